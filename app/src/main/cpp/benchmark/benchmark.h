@@ -0,0 +1,66 @@
+// SPDX-License-Identifier: MPL-2.0
+// Copyright © 2023 Skyline Team and Contributors (https://github.com/skyline-emu/)
+
+#pragma once
+
+#include <chrono>
+#include <functional>
+#include <random>
+#include <string>
+#include <vector>
+#include <common/base.h>
+
+namespace skyline::benchmark {
+    /**
+     * @brief Prevents the compiler from optimizing away the computation of a value that is otherwise unused
+     */
+    template<typename Type>
+    inline void DoNotOptimize(const Type &value) {
+        asm volatile("" : : "r,m"(value) : "memory");
+    }
+
+    /**
+     * @brief Prevents the compiler from assuming that any memory is unchanged across this point
+     */
+    inline void ClobberMemory() {
+        asm volatile("" : : : "memory");
+    }
+
+    /**
+     * @return A deterministic random number generator, all benchmarks use the same seed so runs are directly comparable
+     */
+    inline std::mt19937_64 MakeRandom() {
+        return std::mt19937_64{0x5C71E};
+    }
+
+    /**
+     * @brief A collection of microbenchmarks which times each one and reports the results
+     */
+    class Runner {
+      private:
+        struct Benchmark {
+            std::string name;
+            size_t bytesPerIteration; //!< The amount of bytes processed in an iteration, this is used to report throughput if non-zero
+            std::function<void()> function; //!< A single iteration of the benchmark
+        };
+        std::vector<Benchmark> benchmarks;
+
+      public:
+        static constexpr std::chrono::milliseconds MinimumDuration{250}; //!< The minimum amount of time a benchmark is run for to reduce noise
+
+        /**
+         * @brief Registers a benchmark, the function should perform a single iteration of the operation being measured
+         */
+        void Add(std::string name, std::function<void()> function, size_t bytesPerIteration = 0);
+
+        /**
+         * @brief Runs all benchmarks with a name containing the filter and prints their results
+         * @return The amount of benchmarks that were run
+         */
+        size_t Run(std::string_view filter);
+    };
+
+    void RegisterContainerBenchmarks(Runner &runner);
+
+    void RegisterTextureBenchmarks(Runner &runner);
+}
@@ -0,0 +1,220 @@
+// SPDX-License-Identifier: MPL-2.0
+// Copyright © 2023 Skyline Team and Contributors (https://github.com/skyline-emu/)
+
+#include <common/interval_map.h>
+#include <common/interval_list.h>
+#include <common/segment_table.h>
+#include <common/circular_queue.h>
+#include <common/linear_allocator.h>
+#include <common/spin_lock.h>
+#include "benchmark.h"
+
+namespace skyline::benchmark {
+    constexpr size_t IntervalCount{1024}; //!< The amount of intervals inserted into the interval containers, this is in the range of the amount of traps or dirty intervals seen in games
+    constexpr size_t LookupCount{256}; //!< The amount of lookups performed in a single iteration of lookup benchmarks
+
+    /**
+     * @brief A set of random intervals within an arena alongside random addresses to look up in it
+     */
+    struct IntervalDataset {
+        static constexpr size_t ArenaSize{64 * 1024 * 1024};
+        std::vector<u8> arena;
+        std::vector<span<u8>> intervals;
+        std::vector<u8 *> lookups;
+
+        IntervalDataset() : arena(ArenaSize) {
+            auto random{MakeRandom()};
+            std::uniform_int_distribution<size_t> offsetDistribution{0, ArenaSize - PAGE_SIZE * 16};
+            std::uniform_int_distribution<size_t> sizeDistribution{1, 16};
+
+            for (size_t index{}; index < IntervalCount; index++)
+                intervals.emplace_back(arena.data() + offsetDistribution(random), sizeDistribution(random) * PAGE_SIZE);
+
+            for (size_t index{}; index < LookupCount; index++)
+                lookups.push_back(arena.data() + offsetDistribution(random));
+        }
+    };
+
+    void RegisterIntervalMapBenchmarks(Runner &runner) {
+        static IntervalDataset dataset;
+
+        runner.Add("IntervalMap::Insert/Remove", [] {
+            IntervalMap<u8 *, u32> map;
+            std::vector<IntervalMap<u8 *, u32>::GroupHandle> groups;
+            for (u32 index{}; index < IntervalCount; index++)
+                groups.push_back(map.Insert(dataset.intervals[index].data(), dataset.intervals[index].data() + dataset.intervals[index].size(), index));
+            for (auto group : groups)
+                map.Remove(group);
+        });
+
+        static IntervalMap<u8 *, u32> map;
+        for (u32 index{}; index < IntervalCount; index++)
+            map.Insert(dataset.intervals[index].data(), dataset.intervals[index].data() + dataset.intervals[index].size(), index);
+
+        runner.Add("IntervalMap::Get", [] {
+            for (auto address : dataset.lookups)
+                DoNotOptimize(map.Get(address));
+        });
+
+        runner.Add("IntervalMap::GetRange", [] {
+            for (auto address : dataset.lookups)
+                DoNotOptimize(map.GetRange({address, address + PAGE_SIZE * 4}));
+        });
+
+        runner.Add("IntervalMap::GetAlignedRecursiveRange", [] {
+            for (auto address : dataset.lookups)
+                DoNotOptimize(map.GetAlignedRecursiveRange<PAGE_SIZE>(address));
+        });
+    }
+
+    void RegisterIntervalListBenchmarks(Runner &runner) {
+        static IntervalDataset dataset;
+
+        runner.Add("IntervalList::Insert", [] {
+            IntervalList<u8 *> list;
+            for (auto interval : dataset.intervals)
+                list.Insert(interval);
+            DoNotOptimize(list);
+        });
+
+        static IntervalList<u8 *> list;
+        for (auto interval : dataset.intervals)
+            list.Insert(interval);
+
+        runner.Add("IntervalList::Query", [] {
+            for (auto address : dataset.lookups)
+                DoNotOptimize(list.Query(address));
+        });
+
+        runner.Add("IntervalList::Intersect", [] {
+            for (auto address : dataset.lookups)
+                DoNotOptimize(list.Intersect({address, address + PAGE_SIZE * 4}));
+        });
+    }
+
+    void RegisterSegmentTableBenchmarks(Runner &runner) {
+        // The same layout as the GMMU block segment table which is on the hot path of GPU address translation
+        using Table = SegmentTable<u64, 1ULL << 40, 12, 17>;
+        static Table table;
+        static std::vector<size_t> lookups;
+
+        auto random{MakeRandom()};
+        std::uniform_int_distribution<size_t> addressDistribution{0, (1ULL << 34) - 1};
+        std::uniform_int_distribution<size_t> sizeDistribution{1, 256};
+        for (size_t index{}; index < IntervalCount; index++) {
+            size_t start{util::AlignDown(addressDistribution(random), PAGE_SIZE)};
+            table.Set(start, start + sizeDistribution(random) * PAGE_SIZE, index + 1);
+        }
+        for (size_t index{}; index < LookupCount; index++)
+            lookups.push_back(addressDistribution(random));
+
+        runner.Add("SegmentTable::Set", [] {
+            static size_t start{};
+            table.Set(start, start + 64 * PAGE_SIZE, 1);
+            start = (start + 64 * PAGE_SIZE) % (1ULL << 34);
+        });
+
+        runner.Add("SegmentTable::operator[]", [] {
+            for (auto address : lookups)
+                DoNotOptimize(table[address]);
+        });
+    }
+
+    void RegisterCircularQueueBenchmarks(Runner &runner) {
+        constexpr size_t QueueSize{1024};
+        static CircularQueue<u64> queue{QueueSize};
+
+        runner.Add("CircularQueue::Push/Pop", [] {
+            for (u64 index{}; index < QueueSize / 2; index++)
+                queue.Push(index);
+            for (u64 index{}; index < QueueSize / 2; index++)
+                DoNotOptimize(queue.Pop());
+        });
+    }
+
+    void RegisterLinearAllocatorBenchmarks(Runner &runner) {
+        constexpr size_t AllocationCount{256};
+        static LinearAllocatorState<> allocator;
+
+        runner.Add("LinearAllocator::Allocate/Reset", [] {
+            for (size_t index{}; index < AllocationCount; index++)
+                DoNotOptimize(allocator.Allocate(16 + (index % 8) * 24, false));
+            allocator.Reset();
+        });
+
+        runner.Add("std::vector<LinearAllocator>::push_back", [] {
+            {
+                std::vector<u64, LinearAllocator<u64>> vector{allocator};
+                for (u64 index{}; index < AllocationCount; index++)
+                    vector.push_back(index);
+                DoNotOptimize(vector.data());
+            }
+            allocator.Reset();
+        });
+    }
+
+    void RegisterSpinLockBenchmarks(Runner &runner) {
+        constexpr size_t LockCount{1024};
+        constexpr size_t ContendedThreadCount{4};
+        static SpinLock spinLock;
+        static SharedSpinLock sharedSpinLock;
+        static std::mutex mutex;
+
+        runner.Add("SpinLock (Uncontended)", [] {
+            for (size_t index{}; index < LockCount; index++) {
+                std::scoped_lock lock{spinLock};
+                ClobberMemory();
+            }
+        });
+
+        runner.Add("SharedSpinLock (Uncontended Exclusive)", [] {
+            for (size_t index{}; index < LockCount; index++) {
+                std::scoped_lock lock{sharedSpinLock};
+                ClobberMemory();
+            }
+        });
+
+        runner.Add("SharedSpinLock (Uncontended Shared)", [] {
+            for (size_t index{}; index < LockCount; index++) {
+                std::shared_lock lock{sharedSpinLock};
+                ClobberMemory();
+            }
+        });
+
+        runner.Add("std::mutex (Uncontended)", [] {
+            for (size_t index{}; index < LockCount; index++) {
+                std::scoped_lock lock{mutex};
+                ClobberMemory();
+            }
+        });
+
+        auto addContended{[&runner](std::string name, auto &lockable) {
+            runner.Add(std::move(name), [&lockable] {
+                std::vector<std::thread> threads;
+                for (size_t thread{}; thread < ContendedThreadCount; thread++)
+                    threads.emplace_back([&lockable] {
+                        for (size_t index{}; index < LockCount; index++) {
+                            std::scoped_lock lock{lockable};
+                            ClobberMemory();
+                        }
+                    });
+
+                for (auto &thread : threads)
+                    thread.join();
+            });
+        }};
+
+        addContended("SpinLock (Contended)", spinLock);
+        addContended("SharedSpinLock (Contended Exclusive)", sharedSpinLock);
+        addContended("std::mutex (Contended)", mutex);
+    }
+
+    void RegisterContainerBenchmarks(Runner &runner) {
+        RegisterIntervalMapBenchmarks(runner);
+        RegisterIntervalListBenchmarks(runner);
+        RegisterSegmentTableBenchmarks(runner);
+        RegisterCircularQueueBenchmarks(runner);
+        RegisterLinearAllocatorBenchmarks(runner);
+        RegisterSpinLockBenchmarks(runner);
+    }
+}
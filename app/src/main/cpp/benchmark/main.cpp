@@ -0,0 +1,65 @@
+// SPDX-License-Identifier: MPL-2.0
+// Copyright © 2023 Skyline Team and Contributors (https://github.com/skyline-emu/)
+
+#include <fmt/format.h>
+#include <common/trace.h>
+#include "benchmark.h"
+
+PERFETTO_TRACK_EVENT_STATIC_STORAGE();
+
+namespace skyline::benchmark {
+    void Runner::Add(std::string name, std::function<void()> function, size_t bytesPerIteration) {
+        benchmarks.push_back(Benchmark{std::move(name), bytesPerIteration, std::move(function)});
+    }
+
+    size_t Runner::Run(std::string_view filter) {
+        using Clock = std::chrono::steady_clock;
+
+        size_t count{};
+        for (auto &benchmark : benchmarks) {
+            if (benchmark.name.find(filter) == std::string::npos)
+                continue;
+
+            // A single untimed iteration warms up caches and lazy allocations
+            benchmark.function();
+
+            // The iteration count is doubled until the run takes long enough to be measured reliably
+            size_t iterations{1};
+            Clock::duration elapsed{};
+            while (true) {
+                auto start{Clock::now()};
+                for (size_t iteration{}; iteration < iterations; iteration++)
+                    benchmark.function();
+                elapsed = Clock::now() - start;
+
+                if (elapsed >= MinimumDuration)
+                    break;
+                iterations *= 2;
+            }
+
+            auto nsPerIteration{static_cast<double>(std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count()) / static_cast<double>(iterations)};
+            if (benchmark.bytesPerIteration)
+                fmt::print("{:<48} {:>14.1f} ns/iter {:>10.1f} MiB/s\n", benchmark.name, nsPerIteration, (static_cast<double>(benchmark.bytesPerIteration) / (1024.0 * 1024.0)) / (nsPerIteration / constant::NsInSecond));
+            else
+                fmt::print("{:<48} {:>14.1f} ns/iter\n", benchmark.name, nsPerIteration);
+
+            count++;
+        }
+
+        return count;
+    }
+}
+
+int main(int argc, char **argv) {
+    skyline::benchmark::Runner runner;
+    skyline::benchmark::RegisterContainerBenchmarks(runner);
+    skyline::benchmark::RegisterTextureBenchmarks(runner);
+
+    std::string_view filter{argc > 1 ? argv[1] : ""};
+    if (!runner.Run(filter)) {
+        fmt::print(stderr, "No benchmarks matched the filter '{}'\n", filter);
+        return 1;
+    }
+
+    return 0;
+}
@@ -0,0 +1,130 @@
+// SPDX-License-Identifier: MPL-2.0
+// Copyright © 2023 Skyline Team and Contributors (https://github.com/skyline-emu/)
+
+#include <fmt/format.h>
+#include <gpu/texture/layout.h>
+#include <gpu/texture/bc_decoder.h>
+#include <gpu/texture/bc_transcoder.h>
+#include <gpu/texture/astc_decoder.h>
+#include <gpu/interconnect/conversion/quads.h>
+#include "benchmark.h"
+
+namespace skyline::benchmark {
+    /**
+     * @return A buffer of the supplied size filled with deterministic random bytes
+     */
+    static std::vector<u8> MakeRandomBuffer(size_t size) {
+        auto random{MakeRandom()};
+        std::vector<u8> buffer(size);
+        for (auto &byte : buffer)
+            byte = static_cast<u8>(random());
+        return buffer;
+    }
+
+    void RegisterLayoutBenchmarks(Runner &runner) {
+        using gpu::texture::Dimensions;
+
+        struct LayoutCase {
+            const char *name;
+            Dimensions dimensions;
+            size_t formatBpb;
+            size_t gobBlockHeight;
+            size_t gobBlockDepth;
+        };
+
+        // Typical render target, texture and volume layouts seen in games
+        static constexpr std::array<LayoutCase, 3> LayoutCases{{
+            {"1280x720 RGBA8", Dimensions{1280, 720, 1}, 4, 16, 1},
+            {"1024x1024 RGBA16F", Dimensions{1024, 1024, 1}, 8, 16, 1},
+            {"64x64x64 R8", Dimensions{64, 64, 64}, 1, 4, 4},
+        }};
+
+        for (const auto &layoutCase : LayoutCases) {
+            size_t blockLinearSize{gpu::texture::GetBlockLinearLayerSize(layoutCase.dimensions, 1, 1, layoutCase.formatBpb, layoutCase.gobBlockHeight, layoutCase.gobBlockDepth)};
+            size_t linearSize{static_cast<size_t>(layoutCase.dimensions.width) * layoutCase.dimensions.height * layoutCase.dimensions.depth * layoutCase.formatBpb};
+
+            auto blockLinear{std::make_shared<std::vector<u8>>(MakeRandomBuffer(blockLinearSize))};
+            auto linear{std::make_shared<std::vector<u8>>(MakeRandomBuffer(linearSize))};
+
+            runner.Add(fmt::format("CopyBlockLinearToLinear ({})", layoutCase.name), [layoutCase, blockLinear, linear] {
+                gpu::texture::CopyBlockLinearToLinear(layoutCase.dimensions, 1, 1, layoutCase.formatBpb, layoutCase.gobBlockHeight, layoutCase.gobBlockDepth, blockLinear->data(), linear->data());
+                ClobberMemory();
+            }, linearSize);
+
+            runner.Add(fmt::format("CopyLinearToBlockLinear ({})", layoutCase.name), [layoutCase, blockLinear, linear] {
+                gpu::texture::CopyLinearToBlockLinear(layoutCase.dimensions, 1, 1, layoutCase.formatBpb, layoutCase.gobBlockHeight, layoutCase.gobBlockDepth, linear->data(), blockLinear->data());
+                ClobberMemory();
+            }, linearSize);
+
+            if (layoutCase.dimensions.depth == 1) {
+                auto pitchAmount{static_cast<u32>(layoutCase.dimensions.width * layoutCase.formatBpb)};
+                runner.Add(fmt::format("CopyBlockLinearToPitch ({})", layoutCase.name), [layoutCase, blockLinear, linear, pitchAmount] {
+                    gpu::texture::CopyBlockLinearToPitch(layoutCase.dimensions, 1, 1, layoutCase.formatBpb, pitchAmount, layoutCase.gobBlockHeight, layoutCase.gobBlockDepth, blockLinear->data(), linear->data());
+                    ClobberMemory();
+                }, linearSize);
+            }
+        }
+    }
+
+    void RegisterBcDecoderBenchmarks(Runner &runner) {
+        constexpr size_t Width{512}, Height{512};
+        constexpr size_t BlockCount{(Width / 4) * (Height / 4)};
+
+        static auto bc8Bpb{MakeRandomBuffer(BlockCount * 8)}; //!< Input for formats with 8 bytes per 4x4 block
+        static auto bc16Bpb{MakeRandomBuffer(BlockCount * 16)}; //!< Input for formats with 16 bytes per 4x4 block
+        static std::vector<u8> output(Width * Height * 8);
+
+        constexpr size_t Rgba8Size{Width * Height * 4};
+        runner.Add("DecodeBc1 (512x512)", [] { bcn::DecodeBc1(bc8Bpb.data(), output.data(), Width, Height, true); ClobberMemory(); }, Rgba8Size);
+        runner.Add("DecodeBc2 (512x512)", [] { bcn::DecodeBc2(bc16Bpb.data(), output.data(), Width, Height); ClobberMemory(); }, Rgba8Size);
+        runner.Add("DecodeBc3 (512x512)", [] { bcn::DecodeBc3(bc16Bpb.data(), output.data(), Width, Height); ClobberMemory(); }, Rgba8Size);
+        runner.Add("DecodeBc4 (512x512)", [] { bcn::DecodeBc4(bc8Bpb.data(), output.data(), Width, Height, false); ClobberMemory(); }, Width * Height);
+        runner.Add("DecodeBc5 (512x512)", [] { bcn::DecodeBc5(bc16Bpb.data(), output.data(), Width, Height, false); ClobberMemory(); }, Width * Height * 2);
+        runner.Add("DecodeBc6 (512x512)", [] { bcn::DecodeBc6(bc16Bpb.data(), output.data(), Width, Height, false); ClobberMemory(); }, Width * Height * 8);
+        runner.Add("DecodeBc7 (512x512)", [] { bcn::DecodeBc7(bc16Bpb.data(), output.data(), Width, Height); ClobberMemory(); }, Rgba8Size);
+        runner.Add("TranscodeBc4ToEac (512x512)", [] { bcn::TranscodeBc4ToEac(bc8Bpb.data(), output.data(), Width, Height, false); ClobberMemory(); }, BlockCount * 8);
+        runner.Add("TranscodeBc5ToEac (512x512)", [] { bcn::TranscodeBc5ToEac(bc16Bpb.data(), output.data(), Width, Height, false); ClobberMemory(); }, BlockCount * 16);
+    }
+
+    void RegisterAstcDecoderBenchmarks(Runner &runner) {
+        constexpr size_t Width{480}, Height{480}; // A multiple of all benchmarked block sizes
+
+        static auto input{MakeRandomBuffer((Width / 4) * (Height / 4) * 16)}; //!< Random blocks are largely illegal encodings, this mostly measures the overhead of block mode decoding and output
+        static std::vector<u8> output(Width * Height * 4);
+
+        constexpr size_t Rgba8Size{Width * Height * 4};
+        runner.Add("DecodeAstc 4x4 (480x480)", [] { astc::DecodeAstc(input.data(), output.data(), Width, Height, 4, 4, false); ClobberMemory(); }, Rgba8Size);
+        runner.Add("DecodeAstc 6x6 (480x480)", [] { astc::DecodeAstc(input.data(), output.data(), Width, Height, 6, 6, false); ClobberMemory(); }, Rgba8Size);
+        runner.Add("DecodeAstc 8x8 (480x480)", [] { astc::DecodeAstc(input.data(), output.data(), Width, Height, 8, 8, true); ClobberMemory(); }, Rgba8Size);
+    }
+
+    void RegisterQuadConversionBenchmarks(Runner &runner) {
+        namespace quads = gpu::interconnect::conversion::quads;
+        constexpr u32 VertexCount{0x10000};
+
+        static std::vector<u8> output(quads::GetRequiredBufferSize(VertexCount, sizeof(u32)));
+        static auto indices{MakeRandomBuffer(VertexCount * sizeof(u32))};
+
+        runner.Add("GenerateQuadListConversionBuffer", [] {
+            quads::GenerateQuadListConversionBuffer(reinterpret_cast<u32 *>(output.data()), VertexCount);
+            ClobberMemory();
+        }, quads::GetRequiredBufferSize(VertexCount, sizeof(u32)));
+
+        runner.Add("GenerateIndexedQuadConversionBuffer (u16)", [] {
+            quads::GenerateIndexedQuadConversionBuffer(output.data(), indices.data(), VertexCount, vk::IndexType::eUint16);
+            ClobberMemory();
+        }, quads::GetRequiredBufferSize(VertexCount, sizeof(u16)));
+
+        runner.Add("GenerateIndexedQuadConversionBuffer (u32)", [] {
+            quads::GenerateIndexedQuadConversionBuffer(output.data(), indices.data(), VertexCount, vk::IndexType::eUint32);
+            ClobberMemory();
+        }, quads::GetRequiredBufferSize(VertexCount, sizeof(u32)));
+    }
+
+    void RegisterTextureBenchmarks(Runner &runner) {
+        RegisterLayoutBenchmarks(runner);
+        RegisterBcDecoderBenchmarks(runner);
+        RegisterAstcDecoderBenchmarks(runner);
+        RegisterQuadConversionBenchmarks(runner);
+    }
+}
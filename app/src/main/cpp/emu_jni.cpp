@@ -9,14 +9,21 @@
 #include "skyline/common/language.h"
 #include "skyline/common/signal.h"
 #include "skyline/common/android_settings.h"
+#include "skyline/common/host_affinity.h"
+#include "skyline/common/performance_hint.h"
 #include "skyline/common/trace.h"
+#include "skyline/common/performance_stats.h"
+#include "skyline/common/boot_profiler.h"
 #include "skyline/loader/loader.h"
 #include "skyline/vfs/android_asset_filesystem.h"
 #include "skyline/os.h"
 #include "skyline/jvm.h"
 #include "skyline/gpu.h"
+#include "skyline/gpu/shader_telemetry.h"
+#include "skyline/soc.h"
 #include "skyline/audio.h"
 #include "skyline/input.h"
+#include "skyline/input/event_ring.h"
 #include "skyline/kernel/types/KProcess.h"
 
 jint Fps; //!< An approximation of the amount of frames being submitted every second
@@ -86,18 +93,17 @@ extern "C" JNIEXPORT void Java_emu_skyline_EmulationActivity_executeApplication(
     auto jvmManager{std::make_shared<skyline::JvmManager>(env, instance)};
 
     std::shared_ptr<skyline::Settings> settings{std::make_shared<skyline::AndroidSettings>(env, settingsInstance)};
+    skyline::HostAffinity::Initialize(*settings->pinHostThreads);
+    skyline::PerformanceHint::Initialize(*settings->performanceHints);
 
     skyline::JniString publicAppFilesPath(env, publicAppFilesPathJstring);
     skyline::Logger::EmulationContext.Initialize(publicAppFilesPath + "logs/emulation.sklog");
 
     auto start{std::chrono::steady_clock::now()};
 
-    // Initialize tracing
-    perfetto::TracingInitArgs args;
-    args.backends |= perfetto::kSystemBackend;
-    args.shmem_size_hint_kb = 0x200000;
-    perfetto::Tracing::Initialize(args);
-    perfetto::TrackEvent::Register();
+    skyline::trace::Initialize();
+    skyline::BootProfile.Begin();
+    skyline::gpu::ShaderStats.Reset();
 
     try {
         skyline::JniString nativeLibraryPath(env, nativeLibraryPathJstring);
@@ -110,7 +116,9 @@ extern "C" JNIEXPORT void Java_emu_skyline_EmulationActivity_executeApplication(
             privateAppFilesPath,
             nativeLibraryPath,
             GetTimeZoneName(),
-            std::make_shared<skyline::vfs::AndroidAssetFileSystem>(AAssetManager_fromJava(env, assetManager))
+            std::make_shared<skyline::vfs::AndroidAssetFileSystem>(AAssetManager_fromJava(env, assetManager)),
+            romFd,
+            static_cast<skyline::loader::RomFormat>(romType)
         )};
         OsWeak = os;
         GpuWeak = os->state.gpu;
@@ -121,7 +129,7 @@ extern "C" JNIEXPORT void Java_emu_skyline_EmulationActivity_executeApplication(
 
         skyline::Logger::DebugNoPrefix("Launching ROM {}", skyline::JniString(env, romUriJstring));
 
-        os->Execute(romFd, static_cast<skyline::loader::RomFormat>(romType));
+        os->Execute();
     } catch (std::exception &e) {
         skyline::Logger::ErrorNoPrefix("An uncaught exception has occurred: {}", e.what());
     } catch (const skyline::signal::SignalException &e) {
@@ -131,8 +139,10 @@ extern "C" JNIEXPORT void Java_emu_skyline_EmulationActivity_executeApplication(
     }
 
     perfetto::TrackEvent::Flush();
+    skyline::trace::Controller.Stop();
 
     InputWeak.reset();
+    skyline::PerformanceHint::Finalize();
 
     auto end{std::chrono::steady_clock::now()};
     skyline::Logger::Write(skyline::Logger::LogLevel::Info, fmt::format("Emulation has ended in {}ms", std::chrono::duration_cast<std::chrono::milliseconds>(end - start).count()));
@@ -190,6 +200,148 @@ extern "C" JNIEXPORT void Java_emu_skyline_EmulationActivity_updatePerformanceSt
     env->SetFloatField(thiz, averageFrametimeDeviationField, AverageFrametimeDeviationMs);
 }
 
+/**
+ * @brief The indices of values in the array filled by `getPerformanceOverlayStatistics`, these must be kept in sync with the Kotlin side
+ */
+enum class OverlayStatistic : jsize {
+    Fps,
+    AverageFrametimeUs,
+    FrameGpuTimeUs,
+    PipelineCompiles,
+    ShaderCacheHits,
+    ShaderCacheMisses,
+    TextureCount,
+    BufferCount,
+    MegaBufferBytes,
+    DeviceLocalMemoryBytes,
+    ContextSwitches,
+    FrameTimeCount,
+    Count,
+};
+
+extern "C" JNIEXPORT jstring Java_emu_skyline_EmulationActivity_getPerformanceOverlayStatistics(JNIEnv *env, jobject, jlongArray statisticsJarray, jfloatArray frameTimesJarray) {
+    using skyline::PerfStats;
+    auto gpu{GpuWeak.lock()};
+
+    std::array<jlong, static_cast<size_t>(OverlayStatistic::Count)> statistics{};
+    auto set{[&](OverlayStatistic statistic, auto value) {
+        statistics[static_cast<size_t>(statistic)] = static_cast<jlong>(value);
+    }};
+
+    set(OverlayStatistic::Fps, Fps);
+    set(OverlayStatistic::AverageFrametimeUs, AverageFrametimeMs * 1000.0f);
+    set(OverlayStatistic::FrameGpuTimeUs, PerfStats.frameGpuTimeNs.load(std::memory_order_relaxed) / 1000);
+    set(OverlayStatistic::PipelineCompiles, PerfStats.pipelineCompiles.load(std::memory_order_relaxed));
+    set(OverlayStatistic::ShaderCacheHits, PerfStats.shaderCacheHits.load(std::memory_order_relaxed));
+    set(OverlayStatistic::ShaderCacheMisses, PerfStats.shaderCacheMisses.load(std::memory_order_relaxed));
+    set(OverlayStatistic::TextureCount, PerfStats.textureCount.load(std::memory_order_relaxed));
+    set(OverlayStatistic::BufferCount, PerfStats.bufferCount.load(std::memory_order_relaxed));
+    set(OverlayStatistic::MegaBufferBytes, PerfStats.megaBufferBytes.load(std::memory_order_relaxed));
+    set(OverlayStatistic::DeviceLocalMemoryBytes, gpu ? gpu->memory.GetDeviceLocalUsage() : 0);
+    set(OverlayStatistic::ContextSwitches, PerfStats.contextSwitches.load(std::memory_order_relaxed));
+
+    std::array<float, skyline::PerformanceStats::FrameTimeHistorySize> frameTimes{};
+    auto frameTimeCount{PerfStats.CopyFrameTimes(skyline::span<float>{frameTimes}.first(std::min(frameTimes.size(), static_cast<size_t>(env->GetArrayLength(frameTimesJarray)))))};
+    set(OverlayStatistic::FrameTimeCount, frameTimeCount);
+
+    env->SetLongArrayRegion(statisticsJarray, 0, std::min(static_cast<jsize>(statistics.size()), env->GetArrayLength(statisticsJarray)), statistics.data());
+    env->SetFloatArrayRegion(frameTimesJarray, 0, static_cast<jsize>(frameTimeCount), frameTimes.data());
+
+    return env->NewStringUTF(PerfStats.SampleThreadUsage(4).c_str());
+}
+
+extern "C" JNIEXPORT jstring Java_emu_skyline_EmulationActivity_dumpServiceStatistics(JNIEnv *env, jobject) {
+    auto os{OsWeak.lock()};
+    if (!os)
+        return nullptr;
+
+    auto dump{os->serviceManager.DumpServiceStatistics()};
+    skyline::Logger::Write(skyline::Logger::LogLevel::Info, fmt::format("Service Statistics:\n{}", dump));
+    return env->NewStringUTF(dump.c_str());
+}
+
+extern "C" JNIEXPORT jstring Java_emu_skyline_EmulationActivity_getBootProfile(JNIEnv *env, jobject) {
+    auto summary{skyline::BootProfile.GetSummary()};
+    if (summary.empty())
+        return nullptr;
+
+    return env->NewStringUTF(summary.c_str());
+}
+
+extern "C" JNIEXPORT jstring Java_emu_skyline_EmulationActivity_dumpShaderCompileStatistics(JNIEnv *env, jobject) {
+    auto dump{skyline::gpu::ShaderStats.GetWorstOffenders()};
+    skyline::Logger::Write(skyline::Logger::LogLevel::Info, fmt::format("Shader Compilation Statistics:\n{}", dump));
+    return env->NewStringUTF(dump.c_str());
+}
+
+extern "C" JNIEXPORT jboolean Java_emu_skyline_EmulationActivity_startTracing(JNIEnv *env, jobject, jstring pathJstring, jobjectArray categoriesJarray, jint bufferSizeKb) {
+    std::vector<std::string> categories;
+    if (categoriesJarray) {
+        auto count{env->GetArrayLength(categoriesJarray)};
+        categories.reserve(static_cast<size_t>(count));
+        for (jsize index{}; index < count; index++) {
+            auto categoryJstring{reinterpret_cast<jstring>(env->GetObjectArrayElement(categoriesJarray, index))};
+            categories.emplace_back(skyline::JniString(env, categoryJstring));
+            env->DeleteLocalRef(categoryJstring);
+        }
+    }
+
+    return skyline::trace::Controller.Start(skyline::JniString(env, pathJstring), categories, static_cast<skyline::u32>(bufferSizeKb));
+}
+
+extern "C" JNIEXPORT jboolean Java_emu_skyline_EmulationActivity_stopTracing(JNIEnv *, jobject) {
+    return skyline::trace::Controller.Stop();
+}
+
+extern "C" JNIEXPORT jboolean Java_emu_skyline_EmulationActivity_startGpuCapture(JNIEnv *env, jobject, jstring pathJstring) {
+    auto os{OsWeak.lock()};
+    if (!os)
+        return false;
+
+    return os->state.soc->gpfifoCapture.Start(skyline::JniString(env, pathJstring));
+}
+
+extern "C" JNIEXPORT jboolean Java_emu_skyline_EmulationActivity_stopGpuCapture(JNIEnv *, jobject) {
+    auto os{OsWeak.lock()};
+    if (!os)
+        return false;
+
+    return os->state.soc->gpfifoCapture.Stop();
+}
+
+extern "C" JNIEXPORT jlongArray Java_emu_skyline_EmulationActivity_replayGpuCapture(JNIEnv *env, jobject, jstring pathJstring, jint iterations) {
+    auto os{OsWeak.lock()};
+    if (!os)
+        return nullptr;
+
+    std::vector<jlong> replayTimes;
+    try {
+        skyline::soc::gm20b::GpfifoReplayer replayer{os->state, skyline::JniString(env, pathJstring)};
+        for (jint iteration{}; iteration < iterations; iteration++) {
+            replayTimes.push_back(replayer.Replay());
+            skyline::Logger::Info("GPFIFO replay {}/{} took {}ms", iteration + 1, iterations, static_cast<double>(replayTimes.back()) / skyline::constant::NsInMillisecond);
+        }
+    } catch (const skyline::exception &e) {
+        skyline::Logger::Error("GPFIFO replay failed: {}", e.what());
+        return nullptr;
+    }
+
+    auto replayTimesJarray{env->NewLongArray(static_cast<jsize>(replayTimes.size()))};
+    env->SetLongArrayRegion(replayTimesJarray, 0, static_cast<jsize>(replayTimes.size()), replayTimes.data());
+    return replayTimesJarray;
+}
+
+extern "C" JNIEXPORT jboolean Java_emu_skyline_EmulationActivity_saveMemorySnapshot(JNIEnv *env, jobject, jstring pathJstring) {
+    auto os{OsWeak.lock()};
+    if (!os)
+        return false;
+    auto process{os->state.process};
+    if (!process)
+        return false;
+
+    return process->SaveMemorySnapshot(skyline::JniString(env, pathJstring));
+}
+
 extern "C" JNIEXPORT void JNICALL Java_emu_skyline_input_InputHandler_00024Companion_setController(JNIEnv *, jobject, jint index, jint type, jint partnerIndex) {
     auto input{InputWeak.lock()};
     std::lock_guard guard(input->npad.mutex);
@@ -218,6 +370,11 @@ extern "C" JNIEXPORT void JNICALL Java_emu_skyline_input_InputHandler_00024Compa
         device->SetAxisValue(static_cast<skyline::input::NpadAxisId>(axis), value);
 }
 
+extern "C" JNIEXPORT jobject JNICALL Java_emu_skyline_input_InputHandler_00024Companion_getInputEventRing(JNIEnv *env, jobject) {
+    auto buffer{skyline::input::InputEventRing::Get().Buffer()};
+    return env->NewDirectByteBuffer(buffer.data(), static_cast<jlong>(buffer.size()));
+}
+
 extern "C" JNIEXPORT void JNICALL Java_emu_skyline_input_InputHandler_00024Companion_setMotionState(JNIEnv *env, jobject, jint index, jint motionId, jobject value) {
     auto input{InputWeak.lock()};
     if (!input)
@@ -1,6 +1,7 @@
 // SPDX-License-Identifier: MPL-2.0
 // Copyright © 2020 Skyline Team and Contributors (https://github.com/skyline-emu/)
 
+#include <sys/stat.h>
 #include "skyline/common/logger.h"
 #include "skyline/crypto/key_store.h"
 #include "skyline/vfs/nca.h"
@@ -10,16 +11,56 @@
 #include "skyline/loader/nca.h"
 #include "skyline/loader/xci.h"
 #include "skyline/loader/nsp.h"
+#include "skyline/loader/metadata_index.h"
 #include "skyline/jvm.h"
 
-extern "C" JNIEXPORT jint JNICALL Java_emu_skyline_loader_RomFile_populate(JNIEnv *env, jobject thiz, jint jformat, jint fd, jstring appFilesPathJstring, jint systemLanguage) {
+/**
+ * @brief Writes the supplied metadata to the fields of a RomFile object
+ */
+static void SetRomFileFields(JNIEnv *env, jobject thiz, const skyline::loader::MetadataIndex::Entry &entry) {
+    jclass clazz{env->GetObjectClass(thiz)};
+    jfieldID applicationNameField{env->GetFieldID(clazz, "applicationName", "Ljava/lang/String;")};
+    jfieldID applicationTitleIdField{env->GetFieldID(clazz, "applicationTitleId", "Ljava/lang/String;")};
+    jfieldID applicationAuthorField{env->GetFieldID(clazz, "applicationAuthor", "Ljava/lang/String;")};
+    jfieldID rawIconField{env->GetFieldID(clazz, "rawIcon", "[B")};
+    jfieldID applicationVersionField{env->GetFieldID(clazz, "applicationVersion", "Ljava/lang/String;")};
+
+    env->SetObjectField(thiz, applicationNameField, env->NewStringUTF(entry.applicationName.c_str()));
+    env->SetObjectField(thiz, applicationVersionField, env->NewStringUTF(entry.applicationVersion.c_str()));
+    env->SetObjectField(thiz, applicationTitleIdField, env->NewStringUTF(entry.applicationTitleId.c_str()));
+    env->SetObjectField(thiz, applicationAuthorField, env->NewStringUTF(entry.applicationAuthor.c_str()));
+
+    jbyteArray iconByteArray{env->NewByteArray(static_cast<jsize>(entry.icon.size()))};
+    env->SetByteArrayRegion(iconByteArray, 0, static_cast<jsize>(entry.icon.size()), reinterpret_cast<const jbyte *>(entry.icon.data()));
+    env->SetObjectField(thiz, rawIconField, iconByteArray);
+}
+
+extern "C" JNIEXPORT jint JNICALL Java_emu_skyline_loader_RomFile_populate(JNIEnv *env, jobject thiz, jint jformat, jint fd, jstring pathJstring, jstring appFilesPathJstring, jstring indexPathJstring, jint systemLanguage) {
     skyline::signal::ScopedStackBlocker stackBlocker;
 
     skyline::loader::RomFormat format{static_cast<skyline::loader::RomFormat>(jformat)};
 
     skyline::Logger::SetContext(&skyline::Logger::LoaderContext);
 
-    auto keyStore{std::make_shared<skyline::crypto::KeyStore>(skyline::JniString(env, appFilesPathJstring))};
+    // ROMs which haven't changed since they were last parsed are served from the index without being opened by a loader
+    std::shared_ptr<skyline::loader::MetadataIndex> index;
+    std::optional<skyline::loader::MetadataIndex::Key> indexKey;
+    struct stat romStat{};
+    if (indexPathJstring && fstat(fd, &romStat) == 0) {
+        index = skyline::loader::MetadataIndex::Get(skyline::JniString(env, indexPathJstring));
+        indexKey = skyline::loader::MetadataIndex::Key{
+            .path = skyline::JniString(env, pathJstring),
+            .size = static_cast<skyline::u64>(romStat.st_size),
+            .modificationTime = static_cast<skyline::i64>(romStat.st_mtim.tv_sec) * 1'000'000'000 + romStat.st_mtim.tv_nsec,
+            .language = static_cast<skyline::u32>(systemLanguage),
+        };
+
+        if (auto entry{index->Lookup(*indexKey)}) {
+            SetRomFileFields(env, thiz, *entry);
+            return static_cast<jint>(skyline::loader::LoaderResult::Success);
+        }
+    }
+
     std::unique_ptr<skyline::loader::Loader> loader;
     try {
         auto backing{std::make_shared<skyline::vfs::OsBacking>(fd)};
@@ -32,13 +73,13 @@ extern "C" JNIEXPORT jint JNICALL Java_emu_skyline_loader_RomFile_populate(JNIEn
                 loader = std::make_unique<skyline::loader::NsoLoader>(backing);
                 break;
             case skyline::loader::RomFormat::NCA:
-                loader = std::make_unique<skyline::loader::NcaLoader>(backing, keyStore);
+                loader = std::make_unique<skyline::loader::NcaLoader>(backing, std::make_shared<skyline::crypto::KeyStore>(skyline::JniString(env, appFilesPathJstring)));
                 break;
             case skyline::loader::RomFormat::XCI:
-                loader = std::make_unique<skyline::loader::XciLoader>(backing, keyStore);
+                loader = std::make_unique<skyline::loader::XciLoader>(backing, std::make_shared<skyline::crypto::KeyStore>(skyline::JniString(env, appFilesPathJstring)));
                 break;
             case skyline::loader::RomFormat::NSP:
-                loader = std::make_unique<skyline::loader::NspLoader>(backing, keyStore);
+                loader = std::make_unique<skyline::loader::NspLoader>(backing, std::make_shared<skyline::crypto::KeyStore>(skyline::JniString(env, appFilesPathJstring)));
                 break;
             default:
                 return static_cast<jint>(skyline::loader::LoaderResult::ParsingError);
@@ -49,28 +90,28 @@ extern "C" JNIEXPORT jint JNICALL Java_emu_skyline_loader_RomFile_populate(JNIEn
         return static_cast<jint>(skyline::loader::LoaderResult::ParsingError);
     }
 
-    jclass clazz{env->GetObjectClass(thiz)};
-    jfieldID applicationNameField{env->GetFieldID(clazz, "applicationName", "Ljava/lang/String;")};
-    jfieldID applicationTitleIdField{env->GetFieldID(clazz, "applicationTitleId", "Ljava/lang/String;")};
-    jfieldID applicationAuthorField{env->GetFieldID(clazz, "applicationAuthor", "Ljava/lang/String;")};
-    jfieldID rawIconField{env->GetFieldID(clazz, "rawIcon", "[B")};
-    jfieldID applicationVersionField{env->GetFieldID(clazz, "applicationVersion", "Ljava/lang/String;")};
-
     if (loader->nacp) {
         auto language{skyline::language::GetApplicationLanguage(static_cast<skyline::language::SystemLanguage>(systemLanguage))};
         if (((1 << static_cast<skyline::u32>(language)) & loader->nacp->supportedTitleLanguages) == 0)
             language = loader->nacp->GetFirstSupportedTitleLanguage();
 
-        env->SetObjectField(thiz, applicationNameField, env->NewStringUTF(loader->nacp->GetApplicationName(language).c_str()));
-        env->SetObjectField(thiz, applicationVersionField, env->NewStringUTF(loader->nacp->GetApplicationVersion().c_str()));
-        env->SetObjectField(thiz, applicationTitleIdField, env->NewStringUTF(loader->nacp->GetSaveDataOwnerId().c_str()));
-        env->SetObjectField(thiz, applicationAuthorField, env->NewStringUTF(loader->nacp->GetApplicationPublisher(language).c_str()));
+        skyline::loader::MetadataIndex::Entry entry{
+            .applicationName = loader->nacp->GetApplicationName(language),
+            .applicationVersion = loader->nacp->GetApplicationVersion(),
+            .applicationTitleId = loader->nacp->GetSaveDataOwnerId(),
+            .applicationAuthor = loader->nacp->GetApplicationPublisher(language),
+            .icon = loader->GetIcon(language),
+        };
 
-        auto icon{loader->GetIcon(language)};
-        jbyteArray iconByteArray{env->NewByteArray(static_cast<jsize>(icon.size()))};
-        env->SetByteArrayRegion(iconByteArray, 0, static_cast<jsize>(icon.size()), reinterpret_cast<const jbyte *>(icon.data()));
-        env->SetObjectField(thiz, rawIconField, iconByteArray);
+        SetRomFileFields(env, thiz, entry);
+        if (index)
+            index->Insert(*indexKey, std::move(entry));
     }
 
     return static_cast<jint>(skyline::loader::LoaderResult::Success);
 }
+
+extern "C" JNIEXPORT void JNICALL Java_emu_skyline_loader_RomFile_flushMetadataIndex(JNIEnv *env, jclass, jstring indexPathJstring) {
+    skyline::Logger::SetContext(&skyline::Logger::LoaderContext);
+    skyline::loader::MetadataIndex::Get(skyline::JniString(env, indexPathJstring))->Flush();
+}
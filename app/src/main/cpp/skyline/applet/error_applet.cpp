@@ -17,7 +17,7 @@ namespace skyline::applet {
         auto commonArg{PopNormalInput<service::applet::CommonArguments>()};
 
         errorStorage = PopNormalInput();
-        auto errorCommonHeader{errorStorage->GetSpan().as<ErrorCommonHeader>()};
+        const auto &errorCommonHeader{errorStorage->GetSpan().as<ErrorCommonHeader>()};
         Logger::Debug("ErrorApplet: version: 0x{:X}, type: 0x{:X}", commonArg.apiVersion, errorCommonHeader.type);
 
         switch (errorCommonHeader.type) {
@@ -38,12 +38,12 @@ namespace skyline::applet {
     }
 
     void ErrorApplet::HandleErrorCommonArg() {
-        auto errorCommonArg{errorStorage->GetSpan().as<ErrorCommonArg>()};
+        const auto &errorCommonArg{errorStorage->GetSpan().as<ErrorCommonArg>()};
         Logger::Error("ErrorApplet: error code: 0x{:X}, result: 0x{:X}", errorCommonArg.errorCode, errorCommonArg.result);
     }
 
     void ErrorApplet::HandleApplicationErrorArg() {
-        auto applicationErrorStorage{errorStorage->GetSpan().as<ApplicationErrorArg>()};
+        const auto &applicationErrorStorage{errorStorage->GetSpan().as<ApplicationErrorArg>()};
 
         if (applicationErrorStorage.fullscreenMessage[0] == '\0')
             Logger::ErrorNoPrefix("Application Error: {}", applicationErrorStorage.dialogMessage.data());
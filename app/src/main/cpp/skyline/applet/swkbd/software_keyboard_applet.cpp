@@ -52,7 +52,7 @@ namespace skyline::applet::swkbd {
     void SoftwareKeyboardApplet::SendResult() {
         if (dialog)
             state.jvm->CloseKeyboard(dialog);
-        PushNormalDataAndSignal(std::make_shared<service::am::ObjIStorage<OutputResult>>(state, manager, OutputResult{currentResult, currentText, config.commonConfig.isUseUtf8}));
+        PushNormalDataAndSignal(std::make_shared<service::am::ObjIStorage<OutputResult>>(state, manager, std::in_place, currentResult, currentText, config.commonConfig.isUseUtf8));
         onAppletStateChanged->Signal();
     }
 
@@ -126,7 +126,7 @@ namespace skyline::applet::swkbd {
             currentText = result.second;
         }
         if (config.commonConfig.isUseTextCheck && currentResult == CloseResult::Enter) {
-            PushInteractiveDataAndSignal(std::make_shared<service::am::ObjIStorage<ValidationRequest>>(state, manager, ValidationRequest{currentText, config.commonConfig.isUseUtf8}));
+            PushInteractiveDataAndSignal(std::make_shared<service::am::ObjIStorage<ValidationRequest>>(state, manager, std::in_place, currentText, config.commonConfig.isUseUtf8));
             validationPending = true;
         } else {
             SendResult();
@@ -161,7 +161,7 @@ namespace skyline::applet::swkbd {
                         currentResult = static_cast<CloseResult>(result.first);
                         currentText = result.second;
                         if (currentResult == CloseResult::Enter) {
-                            PushInteractiveDataAndSignal(std::make_shared<service::am::ObjIStorage<ValidationRequest>>(state, manager, ValidationRequest{currentText, config.commonConfig.isUseUtf8}));
+                            PushInteractiveDataAndSignal(std::make_shared<service::am::ObjIStorage<ValidationRequest>>(state, manager, std::in_place, currentText, config.commonConfig.isUseUtf8));
                         } else {
                             SendResult();
                         }
@@ -174,7 +174,7 @@ namespace skyline::applet::swkbd {
                         Logger::Warn("Sending default text despite being rejected by the guest with message: \"{}\"", message);
                     else
                         Logger::Debug("Guest asked to confirm default text with message: \"{}\"", message);
-                    PushNormalDataAndSignal(std::make_shared<service::am::ObjIStorage<OutputResult>>(state, manager, OutputResult{CloseResult::Enter, currentText, config.commonConfig.isUseUtf8}));
+                    PushNormalDataAndSignal(std::make_shared<service::am::ObjIStorage<OutputResult>>(state, manager, std::in_place, CloseResult::Enter, currentText, config.commonConfig.isUseUtf8));
                 }
             }
         }
@@ -2,6 +2,7 @@
 // Copyright © 2020 Skyline Team and Contributors (https://github.com/skyline-emu/)
 
 #include "common.h"
+#include "common/boot_profiler.h"
 #include "nce.h"
 #include "soc.h"
 #include "gpu.h"
@@ -13,7 +14,10 @@ namespace skyline {
     DeviceState::DeviceState(kernel::OS *os, std::shared_ptr<JvmManager> jvmManager, std::shared_ptr<Settings> settings)
         : os(os), jvm(std::move(jvmManager)), settings(std::move(settings)) {
         // We assign these later as they use the state in their constructor and we don't want null pointers
-        gpu = std::make_shared<gpu::GPU>(*this);
+        {
+            BootProfiler::ScopedStage bootStage{BootProfiler::Stage::VulkanDeviceCreation};
+            gpu = std::make_shared<gpu::GPU>(*this);
+        }
         soc = std::make_shared<soc::SOC>(*this);
         audio = std::make_shared<audio::Audio>(*this);
         nce = std::make_shared<nce::NCE>(*this);
@@ -6,6 +6,7 @@
 #include <boost/container/small_vector.hpp>
 #include <concepts>
 #include <common.h>
+#include <common/trace.h>
 #include "segment_table.h"
 #include "spin_lock.h"
 
@@ -55,20 +56,30 @@ namespace skyline {
             }
         };
 
-        SharedSpinLock blockMutex;
+        DistributedSharedSpinLock blockMutex; //!< Translations are looked up concurrently by the GPU and guest threads while the map is rarely modified
         std::vector<Block> blocks{Block{}};
 
         /**
          * @brief Maps a PA range into the given AS region
+         * @param notify If the unmap callback should be called for the region, this can be skipped by callers which notify for a batch of operations at once
          * @note blockMutex MUST be locked when calling this
          */
-        void MapLocked(VaType virt, PaType phys, VaType size, ExtraBlockInfo extraInfo);
+        void MapLocked(VaType virt, PaType phys, VaType size, ExtraBlockInfo extraInfo, bool notify = true);
 
         /**
          * @brief Unmaps the given range and merges it with other unmapped regions
+         * @param notify If the unmap callback should be called for the region, this can be skipped by callers which notify for a batch of operations at once
          * @note blockMutex MUST be locked when calling this
          */
-        void UnmapLocked(VaType virt, VaType size);
+        void UnmapLocked(VaType virt, VaType size, bool notify = true);
+
+        /**
+         * @brief Calls the unmap callback for the supplied region if there is one
+         */
+        void NotifyUnmap(VaType virt, VaType size) {
+            if (unmapCallback)
+                unmapCallback(virt, size);
+        }
 
       public:
         static constexpr VaType VaMaximum{(1ULL << (AddressSpaceBits - 1)) + ((1ULL << (AddressSpaceBits - 1)) - 1)}; //!< The maximum VA that this AS can technically reach
@@ -87,6 +98,13 @@ namespace skyline {
         bool sparseMapped;
     };
 
+    /**
+     * @brief A CPU access callback that does nothing, memory manager accesses without a callback use this so the check and the indirect call are compiled out of their loops
+     */
+    struct NoCpuAccessCallback {
+        constexpr void operator()(span<u8>) const {}
+    };
+
     /**
      * @brief FlatMemoryManager specialises FlatAddressSpaceMap to focus on pointers as PAs, adding read/write functions and sparse mapping support
      */
@@ -109,8 +127,66 @@ namespace skyline {
         static constexpr size_t AddressSpaceSize{1ULL << AddressSpaceBits};
         SegmentTable<SegmentTableEntry, AddressSpaceSize, VaGranularityBits, VaL2GranularityBits> blockSegmentTable; //!< A page table of all buffer mappings for O(1) lookups on full matches
 
+        /**
+         * @brief A cached translation of an entire block from the block vector, this is exact unlike segment table entries which may be stale for blocks that were split by later mappings
+         */
+        struct TlbEntry {
+            const FlatMemoryManager *manager; //!< The memory manager that the translation was made by
+            u64 generation; //!< The generation of the memory manager at the time of the translation
+            VaType virt;
+            VaType virtEnd;
+            u8 *phys;
+            bool sparseMapped;
+        };
+
+        static constexpr size_t TlbEntryCount{4}; //!< The amount of translations cached by each thread, this covers the handful of regions that are accessed repeatedly by pushbuffer fetches and DMA copies
+        inline static thread_local std::array<TlbEntry, TlbEntryCount> tlb{}; //!< A small per-thread cache of the most recent block translations
+        inline static thread_local size_t tlbNextEntry{}; //!< The index of the TLB entry that will be replaced next
+        inline static std::atomic<u64> nextGeneration{1}; //!< Generations are unique across all memory managers so a TLB entry can never match a different memory manager at the same address
+        u64 generation{nextGeneration.fetch_add(1, std::memory_order_relaxed)}; //!< Changes on every modification of the mappings, this invalidates all TLB entries for the memory manager
+
+        /**
+         * @return The TLB entry that contains the entire supplied range or nullptr if there isn't one
+         * @note blockMutex MUST be locked when calling this
+         */
+        const TlbEntry *LookupTlbLocked(VaType virt, VaType size) {
+            for (const auto &entry : tlb)
+                if (entry.manager == this && entry.generation == generation && virt >= entry.virt && virt + size <= entry.virtEnd)
+                    return &entry;
+            return nullptr;
+        }
+
+        /**
+         * @brief Caches the translation of a mapped block in the TLB of the current thread
+         * @note blockMutex MUST be locked when calling this
+         */
+        void InsertTlbLocked(VaType virt, VaType virtEnd, u8 *phys, bool sparseMapped) {
+            tlb[tlbNextEntry++ % TlbEntryCount] = TlbEntry{this, generation, virt, virtEnd, phys, sparseMapped};
+        }
+
+        /**
+         * @brief Invalidates all TLB entries for this memory manager on every thread
+         * @note blockMutex MUST be exclusively locked when calling this
+         */
+        void InvalidateTlbLocked() {
+            generation = nextGeneration.fetch_add(1, std::memory_order_relaxed);
+        }
+
         TranslatedAddressRange TranslateRangeImpl(VaType virt, VaType size, std::function<void(span<u8>)> cpuAccessCallback = {});
 
+        /**
+         * @brief Calls the supplied CPU access callback on a block, callbacks that can be empty such as std::function are checked first while NoCpuAccessCallback compiles out entirely
+         */
+        template<typename CallbackType>
+        __attribute__((always_inline)) static void InvokeCpuAccessCallback(CallbackType &cpuAccessCallback, span<u8> block) {
+            if constexpr (std::is_constructible_v<bool, CallbackType &>) {
+                if (cpuAccessCallback)
+                    cpuAccessCallback(block);
+            } else {
+                cpuAccessCallback(block);
+            }
+        }
+
         std::pair<span<u8>, size_t> LookupBlockLocked(VaType virt, std::function<void(span<u8>)> cpuAccessCallback = {}) {
             const auto &blockEntry{this->blockSegmentTable[virt]};
             VaType segmentOffset{virt - blockEntry.virt};
@@ -163,18 +239,83 @@ namespace skyline {
             return TranslateRangeImpl(virt, size, cpuAccessCallback);
         }
 
+        /**
+         * @brief Calls the supplied function for every mapped region in the AS in ascending order of VA
+         * @param function A function taking the VA of the region, a span of its backing and if it is sparse mapped, sparse regions are backed by the placeholder address
+         */
+        template<typename Function>
+        void ForEachMapping(Function function) {
+            std::shared_lock lock{this->blockMutex};
+
+            for (auto block{this->blocks.begin()}; std::next(block) != this->blocks.end(); block++)
+                if (block->Mapped())
+                    function(block->virt, span<u8>{block->phys, static_cast<size_t>(std::next(block)->virt - block->virt)}, block->extraInfo.sparseMapped);
+        }
+
+        template<typename CallbackType = NoCpuAccessCallback>
+        void Read(u8 *destination, VaType virt, VaType size, CallbackType &&cpuAccessCallback = {}) {
+            TRACE_EVENT("containers", "FlatMemoryManager::Read");
 
-        void Read(u8 *destination, VaType virt, VaType size, std::function<void(span<u8>)> cpuAccessCallback = {});
+            std::shared_lock lock(this->blockMutex);
+
+            // (Fast path) Reads contained in a recently translated block don't need to search the block vector
+            if (auto entry{LookupTlbLocked(virt, size)}) [[likely]] {
+                if (entry->sparseMapped) {
+                    std::memset(destination, 0, size);
+                } else {
+                    span<u8> cpuBlock{entry->phys + (virt - entry->virt), size};
+                    InvokeCpuAccessCallback(cpuAccessCallback, cpuBlock);
+
+                    std::memcpy(destination, cpuBlock.data(), size);
+                }
+                return;
+            }
 
-        template<typename T>
-        void Read(span <T> destination, VaType virt, std::function<void(span<u8>)> cpuAccessCallback = {}) {
-            Read(reinterpret_cast<u8 *>(destination.data()), virt, destination.size_bytes(), cpuAccessCallback);
+            auto successor{std::upper_bound(this->blocks.begin(), this->blocks.end(), virt, [] (auto virt, const auto &block) {
+                return virt < block.virt;
+            })};
+
+            auto predecessor{std::prev(successor)};
+            if (predecessor->phys)
+                InsertTlbLocked(predecessor->virt, successor->virt, predecessor->phys, predecessor->extraInfo.sparseMapped);
+
+            u8 *blockPhys{predecessor->phys + (virt - predecessor->virt)};
+            VaType blockReadSize{std::min(successor->virt - virt, size)};
+
+            // Reads may span across multiple individual blocks
+            while (size) {
+                if (predecessor->phys == nullptr) {
+                    throw exception("Page fault at 0x{:X}", predecessor->virt);
+                } else {
+                    if (predecessor->extraInfo.sparseMapped) { // Sparse mappings read all zeroes
+                        std::memset(destination, 0, blockReadSize);
+                    } else {
+                        InvokeCpuAccessCallback(cpuAccessCallback, span{blockPhys, blockReadSize});
+
+                        std::memcpy(destination, blockPhys, blockReadSize);
+                    }
+                }
+
+                destination += blockReadSize;
+                size -= blockReadSize;
+
+                if (size) {
+                    predecessor = successor++;
+                    blockPhys = predecessor->phys;
+                    blockReadSize = std::min(successor->virt - predecessor->virt, size);
+                }
+            }
+        }
+
+        template<typename T, typename CallbackType = NoCpuAccessCallback>
+        void Read(span <T> destination, VaType virt, CallbackType &&cpuAccessCallback = {}) {
+            Read(reinterpret_cast<u8 *>(destination.data()), virt, destination.size_bytes(), std::forward<CallbackType>(cpuAccessCallback));
         }
 
-        template<typename T>
-        T Read(VaType virt, std::function<void(span<u8>)> cpuAccessCallback = {}) {
+        template<typename T, typename CallbackType = NoCpuAccessCallback>
+        T Read(VaType virt, CallbackType &&cpuAccessCallback = {}) {
             T obj;
-            Read(reinterpret_cast<u8 *>(&obj), virt, sizeof(T), cpuAccessCallback);
+            Read(reinterpret_cast<u8 *>(&obj), virt, sizeof(T), std::forward<CallbackType>(cpuAccessCallback));
             return obj;
         }
 
@@ -185,8 +326,8 @@ namespace skyline {
          * @note The function will **NOT** be run on any sparse block
          * @note The function will provide no feedback on if the end has been reached or if there was an early exit
          */
-        template<typename Function, typename Container>
-        span<u8> ReadTill(Container& destination, VaType virt, Function function, std::function<void(span<u8>)> cpuAccessCallback = {}) {
+        template<typename Function, typename Container, typename CallbackType = NoCpuAccessCallback>
+        span<u8> ReadTill(Container& destination, VaType virt, Function function, CallbackType &&cpuAccessCallback = {}) {
             //TRACE_EVENT("containers", "FlatMemoryManager::ReadTill");
 
             std::shared_lock lock(this->blockMutex);
@@ -211,8 +352,7 @@ namespace skyline {
                         std::memset(pointer, 0, blockReadSize);
                     } else {
                         span<u8> cpuBlock{blockPhys, blockReadSize};
-                        if (cpuAccessCallback)
-                            cpuAccessCallback(cpuBlock);
+                        InvokeCpuAccessCallback(cpuAccessCallback, cpuBlock);
 
                         auto end{function(cpuBlock)};
                         std::memcpy(pointer, blockPhys, end ? *end : blockReadSize);
@@ -234,30 +374,166 @@ namespace skyline {
             return {destination.data(), destination.size()};
         }
 
-        void Write(VaType virt, u8 *source, VaType size, std::function<void(span<u8>)> cpuAccessCallback = {});
+        template<typename CallbackType = NoCpuAccessCallback>
+        void Write(VaType virt, u8 *source, VaType size, CallbackType &&cpuAccessCallback = {}) {
+            TRACE_EVENT("containers", "FlatMemoryManager::Write");
+
+            std::shared_lock lock(this->blockMutex);
+
+            // (Fast path) Writes contained in a recently translated block don't need to search the block vector
+            if (auto entry{LookupTlbLocked(virt, size)}) [[likely]] {
+                if (!entry->sparseMapped) {
+                    span<u8> cpuBlock{entry->phys + (virt - entry->virt), size};
+                    InvokeCpuAccessCallback(cpuAccessCallback, cpuBlock);
+
+                    std::memcpy(cpuBlock.data(), source, size);
+                }
+                return;
+            }
+
+            VaType virtEnd{virt + size};
+
+            auto successor{std::upper_bound(this->blocks.begin(), this->blocks.end(), virt, [] (auto virt, const auto &block) {
+                return virt < block.virt;
+            })};
+
+            auto predecessor{std::prev(successor)};
+            if (predecessor->phys)
+                InsertTlbLocked(predecessor->virt, successor->virt, predecessor->phys, predecessor->extraInfo.sparseMapped);
+
+            u8 *blockPhys{predecessor->phys + (virt - predecessor->virt)};
+            VaType blockWriteSize{std::min(successor->virt - virt, size)};
+
+            // Writes may span across multiple individual blocks
+            while (size) {
+                if (predecessor->phys == nullptr) {
+                    throw exception("Page fault at 0x{:X}", predecessor->virt);
+                } else {
+                    if (!predecessor->extraInfo.sparseMapped) { // Sparse mappings ignore writes
+                        InvokeCpuAccessCallback(cpuAccessCallback, span{blockPhys, blockWriteSize});
+
+                        std::memcpy(blockPhys, source, blockWriteSize);
+                    }
+                }
+
+                source += blockWriteSize;
+                size -= blockWriteSize;
+
+                if (size) {
+                    predecessor = successor++;
+                    blockPhys = predecessor->phys;
+                    blockWriteSize = std::min(successor->virt - predecessor->virt, size);
+                }
+            }
+        }
 
-        template<typename T>
-        void Write(VaType virt, span<T> source, std::function<void(span<u8>)> cpuAccessCallback = {}) {
-            Write(virt, reinterpret_cast<u8 *>(source.data()), source.size_bytes());
+        template<typename T, typename CallbackType = NoCpuAccessCallback>
+        void Write(VaType virt, span<T> source, CallbackType &&cpuAccessCallback = {}) {
+            Write(virt, reinterpret_cast<u8 *>(source.data()), source.size_bytes(), std::forward<CallbackType>(cpuAccessCallback));
         }
 
-        void Write(VaType virt, util::TrivialObject auto source, std::function<void(span<u8>)> cpuAccessCallback = {}) {
-            Write(virt, reinterpret_cast<u8 *>(&source), sizeof(source), cpuAccessCallback);
+        template<util::TrivialObject T, typename CallbackType = NoCpuAccessCallback>
+        void Write(VaType virt, T source, CallbackType &&cpuAccessCallback = {}) {
+            Write(virt, reinterpret_cast<u8 *>(&source), sizeof(source), std::forward<CallbackType>(cpuAccessCallback));
         }
 
-        void Copy(VaType dst, VaType src, VaType size, std::function<void(span<u8>)> cpuAccessCallback = {});
+        template<typename CallbackType = NoCpuAccessCallback>
+        void Copy(VaType dst, VaType src, VaType size, CallbackType &&cpuAccessCallback = {}) {
+            TRACE_EVENT("containers", "FlatMemoryManager::Copy");
+
+            std::shared_lock lock(this->blockMutex);
+
+            VaType srcEnd{src + size};
+            VaType dstEnd{dst + size};
+
+            auto srcSuccessor{std::upper_bound(this->blocks.begin(), this->blocks.end(), src, [] (auto virt, const auto &block) {
+                return virt < block.virt;
+            })};
+
+            auto dstSuccessor{std::upper_bound(this->blocks.begin(), this->blocks.end(), dst, [] (auto virt, const auto &block) {
+                return virt < block.virt;
+            })};
+
+            auto srcPredecessor{std::prev(srcSuccessor)};
+            auto dstPredecessor{std::prev(dstSuccessor)};
+
+            u8 *srcBlockPhys{srcPredecessor->phys + (src - srcPredecessor->virt)};
+            u8 *dstBlockPhys{dstPredecessor->phys + (dst - dstPredecessor->virt)};
+
+            VaType srcBlockRemainingSize{srcSuccessor->virt - src};
+            VaType dstBlockRemainingSize{dstSuccessor->virt - dst};
+
+            VaType blockCopySize{std::min({srcBlockRemainingSize, dstBlockRemainingSize, size})};
+
+            // Writes may span across multiple individual blocks
+            while (size) {
+                if (srcPredecessor->phys == nullptr) {
+                    throw exception("Page fault at 0x{:X}", srcPredecessor->virt);
+                } else if (dstPredecessor->phys == nullptr) {
+                    throw exception("Page fault at 0x{:X}", dstPredecessor->virt);
+                } else { [[likely]]
+                        if (srcPredecessor->extraInfo.sparseMapped) {
+                            std::memset(dstBlockPhys, 0, blockCopySize);
+                        } else [[likely]] {
+                            InvokeCpuAccessCallback(cpuAccessCallback, span{dstBlockPhys, blockCopySize});
+                            InvokeCpuAccessCallback(cpuAccessCallback, span{srcBlockPhys, blockCopySize});
+
+                            std::memcpy(dstBlockPhys, srcBlockPhys, blockCopySize);
+                        }
+                }
+
+                dstBlockPhys += blockCopySize;
+                srcBlockPhys += blockCopySize;
+                size -= blockCopySize;
+                srcBlockRemainingSize -= blockCopySize;
+                dstBlockRemainingSize -= blockCopySize;
+
+                if (size) {
+                    if (!srcBlockRemainingSize) {
+                        srcPredecessor = srcSuccessor++;
+                        srcBlockPhys = srcPredecessor->phys;
+                        srcBlockRemainingSize = srcSuccessor->virt - srcPredecessor->virt;
+                        blockCopySize = std::min({srcBlockRemainingSize, dstBlockRemainingSize, size});
+                    }
+                    if (!dstBlockRemainingSize) {
+                        dstPredecessor = dstSuccessor++;
+                        dstBlockPhys = dstPredecessor->phys;
+                        dstBlockRemainingSize = dstSuccessor->virt - dstPredecessor->virt;
+                        blockCopySize = std::min({srcBlockRemainingSize, dstBlockRemainingSize, size});
+                    }
+                }
+            }
+        }
 
         void Map(VaType virt, u8 *phys, VaType size, MemoryManagerBlockInfo extraInfo = {}) {
             std::scoped_lock lock(this->blockMutex);
             blockSegmentTable.Set(virt, virt + size, {virt, phys, size, extraInfo});
             this->MapLocked(virt, phys, size, extraInfo);
+            InvalidateTlbLocked();
         }
 
         void Unmap(VaType virt, VaType size) {
             std::scoped_lock lock(this->blockMutex);
             blockSegmentTable.Set(virt, virt + size, {});
             this->UnmapLocked(virt, size);
+            InvalidateTlbLocked();
         }
+
+        /**
+         * @brief A single operation in a batch passed to MapBatch, a `phys` of nullptr denotes an unmap
+         */
+        struct MapOperation {
+            VaType virt;
+            u8 *phys;
+            VaType size;
+            MemoryManagerBlockInfo extraInfo{};
+        };
+
+        /**
+         * @brief Applies a batch of map and unmap operations in order while only locking the AS once, runs of operations that are contiguous in the VA and PA are coalesced into a single operation
+         * @note Operations should be sorted by their VA to benefit from coalescing, the unmap callback is called once for every contiguous changed region after all operations are applied
+         */
+        void MapBatch(span<const MapOperation> operations);
     };
 
     /**
@@ -37,16 +37,36 @@ namespace skyline {
             systemLanguage = ktSettings.GetInt<skyline::language::SystemLanguage>("systemLanguage");
             systemRegion = ktSettings.GetInt<skyline::region::RegionCode>("systemRegion");
             isInternetEnabled = ktSettings.GetBool("isInternetEnabled");
+            pinHostThreads = ktSettings.GetBool("pinHostThreads");
+            performanceHints = ktSettings.GetBool("performanceHints");
+            cacheDecryptedNca = ktSettings.GetBool("cacheDecryptedNca");
+            verifyRomFsIntegrity = ktSettings.GetBool("verifyRomFsIntegrity");
+            hardwareVideoDecoding = ktSettings.GetBool("hardwareVideoDecoding");
             forceTripleBuffering = ktSettings.GetBool("forceTripleBuffering");
             disableFrameThrottling = ktSettings.GetBool("disableFrameThrottling");
+            framePacing = ktSettings.GetBool("framePacing");
             gpuDriver = ktSettings.GetString("gpuDriver");
             gpuDriverLibraryName = ktSettings.GetString("gpuDriverLibraryName");
             executorSlotCountScale = ktSettings.GetInt<u32>("executorSlotCountScale");
             executorFlushThreshold = ktSettings.GetInt<u32>("executorFlushThreshold");
+            adaptiveExecutorFlush = ktSettings.GetBool("adaptiveExecutorFlush");
             useDirectMemoryImport = ktSettings.GetBool("useDirectMemoryImport");
             forceMaxGpuClocks = ktSettings.GetBool("forceMaxGpuClocks");
+            parallelCommandRecording = ktSettings.GetBool("parallelCommandRecording");
             disableShaderCache = ktSettings.GetBool("disableShaderCache");
+            asyncPipelineCompilation = ktSettings.GetBool("asyncPipelineCompilation");
+            enableMacroJit = ktSettings.GetBool("enableMacroJit");
             freeGuestTextureMemory = ktSettings.GetBool("freeGuestTextureMemory");
+            textureMemoryBudget = ktSettings.GetInt<u32>("textureMemoryBudget");
+            transientAttachments = ktSettings.GetBool("transientAttachments");
+            resolutionScale = ktSettings.GetInt<u32>("resolutionScale");
+            dynamicResolution = ktSettings.GetBool("dynamicResolution");
+            upscalingMode = ktSettings.GetInt<u32>("upscalingMode");
+            gpuTextureDecoding = ktSettings.GetBool("gpuTextureDecoding");
+            textureTranscoding = ktSettings.GetBool("textureTranscoding");
+            gpuQuadConversion = ktSettings.GetBool("gpuQuadConversion");
+            enableTextureCache = ktSettings.GetBool("enableTextureCache");
+            skipRedundantUploads = ktSettings.GetBool("skipRedundantUploads");
             enableFastGpuReadbackHack = ktSettings.GetBool("enableFastGpuReadbackHack");
             enableFastReadbackWrites = ktSettings.GetBool("enableFastReadbackWrites");
             disableSubgroupShuffle = ktSettings.GetBool("disableSubgroupShuffle");
@@ -0,0 +1,86 @@
+// SPDX-License-Identifier: MPL-2.0
+// Copyright © 2023 Skyline Team and Contributors (https://github.com/skyline-emu/)
+
+#include "utils.h"
+#include "boot_profiler.h"
+
+namespace skyline {
+    BootProfiler BootProfile;
+
+    static constexpr std::array<const char *, static_cast<size_t>(BootProfiler::Stage::Count)> StageNames{
+        "Vulkan Device Creation",
+        "Service Manager",
+        "Key Loading",
+        "ROM Parsing",
+        "GPU Initialisation",
+        "Pipeline Cache Warmup",
+        "Executable Loading",
+        "Code Patching",
+        "First Frame",
+    };
+
+    BootProfiler::ScopedStage::ScopedStage(Stage stage) : stage{stage}, startNs{util::GetTimeNs()} {}
+
+    BootProfiler::ScopedStage::~ScopedStage() {
+        BootProfile.AddStageTime(stage, startNs, util::GetTimeNs() - startNs);
+    }
+
+    void BootProfiler::Begin() {
+        std::scoped_lock lock{mutex};
+        stages = {};
+        bootStartNs = util::GetTimeNs();
+        bootDurationNs = 0;
+        guestStartNs = 0;
+        running = true;
+    }
+
+    void BootProfiler::AddStageTime(Stage stage, i64 startNs, i64 durationNs) {
+        if (!IsRunning())
+            return;
+
+        std::scoped_lock lock{mutex};
+        auto &timing{stages[static_cast<size_t>(stage)]};
+        if (timing.firstStartNs == -1)
+            timing.firstStartNs = startNs - bootStartNs;
+        timing.durationNs += durationNs;
+        timing.occurrences++;
+    }
+
+    void BootProfiler::MarkGuestStart() {
+        std::scoped_lock lock{mutex};
+        guestStartNs = util::GetTimeNs();
+    }
+
+    void BootProfiler::Finish() {
+        if (!running.exchange(false))
+            return;
+
+        {
+            std::scoped_lock lock{mutex};
+            auto endNs{util::GetTimeNs()};
+            if (guestStartNs)
+                stages[static_cast<size_t>(Stage::FirstFrame)] = StageTiming{guestStartNs - bootStartNs, endNs - guestStartNs, 1};
+            bootDurationNs = endNs - bootStartNs;
+        }
+
+        Logger::Info("Boot Profile:\n{}", GetSummary());
+    }
+
+    std::string BootProfiler::GetSummary() {
+        std::scoped_lock lock{mutex};
+        if (!bootDurationNs)
+            return {};
+
+        auto toMs{[](i64 ns) { return static_cast<double>(ns) / constant::NsInMillisecond; }};
+
+        std::string summary{"Stage,Start (ms),Duration (ms),Occurrences\n"};
+        for (size_t index{}; index < stages.size(); index++) {
+            const auto &timing{stages[index]};
+            if (timing.occurrences)
+                summary += fmt::format("{},{:.2f},{:.2f},{}\n", StageNames[index], toMs(timing.firstStartNs), toMs(timing.durationNs), timing.occurrences);
+        }
+        summary += fmt::format("Total,0.00,{:.2f},1", toMs(bootDurationNs));
+
+        return summary;
+    }
+}
@@ -0,0 +1,90 @@
+// SPDX-License-Identifier: MPL-2.0
+// Copyright © 2023 Skyline Team and Contributors (https://github.com/skyline-emu/)
+
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <common.h>
+
+namespace skyline {
+    /**
+     * @brief Records wall-clock timings of each stage of booting a title, a summary is logged once the first frame is presented
+     * @note Stages can nest and occur multiple times (e.g. code patching within executable loading for every executable), the time of each occurrence is accumulated
+     */
+    class BootProfiler {
+      public:
+        enum class Stage : u8 {
+            VulkanDeviceCreation, //!< Loading the Vulkan driver, creating the device and querying its traits
+            ServiceManager, //!< Constructing the HLE service manager
+            KeyLoading, //!< Loading and parsing the keys in the KeyStore
+            RomParsing, //!< Parsing the ROM container and the NCAs inside it
+            GpuInitialisation, //!< Creating the per-title GPU state such as the shader and pipeline caches
+            PipelineCacheWarmup, //!< Compiling all pipelines from the on-disk pipeline cache
+            ExecutableLoading, //!< Loading, decompressing and mapping all executables
+            CodePatching, //!< Patching executables for NCE
+            FirstFrame, //!< From the start of guest execution until the first frame is presented
+            Count,
+        };
+
+      private:
+        struct StageTiming {
+            i64 firstStartNs{-1}; //!< The time at which the first occurrence of the stage began relative to the start of the boot or -1 if it never occurred
+            i64 durationNs{}; //!< The accumulated duration of all occurrences of the stage
+            u32 occurrences{};
+        };
+
+        std::mutex mutex;
+        std::array<StageTiming, static_cast<size_t>(Stage::Count)> stages{};
+        i64 bootStartNs{};
+        i64 guestStartNs{}; //!< The time at which guest execution started
+        i64 bootDurationNs{};
+        std::atomic<bool> running{}; //!< If a boot is currently being profiled, this is cleared once the first frame is presented
+
+      public:
+        /**
+         * @brief An RAII timer for a single occurrence of a stage
+         */
+        class ScopedStage {
+          private:
+            Stage stage;
+            i64 startNs;
+
+          public:
+            ScopedStage(Stage stage);
+
+            ~ScopedStage();
+        };
+
+        /**
+         * @brief Resets all timings and marks the start of a new boot
+         */
+        void Begin();
+
+        /**
+         * @brief Records an occurrence of a stage with the supplied start time and duration
+         */
+        void AddStageTime(Stage stage, i64 startNs, i64 durationNs);
+
+        /**
+         * @brief Marks the start of guest execution, the time from this until the first frame is recorded as Stage::FirstFrame
+         */
+        void MarkGuestStart();
+
+        /**
+         * @brief Ends profiling of the current boot and logs its summary, this is a no-op if there's no boot being profiled
+         */
+        void Finish();
+
+        bool IsRunning() {
+            return running.load(std::memory_order_relaxed);
+        }
+
+        /**
+         * @return A summary of the last finished boot as a table in CSV format or an empty string if no boot has finished yet
+         */
+        std::string GetSummary();
+    };
+
+    extern BootProfiler BootProfile; //!< The boot profiler of the emulator
+}
@@ -94,6 +94,24 @@ namespace skyline {
             return item;
         }
 
+        /**
+         * @return The oldest item in the queue if there are any, this doesn't block unlike Pop()
+         */
+        std::optional<Type> TryPop() {
+            std::scoped_lock comsumptionLock{consumptionMutex};
+            if (start == end)
+                return std::nullopt;
+
+            auto next{start + 1};
+            next = (next == reinterpret_cast<Type *>(vector.end().base())) ? reinterpret_cast<Type *>(vector.begin().base()) : next;
+            std::optional<Type> item{std::move(*next)};
+            start = next;
+
+            consumeCondition.notify_one();
+
+            return item;
+        }
+
         void Push(const Type &item) {
             Type *waitNext{};
             Type *waitEnd{};
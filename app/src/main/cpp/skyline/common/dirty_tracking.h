@@ -3,6 +3,7 @@
 
 #pragma once
 
+#include <bit>
 #include "base.h"
 #include "exception.h"
 #include "logger.h"
@@ -12,6 +13,64 @@ namespace skyline::dirty {
     template<size_t, size_t, size_t>
     class Manager;
 
+    /**
+     * @brief A reference to a single bit of a `Bitmap`, this is type-erased so it can be stored in handles regardless of the bitmap size
+     */
+    struct BitmapSlot {
+        u64 *bits{}; //!< The backing of the bitmap, the first word is the summary of all following words
+        u32 index{};
+
+        /**
+         * @return The slot `offset` bits after this one, this allows for a slot to be used as a source for `util::MergeInto`
+         */
+        BitmapSlot operator[](u32 offset) const {
+            return {bits, index + offset};
+        }
+
+        void Set() const {
+            if (bits) {
+                u32 word{index / 64};
+                bits[0] |= 1ULL << word;
+                bits[word + 1] |= 1ULL << (index % 64);
+            }
+        }
+    };
+
+    /**
+     * @brief A two-level bitmap of dirty states, this allows for only the dirty states out of a large set to be visited without checking each of them
+     */
+    template<size_t Count>
+    class Bitmap {
+      private:
+        static constexpr size_t WordCount{(Count + 63) / 64};
+        static_assert(WordCount <= 64, "The summary word can only track 64 words");
+
+        std::array<u64, WordCount + 1> bits{}; //!< A summary word with a bit set for each word with any set bits, followed by the words themselves
+
+      public:
+        BitmapSlot GetSlot(u32 index) {
+            return {bits.data(), index};
+        }
+
+        /**
+         * @brief Calls `func` with the index of every set bit in ascending order, clearing them in the process
+         */
+        template<typename Func>
+        void ConsumeSet(Func &&func) {
+            u64 summary{std::exchange(bits[0], 0)};
+            while (summary) {
+                u32 word{static_cast<u32>(std::countr_zero(summary))};
+                summary &= summary - 1;
+
+                u64 wordBits{std::exchange(bits[word + 1], 0)};
+                while (wordBits) {
+                    func(word * 64 + static_cast<u32>(std::countr_zero(wordBits)));
+                    wordBits &= wordBits - 1;
+                }
+            }
+        }
+    };
+
     /**
      * @brief An opaque handle to a dirty subresource
      */
@@ -20,10 +79,18 @@ namespace skyline::dirty {
         template<size_t, size_t, size_t>
         friend class Manager;
 
-        bool *dirtyPtr; //!< Underlying target ptr
+        bool *dirtyPtr{}; //!< Underlying target ptr
+        BitmapSlot bitmapSlot{}; //!< An optional bitmap bit that is set alongside the target
+
+        void MarkDirty() const {
+            *dirtyPtr = true;
+            bitmapSlot.Set();
+        }
 
       public:
-        explicit Handle(bool *dirtyPtr) : dirtyPtr{dirtyPtr} {}
+        Handle() = default;
+
+        explicit Handle(bool *dirtyPtr, BitmapSlot bitmapSlot = {}) : dirtyPtr{dirtyPtr}, bitmapSlot{bitmapSlot} {}
     };
 
     /**
@@ -39,26 +106,26 @@ namespace skyline::dirty {
         struct BindingState {
             enum class Type : u32 {
                 None, //!< No handles are bound
-                Inline, //!< `inlineDirtyPtr` contains a pointer to the single bound handle for the entry
-                OverlapSpan, //!< `overlapSpanDirtyPtrs` contains an array of pointers to handles bound to the entry
+                Inline, //!< `inlineHandle` contains the single bound handle for the entry
+                OverlapSpan, //!< `overlapSpanHandles` contains an array of handles bound to the entry
             } type{Type::None};
-            u32 overlapSpanSize{}; //!< Size of the array that overlapSpanDirtyPtrs points to
+            u32 overlapSpanSize{}; //!< Size of the array that overlapSpanHandles points to
 
             union {
-                bool *inlineDirtyPtr;
-                bool **overlapSpanDirtyPtrs;
+                Handle inlineHandle;
+                Handle *overlapSpanHandles{};
             };
 
             /**
-             * @return An array of pointers to handles bound to the entry
+             * @return An array of handles bound to the entry
              */
-            span<bool *> GetOverlapSpan() {
-                return {overlapSpanDirtyPtrs, overlapSpanSize};
+            span<Handle> GetOverlapSpan() {
+                return {overlapSpanHandles, overlapSpanSize};
             }
         };
 
-        std::array<bool *, OverlapPoolSize> overlapPool{}; //!< Backing pool for `overlapSpanDirtyPtrs` in entry
-        bool **freeOverlapPtr{}; //!< Pointer to the next free entry in `overlapPool`
+        std::array<Handle, OverlapPoolSize> overlapPool{}; //!< Backing pool for `overlapSpanHandles` in entry
+        Handle *freeOverlapPtr{}; //!< Pointer to the next free entry in `overlapPool`
         
         std::array<BindingState, ManagedResourceSize / Granularity> states{}; //!< The dirty binding states for the entire managed resource
 
@@ -96,15 +163,15 @@ namespace skyline::dirty {
                 
                 if (state.type == BindingState::Type::None) {
                     state.type = BindingState::Type::Inline;
-                    state.inlineDirtyPtr = handle.dirtyPtr;
+                    state.inlineHandle = handle;
                 } else if (state.type == BindingState::Type::Inline) {
                     state.type = BindingState::Type::OverlapSpan;
 
-                    // Save the old inline dirty pointer since we'll need to insert it into the new overlap span and setting the overlap span ptr will overwrite it
-                    bool *origDirtyPtr{state.inlineDirtyPtr};
+                    // Save the old inline handle since we'll need to insert it into the new overlap span and setting the overlap span ptr will overwrite it
+                    Handle origHandle{state.inlineHandle};
 
                     // Point to a new pool allocation that can hold the overlap
-                    state.overlapSpanDirtyPtrs = freeOverlapPtr;
+                    state.overlapSpanHandles = freeOverlapPtr;
                     state.overlapSpanSize = 2; // Existing inline handle + our new handle
 
                     // Check if the pool allocation is valid
@@ -112,14 +179,14 @@ namespace skyline::dirty {
                         throw exception("Dirty overlap pool is full");
 
                     // Write overlap to our new pool allocation
-                    *freeOverlapPtr++ = origDirtyPtr;
-                    *freeOverlapPtr++ = handle.dirtyPtr;
+                    *freeOverlapPtr++ = origHandle;
+                    *freeOverlapPtr++ = handle;
                 } else if (state.type == BindingState::Type::OverlapSpan) {
                     auto originalOverlapSpan{state.GetOverlapSpan()};
 
                     // Point to a new pool allocation that can hold all the old overlaps + our new overlap
                     state.overlapSpanSize++;
-                    state.overlapSpanDirtyPtrs = freeOverlapPtr;
+                    state.overlapSpanHandles = freeOverlapPtr;
 
                     // Check if the pool allocation is valid
                     if (freeOverlapPtr + state.overlapSpanSize >= overlapPool.end())
@@ -128,7 +195,7 @@ namespace skyline::dirty {
                     // Write all overlaps to our new pool allocation
                     auto newOverlapSpan{state.GetOverlapSpan()};
                     newOverlapSpan.copy_from(originalOverlapSpan); // Copy old overlaps
-                    *newOverlapSpan.last(1).data() = handle.dirtyPtr; // Write new overlap
+                    *newOverlapSpan.last(1).data() = handle; // Write new overlap
                     freeOverlapPtr += state.overlapSpanSize;
                 }
             }
@@ -153,10 +220,32 @@ namespace skyline::dirty {
             if (state.type == BindingState::Type::None) [[likely]] {
                 return;
             } else if (state.type == BindingState::Type::Inline) {
-                *state.inlineDirtyPtr = true;
+                state.inlineHandle.MarkDirty();
             } else if (state.type == BindingState::Type::OverlapSpan) [[unlikely]] {
-                for (auto &dirtyPtr : state.GetOverlapSpan())
-                    *dirtyPtr = true;
+                for (const auto &handle : state.GetOverlapSpan())
+                    handle.MarkDirty();
+            }
+        }
+
+        /**
+         * @brief Marks a contiguous range of the managed resource as dirty in a single pass
+         * @note Subresources generally span several consecutive entries, repeated handles in the range are only written to once
+         * @note This *MUST NOT* be called after any bound handles have been destroyed
+         */
+        void MarkDirty(size_t index, size_t count) {
+            bool *lastDirtyPtr{};
+            for (auto &state : span(states).subspan(index, count)) {
+                if (state.type == BindingState::Type::None) [[likely]] {
+                    continue;
+                } else if (state.type == BindingState::Type::Inline) {
+                    if (state.inlineHandle.dirtyPtr != lastDirtyPtr) {
+                        lastDirtyPtr = state.inlineHandle.dirtyPtr;
+                        state.inlineHandle.MarkDirty();
+                    }
+                } else if (state.type == BindingState::Type::OverlapSpan) [[unlikely]] {
+                    for (const auto &handle : state.GetOverlapSpan())
+                        handle.MarkDirty();
+                }
             }
         }
     };
@@ -202,20 +291,29 @@ namespace skyline::dirty {
     template<typename T> requires (std::is_base_of_v<ManualDirty, T>)
     class ManualDirtyState {
       private:
-        T value; //!< The underlying object
         bool dirty{true}; //!< Whether the value is dirty
+        BitmapSlot bitmapSlot; //!< An optional bitmap bit that is set whenever the value is marked dirty
+        T value; //!< The underlying object
 
         /**
          * @return An opaque handle that can be used to modify dirty state
          */
         Handle GetDirtyHandle() {
-            return Handle{&dirty};
+            return Handle{&dirty, bitmapSlot};
         }
 
       public:
         template<typename... Args>
         ManualDirtyState(Args &&... args) : value{GetDirtyHandle(), std::forward<Args>(args)...} {}
 
+        /**
+         * @param bitmapSlot A bit that will be set whenever the value is marked dirty, this allows the owner to only update dirty values
+         */
+        template<typename... Args>
+        ManualDirtyState(BitmapSlot bitmapSlot, Args &&... args) : bitmapSlot{bitmapSlot}, value{GetDirtyHandle(), std::forward<Args>(args)...} {
+            bitmapSlot.Set();
+        }
+
         /**
          * @brief Cleans the object of its dirty state and refreshes it if necessary
          * @note This *MUST* be called before any accesses to the underlying object without *ANY* calls to `MarkDirty()` in between
@@ -237,6 +335,7 @@ namespace skyline::dirty {
          */
         void MarkDirty(bool purgeCaches) {
             dirty = true;
+            bitmapSlot.Set();
 
             if constexpr (std::is_base_of_v<CachedManualDirty, T>)
                 if (purgeCaches)
@@ -0,0 +1,161 @@
+// SPDX-License-Identifier: MPL-2.0
+// Copyright © 2022 Skyline Team and Contributors (https://github.com/skyline-emu/)
+
+#include <fstream>
+#include <sstream>
+#include <sys/resource.h>
+#include "host_affinity.h"
+
+namespace skyline {
+    /**
+     * @return The value of a numeric sysfs attribute or 0 if it couldn't be read
+     */
+    static u64 ReadSysfsValue(const std::string &path) {
+        std::ifstream file{path};
+        u64 value{};
+        if (!(file >> value))
+            return 0;
+        return value;
+    }
+
+    /**
+     * @return The IDs of all cores that could be brought online, this is parsed from a list of ranges such as "0-3,6"
+     */
+    static std::vector<u32> ReadPossibleCores() {
+        std::ifstream file{"/sys/devices/system/cpu/possible"};
+        std::string list;
+        if (!std::getline(file, list))
+            return {};
+
+        std::vector<u32> cores;
+        std::stringstream stream{list};
+        for (std::string range; std::getline(stream, range, ',');) {
+            auto separator{range.find('-')};
+            u32 first{static_cast<u32>(std::stoul(range.substr(0, separator)))};
+            u32 last{separator == std::string::npos ? first : static_cast<u32>(std::stoul(range.substr(separator + 1)))};
+            for (u32 core{first}; core <= last && core < CPU_SETSIZE; core++)
+                cores.push_back(core);
+        }
+        return cores;
+    }
+
+    void HostAffinity::Initialize(bool enable) {
+        enabled = false;
+        if (!enable)
+            return;
+
+        struct HostCore {
+            u32 id;
+            u64 capacity; //!< The relative performance of the core, cores with the same capacity are in the same cluster
+        };
+        std::vector<HostCore> cores;
+        try {
+            for (u32 id : ReadPossibleCores()) {
+                auto basePath{fmt::format("/sys/devices/system/cpu/cpu{}/", id)};
+                u64 capacity{ReadSysfsValue(basePath + "cpu_capacity")};
+                if (!capacity)
+                    capacity = ReadSysfsValue(basePath + "cpufreq/cpuinfo_max_freq");
+                cores.push_back({id, capacity});
+            }
+        } catch (const std::exception &e) {
+            Logger::Warn("Failed to parse the host CPU topology: {}", e.what());
+            return;
+        }
+
+        // Order cores from the fastest to the slowest, the order of cores within a cluster is preserved so guest cores are pinned deterministically
+        std::stable_sort(cores.begin(), cores.end(), [](const HostCore &a, const HostCore &b) { return a.capacity > b.capacity; });
+        if (cores.empty() || !cores.back().capacity || cores.front().capacity == cores.back().capacity) {
+            Logger::Info("Host CPU topology is unknown or symmetric, host threads won't be placed");
+            return;
+        }
+
+        CPU_ZERO(&performanceSet);
+        CPU_ZERO(&littleSet);
+        std::vector<u32> performanceCores;
+        for (const auto &core : cores) {
+            if (core.capacity == cores.back().capacity) {
+                CPU_SET(core.id, &littleSet);
+            } else {
+                CPU_SET(core.id, &performanceSet);
+                performanceCores.push_back(core.id);
+            }
+        }
+
+        // Each application core gets a dedicated performance core if there's enough of them, the system core is treated as a background thread
+        constexpr u8 ApplicationCoreCount{GuestCoreCount - 1};
+        bool dedicatedCores{performanceCores.size() >= ApplicationCoreCount};
+        for (u8 guestCore{}; guestCore < GuestCoreCount; guestCore++) {
+            auto &set{guestCoreSets[guestCore]};
+            if (guestCore == ApplicationCoreCount) {
+                set = littleSet;
+            } else if (dedicatedCores) {
+                CPU_ZERO(&set);
+                CPU_SET(performanceCores[guestCore], &set);
+            } else {
+                set = performanceSet;
+            }
+        }
+
+        if (dedicatedCores && performanceCores.size() > ApplicationCoreCount) {
+            CPU_ZERO(&gpuChannelSet);
+            for (size_t i{ApplicationCoreCount}; i < performanceCores.size(); i++)
+                CPU_SET(performanceCores[i], &gpuChannelSet);
+        } else {
+            gpuChannelSet = performanceSet;
+        }
+
+        Logger::Info("Placing host threads on {} performance cores and {} little cores", CPU_COUNT(&performanceSet), CPU_COUNT(&littleSet));
+        enabled = true;
+    }
+
+    void HostAffinity::PlaceCurrentThread(HostThreadRole role, u8 guestCore) {
+        if (!enabled)
+            return;
+
+        const cpu_set_t &set{[&]() -> const cpu_set_t & {
+            switch (role) {
+                case HostThreadRole::GuestCore:
+                    return guestCoreSets.at(guestCore);
+                case HostThreadRole::GpuChannel:
+                    return gpuChannelSet;
+                case HostThreadRole::CommandRecord:
+                    return performanceSet;
+                case HostThreadRole::Background:
+                case HostThreadRole::Audio:
+                    return littleSet;
+            }
+            return performanceSet;
+        }()};
+
+        if (sched_setaffinity(0, sizeof(cpu_set_t), &set))
+            Logger::Warn("Failed to set the affinity of the current thread: {}", strerror(errno));
+
+        if (role == HostThreadRole::Audio && setpriority(PRIO_PROCESS, 0, AudioThreadPriority))
+            Logger::Warn("Failed to set the priority of the current thread: {}", strerror(errno));
+    }
+
+    HostAffinity::ScopedPlacement::ScopedPlacement(HostThreadRole role) {
+        if (!enabled)
+            return;
+
+        errno = 0;
+        previousPriority = getpriority(PRIO_PROCESS, 0); // Note: -1 is a valid priority so errno must be checked instead
+        if (errno || sched_getaffinity(0, sizeof(cpu_set_t), &previousSet)) {
+            Logger::Warn("Failed to retrieve the placement of the current thread: {}", strerror(errno));
+            return;
+        }
+
+        PlaceCurrentThread(role);
+        placed = true;
+    }
+
+    HostAffinity::ScopedPlacement::~ScopedPlacement() {
+        if (!placed)
+            return;
+
+        if (sched_setaffinity(0, sizeof(cpu_set_t), &previousSet))
+            Logger::Warn("Failed to restore the affinity of the current thread: {}", strerror(errno));
+        if (setpriority(PRIO_PROCESS, 0, previousPriority))
+            Logger::Warn("Failed to restore the priority of the current thread: {}", strerror(errno));
+    }
+}
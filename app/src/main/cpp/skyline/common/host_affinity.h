@@ -0,0 +1,67 @@
+// SPDX-License-Identifier: MPL-2.0
+// Copyright © 2022 Skyline Team and Contributors (https://github.com/skyline-emu/)
+
+#pragma once
+
+#include <sched.h>
+#include <common.h>
+
+namespace skyline {
+    /**
+     * @brief The roles of host threads that are placed onto specific host cores
+     */
+    enum class HostThreadRole {
+        GuestCore, //!< A thread running guest code on an emulated CPU core
+        GpuChannel, //!< A thread processing the GPFIFO of a GPU channel
+        CommandRecord, //!< A thread recording GPU executions into Vulkan command buffers
+        Background, //!< A latency-insensitive thread which shouldn't occupy any performance cores
+        Audio, //!< A thread processing or outputting audio, these are light enough for the little cores but are run at a higher priority to avoid underruns
+    };
+
+    /**
+     * @brief A policy for placing host threads onto host cores according to their role, this avoids Android migrating latency-sensitive threads onto little cores
+     * @note The topology is read from sysfs at initialization, cores are grouped into clusters by their capacity (or maximum frequency when that's unavailable) with all but the slowest cluster being performance cores
+     * @note Guest cores 0-2 are each pinned to a single performance core starting from the fastest as only one guest thread can run on an emulated core at a time, the system core is placed on the little cores
+     */
+    class HostAffinity {
+      private:
+        static constexpr u8 GuestCoreCount{4}; //!< The amount of emulated cores, this matches `constant::CoreCount`
+
+        inline static bool enabled{}; //!< If placement is enabled and the host has more than a single cluster of cores
+        inline static std::array<cpu_set_t, GuestCoreCount> guestCoreSets{};
+        inline static cpu_set_t performanceSet{}; //!< All cores that aren't in the slowest cluster
+        inline static cpu_set_t gpuChannelSet{}; //!< Performance cores that aren't pinned to a guest core, this is equivalent to the performance set if there aren't any
+        inline static cpu_set_t littleSet{}; //!< All cores in the slowest cluster
+        static constexpr int AudioThreadPriority{-16}; //!< The nice value of audio threads, this matches ANDROID_PRIORITY_AUDIO
+
+      public:
+        /**
+         * @brief Reads the host CPU topology and determines the placement of every thread role
+         * @param enable If threads should be placed at all, placement will also be disabled if the topology can't be determined or is symmetric
+         * @note This must be called prior to any threads being placed
+         */
+        static void Initialize(bool enable);
+
+        /**
+         * @brief Sets the affinity of the calling thread according to its role
+         * @param guestCore The emulated core that the thread is running on, this is only used for guest core threads
+         */
+        static void PlaceCurrentThread(HostThreadRole role, u8 guestCore = 0);
+
+        /**
+         * @brief Temporarily places the calling thread according to a role so that any threads created by it inherit the placement, the prior placement is restored on destruction
+         * @note This is used for threads that are created by libraries and can't be placed directly, such as the ones created by the audio core
+         */
+        class ScopedPlacement {
+          private:
+            bool placed{}; //!< If the thread was placed and needs to be restored
+            cpu_set_t previousSet{};
+            int previousPriority{};
+
+          public:
+            ScopedPlacement(HostThreadRole role);
+
+            ~ScopedPlacement();
+        };
+    };
+}
@@ -0,0 +1,100 @@
+// SPDX-License-Identifier: MPL-2.0
+// Copyright © 2023 Skyline Team and Contributors (https://github.com/skyline-emu/)
+
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <algorithm>
+#include <pthread.h>
+#include <fmt/format.h>
+#include "logger.h"
+#include "utils.h"
+#include "lock_profiler.h"
+
+namespace skyline::lock_profiler {
+    static constexpr auto ReportInterval{std::chrono::seconds(10)}; //!< The interval at which the most contended lock sites are logged
+    static constexpr size_t ReportedSiteCount{10}; //!< The amount of sites included in each periodic report
+
+    LockSite::LockSite(const char *type, const char *file, const char *function, u32 line) : type{type}, file{file}, function{function}, line{line} {}
+
+    void LockSite::RecordContention(i64 durationNs) {
+        contendedAcquisitions.fetch_add(1, std::memory_order_relaxed);
+        spinNs.fetch_add(durationNs, std::memory_order_relaxed);
+
+        i64 maxNs{maxSpinNs.load(std::memory_order_relaxed)};
+        while (durationNs > maxNs && !maxSpinNs.compare_exchange_weak(maxNs, durationNs, std::memory_order_relaxed));
+    }
+
+    /**
+     * @brief All lock sites that have been constructed, sites are never removed so pointers to them remain valid
+     * @note This is intentionally leaked to avoid destruction order issues with locks that are destroyed during static destruction
+     */
+    struct SiteRegistry {
+        std::mutex mutex; //!< This must not be a spin lock as it's used during the construction of every spin lock
+        std::deque<LockSite> sites;
+        std::thread reporter;
+
+        SiteRegistry() : reporter{[this] { ReportLoop(); }} {
+            reporter.detach();
+        }
+
+        [[noreturn]] void ReportLoop() {
+            pthread_setname_np(pthread_self(), "Sky-LockProf");
+            while (true) {
+                std::this_thread::sleep_for(ReportInterval);
+
+                auto report{GetReport(ReportedSiteCount)};
+                if (!report.empty())
+                    Logger::Info("Lock Contention:\n{}", report);
+            }
+        }
+    };
+
+    static SiteRegistry &GetRegistry() {
+        static auto registry{new SiteRegistry{}};
+        return *registry;
+    }
+
+    LockSite *GetLockSite(const char *type, const char *file, const char *function, u32 line) {
+        auto &registry{GetRegistry()};
+        std::scoped_lock lock{registry.mutex};
+
+        // The strings are compared by value as the same location in a header may be represented by a different literal in each translation unit
+        auto it{std::find_if(registry.sites.begin(), registry.sites.end(), [&](const LockSite &site) {
+            return site.line == line && std::string_view{site.file} == file && std::string_view{site.function} == function && std::string_view{site.type} == type;
+        })};
+        if (it != registry.sites.end())
+            return &*it;
+
+        return &registry.sites.emplace_back(type, file, function, line);
+    }
+
+    std::string GetReport(size_t maxSites) {
+        auto &registry{GetRegistry()};
+        std::vector<LockSite *> sites;
+        {
+            std::scoped_lock lock{registry.mutex};
+            for (auto &site : registry.sites)
+                if (site.contendedAcquisitions.load(std::memory_order_relaxed))
+                    sites.push_back(&site);
+        }
+
+        if (sites.empty())
+            return {};
+
+        std::sort(sites.begin(), sites.end(), [](LockSite *a, LockSite *b) {
+            return a->spinNs.load(std::memory_order_relaxed) > b->spinNs.load(std::memory_order_relaxed);
+        });
+        if (sites.size() > maxSites)
+            sites.resize(maxSites);
+
+        auto toMs{[](i64 ns) { return static_cast<double>(ns) / constant::NsInMillisecond; }};
+
+        std::string report{"Type,Site,Contended Acquisitions,Spin (ms),Max Spin (ms)"};
+        for (auto site : sites)
+            report += fmt::format("\n{},{}:{} ({}),{},{:.3f},{:.3f}", site->type, site->file, site->line, site->function, site->contendedAcquisitions.load(std::memory_order_relaxed),
+                                  toMs(site->spinNs.load(std::memory_order_relaxed)), toMs(site->maxSpinNs.load(std::memory_order_relaxed)));
+
+        return report;
+    }
+}
@@ -0,0 +1,42 @@
+// SPDX-License-Identifier: MPL-2.0
+// Copyright © 2023 Skyline Team and Contributors (https://github.com/skyline-emu/)
+
+#pragma once
+
+#include <atomic>
+#include <string>
+#include "base.h"
+
+namespace skyline::lock_profiler {
+    /**
+     * @brief Contention statistics of all locks constructed at a single source location
+     * @note Locks are attributed to the site of their construction rather than the site of their acquisition as they're almost always acquired through std::scoped_lock or std::unique_lock, for a lock that's a class member this is the constructor of the owning class
+     */
+    struct LockSite {
+        const char *type; //!< The name of the lock class
+        const char *file;
+        const char *function;
+        u32 line;
+        std::atomic<u64> contendedAcquisitions{}; //!< The amount of acquisitions that couldn't immediately acquire the lock
+        std::atomic<i64> spinNs{}; //!< The total time spent spinning on contended acquisitions
+        std::atomic<i64> maxSpinNs{}; //!< The longest time spent spinning on a single acquisition
+
+        LockSite(const char *type, const char *file, const char *function, u32 line);
+
+        /**
+         * @brief Records a contended acquisition of a lock from this site
+         */
+        void RecordContention(i64 durationNs);
+    };
+
+    /**
+     * @return The site for locks of the supplied type constructed at the supplied location, the returned pointer is valid for the lifetime of the process
+     * @note The first call to this starts a thread which periodically logs the most contended sites
+     */
+    LockSite *GetLockSite(const char *type, const char *file, const char *function, u32 line);
+
+    /**
+     * @return A table of the most contended lock sites in CSV format, sorted by their total spin time
+     */
+    std::string GetReport(size_t maxSites);
+}
@@ -3,28 +3,131 @@
 
 #include <android/log.h>
 #include "utils.h"
+#include "mpsc_queue.h"
 #include "logger.h"
 
 namespace skyline {
+    /**
+     * @brief A message or flush request that's handed off to the logger thread
+     * @note Messages which don't fit inline are copied into a heap allocation that's freed by the logger thread, this is rare as the vast majority of messages are short
+     */
+    struct LogRecord {
+        Logger::LoggerContext *context;
+        std::atomic<bool> *flushed; //!< If this is non-null then the record is a flush request and the flag is set once all prior records have been written out
+        i64 timestamp; //!< The time at which the message was written relative to the start of the context in milliseconds
+        Logger::LogLevel level;
+        std::array<char, 16> threadName;
+        u32 length;
+        Logger::RawFormatter formatter; //!< If this is non-null then the message is a raw payload which must be formatted with this prior to being written out
+        char *overflow; //!< A null-terminated heap copy of the message if it's too long to be stored inline
+        std::array<char, 208> message; //!< A null-terminated copy of the message if it fits
+    };
+
+    /**
+     * @brief The logger thread and the queue of records that it writes out
+     * @note This is intentionally leaked as messages may be written during static destruction
+     */
+    struct LogWriter {
+        static constexpr size_t QueueSize{2048}; //!< The maximum amount of records in flight, any producers past this will block till the logger thread catches up
+        MpscQueue<LogRecord> queue{QueueSize};
+
+        LogWriter() {
+            std::thread(&LogWriter::Run, this).detach();
+        }
+
+        [[noreturn]] void Run() {
+            if (int result{pthread_setname_np(pthread_self(), "Sky-Logger")})
+                Logger::WriteAndroid(Logger::LogLevel::Warn, fmt::format("Failed to set the thread name: {}", strerror(result)));
+
+            queue.Process([](LogRecord &record) {
+                if (record.flushed) {
+                    if (record.context) {
+                        std::scoped_lock lock{record.context->mutex};
+                        record.context->logFile.flush();
+                    }
+                    record.flushed->store(true, std::memory_order_release);
+                    record.flushed->notify_all();
+                    return;
+                }
+
+                constexpr std::array<int, 5> levelAlog{ANDROID_LOG_ERROR, ANDROID_LOG_WARN, ANDROID_LOG_INFO, ANDROID_LOG_DEBUG, ANDROID_LOG_VERBOSE}; // This corresponds to LogLevel and provides its equivalent for NDK Logging
+                constexpr std::array<char, 5> levelCharacter{'E', 'W', 'I', 'D', 'V'}; // The LogLevel as written out to a file
+
+                const char *message{record.overflow ? record.overflow : record.message.data()};
+                std::string formatted;
+                if (record.formatter) {
+                    try {
+                        formatted = record.formatter(span<u8>{reinterpret_cast<u8 *>(const_cast<char *>(message)), record.length});
+                    } catch (const std::exception &e) {
+                        formatted = fmt::format("Failed to format raw log message: {}", e.what());
+                    }
+                    message = formatted.c_str();
+                    record.length = static_cast<u32>(formatted.size());
+                }
+
+                std::array<char, 32> tag{};
+                fmt::format_to_n(tag.data(), tag.size() - 1, "emu-cpp-{}", record.threadName.data());
+                __android_log_write(levelAlog[static_cast<u8>(record.level)], tag.data(), message);
+
+                if (record.context)
+                    // We use RS (\036) and GS (\035) as our delimiters
+                    record.context->Write(fmt::format("\036{}\035{}\035{}\035{}\n", levelCharacter[static_cast<u8>(record.level)], record.timestamp, record.threadName.data(), std::string_view{message, record.length}));
+
+                delete[] record.overflow;
+            }, [] {
+                // The log files are flushed whenever the logger thread is idle so that as little as possible is lost if the process is killed
+                for (auto *context : {&Logger::EmulationContext, &Logger::LoaderContext}) {
+                    std::scoped_lock lock{context->mutex};
+                    context->logFile.flush();
+                }
+            });
+        }
+    };
+
+    static LogWriter &GetLogWriter() {
+        static auto *writer{new LogWriter{}};
+        return *writer;
+    }
+
+    /**
+     * @brief Queues a flush request behind all records previously queued by the calling thread
+     * @param flushed A flag that will be set once the request has been processed, it must outlive the request
+     */
+    static void QueueFlush(Logger::LoggerContext *context, std::atomic<bool> &flushed) {
+        GetLogWriter().queue.Push(LogRecord{
+            .context = context,
+            .flushed = &flushed,
+        });
+    }
+
     void Logger::LoggerContext::Initialize(const std::string &path) {
         start = util::GetTimeNs() / constant::NsInMillisecond;
         logFile.open(path, std::ios::trunc);
     }
 
     void Logger::LoggerContext::Finalize() {
+        Flush();
         std::scoped_lock lock{mutex};
         logFile.close();
     }
 
     void Logger::LoggerContext::TryFlush() {
-        std::unique_lock lock(mutex, std::try_to_lock);
-        if (lock)
-            logFile.flush();
+        constexpr auto FlushTimeout{std::chrono::milliseconds(100)}; //!< The maximum duration to wait on the logger thread, it may be unable to make progress if the process is crashing
+
+        // The flag is static as the request may outlive this call if the logger thread doesn't process it in time
+        static std::atomic<bool> flushed;
+        flushed.store(false, std::memory_order_relaxed);
+        QueueFlush(this, flushed);
+
+        auto deadline{std::chrono::steady_clock::now() + FlushTimeout};
+        while (!flushed.load(std::memory_order_acquire) && std::chrono::steady_clock::now() < deadline)
+            std::this_thread::yield();
     }
 
     void Logger::LoggerContext::Flush() {
-        std::scoped_lock lock{mutex};
-        logFile.flush();
+        std::atomic<bool> flushed{};
+        QueueFlush(this, flushed);
+        flushed.wait(false, std::memory_order_acquire);
     }
 
     thread_local static std::string logTag, threadName;
@@ -55,13 +158,41 @@ namespace skyline {
         __android_log_write(levelAlog[static_cast<u8>(level)], logTag.c_str(), str.c_str());
     }
 
+    /**
+     * @brief Queues a record with a copy of the supplied data, a null terminator is always appended to the copy
+     */
+    static void QueueRecord(Logger::LogLevel level, span<const u8> data, Logger::RawFormatter formatter) {
+        if (logTag.empty())
+            Logger::UpdateTag();
+
+        LogRecord record{
+            .context = context,
+            .timestamp = context ? (util::GetTimeNs() / constant::NsInMillisecond) - context->start : 0,
+            .level = level,
+            .length = static_cast<u32>(data.size()),
+            .formatter = formatter,
+        };
+
+        std::strncpy(record.threadName.data(), threadName.c_str(), record.threadName.size() - 1);
+        char *destination;
+        if (data.size() < record.message.size()) [[likely]] {
+            destination = record.message.data();
+        } else {
+            record.overflow = new char[data.size() + 1];
+            destination = record.overflow;
+        }
+        std::memcpy(destination, data.data(), data.size());
+        destination[data.size()] = '\0';
+
+        GetLogWriter().queue.Push(record);
+    }
+
     void Logger::Write(LogLevel level, const std::string &str) {
-        constexpr std::array<char, 5> levelCharacter{'E', 'W', 'I', 'D', 'V'}; // The LogLevel as written out to a file
-        WriteAndroid(level, str);
+        QueueRecord(level, span<const u8>{reinterpret_cast<const u8 *>(str.data()), str.size()}, nullptr);
+    }
 
-        if (context)
-            // We use RS (\036) and GS (\035) as our delimiters
-            context->Write(fmt::format("\036{}\035{}\035{}\035{}\n", levelCharacter[static_cast<u8>(level)], (util::GetTimeNs() / constant::NsInMillisecond) - context->start, threadName, str));
+    void Logger::WriteRaw(LogLevel level, span<const u8> payload, RawFormatter formatter) {
+        QueueRecord(level, payload, formatter);
     }
 
     void Logger::LoggerContext::Write(const std::string &str) {
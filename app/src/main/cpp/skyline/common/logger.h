@@ -5,11 +5,12 @@
 
 #include <fstream>
 #include <mutex>
-#include "base.h"
+#include "span.h"
 
 namespace skyline {
     /**
      * @brief A wrapper around writing logs into a log file and logcat using Android Log APIs
+     * @note Messages are formatted on the calling thread but all output is done asynchronously by a dedicated logger thread, this avoids any I/O or lock contention on latency-sensitive threads
      */
     class Logger {
       private:
@@ -38,12 +39,24 @@ namespace skyline {
 
             void Initialize(const std::string &path);
 
+            /**
+             * @brief Writes out all prior messages from the calling thread and closes the log file
+             */
             void Finalize();
 
+            /**
+             * @brief Flushes all prior messages from the calling thread to the log file without waiting indefinitely on the logger thread, this is used in signal handlers
+             */
             void TryFlush();
 
+            /**
+             * @brief Waits for all prior messages from the calling thread to be written out and flushes the log file
+             */
             void Flush();
 
+            /**
+             * @note This must only be called from the logger thread
+             */
             void Write(const std::string &str);
         };
         static inline LoggerContext EmulationContext, LoaderContext;
@@ -57,10 +70,28 @@ namespace skyline {
 
         static void SetContext(LoggerContext *context);
 
+        /**
+         * @brief Synchronously writes a message to logcat with the tag of the calling thread
+         */
         static void WriteAndroid(LogLevel level, const std::string &str);
 
+        /**
+         * @brief Queues a message to be written to logcat and the log file of the current context by the logger thread
+         */
         static void Write(LogLevel level, const std::string &str);
 
+        /**
+         * @brief A function which converts a raw payload into a message, it's called on the logger thread with a copy of the payload
+         * @note Any exceptions thrown by this are caught and written out in place of the message
+         */
+        using RawFormatter = std::string (*)(span<u8> payload);
+
+        /**
+         * @brief Queues a raw binary payload which is only formatted into a message by the logger thread, this avoids any parsing or formatting on the calling thread
+         * @note The caller is expected to check the level against configLevel prior to calling this, the payload is copied and doesn't need to outlive the call
+         */
+        static void WriteRaw(LogLevel level, span<const u8> payload, RawFormatter formatter);
+
         /**
          * @brief A wrapper around a string which captures the calling function using Clang source location builtins
          * @note A function needs to be declared for every argument template specialization as CTAD cannot work with implicit casting
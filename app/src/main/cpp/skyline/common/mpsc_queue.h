@@ -0,0 +1,169 @@
+// SPDX-License-Identifier: MPL-2.0
+// Copyright © 2022 Skyline Team and Contributors (https://github.com/skyline-emu/)
+
+#pragma once
+
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#include <common/trace.h>
+#include <common.h>
+
+namespace skyline {
+    /**
+     * @brief A bounded lock-free multi-producer single-consumer queue, a side only enters the kernel to park on a futex when the queue is full or empty
+     * @note This is based on Dmitry Vyukov's bounded MPMC queue with the consumer side simplified to a single thread
+     * @url https://www.1024cores.net/home/lock-free-algorithms/queues/bounded-mpmc-queue
+     */
+    template<typename Type> requires std::is_trivially_copyable_v<Type>
+    class MpscQueue {
+      private:
+        struct Slot {
+            std::atomic<size_t> sequence; //!< The position this slot can next be produced into, or that position + 1 after it has been produced into
+            union {
+                Type item; //!< The item is left uninitialized till it's produced, this allows types without a default constructor
+            };
+
+            Slot() {}
+        };
+
+        std::unique_ptr<Slot[]> slots;
+        size_t mask; //!< The mask applied to positions to get the index of their slot, the amount of slots is always a power of two
+
+        alignas(64) std::atomic<size_t> tail{}; //!< The position of the next slot to be produced into, this is shared between all producers
+        alignas(64) size_t head{}; //!< The position of the next slot to be consumed, this is only accessed by the consumer
+        alignas(64) std::atomic<u32> consumerFutex{}; //!< Incremented to wake the consumer while it's parked
+        std::atomic<bool> consumerParked{};
+        alignas(64) std::atomic<u32> producerFutex{}; //!< Incremented to wake any producers parked on the queue being full
+        std::atomic<u32> parkedProducers{};
+
+        static void FutexWait(std::atomic<u32> &futex, u32 value) {
+            syscall(SYS_futex, reinterpret_cast<u32 *>(&futex), FUTEX_WAIT_PRIVATE, value, nullptr, nullptr, 0);
+        }
+
+        static void FutexWake(std::atomic<u32> &futex, int count) {
+            syscall(SYS_futex, reinterpret_cast<u32 *>(&futex), FUTEX_WAKE_PRIVATE, count, nullptr, nullptr, 0);
+        }
+
+        /**
+         * @return If the slot at the head of the queue has been produced into
+         */
+        bool HeadReady() {
+            return slots[head & mask].sequence.load(std::memory_order_acquire) == head + 1;
+        }
+
+        /**
+         * @brief Parks the consumer until the slot at the head of the queue has been produced into
+         * @note The flag is set prior to the final check of the slot and the producer checks the flag after publishing a slot, the fences ensure at least one of them observes the other
+         */
+        void WaitForItem() {
+            while (!HeadReady()) {
+                u32 value{consumerFutex.load(std::memory_order_acquire)};
+                consumerParked.store(true, std::memory_order_relaxed);
+                std::atomic_thread_fence(std::memory_order_seq_cst);
+                if (!HeadReady())
+                    FutexWait(consumerFutex, value);
+                consumerParked.store(false, std::memory_order_relaxed);
+            }
+        }
+
+        /**
+         * @brief Parks a producer until the supplied slot has been consumed
+         */
+        void WaitForSpace(Slot &slot, size_t position) {
+            u32 value{producerFutex.load(std::memory_order_acquire)};
+            parkedProducers.fetch_add(1, std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            if (static_cast<ptrdiff_t>(slot.sequence.load(std::memory_order_acquire) - position) < 0)
+                FutexWait(producerFutex, value);
+            parkedProducers.fetch_sub(1, std::memory_order_relaxed);
+        }
+
+        /**
+         * @brief Returns the slot at the head of the queue to the producers
+         */
+        void PopHead() {
+            slots[head & mask].sequence.store(head + mask + 1, std::memory_order_release);
+            head++;
+
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            if (parkedProducers.load(std::memory_order_relaxed)) [[unlikely]] {
+                producerFutex.fetch_add(1, std::memory_order_release);
+                FutexWake(producerFutex, std::numeric_limits<int>::max());
+            }
+        }
+
+      public:
+        /**
+         * @note The capacity of the queue is rounded up to the next power of two
+         */
+        MpscQueue(size_t size) : slots{std::make_unique<Slot[]>(std::bit_ceil(std::max<size_t>(size, 2)))}, mask{std::bit_ceil(std::max<size_t>(size, 2)) - 1} {
+            for (size_t i{}; i <= mask; i++)
+                slots[i].sequence.store(i, std::memory_order_relaxed);
+        }
+
+        MpscQueue(const MpscQueue &) = delete;
+
+        MpscQueue &operator=(const MpscQueue &) = delete;
+
+        /**
+         * @brief A blocking for-each that runs on every item and waits till new items to run on them as well, this must only be called from the consumer thread
+         * @param function A function that is called for each item (with the only parameter as a reference to that item)
+         * @param preWait A function that's called prior to waiting on more items to be queued
+         */
+        template<typename F1, typename F2>
+        [[noreturn]] void Process(F1 function, F2 preWait) {
+            TRACE_EVENT_BEGIN("containers", "MpscQueue::Process");
+
+            while (true) {
+                if (!HeadReady()) {
+                    TRACE_EVENT_END("containers");
+                    preWait();
+                    WaitForItem();
+                    TRACE_EVENT_BEGIN("containers", "MpscQueue::Process");
+                }
+
+                // The item is copied out so its slot can be reused by producers while it's being processed
+                Type item{slots[head & mask].item};
+                PopHead();
+                function(item);
+            }
+        }
+
+        void Push(const Type &item) {
+            size_t position{tail.load(std::memory_order_relaxed)};
+            while (true) {
+                auto &slot{slots[position & mask]};
+                auto difference{static_cast<ptrdiff_t>(slot.sequence.load(std::memory_order_acquire) - position)};
+                if (difference == 0) [[likely]] {
+                    if (tail.compare_exchange_weak(position, position + 1, std::memory_order_relaxed)) {
+                        slot.item = item;
+                        slot.sequence.store(position + 1, std::memory_order_release);
+                        break;
+                    }
+                } else if (difference < 0) {
+                    // The slot from the previous lap hasn't been consumed yet so the queue is full
+                    WaitForSpace(slot, position);
+                    position = tail.load(std::memory_order_relaxed);
+                } else {
+                    // Another producer claimed this position first
+                    position = tail.load(std::memory_order_relaxed);
+                }
+            }
+
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            if (consumerParked.load(std::memory_order_relaxed)) {
+                consumerFutex.fetch_add(1, std::memory_order_release);
+                FutexWake(consumerFutex, 1);
+            }
+        }
+
+        /**
+         * @note The appended elements may not necessarily be directly contiguous as another thread could push elements in between those in the span
+         */
+        void Append(span<Type> buffer) {
+            for (const auto &item : buffer)
+                Push(item);
+        }
+    };
+}
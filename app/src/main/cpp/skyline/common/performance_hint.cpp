@@ -0,0 +1,131 @@
+// SPDX-License-Identifier: MPL-2.0
+// Copyright © 2023 Skyline Team and Contributors (https://github.com/skyline-emu/)
+
+#include <dlfcn.h>
+#include <unistd.h>
+#include "performance_hint.h"
+
+namespace skyline {
+    i64 PerformanceHint::GetCpuTime(clockid_t clock) {
+        timespec time{};
+        if (clock_gettime(clock, &time))
+            return 0;
+        return (time.tv_sec * constant::NsInSecond) + time.tv_nsec;
+    }
+
+    void PerformanceHint::Initialize(bool enable) {
+        std::scoped_lock lock{mutex};
+        manager = nullptr;
+        if (!enable)
+            return;
+
+        void *libandroid{dlopen("libandroid.so", RTLD_NOW)};
+        if (!libandroid)
+            return;
+
+        auto getManager{reinterpret_cast<GetManagerFunction>(dlsym(libandroid, "APerformanceHint_getManager"))};
+        createSession = reinterpret_cast<CreateSessionFunction>(dlsym(libandroid, "APerformanceHint_createSession"));
+        updateTargetWorkDuration = reinterpret_cast<UpdateTargetWorkDurationFunction>(dlsym(libandroid, "APerformanceHint_updateTargetWorkDuration"));
+        reportActualWorkDuration = reinterpret_cast<ReportActualWorkDurationFunction>(dlsym(libandroid, "APerformanceHint_reportActualWorkDuration"));
+        closeSession = reinterpret_cast<CloseSessionFunction>(dlsym(libandroid, "APerformanceHint_closeSession"));
+        setThreads = reinterpret_cast<SetThreadsFunction>(dlsym(libandroid, "APerformanceHint_setThreads"));
+        if (!getManager || !createSession || !updateTargetWorkDuration || !reportActualWorkDuration || !closeSession) {
+            Logger::Info("Performance hints are unsupported on this device");
+            return;
+        }
+
+        manager = getManager();
+        if (!manager)
+            Logger::Warn("Failed to retrieve the performance hint manager");
+    }
+
+    void PerformanceHint::Finalize() {
+        std::scoped_lock lock{mutex};
+        if (session)
+            closeSession(std::exchange(session, nullptr));
+        threads.clear();
+        threadsChanged = false;
+        targetDurationNs = 0;
+    }
+
+    void PerformanceHint::RegisterCurrentThread() {
+        std::scoped_lock lock{mutex};
+        if (!manager)
+            return;
+
+        clockid_t clock{};
+        if (int result{pthread_getcpuclockid(pthread_self(), &clock)}) {
+            Logger::Warn("Failed to retrieve the CPU time clock of the current thread: {}", strerror(result));
+            return;
+        }
+
+        threads.push_back(HintThread{gettid(), clock, GetCpuTime(clock)});
+        threadsChanged = true;
+    }
+
+    void PerformanceHint::UnregisterCurrentThread() {
+        std::scoped_lock lock{mutex};
+        if (!manager)
+            return;
+
+        pid_t tid{gettid()};
+        if (std::erase_if(threads, [tid](const HintThread &thread) { return thread.tid == tid; }))
+            threadsChanged = true;
+    }
+
+    void PerformanceHint::UpdateSessionLocked(i64 targetNs) {
+        std::vector<i32> tids;
+        tids.reserve(threads.size());
+        for (const auto &thread : threads)
+            tids.push_back(thread.tid);
+
+        if (session && setThreads) {
+            if (int result{setThreads(session, tids.data(), tids.size())})
+                Logger::Warn("Failed to update the threads of the performance hint session: {}", strerror(result));
+        } else {
+            // Without APerformanceHint_setThreads the session can only cover a fixed set of threads, so it's recreated instead
+            if (session)
+                closeSession(std::exchange(session, nullptr));
+            session = createSession(manager, tids.data(), tids.size(), targetNs);
+            if (!session)
+                Logger::Warn("Failed to create a performance hint session for {} threads", tids.size());
+            targetDurationNs = targetNs;
+        }
+
+        threadsChanged = false;
+    }
+
+    void PerformanceHint::ReportFrame(i64 frameIntervalNs) {
+        std::scoped_lock lock{mutex};
+        if (!manager || frameIntervalNs <= 0)
+            return;
+
+        if (threadsChanged) {
+            if (threads.empty()) {
+                if (session)
+                    closeSession(std::exchange(session, nullptr));
+                threadsChanged = false;
+                return;
+            }
+            UpdateSessionLocked(frameIntervalNs);
+        }
+
+        if (!session)
+            return;
+
+        if (frameIntervalNs != targetDurationNs) {
+            updateTargetWorkDuration(session, frameIntervalNs);
+            targetDurationNs = frameIntervalNs;
+        }
+
+        i64 workDurationNs{};
+        for (auto &thread : threads) {
+            i64 cpuTimeNs{GetCpuTime(thread.clock)};
+            workDurationNs = std::max(workDurationNs, cpuTimeNs - thread.lastCpuTimeNs);
+            thread.lastCpuTimeNs = cpuTimeNs;
+        }
+
+        if (workDurationNs > 0)
+            reportActualWorkDuration(session, workDurationNs);
+    }
+}
@@ -0,0 +1,102 @@
+// SPDX-License-Identifier: MPL-2.0
+// Copyright © 2023 Skyline Team and Contributors (https://github.com/skyline-emu/)
+
+#pragma once
+
+#include <common.h>
+
+struct APerformanceHintManager;
+struct APerformanceHintSession;
+
+namespace skyline {
+    /**
+     * @brief An ADPF performance hint session covering the host threads that have per-frame deadlines, the actual work duration of every frame is reported to it so the CPU governor can ramp clocks ahead of a deadline rather than waiting for load to build up
+     * @note The work duration of a frame is the CPU time of the busiest registered thread over it, this excludes time spent blocked on the GPU or on frame pacing which the governor shouldn't boost for
+     * @note ADPF was introduced in API 33 so the functions are resolved at runtime, all functions are no-ops if it's unsupported or disabled
+     */
+    class PerformanceHint {
+      private:
+        using GetManagerFunction = APerformanceHintManager *(*)();
+        using CreateSessionFunction = APerformanceHintSession *(*)(APerformanceHintManager *, const i32 *, size_t, i64);
+        using UpdateTargetWorkDurationFunction = int (*)(APerformanceHintSession *, i64);
+        using ReportActualWorkDurationFunction = int (*)(APerformanceHintSession *, i64);
+        using CloseSessionFunction = void (*)(APerformanceHintSession *);
+        using SetThreadsFunction = int (*)(APerformanceHintSession *, const i32 *, size_t);
+
+        inline static CreateSessionFunction createSession{};
+        inline static UpdateTargetWorkDurationFunction updateTargetWorkDuration{};
+        inline static ReportActualWorkDurationFunction reportActualWorkDuration{};
+        inline static CloseSessionFunction closeSession{};
+        inline static SetThreadsFunction setThreads{}; //!< This is only available on API 34 and above, the session is recreated when the threads change otherwise
+
+        /**
+         * @brief A registered thread alongside the CPU time clock used to measure its work
+         */
+        struct HintThread {
+            pid_t tid;
+            clockid_t clock;
+            i64 lastCpuTimeNs; //!< The CPU time of the thread at the last report
+        };
+
+        inline static std::mutex mutex; //!< Synchronizes access to all session state
+        inline static APerformanceHintManager *manager{}; //!< The hint manager of the process, this is nullptr if hints are disabled or unsupported
+        inline static APerformanceHintSession *session{};
+        inline static std::vector<HintThread> threads;
+        inline static bool threadsChanged{}; //!< If the registered threads have changed since the session was created or updated
+        inline static i64 targetDurationNs{}; //!< The target work duration that the session was created or updated with
+
+        /**
+         * @return The CPU time of the supplied clock in nanoseconds or 0 if it couldn't be read
+         */
+        static i64 GetCpuTime(clockid_t clock);
+
+        /**
+         * @brief Creates a session or updates the threads of the existing session if they've changed
+         * @note The mutex **must** be locked when calling this
+         */
+        static void UpdateSessionLocked(i64 targetNs);
+
+      public:
+        /**
+         * @brief Resolves the ADPF functions and acquires the hint manager
+         * @param enable If hints should be reported at all
+         * @note This must be called prior to any threads being registered
+         */
+        static void Initialize(bool enable);
+
+        /**
+         * @brief Closes the session and drops all registered threads, this must be called once all registered threads have exited
+         */
+        static void Finalize();
+
+        /**
+         * @brief Adds the calling thread to the session
+         */
+        static void RegisterCurrentThread();
+
+        /**
+         * @brief Removes the calling thread from the session, this must be called by any registered thread before it exits
+         */
+        static void UnregisterCurrentThread();
+
+        /**
+         * @brief Reports the work done by the registered threads since the last report as the work duration of a single frame
+         * @param frameIntervalNs The interval that the guest is targeting between frames, this is used as the target work duration
+         */
+        static void ReportFrame(i64 frameIntervalNs);
+
+        /**
+         * @brief Registers the calling thread for the lifetime of the object
+         */
+        class ScopedThread {
+          public:
+            ScopedThread() {
+                RegisterCurrentThread();
+            }
+
+            ~ScopedThread() {
+                UnregisterCurrentThread();
+            }
+        };
+    };
+}
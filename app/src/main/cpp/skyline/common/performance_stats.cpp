@@ -0,0 +1,91 @@
+// SPDX-License-Identifier: MPL-2.0
+// Copyright © 2023 Skyline Team and Contributors (https://github.com/skyline-emu/)
+
+#include <dirent.h>
+#include <fstream>
+#include <sstream>
+#include <unistd.h>
+#include "performance_stats.h"
+
+namespace skyline {
+    PerformanceStats PerfStats;
+
+    void PerformanceStats::PushFrame(i64 frameTimeNs) {
+        auto index{frameCount.load(std::memory_order_relaxed)};
+        frameTimesUs[index % FrameTimeHistorySize].store(static_cast<u32>(std::clamp<i64>(frameTimeNs / 1000, 0, std::numeric_limits<u32>::max())), std::memory_order_relaxed);
+        frameCount.store(index + 1, std::memory_order_release);
+
+        frameGpuTimeNs.store(gpuTimeNs.exchange(0, std::memory_order_relaxed), std::memory_order_relaxed);
+    }
+
+    size_t PerformanceStats::CopyFrameTimes(span<float> frameTimesMs) {
+        auto count{frameCount.load(std::memory_order_acquire)};
+        size_t written{std::min({static_cast<size_t>(count), frameTimesMs.size(), FrameTimeHistorySize})};
+        for (size_t i{}; i < written; i++) {
+            auto index{(count - written + i) % FrameTimeHistorySize};
+            frameTimesMs[i] = static_cast<float>(frameTimesUs[index].load(std::memory_order_relaxed)) / 1000.0f;
+        }
+        return written;
+    }
+
+    std::string PerformanceStats::SampleThreadUsage(size_t maxThreads) {
+        static std::unordered_map<pid_t, u64> previousTicks; //!< The CPU time of every thread in clock ticks at the prior sample
+        static i64 previousTime{};
+        static std::string previousResult;
+        static const long ticksPerSecond{sysconf(_SC_CLK_TCK)};
+
+        if (previousTime && util::GetTimeNs() - previousTime < ThreadUsageSamplePeriodNs)
+            return previousResult;
+
+        std::vector<std::pair<std::string, u64>> threads; //!< The name of every thread alongside the amount of ticks it was running for since the prior sample
+        std::unordered_map<pid_t, u64> currentTicks;
+
+        if (DIR *taskDir{opendir("/proc/self/task")}) {
+            while (dirent *entry{readdir(taskDir)}) {
+                if (entry->d_name[0] == '.')
+                    continue;
+
+                std::ifstream statFile{fmt::format("/proc/self/task/{}/stat", entry->d_name)};
+                std::string stat{std::istreambuf_iterator<char>{statFile}, std::istreambuf_iterator<char>{}};
+
+                // The thread name is enclosed in parentheses and may contain spaces, all other fields follow the last closing parenthesis
+                auto nameStart{stat.find('(')}, nameEnd{stat.rfind(')')};
+                if (nameStart == std::string::npos || nameEnd == std::string::npos)
+                    continue;
+
+                // The first field after the name is the 3rd field, utime and stime are the 14th and 15th fields
+                std::istringstream fields{stat.substr(nameEnd + 1)};
+                std::string field;
+                u64 ticks{};
+                for (size_t index{3}; index <= 15 && fields >> field; index++)
+                    if (index >= 14)
+                        ticks += std::strtoull(field.c_str(), nullptr, 10);
+
+                auto tid{static_cast<pid_t>(std::strtol(entry->d_name, nullptr, 10))};
+                currentTicks[tid] = ticks;
+
+                auto previous{previousTicks.find(tid)};
+                threads.emplace_back(stat.substr(nameStart + 1, nameEnd - nameStart - 1), previous != previousTicks.end() ? ticks - std::min(previous->second, ticks) : 0);
+            }
+            closedir(taskDir);
+        }
+
+        auto time{util::GetTimeNs()};
+        auto elapsedNs{previousTime ? time - previousTime : 0};
+        previousTime = time;
+        previousTicks = std::move(currentTicks);
+
+        if (!elapsedNs)
+            return {}; // We need two samples to calculate the usage
+
+        std::sort(threads.begin(), threads.end(), [](const auto &a, const auto &b) { return a.second > b.second; });
+
+        std::string result;
+        for (size_t i{}; i < std::min(maxThreads, threads.size()); i++) {
+            const auto &[name, ticks]{threads[i]};
+            auto usage{(static_cast<double>(ticks) * constant::NsInSecond * 100.0) / (static_cast<double>(ticksPerSecond) * static_cast<double>(elapsedNs))};
+            result += fmt::format("{}{}: {:.0f}%", result.empty() ? "" : "\n", name, usage);
+        }
+        return previousResult = result;
+    }
+}
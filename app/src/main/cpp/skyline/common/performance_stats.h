@@ -0,0 +1,53 @@
+// SPDX-License-Identifier: MPL-2.0
+// Copyright © 2023 Skyline Team and Contributors (https://github.com/skyline-emu/)
+
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <common.h>
+
+namespace skyline {
+    /**
+     * @brief A lock-free block of performance statistics which is updated by the emulator's subsystems and sampled by the frontend's performance overlay
+     * @note All values are updated with relaxed atomics as the overlay only requires them to be eventually consistent
+     */
+    struct PerformanceStats {
+        static constexpr size_t FrameTimeHistorySize{120}; //!< The amount of recent frame times that are kept for the frame-time graph
+        static constexpr i64 ThreadUsageSamplePeriodNs{constant::NsInSecond / 2}; //!< The minimum period between samples of thread CPU usage, reading procfs for every thread is too expensive to do every frame
+
+        std::array<std::atomic<u32>, FrameTimeHistorySize> frameTimesUs{}; //!< A ring of the most recent frame times in microseconds
+        std::atomic<u32> frameCount{}; //!< The total amount of presented frames, the latest frame time is at `(frameCount - 1) % FrameTimeHistorySize`
+
+        std::atomic<u64> gpuTimeNs{}; //!< The GPU execution time of all submissions that completed since the last present
+        std::atomic<u64> frameGpuTimeNs{}; //!< The GPU execution time latched at the last present
+        std::atomic<u64> pipelineCompiles{}; //!< The total amount of graphics pipelines that were compiled
+        std::atomic<u64> shaderCacheHits{}; //!< The total amount of guest shader lookups that were served from the shader cache
+        std::atomic<u64> shaderCacheMisses{}; //!< The total amount of guest shader lookups that required the binary to be parsed and hashed
+        std::atomic<i64> textureCount{}; //!< The amount of host textures that are currently alive
+        std::atomic<i64> bufferCount{}; //!< The amount of host buffers that are currently alive
+        std::atomic<i64> megaBufferBytes{}; //!< The total size of all megabuffer chunks that are currently allocated
+        std::atomic<u64> contextSwitches{}; //!< The total amount of times a guest thread was scheduled onto a core
+
+        /**
+         * @brief Records the frame time of a presented frame and latches the GPU time accumulated over it
+         * @note This must only be called from a single thread
+         */
+        void PushFrame(i64 frameTimeNs);
+
+        /**
+         * @brief Copies the frame-time history into the supplied span from oldest to newest
+         * @return The amount of frame times that were written, this is less than the size of the span if not enough frames have been presented
+         */
+        size_t CopyFrameTimes(span<float> frameTimesMs);
+
+        /**
+         * @brief Samples the CPU usage of all threads in the process since the prior sample, if the prior sample was taken less than ThreadUsageSamplePeriodNs ago then its result is returned
+         * @return A line for each of the busiest `maxThreads` threads with their name and usage in percent of a single core
+         * @note This is not thread-safe and is only intended to be called from the frontend's polling thread
+         */
+        std::string SampleThreadUsage(size_t maxThreads);
+    };
+
+    extern PerformanceStats PerfStats; //!< The global performance statistics of the emulator
+}
@@ -65,20 +65,40 @@ namespace skyline {
         Setting<language::SystemLanguage> systemLanguage; //!< The system language
         Setting<region::RegionCode> systemRegion; //!< The system region
         Setting<bool> isInternetEnabled; //!< If emulator uses internet
+        Setting<bool> pinHostThreads; //!< If emulation threads should be pinned to host cores based on their role and the host CPU topology
+        Setting<bool> performanceHints; //!< If the work durations of frames should be reported to the system with ADPF performance hints so CPU clocks are raised ahead of frame deadlines
+        Setting<bool> cacheDecryptedNca; //!< If the decrypted RomFS and ExeFS of encrypted NCAs should be stored in a container that later launches load directly
+        Setting<bool> verifyRomFsIntegrity; //!< If every block of the RomFS should be verified against the hash tree of its NCA section when it's first read
+        Setting<bool> hardwareVideoDecoding; //!< If NVDEC and VIC command buffers should be processed with video decoding done by the host video decoder through MediaCodec
 
         // Display
         Setting<bool> forceTripleBuffering; //!< If the presentation engine should always triple buffer even if the swapchain supports double buffering
         Setting<bool> disableFrameThrottling; //!< Allow the guest to submit frames without any blocking calls
+        Setting<bool> framePacing; //!< If frames should be scheduled using presentation timing feedback from the compositor to reduce frame time variance and latency
         Setting<bool> disableShaderCache;  //!< Prevents cached shaders from being loaded and disables caching of new shaders
+        Setting<bool> asyncPipelineCompilation; //!< If draws should be skipped while their pipelines are compiling rather than waiting on them
+        Setting<bool> enableMacroJit; //!< If GPU macros should be translated into host code rather than interpreted
 
         // GPU
         Setting<std::string> gpuDriver; //!< The label of the GPU driver to use
         Setting<std::string> gpuDriverLibraryName; //!< The name of the GPU driver library to use
         Setting<u32> executorSlotCountScale; //!< Number of GPU executor slots that can be used concurrently
         Setting<u32> executorFlushThreshold; //!< Number of commands that need to accumulate before they're flushed to the GPU
+        Setting<bool> adaptiveExecutorFlush; //!< If the executor flush threshold should be adjusted each frame based on GPU and command recording idle time
         Setting<bool> useDirectMemoryImport; //!< If buffer emulation should be done by importing guest buffer mappings
         Setting<bool> forceMaxGpuClocks; //!< If the GPU should be forced to run at maximum clocks
+        Setting<bool> parallelCommandRecording; //!< If GPU executions should be recorded into command buffers on multiple threads
         Setting<bool> freeGuestTextureMemory; //!< If guest textrue memory should be freed when the owning texture is GPU dirty
+        Setting<u32> textureMemoryBudget; //!< The amount of host memory in MiB that textures can use before the least recently used ones are evicted, 0 disables the budget but textures are still evicted when the device-local memory budget reported by the driver is close to being exceeded
+        Setting<bool> transientAttachments; //!< If depth buffers which are only ever cleared and rendered to should be backed by lazily allocated memory
+        Setting<u32> resolutionScale; //!< The scale of the host resolution of render targets relative to the guest resolution in percent
+        Setting<bool> dynamicResolution; //!< If the resolution scale should be lowered dynamically to keep up with the guest's frame rate and avoid thermal throttling, the resolution scale setting is used as the upper bound
+        Setting<u32> upscalingMode; //!< The filtering used to upscale frames rendered below the guest resolution during presentation, this corresponds to gpu::UpscalingMode
+        Setting<bool> gpuTextureDecoding; //!< If textures should be deswizzled and decoded on the GPU using compute shaders
+        Setting<bool> textureTranscoding; //!< If BCn textures should be transcoded into another compressed format supported by the host rather than being decoded when the host doesn't support them
+        Setting<bool> gpuQuadConversion; //!< If indexed quad draws should be converted into triangle lists on the GPU using a compute shader
+        Setting<bool> enableTextureCache; //!< If decoded textures should be persistently cached on disk
+        Setting<bool> skipRedundantUploads; //!< If the guest contents of textures and buffers should be hashed during synchronization to skip uploading contents that are unchanged since the last upload
 
         // Hacks
         Setting<bool> enableFastGpuReadbackHack; //!< If the CPU texture readback skipping hack should be used
@@ -11,6 +11,20 @@ namespace skyline {
     static constexpr size_t LockAttemptsPerSleep{1024};
     static constexpr size_t SleepDurationUs{50};
 
+#ifdef SKYLINE_LOCK_PROFILING
+    /**
+     * @brief Records the time from construction to destruction as a single contended acquisition of a lock from the supplied site
+     */
+    struct ContentionTimer {
+        lock_profiler::LockSite *site;
+        i64 startNs{util::GetTimeNs()};
+
+        ~ContentionTimer() {
+            site->RecordContention(util::GetTimeNs() - startNs);
+        }
+    };
+#endif
+
     template<typename Func>
     void FalloffLock(Func &&func) {
         for (size_t i{1}; !func(i); i++) {
@@ -25,18 +39,45 @@ namespace skyline {
     }
 
     void  __attribute__ ((noinline)) SpinLock::LockSlow() {
+#ifdef SKYLINE_LOCK_PROFILING
+        ContentionTimer timer{site};
+#endif
         FalloffLock([this] (size_t i) {
             return try_lock();
         });
     }
 
     void  __attribute__ ((noinline)) SharedSpinLock::LockSlow() {
+#ifdef SKYLINE_LOCK_PROFILING
+        ContentionTimer timer{site};
+#endif
         FalloffLock([this] (size_t i) {
             return try_lock();
         });
     }
 
     void  __attribute__ ((noinline)) SharedSpinLock::LockSlowShared() {
+#ifdef SKYLINE_LOCK_PROFILING
+        ContentionTimer timer{site};
+#endif
+        FalloffLock([this] (size_t i) {
+            return try_lock_shared();
+        });
+    }
+
+    void  __attribute__ ((noinline)) DistributedSharedSpinLock::LockSlow() {
+#ifdef SKYLINE_LOCK_PROFILING
+        ContentionTimer timer{site};
+#endif
+        FalloffLock([this] (size_t i) {
+            return try_lock();
+        });
+    }
+
+    void  __attribute__ ((noinline)) DistributedSharedSpinLock::LockSlowShared() {
+#ifdef SKYLINE_LOCK_PROFILING
+        ContentionTimer timer{site};
+#endif
         FalloffLock([this] (size_t i) {
             return try_lock_shared();
         });
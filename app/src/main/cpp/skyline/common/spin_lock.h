@@ -3,12 +3,16 @@
 
 #pragma once
 
+#include <array>
 #include <atomic>
 #include <condition_variable>
 #include <thread>
 #include <mutex>
 #include "base.h"
 #include "utils.h"
+#ifdef SKYLINE_LOCK_PROFILING
+#include "lock_profiler.h"
+#endif
 
 namespace skyline {
     /**
@@ -18,10 +22,18 @@ namespace skyline {
     class SpinLock {
       private:
         std::atomic_flag locked{};
+#ifdef SKYLINE_LOCK_PROFILING
+        lock_profiler::LockSite *site; //!< The site this lock was constructed at, contended acquisitions are attributed to this
+#endif
 
         void LockSlow();
 
       public:
+#ifdef SKYLINE_LOCK_PROFILING
+        SpinLock(const char *file = __builtin_FILE(), const char *function = __builtin_FUNCTION(), u32 line = __builtin_LINE(), const char *type = "SpinLock")
+            : site{lock_profiler::GetLockSite(type, file, function, line)} {}
+#endif
+
         void lock() {
             if (try_lock()) [[likely]]
                 return;
@@ -48,12 +60,20 @@ namespace skyline {
         static constexpr u32 StateWriter{1};
 
         std::atomic<u32> state{};
+#ifdef SKYLINE_LOCK_PROFILING
+        lock_profiler::LockSite *site; //!< The site this lock was constructed at, contended acquisitions are attributed to this
+#endif
 
         void LockSlow();
 
         void LockSlowShared();
 
       public:
+#ifdef SKYLINE_LOCK_PROFILING
+        SharedSpinLock(const char *file = __builtin_FILE(), const char *function = __builtin_FUNCTION(), u32 line = __builtin_LINE())
+            : site{lock_profiler::GetLockSite("SharedSpinLock", file, function, line)} {}
+#endif
+
         void lock() {
             if (try_lock()) [[likely]]
                 return;
@@ -91,6 +111,97 @@ namespace skyline {
         }
     };
 
+    /**
+     * @brief A variant of SharedSpinLock with the reader count distributed across cache-line sized slots, this avoids readers on different cores contending on a single cache line
+     * @details Every thread is assigned a slot on its first shared acquisition and always uses it, a writer has to check every slot so exclusive acquisitions are more expensive than with SharedSpinLock
+     * @note This should only be used for read-mostly structures which are read by several threads concurrently, a shared lock must be released on the thread that acquired it
+     */
+    class DistributedSharedSpinLock {
+      private:
+        static constexpr size_t SlotCount{16}; //!< The amount of reader slots, this should be at least the amount of cores on the host
+        static constexpr size_t CacheLineSize{64};
+
+        struct alignas(CacheLineSize) ReaderSlot {
+            std::atomic<u32> count;
+        };
+
+        alignas(CacheLineSize) std::atomic<u32> writer{};
+        std::array<ReaderSlot, SlotCount> readers{};
+#ifdef SKYLINE_LOCK_PROFILING
+        lock_profiler::LockSite *site; //!< The site this lock was constructed at, contended acquisitions are attributed to this
+#endif
+
+        static inline std::atomic<size_t> nextReaderSlot{};
+
+        /**
+         * @return The reader count of the slot assigned to the calling thread, threads are assigned slots in a round-robin manner
+         */
+        std::atomic<u32> &GetReaderSlot() {
+            static thread_local size_t slot{nextReaderSlot.fetch_add(1, std::memory_order_relaxed) % SlotCount};
+            return readers[slot].count;
+        }
+
+        void LockSlow();
+
+        void LockSlowShared();
+
+      public:
+#ifdef SKYLINE_LOCK_PROFILING
+        DistributedSharedSpinLock(const char *file = __builtin_FILE(), const char *function = __builtin_FUNCTION(), u32 line = __builtin_LINE())
+            : site{lock_profiler::GetLockSite("DistributedSharedSpinLock", file, function, line)} {}
+#endif
+
+        void lock() {
+            if (try_lock()) [[likely]]
+                return;
+
+            LockSlow();
+        }
+
+        void lock_shared() {
+            if (try_lock_shared()) [[likely]]
+                return;
+
+            LockSlowShared();
+        }
+
+        /**
+         * @note Like SharedSpinLock, a waiting writer doesn't block new readers so nested shared acquisitions can't deadlock
+         */
+        bool try_lock() {
+            u32 expected{};
+            if (!writer.compare_exchange_strong(expected, 1, std::memory_order_seq_cst))
+                return false;
+
+            // The writer flag and the reader counts are sequentially consistent so either this observes a reader or the reader observes the writer
+            for (auto &reader : readers) {
+                if (reader.count.load(std::memory_order_seq_cst)) {
+                    writer.store(0, std::memory_order_release);
+                    return false;
+                }
+            }
+            return true;
+        }
+
+        bool try_lock_shared() {
+            auto &slot{GetReaderSlot()};
+            slot.fetch_add(1, std::memory_order_seq_cst);
+            if (writer.load(std::memory_order_seq_cst)) {
+                slot.fetch_sub(1, std::memory_order_release);
+                return false;
+            }
+            return true;
+        }
+
+        void unlock() {
+            writer.store(0, std::memory_order_release);
+        }
+
+        void unlock_shared() {
+            GetReaderSlot().fetch_sub(1, std::memory_order_release);
+        }
+    };
+
     /**
      * @brief Recursive lock built ontop of `SpinLock`
      * @note This should *ONLY* be used in situations where it is provably better than an std::mutex due to spinlocks having worse perfomance under heavy contention
@@ -102,6 +213,11 @@ namespace skyline {
         std::thread::id tid{};
 
       public:
+#ifdef SKYLINE_LOCK_PROFILING
+        RecursiveSpinLock(const char *file = __builtin_FILE(), const char *function = __builtin_FUNCTION(), u32 line = __builtin_LINE())
+            : backingLock{file, function, line, "RecursiveSpinLock"} {}
+#endif
+
         void lock() {
             if (tid == std::this_thread::get_id()) {
                 uses++;
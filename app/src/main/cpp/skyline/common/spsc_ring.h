@@ -0,0 +1,87 @@
+// SPDX-License-Identifier: MPL-2.0
+// Copyright © 2022 Skyline Team and Contributors (https://github.com/skyline-emu/)
+
+#pragma once
+
+#include <common/spin_lock.h>
+#include <common.h>
+
+namespace skyline {
+    /**
+     * @brief A fixed-size single-producer single-consumer ring of reusable slots, pushing and popping is lock-free and locking only occurs when a side needs to block on the ring being full or empty
+     * @note Slots are never destroyed after being consumed so that any allocations they hold can be reused by the producer
+     */
+    template<typename Type, size_t Size>
+    class SpscRing {
+      private:
+        static_assert(std::has_single_bit(Size), "The size of the ring must be a power of two");
+
+        std::array<Type, Size> slots{};
+        alignas(64) std::atomic<size_t> head{}; //!< The index of the next slot to be consumed, this is only written by the consumer
+        alignas(64) std::atomic<size_t> tail{}; //!< The index of the next slot to be produced, this is only written by the producer
+        std::atomic<bool> consumerWaiting{};
+        std::atomic<bool> producerWaiting{};
+        SpinLock waitMutex;
+        std::condition_variable_any waitCondition;
+
+        /**
+         * @brief Blocks the calling side until the predicate is satisfied
+         * @note The waiting flag is set prior to checking the predicate under the lock which ensures the other side will observe it after any store the predicate depends on
+         */
+        template<typename Predicate>
+        void Wait(std::atomic<bool> &waiting, Predicate predicate) {
+            std::unique_lock lock{waitMutex};
+            waiting = true;
+            waitCondition.wait(lock, predicate);
+            waiting = false;
+        }
+
+        /**
+         * @brief Wakes the other side if it's blocked on the ring
+         */
+        void Wake(std::atomic<bool> &waiting) {
+            if (waiting) [[unlikely]] {
+                std::scoped_lock lock{waitMutex};
+                waitCondition.notify_all();
+            }
+        }
+
+      public:
+        /**
+         * @return A reference to the next slot to be produced, blocking till one is available if the ring is full
+         * @note The slot is only made visible to the consumer after a call to EndPush
+         */
+        Type &BeginPush() {
+            if (tail - head == Size) [[unlikely]]
+                Wait(producerWaiting, [this]() { return tail - head != Size; });
+
+            return slots[tail % Size];
+        }
+
+        /**
+         * @brief Publishes the slot returned by BeginPush to the consumer
+         */
+        void EndPush() {
+            tail++;
+            Wake(consumerWaiting);
+        }
+
+        /**
+         * @return A reference to the oldest produced slot, blocking till one is available if the ring is empty
+         */
+        Type &Front() {
+            if (head == tail) [[unlikely]]
+                Wait(consumerWaiting, [this]() { return head != tail; });
+
+            return slots[head % Size];
+        }
+
+        /**
+         * @brief Returns the slot returned by Front to the producer
+         */
+        void Pop() {
+            head++;
+            Wake(producerWaiting);
+        }
+    };
+}
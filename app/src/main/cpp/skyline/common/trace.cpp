@@ -1,3 +1,107 @@
+#include <fcntl.h>
+#include <unistd.h>
 #include "trace.h"
 
 PERFETTO_TRACK_EVENT_STATIC_STORAGE(); //!< Expands into a structure with static storage for all track events
+
+namespace skyline::trace {
+    void Initialize() {
+        static std::once_flag initializeFlag;
+        std::call_once(initializeFlag, [] {
+            perfetto::TracingInitArgs args;
+            args.backends |= perfetto::kInProcessBackend | perfetto::kSystemBackend;
+            args.shmem_size_hint_kb = 0x200000;
+            perfetto::Tracing::Initialize(args);
+            perfetto::TrackEvent::Register();
+        });
+    }
+
+    namespace detail {
+        std::array<FrameCounterValue, static_cast<size_t>(FrameCounter::Count)> frameCounters{};
+    }
+
+    void EmitFrameCounters() {
+        if (!TRACE_EVENT_CATEGORY_ENABLED("frame"))
+            return;
+
+        constexpr std::array<const char *, static_cast<size_t>(FrameCounter::Count)> CounterNames{
+            "GpfifoBusyTimeNs",
+            "RecordBusyTimeNs",
+            "GpuTimeNs",
+            "PipelineCompiles",
+            "TextureUploads",
+            "TextureUploadBytes",
+            "BufferSyncs",
+            "NceTrapFaults",
+            "ContextSwitches",
+            "RedundantUploads",
+        };
+
+        for (size_t i{}; i < CounterNames.size(); i++)
+            TRACE_COUNTER("frame", perfetto::CounterTrack{CounterNames[i]}, detail::frameCounters[i].value.exchange(0, std::memory_order_relaxed));
+    }
+
+    TraceController Controller;
+
+    TraceController::~TraceController() {
+        if (fd != -1)
+            close(fd);
+    }
+
+    bool TraceController::Start(const std::string &path, const std::vector<std::string> &categories, u32 bufferSizeKb) {
+        Initialize();
+        if (!bufferSizeKb)
+            bufferSizeKb = DefaultBufferSizeKb;
+
+        std::scoped_lock lock{mutex};
+        if (session)
+            return false;
+
+        fd = open(path.c_str(), O_RDWR | O_CREAT | O_TRUNC | O_CLOEXEC, 0600);
+        if (fd == -1) {
+            Logger::Warn("Failed to open trace file '{}': {}", path, strerror(errno));
+            return false;
+        }
+
+        perfetto::protos::gen::TrackEventConfig trackEventConfig;
+        if (!categories.empty()) {
+            trackEventConfig.add_disabled_categories("*");
+            for (const auto &category : categories)
+                trackEventConfig.add_enabled_categories(category);
+        }
+
+        perfetto::TraceConfig config;
+        config.add_buffers()->set_size_kb(bufferSizeKb);
+        auto dataSourceConfig{config.add_data_sources()->mutable_config()};
+        dataSourceConfig->set_name("track_event");
+        dataSourceConfig->set_track_event_config_raw(trackEventConfig.SerializeAsString());
+
+        session = perfetto::Tracing::NewTrace(perfetto::kInProcessBackend);
+        session->Setup(config, fd);
+        session->StartBlocking();
+
+        Logger::Info("Started tracing into '{}' with a {}KiB buffer", path, bufferSizeKb);
+        return true;
+    }
+
+    bool TraceController::Stop() {
+        std::scoped_lock lock{mutex};
+        if (!session)
+            return false;
+
+        perfetto::TrackEvent::Flush();
+        session->StopBlocking();
+        session.reset();
+
+        close(fd);
+        fd = -1;
+
+        Logger::Info("Stopped tracing");
+        return true;
+    }
+
+    bool TraceController::IsActive() {
+        std::scoped_lock lock{mutex};
+        return session != nullptr;
+    }
+}
@@ -1,6 +1,8 @@
 #pragma once
 
 #include <limits>
+#include <array>
+#include <atomic>
 #include <perfetto.h>
 #include <common.h>
 
@@ -16,7 +18,8 @@ PERFETTO_DEFINE_CATEGORIES(
     perfetto::Category("host").SetDescription("Events relating to host code"),
     perfetto::Category("gpu").SetDescription("Events from the emulated GPU"),
     perfetto::Category("service").SetDescription("Events from the HLE sysmodule implementations"),
-    perfetto::Category("containers").SetDescription("Events from custom container implementations")
+    perfetto::Category("containers").SetDescription("Events from custom container implementations"),
+    perfetto::Category("frame").SetDescription("Per-frame counters of the work done by each subsystem")
 );
 
 namespace skyline::trace {
@@ -25,5 +28,83 @@ namespace skyline::trace {
      */
     enum class TrackIds : u64 {
         Presentation = std::numeric_limits<u64>::max(),
+        GpuTimeline = std::numeric_limits<u64>::max() - 1,
     };
+
+    /**
+     * @brief Counters which are accumulated from any thread over the course of a frame and emitted as perfetto counter tracks on every present
+     */
+    enum class FrameCounter : u8 {
+        GpfifoBusyTime, //!< The time in nanoseconds GPFIFO threads spent executing pushbuffers
+        RecordBusyTime, //!< The time in nanoseconds command record threads spent recording and submitting executions
+        GpuTime, //!< The time in nanoseconds the host GPU spent executing command executor submissions, this is measured with timestamp queries
+        PipelineCompiles, //!< The amount of graphics pipelines that were compiled
+        TextureUploads, //!< The amount of guest -> host texture synchronizations
+        TextureUploadBytes, //!< The amount of bytes uploaded by guest -> host texture synchronizations
+        BufferSyncs, //!< The amount of buffer synchronizations in either direction
+        NceTrapFaults, //!< The amount of faults on NCE trapped memory
+        ContextSwitches, //!< The amount of times a guest thread was scheduled onto a core
+        RedundantUploads, //!< The amount of texture and buffer synchronizations that were skipped as the guest contents were unchanged since the last one
+        Count,
+    };
+
+    namespace detail {
+        struct alignas(64) FrameCounterValue {
+            std::atomic<u64> value;
+        };
+
+        extern std::array<FrameCounterValue, static_cast<size_t>(FrameCounter::Count)> frameCounters;
+    }
+
+    /**
+     * @brief Adds the supplied value to a frame counter, this is a no-op unless the 'frame' category is being traced
+     */
+    inline void AddFrameCounter(FrameCounter counter, u64 value = 1) {
+        if (TRACE_EVENT_CATEGORY_ENABLED("frame"))
+            detail::frameCounters[static_cast<size_t>(counter)].value.fetch_add(value, std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief Emits the values of all frame counters and resets them, this should be called once per presented frame
+     */
+    void EmitFrameCounters();
+
+    /**
+     * @brief Initializes the perfetto SDK with both the in-process and system backends, this is idempotent and may be called from any thread
+     */
+    void Initialize();
+
+    /**
+     * @brief A controller for in-process perfetto tracing sessions which are written directly into a file, this allows traces to be captured without the system tracing service
+     * @note Only a single session may be active at a time
+     */
+    class TraceController {
+      private:
+        std::mutex mutex; //!< Synchronizes starting and stopping sessions
+        std::unique_ptr<perfetto::TracingSession> session; //!< The currently active session or nullptr if there's none
+        int fd{-1}; //!< The file descriptor of the trace file being written to by the active session
+
+      public:
+        static constexpr u32 DefaultBufferSizeKb{0x8000}; //!< The size of the trace ring buffer if none is specified, 32MiB
+
+        ~TraceController();
+
+        /**
+         * @brief Starts a tracing session that writes into the file at the supplied path, any existing file is truncated
+         * @param categories The track event categories to enable, all categories are enabled if this is empty
+         * @param bufferSizeKb The size of the ring buffer in KiB, older events are overwritten once it is full
+         * @return If the session was successfully started, this fails if a session is already active or the file couldn't be opened
+         */
+        bool Start(const std::string &path, const std::vector<std::string> &categories, u32 bufferSizeKb = DefaultBufferSizeKb);
+
+        /**
+         * @brief Flushes all pending events and stops the active session, the trace file is finalized after this returns
+         * @return If there was an active session that was stopped
+         */
+        bool Stop();
+
+        bool IsActive();
+    };
+
+    extern TraceController Controller; //!< The global trace controller which is driven by the frontend
 }
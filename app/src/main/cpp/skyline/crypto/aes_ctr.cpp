@@ -0,0 +1,105 @@
+// SPDX-License-Identifier: MPL-2.0
+// Copyright © 2022 Skyline Team and Contributors (https://github.com/skyline-emu/)
+
+#include <arm_neon.h>
+#include <sys/auxv.h>
+#include <asm/hwcap.h>
+#include "aes_ctr.h"
+
+#define AES_TARGET __attribute__((target("aes")))
+
+namespace skyline::crypto {
+    constexpr size_t BlockSize{sizeof(AesCtrCipher::Block)};
+    constexpr size_t PipelineDepth{8}; //!< The amount of blocks that are encrypted in parallel, this is enough to hide the latency of AESE/AESMC on most cores
+
+    bool AesCtrCipher::IsSupported() {
+        static bool supported{(getauxval(AT_HWCAP) & HWCAP_AES) != 0};
+        return supported;
+    }
+
+    /**
+     * @brief Applies SubBytes to every byte of a word using AESE, this works as ShiftRows is a no-op when all columns of the state are identical
+     */
+    AES_TARGET static u32 SubWord(u32 word) {
+        uint8x16_t state{vaeseq_u8(vreinterpretq_u8_u32(vdupq_n_u32(word)), vdupq_n_u8(0))};
+        return vgetq_lane_u32(vreinterpretq_u32_u8(state), 0);
+    }
+
+    AES_TARGET AesCtrCipher::AesCtrCipher(span<u8> key) {
+        if (key.size() != BlockSize)
+            throw exception("AES-CTR key must be 128 bits: {} bytes", key.size());
+
+        constexpr std::array<u8, 10> RoundConstants{0x01, 0x02, 0x04, 0x08, 0x10, 0x20, 0x40, 0x80, 0x1B, 0x36};
+        std::array<u32, 44> words;
+        std::memcpy(words.data(), key.data(), BlockSize);
+        for (size_t i{4}; i < words.size(); i++) {
+            u32 word{words[i - 1]};
+            if (i % 4 == 0)
+                word = SubWord(std::rotr(word, 8)) ^ RoundConstants[(i / 4) - 1]; // Words are little-endian so RotWord is a right rotation
+            words[i] = words[i - 4] ^ word;
+        }
+        std::memcpy(roundKeys.data(), words.data(), sizeof(roundKeys));
+    }
+
+    /**
+     * @brief Encrypts a single block with the expanded key schedule
+     */
+    AES_TARGET static inline uint8x16_t EncryptBlock(uint8x16_t block, const std::array<uint8x16_t, 11> &keys) {
+        for (size_t round{}; round < 9; round++)
+            block = vaesmcq_u8(vaeseq_u8(block, keys[round]));
+        return veorq_u8(vaeseq_u8(block, keys[9]), keys[10]);
+    }
+
+    /**
+     * @brief Loads a big-endian counter into a pair of native integers with the high half first
+     */
+    static inline std::pair<u64, u64> LoadCounter(const AesCtrCipher::Block &counter) {
+        u64 high, low;
+        std::memcpy(&high, counter.data(), sizeof(u64));
+        std::memcpy(&low, counter.data() + sizeof(u64), sizeof(u64));
+        return {util::SwapEndianness(high), util::SwapEndianness(low)};
+    }
+
+    AES_TARGET static inline uint8x16_t MakeCounterBlock(u64 high, u64 low) {
+        return vreinterpretq_u8_u64(vcombine_u64(vcreate_u64(util::SwapEndianness(high)), vcreate_u64(util::SwapEndianness(low))));
+    }
+
+    AES_TARGET void AesCtrCipher::Process(u8 *destination, const u8 *source, size_t size, Block counter) const {
+        std::array<uint8x16_t, 11> keys;
+        for (size_t i{}; i < keys.size(); i++)
+            keys[i] = vld1q_u8(roundKeys[i].data());
+
+        auto [high, low]{LoadCounter(counter)};
+        auto nextCounter{[&high = high, &low = low]() {
+            auto block{MakeCounterBlock(high, low)};
+            if (++low == 0)
+                high++;
+            return block;
+        }};
+
+        size_t offset{};
+        for (; size - offset >= PipelineDepth * BlockSize; offset += PipelineDepth * BlockSize) {
+            // The blocks are independent so interleaving them keeps the AES pipeline full rather than stalling on each round's latency
+            std::array<uint8x16_t, PipelineDepth> blocks;
+            for (auto &block : blocks)
+                block = nextCounter();
+            for (size_t round{}; round < 9; round++)
+                for (auto &block : blocks)
+                    block = vaesmcq_u8(vaeseq_u8(block, keys[round]));
+            for (size_t i{}; i < PipelineDepth; i++) {
+                auto keystream{veorq_u8(vaeseq_u8(blocks[i], keys[9]), keys[10])};
+                vst1q_u8(destination + offset + i * BlockSize, veorq_u8(vld1q_u8(source + offset + i * BlockSize), keystream));
+            }
+        }
+
+        for (; size - offset >= BlockSize; offset += BlockSize)
+            vst1q_u8(destination + offset, veorq_u8(vld1q_u8(source + offset), EncryptBlock(nextCounter(), keys)));
+
+        if (offset != size) {
+            Block keystream;
+            vst1q_u8(keystream.data(), EncryptBlock(nextCounter(), keys));
+            for (size_t i{}; offset + i < size; i++)
+                destination[offset + i] = source[offset + i] ^ keystream[i];
+        }
+    }
+}
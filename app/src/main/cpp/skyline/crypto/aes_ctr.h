@@ -0,0 +1,42 @@
+// SPDX-License-Identifier: MPL-2.0
+// Copyright © 2022 Skyline Team and Contributors (https://github.com/skyline-emu/)
+
+#pragma once
+
+#include <common.h>
+
+namespace skyline::crypto {
+    /**
+     * @brief An AES-128-CTR implementation using the ARMv8 Cryptography Extensions, this is substantially faster than mbedtls as several blocks are pipelined through the AES units at once
+     * @note The cipher is stateless as the counter is supplied with every call, it can be used by multiple threads concurrently without any locking
+     */
+    class AesCtrCipher {
+      public:
+        using Block = std::array<u8, 0x10>;
+
+      private:
+        std::array<Block, 11> roundKeys; //!< The expanded key schedule for all 10 rounds and the initial round key
+
+      public:
+        /**
+         * @return If the host CPU supports the AES instructions, the cipher must not be used otherwise
+         */
+        static bool IsSupported();
+
+        AesCtrCipher(span<u8> key);
+
+        /**
+         * @brief Encrypts or decrypts the supplied data with the keystream starting at the supplied counter
+         * @param counter The big-endian counter of the first block, this is incremented for every subsequent block
+         * @note The destination and source buffers can be the same, the size doesn't need to be a multiple of the block size
+         */
+        void Process(u8 *destination, const u8 *source, size_t size, Block counter) const;
+
+        /**
+         * @brief Encrypts or decrypts the supplied data in-place
+         */
+        void Process(span<u8> data, const Block &counter) const {
+            Process(data.data(), data.data(), data.size(), counter);
+        }
+    };
+}
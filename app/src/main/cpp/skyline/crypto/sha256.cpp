@@ -0,0 +1,91 @@
+// SPDX-License-Identifier: MPL-2.0
+// Copyright © 2023 Skyline Team and Contributors (https://github.com/skyline-emu/)
+
+#include <arm_neon.h>
+#include <sys/auxv.h>
+#include <asm/hwcap.h>
+#include <mbedtls/sha256.h>
+#include "sha256.h"
+
+#define SHA2_TARGET __attribute__((target("sha2")))
+
+namespace skyline::crypto {
+    constexpr size_t BlockSize{0x40};
+
+    constexpr std::array<u32, 64> RoundConstants{
+        0x428A2F98, 0x71374491, 0xB5C0FBCF, 0xE9B5DBA5, 0x3956C25B, 0x59F111F1, 0x923F82A4, 0xAB1C5ED5,
+        0xD807AA98, 0x12835B01, 0x243185BE, 0x550C7DC3, 0x72BE5D74, 0x80DEB1FE, 0x9BDC06A7, 0xC19BF174,
+        0xE49B69C1, 0xEFBE4786, 0x0FC19DC6, 0x240CA1CC, 0x2DE92C6F, 0x4A7484AA, 0x5CB0A9DC, 0x76F988DA,
+        0x983E5152, 0xA831C66D, 0xB00327C8, 0xBF597FC7, 0xC6E00BF3, 0xD5A79147, 0x06CA6351, 0x14292967,
+        0x27B70A85, 0x2E1B2138, 0x4D2C6DFC, 0x53380D13, 0x650A7354, 0x766A0ABB, 0x81C2C92E, 0x92722C85,
+        0xA2BFE8A1, 0xA81A664B, 0xC24B8B70, 0xC76C51A3, 0xD192E819, 0xD6990624, 0xF40E3585, 0x106AA070,
+        0x19A4C116, 0x1E376C08, 0x2748774C, 0x34B0BCB5, 0x391C0CB3, 0x4ED8AA4A, 0x5B9CCA4F, 0x682E6FF3,
+        0x748F82EE, 0x78A5636F, 0x84C87814, 0x8CC70208, 0x90BEFFFA, 0xA4506CEB, 0xBEF9A3F7, 0xC67178F2,
+    };
+
+    bool IsSha256Accelerated() {
+        static bool supported{(getauxval(AT_HWCAP) & HWCAP_SHA2) != 0};
+        return supported;
+    }
+
+    /**
+     * @brief Runs the compression function over a contiguous run of 64-byte blocks
+     * @param abcd The first half of the hash state, this is updated in-place
+     * @param efgh The second half of the hash state, this is updated in-place
+     */
+    SHA2_TARGET static void ProcessBlocks(uint32x4_t &abcd, uint32x4_t &efgh, const u8 *data, size_t blockCount) {
+        for (size_t block{}; block < blockCount; block++, data += BlockSize) {
+            uint32x4_t abcdSave{abcd}, efghSave{efgh};
+
+            std::array<uint32x4_t, 4> schedule;
+            for (size_t i{}; i < schedule.size(); i++)
+                schedule[i] = vreinterpretq_u32_u8(vrev32q_u8(vld1q_u8(data + i * 0x10))); // Message words are big-endian
+
+            // Every iteration does four rounds, the message schedule is extended in a rolling window of the last 16 words
+            for (size_t i{}; i < 16; i++) {
+                uint32x4_t wk{vaddq_u32(schedule[i % 4], vld1q_u32(RoundConstants.data() + i * 4))};
+                if (i < 12)
+                    schedule[i % 4] = vsha256su1q_u32(vsha256su0q_u32(schedule[i % 4], schedule[(i + 1) % 4]), schedule[(i + 2) % 4], schedule[(i + 3) % 4]);
+
+                uint32x4_t abcdPrior{abcd};
+                abcd = vsha256hq_u32(abcd, efgh, wk);
+                efgh = vsha256h2q_u32(efgh, abcdPrior, wk);
+            }
+
+            abcd = vaddq_u32(abcd, abcdSave);
+            efgh = vaddq_u32(efgh, efghSave);
+        }
+    }
+
+    SHA2_TARGET static Sha256Hash Sha256Accelerated(span<const u8> data) {
+        constexpr std::array<u32, 8> InitialState{0x6A09E667, 0xBB67AE85, 0x3C6EF372, 0xA54FF53A, 0x510E527F, 0x9B05688C, 0x1F83D9AB, 0x5BE0CD19};
+        uint32x4_t abcd{vld1q_u32(InitialState.data())}, efgh{vld1q_u32(InitialState.data() + 4)};
+
+        size_t fullBlocks{data.size() / BlockSize};
+        ProcessBlocks(abcd, efgh, data.data(), fullBlocks);
+
+        // The trailing partial block is padded with a single set bit followed by zeroes and the big-endian length in bits, this may spill over into an additional block
+        std::array<u8, BlockSize * 2> tail{};
+        size_t remainder{data.size() - fullBlocks * BlockSize};
+        std::memcpy(tail.data(), data.data() + fullBlocks * BlockSize, remainder);
+        tail[remainder] = 0x80;
+        size_t tailSize{remainder + 1 + sizeof(u64) > BlockSize ? BlockSize * 2 : BlockSize};
+        u64 bitLength{util::SwapEndianness(static_cast<u64>(data.size()) * 8)};
+        std::memcpy(tail.data() + tailSize - sizeof(u64), &bitLength, sizeof(u64));
+        ProcessBlocks(abcd, efgh, tail.data(), tailSize / BlockSize);
+
+        Sha256Hash hash;
+        vst1q_u8(hash.data(), vrev32q_u8(vreinterpretq_u8_u32(abcd)));
+        vst1q_u8(hash.data() + 0x10, vrev32q_u8(vreinterpretq_u8_u32(efgh)));
+        return hash;
+    }
+
+    Sha256Hash Sha256(span<const u8> data) {
+        if (IsSha256Accelerated()) [[likely]]
+            return Sha256Accelerated(data);
+
+        Sha256Hash hash;
+        mbedtls_sha256_ret(data.data(), data.size(), hash.data(), 0);
+        return hash;
+    }
+}
@@ -0,0 +1,21 @@
+// SPDX-License-Identifier: MPL-2.0
+// Copyright © 2023 Skyline Team and Contributors (https://github.com/skyline-emu/)
+
+#pragma once
+
+#include <common.h>
+
+namespace skyline::crypto {
+    using Sha256Hash = std::array<u8, 0x20>;
+
+    /**
+     * @return If the host CPU supports the SHA2 instructions, hashing falls back to mbedtls otherwise
+     */
+    bool IsSha256Accelerated();
+
+    /**
+     * @brief Computes the SHA-256 hash of the supplied data using the ARMv8 Cryptography Extensions when they're supported
+     * @note This is stateless and can be used by multiple threads concurrently
+     */
+    Sha256Hash Sha256(span<const u8> data);
+}
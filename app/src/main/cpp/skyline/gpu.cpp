@@ -222,6 +222,7 @@ namespace skyline::gpu {
     static vk::raii::Device CreateDevice(const vk::raii::Context &context,
                                          const vk::raii::PhysicalDevice &physicalDevice,
                                          decltype(vk::DeviceQueueCreateInfo::queueCount) &vkQueueFamilyIndex,
+                                         decltype(vk::DeviceQueueCreateInfo::queueCount) &vkQueueCount,
                                          TraitManager &traits,
                                          adrenotools_gpu_mapping *mapping) {
         auto deviceFeatures2{physicalDevice.getFeatures2<
@@ -239,7 +240,16 @@ namespace skyline::gpu {
             vk::PhysicalDeviceTransformFeedbackFeaturesEXT,
             vk::PhysicalDeviceIndexTypeUint8FeaturesEXT,
             vk::PhysicalDeviceExtendedDynamicStateFeaturesEXT,
-            vk::PhysicalDeviceRobustness2FeaturesEXT>()};
+            vk::PhysicalDeviceVertexInputDynamicStateFeaturesEXT,
+            vk::PhysicalDeviceRobustness2FeaturesEXT,
+            vk::PhysicalDeviceTimelineSemaphoreFeaturesKHR,
+            vk::PhysicalDeviceGraphicsPipelineLibraryFeaturesEXT,
+            vk::PhysicalDeviceDescriptorBufferFeaturesEXT,
+            vk::PhysicalDeviceConditionalRenderingFeaturesEXT,
+            vk::PhysicalDeviceMultiDrawFeaturesEXT,
+            vk::PhysicalDeviceInlineUniformBlockFeaturesEXT,
+            vk::PhysicalDevicePipelineCreationCacheControlFeaturesEXT,
+            vk::PhysicalDeviceShaderModuleIdentifierFeaturesEXT>()};
         decltype(deviceFeatures2) enabledFeatures2{}; // We only want to enable features we required due to potential overhead from unused features
 
         #define FEAT_REQ(structName, feature)                                            \
@@ -275,7 +285,12 @@ namespace skyline::gpu {
             vk::PhysicalDeviceDriverProperties,
             vk::PhysicalDeviceFloatControlsProperties,
             vk::PhysicalDeviceTransformFeedbackPropertiesEXT,
-            vk::PhysicalDeviceSubgroupProperties>()};
+            vk::PhysicalDeviceSubgroupProperties,
+            vk::PhysicalDeviceGraphicsPipelineLibraryPropertiesEXT,
+            vk::PhysicalDeviceExternalMemoryHostPropertiesEXT,
+            vk::PhysicalDeviceMultiDrawPropertiesEXT,
+            vk::PhysicalDeviceInlineUniformBlockPropertiesEXT,
+            vk::PhysicalDeviceShaderModuleIdentifierPropertiesEXT>()};
 
         traits = TraitManager{deviceFeatures2, enabledFeatures2, deviceExtensions, enabledExtensions, deviceProperties2, physicalDevice};
         traits.ApplyDriverPatches(context, mapping);
@@ -286,17 +301,19 @@ namespace skyline::gpu {
             pEnabledExtensions.push_back(extension.data());
 
         auto queueFamilies{physicalDevice.getQueueFamilyProperties()};
-        float queuePriority{1.0f}; //!< The priority of the only queue we use, it's set to the maximum of 1.0
+        std::array<float, 2> queuePriorities{1.0f, 1.0f}; //!< The priorities of the graphics and transfer queues, they're both set to the maximum of 1.0
         vk::StructureChain<vk::DeviceQueueCreateInfo, vk::DeviceQueueGlobalPriorityCreateInfoEXT> queueCreateInfo{
             [&]() -> vk::DeviceQueueCreateInfo {
                 decltype(vk::DeviceQueueCreateInfo::queueFamilyIndex) index{};
                 for (const auto &queueFamily : queueFamilies) {
                     if (queueFamily.queueFlags & vk::QueueFlagBits::eGraphics && queueFamily.queueFlags & vk::QueueFlagBits::eCompute) {
                         vkQueueFamilyIndex = index;
+                        // A second queue is used for uploads so they can overlap with rendering, it's from the same family to avoid queue family ownership transfers and is only useful with timeline semaphores to hand off uploads to the graphics queue
+                        vkQueueCount = (traits.supportsTimelineSemaphores && queueFamily.queueCount >= queuePriorities.size()) ? static_cast<u32>(queuePriorities.size()) : 1;
                         return vk::DeviceQueueCreateInfo{
                             .queueFamilyIndex = index,
-                            .queueCount = 1,
-                            .pQueuePriorities = &queuePriority,
+                            .queueCount = vkQueueCount,
+                            .pQueuePriorities = queuePriorities.data(),
                         };
                     }
                     index++;
@@ -391,10 +408,13 @@ namespace skyline::gpu {
           vkInstance(CreateInstance(state, vkContext)),
           vkDebugReportCallback(CreateDebugReportCallback(this, vkInstance)),
           vkPhysicalDevice(CreatePhysicalDevice(vkInstance)),
-          vkDevice(CreateDevice(vkContext, vkPhysicalDevice, vkQueueFamilyIndex, traits, &adrenotoolsImportMapping)),
+          vkDevice(CreateDevice(vkContext, vkPhysicalDevice, vkQueueFamilyIndex, vkQueueCount, traits, &adrenotoolsImportMapping)),
           vkQueue(vkDevice, vkQueueFamilyIndex, 0),
+          vkTransferQueue(vkQueueCount > 1 ? std::optional<vk::raii::Queue>{std::in_place, vkDevice, vkQueueFamilyIndex, 1} : std::nullopt),
           memory(*this),
-          scheduler(state, *this),
+          scheduler(state, *this, vkQueue, queueMutex),
+          transferScheduler(vkTransferQueue ? std::optional<CommandScheduler>{std::in_place, state, *this, *vkTransferQueue, transferQueueMutex} : std::nullopt),
+          resolution(state),
           presentation(state, *this),
           texture(*this),
           buffer(*this),
@@ -410,10 +430,13 @@ namespace skyline::gpu {
         graphicsPipelineAssembler.emplace(*this, state.os->publicAppFilesPath + "vk_graphics_pipeline_cache/" + titleId);
         shader.emplace(state, *this,
                        state.os->publicAppFilesPath + "shader_replacements/" + titleId,
-                       state.os->publicAppFilesPath + "shader_dumps/" + titleId);
+                       state.os->publicAppFilesPath + "shader_dumps/" + titleId,
+                       *state.settings->disableShaderCache ? std::string{} : state.os->publicAppFilesPath + "spirv_cache/");
         if (!*state.settings->disableShaderCache)
             graphicsPipelineCacheManager.emplace(state,
                                                  state.os->publicAppFilesPath + "graphics_pipeline_cache/" + titleId);
+        if (*state.settings->enableTextureCache)
+            textureCacheManager.emplace(state.os->publicAppFilesPath + "texture_cache/" + titleId + "/");
         graphicsPipelineManager.emplace(*this, *state.jvm);
     }
 }
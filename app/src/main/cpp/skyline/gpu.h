@@ -7,6 +7,7 @@
 #include "gpu/trait_manager.h"
 #include "gpu/memory_manager.h"
 #include "gpu/command_scheduler.h"
+#include "gpu/resolution_controller.h"
 #include "gpu/presentation_engine.h"
 #include "gpu/texture_manager.h"
 #include "gpu/buffer_manager.h"
@@ -14,8 +15,10 @@
 #include "gpu/descriptor_allocator.h"
 #include "gpu/shader_manager.h"
 #include "gpu/pipeline_cache_manager.h"
+#include "gpu/texture_cache_manager.h"
 #include "gpu/graphics_pipeline_assembler.h"
 #include "gpu/shaders/helper_shaders.h"
+#include "gpu/texture/texture_decoder.h"
 #include "gpu/cache/renderpass_cache.h"
 #include "gpu/cache/framebuffer_cache.h"
 #include "gpu/interconnect/maxwell_3d/pipeline_manager.h"
@@ -41,13 +44,18 @@ namespace skyline::gpu {
         vk::raii::DebugReportCallbackEXT vkDebugReportCallback; //!< An RAII Vulkan debug report manager which calls into 'GPU::DebugCallback'
         vk::raii::PhysicalDevice vkPhysicalDevice;
         u32 vkQueueFamilyIndex{};
+        u32 vkQueueCount{}; //!< The amount of queues created from the queue family, this is 2 if a transfer queue is available
         TraitManager traits;
         vk::raii::Device vkDevice;
         std::mutex queueMutex; //!< Synchronizes access to the queue as it is externally synchronized
         vk::raii::Queue vkQueue; //!< A Vulkan Queue supporting graphics and compute operations
+        std::mutex transferQueueMutex; //!< Synchronizes access to the transfer queue
+        std::optional<vk::raii::Queue> vkTransferQueue; //!< A second queue from the same family as the graphics queue which large uploads are submitted to, this is only present if the family has multiple queues and timeline semaphores are supported
 
         memory::MemoryManager memory;
         CommandScheduler scheduler;
+        std::optional<CommandScheduler> transferScheduler; //!< The scheduler for submissions to the transfer queue, this is only present alongside it
+        ResolutionController resolution;
         PresentationEngine presentation;
 
         TextureManager texture;
@@ -58,6 +66,7 @@ namespace skyline::gpu {
         std::optional<ShaderManager> shader;
 
         HelperShaders helperShaders;
+        TextureDecoder textureDecoder;
 
         std::optional<GraphicsPipelineAssembler> graphicsPipelineAssembler;
         cache::RenderPassCache renderPassCache;
@@ -65,6 +74,7 @@ namespace skyline::gpu {
 
         std::mutex channelLock;
         std::optional<PipelineCacheManager> graphicsPipelineCacheManager;
+        std::optional<TextureCacheManager> textureCacheManager;
         std::optional<interconnect::maxwell3d::PipelineManager> graphicsPipelineManager;
         interconnect::kepler_compute::PipelineManager computePipelineManager;
 
@@ -7,6 +7,7 @@
 #include <kernel/types/KProcess.h>
 #include <common/trace.h>
 #include <common/settings.h>
+#include <common/performance_stats.h>
 #include "buffer.h"
 
 namespace skyline::gpu {
@@ -19,12 +20,127 @@ namespace skyline::gpu {
         unifiedMegaBuffer = {};
     }
 
+    void Buffer::InvalidateMegaBufferRegion(vk::DeviceSize offset, vk::DeviceSize size) {
+        unifiedMegaBuffer = {};
+        if (!megaBufferTableUsed)
+            return;
+
+        // Allocations may extend past the end of their entry so the extent of the allocation needs to be checked rather than only the entry
+        for (size_t i{}; i < megaBufferTable.size(); i++) {
+            vk::DeviceSize entryOffset{static_cast<vk::DeviceSize>(i) << megaBufferTableShift};
+            if (megaBufferTableValidity.test(i) && entryOffset < offset + size && entryOffset + megaBufferTable[i].region.size() > offset)
+                megaBufferTableValidity.reset(i);
+        }
+    }
+
+    void Buffer::FilterUnchangedRegions(SyncRegions &regions) {
+        TRACE_EVENT("gpu", "Buffer::FilterUnchangedRegions");
+
+        // Any modification of the backing since the hashes were last updated makes them stale
+        size_t pageCount{util::DivideCeil<size_t>(mirror.size(), PAGE_SIZE)};
+        if (pageHashes.size() != pageCount || hashSequenceNumber != sequenceNumber)
+            pageHashes.assign(pageCount, 0);
+
+        SyncRegions changedRegions;
+        bool anyUnchanged{};
+        for (const auto &[offset, size] : regions) {
+            for (vk::DeviceSize pageOffset{util::AlignDown(offset, PAGE_SIZE)}; pageOffset < offset + size; pageOffset += PAGE_SIZE) {
+                vk::DeviceSize pageSize{std::min<vk::DeviceSize>(PAGE_SIZE, mirror.size() - pageOffset)};
+                u64 hash{XXH3_64bits(mirror.data() + pageOffset, pageSize)};
+                auto &pageHash{pageHashes[pageOffset / PAGE_SIZE]};
+                if (pageHash && pageHash == hash) {
+                    anyUnchanged = true;
+                    continue;
+                }
+                pageHash = hash;
+
+                if (!changedRegions.empty() && changedRegions.back().first + changedRegions.back().second == pageOffset)
+                    changedRegions.back().second += pageSize;
+                else
+                    changedRegions.emplace_back(pageOffset, pageSize);
+            }
+        }
+
+        if (anyUnchanged)
+            trace::AddFrameCounter(trace::FrameCounter::RedundantUploads);
+        regions = std::move(changedRegions);
+    }
+
+    void Buffer::MarkCpuDirtyRegion(vk::DeviceSize offset, vk::DeviceSize size) {
+        if (dirtyState != DirtyState::CpuDirty) {
+            dirtyState = DirtyState::CpuDirty;
+            // The bitmap is always cleared when the buffer stops being CPU dirty so it'll only contain this write
+        }
+
+        if (!cpuDirtyPagesValid || !size)
+            return;
+
+        for (size_t page{offset / PAGE_SIZE}, endPage{util::DivideCeil<size_t>(offset + size, PAGE_SIZE)}; page < endPage; page++)
+            cpuDirtyPages[page / 64] |= 1ULL << (page % 64);
+    }
+
+    void Buffer::MarkCpuDirtyAll() {
+        dirtyState = DirtyState::CpuDirty;
+        cpuDirtyPagesValid = false;
+    }
+
+    void Buffer::CollectTrackedCpuWrites() {
+        if (!trapHandle)
+            return;
+
+        gpu.state.nce->CollectTrapWrites(*trapHandle, [this](span<u8> pages) {
+            auto start{std::max(pages.data(), guest->data())}, end{std::min(pages.end().base(), guest->end().base())};
+            if (start < end)
+                MarkCpuDirtyRegion(static_cast<vk::DeviceSize>(start - guest->data()), static_cast<vk::DeviceSize>(end - start));
+        });
+    }
+
     void Buffer::SetupStagedTraps() {
         if (isDirect)
             return;
 
         // We can't just capture this in the lambda since the lambda could exceed the lifetime of the buffer
         std::weak_ptr<Buffer> weakThis{shared_from_this()};
+        auto writeCallback{[weakThis] {
+            TRACE_EVENT("gpu", "Buffer::WriteTrap");
+
+            auto buffer{weakThis.lock()};
+            if (!buffer)
+                return true;
+
+            std::unique_lock stateLock{buffer->stateMutex, std::try_to_lock};
+            if (!stateLock)
+                return false;
+
+            if (!buffer->AllCpuBackingWritesBlocked() && buffer->dirtyState != DirtyState::GpuDirty) {
+                buffer->MarkCpuDirtyAll();
+                return true;
+            }
+
+            if (buffer->accumulatedGuestWaitTime > FastReadbackHackWaitTimeThreshold && *buffer->gpu.state.settings->enableFastGpuReadbackHack) {
+                // As opposed to skipping readback as we do for textures, with buffers we can still perform the readback but just without syncinc the GPU
+                // While the read data may be invalid it's still better than nothing and works in most cases
+                memcpy(buffer->mirror.data(), buffer->backing->data(), buffer->mirror.size());
+                if (*buffer->gpu.state.settings->enableFastReadbackWrites)
+                    buffer->MarkCpuDirtyAll();
+                else
+                    buffer->dirtyState = DirtyState::Clean;
+                return true;
+            }
+
+            std::unique_lock lock{*buffer, std::try_to_lock};
+            if (!lock)
+                return false;
+
+            if (buffer->cycle)
+                return false;
+
+            buffer->SynchronizeGuest(true); // We need to assume the buffer is dirty since we don't know what the guest is writing
+            buffer->MarkCpuDirtyAll();
+
+            return true;
+        }};
+
         trapHandle = gpu.state.nce->CreateTrap(*guest, [weakThis] {
             auto buffer{weakThis.lock()};
             if (!buffer)
@@ -78,8 +194,8 @@ namespace skyline::gpu {
 
             buffer->SynchronizeGuest(true); // We can skip trapping since the caller will do it
             return true;
-        }, [weakThis] {
-            TRACE_EVENT("gpu", "Buffer::WriteTrap");
+        }, writeCallback, [weakThis, writeCallback](span<u8> pages) {
+            TRACE_EVENT("gpu", "Buffer::PageWriteTrap");
 
             auto buffer{weakThis.lock()};
             if (!buffer)
@@ -89,30 +205,18 @@ namespace skyline::gpu {
             if (!stateLock)
                 return false;
 
-            if (!buffer->AllCpuBackingWritesBlocked() && buffer->dirtyState != DirtyState::GpuDirty) {
-                buffer->dirtyState = DirtyState::CpuDirty;
+            if (!buffer->guest)
                 return true;
-            }
 
-            if (buffer->accumulatedGuestWaitTime > FastReadbackHackWaitTimeThreshold && *buffer->gpu.state.settings->enableFastGpuReadbackHack) {
-                // As opposed to skipping readback as we do for textures, with buffers we can still perform the readback but just without syncinc the GPU
-                // While the read data may be invalid it's still better than nothing and works in most cases
-                memcpy(buffer->mirror.data(), buffer->backing->data(), buffer->mirror.size());
-                buffer->dirtyState = *buffer->gpu.state.settings->enableFastReadbackWrites ? DirtyState::CpuDirty : DirtyState::Clean;
+            if (!buffer->AllCpuBackingWritesBlocked() && buffer->dirtyState != DirtyState::GpuDirty) {
+                // Only the written pages need to be synchronized to the backing and re-trapped later
+                auto start{std::max(pages.data(), buffer->guest->data())}, end{std::min(pages.end().base(), buffer->guest->end().base())};
+                buffer->MarkCpuDirtyRegion(static_cast<vk::DeviceSize>(start - buffer->guest->data()), static_cast<vk::DeviceSize>(end - start));
                 return true;
             }
 
-            std::unique_lock lock{*buffer, std::try_to_lock};
-            if (!lock)
-                return false;
-
-            if (buffer->cycle)
-                return false;
-
-            buffer->SynchronizeGuest(true); // We need to assume the buffer is dirty since we don't know what the guest is writing
-            buffer->dirtyState = DirtyState::CpuDirty;
-
-            return true;
+            stateLock.unlock();
+            return writeCallback(); // The buffer can't be written to without synchronization, the entire buffer will be treated as dirty by this
         });
     }
 
@@ -157,10 +261,41 @@ namespace skyline::gpu {
             }
         }
 
-        directGpuWritesActive = false;
+        if (directGpuWritesActive) {
+            directGpuWritesActive = false;
+            ResetSequencedGpuWrites();
+        }
         return false;
     }
 
+    void Buffer::TrackSequencedGpuWrite(span<u8> data, vk::DeviceSize offset) {
+        if (sequencedGpuWriteShadow.empty())
+            sequencedGpuWriteShadow.resize(guest->size());
+
+        sequencedGpuWrites.Insert({offset, offset + data.size()});
+        std::memcpy(sequencedGpuWriteShadow.data() + offset, data.data(), data.size());
+    }
+
+    void Buffer::ResetSequencedGpuWrites() {
+        if (!sequencedGpuWriteShadow.empty()) {
+            sequencedGpuWrites.Clear();
+            sequencedGpuWriteShadow.clear();
+            sequencedGpuWriteShadow.shrink_to_fit();
+        }
+    }
+
+    bool Buffer::ReadSequencedGpuWrites(span<u8> data, vk::DeviceSize offset) {
+        if (sequencedGpuWriteShadow.empty())
+            return false;
+
+        auto result{sequencedGpuWrites.Query(offset)};
+        if (!result.enclosed || static_cast<size_t>(result.size) < data.size())
+            return false; // Intervals are merged on insertion so a read that isn't contained in a single interval must touch GPU-written contents
+
+        std::memcpy(data.data(), sequencedGpuWriteShadow.data() + offset, data.size());
+        return true;
+    }
+
     bool Buffer::ValidateMegaBufferViewImplDirect(vk::DeviceSize size) {
         if (!everHadInlineUpdate || size >= MegaBufferChunkSize)
             // Don't megabuffer buffers that have never had inline updates
@@ -217,6 +352,9 @@ namespace skyline::gpu {
                                     UsageTracker &usageTracker, const std::function<void()> &gpuCopyCallback) {
         std::scoped_lock lock{stateMutex, src->stateMutex}; // Fine even if src and dst are same since recursive mutex
 
+        if (SequencedCpuBackingWritesBlocked())
+            CollectTrackedCpuWrites(); // Any tracked CPU writes must be observed for them to be sequenced prior to this write
+
         if (dirtyState == DirtyState::CpuDirty && SequencedCpuBackingWritesBlocked())
             // If the buffer is used in sequence directly on the GPU, SynchronizeHost before modifying the mirror contents to ensure proper sequencing. This write will then be sequenced on the GPU instead (the buffer will be kept clean for the rest of the execution due to gpuCopyCallback blocking all writes)
             SynchronizeHost();
@@ -224,9 +362,11 @@ namespace skyline::gpu {
         if (dirtyState != DirtyState::GpuDirty && src->dirtyState != DirtyState::GpuDirty) {
             std::memcpy(mirror.data() + dstOffset, src->mirror.data() + srcOffset, size);
 
-            if (dirtyState == DirtyState::CpuDirty && !SequencedCpuBackingWritesBlocked())
+            if (dirtyState == DirtyState::CpuDirty && !SequencedCpuBackingWritesBlocked()) {
                 // Skip updating backing if the changes are gonna be updated later by SynchroniseHost in executor anyway
+                MarkCpuDirtyRegion(dstOffset, size);
                 return;
+            }
 
             if (!SequencedCpuBackingWritesBlocked() && PollFence())
                 // We can write directly to the backing as long as this resource isn't being actively used by a past workload (in the current context or another)
@@ -245,9 +385,11 @@ namespace skyline::gpu {
         if (RefreshGpuWritesActiveDirect()) {
             if (gpuCopyCallback) {
                 // Propagate dirtiness to the current cycle, since if this is only dirty in a previous cycle that could change at any time and we would need to have the write saved somewhere for CPU reads
-                // By propagating the dirtiness to the current cycle we can avoid this and force a wait on any reads
-                MarkGpuDirty(usageTracker);
+                // By propagating the dirtiness to the current cycle we can avoid this and force a wait on any reads outside of the tracked inline updates
+                usageTracker.dirtyIntervals.Insert(*guest);
+                MarkGpuDirtyImpl(true);
                 gpuCopyCallback();
+                TrackSequencedGpuWrite(data, offset);
                 return false;
             } else {
                 return true;
@@ -280,17 +422,24 @@ namespace skyline::gpu {
                 gpuCopyCallback();
             else
                 return true;
+
+            TrackSequencedGpuWrite(data, offset); // The mirror is trapped while GPU dirty so the contents need to be kept separately for CPU reads
         }
 
+        if (SequencedCpuBackingWritesBlocked())
+            CollectTrackedCpuWrites(); // Any tracked CPU writes must be observed for them to be sequenced prior to this write
+
         if (dirtyState == DirtyState::CpuDirty && SequencedCpuBackingWritesBlocked())
             // If the buffer is used in sequence directly on the GPU, SynchronizeHost before modifying the mirror contents to ensure proper sequencing. This write will then be sequenced on the GPU instead (the buffer will be kept clean for the rest of the execution due to gpuCopyCallback blocking all writes)
             SynchronizeHost();
 
         std::memcpy(mirror.data() + offset, data.data(), data.size()); // Always copy to mirror since any CPU side reads will need the up-to-date contents
 
-        if (dirtyState == DirtyState::CpuDirty && !SequencedCpuBackingWritesBlocked())
+        if (dirtyState == DirtyState::CpuDirty && !SequencedCpuBackingWritesBlocked()) {
             // Skip updating backing if the changes are gonna be updated later by SynchroniseHost in executor anyway
+            MarkCpuDirtyRegion(offset, data.size());
             return false;
+        }
 
         if (!SequencedCpuBackingWritesBlocked() && PollFence()) {
             // We can write directly to the backing as long as this resource isn't being actively used by a past workload (in the current context or another)
@@ -308,7 +457,10 @@ namespace skyline::gpu {
     }
 
     void Buffer::ReadImplDirect(const std::function<void()> &flushHostCallback, span<u8> data, vk::DeviceSize offset) {
-        // If GPU writes are active then wait until that's no longer the case
+        // If GPU writes are active then wait until that's no longer the case, unless the read is entirely covered by inline updates which have known contents
+        if (RefreshGpuWritesActiveDirect() && ReadSequencedGpuWrites(data, offset))
+            return;
+
         RefreshGpuWritesActiveDirect(true, flushHostCallback);
 
         if (directTrackedShadowActive && RefreshGpuReadsActiveDirect()) {
@@ -328,8 +480,12 @@ namespace skyline::gpu {
     }
 
     void Buffer::ReadImplStaged(bool isFirstUsage, const std::function<void()> &flushHostCallback, span<u8> data, vk::DeviceSize offset) {
-        if (dirtyState == DirtyState::GpuDirty)
+        if (dirtyState == DirtyState::GpuDirty) {
+            if (ReadSequencedGpuWrites(data, offset))
+                return; // Avoid synchronizing the entire buffer when only reading inline updates with known contents, this is common for constant buffers
+
             SynchronizeGuestImmediate(isFirstUsage, flushHostCallback);
+        }
 
         std::memcpy(data.data(), mirror.data() + offset, data.size());
     }
@@ -347,6 +503,7 @@ namespace skyline::gpu {
             return;
 
         gpu.state.nce->TrapRegions(*trapHandle, false); // This has to occur prior to any synchronization as it'll skip trapping
+        CollectTrackedCpuWrites(); // Tracking of CPU writes stops once the buffer is read-write trapped, any prior writes need to be synchronized
 
         if (dirtyState == DirtyState::CpuDirty)
             SynchronizeHost(true); // Will transition the Buffer to Clean
@@ -357,9 +514,12 @@ namespace skyline::gpu {
         AdvanceSequence(); // The GPU will modify buffer contents so advance to the next sequence
     }
 
-    void Buffer::MarkGpuDirtyImpl() {
+    void Buffer::MarkGpuDirtyImpl(bool sequenced) {
         currentExecutionGpuDirty = true;
 
+        if (!sequenced)
+            sequencedGpuWrites.Clear(); // The GPU may overwrite any prior inline updates with indeterminate contents
+
         if (isDirect)
             MarkGpuDirtyImplDirect();
         else
@@ -374,10 +534,13 @@ namespace skyline::gpu {
           isDirect{direct},
           id{id},
           megaBufferTableShift{std::max(std::bit_width(guest.size() / MegaBufferTableMaxEntries - 1), MegaBufferTableShiftMin)} {
-        if (isDirect)
+        PerfStats.bufferCount.fetch_add(1, std::memory_order_relaxed);
+        if (isDirect) {
             directBacking = gpu.memory.ImportBuffer(mirror);
-        else
+        } else {
             backing = gpu.memory.AllocateBuffer(mirror.size());
+            cpuDirtyPages.resize(util::DivideCeil<size_t>(util::DivideCeil<size_t>(mirror.size(), PAGE_SIZE), 64));
+        }
 
         megaBufferTable.resize(guest.size() / (1 << megaBufferTableShift));
     }
@@ -387,10 +550,12 @@ namespace skyline::gpu {
           backing{gpu.memory.AllocateBuffer(size)},
           delegate{delegateAllocator.EmplaceUntracked<BufferDelegate>(this)},
           id{id} {
+        PerfStats.bufferCount.fetch_add(1, std::memory_order_relaxed);
         dirtyState = DirtyState::Clean; // Since this is a host-only buffer it's always going to be clean
     }
 
     Buffer::~Buffer() {
+        PerfStats.bufferCount.fetch_sub(1, std::memory_order_relaxed);
         if (trapHandle)
             gpu.state.nce->DeleteTrap(*trapHandle);
         SynchronizeGuest(true);
@@ -444,21 +609,82 @@ namespace skyline::gpu {
 
         TRACE_EVENT("gpu", "Buffer::SynchronizeHost");
 
+        bool partialSync{}; // If only the regions in `dirtyRegions` need to be synchronized rather than the entire buffer
+        SyncRegions dirtyRegions; // The offset and size of every dirty region of the buffer
         {
             std::scoped_lock lock{stateMutex};
+            CollectTrackedCpuWrites();
             if (dirtyState != DirtyState::CpuDirty)
                 return;
 
+            trace::AddFrameCounter(trace::FrameCounter::BufferSyncs);
             dirtyState = DirtyState::Clean;
             WaitOnFence();
 
-            AdvanceSequence(); // We are modifying GPU backing contents so advance to the next sequence
+            bool skipRedundantUploads{*gpu.state.settings->skipRedundantUploads};
+            if (cpuDirtyPagesValid) {
+                partialSync = true;
+
+                // Coalesce runs of dirty pages into regions and clear them from the bitmap
+                size_t pageCount{util::DivideCeil<size_t>(mirror.size(), PAGE_SIZE)};
+                for (size_t page{}; page < pageCount;) {
+                    u64 word{cpuDirtyPages[page / 64] >> (page % 64)};
+                    if (!word) {
+                        page = util::AlignDown(page, 64) + 64;
+                        continue;
+                    }
+
+                    page += static_cast<size_t>(std::countr_zero(word));
+                    size_t startPage{page};
+                    while (page < pageCount && (cpuDirtyPages[page / 64] & (1ULL << (page % 64))))
+                        page++;
+
+                    vk::DeviceSize offset{startPage * PAGE_SIZE};
+                    dirtyRegions.emplace_back(offset, std::min<vk::DeviceSize>(page * PAGE_SIZE, mirror.size()) - offset);
+                }
+                std::fill(cpuDirtyPages.begin(), cpuDirtyPages.end(), 0);
+
+                if (!skipTrap)
+                    for (const auto &[offset, size] : dirtyRegions)
+                        gpu.state.nce->TrapRegions(*trapHandle, guest->subspan(offset, size), true); // Must be done before the memcpy (and hashing) for the same reason as below
+
+                if (skipRedundantUploads)
+                    FilterUnchangedRegions(dirtyRegions);
+
+                // We are modifying GPU backing contents so advance to the next sequence, only megabuffer allocations containing modified regions need to be invalidated
+                if (!dirtyRegions.empty()) {
+                    sequenceNumber++;
+                    for (const auto &[offset, size] : dirtyRegions)
+                        InvalidateMegaBufferRegion(offset, size);
+                }
+            } else {
+                if (!skipTrap)
+                    gpu.state.nce->TrapRegions(*trapHandle, true); // Trap any future CPU writes to this buffer, must be done before the memcpy so that any modifications during the copy are tracked
+
+                std::fill(cpuDirtyPages.begin(), cpuDirtyPages.end(), 0);
+                cpuDirtyPagesValid = true;
+
+                if (skipRedundantUploads) {
+                    // The entire buffer is hashed and only pages with modified contents are uploaded
+                    partialSync = true;
+                    dirtyRegions.emplace_back(0, mirror.size());
+                    FilterUnchangedRegions(dirtyRegions);
+                    if (!dirtyRegions.empty())
+                        AdvanceSequence();
+                } else {
+                    AdvanceSequence(); // We are modifying GPU backing contents so advance to the next sequence
+                }
+            }
 
-            if (!skipTrap)
-                gpu.state.nce->TrapRegions(*trapHandle, true); // Trap any future CPU writes to this buffer, must be done before the memcpy so that any modifications during the copy are tracked
+            if (skipRedundantUploads)
+                hashSequenceNumber = sequenceNumber;
         }
 
-        std::memcpy(backing->data(), mirror.data(), mirror.size());
+        if (!partialSync)
+            std::memcpy(backing->data(), mirror.data(), mirror.size());
+        else
+            for (const auto &[offset, size] : dirtyRegions)
+                std::memcpy(backing->data() + offset, mirror.data() + offset, size);
     }
 
     bool Buffer::SynchronizeGuest(bool skipTrap, bool nonBlocking) {
@@ -476,10 +702,14 @@ namespace skyline::gpu {
             if (nonBlocking && !PollFence())
                 return false; // If the fence is not signalled and non-blocking behaviour is requested then bail out
 
+            trace::AddFrameCounter(trace::FrameCounter::BufferSyncs);
             WaitOnFence();
             std::memcpy(mirror.data(), backing->data(), mirror.size());
 
             dirtyState = DirtyState::Clean;
+            ResetSequencedGpuWrites();
+            std::fill(cpuDirtyPages.begin(), cpuDirtyPages.end(), 0);
+            cpuDirtyPagesValid = true;
         }
 
         if (!skipTrap)
@@ -648,7 +878,7 @@ namespace skyline::gpu {
 
     Buffer *BufferDelegate::GetBuffer() {
         if (linked) [[unlikely]]
-            return link->GetBuffer();
+            return link->buffer;
         else
             return buffer;
     }
@@ -662,9 +892,17 @@ namespace skyline::gpu {
         offset = newOffset;
     }
 
+    void BufferDelegate::Relink(BufferDelegate *newTarget, vk::DeviceSize offsetDelta) {
+        if (!linked)
+            throw exception("Cannot relink a buffer delegate that isn't linked!");
+
+        link = newTarget;
+        offset += offsetDelta;
+    }
+
     vk::DeviceSize BufferDelegate::GetOffset() {
         if (linked) [[unlikely]]
-            return link->GetOffset() + offset;
+            return link->offset + offset;
         else
             return offset;
     }
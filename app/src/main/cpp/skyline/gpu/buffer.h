@@ -4,6 +4,7 @@
 #pragma once
 
 #include <boost/functional/hash.hpp>
+#include <boost/container/small_vector.hpp>
 #include <common/linear_allocator.h>
 #include <common/spin_lock.h>
 #include <nce.h>
@@ -56,6 +57,9 @@ namespace skyline::gpu {
         std::vector<u8> directTrackedShadow; //!< (Direct) Temporary mirror used to track any CPU-side writes to the buffer while it's being read by the GPU
         bool directTrackedShadowActive{}; //!< (Direct) If `directTrackedShadow` is currently being used to track writes
 
+        IntervalList<size_t> sequencedGpuWrites; //!< Regions of the buffer written by GPU-sequenced inline updates since the last GPU write of indeterminate contents, reads enclosed by these can be served from `sequencedGpuWriteShadow` without waiting on the GPU
+        std::vector<u8> sequencedGpuWriteShadow; //!< A copy of the contents of `sequencedGpuWrites`, this is only allocated while the buffer has GPU writes pending
+
         span<u8> mirror{}; //!< A contiguous mirror of all the guest mappings to allow linear access on the CPU
         std::optional<memory::Buffer> backing;
         std::optional<memory::ImportedBuffer> directBacking;
@@ -67,6 +71,10 @@ namespace skyline::gpu {
             CpuDirty, //!< The CPU mappings have been modified but the GPU buffer is not up to date
             GpuDirty, //!< The GPU buffer has been modified but the CPU mappings have not been updated
         } dirtyState{DirtyState::CpuDirty}; //!< (Staged) The state of the CPU mappings with respect to the GPU buffer
+        std::vector<u64> cpuDirtyPages; //!< (Staged) A bitmap of the pages of the buffer that were written to on the CPU while CpuDirty, a page's bit is at `(offset / PAGE_SIZE)` with the offset being relative to the start of the buffer
+        bool cpuDirtyPagesValid{}; //!< (Staged) If `cpuDirtyPages` contains all CPU modifications, the entire buffer is treated as dirty otherwise
+        std::vector<u64> pageHashes; //!< (Staged) The hash of the guest contents of every page of the buffer at the last guest -> host synchronization, a hash of 0 denotes that the contents are unknown
+        u32 hashSequenceNumber{}; //!< (Staged) The sequence number of the backing at the point `pageHashes` was last updated, the hashes are only valid while this matches `sequenceNumber`
         bool directGpuWritesActive{}; //!< (Direct) If the current/next GPU exection is writing to the buffer (basically GPU dirty)
 
         enum class BackingImmutability {
@@ -111,8 +119,40 @@ namespace skyline::gpu {
          */
         void ResetMegabufferState();
 
+        /**
+         * @brief Invalidates any megabuffer allocations that contain data from the supplied region of the buffer
+         */
+        void InvalidateMegaBufferRegion(vk::DeviceSize offset, vk::DeviceSize size);
+
+        /**
+         * @brief Transitions the buffer to being CPU dirty with only the supplied region of the buffer being modified
+         * @note The state mutex **must** be locked when calling this
+         */
+        void MarkCpuDirtyRegion(vk::DeviceSize offset, vk::DeviceSize size);
+
+        /**
+         * @brief Transitions the buffer to being CPU dirty in its entirety
+         * @note The state mutex **must** be locked when calling this
+         */
+        void MarkCpuDirtyAll();
+
+        /**
+         * @brief Marks any pages of the buffer that the NCE tracked CPU writes to rather than trapping them as CPU dirty
+         * @note The state mutex **must** be locked when calling this
+         */
+        void CollectTrackedCpuWrites();
+
+        using SyncRegions = boost::container::small_vector<std::pair<vk::DeviceSize, vk::DeviceSize>, 8>; //!< The offset and size of a set of regions of the buffer
+
+        /**
+         * @brief Hashes all pages in the supplied regions and removes any pages with contents that are unchanged since the last guest -> host synchronization, the remaining pages are coalesced into regions
+         * @note The state mutex **must** be locked when calling this
+         */
+        void FilterUnchangedRegions(SyncRegions &regions);
+
       private:
         BufferDelegate *delegate;
+        std::vector<BufferDelegate *> linkedDelegates; //!< The delegates of all buffers that were coalesced into this buffer, these all link directly to `delegate` so they can be retargeted if this buffer is coalesced in turn
 
         friend BufferView;
         friend BufferManager;
@@ -140,6 +180,22 @@ namespace skyline::gpu {
          */
         bool RefreshGpuWritesActiveDirect(bool wait = false, const std::function<void()> &flushHostCallback = {});
 
+        /**
+         * @brief Records an inline update that will be performed on the GPU while the buffer has pending GPU writes, the contents of the region are known on the CPU until the next GPU write of indeterminate contents
+         */
+        void TrackSequencedGpuWrite(span<u8> data, vk::DeviceSize offset);
+
+        /**
+         * @brief Frees the shadow of any sequenced GPU writes, this should be called once the buffer has no pending GPU writes
+         */
+        void ResetSequencedGpuWrites();
+
+        /**
+         * @brief Attempts to read the supplied region from the shadow of sequenced GPU writes
+         * @return If the region was entirely enclosed by sequenced GPU writes and has been read into `data`
+         */
+        bool ReadSequencedGpuWrites(span<u8> data, vk::DeviceSize offset);
+
         bool ValidateMegaBufferViewImplDirect(vk::DeviceSize size);
 
         bool ValidateMegaBufferViewImplStaged(vk::DeviceSize size);
@@ -170,7 +226,10 @@ namespace skyline::gpu {
 
         void MarkGpuDirtyImplStaged();
 
-        void MarkGpuDirtyImpl();
+        /**
+         * @param sequenced If the GPU writes are an inline update with contents known on the CPU, these are tracked separately and don't invalidate prior tracked inline updates
+         */
+        void MarkGpuDirtyImpl(bool sequenced = false);
 
       public:
         void UpdateCycle(const std::shared_ptr<FenceCycle> &newCycle) {
@@ -412,6 +471,27 @@ namespace skyline::gpu {
          */
         void AdvanceSequence();
 
+        /**
+         * @return The current sequence number of the buffer, see the comment for `sequenceNumber`
+         * @note The sequence number may be advanced at any point unless the buffer is locked
+         */
+        u32 GetSequenceNumber() const {
+            return sequenceNumber;
+        }
+
+        /**
+         * @return If the sequence number of the buffer identifies its current backing contents, this allows caching data derived from the backing across executions
+         * @note This is never the case for direct buffers as guest writes reach the backing without advancing the sequence, nor for GPU dirty buffers as their contents are indeterminate
+         * @note The buffer **must** be locked prior to calling this
+         */
+        bool SequenceIdentifiesContents() {
+            if (isDirect)
+                return false;
+
+            std::scoped_lock lock{stateMutex};
+            return dirtyState == DirtyState::Clean;
+        }
+
         /**
          * @param isFirstUsage If this is the first usage of this resource in the context as returned from LockWithTag(...)
          * @param flushHostCallback Callback to flush and execute all pending GPU work to allow for synchronisation of GPU dirty buffers
@@ -429,6 +509,7 @@ namespace skyline::gpu {
 
     /**
      * @brief A delegate for a strong reference to a Buffer by a BufferView which can be changed to another Buffer transparently
+     * @note Linked delegates always directly target the delegate of a live buffer as they're retargeted whenever that buffer is coalesced, this keeps resolution to at most a single hop regardless of how many times a buffer has been recreated
      */
     class BufferDelegate {
       private:
@@ -454,6 +535,13 @@ namespace skyline::gpu {
          */
         void Link(BufferDelegate *newTarget, vk::DeviceSize newOffset);
 
+        /**
+         * @brief Retargets an already linked delegate to a new delegate, this is used to skip over the delegate of a buffer that was coalesced into another
+         * @param offsetDelta The offset of the current target buffer inside the new target buffer
+         * @note Both the current target buffer object and new target buffer object **must** be locked prior to calling this
+         */
+        void Relink(BufferDelegate *newTarget, vk::DeviceSize offsetDelta);
+
         /**
          * @return The offset of the delegate in the buffer
          * @note The target buffer **must** be locked prior to calling this
@@ -564,8 +652,15 @@ namespace skyline::gpu {
          */
         void CopyFrom(BufferView src, UsageTracker &usageTracker, const std::function<void()> &gpuCopyCallback);
 
-        constexpr operator bool() {
+        constexpr operator bool() const {
             return delegate != nullptr;
         }
+
+        /**
+         * @return The delegate this view refers to alongside the offset of the view within it, views with an identical delegate, offset and size will always resolve to the same binding
+         */
+        std::pair<BufferDelegate *, vk::DeviceSize> GetDelegateRegion() const {
+            return {delegate, offset};
+        }
     };
 }
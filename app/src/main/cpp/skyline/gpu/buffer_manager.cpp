@@ -8,6 +8,18 @@
 namespace skyline::gpu {
     BufferManager::BufferManager(GPU &gpu) : gpu{gpu} {}
 
+    void BufferManager::lock() {
+        mutex.lock();
+    }
+
+    void BufferManager::unlock() {
+        mutex.unlock();
+    }
+
+    bool BufferManager::try_lock() {
+        return mutex.try_lock();
+    }
+
     bool BufferManager::BufferLessThan(const std::shared_ptr<Buffer> &it, u8 *pointer) {
         return it->guest->begin().base() < pointer;
     }
@@ -138,6 +150,14 @@ namespace skyline::gpu {
             // Transfer all views from the overlapping buffer to the new buffer with the new buffer and updated offset, ensuring pointer stability
             vk::DeviceSize overlapOffset{static_cast<vk::DeviceSize>(srcBuffer->guest->begin() - newBuffer->guest->begin())};
             srcBuffer->delegate->Link(newBuffer->delegate, overlapOffset);
+            newBuffer->linkedDelegates.push_back(srcBuffer->delegate);
+
+            // Delegates that were linked to the overlapping buffer are retargeted at the new buffer directly rather than being chained through the overlapping buffer's delegate, this keeps delegate resolution O(1) for views that have survived many recreations
+            for (auto linkedDelegate : srcBuffer->linkedDelegates) {
+                linkedDelegate->Relink(newBuffer->delegate, overlapOffset);
+                newBuffer->linkedDelegates.push_back(linkedDelegate);
+            }
+            srcBuffer->linkedDelegates.clear();
         }
 
         return newBuffer;
@@ -152,6 +172,7 @@ namespace skyline::gpu {
         auto alignedStart{util::AlignDown(guestMapping.begin().base(), constant::PageSize)}, alignedEnd{util::AlignUp(guestMapping.end().base(), constant::PageSize)};
         span<u8> alignedGuestMapping{alignedStart, alignedEnd};
 
+        std::scoped_lock lock{*this};
         auto overlaps{Lookup(alignedGuestMapping, tag)};
         if (overlaps.size() == 1) [[likely]] {
             // If we find a buffer which can entirely fit the guest mapping, we can just return a view into it
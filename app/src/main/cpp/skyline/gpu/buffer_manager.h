@@ -16,6 +16,7 @@ namespace skyline::gpu {
     class BufferManager {
       private:
         GPU &gpu;
+        std::mutex mutex; //!< Synchronizes access to the buffer mappings and table, this allows channels to look up buffers without any external synchronization
         std::vector<std::shared_ptr<Buffer>> bufferMappings; //!< A sorted vector of all buffer mappings
         LinearAllocatorState<> delegateAllocatorState; //!< Linear allocator used to allocate buffer delegates
         size_t nextBufferId{}; //!< The next unique buffer id to be assigned
@@ -75,13 +76,13 @@ namespace skyline::gpu {
         BufferManager(GPU &gpu);
 
         /**
-         * @brief Acquires an exclusive lock on the texture for the calling thread
+         * @brief Acquires an exclusive lock on the buffer manager for the calling thread
          * @note Naming is in accordance to the BasicLockable named requirement
          */
         void lock();
 
         /**
-         * @brief Relinquishes an existing lock on the texture by the calling thread
+         * @brief Relinquishes an existing lock on the buffer manager by the calling thread
          * @note Naming is in accordance to the BasicLockable named requirement
          */
         void unlock();
@@ -95,7 +96,7 @@ namespace skyline::gpu {
         /**
          * @param attachBuffer A function that attaches the buffer to the current context, this'll be called when coalesced buffers are merged into the current buffer
          * @return A pre-existing or newly created Buffer object which covers the supplied mappings
-         * @note The buffer manager **must** be locked prior to calling this
+         * @note The buffer manager is locked internally and **must not** be locked by the caller
          */
         BufferView FindOrCreateImpl(GuestBuffer guestMapping, ContextTag tag, const std::function<void(std::shared_ptr<Buffer>, ContextLock<Buffer> &&)> &attachBuffer);
 
@@ -140,13 +140,40 @@ namespace skyline::gpu::cache {
         return true;
     }
 
-    vk::Framebuffer FramebufferCache::GetFramebuffer(const FramebufferCreateInfo &createInfo) {
+    void FramebufferCache::Evict(decltype(framebufferCache)::iterator it) {
+        auto &entry{it->second};
+        lruList.erase(entry.lruIt);
+        if (entry.cycle)
+            entry.cycle->AttachObject(std::make_shared<vk::raii::Framebuffer>(std::move(entry.framebuffer)));
+        framebufferCache.erase(it);
+    }
+
+    vk::Framebuffer FramebufferCache::GetFramebuffer(const FramebufferCreateInfo &createInfo, const std::shared_ptr<FenceCycle> &cycle) {
         std::scoped_lock lock{mutex};
         auto it{framebufferCache.find(createInfo)};
-        if (it != framebufferCache.end())
-            return *it->second;
+        if (it != framebufferCache.end()) {
+            auto &entry{it->second};
+            entry.cycle = cycle;
+            lruList.splice(lruList.begin(), lruList, entry.lruIt);
+            return *entry.framebuffer;
+        }
+
+        if (framebufferCache.size() >= MaxFramebufferCount)
+            Evict(framebufferCache.find(*lruList.back()));
 
-        auto entryIt{framebufferCache.try_emplace(FramebufferCacheKey{createInfo}, gpu.vkDevice, createInfo.get<vk::FramebufferCreateInfo>())};
-        return *entryIt.first->second;
+        auto entryIt{framebufferCache.try_emplace(FramebufferCacheKey{createInfo}, vk::raii::Framebuffer{gpu.vkDevice, createInfo.get<vk::FramebufferCreateInfo>()}).first};
+        auto &entry{entryIt->second};
+        entry.cycle = cycle;
+        entry.lruIt = lruList.insert(lruList.begin(), &entryIt->first);
+        return *entry.framebuffer;
+    }
+
+    void FramebufferCache::EvictRenderPass(vk::RenderPass renderPass) {
+        std::scoped_lock lock{mutex};
+        for (auto it{framebufferCache.begin()}; it != framebufferCache.end();) {
+            auto current{it++};
+            if (current->first.renderPass == renderPass)
+                Evict(current);
+        }
     }
 }
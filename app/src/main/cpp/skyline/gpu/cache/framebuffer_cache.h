@@ -5,6 +5,7 @@
 
 #include <vulkan/vulkan_raii.hpp>
 #include <common.h>
+#include <gpu/fence_cycle.h>
 
 namespace skyline::gpu::cache {
     using FramebufferCreateInfo = vk::StructureChain<vk::FramebufferCreateInfo, vk::FramebufferAttachmentsCreateInfo>;
@@ -65,15 +66,38 @@ namespace skyline::gpu::cache {
             bool operator()(const FramebufferCacheKey &lhs, const FramebufferCreateInfo &rhs) const;
         };
 
-        std::unordered_map<FramebufferCacheKey, vk::raii::Framebuffer, FramebufferHash, FramebufferEqual> framebufferCache;
+        static constexpr size_t MaxFramebufferCount{512}; //!< The maximum amount of framebuffers in the cache, the least recently used framebuffers are evicted beyond this
+
+        struct FramebufferEntry {
+            vk::raii::Framebuffer framebuffer;
+            std::shared_ptr<FenceCycle> cycle; //!< The cycle of the last execution the framebuffer was used in, destruction of the framebuffer is deferred till it has been signalled
+            std::list<const FramebufferCacheKey *>::iterator lruIt;
+
+            FramebufferEntry(vk::raii::Framebuffer &&framebuffer) : framebuffer{std::move(framebuffer)} {}
+        };
+
+        std::unordered_map<FramebufferCacheKey, FramebufferEntry, FramebufferHash, FramebufferEqual> framebufferCache;
+        std::list<const FramebufferCacheKey *> lruList; //!< The keys of all cached framebuffers ordered from the most to the least recently used
+
+        /**
+         * @brief Removes the supplied framebuffer from the cache, its destruction is deferred till the last execution using it has completed
+         */
+        void Evict(decltype(framebufferCache)::iterator it);
 
       public:
         FramebufferCache(GPU &gpu);
 
         /**
+         * @param cycle The cycle of the execution the framebuffer will be used in
          * @note When using imageless framebuffer attachments, VkFramebufferAttachmentImageInfo **must** have a single view format
          * @note When using image framebuffer attachments, it is expected that the supplied image handle will remain stable for the cache to function
          */
-        vk::Framebuffer GetFramebuffer(const FramebufferCreateInfo &createInfo);
+        vk::Framebuffer GetFramebuffer(const FramebufferCreateInfo &createInfo, const std::shared_ptr<FenceCycle> &cycle);
+
+        /**
+         * @brief Evicts all framebuffers created with the supplied render pass
+         * @note This must be called prior to the render pass being destroyed as its handle could be reused by a future incompatible render pass otherwise
+         */
+        void EvictRenderPass(vk::RenderPass renderPass);
     };
 }
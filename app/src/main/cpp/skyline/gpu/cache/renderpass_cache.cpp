@@ -187,13 +187,34 @@ namespace skyline::gpu::cache {
         return true;
     }
 
-    vk::RenderPass RenderPassCache::GetRenderPass(const vk::RenderPassCreateInfo &createInfo) {
+    void RenderPassCache::EvictLeastRecentlyUsed() {
+        auto it{renderPassCache.find(*lruList.back())};
+        auto &entry{it->second};
+        lruList.pop_back();
+
+        gpu.framebufferCache.EvictRenderPass(*entry.renderPass);
+        if (entry.cycle)
+            entry.cycle->AttachObject(std::make_shared<vk::raii::RenderPass>(std::move(entry.renderPass)));
+        renderPassCache.erase(it);
+    }
+
+    vk::RenderPass RenderPassCache::GetRenderPass(const vk::RenderPassCreateInfo &createInfo, const std::shared_ptr<FenceCycle> &cycle) {
         std::scoped_lock lock{mutex};
         auto it{renderPassCache.find(createInfo)};
-        if (it != renderPassCache.end())
-            return *it->second;
+        if (it != renderPassCache.end()) {
+            auto &entry{it->second};
+            entry.cycle = cycle;
+            lruList.splice(lruList.begin(), lruList, entry.lruIt);
+            return *entry.renderPass;
+        }
+
+        if (renderPassCache.size() >= MaxRenderPassCount)
+            EvictLeastRecentlyUsed();
 
-        auto entryIt{renderPassCache.try_emplace(RenderPassMetadata{createInfo}, gpu.vkDevice, createInfo)};
-        return *entryIt.first->second;
+        auto entryIt{renderPassCache.try_emplace(RenderPassMetadata{createInfo}, vk::raii::RenderPass{gpu.vkDevice, createInfo}).first};
+        auto &entry{entryIt->second};
+        entry.cycle = cycle;
+        entry.lruIt = lruList.insert(lruList.begin(), &entryIt->first);
+        return *entry.renderPass;
     }
 }
@@ -5,6 +5,7 @@
 
 #include <vulkan/vulkan_raii.hpp>
 #include <common.h>
+#include <gpu/fence_cycle.h>
 
 namespace skyline::gpu::cache {
     /**
@@ -61,11 +62,30 @@ namespace skyline::gpu::cache {
             bool operator()(const RenderPassMetadata &lhs, const vk::RenderPassCreateInfo &rhs) const;
         };
 
-        std::unordered_map<RenderPassMetadata, vk::raii::RenderPass, RenderPassHash, RenderPassEqual> renderPassCache;
+        static constexpr size_t MaxRenderPassCount{256}; //!< The maximum amount of render passes in the cache, the least recently used render passes are evicted beyond this
+
+        struct RenderPassEntry {
+            vk::raii::RenderPass renderPass;
+            std::shared_ptr<FenceCycle> cycle; //!< The cycle of the last execution the render pass was used in, destruction of the render pass is deferred till it has been signalled
+            std::list<const RenderPassMetadata *>::iterator lruIt;
+
+            RenderPassEntry(vk::raii::RenderPass &&renderPass) : renderPass{std::move(renderPass)} {}
+        };
+
+        std::unordered_map<RenderPassMetadata, RenderPassEntry, RenderPassHash, RenderPassEqual> renderPassCache;
+        std::list<const RenderPassMetadata *> lruList; //!< The keys of all cached render passes ordered from the most to the least recently used
+
+        /**
+         * @brief Evicts the least recently used render pass alongside any framebuffers created with it, its destruction is deferred till the last execution using it has completed
+         */
+        void EvictLeastRecentlyUsed();
 
       public:
         RenderPassCache(GPU &gpu);
 
-        vk::RenderPass GetRenderPass(const vk::RenderPassCreateInfo &createInfo);
+        /**
+         * @param cycle The cycle of the execution the render pass will be used in
+         */
+        vk::RenderPass GetRenderPass(const vk::RenderPassCreateInfo &createInfo, const std::shared_ptr<FenceCycle> &cycle);
     };
 }
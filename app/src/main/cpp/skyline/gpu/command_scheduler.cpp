@@ -8,6 +8,46 @@
 #include "common/exception.h"
 
 namespace skyline::gpu {
+    void CommandScheduler::WaitAny(span<const std::shared_ptr<FenceCycle>> cycles) {
+        TRACE_EVENT("gpu", "CommandScheduler::WaitAny", "count", cycles.size());
+
+        // A cancelled cycle might never be signalled by the GPU, it's treated as being signalled already
+        if (std::any_of(cycles.begin(), cycles.end(), [](const auto &cycle) { return cycle->signalled.test(std::memory_order_consume); }))
+            return;
+
+        auto &front{*cycles.front()};
+        if (front.timeline) {
+            // All cycles share the same timeline semaphore, its value reaching the lowest value of any cycle implies that cycle has been signalled
+            u64 value{front.timelineValue};
+            for (const auto &cycle : cycles)
+                value = std::min(value, cycle->timelineValue);
+            front.timeline->Wait(value);
+            return;
+        }
+
+        boost::container::small_vector<vk::Fence, 32> fences;
+        for (const auto &cycle : cycles)
+            fences.push_back(cycle->fence);
+
+        vk::Result waitResult;
+        while ((waitResult = (*front.device).waitForFences(static_cast<u32>(fences.size()), fences.data(), false, std::numeric_limits<u64>::max(), *front.device.getDispatcher())) != vk::Result::eSuccess) {
+            if (waitResult == vk::Result::eTimeout || waitResult == vk::Result::eErrorInitializationFailed)
+                // See FenceCycle::Wait for why eErrorInitializationFailed is retried
+                continue;
+
+            throw exception("An error occurred while waiting for {} fences: {}", fences.size(), vk::to_string(waitResult));
+        }
+    }
+
+    bool CommandScheduler::PollSubmission(FenceCycle &cycle) {
+        if (cycle.signalled.test(std::memory_order_consume))
+            return true;
+
+        if (cycle.timeline)
+            return cycle.timeline->Poll(cycle.timelineValue);
+        return (*cycle.device).getFenceStatus(cycle.fence, *cycle.device.getDispatcher()) == vk::Result::eSuccess;
+    }
+
     void CommandScheduler::WaiterThread() {
         if (int result{pthread_setname_np(pthread_self(), "Sky-CycleWaiter")})
             Logger::Warn("Failed to set the thread name: {}", strerror(result));
@@ -15,9 +55,34 @@ namespace skyline::gpu {
         try {
             signal::SetSignalHandler({SIGINT, SIGILL, SIGTRAP, SIGBUS, SIGFPE, SIGSEGV}, signal::ExceptionalSignalHandler);
 
-            cycleQueue.Process([](const std::shared_ptr<FenceCycle> &cycle) {
-                cycle->Wait(true);
-            }, [] {});
+            // All submitted cycles are waited on together rather than one after another, every cycle which was signalled by the time the wait completes is then retired as a group
+            std::vector<std::shared_ptr<FenceCycle>> waitingCycles;
+            waitingCycles.reserve(FenceCycleWaitCount);
+            while (true) {
+                if (waitingCycles.empty())
+                    waitingCycles.push_back(cycleQueue.Pop());
+                while (auto cycle{cycleQueue.TryPop()})
+                    waitingCycles.push_back(std::move(*cycle));
+
+                WaitAny(waitingCycles);
+
+                size_t retiredCount{};
+                std::erase_if(waitingCycles, [&](const std::shared_ptr<FenceCycle> &cycle) {
+                    if (!PollSubmission(*cycle))
+                        return false;
+
+                    cycle->Wait(true); // This handles any chained cycles and destroys the dependencies of the cycle
+                    retiredCount++;
+                    return true;
+                });
+
+                if (retiredCount) {
+                    std::scoped_lock lock{idleMutex};
+                    pendingSubmissions -= retiredCount;
+                    if (pendingSubmissions == 0)
+                        idleStartTime = util::GetTimeNs();
+                }
+            }
         } catch (const signal::SignalException &e) {
             Logger::Error("{}\nStack Trace:{}", e.what(), state.loader->GetStackTrace(e.frames));
             if (state.process)
@@ -33,16 +98,19 @@ namespace skyline::gpu {
         }
     }
 
-    CommandScheduler::CommandBufferSlot::CommandBufferSlot(vk::raii::Device &device, vk::CommandBuffer commandBuffer, vk::raii::CommandPool &pool)
+    CommandScheduler::CommandBufferSlot::CommandBufferSlot(vk::raii::Device &device, vk::CommandBuffer commandBuffer, vk::raii::CommandPool &pool, TimelineSemaphore *timeline)
         : device{device},
           commandBuffer{device, static_cast<VkCommandBuffer>(commandBuffer), static_cast<VkCommandPool>(*pool)},
           fence{device, vk::FenceCreateInfo{}},
           semaphore{device, vk::SemaphoreCreateInfo{}},
-          cycle{std::make_shared<FenceCycle>(device, *fence, *semaphore)} {}
+          cycle{std::make_shared<FenceCycle>(device, *fence, *semaphore, timeline)} {}
 
-    CommandScheduler::CommandScheduler(const DeviceState &state, GPU &pGpu)
+    CommandScheduler::CommandScheduler(const DeviceState &state, GPU &pGpu, vk::raii::Queue &queue, std::mutex &queueMutex)
         : state{state},
           gpu{pGpu},
+          queue{queue},
+          queueMutex{queueMutex},
+          timeline{pGpu.traits.supportsTimelineSemaphores ? std::optional<TimelineSemaphore>{std::in_place, pGpu.vkDevice} : std::nullopt},
           waiterThread{&CommandScheduler::WaiterThread, this},
           pool{std::ref(pGpu.vkDevice), vk::CommandPoolCreateInfo{
               .flags = vk::CommandPoolCreateFlagBits::eTransient | vk::CommandPoolCreateFlagBits::eResetCommandBuffer,
@@ -53,6 +121,18 @@ namespace skyline::gpu {
         waiterThread.join();
     }
 
+    u64 CommandScheduler::ConsumeIdleTime() {
+        std::scoped_lock lock{idleMutex};
+        if (idleStartTime) {
+            // Account for the ongoing idle period up till now, the remainder will be accounted for in the next call
+            auto time{util::GetTimeNs()};
+            idleTime += time - idleStartTime;
+            idleStartTime = time;
+        }
+
+        return std::exchange(idleTime, 0);
+    }
+
     CommandScheduler::ActiveCommandBuffer CommandScheduler::AllocateCommandBuffer() {
         for (auto &slot : pool->buffers) {
             if (!slot.active.test_and_set(std::memory_order_acq_rel)) {
@@ -76,34 +156,69 @@ namespace skyline::gpu {
         auto result{(*gpu.vkDevice).allocateCommandBuffers(&commandBufferAllocateInfo, &commandBuffer, *gpu.vkDevice.getDispatcher())};
         if (result != vk::Result::eSuccess)
             vk::throwResultException(result, __builtin_FUNCTION());
-        return {pool->buffers.emplace_back(gpu.vkDevice, commandBuffer, pool->vkCommandPool)};
+        return {pool->buffers.emplace_back(gpu.vkDevice, commandBuffer, pool->vkCommandPool, GetTimeline())};
     }
 
-    void CommandScheduler::SubmitCommandBuffer(const vk::raii::CommandBuffer &commandBuffer, std::shared_ptr<FenceCycle> cycle, span<vk::Semaphore> waitSemaphores, span<vk::Semaphore> signalSemaphores) {
+    void CommandScheduler::SubmitCommandBuffer(const vk::raii::CommandBuffer &commandBuffer, std::shared_ptr<FenceCycle> cycle, span<vk::Semaphore> waitSemaphores, span<vk::Semaphore> signalSemaphores, span<FenceCycle::TimelinePoint> waitTimelinePoints) {
         boost::container::small_vector<vk::Semaphore, 3> fullWaitSemaphores{waitSemaphores.begin(), waitSemaphores.end()};
         boost::container::small_vector<vk::PipelineStageFlags, 3> fullWaitStages{waitSemaphores.size(), vk::PipelineStageFlagBits::eAllCommands};
 
+        // Wait values for binary semaphores are ignored, they're only meaningful for the timeline semaphores which follow them
+        boost::container::small_vector<u64, 4> waitValues;
+        if (!waitTimelinePoints.empty()) {
+            waitValues.resize(fullWaitSemaphores.size());
+            for (const auto &[semaphore, value] : waitTimelinePoints) {
+                fullWaitSemaphores.push_back(semaphore);
+                fullWaitStages.push_back(vk::PipelineStageFlagBits::eAllCommands);
+                waitValues.push_back(value);
+            }
+        }
+
         if (cycle->semaphoreSubmitWait) {
             fullWaitSemaphores.push_back(cycle->semaphore);
             // We don't need a full barrier since this is only done to ensure the semaphore is unsignalled
             fullWaitStages.push_back(vk::PipelineStageFlagBits::eTopOfPipe);
+            if (!waitValues.empty())
+                waitValues.push_back(0);
         }
 
         boost::container::small_vector<vk::Semaphore, 2> fullSignalSemaphores{signalSemaphores.begin(), signalSemaphores.end()};
         fullSignalSemaphores.push_back(cycle->semaphore);
 
+        // Values for binary semaphores are ignored, only the timeline semaphore's value (which is always last) is meaningful
+        boost::container::small_vector<u64, 3> signalValues;
+        if (cycle->timeline) {
+            fullSignalSemaphores.push_back(**cycle->timeline);
+            signalValues.resize(fullSignalSemaphores.size());
+        }
+
         {
             try {
-                std::scoped_lock lock{gpu.queueMutex};
-                gpu.vkQueue.submit(vk::SubmitInfo{
-                    .commandBufferCount = 1,
-                    .pCommandBuffers = &*commandBuffer,
-                    .waitSemaphoreCount = static_cast<u32>(fullWaitSemaphores.size()),
-                    .pWaitSemaphores = fullWaitSemaphores.data(),
-                    .pWaitDstStageMask = fullWaitStages.data(),
-                    .signalSemaphoreCount = static_cast<u32>(fullSignalSemaphores.size()),
-                    .pSignalSemaphores = fullSignalSemaphores.data(),
-                }, cycle->fence);
+                std::scoped_lock lock{queueMutex};
+                if (cycle->timeline)
+                    signalValues.back() = cycle->timelineValue = cycle->timeline->AllocateValue();
+
+                vk::StructureChain<vk::SubmitInfo, vk::TimelineSemaphoreSubmitInfoKHR> submitInfo{
+                    vk::SubmitInfo{
+                        .commandBufferCount = 1,
+                        .pCommandBuffers = &*commandBuffer,
+                        .waitSemaphoreCount = static_cast<u32>(fullWaitSemaphores.size()),
+                        .pWaitSemaphores = fullWaitSemaphores.data(),
+                        .pWaitDstStageMask = fullWaitStages.data(),
+                        .signalSemaphoreCount = static_cast<u32>(fullSignalSemaphores.size()),
+                        .pSignalSemaphores = fullSignalSemaphores.data(),
+                    },
+                    vk::TimelineSemaphoreSubmitInfoKHR{
+                        .waitSemaphoreValueCount = static_cast<u32>(waitValues.size()),
+                        .pWaitSemaphoreValues = waitValues.data(),
+                        .signalSemaphoreValueCount = static_cast<u32>(signalValues.size()),
+                        .pSignalSemaphoreValues = signalValues.data(),
+                    }
+                };
+                if (!cycle->timeline && waitValues.empty())
+                    submitInfo.unlink<vk::TimelineSemaphoreSubmitInfoKHR>();
+
+                queue.submit(submitInfo.get<vk::SubmitInfo>(), cycle->timeline ? vk::Fence{} : cycle->fence);
             } catch (const vk::DeviceLostError &e) {
                 // Wait 5 seconds to give traces etc. time to settle
                 std::this_thread::sleep_for(std::chrono::seconds(5));
@@ -111,6 +226,14 @@ namespace skyline::gpu {
             }
         }
 
+        {
+            std::scoped_lock lock{idleMutex};
+            if (pendingSubmissions++ == 0 && idleStartTime) {
+                idleTime += util::GetTimeNs() - idleStartTime;
+                idleStartTime = 0;
+            }
+        }
+
         cycle->NotifySubmitted();
         cycleQueue.Push(cycle);
     }
@@ -24,11 +24,14 @@ namespace skyline::gpu {
             vk::raii::Semaphore semaphore; //!< A semaphore used for tracking work status on the GPU
             std::shared_ptr<FenceCycle> cycle; //!< The latest cycle on the fence, all waits must be performed through this
 
-            CommandBufferSlot(vk::raii::Device &device, vk::CommandBuffer commandBuffer, vk::raii::CommandPool &pool);
+            CommandBufferSlot(vk::raii::Device &device, vk::CommandBuffer commandBuffer, vk::raii::CommandPool &pool, TimelineSemaphore *timeline);
         };
 
         const DeviceState &state;
         GPU &gpu;
+        vk::raii::Queue &queue; //!< The queue that all command buffers are submitted to
+        std::mutex &queueMutex; //!< Synchronizes access to the queue as it is externally synchronized
+        std::optional<TimelineSemaphore> timeline; //!< The timeline semaphore signalled by all submissions, this is only present on devices that support timeline semaphores
 
         /**
          * @brief A command pool designed to be thread-local to respect external synchronization for all command buffers and the associated pool
@@ -47,6 +50,22 @@ namespace skyline::gpu {
         static constexpr size_t FenceCycleWaitCount{256}; //!< The amount of fence cycles the cycle queue can hold
         CircularQueue<std::shared_ptr<FenceCycle>> cycleQueue{FenceCycleWaitCount}; //!< A circular queue containing all the active cycles that can be waited on
 
+        SpinLock idleMutex; //!< Synchronizes all GPU idle time tracking state
+        size_t pendingSubmissions{}; //!< The amount of submissions which haven't been observed to have completed by the waiter thread
+        u64 idleStartTime{}; //!< The time at which the GPU was last observed to have run out of work or 0 if it's currently busy
+        u64 idleTime{}; //!< The time the GPU has spent idle since the last call to ConsumeIdleTime
+
+        /**
+         * @brief Waits till at least one of the supplied submitted cycles has been signalled by the GPU, this is a single wait on the host regardless of the amount of cycles
+         * @note Chained cycles aren't waited on, the cycles must still be waited on individually to observe them
+         */
+        static void WaitAny(span<const std::shared_ptr<FenceCycle>> cycles);
+
+        /**
+         * @return If the GPU has signalled the fence or timeline value of the supplied submitted cycle, this doesn't account for chained cycles
+         */
+        static bool PollSubmission(FenceCycle &cycle);
+
         void WaiterThread();
 
       public:
@@ -101,10 +120,23 @@ namespace skyline::gpu {
             }
         };
 
-        CommandScheduler(const DeviceState &state, GPU &gpu);
+        CommandScheduler(const DeviceState &state, GPU &gpu, vk::raii::Queue &queue, std::mutex &queueMutex);
 
         ~CommandScheduler();
 
+        /**
+         * @return The timeline semaphore that should be used by any FenceCycle submitted through the scheduler or nullptr if they should use their fence
+         */
+        TimelineSemaphore *GetTimeline() {
+            return timeline ? &*timeline : nullptr;
+        }
+
+        /**
+         * @return The amount of time in nanoseconds the GPU has spent without any submissions to execute since the last call to this
+         * @note The GPU is considered idle from when the waiter thread observes the completion of the last pending submission till the next submission
+         */
+        u64 ConsumeIdleTime();
+
         /**
          * @brief Allocates an existing or new primary command buffer from the pool
          */
@@ -114,16 +146,18 @@ namespace skyline::gpu {
          * @brief Submits a single command buffer to the GPU queue while queuing it up to be waited on
          * @note The supplied command buffer and cycle **must** be from AllocateCommandBuffer()
          * @note Any cycle submitted via this method does not need to destroy dependencies manually, the waiter thread will handle this
+         * @param waitTimelinePoints A span of timeline semaphore points that should be reached before the GPU executes the command buffer, this is used to hand off work between queues
          */
-        void SubmitCommandBuffer(const vk::raii::CommandBuffer &commandBuffer, std::shared_ptr<FenceCycle> cycle, span<vk::Semaphore> waitSemaphores = {}, span<vk::Semaphore> signalSemaphore = {});
+        void SubmitCommandBuffer(const vk::raii::CommandBuffer &commandBuffer, std::shared_ptr<FenceCycle> cycle, span<vk::Semaphore> waitSemaphores = {}, span<vk::Semaphore> signalSemaphore = {}, span<FenceCycle::TimelinePoint> waitTimelinePoints = {});
 
         /**
          * @brief Submits a command buffer recorded with the supplied function synchronously
          * @param waitSemaphores A span of all (excl fence cycle) semaphores that should be waited on by the GPU before executing the command buffer
          * @param signalSemaphore A span of all semaphores that should be signalled by the GPU after executing the command buffer
+         * @param waitTimelinePoints A span of all timeline semaphore points that should be reached before the GPU executes the command buffer
          */
         template<typename RecordFunction>
-        std::shared_ptr<FenceCycle> Submit(RecordFunction recordFunction, span<vk::Semaphore> waitSemaphores = {}, span<vk::Semaphore> signalSemaphores = {}) {
+        std::shared_ptr<FenceCycle> Submit(RecordFunction recordFunction, span<vk::Semaphore> waitSemaphores = {}, span<vk::Semaphore> signalSemaphores = {}, span<FenceCycle::TimelinePoint> waitTimelinePoints = {}) {
             auto commandBuffer{AllocateCommandBuffer()};
             try {
                 commandBuffer->begin(vk::CommandBufferBeginInfo{
@@ -133,7 +167,7 @@ namespace skyline::gpu {
                 commandBuffer->end();
 
                 auto cycle{commandBuffer.GetFenceCycle()};
-                SubmitCommandBuffer(*commandBuffer, cycle, waitSemaphores, signalSemaphores);
+                SubmitCommandBuffer(*commandBuffer, cycle, waitSemaphores, signalSemaphores, waitTimelinePoints);
                 return cycle;
             } catch (...) {
                 commandBuffer.GetFenceCycle()->Cancel();
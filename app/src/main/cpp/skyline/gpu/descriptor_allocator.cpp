@@ -16,7 +16,7 @@ namespace skyline::gpu {
 
     void DescriptorAllocator::AllocateDescriptorPool() {
         namespace maxwell3d = soc::gm20b::engine::maxwell3d::type; // We use Maxwell3D as reference for base descriptor counts
-        using DescriptorSizes = std::array<vk::DescriptorPoolSize, 6>;
+        using DescriptorSizes = std::array<vk::DescriptorPoolSize, 7>;
 
         constexpr DescriptorSizes BaseDescriptorSizes{
             vk::DescriptorPoolSize{
@@ -42,18 +42,33 @@ namespace skyline::gpu {
             vk::DescriptorPoolSize{
                 .descriptorCount = 4,
                 .type = vk::DescriptorType::eStorageTexelBuffer,
+            },
+            vk::DescriptorPoolSize{
+                .descriptorCount = 64 * 256, // Inline uniform block counts are in bytes rather than descriptors
+                .type = vk::DescriptorType::eInlineUniformBlockEXT,
             } //!< Approximated descriptor counts based off empirical testing, the total amount will grow in these ratios
         };
+        constexpr u32 BaseInlineUniformBlockBindings{64};
 
         DescriptorSizes descriptorSizes{BaseDescriptorSizes};
         for (auto &descriptorSize : descriptorSizes)
             descriptorSize.descriptorCount *= descriptorMultiplier;
 
-        pool = std::make_shared<DescriptorPool>(gpu.vkDevice, vk::DescriptorPoolCreateInfo{
-            .maxSets = descriptorSetCount,
-            .pPoolSizes = descriptorSizes.data(),
-            .poolSizeCount = descriptorSizes.size(),
-        });
+        // Inline uniform blocks can only be allocated from the pool when the extension is enabled, the size for them is last so it can be dropped otherwise
+        vk::StructureChain<vk::DescriptorPoolCreateInfo, vk::DescriptorPoolInlineUniformBlockCreateInfoEXT> createInfo{
+            vk::DescriptorPoolCreateInfo{
+                .maxSets = descriptorSetCount,
+                .pPoolSizes = descriptorSizes.data(),
+                .poolSizeCount = static_cast<u32>(gpu.traits.supportsInlineUniformBlock ? descriptorSizes.size() : descriptorSizes.size() - 1),
+            },
+            vk::DescriptorPoolInlineUniformBlockCreateInfoEXT{
+                .maxInlineUniformBlockBindings = BaseInlineUniformBlockBindings * descriptorMultiplier,
+            }
+        };
+        if (!gpu.traits.supportsInlineUniformBlock)
+            createInfo.unlink<vk::DescriptorPoolInlineUniformBlockCreateInfoEXT>();
+
+        pool = std::make_shared<DescriptorPool>(gpu.vkDevice, createInfo.get<vk::DescriptorPoolCreateInfo>());
 
         pool->freeSetCount = descriptorSetCount;
     }
@@ -12,10 +12,181 @@
 namespace skyline::gpu {
     class CommandScheduler;
 
+    /**
+     * @brief A device-wide timeline semaphore that every submission signals with a monotonically increasing value, the completion of a submission can then be determined by a comparison against the last value observed to be reached by the GPU
+     * @note This avoids a fence per submission, a single wait or query covers all submissions prior to the value
+     */
+    class TimelineSemaphore {
+      private:
+        const vk::raii::Device &device;
+        vk::raii::Semaphore semaphore;
+        u64 nextValue{1}; //!< The value that the next submission will signal, this must only be accessed with the queue mutex held
+        std::atomic<u64> completedValue{}; //!< The last value the semaphore was observed to have reached
+
+        /**
+         * @brief Queries the current value of the semaphore and updates the cached value with it
+         */
+        u64 Refresh() {
+            u64 value{(*device).getSemaphoreCounterValueKHR(*semaphore, *device.getDispatcher())};
+            u64 cached{completedValue.load(std::memory_order_relaxed)};
+            while (cached < value && !completedValue.compare_exchange_weak(cached, value, std::memory_order_release, std::memory_order_relaxed));
+            return std::max(cached, value);
+        }
+
+      public:
+        TimelineSemaphore(const vk::raii::Device &device) : device{device}, semaphore{device, vk::StructureChain<vk::SemaphoreCreateInfo, vk::SemaphoreTypeCreateInfoKHR>{
+            {},
+            vk::SemaphoreTypeCreateInfoKHR{
+                .semaphoreType = vk::SemaphoreType::eTimeline,
+                .initialValue = 0,
+            }
+        }.get<vk::SemaphoreCreateInfo>()} {}
+
+        vk::Semaphore operator*() const {
+            return *semaphore;
+        }
+
+        /**
+         * @return The value to be signalled by a new submission
+         * @note The queue mutex must be held from this call till the submission has been made, this ensures that values are signalled in order
+         */
+        u64 AllocateValue() {
+            return nextValue++;
+        }
+
+        /**
+         * @param quick Skips querying the semaphore, only comparing against the last observed value
+         * @return If the semaphore has reached the supplied value
+         */
+        bool Poll(u64 value, bool quick = false) {
+            if (value <= completedValue.load(std::memory_order_acquire))
+                return true;
+            return !quick && value <= Refresh();
+        }
+
+        /**
+         * @brief Waits on the host till the semaphore has reached the supplied value
+         */
+        void Wait(u64 value) {
+            if (Poll(value, true))
+                return;
+
+            vk::Semaphore handle{*semaphore};
+            vk::SemaphoreWaitInfoKHR waitInfo{
+                .semaphoreCount = 1,
+                .pSemaphores = &handle,
+                .pValues = &value,
+            };
+
+            vk::Result waitResult;
+            while ((waitResult = (*device).waitSemaphoresKHR(&waitInfo, std::numeric_limits<u64>::max(), *device.getDispatcher())) != vk::Result::eSuccess) {
+                if (waitResult == vk::Result::eTimeout || waitResult == vk::Result::eErrorInitializationFailed)
+                    // See FenceCycle::Wait for why eErrorInitializationFailed is retried
+                    continue;
+
+                throw exception("An error occurred while waiting for timeline semaphore 0x{:X} to reach {}: {}", static_cast<VkSemaphore>(handle), value, vk::to_string(waitResult));
+            }
+
+            // The semaphore may have advanced beyond the value we waited on, refreshing lets any later polls for those values skip the query
+            Refresh();
+        }
+    };
+
+    /**
+     * @brief A list of objects with lifetimes attached to a FenceCycle, objects are stored in fixed-size chunks rather than a node per object
+     * @note Chunks are recycled through a global pool rather than being freed, attaching objects doesn't require any heap allocations once the pool has warmed up
+     */
+    class FenceCycleDependencies {
+      private:
+        struct Chunk {
+            static constexpr size_t Capacity{30}; //!< The amount of objects in a chunk, this results in a chunk spanning 8 cache lines
+
+            Chunk *next;
+            size_t count;
+            std::array<std::shared_ptr<void>, Capacity> objects;
+        };
+
+        SpinLock mutex; //!< Synchronizes appending to the list as objects may be attached from multiple threads
+        Chunk *head{}; //!< The chunk that's currently being filled, all prior chunks are full
+
+        static inline SpinLock poolMutex;
+        static inline Chunk *pool{}; //!< A singly-linked list of empty chunks
+
+        static Chunk *AllocateChunk(Chunk *next) {
+            Chunk *chunk;
+            {
+                std::scoped_lock lock{poolMutex};
+                chunk = pool;
+                if (chunk)
+                    pool = chunk->next;
+            }
+
+            if (!chunk)
+                chunk = new Chunk{};
+            chunk->next = next;
+            return chunk;
+        }
+
+        template<typename Object>
+        void AppendLocked(Object &&object) {
+            if (!head || head->count == Chunk::Capacity)
+                head = AllocateChunk(head);
+            head->objects[head->count++] = std::forward<Object>(object);
+        }
+
+      public:
+        FenceCycleDependencies() = default;
+
+        FenceCycleDependencies(const FenceCycleDependencies &) = delete;
+
+        FenceCycleDependencies &operator=(const FenceCycleDependencies &) = delete;
+
+        ~FenceCycleDependencies() {
+            Clear();
+        }
+
+        /**
+         * @brief Appends objects to the list, rvalue references are moved into the list to avoid redundant reference count updates
+         */
+        template<typename... Objects>
+        void Append(Objects &&... objects) {
+            std::scoped_lock lock{mutex};
+            (AppendLocked(std::forward<Objects>(objects)), ...);
+        }
+
+        /**
+         * @brief Releases all objects in the list and returns the chunks to the pool
+         * @note The objects are released without any locks held as their destructors may wait on other cycles
+         */
+        void Clear() {
+            Chunk *first;
+            {
+                std::scoped_lock lock{mutex};
+                first = std::exchange(head, nullptr);
+            }
+
+            if (!first)
+                return;
+
+            Chunk *last{};
+            for (auto chunk{first}; chunk; chunk = chunk->next) {
+                for (size_t index{}; index < chunk->count; index++)
+                    chunk->objects[index].reset();
+                chunk->count = 0;
+                last = chunk;
+            }
+
+            std::scoped_lock lock{poolMutex};
+            last->next = pool;
+            pool = first;
+        }
+    };
+
     /**
      * @brief A wrapper around a Vulkan Fence which only tracks a single reset -> signal cycle with the ability to attach lifetimes of objects to it
      * @note This provides the guarantee that the fence must be signalled prior to destruction when objects are to be destroyed
      * @note All waits to the fence **must** be done through the same instance of this, the state of the fence changing externally will lead to UB
+     * @note If a timeline semaphore is supplied then submissions signal it rather than the fence, the fence is never reset or waited on in that case
      */
     struct FenceCycle {
       private:
@@ -26,6 +197,8 @@ namespace skyline::gpu {
         std::condition_variable_any submitCondition;
         bool submitted{}; //!< If the fence has been submitted to the GPU
         vk::Fence fence;
+        TimelineSemaphore *timeline; //!< The timeline semaphore that's signalled by the submission instead of the fence, this is nullptr if timeline semaphores aren't supported
+        u64 timelineValue{}; //!< The value of the timeline semaphore that the submission will signal, this is only valid after submission
         vk::Semaphore semaphore; //!< Semaphore that will be signalled upon GPU completion of the fence
         bool semaphoreSubmitWait{}; //!< If the semaphore needs to be waited on (on GPU) before the fence's command buffer begins. Used to ensure fences that wouldn't otherwise be unsignalled are unsignalled
         bool nextSemaphoreSubmitWait{true}; //!< If the next fence cycle created from this one after it's signalled should wait on the semaphore to unsignal it
@@ -33,7 +206,7 @@ namespace skyline::gpu {
 
         friend CommandScheduler;
 
-        AtomicForwardList<std::shared_ptr<void>> dependencies; //!< A list of all dependencies on this fence cycle
+        FenceCycleDependencies dependencies; //!< A list of all dependencies on this fence cycle
         AtomicForwardList<std::shared_ptr<FenceCycle>> chainedCycles; //!< A list of all chained FenceCycles, this is used to express multi-fence dependencies
         SharedSpinLock chainMutex;
 
@@ -50,13 +223,16 @@ namespace skyline::gpu {
         }
 
       public:
-        FenceCycle(const vk::raii::Device &device, vk::Fence fence, vk::Semaphore semaphore, bool signalled = false) : signalled{signalled}, device{device}, fence{fence}, semaphore{semaphore}, nextSemaphoreSubmitWait{!signalled} {
-            if (!signalled)
+        using TimelinePoint = std::pair<vk::Semaphore, u64>; //!< A timeline semaphore alongside a value of it
+
+        FenceCycle(const vk::raii::Device &device, vk::Fence fence, vk::Semaphore semaphore, TimelineSemaphore *timeline, bool signalled = false) : signalled{signalled}, device{device}, fence{fence}, timeline{timeline}, semaphore{semaphore}, nextSemaphoreSubmitWait{!signalled} {
+            if (!signalled && !timeline)
                 device.resetFences(fence);
         }
 
-        explicit FenceCycle(const FenceCycle &cycle) : signalled{false}, device{cycle.device}, fence{cycle.fence}, semaphore{cycle.semaphore}, semaphoreSubmitWait{cycle.nextSemaphoreSubmitWait} {
-            device.resetFences(fence);
+        explicit FenceCycle(const FenceCycle &cycle) : signalled{false}, device{cycle.device}, fence{cycle.fence}, timeline{cycle.timeline}, semaphore{cycle.semaphore}, semaphoreSubmitWait{cycle.nextSemaphoreSubmitWait} {
+            if (!timeline)
+                device.resetFences(fence);
         }
 
         ~FenceCycle() {
@@ -155,17 +331,21 @@ namespace skyline::gpu {
                 return;
             }
 
-            vk::Result waitResult;
-            while ((waitResult = (*device).waitForFences(1, &fence, false, std::numeric_limits<u64>::max(), *device.getDispatcher())) != vk::Result::eSuccess) {
-                if (waitResult == vk::Result::eTimeout)
-                    // Retry if the waiting time out
-                    continue;
+            if (timeline) {
+                timeline->Wait(timelineValue);
+            } else {
+                vk::Result waitResult;
+                while ((waitResult = (*device).waitForFences(1, &fence, false, std::numeric_limits<u64>::max(), *device.getDispatcher())) != vk::Result::eSuccess) {
+                    if (waitResult == vk::Result::eTimeout)
+                        // Retry if the waiting time out
+                        continue;
 
-                if (waitResult == vk::Result::eErrorInitializationFailed)
-                    // eErrorInitializationFailed occurs on Mali GPU drivers due to them using the ppoll() syscall which isn't correctly restarted after a signal, we need to manually retry waiting in that case
-                    continue;
+                    if (waitResult == vk::Result::eErrorInitializationFailed)
+                        // eErrorInitializationFailed occurs on Mali GPU drivers due to them using the ppoll() syscall which isn't correctly restarted after a signal, we need to manually retry waiting in that case
+                        continue;
 
-                throw exception("An error occurred while waiting for fence 0x{:X}: {}", static_cast<VkFence>(fence), vk::to_string(waitResult));
+                    throw exception("An error occurred while waiting for fence 0x{:X}: {}", static_cast<VkFence>(fence), vk::to_string(waitResult));
+                }
             }
 
             if (semaphoreUnsignalCycle)
@@ -217,8 +397,7 @@ namespace skyline::gpu {
             if (!submitted)
                 return false;
 
-            auto status{(*device).getFenceStatus(fence, *device.getDispatcher())};
-            if (status == vk::Result::eSuccess) {
+            if (timeline ? timeline->Poll(timelineValue) : (*device).getFenceStatus(fence, *device.getDispatcher()) == vk::Result::eSuccess) {
                 if (semaphoreUnsignalCycle && !semaphoreUnsignalCycle->Poll())
                     return false;
 
@@ -231,6 +410,20 @@ namespace skyline::gpu {
             }
         }
 
+        /**
+         * @return The timeline semaphore point signalled by the submission of this cycle, this is empty if the cycle doesn't use a timeline semaphore, hasn't been submitted yet or has already been signalled
+         * @note Chained cycles aren't accounted for as they're expected to be submitted prior to this cycle or waited on by it
+         */
+        std::optional<TimelinePoint> GetTimelinePoint() {
+            if (!timeline || signalled.test(std::memory_order_consume))
+                return std::nullopt;
+
+            std::scoped_lock lock{mutex};
+            if (!submitted)
+                return std::nullopt;
+            return TimelinePoint{**timeline, timelineValue};
+        }
+
         /**
          * @brief Attach the lifetime of an object to the fence being signalled
          */
@@ -239,13 +432,21 @@ namespace skyline::gpu {
                 dependencies.Append(dependency);
         }
 
+        /**
+         * @brief A version of AttachObject which takes ownership of the supplied reference rather than copying it
+         */
+        void AttachObject(std::shared_ptr<void> &&dependency) {
+            if (!signalled.test(std::memory_order_consume))
+                dependencies.Append(std::move(dependency));
+        }
+
         /**
          * @brief A version of AttachObject optimized for several objects being attached at once
          */
         template<typename... Dependencies>
         void AttachObjects(Dependencies &&... pDependencies) {
             if (!signalled.test(std::memory_order_consume))
-                dependencies.Append(pDependencies...);
+                dependencies.Append(std::forward<Dependencies>(pDependencies)...);
         }
 
         /**
@@ -4,6 +4,8 @@
 #include <boost/functional/hash.hpp>
 #include <filesystem>
 #include <gpu.h>
+#include <common/trace.h>
+#include <common/performance_stats.h>
 #include "graphics_pipeline_assembler.h"
 #include "trait_manager.h"
 
@@ -38,14 +40,48 @@ namespace skyline::gpu {
     };
     static_assert(sizeof(PipelineCacheFileDataHeader) == 0x10);
 
+    static constexpr size_t PipelineCacheMinimumGrowth{1024 * 1024}; //!< The minimum growth of the pipeline cache since it was last written for it to be written again
+    static constexpr size_t PipelineCacheGrowthDivisor{8}; //!< The pipeline cache must grow by at least 1/Nth of its last written size to be written again, this bounds the write amplification of rewriting the entire cache
+    static constexpr size_t PipelineCacheMaximumSize{256 * 1024 * 1024}; //!< Pipeline cache files larger than this are discarded on load, the cache is then rebuilt from only the pipelines that are still in use which compacts it
+    static constexpr u32 PipelineCacheSaveInterval{256}; //!< The amount of pipelines compiled after which a write of the pipeline cache is attempted
+
+    /**
+     * @return If the supplied pipeline cache data was created by the current driver according to the Vulkan pipeline cache header, stale data would be rejected by the driver after being parsed at best
+     */
+    static bool ValidatePipelineCacheData(const TraitManager &traits, span<u8> data) {
+        VkPipelineCacheHeaderVersionOne header;
+        if (data.size() < sizeof(VkPipelineCacheHeaderVersionOne))
+            return false;
+
+        std::memcpy(&header, data.data(), sizeof(VkPipelineCacheHeaderVersionOne));
+        return header.headerVersion == VK_PIPELINE_CACHE_HEADER_VERSION_ONE && header.headerSize >= sizeof(VkPipelineCacheHeaderVersionOne) &&
+            header.vendorID == traits.vendorId && header.deviceID == traits.deviceId &&
+            std::equal(traits.pipelineCacheUuid.begin(), traits.pipelineCacheUuid.end(), std::begin(header.pipelineCacheUUID));
+    }
+
     static vk::raii::PipelineCache DeserialisePipelineCache(GPU &gpu, std::string_view pipelineCacheDir) {
         std::filesystem::create_directories(pipelineCacheDir);
         PipelineCacheFileNameHeader expectedFilenameHeader{gpu.traits};
         std::filesystem::path path{std::filesystem::path{pipelineCacheDir} / expectedFilenameHeader.HexDump()};
 
+        // Caches from other drivers (or temporary files from interrupted writes) can never be used again, so they're deleted rather than left to accumulate
+        std::error_code error;
+        for (const auto &entry : std::filesystem::directory_iterator{pipelineCacheDir, error}) {
+            if (entry.path().filename() != path.filename()) {
+                Logger::Info("Removing stale pipeline cache: {}", entry.path().filename().string());
+                std::filesystem::remove(entry.path(), error);
+            }
+        }
+
         if (!std::filesystem::exists(path))
             return {gpu.vkDevice, vk::PipelineCacheCreateInfo{}};
 
+        if (auto fileSize{std::filesystem::file_size(path, error)}; !error && fileSize > PipelineCacheMaximumSize) {
+            Logger::Info("Discarding oversized pipeline cache (size: 0x{:X} bytes)", fileSize);
+            std::filesystem::remove(path, error);
+            return {gpu.vkDevice, vk::PipelineCacheCreateInfo{}};
+        }
+
         std::ifstream stream{path, std::ios::binary};
         if (stream.fail()) {
             Logger::Warn("Failed to open Vulkan pipeline cache!");
@@ -63,41 +99,75 @@ namespace skyline::gpu {
             return {gpu.vkDevice, vk::PipelineCacheCreateInfo{}};
         }
 
+        if (!ValidatePipelineCacheData(gpu.traits, readData)) {
+            Logger::Warn("Ignoring pipeline cache file from a different driver!");
+            return {gpu.vkDevice, vk::PipelineCacheCreateInfo{}};
+        }
+
         return {gpu.vkDevice, vk::PipelineCacheCreateInfo{
             .initialDataSize = readData.size(),
             .pInitialData = readData.data(),
         }};
     }
 
-    static void SerialisePipelineCache(GPU &gpu, std::string_view pipelineCacheDir, span<u8> data) {
+    /**
+     * @return If the pipeline cache was successfully written
+     */
+    static bool SerialisePipelineCache(GPU &gpu, std::string_view pipelineCacheDir, span<u8> data) {
         PipelineCacheFileNameHeader expectedFilenameHeader{gpu.traits};
         std::filesystem::path path{std::filesystem::path{pipelineCacheDir} / expectedFilenameHeader.HexDump()};
+        std::filesystem::path tempPath{path.string() + ".tmp"};
 
         PipelineCacheFileDataHeader header{
             .size = data.size(),
             .hash = XXH64(data.data(), data.size(), 0)
         };
-        std::ofstream stream{path, std::ios::binary | std::ios::trunc};
-        if (stream.fail()) {
-            Logger::Warn("Failed to write Vulkan pipeline cache!");
-            return;
+
+        {
+            // The cache is written to a temporary file and renamed over the existing one so an interrupted write doesn't lose the existing cache
+            std::ofstream stream{tempPath, std::ios::binary | std::ios::trunc};
+            if (stream.fail()) {
+                Logger::Warn("Failed to write Vulkan pipeline cache!");
+                return false;
+            }
+
+            stream.write(reinterpret_cast<char *>(&header), sizeof(PipelineCacheFileDataHeader));
+            stream.write(reinterpret_cast<char *>(data.data()), static_cast<std::streamsize>(data.size()));
+            if (stream.fail()) {
+                Logger::Warn("Failed to write Vulkan pipeline cache!");
+                return false;
+            }
         }
 
-        stream.write(reinterpret_cast<char *>(&header), sizeof(PipelineCacheFileDataHeader));
-        stream.write(reinterpret_cast<char *>(data.data()), static_cast<std::streamsize>(data.size()));
+        std::error_code error;
+        std::filesystem::rename(tempPath, path, error);
+        if (error) {
+            Logger::Warn("Failed to replace Vulkan pipeline cache: {}", error.message());
+            std::filesystem::remove(tempPath, error);
+            return false;
+        }
 
         Logger::Info("Wrote Vulkan pipeline cache to {} (size: 0x{:X} bytes)", path.string(), data.size());
+        return true;
     }
 
     GraphicsPipelineAssembler::GraphicsPipelineAssembler(GPU &gpu, std::string_view pipelineCacheDir)
         : gpu{gpu},
           vkPipelineCache{DeserialisePipelineCache(gpu, pipelineCacheDir)},
           pool{gpu.traits.quirks.brokenMultithreadedPipelineCompilation ? 1U : 0U},
-          pipelineCacheDir{pipelineCacheDir} {}
+          pipelineCacheDir{pipelineCacheDir} {
+        savedPipelineCacheSize = GetPipelineCacheSize();
+    }
+
+    size_t GraphicsPipelineAssembler::GetPipelineCacheSize() {
+        size_t size{};
+        gpu.vkDevice.getDispatcher()->vkGetPipelineCacheData(*gpu.vkDevice, static_cast<VkPipelineCache>(*vkPipelineCache), &size, nullptr);
+        return size;
+    }
 
     #define VEC_CPY(pointer, size) state.pointer, state.pointer + state.size
 
-    GraphicsPipelineAssembler::PipelineDescription::PipelineDescription(const GraphicsPipelineAssembler::PipelineState &state)
+    GraphicsPipelineAssembler::PipelineDescription::PipelineDescription(const GraphicsPipelineAssembler::PipelineState &state, u64 layoutHash)
         : shaderStages(state.shaderStages.begin(), state.shaderStages.end()),
           vertexState(state.vertexState),
           vertexBindings(VEC_CPY(VertexInputState().pVertexBindingDescriptions, VertexInputState().vertexBindingDescriptionCount)),
@@ -114,7 +184,11 @@ namespace skyline::gpu {
           colorBlendState(state.colorBlendState),
           dynamicStates(VEC_CPY(dynamicState.pDynamicStates, dynamicState.dynamicStateCount)),
           dynamicState(state.dynamicState),
-          colorBlendAttachments(VEC_CPY(colorBlendState.pAttachments, colorBlendState.attachmentCount)) {
+          colorBlendAttachments(VEC_CPY(colorBlendState.pAttachments, colorBlendState.attachmentCount)),
+          shaderStageHashes(state.shaderStageHashes.begin(), state.shaderStageHashes.end()),
+          shaderModuleIdentifiers(state.shaderModuleIdentifiers.begin(), state.shaderModuleIdentifiers.end()),
+          compileTimings{state.compileTimings},
+          layoutHash{layoutHash} {
         auto &vertexInputState{vertexState.get<vk::PipelineVertexInputStateCreateInfo>()};
         vertexInputState.pVertexBindingDescriptions = vertexBindings.data();
         vertexInputState.pVertexAttributeDescriptions = vertexAttributes.data();
@@ -127,6 +201,20 @@ namespace skyline::gpu {
 
         dynamicState.pDynamicStates = dynamicStates.data();
 
+        if (!shaderModuleIdentifiers.empty()) {
+            shaderModuleIdentifierInfos.resize(shaderStages.size());
+            for (size_t i{}; i < shaderStages.size(); i++) {
+                if (!shaderModuleIdentifiers[i])
+                    continue;
+
+                shaderModuleIdentifierInfos[i] = vk::PipelineShaderStageModuleIdentifierCreateInfoEXT{
+                    .identifierSize = shaderModuleIdentifiers[i].size,
+                    .pIdentifier = shaderModuleIdentifiers[i].data.data(),
+                };
+                shaderStages[i].pNext = &shaderModuleIdentifierInfos[i];
+            }
+        }
+
         for (auto &colorFormat : state.colorFormats)
             colorFormats.emplace_back(colorFormat);
 
@@ -137,7 +225,42 @@ namespace skyline::gpu {
 
     #undef VEC_CPY
 
-    vk::raii::Pipeline GraphicsPipelineAssembler::AssemblePipeline(std::list<PipelineDescription>::iterator pipelineDescIt, vk::PipelineLayout pipelineLayout) {
+    /**
+     * @brief Accumulates state that a graphics pipeline library depends on into a single hash
+     * @note Only trivially copyable structures which don't contain any pointers or padding should be added directly
+     */
+    class LibraryKeyBuilder {
+      private:
+        std::vector<u8> data;
+
+      public:
+        template<typename Type> requires std::is_trivially_copyable_v<Type>
+        LibraryKeyBuilder &Add(const Type &value) {
+            auto bytes{reinterpret_cast<const u8 *>(&value)};
+            data.insert(data.end(), bytes, bytes + sizeof(Type));
+            return *this;
+        }
+
+        template<typename Type> requires std::is_trivially_copyable_v<Type>
+        LibraryKeyBuilder &Add(const std::vector<Type> &values) {
+            Add(values.size());
+            auto bytes{reinterpret_cast<const u8 *>(values.data())};
+            data.insert(data.end(), bytes, bytes + values.size() * sizeof(Type));
+            return *this;
+        }
+
+        u64 Build() const {
+            return XXH64(data.data(), data.size(), 0);
+        }
+    };
+
+    vk::RenderPass GraphicsPipelineAssembler::GetRenderPass(const PipelineDescription &description, u64 &renderPassHash) {
+        renderPassHash = LibraryKeyBuilder{}.Add(description.colorFormats).Add(description.depthStencilFormat).Add(description.sampleCount).Build();
+
+        std::scoped_lock lock{libraryMutex};
+        if (auto it{renderPasses.find(renderPassHash)}; it != renderPasses.end())
+            return *it->second;
+
         boost::container::small_vector<vk::AttachmentDescription, 8> attachmentDescriptions;
         boost::container::small_vector<vk::AttachmentReference, 8> attachmentReferences;
 
@@ -145,7 +268,7 @@ namespace skyline::gpu {
             if (format != vk::Format::eUndefined) {
                 attachmentDescriptions.push_back(vk::AttachmentDescription{
                     .format = format,
-                    .samples = pipelineDescIt->sampleCount,
+                    .samples = description.sampleCount,
                     .loadOp = vk::AttachmentLoadOp::eLoad,
                     .storeOp = vk::AttachmentStoreOp::eStore,
                     .stencilLoadOp = vk::AttachmentLoadOp::eLoad,
@@ -170,11 +293,11 @@ namespace skyline::gpu {
             .pipelineBindPoint = vk::PipelineBindPoint::eGraphics,
         };
 
-        for (auto &colorAttachment : pipelineDescIt->colorFormats)
+        for (auto &colorAttachment : description.colorFormats)
             pushAttachment(colorAttachment);
 
-        if (pipelineDescIt->depthStencilFormat != vk::Format::eUndefined) {
-            pushAttachment(pipelineDescIt->depthStencilFormat);
+        if (description.depthStencilFormat != vk::Format::eUndefined) {
+            pushAttachment(description.depthStencilFormat);
 
             subpassDescription.pColorAttachments = attachmentReferences.data();
             subpassDescription.colorAttachmentCount = static_cast<u32>(attachmentReferences.size() - 1);
@@ -184,30 +307,224 @@ namespace skyline::gpu {
             subpassDescription.colorAttachmentCount = static_cast<u32>(attachmentReferences.size());
         }
 
-        vk::raii::RenderPass renderPass{gpu.vkDevice, vk::RenderPassCreateInfo{
+        return *renderPasses.emplace(renderPassHash, vk::raii::RenderPass{gpu.vkDevice, vk::RenderPassCreateInfo{
             .attachmentCount = static_cast<u32>(attachmentDescriptions.size()),
             .pAttachments = attachmentDescriptions.data(),
             .subpassCount = 1,
             .pSubpasses = &subpassDescription,
-        }};
+        }}).first->second;
+    }
+
+    vk::Pipeline GraphicsPipelineAssembler::GetLibrary(u64 key, vk::GraphicsPipelineLibraryFlagsEXT flags, vk::GraphicsPipelineCreateInfo createInfo) {
+        // The type of library is a part of the key as the same state can be used by multiple types of libraries
+        key = LibraryKeyBuilder{}.Add(key).Add(flags).Build();
+
+        {
+            std::scoped_lock lock{libraryMutex};
+            if (auto it{libraries.find(key)}; it != libraries.end())
+                return *it->second;
+        }
+
+        vk::GraphicsPipelineLibraryCreateInfoEXT libraryInfo{
+            .flags = flags,
+        };
+        createInfo.pNext = &libraryInfo;
+        createInfo.flags |= vk::PipelineCreateFlagBits::eLibraryKHR | vk::PipelineCreateFlagBits::eRetainLinkTimeOptimizationInfoEXT;
+
+        // The library is compiled without holding the lock, if another thread compiled the same library in the meantime then that is used instead
+        auto library{gpu.vkDevice.createGraphicsPipeline(vkPipelineCache, createInfo)};
+
+        std::scoped_lock lock{libraryMutex};
+        return *libraries.try_emplace(key, std::move(library)).first->second;
+    }
+
+    vk::raii::Pipeline GraphicsPipelineAssembler::LinkPipeline(const PipelineDescription &description, vk::PipelineLayout pipelineLayout, const OptimizedPipeline &optimizedPipeline) {
+        u64 renderPassHash;
+        vk::RenderPass renderPass{GetRenderPass(description, renderPassHash)};
+
+        LibraryKeyBuilder dynamicStateKey;
+        dynamicStateKey.Add(description.dynamicStates);
+
+        boost::container::static_vector<vk::PipelineShaderStageCreateInfo, 5> preRasterizationStages;
+        boost::container::static_vector<vk::PipelineShaderStageCreateInfo, 1> fragmentStages;
+        LibraryKeyBuilder preRasterizationKey{dynamicStateKey}, fragmentKey{dynamicStateKey};
+        for (size_t i{}; i < description.shaderStages.size(); i++) {
+            const auto &stage{description.shaderStages[i]};
+            auto &key{stage.stage == vk::ShaderStageFlagBits::eFragment ? fragmentKey : preRasterizationKey};
+            key.Add(stage.stage).Add(description.shaderStageHashes[i]);
+            if (stage.stage == vk::ShaderStageFlagBits::eFragment)
+                fragmentStages.push_back(stage);
+            else
+                preRasterizationStages.push_back(stage);
+        }
+
+        const auto &vertexInputState{description.VertexInputState()};
+        const auto &rasterizationState{description.RasterizationState()};
+        const auto &multisampleState{description.multisampleState};
+        const auto &depthStencilState{description.depthStencilState};
+        const auto &colorBlendState{description.colorBlendState};
+
+        LibraryKeyBuilder vertexInputKey{dynamicStateKey};
+        vertexInputKey.Add(description.vertexBindings).Add(description.vertexAttributes).Add(description.vertexDivisors)
+                      .Add(description.inputAssemblyState.topology).Add(description.inputAssemblyState.primitiveRestartEnable);
+
+        preRasterizationKey.Add(description.layoutHash).Add(renderPassHash)
+                           .Add(description.tessellationState.patchControlPoints)
+                           .Add(description.viewportState.viewportCount).Add(description.viewportState.scissorCount)
+                           .Add(rasterizationState.depthClampEnable).Add(rasterizationState.rasterizerDiscardEnable).Add(rasterizationState.polygonMode)
+                           .Add(rasterizationState.cullMode).Add(rasterizationState.frontFace).Add(rasterizationState.depthBiasEnable)
+                           .Add(rasterizationState.depthBiasConstantFactor).Add(rasterizationState.depthBiasClamp).Add(rasterizationState.depthBiasSlopeFactor)
+                           .Add(rasterizationState.lineWidth).Add(description.ProvokingVertexState().provokingVertexMode);
+
+        fragmentKey.Add(description.layoutHash).Add(renderPassHash)
+                   .Add(multisampleState.rasterizationSamples).Add(multisampleState.sampleShadingEnable).Add(multisampleState.minSampleShading)
+                   .Add(multisampleState.alphaToCoverageEnable).Add(multisampleState.alphaToOneEnable)
+                   .Add(depthStencilState.depthTestEnable).Add(depthStencilState.depthWriteEnable).Add(depthStencilState.depthCompareOp)
+                   .Add(depthStencilState.depthBoundsTestEnable).Add(depthStencilState.stencilTestEnable).Add(depthStencilState.front).Add(depthStencilState.back)
+                   .Add(depthStencilState.minDepthBounds).Add(depthStencilState.maxDepthBounds);
+
+        LibraryKeyBuilder fragmentOutputKey{dynamicStateKey};
+        fragmentOutputKey.Add(renderPassHash)
+                         .Add(multisampleState.rasterizationSamples).Add(multisampleState.alphaToCoverageEnable).Add(multisampleState.alphaToOneEnable)
+                         .Add(colorBlendState.logicOpEnable).Add(colorBlendState.logicOp).Add(description.colorBlendAttachments).Add(colorBlendState.blendConstants);
+
+        std::array<vk::Pipeline, 4> pipelineLibraries{
+            GetLibrary(vertexInputKey.Build(), vk::GraphicsPipelineLibraryFlagBitsEXT::eVertexInputInterface, vk::GraphicsPipelineCreateInfo{
+                .pVertexInputState = &vertexInputState,
+                .pInputAssemblyState = &description.inputAssemblyState,
+                .pDynamicState = &description.dynamicState,
+            }),
+            GetLibrary(preRasterizationKey.Build(), vk::GraphicsPipelineLibraryFlagBitsEXT::ePreRasterizationShaders, vk::GraphicsPipelineCreateInfo{
+                .pStages = preRasterizationStages.data(),
+                .stageCount = static_cast<u32>(preRasterizationStages.size()),
+                .pTessellationState = &description.tessellationState,
+                .pViewportState = &description.viewportState,
+                .pRasterizationState = &rasterizationState,
+                .pDynamicState = &description.dynamicState,
+                .layout = pipelineLayout,
+                .renderPass = renderPass,
+                .subpass = 0,
+            }),
+            GetLibrary(fragmentKey.Build(), vk::GraphicsPipelineLibraryFlagBitsEXT::eFragmentShader, vk::GraphicsPipelineCreateInfo{
+                .pStages = fragmentStages.data(),
+                .stageCount = static_cast<u32>(fragmentStages.size()),
+                .pMultisampleState = &multisampleState,
+                .pDepthStencilState = &depthStencilState,
+                .pDynamicState = &description.dynamicState,
+                .layout = pipelineLayout,
+                .renderPass = renderPass,
+                .subpass = 0,
+            }),
+            GetLibrary(fragmentOutputKey.Build(), vk::GraphicsPipelineLibraryFlagBitsEXT::eFragmentOutputInterface, vk::GraphicsPipelineCreateInfo{
+                .pMultisampleState = &multisampleState,
+                .pColorBlendState = &colorBlendState,
+                .pDynamicState = &description.dynamicState,
+                .renderPass = renderPass,
+                .subpass = 0,
+            }),
+        };
+
+        vk::PipelineLibraryCreateInfoKHR libraryInfo{
+            .libraryCount = static_cast<u32>(pipelineLibraries.size()),
+            .pLibraries = pipelineLibraries.data(),
+        };
 
         auto pipeline{gpu.vkDevice.createGraphicsPipeline(vkPipelineCache, vk::GraphicsPipelineCreateInfo{
-            .pStages = pipelineDescIt->shaderStages.data(),
-            .stageCount = static_cast<u32>(pipelineDescIt->shaderStages.size()),
-            .pVertexInputState = &pipelineDescIt->vertexState.get<vk::PipelineVertexInputStateCreateInfo>(),
-            .pInputAssemblyState = &pipelineDescIt->inputAssemblyState,
-            .pTessellationState = &pipelineDescIt->tessellationState,
-            .pViewportState = &pipelineDescIt->viewportState,
-            .pRasterizationState = &pipelineDescIt->rasterizationState.get<vk::PipelineRasterizationStateCreateInfo>(),
-            .pMultisampleState = &pipelineDescIt->multisampleState,
-            .pDepthStencilState = &pipelineDescIt->depthStencilState,
-            .pColorBlendState = &pipelineDescIt->colorBlendState,
-            .pDynamicState = &pipelineDescIt->dynamicState,
+            .pNext = &libraryInfo,
             .layout = pipelineLayout,
-            .renderPass = *renderPass,
-            .subpass = 0,
         })};
 
+        // The libraries are never destroyed so they can be safely linked again after this function returns
+        std::ignore = pool.submit([this, pipelineLibraries, pipelineLayout, optimizedPipeline]() {
+            vk::PipelineLibraryCreateInfoKHR optimizedLibraryInfo{
+                .libraryCount = static_cast<u32>(pipelineLibraries.size()),
+                .pLibraries = pipelineLibraries.data(),
+            };
+
+            auto optimized{gpu.vkDevice.createGraphicsPipeline(vkPipelineCache, vk::GraphicsPipelineCreateInfo{
+                .pNext = &optimizedLibraryInfo,
+                .flags = vk::PipelineCreateFlagBits::eLinkTimeOptimizationEXT,
+                .layout = pipelineLayout,
+            })};
+
+            std::scoped_lock lock{libraryMutex};
+            optimizedPipeline->store(*optimizedPipelines.emplace_back(std::move(optimized)), std::memory_order_release);
+        });
+
+        return pipeline;
+    }
+
+    std::optional<vk::raii::Pipeline> GraphicsPipelineAssembler::CreatePipelineFromIdentifiers(PipelineDescription &description, vk::GraphicsPipelineCreateInfo createInfo) {
+        TRACE_EVENT("gpu", "GraphicsPipelineAssembler::CreatePipelineFromIdentifiers");
+
+        createInfo.flags |= vk::PipelineCreateFlagBits::eFailOnPipelineCompileRequiredEXT;
+        auto result{(*gpu.vkDevice).createGraphicsPipeline(*vkPipelineCache, createInfo, nullptr, *gpu.vkDevice.getDispatcher())};
+        if (result.result == vk::Result::eSuccess)
+            return vk::raii::Pipeline{gpu.vkDevice, static_cast<VkPipeline>(result.value)};
+
+        // The driver doesn't have a binary for the pipeline cached, so the modules that the identifiers refer to need to be recreated from the SPIR-V cache
+        for (size_t i{}; i < description.shaderStages.size(); i++) {
+            auto &identifier{description.shaderModuleIdentifiers[i]};
+            if (!identifier)
+                continue;
+
+            description.shaderStages[i].module = gpu.shader->CreateShaderModule(identifier);
+            description.shaderStages[i].pNext = nullptr;
+            identifier = {};
+        }
+        return std::nullopt;
+    }
+
+    vk::raii::Pipeline GraphicsPipelineAssembler::AssemblePipeline(std::list<PipelineDescription>::iterator pipelineDescIt, vk::PipelineLayout pipelineLayout, OptimizedPipeline optimizedPipeline) {
+        auto &timings{pipelineDescIt->compileTimings};
+        auto worstShader{timings.WorstShader()};
+        TRACE_EVENT("gpu", "GraphicsPipelineAssembler::AssemblePipeline",
+                    "hash", worstShader ? worstShader->hash : 0,
+                    "TranslationNs", timings.TranslationNs(),
+                    "SpirvNs", timings.SpirvNs());
+
+        auto startNs{util::GetTimeNs()};
+        auto pipeline{[&]() {
+            if (optimizedPipeline)
+                return LinkPipeline(*pipelineDescIt, pipelineLayout, optimizedPipeline);
+
+            u64 renderPassHash;
+            vk::GraphicsPipelineCreateInfo createInfo{
+                .pStages = pipelineDescIt->shaderStages.data(),
+                .stageCount = static_cast<u32>(pipelineDescIt->shaderStages.size()),
+                .pVertexInputState = &pipelineDescIt->vertexState.get<vk::PipelineVertexInputStateCreateInfo>(),
+                .pInputAssemblyState = &pipelineDescIt->inputAssemblyState,
+                .pTessellationState = &pipelineDescIt->tessellationState,
+                .pViewportState = &pipelineDescIt->viewportState,
+                .pRasterizationState = &pipelineDescIt->rasterizationState.get<vk::PipelineRasterizationStateCreateInfo>(),
+                .pMultisampleState = &pipelineDescIt->multisampleState,
+                .pDepthStencilState = &pipelineDescIt->depthStencilState,
+                .pColorBlendState = &pipelineDescIt->colorBlendState,
+                .pDynamicState = &pipelineDescIt->dynamicState,
+                .layout = pipelineLayout,
+                .renderPass = GetRenderPass(*pipelineDescIt, renderPassHash),
+                .subpass = 0,
+            };
+
+            if (!pipelineDescIt->shaderModuleIdentifiers.empty())
+                if (auto identifierPipeline{CreatePipelineFromIdentifiers(*pipelineDescIt, createInfo)})
+                    return std::move(*identifierPipeline);
+
+            return gpu.vkDevice.createGraphicsPipeline(vkPipelineCache, createInfo);
+        }()};
+
+        timings.pipelineNs = util::GetTimeNs() - startNs;
+        ShaderStats.Record(ShaderTelemetry::PipelineType::Graphics, timings);
+
+        trace::AddFrameCounter(trace::FrameCounter::PipelineCompiles);
+        PerfStats.pipelineCompiles.fetch_add(1, std::memory_order_relaxed);
+
+        // Pipelines compiled during gameplay are persisted periodically rather than only after the pipeline cache has been loaded
+        if (pipelinesSinceSave.fetch_add(1, std::memory_order_relaxed) + 1 >= PipelineCacheSaveInterval) {
+            pipelinesSinceSave.store(0, std::memory_order_relaxed);
+            SavePipelineCache();
+        }
+
         if (pipelineDescIt->destroyShaderModules)
             for (auto &shaderStage : pipelineDescIt->shaderStages)
                 (*gpu.vkDevice).destroyShaderModule(shaderStage.module, nullptr,  *gpu.vkDevice.getDispatcher());
@@ -221,7 +538,11 @@ namespace skyline::gpu {
     }
 
 
-    GraphicsPipelineAssembler::CompiledPipeline GraphicsPipelineAssembler::AssemblePipelineAsync(const PipelineState &state, span<const vk::DescriptorSetLayoutBinding> layoutBindings, span<const vk::PushConstantRange> pushConstantRanges, bool noPushDescriptors) {
+    const GraphicsPipelineAssembler::PipelineLayouts &GraphicsPipelineAssembler::GetPipelineLayouts(u64 layoutHash, span<const vk::DescriptorSetLayoutBinding> layoutBindings, span<const vk::PushConstantRange> pushConstantRanges, bool noPushDescriptors) {
+        std::scoped_lock lock{layoutMutex};
+        if (auto it{pipelineLayouts.find(layoutHash)}; it != pipelineLayouts.end())
+            return it->second;
+
         vk::raii::DescriptorSetLayout descriptorSetLayout{gpu.vkDevice, vk::DescriptorSetLayoutCreateInfo{
             .flags = vk::DescriptorSetLayoutCreateFlags{(!noPushDescriptors && gpu.traits.supportsPushDescriptors) ? vk::DescriptorSetLayoutCreateFlagBits::ePushDescriptorKHR : vk::DescriptorSetLayoutCreateFlags{}},
             .pBindings = layoutBindings.data(),
@@ -235,14 +556,32 @@ namespace skyline::gpu {
             .pushConstantRangeCount = static_cast<u32>(pushConstantRanges.size()),
         }};
 
-        auto descIt{[this, &state]() {
+        return pipelineLayouts.emplace(layoutHash, PipelineLayouts{std::move(descriptorSetLayout), std::move(pipelineLayout)}).first->second;
+    }
+
+    GraphicsPipelineAssembler::CompiledPipeline GraphicsPipelineAssembler::AssemblePipelineAsync(const PipelineState &state, span<const vk::DescriptorSetLayoutBinding> layoutBindings, span<const vk::PushConstantRange> pushConstantRanges, bool noPushDescriptors) {
+        // Layouts are shared between all pipelines with the same binding signature, this allows descriptor sets to be reused across pipelines with compatible bindings
+        LibraryKeyBuilder layoutKey;
+        for (const auto &binding : layoutBindings)
+            layoutKey.Add(binding.binding).Add(binding.descriptorType).Add(binding.descriptorCount).Add(binding.stageFlags);
+        for (const auto &range : pushConstantRanges)
+            layoutKey.Add(range);
+        u64 layoutHash{layoutKey.Add(noPushDescriptors).Build()};
+
+        const auto &layouts{GetPipelineLayouts(layoutHash, layoutBindings, pushConstantRanges, noPushDescriptors)};
+
+        // Pipelines can only be split into libraries that are shared between pipelines when the contents of their shaders are known
+        bool useLibraries{gpu.traits.supportsGraphicsPipelineLibrary && !state.shaderStageHashes.empty()};
+
+        auto descIt{[this, &state, layoutHash]() {
             std::scoped_lock lock{mutex};
-            compilePendingDescs.emplace_back(state);
+            compilePendingDescs.emplace_back(state, layoutHash);
             return std::prev(compilePendingDescs.end());
         }()};
 
-        auto pipelineFuture{pool.submit(&GraphicsPipelineAssembler::AssemblePipeline, this, descIt, *pipelineLayout)};
-        return CompiledPipeline{std::move(descriptorSetLayout), std::move(pipelineLayout), std::move(pipelineFuture)};
+        OptimizedPipeline optimizedPipeline{useLibraries ? std::make_shared<std::atomic<vk::Pipeline>>() : nullptr};
+        auto pipelineFuture{pool.submit(&GraphicsPipelineAssembler::AssemblePipeline, this, descIt, *layouts.pipelineLayout, optimizedPipeline)};
+        return CompiledPipeline{*layouts.descriptorSetLayout, *layouts.pipelineLayout, std::move(pipelineFuture), std::move(optimizedPipeline)};
     }
 
     void GraphicsPipelineAssembler::WaitIdle() {
@@ -250,9 +589,21 @@ namespace skyline::gpu {
     }
 
     void GraphicsPipelineAssembler::SavePipelineCache() {
+        if (pipelineCacheSaveActive.exchange(true))
+            return; // A write is already in flight, it'll include any pipelines compiled so far
+
         std::ignore = pool.submit([this] () {
-            std::vector<u8> rawData{vkPipelineCache.getData()};
-            SerialisePipelineCache(gpu, pipelineCacheDir, rawData);
+            TRACE_EVENT("gpu", "GraphicsPipelineAssembler::SavePipelineCache");
+
+            // Querying the size doesn't copy the cache data, this avoids rewriting the entire cache when it has barely grown since it was last written
+            size_t savedSize{savedPipelineCacheSize.load(std::memory_order_relaxed)};
+            if (GetPipelineCacheSize() >= savedSize + std::max(PipelineCacheMinimumGrowth, savedSize / PipelineCacheGrowthDivisor)) {
+                std::vector<u8> rawData{vkPipelineCache.getData()};
+                if (SerialisePipelineCache(gpu, pipelineCacheDir, rawData))
+                    savedPipelineCacheSize.store(rawData.size(), std::memory_order_relaxed);
+            }
+
+            pipelineCacheSaveActive.store(false, std::memory_order_release);
         });
     }
 
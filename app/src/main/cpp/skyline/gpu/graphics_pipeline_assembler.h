@@ -7,6 +7,8 @@
 #include <future>
 #include <BS_thread_pool.hpp>
 #include <vulkan/vulkan_raii.hpp>
+#include "shader_manager.h"
+#include "shader_telemetry.h"
 
 namespace skyline::gpu {
     class TextureView;
@@ -37,6 +39,9 @@ namespace skyline::gpu {
             vk::Format depthStencilFormat; //!< The depth attachment format in the subpass of this pipeline, 'Undefined' if there is no depth attachment
             vk::SampleCountFlagBits sampleCount; //!< The sample count of the subpass of this pipeline
             bool destroyShaderModules; //!< Whether the shader modules should be destroyed after the pipeline is compiled
+            span<u64> shaderStageHashes{}; //!< A hash of the SPIR-V of each stage in `shaderStages`, this is required for the pipeline to be split into libraries that are shared with other pipelines
+            span<ShaderModuleIdentifier> shaderModuleIdentifiers{}; //!< The identifier of each stage in `shaderStages` that has no module, this is either empty or has an entry for every stage and must be empty if `shaderStageHashes` isn't
+            PipelineCompileTimings compileTimings{}; //!< The time spent compiling the shaders of this pipeline, the time spent creating the pipeline is added to this before it's recorded
 
             constexpr const vk::PipelineVertexInputStateCreateInfo &VertexInputState() const {
                 return vertexState.get<vk::PipelineVertexInputStateCreateInfo>();
@@ -55,11 +60,16 @@ namespace skyline::gpu {
             }
         };
 
+        using OptimizedPipeline = std::shared_ptr<std::atomic<vk::Pipeline>>; //!< A pipeline that's set once a link-time optimized variant of a pipeline has been compiled in the background
+
       private:
         GPU &gpu;
         vk::raii::PipelineCache vkPipelineCache; //!< A Vulkan Pipeline Cache which stores all unique graphics pipelines
         BS::thread_pool pool;
         std::string pipelineCacheDir;
+        std::atomic<size_t> savedPipelineCacheSize{}; //!< The size of the pipeline cache data when it was last written to (or read from) the filesystem
+        std::atomic<u32> pipelinesSinceSave{}; //!< The amount of pipelines compiled since a write of the pipeline cache was last attempted
+        std::atomic<bool> pipelineCacheSaveActive{}; //!< If a write of the pipeline cache is currently queued or in progress
         std::function<void()> compilationCallback;
 
         /**
@@ -98,8 +108,13 @@ namespace skyline::gpu {
             vk::Format depthStencilFormat;
             vk::SampleCountFlagBits sampleCount;
             bool destroyShaderModules;
+            std::vector<u64> shaderStageHashes;
+            std::vector<ShaderModuleIdentifier> shaderModuleIdentifiers;
+            std::vector<vk::PipelineShaderStageModuleIdentifierCreateInfoEXT> shaderModuleIdentifierInfos; //!< The identifier create info chained onto each stage without a module, this is indexed the same as `shaderStages`
+            PipelineCompileTimings compileTimings;
+            u64 layoutHash; //!< A hash of the descriptor set layout bindings and push constant ranges of the pipeline layout
 
-            PipelineDescription(const PipelineState& state);
+            PipelineDescription(const PipelineState& state, u64 layoutHash);
 
             constexpr const vk::PipelineVertexInputStateCreateInfo &VertexInputState() const {
                 return vertexState.get<vk::PipelineVertexInputStateCreateInfo>();
@@ -121,27 +136,80 @@ namespace skyline::gpu {
         std::mutex mutex; //!< Protects access to `compilePendingDescs`
         std::list<PipelineDescription> compilePendingDescs; //!< List of pipeline descriptions that are pending compilation
 
+        std::mutex libraryMutex; //!< Protects access to `renderPasses`, `libraries` and `optimizedPipelines`
+        std::unordered_map<u64, vk::raii::RenderPass> renderPasses; //!< A map from the hash of a subpass's attachments to a render pass for creating pipelines with it
+        std::unordered_map<u64, vk::raii::Pipeline> libraries; //!< A map from the hash of all state a graphics pipeline library depends on to the library
+        std::list<vk::raii::Pipeline> optimizedPipelines; //!< Link-time optimized pipelines that have replaced fast-linked pipelines, these are never destroyed as the fast-linked pipelines they replace aren't either
+
+        /**
+         * @brief A descriptor set layout and a pipeline layout that only contains it, these are shared between all pipelines with the same binding signature
+         */
+        struct PipelineLayouts {
+            vk::raii::DescriptorSetLayout descriptorSetLayout;
+            vk::raii::PipelineLayout pipelineLayout;
+        };
+
+        std::mutex layoutMutex; //!< Protects access to `pipelineLayouts`
+        std::unordered_map<u64, PipelineLayouts> pipelineLayouts; //!< A map from the hash of a binding signature to the layouts for it, these are retained for the lifetime of the assembler
+
+        /**
+         * @return Cached layouts for the supplied binding signature or newly created ones
+         */
+        const PipelineLayouts &GetPipelineLayouts(u64 layoutHash, span<const vk::DescriptorSetLayoutBinding> layoutBindings, span<const vk::PushConstantRange> pushConstantRanges, bool noPushDescriptors);
+
+        /**
+         * @return A cached render pass with a single subpass that has the attachments from the description
+         * @note The render pass is retained for the lifetime of the assembler so libraries created with it can be linked with any other libraries for the same attachments
+         */
+        vk::RenderPass GetRenderPass(const PipelineDescription &description, u64 &renderPassHash);
+
+        /**
+         * @return A cached graphics pipeline library with the supplied key or a newly compiled one using the supplied state
+         */
+        vk::Pipeline GetLibrary(u64 key, vk::GraphicsPipelineLibraryFlagsEXT flags, vk::GraphicsPipelineCreateInfo createInfo);
+
+        /**
+         * @brief Compiles any libraries for the description that aren't cached and links them into a pipeline, a link-time optimized variant is linked in the background which replaces the pipeline once it's done
+         */
+        vk::raii::Pipeline LinkPipeline(const PipelineDescription &description, vk::PipelineLayout pipelineLayout, const OptimizedPipeline &optimizedPipeline);
+
+        /**
+         * @brief Attempts to create a pipeline from the shader module identifiers in the description without the driver compiling it
+         * @note If this fails, modules are created for all stages in the description that used identifiers so the pipeline can be compiled regularly
+         * @return The pipeline if the driver had a binary for it cached
+         */
+        std::optional<vk::raii::Pipeline> CreatePipelineFromIdentifiers(PipelineDescription &description, vk::GraphicsPipelineCreateInfo createInfo);
+
         /**
          * @brief Synchronously compiles a pipeline with the state from the given description
+         * @param optimizedPipeline The optimized pipeline to set once it's compiled, this is only used if the pipeline is split into libraries
          */
-        vk::raii::Pipeline AssemblePipeline(std::list<PipelineDescription>::iterator pipelineDescIt, vk::PipelineLayout pipelineLayout);
+        vk::raii::Pipeline AssemblePipeline(std::list<PipelineDescription>::iterator pipelineDescIt, vk::PipelineLayout pipelineLayout, OptimizedPipeline optimizedPipeline);
+
+        /**
+         * @return The size of the data that would be retrieved from the Vulkan pipeline cache, this doesn't copy the data
+         */
+        size_t GetPipelineCacheSize();
 
       public:
         GraphicsPipelineAssembler(GPU &gpu, std::string_view pipelineCacheDir);
 
         struct CompiledPipeline {
-            vk::raii::DescriptorSetLayout descriptorSetLayout;
-            vk::raii::PipelineLayout pipelineLayout;
+            vk::DescriptorSetLayout descriptorSetLayout; //!< The descriptor set layout of the pipeline, this is owned by the assembler and shared with all pipelines that have the same bindings
+            vk::PipelineLayout pipelineLayout; //!< The pipeline layout of the pipeline, this is owned by the assembler and shared with all pipelines that have the same bindings
             std::shared_future<vk::raii::Pipeline> pipeline;
-
-            CompiledPipeline() : descriptorSetLayout{nullptr}, pipelineLayout{nullptr} {};
-
-            CompiledPipeline(vk::raii::DescriptorSetLayout descriptorSetLayout,
-                             vk::raii::PipelineLayout pipelineLayout,
-                             std::shared_future<vk::raii::Pipeline> pipeline)
-                : descriptorSetLayout{std::move(descriptorSetLayout)},
-                  pipelineLayout{std::move(pipelineLayout)},
-                  pipeline{std::move(pipeline)} {};
+            OptimizedPipeline optimizedPipeline; //!< If non-null, this should be used over `pipeline` once it has been set
+
+            CompiledPipeline() = default;
+
+            CompiledPipeline(vk::DescriptorSetLayout descriptorSetLayout,
+                             vk::PipelineLayout pipelineLayout,
+                             std::shared_future<vk::raii::Pipeline> pipeline,
+                             OptimizedPipeline optimizedPipeline = {})
+                : descriptorSetLayout{descriptorSetLayout},
+                  pipelineLayout{pipelineLayout},
+                  pipeline{std::move(pipeline)},
+                  optimizedPipeline{std::move(optimizedPipeline)} {};
         };
 
         /**
@@ -157,7 +225,7 @@ namespace skyline::gpu {
         void WaitIdle();
 
         /**
-         * @brief Saves the current Vulkan pipeline cache to the filesystem
+         * @brief Saves the current Vulkan pipeline cache to the filesystem in the background if it has grown significantly since it was last saved
          */
         void SavePipelineCache();
 
@@ -7,7 +7,11 @@
 #include <range/v3/view.hpp>
 #include <adrenotools/driver.h>
 #include <common/settings.h>
+#include <common/host_affinity.h>
+#include <common/performance_hint.h>
+#include <common/performance_stats.h>
 #include <loader/loader.h>
+#include <soc/host1x/syncpoint.h>
 #include <gpu.h>
 #include <dlfcn.h>
 #include "command_executor.h"
@@ -23,11 +27,82 @@ namespace skyline::gpu::interconnect {
         );
     }
 
+    TimestampQueries::TimestampQueries(GPU &gpu)
+        : pool{gpu.vkDevice, vk::QueryPoolCreateInfo{
+            .queryType = vk::QueryType::eTimestamp,
+            .queryCount = QueryCount,
+        }} {}
+
+    void TimestampQueries::Begin(vk::raii::CommandBuffer &commandBuffer) {
+        renderPassCount = 0;
+        commandBuffer.resetQueryPool(*pool, 0, QueryCount);
+        commandBuffer.writeTimestamp(vk::PipelineStageFlagBits::eTopOfPipe, *pool, 0);
+    }
+
+    void TimestampQueries::BeginRenderPass(vk::raii::CommandBuffer &commandBuffer, vk::Rect2D renderArea) {
+        if (renderPassCount == MaxRenderPasses)
+            return;
+
+        renderAreas[renderPassCount] = renderArea;
+        commandBuffer.writeTimestamp(vk::PipelineStageFlagBits::eTopOfPipe, *pool, 2 + (renderPassCount * 2));
+    }
+
+    void TimestampQueries::EndRenderPass(vk::raii::CommandBuffer &commandBuffer) {
+        if (renderPassCount == MaxRenderPasses)
+            return;
+
+        commandBuffer.writeTimestamp(vk::PipelineStageFlagBits::eBottomOfPipe, *pool, 3 + (renderPassCount * 2));
+        renderPassCount++;
+    }
+
+    void TimestampQueries::End(vk::raii::CommandBuffer &commandBuffer) {
+        commandBuffer.writeTimestamp(vk::PipelineStageFlagBits::eBottomOfPipe, *pool, 1);
+    }
+
+    void TimestampQueries::Resolve(GPU &gpu, const perfetto::Track &track) {
+        // Without calibrated timestamps the GPU clock domain is anchored by assuming the submission ended when its completion was observed, this is an underestimate of the true time by the wakeup latency of the waiter but keeps all slices within a submission consistent
+        auto endTime{perfetto::TrackEvent::GetTraceTimeNs()};
+
+        u32 queryCount{2 + (renderPassCount * 2)};
+        std::array<u64, QueryCount> timestamps;
+        auto result{(*gpu.vkDevice).getQueryPoolResults(*pool, 0, queryCount, queryCount * sizeof(u64), timestamps.data(), sizeof(u64), vk::QueryResultFlagBits::e64, *gpu.vkDevice.getDispatcher())};
+        if (result != vk::Result::eSuccess)
+            return;
+
+        u64 submissionEnd{timestamps[1]};
+        auto toTraceTime{[&](u64 timestamp) -> u64 {
+            auto offset{static_cast<u64>(static_cast<double>(submissionEnd - std::min(timestamp, submissionEnd)) * gpu.traits.timestampPeriod)};
+            return endTime - std::min(offset, endTime);
+        }};
+
+        TRACE_EVENT_BEGIN("gpu", nullptr, track, toTraceTime(timestamps[0]), [&](perfetto::EventContext ctx) {
+            ctx.event()->set_name(fmt::format("Submission {}", submissionNumber));
+        });
+        for (u32 i{}; i < renderPassCount; i++) {
+            const auto &renderArea{renderAreas[i]};
+            TRACE_EVENT_BEGIN("gpu", nullptr, track, toTraceTime(timestamps[2 + (i * 2)]), [&](perfetto::EventContext ctx) {
+                ctx.event()->set_name(fmt::format("RenderPass {} ({}x{})", i, renderArea.extent.width, renderArea.extent.height));
+            });
+            TRACE_EVENT_END("gpu", track, toTraceTime(timestamps[3 + (i * 2)]));
+        }
+        TRACE_EVENT_END("gpu", track, endTime);
+    }
+
     CommandRecordThread::CommandRecordThread(const DeviceState &state)
         : state{state},
           incoming{1U << *state.settings->executorSlotCountScale},
-          outgoing{1U << *state.settings->executorSlotCountScale},
-          thread{&CommandRecordThread::Run, this} {}
+          outgoing{1U << *state.settings->executorSlotCountScale} {
+        if (void *mod{dlopen("libVkLayer_GLES_RenderDoc.so", RTLD_NOW | RTLD_NOLOAD)}) {
+            auto *pfnGetApi{reinterpret_cast<pRENDERDOC_GetAPI>(dlsym(mod, "RENDERDOC_GetAPI"))};
+            if (int ret{pfnGetApi(eRENDERDOC_API_Version_1_4_2, (void **)&renderDocApi)}; ret != 1)
+                Logger::Warn("Failed to intialise RenderDoc API: {}", ret);
+        }
+
+        // Recording separate slots concurrently is safe as each has its own command pool, submission is still serialized in release order
+        size_t threadCount{*state.settings->parallelCommandRecording ? ParallelRecordThreadCount : 1};
+        for (size_t i{}; i < threadCount; i++)
+            threads.emplace_back(&CommandRecordThread::Run, this, i);
+    }
 
     CommandRecordThread::Slot::ScopedBegin::ScopedBegin(CommandRecordThread::Slot &slot) : slot{slot} {}
 
@@ -55,7 +130,12 @@ namespace skyline::gpu::interconnect {
           commandBuffer{AllocateRaiiCommandBuffer(gpu, commandPool)},
           fence{gpu.vkDevice, vk::FenceCreateInfo{ .flags = vk::FenceCreateFlagBits::eSignaled }},
           semaphore{gpu.vkDevice, vk::SemaphoreCreateInfo{}},
-          cycle{std::make_shared<FenceCycle>(gpu.vkDevice, *fence, *semaphore, true)},
+          cycle{std::make_shared<FenceCycle>(gpu.vkDevice, *fence, *semaphore, gpu.scheduler.GetTimeline(), true)},
+          timestampPool{gpu.traits.supportsGpuTimestamps ? std::optional<vk::raii::QueryPool>{std::in_place, gpu.vkDevice, vk::QueryPoolCreateInfo{
+              .queryType = vk::QueryType::eTimestamp,
+              .queryCount = 2,
+          }} : std::nullopt},
+          megaBufferAllocator{gpu, MegaBufferSlotChunkSize},
           nodes{allocator},
           pendingPostRenderPassNodes{allocator} {
         Begin();
@@ -67,7 +147,9 @@ namespace skyline::gpu::interconnect {
           fence{std::move(other.fence)},
           semaphore{std::move(other.semaphore)},
           cycle{std::move(other.cycle)},
+          timestampPool{std::move(other.timestampPool)},
           allocator{std::move(other.allocator)},
+          megaBufferAllocator{std::move(other.megaBufferAllocator)},
           nodes{std::move(other.nodes)},
           pendingPostRenderPassNodes{std::move(other.pendingPostRenderPassNodes)},
           ready{other.ready} {}
@@ -80,6 +162,19 @@ namespace skyline::gpu::interconnect {
         if (util::GetTimeNs() - startTime > GrowThresholdNs)
             didWait = true;
 
+        if (std::exchange(timestampsWritten, false)) {
+            std::array<u64, 2> timestamps{};
+            auto result{(*gpu.vkDevice).getQueryPoolResults(**timestampPool, 0, static_cast<u32>(timestamps.size()), sizeof(timestamps), timestamps.data(), sizeof(u64), vk::QueryResultFlagBits::e64, *gpu.vkDevice.getDispatcher())};
+            if (result == vk::Result::eSuccess && timestamps[1] > timestamps[0]) {
+                auto gpuTime{static_cast<u64>(static_cast<double>(timestamps[1] - timestamps[0]) * gpu.traits.timestampPeriod)};
+                trace::AddFrameCounter(trace::FrameCounter::GpuTime, gpuTime);
+                PerfStats.gpuTimeNs.fetch_add(gpuTime, std::memory_order_relaxed);
+            }
+        }
+
+        // All allocations were made with the prior cycle which has now been signalled
+        megaBufferAllocator.Reset();
+
         // Command buffer doesn't need to be reset since that's done implicitly by begin
         return cycle;
     }
@@ -95,6 +190,10 @@ namespace skyline::gpu::interconnect {
         commandBuffer.begin(vk::CommandBufferBeginInfo{
             .flags = vk::CommandBufferUsageFlagBits::eOneTimeSubmit,
         });
+        if (timestampPool) {
+            commandBuffer.resetQueryPool(**timestampPool, 0, 2);
+            commandBuffer.writeTimestamp(vk::PipelineStageFlagBits::eTopOfPipe, **timestampPool, 0);
+        }
         ready = true;
         beginCondition.notify_all();
     }
@@ -103,9 +202,17 @@ namespace skyline::gpu::interconnect {
         TRACE_EVENT_FMT("gpu", "ProcessSlot: 0x{:X}, execution: {}", slot, u64{slot->executionTag});
         auto &gpu{*state.gpu};
 
+        VkInstance instance{*gpu.vkInstance};
+        if (renderDocApi && slot->capture)
+            renderDocApi->StartFrameCapture(RENDERDOC_DEVICEPOINTER_FROM_VKINSTANCE(instance), nullptr);
+
         vk::RenderPass lRenderPass;
         u32 subpassIndex;
 
+        auto timestampQueries{slot->timestampQueries.get()};
+        if (timestampQueries)
+            timestampQueries->Begin(slot->commandBuffer);
+
         using namespace node;
         for (NodeVariant &node : slot->nodes) {
             std::visit(VariantVisitor{
@@ -134,6 +241,8 @@ namespace skyline::gpu::interconnect {
 
                 [&](RenderPassNode &node) {
                     TRACE_EVENT_INSTANT("gpu", "RenderPassNode");
+                    if (timestampQueries)
+                        timestampQueries->BeginRenderPass(slot->commandBuffer, node.renderArea);
                     lRenderPass = node(slot->commandBuffer, slot->cycle, gpu);
                     subpassIndex = 0;
                 },
@@ -157,59 +266,86 @@ namespace skyline::gpu::interconnect {
                 [&](RenderPassEndNode &node) {
                     TRACE_EVENT_INSTANT("gpu", "RenderPassEndNode");
                     node(slot->commandBuffer, slot->cycle, gpu);
+                    if (timestampQueries)
+                        timestampQueries->EndRenderPass(slot->commandBuffer);
                 },
             }, node);
             #undef NODE
         }
 
+        if (timestampQueries) {
+            timestampQueries->End(slot->commandBuffer);
+            slot->timestampQueries.reset(); // Ownership of the queries is retained by the executor till they're resolved
+        }
+
+        if (slot->timestampPool) {
+            slot->commandBuffer.writeTimestamp(vk::PipelineStageFlagBits::eBottomOfPipe, **slot->timestampPool, 1);
+            slot->timestampsWritten = true;
+        }
+
         slot->commandBuffer.end();
         slot->ready = false;
 
-        gpu.scheduler.SubmitCommandBuffer(slot->commandBuffer, slot->cycle);
+        if (renderDocApi && slot->capture)
+            renderDocApi->EndFrameCapture(RENDERDOC_DEVICEPOINTER_FROM_VKINSTANCE(instance), nullptr);
+        slot->capture = false;
+
+        {
+            std::unique_lock lock{submissionMutex};
+            submissionCondition.wait(lock, [&] { return slot->submissionIndex == nextSubmissionIndex; });
+
+            gpu.scheduler.SubmitCommandBuffer(slot->commandBuffer, slot->cycle, {}, {}, slot->waitTimelinePoints);
+            slot->waitTimelinePoints.clear();
+            nextSubmissionIndex++;
+
+            if (slot->didWait && (slots.size() + 1) < (1U << *state.settings->executorSlotCountScale)) {
+                outgoing.Push(&slots.emplace_back(gpu));
+                outgoing.Push(&slots.emplace_back(gpu));
+                slot->didWait = false;
+            }
+        }
+        submissionCondition.notify_all();
 
         slot->nodes.clear();
         slot->allocator.Reset();
+
+        outgoing.Push(slot);
     }
 
-    void CommandRecordThread::Run() {
+    void CommandRecordThread::Run(size_t threadIndex) {
         auto &gpu{*state.gpu};
 
-        RENDERDOC_API_1_4_2 *renderDocApi{};
-        if (void *mod{dlopen("libVkLayer_GLES_RenderDoc.so", RTLD_NOW | RTLD_NOLOAD)}) {
-            auto *pfnGetApi{reinterpret_cast<pRENDERDOC_GetAPI>(dlsym(mod, "RENDERDOC_GetAPI"))};
-            if (int ret{pfnGetApi(eRENDERDOC_API_Version_1_4_2, (void **)&renderDocApi)}; ret != 1)
-                Logger::Warn("Failed to intialise RenderDoc API: {}", ret);
+        if (threadIndex == 0) {
+            std::scoped_lock lock{submissionMutex};
+            outgoing.Push(&slots.emplace_back(gpu));
         }
 
-        outgoing.Push(&slots.emplace_back(gpu));
-
-        if (int result{pthread_setname_np(pthread_self(), "Sky-CmdRecord")})
+        if (int result{pthread_setname_np(pthread_self(), threadIndex ? fmt::format("Sky-CmdRecord{}", threadIndex).c_str() : "Sky-CmdRecord")})
             Logger::Warn("Failed to set the thread name: {}", strerror(result));
 
+        HostAffinity::PlaceCurrentThread(HostThreadRole::CommandRecord);
+        PerformanceHint::ScopedThread hintThread;
+
         try {
             signal::SetSignalHandler({SIGINT, SIGILL, SIGTRAP, SIGBUS, SIGFPE, SIGSEGV}, signal::ExceptionalSignalHandler);
 
-            incoming.Process([this, renderDocApi, &gpu](Slot *slot) {
-                idle = false;
-                VkInstance instance{*gpu.vkInstance};
-                if (renderDocApi && slot->capture)
-                    renderDocApi->StartFrameCapture(RENDERDOC_DEVICEPOINTER_FROM_VKINSTANCE(instance), nullptr);
-
+            auto processSlot{[this](Slot *slot) {
+                activeThreads++;
+                auto startTime{util::GetTimeNs()};
                 ProcessSlot(slot);
+                auto slotBusyTime{static_cast<u64>(util::GetTimeNs() - startTime)};
+                busyTime.fetch_add(slotBusyTime, std::memory_order_relaxed);
+                trace::AddFrameCounter(trace::FrameCounter::RecordBusyTime, slotBusyTime);
+                activeThreads--;
+            }};
 
-                if (renderDocApi && slot->capture)
-                    renderDocApi->EndFrameCapture(RENDERDOC_DEVICEPOINTER_FROM_VKINSTANCE(instance), nullptr);
-                slot->capture = false;
-
-                if (slot->didWait && (slots.size() + 1) < (1U << *state.settings->executorSlotCountScale)) {
-                    outgoing.Push(&slots.emplace_back(gpu));
-                    outgoing.Push(&slots.emplace_back(gpu));
-                    slot->didWait = false;
-                }
-
-                outgoing.Push(slot);
-                idle = true;
-            }, [] {});
+            if (!*state.settings->parallelCommandRecording) {
+                incoming.Process(processSlot, [] {});
+            } else {
+                // Slots are popped individually as processing entire batches would serialize recording
+                while (true)
+                    processSlot(incoming.Pop());
+            }
         } catch (const signal::SignalException &e) {
             Logger::Error("{}\nStack Trace:{}", e.what(), state.loader->GetStackTrace(e.frames));
             if (state.process)
@@ -226,7 +362,11 @@ namespace skyline::gpu::interconnect {
     }
 
     bool CommandRecordThread::IsIdle() const {
-        return idle;
+        return activeThreads == 0;
+    }
+
+    u64 CommandRecordThread::ConsumeBusyTime() {
+        return busyTime.exchange(0, std::memory_order_relaxed);
     }
 
     CommandRecordThread::Slot *CommandRecordThread::AcquireSlot() {
@@ -239,6 +379,7 @@ namespace skyline::gpu::interconnect {
     }
 
     void CommandRecordThread::ReleaseSlot(Slot *slot) {
+        slot->submissionIndex = nextReleaseIndex++;
         incoming.Push(slot);
     }
 
@@ -250,7 +391,6 @@ namespace skyline::gpu::interconnect {
             adrenotools_set_turbo(true);
 
         while (true) {
-            std::pair<std::shared_ptr<FenceCycle>, std::function<void()>> item{};
             {
                 std::unique_lock lock{mutex};
                 if (pendingSignalQueue.empty()) {
@@ -268,17 +408,21 @@ namespace skyline::gpu::interconnect {
 
                     idle = false;
                 }
-                item = std::move(pendingSignalQueue.front());
-                pendingSignalQueue.pop();
-            }
-            {
-                TRACE_EVENT("gpu", "GPU");
-                if (item.first)
-                    item.first->Wait();
+
+                // All queued callbacks are taken at once, they're dispatched in order as their cycles are signalled without any further synchronization with the producer
+                std::swap(pendingSignalQueue, processingSignalQueue);
             }
 
-            if (item.second)
-                item.second();
+            for (auto &[cycle, callback] : processingSignalQueue) {
+                if (cycle) {
+                    TRACE_EVENT("gpu", "GPU");
+                    cycle->Wait();
+                }
+
+                if (callback)
+                    callback();
+            }
+            processingSignalQueue.clear();
         }
     }
 
@@ -289,11 +433,16 @@ namespace skyline::gpu::interconnect {
     }
 
     void ExecutionWaiterThread::Queue(std::shared_ptr<FenceCycle> cycle, std::function<void()> &&callback) {
+        bool wasIdle;
         {
             std::unique_lock lock{mutex};
-            pendingSignalQueue.push({std::move(cycle), std::move(callback)});
+            pendingSignalQueue.emplace_back(std::move(cycle), std::move(callback));
+            wasIdle = idle;
         }
-        condition.notify_all();
+
+        // The thread only needs to be woken up if it's waiting on new callbacks, it'll pick up the callback after its current batch otherwise
+        if (wasIdle)
+            condition.notify_all();
     }
 
     void CheckpointPollerThread::Run() {
@@ -325,7 +474,16 @@ namespace skyline::gpu::interconnect {
           recordThread{state},
           waiterThread{state},
           checkpointPollerThread{EnableGpuCheckpoints ? std::optional<CheckpointPollerThread>{state} : std::optional<CheckpointPollerThread>{}},
+          flushThreshold{*state.settings->adaptiveExecutorFlush ? std::clamp(*state.settings->executorFlushThreshold, MinAdaptiveFlushThreshold, MaxAdaptiveFlushThreshold) : *state.settings->executorFlushThreshold},
+          lastFlushEvaluationTime{util::GetTimeNs()},
+          gpuTimelineTrack{static_cast<u64>(trace::TrackIds::GpuTimeline), perfetto::ProcessTrack::Current()},
           tag{AllocateTag()} {
+        if constexpr (EnableGpuTimestampQueries) {
+            auto desc{gpuTimelineTrack.Serialize()};
+            desc.set_name("GPU Timeline");
+            perfetto::TrackEvent::SetTrackDescriptor(gpuTimelineTrack, desc);
+        }
+
         RotateRecordSlot();
     }
 
@@ -344,10 +502,31 @@ namespace skyline::gpu::interconnect {
         cycle = slot->Reset(gpu);
         slot->executionTag = executionTag;
         allocator = &slot->allocator;
+        megaBufferAllocator = &slot->megaBufferAllocator;
+    }
+
+    void CommandExecutor::UpdateFlushThreshold() {
+        auto time{util::GetTimeNs()};
+        auto period{time - lastFlushEvaluationTime};
+        if (period < FlushEvaluationPeriodNs)
+            return;
+        lastFlushEvaluationTime = time;
+
+        auto gpuIdleTime{static_cast<i64>(gpu.scheduler.ConsumeIdleTime())};
+        auto recordBusyTime{static_cast<i64>(recordThread.ConsumeBusyTime())};
+
+        if (gpuIdleTime > period / 8)
+            // The GPU spent a significant portion of the period without work, flush sooner so it can start on work while the rest of the execution is being recorded
+            flushThreshold = std::max(flushThreshold - flushThreshold / 4, MinAdaptiveFlushThreshold);
+        else if (gpuIdleTime < period / 32 && recordBusyTime < period / 2)
+            // The GPU is kept fed and the record thread has headroom, larger executions reduce the overhead of submissions
+            flushThreshold = std::min(flushThreshold + flushThreshold / 8, MaxAdaptiveFlushThreshold);
+
+        TRACE_COUNTER("gpu", perfetto::CounterTrack{"ExecutorFlushThreshold"}, flushThreshold);
     }
 
     static bool ViewsEqual(vk::ImageView a, TextureView *b) {
-        return (!a && !b) || (a && b && b->GetView() == a);
+        return (!a && !b) || (a && b && b->GetAttachmentView() == a);
     }
 
     bool CommandExecutor::CreateRenderPassWithSubpass(vk::Rect2D renderArea, span<TextureView *> sampledImages, span<TextureView *> inputAttachments, span<TextureView *> colorAttachments, TextureView *depthStencilAttachment, bool noSubpassCreation, vk::PipelineStageFlags srcStageMask, vk::PipelineStageFlags dstStageMask) {
@@ -356,9 +535,9 @@ namespace skyline::gpu::interconnect {
             lastSubpassColorAttachments.clear();
             lastSubpassInputAttachments.clear();
 
-            ranges::transform(colorAttachments, std::back_inserter(lastSubpassColorAttachments), [](TextureView *view){ return view ? view->GetView() : vk::ImageView{};});
-            ranges::transform(inputAttachments, std::back_inserter(lastSubpassInputAttachments), [](TextureView *view){ return view ? view->GetView() : vk::ImageView{};});
-            lastSubpassDepthStencilAttachment = depthStencilAttachment ? depthStencilAttachment->GetView() : vk::ImageView{};
+            ranges::transform(colorAttachments, std::back_inserter(lastSubpassColorAttachments), [](TextureView *view){ return view ? view->GetAttachmentView() : vk::ImageView{};});
+            ranges::transform(inputAttachments, std::back_inserter(lastSubpassInputAttachments), [](TextureView *view){ return view ? view->GetAttachmentView() : vk::ImageView{};});
+            lastSubpassDepthStencilAttachment = depthStencilAttachment ? depthStencilAttachment->GetAttachmentView() : vk::ImageView{};
         }};
 
         span<TextureView *> depthStencilAttachmentSpan{depthStencilAttachment ? span<TextureView *>(depthStencilAttachment) : span<TextureView *>()};
@@ -430,9 +609,14 @@ namespace skyline::gpu::interconnect {
             texture->unlock();
     }
 
-    bool CommandExecutor::AttachTexture(TextureView *view) {
+    bool CommandExecutor::AttachTexture(TextureView *view, bool overwrite) {
         bool didLock{view->LockWithTag(tag)};
         if (didLock) {
+            if (overwrite)
+                view->texture->DiscardContents();
+            view->texture->RestoreBacking();
+            view->texture->lastUseTime = util::GetTimeNs();
+
             // TODO: fixup remaining bugs with this and add better heuristics to avoid pauses
             // if (view->texture->FrequentlyLocked())
             attachedTextures.emplace_back(view->texture);
@@ -472,6 +656,32 @@ namespace skyline::gpu::interconnect {
         return didLock;
     }
 
+    static size_t GetBufferViewCacheIndex(span<u8> mapping, size_t cacheSize) {
+        auto address{reinterpret_cast<u64>(mapping.data())};
+        return ((address >> 4) ^ (address >> 16) ^ mapping.size()) & (cacheSize - 1);
+    }
+
+    BufferView CommandExecutor::LookupCachedBufferView(span<u8> mapping) {
+        auto &entry{bufferViewCache[GetBufferViewCacheIndex(mapping, BufferViewCacheSize)]};
+        if (entry.executionTag == executionTag && entry.address == mapping.data() && entry.size == mapping.size() && entry.view.GetBuffer()->GetSequenceNumber() == entry.sequenceNumber)
+            return entry.view;
+
+        return {};
+    }
+
+    void CommandExecutor::CacheBufferView(span<u8> mapping, const BufferView &view) {
+        if (!view)
+            return;
+
+        bufferViewCache[GetBufferViewCacheIndex(mapping, BufferViewCacheSize)] = BufferViewCacheEntry{
+            .address = mapping.data(),
+            .size = mapping.size(),
+            .executionTag = executionTag,
+            .sequenceNumber = view.GetBuffer()->GetSequenceNumber(),
+            .view = view,
+        };
+    }
+
     void CommandExecutor::AttachLockedBufferView(BufferView &view, ContextLock<BufferView> &&lock) {
         if (lock.OwnsLock()) {
             // Transfer ownership to executor so that the resource will stay locked for the period it is used on the GPU
@@ -491,44 +701,49 @@ namespace skyline::gpu::interconnect {
         cycle->AttachObject(dependency);
     }
 
-    void CommandExecutor::AddSubpass(std::function<void(vk::raii::CommandBuffer &, const std::shared_ptr<FenceCycle> &, GPU &, vk::RenderPass, u32)> &&function, vk::Rect2D renderArea, span<TextureView *> sampledImages, span<TextureView *> inputAttachments, span<TextureView *> colorAttachments, TextureView *depthStencilAttachment, bool noSubpassCreation, vk::PipelineStageFlags srcStageMask, vk::PipelineStageFlags dstStageMask) {
+    void CommandExecutor::AddSubpassNode(node::SubpassFunctionNode &&function, vk::Rect2D renderArea, span<TextureView *> sampledImages, span<TextureView *> inputAttachments, span<TextureView *> colorAttachments, TextureView *depthStencilAttachment, bool noSubpassCreation, vk::PipelineStageFlags srcStageMask, vk::PipelineStageFlags dstStageMask) {
         bool gotoNext{CreateRenderPassWithSubpass(renderArea, sampledImages, inputAttachments, colorAttachments, depthStencilAttachment ? &*depthStencilAttachment : nullptr, noSubpassCreation, srcStageMask, dstStageMask)};
         if (gotoNext)
-            slot->nodes.emplace_back(std::in_place_type_t<node::NextSubpassFunctionNode>(), std::forward<decltype(function)>(function));
+            slot->nodes.emplace_back(std::in_place_type_t<node::NextSubpassFunctionNode>(), std::move(function));
         else
-            slot->nodes.emplace_back(std::in_place_type_t<node::SubpassFunctionNode>(), std::forward<decltype(function)>(function));
+            slot->nodes.emplace_back(std::in_place_type_t<node::SubpassFunctionNode>(), std::move(function));
 
-        if (slot->nodes.size() > *state.settings->executorFlushThreshold && !gotoNext)
+        if (slot->nodes.size() > flushThreshold && !gotoNext)
             Submit();
     }
 
-    void CommandExecutor::AddOutsideRpCommand(std::function<void(vk::raii::CommandBuffer &, const std::shared_ptr<FenceCycle> &, GPU &)> &&function) {
+    void CommandExecutor::AddOutsideRpCommandNode(node::FunctionNode &&function) {
         if (renderPass)
             FinishRenderPass();
 
-        slot->nodes.emplace_back(std::in_place_type_t<node::FunctionNode>(), std::forward<decltype(function)>(function));
+        slot->nodes.emplace_back(std::in_place_type_t<node::FunctionNode>(), std::move(function));
     }
 
-    void CommandExecutor::AddCommand(std::function<void(vk::raii::CommandBuffer &, const std::shared_ptr<FenceCycle> &, GPU &)> &&function) {
-        slot->nodes.emplace_back(std::in_place_type_t<node::FunctionNode>(), std::forward<decltype(function)>(function));
+    void CommandExecutor::AddCommandNode(node::FunctionNode &&function) {
+        slot->nodes.emplace_back(std::in_place_type_t<node::FunctionNode>(), std::move(function));
     }
 
-    void CommandExecutor::InsertPreExecuteCommand(std::function<void(vk::raii::CommandBuffer &, const std::shared_ptr<FenceCycle> &, GPU &)> &&function) {
-        slot->nodes.emplace(slot->nodes.begin(), std::in_place_type_t<node::FunctionNode>(), std::forward<decltype(function)>(function));
+    void CommandExecutor::InsertPreExecuteCommandNode(node::FunctionNode &&function) {
+        slot->nodes.emplace(slot->nodes.begin(), std::in_place_type_t<node::FunctionNode>(), std::move(function));
     }
 
-    void CommandExecutor::InsertPreRpCommand(std::function<void(vk::raii::CommandBuffer &, const std::shared_ptr<FenceCycle> &, GPU &)> &&function) {
-        slot->nodes.emplace(renderPass ? renderPassIt : slot->nodes.end(), std::in_place_type_t<node::FunctionNode>(), std::forward<decltype(function)>(function));
+    void CommandExecutor::InsertPreRpCommandNode(node::FunctionNode &&function) {
+        slot->nodes.emplace(renderPass ? renderPassIt : slot->nodes.end(), std::in_place_type_t<node::FunctionNode>(), std::move(function));
     }
 
-    void CommandExecutor::InsertPostRpCommand(std::function<void(vk::raii::CommandBuffer &, const std::shared_ptr<FenceCycle> &, GPU &)> &&function) {
-        slot->pendingPostRenderPassNodes.emplace_back(std::in_place_type_t<node::FunctionNode>(), std::forward<decltype(function)>(function));
+    void CommandExecutor::InsertPostRpCommandNode(node::FunctionNode &&function) {
+        slot->pendingPostRenderPassNodes.emplace_back(std::in_place_type_t<node::FunctionNode>(), std::move(function));
     }
 
     void CommandExecutor::AddFullBarrier() {
+        // Guests commonly issue several WFIs back-to-back, each of these would otherwise flush the entire pipeline again despite there being nothing new to wait on
+        if (!renderPass && slot->nodes.size() == fullBarrierNodeCount)
+            return;
+
         AddOutsideRpCommand([](vk::raii::CommandBuffer &commandBuffer, const std::shared_ptr<FenceCycle> &, GPU &) {
             RecordFullBarrier(commandBuffer);
         });
+        fullBarrierNodeCount = slot->nodes.size();
     }
 
     void CommandExecutor::AddClearColorSubpass(TextureView *attachment, const vk::ClearColorValue &value) {
@@ -550,9 +765,9 @@ namespace skyline::gpu::interconnect {
             }};
 
             if (gotoNext)
-                slot->nodes.emplace_back(std::in_place_type_t<node::NextSubpassFunctionNode>(), function);
+                slot->nodes.emplace_back(std::in_place_type_t<node::NextSubpassFunctionNode>(), *allocator, function);
             else
-                slot->nodes.emplace_back(std::in_place_type_t<node::SubpassFunctionNode>(), function);
+                slot->nodes.emplace_back(std::in_place_type_t<node::SubpassFunctionNode>(), *allocator, function);
         }
     }
 
@@ -574,12 +789,44 @@ namespace skyline::gpu::interconnect {
             }};
 
             if (gotoNext)
-                slot->nodes.emplace_back(std::in_place_type_t<node::NextSubpassFunctionNode>(), function);
+                slot->nodes.emplace_back(std::in_place_type_t<node::NextSubpassFunctionNode>(), *allocator, function);
             else
-                slot->nodes.emplace_back(std::in_place_type_t<node::SubpassFunctionNode>(), function);
+                slot->nodes.emplace_back(std::in_place_type_t<node::SubpassFunctionNode>(), *allocator, function);
         }
     }
 
+    bool CommandExecutor::AddInlineClear(span<TextureView *> attachments, span<const vk::ClearAttachment> clearAttachments, const vk::ClearRect &clearRect) {
+        if (!renderPass || clearRect.baseArrayLayer != 0 || clearRect.layerCount != 1)
+            return false; // Render passes always have a single-layer framebuffer
+
+        const auto &renderArea{renderPass->renderArea};
+        if (clearRect.rect.offset.x < renderArea.offset.x || clearRect.rect.offset.y < renderArea.offset.y ||
+            static_cast<i64>(clearRect.rect.offset.x) + clearRect.rect.extent.width > static_cast<i64>(renderArea.offset.x) + renderArea.extent.width ||
+            static_cast<i64>(clearRect.rect.offset.y) + clearRect.rect.extent.height > static_cast<i64>(renderArea.offset.y) + renderArea.extent.height)
+            return false;
+
+        boost::container::small_vector<vk::ClearAttachment, 2> subpassClearAttachments;
+        for (size_t i{}; i < attachments.size(); i++) {
+            auto vkView{attachments[i]->GetAttachmentView()};
+            auto clearAttachment{clearAttachments[i]};
+            if (clearAttachment.aspectMask & vk::ImageAspectFlagBits::eColor) {
+                auto it{ranges::find(lastSubpassColorAttachments, vkView)};
+                if (it == lastSubpassColorAttachments.end())
+                    return false;
+                clearAttachment.colorAttachment = static_cast<u32>(std::distance(lastSubpassColorAttachments.begin(), it));
+            } else if (vkView != lastSubpassDepthStencilAttachment) {
+                return false;
+            }
+
+            subpassClearAttachments.push_back(clearAttachment);
+        }
+
+        slot->nodes.emplace_back(std::in_place_type_t<node::SubpassFunctionNode>(), *allocator, [subpassClearAttachments, clearRect](vk::raii::CommandBuffer &commandBuffer, const std::shared_ptr<FenceCycle> &, GPU &, vk::RenderPass, u32) {
+            commandBuffer.clearAttachments(subpassClearAttachments, clearRect);
+        });
+        return true;
+    }
+
     void CommandExecutor::AddFlushCallback(std::function<void()> &&callback) {
         flushCallbacks.emplace_back(std::forward<decltype(callback)>(callback));
     }
@@ -597,11 +844,15 @@ namespace skyline::gpu::interconnect {
         return renderPassIndex;
     }
 
+    const void *CommandExecutor::GetLastNode() {
+        return slot->nodes.empty() ? nullptr : &slot->nodes.back();
+    }
+
     u32 CommandExecutor::AddCheckpointImpl(std::string_view annotation) {
         if (renderPass)
             FinishRenderPass();
 
-        slot->nodes.emplace_back(node::CheckpointNode{gpu.megaBufferAllocator.Push(cycle, span<u32>(&nextCheckpointId, 1).cast<u8>()), nextCheckpointId});
+        slot->nodes.emplace_back(node::CheckpointNode{megaBufferAllocator->Push(cycle, span<u32>(&nextCheckpointId, 1).cast<u8>()), nextCheckpointId});
 
         TRACE_EVENT_INSTANT("gpu", "Mark Checkpoint", "id", nextCheckpointId, "annotation", [&annotation](perfetto::TracedValue context) {
             std::move(context).WriteString(annotation.data(), annotation.size());
@@ -612,12 +863,57 @@ namespace skyline::gpu::interconnect {
         return nextCheckpointId++;
     }
 
+    void CommandExecutor::OptimizeRenderPasses() {
+        TRACE_EVENT("gpu", "CommandExecutor::OptimizeRenderPasses");
+
+        renderPassRanges.clear();
+        for (auto it{slot->nodes.begin()}; it != slot->nodes.end(); it++) {
+            if (std::holds_alternative<node::RenderPassNode>(*it))
+                renderPassRanges.push_back({.begin = it});
+            else if (std::holds_alternative<node::RenderPassEndNode>(*it))
+                renderPassRanges.back().end = it;
+        }
+
+        if (renderPassRanges.size() < 2)
+            return;
+
+        // Render passes are visited in reverse so clears can be folded through a chain of clear-only render passes into the first one with commands
+        size_t next{renderPassRanges.size() - 1};
+        for (size_t i{next}; i-- > 0;) {
+            auto &range{renderPassRanges[i]}, &nextRange{renderPassRanges[next]};
+            if (std::next(range.end) != nextRange.begin) {
+                // Any commands in between render passes could depend on the contents of the attachments
+                next = i;
+                continue;
+            }
+
+            auto &renderPassNode{std::get<node::RenderPassNode>(*range.begin)};
+            auto &nextRenderPassNode{std::get<node::RenderPassNode>(*nextRange.begin)};
+            if (std::next(range.begin) == range.end && renderPassNode.FoldClearsInto(nextRenderPassNode)) {
+                slot->nodes.erase(range.begin, std::next(range.end));
+                continue;
+            }
+
+            renderPassNode.DiscardOverwrittenAttachments(nextRenderPassNode);
+            next = i;
+        }
+    }
+
     void CommandExecutor::SubmitInternal() {
         if (renderPass)
             FinishRenderPass();
 
         slot->nodes.splice(slot->nodes.end(), slot->pendingPostRenderPassNodes);
 
+        OptimizeRenderPasses();
+
+        // Transient backings are only retained if no render pass in the execution loads an attachment, all passes need to be inspected prior to discarding any attachment contents
+        for (auto &slotNode : slot->nodes)
+            if (auto renderPassNode{std::get_if<node::RenderPassNode>(&slotNode)})
+                renderPassNode->UpdateTransientAttachments();
+        for (auto &slotNode : slot->nodes)
+            if (auto renderPassNode{std::get_if<node::RenderPassNode>(&slotNode)})
+                renderPassNode->DiscardTransientAttachments();
 
         {
             slot->WaitReady();
@@ -627,7 +923,16 @@ namespace skyline::gpu::interconnect {
 
             boost::container::small_vector<FenceCycle *, 8> chainedCycles;
             for (const auto &texture : ranges::views::concat(attachedTextures, preserveAttachedTextures)) {
-                texture->SynchronizeHostInline(slot->commandBuffer, cycle, true);
+                // Large uploads are done on the transfer queue so they can overlap with rendering, the slot waits on them before it executes
+                if (auto point{texture->SynchronizeHostAsync(true)}) {
+                    auto it{ranges::find(slot->waitTimelinePoints, point->first, &FenceCycle::TimelinePoint::first)};
+                    if (it != slot->waitTimelinePoints.end())
+                        it->second = std::max(it->second, point->second);
+                    else
+                        slot->waitTimelinePoints.push_back(*point);
+                } else {
+                    texture->SynchronizeHostInline(slot->commandBuffer, cycle, true);
+                }
                 // We don't need to attach the Texture to the cycle as a TextureView will already be attached
                 if (ranges::find(chainedCycles, texture->cycle.get()) == chainedCycles.end()) {
                     cycle->ChainCycle(texture->cycle);
@@ -636,12 +941,45 @@ namespace skyline::gpu::interconnect {
 
                 texture->cycle = cycle;
                 texture->UpdateRenderPassUsage(0, texture::RenderPassUsage::None);
+                texture->UpdateTransientBacking(slot->commandBuffer, cycle);
+
+                if (texture->RequestAsyncReadback(cycle)) {
+                    // Frequently read back textures are copied into a staging buffer at the end of the execution so that the guest doesn't need to block on the GPU to read them
+                    slot->nodes.emplace_back(std::in_place_type_t<node::FunctionNode>(), *allocator, [texture = texture.texture](vk::raii::CommandBuffer &commandBuffer, const std::shared_ptr<FenceCycle> &, GPU &) {
+                        texture->RecordAsyncReadback(commandBuffer);
+                    });
+                    waiterThread.Queue(cycle, [texture = texture.texture, readbackCycle = cycle] {
+                        texture->CompleteAsyncReadback(readbackCycle);
+                    });
+                }
             }
 
             // Wait on texture syncs to finish before beginning the cmdbuf
             RecordFullBarrier(slot->commandBuffer);
         }
 
+        if (EnableGpuTimestampQueries && gpu.traits.supportsGpuTimestamps) {
+            std::shared_ptr<TimestampQueries> queries;
+            {
+                std::scoped_lock lock{timestampQueriesMutex};
+                if (!freeTimestampQueries.empty()) {
+                    queries = std::move(freeTimestampQueries.back());
+                    freeTimestampQueries.pop_back();
+                }
+            }
+            if (!queries)
+                queries = std::make_shared<TimestampQueries>(gpu);
+
+            queries->submissionNumber = submissionNumber;
+            slot->timestampQueries = queries;
+            waiterThread.Queue(cycle, [this, queries = std::move(queries)]() mutable {
+                queries->Resolve(gpu, gpuTimelineTrack);
+
+                std::scoped_lock lock{timestampQueriesMutex};
+                freeTimestampQueries.push_back(std::move(queries));
+            });
+        }
+
         for (const auto &attachedBuffer : ranges::views::concat(attachedBuffers, preserveAttachedBuffers)) {
             if (attachedBuffer->RequiresCycleAttach()) {
                 attachedBuffer->SynchronizeHost(); // Synchronize attached buffers from the CPU without using a staging buffer
@@ -659,6 +997,7 @@ namespace skyline::gpu::interconnect {
         attachedBuffers.clear();
         allocator->Reset();
         renderPassIndex = 0;
+        fullBarrierNodeCount = 0;
         usageTracker.sequencedIntervals.Clear();
 
         // Periodically clear preserve attachments just in case there are new waiters which would otherwise end up waiting forever
@@ -691,9 +1030,18 @@ namespace skyline::gpu::interconnect {
 
         if (!slot->nodes.empty()) {
             TRACE_EVENT("gpu", "CommandExecutor::Submit");
+            auto submittedCycle{cycle}; // The cycle is replaced by that of the next slot during submission
             SubmitInternal();
             submissionNumber++;
+
+            if (*state.settings->useDirectMemoryImport)
+                for (auto &[syncpoint, threshold] : pendingSyncpointFences)
+                    syncpoint->AttachFence(threshold, submittedCycle);
         }
+        pendingSyncpointFences.clear();
+
+        if (*state.settings->adaptiveExecutorFlush)
+            UpdateFlushThreshold();
 
         if (!*state.settings->useDirectMemoryImport) {
             // When DMI is not in use, execute callbacks immediately after submission
@@ -730,6 +1078,10 @@ namespace skyline::gpu::interconnect {
         pendingDeferredActions.emplace_back(std::move(callback));
     }
 
+    void CommandExecutor::AddSyncpointFence(soc::host1x::Syncpoint &syncpoint, u32 threshold) {
+        pendingSyncpointFences.emplace_back(&syncpoint, threshold);
+    }
+
     void CommandExecutor::LockPreserve() {
         if (!preserveLocked) {
             preserveLocked = true;
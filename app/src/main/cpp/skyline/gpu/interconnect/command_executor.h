@@ -6,13 +6,52 @@
 #include <boost/container/stable_vector.hpp>
 #include <renderdoc_app.h>
 #include <common/linear_allocator.h>
+#include <common/trace.h>
 #include <gpu/usage_tracker.h>
 #include <gpu/megabuffer.h>
 #include "command_nodes.h"
 #include "common/spin_lock.h"
 
+namespace skyline::soc::host1x {
+    class Syncpoint;
+}
+
 namespace skyline::gpu::interconnect {
     constexpr bool EnableGpuCheckpoints{false}; //!< Whether to enable GPU debugging checkpoints (WILL DECREASE PERF SIGNIFICANTLY)
+    constexpr bool EnableGpuTimestampQueries{false}; //!< Whether to bracket every submission and render pass with timestamp queries and publish their GPU execution times as perfetto slices
+
+    /**
+     * @brief A set of timestamp queries which bracket a single submission and the render passes within it
+     * @note These are owned by the executor's pending resolution callback until they are resolved, so they can outlive the slot they were recorded into being reused
+     */
+    struct TimestampQueries {
+        static constexpr u32 MaxRenderPasses{255}; //!< The maximum amount of render passes within a submission that are timed, any further ones are not measured
+        static constexpr u32 QueryCount{2 + (MaxRenderPasses * 2)}; //!< The submission's begin and end queries followed by the begin and end queries of each render pass
+
+        vk::raii::QueryPool pool;
+        std::array<vk::Rect2D, MaxRenderPasses> renderAreas; //!< The render area of each timed render pass
+        u32 renderPassCount{}; //!< The amount of render passes timed in the current submission
+        size_t submissionNumber{}; //!< The submission number of the executor at the time these queries were recorded
+
+        TimestampQueries(GPU &gpu);
+
+        /**
+         * @brief Resets all queries and writes the submission's begin timestamp
+         */
+        void Begin(vk::raii::CommandBuffer &commandBuffer);
+
+        void BeginRenderPass(vk::raii::CommandBuffer &commandBuffer, vk::Rect2D renderArea);
+
+        void EndRenderPass(vk::raii::CommandBuffer &commandBuffer);
+
+        void End(vk::raii::CommandBuffer &commandBuffer);
+
+        /**
+         * @brief Reads back the query results and emits them as slices on the GPU timeline track
+         * @note This must only be called after the cycle the queries were submitted with has been signalled
+         */
+        void Resolve(GPU &gpu, const perfetto::Track &track);
+    };
 
     /*
      * @brief Thread responsible for recording Vulkan commands from the execution nodes and submitting them
@@ -39,7 +78,10 @@ namespace skyline::gpu::interconnect {
             vk::raii::Fence fence;
             vk::raii::Semaphore semaphore;
             std::shared_ptr<FenceCycle> cycle;
+            std::optional<vk::raii::QueryPool> timestampPool; //!< A pool of two timestamp queries written at the start and end of the command buffer to measure its GPU execution time, this is only present when the host GPU supports timestamps
+            std::shared_ptr<TimestampQueries> timestampQueries; //!< The queries timing the submission and its render passes, this is only set when EnableGpuTimestampQueries is true
             LinearAllocatorState<> allocator;
+            MegaBufferAllocator megaBufferAllocator; //!< The megabuffer used for all allocations made during this slot's execution, it's reclaimed as a whole when the slot is reset
             std::list<node::NodeVariant, LinearAllocator<node::NodeVariant>> nodes;
             std::list<node::NodeVariant, LinearAllocator<node::NodeVariant>> pendingPostRenderPassNodes;
             std::mutex beginLock;
@@ -48,14 +90,18 @@ namespace skyline::gpu::interconnect {
             bool ready{}; //!< If this slot's command buffer has had 'beginCommandBuffer' called and is ready to have commands recorded into it
             bool capture{}; //!< If this slot's Vulkan commands should be captured using the renderdoc API
             bool didWait{}; //!< If a wait of time longer than GrowThresholdNs occured when this slot was acquired
+            bool timestampsWritten{}; //!< If both timestamp queries were written in the last submission of this slot's command buffer
+            size_t submissionIndex{}; //!< The index of this slot's execution in submission order, this is assigned when the slot is released for recording
+            boost::container::small_vector<FenceCycle::TimelinePoint, 1> waitTimelinePoints; //!< The timeline points of uploads on the transfer queue that must complete before the slot's command buffer executes
 
             Slot(GPU &gpu);
 
             Slot(Slot &&other);
 
             /**
-             * @brief Waits on the fence and resets the command buffer
+             * @brief Waits on the fence, resets the command buffer and reclaims the megabuffer
              * @note A new fence cycle for the reset command buffer
+             * @note The GPU execution time of the prior submission is accounted for in the performance statistics and the frame counters
              */
             std::shared_ptr<FenceCycle> Reset(GPU &gpu);
 
@@ -69,23 +115,39 @@ namespace skyline::gpu::interconnect {
 
       private:
         static constexpr size_t GrowThresholdNs{constant::NsInMillisecond / 50}; //!< The wait time threshold at which the slot count will be increased
+        static constexpr size_t ParallelRecordThreadCount{2}; //!< The amount of threads slots are recorded on when parallel recording is enabled
         const DeviceState &state;
         CircularQueue<Slot *> incoming; //!< Slots pending recording
         CircularQueue<Slot *> outgoing; //!< Slots that have been submitted, may still be active on the GPU
-        std::list<Slot> slots;
-        std::atomic<bool> idle;
+        std::list<Slot> slots; //!< All slots, this must only be modified with `submissionMutex` held
+        std::atomic<u32> activeThreads{}; //!< The amount of threads currently processing a slot
+        std::atomic<u64> busyTime{}; //!< The time spent processing slots across all threads since the last call to ConsumeBusyTime
+        RENDERDOC_API_1_4_2 *renderDocApi{};
 
-        std::thread thread;
+        size_t nextReleaseIndex{}; //!< The submission index of the next slot to be released
+        size_t nextSubmissionIndex{}; //!< The submission index of the next slot to be submitted, recorded slots wait for their turn so submission order always matches release order
+        std::mutex submissionMutex;
+        std::condition_variable submissionCondition;
+
+        std::vector<std::thread> threads;
 
+        /**
+         * @brief Records the nodes of a slot into its command buffer and submits it once all slots released prior to it have been submitted
+         */
         void ProcessSlot(Slot *slot);
 
-        void Run();
+        void Run(size_t threadIndex);
 
       public:
         CommandRecordThread(const DeviceState &state);
 
         bool IsIdle() const;
 
+        /**
+         * @return The amount of time in nanoseconds spent processing slots since the last call to this, this is the sum across all record threads
+         */
+        u64 ConsumeBusyTime();
+
         /**
          * @return A free slot, `Reset` needs to be called before accessing it
          */
@@ -106,7 +168,9 @@ namespace skyline::gpu::interconnect {
         std::thread thread;
         SpinLock mutex;
         std::condition_variable_any condition;
-        std::queue<std::pair<std::shared_ptr<FenceCycle>, std::function<void()>>> pendingSignalQueue; //!< Queue of callbacks to be executed when their coressponding fence is signalled
+        using PendingSignal = std::pair<std::shared_ptr<FenceCycle>, std::function<void()>>;
+        std::vector<PendingSignal> pendingSignalQueue; //!< Queue of callbacks to be executed when their coressponding fence is signalled
+        std::vector<PendingSignal> processingSignalQueue; //!< The callbacks that are currently being processed by the thread, this is swapped with pendingSignalQueue to process callbacks in batches while retaining the allocations of both
         std::atomic<bool> idle{};
 
         void Run();
@@ -148,12 +212,22 @@ namespace skyline::gpu::interconnect {
         CommandRecordThread::Slot *slot{};
         ExecutionWaiterThread waiterThread;
         std::optional<CheckpointPollerThread> checkpointPollerThread;
+        static constexpr i64 FlushEvaluationPeriodNs{constant::NsInSecond / 60}; //!< The period over which idle times are measured before the adaptive flush threshold is adjusted, this corresponds to a frame at 60 FPS
+        static constexpr u32 MinAdaptiveFlushThreshold{32}; //!< The lowest flush threshold the adaptive heuristic will use, anything lower has submission overhead dominate
+        static constexpr u32 MaxAdaptiveFlushThreshold{1024}; //!< The highest flush threshold the adaptive heuristic will use
+        u32 flushThreshold; //!< The amount of nodes after which an execution is submitted early, this is adjusted at runtime when adaptive flushing is enabled
+        i64 lastFlushEvaluationTime{}; //!< The time at which the flush threshold was last evaluated
         node::RenderPassNode *renderPass{};
         std::list<node::NodeVariant, LinearAllocator<node::NodeVariant>>::iterator renderPassIt;
         size_t subpassCount{}; //!< The number of subpasses in the current render pass
         u32 renderPassIndex{};
+        size_t fullBarrierNodeCount{}; //!< The amount of nodes in the slot directly after the last full barrier, a full barrier with no nodes after the prior one is redundant
         bool preserveLocked{};
 
+        perfetto::Track gpuTimelineTrack; //!< The track GPU execution slices are emitted on when timestamp queries are enabled
+        SpinLock timestampQueriesMutex; //!< Synchronizes access to `freeTimestampQueries` from the waiter thread
+        std::vector<std::shared_ptr<TimestampQueries>> freeTimestampQueries; //!< Timestamp queries that have been resolved and can be reused
+
         /**
          * @brief A wrapper of a Texture object that has been locked beforehand and must be unlocked afterwards
          */
@@ -194,6 +268,21 @@ namespace skyline::gpu::interconnect {
         std::vector<LockedBuffer> preserveAttachedBuffers;
         std::vector<LockedBuffer> attachedBuffers; //!< All textures that are attached to the current execution
 
+        static constexpr size_t BufferViewCacheSize{64}; //!< The amount of entries in the buffer view cache, this must be a power of two
+
+        /**
+         * @brief A cached lookup of a guest mapping to the view of the buffer containing it
+         */
+        struct BufferViewCacheEntry {
+            u8 *address{};
+            size_t size{};
+            ContextTag executionTag{}; //!< The execution the lookup occurred in, the entry is stale in any other execution as the buffer might not be attached to it
+            u32 sequenceNumber{}; //!< The sequence number of the buffer at the time of the lookup, the entry is stale if the buffer has been modified since
+            BufferView view;
+        };
+
+        std::array<BufferViewCacheEntry, BufferViewCacheSize> bufferViewCache{}; //!< A direct-mapped cache of the most recent buffer lookups, this allows repeated binds of the same mappings to avoid going through the buffer manager
+
 
         std::vector<vk::ImageView> lastSubpassInputAttachments; //!< The set of input attachments used in the last subpass
         std::vector<vk::ImageView> lastSubpassColorAttachments; //!< The set of color attachments used in the last subpass
@@ -203,11 +292,18 @@ namespace skyline::gpu::interconnect {
         std::vector<std::function<void()>> pipelineChangeCallbacks; //!< Set of persistent callbacks that will be called after any non-Maxwell 3D engine changes the active pipeline
 
         std::vector<std::function<void()>> pendingDeferredActions;
+        std::vector<std::pair<soc::host1x::Syncpoint *, u32>> pendingSyncpointFences; //!< Host syncpoints that will reach the paired value upon completion of the current execution, see AddSyncpointFence
 
         u32 nextCheckpointId{}; //!< The ID of the next debug checkpoint to be allocated
 
         void RotateRecordSlot();
 
+        /**
+         * @brief Adjusts the flush threshold based on how long the GPU and record thread spent idle over the last evaluation period
+         * @note The GPU being starved of work implies that the emulated GPU is blocked on recording or submission, earlier flushes allow it to begin work sooner while a GPU that's always busy can absorb larger batches with less submission overhead
+         */
+        void UpdateFlushThreshold();
+
         /**
          * @brief Create a new render pass and subpass with the specified attachments, if one doesn't already exist or the current one isn't compatible
          * @param noSubpassCreation Forces creation of a renderpass when a new subpass would otherwise be created
@@ -221,6 +317,21 @@ namespace skyline::gpu::interconnect {
          */
         void FinishRenderPass();
 
+        /**
+         * @brief The bounds of a render pass in the node list of the current slot
+         */
+        struct RenderPassRange {
+            std::list<node::NodeVariant, LinearAllocator<node::NodeVariant>>::iterator begin; //!< The RenderPassNode beginning the render pass
+            std::list<node::NodeVariant, LinearAllocator<node::NodeVariant>>::iterator end; //!< The RenderPassEndNode ending the render pass
+        };
+        std::vector<RenderPassRange> renderPassRanges; //!< Scratch storage for the render passes in an execution, this is retained to avoid reallocations
+
+        /**
+         * @brief Optimizes the load and store operations of directly adjacent render passes in the current execution
+         * @note Render passes which only clear attachments are folded into the following render pass with VK_ATTACHMENT_LOAD_OP_CLEAR and attachments which are entirely cleared by the following render pass aren't stored, these avoid tile loads and stores which dominate bandwidth on tiling GPUs
+         */
+        void OptimizeRenderPasses();
+
         /**
          * @brief Execute all the nodes and submit the resulting command buffer to the GPU
          * @note It is the responsibility of the caller to handle resetting of command buffers, fence cycle and megabuffers
@@ -234,6 +345,18 @@ namespace skyline::gpu::interconnect {
 
         void AttachBufferBase(std::shared_ptr<Buffer> buffer);
 
+        void AddSubpassNode(node::SubpassFunctionNode &&function, vk::Rect2D renderArea, span<TextureView *> sampledImages, span<TextureView *> inputAttachments, span<TextureView *> colorAttachments, TextureView *depthStencilAttachment, bool noSubpassCreation, vk::PipelineStageFlags srcStageMask, vk::PipelineStageFlags dstStageMask);
+
+        void AddOutsideRpCommandNode(node::FunctionNode &&function);
+
+        void AddCommandNode(node::FunctionNode &&function);
+
+        void InsertPreExecuteCommandNode(node::FunctionNode &&function);
+
+        void InsertPreRpCommandNode(node::FunctionNode &&function);
+
+        void InsertPostRpCommandNode(node::FunctionNode &&function);
+
         /**
          * @brief Non-gated implementation of `AddCheckpoint`
          */
@@ -242,6 +365,7 @@ namespace skyline::gpu::interconnect {
       public:
         std::shared_ptr<FenceCycle> cycle; //!< The fence cycle that this command executor uses to wait for the GPU to finish executing commands
         LinearAllocatorState<> *allocator;
+        MegaBufferAllocator *megaBufferAllocator; //!< The megabuffer allocator of the current slot, any megabuffer allocations made with `cycle` should use this
         ContextTag tag; //!< The tag associated with this command executor, any tagged resource locking must utilize this tag
         size_t submissionNumber{};
         ContextTag executionTag{};
@@ -254,11 +378,12 @@ namespace skyline::gpu::interconnect {
 
         /**
          * @brief Attach the lifetime of the texture to the command buffer
+         * @param overwrite If the first usage of the texture within this execution entirely overwrites all of its subresources, its contents don't need to be uploaded if it has no backing yet
          * @return If this is the first usage of the backing of this resource within this execution
          * @note The supplied texture will be locked automatically until the command buffer is submitted and must **not** be locked by the caller
          * @note This'll automatically handle syncing of the texture in the most optimal way possible
          */
-        bool AttachTexture(TextureView *view);
+        bool AttachTexture(TextureView *view, bool overwrite = false);
 
         /**
          * @brief Attach the lifetime of a buffer view to the command buffer
@@ -268,6 +393,16 @@ namespace skyline::gpu::interconnect {
          */
         bool AttachBuffer(BufferView &view);
 
+        /**
+         * @return A view of the supplied mapping that was looked up earlier during the current execution, if there is none then an empty view is returned
+         */
+        BufferView LookupCachedBufferView(span<u8> mapping);
+
+        /**
+         * @brief Caches the view of a mapping for lookups during the current execution
+         */
+        void CacheBufferView(span<u8> mapping, const BufferView &view);
+
         /**
          * @brief Attach the lifetime of a buffer view that's already locked to the command buffer
          * @note The supplied buffer **must** be locked with the executor's tag
@@ -294,7 +429,10 @@ namespace skyline::gpu::interconnect {
          * @param exclusiveSubpass If this subpass should be the only subpass in a render pass
          * @note Any supplied texture should be attached prior and not undergo any persistent layout transitions till execution
          */
-        void AddSubpass(std::function<void(vk::raii::CommandBuffer &, const std::shared_ptr<FenceCycle> &, GPU &, vk::RenderPass, u32)> &&function, vk::Rect2D renderArea, span<TextureView *> sampledImages, span<TextureView *> inputAttachments = {}, span<TextureView *> colorAttachments = {}, TextureView *depthStencilAttachment = {}, bool noSubpassCreation = false, vk::PipelineStageFlags srcStageMask = {}, vk::PipelineStageFlags dstStageMask = {});
+        template<typename FunctionType>
+        void AddSubpass(FunctionType &&function, vk::Rect2D renderArea, span<TextureView *> sampledImages, span<TextureView *> inputAttachments = {}, span<TextureView *> colorAttachments = {}, TextureView *depthStencilAttachment = {}, bool noSubpassCreation = false, vk::PipelineStageFlags srcStageMask = {}, vk::PipelineStageFlags dstStageMask = {}) {
+            AddSubpassNode(node::SubpassFunctionNode{*allocator, std::forward<FunctionType>(function)}, renderArea, sampledImages, inputAttachments, colorAttachments, depthStencilAttachment, noSubpassCreation, srcStageMask, dstStageMask);
+        }
 
         /**
          * @brief Adds a subpass that clears the entirety of the specified attachment with a color value, it may utilize VK_ATTACHMENT_LOAD_OP_CLEAR for a more efficient clear when possible
@@ -308,33 +446,65 @@ namespace skyline::gpu::interconnect {
          */
         void AddClearDepthStencilSubpass(TextureView *attachment, const vk::ClearDepthStencilValue &value);
 
+        /**
+         * @brief Clears a region of attachments bound to the current subpass with vkCmdClearAttachments, this avoids starting a new subpass or render pass for the clear
+         * @param attachments The attachments to clear, each corresponding to an entry in `clearAttachments` which will have its color attachment index filled in
+         * @param clearRect The region to clear in the coordinates of the attachments, it must lie within the render area of the current render pass
+         * @return If the clear could be recorded, this is only the case when all attachments are bound to the current subpass
+         * @note Any supplied texture should be attached prior and not undergo any persistent layout transitions till execution
+         */
+        bool AddInlineClear(span<TextureView *> attachments, span<const vk::ClearAttachment> clearAttachments, const vk::ClearRect &clearRect);
+
+        /**
+         * @return The amount of nodes recorded in the current execution, this can be compared against a prior value alongside `executionTag` to determine if any nodes were recorded since
+         */
+        size_t GetNodeCount() {
+            return slot->nodes.size();
+        }
+
         /**
          * @brief Adds a command that needs to be executed outside the scope of a render pass
          */
-        void AddOutsideRpCommand(std::function<void(vk::raii::CommandBuffer &, const std::shared_ptr<FenceCycle> &, GPU &)> &&function);
+        template<typename FunctionType>
+        void AddOutsideRpCommand(FunctionType &&function) {
+            AddOutsideRpCommandNode(node::FunctionNode{*allocator, std::forward<FunctionType>(function)});
+        }
 
         /**
          * @brief Adds a command that can be executed inside or outside of an RP
          */
-        void AddCommand(std::function<void(vk::raii::CommandBuffer &, const std::shared_ptr<FenceCycle> &, GPU &)> &&function);
+        template<typename FunctionType>
+        void AddCommand(FunctionType &&function) {
+            AddCommandNode(node::FunctionNode{*allocator, std::forward<FunctionType>(function)});
+        }
 
         /**
          * @brief Inserts the input command into the node list at the beginning of the execution
          */
-        void InsertPreExecuteCommand(std::function<void(vk::raii::CommandBuffer &, const std::shared_ptr<FenceCycle> &, GPU &)> &&function);
+        template<typename FunctionType>
+        void InsertPreExecuteCommand(FunctionType &&function) {
+            InsertPreExecuteCommandNode(node::FunctionNode{*allocator, std::forward<FunctionType>(function)});
+        }
 
         /**
          * @brief Inserts the input command into the node list before the current RP begins (or immediately if not in an RP)
          */
-        void InsertPreRpCommand(std::function<void(vk::raii::CommandBuffer &, const std::shared_ptr<FenceCycle> &, GPU &)> &&function);
+        template<typename FunctionType>
+        void InsertPreRpCommand(FunctionType &&function) {
+            InsertPreRpCommandNode(node::FunctionNode{*allocator, std::forward<FunctionType>(function)});
+        }
 
         /**
          * @brief Inserts the input command into the node list after the current RP (or execution) finishes
          */
-        void InsertPostRpCommand(std::function<void(vk::raii::CommandBuffer &, const std::shared_ptr<FenceCycle> &, GPU &)> &&function);
+        template<typename FunctionType>
+        void InsertPostRpCommand(FunctionType &&function) {
+            InsertPostRpCommandNode(node::FunctionNode{*allocator, std::forward<FunctionType>(function)});
+        }
 
         /**
          * @brief Adds a full pipeline barrier to the command buffer
+         * @note This is a no-op if no nodes were added since the last full barrier (or the start of the execution, which always begins with one)
          */
         void AddFullBarrier();
 
@@ -355,6 +525,11 @@ namespace skyline::gpu::interconnect {
 
         std::optional<u32> GetRenderPassIndex();
 
+        /**
+         * @return An opaque identifier for the most recently appended node in the current execution, if this is unchanged between two calls during the same execution then no nodes were appended in-between
+         */
+        const void *GetLastNode();
+
         /**
          * @brief Records a checkpoint into the GPU command stream at the current
          * @param annotation A string annotation to display in perfetto for this checkpoint
@@ -367,6 +542,21 @@ namespace skyline::gpu::interconnect {
                 return 0;
         }
 
+        /**
+         * @brief The bounds of a render pass in the node list of the current slot
+         */
+        struct RenderPassRange {
+            std::list<node::NodeVariant, LinearAllocator<node::NodeVariant>>::iterator begin; //!< The RenderPassNode beginning the render pass
+            std::list<node::NodeVariant, LinearAllocator<node::NodeVariant>>::iterator end; //!< The RenderPassEndNode ending the render pass
+        };
+        std::vector<RenderPassRange> renderPassRanges; //!< Scratch storage for the render passes in an execution, this is retained to avoid reallocations
+
+        /**
+         * @brief Optimizes the load and store operations of directly adjacent render passes in the current execution
+         * @note Render passes which only clear attachments are folded into the following render pass with VK_ATTACHMENT_LOAD_OP_CLEAR and attachments which are entirely cleared by the following render pass aren't stored, these avoid tile loads and stores which dominate bandwidth on tiling GPUs
+         */
+        void OptimizeRenderPasses();
+
         /**
          * @brief Execute all the nodes and submit the resulting command buffer to the GPU
          * @param callback A function to call upon GPU completion of the submission
@@ -379,6 +569,12 @@ namespace skyline::gpu::interconnect {
          */
         void AddDeferredAction(std::function<void()> &&callback);
 
+        /**
+         * @brief Attaches the cycle of the current execution to the supplied host syncpoint once it's submitted, waits for the syncpoint to reach the threshold can then wait on the host GPU directly
+         * @note This should accompany a deferred action that increments the syncpoint to the threshold, it has no effect when DMI is off as deferred actions are executed after submission then
+         */
+        void AddSyncpointFence(soc::host1x::Syncpoint &syncpoint, u32 threshold);
+
         /**
          * @brief Locks all preserve attached buffers/textures
          * @note This **MUST** be called before attaching any buffers/textures to an execution
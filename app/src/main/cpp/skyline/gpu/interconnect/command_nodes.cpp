@@ -9,11 +9,12 @@ namespace skyline::gpu::interconnect::node {
     RenderPassNode::RenderPassNode(vk::Rect2D renderArea) : renderArea{renderArea} {}
 
     u32 RenderPassNode::AddAttachment(TextureView *view, GPU &gpu) {
-        auto vkView{view->GetView()};
+        auto vkView{view->GetAttachmentView()};
         auto attachment{std::find(attachments.begin(), attachments.end(), vkView)};
         if (attachment == attachments.end()) {
             // If we cannot find any matches for the specified attachment, we add it as a new one
             attachments.push_back(vkView);
+            attachmentTextures.push_back(view->texture.get());
 
             if (gpu.traits.supportsImagelessFramebuffers)
                 attachmentInfo.push_back(vk::FramebufferAttachmentImageInfo{
@@ -33,6 +34,11 @@ namespace skyline::gpu::interconnect::node {
                 .flags = vk::AttachmentDescriptionFlagBits::eMayAlias
             });
 
+            if (view->range.baseMipLevel == 0 && view->range.layerCount == 1 && view->texture->dimensions.depth == 1)
+                attachmentExtents.push_back(view->texture->dimensions);
+            else
+                attachmentExtents.push_back(vk::Extent2D{std::numeric_limits<u32>::max(), std::numeric_limits<u32>::max()});
+
             if (auto usage{view->texture->GetLastRenderPassUsage()}; usage != texture::RenderPassUsage::None) {
                 vk::PipelineStageFlags attachmentDstStageMask{};
                 if (view->format->vkAspect & vk::ImageAspectFlagBits::eColor)
@@ -219,6 +225,76 @@ namespace skyline::gpu::interconnect::node {
         return false;
     }
 
+    bool RenderPassNode::FoldClearsInto(RenderPassNode &next) {
+        if (subpassDescriptions.size() != 1 || renderArea != next.renderArea)
+            return false;
+
+        // Every cleared attachment must be used by the following render pass for the clear to be folded into it, attachments which are only loaded aren't modified by this render pass
+        for (size_t i{}; i < attachments.size(); i++)
+            if (attachmentDescriptions[i].loadOp == vk::AttachmentLoadOp::eClear && std::find(next.attachments.begin(), next.attachments.end(), attachments[i]) == next.attachments.end())
+                return false;
+
+        for (size_t i{}; i < attachments.size(); i++) {
+            if (attachmentDescriptions[i].loadOp != vk::AttachmentLoadOp::eClear)
+                continue;
+
+            auto nextIndex{static_cast<u32>(std::distance(next.attachments.begin(), std::find(next.attachments.begin(), next.attachments.end(), attachments[i])))};
+            auto &nextDescription{next.attachmentDescriptions[nextIndex]};
+            if (nextDescription.loadOp != vk::AttachmentLoadOp::eLoad)
+                continue; // The following render pass clearing the attachment itself supersedes this clear
+
+            nextDescription.loadOp = vk::AttachmentLoadOp::eClear;
+            next.clearValues.resize(std::max<size_t>(next.clearValues.size(), nextIndex + 1));
+            next.clearValues[nextIndex] = clearValues[i];
+        }
+
+        next.UpdateDependency(dependencySrcStageMask, dependencyDstStageMask);
+        return true;
+    }
+
+    void RenderPassNode::DiscardOverwrittenAttachments(const RenderPassNode &next) {
+        if (next.renderArea.offset.x != 0 || next.renderArea.offset.y != 0)
+            return;
+
+        for (size_t i{}; i < attachments.size(); i++) {
+            auto nextAttachment{std::find(next.attachments.begin(), next.attachments.end(), attachments[i])};
+            if (nextAttachment == next.attachments.end())
+                continue;
+
+            if (next.renderArea.extent.width < attachmentExtents[i].width || next.renderArea.extent.height < attachmentExtents[i].height)
+                continue; // The clear doesn't cover the entire attachment so the contents outside the render area must be preserved
+
+            // Depth and stencil are cleared independently, an attachment's stencil contents must be stored unless the stencil is cleared alongside the depth
+            const auto &nextDescription{next.attachmentDescriptions[static_cast<size_t>(std::distance(next.attachments.begin(), nextAttachment))]};
+            if (nextDescription.loadOp == vk::AttachmentLoadOp::eClear)
+                attachmentDescriptions[i].storeOp = vk::AttachmentStoreOp::eDontCare;
+            if (nextDescription.stencilLoadOp == vk::AttachmentLoadOp::eClear)
+                attachmentDescriptions[i].stencilStoreOp = vk::AttachmentStoreOp::eDontCare;
+        }
+    }
+
+    void RenderPassNode::UpdateTransientAttachments() {
+        bool coversOrigin{renderArea.offset.x == 0 && renderArea.offset.y == 0};
+        for (size_t i{}; i < attachments.size(); i++) {
+            const auto &description{attachmentDescriptions[i]};
+            bool cleared{coversOrigin && renderArea.extent.width >= attachmentExtents[i].width && renderArea.extent.height >= attachmentExtents[i].height};
+            cleared &= description.loadOp != vk::AttachmentLoadOp::eLoad;
+            if (attachmentTextures[i]->format->vkAspect & vk::ImageAspectFlagBits::eStencil)
+                cleared &= description.stencilLoadOp != vk::AttachmentLoadOp::eLoad;
+
+            attachmentTextures[i]->UpdateAttachmentUsage(cleared);
+        }
+    }
+
+    void RenderPassNode::DiscardTransientAttachments() {
+        for (size_t i{}; i < attachments.size(); i++) {
+            if (attachmentTextures[i]->HasTransientBacking()) {
+                attachmentDescriptions[i].storeOp = vk::AttachmentStoreOp::eDontCare;
+                attachmentDescriptions[i].stencilStoreOp = vk::AttachmentStoreOp::eDontCare;
+            }
+        }
+    }
+
     vk::RenderPass RenderPassNode::operator()(vk::raii::CommandBuffer &commandBuffer, const std::shared_ptr<FenceCycle> &cycle, GPU &gpu) {
         auto preserveAttachmentIt{preserveAttachmentReferences.begin()};
         for (auto &subpassDescription : subpassDescriptions) {
@@ -250,7 +326,7 @@ namespace skyline::gpu::interconnect::node {
             .pSubpasses = subpassDescriptions.data(),
             .dependencyCount = static_cast<u32>(subpassDependencies.size()),
             .pDependencies = subpassDependencies.data(),
-        })};
+        }, cycle)};
 
         auto useImagelessFramebuffer{gpu.traits.supportsImagelessFramebuffers};
         cache::FramebufferCreateInfo framebufferCreateInfo{
@@ -272,7 +348,7 @@ namespace skyline::gpu::interconnect::node {
         if (!useImagelessFramebuffer)
             framebufferCreateInfo.unlink<vk::FramebufferAttachmentsCreateInfo>();
 
-        auto framebuffer{gpu.framebufferCache.GetFramebuffer(framebufferCreateInfo)};
+        auto framebuffer{gpu.framebufferCache.GetFramebuffer(framebufferCreateInfo, cycle)};
 
         vk::StructureChain<vk::RenderPassBeginInfo, vk::RenderPassAttachmentBeginInfo> renderPassBeginInfo{
             vk::RenderPassBeginInfo{
@@ -3,21 +3,55 @@
 
 #pragma once
 
+#include <common/linear_allocator.h>
 #include <gpu.h>
 
 namespace skyline::gpu::interconnect::node {
+    template<typename FunctionSignature = void(vk::raii::CommandBuffer &, const std::shared_ptr<FenceCycle> &, GPU &)>
+    struct FunctionNodeBase;
+
     /**
      * @brief A generic node for simply executing a function
+     * @note The function object is placed into the execution's linear allocator rather than being type-erased by std::function, this avoids any heap allocations for captured state and only costs a single indirect call on execution
      */
-    template<typename FunctionSignature = void(vk::raii::CommandBuffer &, const std::shared_ptr<FenceCycle> &, GPU &)>
-    struct FunctionNodeBase {
-        std::function<FunctionSignature> function;
+    template<typename... Args>
+    struct FunctionNodeBase<void(Args...)> {
+      private:
+        void *object; //!< The function object inside the linear allocator
+        void (*invoke)(void *object, Args... args);
+        void (*destroy)(void *object); //!< Destroys the function object, this is nullptr for trivially destructible objects
 
-        FunctionNodeBase(std::function<FunctionSignature> &&function) : function(function) {}
+      public:
+        /**
+         * @note The allocator must outlive the node, linear allocators are only reset after all nodes referencing them have been destroyed
+         */
+        template<typename FunctionType>
+        FunctionNodeBase(LinearAllocatorState<> &allocator, FunctionType &&function) {
+            using StoredType = std::remove_cvref_t<FunctionType>;
+            object = allocator.EmplaceUntracked<StoredType>(std::forward<FunctionType>(function));
+            invoke = [](void *object, Args... args) {
+                (*static_cast<StoredType *>(object))(std::forward<Args>(args)...);
+            };
+
+            if constexpr (std::is_trivially_destructible_v<StoredType>)
+                destroy = nullptr;
+            else
+                destroy = [](void *object) { std::destroy_at(static_cast<StoredType *>(object)); };
+        }
+
+        FunctionNodeBase(const FunctionNodeBase &) = delete;
+
+        FunctionNodeBase &operator=(const FunctionNodeBase &) = delete;
+
+        FunctionNodeBase(FunctionNodeBase &&other) : object{other.object}, invoke{other.invoke}, destroy{std::exchange(other.destroy, nullptr)} {}
+
+        ~FunctionNodeBase() {
+            if (destroy)
+                destroy(object);
+        }
 
-        template<class... Args>
-        void operator()(Args &&... args) {
-            function(std::forward<Args>(args)...);
+        void operator()(Args... args) {
+            invoke(object, std::forward<Args>(args)...);
         }
     };
 
@@ -29,8 +63,10 @@ namespace skyline::gpu::interconnect::node {
     struct RenderPassNode {
       private:
         std::vector<vk::ImageView> attachments;
+        std::vector<Texture *> attachmentTextures; //!< The texture backing each attachment
         std::vector<vk::FramebufferAttachmentImageInfo> attachmentInfo;
         std::vector<vk::AttachmentDescription> attachmentDescriptions;
+        std::vector<vk::Extent2D> attachmentExtents; //!< The extent a render area must cover to overwrite the entire contents of each attachment, this is the maximum extent for attachments which can't be entirely overwritten by a single-layer framebuffer
 
         std::vector<vk::AttachmentReference> attachmentReferences;
         std::vector<std::vector<u32>> preserveAttachmentReferences; //!< Any attachment that must be preserved to be utilized by a future subpass, these are stored per-subpass to ensure contiguity
@@ -87,6 +123,30 @@ namespace skyline::gpu::interconnect::node {
          */
         bool ClearDepthStencilAttachment(const vk::ClearDepthStencilValue &value, GPU& gpu);
 
+        /**
+         * @brief Folds all attachment clears performed by this render pass into the render pass directly following it, this avoids a round-trip of the attachments through memory on tiling GPUs
+         * @note This must only be used on render passes which don't contain any commands, they can be dropped entirely after this succeeds
+         * @return If the clears could be folded into the following render pass, neither render pass is modified otherwise
+         */
+        bool FoldClearsInto(RenderPassNode &next);
+
+        /**
+         * @brief Discards rather than stores the contents of any attachments that are entirely cleared by the render pass directly following this one
+         */
+        void DiscardOverwrittenAttachments(const RenderPassNode &next);
+
+        /**
+         * @brief Informs the textures backing all attachments about whether their contents are entirely cleared by the render pass, this determines if they can use transient backings
+         * @note This must be called after all render pass optimizations that can affect load operations
+         */
+        void UpdateTransientAttachments();
+
+        /**
+         * @brief Discards rather than stores the contents of any attachments with transient backings as they can't be read outside of the render pass
+         * @note This must be called after UpdateTransientAttachments has been called for all render passes in the execution as it could revert transient backings
+         */
+        void DiscardTransientAttachments();
+
         vk::RenderPass operator()(vk::raii::CommandBuffer &commandBuffer, const std::shared_ptr<FenceCycle> &cycle, GPU &gpu);
     };
 
@@ -107,6 +167,8 @@ namespace skyline::gpu::interconnect::node {
     struct NextSubpassFunctionNode : private SubpassFunctionNode {
         using SubpassFunctionNode::SubpassFunctionNode;
 
+        NextSubpassFunctionNode(SubpassFunctionNode &&node) : SubpassFunctionNode{std::move(node)} {}
+
         void operator()(vk::raii::CommandBuffer &commandBuffer, const std::shared_ptr<FenceCycle> &cycle, GPU &gpu, vk::RenderPass renderPass, u32 subpassIndex) {
             commandBuffer.nextSubpass(vk::SubpassContents::eInline);
             SubpassFunctionNode::operator()(commandBuffer, cycle, gpu, renderPass, subpassIndex);
@@ -36,10 +36,15 @@ namespace skyline::gpu::interconnect {
             if (view = view.GetBuffer()->TryGetView(viewMapping); view)
                 return;
 
+        // Then attempt to reuse a view for the same mapping from a lookup earlier in the execution
+        if (view = ctx.executor.LookupCachedBufferView(viewMapping); view)
+            return;
+
         // Otherwise perform a full lookup
         view = ctx.gpu.buffer.FindOrCreate(viewMapping, ctx.executor.tag, [&ctx](std::shared_ptr<Buffer> buffer, ContextLock<Buffer> &&lock) {
             ctx.executor.AttachLockedBuffer(buffer, std::move(lock));
         });
+        ctx.executor.CacheBufferView(viewMapping, view);
     }
 
     void CachedMappedBufferView::PurgeCaches() {
@@ -56,4 +61,30 @@ namespace skyline::gpu::interconnect {
         ContextLock lock{executor.tag, view};
         view.Read(lock.IsFirstUsage(), FlushHostCallback, dstBuffer, srcOffset);
     }
+
+    void MakeDescriptorSetKey(const DescriptorUpdateInfo &updateInfo, std::vector<u64> &key) {
+        key.clear();
+        key.push_back(reinterpret_cast<u64>(static_cast<VkDescriptorSetLayout>(updateInfo.descriptorSetLayout)));
+
+        for (const auto &dynamicBinding : updateInfo.bufferDescDynamicBindings) {
+            if (auto view{std::get_if<BufferView>(&dynamicBinding)}) {
+                auto [delegate, offset]{view->GetDelegateRegion()};
+                key.insert(key.end(), {1, reinterpret_cast<u64>(delegate), offset, view->size});
+            } else if (auto binding{std::get_if<BufferBinding>(&dynamicBinding)}) {
+                key.insert(key.end(), {2, reinterpret_cast<u64>(static_cast<VkBuffer>(binding->buffer)), binding->offset, binding->size});
+            } else {
+                key.push_back(0);
+            }
+        }
+
+        for (const auto &imageDesc : updateInfo.imageDescs)
+            key.insert(key.end(), {reinterpret_cast<u64>(static_cast<VkSampler>(imageDesc.sampler)), reinterpret_cast<u64>(static_cast<VkImageView>(imageDesc.imageView)), static_cast<u64>(imageDesc.imageLayout)});
+
+        // The sizes of all inline uniform blocks are fixed by the layout so their contents can be appended as-is
+        if (!updateInfo.inlineUniformBlockData.empty()) {
+            size_t keyOffset{key.size()};
+            key.resize(keyOffset + util::DivideCeil(updateInfo.inlineUniformBlockData.size(), sizeof(u64)));
+            std::memcpy(key.data() + keyOffset, updateInfo.inlineUniformBlockData.data(), updateInfo.inlineUniformBlockData.size());
+        }
+    }
 }
@@ -93,9 +93,19 @@ namespace skyline::gpu::interconnect {
         span<vk::WriteDescriptorSet> writes;
         span<vk::DescriptorBufferInfo> bufferDescs;
         span<DynamicBufferBinding> bufferDescDynamicBindings;
+        span<vk::DescriptorImageInfo> imageDescs; //!< Only populated for full updates, this is used to identify the contents of the descriptor set
+        void *descriptorData{}; //!< The contiguous backing of `bufferDescs`, `imageDescs` and `inlineUniformBlockData` for full updates
+        span<u8> inlineUniformBlockData; //!< The contents of all inline uniform blocks, only populated for full updates, this is used to identify the contents of the descriptor set
+        vk::DescriptorUpdateTemplate updateTemplate{}; //!< If non-null, this is used with `descriptorData` to perform the writes rather than `writes`
         vk::PipelineLayout pipelineLayout;
         vk::DescriptorSetLayout descriptorSetLayout;
         vk::PipelineBindPoint bindPoint;
         u32 descriptorSetIndex;
     };
+
+    /**
+     * @brief Fills `key` with a key that identifies the contents of the descriptor set written by a full descriptor update
+     * @note Any buffer views in the update are keyed by their delegate, they'll resolve to the same binding during recording as all views are resolved at the same point
+     */
+    void MakeDescriptorSetKey(const DescriptorUpdateInfo &updateInfo, std::vector<u64> &key);
 }
@@ -0,0 +1,86 @@
+// SPDX-License-Identifier: MPL-2.0
+// Copyright © 2022 Skyline Team and Contributors (https://github.com/skyline-emu/)
+
+#include <gpu.h>
+#include "pool_write_trap.h"
+
+namespace skyline::gpu::interconnect {
+    void PoolWriteTrap::Release() {
+        if (trapHandle)
+            nce->DeleteTrap(*trapHandle);
+
+        trapHandle.reset();
+        region = {};
+
+        std::scoped_lock lock{writeMutex};
+        writtenPages.clear();
+        allWritten = false;
+    }
+
+    PoolWriteTrap::~PoolWriteTrap() {
+        Release();
+    }
+
+    void PoolWriteTrap::Trap(InterconnectContext &ctx, span<u8> pool) {
+        Release();
+        if (pool.empty())
+            return;
+
+        nce = ctx.gpu.state.nce.get();
+        region = pool;
+
+        std::array<span<u8>, 1> regions{pool};
+        trapHandle = nce->CreateTrap(regions, [] {}, [] {
+            return true;
+        }, [this] {
+            std::unique_lock lock{writeMutex, std::try_to_lock};
+            if (!lock)
+                return false;
+
+            allWritten = true;
+            return true;
+        }, [this](span<u8> pages) {
+            std::unique_lock lock{writeMutex, std::try_to_lock};
+            if (!lock)
+                return false;
+
+            writtenPages.push_back(pages);
+            return true;
+        });
+        nce->TrapRegions(*trapHandle, true);
+    }
+
+    void PoolWriteTrap::Collect(const std::function<void(size_t, size_t)> &callback) {
+        if (!trapHandle)
+            return;
+
+        auto reportPages{[&](span<u8> pages) {
+            auto start{std::max(pages.data(), region.data())}, end{std::min(pages.end().base(), region.end().base())};
+            if (start < end)
+                callback(static_cast<size_t>(start - region.data()), static_cast<size_t>(end - start));
+        }};
+
+        // Writes that were tracked by the kernel rather than trapped don't invoke any callbacks so they need to be explicitly collected
+        nce->CollectTrapWrites(*trapHandle, reportPages);
+
+        std::vector<span<u8>> pages;
+        bool all;
+        {
+            std::scoped_lock lock{writeMutex};
+            pages.swap(writtenPages);
+            all = std::exchange(allWritten, false);
+        }
+
+        // The pages are retrapped prior to being reported so that any writes after this point are observed by the next collection
+        if (all) {
+            nce->TrapRegions(*trapHandle, true);
+            callback(0, region.size());
+            return;
+        }
+
+        for (auto page : pages) {
+            nce->TrapRegions(*trapHandle, page, true);
+            reportPages(page);
+        }
+    }
+}
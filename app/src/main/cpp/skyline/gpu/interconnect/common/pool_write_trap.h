@@ -0,0 +1,53 @@
+// SPDX-License-Identifier: MPL-2.0
+// Copyright © 2022 Skyline Team and Contributors (https://github.com/skyline-emu/)
+
+#pragma once
+
+#include <common/spin_lock.h>
+#include <nce.h>
+#include "common.h"
+
+namespace skyline::gpu::interconnect {
+    /**
+     * @brief Tracks guest writes to a descriptor pool (TIC/TSC) with a write trap, this allows cached per-index state to only be revalidated for entries that could have been written
+     */
+    class PoolWriteTrap {
+      private:
+        nce::NCE *nce{};
+        std::optional<nce::NCE::TrapHandle> trapHandle;
+        span<u8> region; //!< The currently trapped pool region
+        SpinLock writeMutex; //!< Synchronizes access to the written state from the trap callbacks
+        std::vector<span<u8>> writtenPages; //!< Pages of the pool that were written to since the last collection
+        bool allWritten{}; //!< If the entire pool has to be assumed to be written, this occurs when the trap couldn't be page-granular
+
+        void Release();
+
+      public:
+        PoolWriteTrap() = default;
+
+        PoolWriteTrap(const PoolWriteTrap &) = delete;
+
+        PoolWriteTrap &operator=(const PoolWriteTrap &) = delete;
+
+        ~PoolWriteTrap();
+
+        /**
+         * @return If the supplied pool is the one currently being trapped
+         */
+        bool IsTrapping(span<u8> pool) const {
+            return trapHandle && region.data() == pool.data() && region.size() == pool.size();
+        }
+
+        /**
+         * @brief Starts trapping writes to the supplied pool, any previously trapped pool stops being trapped
+         * @note All entries of the pool must be assumed to be written prior to this
+         */
+        void Trap(InterconnectContext &ctx, span<u8> pool);
+
+        /**
+         * @brief Supplies all regions of the pool that were written to since the last collection and retraps them
+         * @param callback A function that's called with the byte offset and size of every potentially written region within the pool
+         */
+        void Collect(const std::function<void(size_t, size_t)> &callback);
+    };
+}
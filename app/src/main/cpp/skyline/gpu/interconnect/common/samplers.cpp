@@ -37,7 +37,23 @@ namespace skyline::gpu::interconnect {
 
     void Samplers::MarkAllDirty() {
         samplerPool.MarkDirty(true);
-        std::fill(texSamplerCache.begin(), texSamplerCache.end(), nullptr);
+    }
+
+    void Samplers::SyncPoolWrites(InterconnectContext &ctx, span<TextureSamplerControl> texSamplers) {
+        poolSyncSequenceNumber = ctx.channelCtx.channelSequenceNumber;
+
+        auto pool{texSamplers.cast<u8>()};
+        if (!poolWriteTrap.IsTrapping(pool)) {
+            poolWriteTrap.Trap(ctx, pool);
+            std::fill(texSamplerCache.begin(), texSamplerCache.end(), nullptr);
+            return;
+        }
+
+        poolWriteTrap.Collect([this](size_t offset, size_t size) {
+            auto begin{texSamplerCache.begin() + static_cast<ptrdiff_t>(offset / sizeof(TextureSamplerControl))};
+            auto end{texSamplerCache.begin() + static_cast<ptrdiff_t>(util::DivideCeil(offset + size, sizeof(TextureSamplerControl)))};
+            std::fill(begin, end, nullptr);
+        });
     }
 
     static vk::Filter ConvertSamplerFilter(TextureSamplerControl::Filter filter) {
@@ -155,10 +171,15 @@ namespace skyline::gpu::interconnect {
         if (texSamplers.size() != texSamplerCache.size()) {
             texSamplerCache.resize(texSamplers.size());
             std::fill(texSamplerCache.begin(), texSamplerCache.end(), nullptr);
-        } else if (texSamplerCache[index]) {
-            return texSamplerCache[index];
         }
 
+        // Guest writes to the pool are only collected once per channel sequence as the pool isn't expected to change in between
+        if (poolSyncSequenceNumber != ctx.channelCtx.channelSequenceNumber)
+            SyncPoolWrites(ctx, texSamplers);
+
+        if (texSamplerCache[index])
+            return texSamplerCache[index];
+
         TextureSamplerControl &texSampler{texSamplers[index]};
         auto &sampler{texSamplerStore[texSampler]};
         if (!sampler) {
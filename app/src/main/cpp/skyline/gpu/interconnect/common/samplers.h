@@ -5,6 +5,7 @@
 
 #include <tsl/robin_map.h>
 #include "common.h"
+#include "pool_write_trap.h"
 #include "tsc.h"
 
 namespace skyline::gpu::interconnect {
@@ -38,7 +39,14 @@ namespace skyline::gpu::interconnect {
         dirty::ManualDirtyState<SamplerPoolState> samplerPool;
 
         tsl::robin_map<TextureSamplerControl, std::unique_ptr<vk::raii::Sampler>, util::ObjectHash<TextureSamplerControl>> texSamplerStore;
-        std::vector<vk::raii::Sampler *> texSamplerCache;
+        std::vector<vk::raii::Sampler *> texSamplerCache; //!< A cache of samplers indexed by TSC index, entries are only invalidated when their TSC is written to
+        PoolWriteTrap poolWriteTrap;
+        size_t poolSyncSequenceNumber{}; //!< The channel sequence number at which writes to the pool were last collected
+
+        /**
+         * @brief Invalidates all cached samplers with TSCs that have been written to since the last call
+         */
+        void SyncPoolWrites(InterconnectContext &ctx, span<TextureSamplerControl> texSamplers);
 
       public:
         Samplers(DirtyManager &manager, const SamplerPoolState::EngineRegisters &engine);
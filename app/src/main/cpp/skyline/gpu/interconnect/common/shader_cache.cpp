@@ -8,9 +8,46 @@
 #include <soc/gm20b/channel.h>
 #include <soc/gm20b/gmmu.h>
 #include <gpu.h>
+#include <common/performance_stats.h>
 #include "shader_cache.h"
 
 namespace skyline::gpu::interconnect {
+    // We attempt to find the shader size by looking for "BRA $" (Infinite Loop) which is used as padding at the end of the shader
+    // UAM Shader Compiler Reference: https://github.com/devkitPro/uam/blob/5a5afc2bae8b55409ab36ba45be63fcb73f68993/source/compiler_iface.cpp#L319-L351
+    constexpr u64 BraSelf1{0xE2400FFFFF87000F}, BraSelf2{0xE2400FFFFF07000F};
+
+    void ShaderCache::UpdateGeneration(InterconnectContext &ctx) {
+        if (entry->trapCount > MirrorEntry::SkipTrapThreshold && entry->executionTag != ctx.executor.executionTag) {
+            entry->executionTag = ctx.executor.executionTag;
+            entry->dirty = true;
+        }
+
+        if (entry->dirty) {
+            entry->generation++;
+            entry->dirty = false;
+
+            // Retrap to catch any future writes
+            if (entry->trapCount <= MirrorEntry::SkipTrapThreshold)
+                ctx.nce.TrapRegions(*entry->trap, true);
+        }
+    }
+
+    bool ShaderCache::Validate(CacheEntry &cached) {
+        if (cached.generation == entry->generation)
+            return true;
+
+        if (!cached.terminated)
+            return false;
+
+        auto binary{cached.binary.binary};
+        u64 terminator{*reinterpret_cast<u64 *>(binary.data() + binary.size())};
+        if ((terminator != BraSelf1 && terminator != BraSelf2) || XXH64(binary.data(), binary.size_bytes(), 0) != cached.hash)
+            return false;
+
+        cached.generation = entry->generation;
+        return true;
+    }
+
     /* Pipeline Stage */
     std::pair<ShaderBinary, u64> ShaderCache::Lookup(InterconnectContext &ctx, u64 programBase, u32 programOffset) {
         lastProgramBase = programBase;
@@ -53,22 +90,20 @@ namespace skyline::gpu::interconnect {
             mirrorBlock = blockMapping;
         }
 
-        if (entry->trapCount > MirrorEntry::SkipTrapThreshold && entry->executionTag != ctx.executor.executionTag) {
-            entry->executionTag = ctx.executor.executionTag;
+        // Writes from the GPU aren't caught by the trap so they're treated the same as a trap hit
+        if (ctx.executor.usageTracker.sequencedIntervals.Intersect(blockMapping.subspan(blockOffset)))
             entry->dirty = true;
-        }
 
-        // If the mirror entry has been written to, clear its shader binary cache and retrap to catch any future writes
-        if (entry->dirty || ctx.executor.usageTracker.sequencedIntervals.Intersect(blockMapping.subspan(blockOffset))) {
-            entry->cache.clear();
-            entry->dirty = false;
+        UpdateGeneration(ctx);
 
-            if (entry->trapCount <= MirrorEntry::SkipTrapThreshold)
-                ctx.nce.TrapRegions(*entry->trap, true);
-        } else if (auto it{entry->cache.find(blockMapping.data() + blockOffset)}; it != entry->cache.end()) {
-            return it->second;
+        lastShaderAddress = blockMapping.data() + blockOffset;
+        if (auto it{entry->cache.find(lastShaderAddress)}; it != entry->cache.end() && Validate(it.value())) {
+            PerfStats.shaderCacheHits.fetch_add(1, std::memory_order_relaxed);
+            return {it->second.binary, it->second.hash};
         }
 
+        PerfStats.shaderCacheMisses.fetch_add(1, std::memory_order_relaxed);
+
         // entry->mirror may not be a direct mirror of blockMapping and may just contain it as a subregion, so we need to explicitly calculate the offset
         span<u8> blockMappingMirror{blockMapping.data() - mirrorBlock.data() + entry->mirror.data(), blockMapping.size()};
 
@@ -76,10 +111,6 @@ namespace skyline::gpu::interconnect {
         auto shaderSubmapping{blockMappingMirror.subspan(blockOffset)};
         // If nothing was in the cache then do a full shader parse
         binary.binary = [](span<u8> mapping) {
-            // We attempt to find the shader size by looking for "BRA $" (Infinite Loop) which is used as padding at the end of the shader
-            // UAM Shader Compiler Reference: https://github.com/devkitPro/uam/blob/5a5afc2bae8b55409ab36ba45be63fcb73f68993/source/compiler_iface.cpp#L319-L351
-            constexpr u64 BraSelf1{0xE2400FFFFF87000F}, BraSelf2{0xE2400FFFFF07000F};
-
             span<u64> shaderInstructions{mapping.cast<u64, std::dynamic_extent, true>()};
             for (auto it{shaderInstructions.begin()}; it != shaderInstructions.end(); it++) {
                 auto instruction{*it};
@@ -91,7 +122,8 @@ namespace skyline::gpu::interconnect {
             return span<u8>{};
         }(shaderSubmapping);
 
-        if (!binary.binary.valid()) {
+        bool terminated{binary.binary.valid()};
+        if (!terminated) {
             static constexpr size_t FallbackSize{0x10000}; //!< Fallback shader size for when we can't detect it with the BRA $ pattern
             if (shaderSubmapping.size() > FallbackSize) {
                 binary.binary = shaderSubmapping;
@@ -117,7 +149,7 @@ namespace skyline::gpu::interconnect {
         binary.baseOffset = programOffset;
 
         u64 hash{XXH64(binary.binary.data(), binary.binary.size_bytes(), 0)};
-        entry->cache.insert({blockMapping.data() + blockOffset, {binary, hash}});
+        entry->cache.insert_or_assign(lastShaderAddress, CacheEntry{binary, hash, entry->generation, terminated});
 
         return {binary, hash};
     }
@@ -129,12 +161,14 @@ namespace skyline::gpu::interconnect {
         if (programBase != lastProgramBase || programOffset != lastProgramOffset)
             return true;
 
-        if (entry && entry->trapCount > MirrorEntry::SkipTrapThreshold && entry->executionTag != ctx.executor.executionTag)
-            return true;
-        else if (entry && entry->dirty)
-            return true;
+        if (!entry)
+            return false;
+
+        UpdateGeneration(ctx);
 
-        return false;
+        // Only a write to the shader itself requires a new lookup, writes elsewhere in the mirror are ignored after revalidating the shader
+        auto it{entry->cache.find(lastShaderAddress)};
+        return it == entry->cache.end() || !Validate(it.value());
     }
 
     void ShaderCache::PurgeCaches() {
@@ -12,18 +12,29 @@ namespace skyline::gpu::interconnect {
      */
     class ShaderCache {
       private:
+        /**
+         * @brief A shader binary that was parsed out of a mirror
+         */
+        struct CacheEntry {
+            ShaderBinary binary;
+            u64 hash; //!< The hash of the binary contents
+            u32 generation; //!< The generation of the mirror at which the binary was last known to be valid
+            bool terminated; //!< If the binary is in the mirror and directly followed by a terminating instruction, only such binaries can be revalidated by hashing
+        };
+
         /**
          * @brief Holds mirror state for a single GPU mapped block
          */
         struct MirrorEntry {
             span<u8> mirror;
-            tsl::robin_map<u8 *, std::pair<ShaderBinary, u64>> cache;
+            tsl::robin_map<u8 *, CacheEntry> cache;
             std::optional<nce::NCE::TrapHandle> trap;
 
             static constexpr u32 SkipTrapThreshold{20}; //!< Threshold for the number of times a mirror trap needs to be hit before we fallback to always hashing
             u32 trapCount{}; //!< The number of times the trap has been hit, used to avoid trapping in cases where the constant retraps would harm performance
-            ContextTag executionTag{}; //!< For the case where `trapCount > SkipTrapThreshold`, the memory sequence number number used to clear the cache after every access
-            bool dirty{}; //!< If the trap has been hit and the cache needs to be cleared
+            ContextTag executionTag{}; //!< For the case where `trapCount > SkipTrapThreshold`, the memory sequence number number used to invalidate the cache after every access
+            bool dirty{}; //!< If the trap has been hit and the generation needs to be advanced
+            u32 generation{}; //!< Advanced whenever the mirror might have been written to, cached binaries from prior generations are lazily revalidated by hashing their contents
 
             MirrorEntry(span<u8> alignedMirror) : mirror{alignedMirror} {}
         };
@@ -35,8 +46,20 @@ namespace skyline::gpu::interconnect {
         span<u8> mirrorBlock{}; //!< Guest mapped memory block corresponding to `entry`
         u64 lastProgramBase{};
         u32 lastProgramOffset{};
+        u8 *lastShaderAddress{}; //!< The guest address of the binary returned by the previous lookup, this is the key of its entry in the cache
         std::vector<u8> splitBinaryStorage;
 
+        /**
+         * @brief Advances the generation of the current mirror if it might have been written to since the last check
+         */
+        void UpdateGeneration(InterconnectContext &ctx);
+
+        /**
+         * @return If the supplied cached binary is still valid in the current generation of the mirror
+         * @note Binaries from prior generations are rehashed, this only considers writes to the binary itself so writes next to shaders don't invalidate them
+         */
+        bool Validate(CacheEntry &cached);
+
       public:
         /**
          * @brief Returns the shader binary located at the given address
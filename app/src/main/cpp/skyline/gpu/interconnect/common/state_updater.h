@@ -4,6 +4,7 @@
 #pragma once
 
 #include <future>
+#include <gpu/graphics_pipeline_assembler.h>
 #include <gpu/interconnect/command_executor.h>
 #include "common.h"
 
@@ -203,6 +204,48 @@ namespace skyline::gpu::interconnect {
     };
     using SetBaseStencilStateCmd = CmdHolder<SetBaseStencilStateCmdImpl>;
 
+    struct SetCullStateCmdImpl {
+        void Record(GPU &gpu, vk::raii::CommandBuffer &commandBuffer) {
+            commandBuffer.setCullModeEXT(cullMode);
+            commandBuffer.setFrontFaceEXT(frontFace);
+        }
+
+        vk::CullModeFlags cullMode;
+        vk::FrontFace frontFace;
+    };
+    using SetCullStateCmd = CmdHolder<SetCullStateCmdImpl>;
+
+    struct SetDepthStencilStateCmdImpl {
+        void Record(GPU &gpu, vk::raii::CommandBuffer &commandBuffer) {
+            commandBuffer.setDepthTestEnableEXT(depthTestEnable);
+            commandBuffer.setDepthWriteEnableEXT(depthWriteEnable);
+            commandBuffer.setDepthCompareOpEXT(depthCompareOp);
+            commandBuffer.setDepthBoundsTestEnableEXT(depthBoundsTestEnable);
+            commandBuffer.setStencilTestEnableEXT(stencilTestEnable);
+            commandBuffer.setStencilOpEXT(vk::StencilFaceFlagBits::eFront, front.failOp, front.passOp, front.depthFailOp, front.compareOp);
+            commandBuffer.setStencilOpEXT(vk::StencilFaceFlagBits::eBack, back.failOp, back.passOp, back.depthFailOp, back.compareOp);
+        }
+
+        bool depthTestEnable;
+        bool depthWriteEnable;
+        vk::CompareOp depthCompareOp;
+        bool depthBoundsTestEnable;
+        bool stencilTestEnable;
+        vk::StencilOpState front; //!< Only the operations and compare op are used, masks and references are set through SetBaseStencilStateCmd
+        vk::StencilOpState back;
+    };
+    using SetDepthStencilStateCmd = CmdHolder<SetDepthStencilStateCmdImpl>;
+
+    struct SetVertexInputCmdImpl {
+        void Record(GPU &gpu, vk::raii::CommandBuffer &commandBuffer) {
+            commandBuffer.setVertexInputEXT(bindings, attributes);
+        }
+
+        span<vk::VertexInputBindingDescription2EXT> bindings;
+        span<vk::VertexInputAttributeDescription2EXT> attributes;
+    };
+    using SetVertexInputCmd = CmdHolder<SetVertexInputCmdImpl>;
+
     template<bool PushDescriptor>
     struct SetDescriptorSetCmdImpl {
         void Record(GPU &gpu, vk::raii::CommandBuffer &commandBuffer) {
@@ -241,7 +284,10 @@ namespace skyline::gpu::interconnect {
                 if (!updateInfo->copies.empty())
                     gpu.vkDevice.updateDescriptorSets({}, updateInfo->copies);
 
-                if (!updateInfo->writes.empty())
+                if (updateInfo->updateTemplate)
+                    // The buffer descriptors resolved above are written into the template data directly as it backs `bufferDescs`
+                    (*gpu.vkDevice).updateDescriptorSetWithTemplate(**dstSet, updateInfo->updateTemplate, updateInfo->descriptorData, *gpu.vkDevice.getDispatcher());
+                else if (!updateInfo->writes.empty())
                     gpu.vkDevice.updateDescriptorSets(updateInfo->writes, {});
 
                 // Bind the updated descriptor set and we're done!
@@ -256,6 +302,18 @@ namespace skyline::gpu::interconnect {
     using SetDescriptorSetWithUpdateCmd = CmdHolder<SetDescriptorSetCmdImpl<false>>;
     using SetDescriptorSetWithPushCmd = CmdHolder<SetDescriptorSetCmdImpl<true>>;
 
+    struct BindDescriptorSetCmdImpl {
+        void Record(GPU &gpu, vk::raii::CommandBuffer &commandBuffer) {
+            commandBuffer.bindDescriptorSets(bindPoint, pipelineLayout, descriptorSetIndex, **set, {});
+        }
+
+        DescriptorAllocator::ActiveDescriptorSet *set;
+        vk::PipelineLayout pipelineLayout;
+        vk::PipelineBindPoint bindPoint;
+        u32 descriptorSetIndex;
+    };
+    using BindDescriptorSetCmd = CmdHolder<BindDescriptorSetCmdImpl>;
+
     struct SetPipelineCmdImpl {
         void Record(GPU &gpu, vk::raii::CommandBuffer &commandBuffer) {
             commandBuffer.bindPipeline(bindPoint, pipeline);
@@ -268,10 +326,15 @@ namespace skyline::gpu::interconnect {
 
     struct SetPipelineFutureCmdImpl {
         void Record(GPU &gpu, vk::raii::CommandBuffer &commandBuffer) {
+            if (optimizedPipeline)
+                if (vk::Pipeline optimized{optimizedPipeline->load(std::memory_order_acquire)})
+                    return commandBuffer.bindPipeline(bindPoint, optimized);
+
             commandBuffer.bindPipeline(bindPoint, *pipeline.get());
         }
 
         std::shared_future<vk::raii::Pipeline> pipeline;
+        GraphicsPipelineAssembler::OptimizedPipeline optimizedPipeline;
         vk::PipelineBindPoint bindPoint;
     };
     using SetPipelineFutureCmd = CmdHolder<SetPipelineFutureCmdImpl>;
@@ -286,6 +349,13 @@ namespace skyline::gpu::interconnect {
       public:
         StateUpdater(StateUpdateCmdHeader *first) : first{first} {}
 
+        /**
+         * @return If there are no state updates to record
+         */
+        bool Empty() const {
+            return !first;
+        }
+
         /**
          * @brief Records all contained state updates into the given command buffer
          */
@@ -469,6 +539,45 @@ namespace skyline::gpu::interconnect {
                 });
         }
 
+        /**
+         * @note This requires VK_EXT_extended_dynamic_state
+         */
+        void SetCullState(vk::CullModeFlags cullMode, vk::FrontFace frontFace) {
+            AppendCmd<SetCullStateCmd>(
+                {
+                    .cullMode = cullMode,
+                    .frontFace = frontFace,
+                });
+        }
+
+        /**
+         * @note This requires VK_EXT_extended_dynamic_state
+         */
+        void SetDepthStencilState(bool depthTestEnable, bool depthWriteEnable, vk::CompareOp depthCompareOp, bool depthBoundsTestEnable, bool stencilTestEnable, const vk::StencilOpState &front, const vk::StencilOpState &back) {
+            AppendCmd<SetDepthStencilStateCmd>(
+                {
+                    .depthTestEnable = depthTestEnable,
+                    .depthWriteEnable = depthWriteEnable,
+                    .depthCompareOp = depthCompareOp,
+                    .depthBoundsTestEnable = depthBoundsTestEnable,
+                    .stencilTestEnable = stencilTestEnable,
+                    .front = front,
+                    .back = back,
+                });
+        }
+
+        /**
+         * @note This requires VK_EXT_vertex_input_dynamic_state
+         * @note The descriptions must remain valid until the state is recorded, they should be allocated from the same allocator as the builder
+         */
+        void SetVertexInput(span<vk::VertexInputBindingDescription2EXT> bindings, span<vk::VertexInputAttributeDescription2EXT> attributes) {
+            AppendCmd<SetVertexInputCmd>(
+                {
+                    .bindings = bindings,
+                    .attributes = attributes,
+                });
+        }
+
         void SetDescriptorSetWithUpdate(DescriptorUpdateInfo *updateInfo, DescriptorAllocator::ActiveDescriptorSet *dstSet, DescriptorAllocator::ActiveDescriptorSet *srcSet) {
             AppendCmd<SetDescriptorSetWithUpdateCmd>(
                 {
@@ -478,6 +587,19 @@ namespace skyline::gpu::interconnect {
                 });
         }
 
+        /**
+         * @brief Binds a descriptor set that has already been written by a prior update without modifying it
+         */
+        void BindDescriptorSet(DescriptorUpdateInfo *updateInfo, DescriptorAllocator::ActiveDescriptorSet *set) {
+            AppendCmd<BindDescriptorSetCmd>(
+                {
+                    .set = set,
+                    .pipelineLayout = updateInfo->pipelineLayout,
+                    .bindPoint = updateInfo->bindPoint,
+                    .descriptorSetIndex = updateInfo->descriptorSetIndex,
+                });
+        }
+
         void SetPipeline(vk::Pipeline pipeline, vk::PipelineBindPoint bindPoint) {
             AppendCmd<SetPipelineCmd>(
                 {
@@ -486,10 +608,11 @@ namespace skyline::gpu::interconnect {
                 });
         }
 
-        void SetPipeline(const std::shared_future<vk::raii::Pipeline> &pipeline, vk::PipelineBindPoint bindPoint) {
+        void SetPipeline(const std::shared_future<vk::raii::Pipeline> &pipeline, vk::PipelineBindPoint bindPoint, const GraphicsPipelineAssembler::OptimizedPipeline &optimizedPipeline = {}) {
             AppendCmd<SetPipelineFutureCmd>(
                 {
                     .pipeline = pipeline,
+                    .optimizedPipeline = optimizedPipeline,
                     .bindPoint = bindPoint,
                 });
         }
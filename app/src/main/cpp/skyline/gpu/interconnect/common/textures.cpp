@@ -236,17 +236,41 @@ namespace skyline::gpu::interconnect {
         });;
     }
 
+    void Textures::SyncPoolWrites(InterconnectContext &ctx, span<TextureImageControl> textureHeaders) {
+        poolSyncSequenceNumber = ctx.channelCtx.channelSequenceNumber;
+
+        auto pool{textureHeaders.cast<u8>()};
+        if (!poolWriteTrap.IsTrapping(pool)) {
+            poolWriteTrap.Trap(ctx, pool);
+            for (auto &entry : textureHeaderCache)
+                entry.unwritten = false;
+            return;
+        }
+
+        poolWriteTrap.Collect([this](size_t offset, size_t size) {
+            for (size_t i{offset / sizeof(TextureImageControl)}, end{util::DivideCeil(offset + size, sizeof(TextureImageControl))}; i < end; i++)
+                textureHeaderCache[i].unwritten = false;
+        });
+    }
+
     TextureView *Textures::GetTexture(InterconnectContext &ctx, u32 index, Shader::TextureType shaderType) {
         auto textureHeaders{texturePool.UpdateGet(ctx).textureHeaders};
         if (textureHeaderCache.size() != textureHeaders.size()) {
             textureHeaderCache.resize(textureHeaders.size());
             std::fill(textureHeaderCache.begin(), textureHeaderCache.end(), CacheEntry{});
-        } else if (textureHeaders.size() > index && textureHeaderCache[index].view) {
+        }
+
+        // Guest writes to the pool are only collected once per channel sequence as the pool isn't expected to change in between
+        if (poolSyncSequenceNumber != ctx.channelCtx.channelSequenceNumber)
+            SyncPoolWrites(ctx, textureHeaders);
+
+        if (textureHeaders.size() > index && textureHeaderCache[index].view) {
             auto &cached{textureHeaderCache[index]};
             if (cached.sequenceNumber == ctx.channelCtx.channelSequenceNumber)
                 return cached.view;
 
-            if (cached.tic == textureHeaders[index] && !cached.view->texture->replaced) {
+            // Unwritten entries can skip comparing their TIC against the pool entirely
+            if ((cached.unwritten || cached.tic == textureHeaders[index]) && !cached.view->texture->replaced) {
                 cached.sequenceNumber = ctx.channelCtx.channelSequenceNumber;
                 return cached.view;
             }
@@ -356,7 +380,7 @@ namespace skyline::gpu::interconnect {
             texture = ctx.gpu.texture.FindOrCreate(guest, ctx.executor.tag);
         }
 
-        textureHeaderCache[index] = {textureHeader, texture.get(), ctx.channelCtx.channelSequenceNumber};
+        textureHeaderCache[index] = {textureHeader, texture.get(), ctx.channelCtx.channelSequenceNumber, true};
         return texture.get();
     }
 
@@ -7,6 +7,7 @@
 #include <shader_compiler/shader_info.h>
 #include <gpu/texture/texture.h>
 #include "common.h"
+#include "pool_write_trap.h"
 #include "tic.h"
 
 namespace skyline::gpu::interconnect {
@@ -42,8 +43,16 @@ namespace skyline::gpu::interconnect {
             TextureImageControl tic;
             TextureView *view;
             u64 sequenceNumber;
+            bool unwritten; //!< If the TIC hasn't been written to since the entry was cached, it doesn't need to be compared against the pool in that case
         };
         std::vector<CacheEntry> textureHeaderCache;
+        PoolWriteTrap poolWriteTrap;
+        size_t poolSyncSequenceNumber{}; //!< The channel sequence number at which writes to the pool were last collected
+
+        /**
+         * @brief Marks all cache entries with TICs that have been written to since the last call as needing to be compared against the pool
+         */
+        void SyncPoolWrites(InterconnectContext &ctx, span<TextureImageControl> textureHeaders);
 
       public:
         Textures(DirtyManager &manager, const TexturePoolState::EngineRegisters &engine);
@@ -0,0 +1,12 @@
+// SPDX-License-Identifier: MPL-2.0
+// Copyright © 2023 Skyline Team and Contributors (https://github.com/skyline-emu/)
+
+#include "index_widening.h"
+
+namespace skyline::gpu::interconnect::conversion::index_widening {
+    void WidenIndexBuffer(u16 *dest, const u8 *source, u32 indexCount) {
+        #pragma clang loop vectorize(enable) interleave(enable)
+        for (u32 i{}; i < indexCount; i++)
+            dest[i] = source[i];
+    }
+}
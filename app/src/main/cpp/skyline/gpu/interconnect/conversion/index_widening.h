@@ -0,0 +1,21 @@
+// SPDX-License-Identifier: MPL-2.0
+// Copyright © 2023 Skyline Team and Contributors (https://github.com/skyline-emu/)
+
+#pragma once
+
+#include <common/base.h>
+
+namespace skyline::gpu::interconnect::conversion::index_widening {
+    /**
+     * @return The size (in bytes) required to store the supplied amount of widened 16-bit indices
+     */
+    constexpr size_t GetRequiredBufferSize(u32 count) {
+        return count * sizeof(u16);
+    }
+
+    /**
+     * @brief Widens 8-bit indices into 16-bit indices, this is used to emulate 8-bit index buffers on devices without VK_EXT_index_type_uint8
+     * @note The size of the destination buffer should be at least the size returned by GetRequiredBufferSize()
+     */
+    void WidenIndexBuffer(u16 *dest, const u8 *source, u32 indexCount);
+}
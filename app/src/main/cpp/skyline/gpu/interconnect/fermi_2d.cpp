@@ -118,6 +118,56 @@ namespace skyline::gpu::interconnect {
           channelCtx{channelCtx},
           executor{channelCtx.executor} {}
 
+    bool Fermi2D::FormatSupports(vk::Format format, vk::FormatFeatureFlags features) {
+        auto it{optimalFormatFeatures.find(format)};
+        if (it == optimalFormatFeatures.end())
+            it = optimalFormatFeatures.emplace(format, gpu.vkPhysicalDevice.getFormatProperties(format).optimalTilingFeatures).first;
+
+        return (it->second & features) == features;
+    }
+
+    Fermi2D::BlitPath Fermi2D::PlanBlit(TextureView *srcView, TextureView *dstView, const std::array<vk::Offset3D, 2> &srcOffsets, const std::array<vk::Offset3D, 2> &dstOffsets, bool unscaled, bool bilinear) {
+        auto srcTexture{srcView->texture.get()}, dstTexture{dstView->texture.get()};
+
+        // Transfer commands don't permit the source and destination regions to overlap, this can't be cheaply determined for aliased subresources so blits within a texture always use the shader
+        if (srcTexture == dstTexture)
+            return BlitPath::Shader;
+
+        // Transfer commands operate on the image format rather than the view format, reinterpreting views would require sampling
+        if (srcView->format != srcTexture->format || dstView->format != dstTexture->format)
+            return BlitPath::Shader;
+
+        if (srcTexture->sampleCount != vk::SampleCountFlagBits::e1 || dstTexture->sampleCount != vk::SampleCountFlagBits::e1 ||
+            srcTexture->layout != vk::ImageLayout::eGeneral || dstTexture->layout != vk::ImageLayout::eGeneral ||
+            !(srcTexture->usage & vk::ImageUsageFlagBits::eTransferSrc) || !(dstTexture->usage & vk::ImageUsageFlagBits::eTransferDst))
+            return BlitPath::Shader;
+
+        // The shader implicitly clamps reads to the edge of the source and discards writes outside of the destination, transfer commands must be entirely in bounds
+        auto isInBounds{[](TextureView *view, const std::array<vk::Offset3D, 2> &offsets) {
+            i32 width{static_cast<i32>(std::max(view->texture->dimensions.width >> view->range.baseMipLevel, 1U))};
+            i32 height{static_cast<i32>(std::max(view->texture->dimensions.height >> view->range.baseMipLevel, 1U))};
+            return offsets[0].x >= 0 && offsets[0].y >= 0 && offsets[0].x < offsets[1].x && offsets[0].y < offsets[1].y && offsets[1].x <= width && offsets[1].y <= height;
+        }};
+        if (!isInBounds(srcView, srcOffsets) || !isInBounds(dstView, dstOffsets))
+            return BlitPath::Shader;
+
+        // Sampling at texel centres for an unscaled blit yields the exact source texels regardless of filtering, this is equivalent to a copy when no format conversion is required
+        if (unscaled && srcTexture->format == dstTexture->format)
+            return BlitPath::Copy;
+
+        if (srcTexture->tiling != vk::ImageTiling::eOptimal || dstTexture->tiling != vk::ImageTiling::eOptimal)
+            return BlitPath::Shader;
+
+        vk::FormatFeatureFlags srcFeatures{vk::FormatFeatureFlagBits::eBlitSrc};
+        if (bilinear)
+            srcFeatures |= vk::FormatFeatureFlagBits::eSampledImageFilterLinear;
+
+        if (!FormatSupports(srcTexture->format->vkFormat, srcFeatures) || !FormatSupports(dstTexture->format->vkFormat, vk::FormatFeatureFlagBits::eBlitDst))
+            return BlitPath::Shader;
+
+        return BlitPath::Blit;
+    }
+
     void Fermi2D::Blit(const Surface &srcSurface, const Surface &dstSurface, float srcRectX, float srcRectY, u32 dstRectWidth, u32 dstRectHeight, u32 dstRectX, u32 dstRectY, float duDx, float dvDy, SampleModeOrigin sampleOrigin, bool resolve, SampleModeFilter filter) {
         TRACE_EVENT("gpu", "Fermi2D::Blit");
 
@@ -144,36 +194,101 @@ namespace skyline::gpu::interconnect {
         dstTextureView->texture->MarkGpuDirty(executor.usageTracker);
 
         executor.AddCheckpoint("Before blit");
-        gpu.helperShaders.blitHelperShader.Blit(
-            gpu,
-            {
-                .width = duDx * dstRectWidth,
-                .height = dvDy * dstRectHeight,
-                .x = centredSrcRectX,
-                .y = centredSrcRectY,
-            },
-            {
-                .width = static_cast<float>(dstRectWidth),
-                .height = static_cast<float>(dstRectHeight),
-                .x = static_cast<float>(dstRectX),
-                .y = static_cast<float>(dstRectY),
-            },
-            srcGuestTexture.dimensions, dstGuestTexture.dimensions,
-            duDx, dvDy,
-            filter == SampleModeFilter::Bilinear,
-            srcTextureView.get(), dstTextureView.get(),
-            [=](auto &&executionCallback) {
-                auto dst{dstTextureView.get()};
-                std::array<TextureView *, 1> sampledImages{srcTextureView.get()};
-                executor.AddSubpass(std::move(executionCallback), {{static_cast<i32>(dstRectX), static_cast<i32>(dstRectY)}, {dstRectWidth, dstRectHeight} },
-                                    sampledImages, {}, {dst}, {}, false,
-                                    vk::PipelineStageFlagBits::eAllGraphics, vk::PipelineStageFlagBits::eAllGraphics);
-            }
-        );
-        executor.AddCheckpoint("After blit");
+        bool bilinear{filter == SampleModeFilter::Bilinear};
+        float srcRectEndX{centredSrcRectX + duDx * static_cast<float>(dstRectWidth)}, srcRectEndY{centredSrcRectY + dvDy * static_cast<float>(dstRectHeight)};
+        auto isIntegral{[](float value) { return std::floor(value) == value; }};
+
+        // The blit rectangles are in guest texels, they need to be scaled by the render scale of the respective texture for any host operations
+        float srcRenderScale{srcTextureView->texture->renderScale}, dstRenderScale{dstTextureView->texture->renderScale};
+        auto scaleOffsets{[](const std::array<vk::Offset3D, 2> &offsets, float scale) {
+            if (scale == 1.0f)
+                return offsets;
+
+            auto rect{texture::ScaleRect({{offsets[0].x, offsets[0].y}, {static_cast<u32>(offsets[1].x - offsets[0].x), static_cast<u32>(offsets[1].y - offsets[0].y)}}, scale)};
+            return std::array<vk::Offset3D, 2>{vk::Offset3D{rect.offset.x, rect.offset.y, offsets[0].z}, vk::Offset3D{rect.offset.x + static_cast<i32>(rect.extent.width), rect.offset.y + static_cast<i32>(rect.extent.height), offsets[1].z}};
+        }};
+
+        BlitPath path{BlitPath::Shader};
+        std::array<vk::Offset3D, 2> srcOffsets{}, dstOffsets{};
+        if (dstRectWidth && dstRectHeight && isIntegral(centredSrcRectX) && isIntegral(centredSrcRectY) && isIntegral(srcRectEndX) && isIntegral(srcRectEndY)) {
+            // Transfer commands only operate on whole texels so any source region with a fractional edge has to be sampled by the shader
+            srcOffsets = scaleOffsets({vk::Offset3D{static_cast<i32>(centredSrcRectX), static_cast<i32>(centredSrcRectY), 0}, vk::Offset3D{static_cast<i32>(srcRectEndX), static_cast<i32>(srcRectEndY), 1}}, srcRenderScale);
+            dstOffsets = scaleOffsets({vk::Offset3D{static_cast<i32>(dstRectX), static_cast<i32>(dstRectY), 0}, vk::Offset3D{static_cast<i32>(dstRectX + dstRectWidth), static_cast<i32>(dstRectY + dstRectHeight), 1}}, dstRenderScale);
+
+            // A blit is only unscaled on the host if the host regions have the same size, this may not be the case for differing render scales
+            bool unscaled{srcOffsets[1].x - srcOffsets[0].x == dstOffsets[1].x - dstOffsets[0].x && srcOffsets[1].y - srcOffsets[0].y == dstOffsets[1].y - dstOffsets[0].y};
+            path = PlanBlit(srcTextureView.get(), dstTextureView.get(), srcOffsets, dstOffsets, duDx == 1.0f && dvDy == 1.0f && unscaled, bilinear);
+        }
 
+        if (path == BlitPath::Shader) {
+            gpu.helperShaders.blitHelperShader.Blit(
+                gpu,
+                {
+                    .width = duDx * dstRectWidth,
+                    .height = dvDy * dstRectHeight,
+                    .x = centredSrcRectX,
+                    .y = centredSrcRectY,
+                },
+                {
+                    .width = static_cast<float>(dstRectWidth) * dstRenderScale,
+                    .height = static_cast<float>(dstRectHeight) * dstRenderScale,
+                    .x = static_cast<float>(dstRectX) * dstRenderScale,
+                    .y = static_cast<float>(dstRectY) * dstRenderScale,
+                },
+                srcGuestTexture.dimensions, dstGuestTexture.dimensions.Scale(dstRenderScale), // The source rectangle is normalized by the source dimensions so it doesn't need to be scaled
+                duDx, dvDy,
+                filter == SampleModeFilter::Bilinear,
+                srcTextureView.get(), dstTextureView.get(),
+                [=](auto &&executionCallback) {
+                    auto dst{dstTextureView.get()};
+                    std::array<TextureView *, 1> sampledImages{srcTextureView.get()};
+                    executor.AddSubpass(std::move(executionCallback), texture::ScaleRect({{static_cast<i32>(dstRectX), static_cast<i32>(dstRectY)}, {dstRectWidth, dstRectHeight}}, dstRenderScale),
+                                        sampledImages, {}, {dst}, {}, false,
+                                        vk::PipelineStageFlagBits::eAllGraphics, vk::PipelineStageFlagBits::eAllGraphics);
+                }
+            );
+
+            executor.NotifyPipelineChange();
+        } else {
+            executor.AddOutsideRpCommand([srcTextureView, dstTextureView, srcOffsets, dstOffsets, path, bilinear](vk::raii::CommandBuffer &commandBuffer, const std::shared_ptr<FenceCycle> &, GPU &) {
+                commandBuffer.pipelineBarrier(vk::PipelineStageFlagBits::eAllCommands, vk::PipelineStageFlagBits::eTransfer, {}, vk::MemoryBarrier{
+                    .srcAccessMask = vk::AccessFlagBits::eMemoryWrite,
+                    .dstAccessMask = vk::AccessFlagBits::eTransferRead | vk::AccessFlagBits::eTransferWrite
+                }, {}, {});
+
+                auto getSubresource{[](TextureView *view) {
+                    return vk::ImageSubresourceLayers{
+                        .aspectMask = view->range.aspectMask,
+                        .mipLevel = view->range.baseMipLevel,
+                        .baseArrayLayer = view->range.baseArrayLayer,
+                        .layerCount = 1,
+                    };
+                }};
+
+                if (path == BlitPath::Copy)
+                    commandBuffer.copyImage(srcTextureView->texture->GetBacking(), vk::ImageLayout::eGeneral, dstTextureView->texture->GetBacking(), vk::ImageLayout::eGeneral, vk::ImageCopy{
+                        .srcSubresource = getSubresource(srcTextureView.get()),
+                        .srcOffset = srcOffsets[0],
+                        .dstSubresource = getSubresource(dstTextureView.get()),
+                        .dstOffset = dstOffsets[0],
+                        .extent = {static_cast<u32>(dstOffsets[1].x - dstOffsets[0].x), static_cast<u32>(dstOffsets[1].y - dstOffsets[0].y), 1},
+                    });
+                else
+                    commandBuffer.blitImage(srcTextureView->texture->GetBacking(), vk::ImageLayout::eGeneral, dstTextureView->texture->GetBacking(), vk::ImageLayout::eGeneral, vk::ImageBlit{
+                        .srcSubresource = getSubresource(srcTextureView.get()),
+                        .srcOffsets = srcOffsets,
+                        .dstSubresource = getSubresource(dstTextureView.get()),
+                        .dstOffsets = dstOffsets,
+                    }, bilinear ? vk::Filter::eLinear : vk::Filter::eNearest);
+
+                commandBuffer.pipelineBarrier(vk::PipelineStageFlagBits::eTransfer, vk::PipelineStageFlagBits::eAllCommands, {}, vk::MemoryBarrier{
+                    .srcAccessMask = vk::AccessFlagBits::eTransferWrite,
+                    .dstAccessMask = vk::AccessFlagBits::eMemoryRead | vk::AccessFlagBits::eMemoryWrite,
+                }, {}, {});
+            });
+        }
 
-        executor.NotifyPipelineChange();
+        executor.AddCheckpoint("After blit");
     }
 
 }
@@ -29,12 +29,34 @@ namespace skyline::gpu::interconnect {
         using SampleModeOrigin = skyline::soc::gm20b::engine::fermi2d::type::SampleModeOrigin;
         using SampleModeFilter = skyline::soc::gm20b::engine::fermi2d::type::SampleModeFilter;
 
+        /**
+         * @brief The Vulkan primitive that a blit is translated into, these are ordered from cheapest to most expensive
+         */
+        enum class BlitPath {
+            Copy, //!< An unscaled copy between images of the same format using vkCmdCopyImage
+            Blit, //!< A scaled or format converting blit using vkCmdBlitImage
+            Shader, //!< A draw with the blit helper shader, this is the general fallback for anything the transfer commands can't represent exactly
+        };
+
         GPU &gpu;
         soc::gm20b::ChannelContext &channelCtx;
         gpu::interconnect::CommandExecutor &executor;
+        std::unordered_map<vk::Format, vk::FormatFeatureFlags> optimalFormatFeatures; //!< A cache of the optimal tiling features of host formats that have been blitted with
 
         std::pair<gpu::GuestTexture, bool> GetGuestTexture(const Surface &surface, u32 oobReadStart = 0, u32 oobReadWidth = 0);
 
+        /**
+         * @return If the host format supports all the supplied features with optimal tiling
+         */
+        bool FormatSupports(vk::Format format, vk::FormatFeatureFlags features);
+
+        /**
+         * @brief Determines the cheapest primitive that can exactly perform a blit between the supplied views
+         * @param srcOffsets The source region in texels which has been corrected to be relative to texel edges
+         * @param dstOffsets The destination region in texels
+         */
+        BlitPath PlanBlit(TextureView *srcView, TextureView *dstView, const std::array<vk::Offset3D, 2> &srcOffsets, const std::array<vk::Offset3D, 2> &dstOffsets, bool unscaled, bool bilinear);
+
       public:
         Fermi2D(GPU &gpu, soc::gm20b::ChannelContext &channelCtx);
 
@@ -21,13 +21,16 @@ namespace skyline::gpu::interconnect {
         })};
         ContextLock dstBufLock{executor.tag, dstBuf};
 
+        // First attempt the write without setting up the GPU copy callback as a fast path, this writes directly into the buffer's mirror and backing when the buffer isn't in use by the GPU
+        if (!dstBuf.Write(src, 0, executor.usageTracker)) [[likely]]
+            return;
 
         dstBuf.Write(src, 0, executor.usageTracker, [&]() {
             executor.AttachLockedBufferView(dstBuf, std::move(dstBufLock));
             // This will prevent any CPU accesses to backing for the duration of the usage
             dstBuf.GetBuffer()->BlockAllCpuBackingWrites();
 
-            auto srcGpuAllocation{gpu.megaBufferAllocator.Push(executor.cycle, src)};
+            auto srcGpuAllocation{executor.megaBufferAllocator->Push(executor.cycle, src)};
             executor.AddOutsideRpCommand([srcGpuAllocation, dstBuf, src](vk::raii::CommandBuffer &commandBuffer, const std::shared_ptr<FenceCycle> &, GPU &pGpu) {
                 auto dstBufBinding{dstBuf.GetBinding(pGpu)};
                 vk::BufferCopy copyRegion{
@@ -9,6 +9,24 @@
 #include "kepler_compute.h"
 
 namespace skyline::gpu::interconnect::kepler_compute {
+    /**
+     * @brief A single dispatch in a batch, these are linearly allocated and form a singly linked list
+     */
+    struct BatchedDispatch {
+        std::array<u32, 3> dimensions;
+        vk::PipelineStageFlags srcStageMask, dstStageMask; //!< The stages of the barrier that must be recorded prior to the dispatch
+        BatchedDispatch *next;
+    };
+
+    /**
+     * @note This is linearly allocated to avoid a dynamic allocation with lambda captures
+     */
+    struct KeplerCompute::DispatchBatch {
+        StateUpdater stateUpdater;
+        BatchedDispatch first;
+        BatchedDispatch *last;
+    };
+
     KeplerCompute::KeplerCompute(GPU &gpu,
                                  soc::gm20b::ChannelContext &channelCtx,
                                  nce::NCE &nce,
@@ -24,9 +42,26 @@ namespace skyline::gpu::interconnect::kepler_compute {
             constantBuffers.MarkAllDirty();
             samplers.MarkAllDirty();
             textures.MarkAllDirty();
+            activeBatch = nullptr;
         });
     }
 
+    bool KeplerCompute::TryAppendToBatch(Pipeline *pipeline, DescriptorUpdateInfo *descUpdateInfo, const QMD &qmd, vk::PipelineStageFlags srcStageMask, vk::PipelineStageFlags dstStageMask) {
+        if (descUpdateInfo)
+            MakeDescriptorSetKey(*descUpdateInfo, descriptorSetKey);
+        else
+            descriptorSetKey.clear();
+
+        // Any node recorded after the batch (including a barrier or buffer update) could depend on the batched dispatches, so only the last node can be extended
+        if (!activeBatch || activeBatchNode != ctx.executor.GetLastNode() || activeBatchPipeline != pipeline || activeBatchKey != descriptorSetKey)
+            return false;
+
+        auto *dispatch{ctx.executor.allocator->EmplaceUntracked<BatchedDispatch>(BatchedDispatch{{qmd.ctaRasterWidth, qmd.ctaRasterHeight, qmd.ctaRasterDepth}, srcStageMask, dstStageMask, nullptr})};
+        activeBatch->last->next = dispatch;
+        activeBatch->last = dispatch;
+        return true;
+    }
+
     void KeplerCompute::Dispatch(const QMD &qmd) {
         if (ctx.gpu.traits.quirks.brokenComputeShaders)
             return;
@@ -41,6 +76,11 @@ namespace skyline::gpu::interconnect::kepler_compute {
 
         vk::PipelineStageFlags srcStageMask{}, dstStageMask{};
         auto *descUpdateInfo{pipeline->SyncDescriptors(ctx, constantBuffers.boundConstantBuffers, samplers, textures, srcStageMask, dstStageMask)};
+
+        // Dispatches which directly follow one with the same pipeline and bindings are appended to its command rather than rebinding all state
+        if (TryAppendToBatch(pipeline, descUpdateInfo, qmd, srcStageMask, dstStageMask))
+            return;
+
         builder.SetPipeline(*pipeline->compiledPipeline.pipeline, vk::PipelineBindPoint::eCompute);
 
         if (ctx.gpu.traits.supportsPushDescriptors) {
@@ -52,31 +92,29 @@ namespace skyline::gpu::interconnect::kepler_compute {
             ctx.executor.AttachDependency(set);
         }
 
-        auto stateUpdater{builder.Build()};
-
-        /**
-         * @brief Struct that can be linearly allocated, holding all state for the draw to avoid a dynamic allocation with lambda captures
-         */
-        struct DrawParams {
-            StateUpdater stateUpdater;
-            std::array<u32, 3> dimensions;
-            vk::PipelineStageFlags srcStageMask, dstStageMask;
-        };
-        auto *drawParams{ctx.executor.allocator->EmplaceUntracked<DrawParams>(DrawParams{stateUpdater, {qmd.ctaRasterWidth, qmd.ctaRasterHeight, qmd.ctaRasterDepth}, srcStageMask, dstStageMask})};
-
+        auto *batch{ctx.executor.allocator->EmplaceUntracked<DispatchBatch>(DispatchBatch{builder.Build(), BatchedDispatch{{qmd.ctaRasterWidth, qmd.ctaRasterHeight, qmd.ctaRasterDepth}, srcStageMask, dstStageMask, nullptr}})};
+        batch->last = &batch->first;
 
         ctx.executor.AddCheckpoint("Before dispatch");
-        ctx.executor.AddOutsideRpCommand([drawParams](vk::raii::CommandBuffer &commandBuffer, const std::shared_ptr<FenceCycle> &, GPU &gpu) {
-            drawParams->stateUpdater.RecordAll(gpu, commandBuffer);
+        ctx.executor.AddOutsideRpCommand([batch](vk::raii::CommandBuffer &commandBuffer, const std::shared_ptr<FenceCycle> &, GPU &gpu) {
+            batch->stateUpdater.RecordAll(gpu, commandBuffer);
 
-            if (drawParams->srcStageMask && drawParams->dstStageMask)
-                commandBuffer.pipelineBarrier(drawParams->srcStageMask, drawParams->dstStageMask, {}, {vk::MemoryBarrier{
-                    .srcAccessMask = vk::AccessFlagBits::eMemoryWrite,
-                    .dstAccessMask = vk::AccessFlagBits::eMemoryRead | vk::AccessFlagBits::eMemoryWrite
-                }}, {}, {});
+            for (auto *dispatch{&batch->first}; dispatch; dispatch = dispatch->next) {
+                if (dispatch->srcStageMask && dispatch->dstStageMask)
+                    commandBuffer.pipelineBarrier(dispatch->srcStageMask, dispatch->dstStageMask, {}, {vk::MemoryBarrier{
+                        .srcAccessMask = vk::AccessFlagBits::eMemoryWrite,
+                        .dstAccessMask = vk::AccessFlagBits::eMemoryRead | vk::AccessFlagBits::eMemoryWrite
+                    }}, {}, {});
 
-            commandBuffer.dispatch(drawParams->dimensions[0], drawParams->dimensions[1], drawParams->dimensions[2]);
+                commandBuffer.dispatch(dispatch->dimensions[0], dispatch->dimensions[1], dispatch->dimensions[2]);
+            }
         });
+
+        activeBatch = batch;
+        activeBatchNode = ctx.executor.GetLastNode();
+        activeBatchPipeline = pipeline;
+        std::swap(activeBatchKey, descriptorSetKey);
+
         ctx.executor.AddCheckpoint("After dispatch");
     }
 }
\ No newline at end of file
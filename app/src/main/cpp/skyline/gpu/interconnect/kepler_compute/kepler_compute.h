@@ -25,12 +25,25 @@ namespace skyline::gpu::interconnect::kepler_compute {
         };
 
       private:
+        struct DispatchBatch; //!< Consecutive dispatches that use the same pipeline and descriptor set contents, these are recorded as a single command with state only being bound once
+
         InterconnectContext ctx;
         PipelineState pipelineState;
         ConstantBuffers constantBuffers;
         Samplers samplers;
         Textures textures;
 
+        DispatchBatch *activeBatch{}; //!< The batch of the previous dispatch, subsequent dispatches can only be appended to it while its command is the last node in the execution
+        const void *activeBatchNode{}; //!< The executor node of the active batch's command
+        Pipeline *activeBatchPipeline{};
+        std::vector<u64> activeBatchKey; //!< The descriptor set key of the active batch
+        std::vector<u64> descriptorSetKey; //!< Scratch storage for the key of the current dispatch's descriptor set
+
+        /**
+         * @return If the dispatch could be appended to the active batch without any state being rebound
+         */
+        bool TryAppendToBatch(Pipeline *pipeline, DescriptorUpdateInfo *descUpdateInfo, const QMD &qmd, vk::PipelineStageFlags srcStageMask, vk::PipelineStageFlags dstStageMask);
+
       public:
         KeplerCompute(GPU &gpu,
                       soc::gm20b::ChannelContext &channelCtx,
@@ -1,6 +1,7 @@
 // SPDX-License-Identifier: MPL-2.0
 // Copyright © 2022 Skyline Team and Contributors (https://github.com/skyline-emu/)
 
+#include <common/trace.h>
 #include <gpu/texture/texture.h>
 #include <gpu/interconnect/command_executor.h>
 #include <gpu/interconnect/common/pipeline.inc>
@@ -9,9 +10,10 @@
 #include "pipeline_manager.h"
 
 namespace skyline::gpu::interconnect::kepler_compute {
-    static Pipeline::ShaderStage MakePipelineShader(InterconnectContext &ctx, Textures &textures, ConstantBufferSet &constantBuffers, const PackedPipelineState &packedState, const ShaderBinary &shaderBinary) {
+    static Pipeline::ShaderStage MakePipelineShader(InterconnectContext &ctx, Textures &textures, ConstantBufferSet &constantBuffers, const PackedPipelineState &packedState, const ShaderBinary &shaderBinary, PipelineCompileTimings &timings) {
         ctx.gpu.shader->ResetPools();
 
+        u64 programHash{};
         auto program{ctx.gpu.shader->ParseComputeShader(
             packedState.shaderHash, shaderBinary.binary, shaderBinary.baseOffset,
             packedState.bindlessTextureConstantBufferSlotSelect,
@@ -21,11 +23,11 @@ namespace skyline::gpu::interconnect::kepler_compute {
                 return constantBuffers[index].Read<int>(ctx.executor, offset);
             }, [&](u32 index) {
                 return textures.GetTextureType(ctx, BindlessHandle{ .raw = index }.textureIndex);
-            })};
+            }, &timings, &programHash)};
 
         Shader::Backend::Bindings bindings{};
 
-        return {ctx.gpu.shader->CompileShader({}, program, bindings, packedState.shaderHash), program.info};
+        return {ctx.gpu.shader->CompileShader({}, program, bindings, packedState.shaderHash, nullptr, &timings, programHash), program.info};
     }
 
     static Pipeline::DescriptorInfo MakePipelineDescriptorInfo(const Pipeline::ShaderStage &stage) {
@@ -67,7 +69,8 @@ namespace skyline::gpu::interconnect::kepler_compute {
     static Pipeline::CompiledPipeline MakeCompiledPipeline(InterconnectContext &ctx,
                                                                                const PackedPipelineState &packedState,
                                                                                const Pipeline::ShaderStage &shaderStage,
-                                                                               span<vk::DescriptorSetLayoutBinding> layoutBindings) {
+                                                                               span<vk::DescriptorSetLayoutBinding> layoutBindings,
+                                                                               PipelineCompileTimings &timings) {
         vk::raii::DescriptorSetLayout descriptorSetLayout{ctx.gpu.vkDevice, vk::DescriptorSetLayoutCreateInfo{
             .flags = vk::DescriptorSetLayoutCreateFlags{ctx.gpu.traits.supportsPushDescriptors ? vk::DescriptorSetLayoutCreateFlagBits::ePushDescriptorKHR : vk::DescriptorSetLayoutCreateFlags{}},
             .pBindings = layoutBindings.data(),
@@ -94,7 +97,13 @@ namespace skyline::gpu::interconnect::kepler_compute {
         if (ctx.gpu.traits.quirks.brokenMultithreadedPipelineCompilation)
             ctx.gpu.graphicsPipelineAssembler->WaitIdle();
 
-        vk::raii::Pipeline pipeline{ctx.gpu.vkDevice, nullptr, pipelineInfo};
+        auto startNs{util::GetTimeNs()};
+        vk::raii::Pipeline pipeline{[&]() {
+            TRACE_EVENT("gpu", "vkCreateComputePipelines", "hash", packedState.shaderHash);
+            return vk::raii::Pipeline{ctx.gpu.vkDevice, nullptr, pipelineInfo};
+        }()};
+        timings.pipelineNs = util::GetTimeNs() - startNs;
+        ShaderStats.Record(ShaderTelemetry::PipelineType::Compute, timings);
 
         return Pipeline::CompiledPipeline{
             .pipeline = std::move(pipeline),
@@ -104,9 +113,12 @@ namespace skyline::gpu::interconnect::kepler_compute {
     }
 
     Pipeline::Pipeline(InterconnectContext &ctx, Textures &textures, ConstantBufferSet &constantBuffers, const PackedPipelineState &packedState, const ShaderBinary &shaderBinary)
-        : shaderStage{MakePipelineShader(ctx, textures, constantBuffers, packedState, shaderBinary)},
+        : Pipeline{ctx, textures, constantBuffers, packedState, shaderBinary, PipelineCompileTimings{}} {}
+
+    Pipeline::Pipeline(InterconnectContext &ctx, Textures &textures, ConstantBufferSet &constantBuffers, const PackedPipelineState &packedState, const ShaderBinary &shaderBinary, PipelineCompileTimings &&timings)
+        : shaderStage{MakePipelineShader(ctx, textures, constantBuffers, packedState, shaderBinary, timings)},
           descriptorInfo{MakePipelineDescriptorInfo(shaderStage)},
-          compiledPipeline{MakeCompiledPipeline(ctx, packedState, shaderStage, descriptorInfo.descriptorSetLayoutBindings)},
+          compiledPipeline{MakeCompiledPipeline(ctx, packedState, shaderStage, descriptorInfo.descriptorSetLayoutBindings, timings)},
           sourcePackedState{packedState} {
         storageBufferViews.resize(shaderStage.info.storage_buffers_descriptors.size());
     }
@@ -209,6 +221,7 @@ namespace skyline::gpu::interconnect::kepler_compute {
             .writes = writes.first(writeIdx),
             .bufferDescs = bufferDescs.first(bufferIdx),
             .bufferDescDynamicBindings = bufferDescDynamicBindings.first(bufferIdx),
+            .imageDescs = imageDescs.first(imageIdx),
             .pipelineLayout = *compiledPipeline.pipelineLayout,
             .descriptorSetLayout = *compiledPipeline.descriptorSetLayout,
             .bindPoint = vk::PipelineBindPoint::eCompute,
@@ -7,6 +7,7 @@
 #include <shader_compiler/frontend/ir/program.h>
 #include <gpu/interconnect/common/samplers.h>
 #include <gpu/interconnect/common/textures.h>
+#include <gpu/shader_telemetry.h>
 #include "packed_pipeline_state.h"
 #include "constant_buffers.h"
 
@@ -45,6 +46,11 @@ namespace skyline::gpu::interconnect::kepler_compute {
 
         void SyncCachedStorageBufferViews(ContextTag executionTag);
 
+        /**
+         * @param timings The timings of each compilation stage, these are accumulated by the member initializers and recorded once the pipeline is compiled
+         */
+        Pipeline(InterconnectContext &ctx, Textures &textures, ConstantBufferSet &constantBuffers, const PackedPipelineState &packedState, const ShaderBinary &shaderBinary, PipelineCompileTimings &&timings);
+
       public:
         CompiledPipeline compiledPipeline;
 
@@ -49,6 +49,7 @@ namespace skyline::gpu::interconnect::kepler_compute {
         const engine_common::BindlessTexture &bindlessTexture;
 
         PackedPipelineState packedState{};
+        Pipeline *pipeline{}; //!< The pipeline used by the previous dispatch, consecutive dispatches from the same QMD state reuse this without a pipeline lookup
 
       public:
         PipelineState(DirtyManager &manager, const EngineRegisters &engine);
@@ -5,11 +5,14 @@
 
 #include <limits>
 #include <range/v3/algorithm.hpp>
+#include <common/settings.h>
 #include <soc/gm20b/channel.h>
 #include <soc/gm20b/gmmu.h>
+#include <gpu.h>
 #include <gpu/buffer_manager.h>
 #include <gpu/interconnect/command_executor.h>
 #include <gpu/interconnect/conversion/quads.h>
+#include <gpu/interconnect/conversion/index_widening.h>
 #include <gpu/interconnect/common/state_updater.h>
 #include "common.h"
 #include "active_state.h"
@@ -31,7 +34,7 @@ namespace skyline::gpu::interconnect::maxwell3d {
                 ctx.executor.AttachBuffer(*view);
                 view->GetBuffer()->PopulateReadBarrier(vk::PipelineStageFlagBits::eVertexInput, srcStageMask, dstStageMask);
 
-                if (megaBufferBinding = view->TryMegaBuffer(ctx.executor.cycle, ctx.gpu.megaBufferAllocator, ctx.executor.executionTag);
+                if (megaBufferBinding = view->TryMegaBuffer(ctx.executor.cycle, *ctx.executor.megaBufferAllocator, ctx.executor.executionTag);
                     megaBufferBinding)
                     builder.SetVertexBuffer(index, megaBufferBinding, ctx.gpu.traits.supportsExtendedDynamicState, engine->vertexStream.format.stride);
                 else
@@ -47,7 +50,7 @@ namespace skyline::gpu::interconnect::maxwell3d {
         if (ctx.gpu.traits.supportsNullDescriptor)
             builder.SetVertexBuffer(index, BufferBinding{}, ctx.gpu.traits.supportsExtendedDynamicState, engine->vertexStream.format.stride);
         else
-            builder.SetVertexBuffer(index, {ctx.gpu.megaBufferAllocator.Allocate(ctx.executor.cycle, 0).buffer}, ctx.gpu.traits.supportsExtendedDynamicState, engine->vertexStream.format.stride);
+            builder.SetVertexBuffer(index, {ctx.executor.megaBufferAllocator->Allocate(ctx.executor.cycle, 0).buffer}, ctx.gpu.traits.supportsExtendedDynamicState, engine->vertexStream.format.stride);
     }
 
     bool VertexBufferState::Refresh(InterconnectContext &ctx, StateUpdateBuilder &builder, vk::PipelineStageFlags &srcStageMask, vk::PipelineStageFlags &dstStageMask) {
@@ -55,7 +58,7 @@ namespace skyline::gpu::interconnect::maxwell3d {
             view->GetBuffer()->PopulateReadBarrier(vk::PipelineStageFlagBits::eVertexInput, srcStageMask, dstStageMask);
 
         if (megaBufferBinding) {
-            if (auto newMegaBufferBinding{view->TryMegaBuffer(ctx.executor.cycle, ctx.gpu.megaBufferAllocator, ctx.executor.executionTag)};
+            if (auto newMegaBufferBinding{view->TryMegaBuffer(ctx.executor.cycle, *ctx.executor.megaBufferAllocator, ctx.executor.executionTag)};
                 newMegaBufferBinding != megaBufferBinding) {
 
                 megaBufferBinding = newMegaBufferBinding;
@@ -100,7 +103,51 @@ namespace skyline::gpu::interconnect::maxwell3d {
         }
     }
 
-    static BufferBinding GenerateQuadConversionIndexBuffer(InterconnectContext &ctx, engine::IndexBuffer::IndexSize indexType, BufferView &view, u32 firstIndex, u32 elementCount) {
+    /**
+     * @brief Records a compute dispatch prior to the current render pass that expands the quads in the index buffer into a 32-bit triangle list index buffer in the megabuffer
+     */
+    static BufferBinding GenerateQuadConversionIndexBufferGpu(InterconnectContext &ctx, engine::IndexBuffer::IndexSize indexType, BufferView &view, u32 firstIndex, u32 elementCount) {
+        u32 indexSize{1U << static_cast<u32>(indexType)};
+        vk::DeviceSize alignment{ctx.gpu.traits.minimumStorageBufferAlignment};
+        vk::DeviceSize indexBufferSize{util::DivideCeil(elementCount, conversion::quads::QuadVertexCount) * conversion::quads::EmittedIndexCount * sizeof(u32)};
+        auto quadConversionAllocation{ctx.executor.megaBufferAllocator->Allocate(ctx.executor.cycle, indexBufferSize + alignment)};
+        vk::DescriptorBufferInfo dst{
+            .buffer = quadConversionAllocation.buffer,
+            .offset = util::AlignUp(quadConversionAllocation.offset, alignment),
+            .range = indexBufferSize,
+        };
+
+        // The guest index buffer is read on the GPU so it needs to be up to date with any sequenced writes
+        view.GetBuffer()->BlockSequencedCpuBackingWrites();
+
+        ctx.executor.InsertPreRpCommand([view, dst, firstOffset = firstIndex * indexSize, indexSize, elementCount](vk::raii::CommandBuffer &commandBuffer, const std::shared_ptr<FenceCycle> &cycle, GPU &gpu) {
+            auto binding{view.GetBinding(gpu)};
+            vk::DeviceSize offset{binding.offset + firstOffset};
+            vk::DeviceSize padding{offset & (gpu.traits.minimumStorageBufferAlignment - 1)};
+            vk::DescriptorBufferInfo src{
+                .buffer = binding.buffer,
+                .offset = offset - padding,
+                .range = util::AlignUp(padding + elementCount * indexSize, sizeof(u32)),
+            };
+
+            gpu.helperShaders.quadConversionHelperShader.Convert(gpu, commandBuffer, cycle, src, dst, static_cast<u32>(padding), indexSize, elementCount);
+        });
+
+        return {dst.buffer, dst.offset, indexBufferSize};
+    }
+
+    /**
+     * @brief Generates an index buffer for drawing the quads in the index buffer as a triangle list
+     * @param hostIndexType The type of the indices in the returned buffer, this may differ from the guest index type
+     */
+    static BufferBinding GenerateQuadConversionIndexBuffer(InterconnectContext &ctx, engine::IndexBuffer::IndexSize indexType, BufferView &view, u32 firstIndex, u32 elementCount, vk::IndexType &hostIndexType) {
+        // The GPU path always emits 32-bit indices so it's used regardless of the setting when 8-bit indices can't be consumed directly
+        if (*ctx.gpu.state.settings->gpuQuadConversion || (indexType == engine::IndexBuffer::IndexSize::OneByte && !ctx.gpu.traits.supportsUint8Indices)) {
+            hostIndexType = vk::IndexType::eUint32;
+            return GenerateQuadConversionIndexBufferGpu(ctx, indexType, view, firstIndex, elementCount);
+        }
+
+        hostIndexType = ConvertIndexType(indexType);
         auto viewSpan{view.GetReadOnlyBackingSpan(false /* We attach above so always false */, []() {
             // TODO: see Read()
             Logger::Error("Dirty index buffer reads for attached buffers are unimplemented");
@@ -108,14 +155,94 @@ namespace skyline::gpu::interconnect::maxwell3d {
 
         size_t indexSize{1U << static_cast<u32>(indexType)};
         vk::DeviceSize indexBufferSize{conversion::quads::GetRequiredBufferSize(elementCount, indexSize)};
-        auto quadConversionAllocation{ctx.gpu.megaBufferAllocator.Allocate(ctx.executor.cycle, indexBufferSize)};
+        auto quadConversionAllocation{ctx.executor.megaBufferAllocator->Allocate(ctx.executor.cycle, indexBufferSize)};
 
         conversion::quads::GenerateIndexedQuadConversionBuffer(quadConversionAllocation.region.data(), viewSpan.subspan(GetIndexBufferSize(indexType, firstIndex)).data(), elementCount, ConvertIndexType(indexType));
 
         return {quadConversionAllocation.buffer, quadConversionAllocation.offset, indexBufferSize};
     }
 
+    /**
+     * @brief Records a compute dispatch prior to the current render pass that widens the 8-bit indices in the index buffer into a 16-bit index buffer in the megabuffer
+     */
+    static BufferBinding GenerateWidenedIndexBufferGpu(InterconnectContext &ctx, BufferView &view, u32 indexCount) {
+        vk::DeviceSize alignment{ctx.gpu.traits.minimumStorageBufferAlignment};
+        vk::DeviceSize indexBufferSize{util::AlignUp(conversion::index_widening::GetRequiredBufferSize(indexCount), sizeof(u32))};
+        auto widenedAllocation{ctx.executor.megaBufferAllocator->Allocate(ctx.executor.cycle, indexBufferSize + alignment)};
+        vk::DescriptorBufferInfo dst{
+            .buffer = widenedAllocation.buffer,
+            .offset = util::AlignUp(widenedAllocation.offset, alignment),
+            .range = indexBufferSize,
+        };
+
+        // The guest index buffer is read on the GPU so it needs to be up to date with any sequenced writes
+        view.GetBuffer()->BlockSequencedCpuBackingWrites();
+
+        ctx.executor.InsertPreRpCommand([view, dst, indexCount](vk::raii::CommandBuffer &commandBuffer, const std::shared_ptr<FenceCycle> &cycle, GPU &gpu) {
+            auto binding{view.GetBinding(gpu)};
+            vk::DeviceSize padding{binding.offset & (gpu.traits.minimumStorageBufferAlignment - 1)};
+            vk::DescriptorBufferInfo src{
+                .buffer = binding.buffer,
+                .offset = binding.offset - padding,
+                .range = util::AlignUp(padding + indexCount, sizeof(u32)),
+            };
+
+            gpu.helperShaders.indexWideningHelperShader.Widen(gpu, commandBuffer, cycle, src, dst, static_cast<u32>(padding), indexCount);
+        });
+
+        return {dst.buffer, dst.offset, indexBufferSize};
+    }
+
     /* Index Buffer */
+    BufferBinding IndexBufferState::GenerateWidenedIndexBuffer(InterconnectContext &ctx, u32 indexCount) {
+        Buffer *buffer{view->GetBuffer()};
+        if (!buffer->SequenceIdentifiesContents())
+            return GenerateWidenedIndexBufferGpu(ctx, *view, indexCount);
+
+        vk::DeviceSize offset{view->GetOffset()};
+        auto it{std::find_if(widenedIndexBuffers.begin(), widenedIndexBuffers.end(), [&](const WidenedIndexBuffer &entry) {
+            return entry.buffer == buffer && entry.offset == offset;
+        })};
+
+        if (it == widenedIndexBuffers.end() || it->bufferLifetime.expired()) {
+            if (it == widenedIndexBuffers.end()) {
+                if (widenedIndexBuffers.size() < WidenedIndexBufferCacheSize)
+                    it = widenedIndexBuffers.emplace(widenedIndexBuffers.end());
+                else
+                    it = std::min_element(widenedIndexBuffers.begin(), widenedIndexBuffers.end(), [](const WidenedIndexBuffer &a, const WidenedIndexBuffer &b) { return a.lastUseTag < b.lastUseTag; });
+            }
+
+            *it = WidenedIndexBuffer{
+                .buffer = buffer,
+                .bufferLifetime = buffer->shared_from_this(),
+                .offset = offset,
+            };
+        }
+
+        u32 sequenceNumber{buffer->GetSequenceNumber()};
+        if (!it->widened || it->sequenceNumber != sequenceNumber || it->indexCount < indexCount) {
+            auto viewSpan{view->GetReadOnlyBackingSpan(false /* We attach above so always false */, []() {
+                // TODO: see Read()
+                Logger::Error("Dirty index buffer reads for attached buffers are unimplemented");
+            })};
+
+            // A new allocation is always used as the prior one may still be in use by the GPU
+            it->widened = std::make_shared<memory::Buffer>(ctx.gpu.memory.AllocateBuffer(conversion::index_widening::GetRequiredBufferSize(indexCount)));
+            conversion::index_widening::WidenIndexBuffer(it->widened->cast<u16>().data(), viewSpan.data(), indexCount);
+            it->indexCount = indexCount;
+            it->sequenceNumber = sequenceNumber;
+            it->attachedExecutionTag = {};
+        }
+
+        if (it->attachedExecutionTag != ctx.executor.executionTag) {
+            ctx.executor.AttachDependency(it->widened);
+            it->attachedExecutionTag = ctx.executor.executionTag;
+        }
+
+        it->lastUseTag = ++widenedUseCounter;
+        return {it->widened->vkBuffer, 0, conversion::index_widening::GetRequiredBufferSize(it->indexCount)};
+    }
+
     void IndexBufferState::EngineRegisters::DirtyBind(DirtyManager &manager, dirty::Handle handle) const {
         manager.Bind(handle, indexBuffer.indexSize, indexBuffer.address, indexBuffer.limit);
     }
@@ -146,10 +273,14 @@ namespace skyline::gpu::interconnect::maxwell3d {
 
         indexType = ConvertIndexType(engine->indexBuffer.indexSize);
 
-        if (quadConversion)
-            megaBufferBinding = GenerateQuadConversionIndexBuffer(ctx, engine->indexBuffer.indexSize, *view, firstIndex, elementCount);
-        else
-            megaBufferBinding = view->TryMegaBuffer(ctx.executor.cycle, ctx.gpu.megaBufferAllocator, ctx.executor.executionTag);
+        if (quadConversion) {
+            megaBufferBinding = GenerateQuadConversionIndexBuffer(ctx, engine->indexBuffer.indexSize, *view, firstIndex, elementCount, indexType);
+        } else if (engine->indexBuffer.indexSize == engine::IndexBuffer::IndexSize::OneByte && !ctx.gpu.traits.supportsUint8Indices) {
+            megaBufferBinding = GenerateWidenedIndexBuffer(ctx, static_cast<u32>(view->size));
+            indexType = vk::IndexType::eUint16;
+        } else {
+            megaBufferBinding = view->TryMegaBuffer(ctx.executor.cycle, *ctx.executor.megaBufferAllocator, ctx.executor.executionTag);
+        }
 
         if (megaBufferBinding)
             builder.SetIndexBuffer(megaBufferBinding, indexType);
@@ -166,10 +297,14 @@ namespace skyline::gpu::interconnect::maxwell3d {
 
         // TODO: optimise this to use buffer sequencing to avoid needing to regenerate the quad buffer every time. We can't use as it is rn though because sequences aren't globally unique and may conflict after buffer recreation
         if (usedQuadConversion) {
-            megaBufferBinding = GenerateQuadConversionIndexBuffer(ctx, engine->indexBuffer.indexSize, *view, firstIndex, elementCount);
+            megaBufferBinding = GenerateQuadConversionIndexBuffer(ctx, engine->indexBuffer.indexSize, *view, firstIndex, elementCount, indexType);
+            builder.SetIndexBuffer(megaBufferBinding, indexType);
+        } else if (engine->indexBuffer.indexSize == engine::IndexBuffer::IndexSize::OneByte && !ctx.gpu.traits.supportsUint8Indices) {
+            // The widened indices are regenerated for the same range as the initial flush, this is served from the cache when the contents are unchanged
+            megaBufferBinding = GenerateWidenedIndexBuffer(ctx, static_cast<u32>(view->size));
             builder.SetIndexBuffer(megaBufferBinding, indexType);
         } else if (megaBufferBinding) {
-            if (auto newMegaBufferBinding{view->TryMegaBuffer(ctx.executor.cycle, ctx.gpu.megaBufferAllocator, ctx.executor.executionTag)};
+            if (auto newMegaBufferBinding{view->TryMegaBuffer(ctx.executor.cycle, *ctx.executor.megaBufferAllocator, ctx.executor.executionTag)};
                 newMegaBufferBinding != megaBufferBinding) {
 
                 megaBufferBinding = newMegaBufferBinding;
@@ -217,7 +352,7 @@ namespace skyline::gpu::interconnect::maxwell3d {
             }
 
             // Bind an empty buffer ourselves since Vulkan doesn't support passing a VK_NULL_HANDLE xfb buffer
-            builder.SetTransformFeedbackBuffer(index, {ctx.gpu.megaBufferAllocator.Allocate(ctx.executor.cycle, 0).buffer});
+            builder.SetTransformFeedbackBuffer(index, {ctx.executor.megaBufferAllocator->Allocate(ctx.executor.cycle, 0).buffer});
         }
     }
 
@@ -284,12 +419,20 @@ namespace skyline::gpu::interconnect::maxwell3d {
         return vkViewport;
     }
 
-    void ViewportState::Flush(InterconnectContext &ctx, StateUpdateBuilder &builder) {
+    void ViewportState::Flush(InterconnectContext &ctx, StateUpdateBuilder &builder, float renderScale) {
         if (index != 0 && !ctx.gpu.traits.supportsMultipleViewports)
             return;
 
+        auto setViewport{[&](vk::Viewport viewport) {
+            viewport.x *= renderScale;
+            viewport.y *= renderScale;
+            viewport.width *= renderScale;
+            viewport.height *= renderScale;
+            builder.SetViewport(index, viewport);
+        }};
+
         if (!engine->viewportScaleOffsetEnable) {
-            builder.SetViewport(index, vk::Viewport{
+            setViewport(vk::Viewport{
                 .x = static_cast<float>(engine->surfaceClip.horizontal.x),
                 .y = static_cast<float>(engine->surfaceClip.vertical.y),
                 .width = engine->surfaceClip.horizontal.width ? static_cast<float>(engine->surfaceClip.horizontal.width) : 1.0f,
@@ -298,9 +441,9 @@ namespace skyline::gpu::interconnect::maxwell3d {
                 .maxDepth = 1.0f,
             });
         } else if (engine->viewport.scaleX == 0.0f || engine->viewport.scaleY == 0.0f) {
-            builder.SetViewport(index, ConvertViewport(engine->viewport0, engine->viewportClip0, engine->windowOrigin, engine->viewportScaleOffsetEnable));
+            setViewport(ConvertViewport(engine->viewport0, engine->viewportClip0, engine->windowOrigin, engine->viewportScaleOffsetEnable));
         } else {
-            builder.SetViewport(index, ConvertViewport(engine->viewport, engine->viewportClip, engine->windowOrigin, engine->viewportScaleOffsetEnable));
+            setViewport(ConvertViewport(engine->viewport, engine->viewportClip, engine->windowOrigin, engine->viewportScaleOffsetEnable));
         }
     }
 
@@ -311,11 +454,11 @@ namespace skyline::gpu::interconnect::maxwell3d {
 
     ScissorState::ScissorState(dirty::Handle dirtyHandle, DirtyManager &manager, const EngineRegisters &engine, u32 index) : engine{manager, dirtyHandle, engine}, index{index} {}
 
-    void ScissorState::Flush(InterconnectContext &ctx, StateUpdateBuilder &builder) {
+    void ScissorState::Flush(InterconnectContext &ctx, StateUpdateBuilder &builder, float renderScale) {
         if (index != 0 && !ctx.gpu.traits.supportsMultipleViewports)
             return;
 
-        builder.SetScissor(index, [&]() {
+        builder.SetScissor(index, texture::ScaleRect([&]() {
             if (engine->scissor.enable) {
                 const auto &vertical{engine->scissor.vertical};
                 const auto &horizontal{engine->scissor.horizontal};
@@ -336,7 +479,7 @@ namespace skyline::gpu::interconnect::maxwell3d {
                     .extent.width = std::numeric_limits<i32>::max(),
                 };
             }
-        }());
+        }(), renderScale));
     }
 
     /* Line Width */
@@ -402,18 +545,98 @@ namespace skyline::gpu::interconnect::maxwell3d {
             builder.SetBaseStencilState(vk::StencilFaceFlagBits::eBack, engine->backStencilValues.funcRef, engine->backStencilValues.funcMask, engine->backStencilValues.mask);
     }
 
+    /* Extended Dynamic State */
+    void ExtendedDynamicState::EngineRegisters::DirtyBind(DirtyManager &manager, dirty::Handle handle) const {
+        manager.Bind(handle, oglCullEnable, oglCullFace, oglFrontFace, windowOrigin, depthTestEnable, depthWriteEnable, depthFunc, depthBoundsTestEnable, stencilTestEnable, twoSidedStencilTestEnable, stencilOps, stencilBack);
+    }
+
+    ExtendedDynamicState::ExtendedDynamicState(dirty::Handle dirtyHandle, DirtyManager &manager, const EngineRegisters &engine) : engine{manager, dirtyHandle, engine} {}
+
+    static vk::StencilOpState ConvertStencilOpState(engine::StencilOps ops) {
+        return {
+            .failOp = ConvertStencilOp(ops.fail),
+            .passOp = ConvertStencilOp(ops.zPass),
+            .depthFailOp = ConvertStencilOp(ops.zFail),
+            .compareOp = ConvertCompareFunc(ops.func),
+        };
+    }
+
+    void ExtendedDynamicState::Flush(InterconnectContext &ctx, StateUpdateBuilder &builder) {
+        if (!ctx.gpu.traits.supportsExtendedDynamicState)
+            return;
+
+        // The front face needs to match the Y flip transformation that's applied in the shader, see RasterizationState
+        bool frontFaceClockwise{engine->windowOrigin.flipY != (engine->oglFrontFace == engine::FrontFace::CW)};
+        builder.SetCullState(ConvertCullMode(engine->oglCullEnable, engine->oglCullFace), frontFaceClockwise ? vk::FrontFace::eClockwise : vk::FrontFace::eCounterClockwise);
+
+        vk::StencilOpState front{}, back{};
+        if (engine->stencilTestEnable) {
+            front = ConvertStencilOpState(engine->stencilOps);
+            back = ConvertStencilOpState(engine->twoSidedStencilTestEnable ? engine->stencilBack : engine->stencilOps);
+        } else {
+            front.compareOp = back.compareOp = vk::CompareOp::eAlways;
+        }
+
+        builder.SetDepthStencilState(engine->depthTestEnable, engine->depthWriteEnable,
+                                     engine->depthTestEnable ? ConvertCompareFunc(engine->depthFunc) : vk::CompareOp::eAlways,
+                                     engine->depthBoundsTestEnable, engine->stencilTestEnable, front, back);
+    }
+
+    /* Vertex Input Layout */
+    VertexInputLayoutState::VertexInputLayoutState(dirty::Handle dirtyHandle, DirtyManager &manager, const VertexInputState::EngineRegisters &engine) : engine{manager, dirtyHandle, engine} {}
+
+    void VertexInputLayoutState::Flush(InterconnectContext &ctx, StateUpdateBuilder &builder) {
+        if (!ctx.gpu.traits.supportsVertexInputDynamicState)
+            return;
+
+        auto bindings{ctx.executor.allocator->AllocateUntracked<vk::VertexInputBindingDescription2EXT>(engine::VertexStreamCount)};
+        for (u32 i{}; i < engine::VertexStreamCount; i++) {
+            const auto &stream{engine->vertexStreams[i]};
+            bool instanced{engine->vertexStreamInstance[i].isInstanced};
+
+            // Unsupported divisors fall back to a divisor of 1, matching the behaviour of the static pipeline path
+            u32 divisor{1};
+            if (instanced && ctx.gpu.traits.supportsVertexAttributeDivisor && (stream.frequency || ctx.gpu.traits.supportsVertexAttributeZeroDivisor))
+                divisor = stream.frequency;
+
+            bindings[i] = vk::VertexInputBindingDescription2EXT{
+                .binding = i,
+                .stride = stream.format.stride,
+                .inputRate = instanced ? vk::VertexInputRate::eInstance : vk::VertexInputRate::eVertex,
+                .divisor = divisor,
+            };
+        }
+
+        auto attributes{ctx.executor.allocator->AllocateUntracked<vk::VertexInputAttributeDescription2EXT>(engine::VertexAttributeCount)};
+        u32 attributeCount{};
+        for (u32 i{}; i < engine::VertexAttributeCount; i++) {
+            const auto &attribute{engine->vertexAttributes[i]};
+            if (attribute.source == engine::VertexAttribute::Source::Active)
+                attributes[attributeCount++] = vk::VertexInputAttributeDescription2EXT{
+                    .location = i,
+                    .binding = attribute.stream,
+                    .format = ConvertVertexInputAttributeFormat(attribute.componentBitWidths, attribute.numericalType),
+                    .offset = attribute.offset,
+                };
+        }
+
+        builder.SetVertexInput(bindings, attributes.first(attributeCount));
+    }
+
     ActiveState::ActiveState(DirtyManager &manager, const EngineRegisters &engineRegisters)
         : pipeline{manager, engineRegisters.pipelineRegisters},
           vertexBuffers{util::MergeInto<dirty::ManualDirtyState<VertexBufferState>, engine::VertexStreamCount>(manager, engineRegisters.vertexBuffersRegisters, util::IncrementingT<u32>{})},
           indexBuffer{manager, engineRegisters.indexBufferRegisters},
           transformFeedbackBuffers{util::MergeInto<dirty::ManualDirtyState<TransformFeedbackBufferState>, engine::StreamOutBufferCount>(manager, engineRegisters.transformFeedbackBuffersRegisters, util::IncrementingT<u32>{})},
-          viewports{util::MergeInto<dirty::ManualDirtyState<ViewportState>, engine::ViewportCount>(manager, engineRegisters.viewportsRegisters, util::IncrementingT<u32>{})},
-          scissors{util::MergeInto<dirty::ManualDirtyState<ScissorState>, engine::ViewportCount>(manager, engineRegisters.scissorsRegisters, util::IncrementingT<u32>{})},
-          lineWidth{manager, engineRegisters.lineWidthRegisters},
-          depthBias{manager, engineRegisters.depthBiasRegisters},
-          blendConstants{manager, engineRegisters.blendConstantsRegisters},
-          depthBounds{manager, engineRegisters.depthBoundsRegisters},
-          stencilValues{manager, engineRegisters.stencilValuesRegisters},
+          viewports{util::MergeInto<dirty::ManualDirtyState<ViewportState>, engine::ViewportCount>(dirtyBitmap.GetSlot(ViewportsBit), manager, engineRegisters.viewportsRegisters, util::IncrementingT<u32>{})},
+          scissors{util::MergeInto<dirty::ManualDirtyState<ScissorState>, engine::ViewportCount>(dirtyBitmap.GetSlot(ScissorsBit), manager, engineRegisters.scissorsRegisters, util::IncrementingT<u32>{})},
+          lineWidth{dirtyBitmap.GetSlot(LineWidthBit), manager, engineRegisters.lineWidthRegisters},
+          depthBias{dirtyBitmap.GetSlot(DepthBiasBit), manager, engineRegisters.depthBiasRegisters},
+          blendConstants{dirtyBitmap.GetSlot(BlendConstantsBit), manager, engineRegisters.blendConstantsRegisters},
+          depthBounds{dirtyBitmap.GetSlot(DepthBoundsBit), manager, engineRegisters.depthBoundsRegisters},
+          stencilValues{dirtyBitmap.GetSlot(StencilValuesBit), manager, engineRegisters.stencilValuesRegisters},
+          extendedDynamicState{dirtyBitmap.GetSlot(ExtendedDynamicStateBit), manager, engineRegisters.extendedDynamicStateRegisters},
+          vertexInputLayout{dirtyBitmap.GetSlot(VertexInputLayoutBit), manager, engineRegisters.vertexInputLayoutRegisters},
           directState{pipeline.Get().directState} {}
 
     void ActiveState::MarkAllDirty() {
@@ -430,6 +653,8 @@ namespace skyline::gpu::interconnect::maxwell3d {
         dirtyFunc(blendConstants);
         dirtyFunc(depthBounds);
         dirtyFunc(stencilValues);
+        dirtyFunc(extendedDynamicState);
+        dirtyFunc(vertexInputLayout);
     }
 
     void ActiveState::Update(InterconnectContext &ctx, Textures &textures, ConstantBufferSet &constantBuffers, StateUpdateBuilder &builder,
@@ -445,17 +670,53 @@ namespace skyline::gpu::interconnect::maxwell3d {
         auto updateFuncBuffer{[&](auto &stateElem, auto &&... args) { stateElem.Update(ctx, builder, srcStageMask, dstStageMask, args...); }};
 
         pipeline.Update(ctx, textures, constantBuffers, builder);
+
+        // Viewports and scissors are specified in guest texels so they need to be flushed again whenever the render scale of the attachments changes
+        if (float attachmentRenderScale{GetRenderScale()}; attachmentRenderScale != renderScale) {
+            renderScale = attachmentRenderScale;
+            ranges::for_each(viewports, [](auto &viewport) { viewport.MarkDirty(false); });
+            ranges::for_each(scissors, [](auto &scissor) { scissor.MarkDirty(false); });
+        }
+
         ranges::for_each(vertexBuffers, updateFuncBuffer);
         if (indexed)
             updateFuncBuffer(indexBuffer, directState.inputAssembly.NeedsQuadConversion(), estimateIndexBufferSize, drawFirstIndex, drawElementCount);
         ranges::for_each(transformFeedbackBuffers, updateFuncBuffer);
-        ranges::for_each(viewports, updateFunc);
-        ranges::for_each(scissors, updateFunc);
-        updateFunc(lineWidth);
-        updateFunc(depthBias);
-        updateFunc(blendConstants);
-        updateFunc(depthBounds);
-        updateFunc(stencilValues);
+
+        // Only visit the states that have been marked dirty since the last draw, as most draws don't modify any of them
+        dirtyBitmap.ConsumeSet([&](u32 bit) {
+            if (bit < ScissorsBit) {
+                updateFunc(viewports[bit - ViewportsBit], renderScale);
+            } else if (bit < LineWidthBit) {
+                updateFunc(scissors[bit - ScissorsBit], renderScale);
+            } else {
+                switch (bit) {
+                    case LineWidthBit:
+                        updateFunc(lineWidth);
+                        break;
+                    case DepthBiasBit:
+                        updateFunc(depthBias);
+                        break;
+                    case BlendConstantsBit:
+                        updateFunc(blendConstants);
+                        break;
+                    case DepthBoundsBit:
+                        updateFunc(depthBounds);
+                        break;
+                    case StencilValuesBit:
+                        updateFunc(stencilValues);
+                        break;
+                    case ExtendedDynamicStateBit:
+                        updateFunc(extendedDynamicState);
+                        break;
+                    case VertexInputLayoutBit:
+                        updateFunc(vertexInputLayout);
+                        break;
+                    default:
+                        break;
+                }
+            }
+        });
     }
 
     Pipeline *ActiveState::GetPipeline() {
@@ -470,6 +731,15 @@ namespace skyline::gpu::interconnect::maxwell3d {
         return pipeline.Get().depthAttachment;
     }
 
+    float ActiveState::GetRenderScale() {
+        auto &pipelineState{pipeline.Get()};
+        for (auto attachment : pipelineState.colorAttachments)
+            if (attachment)
+                return attachment->texture->renderScale;
+
+        return pipelineState.depthAttachment ? pipelineState.depthAttachment->texture->renderScale : 1.0f;
+    }
+
     std::shared_ptr<TextureView> ActiveState::GetColorRenderTargetForClear(InterconnectContext &ctx, size_t index) {
         return pipeline.Get().GetColorRenderTargetForClear(ctx, index);
     }
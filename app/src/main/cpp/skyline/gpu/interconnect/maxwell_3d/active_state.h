@@ -52,6 +52,30 @@ namespace skyline::gpu::interconnect::maxwell3d {
         u32 usedFirstIndex{};
         bool usedQuadConversion{};
 
+        /**
+         * @brief A 16-bit index buffer created by widening an 8-bit guest index buffer with known contents
+         */
+        struct WidenedIndexBuffer {
+            Buffer *buffer; //!< The guest buffer the indices were read from, this is only used for comparisons as it may have been destroyed
+            std::weak_ptr<Buffer> bufferLifetime; //!< Used to detect if `buffer` was destroyed, as a new buffer at the same address could otherwise be confused with it
+            vk::DeviceSize offset; //!< The offset of the first index in the guest buffer
+            u32 indexCount;
+            u32 sequenceNumber; //!< The sequence number of the guest buffer at the time of widening
+            std::shared_ptr<memory::Buffer> widened;
+            u64 lastUseTag; //!< The value of `widenedUseCounter` at the last use of this entry, used to evict the least recently used entry
+            ContextTag attachedExecutionTag; //!< The tag of the execution `widened` was last attached to
+        };
+
+        static constexpr size_t WidenedIndexBufferCacheSize{64}; //!< The maximum amount of widened index buffers retained by the cache
+        std::vector<WidenedIndexBuffer> widenedIndexBuffers; //!< A cache of widened index buffers to avoid redundantly widening static index buffers on every draw
+        u64 widenedUseCounter{};
+
+        /**
+         * @brief Generates a 16-bit index buffer from the 8-bit indices in the index buffer, this is used on devices that don't support 8-bit indices
+         * @note The widened indices are cached based on the sequence number of the guest buffer where possible, otherwise they are widened on the GPU
+         */
+        BufferBinding GenerateWidenedIndexBuffer(InterconnectContext &ctx, u32 indexCount);
+
       public:
         IndexBufferState(dirty::Handle dirtyHandle, DirtyManager &manager, const EngineRegisters &engine);
 
@@ -107,7 +131,10 @@ namespace skyline::gpu::interconnect::maxwell3d {
       public:
         ViewportState(dirty::Handle dirtyHandle, DirtyManager &manager, const EngineRegisters &engine, u32 index);
 
-        void Flush(InterconnectContext &ctx, StateUpdateBuilder &builder);
+        /**
+         * @param renderScale The render scale of the active attachments, the guest viewport is scaled by this
+         */
+        void Flush(InterconnectContext &ctx, StateUpdateBuilder &builder, float renderScale);
     };
 
     class ScissorState : dirty::ManualDirty {
@@ -125,7 +152,10 @@ namespace skyline::gpu::interconnect::maxwell3d {
       public:
         ScissorState(dirty::Handle dirtyHandle, DirtyManager &manager, const EngineRegisters &engine, u32 index);
 
-        void Flush(InterconnectContext &ctx, StateUpdateBuilder &builder);
+        /**
+         * @param renderScale The render scale of the active attachments, the guest scissor is scaled by this
+         */
+        void Flush(InterconnectContext &ctx, StateUpdateBuilder &builder, float renderScale);
     };
 
     struct LineWidthState : dirty::ManualDirty {
@@ -220,11 +250,74 @@ namespace skyline::gpu::interconnect::maxwell3d {
         void Flush(InterconnectContext &ctx, StateUpdateBuilder &builder);
     };
 
+    /**
+     * @brief State that's applied through VK_EXT_extended_dynamic_state rather than being baked into the pipeline, this avoids creating pipelines that only differ in this state
+     * @note This is a no-op on devices that lack the extension, the state is stored in PackedPipelineState in that case
+     */
+    class ExtendedDynamicState : dirty::ManualDirty {
+      public:
+        struct EngineRegisters {
+            const u32 &oglCullEnable;
+            const engine::CullFace &oglCullFace;
+            const engine::FrontFace &oglFrontFace;
+            const engine::WindowOrigin &windowOrigin;
+            const u32 &depthTestEnable;
+            const u32 &depthWriteEnable;
+            const engine::CompareFunc &depthFunc;
+            const u32 &depthBoundsTestEnable;
+            const u32 &stencilTestEnable;
+            const u32 &twoSidedStencilTestEnable;
+            const engine::StencilOps &stencilOps;
+            const engine::StencilOps &stencilBack;
+
+            void DirtyBind(DirtyManager &manager, dirty::Handle handle) const;
+        };
+
+      private:
+        dirty::BoundSubresource<EngineRegisters> engine;
+
+      public:
+        ExtendedDynamicState(dirty::Handle dirtyHandle, DirtyManager &manager, const EngineRegisters &engine);
+
+        void Flush(InterconnectContext &ctx, StateUpdateBuilder &builder);
+    };
+
+    /**
+     * @brief The vertex input layout applied through VK_EXT_vertex_input_dynamic_state rather than being baked into the pipeline, this avoids creating pipelines that only differ in their vertex formats, offsets or strides
+     * @note This is a no-op on devices that lack the extension, the layout is stored in PackedPipelineState in that case
+     */
+    class VertexInputLayoutState : dirty::ManualDirty {
+      private:
+        dirty::BoundSubresource<VertexInputState::EngineRegisters> engine;
+
+      public:
+        VertexInputLayoutState(dirty::Handle dirtyHandle, DirtyManager &manager, const VertexInputState::EngineRegisters &engine);
+
+        void Flush(InterconnectContext &ctx, StateUpdateBuilder &builder);
+    };
+
     /**
      * @brief Holds all GPU state that can be dynamically updated without changing the active pipeline
      */
     class ActiveState {
       private:
+        /**
+         * @brief The bits in `dirtyBitmap` of states that don't need to be refreshed on every draw, these are only updated when their bit is set
+         */
+        enum DirtyBit : u32 {
+            ViewportsBit = 0,
+            ScissorsBit = ViewportsBit + engine::ViewportCount,
+            LineWidthBit = ScissorsBit + engine::ViewportCount,
+            DepthBiasBit,
+            BlendConstantsBit,
+            DepthBoundsBit,
+            StencilValuesBit,
+            ExtendedDynamicStateBit,
+            VertexInputLayoutBit,
+            DirtyBitCount,
+        };
+
+        dirty::Bitmap<DirtyBitCount> dirtyBitmap; //!< Tracks which of the non-refreshable states are dirty, this must be declared before any states that use it
         dirty::ManualDirtyState<PipelineState> pipeline;
         std::array<dirty::ManualDirtyState<VertexBufferState>, engine::VertexStreamCount> vertexBuffers;
         dirty::ManualDirtyState<IndexBufferState> indexBuffer;
@@ -236,6 +329,9 @@ namespace skyline::gpu::interconnect::maxwell3d {
         dirty::ManualDirtyState<BlendConstantsState> blendConstants;
         dirty::ManualDirtyState<DepthBoundsState> depthBounds;
         dirty::ManualDirtyState<StencilValuesState> stencilValues;
+        dirty::ManualDirtyState<ExtendedDynamicState> extendedDynamicState;
+        dirty::ManualDirtyState<VertexInputLayoutState> vertexInputLayout;
+        float renderScale{1.0f}; //!< The render scale that the viewports and scissors were last flushed with
 
       public:
         struct EngineRegisters {
@@ -250,6 +346,8 @@ namespace skyline::gpu::interconnect::maxwell3d {
             BlendConstantsState::EngineRegisters blendConstantsRegisters;
             DepthBoundsState::EngineRegisters depthBoundsRegisters;
             StencilValuesState::EngineRegisters stencilValuesRegisters;
+            ExtendedDynamicState::EngineRegisters extendedDynamicStateRegisters;
+            VertexInputState::EngineRegisters vertexInputLayoutRegisters;
         };
 
         DirectPipelineState &directState;
@@ -272,6 +370,11 @@ namespace skyline::gpu::interconnect::maxwell3d {
 
         TextureView *GetDepthAttachment();
 
+        /**
+         * @return The render scale of the active attachments, this is shared by all attachments in a render pass
+         */
+        float GetRenderScale();
+
         std::shared_ptr<TextureView> GetColorRenderTargetForClear(InterconnectContext &ctx, size_t index);
 
         std::shared_ptr<TextureView> GetDepthRenderTargetForClear(InterconnectContext &ctx);
@@ -16,7 +16,8 @@ namespace skyline::gpu::interconnect::maxwell3d {
                          nce::NCE &nce,
                          skyline::kernel::MemoryManager &memoryManager,
                          DirtyManager &manager,
-                         const EngineRegisterBundle &registerBundle)
+                         const EngineRegisterBundle &registerBundle,
+                         bool asyncPipelineCompilation)
         : ctx{channelCtx, channelCtx.executor, gpu, nce, memoryManager},
           activeState{manager, registerBundle.activeStateRegisters},
           clearEngineRegisters{registerBundle.clearRegisters},
@@ -25,13 +26,16 @@ namespace skyline::gpu::interconnect::maxwell3d {
           samplerBinding{registerBundle.samplerBinding},
           textures{manager, registerBundle.texturePoolRegisters},
           directState{activeState.directState},
-          queries{gpu} {
+          queries{gpu},
+          asyncPipelineCompilation{asyncPipelineCompilation} {
         ctx.executor.AddFlushCallback([this] {
             if (attachedDescriptorSets) {
                 ctx.executor.AttachDependency(attachedDescriptorSets);
                 attachedDescriptorSets = nullptr;
                 activeDescriptorSet = nullptr;
             }
+            descriptorSetCache.clear();
+            lastDrawParams = nullptr;
 
             activeState.MarkAllDirty();
             constantBuffers.MarkAllDirty();
@@ -40,6 +44,7 @@ namespace skyline::gpu::interconnect::maxwell3d {
             quadConversionBufferAttached = false;
             constantBuffers.DisableQuickBind();
             queries.PurgeCaches(ctx);
+            renderConditionView.PurgeCaches();
         });
 
         ctx.executor.AddPipelineChangeCallback([this] {
@@ -116,8 +121,8 @@ namespace skyline::gpu::interconnect::maxwell3d {
 
     vk::Rect2D Maxwell3D::GetDrawScissor() {
         const auto &surfaceClip{clearEngineRegisters.surfaceClip};
-        vk::Rect2D scissor{{surfaceClip.horizontal.x, surfaceClip.vertical.y},
-                           {surfaceClip.horizontal.width, surfaceClip.vertical.height}};
+        vk::Rect2D scissor{texture::ScaleRect({{surfaceClip.horizontal.x, surfaceClip.vertical.y},
+                                               {surfaceClip.horizontal.width, surfaceClip.vertical.height}}, activeState.GetRenderScale())};
 
         auto colorAttachments{activeState.GetColorAttachments()};
         auto depthStencilAttachment{activeState.GetDepthAttachment()};
@@ -132,7 +137,7 @@ namespace skyline::gpu::interconnect::maxwell3d {
         return scissor;
     }
 
-     void Maxwell3D::PrepareDraw(StateUpdateBuilder &builder,
+     bool Maxwell3D::PrepareDraw(StateUpdateBuilder &builder,
                                  engine::DrawTopology topology, bool indexed, bool estimateIndexBufferSize, u32 firstIndex, u32 count,
                                  vk::PipelineStageFlags &srcStageMask, vk::PipelineStageFlags &dstStageMask) {
          Pipeline *oldPipeline{activeState.GetPipeline()};
@@ -142,6 +147,14 @@ namespace skyline::gpu::interconnect::maxwell3d {
                             indexed, topology, estimateIndexBufferSize, firstIndex, count,
                             srcStageMask, dstStageMask);
          Pipeline *pipeline{activeState.GetPipeline()};
+         if (asyncPipelineCompilation && !pipeline->IsCompiled()) [[unlikely]] {
+             // None of the state from this draw will be recorded so everything needs to be resent for the next draw, including the pipeline and a full descriptor update
+             activeState.MarkAllDirty();
+             constantBuffers.DisableQuickBind();
+             activeDescriptorSet = nullptr;
+             return false;
+         }
+
          activeDescriptorSetSampledImages.resize(pipeline->GetTotalSampledImageCount());
 
 
@@ -165,12 +178,27 @@ namespace skyline::gpu::interconnect::maxwell3d {
 
          if (oldPipeline != pipeline)
              // If the pipeline has changed, we need to update the pipeline state
-             builder.SetPipeline(pipeline->compiledPipeline.pipeline, vk::PipelineBindPoint::eGraphics);
+             builder.SetPipeline(pipeline->compiledPipeline.pipeline, vk::PipelineBindPoint::eGraphics, pipeline->compiledPipeline.optimizedPipeline);
 
          if (descUpdateInfo) {
              if (ctx.gpu.traits.supportsPushDescriptors) {
                  builder.SetDescriptorSetWithPush(descUpdateInfo);
              } else {
+                 // Full updates that match the contents of a set that was already written during this execution can reuse it without any writes
+                 bool fullUpdate{descUpdateInfo->copies.empty()};
+                 u64 keyHash{};
+                 if (fullUpdate) {
+                     MakeDescriptorSetKey(*descUpdateInfo, descriptorSetKey);
+                     keyHash = XXH64(descriptorSetKey.data(), descriptorSetKey.size() * sizeof(u64), 0);
+
+                     auto it{descriptorSetCache.find(keyHash)};
+                     if (it != descriptorSetCache.end() && it->second.key == descriptorSetKey) {
+                         activeDescriptorSet = it->second.set;
+                         builder.BindDescriptorSet(descUpdateInfo, activeDescriptorSet);
+                         return true;
+                     }
+                 }
+
                  if (!attachedDescriptorSets)
                      attachedDescriptorSets = std::make_shared<boost::container::static_vector<DescriptorAllocator::ActiveDescriptorSet, DescriptorBatchSize>>();
 
@@ -180,12 +208,17 @@ namespace skyline::gpu::interconnect::maxwell3d {
 
                  builder.SetDescriptorSetWithUpdate(descUpdateInfo, activeDescriptorSet, oldSet);
 
+                 if (fullUpdate)
+                     descriptorSetCache.insert_or_assign(keyHash, CachedDescriptorSet{descriptorSetKey, activeDescriptorSet});
+
                  if (attachedDescriptorSets->size() == DescriptorBatchSize) {
                      ctx.executor.AttachDependency(attachedDescriptorSets);
                      attachedDescriptorSets.reset();
                  }
              }
          }
+
+         return true;
     }
 
     void Maxwell3D::LoadConstantBuffer(span<u32> data, u32 offset) {
@@ -211,27 +244,38 @@ namespace skyline::gpu::interconnect::maxwell3d {
         TRACE_EVENT("gpu", "Maxwell3D::Clear");
         ctx.executor.AddCheckpoint("Before clear");
 
+        // The scissor and render area are in guest texels, they're scaled by the render scale of each attachment that's cleared
         auto needsAttachmentClearCmd{[&](auto &view) {
-            return scissor.offset.x != 0 || scissor.offset.y != 0 ||
-                scissor.extent != vk::Extent2D{view->texture->dimensions} ||
+            auto viewScissor{texture::ScaleRect(scissor, view->texture->renderScale)};
+            return viewScissor.offset.x != 0 || viewScissor.offset.y != 0 ||
+                viewScissor.extent != vk::Extent2D{view->texture->dimensions} ||
                 view->range.layerCount != 1 || view->range.baseArrayLayer != 0 || clearSurface.rtArrayIndex != 0;
         }};
 
+        // If a clear overwrites every texel of a texture then its prior contents don't need to be uploaded to it
+        auto clearsEntireTexture{[&](auto &view, vk::ImageAspectFlags aspectMask) {
+            return !needsAttachmentClearCmd(view) && view->texture->levelCount == 1 && view->texture->layerCount == 1 && aspectMask == view->texture->format->vkAspect;
+        }};
+
         // Always use surfaceClip for render area since it's more likely to match the renderArea of draws and avoid an RP break
         const auto &surfaceClip{clearEngineRegisters.surfaceClip};
         vk::Rect2D renderArea{{surfaceClip.horizontal.x, surfaceClip.vertical.y}, {surfaceClip.horizontal.width, surfaceClip.vertical.height}};
 
-        auto clearRects{util::MakeFilledArray<vk::ClearRect, 2>(vk::ClearRect{.rect = scissor, .baseArrayLayer = clearSurface.rtArrayIndex, .layerCount = 1})};
         boost::container::small_vector<vk::ClearAttachment, 2> clearAttachments;
 
         std::shared_ptr<TextureView> colorView{};
         std::shared_ptr<TextureView> depthStencilView{};
 
+        // Clears which don't require the helper shader are only recorded after both attachments have been determined as they might be recorded inline into the current subpass together
+        std::shared_ptr<TextureView> pendingColorView{};
+        std::shared_ptr<TextureView> pendingDepthStencilView{};
+        vk::ImageAspectFlags pendingDepthStencilAspect{};
+
         if (clearSurface.rEnable || clearSurface.gEnable || clearSurface.bEnable || clearSurface.aEnable) {
             if (auto view{activeState.GetColorRenderTargetForClear(ctx, clearSurface.mrtSelect)}) {
-                ctx.executor.AttachTexture(&*view);
-
                 bool partialClear{!(clearSurface.rEnable && clearSurface.gEnable && clearSurface.bEnable && clearSurface.aEnable)};
+                ctx.executor.AttachTexture(&*view, !partialClear && clearsEntireTexture(view, view->range.aspectMask));
+
                 if (!(view->range.aspectMask & vk::ImageAspectFlagBits::eColor))
                     Logger::Warn("Colour RT used in clear lacks colour aspect"); // TODO: Drop this check after texman rework
 
@@ -244,63 +288,148 @@ namespace skyline::gpu::interconnect::maxwell3d {
                                                                   (clearSurface.aEnable ? vk::ColorComponentFlagBits::eA : vk::ColorComponentFlags{}),
                                                                   {clearEngineRegisters.colorClearValue}, &*view, [=](auto &&executionCallback) {
                         auto dst{view.get()};
-                        ctx.executor.AddSubpass(std::move(executionCallback), renderArea, {}, {}, span<TextureView *>{dst}, nullptr);
+                        ctx.executor.AddSubpass(std::move(executionCallback), texture::ScaleRect(renderArea, dst->texture->renderScale), {}, {}, span<TextureView *>{dst}, nullptr);
                     });
                     ctx.executor.NotifyPipelineChange();
-                } else if (needsAttachmentClearCmd(view)) {
-                    clearAttachments.push_back({.aspectMask = view->range.aspectMask, .clearValue = {clearEngineRegisters.colorClearValue}});
-                    colorView = view;
                 } else {
-                    ctx.executor.AddClearColorSubpass(&*view, clearEngineRegisters.colorClearValue);
+                    pendingColorView = view;
                 }
             }
         }
 
         if (clearSurface.stencilEnable || clearSurface.zEnable) {
             if (auto view{activeState.GetDepthRenderTargetForClear(ctx)}) {
-                ctx.executor.AttachTexture(&*view);
-
                 bool viewHasDepth{view->range.aspectMask & vk::ImageAspectFlagBits::eDepth}, viewHasStencil{view->range.aspectMask & vk::ImageAspectFlagBits::eStencil};
                 vk::ImageAspectFlags clearAspectMask{(clearSurface.zEnable ? vk::ImageAspectFlagBits::eDepth : vk::ImageAspectFlags{}) |
                                                      (clearSurface.stencilEnable ? vk::ImageAspectFlagBits::eStencil : vk::ImageAspectFlags{})};
                 clearAspectMask &= view->range.aspectMask;
-
-                vk::ClearDepthStencilValue clearValue{
-                    .depth = clearEngineRegisters.depthClearValue,
-                    .stencil = clearEngineRegisters.stencilClearValue
-                };
+                ctx.executor.AttachTexture(&*view, clearAspectMask && clearsEntireTexture(view, clearAspectMask));
 
                 if (!clearAspectMask) {
                     Logger::Warn("Depth stencil RT used in clear lacks depth or stencil aspects"); // TODO: Drop this check after texman rework
                     return;
                 }
 
-                if (needsAttachmentClearCmd(view) || (clearAspectMask != view->range.aspectMask)) { // Subpass clears write to all aspects of the texture, so we can't use them when only one component is enabled
-                    clearAttachments.push_back({.aspectMask = clearAspectMask, .clearValue = clearValue});
-                    depthStencilView = view;
-                } else {
-                    ctx.executor.AddClearDepthStencilSubpass(&*view, clearValue);
+                pendingDepthStencilView = view;
+                pendingDepthStencilAspect = clearAspectMask;
+            }
+        }
+
+        vk::ClearDepthStencilValue depthStencilClearValue{
+            .depth = clearEngineRegisters.depthClearValue,
+            .stencil = clearEngineRegisters.stencilClearValue
+        };
+
+        if (pendingColorView || pendingDepthStencilView) {
+            // Clears of attachments bound to the current subpass are recorded inline, this avoids breaking up the render pass which is expensive on tiling GPUs
+            boost::container::small_vector<TextureView *, 2> inlineViews;
+            boost::container::small_vector<vk::ClearAttachment, 2> inlineClearAttachments;
+            if (pendingColorView) {
+                inlineViews.push_back(&*pendingColorView);
+                inlineClearAttachments.push_back({.aspectMask = pendingColorView->range.aspectMask, .clearValue = {clearEngineRegisters.colorClearValue}});
+            }
+            if (pendingDepthStencilView) {
+                inlineViews.push_back(&*pendingDepthStencilView);
+                inlineClearAttachments.push_back({.aspectMask = pendingDepthStencilAspect, .clearValue = depthStencilClearValue});
+            }
+
+            float renderScale{inlineViews.front()->texture->renderScale};
+            if (!ctx.executor.AddInlineClear(span<TextureView *>{inlineViews.data(), inlineViews.size()}, span<const vk::ClearAttachment>{inlineClearAttachments.data(), inlineClearAttachments.size()}, vk::ClearRect{.rect = texture::ScaleRect(scissor, renderScale), .baseArrayLayer = clearSurface.rtArrayIndex, .layerCount = 1})) {
+                if (pendingColorView) {
+                    if (needsAttachmentClearCmd(pendingColorView)) {
+                        clearAttachments.push_back(inlineClearAttachments.front());
+                        colorView = pendingColorView;
+                    } else {
+                        ctx.executor.AddClearColorSubpass(&*pendingColorView, clearEngineRegisters.colorClearValue);
+                    }
+                }
+
+                if (pendingDepthStencilView) {
+                    if (needsAttachmentClearCmd(pendingDepthStencilView) || (pendingDepthStencilAspect != pendingDepthStencilView->range.aspectMask)) { // Subpass clears write to all aspects of the texture, so we can't use them when only one component is enabled
+                        clearAttachments.push_back(inlineClearAttachments.back());
+                        depthStencilView = pendingDepthStencilView;
+                    } else {
+                        ctx.executor.AddClearDepthStencilSubpass(&*pendingDepthStencilView, depthStencilClearValue);
+                    }
                 }
             }
         }
 
+        auto addClearSubpass{[&](const boost::container::small_vector<vk::ClearAttachment, 2> &attachments, TextureView *color, TextureView *depthStencil) {
+            float renderScale{(color ? color : depthStencil)->texture->renderScale};
+            auto clearRects{util::MakeFilledArray<vk::ClearRect, 2>(vk::ClearRect{.rect = texture::ScaleRect(scissor, renderScale), .baseArrayLayer = clearSurface.rtArrayIndex, .layerCount = 1})};
+            std::array<TextureView *, 1> colorAttachments{color};
+            ctx.executor.AddSubpass([attachments, clearRects](vk::raii::CommandBuffer &commandBuffer, const std::shared_ptr<FenceCycle> &, GPU &, vk::RenderPass, u32) {
+                commandBuffer.clearAttachments(attachments, span(clearRects).first(attachments.size()));
+            }, texture::ScaleRect(renderArea, renderScale), {}, {}, color ? colorAttachments : span<TextureView *>{}, depthStencil);
+        }};
+
         if (!clearAttachments.empty()) {
-            std::array<TextureView *, 1> colorAttachments{colorView ? &*colorView : nullptr};
-            ctx.executor.AddSubpass([clearAttachments, clearRects](vk::raii::CommandBuffer &commandBuffer, const std::shared_ptr<FenceCycle> &, GPU &, vk::RenderPass, u32) {
-                commandBuffer.clearAttachments(clearAttachments, span(clearRects).first(clearAttachments.size()));
-            }, renderArea, {}, {}, colorView ? colorAttachments : span<TextureView *>{}, depthStencilView ? &*depthStencilView : nullptr);
+            if (colorView && depthStencilView && colorView->texture->renderScale != depthStencilView->texture->renderScale) {
+                // Attachments with differing render scales can't share a render pass, the colour attachment is always first
+                addClearSubpass({clearAttachments.front()}, &*colorView, nullptr);
+                addClearSubpass({clearAttachments.back()}, nullptr, &*depthStencilView);
+            } else {
+                addClearSubpass(clearAttachments, colorView ? &*colorView : nullptr, depthStencilView ? &*depthStencilView : nullptr);
+            }
         }
 
         ctx.executor.AddCheckpoint("After clear");
     }
 
+    BufferView Maxwell3D::GetRenderConditionView(vk::PipelineStageFlags &srcStageMask, vk::PipelineStageFlags &dstStageMask) {
+        if (!renderConditionAddress)
+            return {};
+
+        renderConditionView.Update(ctx, *renderConditionAddress, sizeof(u32));
+        if (!*renderConditionView)
+            return {};
+
+        ctx.executor.AttachBuffer(*renderConditionView);
+        renderConditionView->GetBuffer()->BlockSequencedCpuBackingWrites();
+
+        // The query result is copied into the buffer after the render pass it was reported in
+        srcStageMask |= vk::PipelineStageFlagBits::eTransfer;
+        dstStageMask |= vk::PipelineStageFlagBits::eConditionalRenderingEXT;
+        return *renderConditionView;
+    }
+
+    void Maxwell3D::DrawParams::AddDraw(LinearAllocatorState<> &allocator, u32 count, u32 first, u32 vertexOffset) {
+        if (drawCount == draws.size()) {
+            auto newDraws{allocator.AllocateUntracked<vk::MultiDrawIndexedInfoEXT>(std::max<size_t>(draws.size() * 2, 4))};
+            newDraws.copy_from(draws.first(drawCount));
+            draws = newDraws;
+        }
+
+        draws[drawCount++] = vk::MultiDrawIndexedInfoEXT{
+            .firstIndex = first,
+            .indexCount = count,
+            .vertexOffset = static_cast<i32>(vertexOffset),
+        };
+    }
+
+    bool Maxwell3D::CanMergeDraw(const DrawParams &params, vk::PipelineStageFlags srcStageMask, vk::PipelineStageFlags dstStageMask, const vk::Rect2D &scissor) {
+        if (!lastDrawParams || lastDrawExecutionTag != ctx.executor.executionTag || lastDrawNodeCount != ctx.executor.GetNodeCount())
+            return false;
+
+        if (!params.stateUpdater.Empty() || srcStageMask || dstStageMask || params.renderCondition || params.transformFeedbackEnable)
+            return false;
+
+        if (params.indexed != lastDrawParams->indexed || params.instanceCount != lastDrawParams->instanceCount || params.firstInstance != lastDrawParams->firstInstance || scissor != lastDrawScissor)
+            return false;
+
+        auto colorAttachments{activeState.GetColorAttachments()};
+        return std::equal(colorAttachments.begin(), colorAttachments.end(), lastDrawColorAttachments.begin(), lastDrawColorAttachments.end()) && activeState.GetDepthAttachment() == lastDrawDepthAttachment;
+    }
+
     void Maxwell3D::Draw(engine::DrawTopology topology, bool transformFeedbackEnable, bool indexed, u32 count, u32 first, u32 instanceCount, u32 vertexOffset, u32 firstInstance) {
         TRACE_EVENT("gpu", "Draw", "indexed", indexed, "count", count, "instanceCount", instanceCount);
 
         StateUpdateBuilder builder{*ctx.executor.allocator};
         vk::PipelineStageFlags srcStageMask{}, dstStageMask{};
 
-        PrepareDraw(builder, topology, indexed, false, first, count, srcStageMask, dstStageMask);
+        if (!PrepareDraw(builder, topology, indexed, false, first, count, srcStageMask, dstStageMask))
+            return;
 
         if (directState.inputAssembly.NeedsQuadConversion()) {
             count = conversion::quads::GetIndexCount(count);
@@ -314,45 +443,80 @@ namespace skyline::gpu::interconnect::maxwell3d {
             }
         }
 
-        auto stateUpdater{builder.Build()};
-
-        /**
-         * @brief Struct that can be linearly allocated, holding all state for the draw to avoid a dynamic allocation with lambda captures
-         */
-        struct DrawParams {
-            StateUpdater stateUpdater;
-            u32 count;
-            u32 first;
-            u32 instanceCount;
-            u32 vertexOffset;
-            u32 firstInstance;
-            bool indexed;
-            bool transformFeedbackEnable;
+        DrawParams params{
+            .stateUpdater = builder.Build(),
+            .renderCondition = GetRenderConditionView(srcStageMask, dstStageMask),
+            .instanceCount = instanceCount,
+            .firstInstance = firstInstance,
+            .indexed = indexed,
+            .transformFeedbackEnable = ctx.gpu.traits.supportsTransformFeedback ? transformFeedbackEnable : false,
         };
-        auto *drawParams{ctx.executor.allocator->EmplaceUntracked<DrawParams>(DrawParams{stateUpdater,
-                                                                                         count, first, instanceCount, vertexOffset, firstInstance, indexed,
-                                                                                         ctx.gpu.traits.supportsTransformFeedback ? transformFeedbackEnable : false})};
 
         vk::Rect2D scissor{GetDrawScissor()};
 
-
         constantBuffers.ResetQuickBind();
+
+        if (CanMergeDraw(params, srcStageMask, dstStageMask, scissor)) {
+            lastDrawParams->AddDraw(*ctx.executor.allocator, count, first, vertexOffset);
+            return;
+        }
+
+        lastDrawParams = nullptr;
+        auto *drawParams{ctx.executor.allocator->EmplaceUntracked<DrawParams>(params)};
+        drawParams->AddDraw(*ctx.executor.allocator, count, first, vertexOffset);
+
         ctx.executor.AddCheckpoint("Before draw");
         ctx.executor.AddSubpass([drawParams](vk::raii::CommandBuffer &commandBuffer, const std::shared_ptr<FenceCycle> &, GPU &gpu, vk::RenderPass, u32) {
             drawParams->stateUpdater.RecordAll(gpu, commandBuffer);
 
+            if (drawParams->renderCondition) {
+                auto conditionBinding{drawParams->renderCondition.GetBinding(gpu)};
+                commandBuffer.beginConditionalRenderingEXT(vk::ConditionalRenderingBeginInfoEXT{
+                    .buffer = conditionBinding.buffer,
+                    .offset = conditionBinding.offset,
+                });
+            }
+
             if (drawParams->transformFeedbackEnable)
                 commandBuffer.beginTransformFeedbackEXT(0, {}, {});
 
-            if (drawParams->indexed)
-                commandBuffer.drawIndexed(drawParams->count, drawParams->instanceCount, drawParams->first, static_cast<i32>(drawParams->vertexOffset), drawParams->firstInstance);
-            else
-                commandBuffer.draw(drawParams->count, drawParams->instanceCount, drawParams->first, drawParams->firstInstance);
+            auto draws{drawParams->draws.first(drawParams->drawCount)};
+            if (draws.size() > 1 && gpu.traits.supportsMultiDraw) {
+                // VkMultiDrawInfoEXT has the same layout as the first two members of VkMultiDrawIndexedInfoEXT so the same array can be used for both with the stride of the latter
+                for (size_t offset{}; offset < draws.size(); offset += gpu.traits.maxMultiDrawCount) {
+                    auto chunk{draws.subspan(offset, std::min<size_t>(gpu.traits.maxMultiDrawCount, draws.size() - offset))};
+                    if (drawParams->indexed)
+                        commandBuffer.getDispatcher()->vkCmdDrawMultiIndexedEXT(*commandBuffer, static_cast<u32>(chunk.size()), reinterpret_cast<const VkMultiDrawIndexedInfoEXT *>(chunk.data()), drawParams->instanceCount, drawParams->firstInstance, sizeof(vk::MultiDrawIndexedInfoEXT), nullptr);
+                    else
+                        commandBuffer.getDispatcher()->vkCmdDrawMultiEXT(*commandBuffer, static_cast<u32>(chunk.size()), reinterpret_cast<const VkMultiDrawInfoEXT *>(chunk.data()), drawParams->instanceCount, drawParams->firstInstance, sizeof(vk::MultiDrawIndexedInfoEXT));
+                }
+            } else {
+                for (const auto &draw : draws) {
+                    if (drawParams->indexed)
+                        commandBuffer.drawIndexed(draw.indexCount, drawParams->instanceCount, draw.firstIndex, draw.vertexOffset, drawParams->firstInstance);
+                    else
+                        commandBuffer.draw(draw.indexCount, drawParams->instanceCount, draw.firstIndex, drawParams->firstInstance);
+                }
+            }
 
             if (drawParams->transformFeedbackEnable)
                 commandBuffer.endTransformFeedbackEXT(0, {}, {});
+
+            if (drawParams->renderCondition)
+                commandBuffer.endConditionalRenderingEXT();
         }, scissor, activeDescriptorSetSampledImages, {}, activeState.GetColorAttachments(), activeState.GetDepthAttachment(), !ctx.gpu.traits.quirks.relaxedRenderPassCompatibility, srcStageMask, dstStageMask);
         ctx.executor.AddCheckpoint("After draw");
+
+        // Only draws without any synchronization or predication are considered for merging as those can't be split across draws
+        if (!srcStageMask && !dstStageMask && !drawParams->renderCondition && !drawParams->transformFeedbackEnable) {
+            lastDrawParams = drawParams;
+            lastDrawExecutionTag = ctx.executor.executionTag;
+            lastDrawNodeCount = ctx.executor.GetNodeCount();
+            lastDrawScissor = scissor;
+            auto colorAttachments{activeState.GetColorAttachments()};
+            lastDrawColorAttachments.assign(colorAttachments.begin(), colorAttachments.end());
+            lastDrawDepthAttachment = activeState.GetDepthAttachment();
+        }
     }
 
     void Maxwell3D::DrawIndirect(engine::DrawTopology topology, bool transformFeedbackEnable, bool indexed, span<u8> indirectBuffer, u32 count, u32 stride) {
@@ -364,7 +528,8 @@ namespace skyline::gpu::interconnect::maxwell3d {
         StateUpdateBuilder builder{*ctx.executor.allocator};
         vk::PipelineStageFlags srcStageMask{}, dstStageMask{};
 
-        PrepareDraw(builder, topology, indexed, true, 0, 0, srcStageMask, dstStageMask);
+        if (!PrepareDraw(builder, topology, indexed, true, 0, 0, srcStageMask, dstStageMask))
+            return;
 
         if (directState.inputAssembly.NeedsQuadConversion())
             throw exception("Quad conversion is not supported for indirect draws!");
@@ -386,6 +551,7 @@ namespace skyline::gpu::interconnect::maxwell3d {
         struct DrawParams {
             StateUpdater stateUpdater;
             BufferView indirectBuffer;
+            BufferView renderCondition;
             u32 count;
             u32 stride;
             bool indexed;
@@ -393,6 +559,7 @@ namespace skyline::gpu::interconnect::maxwell3d {
         };
         auto *drawParams{ctx.executor.allocator->EmplaceUntracked<DrawParams>(DrawParams{stateUpdater,
                                                                                          indirectBufferView,
+                                                                                         GetRenderConditionView(srcStageMask, dstStageMask),
                                                                                          count, stride, indexed,
                                                                                          ctx.gpu.traits.supportsTransformFeedback ? transformFeedbackEnable : false})};
 
@@ -403,17 +570,39 @@ namespace skyline::gpu::interconnect::maxwell3d {
         ctx.executor.AddSubpass([drawParams](vk::raii::CommandBuffer &commandBuffer, const std::shared_ptr<FenceCycle> &, GPU &gpu, vk::RenderPass, u32) {
             drawParams->stateUpdater.RecordAll(gpu, commandBuffer);
 
+            if (drawParams->renderCondition) {
+                auto conditionBinding{drawParams->renderCondition.GetBinding(gpu)};
+                commandBuffer.beginConditionalRenderingEXT(vk::ConditionalRenderingBeginInfoEXT{
+                    .buffer = conditionBinding.buffer,
+                    .offset = conditionBinding.offset,
+                });
+            }
+
             if (drawParams->transformFeedbackEnable)
                 commandBuffer.beginTransformFeedbackEXT(0, {}, {});
 
             auto indirectBinding{drawParams->indirectBuffer.GetBinding(gpu)};
-            if (drawParams->indexed)
-                commandBuffer.drawIndexedIndirect(indirectBinding.buffer, indirectBinding.offset, drawParams->count, drawParams->stride);
-            else
-                commandBuffer.drawIndirect(indirectBinding.buffer,  indirectBinding.offset, drawParams->count, drawParams->stride);
+            if (drawParams->count == 1 || gpu.traits.supportsMultiDrawIndirect) {
+                if (drawParams->indexed)
+                    commandBuffer.drawIndexedIndirect(indirectBinding.buffer, indirectBinding.offset, drawParams->count, drawParams->stride);
+                else
+                    commandBuffer.drawIndirect(indirectBinding.buffer, indirectBinding.offset, drawParams->count, drawParams->stride);
+            } else {
+                // Without multi-draw indirect support each draw needs to be issued separately, this is still cheaper than reading back the draw parameters
+                for (u32 i{}; i < drawParams->count; i++) {
+                    vk::DeviceSize offset{indirectBinding.offset + static_cast<vk::DeviceSize>(i) * drawParams->stride};
+                    if (drawParams->indexed)
+                        commandBuffer.drawIndexedIndirect(indirectBinding.buffer, offset, 1, 0);
+                    else
+                        commandBuffer.drawIndirect(indirectBinding.buffer, offset, 1, 0);
+                }
+            }
 
             if (drawParams->transformFeedbackEnable)
                 commandBuffer.endTransformFeedbackEXT(0, {}, {});
+
+            if (drawParams->renderCondition)
+                commandBuffer.endConditionalRenderingEXT();
         }, scissor, activeDescriptorSetSampledImages, {}, activeState.GetColorAttachments(), activeState.GetDepthAttachment(), !ctx.gpu.traits.quirks.relaxedRenderPassCompatibility, srcStageMask, dstStageMask);
         ctx.executor.AddCheckpoint("After indirect draw");
     }
@@ -439,4 +628,12 @@ namespace skyline::gpu::interconnect::maxwell3d {
     bool Maxwell3D::QueryPresentAtAddress(soc::gm20b::IOVA address) {
         return queries.QueryPresentAtAddress(address);
     }
-}
\ No newline at end of file
+
+    void Maxwell3D::SetRenderCondition(std::optional<soc::gm20b::IOVA> address) {
+        // Results reported in the current render pass are only written after it ends, draws in it can't be predicated on them
+        if (address && (!ctx.gpu.traits.supportsConditionalRendering || queries.QueryPendingAtAddress(ctx, *address)))
+            renderConditionAddress = std::nullopt;
+        else
+            renderConditionAddress = address;
+    }
+}
@@ -53,11 +53,51 @@ namespace skyline::gpu::interconnect::maxwell3d {
         bool quadConversionBufferAttached{};
         BufferView indirectBufferView;
         Queries queries;
+        std::optional<soc::gm20b::IOVA> renderConditionAddress; //!< The address of a query result that draws should be predicated on with conditional rendering
+        CachedMappedBufferView renderConditionView;
 
         static constexpr size_t DescriptorBatchSize{0x100};
         std::shared_ptr<boost::container::static_vector<DescriptorAllocator::ActiveDescriptorSet, DescriptorBatchSize>> attachedDescriptorSets;
         DescriptorAllocator::ActiveDescriptorSet *activeDescriptorSet{};
+
+        struct CachedDescriptorSet {
+            std::vector<u64> key; //!< The full key of the set, this is used to resolve hash collisions
+            DescriptorAllocator::ActiveDescriptorSet *set;
+        };
+        std::unordered_map<u64, CachedDescriptorSet> descriptorSetCache; //!< A map from the hash of the contents of fully written descriptor sets to the sets, this is cleared on every flush as the sets only stay alive for a single execution
+        std::vector<u64> descriptorSetKey; //!< Scratch storage for the key of a descriptor set
+
         std::vector<TextureView *> activeDescriptorSetSampledImages{};
+        bool asyncPipelineCompilation; //!< If draws should be skipped while their pipelines are still being compiled rather than waiting on the compilation
+
+        /**
+         * @brief Struct that can be linearly allocated, holding all state for a draw to avoid a dynamic allocation with lambda captures
+         * @note Consecutive draws which only differ in their vertex/index ranges are merged into a single set of parameters and recorded as a multi-draw
+         */
+        struct DrawParams {
+            StateUpdater stateUpdater;
+            BufferView renderCondition;
+            u32 instanceCount;
+            u32 firstInstance;
+            bool indexed;
+            bool transformFeedbackEnable;
+            span<vk::MultiDrawIndexedInfoEXT> draws; //!< Storage for the ranges of all merged draws, for non-indexed draws `firstIndex`/`indexCount` are interpreted as `firstVertex`/`vertexCount`
+            u32 drawCount;
+
+            void AddDraw(LinearAllocatorState<> &allocator, u32 count, u32 first, u32 vertexOffset);
+        };
+
+        DrawParams *lastDrawParams{}; //!< The parameters of the last draw if further draws can be merged into it, this is reset whenever it can't be
+        ContextTag lastDrawExecutionTag{}; //!< The execution the last draw was recorded in
+        size_t lastDrawNodeCount{}; //!< The amount of nodes in the executor after the last draw was recorded, any change in this indicates something was recorded in between
+        vk::Rect2D lastDrawScissor{};
+        std::vector<TextureView *> lastDrawColorAttachments;
+        TextureView *lastDrawDepthAttachment{};
+
+        /**
+         * @return If a draw with the supplied parameters can be merged into the last draw, this requires that nothing was recorded in between and the draw doesn't update any state
+         */
+        bool CanMergeDraw(const DrawParams &params, vk::PipelineStageFlags srcStageMask, vk::PipelineStageFlags dstStageMask, const vk::Rect2D &scissor);
 
         size_t UpdateQuadConversionBuffer(u32 count, u32 firstVertex);
 
@@ -71,10 +111,17 @@ namespace skyline::gpu::interconnect::maxwell3d {
          */
         vk::Rect2D GetDrawScissor();
 
+        /**
+         * @brief Resolves the buffer view of the active render condition and sets up the dependencies on it for the draw
+         * @return The view of the 32-bit value the draw should be predicated on, or an empty view if the draw isn't predicated
+         */
+        BufferView GetRenderConditionView(vk::PipelineStageFlags &srcStageMask, vk::PipelineStageFlags &dstStageMask);
+
         /**
          * @brief Performs operations common across indirect and regular draws
+         * @return If the draw should be recorded, this is false if asynchronous pipeline compilation is enabled and the pipeline isn't compiled yet
          */
-        void PrepareDraw(StateUpdateBuilder &builder,
+        bool PrepareDraw(StateUpdateBuilder &builder,
                          engine::DrawTopology topology, bool indexed, bool estimateIndexBufferSize, u32 firstIndex, u32 count,
                          vk::PipelineStageFlags &srcStageMask, vk::PipelineStageFlags &dstStageMask);
 
@@ -86,7 +133,8 @@ namespace skyline::gpu::interconnect::maxwell3d {
                   nce::NCE &nce,
                   kernel::MemoryManager &memoryManager,
                   DirtyManager &manager,
-                  const EngineRegisterBundle &registerBundle);
+                  const EngineRegisterBundle &registerBundle,
+                  bool asyncPipelineCompilation);
 
         /**
          * @brief Loads the given data into the constant buffer pointed by the constant buffer selector starting at the given offset
@@ -114,5 +162,12 @@ namespace skyline::gpu::interconnect::maxwell3d {
         void ResetCounter(engine::ClearReportValue::Type type);
 
         bool QueryPresentAtAddress(soc::gm20b::IOVA address);
+
+        /**
+         * @brief Predicates subsequent draws on the query result at the supplied address being non-zero with conditional rendering
+         * @param address The address of the query result, draws aren't predicated if this is empty
+         * @note Draws are left unpredicated if conditional rendering is unsupported or the result isn't available to the GPU yet
+         */
+        void SetRenderCondition(std::optional<soc::gm20b::IOVA> address);
     };
 }
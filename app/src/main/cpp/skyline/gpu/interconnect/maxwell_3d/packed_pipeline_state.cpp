@@ -57,39 +57,108 @@ namespace skyline::gpu::interconnect::maxwell3d {
         return static_cast<vk::PolygonMode>(polygonMode);
     }
 
-    void PackedPipelineState::SetCullMode(bool enable, engine::CullFace mode) {
-        if (!enable) {
-            cullMode = {};
-            return;
+    vk::Format ConvertVertexInputAttributeFormat(engine::VertexAttribute::ComponentBitWidths componentBitWidths, engine::VertexAttribute::NumericalType numericalType) {
+        #define FORMAT_CASE(bitWidths, type, vkType, vkFormat, ...) \
+            case engine::VertexAttribute::ComponentBitWidths::bitWidths | engine::VertexAttribute::NumericalType::type: \
+                return vk::Format::vkFormat ## vkType ##__VA_ARGS__
+
+        #define FORMAT_INT_CASE(size, vkFormat, ...) \
+            FORMAT_CASE(size, Uint, Uint, vkFormat, ##__VA_ARGS__); \
+            FORMAT_CASE(size, Sint, Sint, vkFormat, ##__VA_ARGS__);
+
+        #define FORMAT_INT_FLOAT_CASE(size, vkFormat, ...) \
+            FORMAT_INT_CASE(size, vkFormat, ##__VA_ARGS__); \
+            FORMAT_CASE(size, Float, Sfloat, vkFormat, ##__VA_ARGS__);
+
+        #define FORMAT_NORM_INT_SCALED_CASE(size, vkFormat, ...) \
+            FORMAT_INT_CASE(size, vkFormat, ##__VA_ARGS__);               \
+            FORMAT_CASE(size, Unorm, Unorm, vkFormat, ##__VA_ARGS__);     \
+            FORMAT_CASE(size, Snorm, Snorm, vkFormat, ##__VA_ARGS__);     \
+            FORMAT_CASE(size, Uscaled, Uscaled, vkFormat, ##__VA_ARGS__); \
+            FORMAT_CASE(size, Sscaled, Sscaled, vkFormat, ##__VA_ARGS__)
+
+        #define FORMAT_NORM_INT_SCALED_FLOAT_CASE(size, vkFormat) \
+            FORMAT_NORM_INT_SCALED_CASE(size, vkFormat); \
+            FORMAT_CASE(size, Float, Sfloat, vkFormat)
+
+        // No mobile support scaled formats, so pass as int and the shader compiler will convert to float for us
+        if (numericalType == engine::VertexAttribute::NumericalType::Sscaled)
+            numericalType = engine::VertexAttribute::NumericalType::Sint;
+        else if (numericalType == engine::VertexAttribute::NumericalType::Uscaled)
+            numericalType = engine::VertexAttribute::NumericalType::Uint;
+
+        switch (componentBitWidths | numericalType) {
+            /* 8-bit components */
+            FORMAT_NORM_INT_SCALED_CASE(R8, eR8);
+            FORMAT_NORM_INT_SCALED_CASE(R8_G8, eR8G8);
+            FORMAT_NORM_INT_SCALED_CASE(G8R8, eR8G8);
+            FORMAT_NORM_INT_SCALED_CASE(R8_G8_B8, eR8G8B8);
+            FORMAT_NORM_INT_SCALED_CASE(R8_G8_B8_A8, eR8G8B8A8);
+            FORMAT_NORM_INT_SCALED_CASE(A8B8G8R8, eR8G8B8A8);
+            FORMAT_NORM_INT_SCALED_CASE(X8B8G8R8, eR8G8B8A8);
+
+                /* 16-bit components */
+            FORMAT_NORM_INT_SCALED_FLOAT_CASE(R16, eR16);
+            FORMAT_NORM_INT_SCALED_FLOAT_CASE(R16_G16, eR16G16);
+            FORMAT_NORM_INT_SCALED_FLOAT_CASE(R16_G16_B16, eR16G16B16);
+            FORMAT_NORM_INT_SCALED_FLOAT_CASE(R16_G16_B16_A16, eR16G16B16A16);
+
+                /* 32-bit components */
+            FORMAT_INT_FLOAT_CASE(R32, eR32);
+            FORMAT_INT_FLOAT_CASE(R32_G32, eR32G32);
+            FORMAT_INT_FLOAT_CASE(R32_G32_B32, eR32G32B32);
+            FORMAT_INT_FLOAT_CASE(R32_G32_B32_A32, eR32G32B32A32);
+
+                /* 10-bit RGB, 2-bit A */
+            FORMAT_NORM_INT_SCALED_CASE(A2B10G10R10, eA2B10G10R10, Pack32);
+
+                /* 11-bit G and R, 10-bit B */
+            FORMAT_CASE(B10G11R11, Float, Ufloat, eB10G11R11, Pack32);
+
+            default:
+                Logger::Warn("Unimplemented Maxwell3D Vertex Buffer Format: {} | {}", static_cast<u8>(componentBitWidths), static_cast<u8>(numericalType));
+                return vk::Format::eR8G8B8A8Unorm;
         }
 
+        #undef FORMAT_CASE
+        #undef FORMAT_INT_CASE
+        #undef FORMAT_INT_FLOAT_CASE
+        #undef FORMAT_NORM_INT_SCALED_CASE
+        #undef FORMAT_NORM_INT_SCALED_FLOAT_CASE
+    }
+
+    vk::CullModeFlags ConvertCullMode(bool enable, engine::CullFace mode) {
+        if (!enable)
+            return {};
+
         switch (mode) {
             case engine::CullFace::Front:
-                cullMode = VK_CULL_MODE_FRONT_BIT;
-                break;
+                return vk::CullModeFlagBits::eFront;
             case engine::CullFace::Back:
-                cullMode = VK_CULL_MODE_BACK_BIT;
-                break;
+                return vk::CullModeFlagBits::eBack;
             case engine::CullFace::FrontAndBack:
-                cullMode = VK_CULL_MODE_FRONT_BIT | VK_CULL_MODE_BACK_BIT;
-                break;
+                return vk::CullModeFlagBits::eFrontAndBack;
             default:
                 throw exception("Invalid cull mode: 0x{:X}", static_cast<u32>(mode));
         }
     }
 
-    static u8 ConvertCompareFunc(engine::CompareFunc func) {
+    void PackedPipelineState::SetCullMode(bool enable, engine::CullFace mode) {
+        cullMode = static_cast<VkCullModeFlags>(ConvertCullMode(enable, mode));
+    }
+
+    vk::CompareOp ConvertCompareFunc(engine::CompareFunc func) {
         if (func < engine::CompareFunc::D3DNever || func > engine::CompareFunc::OglAlways || (func > engine::CompareFunc::D3DAlways && func < engine::CompareFunc::OglNever))
             throw exception("Invalid comparision function: 0x{:X}", static_cast<u32>(func));
 
         u32 val{static_cast<u32>(func)};
 
         // VK CompareOp values match 1:1 with Maxwell with some small maths
-        return static_cast<u8>(func >= engine::CompareFunc::OglNever ? val - 0x200 : val - 1);
+        return static_cast<vk::CompareOp>(func >= engine::CompareFunc::OglNever ? val - 0x200 : val - 1);
     }
 
     void PackedPipelineState::SetDepthFunc(engine::CompareFunc func) {
-        depthFunc = ConvertCompareFunc(func);
+        depthFunc = static_cast<u8>(ConvertCompareFunc(func));
     }
 
     vk::CompareOp PackedPipelineState::GetDepthFunc() const {
@@ -231,47 +300,43 @@ namespace skyline::gpu::interconnect::maxwell3d {
         #undef FORMAT_CASE
     }
 
-    static u8 ConvertStencilOp(engine::StencilOps::Op op) {
-        auto conv{[&]() {
-            switch (op) {
-                case engine::StencilOps::Op::OglZero:
-                case engine::StencilOps::Op::D3DZero:
-                    return vk::StencilOp::eZero;
-                case engine::StencilOps::Op::D3DKeep:
-                case engine::StencilOps::Op::OglKeep:
-                    return vk::StencilOp::eKeep;
-                case engine::StencilOps::Op::D3DReplace:
-                case engine::StencilOps::Op::OglReplace:
-                    return vk::StencilOp::eReplace;
-                case engine::StencilOps::Op::D3DIncrSat:
-                case engine::StencilOps::Op::OglIncrSat:
-                    return vk::StencilOp::eIncrementAndClamp;
-                case engine::StencilOps::Op::D3DDecrSat:
-                case engine::StencilOps::Op::OglDecrSat:
-                    return vk::StencilOp::eDecrementAndClamp;
-                case engine::StencilOps::Op::D3DInvert:
-                case engine::StencilOps::Op::OglInvert:
-                    return vk::StencilOp::eInvert;
-                case engine::StencilOps::Op::D3DIncr:
-                case engine::StencilOps::Op::OglIncr:
-                    return vk::StencilOp::eIncrementAndWrap;
-                case engine::StencilOps::Op::D3DDecr:
-                case engine::StencilOps::Op::OglDecr:
-                    return vk::StencilOp::eDecrementAndWrap;
-                default:
-                    throw exception("Invalid stencil operation: 0x{:X}", static_cast<u32>(op));
-            }
-        }};
-
-        return static_cast<u8>(conv());
+    vk::StencilOp ConvertStencilOp(engine::StencilOps::Op op) {
+        switch (op) {
+            case engine::StencilOps::Op::OglZero:
+            case engine::StencilOps::Op::D3DZero:
+                return vk::StencilOp::eZero;
+            case engine::StencilOps::Op::D3DKeep:
+            case engine::StencilOps::Op::OglKeep:
+                return vk::StencilOp::eKeep;
+            case engine::StencilOps::Op::D3DReplace:
+            case engine::StencilOps::Op::OglReplace:
+                return vk::StencilOp::eReplace;
+            case engine::StencilOps::Op::D3DIncrSat:
+            case engine::StencilOps::Op::OglIncrSat:
+                return vk::StencilOp::eIncrementAndClamp;
+            case engine::StencilOps::Op::D3DDecrSat:
+            case engine::StencilOps::Op::OglDecrSat:
+                return vk::StencilOp::eDecrementAndClamp;
+            case engine::StencilOps::Op::D3DInvert:
+            case engine::StencilOps::Op::OglInvert:
+                return vk::StencilOp::eInvert;
+            case engine::StencilOps::Op::D3DIncr:
+            case engine::StencilOps::Op::OglIncr:
+                return vk::StencilOp::eIncrementAndWrap;
+            case engine::StencilOps::Op::D3DDecr:
+            case engine::StencilOps::Op::OglDecr:
+                return vk::StencilOp::eDecrementAndWrap;
+            default:
+                throw exception("Invalid stencil operation: 0x{:X}", static_cast<u32>(op));
+        }
     }
 
     static PackedPipelineState::StencilOps PackStencilOps(engine::StencilOps ops) {
         return {
-            .zPass = ConvertStencilOp(ops.zPass),
-            .fail = ConvertStencilOp(ops.fail),
-            .zFail = ConvertStencilOp(ops.zFail),
-            .func = ConvertCompareFunc(ops.func),
+            .zPass = static_cast<u8>(ConvertStencilOp(ops.zPass)),
+            .fail = static_cast<u8>(ConvertStencilOp(ops.fail)),
+            .zFail = static_cast<u8>(ConvertStencilOp(ops.zFail)),
+            .func = static_cast<u8>(ConvertCompareFunc(ops.func)),
         };
     }
 
@@ -471,7 +536,7 @@ namespace skyline::gpu::interconnect::maxwell3d {
     }
 
     void PackedPipelineState::SetAlphaFunc(engine::CompareFunc func) {
-        alphaFunc = ConvertCompareFunc(func);
+        alphaFunc = static_cast<u8>(ConvertCompareFunc(func));
     }
 
     Shader::CompareFunction PackedPipelineState::GetAlphaFunc() const {
@@ -479,6 +544,31 @@ namespace skyline::gpu::interconnect::maxwell3d {
         return static_cast<Shader::CompareFunction>(alphaFunc);
     }
 
+    PackedPipelineStateSubHashes PackedPipelineState::CalculateSubHashes() const {
+        return {
+            .vertexAttributes = HashPackedStateMember(vertexAttributes),
+            .vertexBindings = HashPackedStateMember(vertexBindings),
+            .vertexStrides = HashPackedStateMember(vertexStrides),
+            .transformFeedbackVaryings = HashPackedStateMember(transformFeedbackVaryings),
+        };
+    }
+
+    u64 PackedPipelineState::Hash(const PackedPipelineStateSubHashes &subHashes) const {
+        // The state between the arrays covered by sub-hashes is small enough that hashing it directly is cheaper than caching it
+        std::array<u64, 7> hashes{
+            XXH64(this, offsetof(PackedPipelineState, vertexAttributes), 0),
+            subHashes.vertexAttributes,
+            XXH64(&colorRenderTargetFormats, offsetof(PackedPipelineState, vertexBindings) - offsetof(PackedPipelineState, colorRenderTargetFormats), 0),
+            subHashes.vertexBindings,
+            HashPackedStateMember(attachmentBlendStates),
+            // Only hash the state which is compared by operator==: strides are covered by dynamic state and transform feedback state is only hashed when it's enabled
+            (transformFeedbackEnable || !dynamicStateActive) ? subHashes.vertexStrides : 0,
+            transformFeedbackEnable ? subHashes.transformFeedbackVaryings : 0,
+        };
+
+        return XXH64(hashes.data(), sizeof(hashes), 0);
+    }
+
     void PackedPipelineState::SetDepthClampEnable(engine::ViewportClipControl::GeometryClip clip) {
         depthClampEnable = (clip != engine::ViewportClipControl::GeometryClip::Passthru) && (clip != engine::ViewportClipControl::GeometryClip::FrustrumXYZClip) && (clip != engine::ViewportClipControl::GeometryClip::FrustrumZClip);
     }
@@ -12,10 +12,38 @@ namespace skyline::gpu::interconnect::maxwell3d {
     #pragma clang diagnostic push
     #pragma clang diagnostic ignored "-Wbitfield-enum-conversion"
 
+    vk::CullModeFlags ConvertCullMode(bool enable, engine::CullFace mode);
+
+    vk::CompareOp ConvertCompareFunc(engine::CompareFunc func);
+
+    vk::StencilOp ConvertStencilOp(engine::StencilOps::Op op);
+
+    vk::Format ConvertVertexInputAttributeFormat(engine::VertexAttribute::ComponentBitWidths componentBitWidths, engine::VertexAttribute::NumericalType numericalType);
+
+    /**
+     * @brief Hashes of the largest arrays in PackedPipelineState, these are cached by the state that writes each array so that only the small remainder of the state needs to be hashed on every pipeline lookup
+     */
+    struct PackedPipelineStateSubHashes {
+        u64 vertexAttributes;
+        u64 vertexBindings;
+        u64 vertexStrides;
+        u64 transformFeedbackVaryings;
+    };
+
+    /**
+     * @return A hash of a single member of PackedPipelineState for use as a sub-hash
+     */
+    template<typename T>
+    u64 HashPackedStateMember(const T &member) {
+        return XXH64(&member, sizeof(T), 0);
+    }
+
     /**
      * @brief Packed struct of pipeline state suitable for use as a map key
      * @note This is heavily based around yuzu's pipeline key with some packing modifications
      * @note Any modifications to this struct *MUST* be accompanied by a pipeline cache version bump
+     * @note State that's covered by VK_EXT_extended_dynamic_state is left zeroed when `dynamicStateActive` is set, it's applied by ExtendedDynamicState instead
+     * @note Similarly, only the numerical types of vertex attributes are retained when `vertexInputDynamicStateActive` is set as the rest of the vertex input layout is applied by VertexInputLayoutState
      * @url https://github.com/yuzu-emu/yuzu/blob/9c701774562ea490296b9cbea3dbd8c096bc4483/src/video_core/renderer_vulkan/fixed_pipeline_state.h#L20
      */
     struct PackedPipelineState {
@@ -62,6 +90,7 @@ namespace skyline::gpu::interconnect::maxwell3d {
             bool depthClampEnable : 1; // Use SetDepthClampEnable
             bool dynamicStateActive : 1;
             bool viewportTransformEnable : 1;
+            bool vertexInputDynamicStateActive : 1;
         };
 
         u32 patchSize;
@@ -166,6 +195,17 @@ namespace skyline::gpu::interconnect::maxwell3d {
 
         void SetDepthClampEnable(engine::ViewportClipControl::GeometryClip clip);
 
+        /**
+         * @return The sub-hashes of this state calculated from scratch
+         */
+        PackedPipelineStateSubHashes CalculateSubHashes() const;
+
+        /**
+         * @return A hash of this state combined from the supplied sub-hashes and a hash of the remaining state
+         * @note The sub-hashes *MUST* match the current contents of the state, this yields the same value as PackedPipelineStateHash
+         */
+        u64 Hash(const PackedPipelineStateSubHashes &subHashes) const;
+
         bool operator==(const PackedPipelineState &other) const {
             // Only hash transform feedback state if it's enabled
             if (other.transformFeedbackEnable && transformFeedbackEnable)
@@ -179,14 +219,7 @@ namespace skyline::gpu::interconnect::maxwell3d {
 
     struct PackedPipelineStateHash {
         size_t operator()(const PackedPipelineState &state) const noexcept {
-            // Only hash transform feedback state if it's enabled
-            if (state.transformFeedbackEnable)
-                return XXH64(&state, sizeof(PackedPipelineState), 0);
-            else if (state.dynamicStateActive)
-                return XXH64(&state, offsetof(PackedPipelineState, vertexStrides), 0);
-
-
-            return XXH64(&state, offsetof(PackedPipelineState, transformFeedbackVaryings), 0);
+            return state.Hash(state.CalculateSubHashes());
         }
     };
 
@@ -2,6 +2,8 @@
 // Copyright © 2022 yuzu Team and Contributors (https://github.com/yuzu-emu/)
 // Copyright © 2022 Skyline Team and Contributors (https://github.com/skyline-emu/)
 
+#include <boost/functional/hash.hpp>
+#include <common/boot_profiler.h>
 #include <gpu/texture/texture.h>
 #include <gpu/interconnect/command_executor.h>
 #include <gpu/interconnect/common/pipeline.inc>
@@ -11,6 +13,7 @@
 #include <gpu.h>
 #include <jvm.h>
 #include <vulkan/vulkan_enums.hpp>
+#include <BS_thread_pool.hpp>
 #include "graphics_pipeline_state_accessor.h"
 #include "pipeline_manager.h"
 #include "soc/gm20b/engines/maxwell/types.h"
@@ -20,6 +23,12 @@ namespace skyline::gpu::interconnect::maxwell3d {
         vk::ShaderStageFlagBits stage;
         vk::ShaderModule module;
         Shader::Info info;
+        u64 spirvHash; //!< A hash of the SPIR-V the module was created from
+        ShaderModuleIdentifier identifier; //!< The identifier of a cached module for the stage, this is used in place of the module if it's null
+
+        bool Valid() const {
+            return module || identifier;
+        }
     };
 
     static constexpr Shader::Stage ConvertCompilerShaderStage(engine::Pipeline::Shader::Type stage) {
@@ -195,7 +204,7 @@ namespace skyline::gpu::interconnect::maxwell3d {
         return info;
     }
 
-    static std::array<ShaderStage, engine::ShaderStageCount> MakePipelineShaders(GPU &gpu, const PipelineStateAccessor &accessor, const PackedPipelineState &packedState) {
+    static std::array<ShaderStage, engine::ShaderStageCount> MakePipelineShaders(GPU &gpu, const PipelineStateAccessor &accessor, const PackedPipelineState &packedState, PipelineCompileTimings &timings) {
         gpu.shader->ResetPools();
 
         using PipelineStage = engine::Pipeline::Shader::Type;
@@ -203,6 +212,7 @@ namespace skyline::gpu::interconnect::maxwell3d {
         auto stageIdx{[](PipelineStage stage) { return static_cast<u8>(stage); }};
 
         std::array<Shader::IR::Program, engine::PipelineCount> programs;
+        std::array<u64, engine::PipelineCount> programHashes{}; //!< Hashes of the programs for the SPIR-V cache, generated programs aren't cached and have a hash of 0
         Shader::IR::Program *layerConversionSourceProgram{};
         bool ignoreVertexCullBeforeFetch{};
 
@@ -215,6 +225,7 @@ namespace skyline::gpu::interconnect::maxwell3d {
             }
 
             auto binary{accessor.GetShaderBinary(i)};
+            u64 programHash{};
             auto program{gpu.shader->ParseGraphicsShader(
                 packedState.postVtgShaderAttributeSkipMask,
                 ConvertCompilerShaderStage(static_cast<PipelineStage>(i)),
@@ -226,13 +237,20 @@ namespace skyline::gpu::interconnect::maxwell3d {
                     return accessor.GetConstantBufferValue(shaderStage, index, offset);
                 }, [&](u32 index) {
                     return accessor.GetTextureType(BindlessHandle{ .raw = index }.textureIndex);
-                })};
+                }, &timings, &programHash)};
             if (i == stageIdx(PipelineStage::Vertex) && packedState.shaderHashes[stageIdx(PipelineStage::VertexCullBeforeFetch)]) {
                 ignoreVertexCullBeforeFetch = true;
                 programs[i] = gpu.shader->CombineVertexShaders(programs[stageIdx(PipelineStage::VertexCullBeforeFetch)], program, binary.binary);
+
+                auto &vertexAHash{programHashes[stageIdx(PipelineStage::VertexCullBeforeFetch)]};
+                if (programHash && vertexAHash)
+                    boost::hash_combine(programHash, vertexAHash);
+                else
+                    programHash = 0;
             } else {
                 programs[i] = program;
             }
+            programHashes[i] = programHash;
 
             if (programs[i].info.requires_layer_emulation)
                 layerConversionSourceProgram = &programs[i];
@@ -249,9 +267,10 @@ namespace skyline::gpu::interconnect::maxwell3d {
                 continue;
 
             auto runtimeInfo{MakeRuntimeInfo(packedState, programs[i], lastProgram, hasGeometry)};
-            shaderStages[i - (i >= 1 ? 1 : 0)] = {ConvertVkShaderStage(pipelineStage(i)),
-                                                  gpu.shader->CompileShader(runtimeInfo, programs[i], bindings, packedState.shaderHashes[i]),
-                                                  programs[i].info};
+            auto &shaderStage{shaderStages[i - (i >= 1 ? 1 : 0)]};
+            shaderStage = {ConvertVkShaderStage(pipelineStage(i)), {}, programs[i].info};
+            // Identifiers are only used for monolithic pipelines as libraries are keyed by the SPIR-V hash which isn't known without reading the SPIR-V
+            shaderStage.module = gpu.shader->CompileShader(runtimeInfo, programs[i], bindings, packedState.shaderHashes[i], &shaderStage.spirvHash, &timings, programHashes[i], gpu.traits.supportsGraphicsPipelineLibrary ? nullptr : &shaderStage.identifier);
 
             lastProgram = &programs[i];
         }
@@ -275,17 +294,23 @@ namespace skyline::gpu::interconnect::maxwell3d {
                 throw exception("Invalid shader stage");
         }
     }
-    static Pipeline::DescriptorInfo MakePipelineDescriptorInfo(const std::array<ShaderStage, engine::ShaderStageCount> &shaderStages, bool needsIndividualTextureBindingWrites) {
+    /**
+     * @param inlineUniformBlockMaxSize The maximum size of a constant buffer that'll be backed by an inline uniform block rather than a uniform buffer, zero disables inline uniform blocks
+     * @param inlineUniformBlockMaxCount The maximum amount of inline uniform blocks in the pipeline
+     */
+    static Pipeline::DescriptorInfo MakePipelineDescriptorInfo(const std::array<ShaderStage, engine::ShaderStageCount> &shaderStages, bool needsIndividualTextureBindingWrites, u32 inlineUniformBlockMaxSize, u32 inlineUniformBlockMaxCount) {
         Pipeline::DescriptorInfo descriptorInfo{};
         u16 bindingIndex{};
+        u32 inlineUniformBlockCount{};
 
         for (size_t i{}; i < engine::ShaderStageCount; i++) {
             const auto &stage{shaderStages[i]};
-            if (!stage.module)
+            if (!stage.Valid())
                 continue;
 
             auto &stageDescInfo{descriptorInfo.stages[i]};
             stageDescInfo.stage = ConvertShaderToPipelineStage(stage.stage);
+            stageDescInfo.constantBufferUsedSizes = stage.info.constant_buffer_used_sizes;
 
             auto pushBindings{[&](vk::DescriptorType type, const auto &descs, u16 &count, auto &outputDescs, auto &&descCb, bool individualDescWrites = false) {
                 descriptorInfo.totalWriteDescCount += individualDescWrites ? descs.size() : ((descs.size() > 0) ? 1 : 0);
@@ -314,9 +339,24 @@ namespace skyline::gpu::interconnect::maxwell3d {
                 }
             }};
 
+            u16 uniformBufferBindingIndex{bindingIndex};
             pushBindings(vk::DescriptorType::eUniformBuffer, stage.info.constant_buffer_descriptors,
                          stageDescInfo.uniformBufferDescTotalCount, stageDescInfo.uniformBufferDescs,
                          [&](const Shader::ConstantBufferDescriptor &desc, u16 descIdx) {
+                // Small constant buffers that are only statically accessed are stored directly in the descriptor set, this avoids a megabuffer copy and buffer descriptor for them
+                u32 usedSize{stageDescInfo.constantBufferUsedSizes[desc.index]};
+                if (desc.count == 1 && usedSize && usedSize <= inlineUniformBlockMaxSize && inlineUniformBlockCount < inlineUniformBlockMaxCount) {
+                    stageDescInfo.uniformBufferDescs.back().inlineSize = static_cast<u16>(util::AlignUp(usedSize, 4));
+                    stageDescInfo.inlineUniformBlockCount++;
+                    inlineUniformBlockCount++;
+                    descriptorInfo.totalInlineUniformBlockSize += stageDescInfo.uniformBufferDescs.back().inlineSize;
+
+                    auto &usage{stageDescInfo.cbufUsages[desc.index]};
+                    usage.inlineUniformBlocks.push_back({bindingIndex, descIdx});
+                    usage.writeDescCount++;
+                    return;
+                }
+
                 for (u16 cbufIdx{static_cast<u16>(desc.index)}; cbufIdx < desc.index + desc.count; cbufIdx++) {
                     auto &usage{stageDescInfo.cbufUsages[cbufIdx]};
                     usage.uniformBuffers.push_back({bindingIndex, descIdx});
@@ -324,6 +364,21 @@ namespace skyline::gpu::interconnect::maxwell3d {
                     usage.writeDescCount++;
                 }
             });
+
+            if (stageDescInfo.inlineUniformBlockCount) {
+                // Inline uniform blocks are sized in bytes and can't share a write with the uniform buffers they're interleaved with, so every uniform buffer in the stage is written individually
+                descriptorInfo.totalWriteDescCount += stageDescInfo.uniformBufferDescs.size() - 1;
+                for (size_t descIdx{}; descIdx < stageDescInfo.uniformBufferDescs.size(); descIdx++) {
+                    u16 inlineSize{stageDescInfo.uniformBufferDescs[descIdx].inlineSize};
+                    if (!inlineSize)
+                        continue;
+
+                    size_t binding{uniformBufferBindingIndex + descIdx};
+                    descriptorInfo.descriptorSetLayoutBindings[binding].descriptorType = vk::DescriptorType::eInlineUniformBlockEXT;
+                    descriptorInfo.descriptorSetLayoutBindings[binding].descriptorCount = inlineSize;
+                    descriptorInfo.copyDescs[binding].descriptorCount = inlineSize;
+                }
+            }
             pushBindings(vk::DescriptorType::eStorageBuffer, stage.info.storage_buffers_descriptors,
                          stageDescInfo.storageBufferDescTotalCount, stageDescInfo.storageBufferDescs,
                          [&](const Shader::StorageBufferDescriptor &desc, u16 descIdx) {
@@ -373,76 +428,6 @@ namespace skyline::gpu::interconnect::maxwell3d {
         return descriptorInfo;
     }
 
-    static vk::Format ConvertVertexInputAttributeFormat(engine::VertexAttribute::ComponentBitWidths componentBitWidths, engine::VertexAttribute::NumericalType numericalType) {
-        #define FORMAT_CASE(bitWidths, type, vkType, vkFormat, ...) \
-            case engine::VertexAttribute::ComponentBitWidths::bitWidths | engine::VertexAttribute::NumericalType::type: \
-                return vk::Format::vkFormat ## vkType ##__VA_ARGS__
-
-        #define FORMAT_INT_CASE(size, vkFormat, ...) \
-            FORMAT_CASE(size, Uint, Uint, vkFormat, ##__VA_ARGS__); \
-            FORMAT_CASE(size, Sint, Sint, vkFormat, ##__VA_ARGS__);
-
-        #define FORMAT_INT_FLOAT_CASE(size, vkFormat, ...) \
-            FORMAT_INT_CASE(size, vkFormat, ##__VA_ARGS__); \
-            FORMAT_CASE(size, Float, Sfloat, vkFormat, ##__VA_ARGS__);
-
-        #define FORMAT_NORM_INT_SCALED_CASE(size, vkFormat, ...) \
-            FORMAT_INT_CASE(size, vkFormat, ##__VA_ARGS__);               \
-            FORMAT_CASE(size, Unorm, Unorm, vkFormat, ##__VA_ARGS__);     \
-            FORMAT_CASE(size, Snorm, Snorm, vkFormat, ##__VA_ARGS__);     \
-            FORMAT_CASE(size, Uscaled, Uscaled, vkFormat, ##__VA_ARGS__); \
-            FORMAT_CASE(size, Sscaled, Sscaled, vkFormat, ##__VA_ARGS__)
-
-        #define FORMAT_NORM_INT_SCALED_FLOAT_CASE(size, vkFormat) \
-            FORMAT_NORM_INT_SCALED_CASE(size, vkFormat); \
-            FORMAT_CASE(size, Float, Sfloat, vkFormat)
-
-        // No mobile support scaled formats, so pass as int and the shader compiler will convert to float for us
-        if (numericalType == engine::VertexAttribute::NumericalType::Sscaled)
-            numericalType = engine::VertexAttribute::NumericalType::Sint;
-        else if (numericalType == engine::VertexAttribute::NumericalType::Uscaled)
-            numericalType = engine::VertexAttribute::NumericalType::Uint;
-
-        switch (componentBitWidths | numericalType) {
-            /* 8-bit components */
-            FORMAT_NORM_INT_SCALED_CASE(R8, eR8);
-            FORMAT_NORM_INT_SCALED_CASE(R8_G8, eR8G8);
-            FORMAT_NORM_INT_SCALED_CASE(G8R8, eR8G8);
-            FORMAT_NORM_INT_SCALED_CASE(R8_G8_B8, eR8G8B8);
-            FORMAT_NORM_INT_SCALED_CASE(R8_G8_B8_A8, eR8G8B8A8);
-            FORMAT_NORM_INT_SCALED_CASE(A8B8G8R8, eR8G8B8A8);
-            FORMAT_NORM_INT_SCALED_CASE(X8B8G8R8, eR8G8B8A8);
-
-                /* 16-bit components */
-            FORMAT_NORM_INT_SCALED_FLOAT_CASE(R16, eR16);
-            FORMAT_NORM_INT_SCALED_FLOAT_CASE(R16_G16, eR16G16);
-            FORMAT_NORM_INT_SCALED_FLOAT_CASE(R16_G16_B16, eR16G16B16);
-            FORMAT_NORM_INT_SCALED_FLOAT_CASE(R16_G16_B16_A16, eR16G16B16A16);
-
-                /* 32-bit components */
-            FORMAT_INT_FLOAT_CASE(R32, eR32);
-            FORMAT_INT_FLOAT_CASE(R32_G32, eR32G32);
-            FORMAT_INT_FLOAT_CASE(R32_G32_B32, eR32G32B32);
-            FORMAT_INT_FLOAT_CASE(R32_G32_B32_A32, eR32G32B32A32);
-
-                /* 10-bit RGB, 2-bit A */
-            FORMAT_NORM_INT_SCALED_CASE(A2B10G10R10, eA2B10G10R10, Pack32);
-
-                /* 11-bit G and R, 10-bit B */
-            FORMAT_CASE(B10G11R11, Float, Ufloat, eB10G11R11, Pack32);
-
-            default:
-                Logger::Warn("Unimplemented Maxwell3D Vertex Buffer Format: {} | {}", static_cast<u8>(componentBitWidths), static_cast<u8>(numericalType));
-                return vk::Format::eR8G8B8A8Unorm;
-        }
-
-        #undef FORMAT_CASE
-        #undef FORMAT_INT_CASE
-        #undef FORMAT_INT_FLOAT_CASE
-        #undef FORMAT_NORM_INT_SCALED_CASE
-        #undef FORMAT_NORM_INT_SCALED_FLOAT_CASE
-    }
-
     static vk::PrimitiveTopology ConvertPrimitiveTopology(engine::DrawTopology topology) {
         switch (topology) {
             case engine::DrawTopology::Points:
@@ -487,52 +472,64 @@ namespace skyline::gpu::interconnect::maxwell3d {
     static GraphicsPipelineAssembler::CompiledPipeline MakeCompiledPipeline(GPU &gpu,
                                                                                  const PackedPipelineState &packedState,
                                                                                  const std::array<ShaderStage, engine::ShaderStageCount> &shaderStages,
-                                                                                 span<vk::DescriptorSetLayoutBinding> layoutBindings) {
+                                                                                 span<vk::DescriptorSetLayoutBinding> layoutBindings,
+                                                                                 const PipelineCompileTimings &timings) {
         boost::container::static_vector<vk::PipelineShaderStageCreateInfo, engine::ShaderStageCount> shaderStageInfos;
-        for (const auto &stage : shaderStages)
-            if (stage.module)
+        boost::container::static_vector<u64, engine::ShaderStageCount> shaderStageHashes;
+        boost::container::static_vector<ShaderModuleIdentifier, engine::ShaderStageCount> shaderModuleIdentifiers;
+        bool hasIdentifiers{};
+        for (const auto &stage : shaderStages) {
+            if (stage.Valid()) {
                 shaderStageInfos.push_back(vk::PipelineShaderStageCreateInfo{
                     .stage = stage.stage,
                     .module = &*stage.module,
                     .pName = "main"
                 });
+                shaderStageHashes.push_back(stage.spirvHash);
+                shaderModuleIdentifiers.push_back(stage.identifier);
+                hasIdentifiers |= static_cast<bool>(stage.identifier);
+            }
+        }
 
         boost::container::static_vector<vk::VertexInputBindingDescription, engine::VertexStreamCount> bindingDescs;
         boost::container::static_vector<vk::VertexInputBindingDivisorDescriptionEXT, engine::VertexStreamCount> bindingDivisorDescs;
         boost::container::static_vector<vk::VertexInputAttributeDescription, engine::VertexAttributeCount> attributeDescs;
 
-        for (u32 i{}; i < engine::VertexStreamCount; i++) {
-            const auto &binding{packedState.vertexBindings[i]};
-            bindingDescs.push_back({
-                                       .binding = i,
-                                       .stride = packedState.vertexStrides[i],
-                                       .inputRate = binding.GetInputRate(),
-                                   });
-
-            if (binding.GetInputRate() == vk::VertexInputRate::eInstance) {
-                if (!gpu.traits.supportsVertexAttributeDivisor)
-                    [[unlikely]]
-                        Logger::Warn("Vertex attribute divisor used on guest without host support");
-                else if (!gpu.traits.supportsVertexAttributeZeroDivisor && binding.divisor == 0)
-                    [[unlikely]]
-                        Logger::Warn("Vertex attribute zero divisor used on guest without host support");
-                else
-                    bindingDivisorDescs.push_back({
-                                                      .binding = i,
-                                                      .divisor = binding.divisor,
-                                                  });
+        // The vertex input layout is entirely dynamic when VK_EXT_vertex_input_dynamic_state is used, see VertexInputLayoutState
+        if (!packedState.vertexInputDynamicStateActive) {
+            for (u32 i{}; i < engine::VertexStreamCount; i++) {
+                const auto &binding{packedState.vertexBindings[i]};
+                bindingDescs.push_back({
+                                           .binding = i,
+                                           .stride = packedState.vertexStrides[i],
+                                           .inputRate = binding.GetInputRate(),
+                                       });
+
+                if (binding.GetInputRate() == vk::VertexInputRate::eInstance) {
+                    if (!gpu.traits.supportsVertexAttributeDivisor)
+                        [[unlikely]]
+                            Logger::Warn("Vertex attribute divisor used on guest without host support");
+                    else if (!gpu.traits.supportsVertexAttributeZeroDivisor && binding.divisor == 0)
+                        [[unlikely]]
+                            Logger::Warn("Vertex attribute zero divisor used on guest without host support");
+                    else
+                        bindingDivisorDescs.push_back({
+                                                          .binding = i,
+                                                          .divisor = binding.divisor,
+                                                      });
+                }
             }
-        }
 
-        for (u32 i{}; i < engine::VertexAttributeCount; i++) {
-            const auto &attribute{packedState.vertexAttributes[i]};
-            if (attribute.source == engine::VertexAttribute::Source::Active && shaderStages[0].info.loads.Generic(i))
-                attributeDescs.push_back({
-                                             .location = i,
-                                             .binding = attribute.stream,
-                                             .format = ConvertVertexInputAttributeFormat(attribute.componentBitWidths, attribute.numericalType),
-                                             .offset = attribute.offset,
-                                         });
+            for (u32 i{}; i < engine::VertexAttributeCount; i++) {
+                const auto &attribute{packedState.vertexAttributes[i]};
+                if (attribute.source == engine::VertexAttribute::Source::Active && shaderStages[0].info.loads.Generic(i))
+                    attributeDescs.push_back({
+                                                 .location = i,
+                                                 .binding = attribute.stream,
+                                                 .format = ConvertVertexInputAttributeFormat(attribute.componentBitWidths, attribute.numericalType),
+                                                 .offset = attribute.offset,
+                                             });
+            }
         }
 
         vk::StructureChain<vk::PipelineVertexInputStateCreateInfo, vk::PipelineVertexInputDivisorStateCreateInfoEXT> vertexInputState{
@@ -609,7 +606,7 @@ namespace skyline::gpu::interconnect::maxwell3d {
 
 
         static constexpr u32 BaseDynamicStateCount{9};
-        static constexpr u32 ExtendedDynamicStateCount{BaseDynamicStateCount + 1};
+        static constexpr u32 ExtendedDynamicStateCount{BaseDynamicStateCount + 9};
 
         constexpr std::array<vk::DynamicState, ExtendedDynamicStateCount> dynamicStates{
             vk::DynamicState::eViewport,
@@ -622,12 +619,24 @@ namespace skyline::gpu::interconnect::maxwell3d {
             vk::DynamicState::eStencilWriteMask,
             vk::DynamicState::eStencilReference,
             // VK_EXT_dynamic_state starts here
-            vk::DynamicState::eVertexInputBindingStrideEXT
+            vk::DynamicState::eVertexInputBindingStrideEXT,
+            vk::DynamicState::eCullModeEXT,
+            vk::DynamicState::eFrontFaceEXT,
+            vk::DynamicState::eDepthTestEnableEXT,
+            vk::DynamicState::eDepthWriteEnableEXT,
+            vk::DynamicState::eDepthCompareOpEXT,
+            vk::DynamicState::eDepthBoundsTestEnableEXT,
+            vk::DynamicState::eStencilTestEnableEXT,
+            vk::DynamicState::eStencilOpEXT
         };
 
+        boost::container::static_vector<vk::DynamicState, ExtendedDynamicStateCount + 1> enabledDynamicStates{dynamicStates.begin(), dynamicStates.begin() + (gpu.traits.supportsExtendedDynamicState ? ExtendedDynamicStateCount : BaseDynamicStateCount)};
+        if (packedState.vertexInputDynamicStateActive)
+            enabledDynamicStates.push_back(vk::DynamicState::eVertexInputEXT);
+
         vk::PipelineDynamicStateCreateInfo dynamicState{
-            .dynamicStateCount = gpu.traits.supportsExtendedDynamicState ? ExtendedDynamicStateCount : BaseDynamicStateCount,
-            .pDynamicStates = dynamicStates.data()
+            .dynamicStateCount = static_cast<u32>(enabledDynamicStates.size()),
+            .pDynamicStates = enabledDynamicStates.data()
         };
 
         // Dynamic state will be used instead of these
@@ -657,15 +666,24 @@ namespace skyline::gpu::interconnect::maxwell3d {
             .colorFormats = colorAttachmentFormats,
             .depthStencilFormat = depthStencilFormat ? depthStencilFormat->vkFormat : vk::Format::eUndefined,
             .sampleCount = vk::SampleCountFlagBits::e1, //TODO: fix after MSAA support
-            .destroyShaderModules = true
+            .destroyShaderModules = true,
+            .shaderStageHashes = hasIdentifiers ? span<u64>{} : span<u64>{shaderStageHashes},
+            .shaderModuleIdentifiers = hasIdentifiers ? span<ShaderModuleIdentifier>{shaderModuleIdentifiers} : span<ShaderModuleIdentifier>{},
+            .compileTimings = timings,
         }, layoutBindings);
     }
 
     Pipeline::Pipeline(GPU &gpu, PipelineStateAccessor &accessor, const PackedPipelineState &packedState)
-        : sourcePackedState{packedState} {
-        auto shaderStages{MakePipelineShaders(gpu, accessor, sourcePackedState)};
-        descriptorInfo = MakePipelineDescriptorInfo(shaderStages, gpu.traits.quirks.needsIndividualTextureBindingWrites);
-        compiledPipeline = MakeCompiledPipeline(gpu, sourcePackedState, shaderStages, descriptorInfo.descriptorSetLayoutBindings);
+        : sourcePackedState{packedState},
+          sourcePackedStateHash{PackedPipelineStateHash{}(packedState)} {
+        PipelineCompileTimings timings;
+        auto shaderStages{MakePipelineShaders(gpu, accessor, sourcePackedState, timings)};
+        // Inline uniform blocks can't be used in push descriptor set layouts so they're only used when descriptor sets are allocated and written
+        bool useInlineUniformBlocks{gpu.traits.supportsInlineUniformBlock && !gpu.traits.supportsPushDescriptors};
+        descriptorInfo = MakePipelineDescriptorInfo(shaderStages, gpu.traits.quirks.needsIndividualTextureBindingWrites,
+                                                    useInlineUniformBlocks ? std::min(InlineUniformBlockMaxSize, gpu.traits.maxInlineUniformBlockSize) : 0,
+                                                    gpu.traits.maxInlineUniformBlockCount);
+        compiledPipeline = MakeCompiledPipeline(gpu, sourcePackedState, shaderStages, descriptorInfo.descriptorSetLayoutBindings, timings);
 
         for (u32 i{}; i < engine::ShaderStageCount; i++)
             if (shaderStages[i].stage != vk::ShaderStageFlagBits{})
@@ -684,27 +702,47 @@ namespace skyline::gpu::interconnect::maxwell3d {
         }
     }
 
-    Pipeline *Pipeline::LookupNext(const PackedPipelineState &packedState) {
-        if (packedState == sourcePackedState)
+    /**
+     * @brief Reads the contents of a constant buffer into the supplied inline uniform block data and creates a descriptor write for it
+     */
+    static vk::WriteDescriptorSet GetInlineUniformBlockWrite(InterconnectContext &ctx, ConstantBuffer &cbuf, span<u8> data, u32 binding) {
+        size_t readSize{cbuf.view ? std::min<size_t>(data.size(), cbuf.view.size) : 0};
+        if (readSize)
+            cbuf.Read(ctx.executor, data.first(readSize), 0);
+        std::memset(data.data() + readSize, 0, data.size() - readSize); // Any part of the block that isn't backed by the constant buffer reads as zero
+
+        auto *inlineWrite{ctx.executor.allocator->EmplaceUntracked<vk::WriteDescriptorSetInlineUniformBlockEXT>(vk::WriteDescriptorSetInlineUniformBlockEXT{
+            .dataSize = static_cast<u32>(data.size()),
+            .pData = data.data(),
+        })};
+
+        return vk::WriteDescriptorSet{
+            .pNext = inlineWrite,
+            .dstBinding = binding,
+            .descriptorCount = static_cast<u32>(data.size()),
+            .descriptorType = vk::DescriptorType::eInlineUniformBlockEXT,
+        };
+    }
+
+    Pipeline *Pipeline::LookupNext(const PackedPipelineState &packedState, u64 packedStateHash) {
+        // The full state comparison is only performed on a hash match to guard against collisions
+        if (packedStateHash == sourcePackedStateHash && packedState == sourcePackedState)
             return this;
 
-        auto it{std::find_if(transitionCache.begin(), transitionCache.end(), [&packedState](auto pipeline) {
-            if (pipeline && pipeline->sourcePackedState == packedState)
-                return true;
-            else
-                return false;
+        auto it{std::find_if(transitionCache.begin(), transitionCache.end(), [&packedState, packedStateHash](const Transition &transition) {
+            return transition.pipeline && transition.packedStateHash == packedStateHash && transition.pipeline->sourcePackedState == packedState;
         })};
 
         if (it != transitionCache.end()) {
             std::swap(*it, *transitionCache.begin());
-            return *transitionCache.begin();
+            return transitionCache.begin()->pipeline;
         }
 
         return nullptr;
     }
 
     void Pipeline::AddTransition(Pipeline *next) {
-        transitionCache[transitionCacheNextIdx] = next;
+        transitionCache[transitionCacheNextIdx] = {next->sourcePackedStateHash, next};
         transitionCacheNextIdx = (transitionCacheNextIdx + 1) % transitionCache.size();
     }
 
@@ -726,6 +764,10 @@ namespace skyline::gpu::interconnect::maxwell3d {
         return true;
     }
 
+    bool Pipeline::IsCompiled() const {
+        return compiledPipeline.pipeline.wait_for(std::chrono::nanoseconds{}) == std::future_status::ready;
+    }
+
     u32 Pipeline::GetTotalSampledImageCount() const {
         return descriptorInfo.totalCombinedImageSamplerCount;
     }
@@ -736,11 +778,18 @@ namespace skyline::gpu::interconnect::maxwell3d {
         u32 writeIdx{};
         auto writes{ctx.executor.allocator->AllocateUntracked<vk::WriteDescriptorSet>(descriptorInfo.totalWriteDescCount)};
 
+        // Buffer and image descriptors alongside inline uniform block contents are allocated contiguously so the combined allocation can be used as the data for a descriptor update template
+        size_t bufferDescsSize{descriptorInfo.totalBufferDescCount * sizeof(vk::DescriptorBufferInfo)};
+        size_t imageDescsSize{descriptorInfo.totalImageDescCount * sizeof(vk::DescriptorImageInfo)};
+        auto descriptorData{ctx.executor.allocator->AllocateUntracked<u8>(bufferDescsSize + imageDescsSize + descriptorInfo.totalInlineUniformBlockSize)};
+
         u32 bufferIdx{};
-        auto bufferDescs{ctx.executor.allocator->AllocateUntracked<vk::DescriptorBufferInfo>(descriptorInfo.totalBufferDescCount)};
+        span<vk::DescriptorBufferInfo> bufferDescs{reinterpret_cast<vk::DescriptorBufferInfo *>(descriptorData.data()), descriptorInfo.totalBufferDescCount};
         auto bufferDescDynamicBindings{ctx.executor.allocator->AllocateUntracked<DynamicBufferBinding>(descriptorInfo.totalBufferDescCount)};
         u32 imageIdx{};
-        auto imageDescs{ctx.executor.allocator->AllocateUntracked<vk::DescriptorImageInfo>(descriptorInfo.totalImageDescCount)};
+        span<vk::DescriptorImageInfo> imageDescs{reinterpret_cast<vk::DescriptorImageInfo *>(descriptorData.data() + bufferDescsSize), descriptorInfo.totalImageDescCount};
+        size_t inlineUniformBlockOffset{};
+        auto inlineUniformBlockData{descriptorData.subspan(bufferDescsSize + imageDescsSize)};
 
         u32 storageBufferIdx{}; // Need to keep track of this to index into the cached view array
         u32 combinedImageSamplerIdx{}; // Need to keep track of this to index into the sampled image array
@@ -803,14 +852,34 @@ namespace skyline::gpu::interconnect::maxwell3d {
 
             const auto &stage{descriptorInfo.stages[i]};
 
-            writeBufferDescs(vk::DescriptorType::eUniformBuffer, stage.uniformBufferDescs, stage.uniformBufferDescTotalCount,
-                             [&](const DescriptorInfo::StageDescriptorInfo::UniformBufferDesc &desc, size_t arrayIdx) {
-                                 size_t cbufIdx{desc.index + arrayIdx};
-                                 return GetConstantBufferBinding(ctx, {stage.constantBufferUsedSizes},
-                                                                 constantBuffers[i][cbufIdx].view, cbufIdx,
-                                                                 stage.stage,
-                                                                 srcStageMask, dstStageMask);
-                             });
+            auto getUniformBufferBinding{[&](const DescriptorInfo::StageDescriptorInfo::UniformBufferDesc &desc, size_t arrayIdx) {
+                size_t cbufIdx{desc.index + arrayIdx};
+                return GetConstantBufferBinding(ctx, {stage.constantBufferUsedSizes},
+                                                constantBuffers[i][cbufIdx].view, cbufIdx,
+                                                stage.stage,
+                                                srcStageMask, dstStageMask);
+            }};
+
+            if (stage.inlineUniformBlockCount) {
+                for (const auto &desc : stage.uniformBufferDescs) {
+                    if (desc.inlineSize) {
+                        writes[writeIdx++] = GetInlineUniformBlockWrite(ctx, constantBuffers[i][desc.index], inlineUniformBlockData.subspan(inlineUniformBlockOffset, desc.inlineSize), bindingIdx++);
+                        inlineUniformBlockOffset += desc.inlineSize;
+                    } else {
+                        writes[writeIdx++] = {
+                            .dstBinding = bindingIdx++,
+                            .descriptorCount = desc.count,
+                            .descriptorType = vk::DescriptorType::eUniformBuffer,
+                            .pBufferInfo = &bufferDescs[bufferIdx],
+                        };
+
+                        for (u32 arrayIdx{}; arrayIdx < desc.count; arrayIdx++)
+                            bufferDescDynamicBindings[bufferIdx++] = getUniformBufferBinding(desc, arrayIdx);
+                    }
+                }
+            } else {
+                writeBufferDescs(vk::DescriptorType::eUniformBuffer, stage.uniformBufferDescs, stage.uniformBufferDescTotalCount, getUniformBufferBinding);
+            }
 
             writeBufferDescs(vk::DescriptorType::eStorageBuffer, stage.storageBufferDescs, stage.storageBufferDescTotalCount,
                              [&](const DescriptorInfo::StageDescriptorInfo::StorageBufferDesc &desc, size_t arrayIdx) {
@@ -837,12 +906,42 @@ namespace skyline::gpu::interconnect::maxwell3d {
             bindingIdx += stage.storageImageDescs.size();
         }
 
+        // The layout of the writes is identical for every full update of a pipeline, so a template that matches it only needs to be created once
+        if (!ctx.gpu.traits.supportsPushDescriptors && !*descriptorUpdateTemplate && writeIdx) [[unlikely]] {
+            std::vector<vk::DescriptorUpdateTemplateEntry> entries;
+            entries.reserve(writeIdx);
+            for (const auto &write : writes.first(writeIdx)) {
+                bool isInline{write.descriptorType == vk::DescriptorType::eInlineUniformBlockEXT}, isBuffer{write.pBufferInfo != nullptr};
+                auto info{isInline ? static_cast<const u8 *>(static_cast<const vk::WriteDescriptorSetInlineUniformBlockEXT *>(write.pNext)->pData) :
+                          isBuffer ? reinterpret_cast<const u8 *>(write.pBufferInfo) : reinterpret_cast<const u8 *>(write.pImageInfo)};
+                entries.push_back(vk::DescriptorUpdateTemplateEntry{
+                    .dstBinding = write.dstBinding,
+                    .dstArrayElement = write.dstArrayElement,
+                    .descriptorCount = write.descriptorCount,
+                    .descriptorType = write.descriptorType,
+                    .offset = static_cast<size_t>(info - descriptorData.data()),
+                    .stride = isInline ? 0 : (isBuffer ? sizeof(vk::DescriptorBufferInfo) : sizeof(vk::DescriptorImageInfo)), // The stride is ignored for inline uniform blocks as their data is contiguous
+                });
+            }
+
+            descriptorUpdateTemplate = vk::raii::DescriptorUpdateTemplate{ctx.gpu.vkDevice, vk::DescriptorUpdateTemplateCreateInfo{
+                .descriptorUpdateEntryCount = static_cast<u32>(entries.size()),
+                .pDescriptorUpdateEntries = entries.data(),
+                .templateType = vk::DescriptorUpdateTemplateType::eDescriptorSet,
+                .descriptorSetLayout = compiledPipeline.descriptorSetLayout,
+            }};
+        }
+
         return ctx.executor.allocator->EmplaceUntracked<DescriptorUpdateInfo>(DescriptorUpdateInfo{
             .writes = writes.first(writeIdx),
             .bufferDescs = bufferDescs.first(bufferIdx),
             .bufferDescDynamicBindings = bufferDescDynamicBindings.first(bufferIdx),
-            .pipelineLayout = *compiledPipeline.pipelineLayout,
-            .descriptorSetLayout = *compiledPipeline.descriptorSetLayout,
+            .imageDescs = imageDescs.first(imageIdx),
+            .descriptorData = descriptorData.data(),
+            .inlineUniformBlockData = inlineUniformBlockData,
+            .updateTemplate = *descriptorUpdateTemplate,
+            .pipelineLayout = compiledPipeline.pipelineLayout,
+            .descriptorSetLayout = compiledPipeline.descriptorSetLayout,
             .bindPoint = vk::PipelineBindPoint::eGraphics,
             .descriptorSetIndex = 0,
         });
@@ -908,6 +1007,11 @@ namespace skyline::gpu::interconnect::maxwell3d {
                                                                                srcStageMask, dstStageMask);
                                            });
 
+        for (const auto &usage : cbufUsageInfo.inlineUniformBlocks) {
+            const auto &desc{stageDescInfo.uniformBufferDescs[usage.shaderDescIdx]};
+            writes[writeIdx++] = GetInlineUniformBlockWrite(ctx, stageConstantBuffers[desc.index], ctx.executor.allocator->AllocateUntracked<u8>(desc.inlineSize), usage.binding);
+        }
+
         writeDescs.operator()<false, true>(vk::DescriptorType::eStorageBuffer, cbufUsageInfo.storageBuffers, stageDescInfo.storageBufferDescs,
                                            [&](auto usage, const DescriptorInfo::StageDescriptorInfo::StorageBufferDesc &desc, size_t arrayIdx) {
                                                return GetStorageBufferBinding(ctx, desc, stageConstantBuffers[desc.cbuf_index],
@@ -936,8 +1040,8 @@ namespace skyline::gpu::interconnect::maxwell3d {
             .writes = writes.first(writeIdx),
             .bufferDescs = bufferDescs.first(bufferIdx),
             .bufferDescDynamicBindings = bufferDescDynamicBindings.first(bufferIdx),
-            .pipelineLayout = *compiledPipeline.pipelineLayout,
-            .descriptorSetLayout = *compiledPipeline.descriptorSetLayout,
+            .pipelineLayout = compiledPipeline.pipelineLayout,
+            .descriptorSetLayout = compiledPipeline.descriptorSetLayout,
             .bindPoint = vk::PipelineBindPoint::eGraphics,
             .descriptorSetIndex = 0,
         });
@@ -947,6 +1051,7 @@ namespace skyline::gpu::interconnect::maxwell3d {
         if (!gpu.graphicsPipelineCacheManager)
             return;
 
+        BootProfiler::ScopedStage bootStage{BootProfiler::Stage::PipelineCacheWarmup};
         std::atomic<u32> compiledCount{};
         auto [stream, totalPipelineCount]{gpu.graphicsPipelineCacheManager->OpenReadStream()};
         i64 lastKnownGoodOffset{stream.tellg()};
@@ -958,21 +1063,60 @@ namespace skyline::gpu::interconnect::maxwell3d {
 
         try {
             auto startTime{util::GetTimeNs()};
-            PipelineStateBundle bundle;
 
-            while (bundle.Deserialise(stream)) {
+            // Bundles are deserialised sequentially on this thread while pipeline construction for each chunk of them is spread across all cores
+            constexpr size_t PreloadChunkSize{64}; //!< The number of bundles handed to a single worker task, large enough to amortise the task overhead
+            using PreloadedPipelines = std::vector<std::pair<PackedPipelineState, std::unique_ptr<Pipeline>>>;
+            BS::thread_pool preloadPool;
+            std::vector<std::future<PreloadedPipelines>> preloadFutures;
+
+            auto submitChunk{[&](std::vector<std::unique_ptr<PipelineStateBundle>> &&chunk) {
+                preloadFutures.emplace_back(preloadPool.submit([&gpu, chunk = std::move(chunk)]() {
+                    PreloadedPipelines pipelines;
+                    pipelines.reserve(chunk.size());
+                    for (auto &bundle : chunk) {
+                        auto accessor{FilePipelineStateAccessor{*bundle}};
+                        auto key{bundle->GetKey<PackedPipelineState>()};
+                        pipelines.emplace_back(key, std::make_unique<Pipeline>(gpu, accessor, key));
+                    }
+                    return pipelines;
+                }));
+            }};
+
+            std::vector<std::unique_ptr<PipelineStateBundle>> chunk;
+            while (true) {
+                auto bundle{std::make_unique<PipelineStateBundle>()};
+                if (!bundle->Deserialise(stream))
+                    break;
+
                 lastKnownGoodOffset = stream.tellg();
-                auto accessor{FilePipelineStateAccessor{bundle}};
-                auto *pipeline{map.emplace(bundle.GetKey<PackedPipelineState>(), std::make_unique<Pipeline>(gpu, accessor, bundle.GetKey<PackedPipelineState>())).first.value().get()};
-                #ifdef PIPELINE_STATS
-                auto sharedIt{sharedPipelines.find(pipeline->sourcePackedState.shaderHashes)};
-                if (sharedIt == sharedPipelines.end())
-                    sharedPipelines.emplace(pipeline->sourcePackedState.shaderHashes, std::list<Pipeline *>{pipeline});
-                else
-                    sharedIt->second.push_back(pipeline);
-                #else
-                (void)pipeline;
-                #endif
+                chunk.emplace_back(std::move(bundle));
+                if (chunk.size() == PreloadChunkSize) {
+                    submitChunk(std::move(chunk));
+                    chunk = {};
+                }
+            }
+
+            if (!chunk.empty())
+                submitChunk(std::move(chunk));
+
+            // All tasks must finish before any exception is rethrown as they reference the GPU and the pool itself
+            for (auto &future : preloadFutures)
+                future.wait();
+
+            for (auto &future : preloadFutures) {
+                for (auto &[key, preloadedPipeline] : future.get()) {
+                    auto *pipeline{map.emplace(key, std::move(preloadedPipeline)).first.value().get()};
+                    #ifdef PIPELINE_STATS
+                    auto sharedIt{sharedPipelines.find(pipeline->sourcePackedState.shaderHashes)};
+                    if (sharedIt == sharedPipelines.end())
+                        sharedPipelines.emplace(pipeline->sourcePackedState.shaderHashes, std::list<Pipeline *>{pipeline});
+                    else
+                        sharedIt->second.push_back(pipeline);
+                    #else
+                    (void)pipeline;
+                    #endif
+                }
             }
 
             gpu.graphicsPipelineAssembler->WaitIdle();
@@ -1000,8 +1144,8 @@ namespace skyline::gpu::interconnect::maxwell3d {
         jvm.HidePipelineLoadingScreen();
     }
 
-    Pipeline *PipelineManager::FindOrCreate(InterconnectContext &ctx, Textures &textures, ConstantBufferSet &constantBuffers, const PackedPipelineState &packedState, const std::array<ShaderBinary, engine::PipelineCount> &shaderBinaries) {
-        auto it{map.find(packedState)};
+    Pipeline *PipelineManager::FindOrCreate(InterconnectContext &ctx, Textures &textures, ConstantBufferSet &constantBuffers, const PackedPipelineState &packedState, u64 packedStateHash, const std::array<ShaderBinary, engine::PipelineCount> &shaderBinaries) {
+        auto it{map.find(packedState, packedStateHash)};
         if (it != map.end())
             return it->second.get();
 
@@ -43,6 +43,7 @@ namespace skyline::gpu::interconnect::maxwell3d {
                 struct UniformBufferDesc {
                     u8 index;
                     u8 count;
+                    u16 inlineSize{}; //!< The size of the inline uniform block backing this descriptor in bytes, this is zero if it's backed by a regular uniform buffer
 
                     UniformBufferDesc(const Shader::ConstantBufferDescriptor &desc)
                         : index{static_cast<u8>(desc.index)},
@@ -51,6 +52,7 @@ namespace skyline::gpu::interconnect::maxwell3d {
                     auto operator<=>(const UniformBufferDesc &) const = default;
                 };
                 boost::container::static_vector<UniformBufferDesc, engine::ShaderStageConstantBufferCount> uniformBufferDescs;
+                u16 inlineUniformBlockCount; //!< The amount of uniform buffer descriptors that are backed by inline uniform blocks, all uniform buffers in the stage are written individually if this is non-zero
 
                 struct StorageBufferDesc {
                     u32 cbuf_offset;
@@ -183,6 +185,7 @@ namespace skyline::gpu::interconnect::maxwell3d {
                     };
 
                     boost::container::small_vector<Usage, 2> uniformBuffers;
+                    boost::container::small_vector<Usage, 1> inlineUniformBlocks;
                     boost::container::small_vector<Usage, 2> storageBuffers;
                     boost::container::small_vector<Usage, 2> combinedImageSamplers;
                     u16 totalBufferDescCount;
@@ -207,13 +210,16 @@ namespace skyline::gpu::interconnect::maxwell3d {
             u16 totalBufferDescCount;
             u16 totalTexelBufferDescCount;
             u16 totalImageDescCount;
+            u32 totalInlineUniformBlockSize; //!< The combined size of all inline uniform blocks in bytes
 
             bool operator==(const DescriptorInfo &) const = default;
         };
 
         PackedPipelineState sourcePackedState;
+        u64 sourcePackedStateHash; //!< The hash of `sourcePackedState` as calculated by PackedPipelineStateHash
 
       private:
+        static constexpr u32 InlineUniformBlockMaxSize{0x100}; //!< The maximum size of a constant buffer that'll be stored in an inline uniform block, larger ones are cheaper to megabuffer than to copy into every descriptor set
         std::vector<CachedMappedBufferView> storageBufferViews;
         ContextTag lastExecutionTag{}; //!< The last execution tag this pipeline was used at
         DescriptorInfo descriptorInfo; //!< Info about all descriptors used in each stage of the pipeline
@@ -221,9 +227,18 @@ namespace skyline::gpu::interconnect::maxwell3d {
         u8 stageMask{}; //!< Bitmask of active shader stages
         u16 sampledImageCount{};
 
-        std::array<Pipeline *, 6> transitionCache{};
+        /**
+         * @brief A transition from this pipeline to another, the hash of the target's state is stored inline so non-matching transitions can be rejected without touching the target
+         */
+        struct Transition {
+            u64 packedStateHash;
+            Pipeline *pipeline;
+        };
+
+        std::array<Transition, 6> transitionCache{};
 
         tsl::robin_map<Pipeline *, bool> bindingMatchCache; //!< Cache of which pipelines have bindings that match this pipeline
+        vk::raii::DescriptorUpdateTemplate descriptorUpdateTemplate{nullptr}; //!< A template matching the writes of a full descriptor update, this is only used on devices without push descriptors
 
         void SyncCachedStorageBufferViews(ContextTag executionTag);
 
@@ -234,8 +249,9 @@ namespace skyline::gpu::interconnect::maxwell3d {
 
         /**
          * @brief Returns the pipeline in the transition cache (if present) that matches the given state
+         * @param packedStateHash The hash of the packed state, this must be equal to PackedPipelineStateHash for the state
          */
-        Pipeline *LookupNext(const PackedPipelineState &packedState);
+        Pipeline *LookupNext(const PackedPipelineState &packedState, u64 packedStateHash);
 
         /**
          * @brief Record a transition from this pipeline to the next pipeline in the transition cache
@@ -244,6 +260,11 @@ namespace skyline::gpu::interconnect::maxwell3d {
 
         bool CheckBindingMatch(Pipeline *other);
 
+        /**
+         * @return If the pipeline has finished compiling and can be bound without blocking
+         */
+        bool IsCompiled() const;
+
         u32 GetTotalSampledImageCount() const;
 
         /**
@@ -274,6 +295,9 @@ namespace skyline::gpu::interconnect::maxwell3d {
       public:
         PipelineManager(GPU &gpu, JvmManager &jvm);
 
-        Pipeline *FindOrCreate(InterconnectContext &ctx, Textures &textures, ConstantBufferSet &constantBuffers, const PackedPipelineState &packedState, const std::array<ShaderBinary, engine::PipelineCount> &shaderBinaries);
+        /**
+         * @param packedStateHash The hash of the packed state, this must be equal to PackedPipelineStateHash for the state
+         */
+        Pipeline *FindOrCreate(InterconnectContext &ctx, Textures &textures, ConstantBufferSet &constantBuffers, const PackedPipelineState &packedState, u64 packedStateHash, const std::array<ShaderBinary, engine::PipelineCount> &shaderBinaries);
     };
 }
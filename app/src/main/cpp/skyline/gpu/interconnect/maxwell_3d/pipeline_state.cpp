@@ -77,7 +77,7 @@ namespace skyline::gpu::interconnect::maxwell3d {
             if (guest.tileConfig.mode == gpu::texture::TileMode::Block)
                 DetermineRenderTargetDimensions(guest, engine->surfaceClip);
 
-            view = ctx.gpu.texture.FindOrCreate(guest, ctx.executor.tag);
+            view = ctx.gpu.texture.FindOrCreate(guest, ctx.executor.tag, true);
         } else {
             format = engine::ColorTarget::Format::Disabled;
             packedState.SetColorRenderTargetFormat(index, engine::ColorTarget::Format::Disabled);
@@ -130,7 +130,7 @@ namespace skyline::gpu::interconnect::maxwell3d {
             if (guest.tileConfig.mode == gpu::texture::TileMode::Block)
                 DetermineRenderTargetDimensions(guest, engine->surfaceClip);
 
-            view = ctx.gpu.texture.FindOrCreate(guest, ctx.executor.tag);
+            view = ctx.gpu.texture.FindOrCreate(guest, ctx.executor.tag, true);
         } else {
             packedState.SetDepthRenderTargetFormat(engine->ztFormat, false);
             view = {};
@@ -178,15 +178,32 @@ namespace skyline::gpu::interconnect::maxwell3d {
     VertexInputState::VertexInputState(dirty::Handle dirtyHandle, DirtyManager &manager, const EngineRegisters &engine) : engine{manager, dirtyHandle, engine} {}
 
     void VertexInputState::Flush(PackedPipelineState &packedState) {
-        for (u32 i{}; i < engine::VertexStreamCount; i++)
-            packedState.SetVertexBinding(i, engine->vertexStreams[i], engine->vertexStreamInstance[i]);
+        if (packedState.vertexInputDynamicStateActive) {
+            // The shader only depends on the numerical type of each attribute, everything else is applied dynamically by VertexInputLayoutState
+            for (u32 i{}; i < engine::VertexAttributeCount; i++) {
+                if (engine->vertexAttributes[i].source == engine::VertexAttribute::Source::Active)
+                    packedState.vertexAttributes[i] = {
+                        .source = engine::VertexAttribute::Source::Active,
+                        .numericalType = engine->vertexAttributes[i].numericalType,
+                    };
+                else
+                    packedState.vertexAttributes[i] = { .source = engine::VertexAttribute::Source::Inactive };
+            }
+        } else {
+            for (u32 i{}; i < engine::VertexStreamCount; i++)
+                packedState.SetVertexBinding(i, engine->vertexStreams[i], engine->vertexStreamInstance[i]);
 
-        for (u32 i{}; i < engine::VertexAttributeCount; i++) {
-            if (engine->vertexAttributes[i].source == engine::VertexAttribute::Source::Active)
-                packedState.vertexAttributes[i] = engine->vertexAttributes[i];
-            else
-                packedState.vertexAttributes[i] = { .source = engine::VertexAttribute::Source::Inactive };
+            for (u32 i{}; i < engine::VertexAttributeCount; i++) {
+                if (engine->vertexAttributes[i].source == engine::VertexAttribute::Source::Active)
+                    packedState.vertexAttributes[i] = engine->vertexAttributes[i];
+                else
+                    packedState.vertexAttributes[i] = { .source = engine::VertexAttribute::Source::Inactive };
+            }
         }
+
+        attributesHash = HashPackedStateMember(packedState.vertexAttributes);
+        bindingsHash = HashPackedStateMember(packedState.vertexBindings);
+        stridesHash = HashPackedStateMember(packedState.vertexStrides);
     }
 
     /* Input Assembly State */
@@ -251,12 +268,16 @@ namespace skyline::gpu::interconnect::maxwell3d {
         if (engine->backPolygonMode != engine->frontPolygonMode)
             Logger::Warn("Non-matching polygon modes!");
 
-        packedState.SetCullMode(engine->oglCullEnable, engine->oglCullFace);
-
         packedState.flipYEnable = engine->windowOrigin.flipY;
 
-        bool origFrontFaceClockwise{engine->oglFrontFace == engine::FrontFace::CW};
-        packedState.frontFaceClockwise = (packedState.flipYEnable != origFrontFaceClockwise);
+        // Cull mode and front face are applied through dynamic state when it's available
+        if (!packedState.dynamicStateActive) {
+            packedState.SetCullMode(engine->oglCullEnable, engine->oglCullFace);
+
+            bool origFrontFaceClockwise{engine->oglFrontFace == engine::FrontFace::CW};
+            packedState.frontFaceClockwise = (packedState.flipYEnable != origFrontFaceClockwise);
+        }
+
         packedState.depthBiasEnable = ConvertDepthBiasEnable(engine->polyOffset, engine->frontPolygonMode);
         packedState.provokingVertex = engine->provokingVertex.value;
         packedState.pointSize = engine->pointSize;
@@ -272,17 +293,20 @@ namespace skyline::gpu::interconnect::maxwell3d {
     DepthStencilState::DepthStencilState(dirty::Handle dirtyHandle, DirtyManager &manager, const EngineRegisters &engine) : engine{manager, dirtyHandle, engine} {}
 
     void DepthStencilState::Flush(PackedPipelineState &packedState) {
-        packedState.depthTestEnable = engine->depthTestEnable;
-        packedState.depthWriteEnable = engine->depthWriteEnable;
-        packedState.SetDepthFunc(engine->depthTestEnable ? engine->depthFunc : engine::CompareFunc::OglAlways);
-        packedState.depthBoundsTestEnable = engine->depthBoundsTestEnable;
-
-        packedState.stencilTestEnable = engine->stencilTestEnable;
-        if (packedState.stencilTestEnable) {
-            auto stencilBack{engine->twoSidedStencilTestEnable ? engine->stencilBack : engine->stencilOps};
-            packedState.SetStencilOps(engine->stencilOps, stencilBack);
-        } else {
-            packedState.SetStencilOps({ .func = engine::CompareFunc::OglAlways }, { .func = engine::CompareFunc::OglAlways });
+        // All depth and stencil state aside from alpha testing is applied through dynamic state when it's available
+        if (!packedState.dynamicStateActive) {
+            packedState.depthTestEnable = engine->depthTestEnable;
+            packedState.depthWriteEnable = engine->depthWriteEnable;
+            packedState.SetDepthFunc(engine->depthTestEnable ? engine->depthFunc : engine::CompareFunc::OglAlways);
+            packedState.depthBoundsTestEnable = engine->depthBoundsTestEnable;
+
+            packedState.stencilTestEnable = engine->stencilTestEnable;
+            if (packedState.stencilTestEnable) {
+                auto stencilBack{engine->twoSidedStencilTestEnable ? engine->stencilBack : engine->stencilOps};
+                packedState.SetStencilOps(engine->stencilOps, stencilBack);
+            } else {
+                packedState.SetStencilOps({ .func = engine::CompareFunc::OglAlways }, { .func = engine::CompareFunc::OglAlways });
+            }
         }
 
         packedState.alphaTestEnable = engine->alphaTestEnable;
@@ -335,6 +359,8 @@ namespace skyline::gpu::interconnect::maxwell3d {
         if (engine->streamOutputEnable)
             for (size_t i{}; i < engine::StreamOutBufferCount; i++)
                 packedState.SetTransformFeedbackVaryings(engine->streamOutControls[i], engine->streamOutLayoutSelect[i], i);
+
+        varyingsHash = HashPackedStateMember(packedState.transformFeedbackVaryings);
     }
 
     /* Global Shader Config State */
@@ -388,6 +414,7 @@ namespace skyline::gpu::interconnect::maxwell3d {
         TRACE_EVENT("gpu", "PipelineState::Flush");
 
         packedState.dynamicStateActive = ctx.gpu.traits.supportsExtendedDynamicState;
+        packedState.vertexInputDynamicStateActive = ctx.gpu.traits.supportsVertexInputDynamicState;
         packedState.ctSelect = ctSelect;
 
         std::array<ShaderBinary, engine::PipelineCount> shaderBinaries;
@@ -407,17 +434,41 @@ namespace skyline::gpu::interconnect::maxwell3d {
                 const auto view{rt.view.get()};
                 packedState.SetColorRenderTargetFormat(ctSelect[i], rt.format);
                 colorAttachments.push_back(view);
-
-                if (view)
-                    ctx.executor.AttachTexture(view);
             } else {
                 colorAttachments.push_back({});
             }
         }
 
         depthAttachment = depthRenderTarget.UpdateGet(ctx, packedState).view.get();
-        if (depthAttachment)
-            ctx.executor.AttachTexture(depthAttachment);
+
+        // All attachments in a render pass must have the same render scale, any scaled attachments are descaled when they're used alongside attachments with a different scale
+        auto depthAttachmentSpan{depthAttachment ? span<TextureView *>(depthAttachment) : span<TextureView *>()};
+        auto attachments{ranges::views::concat(colorAttachments, depthAttachmentSpan)};
+        float renderScale{};
+        bool mixedRenderScale{};
+        for (auto attachment : attachments) {
+            if (!attachment)
+                continue;
+            else if (!renderScale)
+                renderScale = attachment->texture->renderScale;
+            else if (attachment->texture->renderScale != renderScale)
+                mixedRenderScale = true;
+        }
+
+        if (mixedRenderScale) [[unlikely]] {
+            // The prior backings of descaled textures are destroyed so there cannot be any pending usages of them
+            ctx.executor.Submit();
+            for (auto attachment : attachments) {
+                if (attachment) {
+                    std::scoped_lock lock{*attachment->texture};
+                    attachment->texture->Descale();
+                }
+            }
+        }
+
+        for (auto attachment : attachments)
+            if (attachment)
+                ctx.executor.AttachTexture(attachment);
 
         vertexInput.Update(packedState);
         directState.inputAssembly.Update(packedState);
@@ -427,14 +478,22 @@ namespace skyline::gpu::interconnect::maxwell3d {
         transformFeedback.Update(packedState);
         globalShaderConfig.Update(packedState);
 
+        // The large arrays in the packed state are only rehashed when the state that writes them is dirtied, so only the remainder needs to be hashed here
+        u64 packedStateHash{packedState.Hash({
+            .vertexAttributes = vertexInput.Get().attributesHash,
+            .vertexBindings = vertexInput.Get().bindingsHash,
+            .vertexStrides = vertexInput.Get().stridesHash,
+            .transformFeedbackVaryings = transformFeedback.Get().varyingsHash,
+        })};
+
         if (pipeline) {
-            if (auto newPipeline{pipeline->LookupNext(packedState)}) {
+            if (auto newPipeline{pipeline->LookupNext(packedState, packedStateHash)}) {
                 pipeline = newPipeline;
                 return;
             }
         }
 
-        auto newPipeline{ctx.gpu.graphicsPipelineManager->FindOrCreate(ctx, textures, constantBuffers, packedState, shaderBinaries)};
+        auto newPipeline{ctx.gpu.graphicsPipelineManager->FindOrCreate(ctx, textures, constantBuffers, packedState, packedStateHash, shaderBinaries)};
         if (pipeline)
             pipeline->AddTransition(newPipeline);
         pipeline = newPipeline;
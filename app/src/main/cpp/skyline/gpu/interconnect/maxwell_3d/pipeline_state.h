@@ -105,6 +105,10 @@ namespace skyline::gpu::interconnect::maxwell3d {
         dirty::BoundSubresource<EngineRegisters> engine;
 
       public:
+        u64 attributesHash{}; //!< A hash of the packed vertex attributes, this is only recalculated when the state is flushed
+        u64 bindingsHash{}; //!< A hash of the packed vertex bindings, this is only recalculated when the state is flushed
+        u64 stridesHash{}; //!< A hash of the packed vertex strides, this is only recalculated when the state is flushed
+
         VertexInputState(dirty::Handle dirtyHandle, DirtyManager &manager, const EngineRegisters &engine);
 
         void Flush(PackedPipelineState &packedState);
@@ -255,6 +259,8 @@ namespace skyline::gpu::interconnect::maxwell3d {
         dirty::BoundSubresource<EngineRegisters> engine;
 
       public:
+        u64 varyingsHash{}; //!< A hash of the packed transform feedback varyings, this is only recalculated when the state is flushed
+
         TransformFeedbackState(dirty::Handle dirtyHandle, DirtyManager &manager, const EngineRegisters &engine);
 
         void Flush(PackedPipelineState &packedState);
@@ -73,7 +73,7 @@ namespace skyline::gpu::interconnect::maxwell3d {
         *queryActive = false;
 
         // Allocate memory for the timestamp in the megabuffer since updateBuffer can be expensive
-        BufferBinding timestampBuffer{timestamp ? ctx.gpu.megaBufferAllocator.Push(ctx.executor.cycle, span<u64>(*timestamp).cast<u8>()) : BufferBinding{}};
+        BufferBinding timestampBuffer{timestamp ? ctx.executor.megaBufferAllocator->Push(ctx.executor.cycle, span<u64>(*timestamp).cast<u8>()) : BufferBinding{}};
         queries[*usedQueryCount - 1] = {view, timestampBuffer};
 
         if (recordOnNextEnd) {
@@ -120,6 +120,13 @@ namespace skyline::gpu::interconnect::maxwell3d {
     void Queries::Query(InterconnectContext &ctx, soc::gm20b::IOVA address, CounterType type, std::optional<u64> timestamp) {
         view.Update(ctx, address, timestamp ? 16 : 4);
         usedQueryAddresses.emplace(u64{address});
+
+        if (auto renderPassIndex{*ctx.executor.GetRenderPassIndex()}; pendingTag != ctx.executor.executionTag || pendingRenderPassIndex != renderPassIndex) {
+            pendingTag = ctx.executor.executionTag;
+            pendingRenderPassIndex = renderPassIndex;
+            pendingQueryAddresses.clear();
+        }
+        pendingQueryAddresses.push_back(u64{address});
         ctx.executor.AttachBuffer(*view);
 
         auto &counter{counters[static_cast<u32>(type)]};
@@ -144,4 +151,11 @@ namespace skyline::gpu::interconnect::maxwell3d {
     bool Queries::QueryPresentAtAddress(soc::gm20b::IOVA address) {
         return usedQueryAddresses.contains(u64{address});
     }
+
+    bool Queries::QueryPendingAtAddress(InterconnectContext &ctx, soc::gm20b::IOVA address) {
+        if (pendingTag != ctx.executor.executionTag || pendingRenderPassIndex != *ctx.executor.GetRenderPassIndex())
+            return false;
+
+        return std::find(pendingQueryAddresses.begin(), pendingQueryAddresses.end(), u64{address}) != pendingQueryAddresses.end();
+    }
 }
@@ -79,6 +79,10 @@ namespace skyline::gpu::interconnect::maxwell3d {
 
         std::unordered_set<u64> usedQueryAddresses;
 
+        ContextTag pendingTag{}; //!< The execution tag at the time of the last query report
+        u32 pendingRenderPassIndex{}; //!< The render pass index at the time of the last query report
+        std::vector<u64> pendingQueryAddresses; //!< The addresses of all query reports in the current render pass, their results are only written after the render pass ends
+
       public:
         Queries(GPU &gpu);
 
@@ -98,5 +102,10 @@ namespace skyline::gpu::interconnect::maxwell3d {
          * @return If a query has ever been reported to `address`
          */
         bool QueryPresentAtAddress(soc::gm20b::IOVA address);
+
+        /**
+         * @return If a query was reported to `address` in the current render pass, the result at the address won't be written by the GPU till after the render pass
+         */
+        bool QueryPendingAtAddress(InterconnectContext &ctx, soc::gm20b::IOVA address);
     };
 }
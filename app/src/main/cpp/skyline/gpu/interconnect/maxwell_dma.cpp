@@ -3,6 +3,8 @@
 // Copyright © 2022 Skyline Team and Contributors (https://github.com/skyline-emu/)
 
 #include <gpu/buffer_manager.h>
+#include <gpu/texture_manager.h>
+#include <gpu.h>
 #include <soc/gm20b/gmmu.h>
 #include <soc/gm20b/channel.h>
 #include "maxwell_dma.h"
@@ -80,4 +82,99 @@ namespace skyline::gpu::interconnect {
             }, {}, {});
         });
     }
+
+    std::shared_ptr<TextureView> MaxwellDma::FindSurfaceTexture(span<u8> mapping, u32 widthBytes, u32 height, u8 blockHeight, u8 blockDepth) {
+        auto surfaceTexture{gpu.texture.LookupMapping(mapping)};
+        if (!surfaceTexture)
+            return nullptr;
+
+        // Only single-level 2D colour textures with uncompressed formats map directly onto a copy of a byte surface
+        auto &guest{*surfaceTexture->guest};
+        auto &format{guest.format};
+        if (guest.tileConfig.mode != texture::TileMode::Block || guest.tileConfig.blockHeight != blockHeight || guest.tileConfig.blockDepth != blockDepth ||
+            guest.mipLevelCount != 1 || guest.layerCount != 1 || guest.dimensions.depth != 1 ||
+            format->vkAspect != vk::ImageAspectFlagBits::eColor || format->IsCompressed() ||
+            guest.dimensions.width * format->bpb != widthBytes || guest.dimensions.height != height)
+            return nullptr;
+
+        std::shared_ptr<TextureView> view;
+        {
+            ContextLock textureLock{executor.tag, *surfaceTexture};
+            view = surfaceTexture->GetView(vk::ImageViewType::e2D, vk::ImageSubresourceRange{
+                .aspectMask = format->vkAspect,
+                .levelCount = 1,
+                .layerCount = 1,
+            }, format);
+        }
+
+        executor.AttachDependency(view);
+        executor.AttachTexture(view.get());
+        return view;
+    }
+
+    bool MaxwellDma::CopyPitchToBlockLinear(span<u8> dstMapping, span<u8> srcMapping, u32 srcPitch, u32 widthBytes, u32 height, u8 dstBlockHeight, u8 dstBlockDepth) {
+        auto dstView{FindSurfaceTexture(dstMapping, widthBytes, height, dstBlockHeight, dstBlockDepth)};
+        if (!dstView)
+            return false;
+
+        auto dstTexture{dstView->texture};
+        u8 bpb{dstTexture->guest->format->bpb};
+        if (!util::IsAligned(srcPitch, bpb) || !util::IsAligned(reinterpret_cast<uintptr_t>(srcMapping.data()), bpb))
+            return false; // Vulkan requires the buffer offset and row length to be in whole texels
+
+        auto srcBuf{gpu.buffer.FindOrCreate(srcMapping, executor.tag, [this](std::shared_ptr<Buffer> buffer, ContextLock<Buffer> &&lock) {
+            executor.AttachLockedBuffer(buffer, std::move(lock));
+        })};
+        executor.AttachBuffer(srcBuf);
+        srcBuf.GetBuffer()->BlockSequencedCpuBackingWrites();
+
+        dstTexture->MarkGpuDirty(executor.usageTracker);
+
+        executor.AddOutsideRpCommand([srcBuf, dstTexture, rowLength = srcPitch / bpb](vk::raii::CommandBuffer &commandBuffer, const std::shared_ptr<FenceCycle> &, GPU &gpu) {
+            commandBuffer.pipelineBarrier(vk::PipelineStageFlagBits::eAllCommands, vk::PipelineStageFlagBits::eTransfer, {}, vk::MemoryBarrier{
+                .srcAccessMask = vk::AccessFlagBits::eMemoryWrite,
+                .dstAccessMask = vk::AccessFlagBits::eTransferRead | vk::AccessFlagBits::eTransferWrite
+            }, {}, {});
+
+            auto srcBufBinding{srcBuf.GetBinding(gpu)};
+            dstTexture->CopyFromBuffer(commandBuffer, srcBufBinding.buffer, srcBufBinding.offset, rowLength);
+
+            commandBuffer.pipelineBarrier(vk::PipelineStageFlagBits::eTransfer, vk::PipelineStageFlagBits::eAllCommands, {}, vk::MemoryBarrier{
+                .srcAccessMask = vk::AccessFlagBits::eTransferWrite,
+                .dstAccessMask = vk::AccessFlagBits::eMemoryRead | vk::AccessFlagBits::eMemoryWrite,
+            }, {}, {});
+        });
+        return true;
+    }
+
+    bool MaxwellDma::CopyBlockLinearToPitch(span<u8> dstMapping, span<u8> srcMapping, u32 dstPitch, u32 widthBytes, u32 height, u8 srcBlockHeight, u8 srcBlockDepth) {
+        auto srcView{FindSurfaceTexture(srcMapping, widthBytes, height, srcBlockHeight, srcBlockDepth)};
+        if (!srcView)
+            return false;
+
+        auto srcTexture{srcView->texture};
+        u8 bpb{srcTexture->guest->format->bpb};
+        if (!util::IsAligned(dstPitch, bpb) || !util::IsAligned(reinterpret_cast<uintptr_t>(dstMapping.data()), bpb))
+            return false;
+
+        auto dstBuf{gpu.buffer.FindOrCreate(dstMapping, executor.tag, [this](std::shared_ptr<Buffer> buffer, ContextLock<Buffer> &&lock) {
+            executor.AttachLockedBuffer(buffer, std::move(lock));
+        })};
+        executor.AttachBuffer(dstBuf);
+
+        // The rows of the destination are only partially written if the pitch is larger than the row, the gaps must retain their contents which requires any CPU writes to reach the backing first
+        dstBuf.GetBuffer()->BlockSequencedCpuBackingWrites();
+        dstBuf.GetBuffer()->MarkGpuDirty(executor.usageTracker);
+
+        executor.AddOutsideRpCommand([dstBuf, srcTexture, rowLength = dstPitch / bpb](vk::raii::CommandBuffer &commandBuffer, const std::shared_ptr<FenceCycle> &, GPU &gpu) {
+            auto dstBufBinding{dstBuf.GetBinding(gpu)};
+            srcTexture->CopyIntoBuffer(commandBuffer, dstBufBinding.buffer, dstBufBinding.offset, dstBufBinding.size, rowLength);
+
+            commandBuffer.pipelineBarrier(vk::PipelineStageFlagBits::eTransfer, vk::PipelineStageFlagBits::eAllCommands, {}, vk::MemoryBarrier{
+                .srcAccessMask = vk::AccessFlagBits::eTransferWrite,
+                .dstAccessMask = vk::AccessFlagBits::eMemoryRead | vk::AccessFlagBits::eMemoryWrite,
+            }, {}, {});
+        });
+        return true;
+    }
 }
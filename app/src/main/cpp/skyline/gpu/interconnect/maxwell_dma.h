@@ -5,6 +5,7 @@
 #pragma once
 
 #include <soc/gm20b/gmmu.h>
+#include <gpu/texture/texture.h>
 
 namespace skyline::gpu {
     class GPU;
@@ -26,11 +27,29 @@ namespace skyline::gpu::interconnect {
         soc::gm20b::ChannelContext &channelCtx;
         gpu::interconnect::CommandExecutor &executor;
 
+        /**
+         * @return A view of a pre-existing texture that is exactly backed by the supplied block-linear surface or nullptr if there's no texture that the surface can be copied to or from on the GPU
+         * @param widthBytes The width of the surface in bytes, this needs to match the width of the texture as the DMA engine operates on 1 byte per pixel surfaces
+         */
+        std::shared_ptr<TextureView> FindSurfaceTexture(span<u8> mapping, u32 widthBytes, u32 height, u8 blockHeight, u8 blockDepth);
+
       public:
         MaxwellDma(GPU &gpu, soc::gm20b::ChannelContext &channelCtx);
 
         void Copy(span<u8> dstMapping, span<u8> srcMapping);
 
         void Clear(span<u8> mapping, u32 value);
+
+        /**
+         * @brief Copies a pitch-linear buffer into a texture that exactly covers the block-linear destination surface on the GPU
+         * @return If the copy could be done on the GPU, the caller must fallback to a CPU copy otherwise
+         */
+        bool CopyPitchToBlockLinear(span<u8> dstMapping, span<u8> srcMapping, u32 srcPitch, u32 widthBytes, u32 height, u8 dstBlockHeight, u8 dstBlockDepth);
+
+        /**
+         * @brief Copies a texture that exactly covers the block-linear source surface into a pitch-linear buffer on the GPU
+         * @return If the copy could be done on the GPU, the caller must fallback to a CPU copy otherwise
+         */
+        bool CopyBlockLinearToPitch(span<u8> dstMapping, span<u8> srcMapping, u32 dstPitch, u32 widthBytes, u32 height, u8 srcBlockHeight, u8 srcBlockDepth);
     };
 }
@@ -2,10 +2,17 @@
 // Copyright © 2021 Skyline Team and Contributors (https://github.com/skyline-emu/)
 
 #include <gpu.h>
+#include <common/performance_stats.h>
 #include "megabuffer.h"
 
 namespace skyline::gpu {
-    MegaBufferChunk::MegaBufferChunk(GPU &gpu) : backing{gpu.memory.AllocateBuffer(MegaBufferChunkSize)}, freeRegion{backing.subspan(PAGE_SIZE)} {}
+    MegaBufferChunk::MegaBufferChunk(GPU &gpu, vk::DeviceSize size) : backing{gpu.memory.AllocateMegaBuffer(size)}, freeRegion{backing.subspan(PAGE_SIZE)} {
+        PerfStats.megaBufferBytes.fetch_add(static_cast<i64>(backing.size()), std::memory_order_relaxed);
+    }
+
+    MegaBufferChunk::~MegaBufferChunk() {
+        PerfStats.megaBufferBytes.fetch_sub(static_cast<i64>(backing.size()), std::memory_order_relaxed);
+    }
 
     bool MegaBufferChunk::TryReset() {
         if (cycle && cycle->Poll(true)) {
@@ -17,6 +24,15 @@ namespace skyline::gpu {
         return cycle == nullptr;
     }
 
+    void MegaBufferChunk::Reset() {
+        freeRegion = backing.subspan(PAGE_SIZE);
+        cycle = nullptr;
+    }
+
+    vk::DeviceSize MegaBufferChunk::GetSize() const {
+        return backing.size();
+    }
+
     vk::Buffer MegaBufferChunk::GetBacking() const {
         return backing.vkBuffer;
     }
@@ -45,16 +61,58 @@ namespace skyline::gpu {
         return {static_cast<vk::DeviceSize>(resultSpan.data() - backing.data()), resultSpan};
     }
 
-    MegaBufferAllocator::MegaBufferAllocator(GPU &gpu) : gpu{gpu}, activeChunk{chunks.emplace(chunks.end(), gpu)} {}
+    MegaBufferAllocator::MegaBufferAllocator(GPU &gpu, vk::DeviceSize chunkSize) : gpu{gpu}, chunkSize{chunkSize}, activeChunk{chunks.emplace(chunks.end(), gpu, chunkSize)} {}
+
+    void MegaBufferAllocator::Reset() {
+        // Leave space for the unused first page of the chunk and any alignment padding
+        auto targetSize{std::clamp<vk::DeviceSize>(std::bit_ceil(usedSize + usedSize / 8 + PAGE_SIZE), MegaBufferMinChunkSize, MegaBufferChunkSize)};
+        usedSize = 0;
+
+        if (targetSize > chunkSize) {
+            // The prior usage spilled over into additional chunks, replace them all with a single chunk large enough to contain it
+            chunkSize = targetSize;
+            underusedResetCount = 0;
+            chunks.clear();
+        } else if (targetSize * 4 <= chunkSize) {
+            if (++underusedResetCount >= ShrinkResetCount) {
+                chunkSize /= 2;
+                underusedResetCount = 0;
+                chunks.clear();
+            }
+        } else {
+            underusedResetCount = 0;
+        }
+
+        if (chunks.empty()) {
+            chunks.emplace_back(gpu, chunkSize);
+        } else {
+            for (auto &chunk : chunks)
+                chunk.Reset();
+        }
+
+        activeChunk = chunks.begin();
+    }
 
     MegaBufferAllocator::Allocation MegaBufferAllocator::Allocate(const std::shared_ptr<FenceCycle> &cycle, vk::DeviceSize size, bool pageAlign) {
+        usedSize += size;
+
         if (auto allocation{activeChunk->Allocate(cycle, size, pageAlign)}; allocation.first)
             return {activeChunk->GetBacking(), allocation.first, allocation.second};
 
-        activeChunk = ranges::find_if(chunks, [&](auto &chunk) { return chunk.TryReset(); });
-        if (activeChunk == chunks.end()) // If there are no chunks available, allocate a new one
-            activeChunk = chunks.emplace(chunks.end(), gpu);
+        // The chunk after the active one is the least recently used, if it can't be reused then no other chunk can be either
+        auto nextChunk{std::next(activeChunk)};
+        if (nextChunk == chunks.end())
+            nextChunk = chunks.begin();
+
+        if (nextChunk != activeChunk && nextChunk->TryReset()) {
+            if (auto allocation{nextChunk->Allocate(cycle, size, pageAlign)}; allocation.first) {
+                activeChunk = nextChunk;
+                return {activeChunk->GetBacking(), allocation.first, allocation.second};
+            }
+        }
 
+        // Insert a new chunk prior to the next chunk to maintain the ring order, the first page of a chunk is never allocated and space is reserved for alignment padding
+        activeChunk = chunks.emplace(nextChunk, gpu, std::max(chunkSize, util::AlignUp(size, PAGE_SIZE) + (2 * PAGE_SIZE)));
         if (auto allocation{activeChunk->Allocate(cycle, size, pageAlign)}; allocation.first)
             return {activeChunk->GetBacking(), allocation.first, allocation.second};
         else
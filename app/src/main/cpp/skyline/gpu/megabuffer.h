@@ -6,7 +6,9 @@
 #include "memory_manager.h"
 
 namespace skyline::gpu {
-    constexpr static vk::DeviceSize MegaBufferChunkSize{25 * 1024 * 1024}; //!< Size in bytes of a single megabuffer chunk (25MiB)
+    constexpr static vk::DeviceSize MegaBufferChunkSize{25 * 1024 * 1024}; //!< Size in bytes of a single shared megabuffer chunk (25MiB), this is also the largest size a slot megabuffer chunk will grow to
+    constexpr static vk::DeviceSize MegaBufferSlotChunkSize{4 * 1024 * 1024}; //!< Initial size in bytes of a megabuffer chunk owned by an executor slot (4MiB)
+    constexpr static vk::DeviceSize MegaBufferMinChunkSize{1024 * 1024}; //!< The smallest size in bytes a slot megabuffer chunk will shrink to (1MiB)
 
     /**
       * @brief A simple linearly allocated GPU-side buffer used to temporarily store buffer modifications allowing them to be replayed in-sequence on the GPU
@@ -19,7 +21,9 @@ namespace skyline::gpu {
         span<u8> freeRegion; //!< The unallocated space in the chunk
 
       public:
-        MegaBufferChunk(GPU &gpu);
+        MegaBufferChunk(GPU &gpu, vk::DeviceSize size = MegaBufferChunkSize);
+
+        ~MegaBufferChunk();
 
         /**
          * @brief If the chunk's cycle is is signalled, resets the free region of the megabuffer to its initial state, if it's not signalled the chunk must not be used
@@ -27,6 +31,17 @@ namespace skyline::gpu {
          */
         bool TryReset();
 
+        /**
+         * @brief Resets the free region of the megabuffer to its initial state regardless of the cycle
+         * @note The caller must ensure that the GPU is done with all prior allocations in the chunk
+         */
+        void Reset();
+
+        /**
+         * @return The size of the chunk in bytes
+         */
+        vk::DeviceSize GetSize() const;
+
         /**
          * @brief Returns the underlying Vulkan buffer for the chunk
          */
@@ -37,13 +52,20 @@ namespace skyline::gpu {
 
     /**
      * @brief Allocator for megabuffer chunks that takes the usage of resources on the GPU into account
+     * @note Chunks form a ring in the order they were last allocated into, when the active chunk is full only the chunk after it (the least recently used one) is checked for reuse and a new chunk is inserted before it otherwise
+     * @note An allocator owned by a single user (such as an executor slot) can reclaim all chunks at once with Reset, this also adapts the chunk size to the observed usage
      * @note This class is not thread-safe and any calls must be externally synchronized
      */
     class MegaBufferAllocator {
       private:
+        static constexpr size_t ShrinkResetCount{256}; //!< The amount of consecutive resets with usage far below the chunk size after which the chunk size is halved
+
         GPU &gpu;
-        std::list<MegaBufferChunk> chunks; //!< A pool of all allocated megabuffer chunks, these are dynamically utilized
+        vk::DeviceSize chunkSize; //!< The size of any new chunks that are allocated
+        std::list<MegaBufferChunk> chunks; //!< A ring of all allocated megabuffer chunks, these are dynamically utilized
         decltype(chunks)::iterator activeChunk; //!< Currently active chunk of the megabuffer which is being allocated into
+        vk::DeviceSize usedSize{}; //!< The total size of all allocations since the last reset
+        size_t underusedResetCount{}; //!< The amount of consecutive resets where the usage was far below the chunk size
 
       public:
         /**
@@ -59,7 +81,13 @@ namespace skyline::gpu {
             }
         };
 
-        MegaBufferAllocator(GPU &gpu);
+        MegaBufferAllocator(GPU &gpu, vk::DeviceSize chunkSize = MegaBufferChunkSize);
+
+        /**
+         * @brief Reclaims all chunks at once and resizes them based on the usage since the prior reset
+         * @note All cycles that allocations were made with **must** be signalled prior to calling this
+         */
+        void Reset();
 
         /**
           * @brief Allocates data in a megabuffer chunk and returns an structure describing the allocation
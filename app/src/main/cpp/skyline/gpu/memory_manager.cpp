@@ -33,7 +33,52 @@ namespace skyline::gpu::memory {
         return pointer;
     }
 
-    MemoryManager::MemoryManager(GPU &pGpu) : gpu{pGpu} {
+    /**
+     * @brief Staging buffers which aren't in use, sorted into power-of-two size classes
+     */
+    struct StagingBufferPool {
+        static constexpr size_t MinimumSizeClass{16}; //!< The log2 of the smallest size class (64KiB), any smaller buffers are rounded up to this
+        static constexpr size_t MaximumSizeClass{26}; //!< The log2 of the largest size class (64MiB), any larger buffers aren't pooled
+        static constexpr vk::DeviceSize MaximumPooledSize{128 * 1024 * 1024}; //!< The maximum total size of buffers retained in the pool, buffers returned beyond this are freed
+
+        std::mutex mutex;
+        std::array<std::vector<StagingBuffer>, MaximumSizeClass - MinimumSizeClass + 1> freeBuffers;
+        vk::DeviceSize pooledSize{};
+
+        /**
+         * @return The size class of a buffer of the supplied size, this may be above MaximumSizeClass
+         */
+        static size_t GetSizeClass(vk::DeviceSize size) {
+            return std::max<size_t>(static_cast<size_t>(std::bit_width(size - 1)), MinimumSizeClass);
+        }
+
+        std::optional<StagingBuffer> Acquire(size_t sizeClass) {
+            std::scoped_lock lock{mutex};
+            auto &buffers{freeBuffers[sizeClass - MinimumSizeClass]};
+            if (buffers.empty())
+                return std::nullopt;
+
+            StagingBuffer buffer{std::move(buffers.back())};
+            buffers.pop_back();
+            pooledSize -= 1ULL << sizeClass;
+            return buffer;
+        }
+
+        /**
+         * @return If the buffer was retained by the pool, if not it should be freed by the caller
+         */
+        bool Release(StagingBuffer &buffer, size_t sizeClass) {
+            std::scoped_lock lock{mutex};
+            if (pooledSize + (1ULL << sizeClass) > MaximumPooledSize)
+                return false;
+
+            freeBuffers[sizeClass - MinimumSizeClass].emplace_back(std::move(buffer));
+            pooledSize += 1ULL << sizeClass;
+            return true;
+        }
+    };
+
+    MemoryManager::MemoryManager(GPU &pGpu) : gpu{pGpu}, stagingBufferPool{std::make_shared<StagingBufferPool>()} {
         auto instanceDispatcher{gpu.vkInstance.getDispatcher()};
         auto deviceDispatcher{gpu.vkDevice.getDispatcher()};
         VmaVulkanFunctions vulkanFunctions{
@@ -61,6 +106,7 @@ namespace skyline::gpu::memory {
             .vkGetPhysicalDeviceMemoryProperties2KHR = instanceDispatcher->vkGetPhysicalDeviceMemoryProperties2,
         };
         VmaAllocatorCreateInfo allocatorCreateInfo{
+            .flags = gpu.traits.supportsMemoryBudget ? VMA_ALLOCATOR_CREATE_EXT_MEMORY_BUDGET_BIT : VmaAllocatorCreateFlags{},
             .physicalDevice = *gpu.vkPhysicalDevice,
             .device = *gpu.vkDevice,
             .instance = *gpu.vkInstance,
@@ -68,13 +114,109 @@ namespace skyline::gpu::memory {
             .vulkanApiVersion = VkApiVersion,
         };
         ThrowOnFail(vmaCreateAllocator(&allocatorCreateInfo, &vmaAllocator));
+
+        // The pools are created for representative resources of their usage class, the memory types are the same for all resources of a class on practically all drivers
+        stagingVmaPool = CreateVmaPool(vk::BufferCreateInfo{
+            .size = 1,
+            .usage = vk::BufferUsageFlagBits::eTransferSrc | vk::BufferUsageFlagBits::eTransferDst,
+        }, VmaAllocationCreateInfo{
+            .flags = VMA_ALLOCATION_CREATE_MAPPED_BIT,
+            .usage = VMA_MEMORY_USAGE_CPU_ONLY,
+        });
+        megaBufferVmaPool = CreateVmaPool(vk::BufferCreateInfo{
+            .size = 1,
+            .usage = vk::BufferUsageFlagBits::eTransferSrc | vk::BufferUsageFlagBits::eUniformBuffer | vk::BufferUsageFlagBits::eStorageBuffer | vk::BufferUsageFlagBits::eIndexBuffer | vk::BufferUsageFlagBits::eVertexBuffer,
+        }, VmaAllocationCreateInfo{
+            .flags = VMA_ALLOCATION_CREATE_MAPPED_BIT,
+            .usage = VMA_MEMORY_USAGE_UNKNOWN,
+            .requiredFlags = static_cast<VkMemoryPropertyFlags>(vk::MemoryPropertyFlagBits::eHostVisible | vk::MemoryPropertyFlagBits::eHostCoherent | vk::MemoryPropertyFlagBits::eDeviceLocal),
+        });
+
+        vk::ImageCreateInfo imageCreateInfo{
+            .imageType = vk::ImageType::e2D,
+            .format = vk::Format::eR8G8B8A8Unorm,
+            .extent = {1, 1, 1},
+            .mipLevels = 1,
+            .arrayLayers = 1,
+            .samples = vk::SampleCountFlagBits::e1,
+            .tiling = vk::ImageTiling::eOptimal,
+            .usage = vk::ImageUsageFlagBits::eTransferSrc | vk::ImageUsageFlagBits::eTransferDst | vk::ImageUsageFlagBits::eSampled,
+        };
+        VmaAllocationCreateInfo imageAllocationCreateInfo{
+            .usage = VMA_MEMORY_USAGE_GPU_ONLY,
+        };
+        textureVmaPool = CreateVmaPool(imageCreateInfo, imageAllocationCreateInfo);
+        imageCreateInfo.usage |= vk::ImageUsageFlagBits::eColorAttachment;
+        renderTargetVmaPool = CreateVmaPool(imageCreateInfo, imageAllocationCreateInfo);
     }
 
     MemoryManager::~MemoryManager() {
+        {
+            // Pooled buffers must be freed prior to the allocator, any outstanding buffers will be freed directly when released
+            std::scoped_lock lock{stagingBufferPool->mutex};
+            for (auto &buffers : stagingBufferPool->freeBuffers)
+                buffers.clear();
+        }
+        stagingBufferPool.reset();
+
+        for (auto pool : {stagingVmaPool, megaBufferVmaPool, renderTargetVmaPool, textureVmaPool})
+            if (pool)
+                vmaDestroyPool(vmaAllocator, pool);
+
         vmaDestroyAllocator(vmaAllocator);
     }
 
-    std::shared_ptr<StagingBuffer> MemoryManager::AllocateStagingBuffer(vk::DeviceSize size) {
+    VmaPool MemoryManager::CreateVmaPool(const vk::BufferCreateInfo &bufferCreateInfo, const VmaAllocationCreateInfo &allocationCreateInfo) {
+        VmaPoolCreateInfo poolCreateInfo{};
+        if (vmaFindMemoryTypeIndexForBufferInfo(vmaAllocator, &static_cast<const VkBufferCreateInfo &>(bufferCreateInfo), &allocationCreateInfo, &poolCreateInfo.memoryTypeIndex) != VK_SUCCESS)
+            return VK_NULL_HANDLE;
+
+        VmaPool pool{VK_NULL_HANDLE};
+        if (vmaCreatePool(vmaAllocator, &poolCreateInfo, &pool) != VK_SUCCESS)
+            return VK_NULL_HANDLE;
+        return pool;
+    }
+
+    VmaPool MemoryManager::CreateVmaPool(const vk::ImageCreateInfo &imageCreateInfo, const VmaAllocationCreateInfo &allocationCreateInfo) {
+        VmaPoolCreateInfo poolCreateInfo{};
+        if (vmaFindMemoryTypeIndexForImageInfo(vmaAllocator, &static_cast<const VkImageCreateInfo &>(imageCreateInfo), &allocationCreateInfo, &poolCreateInfo.memoryTypeIndex) != VK_SUCCESS)
+            return VK_NULL_HANDLE;
+
+        VmaPool pool{VK_NULL_HANDLE};
+        if (vmaCreatePool(vmaAllocator, &poolCreateInfo, &pool) != VK_SUCCESS)
+            return VK_NULL_HANDLE;
+        return pool;
+    }
+
+    vk::DeviceSize MemoryManager::GetDeviceLocalUsage() {
+        const VkPhysicalDeviceMemoryProperties *memoryProperties;
+        vmaGetMemoryProperties(vmaAllocator, &memoryProperties);
+
+        std::array<VmaBudget, VK_MAX_MEMORY_HEAPS> budgets;
+        vmaGetHeapBudgets(vmaAllocator, budgets.data());
+
+        vk::DeviceSize usage{};
+        for (u32 heap{}; heap < memoryProperties->memoryHeapCount; heap++)
+            if (memoryProperties->memoryHeaps[heap].flags & VK_MEMORY_HEAP_DEVICE_LOCAL_BIT)
+                usage += budgets[heap].usage;
+        return usage;
+    }
+
+    vk::DeviceSize MemoryManager::GetDeviceLocalBudget() {
+        const VkPhysicalDeviceMemoryProperties *memoryProperties;
+        vmaGetMemoryProperties(vmaAllocator, &memoryProperties);
+
+        std::array<VmaBudget, VK_MAX_MEMORY_HEAPS> budgets;
+        vmaGetHeapBudgets(vmaAllocator, budgets.data());
+
+        vk::DeviceSize budget{};
+        for (u32 heap{}; heap < memoryProperties->memoryHeapCount; heap++)
+            if (memoryProperties->memoryHeaps[heap].flags & VK_MEMORY_HEAP_DEVICE_LOCAL_BIT)
+                budget += budgets[heap].budget;
+        return budget;
+    }
+
+    StagingBuffer MemoryManager::CreateStagingBuffer(vk::DeviceSize size) {
         vk::BufferCreateInfo bufferCreateInfo{
             .size = size,
             .usage = vk::BufferUsageFlagBits::eTransferSrc | vk::BufferUsageFlagBits::eTransferDst,
@@ -85,6 +227,7 @@ namespace skyline::gpu::memory {
         VmaAllocationCreateInfo allocationCreateInfo{
             .flags = VMA_ALLOCATION_CREATE_MAPPED_BIT,
             .usage = VMA_MEMORY_USAGE_CPU_ONLY,
+            .pool = stagingVmaPool,
         };
 
         VkBuffer buffer;
@@ -92,13 +235,31 @@ namespace skyline::gpu::memory {
         VmaAllocationInfo allocationInfo;
         ThrowOnFail(vmaCreateBuffer(vmaAllocator, &static_cast<const VkBufferCreateInfo &>(bufferCreateInfo), &allocationCreateInfo, &buffer, &allocation, &allocationInfo));
 
-        return std::make_shared<memory::StagingBuffer>(reinterpret_cast<u8 *>(allocationInfo.pMappedData), size, vmaAllocator, buffer, allocation);
+        return StagingBuffer{reinterpret_cast<u8 *>(allocationInfo.pMappedData), size, vmaAllocator, buffer, allocation};
     }
 
-    Buffer MemoryManager::AllocateBuffer(vk::DeviceSize size) {
+    std::shared_ptr<StagingBuffer> MemoryManager::AllocateStagingBuffer(vk::DeviceSize size) {
+        size_t sizeClass{StagingBufferPool::GetSizeClass(size)};
+        if (sizeClass > StagingBufferPool::MaximumSizeClass)
+            return std::make_shared<StagingBuffer>(CreateStagingBuffer(size));
+
+        auto pooledBuffer{stagingBufferPool->Acquire(sizeClass)};
+        auto buffer{new StagingBuffer{pooledBuffer ? std::move(*pooledBuffer) : CreateStagingBuffer(1ULL << sizeClass)}};
+        static_cast<span<u8> &>(*buffer) = span<u8>{buffer->data(), size}; // The buffer is exposed with the requested size rather than that of its size class
+
+        return std::shared_ptr<StagingBuffer>{buffer, [pool = std::weak_ptr{stagingBufferPool}, sizeClass](StagingBuffer *buffer) {
+            if (auto lockedPool{pool.lock()}) {
+                static_cast<span<u8> &>(*buffer) = span<u8>{buffer->data(), 1ULL << sizeClass};
+                lockedPool->Release(*buffer, sizeClass);
+            }
+            delete buffer; // If the buffer was retained by the pool then this will only destroy the moved-from object
+        }};
+    }
+
+    Buffer MemoryManager::AllocateBuffer(vk::DeviceSize size, VmaPool pool) {
         vk::BufferCreateInfo bufferCreateInfo{
             .size = size,
-            .usage = vk::BufferUsageFlagBits::eTransferSrc | vk::BufferUsageFlagBits::eTransferDst | vk::BufferUsageFlagBits::eUniformTexelBuffer | vk::BufferUsageFlagBits::eStorageTexelBuffer | vk::BufferUsageFlagBits::eUniformBuffer | vk::BufferUsageFlagBits::eStorageBuffer | vk::BufferUsageFlagBits::eIndexBuffer | vk::BufferUsageFlagBits::eVertexBuffer | vk::BufferUsageFlagBits::eIndirectBuffer | vk::BufferUsageFlagBits::eTransformFeedbackBufferEXT,
+            .usage = vk::BufferUsageFlagBits::eTransferSrc | vk::BufferUsageFlagBits::eTransferDst | vk::BufferUsageFlagBits::eUniformTexelBuffer | vk::BufferUsageFlagBits::eStorageTexelBuffer | vk::BufferUsageFlagBits::eUniformBuffer | vk::BufferUsageFlagBits::eStorageBuffer | vk::BufferUsageFlagBits::eIndexBuffer | vk::BufferUsageFlagBits::eVertexBuffer | vk::BufferUsageFlagBits::eIndirectBuffer | vk::BufferUsageFlagBits::eTransformFeedbackBufferEXT | (gpu.traits.supportsConditionalRendering ? vk::BufferUsageFlagBits::eConditionalRenderingEXT : vk::BufferUsageFlags{}),
             .sharingMode = vk::SharingMode::eExclusive,
             .queueFamilyIndexCount = 1,
             .pQueueFamilyIndices = &gpu.vkQueueFamilyIndex,
@@ -107,6 +268,7 @@ namespace skyline::gpu::memory {
             .flags = VMA_ALLOCATION_CREATE_MAPPED_BIT,
             .usage = VMA_MEMORY_USAGE_UNKNOWN,
             .requiredFlags = static_cast<VkMemoryPropertyFlags>(vk::MemoryPropertyFlagBits::eHostVisible | vk::MemoryPropertyFlagBits::eHostCoherent | vk::MemoryPropertyFlagBits::eDeviceLocal),
+            .pool = pool,
         };
 
         VkBuffer buffer;
@@ -117,9 +279,41 @@ namespace skyline::gpu::memory {
         return Buffer(reinterpret_cast<u8 *>(allocationInfo.pMappedData), size, vmaAllocator, buffer, allocation);
     }
 
+    Buffer MemoryManager::AllocateBuffer(vk::DeviceSize size) {
+        return AllocateBuffer(size, VK_NULL_HANDLE);
+    }
+
+    Buffer MemoryManager::AllocateMegaBuffer(vk::DeviceSize size) {
+        return AllocateBuffer(size, megaBufferVmaPool);
+    }
+
+    Image MemoryManager::CreateImage(const vk::ImageCreateInfo &createInfo, VmaAllocationCreateInfo allocationCreateInfo) {
+        allocationCreateInfo.pool = createInfo.usage & (vk::ImageUsageFlagBits::eColorAttachment | vk::ImageUsageFlagBits::eDepthStencilAttachment) ? renderTargetVmaPool : textureVmaPool;
+
+        VkImage image;
+        VmaAllocation allocation;
+        VmaAllocationInfo allocationInfo;
+        auto result{vmaCreateImage(vmaAllocator, &static_cast<const VkImageCreateInfo &>(createInfo), &allocationCreateInfo, &image, &allocation, &allocationInfo)};
+        if (result == VK_ERROR_FEATURE_NOT_PRESENT && allocationCreateInfo.pool) {
+            // The memory type of the pool isn't supported by the image, this can be the case for certain formats
+            allocationCreateInfo.pool = VK_NULL_HANDLE;
+            result = vmaCreateImage(vmaAllocator, &static_cast<const VkImageCreateInfo &>(createInfo), &allocationCreateInfo, &image, &allocation, &allocationInfo);
+        }
+        ThrowOnFail(result);
+
+        return Image(vmaAllocator, image, allocation);
+    }
+
     Image MemoryManager::AllocateImage(const vk::ImageCreateInfo &createInfo) {
-        VmaAllocationCreateInfo allocationCreateInfo{
+        return CreateImage(createInfo, VmaAllocationCreateInfo{
             .usage = VMA_MEMORY_USAGE_GPU_ONLY,
+        });
+    }
+
+    Image MemoryManager::AllocateMappedImage(const vk::ImageCreateInfo &createInfo) {
+        VmaAllocationCreateInfo allocationCreateInfo{
+            .usage = VMA_MEMORY_USAGE_UNKNOWN,
+            .requiredFlags = static_cast<VkMemoryPropertyFlags>(vk::MemoryPropertyFlagBits::eHostVisible | vk::MemoryPropertyFlagBits::eHostCoherent | vk::MemoryPropertyFlagBits::eDeviceLocal),
         };
 
         VkImage image;
@@ -130,10 +324,9 @@ namespace skyline::gpu::memory {
         return Image(vmaAllocator, image, allocation);
     }
 
-    Image MemoryManager::AllocateMappedImage(const vk::ImageCreateInfo &createInfo) {
+    Image MemoryManager::AllocateTransientImage(const vk::ImageCreateInfo &createInfo) {
         VmaAllocationCreateInfo allocationCreateInfo{
-            .usage = VMA_MEMORY_USAGE_UNKNOWN,
-            .requiredFlags = static_cast<VkMemoryPropertyFlags>(vk::MemoryPropertyFlagBits::eHostVisible | vk::MemoryPropertyFlagBits::eHostCoherent | vk::MemoryPropertyFlagBits::eDeviceLocal),
+            .usage = VMA_MEMORY_USAGE_GPU_LAZILY_ALLOCATED,
         };
 
         VkImage image;
@@ -144,16 +337,18 @@ namespace skyline::gpu::memory {
         return Image(vmaAllocator, image, allocation);
     }
 
+    static constexpr vk::BufferUsageFlags ImportedBufferUsage{vk::BufferUsageFlagBits::eTransferSrc | vk::BufferUsageFlagBits::eTransferDst | vk::BufferUsageFlagBits::eUniformTexelBuffer | vk::BufferUsageFlagBits::eStorageTexelBuffer | vk::BufferUsageFlagBits::eUniformBuffer | vk::BufferUsageFlagBits::eStorageBuffer | vk::BufferUsageFlagBits::eIndexBuffer | vk::BufferUsageFlagBits::eVertexBuffer | vk::BufferUsageFlagBits::eIndirectBuffer | vk::BufferUsageFlagBits::eTransformFeedbackBufferEXT};
+
     ImportedBuffer MemoryManager::ImportBuffer(span<u8> cpuMapping) {
         if (!gpu.traits.supportsAdrenoDirectMemoryImport)
-            throw exception("Cannot import host buffers without adrenotools import support!");
+            return ImportHostBuffer(cpuMapping);
 
         if (!adrenotools_import_user_mem(&gpu.adrenotoolsImportMapping, cpuMapping.data(), cpuMapping.size()))
             throw exception("Failed to import user memory");
 
         auto buffer{gpu.vkDevice.createBuffer(vk::BufferCreateInfo{
             .size = cpuMapping.size(),
-            .usage = vk::BufferUsageFlagBits::eTransferSrc | vk::BufferUsageFlagBits::eTransferDst | vk::BufferUsageFlagBits::eUniformTexelBuffer | vk::BufferUsageFlagBits::eStorageTexelBuffer | vk::BufferUsageFlagBits::eUniformBuffer | vk::BufferUsageFlagBits::eStorageBuffer | vk::BufferUsageFlagBits::eIndexBuffer | vk::BufferUsageFlagBits::eVertexBuffer | vk::BufferUsageFlagBits::eIndirectBuffer | vk::BufferUsageFlagBits::eTransformFeedbackBufferEXT,
+            .usage = ImportedBufferUsage | (gpu.traits.supportsConditionalRendering ? vk::BufferUsageFlagBits::eConditionalRenderingEXT : vk::BufferUsageFlags{}),
             .sharingMode = vk::SharingMode::eExclusive
         })};
 
@@ -173,4 +368,65 @@ namespace skyline::gpu::memory {
 
         return ImportedBuffer{cpuMapping, std::move(buffer), std::move(memory)};
     }
+
+    ImportedBuffer MemoryManager::ImportHostBuffer(span<u8> cpuMapping) {
+        if (!gpu.traits.supportsExternalMemoryHost)
+            throw exception("Cannot import host buffers without adrenotools import support or VK_EXT_external_memory_host!");
+
+        auto alignment{gpu.traits.minImportedHostPointerAlignment};
+        if (reinterpret_cast<uintptr_t>(cpuMapping.data()) % alignment || cpuMapping.size() % alignment)
+            throw exception("Host buffer import isn't aligned to 0x{:X}: 0x{:X} (0x{:X})", alignment, cpuMapping.data(), cpuMapping.size());
+
+        constexpr auto HandleType{vk::ExternalMemoryHandleTypeFlagBits::eHostAllocationEXT};
+        auto hostPointerProperties{gpu.vkDevice.getMemoryHostPointerPropertiesEXT(HandleType, cpuMapping.data())};
+
+        // Prefer the same memory type as the Adreno path as it's cached on the CPU, otherwise use any host visible type the pointer supports
+        u32 memoryTypeIndex{std::numeric_limits<u32>::max()};
+        if (gpu.traits.hostVisibleCoherentCachedMemoryType != std::numeric_limits<u32>::max() && hostPointerProperties.memoryTypeBits & (1U << gpu.traits.hostVisibleCoherentCachedMemoryType)) {
+            memoryTypeIndex = gpu.traits.hostVisibleCoherentCachedMemoryType;
+        } else {
+            auto memoryProperties{gpu.vkPhysicalDevice.getMemoryProperties()};
+            for (u32 index{}; index < memoryProperties.memoryTypeCount; index++) {
+                if (hostPointerProperties.memoryTypeBits & (1U << index) && memoryProperties.memoryTypes[index].propertyFlags & vk::MemoryPropertyFlagBits::eHostCoherent) {
+                    memoryTypeIndex = index;
+                    break;
+                }
+            }
+        }
+
+        if (memoryTypeIndex == std::numeric_limits<u32>::max())
+            throw exception("No host coherent memory type supports importing host pointer 0x{:X}", cpuMapping.data());
+
+        vk::StructureChain<vk::BufferCreateInfo, vk::ExternalMemoryBufferCreateInfo> bufferCreateInfo{
+            vk::BufferCreateInfo{
+                .size = cpuMapping.size(),
+                .usage = ImportedBufferUsage | (gpu.traits.supportsConditionalRendering ? vk::BufferUsageFlagBits::eConditionalRenderingEXT : vk::BufferUsageFlags{}),
+                .sharingMode = vk::SharingMode::eExclusive
+            },
+            vk::ExternalMemoryBufferCreateInfo{
+                .handleTypes = HandleType,
+            }
+        };
+        auto buffer{gpu.vkDevice.createBuffer(bufferCreateInfo.get<vk::BufferCreateInfo>())};
+
+        vk::StructureChain<vk::MemoryAllocateInfo, vk::ImportMemoryHostPointerInfoEXT> allocateInfo{
+            vk::MemoryAllocateInfo{
+                .allocationSize = cpuMapping.size(),
+                .memoryTypeIndex = memoryTypeIndex,
+            },
+            vk::ImportMemoryHostPointerInfoEXT{
+                .handleType = HandleType,
+                .pHostPointer = cpuMapping.data(),
+            }
+        };
+        auto memory{gpu.vkDevice.allocateMemory(allocateInfo.get<vk::MemoryAllocateInfo>())};
+
+        gpu.vkDevice.bindBufferMemory2({vk::BindBufferMemoryInfo{
+            .buffer = *buffer,
+            .memory = *memory,
+            .memoryOffset = 0
+        }});
+
+        return ImportedBuffer{cpuMapping, std::move(buffer), std::move(memory)};
+    }
 }
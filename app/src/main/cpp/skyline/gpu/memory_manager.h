@@ -113,6 +113,8 @@ namespace skyline::gpu::memory {
         u8 *data();
     };
 
+    struct StagingBufferPool;
+
     /**
      * @brief An abstraction over memory operations done in Vulkan, it's used for all allocations on the host GPU
      */
@@ -120,14 +122,53 @@ namespace skyline::gpu::memory {
       private:
         GPU &gpu;
         VmaAllocator vmaAllocator{VK_NULL_HANDLE};
+        std::shared_ptr<StagingBufferPool> stagingBufferPool; //!< Staging buffers are recycled through this rather than being freed, it's shared with the deleters of outstanding staging buffers
+
+        /* Allocations of each usage class are made from separate VMA pools, this keeps short-lived allocations from fragmenting the blocks of long-lived ones and allows tracking the usage of each class independently
+         * Any of these can be VK_NULL_HANDLE if no memory type could be found for the pool, allocations are made from the default pools in that case */
+        VmaPool stagingVmaPool{VK_NULL_HANDLE};
+        VmaPool megaBufferVmaPool{VK_NULL_HANDLE};
+        VmaPool renderTargetVmaPool{VK_NULL_HANDLE}; //!< Images with color or depth/stencil attachment usage
+        VmaPool textureVmaPool{VK_NULL_HANDLE}; //!< Images without any attachment usage
+
+        /**
+         * @return A VMA pool for buffers/images created with the supplied parameters or VK_NULL_HANDLE if no suitable memory type exists
+         */
+        VmaPool CreateVmaPool(const vk::BufferCreateInfo &bufferCreateInfo, const VmaAllocationCreateInfo &allocationCreateInfo);
+
+        VmaPool CreateVmaPool(const vk::ImageCreateInfo &imageCreateInfo, const VmaAllocationCreateInfo &allocationCreateInfo);
+
+        /**
+         * @brief Creates a new staging buffer with VMA, bypassing the pool
+         */
+        StagingBuffer CreateStagingBuffer(vk::DeviceSize size);
+
+        Buffer AllocateBuffer(vk::DeviceSize size, VmaPool pool);
+
+        /**
+         * @brief Creates an image in the pool corresponding to its usage, falling back to the default pools if the image can't be allocated from the memory type of that pool
+         */
+        Image CreateImage(const vk::ImageCreateInfo &createInfo, VmaAllocationCreateInfo allocationCreateInfo);
 
       public:
         MemoryManager(GPU &gpu);
 
         ~MemoryManager();
 
+        /**
+         * @return The amount of memory in bytes that's currently allocated from device-local heaps, this includes allocations made outside of VMA as reported by the driver
+         */
+        vk::DeviceSize GetDeviceLocalUsage();
+
+        /**
+         * @return The amount of memory in bytes that can be allocated from device-local heaps without risking the driver or the OS reclaiming memory forcibly, this is the sum of the budgets of all device-local heaps
+         * @note This is only an estimate based on the heap sizes if TraitManager::supportsMemoryBudget isn't set
+         */
+        vk::DeviceSize GetDeviceLocalBudget();
+
         /**
          * @brief Creates a buffer which is optimized for staging (Transfer Source)
+         * @note Buffers are sub-allocated from power-of-two size classes and recycled once all references to them are dropped, this is after any fence cycles they're attached to have been signalled
          */
         std::shared_ptr<StagingBuffer> AllocateStagingBuffer(vk::DeviceSize size);
 
@@ -136,6 +177,11 @@ namespace skyline::gpu::memory {
          */
         Buffer AllocateBuffer(vk::DeviceSize size);
 
+        /**
+         * @brief Same as AllocateBuffer but the buffer is allocated from a pool dedicated to megabuffer chunks
+         */
+        Buffer AllocateMegaBuffer(vk::DeviceSize size);
+
         /**
          * @brief Creates an image which is allocated and deallocated using RAII
          */
@@ -146,9 +192,21 @@ namespace skyline::gpu::memory {
          */
         Image AllocateMappedImage(const vk::ImageCreateInfo &createInfo);
 
+        /**
+         * @brief Creates an image which is allocated and deallocated using RAII and is backed by lazily allocated memory, it must have transient attachment usage
+         * @note This must only be used when TraitManager::supportsLazilyAllocatedMemory is set
+         */
+        Image AllocateTransientImage(const vk::ImageCreateInfo &createInfo);
+
         /**
          * @brief Maps the input CPU mapped region into a new buffer
          */
         ImportedBuffer ImportBuffer(span<u8> cpuMapping);
+
+        /**
+         * @brief Maps the input CPU mapped region into a new buffer using VK_EXT_external_memory_host, the region must be aligned to `minImportedHostPointerAlignment`
+         * @note This is used by ImportBuffer() when the Adreno-specific import path is unavailable
+         */
+        ImportedBuffer ImportHostBuffer(span<u8> cpuMapping);
     };
 }
@@ -5,6 +5,9 @@
 #include <android/choreographer.h>
 #include <common/settings.h>
 #include <common/signal.h>
+#include <common/performance_stats.h>
+#include <common/performance_hint.h>
+#include <common/boot_profiler.h>
 #include <jvm.h>
 #include <gpu.h>
 #include <soc.h>
@@ -92,23 +95,90 @@ namespace skyline::gpu {
         }
     }
 
+    void PresentationEngine::UpdatePacingFeedback() {
+        auto weightedAverage{[](i64 previousAverage, i64 current) {
+            return previousAverage ? ((previousAverage * 7) + current) / 8 : current;
+        }};
+
+        size_t remaining{};
+        for (size_t index{}; index < pacedFrameCount; index++) {
+            auto &pacedFrame{pacedFrames[index]};
+            i64 latchTime{}, displayPresentTime{};
+            int result{window->perform(window, NATIVE_WINDOW_GET_FRAME_TIMESTAMPS, pacedFrame.frameId,
+                                       nullptr, nullptr, &latchTime, nullptr, nullptr, nullptr, &displayPresentTime, nullptr, nullptr)};
+            if (result) // The frame is too old for the compositor to have its timestamps
+                continue;
+
+            if (latchTime == NativeWindowTimestampPending || displayPresentTime == NativeWindowTimestampPending) {
+                pacedFrames[remaining++] = pacedFrame;
+                continue;
+            }
+
+            if (latchTime <= 0 || displayPresentTime <= 0)
+                continue;
+
+            // A frame displayed a refresh cycle after its target was queued too late, the required lead time is increased by a refresh cycle to avoid repeatedly missing the target
+            i64 sample{displayPresentTime - latchTime};
+            if (displayPresentTime - pacedFrame.requestedTime > refreshCycleDuration / 2)
+                sample += refreshCycleDuration;
+            presentLatencyNs = weightedAverage(presentLatencyNs, sample);
+        }
+        pacedFrameCount = remaining;
+
+        TRACE_EVENT_INSTANT("gpu", "PacingFeedback", presentationTrack, "PresentLatencyNs", presentLatencyNs, "GuestFrameLatencyNs", guestFrameLatencyNs);
+    }
+
+    i64 PresentationEngine::GetPacedTimestamp(i64 now, i64 swapInterval) {
+        i64 earliestTime{std::max(now + presentLatencyNs, lastTargetTime + (refreshCycleDuration * swapInterval))};
+
+        // The target is aligned to the display's refresh phase as a frame can only be displayed at a refresh boundary, requesting anything in between only adds variance
+        if (refreshCycleDuration && lastChoreographerTime && earliestTime > lastChoreographerTime)
+            earliestTime = lastChoreographerTime + util::AlignUpNpot(earliestTime - lastChoreographerTime, refreshCycleDuration);
+
+        return lastTargetTime = earliestTime;
+    }
+
     void PresentationEngine::PresentFrame(const PresentableFrame &frame) {
         std::unique_lock lock(mutex);
         surfaceCondition.wait(lock, [this]() { return vkSurface.has_value(); });
 
         frame.fence.Wait(state.soc->host1x);
 
+        bool framePacing{*state.settings->framePacing && !*state.settings->disableFrameThrottling && frame.swapInterval};
+        if (framePacing) {
+            guestFrameLatencyNs = ((guestFrameLatencyNs * 7) + (util::GetTimeNs() - frame.queueTime)) / 8;
+            UpdatePacingFeedback();
+        }
+
         std::scoped_lock textureLock(*frame.textureView);
 
         auto texture{frame.textureView->texture};
-        if (frame.textureView->format != swapchainFormat || texture->dimensions != swapchainExtent)
-            UpdateSwapchain(frame.textureView->format, texture->dimensions);
+
+        // Frames rendered below the guest resolution are upscaled back to it rather than leaving them to be stretched by the compositor
+        auto upscalingMode{static_cast<UpscalingMode>(*state.settings->upscalingMode)};
+        bool upscale{upscalingMode != UpscalingMode::None && texture->renderScale < 1.0f};
+        bool sharpen{upscale && upscalingMode == UpscalingMode::Sharpened};
+        auto extent{upscale ? texture->guest->dimensions : texture->dimensions};
+        if (frame.textureView->format != swapchainFormat || extent != swapchainExtent || sharpen != swapchainSharpening)
+            UpdateSwapchain(frame.textureView->format, extent, sharpen);
+
+        // The crop is in guest texels while the swapchain is at the host resolution of the texture unless the frame is upscaled
+        auto crop{frame.crop};
+        if (crop && !upscale && texture->renderScale != 1.0f) {
+            auto scaleEdge{[&](u32 edge, u32 limit) { return std::min(static_cast<u32>(std::lround(edge * texture->renderScale)), limit); }};
+            crop = {
+                .left = scaleEdge(crop.left, texture->dimensions.width),
+                .top = scaleEdge(crop.top, texture->dimensions.height),
+                .right = scaleEdge(crop.right, texture->dimensions.width),
+                .bottom = scaleEdge(crop.bottom, texture->dimensions.height),
+            };
+        }
 
         int result;
-        if (frame.crop && frame.crop != windowCrop) {
-            if ((result = window->perform(window, NATIVE_WINDOW_SET_CROP, &frame.crop)))
-                throw exception("Setting the layer crop to ({}-{})x({}-{}) failed with {}", frame.crop.left, frame.crop.right, frame.crop.top, frame.crop.bottom, result);
-            windowCrop = frame.crop;
+        if (crop && crop != windowCrop) {
+            if ((result = window->perform(window, NATIVE_WINDOW_SET_CROP, &crop)))
+                throw exception("Setting the layer crop to ({}-{})x({}-{}) failed with {}", crop.left, crop.right, crop.top, crop.bottom, result);
+            windowCrop = crop;
         }
 
         if (frame.scalingMode != NativeWindowScalingMode::Freeze && windowScalingMode != frame.scalingMode) {
@@ -140,11 +210,14 @@ namespace skyline::gpu {
         auto &presentSemaphore{presentSemaphores[nextImage.second]};
 
         texture->SynchronizeHost();
-        nextImageTexture->CopyFrom(texture, *acquireSemaphore, *presentSemaphore, swapchainFormat, vk::ImageSubresourceRange{
-            .aspectMask = vk::ImageAspectFlagBits::eColor,
-            .levelCount = 1,
-            .layerCount = 1,
-        });
+        if (upscale)
+            UpscaleFrame(frame.textureView, nextImageTexture, *acquireSemaphore, *presentSemaphore, sharpen && swapchainStorage);
+        else
+            nextImageTexture->CopyFrom(texture, *acquireSemaphore, *presentSemaphore, swapchainFormat, vk::ImageSubresourceRange{
+                .aspectMask = vk::ImageAspectFlagBits::eColor,
+                .levelCount = 1,
+                .layerCount = 1,
+            });
 
         frameFence = nextImageTexture->cycle;
 
@@ -168,7 +241,10 @@ namespace skyline::gpu {
             }
         }
 
-        if (frame.swapInterval) {
+        if (framePacing) {
+            // Frame pacing schedules the frame for the earliest refresh that it can make rather than a fixed amount of refreshes after the last one
+            timestamp = std::max(timestamp, GetPacedTimestamp(getMonotonicNsNow(), frame.swapInterval));
+        } else if (frame.swapInterval) {
             // If we have a swap interval, we have to adjust the timestamp to emulate the swap interval
             i64 lastFramePresentTime{util::AlignUpNpot(windowLastTimestamp, refreshCycleDuration)};
             if (lastFramePresentTime > lastChoreographerTime)
@@ -191,6 +267,14 @@ namespace skyline::gpu {
         if ((result = window->perform(window, NATIVE_WINDOW_GET_NEXT_FRAME_ID, &frameId)))
             throw exception("Retrieving the next frame's ID failed with {}", result);
 
+        if (framePacing) {
+            if (pacedFrameCount == PacedFrameCount) {
+                std::move(std::next(pacedFrames.begin()), pacedFrames.end(), pacedFrames.begin());
+                pacedFrameCount--;
+            }
+            pacedFrames[pacedFrameCount++] = PacedFrame{frameId, timestamp};
+        }
+
         {
             std::scoped_lock queueLock{gpu.queueMutex};
             std::ignore = gpu.vkQueue.presentKHR(vk::PresentInfoKHR{
@@ -221,6 +305,13 @@ namespace skyline::gpu {
             Fps = static_cast<jint>(std::round(static_cast<float>(constant::NsInSecond) / static_cast<float>(averageFrametimeNs)));
 
             TRACE_EVENT_INSTANT("gpu", "Present", presentationTrack, "FrameTimeNs", timestamp - frameTimestamp, "Fps", Fps);
+            trace::EmitFrameCounters();
+            PerfStats.PushFrame(currentFrametime);
+            i64 frameIntervalNs{frame.swapInterval ? (frame.swapInterval * constant::NsInSecond) / 60 : refreshCycleDuration};
+            gpu.resolution.Update(PerfStats.frameGpuTimeNs.load(std::memory_order_relaxed), frameIntervalNs);
+            PerformanceHint::ReportFrame(frameIntervalNs);
+            if (BootProfile.IsRunning()) [[unlikely]]
+                BootProfile.Finish();
 
             frameTimestamp = timestamp;
         } else {
@@ -228,6 +319,133 @@ namespace skyline::gpu {
         }
     }
 
+    void PresentationEngine::UpscaleFrame(const std::shared_ptr<TextureView> &source, const std::shared_ptr<Texture> &destination, vk::Semaphore waitSemaphore, vk::Semaphore signalSemaphore, bool sharpen) {
+        auto texture{source->texture};
+        if (destination->cycle)
+            destination->cycle->WaitSubmit();
+        if (texture->cycle)
+            texture->cycle->WaitSubmit();
+
+        destination->WaitOnBacking();
+        texture->WaitOnBacking();
+        destination->WaitOnFence();
+
+        if (texture->layout == vk::ImageLayout::eUndefined)
+            throw exception("Cannot upscale from image with undefined layout");
+
+        TRACE_EVENT("gpu", "PresentationEngine::UpscaleFrame");
+
+        constexpr vk::ImageSubresourceRange subresource{
+            .aspectMask = vk::ImageAspectFlagBits::eColor,
+            .levelCount = 1,
+            .layerCount = 1,
+        };
+
+        // The sharpening shader samples the source and writes the destination as a storage image while bilinear upscaling is done with a single filtered blit
+        auto srcLayout{sharpen ? vk::ImageLayout::eGeneral : vk::ImageLayout::eTransferSrcOptimal}, dstLayout{sharpen ? vk::ImageLayout::eGeneral : vk::ImageLayout::eTransferDstOptimal};
+        auto stage{sharpen ? vk::PipelineStageFlagBits::eComputeShader : vk::PipelineStageFlagBits::eTransfer};
+        auto srcAccess{sharpen ? vk::AccessFlagBits::eShaderRead : vk::AccessFlagBits::eTransferRead}, dstAccess{sharpen ? vk::AccessFlagBits::eShaderWrite : vk::AccessFlagBits::eTransferWrite};
+        vk::ImageView srcView{sharpen ? source->GetView() : vk::ImageView{}}, dstView{sharpen ? destination->GetView(vk::ImageViewType::e2D, subresource)->GetView() : vk::ImageView{}};
+        auto filter{(gpu.vkPhysicalDevice.getFormatProperties(*texture->format).optimalTilingFeatures & vk::FormatFeatureFlagBits::eSampledImageFilterLinear) ? vk::Filter::eLinear : vk::Filter::eNearest};
+
+        auto submitFunc{[&](vk::Semaphore extraWaitSemaphore) {
+            std::array<vk::Semaphore, 2> waitSemaphores{waitSemaphore, extraWaitSemaphore};
+
+            auto commandBuffer{gpu.scheduler.AllocateCommandBuffer()};
+            auto cycle{commandBuffer.GetFenceCycle()};
+            try {
+                commandBuffer->begin(vk::CommandBufferBeginInfo{
+                    .flags = vk::CommandBufferUsageFlagBits::eOneTimeSubmit,
+                });
+
+                auto sourceBacking{texture->GetBacking()}, destinationBacking{destination->GetBacking()};
+                commandBuffer->pipelineBarrier(vk::PipelineStageFlagBits::eAllCommands, stage, {}, {}, {}, std::array<vk::ImageMemoryBarrier, 2>{
+                    vk::ImageMemoryBarrier{
+                        .image = sourceBacking,
+                        .srcAccessMask = vk::AccessFlagBits::eMemoryWrite,
+                        .dstAccessMask = srcAccess,
+                        .oldLayout = texture->layout,
+                        .newLayout = srcLayout,
+                        .srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
+                        .dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
+                        .subresourceRange = subresource,
+                    },
+                    vk::ImageMemoryBarrier{
+                        // The destination is entirely overwritten so its prior contents are discarded
+                        .image = destinationBacking,
+                        .srcAccessMask = vk::AccessFlagBits::eMemoryRead,
+                        .dstAccessMask = dstAccess,
+                        .oldLayout = vk::ImageLayout::eUndefined,
+                        .newLayout = dstLayout,
+                        .srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
+                        .dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
+                        .subresourceRange = subresource,
+                    },
+                });
+
+                if (sharpen) {
+                    gpu.helperShaders.upscaleHelperShader.Upscale(gpu, *commandBuffer, cycle, srcView, dstView, vk::Extent2D{destination->dimensions.width, destination->dimensions.height}, UpscalingSharpness);
+                } else {
+                    vk::ImageSubresourceLayers subresourceLayers{
+                        .aspectMask = subresource.aspectMask,
+                        .layerCount = 1,
+                    };
+                    commandBuffer->blitImage(sourceBacking, srcLayout, destinationBacking, dstLayout, vk::ImageBlit{
+                        .srcSubresource = subresourceLayers,
+                        .srcOffsets = std::array<vk::Offset3D, 2>{
+                            vk::Offset3D{0, 0, 0},
+                            vk::Offset3D{static_cast<i32>(texture->dimensions.width), static_cast<i32>(texture->dimensions.height), 1}
+                        },
+                        .dstSubresource = subresourceLayers,
+                        .dstOffsets = std::array<vk::Offset3D, 2>{
+                            vk::Offset3D{0, 0, 0},
+                            vk::Offset3D{static_cast<i32>(destination->dimensions.width), static_cast<i32>(destination->dimensions.height), 1}
+                        }
+                    }, filter);
+                }
+
+                commandBuffer->pipelineBarrier(stage, vk::PipelineStageFlagBits::eAllCommands, {}, {}, {}, std::array<vk::ImageMemoryBarrier, 2>{
+                    vk::ImageMemoryBarrier{
+                        .image = destinationBacking,
+                        .srcAccessMask = dstAccess,
+                        .dstAccessMask = vk::AccessFlagBits::eMemoryRead,
+                        .oldLayout = dstLayout,
+                        .newLayout = destination->layout,
+                        .srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
+                        .dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
+                        .subresourceRange = subresource,
+                    },
+                    vk::ImageMemoryBarrier{
+                        .image = sourceBacking,
+                        .srcAccessMask = srcAccess,
+                        .dstAccessMask = vk::AccessFlagBits::eMemoryWrite,
+                        .oldLayout = srcLayout,
+                        .newLayout = texture->layout,
+                        .srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
+                        .dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
+                        .subresourceRange = subresource,
+                    },
+                });
+
+                commandBuffer->end();
+                gpu.scheduler.SubmitCommandBuffer(*commandBuffer, cycle, span<vk::Semaphore>{waitSemaphores.data(), extraWaitSemaphore ? 2U : 1U}, span<vk::Semaphore>{signalSemaphore});
+                return cycle;
+            } catch (...) {
+                cycle->Cancel();
+                std::rethrow_exception(std::current_exception());
+            }
+        }};
+
+        auto newCycle{[&] {
+            if (texture->cycle)
+                return texture->cycle->RecordSemaphoreWaitUsage(std::move(submitFunc));
+            else
+                return submitFunc({});
+        }()};
+        newCycle->AttachObjects(texture, destination);
+        destination->cycle = newCycle;
+    }
+
     void PresentationEngine::PresentationThread() {
         if (int result{pthread_setname_np(pthread_self(), "Sky-Present")})
             Logger::Warn("Failed to set the thread name: {}", strerror(result));
@@ -238,6 +456,17 @@ namespace skyline::gpu {
             presentQueue.Process([this](const PresentableFrame &frame) {
                 PresentFrame(frame);
                 frame.presentCallback(); // We're calling the callback here as it's outside of all the locks in PresentFrame
+
+                if (*state.settings->framePacing && frame.swapInterval && lastTargetTime) {
+                    // The guest is signalled such that its next frame is predicted to complete right before the next paced present, rather than immediately which would have it render far ahead of the display and add latency
+                    timespec time;
+                    clock_gettime(CLOCK_MONOTONIC, &time);
+                    i64 now{(time.tv_sec * constant::NsInSecond) + time.tv_nsec};
+                    i64 signalTime{lastTargetTime + (refreshCycleDuration * frame.swapInterval) - presentLatencyNs - guestFrameLatencyNs};
+                    if (signalTime > now)
+                        std::this_thread::sleep_for(std::chrono::nanoseconds{std::min(signalTime - now, refreshCycleDuration)});
+                }
+
                 skipSignal = true;
                 vsyncEvent->Signal();
             }, [] {});
@@ -279,7 +508,7 @@ namespace skyline::gpu {
         }
     }
 
-    void PresentationEngine::UpdateSwapchain(texture::Format format, texture::Dimensions extent) {
+    void PresentationEngine::UpdateSwapchain(texture::Format format, texture::Dimensions extent, bool sharpen) {
         auto minImageCount{std::max(vkSurfaceCapabilities.minImageCount, *state.settings->forceTripleBuffering ? 3U : 2U)};
         if (minImageCount > MaxSwapchainImageCount)
             throw exception("Requesting swapchain with higher image count ({}) than maximum slot count ({})", minImageCount, MaxSwapchainImageCount);
@@ -304,6 +533,15 @@ namespace skyline::gpu {
         if ((capabilities.supportedUsageFlags & presentUsage) != presentUsage)
             throw exception("Swapchain doesn't support image usage '{}': {}", vk::to_string(presentUsage), vk::to_string(capabilities.supportedUsageFlags));
 
+        // The sharpening shader writes R8G8B8A8 texels directly into the swapchain images, this can't be done for any other formats
+        vk::ImageUsageFlags usage{presentUsage};
+        bool storage{sharpen && underlyingFormat == format::R8G8B8A8Unorm && (capabilities.supportedUsageFlags & vk::ImageUsageFlagBits::eStorage) &&
+            (gpu.vkPhysicalDevice.getFormatProperties(*underlyingFormat).optimalTilingFeatures & vk::FormatFeatureFlagBits::eStorageImage)};
+        if (storage)
+            usage |= vk::ImageUsageFlagBits::eStorage;
+        else if (sharpen)
+            Logger::Info("Swapchain doesn't support storage usage with '{}', frames will be upscaled without sharpening", vk::to_string(*underlyingFormat));
+
         auto requestedMode{*state.settings->disableFrameThrottling ? vk::PresentModeKHR::eMailbox : vk::PresentModeKHR::eFifo};
         auto modes{gpu.vkPhysicalDevice.getSurfacePresentModesKHR(**vkSurface)};
         if (std::find(modes.begin(), modes.end(), requestedMode) == modes.end())
@@ -316,7 +554,7 @@ namespace skyline::gpu {
             .imageColorSpace = vk::ColorSpaceKHR::eSrgbNonlinear,
             .imageExtent = extent,
             .imageArrayLayers = 1,
-            .imageUsage = presentUsage,
+            .imageUsage = usage,
             .imageSharingMode = vk::SharingMode::eExclusive,
             .compositeAlpha = vk::CompositeAlphaFlagBitsKHR::eInherit,
             .presentMode = requestedMode,
@@ -329,7 +567,7 @@ namespace skyline::gpu {
 
         for (size_t index{}; index < vkImages.size(); index++) {
             auto &slot{images[index]};
-            slot = std::make_shared<Texture>(*state.gpu, vkImages[index], extent, underlyingFormat, vk::ImageLayout::eUndefined, vk::ImageTiling::eOptimal, vk::ImageCreateFlags{}, presentUsage);
+            slot = std::make_shared<Texture>(*state.gpu, vkImages[index], extent, underlyingFormat, vk::ImageLayout::eUndefined, vk::ImageTiling::eOptimal, vk::ImageCreateFlags{}, usage);
             slot->TransitionLayout(vk::ImageLayout::ePresentSrcKHR);
         }
         for (size_t index{vkImages.size()}; index < MaxSwapchainImageCount; index++)
@@ -338,6 +576,8 @@ namespace skyline::gpu {
 
         swapchainFormat = format;
         swapchainExtent = extent;
+        swapchainSharpening = sharpen;
+        swapchainStorage = storage;
         swapchainImageCount = vkImages.size();
     }
 
@@ -364,7 +604,7 @@ namespace skyline::gpu {
             vkSurfaceCapabilities = gpu.vkPhysicalDevice.getSurfaceCapabilitiesKHR(**vkSurface);
 
             if (swapchainExtent && swapchainFormat)
-                UpdateSwapchain(swapchainFormat, swapchainExtent);
+                UpdateSwapchain(swapchainFormat, swapchainExtent, swapchainSharpening);
 
             if (window->common.magic != AndroidNativeWindowMagic)
                 throw exception("ANativeWindow* has unexpected magic: {} instead of {}", span(&window->common.magic, 1).as_string(true), span<const u8>(reinterpret_cast<const u8 *>(&AndroidNativeWindowMagic), sizeof(u32)).as_string(true));
@@ -407,7 +647,8 @@ namespace skyline::gpu {
             nextFrameId,
             crop,
             scalingMode,
-            transform
+            transform,
+            util::GetTimeNs(),
         });
 
         return nextFrameId++;
@@ -14,6 +14,15 @@
 struct ANativeWindow;
 
 namespace skyline::gpu {
+    /**
+     * @brief The filtering used to upscale frames that were rendered below the guest resolution back to it during presentation
+     */
+    enum class UpscalingMode : u32 {
+        None, //!< Frames are presented at their host resolution and stretched by the compositor
+        Bilinear, //!< Frames are upscaled with a bilinear blit
+        Sharpened, //!< Frames are upscaled bilinearly with contrast adaptive sharpening, this falls back to bilinear upscaling if the swapchain doesn't support storage usage
+    };
+
     /**
      * @brief All host presentation is handled by this, it manages the host surface and swapchain alongside dynamically recreating it when required
      */
@@ -37,6 +46,9 @@ namespace skyline::gpu {
         std::optional<vk::raii::SwapchainKHR> vkSwapchain; //!< The Vulkan swapchain and the properties associated with it
         texture::Format swapchainFormat{}; //!< The image format of the textures in the current swapchain
         texture::Dimensions swapchainExtent{}; //!< The extent of images in the current swapchain
+        bool swapchainSharpening{}; //!< If the current swapchain was created for the sharpened upscaling mode
+        bool swapchainStorage{}; //!< If the images in the current swapchain support storage usage, this is only requested for the sharpened upscaling mode as it can disable framebuffer compression
+        static constexpr float UpscalingSharpness{0.87f}; //!< The sharpness of the sharpened upscaling mode, this is equivalent to the RCAS default of 0.2 stops
 
         static constexpr size_t MaxSwapchainImageCount{10}; //!< The maximum amount of swapchain textures, this affects the amount of images that can be in the swapchain
         std::array<std::shared_ptr<Texture>, MaxSwapchainImageCount> images; //!< All the swapchain textures in the same order as supplied by the host swapchain
@@ -51,6 +63,20 @@ namespace skyline::gpu {
         i64 averageFrametimeDeviationNs{}; //!< The average deviation of frametimes in nanoseconds
         perfetto::Track presentationTrack; //!< Perfetto track used for presentation events
 
+        /**
+         * @brief A frame that was presented while frame pacing was enabled and hasn't had its presentation timing read back yet
+         */
+        struct PacedFrame {
+            u64 frameId; //!< The ID of the frame in the window, this is unrelated to PresentableFrame::id
+            i64 requestedTime; //!< The CLOCK_MONOTONIC timestamp that the frame was requested to be displayed at
+        };
+        static constexpr size_t PacedFrameCount{8}; //!< The maximum amount of frames that can await timing feedback, any older frames are dropped
+        std::array<PacedFrame, PacedFrameCount> pacedFrames{};
+        size_t pacedFrameCount{};
+        i64 presentLatencyNs{}; //!< An average of the time from the compositor latching a frame to it being displayed, a frame must be queued at least this long before its target time
+        i64 guestFrameLatencyNs{}; //!< An average of the time from a frame being queued by the guest to its GPU work completing
+        i64 lastTargetTime{}; //!< The CLOCK_MONOTONIC timestamp that the last paced frame was scheduled to be displayed at
+
       public:
         std::atomic<bool> skipSignal; //!< If true, the next signal will be skipped by the choreographer thread
         std::shared_ptr<kernel::type::KEvent> vsyncEvent; //!< Signalled every time a frame is drawn
@@ -73,6 +99,7 @@ namespace skyline::gpu {
             service::hosbinder::AndroidRect crop{};
             service::hosbinder::NativeWindowScalingMode scalingMode{};
             service::hosbinder::NativeWindowTransform transform{};
+            i64 queueTime{}; //!< The time at which the frame was queued for presentation (relative to skyline::util::GetTimeNs)
         };
 
         std::thread presentationThread; //!< A thread for asynchronously presenting queued frames after their corresponded fences are signalled
@@ -90,20 +117,41 @@ namespace skyline::gpu {
          */
         void ChoreographerThread();
 
+        /**
+         * @brief Reads back the presentation timing of previously paced frames from the compositor and updates the latency estimates
+         * @note 'PresentationEngine::mutex' **must** be locked prior to calling this
+         */
+        void UpdatePacingFeedback();
+
+        /**
+         * @return The CLOCK_MONOTONIC timestamp that a frame should be displayed at to keep frame times even while being displayed as early as possible
+         * @param now The current CLOCK_MONOTONIC time
+         * @note 'PresentationEngine::mutex' **must** be locked prior to calling this
+         */
+        i64 GetPacedTimestamp(i64 now, i64 swapInterval);
+
         /**
          * @brief Submits a single frame to the host API for presentation with the appropriate waits and copies
          */
         void PresentFrame(const PresentableFrame& frame);
 
+        /**
+         * @brief Upscales the supplied frame into the entirety of the destination swapchain image, this is a replacement for Texture::CopyFrom when the dimensions differ
+         * @param sharpen If contrast adaptive sharpening should be applied, the destination must support storage usage and be R8G8B8A8 in this case
+         * @note The source texture **must** be locked prior to calling this
+         */
+        void UpscaleFrame(const std::shared_ptr<TextureView> &source, const std::shared_ptr<Texture> &destination, vk::Semaphore waitSemaphore, vk::Semaphore signalSemaphore, bool sharpen);
+
         /**
          * @brief The thread that handles presentation of frames submitted to it
          */
         void PresentationThread();
 
         /**
+         * @param sharpen If the swapchain images should support storage usage for the sharpened upscaling mode when possible
          * @note 'PresentationEngine::mutex' **must** be locked prior to calling this
          */
-        void UpdateSwapchain(texture::Format format, texture::Dimensions extent);
+        void UpdateSwapchain(texture::Format format, texture::Dimensions extent, bool sharpen);
 
       public:
         PresentationEngine(const DeviceState &state, GPU &gpu);
@@ -0,0 +1,90 @@
+// SPDX-License-Identifier: MPL-2.0
+// Copyright © 2023 Skyline Team and Contributors (https://github.com/skyline-emu/)
+
+#include <dlfcn.h>
+#include <common/settings.h>
+#include <common/trace.h>
+#include "resolution_controller.h"
+
+namespace skyline::gpu {
+    ResolutionController::ResolutionController(const DeviceState &state)
+        : enabled{*state.settings->dynamicResolution},
+          maxScale{static_cast<float>(std::clamp(*state.settings->resolutionScale, 50U, 200U)) / 100.0f},
+          scale{maxScale} {
+        if (!enabled)
+            return;
+
+        // The thermal API was introduced in API 30 so it's resolved at runtime as we support API 29
+        if (void *libandroid{dlopen("libandroid.so", RTLD_NOW)}) {
+            auto acquireManager{reinterpret_cast<AcquireManagerFunction>(dlsym(libandroid, "AThermal_acquireManager"))};
+            releaseManager = reinterpret_cast<ReleaseManagerFunction>(dlsym(libandroid, "AThermal_releaseManager"));
+            getThermalHeadroom = reinterpret_cast<GetThermalHeadroomFunction>(dlsym(libandroid, "AThermal_getThermalHeadroom"));
+            if (acquireManager && releaseManager && getThermalHeadroom)
+                thermalManager = acquireManager();
+        }
+
+        if (!thermalManager)
+            Logger::Info("Thermal headroom is unavailable, dynamic resolution will only consider GPU time");
+    }
+
+    ResolutionController::~ResolutionController() {
+        if (thermalManager)
+            releaseManager(thermalManager);
+    }
+
+    void ResolutionController::UpdateThermalHeadroom() {
+        if (!thermalManager)
+            return;
+
+        i64 now{util::GetTimeNs()};
+        if (now - lastThermalSampleTime < ThermalSamplePeriodNs)
+            return;
+        lastThermalSampleTime = now;
+
+        float headroom{getThermalHeadroom(thermalManager, ThermalForecastSeconds)};
+        if (!std::isnan(headroom))
+            thermalHeadroom = headroom;
+    }
+
+    void ResolutionController::Update(u64 gpuTimeNs, i64 frameIntervalNs) {
+        if (!enabled || frameIntervalNs <= 0)
+            return;
+
+        UpdateThermalHeadroom();
+
+        if (gpuTimeNs)
+            averageGpuTimeNs = averageGpuTimeNs ? ((averageGpuTimeNs * 7) + static_cast<i64>(gpuTimeNs)) / 8 : static_cast<i64>(gpuTimeNs);
+
+        float currentScale{scale.load(std::memory_order_relaxed)};
+        bool overBudget{thermalHeadroom >= ThermalThrottleHeadroom || (averageGpuTimeNs && static_cast<float>(averageGpuTimeNs) > static_cast<float>(frameIntervalNs) * ScaleDownThreshold)};
+
+        bool underBudget{};
+        if (!overBudget && averageGpuTimeNs && thermalHeadroom < ThermalWarmHeadroom && currentScale < maxScale) {
+            // GPU time is roughly proportional to the amount of pixels rendered, so it's predicted to grow with the square of the scale
+            float nextScale{std::min(currentScale + ScaleStep, maxScale)};
+            float growth{(nextScale * nextScale) / (currentScale * currentScale)};
+            underBudget = static_cast<float>(averageGpuTimeNs) * growth < static_cast<float>(frameIntervalNs) * ScaleUpThreshold;
+        }
+
+        if (overBudget)
+            pressure = std::max(pressure, 0) + 1;
+        else if (underBudget)
+            pressure = std::min(pressure, 0) - 1;
+        else
+            pressure = 0;
+
+        float newScale{currentScale};
+        if (pressure >= AdjustmentFrameCount)
+            newScale = std::max(currentScale - ScaleStep, MinScale);
+        else if (pressure <= -AdjustmentFrameCount)
+            newScale = std::min(currentScale + ScaleStep, maxScale);
+
+        if (newScale != currentScale) {
+            Logger::Debug("Dynamic resolution scale changed from {}% to {}% (GPU time: {}us, Frame interval: {}us, Thermal headroom: {:.2f})", std::lround(currentScale * 100), std::lround(newScale * 100), averageGpuTimeNs / 1000, frameIntervalNs / 1000, thermalHeadroom);
+            scale.store(newScale, std::memory_order_relaxed);
+            pressure = 0;
+        }
+
+        TRACE_COUNTER("gpu", perfetto::CounterTrack{"ResolutionScale"}, newScale);
+    }
+}
@@ -0,0 +1,68 @@
+// SPDX-License-Identifier: MPL-2.0
+// Copyright © 2023 Skyline Team and Contributors (https://github.com/skyline-emu/)
+
+#pragma once
+
+#include <common.h>
+
+struct AThermalManager;
+
+namespace skyline::gpu {
+    /**
+     * @brief Decides the render scale of newly created render targets, with dynamic resolution enabled the scale is adjusted every frame to keep the GPU time of a frame within the guest's frame interval and to back off before the device starts thermal throttling
+     * @note The scale only applies to render targets created after it changes, existing render targets keep the scale they were created with
+     */
+    class ResolutionController {
+      private:
+        static constexpr float MinScale{0.5f}; //!< The lowest scale that the controller will reduce the resolution to, this matches the minimum of the resolution scale setting
+        static constexpr float ScaleStep{0.25f}; //!< The granularity of scale changes, this is coarse to limit the amount of render passes which mix attachments of different scales
+        static constexpr float ScaleDownThreshold{0.9f}; //!< The fraction of the frame interval that the GPU time must exceed for a frame to count towards scaling down
+        static constexpr float ScaleUpThreshold{0.75f}; //!< The fraction of the frame interval that the predicted GPU time at the next higher scale must stay under for a frame to count towards scaling up
+        static constexpr i32 AdjustmentFrameCount{30}; //!< The amount of consecutive frames that must be over or under budget before the scale is changed
+        static constexpr float ThermalThrottleHeadroom{0.9f}; //!< The forecasted thermal headroom at which the device is considered to be about to throttle, frames count towards scaling down regardless of GPU time
+        static constexpr float ThermalWarmHeadroom{0.75f}; //!< The forecasted thermal headroom above which the scale isn't increased
+        static constexpr i64 ThermalSamplePeriodNs{constant::NsInSecond}; //!< The minimum period between thermal headroom samples, the platform returns NaN when it is polled more often than this
+        static constexpr int ThermalForecastSeconds{3}; //!< How far into the future the thermal headroom is forecasted, this gives the controller time to react before throttling begins
+
+        bool enabled; //!< If the scale is adjusted dynamically rather than being fixed to the resolution scale setting
+        float maxScale; //!< The scale from the resolution scale setting, the dynamic scale never exceeds this
+        std::atomic<float> scale; //!< The scale that new render targets are created with
+
+        i64 averageGpuTimeNs{}; //!< An exponential moving average of the GPU time of recent frames
+        i32 pressure{}; //!< The amount of consecutive frames that were over budget when positive or under budget when negative
+
+        using AcquireManagerFunction = AThermalManager *(*)();
+        using ReleaseManagerFunction = void (*)(AThermalManager *);
+        using GetThermalHeadroomFunction = float (*)(AThermalManager *, int);
+        ReleaseManagerFunction releaseManager{};
+        GetThermalHeadroomFunction getThermalHeadroom{};
+        AThermalManager *thermalManager{}; //!< The thermal manager used to query the thermal headroom, this is nullptr if the platform doesn't support it (API < 30)
+        i64 lastThermalSampleTime{};
+        float thermalHeadroom{}; //!< The most recently sampled thermal headroom, 0 if it's unavailable
+
+        /**
+         * @brief Samples the thermal headroom if the sample period has elapsed since the last sample
+         */
+        void UpdateThermalHeadroom();
+
+      public:
+        ResolutionController(const DeviceState &state);
+
+        ~ResolutionController();
+
+        /**
+         * @brief Updates the scale based on the GPU time of a presented frame
+         * @param gpuTimeNs The GPU time of all work submitted since the prior frame, this is 0 if GPU timestamps aren't supported
+         * @param frameIntervalNs The interval that the guest is targeting between frames
+         * @note This must only be called from a single thread
+         */
+        void Update(u64 gpuTimeNs, i64 frameIntervalNs);
+
+        /**
+         * @return The scale that a newly created render target should be created with
+         */
+        float GetScale() {
+            return scale.load(std::memory_order_relaxed);
+        }
+    };
+}
@@ -1,10 +1,12 @@
 // SPDX-License-Identifier: MPL-2.0
 // Copyright © 2021 Skyline Team and Contributors (https://github.com/skyline-emu/)
 
+#include <thread>
 #include <range/v3/algorithm.hpp>
 #include <boost/functional/hash.hpp>
 #include <gpu.h>
 #include <common/settings.h>
+#include <common/trace.h>
 #include <shader_compiler/common/settings.h>
 #include <shader_compiler/common/log.h>
 #include <shader_compiler/frontend/maxwell/translate_program.h>
@@ -29,6 +31,9 @@ namespace Shader::Log {
 }
 
 namespace skyline::gpu {
+    static constexpr u32 SpirvCacheMagic{0x56505348}; //!< "HSPV" in little-endian, identifies a SPIR-V cache entry
+    static constexpr u32 SpirvCacheVersion{2}; //!< The version of the SPIR-V cache, this must be incremented whenever changes to translation or emission would affect the output for the same inputs
+
     void ShaderManager::LoadShaderReplacements(std::string_view replacementDir) {
         std::filesystem::path replacementDirPath{replacementDir};
         if (std::filesystem::exists(replacementDirPath)) {
@@ -71,7 +76,86 @@ namespace skyline::gpu {
         return binary;
     }
 
-    ShaderManager::ShaderManager(const DeviceState &state, GPU &gpu, std::string_view replacementDir, std::string_view dumpDir) : gpu{gpu}, dumpPath{dumpDir} {
+    /**
+     * @brief The header of a SPIR-V cache entry, this is followed by the SPIR-V words
+     */
+    struct SpirvCacheEntryHeader {
+        u32 magic{SpirvCacheMagic};
+        u32 version{SpirvCacheVersion};
+        u64 key;
+        Shader::Backend::Bindings bindings; //!< The bindings after emission, these are restored on a hit as subsequent stages are emitted with them
+        u32 identifierSize; //!< The size of the identifier of the module created from the SPIR-V, this is 0 if the device doesn't support identifiers
+        std::array<u8, VK_MAX_SHADER_MODULE_IDENTIFIER_SIZE_EXT> identifier;
+    };
+    static_assert(std::is_trivially_copyable_v<SpirvCacheEntryHeader>);
+
+    std::vector<u32> ShaderManager::LoadCachedSpirv(u64 key, Shader::Backend::Bindings &bindings, ShaderModuleIdentifier *identifier) {
+        TRACE_EVENT("gpu", "ShaderManager::LoadCachedSpirv");
+
+        std::ifstream file{spirvCachePath / fmt::format("{:016X}.spv", key), std::ios::binary | std::ios::ate};
+        if (!file)
+            return {};
+
+        auto fileSize{static_cast<size_t>(file.tellg())};
+        if (fileSize <= sizeof(SpirvCacheEntryHeader) || (fileSize - sizeof(SpirvCacheEntryHeader)) % sizeof(u32))
+            return {};
+
+        SpirvCacheEntryHeader header{};
+        file.seekg(0, std::ios::beg);
+        file.read(reinterpret_cast<char *>(&header), sizeof(SpirvCacheEntryHeader));
+        if (!file || header.magic != SpirvCacheMagic || header.version != SpirvCacheVersion || header.key != key || header.identifierSize > header.identifier.size())
+            return {};
+
+        // The driver should still have a binary for the module cached, so the SPIR-V is only read if a pipeline can't be created from the identifier
+        if (identifier && header.identifierSize) {
+            bindings = header.bindings;
+            *identifier = ShaderModuleIdentifier{
+                .size = header.identifierSize,
+                .data = header.identifier,
+                .cacheKey = key,
+            };
+            return {};
+        }
+
+        std::vector<u32> spirv((fileSize - sizeof(SpirvCacheEntryHeader)) / sizeof(u32));
+        file.read(reinterpret_cast<char *>(spirv.data()), static_cast<std::streamsize>(span<u32>{spirv}.size_bytes()));
+        if (!file)
+            return {};
+
+        bindings = header.bindings;
+        return spirv;
+    }
+
+    void ShaderManager::StoreCachedSpirv(u64 key, span<u32> spirv, const Shader::Backend::Bindings &bindings, vk::ShaderModule module) {
+        TRACE_EVENT("gpu", "ShaderManager::StoreCachedSpirv");
+
+        SpirvCacheEntryHeader header{.key = key, .bindings = bindings};
+        if (module && gpu.traits.supportsShaderModuleIdentifier) {
+            auto moduleIdentifier{(*gpu.vkDevice).getShaderModuleIdentifierEXT(module, *gpu.vkDevice.getDispatcher())};
+            header.identifierSize = std::min(moduleIdentifier.identifierSize, static_cast<u32>(header.identifier.size()));
+            std::copy_n(moduleIdentifier.identifier.begin(), header.identifierSize, header.identifier.begin());
+        }
+
+        // Entries are written to a temporary file and renamed into place so that a concurrent or interrupted write can never be observed as a valid entry
+        auto entryPath{spirvCachePath / fmt::format("{:016X}.spv", key)};
+        auto tempPath{spirvCachePath / fmt::format("{:016X}.{:X}.tmp", key, std::hash<std::thread::id>{}(std::this_thread::get_id()))};
+        {
+            std::ofstream file{tempPath, std::ios::binary | std::ios::trunc};
+            file.write(reinterpret_cast<const char *>(&header), sizeof(SpirvCacheEntryHeader));
+            file.write(reinterpret_cast<const char *>(spirv.data()), static_cast<std::streamsize>(spirv.size_bytes()));
+            if (!file) {
+                Logger::Warn("Failed to write SPIR-V cache entry: 0x{:016X}", key);
+                return;
+            }
+        }
+
+        std::error_code error;
+        std::filesystem::rename(tempPath, entryPath, error);
+        if (error)
+            std::filesystem::remove(tempPath, error);
+    }
+
+    ShaderManager::ShaderManager(const DeviceState &state, GPU &gpu, std::string_view replacementDir, std::string_view dumpDir, std::string_view spirvCacheDir) : gpu{gpu}, dumpPath{dumpDir} {
         LoadShaderReplacements(replacementDir);
 
         if constexpr (DumpShaders) {
@@ -142,6 +226,25 @@ namespace skyline::gpu {
                 .active = false,
             },
         };
+
+        if (!spirvCacheDir.empty()) {
+            // The emitted SPIR-V depends on the profile which is derived from the host device, driver and settings, so entries are segregated by them
+            size_t deviceHash{};
+            boost::hash_combine(deviceHash, SpirvCacheVersion);
+            boost::hash_combine(deviceHash, traits.vendorId);
+            boost::hash_combine(deviceHash, traits.deviceId);
+            boost::hash_combine(deviceHash, traits.driverVersion);
+            boost::hash_combine(deviceHash, XXH64(traits.shaderModuleIdentifierAlgorithmUuid.data(), traits.shaderModuleIdentifierAlgorithmUuid.size(), 0));
+            boost::hash_combine(deviceHash, *state.settings->disableSubgroupShuffle);
+
+            spirvCachePath = std::filesystem::path{spirvCacheDir} / fmt::format("{:016X}", deviceHash);
+            std::error_code error;
+            std::filesystem::create_directories(spirvCachePath, error);
+            if (error) {
+                Logger::Warn("Failed to create SPIR-V cache directory: {}", error.message());
+                spirvCachePath.clear();
+            }
+        }
     }
 
     /**
@@ -157,6 +260,8 @@ namespace skyline::gpu {
         ShaderManager::GetTextureType getTextureType;
 
       public:
+        size_t stateHash{}; //!< A hash of all guest state that was read during translation
+
         GraphicsEnvironment(const std::array<u32, 8> &postVtgShaderAttributeSkipMask,
                             Shader::Stage pStage,
                             span<u8> pBinary, u32 baseOffset,
@@ -182,7 +287,11 @@ namespace skyline::gpu {
         }
 
         [[nodiscard]] u32 ReadCbufValue(u32 index, u32 offset) final {
-            return constantBufferRead(index, offset);
+            u32 value{constantBufferRead(index, offset)};
+            boost::hash_combine(stateHash, index);
+            boost::hash_combine(stateHash, offset);
+            boost::hash_combine(stateHash, value);
+            return value;
         }
 
         [[nodiscard]] Shader::TexturePixelFormat ReadTexturePixelFormat(u32 handle) final {
@@ -190,7 +299,10 @@ namespace skyline::gpu {
         }
 
         [[nodiscard]] Shader::TextureType ReadTextureType(u32 handle) final {
-            return getTextureType(handle);
+            auto type{getTextureType(handle)};
+            boost::hash_combine(stateHash, handle);
+            boost::hash_combine(stateHash, static_cast<u32>(type));
+            return type;
         }
 
         [[nodiscard]] u32 ReadViewportTransformState() final {
@@ -252,6 +364,8 @@ namespace skyline::gpu {
         ShaderManager::GetTextureType getTextureType;
 
       public:
+        size_t stateHash{}; //!< A hash of all guest state that was read during translation
+
         ComputeEnvironment(span<u8> pBinary,
                            u32 baseOffset,
                            u32 textureBufferIndex,
@@ -279,7 +393,11 @@ namespace skyline::gpu {
         }
 
         [[nodiscard]] u32 ReadCbufValue(u32 index, u32 offset) final {
-            return constantBufferRead(index, offset);
+            u32 value{constantBufferRead(index, offset)};
+            boost::hash_combine(stateHash, index);
+            boost::hash_combine(stateHash, offset);
+            boost::hash_combine(stateHash, value);
+            return value;
         }
 
         [[nodiscard]] Shader::TexturePixelFormat ReadTexturePixelFormat(u32 handle) final {
@@ -287,7 +405,10 @@ namespace skyline::gpu {
         }
 
         [[nodiscard]] Shader::TextureType ReadTextureType(u32 handle) final {
-            return getTextureType(handle);
+            auto type{getTextureType(handle)};
+            boost::hash_combine(stateHash, handle);
+            boost::hash_combine(stateHash, static_cast<u32>(type));
+            return type;
         }
 
         [[nodiscard]] u32 ReadViewportTransformState() final {
@@ -379,70 +500,196 @@ namespace skyline::gpu {
         void Dump(u64 hash) final {}
     };
 
+    /**
+     * @brief The object pools backing all shader IR, these are thread-local so that shaders can be translated on several threads concurrently without any synchronization
+     */
+    struct ShaderObjectPools {
+        Shader::ObjectPool<Shader::Maxwell::Flow::Block> flowBlockPool;
+        Shader::ObjectPool<Shader::IR::Inst> instructionPool;
+        Shader::ObjectPool<Shader::IR::Block> blockPool;
+    };
+
+    static thread_local ShaderObjectPools pools;
+
     Shader::IR::Program ShaderManager::ParseGraphicsShader(const std::array<u32, 8> &postVtgShaderAttributeSkipMask,
                                                            Shader::Stage stage,
                                                            u64 hash, span<u8> binary, u32 baseOffset,
                                                            u32 textureConstantBufferIndex,
                                                            bool viewportTransformEnabled,
-                                                           const ConstantBufferRead &constantBufferRead, const GetTextureType &getTextureType) {
+                                                           const ConstantBufferRead &constantBufferRead, const GetTextureType &getTextureType,
+                                                           PipelineCompileTimings *timings, u64 *programHash) {
+        TRACE_EVENT("gpu", "ShaderManager::ParseGraphicsShader", "hash", hash);
+        auto startNs{util::GetTimeNs()};
+        auto guestBinary{binary};
         binary = ProcessShaderBinary(false, hash, binary);
 
-        std::scoped_lock lock{poolMutex};
-
         GraphicsEnvironment environment{postVtgShaderAttributeSkipMask, stage, binary, baseOffset, textureConstantBufferIndex, viewportTransformEnabled, constantBufferRead, getTextureType};
-        Shader::Maxwell::Flow::CFG cfg{environment, flowBlockPool, Shader::Maxwell::Location{static_cast<u32>(baseOffset + sizeof(Shader::ProgramHeader))}};
-        return  Shader::Maxwell::TranslateProgram(instructionPool, blockPool, environment, cfg, hostTranslateInfo);
+        Shader::Maxwell::Flow::CFG cfg{environment, pools.flowBlockPool, Shader::Maxwell::Location{static_cast<u32>(baseOffset + sizeof(Shader::ProgramHeader))}};
+        auto program{Shader::Maxwell::TranslateProgram(pools.instructionPool, pools.blockPool, environment, cfg, hostTranslateInfo)};
+
+        if (programHash) {
+            // Replaced shaders are specific to a title so they are never cached
+            if (binary.data() == guestBinary.data()) {
+                size_t combinedHash{hash};
+                boost::hash_combine(combinedHash, static_cast<u32>(stage));
+                boost::hash_combine(combinedHash, baseOffset);
+                boost::hash_combine(combinedHash, textureConstantBufferIndex);
+                boost::hash_combine(combinedHash, viewportTransformEnabled);
+                boost::hash_range(combinedHash, postVtgShaderAttributeSkipMask.begin(), postVtgShaderAttributeSkipMask.end());
+                boost::hash_combine(combinedHash, environment.stateHash);
+                *programHash = combinedHash;
+            } else {
+                *programHash = 0;
+            }
+        }
+
+        if (timings)
+            timings->AddTranslation(hash, util::GetTimeNs() - startNs);
+        return program;
     }
 
     Shader::IR::Program ShaderManager::CombineVertexShaders(Shader::IR::Program &vertexA, Shader::IR::Program &vertexB, span<u8> vertexBBinary) {
-        std::scoped_lock lock{poolMutex};
-
         VertexBEnvironment env{vertexBBinary};
         return Shader::Maxwell::MergeDualVertexPrograms(vertexA, vertexB, env);
     }
 
     Shader::IR::Program ShaderManager::GenerateGeometryPassthroughShader(Shader::IR::Program &layerSource, Shader::OutputTopology topology) {
-        std::scoped_lock lock{poolMutex};
-
-        return Shader::Maxwell::GenerateGeometryPassthrough(instructionPool, blockPool, hostTranslateInfo, layerSource, topology);
+        return Shader::Maxwell::GenerateGeometryPassthrough(pools.instructionPool, pools.blockPool, hostTranslateInfo, layerSource, topology);
     }
 
     Shader::IR::Program ShaderManager::ParseComputeShader(u64 hash, span<u8> binary, u32 baseOffset,
                                                           u32 textureConstantBufferIndex,
                                                           u32 localMemorySize, u32 sharedMemorySize,
                                                           std::array<u32, 3> workgroupDimensions,
-                                                          const ConstantBufferRead &constantBufferRead, const GetTextureType &getTextureType) {
+                                                          const ConstantBufferRead &constantBufferRead, const GetTextureType &getTextureType,
+                                                          PipelineCompileTimings *timings, u64 *programHash) {
+        TRACE_EVENT("gpu", "ShaderManager::ParseComputeShader", "hash", hash);
+        auto startNs{util::GetTimeNs()};
+        auto guestBinary{binary};
         binary = ProcessShaderBinary(false, hash, binary);
 
-        std::scoped_lock lock{poolMutex};
-
         ComputeEnvironment environment{binary, baseOffset, textureConstantBufferIndex, localMemorySize, sharedMemorySize, workgroupDimensions, constantBufferRead, getTextureType};
-        Shader::Maxwell::Flow::CFG cfg{environment, flowBlockPool, Shader::Maxwell::Location{static_cast<u32>(baseOffset)}};
-        return Shader::Maxwell::TranslateProgram(instructionPool, blockPool, environment, cfg, hostTranslateInfo);
+        Shader::Maxwell::Flow::CFG cfg{environment, pools.flowBlockPool, Shader::Maxwell::Location{static_cast<u32>(baseOffset)}};
+        auto program{Shader::Maxwell::TranslateProgram(pools.instructionPool, pools.blockPool, environment, cfg, hostTranslateInfo)};
+
+        if (programHash) {
+            if (binary.data() == guestBinary.data()) {
+                size_t combinedHash{hash};
+                boost::hash_combine(combinedHash, baseOffset);
+                boost::hash_combine(combinedHash, textureConstantBufferIndex);
+                boost::hash_combine(combinedHash, localMemorySize);
+                boost::hash_combine(combinedHash, sharedMemorySize);
+                boost::hash_range(combinedHash, workgroupDimensions.begin(), workgroupDimensions.end());
+                boost::hash_combine(combinedHash, environment.stateHash);
+                *programHash = combinedHash;
+            } else {
+                *programHash = 0;
+            }
+        }
+
+        if (timings)
+            timings->AddTranslation(hash, util::GetTimeNs() - startNs);
+        return program;
+    }
+
+    /**
+     * @return A hash of all runtime info state that is populated by the pipeline managers
+     */
+    static size_t HashRuntimeInfo(const Shader::RuntimeInfo &info) {
+        size_t hash{};
+        const auto &storesMask{info.previous_stage_stores.mask};
+        for (size_t i{}; i < storesMask.size(); i++)
+            if (storesMask.test(i))
+                boost::hash_combine(hash, i);
+
+        for (auto type : info.generic_input_types)
+            boost::hash_combine(hash, static_cast<u32>(type));
+
+        boost::hash_combine(hash, info.convert_depth_mode);
+        boost::hash_combine(hash, info.force_early_z);
+        boost::hash_combine(hash, static_cast<u32>(info.tess_primitive));
+        boost::hash_combine(hash, static_cast<u32>(info.tess_spacing));
+        boost::hash_combine(hash, info.tess_clockwise);
+        boost::hash_combine(hash, static_cast<u32>(info.input_topology));
+        boost::hash_combine(hash, info.fixed_state_point_size.value_or(0.0f));
+        boost::hash_combine(hash, info.fixed_state_point_size.has_value());
+        boost::hash_combine(hash, info.alpha_test_func ? static_cast<u32>(*info.alpha_test_func) + 1 : 0);
+        boost::hash_combine(hash, info.alpha_test_reference);
+        boost::hash_combine(hash, info.y_negate);
+        boost::hash_combine(hash, XXH64(info.xfb_varyings.data(), info.xfb_varyings.size() * sizeof(decltype(info.xfb_varyings)::value_type), 0));
+        return hash;
     }
 
-    vk::ShaderModule ShaderManager::CompileShader(const Shader::RuntimeInfo &runtimeInfo, Shader::IR::Program &program, Shader::Backend::Bindings &bindings, u64 hash) {
-        std::scoped_lock lock{poolMutex};
+    vk::ShaderModule ShaderManager::CompileShader(const Shader::RuntimeInfo &runtimeInfo, Shader::IR::Program &program, Shader::Backend::Bindings &bindings, u64 hash, u64 *spirvHash, PipelineCompileTimings *timings, u64 programHash, ShaderModuleIdentifier *identifier) {
+        TRACE_EVENT("gpu", "ShaderManager::CompileShader", "hash", hash);
+        auto startNs{util::GetTimeNs()};
 
+        // This must occur regardless of if the SPIR-V is cached as it modifies the program info that subsequent stages derive their runtime info from
         if (program.info.loads.Legacy() || program.info.stores.Legacy())
             Shader::Maxwell::ConvertLegacyToGeneric(program, runtimeInfo);
 
-        auto spirvEmitted{Shader::Backend::SPIRV::EmitSPIRV(profile, runtimeInfo, program, bindings)};
+        u64 cacheKey{};
+        std::vector<u32> spirvEmitted;
+        if (programHash && !spirvCachePath.empty()) {
+            static_assert(std::is_trivially_copyable_v<Shader::Backend::Bindings>);
+            size_t key{programHash};
+            boost::hash_combine(key, HashRuntimeInfo(runtimeInfo));
+            boost::hash_combine(key, XXH64(&bindings, sizeof(Shader::Backend::Bindings), 0));
+            cacheKey = key;
+
+            // Identifiers can't be used for replaced shaders as the identifier in the cache entry is for the module created from the emitted SPIR-V
+            bool useIdentifier{identifier && gpu.traits.supportsShaderModuleIdentifier && !hostShaderReplacements.contains(hash)};
+            spirvEmitted = LoadCachedSpirv(cacheKey, bindings, useIdentifier ? identifier : nullptr);
+            if (useIdentifier && *identifier) {
+                if (spirvHash)
+                    *spirvHash = 0;
+
+                if (timings)
+                    timings->AddSpirv(hash, util::GetTimeNs() - startNs);
+                return {};
+            }
+        }
+
+        bool cacheMiss{spirvEmitted.empty()};
+        if (cacheMiss)
+            spirvEmitted = Shader::Backend::SPIRV::EmitSPIRV(profile, runtimeInfo, program, bindings);
         auto spirv{ProcessShaderBinary(true, hash, span<u32>{spirvEmitted}.cast<u8>()).cast<u32>()};
+        if (spirvHash)
+            *spirvHash = XXH64(spirv.data(), spirv.size_bytes(), 0);
 
         vk::ShaderModuleCreateInfo createInfo{
             .pCode = spirv.data(),
             .codeSize = spirv.size_bytes(),
         };
 
-        return (*gpu.vkDevice).createShaderModule(createInfo, nullptr, *gpu.vkDevice.getDispatcher());
+        auto shaderModule{(*gpu.vkDevice).createShaderModule(createInfo, nullptr, *gpu.vkDevice.getDispatcher())};
+
+        // The entry is written after the module is created so its identifier can be stored alongside the SPIR-V, the module of replaced SPIR-V doesn't correspond to the entry so no identifier is stored for it
+        if (cacheKey && cacheMiss)
+            StoreCachedSpirv(cacheKey, spirvEmitted, bindings, spirv.data() == spirvEmitted.data() ? shaderModule : vk::ShaderModule{});
+
+        if (timings)
+            timings->AddSpirv(hash, util::GetTimeNs() - startNs);
+        return shaderModule;
     }
 
-    void ShaderManager::ResetPools() {
-        std::scoped_lock lock{poolMutex};
+    vk::ShaderModule ShaderManager::CreateShaderModule(const ShaderModuleIdentifier &identifier) {
+        TRACE_EVENT("gpu", "ShaderManager::CreateShaderModule", "key", identifier.cacheKey);
 
-        instructionPool.ReleaseContents();
-        blockPool.ReleaseContents();
-        flowBlockPool.ReleaseContents();
+        Shader::Backend::Bindings bindings{};
+        auto spirv{LoadCachedSpirv(identifier.cacheKey, bindings)};
+        if (spirv.empty())
+            throw exception("SPIR-V cache entry for shader module identifier is no longer valid: 0x{:016X}", identifier.cacheKey);
+
+        return (*gpu.vkDevice).createShaderModule(vk::ShaderModuleCreateInfo{
+            .pCode = spirv.data(),
+            .codeSize = span<u32>{spirv}.size_bytes(),
+        }, nullptr, *gpu.vkDevice.getDispatcher());
+    }
+
+    void ShaderManager::ResetPools() {
+        pools.instructionPool.ReleaseContents();
+        pools.blockPool.ReleaseContents();
+        pools.flowBlockPool.ReleaseContents();
     }
 }
@@ -15,8 +15,22 @@
 #include <shader_compiler/runtime_info.h>
 #include <shader_compiler/backend/bindings.h>
 #include <common.h>
+#include "shader_telemetry.h"
 
 namespace skyline::gpu {
+    /**
+     * @brief The identifier of a shader module that the driver created previously, a pipeline can be created with this in place of the module if the driver has a cached binary for it
+     */
+    struct ShaderModuleIdentifier {
+        u32 size{}; //!< The size of the identifier in bytes, this is 0 if there's no identifier
+        std::array<u8, VK_MAX_SHADER_MODULE_IDENTIFIER_SIZE_EXT> data{};
+        u64 cacheKey{}; //!< The key of the SPIR-V cache entry the identifier was loaded from, a module is created from it if the pipeline can't be created with the identifier
+
+        explicit operator bool() const {
+            return size != 0;
+        }
+    };
+
     /**
      * @brief The Shader Manager is responsible for caching and looking up shaders alongside handling compilation of shaders when not found in any cache
      */
@@ -25,16 +39,14 @@ namespace skyline::gpu {
         GPU &gpu;
         Shader::HostTranslateInfo hostTranslateInfo;
         Shader::Profile profile;
-        Shader::ObjectPool<Shader::Maxwell::Flow::Block> flowBlockPool;
-        Shader::ObjectPool<Shader::IR::Inst> instructionPool;
-        Shader::ObjectPool<Shader::IR::Block> blockPool;
         std::unordered_map<u64, std::vector<u8>> guestShaderReplacements; //!< Map of guest shader hash -> replacement guest shader binary, populated at init time and must not be modified after
         std::unordered_map<u64, std::vector<u8>> hostShaderReplacements; //!< ^^ same as above but for host
 
-        std::mutex poolMutex;
         std::filesystem::path dumpPath;
         std::mutex dumpMutex;
 
+        std::filesystem::path spirvCachePath; //!< The directory of the SPIR-V cache for the current device, this is shared between all titles and is empty if caching is disabled
+
         /**
          * @brief Called at init time to populate the shader replacements map from the input directory
          */
@@ -46,16 +58,35 @@ namespace skyline::gpu {
          */
         span<u8> ProcessShaderBinary(bool spv, u64 hash, span<u8> binary);
 
+        /**
+         * @brief Looks up the SPIR-V for the supplied key in the on-disk cache
+         * @param bindings The bindings after emission of the cached SPIR-V are written into this on a hit
+         * @param identifier If non-null and the entry has a shader module identifier, this is set to it and the SPIR-V isn't read
+         * @return The cached SPIR-V or an empty vector if there was no valid entry or the identifier was read instead
+         */
+        std::vector<u32> LoadCachedSpirv(u64 key, Shader::Backend::Bindings &bindings, ShaderModuleIdentifier *identifier = nullptr);
+
+        /**
+         * @brief Writes the SPIR-V for the supplied key to the on-disk cache alongside the resulting bindings
+         * @param module The module created from the SPIR-V, its identifier is stored alongside it if this isn't null and the device supports identifiers
+         */
+        void StoreCachedSpirv(u64 key, span<u32> spirv, const Shader::Backend::Bindings &bindings, vk::ShaderModule module);
+
       public:
         using ConstantBufferRead = std::function<u32(u32 index, u32 offset)>; //!< A function which reads a constant buffer at the specified offset and returns the value
         using GetTextureType = std::function<Shader::TextureType(u32 handle)>; //!< A function which determines the type of a texture from its handle by checking the corresponding TIC
 
-        ShaderManager(const DeviceState &state, GPU &gpu, std::string_view replacementDir, std::string_view dumpDir);
+        /**
+         * @param spirvCacheDir The root directory of the SPIR-V cache shared between titles, caching is disabled if this is empty
+         */
+        ShaderManager(const DeviceState &state, GPU &gpu, std::string_view replacementDir, std::string_view dumpDir, std::string_view spirvCacheDir);
 
         /**
+         * @param timings If non-null, the time spent translating the shader is added to this
+         * @param programHash If non-null, this is set to a hash of the guest code and all state that was read during translation, this is 0 if the program can't be cached
          * @return A shader program that corresponds to all the supplied state including the current state of the constant buffers
          */
-        Shader::IR::Program ParseGraphicsShader(const std::array<u32, 8> &postVtgShaderAttributeSkipMask, Shader::Stage stage, u64 hash, span<u8> binary, u32 baseOffset, u32 textureConstantBufferIndex, bool viewportTransformEnabled, const ConstantBufferRead &constantBufferRead, const GetTextureType &getTextureType);
+        Shader::IR::Program ParseGraphicsShader(const std::array<u32, 8> &postVtgShaderAttributeSkipMask, Shader::Stage stage, u64 hash, span<u8> binary, u32 baseOffset, u32 textureConstantBufferIndex, bool viewportTransformEnabled, const ConstantBufferRead &constantBufferRead, const GetTextureType &getTextureType, PipelineCompileTimings *timings = nullptr, u64 *programHash = nullptr);
 
         /**
          * @brief Combines the VertexA and VertexB shader programs into a single program
@@ -68,10 +99,30 @@ namespace skyline::gpu {
          */
         Shader::IR::Program GenerateGeometryPassthroughShader(Shader::IR::Program &layerSource, Shader::OutputTopology topology);
 
-        Shader::IR::Program ParseComputeShader(u64 hash, span<u8> binary, u32 baseOffset, u32 textureConstantBufferIndex, u32 localMemorySize, u32 sharedMemorySize, std::array<u32, 3> workgroupDimensions, const ConstantBufferRead &constantBufferRead, const GetTextureType &getTextureType);
+        /**
+         * @param timings If non-null, the time spent translating the shader is added to this
+         * @param programHash If non-null, this is set to a hash of the guest code and all state that was read during translation, this is 0 if the program can't be cached
+         */
+        Shader::IR::Program ParseComputeShader(u64 hash, span<u8> binary, u32 baseOffset, u32 textureConstantBufferIndex, u32 localMemorySize, u32 sharedMemorySize, std::array<u32, 3> workgroupDimensions, const ConstantBufferRead &constantBufferRead, const GetTextureType &getTextureType, PipelineCompileTimings *timings = nullptr, u64 *programHash = nullptr);
 
-        vk::ShaderModule CompileShader(const Shader::RuntimeInfo &runtimeInfo, Shader::IR::Program &program, Shader::Backend::Bindings &bindings, u64 hash = 0);
+        /**
+         * @param spirvHash If non-null, this is set to a hash of the SPIR-V that the module was created from
+         * @param timings If non-null, the time spent emitting SPIR-V and creating the shader module is added to this
+         * @param programHash The hash of the program from parsing it, if this is non-zero the SPIR-V is looked up in and written to the on-disk cache
+         * @param identifier If non-null and the cache entry has a shader module identifier, this is set to it and a null module is returned without reading the SPIR-V, `spirvHash` is set to 0 in that case
+         */
+        vk::ShaderModule CompileShader(const Shader::RuntimeInfo &runtimeInfo, Shader::IR::Program &program, Shader::Backend::Bindings &bindings, u64 hash = 0, u64 *spirvHash = nullptr, PipelineCompileTimings *timings = nullptr, u64 programHash = 0, ShaderModuleIdentifier *identifier = nullptr);
 
+        /**
+         * @brief Creates a shader module from the SPIR-V cache entry that an identifier was loaded from, this is used when a pipeline couldn't be created with the identifier
+         * @note An exception is thrown if the entry is no longer valid
+         */
+        vk::ShaderModule CreateShaderModule(const ShaderModuleIdentifier &identifier);
+
+        /**
+         * @brief Releases the contents of the calling thread's shader IR object pools, this invalidates any programs previously generated on the calling thread
+         * @note The object pools are thread-local so shaders may be translated on several threads concurrently
+         */
         void ResetPools();
     };
 }
@@ -0,0 +1,108 @@
+// SPDX-License-Identifier: MPL-2.0
+// Copyright © 2023 Skyline Team and Contributors (https://github.com/skyline-emu/)
+
+#include "shader_telemetry.h"
+
+namespace skyline::gpu {
+    ShaderTelemetry ShaderStats;
+
+    PipelineCompileTimings::ShaderTiming *PipelineCompileTimings::GetShader(u64 hash) {
+        auto it{std::find_if(shaders.begin(), shaders.end(), [hash](const ShaderTiming &shader) { return shader.hash == hash; })};
+        if (it != shaders.end())
+            return &*it;
+
+        if (shaders.size() == shaders.capacity())
+            return nullptr;
+
+        return &shaders.emplace_back(ShaderTiming{hash, 0, 0});
+    }
+
+    void PipelineCompileTimings::AddTranslation(u64 hash, i64 durationNs) {
+        if (auto shader{GetShader(hash)})
+            shader->translationNs += durationNs;
+    }
+
+    void PipelineCompileTimings::AddSpirv(u64 hash, i64 durationNs) {
+        if (auto shader{GetShader(hash)})
+            shader->spirvNs += durationNs;
+    }
+
+    i64 PipelineCompileTimings::TranslationNs() const {
+        i64 total{};
+        for (const auto &shader : shaders)
+            total += shader.translationNs;
+        return total;
+    }
+
+    i64 PipelineCompileTimings::SpirvNs() const {
+        i64 total{};
+        for (const auto &shader : shaders)
+            total += shader.spirvNs;
+        return total;
+    }
+
+    i64 PipelineCompileTimings::TotalNs() const {
+        return TranslationNs() + SpirvNs() + pipelineNs;
+    }
+
+    const PipelineCompileTimings::ShaderTiming *PipelineCompileTimings::WorstShader() const {
+        auto it{std::max_element(shaders.begin(), shaders.end(), [](const ShaderTiming &a, const ShaderTiming &b) { return a.TotalNs() < b.TotalNs(); })};
+        return it != shaders.end() ? &*it : nullptr;
+    }
+
+    static constexpr std::array<const char *, 2> PipelineTypeNames{
+        "Graphics",
+        "Compute",
+    };
+
+    void ShaderTelemetry::Record(PipelineType type, const PipelineCompileTimings &timings) {
+        i64 compileNs{timings.TotalNs()};
+        if (compileNs > SlowCompileThresholdNs) {
+            auto worstShader{timings.WorstShader()};
+            Logger::Debug("Slow {} pipeline compilation: {:.2f}ms (Translation: {:.2f}ms, SPIR-V: {:.2f}ms, Pipeline: {:.2f}ms), worst shader: 0x{:016X}",
+                          PipelineTypeNames[static_cast<size_t>(type)], static_cast<double>(compileNs) / constant::NsInMillisecond,
+                          static_cast<double>(timings.TranslationNs()) / constant::NsInMillisecond, static_cast<double>(timings.SpirvNs()) / constant::NsInMillisecond,
+                          static_cast<double>(timings.pipelineNs) / constant::NsInMillisecond, worstShader ? worstShader->hash : 0);
+        }
+
+        std::scoped_lock lock{mutex};
+        pipelineCount++;
+        totalNs += compileNs;
+
+        if (worstOffenders.size() == WorstOffenderCount && worstOffenders.back().timings.TotalNs() >= compileNs)
+            return;
+
+        auto it{std::upper_bound(worstOffenders.begin(), worstOffenders.end(), compileNs, [](i64 durationNs, const Offender &record) { return durationNs > record.timings.TotalNs(); })};
+        worstOffenders.insert(it, Offender{type, timings});
+        if (worstOffenders.size() > WorstOffenderCount)
+            worstOffenders.pop_back();
+    }
+
+    std::string ShaderTelemetry::GetWorstOffenders() {
+        std::scoped_lock lock{mutex};
+        auto toMs{[](i64 ns) { return static_cast<double>(ns) / constant::NsInMillisecond; }};
+
+        std::string table{"Type,Worst Shader,Shaders,Translation (ms),SPIR-V (ms),Pipeline (ms),Total (ms)\n"};
+        for (const auto &record : worstOffenders) {
+            const auto &timings{record.timings};
+            auto worstShader{timings.WorstShader()};
+
+            std::string shaders;
+            for (const auto &shader : timings.shaders)
+                shaders += fmt::format("{}{:016X}", shaders.empty() ? "" : " ", shader.hash);
+
+            table += fmt::format("{},{:016X},{},{:.2f},{:.2f},{:.2f},{:.2f}\n", PipelineTypeNames[static_cast<size_t>(record.type)], worstShader ? worstShader->hash : 0, shaders,
+                                 toMs(timings.TranslationNs()), toMs(timings.SpirvNs()), toMs(timings.pipelineNs), toMs(timings.TotalNs()));
+        }
+        table += fmt::format("Total ({} pipelines),,,,,,{:.2f}", pipelineCount, toMs(totalNs));
+
+        return table;
+    }
+
+    void ShaderTelemetry::Reset() {
+        std::scoped_lock lock{mutex};
+        worstOffenders.clear();
+        pipelineCount = 0;
+        totalNs = 0;
+    }
+}
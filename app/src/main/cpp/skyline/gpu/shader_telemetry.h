@@ -0,0 +1,90 @@
+// SPDX-License-Identifier: MPL-2.0
+// Copyright © 2023 Skyline Team and Contributors (https://github.com/skyline-emu/)
+
+#pragma once
+
+#include <boost/container/static_vector.hpp>
+#include <common.h>
+
+namespace skyline::gpu {
+    /**
+     * @brief The time spent in each stage of compiling a single pipeline, this is used to attribute compilation stutters to a specific guest shader and stage
+     */
+    struct PipelineCompileTimings {
+        static constexpr size_t MaxShaderCount{6}; //!< The maximum amount of guest shaders in a pipeline, one for each Maxwell pipeline stage
+
+        struct ShaderTiming {
+            u64 hash; //!< The hash of the guest shader binary, this is 0 for host-generated shaders
+            i64 translationNs; //!< The time spent translating the guest shader into IR
+            i64 spirvNs; //!< The time spent emitting and optimising SPIR-V for the shader and creating its module
+
+            i64 TotalNs() const {
+                return translationNs + spirvNs;
+            }
+        };
+
+        boost::container::static_vector<ShaderTiming, MaxShaderCount> shaders;
+        i64 pipelineNs{}; //!< The time spent by the driver creating the Vulkan pipeline from the shader modules
+
+        void AddTranslation(u64 hash, i64 durationNs);
+
+        void AddSpirv(u64 hash, i64 durationNs);
+
+        i64 TranslationNs() const;
+
+        i64 SpirvNs() const;
+
+        i64 TotalNs() const;
+
+        /**
+         * @return The shader which took the longest to translate and emit, this is the most likely culprit of a slow compile
+         */
+        const ShaderTiming *WorstShader() const;
+
+      private:
+        ShaderTiming *GetShader(u64 hash);
+    };
+
+    /**
+     * @brief Tracks the slowest pipeline compilations in a bounded table, so that stutters can be attributed to the responsible shaders
+     */
+    class ShaderTelemetry {
+      public:
+        enum class PipelineType : u8 {
+            Graphics,
+            Compute,
+        };
+
+        static constexpr size_t WorstOffenderCount{32}; //!< The amount of pipelines retained in the worst offenders table
+        static constexpr i64 SlowCompileThresholdNs{50 * constant::NsInMillisecond}; //!< The total compile time above which a pipeline compilation is logged
+
+      private:
+        struct Offender {
+            PipelineType type;
+            PipelineCompileTimings timings;
+        };
+
+        std::mutex mutex;
+        std::vector<Offender> worstOffenders; //!< The slowest compilations sorted by their total duration in descending order
+        u64 pipelineCount{};
+        i64 totalNs{}; //!< The accumulated compile time of all pipelines
+
+      public:
+        /**
+         * @brief Records the timings of a completed pipeline compilation
+         */
+        void Record(PipelineType type, const PipelineCompileTimings &timings);
+
+        /**
+         * @return The worst offenders table as CSV, the slowest compilation is first
+         */
+        std::string GetWorstOffenders();
+
+        /**
+         * @brief Clears all recorded compilations
+         */
+        void Reset();
+    };
+
+    extern ShaderTelemetry ShaderStats; //!< The shader compilation telemetry of the emulator
+}
@@ -240,7 +240,7 @@ namespace skyline::gpu {
                       const GraphicsPipelineAssembler::CompiledPipeline &pipeline,
                       vk::Extent2D imageDimensions)
                 : vertexPushConstants{vertexPushConstants}, fragmentPushConstants{fragmentPushConstants},
-                  descriptorSet{gpu.descriptor.AllocateSet(*pipeline.descriptorSetLayout)},
+                  descriptorSet{gpu.descriptor.AllocateSet(pipeline.descriptorSetLayout)},
                   pipeline{pipeline},
                   imageDimensions{imageDimensions} {}
         };
@@ -298,10 +298,10 @@ namespace skyline::gpu {
             commandBuffer.setScissor(0, {scissor});
             commandBuffer.setViewport(0, {viewport});
             commandBuffer.bindPipeline(vk::PipelineBindPoint::eGraphics, *drawState->pipeline.pipeline.get());
-            commandBuffer.bindDescriptorSets(vk::PipelineBindPoint::eGraphics, *drawState->pipeline.pipelineLayout, 0, *drawState->descriptorSet, nullptr);
-            commandBuffer.pushConstants(*drawState->pipeline.pipelineLayout, vk::ShaderStageFlagBits::eVertex, 0,
+            commandBuffer.bindDescriptorSets(vk::PipelineBindPoint::eGraphics, drawState->pipeline.pipelineLayout, 0, *drawState->descriptorSet, nullptr);
+            commandBuffer.pushConstants(drawState->pipeline.pipelineLayout, vk::ShaderStageFlagBits::eVertex, 0,
                                         vk::ArrayProxy<const blit::VertexPushConstantLayout>{drawState->vertexPushConstants});
-            commandBuffer.pushConstants(*drawState->pipeline.pipelineLayout, vk::ShaderStageFlagBits::eFragment, sizeof(blit::VertexPushConstantLayout),
+            commandBuffer.pushConstants(drawState->pipeline.pipelineLayout, vk::ShaderStageFlagBits::eFragment, sizeof(blit::VertexPushConstantLayout),
                                         vk::ArrayProxy<const blit::FragmentPushConstantLayout>{drawState->fragmentPushConstants});
             commandBuffer.draw(6, 1, 0, 0);
         });
@@ -383,14 +383,527 @@ namespace skyline::gpu {
             commandBuffer.setScissor(0, {scissor});
             commandBuffer.setViewport(0, {viewport});
             commandBuffer.bindPipeline(vk::PipelineBindPoint::eGraphics, *drawState->pipeline.pipeline.get());
-            commandBuffer.pushConstants(*drawState->pipeline.pipelineLayout, vk::ShaderStageFlagBits::eFragment, 0,
+            commandBuffer.pushConstants(drawState->pipeline.pipelineLayout, vk::ShaderStageFlagBits::eFragment, 0,
                                         vk::ArrayProxy<const clear::FragmentPushConstantLayout>{drawState->fragmentPushConstants});
             commandBuffer.draw(6, 1, 0, 0);
         });
     }
 
+    namespace texture_decode {
+        struct DeswizzlePushConstantLayout {
+            u32 widthBytes;
+            u32 height;
+            u32 gobBlockHeight;
+            u32 gobBlockDepth;
+            u32 robWidthGobs;
+            u32 robCount;
+            u32 srcOffset;
+            u32 dstOffset;
+        };
+
+        struct BcDecodePushConstantLayout {
+            u32 width;
+            u32 height;
+            u32 srcOffset;
+            u32 dstOffset;
+            u32 format;
+            glsl::Bool hasAlphaChannel;
+        };
+
+        constexpr static vk::PushConstantRange PushConstantRange{
+            .stageFlags = vk::ShaderStageFlagBits::eCompute,
+            .size = static_cast<u32>(std::max(sizeof(DeswizzlePushConstantLayout), sizeof(BcDecodePushConstantLayout))),
+            .offset = 0
+        };
+
+        constexpr static std::array<vk::DescriptorSetLayoutBinding, 2> LayoutBindings{
+            vk::DescriptorSetLayoutBinding{
+                .binding = 0,
+                .descriptorType = vk::DescriptorType::eStorageBuffer,
+                .descriptorCount = 1,
+                .stageFlags = vk::ShaderStageFlagBits::eCompute
+            }, vk::DescriptorSetLayoutBinding{
+                .binding = 1,
+                .descriptorType = vk::DescriptorType::eStorageBuffer,
+                .descriptorCount = 1,
+                .stageFlags = vk::ShaderStageFlagBits::eCompute
+            }
+        };
+
+        constexpr u32 DeswizzleWorkgroupWidth{64}; //!< The X-axis workgroup size of the deswizzle shader in words
+        constexpr u32 BcDecodeWorkgroupSize{8}; //!< The X and Y-axis workgroup size of the BCn decode shader in blocks
+
+        static vk::raii::Pipeline CreateComputePipeline(GPU &gpu, const vk::raii::ShaderModule &module, const vk::raii::PipelineLayout &layout) {
+            return gpu.vkDevice.createComputePipeline(nullptr, vk::ComputePipelineCreateInfo{
+                .stage = {
+                    .stage = vk::ShaderStageFlagBits::eCompute,
+                    .module = *module,
+                    .pName = "main"
+                },
+                .layout = *layout
+            });
+        }
+
+        /**
+         * @brief Allocates and writes a descriptor set with the supplied source and destination storage buffers, it's attached to the supplied cycle
+         */
+        static vk::DescriptorSet AllocateDescriptorSet(GPU &gpu, const std::shared_ptr<FenceCycle> &cycle, vk::DescriptorSetLayout layout, const vk::DescriptorBufferInfo &src, const vk::DescriptorBufferInfo &dst) {
+            auto descriptorSet{std::make_shared<DescriptorAllocator::ActiveDescriptorSet>(gpu.descriptor.AllocateSet(layout))};
+            cycle->AttachObject(descriptorSet);
+
+            std::array<vk::WriteDescriptorSet, 2> writes{
+                vk::WriteDescriptorSet{
+                    .dstSet = **descriptorSet,
+                    .dstBinding = 0,
+                    .descriptorType = vk::DescriptorType::eStorageBuffer,
+                    .descriptorCount = 1,
+                    .pBufferInfo = &src
+                }, vk::WriteDescriptorSet{
+                    .dstSet = **descriptorSet,
+                    .dstBinding = 1,
+                    .descriptorType = vk::DescriptorType::eStorageBuffer,
+                    .descriptorCount = 1,
+                    .pBufferInfo = &dst
+                }
+            };
+
+            gpu.vkDevice.updateDescriptorSets(writes, nullptr);
+            return **descriptorSet;
+        }
+
+        /**
+         * @brief Records a barrier that makes the output of any prior compute dispatches visible to subsequent compute and transfer operations
+         */
+        static void RecordOutputBarrier(const vk::raii::CommandBuffer &commandBuffer) {
+            commandBuffer.pipelineBarrier(vk::PipelineStageFlagBits::eComputeShader, vk::PipelineStageFlagBits::eComputeShader | vk::PipelineStageFlagBits::eTransfer, {}, vk::MemoryBarrier{
+                .srcAccessMask = vk::AccessFlagBits::eShaderWrite,
+                .dstAccessMask = vk::AccessFlagBits::eShaderRead | vk::AccessFlagBits::eTransferRead
+            }, {}, {});
+        }
+    }
+
+    TextureDecodeHelperShader::TextureDecodeHelperShader(GPU &gpu, std::shared_ptr<vfs::FileSystem> shaderFileSystem)
+        : descriptorSetLayout{gpu.vkDevice, vk::DescriptorSetLayoutCreateInfo{
+              .pBindings = texture_decode::LayoutBindings.data(),
+              .bindingCount = static_cast<u32>(texture_decode::LayoutBindings.size()),
+          }},
+          pipelineLayout{gpu.vkDevice, vk::PipelineLayoutCreateInfo{
+              .pSetLayouts = &*descriptorSetLayout,
+              .setLayoutCount = 1,
+              .pPushConstantRanges = &texture_decode::PushConstantRange,
+              .pushConstantRangeCount = 1,
+          }},
+          deswizzleShaderModule{CreateShaderModule(gpu, *shaderFileSystem->OpenFile("shaders/block_linear_deswizzle.comp.spv"))},
+          bcDecodeShaderModule{CreateShaderModule(gpu, *shaderFileSystem->OpenFile("shaders/bc_decode.comp.spv"))},
+          deswizzlePipeline{texture_decode::CreateComputePipeline(gpu, deswizzleShaderModule, pipelineLayout)},
+          bcDecodePipeline{texture_decode::CreateComputePipeline(gpu, bcDecodeShaderModule, pipelineLayout)} {}
+
+    u32 TextureDecodeHelperShader::GetDecodableBcnFormat(vk::Format format) {
+        switch (format) {
+            case vk::Format::eBc1RgbaUnormBlock:
+            case vk::Format::eBc1RgbaSrgbBlock:
+                return 1;
+
+            case vk::Format::eBc2UnormBlock:
+            case vk::Format::eBc2SrgbBlock:
+                return 2;
+
+            case vk::Format::eBc3UnormBlock:
+            case vk::Format::eBc3SrgbBlock:
+                return 3;
+
+            default:
+                return 0; // BC4/BC5 decode to sub-word texels and BC6H/BC7 are left to the CPU decoder
+        }
+    }
+
+    vk::DescriptorSet TextureDecodeHelperShader::AllocateDescriptorSet(GPU &gpu, const std::shared_ptr<FenceCycle> &cycle, const vk::DescriptorBufferInfo &src, const vk::DescriptorBufferInfo &dst) {
+        return texture_decode::AllocateDescriptorSet(gpu, cycle, *descriptorSetLayout, src, dst);
+    }
+
+    void TextureDecodeHelperShader::Deswizzle(GPU &gpu, const vk::raii::CommandBuffer &commandBuffer, const std::shared_ptr<FenceCycle> &cycle, const vk::DescriptorBufferInfo &src, const vk::DescriptorBufferInfo &dst, span<const DeswizzleLevel> levels) {
+        constexpr u32 GobWidth{64}, GobHeight{8};
+
+        commandBuffer.bindPipeline(vk::PipelineBindPoint::eCompute, *deswizzlePipeline);
+        commandBuffer.bindDescriptorSets(vk::PipelineBindPoint::eCompute, *pipelineLayout, 0, AllocateDescriptorSet(gpu, cycle, src, dst), nullptr);
+
+        for (const auto &level : levels) {
+            texture_decode::DeswizzlePushConstantLayout pushConstants{
+                .widthBytes = level.widthBytes,
+                .height = level.height,
+                .gobBlockHeight = level.gobBlockHeight,
+                .gobBlockDepth = level.gobBlockDepth,
+                .robWidthGobs = util::DivideCeil(level.widthBytes, GobWidth),
+                .robCount = util::DivideCeil(level.height, GobHeight * level.gobBlockHeight),
+                .srcOffset = level.srcOffset,
+                .dstOffset = level.dstOffset,
+            };
+
+            commandBuffer.pushConstants(*pipelineLayout, vk::ShaderStageFlagBits::eCompute, 0, vk::ArrayProxy<const texture_decode::DeswizzlePushConstantLayout>{pushConstants});
+            commandBuffer.dispatch(util::DivideCeil(level.widthBytes / 4, texture_decode::DeswizzleWorkgroupWidth), level.height, level.depth);
+        }
+
+        texture_decode::RecordOutputBarrier(commandBuffer);
+    }
+
+    void TextureDecodeHelperShader::DecodeBcn(GPU &gpu, const vk::raii::CommandBuffer &commandBuffer, const std::shared_ptr<FenceCycle> &cycle, const vk::DescriptorBufferInfo &src, const vk::DescriptorBufferInfo &dst, u32 bcnFormat, bool hasAlphaChannel, span<const DecodeLevel> levels) {
+        constexpr u32 BcBlockSize{4}; //!< The width and height of a BCn block in pixels
+
+        commandBuffer.bindPipeline(vk::PipelineBindPoint::eCompute, *bcDecodePipeline);
+        commandBuffer.bindDescriptorSets(vk::PipelineBindPoint::eCompute, *pipelineLayout, 0, AllocateDescriptorSet(gpu, cycle, src, dst), nullptr);
+
+        for (const auto &level : levels) {
+            texture_decode::BcDecodePushConstantLayout pushConstants{
+                .width = level.width,
+                .height = level.height,
+                .srcOffset = level.srcOffset,
+                .dstOffset = level.dstOffset,
+                .format = bcnFormat,
+                .hasAlphaChannel = hasAlphaChannel,
+            };
+
+            commandBuffer.pushConstants(*pipelineLayout, vk::ShaderStageFlagBits::eCompute, 0, vk::ArrayProxy<const texture_decode::BcDecodePushConstantLayout>{pushConstants});
+            commandBuffer.dispatch(util::DivideCeil(util::DivideCeil(level.width, BcBlockSize), texture_decode::BcDecodeWorkgroupSize),
+                                   util::DivideCeil(util::DivideCeil(level.height, BcBlockSize), texture_decode::BcDecodeWorkgroupSize), 1);
+        }
+
+        texture_decode::RecordOutputBarrier(commandBuffer);
+    }
+
+    namespace quad_conversion {
+        struct PushConstantLayout {
+            u32 srcOffset;
+            u32 indexSizeShift;
+            u32 indexCount;
+        };
+
+        constexpr static vk::PushConstantRange PushConstantRange{
+            .stageFlags = vk::ShaderStageFlagBits::eCompute,
+            .size = sizeof(PushConstantLayout),
+            .offset = 0
+        };
+
+        constexpr u32 WorkgroupSize{64}; //!< The X-axis workgroup size of the quad conversion shader in quads
+    }
+
+    QuadConversionHelperShader::QuadConversionHelperShader(GPU &gpu, std::shared_ptr<vfs::FileSystem> shaderFileSystem)
+        : descriptorSetLayout{gpu.vkDevice, vk::DescriptorSetLayoutCreateInfo{
+              .pBindings = texture_decode::LayoutBindings.data(),
+              .bindingCount = static_cast<u32>(texture_decode::LayoutBindings.size()),
+          }},
+          pipelineLayout{gpu.vkDevice, vk::PipelineLayoutCreateInfo{
+              .pSetLayouts = &*descriptorSetLayout,
+              .setLayoutCount = 1,
+              .pPushConstantRanges = &quad_conversion::PushConstantRange,
+              .pushConstantRangeCount = 1,
+          }},
+          shaderModule{CreateShaderModule(gpu, *shaderFileSystem->OpenFile("shaders/quad_conversion.comp.spv"))},
+          pipeline{texture_decode::CreateComputePipeline(gpu, shaderModule, pipelineLayout)} {}
+
+    void QuadConversionHelperShader::Convert(GPU &gpu, const vk::raii::CommandBuffer &commandBuffer, const std::shared_ptr<FenceCycle> &cycle, const vk::DescriptorBufferInfo &src, const vk::DescriptorBufferInfo &dst, u32 srcOffset, u32 indexSize, u32 indexCount) {
+        // The source may have been written by any prior GPU operation in the execution
+        commandBuffer.pipelineBarrier(vk::PipelineStageFlagBits::eAllCommands, vk::PipelineStageFlagBits::eComputeShader, {}, vk::MemoryBarrier{
+            .srcAccessMask = vk::AccessFlagBits::eMemoryWrite,
+            .dstAccessMask = vk::AccessFlagBits::eShaderRead
+        }, {}, {});
+
+        commandBuffer.bindPipeline(vk::PipelineBindPoint::eCompute, *pipeline);
+        commandBuffer.bindDescriptorSets(vk::PipelineBindPoint::eCompute, *pipelineLayout, 0, texture_decode::AllocateDescriptorSet(gpu, cycle, *descriptorSetLayout, src, dst), nullptr);
+
+        quad_conversion::PushConstantLayout pushConstants{
+            .srcOffset = srcOffset,
+            .indexSizeShift = static_cast<u32>(std::countr_zero(indexSize)),
+            .indexCount = indexCount,
+        };
+
+        commandBuffer.pushConstants(*pipelineLayout, vk::ShaderStageFlagBits::eCompute, 0, vk::ArrayProxy<const quad_conversion::PushConstantLayout>{pushConstants});
+        commandBuffer.dispatch(util::DivideCeil(util::DivideCeil(indexCount, 4U), quad_conversion::WorkgroupSize), 1, 1);
+
+        commandBuffer.pipelineBarrier(vk::PipelineStageFlagBits::eComputeShader, vk::PipelineStageFlagBits::eVertexInput, {}, vk::MemoryBarrier{
+            .srcAccessMask = vk::AccessFlagBits::eShaderWrite,
+            .dstAccessMask = vk::AccessFlagBits::eIndexRead
+        }, {}, {});
+    }
+
+    namespace index_widening {
+        struct PushConstantLayout {
+            u32 srcOffset;
+            u32 indexCount;
+        };
+
+        constexpr static vk::PushConstantRange PushConstantRange{
+            .stageFlags = vk::ShaderStageFlagBits::eCompute,
+            .size = sizeof(PushConstantLayout),
+            .offset = 0
+        };
+
+        constexpr u32 WorkgroupSize{64}; //!< The X-axis workgroup size of the index widening shader in pairs of indices
+    }
+
+    IndexWideningHelperShader::IndexWideningHelperShader(GPU &gpu, std::shared_ptr<vfs::FileSystem> shaderFileSystem)
+        : descriptorSetLayout{gpu.vkDevice, vk::DescriptorSetLayoutCreateInfo{
+              .pBindings = texture_decode::LayoutBindings.data(),
+              .bindingCount = static_cast<u32>(texture_decode::LayoutBindings.size()),
+          }},
+          pipelineLayout{gpu.vkDevice, vk::PipelineLayoutCreateInfo{
+              .pSetLayouts = &*descriptorSetLayout,
+              .setLayoutCount = 1,
+              .pPushConstantRanges = &index_widening::PushConstantRange,
+              .pushConstantRangeCount = 1,
+          }},
+          shaderModule{CreateShaderModule(gpu, *shaderFileSystem->OpenFile("shaders/index_widening.comp.spv"))},
+          pipeline{texture_decode::CreateComputePipeline(gpu, shaderModule, pipelineLayout)} {}
+
+    void IndexWideningHelperShader::Widen(GPU &gpu, const vk::raii::CommandBuffer &commandBuffer, const std::shared_ptr<FenceCycle> &cycle, const vk::DescriptorBufferInfo &src, const vk::DescriptorBufferInfo &dst, u32 srcOffset, u32 indexCount) {
+        // The source may have been written by any prior GPU operation in the execution
+        commandBuffer.pipelineBarrier(vk::PipelineStageFlagBits::eAllCommands, vk::PipelineStageFlagBits::eComputeShader, {}, vk::MemoryBarrier{
+            .srcAccessMask = vk::AccessFlagBits::eMemoryWrite,
+            .dstAccessMask = vk::AccessFlagBits::eShaderRead
+        }, {}, {});
+
+        commandBuffer.bindPipeline(vk::PipelineBindPoint::eCompute, *pipeline);
+        commandBuffer.bindDescriptorSets(vk::PipelineBindPoint::eCompute, *pipelineLayout, 0, texture_decode::AllocateDescriptorSet(gpu, cycle, *descriptorSetLayout, src, dst), nullptr);
+
+        index_widening::PushConstantLayout pushConstants{
+            .srcOffset = srcOffset,
+            .indexCount = indexCount,
+        };
+
+        commandBuffer.pushConstants(*pipelineLayout, vk::ShaderStageFlagBits::eCompute, 0, vk::ArrayProxy<const index_widening::PushConstantLayout>{pushConstants});
+        commandBuffer.dispatch(util::DivideCeil(util::DivideCeil(indexCount, 2U), index_widening::WorkgroupSize), 1, 1);
+
+        commandBuffer.pipelineBarrier(vk::PipelineStageFlagBits::eComputeShader, vk::PipelineStageFlagBits::eVertexInput, {}, vk::MemoryBarrier{
+            .srcAccessMask = vk::AccessFlagBits::eShaderWrite,
+            .dstAccessMask = vk::AccessFlagBits::eIndexRead
+        }, {}, {});
+    }
+
+    namespace format_conversion {
+        struct PushConstantLayout {
+            u32 pixelCount;
+            u32 conversion;
+            glsl::Bool toGuest;
+        };
+
+        constexpr static vk::PushConstantRange PushConstantRange{
+            .stageFlags = vk::ShaderStageFlagBits::eCompute,
+            .size = sizeof(PushConstantLayout),
+            .offset = 0
+        };
+
+        constexpr u32 WorkgroupSize{64}; //!< The X-axis workgroup size of the format conversion shader in pairs of pixels
+
+        constexpr u32 ConversionB5G6R5{1};
+        constexpr u32 ConversionB5G5R5A1{2};
+    }
+
+    FormatConversionHelperShader::FormatConversionHelperShader(GPU &gpu, std::shared_ptr<vfs::FileSystem> shaderFileSystem)
+        : descriptorSetLayout{gpu.vkDevice, vk::DescriptorSetLayoutCreateInfo{
+              .pBindings = texture_decode::LayoutBindings.data(),
+              .bindingCount = static_cast<u32>(texture_decode::LayoutBindings.size()),
+          }},
+          pipelineLayout{gpu.vkDevice, vk::PipelineLayoutCreateInfo{
+              .pSetLayouts = &*descriptorSetLayout,
+              .setLayoutCount = 1,
+              .pPushConstantRanges = &format_conversion::PushConstantRange,
+              .pushConstantRangeCount = 1,
+          }},
+          shaderModule{CreateShaderModule(gpu, *shaderFileSystem->OpenFile("shaders/format_conversion.comp.spv"))},
+          pipeline{texture_decode::CreateComputePipeline(gpu, shaderModule, pipelineLayout)} {}
+
+    u32 FormatConversionHelperShader::GetConversion(vk::Format guestFormat, vk::Format hostFormat) {
+        if (hostFormat != vk::Format::eR8G8B8A8Unorm)
+            return 0;
+
+        switch (guestFormat) {
+            case vk::Format::eB5G6R5UnormPack16:
+                return format_conversion::ConversionB5G6R5;
+
+            case vk::Format::eB5G5R5A1UnormPack16:
+                return format_conversion::ConversionB5G5R5A1;
+
+            default:
+                return 0;
+        }
+    }
+
+    void FormatConversionHelperShader::Convert(GPU &gpu, const vk::raii::CommandBuffer &commandBuffer, const std::shared_ptr<FenceCycle> &cycle, const vk::DescriptorBufferInfo &src, const vk::DescriptorBufferInfo &dst, u32 conversion, bool toGuest, u32 pixelCount) {
+        commandBuffer.bindPipeline(vk::PipelineBindPoint::eCompute, *pipeline);
+        commandBuffer.bindDescriptorSets(vk::PipelineBindPoint::eCompute, *pipelineLayout, 0, texture_decode::AllocateDescriptorSet(gpu, cycle, *descriptorSetLayout, src, dst), nullptr);
+
+        format_conversion::PushConstantLayout pushConstants{
+            .pixelCount = pixelCount,
+            .conversion = conversion,
+            .toGuest = toGuest,
+        };
+
+        commandBuffer.pushConstants(*pipelineLayout, vk::ShaderStageFlagBits::eCompute, 0, vk::ArrayProxy<const format_conversion::PushConstantLayout>{pushConstants});
+        commandBuffer.dispatch(util::DivideCeil(util::DivideCeil(pixelCount, 2U), format_conversion::WorkgroupSize), 1, 1);
+
+        texture_decode::RecordOutputBarrier(commandBuffer);
+    }
+
+    namespace vic_composition {
+        struct PushConstantLayout {
+            u32 width;
+            u32 height;
+            u32 srcStride;
+            u32 chromaOffset;
+            u32 dstStride;
+            glsl::Bool swapRedBlue;
+        };
+
+        constexpr static vk::PushConstantRange PushConstantRange{
+            .stageFlags = vk::ShaderStageFlagBits::eCompute,
+            .size = sizeof(PushConstantLayout),
+            .offset = 0
+        };
+
+        constexpr u32 WorkgroupSize{8}; //!< The X and Y-axis workgroup size of the composition shader in pixels
+    }
+
+    VicCompositionHelperShader::VicCompositionHelperShader(GPU &gpu, std::shared_ptr<vfs::FileSystem> shaderFileSystem)
+        : descriptorSetLayout{gpu.vkDevice, vk::DescriptorSetLayoutCreateInfo{
+              .pBindings = texture_decode::LayoutBindings.data(),
+              .bindingCount = static_cast<u32>(texture_decode::LayoutBindings.size()),
+          }},
+          pipelineLayout{gpu.vkDevice, vk::PipelineLayoutCreateInfo{
+              .pSetLayouts = &*descriptorSetLayout,
+              .setLayoutCount = 1,
+              .pPushConstantRanges = &vic_composition::PushConstantRange,
+              .pushConstantRangeCount = 1,
+          }},
+          shaderModule{CreateShaderModule(gpu, *shaderFileSystem->OpenFile("shaders/vic_composite.comp.spv"))},
+          pipeline{texture_decode::CreateComputePipeline(gpu, shaderModule, pipelineLayout)} {}
+
+    void VicCompositionHelperShader::Compose(GPU &gpu, const vk::raii::CommandBuffer &commandBuffer, const std::shared_ptr<FenceCycle> &cycle, const vk::DescriptorBufferInfo &src, const vk::DescriptorBufferInfo &dst, u32 width, u32 height, u32 srcStride, u32 chromaOffset, u32 dstStride, bool swapRedBlue) {
+        commandBuffer.bindPipeline(vk::PipelineBindPoint::eCompute, *pipeline);
+        commandBuffer.bindDescriptorSets(vk::PipelineBindPoint::eCompute, *pipelineLayout, 0, texture_decode::AllocateDescriptorSet(gpu, cycle, *descriptorSetLayout, src, dst), nullptr);
+
+        vic_composition::PushConstantLayout pushConstants{
+            .width = width,
+            .height = height,
+            .srcStride = srcStride,
+            .chromaOffset = chromaOffset,
+            .dstStride = dstStride,
+            .swapRedBlue = swapRedBlue,
+        };
+
+        commandBuffer.pushConstants(*pipelineLayout, vk::ShaderStageFlagBits::eCompute, 0, vk::ArrayProxy<const vic_composition::PushConstantLayout>{pushConstants});
+        commandBuffer.dispatch(util::DivideCeil(width, vic_composition::WorkgroupSize), util::DivideCeil(height, vic_composition::WorkgroupSize), 1);
+
+        texture_decode::RecordOutputBarrier(commandBuffer);
+    }
+
+    namespace upscale {
+        struct PushConstantLayout {
+            glsl::Vec2 dstPixelSize;
+            u32 dstWidth;
+            u32 dstHeight;
+            float sharpness;
+        };
+
+        constexpr static vk::PushConstantRange PushConstantRange{
+            .stageFlags = vk::ShaderStageFlagBits::eCompute,
+            .size = sizeof(PushConstantLayout),
+            .offset = 0
+        };
+
+        constexpr static std::array<vk::DescriptorSetLayoutBinding, 2> LayoutBindings{
+            vk::DescriptorSetLayoutBinding{
+                .binding = 0,
+                .descriptorType = vk::DescriptorType::eCombinedImageSampler,
+                .descriptorCount = 1,
+                .stageFlags = vk::ShaderStageFlagBits::eCompute
+            }, vk::DescriptorSetLayoutBinding{
+                .binding = 1,
+                .descriptorType = vk::DescriptorType::eStorageImage,
+                .descriptorCount = 1,
+                .stageFlags = vk::ShaderStageFlagBits::eCompute
+            }
+        };
+
+        constexpr u32 WorkgroupSize{8}; //!< The X and Y-axis workgroup size of the upscaling shader in pixels
+    }
+
+    UpscaleHelperShader::UpscaleHelperShader(GPU &gpu, std::shared_ptr<vfs::FileSystem> shaderFileSystem)
+        : descriptorSetLayout{gpu.vkDevice, vk::DescriptorSetLayoutCreateInfo{
+              .pBindings = upscale::LayoutBindings.data(),
+              .bindingCount = static_cast<u32>(upscale::LayoutBindings.size()),
+          }},
+          pipelineLayout{gpu.vkDevice, vk::PipelineLayoutCreateInfo{
+              .pSetLayouts = &*descriptorSetLayout,
+              .setLayoutCount = 1,
+              .pPushConstantRanges = &upscale::PushConstantRange,
+              .pushConstantRangeCount = 1,
+          }},
+          shaderModule{CreateShaderModule(gpu, *shaderFileSystem->OpenFile("shaders/present_upscale.comp.spv"))},
+          pipeline{texture_decode::CreateComputePipeline(gpu, shaderModule, pipelineLayout)},
+          bilinearSampler{gpu.vkDevice.createSampler(
+              vk::SamplerCreateInfo{
+                  .addressModeU = vk::SamplerAddressMode::eClampToEdge,
+                  .addressModeV = vk::SamplerAddressMode::eClampToEdge,
+                  .addressModeW = vk::SamplerAddressMode::eClampToEdge,
+                  .anisotropyEnable = false,
+                  .compareEnable = false,
+                  .magFilter = vk::Filter::eLinear,
+                  .minFilter = vk::Filter::eLinear
+              })
+          } {}
+
+    void UpscaleHelperShader::Upscale(GPU &gpu, const vk::raii::CommandBuffer &commandBuffer, const std::shared_ptr<FenceCycle> &cycle, vk::ImageView srcView, vk::ImageView dstView, vk::Extent2D dstExtent, float sharpness) {
+        auto descriptorSet{std::make_shared<DescriptorAllocator::ActiveDescriptorSet>(gpu.descriptor.AllocateSet(*descriptorSetLayout))};
+        cycle->AttachObject(descriptorSet);
+
+        vk::DescriptorImageInfo srcInfo{
+            .sampler = *bilinearSampler,
+            .imageView = srcView,
+            .imageLayout = vk::ImageLayout::eGeneral,
+        }, dstInfo{
+            .imageView = dstView,
+            .imageLayout = vk::ImageLayout::eGeneral,
+        };
+
+        std::array<vk::WriteDescriptorSet, 2> writes{
+            vk::WriteDescriptorSet{
+                .dstSet = **descriptorSet,
+                .dstBinding = 0,
+                .descriptorType = vk::DescriptorType::eCombinedImageSampler,
+                .descriptorCount = 1,
+                .pImageInfo = &srcInfo
+            }, vk::WriteDescriptorSet{
+                .dstSet = **descriptorSet,
+                .dstBinding = 1,
+                .descriptorType = vk::DescriptorType::eStorageImage,
+                .descriptorCount = 1,
+                .pImageInfo = &dstInfo
+            }
+        };
+
+        gpu.vkDevice.updateDescriptorSets(writes, nullptr);
+
+        commandBuffer.bindPipeline(vk::PipelineBindPoint::eCompute, *pipeline);
+        commandBuffer.bindDescriptorSets(vk::PipelineBindPoint::eCompute, *pipelineLayout, 0, **descriptorSet, nullptr);
+
+        upscale::PushConstantLayout pushConstants{
+            .dstPixelSize = {1.0f / static_cast<float>(dstExtent.width), 1.0f / static_cast<float>(dstExtent.height)},
+            .dstWidth = dstExtent.width,
+            .dstHeight = dstExtent.height,
+            .sharpness = std::clamp(sharpness, 0.0f, 1.0f),
+        };
+
+        commandBuffer.pushConstants(*pipelineLayout, vk::ShaderStageFlagBits::eCompute, 0, vk::ArrayProxy<const upscale::PushConstantLayout>{pushConstants});
+        commandBuffer.dispatch(util::DivideCeil(dstExtent.width, upscale::WorkgroupSize), util::DivideCeil(dstExtent.height, upscale::WorkgroupSize), 1);
+    }
+
     HelperShaders::HelperShaders(GPU &gpu, std::shared_ptr<vfs::FileSystem> shaderFileSystem)
         : blitHelperShader(gpu, shaderFileSystem),
-          clearHelperShader(gpu, shaderFileSystem) {}
+          clearHelperShader(gpu, shaderFileSystem),
+          textureDecodeHelperShader(gpu, shaderFileSystem),
+          quadConversionHelperShader(gpu, shaderFileSystem),
+          indexWideningHelperShader(gpu, shaderFileSystem),
+          formatConversionHelperShader(gpu, shaderFileSystem),
+          vicCompositionHelperShader(gpu, shaderFileSystem),
+          upscaleHelperShader(gpu, shaderFileSystem) {}
 
 }
\ No newline at end of file
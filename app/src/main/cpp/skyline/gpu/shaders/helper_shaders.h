@@ -108,12 +108,195 @@ namespace skyline::gpu {
                   std::function<void(std::function<void(vk::raii::CommandBuffer &, const std::shared_ptr<FenceCycle> &, GPU &, vk::RenderPass, u32)> &&)> &&recordCb);
     };
 
+    /**
+     * @brief Compute helper shaders for deswizzling block-linear textures and decoding BCn textures on the GPU rather than on the CPU
+     */
+    class TextureDecodeHelperShader {
+      private:
+        vk::raii::DescriptorSetLayout descriptorSetLayout; //!< A layout with a source and destination storage buffer, this is shared by all pipelines
+        vk::raii::PipelineLayout pipelineLayout;
+        vk::raii::ShaderModule deswizzleShaderModule;
+        vk::raii::ShaderModule bcDecodeShaderModule;
+        vk::raii::Pipeline deswizzlePipeline;
+        vk::raii::Pipeline bcDecodePipeline;
+
+        /**
+         * @brief Allocates and writes a descriptor set with the supplied buffers, it's attached to the supplied cycle
+         */
+        vk::DescriptorSet AllocateDescriptorSet(GPU &gpu, const std::shared_ptr<FenceCycle> &cycle, const vk::DescriptorBufferInfo &src, const vk::DescriptorBufferInfo &dst);
+
+      public:
+        /**
+         * @brief The parameters for deswizzling a single level of a single layer of a block-linear texture
+         * @note All offsets are in words and the width of the level in bytes must be word-aligned
+         */
+        struct DeswizzleLevel {
+            u32 widthBytes; //!< The width of a single line of the level in bytes
+            u32 height; //!< The height of the level in lines
+            u32 depth; //!< The depth of the level in slices
+            u32 gobBlockHeight;
+            u32 gobBlockDepth;
+            u32 srcOffset;
+            u32 dstOffset;
+        };
+
+        /**
+         * @brief The parameters for decoding a single level of a BCn texture, all layers of the level are treated as a single image
+         * @note All offsets are in words
+         */
+        struct DecodeLevel {
+            u32 width; //!< The width of the level in pixels
+            u32 height; //!< The height of the level in pixels
+            u32 srcOffset;
+            u32 dstOffset;
+        };
+
+        TextureDecodeHelperShader(GPU &gpu, std::shared_ptr<vfs::FileSystem> shaderFileSystem);
+
+        /**
+         * @return The BCn format version (1-3) that can be decoded by the GPU path for the supplied format or 0 if it's not supported
+         */
+        static u32 GetDecodableBcnFormat(vk::Format format);
+
+        /**
+         * @brief Records dispatches to deswizzle the supplied block-linear levels from `src` into `dst`, a barrier is recorded after the dispatches to make the output visible to compute and transfer operations
+         */
+        void Deswizzle(GPU &gpu, const vk::raii::CommandBuffer &commandBuffer, const std::shared_ptr<FenceCycle> &cycle, const vk::DescriptorBufferInfo &src, const vk::DescriptorBufferInfo &dst, span<const DeswizzleLevel> levels);
+
+        /**
+         * @brief Records dispatches to decode the supplied BCn levels from `src` into R8G8B8A8 in `dst`, a barrier is recorded after the dispatches to make the output visible to compute and transfer operations
+         * @param bcnFormat The BCn format version as returned by GetDecodableBcnFormat
+         * @param hasAlphaChannel If BC1 textures should be decoded with 1-bit alpha
+         */
+        void DecodeBcn(GPU &gpu, const vk::raii::CommandBuffer &commandBuffer, const std::shared_ptr<FenceCycle> &cycle, const vk::DescriptorBufferInfo &src, const vk::DescriptorBufferInfo &dst, u32 bcnFormat, bool hasAlphaChannel, span<const DecodeLevel> levels);
+    };
+
+    /**
+     * @brief A compute helper shader for expanding quad list index buffers into triangle list index buffers on the GPU rather than on the CPU
+     */
+    class QuadConversionHelperShader {
+      private:
+        vk::raii::DescriptorSetLayout descriptorSetLayout; //!< A layout with a source and destination storage buffer
+        vk::raii::PipelineLayout pipelineLayout;
+        vk::raii::ShaderModule shaderModule;
+        vk::raii::Pipeline pipeline;
+
+      public:
+        QuadConversionHelperShader(GPU &gpu, std::shared_ptr<vfs::FileSystem> shaderFileSystem);
+
+        /**
+         * @brief Records a dispatch to expand the quad list indices in `src` into 32-bit triangle list indices in `dst`, barriers are recorded to make prior writes to `src` visible to the dispatch and the output visible to index fetching
+         * @param srcOffset The offset of the first index in `src` in bytes, this must be aligned to the size of an index
+         * @param indexSize The size of a single index in `src` in bytes
+         * @param indexCount The amount of indices to expand, `dst` must have space for 6 indices for every started quad
+         */
+        void Convert(GPU &gpu, const vk::raii::CommandBuffer &commandBuffer, const std::shared_ptr<FenceCycle> &cycle, const vk::DescriptorBufferInfo &src, const vk::DescriptorBufferInfo &dst, u32 srcOffset, u32 indexSize, u32 indexCount);
+    };
+
+    /**
+     * @brief A compute helper shader for widening 8-bit index buffers into 16-bit index buffers on the GPU, this is used on devices without VK_EXT_index_type_uint8
+     */
+    class IndexWideningHelperShader {
+      private:
+        vk::raii::DescriptorSetLayout descriptorSetLayout; //!< A layout with a source and destination storage buffer
+        vk::raii::PipelineLayout pipelineLayout;
+        vk::raii::ShaderModule shaderModule;
+        vk::raii::Pipeline pipeline;
+
+      public:
+        IndexWideningHelperShader(GPU &gpu, std::shared_ptr<vfs::FileSystem> shaderFileSystem);
+
+        /**
+         * @brief Records a dispatch to widen the 8-bit indices in `src` into 16-bit indices in `dst`, barriers are recorded to make prior writes to `src` visible to the dispatch and the output visible to index fetching
+         * @param srcOffset The offset of the first index in `src` in bytes
+         * @param indexCount The amount of indices to widen, `dst` must have space for this amount of indices rounded up to a multiple of 2
+         */
+        void Widen(GPU &gpu, const vk::raii::CommandBuffer &commandBuffer, const std::shared_ptr<FenceCycle> &cycle, const vk::DescriptorBufferInfo &src, const vk::DescriptorBufferInfo &dst, u32 srcOffset, u32 indexCount);
+    };
+
+    /**
+     * @brief A compute helper shader for converting packed 16-bit texels of formats that aren't supported by the host into R8G8B8A8 and back, this is used for uploads and readbacks of such textures
+     */
+    class FormatConversionHelperShader {
+      private:
+        vk::raii::DescriptorSetLayout descriptorSetLayout; //!< A layout with a source and destination storage buffer
+        vk::raii::PipelineLayout pipelineLayout;
+        vk::raii::ShaderModule shaderModule;
+        vk::raii::Pipeline pipeline;
+
+      public:
+        FormatConversionHelperShader(GPU &gpu, std::shared_ptr<vfs::FileSystem> shaderFileSystem);
+
+        /**
+         * @return The conversion that can be done between the supplied guest and host formats or 0 if there's none
+         */
+        static u32 GetConversion(vk::Format guestFormat, vk::Format hostFormat);
+
+        /**
+         * @brief Records a dispatch to convert the linear texels in `src` into `dst`, a barrier is recorded after the dispatch to make the output visible to compute and transfer operations
+         * @param conversion The conversion as returned by GetConversion
+         * @param toGuest If `src` is in the host format and should be converted into the guest format rather than the other way around
+         * @param pixelCount The amount of pixels to convert across all levels and layers
+         */
+        void Convert(GPU &gpu, const vk::raii::CommandBuffer &commandBuffer, const std::shared_ptr<FenceCycle> &cycle, const vk::DescriptorBufferInfo &src, const vk::DescriptorBufferInfo &dst, u32 conversion, bool toGuest, u32 pixelCount);
+    };
+
+    /**
+     * @brief A compute helper shader for converting decoded video frames into RGB surfaces on the GPU, this implements the composition done by the VIC
+     */
+    class VicCompositionHelperShader {
+      private:
+        vk::raii::DescriptorSetLayout descriptorSetLayout; //!< A layout with a source and destination storage buffer
+        vk::raii::PipelineLayout pipelineLayout;
+        vk::raii::ShaderModule shaderModule;
+        vk::raii::Pipeline pipeline;
+
+      public:
+        VicCompositionHelperShader(GPU &gpu, std::shared_ptr<vfs::FileSystem> shaderFileSystem);
+
+        /**
+         * @brief Records a dispatch to convert the NV12 frame in `src` into linear R8G8B8A8 or B8G8R8A8 pixels in `dst`, a barrier is recorded after the dispatch to make the output visible to transfer operations
+         * @param srcStride The stride of a line in both planes of the source frame in bytes
+         * @param chromaOffset The offset of the interleaved UV plane in `src` in bytes
+         * @param dstStride The stride of a line in `dst` in pixels
+         */
+        void Compose(GPU &gpu, const vk::raii::CommandBuffer &commandBuffer, const std::shared_ptr<FenceCycle> &cycle, const vk::DescriptorBufferInfo &src, const vk::DescriptorBufferInfo &dst, u32 width, u32 height, u32 srcStride, u32 chromaOffset, u32 dstStride, bool swapRedBlue);
+    };
+
+    /**
+     * @brief A compute helper shader for upscaling presented frames with bilinear filtering and contrast adaptive sharpening, the sharpening is equivalent to the RCAS pass of FSR 1
+     */
+    class UpscaleHelperShader {
+      private:
+        vk::raii::DescriptorSetLayout descriptorSetLayout; //!< A layout with a source combined image sampler and destination storage image
+        vk::raii::PipelineLayout pipelineLayout;
+        vk::raii::ShaderModule shaderModule;
+        vk::raii::Pipeline pipeline;
+        vk::raii::Sampler bilinearSampler;
+
+      public:
+        UpscaleHelperShader(GPU &gpu, std::shared_ptr<vfs::FileSystem> shaderFileSystem);
+
+        /**
+         * @brief Records a dispatch to upscale the entirety of `srcView` into `dstView`, both images must be in the general layout
+         * @param dstView A view of an R8G8B8A8 image with storage usage
+         * @param sharpness The amount of sharpening to apply in the range of 0 (None) to 1 (Maximum)
+         */
+        void Upscale(GPU &gpu, const vk::raii::CommandBuffer &commandBuffer, const std::shared_ptr<FenceCycle> &cycle, vk::ImageView srcView, vk::ImageView dstView, vk::Extent2D dstExtent, float sharpness);
+    };
+
     /**
      * @brief Holds all helper shaders to avoid redundantly recreating them on each usage
      */
     struct HelperShaders {
         BlitHelperShader blitHelperShader;
         ClearHelperShader clearHelperShader;
+        TextureDecodeHelperShader textureDecodeHelperShader;
+        QuadConversionHelperShader quadConversionHelperShader;
+        IndexWideningHelperShader indexWideningHelperShader;
+        FormatConversionHelperShader formatConversionHelperShader;
+        VicCompositionHelperShader vicCompositionHelperShader;
+        UpscaleHelperShader upscaleHelperShader;
 
         HelperShaders(GPU &gpu, std::shared_ptr<vfs::FileSystem> shaderFileSystem);
     };
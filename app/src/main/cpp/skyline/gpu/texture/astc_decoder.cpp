@@ -0,0 +1,775 @@
+// SPDX-License-Identifier: MPL-2.0
+// Copyright © 2023 Skyline Team and Contributors (https://github.com/skyline-emu/)
+
+// An LDR-only ASTC decoder implemented from the Khronos Data Format Specification (Section 23 - ASTC Compressed Texture Image Formats)
+
+#include <algorithm>
+#include <array>
+#include <cstring>
+#include "astc_decoder.h"
+
+namespace {
+    constexpr size_t R8g8b8a8Bpp{4};
+    constexpr size_t MaxBlockDimension{12};
+    constexpr size_t MaxWeightCount{64};
+    constexpr size_t MaxColorValueCount{18};
+    constexpr std::array<uint8_t, 4> ErrorColor{0xFF, 0x00, 0xFF, 0xFF}; //!< The color that all texels of an illegal or HDR block decode to
+
+    /**
+     * @brief A single 128-bit ASTC block which supports extracting arbitrary bitfields
+     */
+    struct Block {
+        uint64_t low;
+        uint64_t high;
+
+        uint32_t Bits(uint32_t offset, uint32_t count) const {
+            if (count == 0 || offset >= 128)
+                return 0;
+
+            uint64_t value;
+            if (offset >= 64)
+                value = high >> (offset - 64);
+            else if (offset == 0)
+                value = low;
+            else
+                value = (low >> offset) | (high << (64 - offset));
+            return static_cast<uint32_t>(value & ((1ULL << count) - 1));
+        }
+
+        /**
+         * @return A copy of the block with the order of all 128 bits reversed, weights are stored from the top of the block downwards
+         */
+        Block Reversed() const {
+            return {__builtin_bitreverse64(high), __builtin_bitreverse64(low)};
+        }
+    };
+
+    /**
+     * @brief A quantization range of an integer sequence encoded value, each value is a trit or a quint followed by a number of bits or only bits
+     */
+    struct IseRange {
+        uint8_t trits;
+        uint8_t quints;
+        uint8_t bits;
+
+        uint32_t EncodedBits(uint32_t count) const {
+            uint32_t size{count * bits};
+            if (trits)
+                size += (count * 8 + 4) / 5;
+            else if (quints)
+                size += (count * 7 + 2) / 3;
+            return size;
+        }
+    };
+
+    /**
+     * @brief The color endpoint quantization ranges ordered from the largest to the smallest, the largest range that fits within the block is used
+     */
+    constexpr std::array<IseRange, 17> ColorRanges{{
+        {0, 0, 8}, {1, 0, 6}, {0, 1, 5}, {0, 0, 7}, {1, 0, 5}, {0, 1, 4}, {0, 0, 6}, {1, 0, 4}, {0, 1, 3},
+        {0, 0, 5}, {1, 0, 3}, {0, 1, 2}, {0, 0, 4}, {1, 0, 2}, {0, 1, 1}, {0, 0, 3}, {1, 0, 1},
+    }};
+
+    /**
+     * @brief The weight quantization ranges indexed by the block mode's high precision bit and range selector
+     */
+    constexpr std::array<std::array<IseRange, 8>, 2> WeightRanges{{
+        {{{}, {}, {0, 0, 1}, {1, 0, 0}, {0, 0, 2}, {0, 1, 0}, {1, 0, 1}, {0, 0, 3}}},
+        {{{}, {}, {0, 1, 1}, {1, 0, 2}, {0, 0, 4}, {0, 1, 2}, {1, 0, 3}, {0, 0, 5}}},
+    }};
+
+    /**
+     * @brief A sequential reader over a region of a block, bits beyond the end of the region are read as zero
+     */
+    class BitReader {
+      private:
+        const Block &block;
+        uint32_t offset;
+        uint32_t end;
+
+      public:
+        BitReader(const Block &block, uint32_t offset, uint32_t size) : block{block}, offset{offset}, end{offset + size} {}
+
+        uint32_t Read(uint32_t count) {
+            uint32_t available{offset < end ? std::min(count, end - offset) : 0};
+            uint32_t value{block.Bits(offset, available)};
+            offset += count;
+            return value;
+        }
+    };
+
+    /**
+     * @brief Decodes a sequence of integer sequence encoded values into their trit/quint and bit components
+     */
+    void DecodeIse(const Block &block, uint32_t offset, uint32_t count, IseRange range, uint8_t *values, uint8_t *bits) {
+        BitReader reader{block, offset, range.EncodedBits(count)};
+        uint32_t mask{(1U << range.bits) - 1};
+
+        if (range.trits) {
+            for (uint32_t i{}; i < count; i += 5) {
+                std::array<uint32_t, 5> m{};
+                uint32_t t{};
+                m[0] = reader.Read(range.bits);
+                t |= reader.Read(2);
+                m[1] = reader.Read(range.bits);
+                t |= reader.Read(2) << 2;
+                m[2] = reader.Read(range.bits);
+                t |= reader.Read(1) << 4;
+                m[3] = reader.Read(range.bits);
+                t |= reader.Read(2) << 5;
+                m[4] = reader.Read(range.bits);
+                t |= reader.Read(1) << 7;
+
+                std::array<uint32_t, 5> trits;
+                uint32_t c;
+                if (((t >> 2) & 7) == 7) {
+                    c = ((t >> 5) << 2) | (t & 3);
+                    trits[4] = trits[3] = 2;
+                } else {
+                    c = t & 0x1F;
+                    if (((t >> 5) & 3) == 3) {
+                        trits[4] = 2;
+                        trits[3] = (t >> 7) & 1;
+                    } else {
+                        trits[4] = (t >> 7) & 1;
+                        trits[3] = (t >> 5) & 3;
+                    }
+                }
+
+                if ((c & 3) == 3) {
+                    trits[2] = 2;
+                    trits[1] = (c >> 4) & 1;
+                    trits[0] = (((c >> 3) & 1) << 1) | (((c >> 2) & 1) & ~((c >> 3) & 1));
+                } else if (((c >> 2) & 3) == 3) {
+                    trits[2] = 2;
+                    trits[1] = 2;
+                    trits[0] = c & 3;
+                } else {
+                    trits[2] = (c >> 4) & 1;
+                    trits[1] = (c >> 2) & 3;
+                    trits[0] = (((c >> 1) & 1) << 1) | ((c & 1) & ~((c >> 1) & 1));
+                }
+
+                for (uint32_t j{}; j < 5 && i + j < count; j++) {
+                    values[i + j] = static_cast<uint8_t>(trits[j]);
+                    bits[i + j] = static_cast<uint8_t>(m[j] & mask);
+                }
+            }
+        } else if (range.quints) {
+            for (uint32_t i{}; i < count; i += 3) {
+                std::array<uint32_t, 3> m{};
+                uint32_t q{};
+                m[0] = reader.Read(range.bits);
+                q |= reader.Read(3);
+                m[1] = reader.Read(range.bits);
+                q |= reader.Read(2) << 3;
+                m[2] = reader.Read(range.bits);
+                q |= reader.Read(2) << 5;
+
+                std::array<uint32_t, 3> quints;
+                if (((q >> 1) & 3) == 3 && ((q >> 5) & 3) == 0) {
+                    uint32_t q0{q & 1}, notQ0{q0 ^ 1};
+                    quints[2] = (q0 << 2) | ((((q >> 4) & 1) & notQ0) << 1) | (((q >> 3) & 1) & notQ0);
+                    quints[1] = quints[0] = 4;
+                } else {
+                    uint32_t c;
+                    if (((q >> 1) & 3) == 3) {
+                        quints[2] = 4;
+                        c = (((q >> 3) & 3) << 3) | ((~(q >> 5) & 3) << 1) | (q & 1);
+                    } else {
+                        quints[2] = (q >> 5) & 3;
+                        c = q & 0x1F;
+                    }
+
+                    if ((c & 7) == 5) {
+                        quints[1] = 4;
+                        quints[0] = (c >> 3) & 3;
+                    } else {
+                        quints[1] = (c >> 3) & 3;
+                        quints[0] = c & 7;
+                    }
+                }
+
+                for (uint32_t j{}; j < 3 && i + j < count; j++) {
+                    values[i + j] = static_cast<uint8_t>(quints[j]);
+                    bits[i + j] = static_cast<uint8_t>(m[j] & mask);
+                }
+            }
+        } else {
+            for (uint32_t i{}; i < count; i++) {
+                values[i] = 0;
+                bits[i] = static_cast<uint8_t>(reader.Read(range.bits));
+            }
+        }
+    }
+
+    /**
+     * @return The value replicated from the supplied bit count to fill the target bit count
+     */
+    constexpr uint32_t ReplicateBits(uint32_t value, uint32_t bits, uint32_t targetBits) {
+        if (bits == 0)
+            return 0;
+
+        uint32_t result{};
+        int32_t shift{static_cast<int32_t>(targetBits - bits)};
+        for (; shift > 0; shift -= static_cast<int32_t>(bits))
+            result |= value << shift;
+        return result | (value >> -shift);
+    }
+
+    /**
+     * @return The color endpoint value unquantized to the 0-255 range
+     */
+    uint32_t UnquantizeColor(IseRange range, uint32_t value, uint32_t m) {
+        if (!range.trits && !range.quints)
+            return ReplicateBits(m, range.bits, 8);
+
+        uint32_t a{(m & 1) ? 0x1FFU : 0U}, b{}, c{};
+        if (range.trits) {
+            switch (range.bits) {
+                case 1:
+                    c = 204;
+                    break;
+                case 2: {
+                    uint32_t x{(m >> 1) & 1};
+                    b = (x << 8) | (x << 4) | (x << 2) | (x << 1);
+                    c = 93;
+                    break;
+                }
+                case 3: {
+                    uint32_t x{(m >> 1) & 3};
+                    b = (x << 7) | (x << 2) | x;
+                    c = 44;
+                    break;
+                }
+                case 4: {
+                    uint32_t x{(m >> 1) & 7};
+                    b = (x << 6) | x;
+                    c = 22;
+                    break;
+                }
+                case 5: {
+                    uint32_t x{(m >> 1) & 0xF};
+                    b = (x << 5) | (x >> 2);
+                    c = 11;
+                    break;
+                }
+                case 6: {
+                    uint32_t x{(m >> 1) & 0x1F};
+                    b = (x << 4) | (x >> 4);
+                    c = 5;
+                    break;
+                }
+            }
+        } else {
+            switch (range.bits) {
+                case 1:
+                    c = 113;
+                    break;
+                case 2: {
+                    uint32_t x{(m >> 1) & 1};
+                    b = (x << 8) | (x << 3) | (x << 2);
+                    c = 54;
+                    break;
+                }
+                case 3: {
+                    uint32_t x{(m >> 1) & 3};
+                    b = (x << 7) | (x << 1) | (x >> 1);
+                    c = 26;
+                    break;
+                }
+                case 4: {
+                    uint32_t x{(m >> 1) & 7};
+                    b = (x << 6) | (x >> 1);
+                    c = 13;
+                    break;
+                }
+                case 5: {
+                    uint32_t x{(m >> 1) & 0xF};
+                    b = (x << 5) | (x >> 3);
+                    c = 6;
+                    break;
+                }
+            }
+        }
+
+        uint32_t t{(value * c + b) ^ a};
+        return (a & 0x80) | (t >> 2);
+    }
+
+    /**
+     * @return The weight value unquantized to the 0-64 range
+     */
+    uint32_t UnquantizeWeight(IseRange range, uint32_t value, uint32_t m) {
+        uint32_t result;
+        if (!range.trits && !range.quints) {
+            result = ReplicateBits(m, range.bits, 6);
+        } else if (range.bits == 0) {
+            constexpr std::array<uint8_t, 3> TritWeights{0, 32, 63};
+            constexpr std::array<uint8_t, 5> QuintWeights{0, 16, 32, 47, 63};
+            result = range.trits ? TritWeights[value] : QuintWeights[value];
+        } else {
+            uint32_t a{(m & 1) ? 0x7FU : 0U}, b{}, c{};
+            if (range.trits) {
+                switch (range.bits) {
+                    case 1:
+                        c = 50;
+                        break;
+                    case 2: {
+                        uint32_t x{(m >> 1) & 1};
+                        b = (x << 6) | (x << 2) | x;
+                        c = 23;
+                        break;
+                    }
+                    case 3: {
+                        uint32_t x{(m >> 1) & 3};
+                        b = (x << 5) | x;
+                        c = 11;
+                        break;
+                    }
+                }
+            } else {
+                switch (range.bits) {
+                    case 1:
+                        c = 28;
+                        break;
+                    case 2: {
+                        uint32_t x{(m >> 1) & 1};
+                        b = (x << 6) | (x << 1);
+                        c = 13;
+                        break;
+                    }
+                }
+            }
+
+            uint32_t t{(value * c + b) ^ a};
+            result = (a & 0x20) | (t >> 2);
+        }
+
+        return result > 32 ? result + 1 : result;
+    }
+
+    uint32_t Hash52(uint32_t p) {
+        p ^= p >> 15;
+        p -= p << 17;
+        p += p << 7;
+        p += p << 4;
+        p ^= p >> 5;
+        p += p << 16;
+        p ^= p >> 7;
+        p ^= p >> 3;
+        p ^= p << 6;
+        p ^= p >> 17;
+        return p;
+    }
+
+    /**
+     * @return The partition which the texel at the supplied coordinates within the block belongs to
+     */
+    uint32_t SelectPartition(uint32_t seed, uint32_t x, uint32_t y, uint32_t partitionCount, bool smallBlock) {
+        if (smallBlock) {
+            x <<= 1;
+            y <<= 1;
+        }
+
+        seed += (partitionCount - 1) * 1024;
+        uint32_t rnum{Hash52(seed)};
+
+        std::array<uint32_t, 8> seeds;
+        for (uint32_t i{}; i < seeds.size(); i++) {
+            uint32_t value{(rnum >> (i * 4)) & 0xF};
+            seeds[i] = value * value;
+        }
+
+        uint32_t sh1, sh2;
+        if (seed & 1) {
+            sh1 = (seed & 2) ? 4 : 5;
+            sh2 = (partitionCount == 3) ? 6 : 5;
+        } else {
+            sh1 = (partitionCount == 3) ? 6 : 5;
+            sh2 = (seed & 2) ? 4 : 5;
+        }
+
+        for (uint32_t i{}; i < seeds.size(); i++)
+            seeds[i] >>= (i & 1) ? sh2 : sh1;
+
+        // The Z-axis seeds are omitted as only 2D blocks are supported, they'd always be multiplied by zero
+        uint32_t a{(seeds[0] * x + seeds[1] * y + (rnum >> 14)) & 0x3F};
+        uint32_t b{(seeds[2] * x + seeds[3] * y + (rnum >> 10)) & 0x3F};
+        uint32_t c{partitionCount < 3 ? 0 : (seeds[4] * x + seeds[5] * y + (rnum >> 6)) & 0x3F};
+        uint32_t d{partitionCount < 4 ? 0 : (seeds[6] * x + seeds[7] * y + (rnum >> 2)) & 0x3F};
+
+        if (a >= b && a >= c && a >= d)
+            return 0;
+        else if (b >= c && b >= d)
+            return 1;
+        else if (c >= d)
+            return 2;
+        else
+            return 3;
+    }
+
+    using Color = std::array<int32_t, 4>;
+
+    int32_t Clamp(int32_t value) {
+        return std::clamp(value, 0, 255);
+    }
+
+    void BitTransferSigned(int32_t &a, int32_t &b) {
+        b >>= 1;
+        b |= a & 0x80;
+        a >>= 1;
+        a &= 0x3F;
+        if (a & 0x20)
+            a -= 0x40;
+    }
+
+    Color BlueContract(int32_t r, int32_t g, int32_t b, int32_t a) {
+        return {(r + b) >> 1, (g + b) >> 1, b, a};
+    }
+
+    /**
+     * @brief Decodes the endpoints of a single partition from the unquantized color values
+     * @return If the endpoint mode is an LDR mode, HDR modes cannot be decoded by an LDR decoder and are treated as errors
+     */
+    bool DecodeEndpoints(uint32_t mode, const int32_t *values, Color &e0, Color &e1) {
+        std::array<int32_t, 8> v;
+        std::copy_n(values, ((mode >> 2) + 1) * 2, v.begin());
+
+        switch (mode) {
+            case 0: // LDR Luminance, Direct
+                e0 = {v[0], v[0], v[0], 0xFF};
+                e1 = {v[1], v[1], v[1], 0xFF};
+                return true;
+
+            case 1: { // LDR Luminance, Base + Offset
+                int32_t l0{(v[0] >> 2) | (v[1] & 0xC0)};
+                int32_t l1{std::min(l0 + (v[1] & 0x3F), 0xFF)};
+                e0 = {l0, l0, l0, 0xFF};
+                e1 = {l1, l1, l1, 0xFF};
+                return true;
+            }
+
+            case 4: // LDR Luminance + Alpha, Direct
+                e0 = {v[0], v[0], v[0], v[2]};
+                e1 = {v[1], v[1], v[1], v[3]};
+                return true;
+
+            case 5: // LDR Luminance + Alpha, Base + Offset
+                BitTransferSigned(v[1], v[0]);
+                BitTransferSigned(v[3], v[2]);
+                e0 = {v[0], v[0], v[0], v[2]};
+                e1 = {Clamp(v[0] + v[1]), Clamp(v[0] + v[1]), Clamp(v[0] + v[1]), Clamp(v[2] + v[3])};
+                return true;
+
+            case 6: // LDR RGB, Base + Scale
+                e0 = {(v[0] * v[3]) >> 8, (v[1] * v[3]) >> 8, (v[2] * v[3]) >> 8, 0xFF};
+                e1 = {v[0], v[1], v[2], 0xFF};
+                return true;
+
+            case 8: // LDR RGB, Direct
+                if (v[1] + v[3] + v[5] >= v[0] + v[2] + v[4]) {
+                    e0 = {v[0], v[2], v[4], 0xFF};
+                    e1 = {v[1], v[3], v[5], 0xFF};
+                } else {
+                    e0 = BlueContract(v[1], v[3], v[5], 0xFF);
+                    e1 = BlueContract(v[0], v[2], v[4], 0xFF);
+                }
+                return true;
+
+            case 9: // LDR RGB, Base + Offset
+                BitTransferSigned(v[1], v[0]);
+                BitTransferSigned(v[3], v[2]);
+                BitTransferSigned(v[5], v[4]);
+                if (v[1] + v[3] + v[5] >= 0) {
+                    e0 = {v[0], v[2], v[4], 0xFF};
+                    e1 = {Clamp(v[0] + v[1]), Clamp(v[2] + v[3]), Clamp(v[4] + v[5]), 0xFF};
+                } else {
+                    e0 = BlueContract(Clamp(v[0] + v[1]), Clamp(v[2] + v[3]), Clamp(v[4] + v[5]), 0xFF);
+                    e1 = BlueContract(v[0], v[2], v[4], 0xFF);
+                }
+                return true;
+
+            case 10: // LDR RGB, Base + Scale plus two A
+                e0 = {(v[0] * v[3]) >> 8, (v[1] * v[3]) >> 8, (v[2] * v[3]) >> 8, v[4]};
+                e1 = {v[0], v[1], v[2], v[5]};
+                return true;
+
+            case 12: // LDR RGBA, Direct
+                if (v[1] + v[3] + v[5] >= v[0] + v[2] + v[4]) {
+                    e0 = {v[0], v[2], v[4], v[6]};
+                    e1 = {v[1], v[3], v[5], v[7]};
+                } else {
+                    e0 = BlueContract(v[1], v[3], v[5], v[7]);
+                    e1 = BlueContract(v[0], v[2], v[4], v[6]);
+                }
+                return true;
+
+            case 13: // LDR RGBA, Base + Offset
+                BitTransferSigned(v[1], v[0]);
+                BitTransferSigned(v[3], v[2]);
+                BitTransferSigned(v[5], v[4]);
+                BitTransferSigned(v[7], v[6]);
+                if (v[1] + v[3] + v[5] >= 0) {
+                    e0 = {v[0], v[2], v[4], v[6]};
+                    e1 = {Clamp(v[0] + v[1]), Clamp(v[2] + v[3]), Clamp(v[4] + v[5]), Clamp(v[6] + v[7])};
+                } else {
+                    e0 = BlueContract(Clamp(v[0] + v[1]), Clamp(v[2] + v[3]), Clamp(v[4] + v[5]), Clamp(v[6] + v[7]));
+                    e1 = BlueContract(v[0], v[2], v[4], v[6]);
+                }
+                return true;
+
+            default: // HDR endpoint modes (2, 3, 7, 11, 14, 15)
+                return false;
+        }
+    }
+
+    struct BlockMode {
+        uint32_t gridWidth;
+        uint32_t gridHeight;
+        bool dualPlane;
+        IseRange weightRange;
+    };
+
+    /**
+     * @brief Decodes the 11-bit block mode field into the dimensions of the weight grid and its quantization
+     * @return If the block mode isn't a reserved encoding
+     */
+    bool DecodeBlockMode(uint32_t mode, BlockMode &result) {
+        uint32_t r, a{(mode >> 5) & 3}, b;
+        bool highPrecision{static_cast<bool>((mode >> 9) & 1)}, dualPlane{static_cast<bool>((mode >> 10) & 1)};
+
+        if (mode & 3) {
+            r = ((mode >> 4) & 1) | ((mode & 3) << 1);
+            b = (mode >> 7) & 3;
+            switch ((mode >> 2) & 3) {
+                case 0:
+                    result.gridWidth = b + 4;
+                    result.gridHeight = a + 2;
+                    break;
+                case 1:
+                    result.gridWidth = b + 8;
+                    result.gridHeight = a + 2;
+                    break;
+                case 2:
+                    result.gridWidth = a + 2;
+                    result.gridHeight = b + 8;
+                    break;
+                case 3:
+                    b &= 1;
+                    if ((mode >> 8) & 1) {
+                        result.gridWidth = b + 2;
+                        result.gridHeight = a + 2;
+                    } else {
+                        result.gridWidth = a + 2;
+                        result.gridHeight = b + 6;
+                    }
+                    break;
+            }
+        } else {
+            r = ((mode >> 4) & 1) | (((mode >> 2) & 3) << 1);
+            if ((mode & 0xF) == 0)
+                return false;
+
+            b = (mode >> 9) & 3;
+            switch ((mode >> 7) & 3) {
+                case 0:
+                    result.gridWidth = 12;
+                    result.gridHeight = a + 2;
+                    break;
+                case 1:
+                    result.gridWidth = a + 2;
+                    result.gridHeight = 12;
+                    break;
+                case 2:
+                    result.gridWidth = a + 6;
+                    result.gridHeight = b + 6;
+                    highPrecision = false;
+                    dualPlane = false;
+                    break;
+                case 3:
+                    if (a == 0) {
+                        result.gridWidth = 6;
+                        result.gridHeight = 10;
+                    } else if (a == 1) {
+                        result.gridWidth = 10;
+                        result.gridHeight = 6;
+                    } else {
+                        return false;
+                    }
+                    break;
+            }
+        }
+
+        if (r < 2)
+            return false;
+
+        result.dualPlane = dualPlane;
+        result.weightRange = WeightRanges[highPrecision][r];
+        return true;
+    }
+
+    void FillColor(uint8_t *texels, size_t texelCount, const std::array<uint8_t, 4> &color) {
+        for (size_t i{}; i < texelCount; i++)
+            std::memcpy(texels + i * R8g8b8a8Bpp, color.data(), R8g8b8a8Bpp);
+    }
+
+    /**
+     * @brief Decodes a single block into an array of R8G8B8A8 texels with a pitch of the block width
+     */
+    void DecodeBlock(const Block &block, uint8_t *texels, uint32_t blockWidth, uint32_t blockHeight, bool isSrgb) {
+        uint32_t texelCount{blockWidth * blockHeight};
+
+        // Void-extent blocks encode a single constant color for the entire block
+        if (block.Bits(0, 9) == 0x1FC) {
+            if (block.Bits(9, 1)) {
+                FillColor(texels, texelCount, ErrorColor);
+                return;
+            }
+
+            std::array<uint8_t, 4> color;
+            for (uint32_t channel{}; channel < 4; channel++)
+                color[channel] = static_cast<uint8_t>(block.Bits(64 + channel * 16, 16) >> 8);
+            FillColor(texels, texelCount, color);
+            return;
+        }
+
+        BlockMode mode;
+        if (!DecodeBlockMode(block.Bits(0, 11), mode) || mode.gridWidth > blockWidth || mode.gridHeight > blockHeight) {
+            FillColor(texels, texelCount, ErrorColor);
+            return;
+        }
+
+        uint32_t planeCount{mode.dualPlane ? 2U : 1U};
+        uint32_t weightCount{mode.gridWidth * mode.gridHeight * planeCount};
+        uint32_t weightBits{mode.weightRange.EncodedBits(weightCount)};
+        uint32_t partitionCount{block.Bits(11, 2) + 1};
+        if (weightCount > MaxWeightCount || weightBits < 24 || weightBits > 96 || (mode.dualPlane && partitionCount == 4)) {
+            FillColor(texels, texelCount, ErrorColor);
+            return;
+        }
+
+        // Determine the color endpoint mode of each partition, multi-partition blocks may store additional mode bits below the weights
+        std::array<uint32_t, 4> endpointModes{};
+        uint32_t colorOffset, extraModeBits{}, partitionSeed{};
+        if (partitionCount == 1) {
+            endpointModes[0] = block.Bits(13, 4);
+            colorOffset = 17;
+        } else {
+            partitionSeed = block.Bits(13, 10);
+            colorOffset = 29;
+
+            uint32_t modeBits{block.Bits(23, 6)};
+            uint32_t selector{modeBits & 3};
+            if (selector == 0) {
+                for (uint32_t i{}; i < partitionCount; i++)
+                    endpointModes[i] = modeBits >> 2;
+            } else {
+                extraModeBits = (3 * partitionCount) - 4;
+                uint32_t encoded{(modeBits >> 2) | (block.Bits(128 - weightBits - extraModeBits, extraModeBits) << 4)};
+                uint32_t baseClass{selector - 1};
+                for (uint32_t i{}; i < partitionCount; i++) {
+                    uint32_t classOffset{(encoded >> i) & 1};
+                    uint32_t modeValue{(encoded >> (partitionCount + i * 2)) & 3};
+                    endpointModes[i] = ((baseClass + classOffset) << 2) | modeValue;
+                }
+            }
+        }
+
+        uint32_t colorValueCount{};
+        for (uint32_t i{}; i < partitionCount; i++)
+            colorValueCount += ((endpointModes[i] >> 2) + 1) * 2;
+
+        uint32_t ccsOffset{128 - weightBits - extraModeBits - (mode.dualPlane ? 2U : 0U)};
+        uint32_t colorBits{ccsOffset - colorOffset};
+        if (colorValueCount > MaxColorValueCount || ccsOffset < colorOffset || colorBits < (13 * colorValueCount + 4) / 5) {
+            FillColor(texels, texelCount, ErrorColor);
+            return;
+        }
+
+        auto colorRange{std::find_if(ColorRanges.begin(), ColorRanges.end(), [&](const IseRange &range) { return range.EncodedBits(colorValueCount) <= colorBits; })};
+        if (colorRange == ColorRanges.end()) {
+            FillColor(texels, texelCount, ErrorColor);
+            return;
+        }
+
+        std::array<uint8_t, MaxColorValueCount> colorValues, colorBitValues;
+        DecodeIse(block, colorOffset, colorValueCount, *colorRange, colorValues.data(), colorBitValues.data());
+
+        std::array<int32_t, MaxColorValueCount> colors;
+        for (uint32_t i{}; i < colorValueCount; i++)
+            colors[i] = static_cast<int32_t>(UnquantizeColor(*colorRange, colorValues[i], colorBitValues[i]));
+
+        // Endpoints are expanded to 16 bits prior to interpolation, sRGB formats use a different expansion to preserve the precision of the conversion
+        std::array<std::array<Color, 2>, 4> endpoints;
+        for (uint32_t i{}, colorIndex{}; i < partitionCount; colorIndex += ((endpointModes[i] >> 2) + 1) * 2, i++) {
+            if (!DecodeEndpoints(endpointModes[i], colors.data() + colorIndex, endpoints[i][0], endpoints[i][1])) {
+                FillColor(texels, texelCount, ErrorColor);
+                return;
+            }
+
+            for (auto &endpoint : endpoints[i])
+                for (auto &channel : endpoint)
+                    channel = isSrgb ? ((channel << 8) | 0x80) : ((channel << 8) | channel);
+        }
+
+        std::array<uint8_t, MaxWeightCount> weightValues, weightBitValues;
+        DecodeIse(block.Reversed(), 0, weightCount, mode.weightRange, weightValues.data(), weightBitValues.data());
+
+        std::array<uint8_t, MaxWeightCount + 2 * (MaxBlockDimension + 1)> weights{}; // Padded so the infill can read one row and column beyond the grid without bounds checks, those are always weighted by zero
+        for (uint32_t i{}; i < weightCount; i++)
+            weights[i] = static_cast<uint8_t>(UnquantizeWeight(mode.weightRange, weightValues[i], weightBitValues[i]));
+
+        uint32_t ccs{mode.dualPlane ? block.Bits(ccsOffset, 2) : 4};
+        bool smallBlock{texelCount < 31};
+        uint32_t scaleS{(1024 + blockWidth / 2) / (blockWidth - 1)}, scaleT{(1024 + blockHeight / 2) / (blockHeight - 1)};
+
+        for (uint32_t t{}; t < blockHeight; t++) {
+            uint32_t gt{((scaleT * t) * (mode.gridHeight - 1) + 32) >> 6};
+            uint32_t jt{gt >> 4}, ft{gt & 0xF};
+
+            for (uint32_t s{}; s < blockWidth; s++) {
+                uint32_t gs{((scaleS * s) * (mode.gridWidth - 1) + 32) >> 6};
+                uint32_t js{gs >> 4}, fs{gs & 0xF};
+
+                uint32_t w11{(fs * ft + 8) >> 4}, w10{ft - w11}, w01{fs - w11}, w00{16 - fs - ft + w11};
+                uint32_t v0{js + jt * mode.gridWidth};
+
+                std::array<uint32_t, 2> texelWeights{};
+                for (uint32_t plane{}; plane < planeCount; plane++) {
+                    auto weight{[&](uint32_t index) -> uint32_t { return weights[index * planeCount + plane]; }};
+                    texelWeights[plane] = (weight(v0) * w00 + weight(v0 + 1) * w01 + weight(v0 + mode.gridWidth) * w10 + weight(v0 + mode.gridWidth + 1) * w11 + 8) >> 4;
+                }
+
+                uint32_t partition{partitionCount > 1 ? SelectPartition(partitionSeed, s, t, partitionCount, smallBlock) : 0};
+                const auto &[e0, e1]{endpoints[partition]};
+                uint8_t *texel{texels + (t * blockWidth + s) * R8g8b8a8Bpp};
+                for (uint32_t channel{}; channel < 4; channel++) {
+                    int32_t weight{static_cast<int32_t>(texelWeights[channel == ccs ? 1 : 0])};
+                    texel[channel] = static_cast<uint8_t>(((e0[channel] * (64 - weight) + e1[channel] * weight + 32) >> 6) >> 8);
+                }
+            }
+        }
+    }
+}
+
+namespace astc {
+    void DecodeAstc(const uint8_t *src, uint8_t *dst, size_t width, size_t height, size_t blockWidth, size_t blockHeight, bool isSrgb) {
+        std::array<uint8_t, MaxBlockDimension * MaxBlockDimension * R8g8b8a8Bpp> texels;
+        size_t pitch{R8g8b8a8Bpp * width};
+        for (size_t y{}; y < height; y += blockHeight, dst += blockHeight * pitch) {
+            size_t rowCount{std::min(blockHeight, height - y)};
+            uint8_t *dstRow{dst};
+            for (size_t x{}; x < width; x += blockWidth, src += sizeof(Block), dstRow += blockWidth * R8g8b8a8Bpp) {
+                Block block;
+                std::memcpy(&block, src, sizeof(Block));
+                DecodeBlock(block, texels.data(), static_cast<uint32_t>(blockWidth), static_cast<uint32_t>(blockHeight), isSrgb);
+
+                // Blocks on the right and bottom edges may extend beyond the image, only the texels within it are written
+                size_t columnSize{std::min(blockWidth, width - x) * R8g8b8a8Bpp};
+                for (size_t row{}; row < rowCount; row++)
+                    std::memcpy(dstRow + row * pitch, texels.data() + row * blockWidth * R8g8b8a8Bpp, columnSize);
+            }
+        }
+    }
+}
@@ -0,0 +1,16 @@
+// SPDX-License-Identifier: MPL-2.0
+// Copyright © 2023 Skyline Team and Contributors (https://github.com/skyline-emu/)
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace astc {
+    /**
+     * @brief Decodes an ASTC LDR encoded image to R8G8B8A8
+     * @param isSrgb If the endpoints should be expanded as specified for sRGB formats, the output is not linearized and should be written into an sRGB image
+     * @note Blocks using HDR endpoint modes or any reserved encodings are decoded as opaque magenta as specified for LDR decoders
+     */
+    void DecodeAstc(const uint8_t *src, uint8_t *dst, size_t width, size_t height, size_t blockWidth, size_t blockHeight, bool isSrgb);
+}
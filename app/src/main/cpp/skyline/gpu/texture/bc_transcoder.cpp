@@ -0,0 +1,154 @@
+// SPDX-License-Identifier: MPL-2.0
+// Copyright © 2023 Skyline Team and Contributors (https://github.com/skyline-emu/)
+
+#include <algorithm>
+#include <array>
+#include <cstring>
+#include <limits>
+#include "bc_transcoder.h"
+
+namespace {
+    constexpr size_t BlockSize{8}; //!< The size of a single BC4 or EAC R11 block in bytes, both cover 4x4 texels
+
+    /**
+     * @brief The modifier tables shared by ETC2 alpha and EAC, each block selects one and scales it by a multiplier
+     */
+    constexpr std::array<std::array<int32_t, 8>, 16> EacModifierTables{{
+        {-3, -6, -9, -15, 2, 5, 8, 14},
+        {-3, -7, -10, -13, 2, 6, 9, 12},
+        {-2, -5, -8, -13, 1, 4, 7, 12},
+        {-2, -4, -6, -13, 1, 3, 5, 12},
+        {-3, -6, -8, -12, 2, 5, 7, 11},
+        {-3, -7, -9, -11, 2, 6, 8, 10},
+        {-4, -7, -8, -11, 3, 6, 7, 10},
+        {-3, -5, -8, -11, 2, 4, 7, 10},
+        {-2, -6, -8, -10, 1, 5, 7, 9},
+        {-2, -5, -8, -10, 1, 4, 7, 9},
+        {-2, -4, -8, -10, 1, 3, 7, 9},
+        {-2, -5, -7, -10, 1, 4, 6, 9},
+        {-3, -4, -7, -10, 2, 3, 6, 9},
+        {-1, -2, -3, -10, 0, 1, 2, 9},
+        {-4, -6, -8, -9, 3, 5, 7, 8},
+        {-3, -5, -7, -9, 2, 4, 6, 8},
+    }};
+
+    /**
+     * @return The 11-bit value that an EAC codeword decodes to, this is in the range [0, 2047] for unsigned and [-1023, 1023] for signed blocks
+     */
+    int32_t DecodeEacValue(int32_t base, int32_t multiplier, int32_t modifier, bool isSigned) {
+        if (isSigned)
+            return std::clamp(base * 8 + modifier * multiplier * 8, -1023, 1023);
+        else
+            return std::clamp(base * 8 + 4 + modifier * multiplier * 8, 0, 2047);
+    }
+
+    /**
+     * @brief Transcodes a single BC4 block into an EAC R11 block
+     * @details BC4 blocks only contain 8 distinct values so the search for the best EAC encoding is performed over the palette weighted by the amount of texels using each entry rather than over the texels themselves
+     */
+    void TranscodeBlock(const uint8_t *src, uint8_t *dst, bool isSigned) {
+        uint64_t data;
+        std::memcpy(&data, src, sizeof(data));
+
+        // Decode the BC4 palette and expand it to the 11-bit range of EAC
+        std::array<int32_t, 8> palette;
+        if (isSigned) {
+            palette[0] = std::max<int32_t>(static_cast<int8_t>(data & 0xFF), -127);
+            palette[1] = std::max<int32_t>(static_cast<int8_t>((data >> 8) & 0xFF), -127);
+        } else {
+            palette[0] = static_cast<int32_t>(data & 0xFF);
+            palette[1] = static_cast<int32_t>((data >> 8) & 0xFF);
+        }
+
+        if (palette[0] > palette[1]) {
+            for (int32_t i{2}; i < 8; i++)
+                palette[i] = ((8 - i) * palette[0] + (i - 1) * palette[1]) / 7;
+        } else {
+            for (int32_t i{2}; i < 6; i++)
+                palette[i] = ((6 - i) * palette[0] + (i - 1) * palette[1]) / 5;
+            palette[6] = isSigned ? -127 : 0;
+            palette[7] = isSigned ? 127 : 255;
+        }
+
+        for (auto &value : palette)
+            value = isSigned ? (value * 1023 + (value < 0 ? -63 : 63)) / 127 : (value << 3) | (value >> 5);
+
+        std::array<uint8_t, 16> texelIndices;
+        std::array<int32_t, 8> paletteUsage{};
+        int32_t minimum{std::numeric_limits<int32_t>::max()}, maximum{std::numeric_limits<int32_t>::min()};
+        for (size_t i{}; i < texelIndices.size(); i++) {
+            auto index{static_cast<uint8_t>((data >> (16 + i * 3)) & 0x7)};
+            texelIndices[i] = index;
+            paletteUsage[index]++;
+            minimum = std::min(minimum, palette[index]);
+            maximum = std::max(maximum, palette[index]);
+        }
+
+        // Search every modifier table with the multiplier and base that best span the range of the block, the base is additionally nudged to counter rounding
+        int64_t bestError{std::numeric_limits<int64_t>::max()};
+        int32_t bestBase{}, bestMultiplier{}, bestTable{};
+        std::array<uint8_t, 8> bestSelectors{};
+        for (int32_t table{}; table < static_cast<int32_t>(EacModifierTables.size()); table++) {
+            const auto &modifiers{EacModifierTables[table]};
+            int32_t modifierSpan{modifiers[7] - modifiers[3]};
+            int32_t multiplier{std::clamp((maximum - minimum + modifierSpan * 4) / (modifierSpan * 8), 1, 15)};
+            int32_t centerBase{((minimum + maximum) / 2 - (isSigned ? 0 : 4) - (modifiers[3] + modifiers[7]) * multiplier * 4) / 8};
+
+            for (int32_t base{centerBase - 1}; base <= centerBase + 1; base++) {
+                int32_t clampedBase{isSigned ? std::clamp(base, -127, 127) : std::clamp(base, 0, 255)};
+
+                int64_t error{};
+                std::array<uint8_t, 8> selectors{};
+                for (size_t entry{}; entry < palette.size(); entry++) {
+                    if (!paletteUsage[entry])
+                        continue;
+
+                    int32_t entryError{std::numeric_limits<int32_t>::max()};
+                    for (uint8_t selector{}; selector < modifiers.size(); selector++) {
+                        int32_t difference{DecodeEacValue(clampedBase, multiplier, modifiers[selector], isSigned) - palette[entry]};
+                        if (difference * difference < entryError) {
+                            entryError = difference * difference;
+                            selectors[entry] = selector;
+                        }
+                    }
+                    error += static_cast<int64_t>(entryError) * paletteUsage[entry];
+                }
+
+                if (error < bestError) {
+                    bestError = error;
+                    bestBase = clampedBase;
+                    bestMultiplier = multiplier;
+                    bestTable = table;
+                    bestSelectors = selectors;
+                }
+            }
+
+            if (bestError == 0)
+                break;
+        }
+
+        // EAC blocks are stored big-endian with texels indexed in column-major order
+        uint64_t encoded{(static_cast<uint64_t>(static_cast<uint8_t>(bestBase)) << 56) | (static_cast<uint64_t>(bestMultiplier) << 52) | (static_cast<uint64_t>(bestTable) << 48)};
+        for (size_t y{}; y < 4; y++)
+            for (size_t x{}; x < 4; x++)
+                encoded |= static_cast<uint64_t>(bestSelectors[texelIndices[y * 4 + x]]) << (45 - (x * 4 + y) * 3);
+
+        for (size_t i{}; i < BlockSize; i++)
+            dst[i] = static_cast<uint8_t>(encoded >> (56 - i * 8));
+    }
+}
+
+namespace bcn {
+    void TranscodeBc4ToEac(const uint8_t *src, uint8_t *dst, size_t width, size_t height, bool isSigned) {
+        size_t blockCount{((width + 3) / 4) * ((height + 3) / 4)};
+        for (size_t block{}; block < blockCount; block++, src += BlockSize, dst += BlockSize)
+            TranscodeBlock(src, dst, isSigned);
+    }
+
+    void TranscodeBc5ToEac(const uint8_t *src, uint8_t *dst, size_t width, size_t height, bool isSigned) {
+        // BC5 and EAC R11G11 blocks are both a pair of single channel blocks for the red and green channels, these are transcoded independently
+        size_t blockCount{((width + 3) / 4) * ((height + 3) / 4) * 2};
+        for (size_t block{}; block < blockCount; block++, src += BlockSize, dst += BlockSize)
+            TranscodeBlock(src, dst, isSigned);
+    }
+}
@@ -0,0 +1,20 @@
+// SPDX-License-Identifier: MPL-2.0
+// Copyright © 2023 Skyline Team and Contributors (https://github.com/skyline-emu/)
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace bcn {
+    /**
+     * @brief Transcodes a BC4 encoded image to EAC R11, this retains the image compressed at the same size on hosts without BCn support
+     * @note The transcoding is lossy as EAC uses non-linear modifier tables rather than the linear palette of BC4, the error is small relative to the BC4 quantization itself
+     */
+    void TranscodeBc4ToEac(const uint8_t *src, uint8_t *dst, size_t width, size_t height, bool isSigned);
+
+    /**
+     * @brief Transcodes a BC5 encoded image to EAC R11G11
+     */
+    void TranscodeBc5ToEac(const uint8_t *src, uint8_t *dst, size_t width, size_t height, bool isSigned);
+}
@@ -116,6 +116,14 @@ namespace skyline::gpu::format {
                      .blockWidth = 4,
                      .blockHeight = 4,
     );
+    FORMAT_SUFF_NORM(EacR11, 64, eEacR11, Block,
+                     .blockWidth = 4,
+                     .blockHeight = 4,
+    );
+    FORMAT_SUFF_NORM(EacR11G11, 128, eEacR11G11, Block,
+                     .blockWidth = 4,
+                     .blockHeight = 4,
+    );
     FORMAT(Bc6HUfloat, 128, eBc6HUfloatBlock,
            .blockWidth = 4,
            .blockHeight = 4,
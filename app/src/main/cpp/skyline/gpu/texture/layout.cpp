@@ -1,6 +1,9 @@
 // SPDX-License-Identifier: MPL-2.0
 // Copyright © 2022 Skyline Team and Contributors (https://github.com/skyline-emu/)
 
+#ifdef __ARM_NEON
+#include <arm_neon.h>
+#endif
 #include "layout.h"
 
 namespace skyline::gpu::texture {
@@ -18,6 +21,72 @@ namespace skyline::gpu::texture {
     constexpr size_t GobHeight{8}; //!< The height of a GOB in lines
     constexpr size_t SectorLinesInGob{(GobWidth / SectorWidth) * GobHeight}; //!< The number of lines of sectors inside a GOB
 
+    #ifdef __ARM_NEON
+    /**
+     * @brief Copies a single GOB between its swizzled and pitch representation with NEON, moving entire 64-byte GOB lines at a time
+     * @note Every 64 bytes in the first half of a GOB hold the left half of two consecutive lines as interleaved sectors, the second half of the GOB holds their right half in the same arrangement
+     */
+    template<bool BlockLinearToPitch>
+    __attribute__((always_inline)) inline void CopyGobNeon(u8 *gob, u8 *pitchGob, size_t pitchWidthBytes) {
+        #pragma clang loop unroll(full)
+        for (size_t line{}; line < GobHeight; line += 2) {
+            u8 *leftHalf{gob + (line * (GobWidth / 2))}; //!< The sectors containing X-axis bytes [0, 32) of both lines
+            u8 *rightHalf{leftHalf + ((GobWidth * GobHeight) / 2)}; //!< The sectors containing X-axis bytes [32, 64) of both lines
+            u8 *evenLine{pitchGob + (line * pitchWidthBytes)};
+            u8 *oddLine{evenLine + pitchWidthBytes};
+
+            if constexpr (BlockLinearToPitch) {
+                uint8x16x4_t left{vld1q_u8_x4(leftHalf)}, right{vld1q_u8_x4(rightHalf)};
+                vst1q_u8_x4(evenLine, uint8x16x4_t{{left.val[0], left.val[2], right.val[0], right.val[2]}});
+                vst1q_u8_x4(oddLine, uint8x16x4_t{{left.val[1], left.val[3], right.val[1], right.val[3]}});
+            } else {
+                uint8x16x4_t even{vld1q_u8_x4(evenLine)}, odd{vld1q_u8_x4(oddLine)};
+                vst1q_u8_x4(leftHalf, uint8x16x4_t{{even.val[0], odd.val[0], even.val[1], odd.val[1]}});
+                vst1q_u8_x4(rightHalf, uint8x16x4_t{{even.val[2], odd.val[2], even.val[3], odd.val[3]}});
+            }
+        }
+    }
+
+    /**
+     * @brief Copies all non-padding GOBs of a single full block with NEON, the GOB block height is a template parameter so the Y-axis loop can be fully unrolled
+     * @note The layout of a GOB is in terms of bytes, this path is therefore shared by all formats and is only used for blocks that don't require any X-axis or Y-axis clipping
+     */
+    template<bool BlockLinearToPitch, size_t GobBlockHeight>
+    void CopyBlockNeon(u8 *&sector, u8 *pitchBlock, size_t depthSliceCount, size_t pitchWidthBytes, size_t gobYOffset, size_t gobZOffset) {
+        for (size_t gobZ{}; gobZ < depthSliceCount; gobZ++, pitchBlock += gobZOffset) {
+            u8 *pitchGob{pitchBlock};
+            #pragma clang loop unroll(full)
+            for (size_t gobY{}; gobY < GobBlockHeight; gobY++, pitchGob += gobYOffset, sector += GobWidth * GobHeight)
+                CopyGobNeon<BlockLinearToPitch>(sector, pitchGob, pitchWidthBytes);
+        }
+    }
+
+    using CopyBlockNeonFunction = void (*)(u8 *&, u8 *, size_t, size_t, size_t, size_t);
+
+    /**
+     * @return A NEON block copy function specialized for the supplied GOB block height or nullptr if there's none
+     */
+    template<bool BlockLinearToPitch>
+    CopyBlockNeonFunction GetCopyBlockNeon(size_t gobBlockHeight) {
+        switch (gobBlockHeight) {
+            case 1:
+                return &CopyBlockNeon<BlockLinearToPitch, 1>;
+            case 2:
+                return &CopyBlockNeon<BlockLinearToPitch, 2>;
+            case 4:
+                return &CopyBlockNeon<BlockLinearToPitch, 4>;
+            case 8:
+                return &CopyBlockNeon<BlockLinearToPitch, 8>;
+            case 16:
+                return &CopyBlockNeon<BlockLinearToPitch, 16>;
+            case 32:
+                return &CopyBlockNeon<BlockLinearToPitch, 32>;
+            default:
+                return nullptr;
+        }
+    }
+    #endif
+
     size_t GetBlockLinearLayerSize(Dimensions dimensions, size_t formatBlockWidth, size_t formatBlockHeight, size_t formatBpb, size_t gobBlockHeight, size_t gobBlockDepth) {
         size_t robLineWidth{util::DivideCeil<size_t>(dimensions.width, formatBlockWidth)}; //!< The width of the ROB in terms of format blocks
         size_t robLineBytes{util::AlignUp(robLineWidth * formatBpb, GobWidth)}; //!< The amount of bytes in a single block
@@ -130,6 +199,10 @@ namespace skyline::gpu::texture {
 
         u8 *sector{blockLinear};
 
+        #ifdef __ARM_NEON
+        CopyBlockNeonFunction copyBlockNeon{GetCopyBlockNeon<BlockLinearToPitch>(gobBlockHeight)}; //!< The NEON path for full blocks, the scalar path is used as a fallback when this is nullptr
+        #endif
+
         auto deswizzleRob{[&](u8 *pitchRob, auto isLastRob, size_t depthSliceCount, size_t blockPaddingY = 0, size_t blockExtentY = 0) {
             auto deswizzleBlock{[&](u8 *pitchBlock, auto copySector) __attribute__((always_inline)) {
                 for (size_t gobZ{}; gobZ < depthSliceCount; gobZ++) { // Every Block contains `depthSliceCount` slices, excluding padding
@@ -164,6 +237,19 @@ namespace skyline::gpu::texture {
             }};
 
             for (size_t block{}; block < robWidthBlocks; block++) { // Every ROB contains `surfaceWidthBlocks` blocks (excl. padding block)
+                #ifdef __ARM_NEON
+                if constexpr (!isLastRob) {
+                    if (copyBlockNeon) [[likely]] {
+                        copyBlockNeon(sector, pitchRob, depthSliceCount, pitchWidthBytes, gobYOffset, gobZOffset);
+                        if (depthSliceCount != gobBlockDepth) [[unlikely]]
+                            sector += blockPaddingZ;
+
+                        pitchRob += GobWidth;
+                        continue;
+                    }
+                }
+                #endif
+
                 deswizzleBlock(pitchRob, [&](u8 *linearSector, size_t) __attribute__((always_inline)) {
                     if constexpr (BlockLinearToPitch)
                         std::memcpy(linearSector, sector, SectorWidth);
@@ -6,10 +6,10 @@
 #include <kernel/types/KProcess.h>
 #include <common/trace.h>
 #include <common/settings.h>
+#include <common/performance_stats.h>
 #include "texture.h"
 #include "layout.h"
 #include "adreno_aliasing.h"
-#include "bc_decoder.h"
 #include "format.h"
 
 namespace skyline::gpu {
@@ -81,7 +81,14 @@ namespace skyline::gpu {
     Texture::TextureViewStorage::TextureViewStorage(vk::ImageViewType type, texture::Format format, vk::ComponentMapping mapping, vk::ImageSubresourceRange range, vk::raii::ImageView &&vkView) : type(type), format(format), mapping(mapping), range(range), vkView(std::move(vkView)) {}
 
     vk::ImageView TextureView::GetView() {
-        if (vkView)
+        if (!texture->transientIneligible)
+            texture->DisallowTransientBacking();
+
+        return GetAttachmentView();
+    }
+
+    vk::ImageView TextureView::GetAttachmentView() {
+        if (vkView && backingGeneration == texture->backingGeneration)
             return vkView;
 
         auto it{std::find_if(texture->views.begin(), texture->views.end(), [this](const Texture::TextureViewStorage &view) {
@@ -99,6 +106,7 @@ namespace skyline::gpu {
             it = texture->views.emplace(texture->views.end(), type, format, mapping, range, vk::raii::ImageView{texture->gpu.vkDevice, createInfo});
         }
 
+        backingGeneration = texture->backingGeneration;
         return vkView = *it->vkView;
     }
 
@@ -155,6 +163,64 @@ namespace skyline::gpu {
 
         // We can't just capture `this` in the lambda since the lambda could exceed the lifetime of the buffer
         std::weak_ptr<Texture> weakThis{weak_from_this()};
+        auto writeCallback{[weakThis] {
+            TRACE_EVENT("gpu", "Texture::WriteTrap");
+
+            auto texture{weakThis.lock()};
+            if (!texture)
+                return true;
+
+            std::unique_lock stateLock{texture->stateMutex, std::try_to_lock};
+            if (!stateLock)
+                return false;
+
+            if (texture->dirtyState != DirtyState::GpuDirty) {
+                texture->MarkCpuDirtyAll();
+                return true; // If the texture is already CPU dirty or we can transition it to being CPU dirty then we don't need to do anything
+            }
+
+            if (texture->accumulatedGuestWaitTime > SkipReadbackHackWaitTimeThreshold && *texture->gpu.state.settings->enableFastGpuReadbackHack && !texture->memoryFreed) {
+                texture->dirtyState = DirtyState::Clean;
+                return true;
+            }
+
+            std::unique_lock lock{*texture, std::try_to_lock};
+            if (!lock)
+                return false;
+
+            if (texture->cycle)
+                return false;
+
+            texture->SynchronizeGuest(true, true); // We need to assume the texture is dirty since we don't know what the guest is writing
+            return true;
+        }};
+
+        // Writes are only tracked at page granularity if they can be used to narrow down synchronization as they'd otherwise only add faults
+        nce::NCE::PageTrapCallback pageWriteCallback;
+        if (SupportsPartialSync()) {
+            cpuDirtySubresources.resize(util::DivideCeil<size_t>(static_cast<size_t>(levelCount) * layerCount, 64));
+            pageWriteCallback = [weakThis, writeCallback](span<u8> pages) {
+                TRACE_EVENT("gpu", "Texture::PageWriteTrap");
+
+                auto texture{weakThis.lock()};
+                if (!texture)
+                    return true;
+
+                std::unique_lock stateLock{texture->stateMutex, std::try_to_lock};
+                if (!stateLock)
+                    return false;
+
+                if (texture->dirtyState != DirtyState::GpuDirty) {
+                    // Only the subresources overlapping the written pages need to be synchronized to the host
+                    texture->MarkCpuDirtyRegion(pages);
+                    return true;
+                }
+
+                stateLock.unlock();
+                return writeCallback(); // The texture needs to be synchronized to the guest prior to the write, the entire texture will be treated as dirty by this
+            };
+        }
+
         trapHandle = gpu.state.nce->CreateTrap(mappings, [weakThis] {
             auto texture{weakThis.lock()};
             if (!texture)
@@ -209,41 +275,192 @@ namespace skyline::gpu {
 
             texture->SynchronizeGuest(false, true); // We can skip trapping since the caller will do it
             return true;
-        }, [weakThis] {
-            TRACE_EVENT("gpu", "Texture::WriteTrap");
+        }, writeCallback, pageWriteCallback);
 
-            auto texture{weakThis.lock()};
-            if (!texture)
-                return true;
+        SetupDirectImport();
+    }
 
-            std::unique_lock stateLock{texture->stateMutex, std::try_to_lock};
-            if (!stateLock)
-                return false;
+    bool Texture::SupportsPartialSync() {
+        // The mip layouts only describe the guest layout of block linear textures, textures that are decoded are always synchronized entirely
+        return guest->tileConfig.mode == texture::TileMode::Block && guest->format == format && guest->dimensions == dimensions && tiling == vk::ImageTiling::eOptimal && (levelCount > 1 || layerCount > 1);
+    }
 
-            if (texture->dirtyState != DirtyState::GpuDirty) {
-                texture->dirtyState = DirtyState::CpuDirty;
-                return true; // If the texture is already CPU dirty or we can transition it to being CPU dirty then we don't need to do anything
-            }
+    void Texture::MarkCpuDirtyRegion(span<u8> region) {
+        dirtyState = DirtyState::CpuDirty;
+        if (!cpuDirtySubresourcesValid)
+            return;
 
-            if (texture->accumulatedGuestWaitTime > SkipReadbackHackWaitTimeThreshold && *texture->gpu.state.settings->enableFastGpuReadbackHack && !texture->memoryFreed) {
-                texture->dirtyState = DirtyState::Clean;
-                return true;
+        // The offset of a guest address in the texture is its offset into the mirror which contains all guest mappings contiguously
+        auto guestLayerStride{guest->GetLayerStride()};
+        size_t mappingOffset{};
+        for (auto mapping : guest->mappings) {
+            auto start{std::max(region.data(), mapping.data())}, end{std::min(region.end().base(), mapping.end().base())};
+            if (start < end) {
+                size_t startOffset{mappingOffset + static_cast<size_t>(start - mapping.data())}, endOffset{startOffset + static_cast<size_t>(end - start)};
+                for (u32 layer{static_cast<u32>(startOffset / guestLayerStride)}; layer < layerCount && layer * guestLayerStride < endOffset; layer++) {
+                    size_t levelOffset{layer * guestLayerStride};
+                    for (u32 level{}; level < levelCount && levelOffset < endOffset; level++) {
+                        size_t levelEnd{levelOffset + mipLayouts[level].blockLinearSize};
+                        if (levelEnd > startOffset) {
+                            size_t subresource{(static_cast<size_t>(layer) * levelCount) + level};
+                            cpuDirtySubresources[subresource / 64] |= 1ULL << (subresource % 64);
+                        }
+                        levelOffset = levelEnd;
+                    }
+                }
             }
+            mappingOffset += mapping.size();
+        }
+    }
 
-            std::unique_lock lock{*texture, std::try_to_lock};
-            if (!lock)
-                return false;
+    void Texture::MarkCpuDirtyAll() {
+        dirtyState = DirtyState::CpuDirty;
+        cpuDirtySubresourcesValid = false;
+    }
 
-            if (texture->cycle)
-                return false;
+    void Texture::CollectTrackedCpuWrites() {
+        if (!trapHandle || cpuDirtySubresources.empty())
+            return;
 
-            texture->SynchronizeGuest(true, true); // We need to assume the texture is dirty since we don't know what the guest is writing
-            return true;
+        gpu.state.nce->CollectTrapWrites(*trapHandle, [this](span<u8> pages) {
+            // Any writes collected while GPU dirty were made prior to the texture being synchronized from the guest and have already been observed
+            if (dirtyState != DirtyState::GpuDirty)
+                MarkCpuDirtyRegion(pages);
         });
     }
 
+    void Texture::SetupDirectImport() {
+        // Only a single level and layer of a linear or pitch linear guest texture in the host format has a guest layout that can be expressed by a buffer image copy
+        if (!*gpu.state.settings->useDirectMemoryImport || !gpu.traits.SupportsDirectMemoryImport() || guest->format != format || levelCount != 1 || layerCount != 1 || dimensions.depth != 1)
+            return;
+
+        u32 rowLength{};
+        if (guest->tileConfig.mode == texture::TileMode::Pitch) {
+            if (guest->tileConfig.pitch % format->bpb)
+                return;
+
+            rowLength = (guest->tileConfig.pitch / format->bpb) * format->blockWidth;
+            if (rowLength < dimensions.width)
+                return;
+        } else if (guest->tileConfig.mode != texture::TileMode::Linear) {
+            return;
+        }
+
+        // The offset of a buffer image copy must be a multiple of both the texel block size and 4
+        auto offset{static_cast<vk::DeviceSize>(mirror.data() - alignedMirror.data())};
+        if (offset % format->bpb || offset % 4)
+            return;
+
+        try {
+            importedMirror.emplace(gpu.memory.ImportBuffer(alignedMirror));
+        } catch (const exception &e) {
+            Logger::Warn("Failed to import guest texture memory, falling back to staging: {}", e.what());
+            return;
+        }
+
+        importedMirrorOffset = offset;
+        importedMirrorRowLength = rowLength;
+    }
+
+    bool Texture::UseImportedMirror() {
+        // Linear host textures that can be mapped on the CPU are already synchronized without any staging
+        return importedMirror && (tiling == vk::ImageTiling::eOptimal || !std::holds_alternative<memory::Image>(backing));
+    }
+
+    bool Texture::IsUploadRedundant() {
+        if (!*gpu.state.settings->skipRedundantUploads)
+            return false;
+
+        TRACE_EVENT("gpu", "Texture::IsUploadRedundant");
+        u64 hash{XXH3_64bits(mirror.data(), mirror.size())};
+        // An undefined layout implies the backing has no defined contents regardless of the hash
+        bool redundant{hash == uploadHash && layout != vk::ImageLayout::eUndefined};
+        uploadHash = hash;
+        if (redundant)
+            trace::AddFrameCounter(trace::FrameCounter::RedundantUploads);
+        return redundant;
+    }
+
+    std::shared_ptr<memory::StagingBuffer> Texture::SynchronizeHostPartialImpl(const std::vector<u64> &dirtySubresources, boost::container::small_vector<vk::BufferImageCopy, 10> &bufferImageCopies) {
+        WaitOnBacking();
+
+        /**
+         * @brief A run of dirty layers with the same mip level, these can be copied by a single buffer image copy
+         */
+        struct DirtyRun {
+            u32 level;
+            u32 baseLayer;
+            u32 layerCount;
+            vk::DeviceSize bufferOffset;
+        };
+        boost::container::small_vector<DirtyRun, 8> runs;
+
+        vk::DeviceSize stagingSize{};
+        for (u32 level{}; level < levelCount; level++) {
+            for (u32 layer{}; layer < layerCount; layer++) {
+                size_t subresource{(static_cast<size_t>(layer) * levelCount) + level};
+                if (!(dirtySubresources[subresource / 64] & (1ULL << (subresource % 64))))
+                    continue;
+
+                if (!runs.empty() && runs.back().level == level && runs.back().baseLayer + runs.back().layerCount == layer) {
+                    runs.back().layerCount++;
+                } else {
+                    stagingSize = util::AlignUpNpot<vk::DeviceSize>(stagingSize, format->bpb * 4); // The offset of a buffer image copy must be a multiple of both the texel block size and 4
+                    runs.push_back(DirtyRun{level, layer, 1, stagingSize});
+                }
+                stagingSize += mipLayouts[level].linearSize;
+            }
+        }
+
+        if (runs.empty())
+            return nullptr; // The writes only touched padding between subresources
+
+        trace::AddFrameCounter(trace::FrameCounter::TextureUploads);
+        trace::AddFrameCounter(trace::FrameCounter::TextureUploadBytes, stagingSize);
+
+        auto stagingBuffer{gpu.memory.AllocateStagingBuffer(stagingSize)};
+        auto guestLayerStride{guest->GetLayerStride()};
+        for (const auto &run : runs) {
+            const auto &level{mipLayouts[run.level]};
+            size_t levelOffset{};
+            for (u32 i{}; i < run.level; i++)
+                levelOffset += mipLayouts[i].blockLinearSize;
+
+            for (u32 layer{}; layer < run.layerCount; layer++)
+                texture::CopyBlockLinearToLinear(
+                    level.dimensions,
+                    guest->format->blockWidth, guest->format->blockHeight, guest->format->bpb,
+                    level.blockHeight, level.blockDepth,
+                    mirror.data() + ((run.baseLayer + layer) * guestLayerStride) + levelOffset,
+                    stagingBuffer->data() + run.bufferOffset + (layer * level.linearSize)
+                );
+
+            auto pushBufferImageCopyWithAspect{[&](vk::ImageAspectFlagBits aspect) {
+                bufferImageCopies.emplace_back(vk::BufferImageCopy{
+                    .bufferOffset = run.bufferOffset,
+                    .imageSubresource = {
+                        .aspectMask = aspect,
+                        .mipLevel = run.level,
+                        .baseArrayLayer = run.baseLayer,
+                        .layerCount = run.layerCount,
+                    },
+                    .imageExtent = level.dimensions,
+                });
+            }};
+
+            if (format->vkAspect & vk::ImageAspectFlagBits::eColor)
+                pushBufferImageCopyWithAspect(vk::ImageAspectFlagBits::eColor);
+            if (format->vkAspect & vk::ImageAspectFlagBits::eDepth)
+                pushBufferImageCopyWithAspect(vk::ImageAspectFlagBits::eDepth);
+            if (format->vkAspect & vk::ImageAspectFlagBits::eStencil)
+                pushBufferImageCopyWithAspect(vk::ImageAspectFlagBits::eStencil);
+        }
+
+        return stagingBuffer;
+    }
+
     std::shared_ptr<memory::StagingBuffer> Texture::SynchronizeHostImpl() {
-        if (guest->dimensions != dimensions)
+        if (guest->dimensions != dimensions && renderScale == 1.0f)
             throw exception("Guest and host dimensions being different is not supported currently");
 
         auto pointer{mirror.data()};
@@ -269,6 +486,17 @@ namespace skyline::gpu {
             }
         }()};
 
+        trace::AddFrameCounter(trace::FrameCounter::TextureUploads);
+        trace::AddFrameCounter(trace::FrameCounter::TextureUploadBytes, surfaceSize);
+
+        // Only textures which require decoding are cached as loading a plain deswizzled texture from the cache is unlikely to be faster than deswizzling it
+        std::optional<u64> cacheKey;
+        if (gpu.textureCacheManager && guest->format != format) {
+            cacheKey = TextureCacheManager::GetKey(*guest, format, levelCount, mirror);
+            if (gpu.textureCacheManager->Load(*cacheKey, span<u8>{bufferData, surfaceSize}))
+                return stagingBuffer;
+        }
+
         std::vector<u8> deswizzleBuffer;
         u8 *deswizzleOutput;
         if (guest->format != format) {
@@ -314,72 +542,129 @@ namespace skyline::gpu {
         }
 
         if (!deswizzleBuffer.empty()) {
+            span<u8> decodeOutput{bufferData, surfaceSize};
             for (const auto &level : mipLayouts) {
-                size_t levelHeight{level.dimensions.height * layerCount}; //!< The height of an image representing all layers in the entire level
-                switch (guest->format->vkFormat) {
-                    case vk::Format::eBc1RgbaUnormBlock:
-                    case vk::Format::eBc1RgbaSrgbBlock:
-                        bcn::DecodeBc1(deswizzleOutput, bufferData, level.dimensions.width, levelHeight, true);
-                        break;
-
-                    case vk::Format::eBc2UnormBlock:
-                    case vk::Format::eBc2SrgbBlock:
-                        bcn::DecodeBc2(deswizzleOutput, bufferData, level.dimensions.width, levelHeight);
-                        break;
-
-                    case vk::Format::eBc3UnormBlock:
-                    case vk::Format::eBc3SrgbBlock:
-                        bcn::DecodeBc3(deswizzleOutput, bufferData, level.dimensions.width, levelHeight);
-                        break;
-
-                    case vk::Format::eBc4UnormBlock:
-                        bcn::DecodeBc4(deswizzleOutput, bufferData, level.dimensions.width, levelHeight, false);
-                        break;
-                    case vk::Format::eBc4SnormBlock:
-                        bcn::DecodeBc4(deswizzleOutput, bufferData, level.dimensions.width, levelHeight, true);
-                        break;
-
-                    case vk::Format::eBc5UnormBlock:
-                        bcn::DecodeBc5(deswizzleOutput, bufferData, level.dimensions.width, levelHeight, false);
-                        break;
-                    case vk::Format::eBc5SnormBlock:
-                        bcn::DecodeBc5(deswizzleOutput, bufferData, level.dimensions.width, levelHeight, true);
-                        break;
-
-                    case vk::Format::eBc6HUfloatBlock:
-                        bcn::DecodeBc6(deswizzleOutput, bufferData, level.dimensions.width, levelHeight, false);
-                        break;
-                    case vk::Format::eBc6HSfloatBlock:
-                        bcn::DecodeBc6(deswizzleOutput, bufferData, level.dimensions.width, levelHeight, true);
-                        break;
-
-                    case vk::Format::eBc7UnormBlock:
-                    case vk::Format::eBc7SrgbBlock:
-                        bcn::DecodeBc7(deswizzleOutput, bufferData, level.dimensions.width, levelHeight);
-                        break;
-
-                    default:
-                        throw exception("Unsupported guest format '{}'", vk::to_string(guest->format->vkFormat));
-                }
+                // Layers are decoded separately as their heights aren't necessarily a multiple of the block height, stacking them would misalign the blocks of all subsequent layers
+                for (size_t layer{}; layer < layerCount; layer++) {
+                    gpu.textureDecoder.Decode(guest->format, format, deswizzleOutput, bufferData, level.dimensions.width, level.dimensions.height);
 
-                deswizzleOutput += level.linearSize * layerCount;
-                bufferData += level.targetLinearSize * layerCount;
+                    deswizzleOutput += level.linearSize;
+                    bufferData += level.targetLinearSize;
+                }
             }
+
+            if (cacheKey)
+                gpu.textureCacheManager->QueueWrite(*cacheKey, decodeOutput);
         }
 
         return stagingBuffer;
     }
 
-    boost::container::small_vector<vk::BufferImageCopy, 10> Texture::GetBufferImageCopies() {
+    bool Texture::SynchronizeHostGpu(const vk::raii::CommandBuffer &commandBuffer, const std::shared_ptr<FenceCycle> &pCycle) {
+        if (!*gpu.state.settings->gpuTextureDecoding || guest->tileConfig.mode != texture::TileMode::Block || guest->dimensions != dimensions || tiling != vk::ImageTiling::eOptimal)
+            return false;
+
+        u32 bcnFormat{}, conversion{};
+        if (guest->format != format) {
+            // Only BC1-3 are decoded on the GPU as they are always decoded into R8G8B8A8, packed 16-bit formats the host doesn't support are converted into R8G8B8A8 and other formats are left to the CPU decoder
+            bcnFormat = TextureDecodeHelperShader::GetDecodableBcnFormat(guest->format->vkFormat);
+            if (!bcnFormat)
+                conversion = FormatConversionHelperShader::GetConversion(guest->format->vkFormat, format->vkFormat);
+            if ((!bcnFormat && !conversion) || format->bpb != 4)
+                return false;
+        }
+
+        auto guestLayerStride{guest->GetLayerStride()};
+        if (guest->format->bpb == 12 || guestLayerStride % 4 != 0)
+            return false;
+
+        constexpr vk::DeviceSize MaxAllocationSize{MegaBufferChunkSize / 4}; //!< Megabuffer allocations are limited to a single chunk, we avoid large textures to not thrash the megabuffer
+        size_t guestSurfaceSize{guestLayerStride * layerCount};
+        if (guestSurfaceSize > MaxAllocationSize || deswizzledSurfaceSize > MaxAllocationSize || surfaceSize > MaxAllocationSize || mirror.size() < guestSurfaceSize)
+            return false;
+
+        boost::container::small_vector<TextureDecodeHelperShader::DeswizzleLevel, 16> deswizzleLevels;
+        for (size_t layer{}; layer < layerCount; layer++) {
+            size_t inputLevel{layer * guestLayerStride}, outputLevel{};
+            for (const auto &level : mipLayouts) {
+                u32 widthBytes{static_cast<u32>(util::DivideCeil<size_t>(level.dimensions.width, guest->format->blockWidth) * guest->format->bpb)};
+                if (widthBytes % 4 != 0 || inputLevel % 4 != 0 || level.linearSize % 4 != 0)
+                    return false; // The compute shaders operate on words so all offsets and lines must be word-aligned
+
+                deswizzleLevels.push_back(TextureDecodeHelperShader::DeswizzleLevel{
+                    .widthBytes = widthBytes,
+                    .height = static_cast<u32>(util::DivideCeil<size_t>(level.dimensions.height, guest->format->blockHeight)),
+                    .depth = level.dimensions.depth,
+                    .gobBlockHeight = static_cast<u32>(level.blockHeight),
+                    .gobBlockDepth = static_cast<u32>(level.blockDepth),
+                    .srcOffset = static_cast<u32>(inputLevel / 4),
+                    .dstOffset = static_cast<u32>((outputLevel + (layer * level.linearSize)) / 4), // Offset into the current layer relative to the start of the current mip level
+                });
+
+                inputLevel += level.blockLinearSize;
+                outputLevel += layerCount * level.linearSize;
+            }
+        }
+
+        WaitOnBacking();
+
+        auto &decodeShader{gpu.helperShaders.textureDecodeHelperShader};
+        auto guestAllocation{gpu.megaBufferAllocator.Push(pCycle, mirror.subspan(0, guestSurfaceSize), true)};
+        auto deswizzledAllocation{gpu.megaBufferAllocator.Allocate(pCycle, deswizzledSurfaceSize, true)};
+        decodeShader.Deswizzle(gpu, commandBuffer, pCycle,
+                               vk::DescriptorBufferInfo{guestAllocation.buffer, guestAllocation.offset, guestSurfaceSize},
+                               vk::DescriptorBufferInfo{deswizzledAllocation.buffer, deswizzledAllocation.offset, deswizzledSurfaceSize},
+                               deswizzleLevels);
+
+        if (bcnFormat) {
+            boost::container::small_vector<TextureDecodeHelperShader::DecodeLevel, 16> decodeLevels;
+            size_t inputLevel{}, outputLevel{};
+            for (const auto &level : mipLayouts) {
+                decodeLevels.push_back(TextureDecodeHelperShader::DecodeLevel{
+                    .width = level.dimensions.width,
+                    .height = level.dimensions.height * layerCount, // The height of an image representing all layers in the entire level
+                    .srcOffset = static_cast<u32>(inputLevel / 4),
+                    .dstOffset = static_cast<u32>(outputLevel / 4),
+                });
+
+                inputLevel += level.linearSize * layerCount;
+                outputLevel += level.targetLinearSize * layerCount;
+            }
+
+            auto decodedAllocation{gpu.megaBufferAllocator.Allocate(pCycle, surfaceSize, true)};
+            decodeShader.DecodeBcn(gpu, commandBuffer, pCycle,
+                                   vk::DescriptorBufferInfo{deswizzledAllocation.buffer, deswizzledAllocation.offset, deswizzledSurfaceSize},
+                                   vk::DescriptorBufferInfo{decodedAllocation.buffer, decodedAllocation.offset, surfaceSize},
+                                   bcnFormat, true, decodeLevels);
+            CopyFromBuffer(commandBuffer, decodedAllocation.buffer, decodedAllocation.offset);
+        } else if (conversion) {
+            auto convertedAllocation{gpu.megaBufferAllocator.Allocate(pCycle, surfaceSize, true)};
+            gpu.helperShaders.formatConversionHelperShader.Convert(gpu, commandBuffer, pCycle,
+                                                                   vk::DescriptorBufferInfo{deswizzledAllocation.buffer, deswizzledAllocation.offset, deswizzledSurfaceSize},
+                                                                   vk::DescriptorBufferInfo{convertedAllocation.buffer, convertedAllocation.offset, surfaceSize},
+                                                                   conversion, false, static_cast<u32>(deswizzledSurfaceSize / guest->format->bpb));
+            CopyFromBuffer(commandBuffer, convertedAllocation.buffer, convertedAllocation.offset);
+        } else {
+            CopyFromBuffer(commandBuffer, deswizzledAllocation.buffer, deswizzledAllocation.offset);
+        }
+
+        pCycle->AttachObject(shared_from_this());
+        pCycle->ChainCycle(cycle);
+        cycle = pCycle;
+        return true;
+    }
+
+    boost::container::small_vector<vk::BufferImageCopy, 10> Texture::GetBufferImageCopies(vk::DeviceSize baseOffset, u32 bufferRowLength) {
         boost::container::small_vector<vk::BufferImageCopy, 10> bufferImageCopies;
 
         auto pushBufferImageCopyWithAspect{[&](vk::ImageAspectFlagBits aspect) {
-            vk::DeviceSize bufferOffset{};
+            vk::DeviceSize bufferOffset{baseOffset};
             u32 mipLevel{};
             for (auto &level : mipLayouts) {
                 bufferImageCopies.emplace_back(
                     vk::BufferImageCopy{
                         .bufferOffset = bufferOffset,
+                        .bufferRowLength = bufferRowLength,
                         .imageSubresource = {
                             .aspectMask = aspect,
                             .mipLevel = mipLevel++,
@@ -402,7 +687,96 @@ namespace skyline::gpu {
         return bufferImageCopies;
     }
 
-    void Texture::CopyFromStagingBuffer(const vk::raii::CommandBuffer &commandBuffer, const std::shared_ptr<memory::StagingBuffer> &stagingBuffer) {
+    bool Texture::CanScale() {
+        if (guest->GetImageType() != vk::ImageType::e2D || guest->tileConfig.mode != texture::TileMode::Block || levelCount != 1 || layerCount != 1 || guest->dimensions.depth != 1 ||
+            guest->dimensions.width < MinimumScaledDimension || guest->dimensions.height < MinimumScaledDimension || format->IsCompressed())
+            return false;
+
+        constexpr vk::FormatFeatureFlags RequiredFeatures{vk::FormatFeatureFlagBits::eBlitSrc | vk::FormatFeatureFlagBits::eBlitDst};
+        return (gpu.vkPhysicalDevice.getFormatProperties(*format).optimalTilingFeatures & RequiredFeatures) == RequiredFeatures;
+    }
+
+    vk::Image Texture::GetGuestResolutionImage() {
+        if (!guestResolutionImage)
+            guestResolutionImage.emplace(gpu.memory.AllocateImage(vk::ImageCreateInfo{
+                .imageType = vk::ImageType::e2D,
+                .format = *format,
+                .extent = guest->dimensions,
+                .mipLevels = 1,
+                .arrayLayers = 1,
+                .samples = vk::SampleCountFlagBits::e1,
+                .tiling = vk::ImageTiling::eOptimal,
+                .usage = vk::ImageUsageFlagBits::eTransferSrc | vk::ImageUsageFlagBits::eTransferDst,
+                .sharingMode = vk::SharingMode::eExclusive,
+                .queueFamilyIndexCount = 1,
+                .pQueueFamilyIndices = &gpu.vkQueueFamilyIndex,
+                .initialLayout = vk::ImageLayout::eUndefined,
+            }));
+
+        return guestResolutionImage->vkImage;
+    }
+
+    void Texture::RecordScaleBlit(const vk::raii::CommandBuffer &commandBuffer, vk::Image guestImage, bool toBacking) {
+        auto image{GetBacking()};
+        vk::ImageSubresourceRange subresourceRange{
+            .aspectMask = format->vkAspect,
+            .levelCount = 1,
+            .layerCount = 1,
+        };
+
+        commandBuffer.pipelineBarrier(vk::PipelineStageFlagBits::eAllCommands, vk::PipelineStageFlagBits::eTransfer, {}, {}, {}, {
+            vk::ImageMemoryBarrier{
+                .image = image,
+                .srcAccessMask = vk::AccessFlagBits::eMemoryWrite,
+                .dstAccessMask = vk::AccessFlagBits::eTransferRead | vk::AccessFlagBits::eTransferWrite,
+                .oldLayout = layout,
+                .newLayout = layout,
+                .srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
+                .dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
+                .subresourceRange = subresourceRange,
+            },
+            vk::ImageMemoryBarrier{
+                .image = guestImage,
+                .srcAccessMask = vk::AccessFlagBits::eMemoryWrite,
+                .dstAccessMask = vk::AccessFlagBits::eTransferRead | vk::AccessFlagBits::eTransferWrite,
+                .oldLayout = toBacking ? vk::ImageLayout::eGeneral : vk::ImageLayout::eUndefined, // The guest resolution image is always entirely overwritten when it's blitted into
+                .newLayout = vk::ImageLayout::eGeneral,
+                .srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
+                .dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
+                .subresourceRange = subresourceRange,
+            },
+        });
+
+        vk::ImageSubresourceLayers subresourceLayers{
+            .aspectMask = format->vkAspect,
+            .layerCount = 1,
+        };
+        std::array<vk::Offset3D, 2> guestOffsets{vk::Offset3D{}, vk::Offset3D{static_cast<i32>(guest->dimensions.width), static_cast<i32>(guest->dimensions.height), 1}};
+        std::array<vk::Offset3D, 2> hostOffsets{vk::Offset3D{}, vk::Offset3D{static_cast<i32>(dimensions.width), static_cast<i32>(dimensions.height), 1}};
+
+        // Nearest filtering is used as linear filtering isn't supported for integer or depth formats, this only affects CPU synchronization which should be rare for render targets
+        if (toBacking)
+            commandBuffer.blitImage(guestImage, vk::ImageLayout::eGeneral, image, layout, vk::ImageBlit{
+                .srcSubresource = subresourceLayers,
+                .srcOffsets = guestOffsets,
+                .dstSubresource = subresourceLayers,
+                .dstOffsets = hostOffsets,
+            }, vk::Filter::eNearest);
+        else
+            commandBuffer.blitImage(image, layout, guestImage, vk::ImageLayout::eGeneral, vk::ImageBlit{
+                .srcSubresource = subresourceLayers,
+                .srcOffsets = hostOffsets,
+                .dstSubresource = subresourceLayers,
+                .dstOffsets = guestOffsets,
+            }, vk::Filter::eNearest);
+
+        commandBuffer.pipelineBarrier(vk::PipelineStageFlagBits::eTransfer, vk::PipelineStageFlagBits::eAllCommands, {}, vk::MemoryBarrier{
+            .srcAccessMask = vk::AccessFlagBits::eTransferWrite,
+            .dstAccessMask = vk::AccessFlagBits::eMemoryRead | vk::AccessFlagBits::eMemoryWrite,
+        }, {}, {});
+    }
+
+    void Texture::CopyFromBuffer(const vk::raii::CommandBuffer &commandBuffer, vk::Buffer buffer, vk::DeviceSize offset, u32 bufferRowLength) {
         auto image{GetBacking()};
         if (layout == vk::ImageLayout::eUndefined)
             commandBuffer.pipelineBarrier(vk::PipelineStageFlagBits::eHost, vk::PipelineStageFlagBits::eTransfer, {}, {}, {}, vk::ImageMemoryBarrier{
@@ -420,38 +794,77 @@ namespace skyline::gpu {
                 },
             });
 
-        auto bufferImageCopies{GetBufferImageCopies()};
-        commandBuffer.copyBufferToImage(stagingBuffer->vkBuffer, image, layout, vk::ArrayProxy(static_cast<u32>(bufferImageCopies.size()), bufferImageCopies.data()));
+        auto bufferImageCopies{GetBufferImageCopies(offset, bufferRowLength)};
+        if (renderScale != 1.0f) {
+            // The buffer contains data at the guest resolution, it's copied into the guest resolution image and then scaled into the backing
+            auto guestImage{GetGuestResolutionImage()};
+            commandBuffer.pipelineBarrier(vk::PipelineStageFlagBits::eAllCommands, vk::PipelineStageFlagBits::eTransfer, {}, {}, {}, vk::ImageMemoryBarrier{
+                .image = guestImage,
+                .srcAccessMask = vk::AccessFlagBits::eMemoryRead | vk::AccessFlagBits::eMemoryWrite,
+                .dstAccessMask = vk::AccessFlagBits::eTransferWrite,
+                .oldLayout = vk::ImageLayout::eUndefined,
+                .newLayout = vk::ImageLayout::eGeneral,
+                .srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
+                .dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
+                .subresourceRange = {
+                    .aspectMask = format->vkAspect,
+                    .levelCount = 1,
+                    .layerCount = 1,
+                },
+            });
+            commandBuffer.copyBufferToImage(buffer, guestImage, vk::ImageLayout::eGeneral, vk::ArrayProxy(static_cast<u32>(bufferImageCopies.size()), bufferImageCopies.data()));
+            RecordScaleBlit(commandBuffer, guestImage, true);
+            return;
+        }
+
+        commandBuffer.copyBufferToImage(buffer, image, layout, vk::ArrayProxy(static_cast<u32>(bufferImageCopies.size()), bufferImageCopies.data()));
+    }
+
+    void Texture::CopyFromStagingBuffer(const vk::raii::CommandBuffer &commandBuffer, const std::shared_ptr<memory::StagingBuffer> &stagingBuffer) {
+        CopyFromBuffer(commandBuffer, stagingBuffer->vkBuffer);
     }
 
     void Texture::CopyIntoStagingBuffer(const vk::raii::CommandBuffer &commandBuffer, const std::shared_ptr<memory::StagingBuffer> &stagingBuffer) {
+        CopyIntoBuffer(commandBuffer, stagingBuffer->vkBuffer, 0, stagingBuffer->size());
+    }
+
+    void Texture::CopyIntoBuffer(const vk::raii::CommandBuffer &commandBuffer, vk::Buffer buffer, vk::DeviceSize offset, vk::DeviceSize size, u32 bufferRowLength) {
         auto image{GetBacking()};
-        commandBuffer.pipelineBarrier(vk::PipelineStageFlagBits::eBottomOfPipe, vk::PipelineStageFlagBits::eTransfer, {}, {}, {}, vk::ImageMemoryBarrier{
-            .image = image,
-            .srcAccessMask = vk::AccessFlagBits::eMemoryWrite,
-            .dstAccessMask = vk::AccessFlagBits::eTransferRead,
-            .oldLayout = layout,
-            .newLayout = layout,
-            .srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
-            .dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
-            .subresourceRange = {
-                .aspectMask = format->vkAspect,
-                .levelCount = levelCount,
-                .layerCount = layerCount,
-            },
-        });
+        auto imageLayout{layout};
+        if (renderScale != 1.0f) {
+            // The buffer must contain data at the guest resolution so the backing is scaled down into the guest resolution image which is copied from instead
+            image = GetGuestResolutionImage();
+            imageLayout = vk::ImageLayout::eGeneral;
+            RecordScaleBlit(commandBuffer, image, false);
+        } else {
+            // The bottom of the pipe can't be used as the source stage here as it performs no memory accesses, this would make the barrier a no-op for prior writes
+            commandBuffer.pipelineBarrier(vk::PipelineStageFlagBits::eAllCommands, vk::PipelineStageFlagBits::eTransfer, {}, {}, {}, vk::ImageMemoryBarrier{
+                .image = image,
+                .srcAccessMask = vk::AccessFlagBits::eMemoryWrite,
+                .dstAccessMask = vk::AccessFlagBits::eTransferRead,
+                .oldLayout = layout,
+                .newLayout = layout,
+                .srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
+                .dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
+                .subresourceRange = {
+                    .aspectMask = format->vkAspect,
+                    .levelCount = levelCount,
+                    .layerCount = layerCount,
+                },
+            });
+        }
 
-        auto bufferImageCopies{GetBufferImageCopies()};
-        commandBuffer.copyImageToBuffer(image, layout, stagingBuffer->vkBuffer, vk::ArrayProxy(static_cast<u32>(bufferImageCopies.size()), bufferImageCopies.data()));
+        auto bufferImageCopies{GetBufferImageCopies(offset, bufferRowLength)};
+        commandBuffer.copyImageToBuffer(image, imageLayout, buffer, vk::ArrayProxy(static_cast<u32>(bufferImageCopies.size()), bufferImageCopies.data()));
 
         commandBuffer.pipelineBarrier(vk::PipelineStageFlagBits::eTransfer, vk::PipelineStageFlagBits::eHost, {}, {}, vk::BufferMemoryBarrier{
             .srcAccessMask = vk::AccessFlagBits::eTransferWrite,
             .dstAccessMask = vk::AccessFlagBits::eHostRead,
             .srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
             .dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
-            .buffer = stagingBuffer->vkBuffer,
-            .offset = 0,
-            .size = stagingBuffer->size(),
+            .buffer = buffer,
+            .offset = offset,
+            .size = size,
         }, {});
     }
 
@@ -495,8 +908,8 @@ namespace skyline::gpu {
     }
 
     void Texture::FreeGuest() {
-        // Avoid freeing memory if the backing format doesn't match, as otherwise texture data would be lost on the guest side, also avoid if fast readback is active
-        if (*gpu.state.settings->freeGuestTextureMemory && guest->format == format && !(accumulatedGuestWaitTime > SkipReadbackHackWaitTimeThreshold && *gpu.state.settings->enableFastGpuReadbackHack)) {
+        // Avoid freeing memory if the backing format doesn't match, as otherwise texture data would be lost on the guest side, also avoid if fast readback is active or the memory is imported on the GPU
+        if (*gpu.state.settings->freeGuestTextureMemory && guest->format == format && !importedMirror && !(accumulatedGuestWaitTime > SkipReadbackHackWaitTimeThreshold && *gpu.state.settings->enableFastGpuReadbackHack)) {
             gpu.state.process->memory.FreeMemory(mirror);
             memoryFreed = true;
         }
@@ -513,13 +926,18 @@ namespace skyline::gpu {
           usage(usage),
           levelCount(levelCount),
           layerCount(layerCount),
-          sampleCount(sampleCount) {}
+          sampleCount(sampleCount) {
+        PerfStats.textureCount.fetch_add(1, std::memory_order_relaxed);
+    }
 
-    texture::Format ConvertHostCompatibleFormat(texture::Format format, const TraitManager &traits) {
+    texture::Format ConvertHostCompatibleFormat(texture::Format format, const GPU &gpu) {
+        const auto &traits{gpu.traits};
         auto bcnSupport{traits.bcnSupport};
-        if (bcnSupport.all())
+        if (bcnSupport.all() && traits.supportsAstcLdr && traits.supportsB5G6R5 && traits.supportsB5G5R5A1)
             return format;
 
+        bool transcode{traits.supportsEac && *gpu.state.settings->textureTranscoding}; //!< If BC4 and BC5 should be transcoded to EAC rather than decoded, this keeps them compressed at the same size
+
         switch (format->vkFormat) {
             case vk::Format::eBc1RgbaUnormBlock:
                 return bcnSupport[0] ? format : format::R8G8B8A8Unorm;
@@ -537,14 +955,14 @@ namespace skyline::gpu {
                 return bcnSupport[2] ? format : format::R8G8B8A8Srgb;
 
             case vk::Format::eBc4UnormBlock:
-                return bcnSupport[3] ? format : format::R8Unorm;
+                return bcnSupport[3] ? format : (transcode ? format::EacR11Unorm : format::R8Unorm);
             case vk::Format::eBc4SnormBlock:
-                return bcnSupport[3] ? format : format::R8Snorm;
+                return bcnSupport[3] ? format : (transcode ? format::EacR11Snorm : format::R8Snorm);
 
             case vk::Format::eBc5UnormBlock:
-                return bcnSupport[4] ? format : format::R8G8Unorm;
+                return bcnSupport[4] ? format : (transcode ? format::EacR11G11Unorm : format::R8G8Unorm);
             case vk::Format::eBc5SnormBlock:
-                return bcnSupport[4] ? format : format::R8G8Snorm;
+                return bcnSupport[4] ? format : (transcode ? format::EacR11G11Snorm : format::R8G8Snorm);
 
             case vk::Format::eBc6HUfloatBlock:
             case vk::Format::eBc6HSfloatBlock:
@@ -555,6 +973,42 @@ namespace skyline::gpu {
             case vk::Format::eBc7SrgbBlock:
                 return bcnSupport[6] ? format : format::R8G8B8A8Srgb;
 
+            case vk::Format::eAstc4x4UnormBlock:
+            case vk::Format::eAstc5x4UnormBlock:
+            case vk::Format::eAstc5x5UnormBlock:
+            case vk::Format::eAstc6x5UnormBlock:
+            case vk::Format::eAstc6x6UnormBlock:
+            case vk::Format::eAstc8x5UnormBlock:
+            case vk::Format::eAstc8x6UnormBlock:
+            case vk::Format::eAstc8x8UnormBlock:
+            case vk::Format::eAstc10x5UnormBlock:
+            case vk::Format::eAstc10x6UnormBlock:
+            case vk::Format::eAstc10x8UnormBlock:
+            case vk::Format::eAstc10x10UnormBlock:
+            case vk::Format::eAstc12x10UnormBlock:
+            case vk::Format::eAstc12x12UnormBlock:
+                return traits.supportsAstcLdr ? format : format::R8G8B8A8Unorm;
+            case vk::Format::eAstc4x4SrgbBlock:
+            case vk::Format::eAstc5x4SrgbBlock:
+            case vk::Format::eAstc5x5SrgbBlock:
+            case vk::Format::eAstc6x5SrgbBlock:
+            case vk::Format::eAstc6x6SrgbBlock:
+            case vk::Format::eAstc8x5SrgbBlock:
+            case vk::Format::eAstc8x6SrgbBlock:
+            case vk::Format::eAstc8x8SrgbBlock:
+            case vk::Format::eAstc10x5SrgbBlock:
+            case vk::Format::eAstc10x6SrgbBlock:
+            case vk::Format::eAstc10x8SrgbBlock:
+            case vk::Format::eAstc10x10SrgbBlock:
+            case vk::Format::eAstc12x10SrgbBlock:
+            case vk::Format::eAstc12x12SrgbBlock:
+                return traits.supportsAstcLdr ? format : format::R8G8B8A8Srgb;
+
+            case vk::Format::eB5G6R5UnormPack16:
+                return traits.supportsB5G6R5 ? format : format::R8G8B8A8Unorm;
+            case vk::Format::eB5G5R5A1UnormPack16:
+                return traits.supportsB5G5R5A1 ? format : format::R8G8B8A8Unorm;
+
             default:
                 return format;
         }
@@ -574,11 +1028,11 @@ namespace skyline::gpu {
         return surfaceSize;
     }
 
-    Texture::Texture(GPU &pGpu, GuestTexture pGuest)
+    Texture::Texture(GPU &pGpu, GuestTexture pGuest, float pRenderScale)
         : gpu(pGpu),
           guest(std::move(pGuest)),
           dimensions(guest->dimensions),
-          format(ConvertHostCompatibleFormat(guest->format, gpu.traits)),
+          format(ConvertHostCompatibleFormat(guest->format, gpu)),
           layout(vk::ImageLayout::eUndefined),
           tiling(vk::ImageTiling::eOptimal), // Force Optimal due to not adhering to host subresource layout during Linear synchronization
           layerCount(guest->layerCount),
@@ -599,6 +1053,7 @@ namespace skyline::gpu {
           sampleCount(vk::SampleCountFlagBits::e1),
           flags(gpu.traits.quirks.vkImageMutableFormatCostly ? vk::ImageCreateFlags{} : vk::ImageCreateFlagBits::eMutableFormat),
           usage(vk::ImageUsageFlagBits::eTransferSrc | vk::ImageUsageFlagBits::eTransferDst | vk::ImageUsageFlagBits::eSampled) {
+        PerfStats.textureCount.fetch_add(1, std::memory_order_relaxed);
         if ((format->vkAspect & vk::ImageAspectFlagBits::eColor) && !format->IsCompressed())
             usage |= vk::ImageUsageFlagBits::eColorAttachment;
         if (format->vkAspect & (vk::ImageAspectFlagBits::eDepth | vk::ImageAspectFlagBits::eStencil))
@@ -610,9 +1065,23 @@ namespace skyline::gpu {
         else if (imageType == vk::ImageType::e3D)
             flags |= vk::ImageCreateFlagBits::e2DArrayCompatible;
 
+        if (pRenderScale != 1.0f && CanScale()) {
+            renderScale = pRenderScale;
+            dimensions = guest->dimensions.Scale(renderScale);
+        }
+
+        // Color attachments aren't considered for transient backings as they're far more likely to be read after being rendered to
+        transientIneligible = !*gpu.state.settings->transientAttachments || !gpu.traits.supportsLazilyAllocatedMemory || !(usage & vk::ImageUsageFlagBits::eDepthStencilAttachment) || levelCount != 1;
+
+        // The backing is only allocated on the first usage of the texture by the GPU, guest surfaces that are never used by the GPU don't require one
+        backingEvicted = true;
+        SetupGuestMappings();
+    }
+
+    void Texture::AllocateBacking() {
         vk::ImageCreateInfo imageCreateInfo{
             .flags = flags,
-            .imageType = imageType,
+            .imageType = guest->GetImageType(),
             .format = *format,
             .extent = dimensions,
             .mipLevels = levelCount,
@@ -623,14 +1092,65 @@ namespace skyline::gpu {
             .sharingMode = vk::SharingMode::eExclusive,
             .queueFamilyIndexCount = 1,
             .pQueueFamilyIndices = &gpu.vkQueueFamilyIndex,
-            .initialLayout = layout,
+            .initialLayout = vk::ImageLayout::eUndefined,
         };
-        backing = tiling != vk::ImageTiling::eLinear ? gpu.memory.AllocateImage(imageCreateInfo) : gpu.memory.AllocateMappedImage(imageCreateInfo);
+        if (transientBacking)
+            backing = gpu.memory.AllocateTransientImage(imageCreateInfo);
+        else
+            backing = tiling != vk::ImageTiling::eLinear ? gpu.memory.AllocateImage(imageCreateInfo) : gpu.memory.AllocateMappedImage(imageCreateInfo);
+        layout = vk::ImageLayout::eUndefined;
+        uploadHash = 0;
+    }
 
-        SetupGuestMappings();
+    void Texture::DisallowTransientBacking() {
+        transientIneligible = true;
+        if (!transientBacking)
+            return;
+
+        TRACE_EVENT("gpu", "Texture::DisallowTransientBacking");
+
+        // The transient backing might still be used by commands in the execution the texture is attached to, it's kept alive till the execution's completion
+        retiredBackings.push_back(std::make_shared<RetiredBacking>(RetiredBacking{std::move(backing), std::move(views)}));
+        views.clear();
+        transientBacking = false;
+        usage = (usage & ~vk::ImageUsageFlagBits::eTransientAttachment) | vk::ImageUsageFlagBits::eTransferSrc | vk::ImageUsageFlagBits::eTransferDst | vk::ImageUsageFlagBits::eSampled;
+        backingGeneration++;
+        AllocateBacking();
+        TransitionLayout(vk::ImageLayout::eGeneral);
+    }
+
+    bool Texture::EvictBacking() {
+        if (!guest || backingEvicted || !std::holds_alternative<memory::Image>(backing) || (cycle && !cycle->Poll()))
+            return false;
+
+        {
+            std::scoped_lock lock{stateMutex};
+            if (dirtyState == DirtyState::GpuDirty && format != guest->format)
+                return false; // The contents of the texture can't be converted back into the guest format so they would be lost
+        }
+
+        TRACE_EVENT("gpu", "Texture::EvictBacking");
+
+        SynchronizeGuest(true); // Any GPU dirty contents are written back and the texture is marked as CPU dirty so that it's synchronized from guest memory once restored
+        WaitOnFence();
+        {
+            std::scoped_lock lock{stateMutex};
+            MarkCpuDirtyAll(); // The entire texture needs to be synchronized into the new backing regardless of any prior partial modifications
+        }
+
+        views.clear();
+        backing = vk::Image{};
+        layout = vk::ImageLayout::eUndefined;
+        guestResolutionImage.reset();
+        downloadStagingBuffer = nullptr;
+        readbackCycle = nullptr;
+        backingEvicted = true;
+        backingGeneration++;
+        return true;
     }
 
     Texture::~Texture() {
+        PerfStats.textureCount.fetch_sub(1, std::memory_order_relaxed);
         SynchronizeGuest(true);
         if (trapHandle)
             gpu.state.nce->DeleteTrap(*trapHandle);
@@ -671,6 +1191,9 @@ namespace skyline::gpu {
 
         if (GetBacking()) [[likely]] {
             return false;
+        } else if (backingEvicted) {
+            RestoreBacking();
+            return false;
         } else {
             std::unique_lock lock(mutex, std::adopt_lock);
             backingCondition.wait(lock, [&]() -> bool { return GetBacking(); });
@@ -679,6 +1202,36 @@ namespace skyline::gpu {
         }
     }
 
+    void Texture::RestoreBacking() {
+        if (!backingEvicted) [[likely]]
+            return;
+
+        TRACE_EVENT("gpu", "Texture::RestoreBacking");
+
+        AllocateBacking();
+        backingEvicted = false;
+        gpu.texture.residentSize += surfaceSize;
+        TransitionLayout(vk::ImageLayout::eGeneral);
+    }
+
+    void Texture::DiscardContents() {
+        if (!guest || !backingEvicted)
+            return;
+
+        std::scoped_lock lock{stateMutex};
+        CollectTrackedCpuWrites();
+        if (dirtyState != DirtyState::CpuDirty)
+            return;
+
+        TRACE_EVENT("gpu", "Texture::DiscardContents");
+
+        // The texture is treated as being in sync with guest memory, any further CPU writes will mark it as CPU dirty again
+        std::fill(cpuDirtySubresources.begin(), cpuDirtySubresources.end(), 0);
+        cpuDirtySubresourcesValid = !cpuDirtySubresources.empty();
+        dirtyState = DirtyState::Clean;
+        gpu.state.nce->TrapRegions(*trapHandle, true);
+    }
+
     void Texture::WaitOnFence() {
         TRACE_EVENT("gpu", "Texture::WaitOnFence");
 
@@ -697,6 +1250,92 @@ namespace skyline::gpu {
             backingCondition.notify_all();
     }
 
+    void Texture::Descale() {
+        if (renderScale == 1.0f) [[likely]]
+            return;
+
+        TRACE_EVENT("gpu", "Texture::Descale");
+
+        DisallowTransientBacking();
+
+        auto scaledDimensions{dimensions};
+        dimensions = guest->dimensions;
+        renderScale = 1.0f;
+        guestResolutionImage.reset();
+
+        if (backingEvicted) {
+            // The backing will be restored at the guest resolution and synchronized from guest memory
+            backingGeneration++;
+            return;
+        }
+
+        WaitOnBacking();
+        WaitOnFence();
+
+        auto scaledBacking{std::make_shared<BackingType>(std::exchange(backing, vk::Image{}))};
+        auto scaledLayout{layout};
+        views.clear();
+        backingGeneration++;
+        AllocateBacking();
+
+        if (scaledLayout == vk::ImageLayout::eUndefined)
+            return; // There are no contents to retain
+
+        auto lCycle{gpu.scheduler.Submit([&](vk::raii::CommandBuffer &commandBuffer) {
+            auto scaledImage{std::visit(VariantVisitor{
+                [](vk::Image image) { return image; },
+                [](const vk::raii::Image &image) { return *image; },
+                [](const memory::Image &image) { return image.vkImage; },
+            }, *scaledBacking)};
+            vk::ImageSubresourceRange subresourceRange{
+                .aspectMask = format->vkAspect,
+                .levelCount = 1,
+                .layerCount = 1,
+            };
+
+            commandBuffer.pipelineBarrier(vk::PipelineStageFlagBits::eAllCommands, vk::PipelineStageFlagBits::eTransfer, {}, {}, {}, {
+                vk::ImageMemoryBarrier{
+                    .image = scaledImage,
+                    .srcAccessMask = vk::AccessFlagBits::eMemoryWrite,
+                    .dstAccessMask = vk::AccessFlagBits::eTransferRead,
+                    .oldLayout = scaledLayout,
+                    .newLayout = scaledLayout,
+                    .srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
+                    .dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
+                    .subresourceRange = subresourceRange,
+                },
+                vk::ImageMemoryBarrier{
+                    .image = GetBacking(),
+                    .srcAccessMask = vk::AccessFlagBits::eNoneKHR,
+                    .dstAccessMask = vk::AccessFlagBits::eTransferWrite,
+                    .oldLayout = std::exchange(layout, vk::ImageLayout::eGeneral),
+                    .newLayout = vk::ImageLayout::eGeneral,
+                    .srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
+                    .dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
+                    .subresourceRange = subresourceRange,
+                },
+            });
+
+            vk::ImageSubresourceLayers subresourceLayers{
+                .aspectMask = format->vkAspect,
+                .layerCount = 1,
+            };
+            commandBuffer.blitImage(scaledImage, scaledLayout, GetBacking(), layout, vk::ImageBlit{
+                .srcSubresource = subresourceLayers,
+                .srcOffsets = std::array<vk::Offset3D, 2>{vk::Offset3D{}, vk::Offset3D{static_cast<i32>(scaledDimensions.width), static_cast<i32>(scaledDimensions.height), 1}},
+                .dstSubresource = subresourceLayers,
+                .dstOffsets = std::array<vk::Offset3D, 2>{vk::Offset3D{}, vk::Offset3D{static_cast<i32>(dimensions.width), static_cast<i32>(dimensions.height), 1}},
+            }, vk::Filter::eNearest);
+
+            commandBuffer.pipelineBarrier(vk::PipelineStageFlagBits::eTransfer, vk::PipelineStageFlagBits::eAllCommands, {}, vk::MemoryBarrier{
+                .srcAccessMask = vk::AccessFlagBits::eTransferWrite,
+                .dstAccessMask = vk::AccessFlagBits::eMemoryRead | vk::AccessFlagBits::eMemoryWrite,
+            }, {}, {});
+        })};
+        lCycle->AttachObjects(scaledBacking, shared_from_this());
+        cycle = lCycle;
+    }
+
     void Texture::TransitionLayout(vk::ImageLayout pLayout) {
         WaitOnBacking();
         WaitOnFence();
@@ -726,11 +1365,28 @@ namespace skyline::gpu {
     }
 
     void Texture::MarkGpuDirty(UsageTracker &usageTracker) {
+        uploadHash = 0;
         for (auto mapping : guest->mappings)
             if (mapping.valid())
                 usageTracker.dirtyIntervals.Insert(mapping);
     }
 
+    std::shared_ptr<FenceCycle> Texture::SubmitUpload(const std::function<void(vk::raii::CommandBuffer &)> &recordFunction) {
+        if (!gpu.transferScheduler)
+            return gpu.scheduler.Submit(recordFunction);
+
+        // Submissions on the transfer queue aren't ordered with prior usages of the texture on the graphics queue, they need to be explicitly waited on
+        boost::container::small_vector<FenceCycle::TimelinePoint, 1> waitTimelinePoints;
+        if (cycle) {
+            if (auto point{cycle->GetTimelinePoint()})
+                waitTimelinePoints.push_back(*point);
+            else
+                cycle->Wait();
+        }
+
+        return gpu.transferScheduler->Submit(recordFunction, {}, {}, waitTimelinePoints);
+    }
+
     void Texture::SynchronizeHost(bool gpuDirty) {
         if (!guest)
             return;
@@ -740,29 +1396,74 @@ namespace skyline::gpu {
             gpuDirty = false;
 
         TRACE_EVENT("gpu", "Texture::SynchronizeHost");
+        bool partialSync{}; // If only the subresources in `dirtySubresources` need to be synchronized rather than the entire texture
+        std::vector<u64> dirtySubresources;
         {
             std::scoped_lock lock{stateMutex};
+            CollectTrackedCpuWrites();
             if (gpuDirty && dirtyState == DirtyState::Clean) {
                 // If a texture is Clean then we can just transition it to being GPU dirty and retrap it
-                dirtyState = DirtyState::GpuDirty;
                 gpu.state.nce->TrapRegions(*trapHandle, false);
-                FreeGuest();
-                return;
-            } else if (dirtyState != DirtyState::CpuDirty) {
+                CollectTrackedCpuWrites(); // Any writes prior to the texture being read-write trapped need to be synchronized
+                if (dirtyState == DirtyState::Clean) {
+                    dirtyState = DirtyState::GpuDirty;
+                    FreeGuest();
+                    return;
+                }
+            }
+
+            if (dirtyState != DirtyState::CpuDirty)
                 return; // If the texture has not been modified on the CPU, there is no need to synchronize it
+
+            if (cpuDirtySubresourcesValid && layout != vk::ImageLayout::eUndefined) {
+                partialSync = true;
+                dirtySubresources = cpuDirtySubresources;
             }
+            std::fill(cpuDirtySubresources.begin(), cpuDirtySubresources.end(), 0);
+            cpuDirtySubresourcesValid = !cpuDirtySubresources.empty();
 
             dirtyState = gpuDirty ? DirtyState::GpuDirty : DirtyState::Clean;
             gpu.state.nce->TrapRegions(*trapHandle, !gpuDirty); // Trap any future CPU reads (optionally) + writes to this texture
+            if (gpuDirty)
+                CollectTrackedCpuWrites(); // Drop any writes tracked prior to the texture being read-write trapped as they'll be observed by the synchronization below
         }
 
         // From this point on Clean -> CPU dirty state transitions can occur, GPU dirty -> * transitions will always require the full lock to be held and thus won't occur
 
-        auto stagingBuffer{SynchronizeHostImpl()};
-        if (stagingBuffer) {
+        if (transientBacking)
+            DisallowTransientBacking(); // Transient backings can't be uploaded to
+
+        if (IsUploadRedundant()) {
+            // The backing already contains the current guest contents
+        } else if (UseImportedMirror()) {
+            // The texture can be copied directly from guest memory, any guest writes prior to the copy executing will be trapped and synchronized later
+            trace::AddFrameCounter(trace::FrameCounter::TextureUploads);
+            trace::AddFrameCounter(trace::FrameCounter::TextureUploadBytes, mirror.size());
+            WaitOnBacking();
             if (cycle)
                 cycle->WaitSubmit();
-            auto lCycle{gpu.scheduler.Submit([&](vk::raii::CommandBuffer &commandBuffer) {
+            auto lCycle{SubmitUpload([&](vk::raii::CommandBuffer &commandBuffer) {
+                CopyFromBuffer(commandBuffer, *importedMirror->vkBuffer, importedMirrorOffset, importedMirrorRowLength);
+            })};
+            lCycle->AttachObject(shared_from_this());
+            lCycle->ChainCycle(cycle);
+            cycle = lCycle;
+        } else if (partialSync) {
+            boost::container::small_vector<vk::BufferImageCopy, 10> bufferImageCopies;
+            if (auto stagingBuffer{SynchronizeHostPartialImpl(dirtySubresources, bufferImageCopies)}) {
+                if (cycle)
+                    cycle->WaitSubmit();
+                auto lCycle{SubmitUpload([&](vk::raii::CommandBuffer &commandBuffer) {
+                    commandBuffer.copyBufferToImage(stagingBuffer->vkBuffer, GetBacking(), layout, vk::ArrayProxy(static_cast<u32>(bufferImageCopies.size()), bufferImageCopies.data()));
+                })};
+                lCycle->AttachObjects(stagingBuffer, shared_from_this());
+                lCycle->ChainCycle(cycle);
+                cycle = lCycle;
+            }
+        } else if (auto stagingBuffer{SynchronizeHostImpl()}; stagingBuffer) {
+            if (cycle)
+                cycle->WaitSubmit();
+            auto lCycle{SubmitUpload([&](vk::raii::CommandBuffer &commandBuffer) {
                 CopyFromStagingBuffer(commandBuffer, stagingBuffer);
             })};
             lCycle->AttachObjects(stagingBuffer, shared_from_this());
@@ -787,27 +1488,67 @@ namespace skyline::gpu {
         if (!*gpu.state.settings->freeGuestTextureMemory && !everUsedAsRt)
             gpuDirty = false;
 
+        bool partialSync{};
+        std::vector<u64> dirtySubresources;
         {
             std::scoped_lock lock{stateMutex};
+            CollectTrackedCpuWrites();
             if (gpuDirty && dirtyState == DirtyState::Clean) {
-                dirtyState = DirtyState::GpuDirty;
                 gpu.state.nce->TrapRegions(*trapHandle, false);
-                FreeGuest();
-                return;
-            } else if (dirtyState != DirtyState::CpuDirty) {
+                CollectTrackedCpuWrites();
+                if (dirtyState == DirtyState::Clean) {
+                    dirtyState = DirtyState::GpuDirty;
+                    FreeGuest();
+                    return;
+                }
+            }
+
+            if (dirtyState != DirtyState::CpuDirty)
                 return;
+
+            if (cpuDirtySubresourcesValid && layout != vk::ImageLayout::eUndefined) {
+                partialSync = true;
+                dirtySubresources = cpuDirtySubresources;
             }
+            std::fill(cpuDirtySubresources.begin(), cpuDirtySubresources.end(), 0);
+            cpuDirtySubresourcesValid = !cpuDirtySubresources.empty();
 
             dirtyState = gpuDirty ? DirtyState::GpuDirty : DirtyState::Clean;
             gpu.state.nce->TrapRegions(*trapHandle, !gpuDirty); // Trap any future CPU reads (optionally) + writes to this texture
+            if (gpuDirty)
+                CollectTrackedCpuWrites();
         }
 
-        auto stagingBuffer{SynchronizeHostImpl()};
-        if (stagingBuffer) {
-            CopyFromStagingBuffer(commandBuffer, stagingBuffer);
-            pCycle->AttachObjects(stagingBuffer, shared_from_this());
+        if (transientBacking)
+            DisallowTransientBacking();
+
+        if (IsUploadRedundant()) {
+            // The backing already contains the current guest contents
+        } else if (UseImportedMirror()) {
+            trace::AddFrameCounter(trace::FrameCounter::TextureUploads);
+            trace::AddFrameCounter(trace::FrameCounter::TextureUploadBytes, mirror.size());
+            WaitOnBacking();
+            CopyFromBuffer(commandBuffer, *importedMirror->vkBuffer, importedMirrorOffset, importedMirrorRowLength);
+            pCycle->AttachObject(shared_from_this());
             pCycle->ChainCycle(cycle);
             cycle = pCycle;
+        } else if (partialSync) {
+            // Partial synchronization is preferred over decoding on the GPU as it avoids deswizzling subresources that haven't been modified
+            boost::container::small_vector<vk::BufferImageCopy, 10> bufferImageCopies;
+            if (auto stagingBuffer{SynchronizeHostPartialImpl(dirtySubresources, bufferImageCopies)}) {
+                commandBuffer.copyBufferToImage(stagingBuffer->vkBuffer, GetBacking(), layout, vk::ArrayProxy(static_cast<u32>(bufferImageCopies.size()), bufferImageCopies.data()));
+                pCycle->AttachObjects(stagingBuffer, shared_from_this());
+                pCycle->ChainCycle(cycle);
+                cycle = pCycle;
+            }
+        } else if (!SynchronizeHostGpu(commandBuffer, pCycle)) {
+            auto stagingBuffer{SynchronizeHostImpl()};
+            if (stagingBuffer) {
+                CopyFromStagingBuffer(commandBuffer, stagingBuffer);
+                pCycle->AttachObjects(stagingBuffer, shared_from_this());
+                pCycle->ChainCycle(cycle);
+                cycle = pCycle;
+            }
         }
 
         {
@@ -818,6 +1559,30 @@ namespace skyline::gpu {
         }
     }
 
+    std::optional<FenceCycle::TimelinePoint> Texture::SynchronizeHostAsync(bool gpuDirty) {
+        // Uploads smaller than this are recorded inline as the overhead of a separate submission outweighs any overlap with rendering, this also excludes all textures that could be decoded on the GPU
+        constexpr size_t MinTransferUploadSize{MegaBufferChunkSize / 4};
+        if (!gpu.transferScheduler || !guest || surfaceSize <= MinTransferUploadSize)
+            return std::nullopt;
+
+        {
+            std::scoped_lock lock{stateMutex};
+            CollectTrackedCpuWrites();
+            if (dirtyState != DirtyState::CpuDirty || (cpuDirtySubresourcesValid && layout != vk::ImageLayout::eUndefined))
+                return std::nullopt; // Partial syncs are only of the modified subresources and are small enough to be recorded inline
+        }
+
+        // An upload would need to wait on the submission of the prior usage of the texture, this might never happen if it is in the calling execution
+        if (cycle && !cycle->Poll() && !cycle->GetTimelinePoint())
+            return std::nullopt;
+
+        auto previousCycle{cycle};
+        SynchronizeHost(gpuDirty);
+        if (cycle == previousCycle)
+            return std::nullopt;
+        return cycle->GetTimelinePoint();
+    }
+
     void Texture::SynchronizeGuest(bool cpuDirty, bool skipTrap) {
         if (!guest)
             return;
@@ -827,7 +1592,7 @@ namespace skyline::gpu {
         {
             std::scoped_lock lock{stateMutex};
             if (cpuDirty && dirtyState == DirtyState::Clean) {
-                dirtyState = DirtyState::CpuDirty;
+                MarkCpuDirtyAll();
                 if (!skipTrap)
                     gpu.state.nce->DeleteTrap(*trapHandle);
                 return;
@@ -835,26 +1600,49 @@ namespace skyline::gpu {
                 return;
             }
 
-            dirtyState = cpuDirty ? DirtyState::CpuDirty : DirtyState::Clean;
+            if (cpuDirty)
+                MarkCpuDirtyAll();
+            else
+                dirtyState = DirtyState::Clean;
             memoryFreed = false;
         }
 
-        if (layout == vk::ImageLayout::eUndefined || format != guest->format)
+        DisallowTransientBacking(); // The guest reading the texture implies that its contents are required
+
+        // Textures in a host format that was converted on the GPU can be converted back while the backing is copied into a buffer
+        u32 conversion{format != guest->format ? FormatConversionHelperShader::GetConversion(guest->format->vkFormat, format->vkFormat) : 0};
+        if (layout == vk::ImageLayout::eUndefined || (format != guest->format && (!conversion || tiling != vk::ImageTiling::eOptimal || UseImportedMirror())))
             // If the state of the host texture is undefined then so can the guest
             // If the texture has differing formats on the guest and host, we don't support converting back in that case as it may involve recompression of a decompressed texture
             return;
 
         WaitOnBacking();
 
-        if (tiling == vk::ImageTiling::eOptimal || !std::holds_alternative<memory::Image>(backing)) {
-            if (!downloadStagingBuffer)
-                downloadStagingBuffer = gpu.memory.AllocateStagingBuffer(surfaceSize);
+        guestReadbackCount++;
 
+        if (UseImportedMirror()) {
             WaitOnFence();
             auto lCycle{gpu.scheduler.Submit([&](vk::raii::CommandBuffer &commandBuffer) {
-                CopyIntoStagingBuffer(commandBuffer, downloadStagingBuffer);
+                CopyIntoBuffer(commandBuffer, *importedMirror->vkBuffer, importedMirrorOffset, mirror.size(), importedMirrorRowLength);
             })};
-            lCycle->Wait(); // We block till the copy is complete
+            lCycle->Wait(); // We block till the copy into guest memory is complete
+        } else if (conversion) {
+            CopyToGuest(ReadbackConverted(conversion));
+        } else if (tiling == vk::ImageTiling::eOptimal || !std::holds_alternative<memory::Image>(backing)) {
+            if (readbackCycle) {
+                // The texture has already been copied into the staging buffer at the end of the execution that last used it
+                readbackCycle->Wait();
+                readbackCycle = nullptr;
+            } else {
+                if (!downloadStagingBuffer)
+                    downloadStagingBuffer = gpu.memory.AllocateStagingBuffer(surfaceSize);
+
+                WaitOnFence();
+                auto lCycle{gpu.scheduler.Submit([&](vk::raii::CommandBuffer &commandBuffer) {
+                    CopyIntoStagingBuffer(commandBuffer, downloadStagingBuffer);
+                })};
+                lCycle->Wait(); // We block till the copy is complete
+            }
 
             CopyToGuest(downloadStagingBuffer->data());
         } else if (tiling == vk::ImageTiling::eLinear) {
@@ -872,6 +1660,84 @@ namespace skyline::gpu {
                 gpu.state.nce->TrapRegions(*trapHandle, true); // Trap any future CPU writes to this texture
     }
 
+    u8 *Texture::ReadbackConverted(u32 conversion) {
+        vk::DeviceSize guestOffset{util::AlignUp(surfaceSize, gpu.traits.minimumStorageBufferAlignment)}, guestSize{util::AlignUp(deswizzledSurfaceSize, sizeof(u32))}; //!< The shader writes entire words so the guest output is padded to a word boundary
+        if (!conversionBuffer)
+            conversionBuffer.emplace(gpu.memory.AllocateBuffer(guestOffset + guestSize));
+
+        WaitOnFence();
+        auto commandBuffer{gpu.scheduler.AllocateCommandBuffer()};
+        auto lCycle{commandBuffer.GetFenceCycle()};
+        try {
+            commandBuffer->begin(vk::CommandBufferBeginInfo{
+                .flags = vk::CommandBufferUsageFlagBits::eOneTimeSubmit,
+            });
+
+            CopyIntoBuffer(*commandBuffer, conversionBuffer->vkBuffer, 0, surfaceSize);
+            commandBuffer->pipelineBarrier(vk::PipelineStageFlagBits::eTransfer, vk::PipelineStageFlagBits::eComputeShader, {}, vk::MemoryBarrier{
+                .srcAccessMask = vk::AccessFlagBits::eTransferWrite,
+                .dstAccessMask = vk::AccessFlagBits::eShaderRead
+            }, {}, {});
+
+            gpu.helperShaders.formatConversionHelperShader.Convert(gpu, *commandBuffer, lCycle,
+                                                                   vk::DescriptorBufferInfo{conversionBuffer->vkBuffer, 0, surfaceSize},
+                                                                   vk::DescriptorBufferInfo{conversionBuffer->vkBuffer, guestOffset, guestSize},
+                                                                   conversion, true, static_cast<u32>(deswizzledSurfaceSize / guest->format->bpb));
+            commandBuffer->pipelineBarrier(vk::PipelineStageFlagBits::eComputeShader, vk::PipelineStageFlagBits::eHost, {}, vk::MemoryBarrier{
+                .srcAccessMask = vk::AccessFlagBits::eShaderWrite,
+                .dstAccessMask = vk::AccessFlagBits::eHostRead
+            }, {}, {});
+
+            commandBuffer->end();
+            gpu.scheduler.SubmitCommandBuffer(*commandBuffer, lCycle);
+        } catch (...) {
+            lCycle->Cancel();
+            std::rethrow_exception(std::current_exception());
+        }
+
+        lCycle->Wait(); // We block till the conversion is complete
+        return conversionBuffer->data() + guestOffset;
+    }
+
+    bool Texture::RequestAsyncReadback(const std::shared_ptr<FenceCycle> &pCycle) {
+        readbackCycle = nullptr;
+        if (!guest || guestReadbackCount < AsyncReadbackThreshold)
+            return false;
+
+        std::scoped_lock lock{stateMutex};
+        // Only textures which are synchronized through a staging buffer can be read back ahead of time, the same conditions as SynchronizeGuest apply otherwise
+        if (dirtyState != DirtyState::GpuDirty || layout == vk::ImageLayout::eUndefined || format != guest->format || UseImportedMirror() || (tiling != vk::ImageTiling::eOptimal && std::holds_alternative<memory::Image>(backing)))
+            return false;
+
+        if (!downloadStagingBuffer)
+            downloadStagingBuffer = gpu.memory.AllocateStagingBuffer(surfaceSize);
+
+        readbackCycle = pCycle;
+        return true;
+    }
+
+    void Texture::RecordAsyncReadback(const vk::raii::CommandBuffer &commandBuffer) {
+        CopyIntoStagingBuffer(commandBuffer, downloadStagingBuffer);
+    }
+
+    void Texture::CompleteAsyncReadback(const std::shared_ptr<FenceCycle> &pCycle) {
+        TRACE_EVENT("gpu", "Texture::CompleteAsyncReadback");
+
+        std::unique_lock lock{*this, std::try_to_lock};
+        if (!lock)
+            return; // If the texture is in use then it may be used by a later execution, any guest access will complete the readback if it's still current
+
+        std::scoped_lock stateLock{stateMutex};
+        if (readbackCycle != pCycle || dirtyState != DirtyState::GpuDirty)
+            return;
+
+        readbackCycle = nullptr;
+        CopyToGuest(downloadStagingBuffer->data());
+        dirtyState = DirtyState::Clean;
+        memoryFreed = false;
+        gpu.state.nce->TrapRegions(*trapHandle, true); // Trap any future CPU writes to this texture
+    }
+
     std::shared_ptr<TextureView> Texture::GetView(vk::ImageViewType type, vk::ImageSubresourceRange range, texture::Format pFormat, vk::ComponentMapping mapping) {
         if (!pFormat || pFormat == guest->format)
             pFormat = format; // We want to use the texture's format if it isn't supplied or if the requested format matches the guest format then we want to use the host format just in case it is host incompatible and the host format differs from the guest format
@@ -895,15 +1761,30 @@ namespace skyline::gpu {
         return std::make_shared<TextureView>(shared_from_this(), type, range, pFormat, mapping);
     }
 
+    bool Texture::CanAliasFormat(texture::Format pFormat) {
+        // Views are created with the guest format directly so neither the texture nor the view can require the format to be converted on the host
+        if (!pFormat || format != guest->format || ConvertHostCompatibleFormat(pFormat, gpu) != pFormat || !format->IsViewCompatible(*pFormat))
+            return false;
+
+        if (flags & vk::ImageCreateFlagBits::eMutableFormat)
+            return true;
+
+        return pFormat == format || (gpu.traits.quirks.adrenoRelaxedFormatAliasing && texture::IsAdrenoAliasCompatible(pFormat->vkFormat, format->vkFormat));
+    }
+
     void Texture::CopyFrom(std::shared_ptr<Texture> source, vk::Semaphore waitSemaphore, vk::Semaphore signalSemaphore, texture::Format srcFormat, const vk::ImageSubresourceRange &subresource) {
         if (cycle)
             cycle->WaitSubmit();
         if (source->cycle)
             source->cycle->WaitSubmit();
 
+        DisallowTransientBacking();
+        source->DisallowTransientBacking();
+
         WaitOnBacking();
         source->WaitOnBacking();
         WaitOnFence();
+        uploadHash = 0;
 
         if (source->layout == vk::ImageLayout::eUndefined)
             throw exception("Cannot copy from image with undefined layout");
@@ -923,7 +1804,7 @@ namespace skyline::gpu {
             return gpu.scheduler.Submit([&](vk::raii::CommandBuffer &commandBuffer) {
                 auto sourceBacking{source->GetBacking()};
                 if (source->layout != vk::ImageLayout::eTransferSrcOptimal) {
-                    commandBuffer.pipelineBarrier(vk::PipelineStageFlagBits::eTopOfPipe, vk::PipelineStageFlagBits::eTransfer, {}, {}, {}, vk::ImageMemoryBarrier{
+                    commandBuffer.pipelineBarrier(vk::PipelineStageFlagBits::eAllCommands, vk::PipelineStageFlagBits::eTransfer, {}, {}, {}, vk::ImageMemoryBarrier{
                         .image = sourceBacking,
                         .srcAccessMask = vk::AccessFlagBits::eMemoryWrite,
                         .dstAccessMask = vk::AccessFlagBits::eTransferRead,
@@ -937,11 +1818,12 @@ namespace skyline::gpu {
 
                 auto destinationBacking{GetBacking()};
                 if (layout != vk::ImageLayout::eTransferDstOptimal) {
-                    commandBuffer.pipelineBarrier(vk::PipelineStageFlagBits::eAllCommands, vk::PipelineStageFlagBits::eAllCommands, {}, {}, {}, vk::ImageMemoryBarrier{
+                    // Every subresource in the range is entirely overwritten by the copy so its prior contents are discarded, this avoids the driver preserving (and potentially decompressing) them which is a full-image read on tilers
+                    commandBuffer.pipelineBarrier(vk::PipelineStageFlagBits::eAllCommands, vk::PipelineStageFlagBits::eTransfer, {}, {}, {}, vk::ImageMemoryBarrier{
                         .image = destinationBacking,
                         .srcAccessMask = vk::AccessFlagBits::eMemoryRead,
                         .dstAccessMask = vk::AccessFlagBits::eTransferWrite,
-                        .oldLayout = layout,
+                        .oldLayout = vk::ImageLayout::eUndefined,
                         .newLayout = vk::ImageLayout::eTransferDstOptimal,
                         .srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
                         .dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
@@ -975,7 +1857,7 @@ namespace skyline::gpu {
                                                  static_cast<i32>(dimensions.height),
                                                  static_cast<i32>(subresourceLayers.layerCount)}
                                 }
-                            }, vk::Filter::eLinear);
+                            }, vk::Filter::eNearest); // The dimensions of both images are identical so no filtering is required
                     } else {
                         commandBuffer.copyImage(sourceBacking, vk::ImageLayout::eTransferSrcOptimal, destinationBacking, vk::ImageLayout::eTransferDstOptimal, vk::ImageCopy{
                             .srcSubresource = subresourceLayers,
@@ -985,8 +1867,9 @@ namespace skyline::gpu {
                     }
                 }
 
+                // The copy is the only prior access to either image in this command buffer so the transfer stage is all that needs to be waited on
                 if (layout != vk::ImageLayout::eTransferDstOptimal)
-                    commandBuffer.pipelineBarrier(vk::PipelineStageFlagBits::eAllCommands, vk::PipelineStageFlagBits::eAllCommands, {}, {}, {}, vk::ImageMemoryBarrier{
+                    commandBuffer.pipelineBarrier(vk::PipelineStageFlagBits::eTransfer, vk::PipelineStageFlagBits::eAllCommands, {}, {}, {}, vk::ImageMemoryBarrier{
                         .image = destinationBacking,
                         .srcAccessMask = vk::AccessFlagBits::eTransferWrite,
                         .dstAccessMask = vk::AccessFlagBits::eMemoryRead,
@@ -998,7 +1881,7 @@ namespace skyline::gpu {
                         });
 
                 if (source->layout != vk::ImageLayout::eTransferSrcOptimal)
-                    commandBuffer.pipelineBarrier(vk::PipelineStageFlagBits::eAllCommands, vk::PipelineStageFlagBits::eAllCommands, {}, {}, {}, vk::ImageMemoryBarrier{
+                    commandBuffer.pipelineBarrier(vk::PipelineStageFlagBits::eTransfer, vk::PipelineStageFlagBits::eAllCommands, {}, {}, {}, vk::ImageMemoryBarrier{
                         .image = sourceBacking,
                         .srcAccessMask = vk::AccessFlagBits::eTransferRead,
                         .dstAccessMask = vk::AccessFlagBits::eMemoryWrite,
@@ -1031,6 +1914,7 @@ namespace skyline::gpu {
 
         if (renderPassUsage == texture::RenderPassUsage::RenderTarget) {
             everUsedAsRt = true;
+            uploadHash = 0;
             pendingStageMask = vk::PipelineStageFlagBits::eVertexShader |
                 vk::PipelineStageFlagBits::eTessellationControlShader |
                 vk::PipelineStageFlagBits::eTessellationEvaluationShader |
@@ -1048,6 +1932,49 @@ namespace skyline::gpu {
         return lastRenderPassUsage;
     }
 
+    void Texture::UpdateAttachmentUsage(bool cleared) {
+        if (transientIneligible)
+            return;
+
+        if (cleared)
+            transientClearCount++;
+        else
+            DisallowTransientBacking(); // The contents of the texture are read by the render pass so they must be retained
+    }
+
+    void Texture::UpdateTransientBacking(const vk::raii::CommandBuffer &commandBuffer, const std::shared_ptr<FenceCycle> &pCycle) {
+        if (!transientIneligible && !transientBacking && transientClearCount >= TransientClearThreshold && std::holds_alternative<memory::Image>(backing)) {
+            TRACE_EVENT("gpu", "Texture::UpdateTransientBacking");
+
+            // The prior backing is used by commands in the supplied cycle, it's kept alive till the cycle has been signalled
+            retiredBackings.push_back(std::make_shared<RetiredBacking>(RetiredBacking{std::move(backing), std::move(views)}));
+            views.clear();
+            transientBacking = true;
+            usage = (usage & (vk::ImageUsageFlagBits::eColorAttachment | vk::ImageUsageFlagBits::eDepthStencilAttachment | vk::ImageUsageFlagBits::eInputAttachment)) | vk::ImageUsageFlagBits::eTransientAttachment;
+            backingGeneration++;
+            AllocateBacking();
+
+            commandBuffer.pipelineBarrier(vk::PipelineStageFlagBits::eTopOfPipe, vk::PipelineStageFlagBits::eBottomOfPipe, {}, {}, {}, vk::ImageMemoryBarrier{
+                .image = GetBacking(),
+                .srcAccessMask = vk::AccessFlagBits::eNoneKHR,
+                .dstAccessMask = vk::AccessFlagBits::eNoneKHR,
+                .oldLayout = std::exchange(layout, vk::ImageLayout::eGeneral),
+                .newLayout = vk::ImageLayout::eGeneral,
+                .srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
+                .dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
+                .subresourceRange = {
+                    .aspectMask = format->vkAspect,
+                    .levelCount = levelCount,
+                    .layerCount = layerCount,
+                },
+            });
+        }
+
+        for (const auto &retiredBacking : retiredBackings)
+            pCycle->AttachObject(retiredBacking);
+        retiredBackings.clear();
+    }
+
     vk::PipelineStageFlags Texture::GetReadStageMask() {
         return readStageMask;
     }
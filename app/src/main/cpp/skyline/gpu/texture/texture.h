@@ -60,8 +60,37 @@ namespace skyline::gpu {
             constexpr operator bool() const {
                 return width && height && depth;
             }
+
+            /**
+             * @return The dimensions scaled by the supplied render scale, the width and height are rounded to the nearest texel and never scaled below a single texel
+             */
+            Dimensions Scale(float scale) const {
+                if (scale == 1.0f) [[likely]]
+                    return *this;
+
+                return Dimensions{std::max(static_cast<u32>(std::lround(width * scale)), 1U), std::max(static_cast<u32>(std::lround(height * scale)), 1U), depth};
+            }
         };
 
+        /**
+         * @return The supplied rectangle in guest texels scaled by a render scale, the scaled rectangle covers every host texel that's partially covered by the guest rectangle
+         * @note Any edge of the rectangle that's beyond the range of an i32 is clamped to it, this allows scaling rectangles that are used to represent an unbounded region
+         */
+        inline vk::Rect2D ScaleRect(vk::Rect2D rect, float scale) {
+            if (scale == 1.0f) [[likely]]
+                return rect;
+
+            constexpr double Limit{std::numeric_limits<i32>::max()};
+            auto scaleStart{[scale](i32 value) { return static_cast<i32>(std::clamp(std::floor(value * static_cast<double>(scale)), -Limit, Limit)); }};
+            auto scaleEnd{[scale](i64 value) { return static_cast<i64>(std::clamp(std::ceil(value * static_cast<double>(scale)), -Limit, Limit)); }};
+
+            vk::Offset2D offset{scaleStart(rect.offset.x), scaleStart(rect.offset.y)};
+            return vk::Rect2D{offset, {
+                static_cast<u32>(std::max(scaleEnd(i64{rect.offset.x} + rect.extent.width) - offset.x, i64{})),
+                static_cast<u32>(std::max(scaleEnd(i64{rect.offset.y} + rect.extent.height) - offset.y, i64{})),
+            }};
+        }
+
         /**
          * @note Blocks refers to the atomic unit of a compressed format (IE: The minimum amount of data that can be decompressed)
          */
@@ -128,6 +157,16 @@ namespace skyline::gpu {
                         }) && (vkAspect & other.vkAspect) != vk::ImageAspectFlags{});
             }
 
+            /**
+             * @return If a view with the supplied format can be created of an image with the current format that was created with VK_IMAGE_CREATE_MUTABLE_FORMAT_BIT
+             * @note Uncompressed color formats are view-compatible as long as they have the same texel block size
+             */
+            constexpr bool IsViewCompatible(const FormatBase &other) const {
+                return vkFormat == other.vkFormat
+                    || (vkAspect == vk::ImageAspectFlagBits::eColor && other.vkAspect == vk::ImageAspectFlagBits::eColor &&
+                        !IsCompressed() && !other.IsCompressed() && bpb == other.bpb);
+            }
+
             /**
              * @brief Determines the image aspect to use based off of the format and the first swizzle component
              */
@@ -319,6 +358,7 @@ namespace skyline::gpu {
     class TextureView : public std::enable_shared_from_this<TextureView> {
       private:
         vk::ImageView vkView{};
+        u32 backingGeneration{}; //!< The backing generation of the texture which `vkView` was created for
 
       public:
         LockableSharedPtr<Texture> texture;
@@ -360,10 +400,17 @@ namespace skyline::gpu {
 
         /**
          * @return A VkImageView that corresponds to the properties of this view
+         * @note If the texture has a transient backing, it's replaced with a regular one as the view might be used for more than a render pass attachment
          * @note The texture **must** be locked prior to calling this
          */
         vk::ImageView GetView();
 
+        /**
+         * @brief Same as GetView but the returned view **must** only be used as a render pass attachment, this allows the texture to retain a transient backing
+         * @note The texture **must** be locked prior to calling this
+         */
+        vk::ImageView GetAttachmentView();
+
         bool operator==(const TextureView &rhs) {
             return texture == rhs.texture && type == rhs.type && format == rhs.format && mapping == rhs.mapping && range == rhs.range;
         }
@@ -391,7 +438,12 @@ namespace skyline::gpu {
             GpuDirty, //!< The GPU texture has been modified but the CPU mappings have not been updated
         } dirtyState{DirtyState::CpuDirty}; //!< The state of the CPU mappings with respect to the GPU texture
         bool memoryFreed{}; //!< If the guest backing memory has been freed
+        std::vector<u64> cpuDirtySubresources; //!< A bitmap of the subresources of the texture that were written to on the CPU while CpuDirty, a subresource's bit is at `(layer * levelCount + level)`, this is empty if the texture doesn't support partial synchronization
+        bool cpuDirtySubresourcesValid{}; //!< If `cpuDirtySubresources` contains all CPU modifications, the entire texture is treated as dirty otherwise
         std::recursive_mutex stateMutex; //!< Synchronizes access to the dirty state
+        bool backingEvicted{}; //!< If the texture has no backing as it was either evicted by the texture manager or never used by the GPU, it's (re)created from guest memory when the texture is next used
+        u32 backingGeneration{}; //!< Incremented whenever the backing is evicted or replaced, this invalidates any VkImageView cached by a TextureView
+        std::optional<memory::Image> guestResolutionImage; //!< An image at the guest resolution of a scaled texture, CPU synchronization goes through this image and is blitted to and from the scaled backing
 
         /**
          * @brief Storage for all metadata about a specific view into the buffer, used to prevent redundant view creation and duplication of VkBufferView(s)
@@ -409,27 +461,141 @@ namespace skyline::gpu {
         std::vector<TextureViewStorage> views;
 
         std::shared_ptr<memory::StagingBuffer> downloadStagingBuffer{};
+        std::optional<memory::Buffer> conversionBuffer; //!< A buffer holding the host format copy of the texture followed by its conversion back into the guest format, this is used for readbacks of textures with a host format converted on the GPU
+        std::optional<memory::ImportedBuffer> importedMirror; //!< An import of `alignedMirror` as a GPU buffer, this is used for synchronization in place of staging buffers for textures with a linear guest layout when direct memory import is enabled
+        vk::DeviceSize importedMirrorOffset{}; //!< The offset of `mirror` in `importedMirror`
+        u32 importedMirrorRowLength{}; //!< The length of a row in `importedMirror` in texels or 0 if rows are tightly packed
 
         u32 lastRenderPassIndex{}; //!< The index of the last render pass that used this texture
         texture::RenderPassUsage lastRenderPassUsage{texture::RenderPassUsage::None}; //!< The type of usage in the last render pass
         bool everUsedAsRt{}; //!< If this texture has ever been used as a rendertarget
+        u64 uploadHash{}; //!< The hash of the guest contents of the texture at the last guest -> host synchronization, this is 0 if it's unknown or if the backing has been modified by anything else since then
         vk::PipelineStageFlags pendingStageMask{}; //!< List of pipeline stages that are yet to be flushed for reads since the last time this texture was used an an RT
         vk::PipelineStageFlags readStageMask{}; //!< Set of pipeline stages that this texture has been read in since it was last used as an RT
 
+        static constexpr u32 TransientClearThreshold{32}; //!< The amount of render passes that a texture must be cleared at the start of without any other usage before it's given a transient backing
+        u32 transientClearCount{}; //!< The amount of render passes that have cleared the texture at their start
+        bool transientIneligible{true}; //!< If the texture can never have a transient backing, this is the case after any usage that requires its contents to be retained
+        bool transientBacking{}; //!< If the backing is a transient attachment with lazily allocated memory, its contents are undefined outside of a render pass
+
+        /**
+         * @brief A backing which was replaced while it might still be used by the GPU alongside the views into it
+         */
+        struct RetiredBacking {
+            BackingType backing;
+            std::vector<TextureViewStorage> views;
+        };
+        std::vector<std::shared_ptr<RetiredBacking>> retiredBackings; //!< Backings replaced since the texture was last attached to an execution, they're kept alive by the cycle of the next execution that uses the texture
+
         friend TextureManager;
         friend TextureView;
 
+        /**
+         * @brief Allocates a backing for the guest texture based on the attributes of the texture, it's initially in the eUndefined layout
+         */
+        void AllocateBacking();
+
+        /**
+         * @brief Writes back the contents of the texture to the guest and frees its backing, it'll be restored with the contents of guest memory when it's next used
+         * @return If the backing could be evicted, this isn't possible while the texture is in use by the GPU or if the contents can't be written back to the guest
+         * @note The texture **must** be locked prior to calling this
+         */
+        bool EvictBacking();
+
+        /**
+         * @brief Replaces a transient backing with a regular one and prevents the texture from being given a transient backing in the future
+         * @note This must be called prior to any usage of the texture other than as a render pass attachment, the contents of a transient backing are undefined so they're lost after this
+         * @note The texture **must** be locked prior to calling this
+         */
+        void DisallowTransientBacking();
+
         /**
          * @brief Sets up mirror mappings for the guest mappings, this must be called after construction for the mirror to be valid
          */
         void SetupGuestMappings();
 
+        /**
+         * @brief Imports the guest mirror as a GPU buffer if the guest layout of the texture allows it to be directly copied to and from
+         */
+        void SetupDirectImport();
+
+        /**
+         * @return If synchronization should copy directly to and from the imported mirror rather than going through a staging buffer
+         */
+        bool UseImportedMirror();
+
+        /**
+         * @return If the guest contents of the texture are identical to those of the last guest -> host synchronization, the backing still contains them in that case so synchronization can be skipped
+         * @note This is only checked when redundant upload skipping is enabled, the hash of the last synchronization is updated to the current guest contents
+         */
+        bool IsUploadRedundant();
+
+        /**
+         * @return If CPU writes to the texture can be tracked at subresource granularity so that only the written subresources need to be synchronized to the host
+         */
+        bool SupportsPartialSync();
+
+        /**
+         * @brief Marks the texture as CPU dirty with only the subresources overlapping the supplied region of guest memory requiring synchronization
+         * @note `stateMutex` must be locked when calling this function
+         */
+        void MarkCpuDirtyRegion(span<u8> region);
+
+        /**
+         * @brief Marks the texture as CPU dirty with the entire texture requiring synchronization
+         * @note `stateMutex` must be locked when calling this function
+         */
+        void MarkCpuDirtyAll();
+
+        /**
+         * @brief Marks the subresources written by any CPU writes recorded by the write tracker as CPU dirty
+         * @note `stateMutex` must be locked when calling this function
+         */
+        void CollectTrackedCpuWrites();
+
+        /**
+         * @brief An implementation function for guest -> host texture synchronization of only the supplied subresources, it allocates and copies their data into a staging buffer
+         * @param dirtySubresources A bitmap of the subresources to synchronize in the same format as `cpuDirtySubresources`
+         * @param bufferImageCopies The buffer image copies from the returned staging buffer to the texture's backing are appended to this
+         * @return A staging buffer filled with the guest data of the subresources or nullptr if there are no subresources to synchronize
+         */
+        std::shared_ptr<memory::StagingBuffer> SynchronizeHostPartialImpl(const std::vector<u64> &dirtySubresources, boost::container::small_vector<vk::BufferImageCopy, 10> &bufferImageCopies);
+
         /**
          * @brief An implementation function for guest -> host texture synchronization, it allocates and copies data into a staging buffer or directly into a linear host texture
          * @return If a staging buffer was required for the texture sync, it's returned filled with guest texture data and must be copied to the host texture by the callee
          */
         std::shared_ptr<memory::StagingBuffer> SynchronizeHostImpl();
 
+        /**
+         * @brief An implementation function for guest -> host texture synchronization which deswizzles and decodes the texture on the GPU using compute shaders
+         * @return If the texture could be synchronized on the GPU, if not then the CPU path must be used instead
+         * @note The supplied cycle will be attached to the texture if the sync was recorded
+         */
+        bool SynchronizeHostGpu(const vk::raii::CommandBuffer &commandBuffer, const std::shared_ptr<FenceCycle> &pCycle);
+
+        /**
+         * @brief Submits a command buffer uploading to the texture, this is done on the transfer queue when it's available
+         * @return The cycle of the submission, the texture cycle must be chained to it by the caller
+         */
+        std::shared_ptr<FenceCycle> SubmitUpload(const std::function<void(vk::raii::CommandBuffer &)> &recordFunction);
+
+        /**
+         * @return If the texture can have a host resolution that differs from its guest resolution, this requires the backing to support being blitted to and from an image at the guest resolution
+         */
+        bool CanScale();
+
+        /**
+         * @return An image at the guest resolution for synchronizing a scaled texture, it's allocated on first use and retained till the backing is evicted
+         */
+        vk::Image GetGuestResolutionImage();
+
+        /**
+         * @brief Records a blit between the backing of a scaled texture and its guest resolution image into the supplied command buffer, the image is transitioned to eGeneral if it's being written to
+         * @param toBacking If the blit is from the guest resolution image to the backing rather than the other way around
+         */
+        void RecordScaleBlit(const vk::raii::CommandBuffer &commandBuffer, vk::Image guestImage, bool toBacking);
+
         /**
          * @brief Records commands for copying data from a staging buffer to the texture's backing into the supplied command buffer
          */
@@ -454,9 +620,13 @@ namespace skyline::gpu {
         void FreeGuest();
 
         /**
+         * @param baseOffset The offset of the texture data in the buffer being copied to or from
+         * @param bufferRowLength The length of a row in the buffer in texels or 0 if rows are tightly packed
          * @return A vector of all the buffer image copies that need to be done for every aspect of every level of every layer of the texture
          */
-        boost::container::small_vector<vk::BufferImageCopy, 10> GetBufferImageCopies();
+        boost::container::small_vector<vk::BufferImageCopy, 10> GetBufferImageCopies(vk::DeviceSize baseOffset = 0, u32 bufferRowLength = 0);
+
+        static constexpr u32 MinimumScaledDimension{64}; //!< The minimum width and height of a texture for it to be scaled, smaller render targets are commonly used for reductions that rely on their exact size
 
         static constexpr size_t FrequentlyLockedThreshold{2}; //!< Threshold for the number of times a texture can be locked (not from context locks, only normal) before it should be considered frequently locked
         size_t accumulatedCpuLockCounter{};
@@ -466,10 +636,16 @@ namespace skyline::gpu {
         size_t accumulatedGuestWaitCounter{}; //!< Total number of times the texture has been waited on
         std::chrono::nanoseconds accumulatedGuestWaitTime{}; //!< Amount of time the texture has been waited on for since the `SkipReadbackHackWaitCountThreshold`th wait on it by the guest
 
+        static constexpr u32 AsyncReadbackThreshold{2}; //!< The amount of guest readbacks of a GPU dirty texture after which it'll be read back asynchronously at the end of every execution that it's used in
+        u32 guestReadbackCount{}; //!< The amount of times the contents of the texture have been read back into guest memory after being GPU dirty
+        std::shared_ptr<FenceCycle> readbackCycle; //!< The cycle of the last execution which used the texture if it copies the texture into `downloadStagingBuffer` at its end, this is protected by the texture's mutex
+
       public:
         std::shared_ptr<FenceCycle> cycle; //!< A fence cycle for when any host operation mutating the texture has completed, it must be waited on prior to any mutations to the backing
+        std::atomic<i64> lastUseTime{}; //!< The time at which the texture was last attached to an execution in nanoseconds, this is used to find the least recently used textures for eviction
         std::optional<GuestTexture> guest;
-        texture::Dimensions dimensions;
+        texture::Dimensions dimensions; //!< The dimensions of the host backing, this differs from the guest dimensions for scaled textures
+        float renderScale{1.0f}; //!< The scale of the host resolution relative to the guest resolution, scaled textures are always 2D with a single level and layer
         texture::Format format;
         vk::ImageLayout layout;
         vk::ImageTiling tiling;
@@ -493,9 +669,11 @@ namespace skyline::gpu {
 
         /**
          * @brief Creates a texture object wrapping the guest texture with a backing that can represent the guest texture data
+         * @param renderScale The requested scale of the host resolution relative to the guest resolution, it's ignored if the texture can't be scaled
          * @note The guest mappings will not be setup until SetupGuestMappings() is called
+         * @note The backing isn't allocated till the texture is first used by the GPU, see RestoreBacking()
          */
-        Texture(GPU &gpu, GuestTexture guest);
+        Texture(GPU &gpu, GuestTexture guest, float renderScale = 1.0f);
 
         ~Texture();
 
@@ -539,10 +717,24 @@ namespace skyline::gpu {
         /**
          * @brief Waits on the texture backing to be a valid non-null Vulkan image
          * @return If the mutex could be unlocked during the function
+         * @note If the backing has been evicted then it's restored rather than waited on
          * @note The texture **must** be locked prior to calling this
          */
         bool WaitOnBacking();
 
+        /**
+         * @brief Recreates the backing of the texture if it has been evicted, the texture will be synchronized from guest memory on its next use
+         * @note The texture **must** be locked prior to calling this
+         */
+        void RestoreBacking();
+
+        /**
+         * @brief Drops any CPU dirty contents of a texture without a backing as they're going to be overwritten in their entirety by the GPU, this avoids uploading contents which are never read
+         * @note This must only be called if the first usage of the texture after this entirely overwrites all of its subresources
+         * @note The texture **must** be locked prior to calling this
+         */
+        void DiscardContents();
+
         /**
          * @brief Waits on a fence cycle if it exists till it's signalled and resets it after
          * @note The texture **must** be locked prior to calling this
@@ -555,12 +747,39 @@ namespace skyline::gpu {
          */
         void SwapBacking(BackingType &&backing, vk::ImageLayout layout = vk::ImageLayout::eUndefined);
 
+        /**
+         * @brief Replaces the backing of a scaled texture with one at the guest resolution while retaining its contents, this is a no-op for unscaled textures
+         * @note The texture **must** be locked prior to calling this and must not be in use by any unsubmitted executions as the prior backing and its views are destroyed
+         */
+        void Descale();
+
         /**
          * @brief Transitions the backing to the supplied layout, if the backing already is in this layout then this does nothing
          * @note The texture **must** be locked prior to calling this
          */
         void TransitionLayout(vk::ImageLayout layout);
 
+        /**
+         * @brief Records commands for copying data from a buffer containing linear host texture data to the texture's backing into the supplied command buffer
+         * @param offset The offset of the texture data in the buffer
+         * @param bufferRowLength The length of a row in the buffer in texels or 0 if rows are tightly packed
+         */
+        void CopyFromBuffer(const vk::raii::CommandBuffer &commandBuffer, vk::Buffer buffer, vk::DeviceSize offset = 0, u32 bufferRowLength = 0);
+
+        /**
+         * @brief Records commands for copying data from the texture's backing to the supplied region of a buffer into the supplied command buffer
+         * @param bufferRowLength The length of a row in the buffer in texels or 0 if rows are tightly packed
+         * @note Any caller **must** ensure that the layout is not `eUndefined`
+         */
+        void CopyIntoBuffer(const vk::raii::CommandBuffer &commandBuffer, vk::Buffer buffer, vk::DeviceSize offset, vk::DeviceSize size, u32 bufferRowLength = 0);
+
+        /**
+         * @brief Copies the texture into `conversionBuffer` and converts it back into the guest format on the GPU, this blocks till the conversion is complete
+         * @param conversion The conversion as returned by FormatConversionHelperShader::GetConversion
+         * @return A pointer to the linear texture data in the guest format
+         */
+        u8 *ReadbackConverted(u32 conversion);
+
         /**
          * @brief Marks the texture as being GPU dirty
          */
@@ -582,6 +801,14 @@ namespace skyline::gpu {
          */
         void SynchronizeHostInline(const vk::raii::CommandBuffer &commandBuffer, const std::shared_ptr<FenceCycle> &cycle, bool gpuDirty = false);
 
+        /**
+         * @brief Synchronizes the host texture with the guest on the transfer queue if the upload is large enough to benefit from overlapping with rendering
+         * @param gpuDirty If true, the texture will be transitioned to being GpuDirty by this call
+         * @return The timeline semaphore point signalled by the upload which must be waited on by the submission that consumes the texture, this is empty if nothing was submitted in which case SynchronizeHostInline should be used instead
+         * @note The texture **must** be locked prior to calling this
+         */
+        std::optional<FenceCycle::TimelinePoint> SynchronizeHostAsync(bool gpuDirty = false);
+
         /**
          * @brief Synchronizes the guest texture with the host texture after it has been modified
          * @param cpuDirty If true, the texture will be transitioned to being CpuDirty by this call
@@ -591,6 +818,30 @@ namespace skyline::gpu {
          */
         void SynchronizeGuest(bool cpuDirty = false, bool skipTrap = false);
 
+        /**
+         * @brief Prepares the texture for being read back into guest memory asynchronously after the supplied execution, this is done for textures which are frequently read back by the guest
+         * @return If the texture should be read back, RecordAsyncReadback must be called at the end of the execution and CompleteAsyncReadback after it has completed in that case
+         * @note This must be called for every execution that the texture is used in as any readback from a prior execution becomes stale
+         * @note The texture **must** be locked prior to calling this
+         */
+        bool RequestAsyncReadback(const std::shared_ptr<FenceCycle> &pCycle);
+
+        /**
+         * @brief Records a copy of the texture into the download staging buffer into the supplied command buffer
+         */
+        void RecordAsyncReadback(const vk::raii::CommandBuffer &commandBuffer);
+
+        /**
+         * @brief Copies the contents of the download staging buffer into guest memory if the readback from the supplied execution is still current, the guest will not need to block on the texture after this
+         * @note The supplied cycle **must** be signalled, if the texture is locked by another thread the readback will be left for a guest access to complete
+         */
+        void CompleteAsyncReadback(const std::shared_ptr<FenceCycle> &pCycle);
+
+        /**
+         * @return If a guest texture with the supplied format can be represented by a view of this texture with that format rather than requiring a separate texture
+         */
+        bool CanAliasFormat(texture::Format pFormat);
+
         /**
          * @return A cached or newly created view into this texture with the supplied attributes
          */
@@ -628,6 +879,26 @@ namespace skyline::gpu {
          */
         texture::RenderPassUsage GetLastRenderPassUsage();
 
+        /**
+         * @brief Records a usage of the texture as a render pass attachment, this is used to determine if it should be given a transient backing
+         * @param cleared If the entire contents of the attachment were cleared at the start of the render pass rather than loaded
+         */
+        void UpdateAttachmentUsage(bool cleared);
+
+        /**
+         * @return If the texture has a transient backing, its contents don't need to be stored at the end of a render pass as they're never read
+         */
+        bool HasTransientBacking() {
+            return transientBacking;
+        }
+
+        /**
+         * @brief Gives the texture a transient backing if it has been cleared at the start of enough render passes without any other usage, any backings replaced since the last call are attached to the supplied cycle
+         * @param commandBuffer The command buffer that a layout transition of a new backing is recorded into, this must be executed prior to any commands using the texture
+         * @note The texture **must** be locked prior to calling this
+         */
+        void UpdateTransientBacking(const vk::raii::CommandBuffer &commandBuffer, const std::shared_ptr<FenceCycle> &pCycle);
+
         /**
          * @return The set of stages this texture has been read in since it was last used as an RT
          */
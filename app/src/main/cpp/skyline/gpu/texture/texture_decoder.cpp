@@ -0,0 +1,164 @@
+// SPDX-License-Identifier: MPL-2.0
+// Copyright © 2022 Skyline Team and Contributors (https://github.com/skyline-emu/)
+
+#include <common/trace.h>
+#include "texture_decoder.h"
+#include "bc_decoder.h"
+#include "bc_transcoder.h"
+#include "astc_decoder.h"
+
+namespace skyline::gpu {
+    /**
+     * @brief Expands packed B5G6R5 or B5G5R5A1 pixels into R8G8B8A8, this matches the conversion done by the format conversion helper shader
+     * @param hasAlpha If the pixels are in B5G5R5A1 rather than B5G6R5
+     */
+    static void ExpandPacked16(const u8 *src, u8 *dst, size_t width, size_t height, bool hasAlpha) {
+        auto widen{[](u16 pixel, u32 offset, u32 bits) -> u8 {
+            u32 component{(static_cast<u32>(pixel) >> offset) & ((1U << bits) - 1)};
+            return static_cast<u8>((component << (8 - bits)) | (component >> (2 * bits - 8)));
+        }};
+
+        auto srcPixels{reinterpret_cast<const u16 *>(src)};
+        for (size_t index{}; index < width * height; index++, dst += 4) {
+            u16 pixel{srcPixels[index]};
+            if (hasAlpha) {
+                dst[0] = widen(pixel, 1, 5);
+                dst[1] = widen(pixel, 6, 5);
+                dst[2] = widen(pixel, 11, 5);
+                dst[3] = (pixel & 1) ? 0xFF : 0;
+            } else {
+                dst[0] = widen(pixel, 0, 5);
+                dst[1] = widen(pixel, 5, 6);
+                dst[2] = widen(pixel, 11, 5);
+                dst[3] = 0xFF;
+            }
+        }
+    }
+
+    /**
+     * @brief Decodes a contiguous set of block rows from the guest format into the host format on the calling thread
+     * @note BC4 and BC5 may be transcoded into EAC rather than decoded depending on the host format
+     */
+    static void DecodeBand(texture::Format guestFormat, texture::Format hostFormat, const u8 *src, u8 *dst, size_t width, size_t height) {
+        bool transcodeToEac{hostFormat->vkFormat == vk::Format::eEacR11UnormBlock || hostFormat->vkFormat == vk::Format::eEacR11SnormBlock ||
+                            hostFormat->vkFormat == vk::Format::eEacR11G11UnormBlock || hostFormat->vkFormat == vk::Format::eEacR11G11SnormBlock};
+
+        switch (guestFormat->vkFormat) {
+            case vk::Format::eBc1RgbaUnormBlock:
+            case vk::Format::eBc1RgbaSrgbBlock:
+                bcn::DecodeBc1(src, dst, width, height, true);
+                break;
+
+            case vk::Format::eBc2UnormBlock:
+            case vk::Format::eBc2SrgbBlock:
+                bcn::DecodeBc2(src, dst, width, height);
+                break;
+
+            case vk::Format::eBc3UnormBlock:
+            case vk::Format::eBc3SrgbBlock:
+                bcn::DecodeBc3(src, dst, width, height);
+                break;
+
+            case vk::Format::eBc4UnormBlock:
+            case vk::Format::eBc4SnormBlock: {
+                bool isSigned{guestFormat->vkFormat == vk::Format::eBc4SnormBlock};
+                if (transcodeToEac)
+                    bcn::TranscodeBc4ToEac(src, dst, width, height, isSigned);
+                else
+                    bcn::DecodeBc4(src, dst, width, height, isSigned);
+                break;
+            }
+
+            case vk::Format::eBc5UnormBlock:
+            case vk::Format::eBc5SnormBlock: {
+                bool isSigned{guestFormat->vkFormat == vk::Format::eBc5SnormBlock};
+                if (transcodeToEac)
+                    bcn::TranscodeBc5ToEac(src, dst, width, height, isSigned);
+                else
+                    bcn::DecodeBc5(src, dst, width, height, isSigned);
+                break;
+            }
+
+            case vk::Format::eBc6HUfloatBlock:
+                bcn::DecodeBc6(src, dst, width, height, false);
+                break;
+            case vk::Format::eBc6HSfloatBlock:
+                bcn::DecodeBc6(src, dst, width, height, true);
+                break;
+
+            case vk::Format::eBc7UnormBlock:
+            case vk::Format::eBc7SrgbBlock:
+                bcn::DecodeBc7(src, dst, width, height);
+                break;
+
+            case vk::Format::eAstc4x4UnormBlock:
+            case vk::Format::eAstc5x4UnormBlock:
+            case vk::Format::eAstc5x5UnormBlock:
+            case vk::Format::eAstc6x5UnormBlock:
+            case vk::Format::eAstc6x6UnormBlock:
+            case vk::Format::eAstc8x5UnormBlock:
+            case vk::Format::eAstc8x6UnormBlock:
+            case vk::Format::eAstc8x8UnormBlock:
+            case vk::Format::eAstc10x5UnormBlock:
+            case vk::Format::eAstc10x6UnormBlock:
+            case vk::Format::eAstc10x8UnormBlock:
+            case vk::Format::eAstc10x10UnormBlock:
+            case vk::Format::eAstc12x10UnormBlock:
+            case vk::Format::eAstc12x12UnormBlock:
+                astc::DecodeAstc(src, dst, width, height, guestFormat->blockWidth, guestFormat->blockHeight, false);
+                break;
+            case vk::Format::eAstc4x4SrgbBlock:
+            case vk::Format::eAstc5x4SrgbBlock:
+            case vk::Format::eAstc5x5SrgbBlock:
+            case vk::Format::eAstc6x5SrgbBlock:
+            case vk::Format::eAstc6x6SrgbBlock:
+            case vk::Format::eAstc8x5SrgbBlock:
+            case vk::Format::eAstc8x6SrgbBlock:
+            case vk::Format::eAstc8x8SrgbBlock:
+            case vk::Format::eAstc10x5SrgbBlock:
+            case vk::Format::eAstc10x6SrgbBlock:
+            case vk::Format::eAstc10x8SrgbBlock:
+            case vk::Format::eAstc10x10SrgbBlock:
+            case vk::Format::eAstc12x10SrgbBlock:
+            case vk::Format::eAstc12x12SrgbBlock:
+                astc::DecodeAstc(src, dst, width, height, guestFormat->blockWidth, guestFormat->blockHeight, true);
+                break;
+
+            case vk::Format::eB5G6R5UnormPack16:
+                ExpandPacked16(src, dst, width, height, false);
+                break;
+            case vk::Format::eB5G5R5A1UnormPack16:
+                ExpandPacked16(src, dst, width, height, true);
+                break;
+
+            default:
+                throw exception("Unsupported guest format '{}'", vk::to_string(guestFormat->vkFormat));
+        }
+    }
+
+    void TextureDecoder::Decode(texture::Format guestFormat, texture::Format hostFormat, const u8 *src, u8 *dst, size_t width, size_t height) {
+        size_t hostBlockRowSize{util::DivideCeil<size_t>(width, hostFormat->blockWidth) * hostFormat->bpb}; //!< The size of a single row of blocks in the host format, this is a line of pixels for uncompressed formats
+        size_t threadCount{pool.get_thread_count()};
+        if (hostBlockRowSize * util::DivideCeil<size_t>(height, hostFormat->blockHeight) < ParallelDecodeThreshold || threadCount <= 1) [[likely]] {
+            DecodeBand(guestFormat, hostFormat, src, dst, width, height);
+            return;
+        }
+
+        TRACE_EVENT("gpu", "TextureDecoder::Decode", "width", width, "height", height);
+
+        // Bands are split on block row boundaries so every band can be decoded independently of the others, ASTC block heights aren't necessarily powers of two so the minimum height is aligned as well
+        size_t bandHeight{util::AlignUpNpot(std::max(util::DivideCeil(height, threadCount), MinimumBandHeight), guestFormat->blockHeight)};
+        size_t guestBandSize{util::DivideCeil<size_t>(width, guestFormat->blockWidth) * guestFormat->bpb * (bandHeight / guestFormat->blockHeight)};
+        size_t hostBandSize{hostBlockRowSize * (bandHeight / hostFormat->blockHeight)};
+
+        std::vector<std::future<void>> bandFutures;
+        for (size_t y{}; y < height; y += bandHeight, src += guestBandSize, dst += hostBandSize)
+            bandFutures.emplace_back(pool.submit(DecodeBand, guestFormat, hostFormat, src, dst, width, std::min(bandHeight, height - y)));
+
+        // All bands must be complete before any exceptions are propagated as they reference the caller's buffers
+        for (auto &future : bandFutures)
+            future.wait();
+        for (auto &future : bandFutures)
+            future.get();
+    }
+}
@@ -0,0 +1,28 @@
+// SPDX-License-Identifier: MPL-2.0
+// Copyright © 2022 Skyline Team and Contributors (https://github.com/skyline-emu/)
+
+#pragma once
+
+#include <BS_thread_pool.hpp>
+#include "texture.h"
+
+namespace skyline::gpu {
+    /**
+     * @brief A front-end for the software texture decoders which splits large levels into bands of block rows that are decoded in parallel on a worker pool
+     */
+    class TextureDecoder {
+      private:
+        BS::thread_pool pool;
+
+      public:
+        static constexpr size_t ParallelDecodeThreshold{256 * 1024}; //!< The minimum size of a decoded level in bytes for it to be split across the worker pool, smaller levels are decoded inline as the dispatch overhead would outweigh any gains
+        static constexpr size_t MinimumBandHeight{32}; //!< The minimum height of a single band in pixels, this is rounded up to a multiple of the format block height
+
+        /**
+         * @brief Decodes a single level of a compressed texture from the guest format into the host format
+         * @param height The height of the level in pixels, this may contain several layers stacked vertically
+         * @note This will block until the entire level has been decoded
+         */
+        void Decode(texture::Format guestFormat, texture::Format hostFormat, const u8 *src, u8 *dst, size_t width, size_t height);
+    };
+}
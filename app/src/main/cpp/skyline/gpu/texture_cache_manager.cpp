@@ -0,0 +1,172 @@
+// SPDX-License-Identifier: MPL-2.0
+// Copyright © 2022 Skyline Team and Contributors (https://github.com/skyline-emu/)
+
+#include <fstream>
+#include <charconv>
+#include <filesystem>
+#include <lz4.h>
+#include <common/trace.h>
+#include <common/host_affinity.h>
+#include "texture_cache_manager.h"
+
+namespace skyline::gpu {
+    struct TextureCacheFileHeader {
+        static constexpr u32 Magic{util::MakeMagic<u32>("TXCH")}; //!< The magic value used to identify a texture cache file
+        static constexpr u32 Version{1}; //!< The version of the texture cache file format, MUST be incremented for any format changes
+
+        u32 magic{Magic};
+        u32 version{Version};
+        u64 key; //!< The key of the texture, this is used to verify that the file corresponds to the expected texture
+        u64 decompressedSize; //!< The size of the host texture payload
+        u64 compressedSize; //!< The size of the LZ4 compressed data following the header
+
+        /**
+         * @brief Checks if the header is valid
+         */
+        bool IsValid() {
+            return magic == Magic && version == Version;
+        }
+    };
+
+    /**
+     * @brief All parameters of a texture which affect its host payload, this is hashed alongside the texture's guest data to form a key
+     */
+    struct TextureCacheKeyDescriptor {
+        vk::Format guestFormat;
+        vk::Format hostFormat;
+        texture::Dimensions dimensions;
+        texture::TileMode tileMode;
+        u32 tileParameter; //!< The block height and depth of block-linear textures or the pitch of pitch-linear textures
+        u32 layerCount;
+        u32 layerStride;
+        u32 levelCount;
+    };
+
+    void TextureCacheManager::Run() {
+        pthread_setname_np(pthread_self(), "Sky-TexCache");
+        HostAffinity::PlaceCurrentThread(HostThreadRole::Background);
+
+        while (true) {
+            std::unique_lock lock{writeMutex};
+            writeCondition.wait(lock, [this] { return !writeQueue.empty(); });
+            auto [key, payload]{std::move(writeQueue.front())};
+            writeQueue.pop();
+            pendingWriteSize -= payload.size();
+            lock.unlock();
+
+            TRACE_EVENT("gpu", "TextureCacheManager::Write");
+
+            std::vector<char> compressed(static_cast<size_t>(LZ4_compressBound(static_cast<int>(payload.size()))));
+            int compressedSize{LZ4_compress_default(reinterpret_cast<const char *>(payload.data()), compressed.data(), static_cast<int>(payload.size()), static_cast<int>(compressed.size()))};
+            if (compressedSize <= 0) {
+                Logger::Warn("Failed to compress texture 0x{:016X} for the texture cache", key);
+                continue;
+            }
+
+            // Write to a temporary file first so that a partially written file is never visible under the final name
+            auto path{GetPath(key)}, temporaryPath{path + ".tmp"};
+            {
+                std::ofstream stream{temporaryPath, std::ios::binary | std::ios::trunc};
+                TextureCacheFileHeader header{
+                    .key = key,
+                    .decompressedSize = payload.size(),
+                    .compressedSize = static_cast<u64>(compressedSize),
+                };
+                stream.write(reinterpret_cast<const char *>(&header), sizeof(TextureCacheFileHeader));
+                stream.write(compressed.data(), compressedSize);
+                if (stream.fail()) {
+                    Logger::Warn("Failed to write texture 0x{:016X} to the texture cache", key);
+                    continue;
+                }
+            }
+
+            std::error_code error;
+            std::filesystem::rename(temporaryPath, path, error);
+            if (!error) {
+                std::scoped_lock entryLock{entryMutex};
+                entries.emplace(key);
+            }
+        }
+    }
+
+    std::string TextureCacheManager::GetPath(u64 key) {
+        return fmt::format("{}{:016X}", directory, key);
+    }
+
+    TextureCacheManager::TextureCacheManager(const std::string &directory) : directory{directory} {
+        std::filesystem::create_directories(directory);
+
+        for (const auto &entry : std::filesystem::directory_iterator{directory}) {
+            if (!entry.is_regular_file())
+                continue;
+
+            auto name{entry.path().filename().string()};
+            if (name.ends_with(".tmp")) {
+                std::filesystem::remove(entry.path()); // Remove any temporary files which were left behind by an interrupted write
+                continue;
+            }
+
+            u64 key{};
+            auto result{std::from_chars(name.data(), name.data() + name.size(), key, 16)};
+            if (result.ec == std::errc{} && result.ptr == name.data() + name.size())
+                entries.emplace(key);
+        }
+
+        writerThread = std::thread(&TextureCacheManager::Run, this);
+    }
+
+    u64 TextureCacheManager::GetKey(const GuestTexture &guest, texture::Format hostFormat, u32 levelCount, span<u8> guestData) {
+        TextureCacheKeyDescriptor descriptor{
+            .guestFormat = guest.format->vkFormat,
+            .hostFormat = hostFormat->vkFormat,
+            .dimensions = guest.dimensions,
+            .tileMode = guest.tileConfig.mode,
+            .tileParameter = guest.tileConfig.mode == texture::TileMode::Block ? (static_cast<u32>(guest.tileConfig.blockHeight) | (static_cast<u32>(guest.tileConfig.blockDepth) << 8)) : (guest.tileConfig.mode == texture::TileMode::Pitch ? guest.tileConfig.pitch : 0),
+            .layerCount = guest.layerCount,
+            .layerStride = guest.layerStride,
+            .levelCount = levelCount,
+        };
+
+        return XXH64(guestData.data(), guestData.size(), XXH64(&descriptor, sizeof(TextureCacheKeyDescriptor), 0));
+    }
+
+    bool TextureCacheManager::Load(u64 key, span<u8> output) {
+        {
+            std::scoped_lock lock{entryMutex};
+            if (!entries.contains(key))
+                return false;
+        }
+
+        TRACE_EVENT("gpu", "TextureCacheManager::Load");
+
+        auto path{GetPath(key)};
+        std::ifstream stream{path, std::ios::binary};
+        TextureCacheFileHeader header{};
+        stream.read(reinterpret_cast<char *>(&header), sizeof(TextureCacheFileHeader));
+
+        if (!stream.fail() && header.IsValid() && header.key == key && header.decompressedSize == output.size()) {
+            std::vector<char> compressed(header.compressedSize);
+            stream.read(compressed.data(), static_cast<std::streamsize>(compressed.size()));
+            if (!stream.fail() && LZ4_decompress_safe(compressed.data(), reinterpret_cast<char *>(output.data()), static_cast<int>(compressed.size()), static_cast<int>(output.size())) == static_cast<int>(output.size()))
+                return true;
+        }
+
+        Logger::Warn("Discarding invalid texture cache file for texture 0x{:016X}", key);
+        stream.close();
+        std::filesystem::remove(path);
+
+        std::scoped_lock lock{entryMutex};
+        entries.erase(key);
+        return false;
+    }
+
+    void TextureCacheManager::QueueWrite(u64 key, span<u8> payload) {
+        std::scoped_lock lock{writeMutex};
+        if (pendingWriteSize + payload.size() > MaxPendingWriteSize)
+            return;
+
+        pendingWriteSize += payload.size();
+        writeQueue.emplace(key, std::vector<u8>(payload.begin(), payload.end()));
+        writeCondition.notify_one();
+    }
+}
@@ -0,0 +1,54 @@
+// SPDX-License-Identifier: MPL-2.0
+// Copyright © 2022 Skyline Team and Contributors (https://github.com/skyline-emu/)
+
+#pragma once
+
+#include <queue>
+#include <unordered_set>
+#include <condition_variable>
+#include <common.h>
+#include "texture/texture.h"
+
+namespace skyline::gpu {
+    /**
+     * @brief Manages a persistent on-disk cache of LZ4 compressed host texture payloads, this allows skipping the deswizzle and decode of textures that are uploaded with identical contents across boots
+     * @note Every texture is stored in a separate file named after its key within the cache directory
+     */
+    class TextureCacheManager {
+      private:
+        std::string directory; //!< The directory containing all cached texture files
+        std::mutex entryMutex; //!< Protects access to the set of entries
+        std::unordered_set<u64> entries; //!< The keys of all textures that are present in the cache
+
+        std::thread writerThread;
+        std::queue<std::pair<u64, std::vector<u8>>> writeQueue; //!< The queue of uncompressed texture payloads to be compressed and written to the cache
+        size_t pendingWriteSize{}; //!< The total size of all payloads in the write queue
+        std::mutex writeMutex; //!< Protects access to the write queue
+        std::condition_variable writeCondition; //!< Notifies the writer thread when the write queue is not empty
+
+        static constexpr size_t MaxPendingWriteSize{64 * 1024 * 1024}; //!< The maximum size of all payloads in the write queue, any further writes are dropped to avoid excessive memory usage
+
+        void Run();
+
+        std::string GetPath(u64 key);
+
+      public:
+        TextureCacheManager(const std::string &directory);
+
+        /**
+         * @return A key for the texture which considers the contents of its guest memory alongside all layout parameters that affect the host payload
+         */
+        static u64 GetKey(const GuestTexture &guest, texture::Format hostFormat, u32 levelCount, span<u8> guestData);
+
+        /**
+         * @brief Loads the texture payload corresponding to the key into the supplied buffer
+         * @return If the texture was present in the cache and fully loaded into the buffer, the contents of the buffer are undefined otherwise
+         */
+        bool Load(u64 key, span<u8> output);
+
+        /**
+         * @brief Queues a texture payload to be compressed and written to the cache, the payload is copied and doesn't need to outlive this call
+         */
+        void QueueWrite(u64 key, span<u8> payload);
+    };
+}
@@ -2,13 +2,116 @@
 // Copyright © 2021 Skyline Team and Contributors (https://github.com/skyline-emu/)
 
 #include <common/trace.h>
+#include <common/settings.h>
+#include <gpu.h>
 #include "texture_manager.h"
 
 namespace skyline::gpu {
+    /**
+     * @return If the format of the guest texture can be used for a view of the texture, either due to being texel-layout compatible or due to the texture being able to alias it
+     */
+    static bool IsFormatCompatible(Texture &matchTexture, const GuestTexture &guestTexture) {
+        return matchTexture.guest->format->IsCompatible(*guestTexture.format) || matchTexture.CanAliasFormat(guestTexture.format);
+    }
+
+    /**
+     * @return If a texture with mappings that perfectly match the guest texture's mappings can be used for the guest texture
+     */
+    static bool IsFullMatchCompatible(Texture &matchTexture, const GuestTexture &guestTexture) {
+        auto &matchGuestTexture{*matchTexture.guest};
+        return IsFormatCompatible(matchTexture, guestTexture) &&
+            ((((matchGuestTexture.dimensions.width == guestTexture.dimensions.width &&
+                matchGuestTexture.dimensions.height == guestTexture.dimensions.height) || matchGuestTexture.CalculateLayerSize() == guestTexture.CalculateLayerSize()) &&
+                matchGuestTexture.GetViewDepth() <= guestTexture.GetViewDepth())
+                || matchGuestTexture.viewMipBase > 0)
+            && matchGuestTexture.tileConfig == guestTexture.tileConfig;
+    }
+
     TextureManager::TextureManager(GPU &gpu) : gpu(gpu) {}
 
-    std::shared_ptr<TextureView> TextureManager::FindOrCreate(const GuestTexture &guestTexture, ContextTag tag) {
+    std::shared_ptr<TextureView> TextureManager::LookupFullMatch(const GuestTexture &guestTexture, ContextTag tag) {
+        auto lookupTexture{textureTable[guestTexture.mappings.front().begin().base()]};
+        if (!lookupTexture || lookupTexture->replaced)
+            return nullptr;
+
+        auto &matchGuestTexture{*lookupTexture->guest};
+        bool mappingMatch{std::equal(matchGuestTexture.mappings.begin(), matchGuestTexture.mappings.end(), guestTexture.mappings.begin(), guestTexture.mappings.end(), [](const span<u8> &lhs, const span<u8> &rhs) {
+            return lhs.begin() == rhs.begin() && lhs.end() == rhs.end();
+        })};
+        if (!mappingMatch || !IsFullMatchCompatible(*lookupTexture, guestTexture))
+            return nullptr;
+
+        ContextLock textureLock{tag, *lookupTexture};
+        return lookupTexture->GetView(guestTexture.viewType, vk::ImageSubresourceRange{
+            .aspectMask = guestTexture.aspect,
+            .baseMipLevel = guestTexture.viewMipBase,
+            .levelCount = guestTexture.viewMipCount,
+            .baseArrayLayer = guestTexture.baseArrayLayer,
+            .layerCount = guestTexture.GetViewLayerCount(),
+        }, guestTexture.format, guestTexture.swizzle);
+    }
+
+    std::shared_ptr<Texture> TextureManager::LookupMapping(span<u8> mapping) {
+        std::scoped_lock lock{mutex};
+        auto lookupTexture{textureTable[mapping.begin().base()]};
+        if (!lookupTexture || lookupTexture->replaced)
+            return nullptr;
+
+        auto &mappings{lookupTexture->guest->mappings};
+        if (mappings.size() != 1 || mappings.front().begin() != mapping.begin() || mappings.front().end() != mapping.end())
+            return nullptr;
+
+        return lookupTexture->shared_from_this();
+    }
+
+    void TextureManager::EvictTextures(ContextTag tag) {
+        size_t budget{static_cast<size_t>(*gpu.state.settings->textureMemoryBudget) * 1024 * 1024};
+        if (!budget)
+            budget = std::numeric_limits<size_t>::max();
+
+        // Textures are also evicted when device-local memory usage approaches the budget reported by the driver, running over it would cause the driver or the OS to forcibly reclaim memory which generally kills the process on unified-memory devices
+        vk::DeviceSize deviceThreshold{gpu.memory.GetDeviceLocalBudget() / 100 * DeviceBudgetPercentage}, deviceUsage{gpu.memory.GetDeviceLocalUsage()};
+        if (deviceUsage > deviceThreshold) {
+            size_t excess{static_cast<size_t>(deviceUsage - deviceThreshold)}, resident{residentSize};
+            budget = std::min(budget, resident > excess ? resident - excess : 0);
+        }
+
+        if (residentSize <= budget)
+            return;
+
+        TRACE_EVENT("gpu", "TextureManager::EvictTextures");
+
+        // Every texture has a mapping corresponding to its first guest mapping, only that one is considered to avoid duplicates
+        i64 now{util::GetTimeNs()};
+        std::vector<std::pair<i64, Texture *>> candidates;
+        for (const auto &mapping : textures)
+            if (mapping.iterator == mapping.texture->guest->mappings.begin())
+                if (i64 lastUseTime{mapping.texture->lastUseTime}; now - lastUseTime > EvictionIdleThreshold)
+                    candidates.emplace_back(lastUseTime, mapping.texture.get());
+
+        std::sort(candidates.begin(), candidates.end());
+
+        for (auto [lastUseTime, texture] : candidates) {
+            if (residentSize <= budget)
+                break;
+
+            // A texture that's locked with our tag would be recursively locked by the try_lock below, it's in use by the current execution regardless
+            if (tag && texture->tag == tag)
+                continue;
+
+            std::unique_lock lock{*texture, std::try_to_lock};
+            if (lock && texture->EvictBacking())
+                residentSize -= texture->surfaceSize;
+        }
+    }
+
+    std::shared_ptr<TextureView> TextureManager::FindOrCreate(const GuestTexture &guestTexture, ContextTag tag, bool renderTarget) {
         TRACE_EVENT("gpu", "TextureManager::FindOrCreate");
+        std::scoped_lock lock{mutex};
+
+        // Any texture overlapping with a newer texture will be shadowed in the table by it, so a full match in the table cannot be superseded by any other texture
+        if (auto view{LookupFullMatch(guestTexture, tag)})
+            return view;
 
         auto guestMapping{guestTexture.mappings.front()};
 
@@ -57,20 +160,14 @@ namespace skyline::gpu {
 
             if (firstHostMapping == hostMappings.begin() && firstHostMapping->begin() == guestMapping.begin() && mappingMatch && lastHostMapping == hostMappings.end() && lastGuestMapping.end() == std::prev(lastHostMapping)->end()) {
                 // We've gotten a perfect 1:1 match for *all* mappings from the start to end, we just need to check for compatibility aside from this
-                auto &matchGuestTexture{*hostMapping->texture->guest};
-                if (matchGuestTexture.format->IsCompatible(*guestTexture.format) &&
-                    ((((matchGuestTexture.dimensions.width == guestTexture.dimensions.width &&
-                        matchGuestTexture.dimensions.height == guestTexture.dimensions.height) || matchGuestTexture.CalculateLayerSize() == guestTexture.CalculateLayerSize()) &&
-                        matchGuestTexture.GetViewDepth() <= guestTexture.GetViewDepth())
-                        || matchGuestTexture.viewMipBase > 0)
-                    && matchGuestTexture.tileConfig == guestTexture.tileConfig) {
+                if (IsFullMatchCompatible(*hostMapping->texture, guestTexture)) {
                     fullMatch = hostMapping->texture;
                 } else {
                     matches.push_back(hostMapping->texture);
                 }
             } else {
                 auto &matchGuestTexture{*hostMapping->texture->guest};
-                if (matchGuestTexture.format->IsCompatible(*guestTexture.format) && matchGuestTexture.tileConfig == guestTexture.tileConfig &&
+                if (IsFormatCompatible(*hostMapping->texture, guestTexture) && matchGuestTexture.tileConfig == guestTexture.tileConfig &&
                         (!layerMipMatch || (matchGuestTexture.GetViewLayerCount() >= layerMipMatch->guest->GetViewLayerCount() && matchGuestTexture.mipLevelCount >= layerMipMatch->guest->mipLevelCount))) {
                     size_t memOffset{static_cast<size_t>(guestMapping.data() - hostMapping->texture->guest->mappings.front().data())};
                     size_t layerMemOffset{};
@@ -133,17 +230,21 @@ namespace skyline::gpu {
         for (auto &texture : matches)
             texture->SynchronizeGuest(false, true);
 
-        // Create a texture as we cannot find one that matches
-        auto texture{std::make_shared<Texture>(gpu, guestTexture)};
+        // Create a texture as we cannot find one that matches, only render targets are scaled as the contents of other textures are generally uploaded by the guest at their native resolution
+        float renderScale{renderTarget ? gpu.resolution.GetScale() : 1.0f};
+        auto texture{std::make_shared<Texture>(gpu, guestTexture, renderScale)};
         texture->SetupGuestMappings();
-        texture->TransitionLayout(vk::ImageLayout::eGeneral);
+        texture->lastUseTime = util::GetTimeNs();
+        EvictTextures(tag); // The backing of the texture is only counted towards the resident size once it's allocated on its first GPU usage
         auto it{texture->guest->mappings.begin()};
         textures.emplace(mappingEnd, TextureMapping{texture, it, guestMapping});
+        textureTable.Set(util::AlignDown(guestMapping.begin().base(), constant::PageSize), util::AlignUp(guestMapping.end().base(), constant::PageSize), texture.get()); // The table is set at page granularity so any overlapping texture is always shadowed by this one
         while ((++it) != texture->guest->mappings.end()) {
             guestMapping = *it;
             auto mapping{std::upper_bound(textures.begin(), textures.end(), guestMapping)};
             // TODO: Delete overlapping textures that aren't in texture pool
             textures.emplace(mapping, TextureMapping{texture, it, guestMapping});
+            textureTable.Set(util::AlignDown(guestMapping.begin().base(), constant::PageSize), util::AlignUp(guestMapping.end().base(), constant::PageSize), texture.get());
         }
 
         return texture->GetView(guestTexture.viewType, vk::ImageSubresourceRange{
@@ -3,6 +3,7 @@
 
 #pragma once
 
+#include <common/segment_table.h>
 #include "texture/texture.h"
 
 namespace skyline::gpu {
@@ -26,15 +27,44 @@ namespace skyline::gpu {
         };
 
         GPU &gpu;
+        std::mutex mutex; //!< Synchronizes access to the texture mappings and table, this allows channels to look up textures without any external synchronization
         std::vector<TextureMapping> textures; //!< A sorted vector of all texture mappings
 
+        static constexpr size_t L2EntryGranularity{19}; //!< The amount of AS (in bytes) a single L2 PTE covers (512 KiB == 1 << 19)
+        SegmentTable<Texture *, constant::AddressSpaceSize, constant::PageSizeBits, L2EntryGranularity> textureTable; //!< A page table of the most recently created texture overlapping each page for O(1) lookups on full matches
+
+        static constexpr i64 EvictionIdleThreshold{constant::NsInSecond * 5}; //!< The minimum amount of time since a texture was last used before it can be evicted
+        std::atomic<size_t> residentSize{}; //!< The total size of all textures with a resident backing, this is an estimate based on the linear size of each texture
+        static constexpr vk::DeviceSize DeviceBudgetPercentage{90}; //!< The percentage of the device-local memory budget that can be used before textures are evicted regardless of the texture memory budget
+
+        friend Texture;
+
+        /**
+         * @return A view of the texture in the table at the start of the guest texture if it's a full match for the guest texture, an empty view otherwise
+         * @note This doesn't consider any other textures and should only be used as a fast path prior to the full lookup
+         */
+        std::shared_ptr<TextureView> LookupFullMatch(const GuestTexture &guestTexture, ContextTag tag);
+
+        /**
+         * @brief Evicts the backings of the least recently used textures till the total size of resident textures is within the texture memory budget and device-local memory usage is within the budget reported by the driver
+         * @note Textures which have been used recently or are currently locked are never evicted
+         */
+        void EvictTextures(ContextTag tag);
+
       public:
         TextureManager(GPU &gpu);
 
         /**
          * @return A pre-existing or newly created Texture object which matches the specified criteria
-         * @note The texture manager **must** be locked prior to calling this
+         * @param renderTarget If the texture is being used as a render target, newly created textures are scaled by the resolution scale in that case
+         * @note The texture manager is locked internally and **must not** be locked by the caller
+         */
+        std::shared_ptr<TextureView> FindOrCreate(const GuestTexture &guestTexture, ContextTag tag = {}, bool renderTarget = false);
+
+        /**
+         * @return A pre-existing texture which is backed by exactly the supplied mapping or nullptr if there's no such texture, this never creates a texture
+         * @note The texture manager is locked internally and **must not** be locked by the caller
          */
-        std::shared_ptr<TextureView> FindOrCreate(const GuestTexture &guestTexture, ContextTag tag = {});
+        std::shared_ptr<Texture> LookupMapping(span<u8> mapping);
     };
 }
@@ -6,7 +6,7 @@
 
 namespace skyline::gpu {
     TraitManager::TraitManager(const DeviceFeatures2 &deviceFeatures2, DeviceFeatures2 &enabledFeatures2, const std::vector<vk::ExtensionProperties> &deviceExtensions, std::vector<std::array<char, VK_MAX_EXTENSION_NAME_SIZE>> &enabledExtensions, const DeviceProperties2 &deviceProperties2, const vk::raii::PhysicalDevice &physicalDevice) : quirks(deviceProperties2.get<vk::PhysicalDeviceProperties2>().properties, deviceProperties2.get<vk::PhysicalDeviceDriverProperties>()) {
-        bool hasCustomBorderColorExt{}, hasShaderAtomicInt64Ext{}, hasShaderFloat16Int8Ext{}, hasShaderDemoteToHelperExt{}, hasVertexAttributeDivisorExt{}, hasProvokingVertexExt{}, hasPrimitiveTopologyListRestartExt{}, hasImagelessFramebuffersExt{}, hasTransformFeedbackExt{}, hasUint8IndicesExt{}, hasExtendedDynamicStateExt{}, hasRobustness2Ext{};
+        bool hasCustomBorderColorExt{}, hasShaderAtomicInt64Ext{}, hasShaderFloat16Int8Ext{}, hasShaderDemoteToHelperExt{}, hasVertexAttributeDivisorExt{}, hasProvokingVertexExt{}, hasPrimitiveTopologyListRestartExt{}, hasImagelessFramebuffersExt{}, hasTransformFeedbackExt{}, hasUint8IndicesExt{}, hasExtendedDynamicStateExt{}, hasVertexInputDynamicStateExt{}, hasRobustness2Ext{}, hasTimelineSemaphoreExt{}, hasPipelineLibraryExt{}, hasGraphicsPipelineLibraryExt{}, hasDescriptorBufferExt{}, hasConditionalRenderingExt{}, hasExternalMemoryHostExt{}, hasMultiDrawExt{}, hasInlineUniformBlockExt{}, hasPipelineCreationCacheControlExt{}, hasShaderModuleIdentifierExt{};
         bool supportsUniformBufferStandardLayout{}; // We require VK_KHR_uniform_buffer_standard_layout but assume it is implicitly supported even when not present
 
         for (auto &extension : deviceExtensions) {
@@ -59,7 +59,23 @@ namespace skyline::gpu {
                 EXT_SET("VK_EXT_primitive_topology_list_restart", hasPrimitiveTopologyListRestartExt);
                 EXT_SET("VK_EXT_transform_feedback", hasTransformFeedbackExt);
                 EXT_SET_COND("VK_EXT_extended_dynamic_state", hasExtendedDynamicStateExt, !quirks.brokenDynamicStateVertexBindings);
+                EXT_SET_COND("VK_EXT_vertex_input_dynamic_state", hasVertexInputDynamicStateExt, !quirks.brokenDynamicStateVertexBindings);
                 EXT_SET("VK_EXT_robustness2", hasRobustness2Ext);
+                EXT_SET("VK_KHR_timeline_semaphore", hasTimelineSemaphoreExt);
+                EXT_SET("VK_KHR_pipeline_library", hasPipelineLibraryExt);
+                EXT_SET("VK_EXT_graphics_pipeline_library", hasGraphicsPipelineLibraryExt);
+                EXT_SET("VK_EXT_conditional_rendering", hasConditionalRenderingExt);
+                EXT_SET("VK_EXT_external_memory_host", hasExternalMemoryHostExt);
+                EXT_SET("VK_EXT_memory_budget", supportsMemoryBudget);
+                EXT_SET("VK_EXT_multi_draw", hasMultiDrawExt);
+                EXT_SET("VK_EXT_inline_uniform_block", hasInlineUniformBlockExt);
+                EXT_SET("VK_EXT_pipeline_creation_cache_control", hasPipelineCreationCacheControlExt);
+                EXT_SET("VK_EXT_shader_module_identifier", hasShaderModuleIdentifierExt);
+
+                case util::Hash("VK_EXT_descriptor_buffer"):
+                    // This is only detected rather than enabled, see below
+                    hasDescriptorBufferExt = extensionName == "VK_EXT_descriptor_buffer";
+                    break;
             }
 
             #undef EXT_SET_COND
@@ -81,6 +97,7 @@ namespace skyline::gpu {
         FEAT_SET(vk::PhysicalDeviceFeatures2, features.shaderInt16, supportsInt16)
         FEAT_SET(vk::PhysicalDeviceFeatures2, features.shaderInt64, supportsInt64)
         FEAT_SET(vk::PhysicalDeviceFeatures2, features.shaderStorageImageReadWithoutFormat, supportsImageReadWithoutFormat)
+        FEAT_SET(vk::PhysicalDeviceFeatures2, features.multiDrawIndirect, supportsMultiDrawIndirect)
         FEAT_SET(vk::PhysicalDeviceFeatures2, features.robustBufferAccess, std::ignore)
 
         if (hasUint8IndicesExt)
@@ -93,6 +110,11 @@ namespace skyline::gpu {
         else
             enabledFeatures2.unlink<vk::PhysicalDeviceExtendedDynamicStateFeaturesEXT>();
 
+        if (hasVertexInputDynamicStateExt)
+            FEAT_SET(vk::PhysicalDeviceVertexInputDynamicStateFeaturesEXT, vertexInputDynamicState, supportsVertexInputDynamicState)
+        else
+            enabledFeatures2.unlink<vk::PhysicalDeviceVertexInputDynamicStateFeaturesEXT>();
+
         if (hasRobustness2Ext) {
             FEAT_SET(vk::PhysicalDeviceRobustness2FeaturesEXT, nullDescriptor, supportsNullDescriptor)
             FEAT_SET(vk::PhysicalDeviceRobustness2FeaturesEXT, robustBufferAccess2, std::ignore)
@@ -101,6 +123,57 @@ namespace skyline::gpu {
             enabledFeatures2.unlink<vk::PhysicalDeviceRobustness2FeaturesEXT>();
         }
 
+        if (hasTimelineSemaphoreExt)
+            FEAT_SET(vk::PhysicalDeviceTimelineSemaphoreFeaturesKHR, timelineSemaphore, supportsTimelineSemaphores)
+        else
+            enabledFeatures2.unlink<vk::PhysicalDeviceTimelineSemaphoreFeaturesKHR>();
+
+        // Libraries are only worth using when they can be linked quickly, otherwise they'd just add overhead over monolithic pipelines
+        if (hasPipelineLibraryExt && hasGraphicsPipelineLibraryExt && deviceProperties2.get<vk::PhysicalDeviceGraphicsPipelineLibraryPropertiesEXT>().graphicsPipelineLibraryFastLinking)
+            FEAT_SET(vk::PhysicalDeviceGraphicsPipelineLibraryFeaturesEXT, graphicsPipelineLibrary, supportsGraphicsPipelineLibrary)
+        else
+            enabledFeatures2.unlink<vk::PhysicalDeviceGraphicsPipelineLibraryFeaturesEXT>();
+
+        if (hasConditionalRenderingExt)
+            FEAT_SET(vk::PhysicalDeviceConditionalRenderingFeaturesEXT, conditionalRendering, supportsConditionalRendering)
+        else
+            enabledFeatures2.unlink<vk::PhysicalDeviceConditionalRenderingFeaturesEXT>();
+
+        if (hasMultiDrawExt) {
+            FEAT_SET(vk::PhysicalDeviceMultiDrawFeaturesEXT, multiDraw, supportsMultiDraw)
+            maxMultiDrawCount = deviceProperties2.get<vk::PhysicalDeviceMultiDrawPropertiesEXT>().maxMultiDrawCount;
+        } else {
+            enabledFeatures2.unlink<vk::PhysicalDeviceMultiDrawFeaturesEXT>();
+        }
+
+        if (hasInlineUniformBlockExt) {
+            FEAT_SET(vk::PhysicalDeviceInlineUniformBlockFeaturesEXT, inlineUniformBlock, supportsInlineUniformBlock)
+            const auto &inlineUniformBlockProperties{deviceProperties2.get<vk::PhysicalDeviceInlineUniformBlockPropertiesEXT>()};
+            maxInlineUniformBlockSize = inlineUniformBlockProperties.maxInlineUniformBlockSize;
+            maxInlineUniformBlockCount = std::min(inlineUniformBlockProperties.maxPerStageDescriptorInlineUniformBlocks, inlineUniformBlockProperties.maxDescriptorSetInlineUniformBlocks);
+        } else {
+            enabledFeatures2.unlink<vk::PhysicalDeviceInlineUniformBlockFeaturesEXT>();
+        }
+
+        // Identifiers are only useful if pipeline creation can fail rather than compiling when the driver doesn't have a cached binary for them
+        if (hasPipelineCreationCacheControlExt && hasShaderModuleIdentifierExt) {
+            bool supportsPipelineCreationCacheControl{};
+            FEAT_SET(vk::PhysicalDevicePipelineCreationCacheControlFeaturesEXT, pipelineCreationCacheControl, supportsPipelineCreationCacheControl)
+            if (supportsPipelineCreationCacheControl) {
+                FEAT_SET(vk::PhysicalDeviceShaderModuleIdentifierFeaturesEXT, shaderModuleIdentifier, supportsShaderModuleIdentifier)
+                shaderModuleIdentifierAlgorithmUuid = deviceProperties2.get<vk::PhysicalDeviceShaderModuleIdentifierPropertiesEXT>().shaderModuleIdentifierAlgorithmUUID;
+            } else {
+                enabledFeatures2.unlink<vk::PhysicalDeviceShaderModuleIdentifierFeaturesEXT>();
+            }
+        } else {
+            enabledFeatures2.unlink<vk::PhysicalDevicePipelineCreationCacheControlFeaturesEXT>();
+            enabledFeatures2.unlink<vk::PhysicalDeviceShaderModuleIdentifierFeaturesEXT>();
+        }
+
+        // Descriptor buffers aren't enabled as they can reduce the performance of regular descriptor sets on some drivers, support is only reported until there's a backend that uses them
+        supportsDescriptorBuffer = hasDescriptorBufferExt && deviceFeatures2.get<vk::PhysicalDeviceDescriptorBufferFeaturesEXT>().descriptorBuffer;
+        enabledFeatures2.unlink<vk::PhysicalDeviceDescriptorBufferFeaturesEXT>();
+
         if (hasCustomBorderColorExt) {
             bool hasCustomBorderColorFeature{};
             FEAT_SET(vk::PhysicalDeviceCustomBorderColorFeaturesEXT, customBorderColors, hasCustomBorderColorFeature)
@@ -205,15 +278,43 @@ namespace skyline::gpu {
         bcnSupport[5] = isFormatSupported(vk::Format::eBc6HSfloatBlock) && isFormatSupported(vk::Format::eBc6HUfloatBlock);
         bcnSupport[6] = isFormatSupported(vk::Format::eBc7UnormBlock) && isFormatSupported(vk::Format::eBc7SrgbBlock);
 
+        supportsEac = isFormatSupported(vk::Format::eEacR11UnormBlock) && isFormatSupported(vk::Format::eEacR11SnormBlock) && isFormatSupported(vk::Format::eEacR11G11UnormBlock) && isFormatSupported(vk::Format::eEacR11G11SnormBlock);
+
+        constexpr std::array<vk::Format, 28> AstcFormats{
+            vk::Format::eAstc4x4UnormBlock, vk::Format::eAstc4x4SrgbBlock, vk::Format::eAstc5x4UnormBlock, vk::Format::eAstc5x4SrgbBlock,
+            vk::Format::eAstc5x5UnormBlock, vk::Format::eAstc5x5SrgbBlock, vk::Format::eAstc6x5UnormBlock, vk::Format::eAstc6x5SrgbBlock,
+            vk::Format::eAstc6x6UnormBlock, vk::Format::eAstc6x6SrgbBlock, vk::Format::eAstc8x5UnormBlock, vk::Format::eAstc8x5SrgbBlock,
+            vk::Format::eAstc8x6UnormBlock, vk::Format::eAstc8x6SrgbBlock, vk::Format::eAstc8x8UnormBlock, vk::Format::eAstc8x8SrgbBlock,
+            vk::Format::eAstc10x5UnormBlock, vk::Format::eAstc10x5SrgbBlock, vk::Format::eAstc10x6UnormBlock, vk::Format::eAstc10x6SrgbBlock,
+            vk::Format::eAstc10x8UnormBlock, vk::Format::eAstc10x8SrgbBlock, vk::Format::eAstc10x10UnormBlock, vk::Format::eAstc10x10SrgbBlock,
+            vk::Format::eAstc12x10UnormBlock, vk::Format::eAstc12x10SrgbBlock, vk::Format::eAstc12x12UnormBlock, vk::Format::eAstc12x12SrgbBlock,
+        };
+        supportsAstcLdr = std::all_of(AstcFormats.begin(), AstcFormats.end(), isFormatSupported);
+
+        supportsB5G6R5 = isFormatSupported(vk::Format::eB5G6R5UnormPack16);
+        supportsB5G5R5A1 = isFormatSupported(vk::Format::eB5G5R5A1UnormPack16);
+
         auto memoryProps{physicalDevice.getMemoryProperties2()};
         constexpr auto ReqMemFlags{vk::MemoryPropertyFlagBits::eDeviceLocal | vk::MemoryPropertyFlagBits::eHostVisible | vk::MemoryPropertyFlagBits::eHostCoherent | vk::MemoryPropertyFlagBits::eHostCached};
         for (u32 i{}; i < memoryProps.memoryProperties.memoryTypeCount; i++)
             if ((memoryProps.memoryProperties.memoryTypes[i].propertyFlags & ReqMemFlags) == ReqMemFlags)
                 hostVisibleCoherentCachedMemoryType = i;
 
+        for (u32 i{}; i < memoryProps.memoryProperties.memoryTypeCount; i++)
+            if (memoryProps.memoryProperties.memoryTypes[i].propertyFlags & vk::MemoryPropertyFlagBits::eLazilyAllocated)
+                supportsLazilyAllocatedMemory = true;
+
 
         minimumStorageBufferAlignment = static_cast<u32>(deviceProperties2.get().properties.limits.minStorageBufferOffsetAlignment);
 
+        supportsGpuTimestamps = deviceProperties2.get().properties.limits.timestampComputeAndGraphics;
+        timestampPeriod = deviceProperties2.get().properties.limits.timestampPeriod;
+
+        if (hasExternalMemoryHostExt) {
+            supportsExternalMemoryHost = true;
+            minImportedHostPointerAlignment = deviceProperties2.get<vk::PhysicalDeviceExternalMemoryHostPropertiesEXT>().minImportedHostPointerAlignment;
+        }
+
         vendorId = deviceProperties2.get().properties.vendorID;
         deviceId = deviceProperties2.get().properties.deviceID;
         driverVersion = deviceProperties2.get().properties.driverVersion;
@@ -222,8 +323,8 @@ namespace skyline::gpu {
 
     std::string TraitManager::Summary() {
         return fmt::format(
-            "\n* Supports U8 Indices: {}\n* Supports Sampler Mirror Clamp To Edge: {}\n* Supports Sampler Reduction Mode: {}\n* Supports Custom Border Color (Without Format): {}\n* Supports Anisotropic Filtering: {}\n* Supports Last Provoking Vertex: {}\n* Supports Logical Operations: {}\n* Supports Vertex Attribute Divisor: {}\n* Supports Vertex Attribute Zero Divisor: {}\n* Supports Push Descriptors: {}\n* Supports Imageless Framebuffers: {}\n* Supports Global Priority: {}\n* Supports Multiple Viewports: {}\n* Supports Shader Viewport Index: {}\n* Supports SPIR-V 1.4: {}\n* Supports Shader Invocation Demotion: {}\n* Supports 16-bit FP: {}\n* Supports 8-bit Integers: {}\n* Supports 16-bit Integers: {}\n* Supports 64-bit Integers: {}\n* Supports Atomic 64-bit Integers: {}\n* Supports Floating Point Behavior Control: {}\n* Supports Image Read Without Format: {}\n* Supports List Primitive Topology Restart: {}\n* Supports Patch List Primitive Topology Restart: {}\n* Supports Transform Feedback: {}\n* Supports Geometry Shaders: {}\n*  Supports Vertex Pipeline Stores and Atomics: {}\n* Supports Fragment Stores and Atomics: {}\n* Supports Shader Storage Image Write Without Format: {}\n*Supports Subgroup Vote: {}\n* Subgroup Size: {}\n* BCn Support: {}",
-            supportsUint8Indices, supportsSamplerMirrorClampToEdge, supportsSamplerReductionMode, supportsCustomBorderColor, supportsAnisotropicFiltering, supportsLastProvokingVertex, supportsLogicOp, supportsVertexAttributeDivisor, supportsVertexAttributeZeroDivisor, supportsPushDescriptors, supportsImagelessFramebuffers, supportsGlobalPriority, supportsMultipleViewports, supportsShaderViewportIndexLayer, supportsSpirv14, supportsShaderDemoteToHelper, supportsFloat16, supportsInt8, supportsInt16, supportsInt64, supportsAtomicInt64, supportsFloatControls, supportsImageReadWithoutFormat, supportsTopologyListRestart, supportsTopologyPatchListRestart, supportsTransformFeedback, supportsGeometryShaders, supportsVertexPipelineStoresAndAtomics, supportsFragmentStoresAndAtomics, supportsShaderStorageImageWriteWithoutFormat, supportsSubgroupVote, subgroupSize, bcnSupport.to_string()
+            "\n* Supports U8 Indices: {}\n* Supports Sampler Mirror Clamp To Edge: {}\n* Supports Sampler Reduction Mode: {}\n* Supports Custom Border Color (Without Format): {}\n* Supports Anisotropic Filtering: {}\n* Supports Last Provoking Vertex: {}\n* Supports Logical Operations: {}\n* Supports Vertex Attribute Divisor: {}\n* Supports Vertex Attribute Zero Divisor: {}\n* Supports Push Descriptors: {}\n* Supports Imageless Framebuffers: {}\n* Supports Global Priority: {}\n* Supports Multiple Viewports: {}\n* Supports Shader Viewport Index: {}\n* Supports SPIR-V 1.4: {}\n* Supports Shader Invocation Demotion: {}\n* Supports 16-bit FP: {}\n* Supports 8-bit Integers: {}\n* Supports 16-bit Integers: {}\n* Supports 64-bit Integers: {}\n* Supports Atomic 64-bit Integers: {}\n* Supports Floating Point Behavior Control: {}\n* Supports Image Read Without Format: {}\n* Supports List Primitive Topology Restart: {}\n* Supports Patch List Primitive Topology Restart: {}\n* Supports Transform Feedback: {}\n* Supports Geometry Shaders: {}\n*  Supports Vertex Pipeline Stores and Atomics: {}\n* Supports Fragment Stores and Atomics: {}\n* Supports Shader Storage Image Write Without Format: {}\n*Supports Subgroup Vote: {}\n* Supports Vertex Input Dynamic State: {}\n* Supports Timeline Semaphores: {}\n* Supports Graphics Pipeline Library: {}\n* Supports Descriptor Buffer: {}\n* Supports Conditional Rendering: {}\n* Supports Multi-Draw Indirect: {}\n* Supports Multi-Draw: {}\n* Supports Inline Uniform Blocks: {}\n* Supports Shader Module Identifiers: {}\n* Supports External Host Memory: {}\n* Supports Lazily Allocated Memory: {}\n* Supports Memory Budget: {}\n* Subgroup Size: {}\n* BCn Support: {}\n* Supports EAC: {}\n* Supports ASTC LDR: {}\n* Supports B5G6R5: {}\n* Supports B5G5R5A1: {}",
+            supportsUint8Indices, supportsSamplerMirrorClampToEdge, supportsSamplerReductionMode, supportsCustomBorderColor, supportsAnisotropicFiltering, supportsLastProvokingVertex, supportsLogicOp, supportsVertexAttributeDivisor, supportsVertexAttributeZeroDivisor, supportsPushDescriptors, supportsImagelessFramebuffers, supportsGlobalPriority, supportsMultipleViewports, supportsShaderViewportIndexLayer, supportsSpirv14, supportsShaderDemoteToHelper, supportsFloat16, supportsInt8, supportsInt16, supportsInt64, supportsAtomicInt64, supportsFloatControls, supportsImageReadWithoutFormat, supportsTopologyListRestart, supportsTopologyPatchListRestart, supportsTransformFeedback, supportsGeometryShaders, supportsVertexPipelineStoresAndAtomics, supportsFragmentStoresAndAtomics, supportsShaderStorageImageWriteWithoutFormat, supportsSubgroupVote, supportsVertexInputDynamicState, supportsTimelineSemaphores, supportsGraphicsPipelineLibrary, supportsDescriptorBuffer, supportsConditionalRendering, supportsMultiDrawIndirect, supportsMultiDraw, supportsInlineUniformBlock, supportsShaderModuleIdentifier, supportsExternalMemoryHost, supportsLazilyAllocatedMemory, supportsMemoryBudget, subgroupSize, bcnSupport.to_string(), supportsEac, supportsAstcLdr, supportsB5G6R5, supportsB5G5R5A1
         );
     }
 
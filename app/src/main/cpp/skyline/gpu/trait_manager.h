@@ -49,7 +49,22 @@ namespace skyline::gpu {
         bool supportsWideLines{}; //!< If the device supports the 'wideLines' Vulkan feature
         bool supportsDepthClamp{}; //!< If the device supports the 'depthClamp' Vulkan feature
         bool supportsExtendedDynamicState{}; //!< If the device supports the 'VK_EXT_extended_dynamic_state' Vulkan extension
+        bool supportsVertexInputDynamicState{}; //!< If the device supports setting the vertex input layout dynamically (with VK_EXT_vertex_input_dynamic_state)
         bool supportsNullDescriptor{}; //!< If the device supports the null descriptor feature in the 'VK_EXT_robustness2' Vulkan extension
+        bool supportsTimelineSemaphores{}; //!< If the device supports timeline semaphores (with VK_KHR_timeline_semaphore)
+        bool supportsGraphicsPipelineLibrary{}; //!< If the device supports fast-linked graphics pipeline libraries (with VK_EXT_graphics_pipeline_library)
+        bool supportsDescriptorBuffer{}; //!< If the device supports descriptor buffers (with VK_EXT_descriptor_buffer), the extension is only detected and not enabled as nothing consumes it yet
+        bool supportsConditionalRendering{}; //!< If the device supports predicating draws on the contents of a buffer (with VK_EXT_conditional_rendering)
+        bool supportsMultiDrawIndirect{}; //!< If the device supports the 'multiDrawIndirect' Vulkan feature
+        bool supportsMultiDraw{}; //!< If the device supports recording several draws with a single command (with VK_EXT_multi_draw)
+        u32 maxMultiDrawCount{}; //!< The maximum amount of draws in a single multi-draw command
+        bool supportsInlineUniformBlock{}; //!< If the device supports storing uniform data directly in descriptor sets (with VK_EXT_inline_uniform_block)
+        u32 maxInlineUniformBlockSize{}; //!< The maximum size of a single inline uniform block in bytes
+        u32 maxInlineUniformBlockCount{}; //!< The maximum amount of inline uniform blocks in a single descriptor set, this is the minimum of the per-stage and per-set limits
+        bool supportsShaderModuleIdentifier{}; //!< If pipelines can be created from the identifiers of shader modules that were created previously rather than their SPIR-V (with VK_EXT_shader_module_identifier)
+        std::array<u8, VK_UUID_SIZE> shaderModuleIdentifierAlgorithmUuid{}; //!< The `shaderModuleIdentifierAlgorithmUUID` Vulkan property, identifiers are only valid for devices with the same algorithm
+        bool supportsGpuTimestamps{}; //!< If timestamps can be written on all graphics and compute queues ('timestampComputeAndGraphics')
+        float timestampPeriod{}; //!< The amount of nanoseconds it takes for a GPU timestamp to be incremented by 1
         u32 subgroupSize{}; //!< Size of a subgroup on the host GPU
         u32 hostVisibleCoherentCachedMemoryType{std::numeric_limits<u32>::max()};
         u32 minimumStorageBufferAlignment{}; //!< Minimum alignment for storage buffers passed to shaders
@@ -60,7 +75,22 @@ namespace skyline::gpu {
         std::array<u8, VK_UUID_SIZE> pipelineCacheUuid{}; //!< The `pipelineCacheUUID` Vulkan property
 
         std::bitset<7> bcnSupport{}; //!< Bitmask of BCn texture formats supported, it is ordered as BC1, BC2, BC3, BC4, BC5, BC6H and BC7
+        bool supportsEac{}; //!< If the EAC R11 and R11G11 formats are supported in both UNORM and SNORM variants, these are used as transcoding targets for BC4 and BC5
+        bool supportsAstcLdr{}; //!< If all 2D ASTC LDR formats are supported in both UNORM and sRGB variants, these are decoded to R8G8B8A8 on the CPU otherwise
+        bool supportsB5G6R5{}; //!< If B5G6R5 is supported, it's converted to R8G8B8A8 on the GPU otherwise
+        bool supportsB5G5R5A1{}; //!< If B5G5R5A1 is supported, it's converted to R8G8B8A8 on the GPU otherwise
         bool supportsAdrenoDirectMemoryImport{};
+        bool supportsExternalMemoryHost{}; //!< If host allocations can be imported as device memory (with VK_EXT_external_memory_host), this is used for direct memory import when the Adreno-specific path is unavailable
+        vk::DeviceSize minImportedHostPointerAlignment{}; //!< The alignment required for the address and size of imported host allocations
+        bool supportsLazilyAllocatedMemory{}; //!< If the device has a lazily allocated memory type, this is generally only the case on tile-based GPUs where it can back transient attachments without committing any memory
+        bool supportsMemoryBudget{}; //!< If the driver reports the usage and budget of memory heaps (with VK_EXT_memory_budget), this accounts for memory allocated by other processes which is important on unified-memory devices
+
+        /**
+         * @return If guest memory can be imported as device memory, allowing buffers and textures to be used directly without any synchronization
+         */
+        bool SupportsDirectMemoryImport() const {
+            return supportsAdrenoDirectMemoryImport || supportsExternalMemoryHost;
+        }
 
         /**
          * @brief Manages a list of any vendor/device-specific errata in the host GPU
@@ -101,7 +131,12 @@ namespace skyline::gpu {
             vk::PhysicalDeviceDriverProperties,
             vk::PhysicalDeviceFloatControlsProperties,
             vk::PhysicalDeviceTransformFeedbackPropertiesEXT,
-            vk::PhysicalDeviceSubgroupProperties>;
+            vk::PhysicalDeviceSubgroupProperties,
+            vk::PhysicalDeviceGraphicsPipelineLibraryPropertiesEXT,
+            vk::PhysicalDeviceExternalMemoryHostPropertiesEXT,
+            vk::PhysicalDeviceMultiDrawPropertiesEXT,
+            vk::PhysicalDeviceInlineUniformBlockPropertiesEXT,
+            vk::PhysicalDeviceShaderModuleIdentifierPropertiesEXT>;
 
         using DeviceFeatures2 = vk::StructureChain<
             vk::PhysicalDeviceFeatures2,
@@ -118,7 +153,16 @@ namespace skyline::gpu {
             vk::PhysicalDeviceTransformFeedbackFeaturesEXT,
             vk::PhysicalDeviceIndexTypeUint8FeaturesEXT,
             vk::PhysicalDeviceExtendedDynamicStateFeaturesEXT,
-            vk::PhysicalDeviceRobustness2FeaturesEXT>;
+            vk::PhysicalDeviceVertexInputDynamicStateFeaturesEXT,
+            vk::PhysicalDeviceRobustness2FeaturesEXT,
+            vk::PhysicalDeviceTimelineSemaphoreFeaturesKHR,
+            vk::PhysicalDeviceGraphicsPipelineLibraryFeaturesEXT,
+            vk::PhysicalDeviceDescriptorBufferFeaturesEXT,
+            vk::PhysicalDeviceConditionalRenderingFeaturesEXT,
+            vk::PhysicalDeviceMultiDrawFeaturesEXT,
+            vk::PhysicalDeviceInlineUniformBlockFeaturesEXT,
+            vk::PhysicalDevicePipelineCreationCacheControlFeaturesEXT,
+            vk::PhysicalDeviceShaderModuleIdentifierFeaturesEXT>;
 
         TraitManager(const DeviceFeatures2 &deviceFeatures2, DeviceFeatures2 &enabledFeatures2, const std::vector<vk::ExtensionProperties> &deviceExtensions, std::vector<std::array<char, VK_MAX_EXTENSION_NAME_SIZE>> &enabledExtensions, const DeviceProperties2 &deviceProperties2, const vk::raii::PhysicalDevice &physicalDevice);
 
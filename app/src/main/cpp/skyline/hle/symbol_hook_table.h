@@ -3,6 +3,7 @@
 
 #pragma once
 
+#include <cstring>
 #include "symbol_hooks.h"
 
 namespace skyline::hle {
@@ -13,5 +14,14 @@ namespace skyline::hle {
         HookTableEntry(std::string_view name, HookType hook) : name{name}, hook{std::move(hook)} {}
     };
 
-    static std::array<HookTableEntry, 0> HookedSymbols{};
+    /**
+     * @brief Guest libc routines which are replaced with the host's implementations, these are commonly called in hot paths and the host's are tuned for the device
+     * @note Only routines which are pure functions of guest memory can be replaced as they don't have access to any guest or host state
+     */
+    static std::array<HookTableEntry, 4> HookedSymbols{
+        HookTableEntry{"memcpy", NativeOverrideHook{reinterpret_cast<void *>(static_cast<void *(*)(void *, const void *, size_t)>(&memcpy))}},
+        HookTableEntry{"memmove", NativeOverrideHook{reinterpret_cast<void *>(static_cast<void *(*)(void *, const void *, size_t)>(&memmove))}},
+        HookTableEntry{"memset", NativeOverrideHook{reinterpret_cast<void *>(static_cast<void *(*)(void *, int, size_t)>(&memset))}},
+        HookTableEntry{"strlen", NativeOverrideHook{reinterpret_cast<void *>(static_cast<size_t (*)(const char *)>(&strlen))}},
+    };
 }
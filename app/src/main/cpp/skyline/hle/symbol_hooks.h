@@ -17,7 +17,24 @@ namespace skyline::hle {
         HookFunction exit; //!< The hook to be called when the function is exited
     };
 
-    using HookType = std::variant<OverrideHook, EntryExitHook>;
+    /**
+     * @brief A host function that replaces a hooked function by being branched to directly from the hook, it's called with the guest's arguments and returns directly to the guest
+     * @note This avoids the context switch into the host of other hooks so it's suitable for hot functions, as a result the function runs with the guest's stack and TLS and must not depend on any host thread state
+     */
+    struct NativeOverrideHook {
+        void *function;
+    };
+
+    /**
+     * @brief A host function that overrides the execution of a hooked function, unlike OverrideHook it's called directly from the hook with a fixed ABI rather than through NCE::HookHandler
+     * @note The guest context is saved prior to the call and restored after it, the guest's arguments and return values can be accessed through the supplied context
+     * @note The function must not throw as there's no exception handler between it and guest code, pending yields are also not serviced until the next SVC
+     */
+    struct DirectOverrideHook {
+        void (*function)(nce::ThreadContext *ctx);
+    };
+
+    using HookType = std::variant<OverrideHook, EntryExitHook, NativeOverrideHook, DirectOverrideHook>;
 
     struct HookedSymbol {
         std::string name; //!< The name of the symbol
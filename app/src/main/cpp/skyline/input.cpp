@@ -5,6 +5,7 @@
 #include <loader/loader.h>
 #include <kernel/types/KProcess.h>
 #include "input.h"
+#include "input/event_ring.h"
 
 namespace skyline::input {
     Input::Input(const DeviceState &state)
@@ -38,12 +39,19 @@ namespace skyline::input {
 
             constexpr std::chrono::milliseconds NPadUpdatePeriod{4}; //!< The period at which a Joy-Con is updated (250Hz)
             constexpr std::chrono::milliseconds TouchUpdatePeriod{4}; //!< The period at which the touch screen is updated (250Hz)
+            constexpr std::chrono::milliseconds SixAxisUpdatePeriod{5}; //!< The period at which the six-axis sensors are sampled (200Hz)
 
-            std::array<UpdateCallback, 2> updateCallbacks{
+            std::array<UpdateCallback, 3> updateCallbacks{
                 UpdateCallback{NPadUpdatePeriod, [&](UpdateCallback &callback) {
+                    // Events queued by the Java side since the last tick are applied right before they're sampled
+                    InputEventRing::Get().Drain(npad.controllers);
                     for (auto &pad : npad.npads)
                         pad.UpdateSharedMemory();
                 }},
+                UpdateCallback{SixAxisUpdatePeriod, [&](UpdateCallback &callback) {
+                    for (auto &pad : npad.npads)
+                        pad.UpdateSixAxisSharedMemory(callback.period);
+                }},
                 UpdateCallback{TouchUpdatePeriod, [&](UpdateCallback &callback) {
                     touch.UpdateSharedMemory();
                 }},
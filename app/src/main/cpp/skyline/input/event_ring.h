@@ -0,0 +1,81 @@
+// SPDX-License-Identifier: MPL-2.0
+// Copyright © 2023 Skyline Team and Contributors (https://github.com/skyline-emu/)
+
+#pragma once
+
+#include <common.h>
+#include "npad_device.h"
+
+namespace skyline::input {
+    /**
+     * @brief A single input event as written by the Java side into the event ring, all fields are packed into a single word so an event is always written atomically
+     * @note The layout of this must be kept in sync with InputHandler.kt
+     */
+    union InputEvent {
+        enum class Type : u8 {
+            None, //!< An empty slot in the ring, this must be zero
+            ButtonPress,
+            ButtonRelease,
+            Axis,
+        };
+
+        u64 raw;
+        struct {
+            Type type;
+            u8 index; //!< The index of the controller the event is directed to
+            u8 axis; //!< The NpadAxisId of the axis for axis events
+            u8 _pad_;
+            u32 value; //!< The mask of the buttons for button events or the value of the axis for axis events
+        };
+    };
+    static_assert(sizeof(InputEvent) == sizeof(u64));
+
+    /**
+     * @brief A single-producer single-consumer ring of input events shared with the Java side as a direct ByteBuffer, this avoids a JNI transition for every button and axis event
+     * @details Every slot is either empty (zero) or holds an event, the producer only writes into empty slots and the consumer empties slots after reading them, as an event is a single word this doesn't require any shared indices
+     * @note The ring has a static lifetime so the Java side can retain the buffer across emulation sessions
+     */
+    class InputEventRing {
+      public:
+        static constexpr size_t Capacity{256}; //!< The amount of slots in the ring, this must be kept in sync with InputHandler.kt
+
+      private:
+        alignas(constant::PageSize) std::array<std::atomic<u64>, Capacity> slots{};
+        size_t readIndex{}; //!< The index of the next slot to be read, this is only accessed by the consumer
+
+      public:
+        static InputEventRing &Get() {
+            static InputEventRing ring;
+            return ring;
+        }
+
+        span<u8> Buffer() {
+            return span<u8>{reinterpret_cast<u8 *>(slots.data()), sizeof(slots)};
+        }
+
+        /**
+         * @brief Applies all pending events to the supplied controllers, events directed to controllers without a device are dropped
+         */
+        template<typename Controllers>
+        void Drain(Controllers &controllers) {
+            while (true) {
+                auto &slot{slots[readIndex]};
+                InputEvent event{.raw = slot.load(std::memory_order_acquire)};
+                if (event.type == InputEvent::Type::None)
+                    break;
+
+                if (event.index < controllers.size()) {
+                    if (auto device{controllers[event.index].device}) {
+                        if (event.type == InputEvent::Type::Axis)
+                            device->SetAxisValue(static_cast<NpadAxisId>(event.axis), static_cast<i32>(event.value));
+                        else
+                            device->SetButtonState(NpadButton{.raw = event.value}, event.type == InputEvent::Type::ButtonPress);
+                    }
+                }
+
+                slot.store(0, std::memory_order_release);
+                readIndex = (readIndex + 1) % Capacity;
+            }
+        }
+    };
+}
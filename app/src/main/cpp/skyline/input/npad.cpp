@@ -11,7 +11,48 @@ namespace skyline::input {
          {*this, hid->npad[4], NpadId::Player5}, {*this, hid->npad[5], NpadId::Player6},
          {*this, hid->npad[6], NpadId::Player7}, {*this, hid->npad[7], NpadId::Player8},
          {*this, hid->npad[8], NpadId::Handheld}, {*this, hid->npad[9], NpadId::Unknown},
-        } { Activate(); /* NPads are activated by default, certain homebrew is reliant on this behavior */ }
+        } {
+        Activate(); // NPads are activated by default, certain homebrew is reliant on this behavior
+        vibrationThread = std::thread{&NpadManager::VibrationThread, this};
+    }
+
+    NpadManager::~NpadManager() {
+        {
+            std::scoped_lock lock{vibrationMutex};
+            vibrationThreadExit = true;
+        }
+        vibrationCondition.notify_all();
+        if (vibrationThread.joinable())
+            vibrationThread.join();
+    }
+
+    void NpadManager::NotifyVibration() {
+        if (!vibrationPending) {
+            vibrationPending = true;
+            vibrationCondition.notify_all();
+        }
+    }
+
+    void NpadManager::VibrationThread() {
+        if (int result{pthread_setname_np(pthread_self(), "Sky-Vibration")})
+            Logger::Warn("Failed to set the thread name: {}", strerror(result));
+
+        std::unique_lock lock{vibrationMutex};
+        while (true) {
+            vibrationCondition.wait(lock, [this] { return vibrationPending || vibrationThreadExit; });
+            if (vibrationThreadExit)
+                return;
+            vibrationPending = false;
+            lock.unlock();
+
+            for (auto &npad : npads)
+                npad.DispatchVibration();
+
+            // Any changes made while waiting are coalesced into the next dispatch
+            std::this_thread::sleep_for(VibrationDispatchPeriod);
+            lock.lock();
+        }
+    }
 
     void NpadManager::Update() {
         std::scoped_lock guard{mutex};
@@ -24,8 +24,23 @@ namespace skyline::input {
         const DeviceState &state;
         bool activated{};
 
+        static constexpr std::chrono::milliseconds VibrationDispatchPeriod{20}; //!< The minimum period between vibration values being dispatched to the host, guests update vibration at up to the HID rate which is far higher than host vibrators can reproduce
+        std::mutex vibrationMutex; //!< Synchronizes the vibration values of all NPads between guest threads and the vibration thread
+        std::condition_variable vibrationCondition; //!< Signalled when the vibration values of any NPad are modified or the vibration thread should exit
+        bool vibrationPending{}; //!< If the vibration values of any NPad were modified since the last dispatch
+        bool vibrationThreadExit{}; //!< If the vibration thread should exit
+        std::thread vibrationThread; //!< A thread that dispatches coalesced vibration values to the host at most once per VibrationDispatchPeriod, this keeps JNI calls off guest threads
+
         friend NpadDevice;
 
+        /**
+         * @brief Wakes up the vibration thread to dispatch the modified vibration values
+         * @note The vibration mutex **must** be locked when calling this
+         */
+        void NotifyVibration();
+
+        void VibrationThread();
+
       public:
         std::recursive_mutex mutex; //!< This mutex must be locked before any modifications to class members
         std::array<NpadDevice, constant::NpadCount> npads;
@@ -40,6 +55,8 @@ namespace skyline::input {
          */
         NpadManager(const DeviceState &state, input::HidSharedMemory *hid);
 
+        ~NpadManager();
+
         /**
          * @brief Translates an NPad's ID into its index in the npad array
          * @param id The ID of the NPad to translate
@@ -220,43 +220,29 @@ namespace skyline::input {
     }
 
     void NpadDevice::WriteNextEntry(NpadControllerInfo &info, NpadControllerState entry) {
-        auto &lastEntry{info.state.at(info.header.currentEntry)};
-
-        info.header.timestamp = util::GetTimeTicks();
-        info.header.entryCount = std::min(static_cast<u8>(info.header.entryCount + 1), constant::HidEntryCount);
-        info.header.maxEntry = info.header.entryCount - 1;
-        info.header.currentEntry = (info.header.currentEntry < info.header.maxEntry) ? info.header.currentEntry + 1 : 0;
-
-        auto &nextEntry{info.state.at(info.header.currentEntry)};
-
-        nextEntry.globalTimestamp = globalTimestamp;
-        nextEntry.localTimestamp = lastEntry.localTimestamp + 1;
-        nextEntry.buttons = entry.buttons;
-        nextEntry.leftX = entry.leftX;
-        nextEntry.leftY = entry.leftY;
-        nextEntry.rightX = entry.rightX;
-        nextEntry.rightY = entry.rightY;
-        nextEntry.status.raw = connectionState.raw;
+        PublishLifoEntry(info.header, info.state, [&](const auto &lastEntry, auto &nextEntry) {
+            nextEntry.globalTimestamp = globalTimestamp;
+            nextEntry.localTimestamp = lastEntry.localTimestamp + 1;
+            nextEntry.buttons = entry.buttons;
+            nextEntry.leftX = entry.leftX;
+            nextEntry.leftY = entry.leftY;
+            nextEntry.rightX = entry.rightX;
+            nextEntry.rightY = entry.rightY;
+            nextEntry.status.raw = connectionState.raw;
+        });
     }
 
     void NpadDevice::WriteNextEntry(NpadSixAxisInfo &info, NpadSixAxisState entry) {
-        auto &lastEntry{info.state.at(info.header.currentEntry)};
-
-        info.header.timestamp = util::GetTimeTicks();
-        info.header.entryCount = std::min(static_cast<u8>(info.header.entryCount + 1), constant::HidEntryCount);
-        info.header.maxEntry = info.header.entryCount - 1;
-        info.header.currentEntry = (info.header.currentEntry < info.header.maxEntry) ? info.header.currentEntry + 1 : 0;
-
-        auto &nextEntry{info.state.at(info.header.currentEntry)};
-
-        nextEntry.globalTimestamp = globalTimestamp;
-        nextEntry.localTimestamp = lastEntry.localTimestamp + 1;
-        nextEntry.deltaTimestamp = entry.deltaTimestamp;
-        nextEntry.accelerometer = entry.accelerometer;
-        nextEntry.gyroscope = entry.gyroscope;
-        nextEntry.rotation = entry.rotation;
-        nextEntry.orientation = entry.orientation;
-        nextEntry.attribute = entry.attribute;
+        PublishLifoEntry(info.header, info.state, [&](const auto &lastEntry, auto &nextEntry) {
+            nextEntry.globalTimestamp = sixAxisTimestamp;
+            nextEntry.localTimestamp = lastEntry.localTimestamp + 1;
+            nextEntry.deltaTimestamp = entry.deltaTimestamp;
+            nextEntry.accelerometer = entry.accelerometer;
+            nextEntry.gyroscope = entry.gyroscope;
+            nextEntry.rotation = entry.rotation;
+            nextEntry.orientation = entry.orientation;
+            nextEntry.attribute = entry.attribute;
+        });
     }
 
     void NpadDevice::WriteEmptyEntries() {
@@ -297,13 +283,25 @@ namespace skyline::input {
             WriteNextEntry(*controllerInfo, controllerState);
         WriteNextEntry(section.defaultController, defaultState);
 
-        // TODO: SixAxis should be updated every 5 ms
+        globalTimestamp++;
+    }
+
+    void NpadDevice::UpdateSixAxisSharedMemory(std::chrono::nanoseconds samplingPeriod) {
+        if (!connectionState.connected)
+            return;
+
+        // The latest host sensor state is held till the next sample, host sensor events may arrive at any rate but the guest expects a sample every period
+        auto writeSample{[&](NpadSixAxisInfo &info, NpadSixAxisState sample) {
+            sample.deltaTimestamp = static_cast<u64>(samplingPeriod.count());
+            WriteNextEntry(info, sample);
+        }};
+
         if (sixAxisInfoLeft)
-            WriteNextEntry(*sixAxisInfoLeft, sixAxisStateLeft);
+            writeSample(*sixAxisInfoLeft, sixAxisStateLeft);
         if (sixAxisInfoRight)
-            WriteNextEntry(*sixAxisInfoRight, sixAxisStateRight);
+            writeSample(*sixAxisInfoRight, sixAxisStateRight);
 
-        globalTimestamp++;
+        sixAxisTimestamp++;
     }
 
     void NpadDevice::SetButtonState(NpadButton mask, bool pressed) {
@@ -550,27 +548,18 @@ namespace skyline::input {
     }
 
     void NpadDevice::Vibrate(const NpadVibrationValue &left, const NpadVibrationValue &right) {
+        std::scoped_lock lock{manager.vibrationMutex};
         if (vibrationLeft == left && vibrationRight && (*vibrationRight) == right)
             return;
 
         vibrationLeft = left;
         vibrationRight = right;
-
-        if (partnerIndex == NpadDevice::NullIndex) {
-            std::array<VibrationInfo, 4> vibrations{
-                VibrationInfo{left.frequencyLow, left.amplitudeLow * (AmplitudeMax / 4)},
-                VibrationInfo{left.frequencyHigh, left.amplitudeHigh * (AmplitudeMax / 4)},
-                VibrationInfo{right.frequencyLow, right.amplitudeLow * (AmplitudeMax / 4)},
-                VibrationInfo{right.frequencyHigh, right.amplitudeHigh * (AmplitudeMax / 4)},
-            };
-            VibrateDevice(manager.state.jvm, index, vibrations);
-        } else {
-            VibrateDevice(manager.state.jvm, index, left);
-            VibrateDevice(manager.state.jvm, partnerIndex, right);
-        }
+        vibrationPending = true;
+        manager.NotifyVibration();
     }
 
     void NpadDevice::VibrateSingle(bool isRight, const NpadVibrationValue &value) {
+        std::scoped_lock lock{manager.vibrationMutex};
         if (isRight) {
             if (vibrationRight && (*vibrationRight) == value)
                 return;
@@ -581,9 +570,50 @@ namespace skyline::input {
             vibrationLeft = value;
         }
 
-        if (vibrationRight)
-            Vibrate(vibrationLeft, *vibrationRight);
-        else
-            VibrateDevice(manager.state.jvm, index, value);
+        vibrationPending = true;
+        manager.NotifyVibration();
+    }
+
+    void NpadDevice::ResetVibrationRight() {
+        std::scoped_lock lock{manager.vibrationMutex};
+        vibrationRight = NpadVibrationValue{};
+        vibrationPending = true;
+        manager.NotifyVibration();
+    }
+
+    void NpadDevice::DispatchVibration() {
+        NpadVibrationValue left;
+        std::optional<NpadVibrationValue> right;
+        i8 deviceIndex, devicePartnerIndex;
+        {
+            std::scoped_lock lock{manager.mutex, manager.vibrationMutex};
+            if (!vibrationPending)
+                return;
+            vibrationPending = false;
+
+            // Changes that were reverted prior to being dispatched don't need to be dispatched at all
+            if (vibrationLeft == dispatchedVibrationLeft && vibrationRight == dispatchedVibrationRight)
+                return;
+
+            left = dispatchedVibrationLeft = vibrationLeft;
+            right = dispatchedVibrationRight = vibrationRight;
+            deviceIndex = index;
+            devicePartnerIndex = partnerIndex;
+        }
+
+        if (!right) {
+            VibrateDevice(manager.state.jvm, deviceIndex, left);
+        } else if (devicePartnerIndex == NpadDevice::NullIndex) {
+            std::array<VibrationInfo, 4> vibrations{
+                VibrationInfo{left.frequencyLow, left.amplitudeLow * (AmplitudeMax / 4)},
+                VibrationInfo{left.frequencyHigh, left.amplitudeHigh * (AmplitudeMax / 4)},
+                VibrationInfo{right->frequencyLow, right->amplitudeLow * (AmplitudeMax / 4)},
+                VibrationInfo{right->frequencyHigh, right->amplitudeHigh * (AmplitudeMax / 4)},
+            };
+            VibrateDevice(manager.state.jvm, deviceIndex, vibrations);
+        } else {
+            VibrateDevice(manager.state.jvm, deviceIndex, left);
+            VibrateDevice(manager.state.jvm, devicePartnerIndex, *right);
+        }
     }
 }
@@ -173,6 +173,7 @@ namespace skyline::input {
         NpadSixAxisInfo *sixAxisInfoLeft{}; //!< The NpadSixAxisInfo for the main or left side of this controller's type
         NpadSixAxisInfo *sixAxisInfoRight{}; //!< The NpadSixAxisInfo for the right side of this controller's type
         u64 globalTimestamp{}; //!< An incrementing timestamp that's common across all sections
+        u64 sixAxisTimestamp{}; //!< An incrementing timestamp that's common across all six-axis sections, these are sampled independently of the controller sections
         NpadControllerState controllerState{}, defaultState{}; //!< The current state of the controller (normal and default)
         NpadSixAxisState sixAxisStateLeft{}, sixAxisStateRight{}; //!< The current state of the sixaxis (left and right)
 
@@ -210,13 +211,17 @@ namespace skyline::input {
          */
         NpadSixAxisInfo &GetSixAxisInfo(MotionId id);
 
+        bool vibrationPending{}; //!< If the vibration values were modified since they were last dispatched to the host, this is protected by NpadManager::vibrationMutex
+        NpadVibrationValue dispatchedVibrationLeft{}; //!< The value of `vibrationLeft` at the last dispatch to the host
+        std::optional<NpadVibrationValue> dispatchedVibrationRight; //!< The value of `vibrationRight` at the last dispatch to the host
+
       public:
         NpadId id;
         static constexpr i8 NullIndex{-1}; //!< The placeholder index value when there is no device present
         i8 index{NullIndex}; //!< The index of the device assigned to this player
         i8 partnerIndex{NullIndex}; //!< The index of a partner device, if present
-        NpadVibrationValue vibrationLeft{}; //!< Vibration for the left Joy-Con (Handheld/Pair), left LRA in a Pro-Controller or individual Joy-Cons
-        std::optional<NpadVibrationValue> vibrationRight; //!< Vibration for the right Joy-Con (Handheld/Pair) or right LRA in a Pro-Controller
+        NpadVibrationValue vibrationLeft{}; //!< Vibration for the left Joy-Con (Handheld/Pair), left LRA in a Pro-Controller or individual Joy-Cons, this is protected by NpadManager::vibrationMutex
+        std::optional<NpadVibrationValue> vibrationRight; //!< Vibration for the right Joy-Con (Handheld/Pair) or right LRA in a Pro-Controller, this is protected by NpadManager::vibrationMutex
         NpadControllerType type{};
         NpadConnectionState connectionState{};
         std::shared_ptr<kernel::type::KEvent> updateEvent; //!< This event is triggered on the controller's style changing
@@ -247,6 +252,12 @@ namespace skyline::input {
          */
         void UpdateSharedMemory();
 
+        /**
+         * @brief Writes the current state of the six-axis sensors to HID shared memory
+         * @param samplingPeriod The period at which the sensors are sampled, this is used as the delta between samples regardless of the rate of host sensor events
+         */
+        void UpdateSixAxisSharedMemory(std::chrono::nanoseconds samplingPeriod);
+
         /**
          * @brief Changes the state of buttons to the specified state
          * @param mask A bit-field mask of all the buttons to change
@@ -270,12 +281,25 @@ namespace skyline::input {
 
         /**
          * @brief Sets the vibration for both the Joy-Cons to the specified vibration values
+         * @note The values are only dispatched to the host by the vibration thread, any further changes prior to that are coalesced with this
          */
         void Vibrate(const NpadVibrationValue &left, const NpadVibrationValue &right);
 
         /**
          * @brief Sets the vibration for either the left or right Joy-Con to the specified vibration value
+         * @note The values are only dispatched to the host by the vibration thread, any further changes prior to that are coalesced with this
          */
         void VibrateSingle(bool isRight, const NpadVibrationValue &value);
+
+        /**
+         * @brief Resets the vibration of the right Joy-Con to a null vibration
+         */
+        void ResetVibrationRight();
+
+        /**
+         * @brief Dispatches the current vibration values to the host vibrators if they were modified since the last dispatch
+         * @note This should only be called by the vibration thread as it calls into the JVM
+         */
+        void DispatchVibration();
     };
 }
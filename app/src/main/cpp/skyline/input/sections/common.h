@@ -3,6 +3,7 @@
 
 #pragma once
 
+#include <atomic>
 #include <common.h>
 
 namespace skyline {
@@ -24,5 +25,26 @@ namespace skyline {
             u64 maxEntry; //!< The maximum entry index
         };
         static_assert(sizeof(CommonHeader) == 0x20);
+
+        /**
+         * @brief Publishes a new entry into the ring LIFO of a section, the guest may concurrently read the section so the entry must be completely written prior to the header pointing to it
+         * @param write A function which is supplied the latest entry and the entry to be written, it should fill in the latter entirely
+         * @note This is equivalent to a seqlock with the index of the latest entry acting as the sequence, the slot being written is the oldest one which the guest doesn't read while newer entries exist
+         */
+        template<typename EntryType, size_t Size, typename WriteFunction>
+        void PublishLifoEntry(CommonHeader &header, std::array<EntryType, Size> &entries, WriteFunction &&write) {
+            u64 entryCount{std::min(header.entryCount + 1, static_cast<u64>(Size))};
+            u64 maxEntry{entryCount - 1};
+            u64 nextEntry{(header.currentEntry < maxEntry) ? header.currentEntry + 1 : 0};
+
+            write(std::as_const(entries[header.currentEntry]), entries[nextEntry]);
+
+            // The entry must be visible prior to the header being updated to avoid the guest reading a partially written entry
+            std::atomic_thread_fence(std::memory_order_release);
+            header.timestamp = util::GetTimeTicks();
+            header.entryCount = entryCount;
+            header.maxEntry = maxEntry;
+            __atomic_store_n(&header.currentEntry, nextEntry, __ATOMIC_RELEASE);
+        }
     }
 }
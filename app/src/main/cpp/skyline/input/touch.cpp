@@ -73,16 +73,10 @@ namespace skyline::input {
         if (!activated)
             return;
 
-        const auto &lastEntry{section.entries[section.header.currentEntry]};
-
-        section.header.timestamp = util::GetTimeTicks();
-        section.header.entryCount = std::min(static_cast<u8>(section.header.entryCount + 1), constant::HidEntryCount);
-        section.header.maxEntry = section.header.entryCount - 1;
-        section.header.currentEntry = (section.header.currentEntry < section.header.maxEntry) ? section.header.currentEntry + 1 : 0;
-
-        auto &entry{section.entries[section.header.currentEntry]};
-        entry = screenState;
-        entry.globalTimestamp = lastEntry.globalTimestamp + 1;
-        entry.localTimestamp = lastEntry.localTimestamp + 1;
+        PublishLifoEntry(section.header, section.entries, [&](const auto &lastEntry, auto &entry) {
+            entry = screenState;
+            entry.globalTimestamp = lastEntry.globalTimestamp + 1;
+            entry.localTimestamp = lastEntry.localTimestamp + 1;
+        });
     }
 }
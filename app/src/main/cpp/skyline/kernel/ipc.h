@@ -3,6 +3,7 @@
 
 #pragma once
 
+#include <boost/container/static_vector.hpp>
 #include <common.h>
 #include "types/KSession.h"
 #include "types/KProcess.h"
@@ -242,7 +243,7 @@ namespace skyline {
             std::shared_ptr<ServiceType> PopService(u32 id, type::KSession &session) {
                 std::shared_ptr<service::BaseService> serviceObject;
                 if (session.isDomain)
-                    serviceObject = session.domains.at(domainObjects.at(id));
+                    serviceObject = session.GetDomainObject(domainObjects.at(id));
                 else
                     serviceObject = session.state.process->GetHandle<kernel::type::KSession>(moveHandles.at(id))->serviceObject;
 
@@ -265,7 +266,7 @@ namespace skyline {
         class IpcResponse {
           private:
             const DeviceState &state;
-            std::vector<u8> payload; //!< The contents to be pushed to the data payload
+            boost::container::static_vector<u8, constant::TlsIpcSize> payload; //!< The contents to be pushed to the data payload, this is stored inline as it can never exceed the size of the TLS IPC buffer it's written into
 
           public:
             Result errorCode{}; //!< The error code to respond with, it's 0 (Success) by default
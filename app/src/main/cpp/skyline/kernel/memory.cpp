@@ -3,6 +3,7 @@
 
 #include <asm-generic/unistd.h>
 #include <fcntl.h>
+#include <common/trace.h>
 #include "memory.h"
 #include "types/KProcess.h"
 
@@ -17,6 +18,12 @@ namespace skyline::kernel {
                 munmap(reinterpret_cast<void *>(codeBase36Bit.data()), codeBase36Bit.size());
     }
 
+    void MemoryManager::IndexChunks(u8 *start, u8 *end) {
+        auto chunk{std::prev(chunks.upper_bound(start))};
+        for (; chunk->first < end; ++chunk)
+            chunkTable.Set(std::max(chunk->first, start), std::min(chunk->first + chunk->second.size, end), &*chunk);
+    }
+
     void MemoryManager::MapInternal(const std::pair<u8 *, ChunkDescriptor> &newDesc) {
         // The chunk that contains / precedes the new chunk base address
         auto firstChunkBase{chunks.lower_bound(newDesc.first)};
@@ -31,6 +38,9 @@ namespace skyline::kernel {
         ChunkDescriptor firstChunk{firstChunkBase->second};
         ChunkDescriptor lastChunk{lastChunkBase->second};
 
+        // Any pages prior to the new chunk stay in the first chunk which is never reinserted, pages from the start of the new chunk till the end of the last chunk may end up in a different chunk and need to be reindexed
+        u8 *indexEnd{lastChunkBase->first + lastChunk.size};
+
         bool needsReprotection{false};
         bool isUnmapping{newDesc.second.state == memory::states::Unmapped};
 
@@ -113,6 +123,8 @@ namespace skyline::kernel {
                 chunks.insert(newDesc);
         }
 
+        IndexChunks(newDesc.first, indexEnd);
+
         if (needsReprotection)
             if (mprotect(newDesc.first, newDesc.second.size, !isUnmapping ? PROT_READ | PROT_WRITE | PROT_EXEC : PROT_NONE)) [[unlikely]]
                 Logger::Warn("Reprotection failed: {}", strerror(errno));
@@ -155,6 +167,57 @@ namespace skyline::kernel {
 
     constexpr size_t RegionAlignment{1ULL << 21}; //!< The minimum alignment of a HOS memory region
     constexpr size_t CodeRegionSize{4ULL * 1024 * 1024 * 1024}; //!< The assumed maximum size of the code region (4GiB)
+    constexpr size_t HugePageSize{1ULL << 21}; //!< The size of a PMD-mapped transparent huge page with 4 KiB pages (2MiB)
+
+    /**
+     * @return If the kernel will back shared memory with transparent huge pages for regions which are advised with MADV_HUGEPAGE
+     */
+    static bool IsShmemHugePageSupported() {
+        std::ifstream file{"/sys/kernel/mm/transparent_hugepage/shmem_enabled"};
+        std::string modes;
+        if (!std::getline(file, modes))
+            return false;
+
+        // The currently selected mode is enclosed in square brackets
+        return modes.find("[always]") != std::string::npos || modes.find("[within_size]") != std::string::npos || modes.find("[advise]") != std::string::npos || modes.find("[force]") != std::string::npos;
+    }
+
+    void MemoryManager::AdviseHugePages(span<u8> region) {
+        if (!hugePagesSupported)
+            return;
+
+        u8 *alignedStart{util::AlignUp(region.data(), HugePageSize)};
+        u8 *alignedEnd{util::AlignDown(region.end().base(), HugePageSize)};
+        if (alignedStart >= alignedEnd)
+            return;
+
+        if (madvise(alignedStart, static_cast<size_t>(alignedEnd - alignedStart), MADV_HUGEPAGE) == -1) [[unlikely]]
+            Logger::Warn("Failed to advise huge pages for 0x{:X} - 0x{:X}: {}", alignedStart, alignedEnd, strerror(errno));
+        else
+            hugePageAdvisedSize += static_cast<size_t>(alignedEnd - alignedStart);
+    }
+
+    void MemoryManager::TraceHugePageUsage() {
+        if (!TRACE_EVENT_CATEGORY_ENABLED("kernel"))
+            return;
+
+        std::ifstream smaps{"/proc/self/smaps"};
+        size_t backedSize{};
+        bool inGuest{};
+        for (std::string line; std::getline(smaps, line);) {
+            auto separator{line.find('-')};
+            if (separator != std::string::npos && separator < line.find(' ') && std::isxdigit(line[0])) {
+                // Every mapping starts with a header line containing its address range
+                auto start{reinterpret_cast<u8 *>(std::strtoull(line.c_str(), nullptr, 16))};
+                inGuest = base.contains(start) || (codeBase36Bit.valid() && codeBase36Bit.contains(start));
+            } else if (inGuest && (line.starts_with("ShmemPmdMapped:") || line.starts_with("AnonHugePages:"))) {
+                backedSize += std::strtoull(line.c_str() + line.find(':') + 1, nullptr, 10) * 1024;
+            }
+        }
+
+        TRACE_COUNTER("kernel", perfetto::CounterTrack{"GuestHugePageAdvised"}, hugePageAdvisedSize);
+        TRACE_COUNTER("kernel", perfetto::CounterTrack{"GuestHugePageBacked"}, backedSize);
+    }
 
     static span<u8> AllocateMappedRange(size_t minSize, size_t align, size_t minAddress, size_t maxAddress, bool findLargest) {
         span<u8> region{};
@@ -223,6 +286,10 @@ namespace skyline::kernel {
 
         base = AllocateMappedRange(baseSize, RegionAlignment, KgslReservedRegionSize, addressSpace.size(), false);
 
+        hugePagesSupported = IsShmemHugePageSupported();
+        if (!hugePagesSupported)
+            Logger::Info("Transparent huge pages aren't available for shared memory, the guest address space will be backed by regular pages");
+
         if (type != memory::AddressSpaceType::AddressSpace36Bit) {
             code = base;
         } else {
@@ -241,6 +308,7 @@ namespace skyline::kernel {
         }}, {reinterpret_cast<u8 *>(UINT64_MAX), {
             .state = memory::states::Reserved,
         }}};
+        IndexChunks(addressSpace.data(), addressSpace.end().base());
     }
 
     void MemoryManager::InitializeRegions(span<u8> codeRegion) {
@@ -292,6 +360,11 @@ namespace skyline::kernel {
         if (codeRegion.size() > code.size()) [[unlikely]]
             throw exception("Code region ({}) is smaller than mapped code size ({})", code.size(), codeRegion.size());
 
+        // The code and heap regions are both aligned to 2MiB so they can be entirely backed by huge pages, this significantly reduces TLB pressure for titles with large working sets
+        AdviseHugePages(code);
+        AdviseHugePages(heap);
+        TraceHugePageUsage();
+
         Logger::Debug("Region Map:\nVMM Base: 0x{:X}\nCode Region: 0x{:X} - 0x{:X} (Size: 0x{:X})\nAlias Region: 0x{:X} - 0x{:X} (Size: 0x{:X})\nHeap Region: 0x{:X} - 0x{:X} (Size: 0x{:X})\nStack Region: 0x{:X} - 0x{:X} (Size: 0x{:X})\nTLS/IO Region: 0x{:X} - 0x{:X} (Size: 0x{:X})", code.data(), code.data(), code.end().base(), code.size(), alias.data(), alias.end().base(), alias.size(), heap.data(), heap.end().base(), heap.size(), stack.data(), stack.end().base(), stack.size(), tlsIo.data(), tlsIo.end().base(), tlsIo.size());
     }
 
@@ -378,11 +451,7 @@ namespace skyline::kernel {
         if (!addressSpace.contains(addr)) [[unlikely]]
             return std::nullopt;
 
-        auto chunkBase{chunks.lower_bound(addr)};
-        if (addr < chunkBase->first)
-            --chunkBase;
-
-        return std::make_optional(*chunkBase);
+        return std::make_optional(*chunkTable[addr]);
     }
 
     __attribute__((always_inline)) void MemoryManager::MapCodeMemory(span<u8> memory, memory::Permission permission) {
@@ -428,6 +497,8 @@ namespace skyline::kernel {
                 .permission = {true, true, false},
                 .state = memory::states::Heap
         }));
+
+        TraceHugePageUsage();
     }
 
     __attribute__((always_inline)) void MemoryManager::MapSharedMemory(span<u8> memory, memory::Permission permission) {
@@ -479,10 +550,22 @@ namespace skyline::kernel {
     __attribute__((always_inline)) void MemoryManager::UnmapMemory(span<u8> memory) {
         std::unique_lock lock{mutex};
 
+        // Contiguous mapped chunks are coalesced so a range with many chunks (such as a heap with varying attributes) is freed with a single madvise call
+        span<u8> freeRange{};
         ForeachChunkInRange(memory, [&](const std::pair<u8 *, ChunkDescriptor> &desc) {
-            if (desc.second.state != memory::states::Unmapped)
-                FreeMemory(span<u8>(desc.first, desc.second.size));
+            if (desc.second.state == memory::states::Unmapped)
+                return;
+
+            if (freeRange.valid() && freeRange.end().base() == desc.first) {
+                freeRange = span<u8>{freeRange.data(), freeRange.size() + desc.second.size};
+            } else {
+                if (freeRange.valid())
+                    FreeMemory(freeRange);
+                freeRange = span<u8>{desc.first, desc.second.size};
+            }
         });
+        if (freeRange.valid())
+            FreeMemory(freeRange);
 
         MapInternal(std::pair<u8 *, ChunkDescriptor>(
             memory.data(),{
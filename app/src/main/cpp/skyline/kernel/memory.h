@@ -6,6 +6,7 @@
 #include <sys/mman.h>
 #include <common.h>
 #include <common/file_descriptor.h>
+#include <common/segment_table.h>
 #include <map>
 
 namespace skyline {
@@ -225,10 +226,34 @@ namespace skyline {
         class MemoryManager {
           private:
             const DeviceState &state;
-            std::map<u8 *, ChunkDescriptor> chunks;
+            using ChunkMap = std::map<u8 *, ChunkDescriptor>;
+            ChunkMap chunks;
+
+            static constexpr size_t ChunkTableL2Bits{21}; //!< The amount of AS (in bytes) a single L2 entry in the chunk table covers (2 MiB == 1 << 21), this matches the minimum alignment of HOS memory regions
+            SegmentTable<ChunkMap::value_type *, constant::AddressSpaceSize, constant::PageSizeBits, ChunkTableL2Bits> chunkTable; //!< A page table pointing to the chunk in `chunks` that contains each page for O(1) point lookups, it's kept in sync with the map by MapInternal
 
             std::vector<std::shared_ptr<type::KMemory>> memRefs;
 
+            bool hugePagesSupported{}; //!< If the host kernel supports transparent huge pages for the shared memory backing the guest address space
+            size_t hugePageAdvisedSize{}; //!< The total size of all regions that have been advised to be backed by huge pages
+
+            /**
+             * @brief Advises the kernel to back the largest 2 MiB aligned portion of the region with transparent huge pages
+             * @note This is a no-op if the host kernel doesn't support transparent huge pages for shared memory
+             */
+            void AdviseHugePages(span<u8> region);
+
+            /**
+             * @brief Emits perfetto counters for the amount of the guest address space that has been advised to be and is actually backed by huge pages
+             * @note This parses /proc/self/smaps which is expensive, it's only done when the kernel trace category is enabled
+             */
+            void TraceHugePageUsage();
+
+            /**
+             * @brief Updates the chunk table entries for all pages in the supplied range to point to the chunks that contain them
+             */
+            void IndexChunks(u8 *start, u8 *end);
+
             void MapInternal(const std::pair<u8 *, ChunkDescriptor> &newDesc);
 
             void ForeachChunkInRange(span<u8> memory, auto editCallback);
@@ -303,6 +328,9 @@ namespace skyline {
 
             void MapStackMemory(span<u8> memory);
 
+            /**
+             * @note The memory isn't explicitly zeroed as any unmapped guest memory has had its backing released by `FreeMemory`, the kernel lazily supplies zeroed pages on the first access to it
+             */
             void MapHeapMemory(span<u8> memory);
 
             void MapSharedMemory(span<u8> memory, memory::Permission permission);
@@ -314,13 +342,14 @@ namespace skyline {
             void Reserve(span<u8> memory);
 
             /**
-             * @note `UnmapMemory` also calls `FreeMemory` on the unmapped memory range
+             * @note `UnmapMemory` also calls `FreeMemory` on the unmapped memory range, contiguous mapped chunks are freed together
              */
             void UnmapMemory(span<u8> memory);
 
             /**
-             * Frees the underlying memory
+             * Frees the underlying memory, any subsequent accesses to it will read as zero
              * @note Memory that's not aligned to page boundaries at the edges of the span will not be freed
+             * @note MADV_REMOVE is used as the guest address space is a shared mapping, MADV_DONTNEED would only drop the page table entries while retaining the backing and MADV_FREE isn't supported on shared mappings
              */
             void FreeMemory(span<u8> memory);
 
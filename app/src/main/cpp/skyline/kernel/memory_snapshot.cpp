@@ -0,0 +1,160 @@
+// SPDX-License-Identifier: MPL-2.0
+// Copyright © 2023 Skyline Team and Contributors (https://github.com/skyline-emu/)
+
+#include <sys/mman.h>
+#include <common/trace.h>
+#include <kernel/types/KProcess.h>
+#include "memory_snapshot.h"
+
+namespace skyline::kernel {
+    MemorySnapshot::MemorySnapshot(const DeviceState &state, const std::string &path) : state{state} {
+        stream = std::ofstream{path, std::ios::binary | std::ios::trunc};
+        if (stream.fail())
+            throw exception("Failed to open memory snapshot file '{}'", path);
+
+        auto &processMemory{state.process->memory};
+        size_t pageCount{};
+        for (u8 *address{processMemory.addressSpace.data()}; address < processMemory.addressSpace.end().base();) {
+            auto chunk{processMemory.GetChunk(address)};
+            if (!chunk)
+                break;
+
+            auto [chunkAddress, descriptor]{*chunk};
+            address = chunkAddress + descriptor.size;
+
+            // Unmapped, reserved and IO regions aren't backed by any guest memory that could be saved
+            if (descriptor.state == memory::states::Unmapped || descriptor.state == memory::states::Reserved || descriptor.state == memory::states::Io)
+                continue;
+
+            regions.push_back(Region{
+                .memory = span<u8>{chunkAddress, descriptor.size},
+                .memoryState = descriptor.state,
+                .pageIndex = pageCount,
+            });
+            pageCount += descriptor.size / constant::PageSize;
+        }
+
+        pageStates.resize(pageCount, PageState::Pending);
+
+        if (pageCount) {
+            auto preservedMemory{mmap(nullptr, pageCount * constant::PageSize, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0)};
+            if (preservedMemory == MAP_FAILED)
+                throw exception("Failed to allocate memory for preserving snapshot pages: {}", strerror(errno));
+            preserved = span<u8>{static_cast<u8 *>(preservedMemory), pageCount * constant::PageSize};
+        }
+
+        // The snapshot is taken at the point each region is trapped, any writes after that point go through PreservePages
+        for (auto &region : regions) {
+            std::array<span<u8>, 1> trapRegions{region.memory};
+            region.trap = state.nce->CreateTrap(trapRegions, [this] {
+                std::scoped_lock lock{mutex};
+            }, [] {
+                return true;
+            }, [this, &region] {
+                return PreservePages(region, region.memory);
+            }, [this, &region](span<u8> pages) {
+                return PreservePages(region, pages);
+            });
+
+            // The subregion overload is used as it always write-protects the pages, writes being tracked by the kernel rather than trapped would only be observed after they've happened
+            state.nce->TrapRegions(*region.trap, region.memory, true);
+        }
+
+        MemorySnapshotHeader header{
+            .regionCount = static_cast<u32>(regions.size()),
+        };
+        stream.write(reinterpret_cast<const char *>(&header), sizeof(MemorySnapshotHeader));
+        for (const auto &region : regions) {
+            MemorySnapshotRegion snapshotRegion{
+                .address = reinterpret_cast<u64>(region.memory.data()),
+                .size = region.memory.size(),
+                .state = region.memoryState,
+            };
+            stream.write(reinterpret_cast<const char *>(&snapshotRegion), sizeof(MemorySnapshotRegion));
+        }
+
+        Logger::Info("Started writing a memory snapshot of {} region(s) totalling {} MiB to '{}'", regions.size(), (pageCount * constant::PageSize) / 1024 / 1024, path);
+        thread = std::thread(&MemorySnapshot::WriterThread, this);
+    }
+
+    MemorySnapshot::~MemorySnapshot() {
+        cancel = true;
+        if (thread.joinable())
+            thread.join();
+
+        DeleteTraps();
+        if (preserved.valid())
+            munmap(preserved.data(), preserved.size());
+    }
+
+    bool MemorySnapshot::PreservePages(const Region &region, span<u8> pages) {
+        std::unique_lock lock{mutex, std::try_to_lock};
+        if (!lock)
+            return false;
+
+        // Both the pages and the region are page-aligned so the intersection of them is as well
+        auto start{std::max(pages.data(), region.memory.data())}, end{std::min(pages.end().base(), region.memory.end().base())};
+        for (u8 *page{start}; page < end; page += constant::PageSize) {
+            size_t pageIndex{region.pageIndex + static_cast<size_t>(page - region.memory.data()) / constant::PageSize};
+            if (pageStates[pageIndex] != PageState::Pending)
+                continue;
+
+            std::memcpy(preserved.data() + pageIndex * constant::PageSize, page, constant::PageSize);
+            pageStates[pageIndex] = PageState::Preserved;
+        }
+        return true;
+    }
+
+    void MemorySnapshot::WriterThread() {
+        if (int result{pthread_setname_np(pthread_self(), "Sky-Snapshot")})
+            Logger::Warn("Failed to set the thread name: {}", strerror(result));
+
+        std::vector<u8> staging(BatchPageCount * constant::PageSize);
+        for (const auto &region : regions) {
+            size_t regionPageCount{region.memory.size() / constant::PageSize};
+            for (size_t pageOffset{}; pageOffset < regionPageCount; pageOffset += BatchPageCount) {
+                if (cancel)
+                    return;
+
+                TRACE_EVENT("kernel", "MemorySnapshot::WriteBatch");
+                size_t batchPageCount{std::min(BatchPageCount, regionPageCount - pageOffset)};
+                bool anyPreserved{};
+                {
+                    std::scoped_lock lock{mutex};
+                    for (size_t batchPage{}; batchPage < batchPageCount; batchPage++) {
+                        size_t pageIndex{region.pageIndex + pageOffset + batchPage};
+                        bool isPreserved{pageStates[pageIndex] == PageState::Preserved};
+                        anyPreserved |= isPreserved;
+                        u8 *source{isPreserved ? preserved.data() + pageIndex * constant::PageSize : region.memory.data() + (pageOffset + batchPage) * constant::PageSize};
+                        std::memcpy(staging.data() + batchPage * constant::PageSize, source, constant::PageSize);
+                        pageStates[pageIndex] = PageState::Written;
+                    }
+                }
+
+                stream.write(reinterpret_cast<const char *>(staging.data()), static_cast<std::streamsize>(batchPageCount * constant::PageSize));
+
+                // The preserved copies are no longer required so their backing can be released
+                if (anyPreserved)
+                    madvise(preserved.data() + (region.pageIndex + pageOffset) * constant::PageSize, batchPageCount * constant::PageSize, MADV_DONTNEED);
+            }
+        }
+
+        // Every page has been written out at this point so there's no need to trap writes any longer
+        DeleteTraps();
+        stream.close();
+
+        if (stream.fail())
+            Logger::Warn("Failed to write out the memory snapshot");
+        else
+            Logger::Info("Finished writing out the memory snapshot");
+        complete.store(true, std::memory_order_release);
+    }
+
+    void MemorySnapshot::DeleteTraps() {
+        for (auto &region : regions) {
+            if (region.trap)
+                state.nce->DeleteTrap(*region.trap);
+            region.trap.reset();
+        }
+    }
+}
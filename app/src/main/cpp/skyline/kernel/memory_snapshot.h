@@ -0,0 +1,103 @@
+// SPDX-License-Identifier: MPL-2.0
+// Copyright © 2023 Skyline Team and Contributors (https://github.com/skyline-emu/)
+
+#pragma once
+
+#include <fstream>
+#include <nce.h>
+#include "memory.h"
+
+namespace skyline::kernel {
+    /**
+     * @brief The header of a memory snapshot file, it's followed by `regionCount` MemorySnapshotRegion entries and then the contents of every region in the same order
+     */
+    struct MemorySnapshotHeader {
+        static constexpr u32 Magic{util::MakeMagic<u32>("SKMS")};
+        static constexpr u32 Version{1};
+
+        u32 magic{Magic};
+        u32 version{Version};
+        u32 regionCount;
+        u32 _pad_;
+    };
+    static_assert(sizeof(MemorySnapshotHeader) == 0x10);
+
+    struct MemorySnapshotRegion {
+        u64 address; //!< The guest address of the region
+        u64 size;
+        memory::MemoryState state;
+        u32 _pad_;
+    };
+    static_assert(sizeof(MemorySnapshotRegion) == 0x18);
+
+    /**
+     * @brief A copy-on-write snapshot of all mapped guest memory which is written out to a file in the background while the guest keeps running
+     * @details All regions are write-protected with NCE traps when the snapshot is taken, a write to a page which hasn't been written out yet preserves the prior contents of the page before the write is allowed to proceed
+     * @note Guest threads aren't paused while the regions are being trapped so writes which race with taking the snapshot may or may not be captured, writes through host mirrors of guest memory bypass the traps and aren't captured either
+     */
+    class MemorySnapshot {
+      private:
+        static constexpr size_t BatchPageCount{16}; //!< The amount of pages which are read from guest memory under the lock at once by the writer thread
+
+        enum class PageState : u8 {
+            Pending, //!< The page hasn't been written out and is still trapped
+            Preserved, //!< The page was written to by the guest, its prior contents were preserved and still need to be written out
+            Written, //!< The page has been written out
+        };
+
+        struct Region {
+            span<u8> memory;
+            memory::MemoryState memoryState;
+            size_t pageIndex; //!< The index of the first page of the region in `pageStates` and `preserved`
+            std::optional<nce::NCE::TrapHandle> trap;
+        };
+
+        const DeviceState &state;
+        std::vector<Region> regions;
+        std::ofstream stream;
+
+        std::mutex mutex; //!< Synchronizes the page states, it's held by the writer thread while reading guest pages and only try-locked by trap callbacks
+        std::vector<PageState> pageStates; //!< The state of every page in the snapshot
+        span<u8> preserved; //!< Lazily committed memory with a slot for every page in the snapshot, this holds the prior contents of pages that were written to before being written out
+
+        std::thread thread;
+        std::atomic<bool> cancel{}; //!< If the writer thread should exit without writing out the rest of the snapshot
+        std::atomic<bool> complete{};
+
+        /**
+         * @brief Preserves the contents of all pending pages in the supplied range of a region
+         * @return If the pages could be preserved, this fails if the writer thread is currently reading guest memory
+         */
+        bool PreservePages(const Region &region, span<u8> pages);
+
+        void WriterThread();
+
+        /**
+         * @brief Deletes the traps of all regions, this makes guest writes to them fault-free again
+         */
+        void DeleteTraps();
+
+      public:
+        /**
+         * @brief Takes a snapshot of all currently mapped guest memory and starts writing it out to a file at the supplied path, it is truncated if it already exists
+         * @note An exception is thrown if the file couldn't be created
+         */
+        MemorySnapshot(const DeviceState &state, const std::string &path);
+
+        MemorySnapshot(const MemorySnapshot &) = delete;
+
+        MemorySnapshot &operator=(const MemorySnapshot &) = delete;
+
+        /**
+         * @note If the snapshot hasn't been written out in full, writing it out is cancelled and the file is left incomplete
+         */
+        ~MemorySnapshot();
+
+        /**
+         * @return If the snapshot has been written out in full
+         */
+        bool IsComplete() {
+            return complete.load(std::memory_order_acquire);
+        }
+    };
+}
@@ -4,13 +4,170 @@
 #include <unistd.h>
 #include <common/signal.h>
 #include <common/trace.h>
+#include <common/host_affinity.h>
+#include <common/performance_stats.h>
+#include <common/performance_stats.h>
 #include "types/KThread.h"
 #include "scheduler.h"
 
 namespace skyline::kernel {
+    type::KThread *ThreadQueue::Next(const type::KThread *thread) const {
+        if (thread->queueNext)
+            return thread->queueNext;
+
+        // Find the next non-empty priority level after the one the thread is at, the shift is well-defined for the last level as it wraps around to 0
+        u64 nextLevels{levelMask & ~((2ULL << thread->queuePriority) - 1)};
+        return nextLevels ? levels[std::countr_zero(nextLevels)].head : nullptr;
+    }
+
+    void ThreadQueue::PushBack(type::KThread *thread, i8 priority) {
+        auto &level{levels.at(static_cast<u8>(priority))};
+        thread->queuePrevious = level.tail;
+        thread->queueNext = nullptr;
+        thread->queuePriority = priority;
+        thread->isQueued = true;
+
+        if (level.tail)
+            level.tail->queueNext = thread;
+        else
+            level.head = thread;
+        level.tail = thread;
+
+        levelMask |= 1ULL << priority;
+    }
+
+    void ThreadQueue::PushFront(type::KThread *thread, i8 priority) {
+        auto &level{levels.at(static_cast<u8>(priority))};
+        thread->queuePrevious = nullptr;
+        thread->queueNext = level.head;
+        thread->queuePriority = priority;
+        thread->isQueued = true;
+
+        if (level.head)
+            level.head->queuePrevious = thread;
+        else
+            level.tail = thread;
+        level.head = thread;
+
+        levelMask |= 1ULL << priority;
+    }
+
+    void ThreadQueue::Remove(type::KThread *thread) {
+        auto &level{levels[static_cast<u8>(thread->queuePriority)]};
+        if (thread->queuePrevious)
+            thread->queuePrevious->queueNext = thread->queueNext;
+        else
+            level.head = thread->queueNext;
+
+        if (thread->queueNext)
+            thread->queueNext->queuePrevious = thread->queuePrevious;
+        else
+            level.tail = thread->queuePrevious;
+
+        if (!level.head)
+            levelMask &= ~(1ULL << thread->queuePriority);
+
+        thread->queuePrevious = nullptr;
+        thread->queueNext = nullptr;
+        thread->isQueued = false;
+    }
+
     Scheduler::CoreContext::CoreContext(u8 id, i8 preemptionPriority) : id(id), preemptionPriority(preemptionPriority) {}
 
-    Scheduler::Scheduler(const DeviceState &state) : state(state) {}
+    Scheduler::Scheduler(const DeviceState &state) : state(state), preemptionTicker(&Scheduler::PreemptionTicker, this) {}
+
+    Scheduler::~Scheduler() {
+        {
+            std::scoped_lock lock{preemptionMutex};
+            preemptionExit = true;
+            preemptionCondition.notify_all();
+        }
+        if (preemptionTicker.joinable())
+            preemptionTicker.join();
+    }
+
+    void Scheduler::PreemptionTicker() {
+        if (int result{pthread_setname_np(pthread_self(), "Sky-Preempt")})
+            Logger::Warn("Failed to set the thread name: {}", strerror(result));
+        HostAffinity::PlaceCurrentThread(HostThreadRole::Background);
+
+        std::unique_lock lock{preemptionMutex};
+        while (!preemptionExit) {
+            i64 now{util::GetTimeNs()}, nextDeadline{};
+            for (auto &core : cores) {
+                if (i64 deadline{core.preemptionDeadline.load(std::memory_order_relaxed)}; deadline && deadline <= now) {
+                    lock.unlock();
+                    TickPreemption(core, now);
+                    lock.lock();
+                }
+
+                if (i64 deadline{core.preemptionDeadline.load(std::memory_order_relaxed)}; deadline && (!nextDeadline || deadline < nextDeadline))
+                    nextDeadline = deadline;
+            }
+
+            if (nextDeadline) {
+                preemptionCondition.wait_for(lock, std::chrono::nanoseconds{nextDeadline - now});
+            } else {
+                // We need to recheck the deadlines after marking ourselves as idle as preemption could've been armed without waking us prior to that
+                preemptionIdle = true;
+                if (std::none_of(cores.begin(), cores.end(), [](const CoreContext &core) { return core.preemptionDeadline.load(); }))
+                    preemptionCondition.wait(lock);
+                preemptionIdle = false;
+            }
+        }
+    }
+
+    void Scheduler::TickPreemption(CoreContext &core, i64 now) {
+        std::unique_lock lock{core.mutex};
+        i64 deadline{core.preemptionDeadline.load(std::memory_order_relaxed)};
+        if (!deadline || deadline > now)
+            return; // Preemption was disarmed or rearmed for another timeslice prior to us acquiring the lock
+
+        auto thread{core.preemptiveThread};
+        if (!thread || core.queue.Front() != thread) {
+            // The thread that preemption was armed for is no longer running on this core, it was migrated without disarming preemption
+            core.preemptionDeadline.store(0, std::memory_order_relaxed);
+            core.preemptiveThread = nullptr;
+            return;
+        }
+
+        auto nextThread{core.queue.Next(thread)};
+        if (!nextThread || nextThread->queuePriority != thread->queuePriority) {
+            // There's no other thread of the same priority that a rotation would schedule, we can avoid signalling the thread and just extend its timeslice
+            core.preemptionDeadline.store(now + std::chrono::duration_cast<std::chrono::nanoseconds>(PreemptiveTimeslice).count(), std::memory_order_relaxed);
+            return;
+        }
+
+        core.preemptionDeadline.store(0, std::memory_order_relaxed);
+        core.preemptiveThread = nullptr;
+
+        auto sharedThread{thread->shared_from_this()};
+        lock.unlock(); // SendSignal can block on the thread's status mutex, we don't want to hold the core mutex while doing so
+        sharedThread->SendSignal(PreemptionSignal);
+    }
+
+    void Scheduler::ArmPreemption(CoreContext &core, type::KThread *thread) {
+        core.preemptiveThread = thread;
+        core.preemptionDeadline.store(util::GetTimeNs() + std::chrono::duration_cast<std::chrono::nanoseconds>(PreemptiveTimeslice).count());
+        thread->isPreempted = true;
+
+        // The ticker only needs to be woken when it's idle, otherwise it'll be waiting on a deadline which must be earlier than this one as all timeslices are the same length
+        if (preemptionIdle.load()) [[unlikely]] {
+            std::scoped_lock lock{preemptionMutex};
+            preemptionCondition.notify_one();
+        }
+    }
+
+    void Scheduler::DisarmPreemption(CoreContext &core, type::KThread *thread) {
+        if (!thread->isPreempted) [[likely]]
+            return;
+
+        if (core.preemptiveThread == thread) {
+            core.preemptionDeadline.store(0, std::memory_order_relaxed);
+            core.preemptiveThread = nullptr;
+        }
+        thread->isPreempted = false;
+    }
 
     void Scheduler::SignalHandler(int signal, siginfo *info, ucontext *ctx, void **tls) {
         if (*tls) {
@@ -33,7 +190,7 @@ namespace skyline::kernel {
     Scheduler::CoreContext &Scheduler::GetOptimalCoreForThread(const std::shared_ptr<type::KThread> &thread) {
         auto *currentCore{&cores.at(thread->coreId)};
 
-        if (!currentCore->queue.empty() && thread->affinityMask.count() != 1) {
+        if (!currentCore->queue.Empty() && thread->affinityMask.count() != 1) {
             // Select core where the current thread will be scheduled the earliest based off average timeslice durations for resident threads
             // There's a preference for the current core as migration isn't free
             size_t minTimeslice{};
@@ -42,12 +199,10 @@ namespace skyline::kernel {
                 if (thread->affinityMask.test(candidateCore.id)) {
                     u64 timeslice{};
 
-                    if (!candidateCore.queue.empty()) {
+                    if (!candidateCore.queue.Empty()) {
                         std::scoped_lock coreLock{candidateCore.mutex};
 
-                        auto threadIterator{candidateCore.queue.cbegin()};
-                        if (threadIterator != candidateCore.queue.cend()) {
-                            const auto &runningThread{*threadIterator};
+                        if (auto runningThread{candidateCore.queue.Front()}) {
                             timeslice += [&]() {
                                 if (runningThread->averageTimeslice)
                                     return std::min(runningThread->averageTimeslice - (util::GetTimeTicks() - runningThread->timesliceStart), 1UL);
@@ -57,11 +212,9 @@ namespace skyline::kernel {
                                     return 1UL;
                             }();
 
-                            while (++threadIterator != candidateCore.queue.cend()) {
-                                const auto &residentThread{*threadIterator};
+                            for (auto residentThread{candidateCore.queue.Next(runningThread)}; residentThread; residentThread = candidateCore.queue.Next(residentThread))
                                 if (residentThread->priority <= thread->priority)
                                     timeslice += residentThread->averageTimeslice ? residentThread->averageTimeslice : 1UL;
-                            }
                         }
                     }
 
@@ -85,8 +238,8 @@ namespace skyline::kernel {
         return *currentCore;
     }
 
-    void Scheduler::YieldThread(const std::shared_ptr<type::KThread> &thread) {
-        if (state.thread != thread) {
+    void Scheduler::YieldThread(type::KThread *thread) {
+        if (state.thread.get() != thread) {
             // If another thread is being yielded, we need to send it an OS signal to yield
             if (!thread->pendingYield) {
                 // We only want to yield the thread if it hasn't already been sent a signal to yield in the past
@@ -101,6 +254,13 @@ namespace skyline::kernel {
         }
     }
 
+    void Scheduler::DisplaceThread(CoreContext &core, type::KThread *thread) {
+        // The displaced thread is expected to call Rotate on yielding, it won't be at the front of the queue by then which would otherwise be erroneous
+        thread->forceYield = true;
+        core.queue.PushBack(thread, thread->priority);
+        YieldThread(thread);
+    }
+
     void Scheduler::InsertThread(const std::shared_ptr<type::KThread> &thread) {
         std::scoped_lock migrationLock{thread->coreMigrationMutex};
         auto &core{cores.at(thread->coreId)};
@@ -113,46 +273,41 @@ namespace skyline::kernel {
         }
 
         #ifndef NDEBUG
-        // Scan the queue for the same thread to prevent double insertion
-        for (auto &residentThread : core.queue) {
-            if (residentThread == thread) {
-                Logger::Error("T{} already exists in C{}", thread->id, core.id);
-                Logger::EmulationContext.Flush();
-            }
+        // Check if the thread is already queued to prevent double insertion
+        if (thread->isQueued) {
+            Logger::Error("T{} already exists in C{}", thread->id, core.id);
+            Logger::EmulationContext.Flush();
         }
         #endif
 
-        auto nextThread{std::upper_bound(core.queue.begin(), core.queue.end(), thread->priority.load(), type::KThread::IsHigherPriority)};
-        if (nextThread == core.queue.begin()) {
-            if (nextThread != core.queue.end()) {
+        i8 priority{thread->priority};
+        auto front{core.queue.Front()};
+        if (!front || priority < front->queuePriority) {
+            core.queue.PushFront(thread.get(), priority);
+            if (front) {
                 // If the inserted thread has a higher priority than the currently running thread (and the queue isn't empty)
                 // We can yield the thread which is currently scheduled on the core by sending it a signal
                 // It is optimized to avoid waiting for the thread to yield on receiving the signal which serializes the entire pipeline
-                auto front{core.queue.front()};
-                front->forceYield = true;
-                core.queue.splice(std::upper_bound(core.queue.begin(), core.queue.end(), front->priority.load(), type::KThread::IsHigherPriority), core.queue, core.queue.begin());
-                core.queue.push_front(thread);
-
-                YieldThread(front);
-            } else {
-                core.queue.push_front(thread);
+                core.queue.Remove(front);
+                DisplaceThread(core, front);
             }
+
             if (thread != state.thread)
                 thread->scheduleCondition.notify(); // We only want to trigger the conditional variable if the current thread isn't inserting itself
         } else {
-            core.queue.insert(nextThread, thread);
+            core.queue.PushBack(thread.get(), priority);
         }
     }
 
     void Scheduler::MigrateToCore(const std::shared_ptr<type::KThread> &thread, CoreContext *&currentCore, CoreContext *targetCore, std::unique_lock<SpinLock> &lock) {
         // We need to check if the thread was in its resident core's queue
         // If it was, we need to remove it from the queue
-        auto it{std::find(currentCore->queue.begin(), currentCore->queue.end(), thread)};
-        bool wasInserted{it != currentCore->queue.end()};
+        bool wasInserted{thread->isQueued};
         if (wasInserted) {
-            it = currentCore->queue.erase(it);
-            if (it == currentCore->queue.begin() && it != currentCore->queue.end())
-                (*it)->scheduleCondition.notify();
+            bool wasFront{currentCore->queue.Front() == thread.get()};
+            currentCore->queue.Remove(thread.get());
+            if (auto front{currentCore->queue.Front()}; wasFront && front)
+                front->scheduleCondition.notify();
         }
         lock.unlock();
 
@@ -165,6 +320,13 @@ namespace skyline::kernel {
         lock = std::unique_lock(targetCore->mutex);
     }
 
+    void Scheduler::PlaceThread(type::KThread &thread, const CoreContext &core) {
+        if (thread.placedCoreId != core.id) [[unlikely]] {
+            HostAffinity::PlaceCurrentThread(HostThreadRole::GuestCore, core.id);
+            thread.placedCoreId = core.id;
+        }
+    }
+
     void Scheduler::WaitSchedule(bool loadBalance) {
         auto &thread{state.thread};
         CoreContext *core{&cores.at(thread->coreId)};
@@ -178,7 +340,7 @@ namespace skyline::kernel {
                 if (!thread->affinityMask.test(thread->coreId)) // We need to retest in case the thread was migrated while the core was unlocked
                     MigrateToCore(thread, core, &cores.at(thread->idealCore), lock);
             }
-            return !core->queue.empty() && core->queue.front() == thread;
+            return core->queue.Front() == thread.get();
         }};
 
         TRACE_EVENT("scheduler", "WaitSchedule");
@@ -199,10 +361,13 @@ namespace skyline::kernel {
         }
 
         if (thread->priority == core->preemptionPriority)
-            // If the thread needs to be preempted then arm its preemption timer
-            thread->ArmPreemptionTimer(PreemptiveTimeslice);
+            // If the thread needs to be preempted then arm preemption for it on the core
+            ArmPreemption(*core, thread.get());
 
+        PlaceThread(*thread, *core);
         thread->timesliceStart = util::GetTimeTicks();
+        trace::AddFrameCounter(trace::FrameCounter::ContextSwitches);
+        PerfStats.contextSwitches.fetch_add(1, std::memory_order_relaxed);
     }
 
     bool Scheduler::TimedWaitSchedule(std::chrono::nanoseconds timeout) {
@@ -216,12 +381,15 @@ namespace skyline::kernel {
                 std::scoped_lock migrationLock{thread->coreMigrationMutex};
                 MigrateToCore(thread, core, &cores.at(thread->idealCore), lock);
             }
-            return !core->queue.empty() && core->queue.front() == thread;
+            return core->queue.Front() == thread.get();
         })) {
             if (thread->priority == core->preemptionPriority)
-                thread->ArmPreemptionTimer(PreemptiveTimeslice);
+                ArmPreemption(*core, thread.get());
 
+            PlaceThread(*thread, *core);
             thread->timesliceStart = util::GetTimeTicks();
+            trace::AddFrameCounter(trace::FrameCounter::ContextSwitches);
+            PerfStats.contextSwitches.fetch_add(1, std::memory_order_relaxed);
 
             return true;
         } else {
@@ -235,14 +403,15 @@ namespace skyline::kernel {
 
         std::unique_lock lock(core.mutex);
 
-        if (core.queue.front() == thread) {
+        if (core.queue.Front() == thread.get()) {
             // If this thread is at the front of the thread queue then we need to rotate the thread
             // In the case where this thread was forcefully yielded, we don't need to do this as it's done by the thread which yielded to this thread
-            // Splice the linked element from the beginning of the queue to where its priority is present
-            core.queue.splice(std::upper_bound(core.queue.begin(), core.queue.end(), thread->priority.load(), type::KThread::IsHigherPriority), core.queue, core.queue.begin());
+            // Move the thread from the front of the queue to behind all other threads of its priority
+            core.queue.Remove(thread.get());
+            core.queue.PushBack(thread.get(), thread->priority);
 
-            auto &front{core.queue.front()};
-            if (front != thread)
+            auto front{core.queue.Front()};
+            if (front != thread.get())
                 front->scheduleCondition.notify(); // If we aren't at the front of the queue, only then should we wake the thread at the front up
         } else if (!thread->forceYield) {
             throw exception("T{} called Rotate while not being in C{}'s queue", thread->id, thread->coreId);
@@ -250,7 +419,7 @@ namespace skyline::kernel {
 
         thread->averageTimeslice = (thread->averageTimeslice / 4) + (3 * (util::GetTimeTicks() - thread->timesliceStart / 4));
 
-        thread->DisarmPreemptionTimer(); // If a preemptive thread did a cooperative yield then we need to disarm the preemptive timer
+        DisarmPreemption(core, thread.get()); // If a preemptive thread did a cooperative yield then we need to disarm its preemption
         thread->pendingYield = false;
         thread->forceYield = false;
     }
@@ -262,16 +431,16 @@ namespace skyline::kernel {
             std::unique_lock lock(core.mutex);
 
             if (!thread->isPaused) {
-                auto it{std::find(core.queue.begin(), core.queue.end(), thread)};
-                if (it != core.queue.end()) {
-                    it = core.queue.erase(it);
-                    if (it == core.queue.begin()) {
+                if (thread->isQueued) {
+                    bool wasFront{core.queue.Front() == thread.get()};
+                    core.queue.Remove(thread.get());
+                    if (wasFront) {
                         // We need to update the averageTimeslice accordingly, if we've been unscheduled by this
                         if (thread->timesliceStart)
                             thread->averageTimeslice = (thread->averageTimeslice / 4) + (3 * (util::GetTimeTicks() - thread->timesliceStart / 4));
 
-                        if (it != core.queue.end())
-                            (*it)->scheduleCondition.notify(); // We need to wake the thread at the front of the queue, if we were at the front previously
+                        if (auto front{core.queue.Front()})
+                            front->scheduleCondition.notify(); // We need to wake the thread at the front of the queue, if we were at the front previously
                     }
                 } else {
                     Logger::Warn("T{} was not in C{}'s queue", thread->id, thread->coreId);
@@ -279,9 +448,10 @@ namespace skyline::kernel {
             } else {
                 thread->insertThreadOnResume = false;
             }
+
+            DisarmPreemption(core, thread.get());
         }
 
-        thread->DisarmPreemptionTimer();
         thread->pendingYield = false;
         thread->forceYield = false;
         YieldPending = false;
@@ -292,30 +462,39 @@ namespace skyline::kernel {
         auto *core{&cores.at(thread->coreId)};
         std::unique_lock coreLock(core->mutex);
 
-        auto currentIt{std::find(core->queue.begin(), core->queue.end(), thread)}, nextIt{std::next(currentIt)};
-        if (currentIt == core->queue.end()) {
+        if (!thread->isQueued)
             return;
-        } else if (currentIt == core->queue.begin()) {
+
+        i8 priority{thread->priority};
+        if (core->queue.Front() == thread.get()) {
             // Alternatively, if it's currently running then we'd just want to yield if there's a higher priority thread to run instead
-            if (nextIt != core->queue.end() && (*nextIt)->priority < thread->priority) {
-                YieldThread(thread);
-            } else if (!thread->isPreempted && thread->priority == core->preemptionPriority) {
-                // If the thread needs to be preempted due to its new priority then arm its preemption timer
-                thread->ArmPreemptionTimer(PreemptiveTimeslice);
+            core->queue.Remove(thread.get());
+            auto nextThread{core->queue.Front()};
+            if (nextThread && nextThread->queuePriority < priority) {
+                nextThread->scheduleCondition.notify();
+                DisplaceThread(*core, thread.get());
+                return;
+            }
+
+            core->queue.PushFront(thread.get(), priority);
+            if (!thread->isPreempted && thread->priority == core->preemptionPriority) {
+                // If the thread needs to be preempted due to its new priority then arm preemption for it
+                ArmPreemption(*core, thread.get());
             } else if (thread->isPreempted && thread->priority != core->preemptionPriority) {
-                // If the thread no longer needs to be preempted due to its new priority then disarm its preemption timer
-                thread->DisarmPreemptionTimer();
+                // If the thread no longer needs to be preempted due to its new priority then disarm its preemption
+                DisarmPreemption(*core, thread.get());
             }
-        } else if (thread->priority < (*std::prev(currentIt))->priority || (nextIt != core->queue.end() && thread->priority > (*nextIt)->priority)) {
+        } else if (thread->queuePriority != priority) {
             // If the thread is in the queue and it's position is affected by the priority change then need to remove and re-insert the thread
-            core->queue.erase(currentIt);
-
-            auto targetIt{std::upper_bound(core->queue.begin(), core->queue.end(), thread->priority.load(), type::KThread::IsHigherPriority)};
-            if (targetIt == core->queue.begin() && targetIt != core->queue.end()) {
-                core->queue.insert(std::next(core->queue.begin()), thread);
-                YieldThread(core->queue.front());
-            } else {
-                core->queue.insert(targetIt, thread);
+            core->queue.Remove(thread.get());
+
+            auto front{core->queue.Front()};
+            core->queue.PushBack(thread.get(), priority);
+            if (front && priority < front->queuePriority) {
+                // The thread has a higher priority than the running thread now, it'll be at the front of the queue so the running thread needs to be yielded
+                core->queue.Remove(front);
+                DisplaceThread(*core, front);
+                thread->scheduleCondition.notify();
             }
         }
     }
@@ -323,7 +502,7 @@ namespace skyline::kernel {
     void Scheduler::UpdateCore(const std::shared_ptr<type::KThread> &thread) {
         auto *core{&cores.at(thread->coreId)};
         std::scoped_lock coreLock{core->mutex};
-        if (core->queue.front() == thread)
+        if (core->queue.Front() == thread.get())
             thread->SendSignal(YieldSignal);
         else
             thread->scheduleCondition.notify();
@@ -336,9 +515,11 @@ namespace skyline::kernel {
 
         auto originalCoreId{thread->coreId};
         thread->coreId = constant::ParkedCoreId;
-        for (auto &core : cores)
-            if (originalCoreId != core.id && thread->affinityMask.test(core.id) && (core.queue.empty() || core.queue.front()->priority > thread->priority))
+        for (auto &core : cores) {
+            auto front{core.queue.Front()};
+            if (originalCoreId != core.id && thread->affinityMask.test(core.id) && (!front || front->priority > thread->priority))
                 thread->coreId = core.id;
+        }
 
         if (thread->coreId == constant::ParkedCoreId) {
             std::unique_lock lock(parkedMutex);
@@ -355,8 +536,9 @@ namespace skyline::kernel {
             auto &thread{state.thread};
             auto &core{cores.at(thread->coreId)};
             std::unique_lock coreLock(core.mutex);
-            auto nextThread{core.queue.size() > 1 ? *std::next(core.queue.begin()) : nullptr};
-            nextThread = nextThread->priority == thread->priority ? nextThread : nullptr; // If the next thread doesn't have the same priority then it won't be scheduled next
+            auto front{core.queue.Front()};
+            auto nextThread{front ? core.queue.Next(front) : nullptr};
+            nextThread = (nextThread && nextThread->priority == thread->priority) ? nextThread : nullptr; // If the next thread doesn't have the same priority then it won't be scheduled next
             auto parkedThread{parkedQueue.front()};
 
             // We need to be conservative about waking up a parked thread, it should only be done if its priority is higher than the current thread
@@ -375,17 +557,17 @@ namespace skyline::kernel {
 
         thread->isPaused = true;
 
-        auto it{std::find(core->queue.begin(), core->queue.end(), thread)};
-        if (it != core->queue.end()) {
+        if (thread->isQueued) {
             thread->insertThreadOnResume = true; // If we're handling removing the thread then we need to be responsible for inserting it back inside ResumeThread
 
-            it = core->queue.erase(it);
-            if (it == core->queue.begin() && it != core->queue.end())
-                (*it)->scheduleCondition.notify();
+            bool wasFront{core->queue.Front() == thread.get()};
+            core->queue.Remove(thread.get());
+            if (auto front{core->queue.Front()}; wasFront && front)
+                front->scheduleCondition.notify();
 
-            if (it == core->queue.begin()) {
+            if (wasFront) {
                 // We need to send a yield signal to the thread if it's currently running
-                YieldThread(thread);
+                YieldThread(thread.get());
                 thread->forceYield = true;
             }
         } else {
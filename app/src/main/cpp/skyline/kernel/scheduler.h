@@ -36,6 +36,57 @@ namespace skyline {
             }
         };
 
+        /**
+         * @brief An intrusive queue of threads ordered by priority with threads of the same priority being in FIFO order, a bitmap of non-empty priority levels is used to find the highest priority thread in constant time
+         * @note This is analogous to KPriorityQueue on HOS, the links are stored inside KThread so operations on the queue never allocate or modify reference counts
+         * @note The queue doesn't synchronize accesses by itself, the owning core's mutex must be held for all operations
+         */
+        class ThreadQueue {
+          public:
+            static constexpr u8 PriorityCount{64}; //!< The amount of priority levels that threads can be queued at
+
+          private:
+            struct Level {
+                type::KThread *head{};
+                type::KThread *tail{};
+            };
+
+            std::array<Level, PriorityCount> levels{};
+            u64 levelMask{}; //!< A bitmask with each bit corresponding to if the priority level with the same index is non-empty
+
+          public:
+            bool Empty() const {
+                return !levelMask;
+            }
+
+            /**
+             * @return The highest priority thread in the queue or nullptr if the queue is empty
+             */
+            type::KThread *Front() const {
+                return levelMask ? levels[std::countr_zero(levelMask)].head : nullptr;
+            }
+
+            /**
+             * @return The thread following the supplied thread in the queue or nullptr if it's the last thread in the queue
+             */
+            type::KThread *Next(const type::KThread *thread) const;
+
+            /**
+             * @brief Inserts the thread behind all other threads of the same priority
+             */
+            void PushBack(type::KThread *thread, i8 priority);
+
+            /**
+             * @brief Inserts the thread ahead of all other threads of the same priority
+             */
+            void PushFront(type::KThread *thread, i8 priority);
+
+            /**
+             * @brief Removes the thread from the queue, it must be in the queue prior to calling this
+             */
+            void Remove(type::KThread *thread);
+        };
+
         /**
          * @brief The Scheduler is responsible for determining which threads should run on which virtual cores and when they should be scheduled
          * @note We tend to stray a lot from HOS in our scheduler design as we've designed it around our 1 host thread per guest thread which leads to scheduling from the perspective of threads while the HOS scheduler deals with scheduling from the perspective of cores, not doing this would lead to missing out on key optimizations and serialization of scheduling
@@ -48,7 +99,9 @@ namespace skyline {
                 u8 id;
                 i8 preemptionPriority; //!< The priority at which this core becomes preemptive as opposed to cooperative
                 SpinLock mutex; //!< Synchronizes all operations on the queue
-                std::list<std::shared_ptr<type::KThread>> queue; //!< A queue of threads which are running or to be run on this core
+                ThreadQueue queue; //!< A queue of threads which are running or to be run on this core, the thread at the front is the one currently running
+                std::atomic<i64> preemptionDeadline{}; //!< A timestamp in nanoseconds of when the preemptive thread running on this core should be rotated, this is 0 when preemption isn't armed and is only written to while holding the core's mutex
+                type::KThread *preemptiveThread{}; //!< The thread which preemption is armed for on this core, this is protected by the core's mutex
 
                 CoreContext(u8 id, i8 preemptionPriority);
             };
@@ -58,6 +111,24 @@ namespace skyline {
             std::mutex parkedMutex; //!< Synchronizes all operations on the queue of parked threads
             std::list<std::shared_ptr<type::KThread>> parkedQueue; //!< A queue of threads which are parked and waiting on core migration
 
+            std::mutex preemptionMutex; //!< Synchronizes waiting on the preemption condition
+            std::condition_variable preemptionCondition; //!< Signalled to wake the preemption ticker when it's idle and preemption has been armed on a core or when the scheduler is being destroyed
+            std::atomic<bool> preemptionIdle{}; //!< If the preemption ticker is waiting without a deadline as no core has preemption armed
+            bool preemptionExit{}; //!< If the preemption ticker should exit, this is protected by `preemptionMutex`
+            std::thread preemptionTicker; //!< A host thread that ticks for all cores and signals preemptive threads once their timeslice has expired
+
+            /**
+             * @brief The entry point for the preemption ticker thread
+             * @note All deadlines are armed with the same timeslice so they expire in the order they were armed, this makes a single deadline slot per core act as a timer wheel which only needs to be polled at the earliest deadline
+             */
+            void PreemptionTicker();
+
+            /**
+             * @brief Rotates the preemptive thread on the supplied core if its deadline has expired and there's another thread of the same priority to run, if there isn't then the deadline is extended by a timeslice
+             * @note The core's mutex must not be held by the calling thread
+             */
+            void TickPreemption(CoreContext &core, i64 now);
+
             /**
              * @brief Migrate a thread from its resident core to the target core
              * @note 'KThread::coreMigrationMutex' **must** be locked by the calling thread prior to calling this
@@ -68,7 +139,31 @@ namespace skyline {
             /**
              * @brief Trigger a thread to yield via a signal or on SVC exit if it is the current thread
              */
-            void YieldThread(const std::shared_ptr<type::KThread> &thread);
+            void YieldThread(type::KThread *thread);
+
+            /**
+             * @brief Sets the host affinity of the calling thread for the core it has been scheduled on if it was last placed on a different core
+             */
+            static void PlaceThread(type::KThread &thread, const CoreContext &core);
+
+            /**
+             * @brief Moves the thread that was displaced from the front of the core's queue behind other threads of its priority and forcefully yields it
+             * @note The core's mutex must be locked and the thread must have been removed from the queue by the calling thread prior to calling this
+             */
+            void DisplaceThread(CoreContext &core, type::KThread *thread);
+
+            /**
+             * @brief Arms preemption for the supplied thread on the core it's running on, it'll be signalled after a timeslice if there's another thread of the same priority to run
+             * @note The core's mutex must be locked by the calling thread prior to calling this
+             * @note This doesn't make any syscalls unless the preemption ticker is idle and needs to be woken up
+             */
+            void ArmPreemption(CoreContext &core, type::KThread *thread);
+
+            /**
+             * @brief Disarms preemption for the supplied thread if it was armed on the core, any pending preemption will be cancelled
+             * @note The core's mutex must be locked by the calling thread prior to calling this
+             */
+            static void DisarmPreemption(CoreContext &core, type::KThread *thread);
 
           public:
             static constexpr std::chrono::milliseconds PreemptiveTimeslice{10}; //!< The duration of time a preemptive thread can run before yielding
@@ -78,6 +173,8 @@ namespace skyline {
 
             Scheduler(const DeviceState &state);
 
+            ~Scheduler();
+
             /**
              * @brief A signal handler designed to cause a non-cooperative yield for preemption and higher priority threads being inserted
              */
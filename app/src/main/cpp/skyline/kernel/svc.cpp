@@ -358,7 +358,7 @@ namespace skyline::kernel::svc {
     void GetThreadPriority(const DeviceState &state) {
         KHandle handle{state.ctx->gpr.w1};
         try {
-            auto thread{state.process->GetHandle<type::KThread>(handle)};
+            auto thread{state.process->BorrowHandle<type::KThread>(handle)};
             i8 priority{thread->priority};
             Logger::Debug("Retrieving thread #{}'s priority: {}", thread->id, priority);
 
@@ -485,7 +485,7 @@ namespace skyline::kernel::svc {
         KHandle handle{state.ctx->gpr.w0};
         TRACE_EVENT_FMT("kernel", "ClearEvent 0x{:X}", handle);
         try {
-            std::static_pointer_cast<type::KEvent>(state.process->GetHandle(handle))->ResetSignal();
+            static_cast<type::KEvent &>(*state.process->BorrowHandle(handle)).ResetSignal();
             Logger::Debug("Clearing 0x{:X}", handle);
             state.ctx->gpr.w0 = Result{};
         } catch (const std::out_of_range &) {
@@ -632,11 +632,11 @@ namespace skyline::kernel::svc {
         KHandle handle{state.ctx->gpr.w0};
         TRACE_EVENT_FMT("kernel", "ResetSignal 0x{:X}", handle);
         try {
-            auto object{state.process->GetHandle(handle)};
+            auto object{state.process->BorrowHandle(handle)};
             switch (object->objectType) {
                 case type::KType::KEvent:
                 case type::KType::KProcess:
-                    state.ctx->gpr.w0 = std::static_pointer_cast<type::KSyncObject>(object)->ResetSignal() ? Result{} : result::InvalidState;
+                    state.ctx->gpr.w0 = static_cast<type::KSyncObject &>(*object).ResetSignal() ? Result{} : result::InvalidState;
                     break;
 
                 default: {
@@ -656,17 +656,14 @@ namespace skyline::kernel::svc {
     }
 
     void WaitSynchronization(const DeviceState &state) {
-        constexpr u8 MaxSyncHandles{0x40}; // The total amount of handles that can be passed to WaitSynchronization
-
         u32 numHandles{state.ctx->gpr.w2};
-        if (numHandles > MaxSyncHandles) {
+        if (numHandles > constant::MaxSyncHandles) {
             state.ctx->gpr.w0 = result::OutOfRange;
             return;
         }
 
         span waitHandles(reinterpret_cast<KHandle *>(state.ctx->gpr.x1), numHandles);
-        std::vector<std::shared_ptr<type::KSyncObject>> objectTable;
-        objectTable.reserve(numHandles);
+        boost::container::small_vector<std::shared_ptr<type::KSyncObject>, constant::MaxSyncHandles> objectTable;
 
         for (const auto &handle : waitHandles) {
             auto object{state.process->GetHandle(handle)};
@@ -698,11 +695,15 @@ namespace skyline::kernel::svc {
 
         TRACE_EVENT_FMT("kernel", waitHandles.size() == 1 ? "WaitSynchronization 0x{:X}" : "WaitSynchronizationMultiple 0x{:X}", waitHandles[0]);
 
-        std::unique_lock lock(type::KSyncObject::syncObjectMutex);
-        if (state.thread->cancelSync) {
-            state.thread->cancelSync = false;
-            state.ctx->gpr.w0 = result::Cancelled;
-            return;
+        type::SyncObjectsLock syncObjectsLock{span{objectTable.data(), objectTable.size()}};
+        std::unique_lock lock{syncObjectsLock};
+        {
+            std::scoped_lock waitLock{state.thread->syncWaitMutex};
+            if (state.thread->cancelSync) {
+                state.thread->cancelSync = false;
+                state.ctx->gpr.w0 = result::Cancelled;
+                return;
+            }
         }
 
         u32 index{};
@@ -722,13 +723,26 @@ namespace skyline::kernel::svc {
             return;
         }
 
-        auto priority{state.thread->priority.load()};
-        for (const auto &object : objectTable)
-            object->syncObjectWaiters.insert(std::upper_bound(object->syncObjectWaiters.begin(), object->syncObjectWaiters.end(), priority, type::KThread::IsHigherPriority), state.thread);
+        {
+            // The objects' mutexes don't exclude cancellation so it needs to be checked again atomically with becoming cancellable
+            std::scoped_lock waitLock{state.thread->syncWaitMutex};
+            if (state.thread->cancelSync) {
+                state.thread->cancelSync = false;
+                state.ctx->gpr.w0 = result::Cancelled;
+                return;
+            }
 
-        state.thread->isCancellable = true;
-        state.thread->wakeObject = nullptr;
-        state.scheduler->RemoveThread();
+            state.thread->isCancellable = true;
+            state.thread->wakeObject = nullptr;
+            state.scheduler->RemoveThread();
+        }
+
+        auto priority{state.thread->priority.load()};
+        for (size_t i{}; i < objectTable.size(); i++) {
+            auto &node{state.thread->syncWaiterNodes[i]};
+            node.thread = state.thread.get();
+            objectTable[i]->InsertWaiter(node, priority);
+        }
 
         lock.unlock();
         if (timeout > 0)
@@ -737,8 +751,16 @@ namespace skyline::kernel::svc {
             state.scheduler->WaitSchedule(false);
         lock.lock();
 
-        state.thread->isCancellable = false;
-        auto wakeObject{state.thread->wakeObject};
+        type::KSyncObject *wakeObject;
+        bool cancelled;
+        {
+            std::scoped_lock waitLock{state.thread->syncWaitMutex};
+            state.thread->isCancellable = false;
+            wakeObject = state.thread->wakeObject;
+            cancelled = !wakeObject && state.thread->cancelSync;
+            if (cancelled)
+                state.thread->cancelSync = false;
+        }
 
         u32 wakeIndex{};
         index = 0;
@@ -746,11 +768,7 @@ namespace skyline::kernel::svc {
             if (object.get() == wakeObject)
                 wakeIndex = index;
 
-            auto it{std::find(object->syncObjectWaiters.begin(), object->syncObjectWaiters.end(), state.thread)};
-            if (it != object->syncObjectWaiters.end())
-                object->syncObjectWaiters.erase(it);
-            else
-                throw exception("svcWaitSynchronization: An object (0x{:X}) has been removed from the syncObjectWaiters queue incorrectly", waitHandles[index]);
+            object->RemoveWaiter(state.thread->syncWaiterNodes[index]);
 
             index++;
         }
@@ -759,8 +777,7 @@ namespace skyline::kernel::svc {
             Logger::Debug("Signalled 0x{:X}", waitHandles[wakeIndex]);
             state.ctx->gpr.w0 = Result{};
             state.ctx->gpr.w1 = wakeIndex;
-        } else if (state.thread->cancelSync) {
-            state.thread->cancelSync = false;
+        } else if (cancelled) {
             Logger::Debug("Wait has been cancelled");
             state.ctx->gpr.w0 = result::Cancelled;
         } else {
@@ -774,8 +791,8 @@ namespace skyline::kernel::svc {
 
     void CancelSynchronization(const DeviceState &state) {
         try {
-            std::unique_lock lock(type::KSyncObject::syncObjectMutex);
             auto thread{state.process->GetHandle<type::KThread>(state.ctx->gpr.w0)};
+            std::scoped_lock lock{thread->syncWaitMutex};
             Logger::Debug("Cancelling Synchronization {}", thread->id);
             thread->cancelSync = true;
             if (thread->isCancellable) {
@@ -891,6 +908,7 @@ namespace skyline::kernel::svc {
     }
 
     void SendSyncRequest(const DeviceState &state) {
+        // The calling thread releases its core for the duration of the request, blocking service calls such as filesystem reads from slow storage can't stall other guest threads on the core
         SchedulerScopedLock schedulerLock(state);
         state.os->serviceManager.SyncRequestHandler(static_cast<KHandle>(state.ctx->gpr.x0));
         state.ctx->gpr.w0 = Result{};
@@ -898,7 +916,7 @@ namespace skyline::kernel::svc {
 
     void GetThreadId(const DeviceState &state) {
         KHandle handle{state.ctx->gpr.w1};
-        size_t tid{state.process->GetHandle<type::KThread>(handle)->id};
+        size_t tid{state.process->BorrowHandle<type::KThread>(handle)->id};
 
         Logger::Debug("0x{:X} -> #{}", handle, tid);
 
@@ -0,0 +1,67 @@
+// SPDX-License-Identifier: MPL-2.0
+// Copyright © 2023 Skyline Team and Contributors (https://github.com/skyline-emu/)
+
+#include <kernel/types/KThread.h>
+#include "thread_pool.h"
+
+namespace skyline::kernel {
+    HostThreadPool::HostThreadPool() {
+        std::scoped_lock lock{mutex};
+        hostThreads.reserve(PrespawnCount);
+        for (size_t i{}; i < PrespawnCount; i++)
+            SpawnHostThread();
+    }
+
+    HostThreadPool::~HostThreadPool() {
+        {
+            std::scoped_lock lock{mutex};
+            exiting = true;
+            condition.notify_all();
+        }
+
+        for (auto &hostThread : hostThreads)
+            if (hostThread.joinable())
+                hostThread.join();
+    }
+
+    void HostThreadPool::SpawnHostThread() {
+        parkedCount++; // The thread is counted as parked prior to it starting so that concurrent calls to Run don't spawn redundant threads
+        hostThreads.emplace_back(&HostThreadPool::HostThread, this);
+    }
+
+    void HostThreadPool::HostThread() {
+        if (int result{pthread_setname_np(pthread_self(), "Sky-GuestPool")})
+            Logger::Warn("Failed to set the thread name: {}", strerror(result));
+
+        std::unique_lock lock{mutex};
+        while (true) {
+            condition.wait(lock, [this]() { return !pendingThreads.empty() || exiting; });
+            if (pendingThreads.empty())
+                return;
+
+            auto thread{std::move(pendingThreads.front())};
+            pendingThreads.pop_front();
+            parkedCount--;
+            lock.unlock();
+
+            thread->StartThread();
+
+            // Any per-thread state must be reset as it'd otherwise be observed by the next guest thread run on this host thread and keep the prior one alive
+            thread.reset();
+            DeviceState::thread = nullptr;
+            DeviceState::ctx = nullptr;
+            Scheduler::YieldPending = false;
+
+            lock.lock();
+            parkedCount++;
+        }
+    }
+
+    void HostThreadPool::Run(std::shared_ptr<type::KThread> thread) {
+        std::scoped_lock lock{mutex};
+        if (parkedCount <= pendingThreads.size())
+            SpawnHostThread();
+        pendingThreads.push_back(std::move(thread));
+        condition.notify_one();
+    }
+}
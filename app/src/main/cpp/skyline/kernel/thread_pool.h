@@ -0,0 +1,45 @@
+// SPDX-License-Identifier: MPL-2.0
+// Copyright © 2023 Skyline Team and Contributors (https://github.com/skyline-emu/)
+
+#pragma once
+
+#include <deque>
+#include <common.h>
+
+namespace skyline::kernel {
+    /**
+     * @brief A pool of parked host threads that guest threads are started on, this reduces the cost of starting a guest thread to waking a host thread rather than creating one
+     * @note Host threads are returned to the pool once the guest thread running on them exits, the pool only grows when more guest threads are running concurrently than there are host threads
+     */
+    class HostThreadPool {
+      private:
+        static constexpr size_t PrespawnCount{8}; //!< The amount of host threads that are created alongside the pool, this covers the worker threads that most titles create at boot
+
+        std::mutex mutex; //!< Synchronizes all state below
+        std::condition_variable condition; //!< Signalled when a guest thread is queued or the pool is being destroyed
+        std::vector<std::thread> hostThreads;
+        std::deque<std::shared_ptr<type::KThread>> pendingThreads; //!< Guest threads which are waiting on a parked host thread to adopt them
+        size_t parkedCount{}; //!< The amount of host threads which are parked and haven't been assigned a guest thread
+        bool exiting{}; //!< If the pool is being destroyed and all parked host threads should exit
+
+        void HostThread();
+
+        /**
+         * @note The mutex must be locked when calling this
+         */
+        void SpawnHostThread();
+
+      public:
+        HostThreadPool();
+
+        /**
+         * @note All guest threads must have exited prior to destroying the pool as this joins all host threads
+         */
+        ~HostThreadPool();
+
+        /**
+         * @brief Runs the supplied guest thread on a parked host thread, a new host thread is created if none are available
+         */
+        void Run(std::shared_ptr<type::KThread> thread);
+    };
+}
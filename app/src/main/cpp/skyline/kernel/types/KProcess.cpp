@@ -1,23 +1,23 @@
 // SPDX-License-Identifier: MPL-2.0
 // Copyright © 2020 Skyline Team and Contributors (https://github.com/skyline-emu/)
 
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#include <boost/container/small_vector.hpp>
 #include <nce.h>
 #include <os.h>
 #include <common/trace.h>
 #include <kernel/results.h>
+#include <kernel/memory_snapshot.h>
 #include "KProcess.h"
 
 namespace skyline::kernel::type {
-    KProcess::TlsPage::TlsPage(u8 *memory) : memory(memory) {}
-
-    u8 *KProcess::TlsPage::ReserveSlot() {
-        if (index == constant::TlsSlots)
-            return nullptr;
-        return memory + (constant::TlsSlotSize * index++);
+    KProcess::KProcess(const DeviceState &state) : memory(state), KSyncObject(state, KType::KProcess) {
+        freeHandleIndices.reserve(constant::MaxHandleCount);
+        for (size_t index{constant::MaxHandleCount}; index > 0; index--)
+            freeHandleIndices.push_back(static_cast<u16>(index - 1)); // The free list is used as a stack, lower indices are allocated first
     }
 
-    KProcess::KProcess(const DeviceState &state) : memory(state), KSyncObject(state, KType::KProcess) {}
-
     KProcess::~KProcess() {
         std::scoped_lock guard{threadMutex};
         disableThreadCreation = true;
@@ -51,18 +51,17 @@ namespace skyline::kernel::type {
         constexpr size_t DefaultHeapSize{0x200000};
         memory.MapHeapMemory(span<u8>{state.process->memory.heap.data(), DefaultHeapSize});
         memory.processHeapSize = DefaultHeapSize;
+
+        {
+            std::scoped_lock lock{tlsMutex};
+            freeTlsSlots.reserve(constant::TlsPreallocatedPages * constant::TlsSlots);
+            for (size_t i{}; i < constant::TlsPreallocatedPages; i++)
+                MapTlsPage();
+        }
         tlsExceptionContext = AllocateTlsSlot();
     }
 
-    u8 *KProcess::AllocateTlsSlot() {
-        std::scoped_lock lock{tlsMutex};
-        u8 *slot;
-        for (auto &tlsPage : tlsPages)
-            if ((slot = tlsPage->ReserveSlot()))
-                return slot;
-
-        bool isAllocated{};
-
+    void KProcess::MapTlsPage() {
         u8 *pageCandidate{state.process->memory.tlsIo.data()};
         std::pair<u8 *, ChunkDescriptor> chunk;
         while (state.process->memory.tlsIo.contains(span<u8>(pageCandidate, constant::PageSize))) {
@@ -70,19 +69,50 @@ namespace skyline::kernel::type {
 
             if (chunk.second.state == memory::states::Unmapped) {
                 memory.MapThreadLocalMemory(span<u8>{pageCandidate, constant::PageSize});
-                isAllocated = true;
-                break;
+
+                // Slots are inserted at the bottom of the stack in descending order so that freed slots are reused first and new slots are allocated upwards
+                freeTlsSlots.insert(freeTlsSlots.begin(), constant::TlsSlots, nullptr);
+                for (size_t slot{}; slot < constant::TlsSlots; slot++)
+                    freeTlsSlots[slot] = pageCandidate + (constant::TlsSlotSize * (constant::TlsSlots - slot - 1));
+                return;
             } else {
                 pageCandidate = chunk.first + chunk.second.size;
             }
         }
 
-        if (!isAllocated) [[unlikely]]
-            throw exception("Failed to find free memory for a tls slot!");
+        throw exception("Failed to find free memory for a tls slot!");
+    }
+
+    u8 *KProcess::AllocateTlsSlot() {
+        std::scoped_lock lock{tlsMutex};
+        if (freeTlsSlots.empty()) [[unlikely]]
+            MapTlsPage();
 
-        auto tlsPage{std::make_shared<TlsPage>(pageCandidate)};
-        tlsPages.push_back(tlsPage);
-        return tlsPage->ReserveSlot();
+        auto slot{freeTlsSlots.back()};
+        freeTlsSlots.pop_back();
+        return slot;
+    }
+
+    void KProcess::FreeTlsSlot(u8 *slot) {
+        std::memset(slot, 0, constant::TlsSlotSize); // Newly allocated slots are expected to be zeroed like those of a freshly mapped page
+
+        std::scoped_lock lock{tlsMutex};
+        freeTlsSlots.push_back(slot);
+    }
+
+    bool KProcess::SaveMemorySnapshot(const std::string &path) {
+        std::scoped_lock lock{snapshotMutex};
+        if (memorySnapshot && !memorySnapshot->IsComplete())
+            return false;
+
+        memorySnapshot.reset(); // The prior snapshot's traps must be removed before any new ones are created on the same memory
+        try {
+            memorySnapshot = std::make_unique<MemorySnapshot>(state, path);
+        } catch (const exception &e) {
+            Logger::Warn("Failed to take a memory snapshot: {}", e.what());
+            return false;
+        }
+        return true;
     }
 
     std::shared_ptr<KThread> KProcess::CreateThread(void *entry, u64 argument, void *stackTop, std::optional<i8> priority, std::optional<u8> idealCore) {
@@ -118,13 +148,113 @@ namespace skyline::kernel::type {
         return thread;
     }
 
+    KHandle KProcess::ReserveHandleLocked(u16 &index) {
+        if (freeHandleIndices.empty())
+            throw exception("The process handle table is full");
+
+        index = freeHandleIndices.back();
+        freeHandleIndices.pop_back();
+
+        u16 linearId{nextHandleLinearId};
+        nextHandleLinearId = (nextHandleLinearId == 0x7FFF) ? 1 : nextHandleLinearId + 1; // A linear ID of 0 is never used so a handle can't be 0
+        return MakeHandle(index, linearId);
+    }
+
+    void KProcess::PublishHandleLocked(u16 index, KHandle handle, std::shared_ptr<KObject> object) {
+        auto &entry{handleTable[index]};
+        entry.object = std::move(object);
+        entry.handle.store(handle, std::memory_order_release);
+    }
+
+    KProcess::HandleEntry &KProcess::BorrowEntry(KHandle handle, std::atomic<KHandle> &borrowSlot) {
+        u16 index{GetHandleIndex(handle)};
+        if (!handle || index >= constant::MaxHandleCount)
+            throw std::out_of_range(fmt::format("GetHandle was called with an invalid handle: 0x{:X}", handle));
+
+        // The borrow and the handle of the entry are sequentially consistent so either a concurrent close observes the borrow or this observes the entry being closed
+        auto &entry{handleTable[index]};
+        borrowSlot.store(handle, std::memory_order_seq_cst);
+        if (entry.handle.load(std::memory_order_seq_cst) != handle) {
+            borrowSlot.store(0, std::memory_order_release);
+            throw std::out_of_range(fmt::format("GetHandle was called with an invalid handle: 0x{:X}", handle));
+        }
+        return entry;
+    }
+
+    void KProcess::CloseHandle(KHandle handle) {
+        {
+            std::scoped_lock lock{handleMutex};
+            u16 index{GetHandleIndex(handle)};
+            if (!handle || index >= constant::MaxHandleCount || handleTable[index].handle.load(std::memory_order_relaxed) != handle)
+                throw std::out_of_range(fmt::format("CloseHandle was called with an invalid handle: 0x{:X}", handle));
+
+            handleTable[index].handle.store(0, std::memory_order_seq_cst);
+            retiredHandles.push_back(RetiredHandle{index, handle});
+        }
+
+        ReclaimHandles();
+    }
+
+    void KProcess::ReclaimHandles() {
+        boost::container::small_vector<KHandle, 16> borrowedHandles;
+        {
+            std::scoped_lock lock{threadMutex};
+            for (const auto &thread : threads)
+                if (KHandle borrowedHandle{thread->borrowedHandle.load(std::memory_order_seq_cst)})
+                    borrowedHandles.push_back(borrowedHandle);
+        }
+
+        boost::container::small_vector<std::shared_ptr<KObject>, 4> releasedObjects; // Objects are only released after unlocking as their destructors may access the handle table
+        std::scoped_lock lock{handleMutex};
+        std::erase_if(retiredHandles, [&](const RetiredHandle &retired) {
+            if (std::find(borrowedHandles.begin(), borrowedHandles.end(), retired.handle) != borrowedHandles.end())
+                return false;
+
+            releasedObjects.push_back(std::move(handleTable[retired.index].object));
+            freeHandleIndices.push_back(retired.index);
+            return true;
+        });
+    }
+
     void KProcess::ClearHandleTable() {
-        std::shared_lock lock(handleMutex);
-        handles.clear();
+        std::vector<std::shared_ptr<KObject>> releasedObjects;
+        std::scoped_lock lock{handleMutex};
+        for (auto &entry : handleTable) {
+            entry.handle.store(0, std::memory_order_relaxed);
+            if (entry.object)
+                releasedObjects.push_back(std::move(entry.object));
+        }
+
+        retiredHandles.clear();
+        freeHandleIndices.clear();
+        for (size_t index{constant::MaxHandleCount}; index > 0; index--)
+            freeHandleIndices.push_back(static_cast<u16>(index - 1));
     }
 
     constexpr u32 HandleWaitersBit{1UL << 30}; //!< A bit which denotes if a mutex psuedo-handle has waiters or not
 
+    bool KProcess::MutexWaitHandoff(u32 *mutex, u32 value) {
+        TRACE_EVENT_FMT("kernel", "MutexWaitHandoff 0x{:X}", mutex);
+
+        state.scheduler->RemoveThread();
+
+        // The waiter count is incremented prior to the futex checking the mutex value, an unlock will either observe the count or the futex will observe the updated value
+        mutexHandoffWaiters.fetch_add(1, std::memory_order_seq_cst);
+        timespec timeout{.tv_nsec = std::chrono::duration_cast<std::chrono::nanoseconds>(MutexHandoffTimeout).count()};
+        bool timedOut{syscall(SYS_futex, mutex, FUTEX_WAIT_PRIVATE, value, &timeout, nullptr, 0) == -1 && errno == ETIMEDOUT};
+        mutexHandoffWaiters.fetch_sub(1, std::memory_order_seq_cst);
+
+        state.scheduler->InsertThread(state.thread);
+        state.scheduler->WaitSchedule();
+
+        return !timedOut;
+    }
+
+    void KProcess::MutexWakeHandoff(u32 *mutex) {
+        if (mutexHandoffWaiters.load(std::memory_order_seq_cst)) [[unlikely]]
+            syscall(SYS_futex, mutex, FUTEX_WAKE_PRIVATE, std::numeric_limits<int>::max(), nullptr, nullptr, 0);
+    }
+
     Result KProcess::MutexLock(const std::shared_ptr<KThread> &thread, u32 *mutex, KHandle ownerHandle, KHandle tag, bool failOnOutdated) {
         TRACE_EVENT_FMT("kernel", "MutexLock 0x{:X} @ 0x{:X}", mutex, thread->id);
 
@@ -138,6 +268,11 @@ namespace skyline::kernel::type {
             return result::InvalidHandle;
         }
 
+        // If the calling thread doesn't have a higher priority than the owner then there's no priority to inherit, it can wait for the mutex to be unlocked without being queued on the owner
+        // The wait returns without the mutex being locked, the guest will retry locking it with the updated mutex value in the same way as if the owner was outdated
+        if (thread == state.thread && thread->priority >= owner->priority && MutexWaitHandoff(mutex, ownerHandle | HandleWaitersBit))
+            return failOnOutdated ? result::InvalidCurrentMemory : Result{};
+
         bool isHighestPriority;
         {
             std::scoped_lock lock{owner->waiterMutex, thread->waiterMutex}; // We need to lock both mutexes at the same time as we mutate the owner and the current thread, the ordering of locks **must** match MutexUnlock to avoid deadlocks
@@ -222,10 +357,13 @@ namespace skyline::kernel::type {
                 __atomic_store_n(mutex, nextOwner->waitTag, __ATOMIC_SEQ_CST);
             }
 
+            MutexWakeHandoff(mutex);
+
             // Finally, schedule the next owner accordingly
             state.scheduler->InsertThread(nextOwner);
         } else {
             __atomic_store_n(mutex, 0, __ATOMIC_SEQ_CST);
+            MutexWakeHandoff(mutex);
         }
     }
 
@@ -335,6 +473,10 @@ namespace skyline::kernel::type {
     void KProcess::ConditionVariableSignal(u32 *key, i32 amount) {
         TRACE_EVENT_FMT("kernel", "ConditionVariableSignal 0x{:X}", key);
 
+        // The flag denoting waiters is only written while holding the waiter mutex, if it isn't set then there are no waiters to signal and the lock can be avoided entirely
+        if (!__atomic_load_n(key, __ATOMIC_SEQ_CST))
+            return;
+
         i32 waiterCount{amount};
         while (amount <= 0 || waiterCount) {
             std::shared_ptr<type::KThread> thread;
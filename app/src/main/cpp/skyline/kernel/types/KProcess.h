@@ -13,7 +13,12 @@ namespace skyline {
     namespace constant {
         constexpr u16 TlsSlotSize{0x200}; //!< The size of a single TLS slot
         constexpr u8 TlsSlots{constant::PageSize / TlsSlotSize}; //!< The amount of TLS slots in a single page
-        constexpr KHandle BaseHandleIndex{0xD000}; //!< The index of the base handle
+        constexpr size_t TlsPreallocatedPages{16}; //!< The amount of TLS pages mapped at process creation, this covers the threads of most titles so thread creation doesn't need to map any
+        constexpr size_t MaxHandleCount{1024}; //!< The capacity of the process handle table, this matches the largest handle table HOS supports
+    }
+
+    namespace kernel {
+        class MemorySnapshot;
     }
 
     namespace kernel::type {
@@ -34,34 +39,144 @@ namespace skyline {
             std::mutex syncWaiterMutex; //!< Synchronizes all mutations to the map to prevent races
             SyncWaiters syncWaiters; //!< All threads waiting on process-wide synchronization primitives (Atomic keys + Address Arbiter)
 
+            static constexpr std::chrono::microseconds MutexHandoffTimeout{500}; //!< The maximum duration a thread waits on a futex for a mutex to be handed off prior to falling back to the scheduler-based mutex arbitration
+            std::atomic<u32> mutexHandoffWaiters{}; //!< The amount of threads parked on a futex keyed by a mutex address, unlocks can skip waking the futex when this is zero
+
             /**
-            * @brief The status of a single TLS page (A page is 4096 bytes on ARMv8)
-            * Each TLS page has 8 slots, each 0x200 (512) bytes in size
-            * The first slot of the first page is reserved for user-mode exception handling
-            * @url https://switchbrew.org/wiki/Thread_Local_Storage
-            */
-            struct TlsPage {
-                u8 index{}; //!< The slots are assigned sequentially, this holds the index of the last TLS slot reserved
-                u8 *memory; //!< A single page sized memory allocation for this TLS page
+             * @brief Parks the calling thread directly on a futex keyed by the mutex address till it's unlocked or ownership changes
+             * @param value The current value of the mutex, the thread won't be parked if the mutex no longer has this value
+             * @return If the mutex value changed prior to the timeout expiring, the thread is scheduled again in either case
+             */
+            bool MutexWaitHandoff(u32 *mutex, u32 value);
 
-                TlsPage(u8 *memory);
+            /**
+             * @brief Wakes all threads parked on the futex for the supplied mutex, this must be called after any modification to the value of a mutex by the kernel
+             */
+            void MutexWakeHandoff(u32 *mutex);
 
-                /**
-                 * @return A non-null pointer to a TLS page slot on success, a nullptr will be returned if this page is full
-                 * @note This function is not thread-safe and should be called exclusively by one thread at a time
-                 */
-                u8 *ReserveSlot();
-            };
+            /**
+             * @brief Maps a new TLS page and adds all of its slots to the free list
+             * @note The TLS mutex must be locked when calling this
+             * @url https://switchbrew.org/wiki/Thread_Local_Storage
+             */
+            void MapTlsPage();
+
+            std::mutex snapshotMutex; //!< Synchronizes taking memory snapshots
+            std::unique_ptr<MemorySnapshot> memorySnapshot; //!< The most recently taken memory snapshot, it's retained till a new one is taken as guest writes to it are trapped till it has been written out in full
 
           public:
+            HostThreadPool hostThreadPool; //!< The host threads that all guest threads other than the main thread are run on
             u8 *tlsExceptionContext{}; //!< A pointer to the TLS exception handling context slot
-            std::mutex tlsMutex; //!< A mutex to synchronize allocation of TLS pages to prevent extra pages from being created
-            std::vector<std::shared_ptr<TlsPage>> tlsPages; //!< All TLS pages allocated by this process
+            std::mutex tlsMutex; //!< Synchronizes accesses to the TLS slot free list and mapping of TLS pages
+            std::vector<u8 *> freeTlsSlots; //!< A stack of TLS slots that aren't assigned to any thread, this is filled at process creation so allocating a slot doesn't require mapping a page
             vfs::NPDM npdm;
             span<u8> mainThreadStack;
           private:
-            std::shared_mutex handleMutex;
-            std::vector<std::shared_ptr<KObject>> handles;
+            /**
+             * @brief An entry in the handle table, entries are only modified by writers holding `handleMutex` while lookups are lock-free
+             */
+            struct HandleEntry {
+                std::atomic<KHandle> handle; //!< The handle currently referring to this entry or 0 if the entry isn't in use, lookups are validated against this
+                std::shared_ptr<KObject> object; //!< The object of the entry, this is only written while the entry isn't in use and isn't borrowed by any thread
+            };
+
+            /**
+             * @brief An entry which was closed but may still be borrowed by a thread, it's only freed once no thread has it borrowed
+             */
+            struct RetiredHandle {
+                u16 index;
+                KHandle handle;
+            };
+
+            std::mutex handleMutex; //!< Synchronizes all modifications of the handle table, this isn't required for lookups
+            std::array<HandleEntry, constant::MaxHandleCount> handleTable{};
+            std::vector<u16> freeHandleIndices; //!< A stack of the indices of unused entries in the handle table
+            std::vector<RetiredHandle> retiredHandles;
+            u16 nextHandleLinearId{1}; //!< The linear ID of the next handle, this is used to detect stale handles to reused entries like HOS
+
+            /**
+             * @return A handle in the HOS format, the index of the entry is in the lower 15 bits while the linear ID is in the upper 15 bits
+             */
+            static constexpr KHandle MakeHandle(u16 index, u16 linearId) {
+                return (static_cast<KHandle>(linearId) << 15) | index;
+            }
+
+            static constexpr u16 GetHandleIndex(KHandle handle) {
+                return static_cast<u16>(handle & 0x7FFF);
+            }
+
+            /**
+             * @brief Reserves an entry in the handle table, it's in use once PublishHandleLocked is called with it
+             * @param index The index of the reserved entry is written to this
+             * @return The handle which will refer to the entry
+             * @note handleMutex MUST be locked when calling this
+             */
+            KHandle ReserveHandleLocked(u16 &index);
+
+            /**
+             * @brief Makes a reserved entry refer to the supplied object, this makes it visible to lookups
+             * @note handleMutex MUST be locked when calling this
+             */
+            void PublishHandleLocked(u16 index, KHandle handle, std::shared_ptr<KObject> object);
+
+            /**
+             * @brief Looks up the entry of a handle and marks it as borrowed by the calling thread, the entry can't be freed till the borrow is released
+             * @param borrowSlot The slot the borrow is recorded in, this must be reset to release the borrow once the entry is no longer accessed
+             * @return The entry of the handle, std::out_of_range is thrown if the handle is invalid or closed
+             * @note This must only be called from guest threads as borrows are tracked per-thread
+             */
+            HandleEntry &BorrowEntry(KHandle handle, std::atomic<KHandle> &borrowSlot);
+
+            /**
+             * @brief Frees any retired entries that aren't borrowed by any thread
+             * @note Neither handleMutex nor threadMutex must be locked when calling this
+             */
+            void ReclaimHandles();
+
+            template<typename objectClass>
+            static constexpr KType GetObjectType() {
+                if constexpr(std::is_same<objectClass, KThread>())
+                    return KType::KThread;
+                else if constexpr(std::is_same<objectClass, KProcess>())
+                    return KType::KProcess;
+                else if constexpr(std::is_same<objectClass, KSharedMemory>())
+                    return KType::KSharedMemory;
+                else if constexpr(std::is_same<objectClass, KTransferMemory>())
+                    return KType::KTransferMemory;
+                else if constexpr(std::is_same<objectClass, KSession>())
+                    return KType::KSession;
+                else if constexpr(std::is_same<objectClass, KEvent>())
+                    return KType::KEvent;
+                else
+                    static_assert(std::is_same<objectClass, KObject>(), "KProcess couldn't determine the object type");
+            }
+
+            /**
+             * @return The object for a pseudo-handle or nullptr if the handle isn't a pseudo-handle that is valid for the supplied type
+             */
+            template<typename objectClass>
+            const std::shared_ptr<objectClass> *GetPseudoHandle(KHandle handle) {
+                constexpr KHandle ThreadSelf{0xFFFF8000}; // The handle used by threads to refer to themselves
+                constexpr KHandle ProcessSelf{0xFFFF8001}; // The handle used by threads in a process to refer to the process
+                if constexpr(std::is_same<objectClass, KThread>())
+                    return handle == ThreadSelf ? &state.thread : nullptr;
+                else if constexpr(std::is_same<objectClass, KProcess>())
+                    return handle == ProcessSelf ? &state.process : nullptr;
+                else
+                    return nullptr;
+            }
+
+            /**
+             * @brief Checks that the object of an entry is of the supplied type
+             */
+            template<typename objectClass>
+            static void ValidateObjectType(KHandle handle, const HandleEntry &entry) {
+                if constexpr(!std::is_same<objectClass, KObject>()) {
+                    constexpr KType objectType{GetObjectType<objectClass>()};
+                    if (entry.object->objectType != objectType)
+                        throw exception("Tried to get kernel object (0x{:X}) with different type: {} when object is {}", handle, objectType, entry.object->objectType);
+                }
+            }
 
           public:
             KProcess(const DeviceState &state);
@@ -79,16 +194,27 @@ namespace skyline {
             void Kill(bool join, bool all = false, bool disableCreation = false);
 
             /**
-             * @brief This initializes the process heap and TLS Error Context slot pointer, it should be called prior to creating the first thread
+             * @brief This initializes the process heap, preallocates TLS pages and sets the TLS Error Context slot pointer, it should be called prior to creating the first thread
              * @note This requires VMM regions to be initialized, it will map heap at an arbitrary location otherwise
              */
             void InitializeHeapTls();
 
             /**
-             * @return A 0x200 TLS slot allocated inside the TLS/IO region
+             * @return A zero-filled 0x200 TLS slot allocated inside the TLS/IO region
              */
             u8 *AllocateTlsSlot();
 
+            /**
+             * @brief Returns a TLS slot to the free list after the thread it was assigned to has exited
+             */
+            void FreeTlsSlot(u8 *slot);
+
+            /**
+             * @brief Takes a copy-on-write snapshot of all mapped guest memory and writes it out to a file at the supplied path in the background
+             * @return If the snapshot was taken, this fails if the previous snapshot is still being written out or the file couldn't be created
+             */
+            bool SaveMemorySnapshot(const std::string &path);
+
             /**
              * @return A shared pointer to a KThread initialized with the specified values or nullptr, if thread creation has been disabled
              * @note The default values are for the main thread and will use values from the NPDM
@@ -105,6 +231,47 @@ namespace skyline {
                 KHandle handle; //!< The handle of the object in the process
             };
 
+            /**
+             * @brief A reference to an object in the handle table which doesn't hold ownership of it, the entry of the object can't be freed till this is destroyed
+             * @note This avoids atomically modifying the reference count of the object for lookups that only access it for the duration of an SVC, only a single reference can be borrowed by a thread at any time
+             */
+            template<typename objectClass>
+            class BorrowedHandle {
+              private:
+                objectClass *object;
+                std::atomic<KHandle> *borrowSlot; //!< The slot the borrow is recorded in or nullptr for pseudo-handles which don't need to be borrowed
+
+              public:
+                BorrowedHandle(objectClass *object, std::atomic<KHandle> *borrowSlot) : object{object}, borrowSlot{borrowSlot} {}
+
+                BorrowedHandle(const BorrowedHandle &) = delete;
+
+                BorrowedHandle &operator=(const BorrowedHandle &) = delete;
+
+                ~BorrowedHandle() {
+                    if (borrowSlot)
+                        borrowSlot->store(0, std::memory_order_release);
+                }
+
+                objectClass *operator->() const {
+                    return object;
+                }
+
+                objectClass &operator*() const {
+                    return *object;
+                }
+            };
+
+            /**
+            * @brief The output for functions that return created kernel objects
+            * @tparam objectClass The class of the kernel object
+            */
+            template<typename objectClass>
+            struct HandleOut {
+                std::shared_ptr<objectClass> item; //!< A shared pointer to the object
+                KHandle handle; //!< The handle of the object in the process
+            };
+
             /**
              * @brief Creates a new handle to a KObject and adds it to the process handle_table
              * @tparam objectClass The class of the kernel object to create
@@ -114,13 +281,21 @@ namespace skyline {
             HandleOut<objectClass> NewHandle(objectArgs... args) {
                 std::unique_lock lock(handleMutex);
 
+                u16 index;
+                KHandle handle{ReserveHandleLocked(index)};
                 std::shared_ptr<objectClass> item;
-                if constexpr (std::is_same<objectClass, KThread>())
-                    item = std::make_shared<objectClass>(state, constant::BaseHandleIndex + handles.size(), args...);
-                else
-                    item = std::make_shared<objectClass>(state, args...);
-                handles.push_back(std::static_pointer_cast<KObject>(item));
-                return {item, static_cast<KHandle>((constant::BaseHandleIndex + handles.size()) - 1)};
+                try {
+                    if constexpr (std::is_same<objectClass, KThread>())
+                        item = std::make_shared<objectClass>(state, handle, args...);
+                    else
+                        item = std::make_shared<objectClass>(state, args...);
+                } catch (...) {
+                    freeHandleIndices.push_back(index);
+                    throw;
+                }
+
+                PublishHandleLocked(index, handle, std::static_pointer_cast<KObject>(item));
+                return {item, handle};
             }
 
             /**
@@ -131,65 +306,69 @@ namespace skyline {
             KHandle InsertItem(std::shared_ptr<objectClass> &item) {
                 std::unique_lock lock(handleMutex);
 
-                handles.push_back(std::static_pointer_cast<KObject>(item));
-                return static_cast<KHandle>((constant::BaseHandleIndex + handles.size()) - 1);
+                u16 index;
+                KHandle handle{ReserveHandleLocked(index)};
+                PublishHandleLocked(index, handle, std::static_pointer_cast<KObject>(item));
+                return handle;
             }
 
+            /**
+             * @return An owning reference to the object of the supplied handle, std::out_of_range is thrown if the handle is invalid
+             */
             template<typename objectClass = KObject>
             std::shared_ptr<objectClass> GetHandle(KHandle handle) {
-                std::shared_lock lock(handleMutex);
-
-                KType objectType;
-                if constexpr(std::is_same<objectClass, KThread>()) {
-                    constexpr KHandle threadSelf{0xFFFF8000}; // The handle used by threads to refer to themselves
-                    if (handle == threadSelf)
-                        return state.thread;
-                    objectType = KType::KThread;
-                } else if constexpr(std::is_same<objectClass, KProcess>()) {
-                    constexpr KHandle processSelf{0xFFFF8001}; // The handle used by threads in a process to refer to the process
-                    if (handle == processSelf)
-                        return state.process;
-                    objectType = KType::KProcess;
-                } else if constexpr(std::is_same<objectClass, KSharedMemory>()) {
-                    objectType = KType::KSharedMemory;
-                } else if constexpr(std::is_same<objectClass, KTransferMemory>()) {
-                    objectType = KType::KTransferMemory;
-                } else if constexpr(std::is_same<objectClass, KSession>()) {
-                    objectType = KType::KSession;
-                } else if constexpr(std::is_same<objectClass, KEvent>()) {
-                    objectType = KType::KEvent;
-                } else {
-                    throw exception("KProcess::GetHandle couldn't determine object type");
+                if (auto pseudoObject{GetPseudoHandle<objectClass>(handle)})
+                    return *pseudoObject;
+
+                if (!state.thread) {
+                    // Host threads can't borrow entries as borrows are tracked per guest thread, they fall back to locking the table instead
+                    std::scoped_lock lock{handleMutex};
+                    u16 index{GetHandleIndex(handle)};
+                    if (!handle || index >= constant::MaxHandleCount || handleTable[index].handle.load(std::memory_order_relaxed) != handle)
+                        throw std::out_of_range(fmt::format("GetHandle was called with an invalid handle: 0x{:X}", handle));
+
+                    auto &entry{handleTable[index]};
+                    ValidateObjectType<objectClass>(handle, entry);
+                    return std::static_pointer_cast<objectClass>(entry.object);
                 }
+
+                auto &borrowSlot{state.thread->borrowedHandle};
+                auto &entry{BorrowEntry(handle, borrowSlot)};
                 try {
-                    auto &item{handles.at(handle - constant::BaseHandleIndex)};
-                    if (item != nullptr && item->objectType == objectType)
-                        return std::static_pointer_cast<objectClass>(item);
-                    else if (item == nullptr)
-                        throw exception("GetHandle was called with a deleted handle: 0x{:X}", handle);
-                    else
-                        throw exception("Tried to get kernel object (0x{:X}) with different type: {} when object is {}", handle, objectType, item->objectType);
-                } catch (const std::out_of_range &) {
-                    throw std::out_of_range(fmt::format("GetHandle was called with an invalid handle: 0x{:X}", handle));
+                    ValidateObjectType<objectClass>(handle, entry);
+                    auto object{std::static_pointer_cast<objectClass>(entry.object)};
+                    borrowSlot.store(0, std::memory_order_release);
+                    return object;
+                } catch (...) {
+                    borrowSlot.store(0, std::memory_order_release);
+                    throw;
                 }
             }
 
-            template<>
-            std::shared_ptr<KObject> GetHandle<KObject>(KHandle handle) {
-                std::shared_lock lock(handleMutex);
-                auto &item{handles.at(handle - constant::BaseHandleIndex)};
-                if (item != nullptr)
-                    return item;
-                else
-                    throw std::out_of_range(fmt::format("GetHandle was called with a deleted handle: 0x{:X}", handle));
+            /**
+             * @return A borrowed reference to the object of the supplied handle, std::out_of_range is thrown if the handle is invalid
+             * @note This must only be called from guest threads and the reference must not be held across any blocking operation, GetHandle should be used to retain the object instead
+             */
+            template<typename objectClass = KObject>
+            BorrowedHandle<objectClass> BorrowHandle(KHandle handle) {
+                if (auto pseudoObject{GetPseudoHandle<objectClass>(handle)})
+                    return BorrowedHandle<objectClass>{pseudoObject->get(), nullptr};
+
+                auto &borrowSlot{state.thread->borrowedHandle};
+                auto &entry{BorrowEntry(handle, borrowSlot)};
+                try {
+                    ValidateObjectType<objectClass>(handle, entry);
+                } catch (...) {
+                    borrowSlot.store(0, std::memory_order_release);
+                    throw;
+                }
+                return BorrowedHandle<objectClass>{static_cast<objectClass *>(entry.object.get()), &borrowSlot};
             }
 
             /**
-             * @brief Closes a handle in the handle table
+             * @brief Closes a handle in the handle table, the object is released once no thread has its entry borrowed
              */
-            void CloseHandle(KHandle handle) {
-                handles.at(handle - constant::BaseHandleIndex) = nullptr;
-            }
+            void CloseHandle(KHandle handle);
 
             /**
              * @brief Clear the process handle table
@@ -3,6 +3,7 @@
 
 #pragma once
 
+#include <common/spin_lock.h>
 #include "KSyncObject.h"
 
 namespace skyline::service {
@@ -14,11 +15,17 @@ namespace skyline::kernel::type {
      * @brief KService holds a reference to a service, this is equivalent to KClientSession
      */
     class KSession : public KSyncObject {
+      public:
+        static constexpr size_t MaxDomainObjects{256}; //!< The maximum amount of objects that can simultaneously exist in a domain
+
+      private:
+        using DomainTable = std::array<std::shared_ptr<service::BaseService>, MaxDomainObjects>;
+        std::unique_ptr<DomainTable> domains; //!< A table of services that correspond to virtual handles, slots are accessed atomically so lookups don't require any locking
+        SpinLock domainMutex; //!< Synchronizes the insertion and removal of domain objects, this is per-session so it's never contended by requests to other sessions
+
       public:
         std::shared_ptr<service::BaseService> serviceObject;
-        std::vector<std::shared_ptr<service::BaseService>> domains; //!< A vector of services that correspond to virtual handles
-        KHandle handleIndex{}; //!< The currently allocated handle index
-        bool isOpen{true}; //!< If the session is open or not
+        std::atomic<bool> isOpen{true}; //!< If the session is open or not
         bool isDomain{}; //!< If this is a domain session or not
 
         /**
@@ -32,9 +39,57 @@ namespace skyline::kernel::type {
          * @return The virtual handle of this service in the domain
          */
         KHandle ConvertDomain() {
+            domains = std::make_unique<DomainTable>();
             isDomain = true;
-            domains.push_back(serviceObject);
-            return handleIndex++;
+            return InsertDomainObject(serviceObject);
+        }
+
+        /**
+         * @brief Inserts a service into the lowest free slot of the domain
+         * @return The virtual handle of the service in the domain
+         */
+        KHandle InsertDomainObject(const std::shared_ptr<service::BaseService> &object) {
+            std::scoped_lock lock{domainMutex};
+            for (KHandle id{}; id < MaxDomainObjects; id++) {
+                auto &slot{(*domains)[id]};
+                if (!std::atomic_load(&slot)) {
+                    std::atomic_store(&slot, object);
+                    return id;
+                }
+            }
+            throw exception("Domain has run out of object slots: {}", MaxDomainObjects);
+        }
+
+        /**
+         * @return The service corresponding to the virtual handle or nullptr if it has been closed
+         * @note This is lock-free and can be called concurrently with insertions and removals
+         */
+        std::shared_ptr<service::BaseService> GetDomainObject(KHandle id) {
+            if (id >= MaxDomainObjects)
+                throw std::out_of_range(fmt::format("Domain object ID is out of range: {}", id));
+            return std::atomic_load(&(*domains)[id]);
+        }
+
+        /**
+         * @brief Frees the slot of the supplied virtual handle so it can be reused
+         * @return The service that was removed from the domain or nullptr if the slot was already empty
+         */
+        std::shared_ptr<service::BaseService> RemoveDomainObject(KHandle id) {
+            if (id >= MaxDomainObjects)
+                throw std::out_of_range(fmt::format("Domain object ID is out of range: {}", id));
+            std::scoped_lock lock{domainMutex};
+            return std::atomic_exchange(&(*domains)[id], std::shared_ptr<service::BaseService>{});
+        }
+
+        /**
+         * @return All services that currently exist in the domain
+         */
+        std::vector<std::shared_ptr<service::BaseService>> GetDomainObjects() {
+            std::vector<std::shared_ptr<service::BaseService>> objects;
+            for (auto &slot : *domains)
+                if (auto object{std::atomic_load(&slot)})
+                    objects.push_back(std::move(object));
+            return objects;
         }
     };
 }
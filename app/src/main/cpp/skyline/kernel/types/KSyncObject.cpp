@@ -8,11 +8,13 @@ namespace skyline::kernel::type {
     void KSyncObject::Signal() {
         std::scoped_lock lock{syncObjectMutex};
         signalled = true;
-        for (auto &waiter : syncObjectWaiters) {
+        for (auto node{syncObjectWaiters}; node; node = node->next) {
+            auto waiter{node->thread};
+            std::scoped_lock waitLock{waiter->syncWaitMutex};
             if (waiter->isCancellable) {
                 waiter->isCancellable = false;
                 waiter->wakeObject = this;
-                state.scheduler->InsertThread(waiter);
+                state.scheduler->InsertThread(waiter->shared_from_this());
             }
         }
     }
@@ -25,4 +27,51 @@ namespace skyline::kernel::type {
         }
         return false;
     }
+
+    void KSyncObject::InsertWaiter(SyncWaiterNode &node, i8 priority) {
+        SyncWaiterNode *previous{};
+        for (auto next{syncObjectWaiters}; next && next->thread->priority <= priority; next = next->next)
+            previous = next;
+
+        node.previous = previous;
+        node.next = previous ? previous->next : syncObjectWaiters;
+        if (node.next)
+            node.next->previous = &node;
+        if (previous)
+            previous->next = &node;
+        else
+            syncObjectWaiters = &node;
+    }
+
+    void KSyncObject::RemoveWaiter(SyncWaiterNode &node) {
+        if (node.previous)
+            node.previous->next = node.next;
+        else
+            syncObjectWaiters = node.next;
+
+        if (node.next)
+            node.next->previous = node.previous;
+
+        node.previous = nullptr;
+        node.next = nullptr;
+    }
+
+    SyncObjectsLock::SyncObjectsLock(span<const std::shared_ptr<KSyncObject>> objects) {
+        mutexes.reserve(objects.size());
+        for (const auto &object : objects)
+            mutexes.push_back(&object->syncObjectMutex);
+
+        std::sort(mutexes.begin(), mutexes.end());
+        mutexes.erase(std::unique(mutexes.begin(), mutexes.end()), mutexes.end());
+    }
+
+    void SyncObjectsLock::lock() {
+        for (auto mutex : mutexes)
+            mutex->lock();
+    }
+
+    void SyncObjectsLock::unlock() {
+        for (auto it{mutexes.rbegin()}; it != mutexes.rend(); it++)
+            (*it)->unlock();
+    }
 }
@@ -5,33 +5,76 @@
 
 #include "KObject.h"
 
-namespace skyline::kernel::type {
-    /**
-     * @brief KSyncObject is an abstract class which holds everything necessary for an object to be synchronizable
-     * @note This abstraction is roughly equivalent to KSynchronizationObject on HOS
-     */
-    class KSyncObject : public KObject {
-      public:
-        inline static std::mutex syncObjectMutex; //!< A global lock used for locking all signalling to avoid races
-        std::list<std::shared_ptr<KThread>> syncObjectWaiters; //!< A list of threads waiting on this object to be signalled
-        bool signalled; //!< If the current object is signalled (An object stays signalled till the signal has been explicitly reset)
+namespace skyline {
+    namespace constant {
+        constexpr u8 MaxSyncHandles{0x40}; //!< The total amount of handles that can be passed to svcWaitSynchronization
+    }
 
+    namespace kernel::type {
         /**
-         * @param presignalled If this object should be signalled initially or not
+         * @brief A node in the intrusive list of threads waiting on a sync object, every thread has a node preallocated for each handle it can wait on
          */
-        KSyncObject(const DeviceState &state, skyline::kernel::type::KType type, bool presignalled = false) : KObject(state, type), signalled(presignalled) {};
+        struct SyncWaiterNode {
+            KThread *thread{}; //!< The thread that is waiting on the object
+            SyncWaiterNode *previous{};
+            SyncWaiterNode *next{};
+        };
 
         /**
-         * @brief Wakes up any waiters on this object and flips the 'signalled' flag
+         * @brief KSyncObject is an abstract class which holds everything necessary for an object to be synchronizable
+         * @note This abstraction is roughly equivalent to KSynchronizationObject on HOS
          */
-        void Signal();
+        class KSyncObject : public KObject {
+          public:
+            std::mutex syncObjectMutex; //!< Synchronizes signalling and all accesses to the waiters of this object, this must be locked alongside the mutexes of other objects through SyncObjectsLock
+            SyncWaiterNode *syncObjectWaiters{}; //!< The head of an intrusive list of threads waiting on this object to be signalled sorted by priority
+            bool signalled; //!< If the current object is signalled (An object stays signalled till the signal has been explicitly reset)
+
+            /**
+             * @param presignalled If this object should be signalled initially or not
+             */
+            KSyncObject(const DeviceState &state, skyline::kernel::type::KType type, bool presignalled = false) : KObject(state, type), signalled(presignalled) {};
+
+            /**
+             * @brief Wakes up any waiters on this object and flips the 'signalled' flag
+             */
+            void Signal();
+
+            /**
+             * @brief Resets the object to an unsignalled state
+             * @return If the signal was reset or not
+             */
+            bool ResetSignal();
+
+            /**
+             * @brief Inserts the node into the waiters of this object behind any waiters of the same or higher priority
+             * @note 'syncObjectMutex' **must** be locked by the calling thread prior to calling this
+             */
+            void InsertWaiter(SyncWaiterNode &node, i8 priority);
+
+            /**
+             * @brief Removes the node from the waiters of this object, it must've been inserted prior
+             * @note 'syncObjectMutex' **must** be locked by the calling thread prior to calling this
+             */
+            void RemoveWaiter(SyncWaiterNode &node);
+
+            virtual ~KSyncObject() = default;
+        };
 
         /**
-         * @brief Resets the object to an unsignalled state
-         * @return If the signal was reset or not
+         * @brief A lock over the signalling state of multiple sync objects at once
+         * @note The mutexes are locked in the order of their addresses which ensures that threads locking overlapping sets of objects cannot deadlock, duplicate objects are only locked once
          */
-        bool ResetSignal();
+        class SyncObjectsLock {
+          private:
+            boost::container::small_vector<std::mutex *, constant::MaxSyncHandles> mutexes;
+
+          public:
+            SyncObjectsLock(span<const std::shared_ptr<KSyncObject>> objects);
+
+            void lock();
 
-        virtual ~KSyncObject() = default;
-    };
+            void unlock();
+        };
+    }
 }
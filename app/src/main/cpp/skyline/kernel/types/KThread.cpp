@@ -5,6 +5,7 @@
 #include <unistd.h>
 #include <common/signal.h>
 #include <common/trace.h>
+#include <common/performance_hint.h>
 #include <nce.h>
 #include <os.h>
 #include "KProcess.h"
@@ -28,10 +29,6 @@ namespace skyline::kernel::type {
 
     KThread::~KThread() {
         Kill(true);
-        if (thread.joinable())
-            thread.join();
-        if (preemptionTimer)
-            timer_delete(preemptionTimer);
     }
 
     void KThread::StartThread() {
@@ -48,12 +45,24 @@ namespace skyline::kernel::type {
             ctx.tpidrroEl0 = parent->AllocateTlsSlot();
 
         ctx.state = &state;
+        ctx.coreId = &coreId;
+        ctx.threadId = id;
         state.ctx = &ctx;
         state.thread = shared_from_this();
 
+        // The main thread drives the frame loop of most titles so it's included in the performance hint session alongside the GPU threads
+        if (id == 1)
+            PerformanceHint::RegisterCurrentThread();
+
         if (setjmp(originalCtx)) { // Returns 1 if it's returning from guest, 0 otherwise
+            if (id == 1)
+                PerformanceHint::UnregisterCurrentThread();
+
             state.scheduler->RemoveThread();
 
+            parent->FreeTlsSlot(ctx.tpidrroEl0);
+            ctx.tpidrroEl0 = nullptr;
+
             {
                 std::scoped_lock lock{statusMutex};
                 running = false;
@@ -72,14 +81,6 @@ namespace skyline::kernel::type {
             return;
         }
 
-        struct sigevent event{
-            .sigev_signo = Scheduler::PreemptionSignal,
-            .sigev_notify = SIGEV_THREAD_ID,
-            .sigev_notify_thread_id = gettid(),
-        };
-        if (timer_create(CLOCK_THREAD_CPUTIME_ID, &event, &preemptionTimer))
-            throw exception("timer_create has failed with '{}'", strerror(errno));
-
         signal::SetSignalHandler({SIGINT, SIGILL, SIGTRAP, SIGBUS, SIGFPE, SIGSEGV}, nce::NCE::SignalHandler);
         signal::SetSignalHandler({Scheduler::YieldSignal, Scheduler::PreemptionSignal}, Scheduler::SignalHandler, false); // We want futexes to fail and their predicates rechecked
 
@@ -221,7 +222,7 @@ namespace skyline::kernel::type {
                 lock.unlock();
                 StartThread();
             } else {
-                thread = std::thread(&KThread::StartThread, this);
+                parent->hostThreadPool.Run(shared_from_this());
             }
         }
     }
@@ -247,32 +248,6 @@ namespace skyline::kernel::type {
             pthread_kill(pthread, signal);
     }
 
-    void KThread::ArmPreemptionTimer(std::chrono::nanoseconds timeToFire) {
-        std::unique_lock lock(statusMutex);
-        statusCondition.wait(lock, [this]() { return ready || killed; });
-        if (!killed && running) {
-            struct itimerspec spec{.it_value = {
-                .tv_nsec = std::min(static_cast<i64>(timeToFire.count()), constant::NsInSecond),
-                .tv_sec = std::max(std::chrono::duration_cast<std::chrono::seconds>(timeToFire).count() - 1, 0LL),
-            }};
-            timer_settime(preemptionTimer, 0, &spec, nullptr);
-            isPreempted = true;
-        }
-    }
-
-    void KThread::DisarmPreemptionTimer() {
-        if (!isPreempted) [[unlikely]]
-            return;
-
-        std::unique_lock lock(statusMutex);
-        statusCondition.wait(lock, [this]() { return ready || killed; });
-        if (!killed && running) {
-            struct itimerspec spec{};
-            timer_settime(preemptionTimer, 0, &spec, nullptr);
-            isPreempted = false;
-        }
-    }
-
     void KThread::UpdatePriorityInheritance() {
         std::unique_lock lock{waiterMutex};
 
@@ -6,6 +6,7 @@
 #include <csetjmp>
 #include <nce/guest.h>
 #include <kernel/scheduler.h>
+#include <kernel/thread_pool.h>
 #include <common/signal.h>
 #include <common/spin_lock.h>
 #include "KSyncObject.h"
@@ -19,16 +20,16 @@ namespace skyline {
         class KThread : public KSyncObject, public std::enable_shared_from_this<KThread> {
           private:
             KProcess *parent;
-            std::thread thread; //!< If this KThread is backed by a host thread then this'll hold it
             pthread_t pthread{}; //!< The pthread_t for the host thread running this guest thread
-            timer_t preemptionTimer{}; //!< A kernel timer used for preemption interrupts
 
             /**
              * @brief Entry function any guest threads, sets up necessary context and jumps into guest code from the calling thread
-             * @note This function also serves as the entry point for host threads created in StartThread
+             * @note This function also serves as the entry point for guest threads run on a host thread from the process's host thread pool
              */
             void StartThread();
 
+            friend HostThreadPool;
+
           public:
             std::mutex statusMutex; //!< Synchronizes all thread state changes (running/ready/killed)
             std::condition_variable statusCondition; //!< Signalled on the status of the thread changing
@@ -38,6 +39,7 @@ namespace skyline {
 
             KHandle handle;
             size_t id; //!< Index of thread in parent process's KThread vector
+            std::atomic<KHandle> borrowedHandle{}; //!< The handle of the process handle table entry this thread has borrowed or 0 if none, the entry can't be freed while it's borrowed
 
             nce::ThreadContext ctx{}; //!< The context of the guest thread during the last SVC
             jmp_buf originalCtx; //!< The context of the host thread prior to jumping into guest code
@@ -54,11 +56,17 @@ namespace skyline {
             u8 idealCore; //!< The ideal CPU core for this thread to run on
             u8 coreId; //!< The CPU core on which this thread is running
             CoreMask affinityMask{}; //!< A mask of CPU cores this thread is allowed to run on
+            u8 placedCoreId{constant::ParkedCoreId}; //!< The core which the host thread's affinity was last set for, this is only accessed by the thread itself
+
+            KThread *queuePrevious{}; //!< The previous thread in the resident core's scheduler queue, this is protected by the core's mutex
+            KThread *queueNext{}; //!< The next thread in the resident core's scheduler queue, this is protected by the core's mutex
+            i8 queuePriority{}; //!< The priority level of the scheduler queue that this thread was inserted at, this can momentarily differ from `priority` during a priority update
+            bool isQueued{}; //!< If this thread is in the resident core's scheduler queue
 
             u64 timesliceStart{}; //!< A timestamp in host CNTVCT ticks of when the thread's current timeslice started
             u64 averageTimeslice{}; //!< A weighted average of the timeslice duration for this thread
 
-            bool isPreempted{}; //!< If the preemption timer has been armed and will fire
+            bool isPreempted{}; //!< If preemption has been armed for this thread on its resident core
             bool pendingYield{}; //!< If the thread has been yielded and hasn't been acted upon it yet
             bool forceYield{}; //!< If the thread has been forcefully yielded by another thread
 
@@ -71,9 +79,11 @@ namespace skyline {
             bool waitSignalled{}; //!< If the conditional variable has been signalled already
             Result waitResult; //!< The result of the wait operation
 
+            SpinLock syncWaitMutex; //!< Synchronizes accesses to the state of a wait on sync objects, it's locked after any sync object mutexes
             bool isCancellable{false}; //!< If the thread is currently in a position where it's cancellable
             bool cancelSync{false}; //!< Whether to cancel the SvcWaitSynchronization call this thread currently is in/the next one it joins
             type::KSyncObject *wakeObject{}; //!< A pointer to the synchronization object responsible for waking this thread up
+            std::array<SyncWaiterNode, constant::MaxSyncHandles> syncWaiterNodes{}; //!< Preallocated nodes for inserting this thread into the waiters of every object it waits on, these are protected by the mutex of the object they're inserted into
 
             bool isPaused{false}; //!< If the thread is currently paused and not runnable
             bool insertThreadOnResume{false}; //!< If the thread should be inserted into the scheduler when it resumes (used for pausing threads during sleep/sync)
@@ -83,7 +93,7 @@ namespace skyline {
             ~KThread();
 
             /**
-             * @param self If the calling thread should jump directly into guest code or if a new thread should be created for it
+             * @param self If the calling thread should jump directly into guest code or if it should be run on a host thread from the pool
              * @note If the thread is already running then this does nothing
              * @note 'stack' will be created if it wasn't set prior to calling this
              */
@@ -99,16 +109,6 @@ namespace skyline {
              */
             void SendSignal(int signal);
 
-            /**
-             * @brief Arms the preemption kernel timer to fire in the specified amount of time
-             */
-            void ArmPreemptionTimer(std::chrono::nanoseconds timeToFire);
-
-            /**
-             * @brief Disarms the preemption kernel timer, any scheduled firings will be cancelled
-             */
-            void DisarmPreemptionTimer();
-
             /**
              * @brief Recursively updates the priority for any threads this thread might be waiting on
              * @note PI is performed by temporarily upgrading a thread's priority if a thread waiting on it has a higher priority to prevent priority inversion
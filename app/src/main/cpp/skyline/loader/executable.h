@@ -5,6 +5,10 @@
 
 #include <common.h>
 
+namespace skyline::vfs {
+    class Backing;
+}
+
 namespace skyline::loader {
     /**
      * @brief The MOD header embeds metadata about an executable into it
@@ -35,8 +39,17 @@ namespace skyline::loader {
          * @brief The contents and offset of an executable segment
          */
         struct Segment {
-            std::vector<u8> contents; //!< The raw contents of the segment
+            std::vector<u8> storage; //!< The contents of the segment if they had to be read or decompressed
+            span<u8> view; //!< A read-only view of the contents directly in their source, this is used instead of `storage` if it's valid
+            size_t size; //!< The size of the segment in memory, anything past the contents is zero-filled when the segment is loaded
             size_t offset; //!< The offset from the base address to load the segment at
+
+            /**
+             * @return The raw contents of the segment, these must never be written to as they may be a read-only view
+             */
+            span<u8> Contents() {
+                return view.valid() ? view : span<u8>{storage};
+            }
         };
 
         Segment text; //!< The .text segment container
@@ -51,5 +64,14 @@ namespace skyline::loader {
 
         RelativeSegment dynsym; //!< The .dynsym segment relative to .rodata
         RelativeSegment dynstr; //!< The .dynstr segment relative to .rodata
+
+        std::shared_ptr<vfs::Backing> backing; //!< The backing that any segment contents are viewed from, this keeps the views valid till the executable has been loaded
+
+        std::array<u64, 4> buildId{}; //!< The build ID of the executable, this is used to key cached data derived from the executable and is all zeros if it doesn't have one
+        u64 headerHash{}; //!< A hash of the executable's segment headers, this is used to validate cached data keyed by the build ID
+
+        bool patchScanned{}; //!< If the NCE patch data has been determined for .text already, it's done by Loader::ScanPatches
+        size_t patchSize{}; //!< The size of the .patch section
+        std::vector<size_t> patchOffsets; //!< Offsets in .text of instructions that need to be patched
     };
 }
@@ -3,6 +3,7 @@
 
 #include <dlfcn.h>
 #include <cxxabi.h>
+#include <common/boot_profiler.h>
 #include <nce.h>
 #include <os.h>
 #include <kernel/types/KProcess.h>
@@ -11,12 +12,27 @@
 #include "loader.h"
 
 namespace skyline::loader {
+    void Loader::ScanPatches(const DeviceState &state, Executable &executable) {
+        auto patch{[&]() {
+            if (executable.buildId == decltype(executable.buildId){})
+                return nce::NCE::GetPatchData(executable.text.Contents());
+
+            // Patch data is cached per build ID so warm boots can skip scanning .text entirely
+            auto cachePath{fmt::format("{}cache/nce_patch/{:016X}{:016X}{:016X}{:016X}.bin", state.os->privateAppFilesPath, executable.buildId[0], executable.buildId[1], executable.buildId[2], executable.buildId[3])};
+            return nce::NCE::GetPatchData(executable.text.Contents(), cachePath, executable.headerHash);
+        }()};
+
+        executable.patchSize = patch.size;
+        executable.patchOffsets = std::move(patch.offsets);
+        executable.patchScanned = true;
+    }
+
     Loader::ExecutableLoadInfo Loader::LoadExecutable(const std::shared_ptr<kernel::type::KProcess> &process, const DeviceState &state, Executable &executable, size_t offset, const std::string &name, bool dynamicallyLinked) {
         u8 *base{reinterpret_cast<u8 *>(process->memory.code.data() + offset)};
 
-        size_t textSize{executable.text.contents.size()};
-        size_t roSize{executable.ro.contents.size()};
-        size_t dataSize{executable.data.contents.size() + executable.bssSize};
+        size_t textSize{executable.text.size};
+        size_t roSize{executable.ro.size};
+        size_t dataSize{executable.data.size + executable.bssSize};
 
         if (!util::IsPageAligned(textSize) || !util::IsPageAligned(roSize) || !util::IsPageAligned(dataSize))
             throw exception("Sections are not aligned with page size: 0x{:X}, 0x{:X}, 0x{:X}", textSize, roSize, dataSize);
@@ -27,10 +43,11 @@ namespace skyline::loader {
         if (!util::IsPageAligned(executable.text.offset) || !util::IsPageAligned(executable.ro.offset) || !util::IsPageAligned(executable.data.offset))
             throw exception("Section offsets are not aligned with page size: 0x{:X}, 0x{:X}, 0x{:X}", executable.text.offset, executable.ro.offset, executable.data.offset);
 
-        auto patch{state.nce->GetPatchData(executable.text.contents)};
+        if (!executable.patchScanned)
+            ScanPatches(state, executable);
 
-        span dynsym{reinterpret_cast<Elf64_Sym *>(executable.ro.contents.data() + executable.dynsym.offset), executable.dynsym.size / sizeof(Elf64_Sym)};
-        span dynstr{reinterpret_cast<char *>(executable.ro.contents.data() + executable.dynstr.offset), executable.dynstr.size};
+        span dynsym{reinterpret_cast<Elf64_Sym *>(executable.ro.Contents().data() + executable.dynsym.offset), executable.dynsym.size / sizeof(Elf64_Sym)};
+        span dynstr{reinterpret_cast<char *>(executable.ro.Contents().data() + executable.dynstr.offset), executable.dynstr.size};
         std::vector<nce::NCE::HookedSymbolEntry> executableSymbols;
         size_t hookSize{};
         if (dynamicallyLinked) {
@@ -90,16 +107,21 @@ namespace skyline::loader {
         }
 
         if (process->memory.addressSpaceType == memory::AddressSpaceType::AddressSpace36Bit) {
-            process->memory.MapHeapMemory(span<u8>{base, patch.size + hookSize}); // ---
-            process->memory.SetRegionPermission(span<u8>{base, patch.size + hookSize}, memory::Permission{false, false, false});
+            process->memory.MapHeapMemory(span<u8>{base, executable.patchSize + hookSize}); // ---
+            process->memory.SetRegionPermission(span<u8>{base, executable.patchSize + hookSize}, memory::Permission{false, false, false});
         } else {
-            process->memory.Reserve(span<u8>{base, patch.size + hookSize}); // ---
+            process->memory.Reserve(span<u8>{base, executable.patchSize + hookSize}); // ---
         }
-        Logger::Debug("Successfully mapped section .patch @ 0x{:X}, Size = 0x{:X}", base, patch.size);
+        Logger::Debug("Successfully mapped section .patch @ 0x{:X}, Size = 0x{:X}", base, executable.patchSize);
         if (hookSize > 0)
-            Logger::Debug("Successfully mapped section .hook @ 0x{:X}, Size = 0x{:X}", base + patch.size, hookSize);
+            Logger::Debug("Successfully mapped section .hook @ 0x{:X}, Size = 0x{:X}", base + executable.patchSize, hookSize);
+
+        u8 *executableBase{base + executable.patchSize + hookSize};
+
+        // The hooked symbols were resolved from the segment contents which are read-only, they need to point into the copy of .rodata in guest memory instead as that's where the hooks are written to
+        for (auto &symbol : executableSymbols)
+            symbol.offset = reinterpret_cast<Elf64_Addr *>(executableBase + executable.ro.offset + (reinterpret_cast<u8 *>(symbol.offset) - executable.ro.Contents().data()));
 
-        u8 *executableBase{base + patch.size + hookSize};
         process->memory.MapCodeMemory(span<u8>{executableBase + executable.text.offset, textSize}, memory::Permission{true, false, true}); // R-X
         Logger::Debug("Successfully mapped section .text @ 0x{:X}, Size = 0x{:X}", executableBase, textSize);
 
@@ -109,12 +131,12 @@ namespace skyline::loader {
         process->memory.MapMutableCodeMemory(span<u8>{executableBase + executable.data.offset, dataSize}); // RW-
         Logger::Debug("Successfully mapped section .data + .bss @ 0x{:X}, Size = 0x{:X}", executableBase + executable.data.offset, dataSize);
 
-        size_t size{patch.size + hookSize + textSize + roSize + dataSize};
+        size_t size{executable.patchSize + hookSize + textSize + roSize + dataSize};
         {
             // Note: We need to copy out the symbols here as it'll be overwritten by any hooks
             ExecutableSymbolicInfo symbolicInfo{
                 .patchStart = base,
-                .hookStart = base + patch.size,
+                .hookStart = base + executable.patchSize,
                 .programStart = executableBase,
                 .programEnd = base + size,
                 .name = name,
@@ -126,13 +148,20 @@ namespace skyline::loader {
             executables.insert(std::upper_bound(executables.begin(), executables.end(), base, [](void *ptr, const ExecutableSymbolicInfo &it) { return ptr < it.patchStart; }), std::move(symbolicInfo));
         }
 
-        state.nce->PatchCode(executable.text.contents, reinterpret_cast<u32 *>(base), patch.size, patch.offsets, hookSize);
-        if (hookSize)
-            state.nce->WriteHookSection(executableSymbols, span<u8>{base + patch.size, hookSize}.cast<u32>());
+        // Segments are copied into guest memory as-is and patched in place from there, this is the only copy of their contents made during loading
+        for (auto segment : {&executable.text, &executable.ro, &executable.data}) {
+            u8 *segmentBase{executableBase + segment->offset};
+            auto contents{segment->Contents()};
+            std::memcpy(segmentBase, contents.data(), contents.size());
+            std::memset(segmentBase + contents.size(), 0, segment->size - contents.size());
+        }
 
-        std::memcpy(executableBase, executable.text.contents.data(), executable.text.contents.size());
-        std::memcpy(executableBase + executable.ro.offset, executable.ro.contents.data(), roSize);
-        std::memcpy(executableBase + executable.data.offset, executable.data.contents.data(), dataSize - executable.bssSize);
+        {
+            BootProfiler::ScopedStage bootStage{BootProfiler::Stage::CodePatching};
+            state.nce->PatchCode(span<u8>{executableBase + executable.text.offset, textSize}, reinterpret_cast<u32 *>(base), executable.patchSize, executable.patchOffsets, hookSize);
+            if (hookSize)
+                state.nce->WriteHookSection(executableSymbols, span<u8>{base + executable.patchSize, hookSize}.cast<u32>());
+        }
 
         Logger::EmulationContext.Flush();
         return {base, size, executableBase + executable.text.offset};
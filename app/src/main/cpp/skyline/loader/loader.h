@@ -76,6 +76,12 @@ namespace skyline::loader {
             void *entry; //!< The entry point of the loaded executable
         };
 
+        /**
+         * @brief Determines the NCE patch data for the executable's .text, this is done by LoadExecutable if it hasn't been done prior
+         * @note This is thread-safe and doesn't depend on the layout of the address space so it can be done in parallel with loading other executables
+         */
+        static void ScanPatches(const DeviceState &state, Executable &executable);
+
         /**
          * @brief Patches an executable and loads it into memory while setting up symbolic information
          * @param offset The offset from the base address that the executable should be placed at
@@ -0,0 +1,132 @@
+// SPDX-License-Identifier: MPL-2.0
+// Copyright © 2023 Skyline Team and Contributors (https://github.com/skyline-emu/)
+
+#include <cstdio>
+#include <fstream>
+#include "metadata_index.h"
+
+namespace skyline::loader {
+    namespace {
+        template<typename Type>
+        void WriteValue(std::ofstream &stream, Type value) {
+            stream.write(reinterpret_cast<const char *>(&value), sizeof(Type));
+        }
+
+        template<typename Container>
+        void WriteBuffer(std::ofstream &stream, const Container &buffer) {
+            WriteValue(stream, static_cast<u32>(buffer.size()));
+            stream.write(reinterpret_cast<const char *>(buffer.data()), static_cast<std::streamsize>(buffer.size()));
+        }
+
+        template<typename Type>
+        Type ReadValue(std::ifstream &stream) {
+            Type value{};
+            stream.read(reinterpret_cast<char *>(&value), sizeof(Type));
+            return value;
+        }
+
+        template<typename Container>
+        Container ReadBuffer(std::ifstream &stream) {
+            Container buffer(ReadValue<u32>(stream), {});
+            stream.read(reinterpret_cast<char *>(buffer.data()), static_cast<std::streamsize>(buffer.size()));
+            return buffer;
+        }
+    }
+
+    MetadataIndex::MetadataIndex(std::string pIndexPath) : indexPath{std::move(pIndexPath)} {
+        std::ifstream stream{indexPath, std::ios::binary};
+        if (!stream)
+            return;
+
+        if (ReadValue<u32>(stream) != Magic || ReadValue<u32>(stream) != Version)
+            return; // An index from an older version is discarded and rebuilt from scratch
+
+        auto entryCount{ReadValue<u32>(stream)};
+        for (u32 index{}; index < entryCount; index++) {
+            Key key{
+                .path = ReadBuffer<std::string>(stream),
+                .size = ReadValue<u64>(stream),
+                .modificationTime = ReadValue<i64>(stream),
+                .language = ReadValue<u32>(stream),
+            };
+            Entry entry{
+                .applicationName = ReadBuffer<std::string>(stream),
+                .applicationVersion = ReadBuffer<std::string>(stream),
+                .applicationTitleId = ReadBuffer<std::string>(stream),
+                .applicationAuthor = ReadBuffer<std::string>(stream),
+                .icon = ReadBuffer<std::vector<u8>>(stream),
+            };
+
+            if (!stream) {
+                Logger::Warn("Metadata index at '{}' is truncated, discarding it", indexPath);
+                entries.clear();
+                return;
+            }
+
+            auto path{key.path};
+            entries.emplace(std::move(path), std::make_pair(std::move(key), std::move(entry)));
+        }
+    }
+
+    std::optional<MetadataIndex::Entry> MetadataIndex::Lookup(const Key &key) {
+        std::scoped_lock lock{mutex};
+        accessedPaths.insert(key.path);
+
+        auto it{entries.find(key.path)};
+        if (it == entries.end() || it->second.first != key)
+            return std::nullopt;
+        return it->second.second;
+    }
+
+    void MetadataIndex::Insert(const Key &key, Entry entry) {
+        std::scoped_lock lock{mutex};
+        accessedPaths.insert(key.path);
+        entries.insert_or_assign(key.path, std::make_pair(key, std::move(entry)));
+        dirty = true;
+    }
+
+    void MetadataIndex::Flush() {
+        std::scoped_lock lock{mutex};
+        dirty |= std::erase_if(entries, [&](const auto &entry) { return !accessedPaths.contains(entry.first); }) != 0;
+        accessedPaths.clear();
+        if (!dirty)
+            return;
+
+        // The index is written to a temporary file which is renamed over the prior index so a partially written index is never read
+        auto temporaryPath{indexPath + ".tmp"};
+        std::ofstream stream{temporaryPath, std::ios::binary | std::ios::trunc};
+        WriteValue(stream, Magic);
+        WriteValue(stream, Version);
+        WriteValue(stream, static_cast<u32>(entries.size()));
+        for (const auto &[path, value] : entries) {
+            const auto &[key, entry]{value};
+            WriteBuffer(stream, key.path);
+            WriteValue(stream, key.size);
+            WriteValue(stream, key.modificationTime);
+            WriteValue(stream, key.language);
+            WriteBuffer(stream, entry.applicationName);
+            WriteBuffer(stream, entry.applicationVersion);
+            WriteBuffer(stream, entry.applicationTitleId);
+            WriteBuffer(stream, entry.applicationAuthor);
+            WriteBuffer(stream, entry.icon);
+        }
+        stream.close();
+
+        if (stream.fail() || std::rename(temporaryPath.c_str(), indexPath.c_str())) {
+            Logger::Warn("Failed to write out the metadata index to '{}'", indexPath);
+            std::remove(temporaryPath.c_str());
+            return;
+        }
+        dirty = false;
+    }
+
+    std::shared_ptr<MetadataIndex> MetadataIndex::Get(const std::string &indexPath) {
+        static std::mutex indexMutex;
+        static std::shared_ptr<MetadataIndex> index;
+
+        std::scoped_lock lock{indexMutex};
+        if (!index || index->indexPath != indexPath)
+            index = std::make_shared<MetadataIndex>(indexPath);
+        return index;
+    }
+}
@@ -0,0 +1,68 @@
+// SPDX-License-Identifier: MPL-2.0
+// Copyright © 2023 Skyline Team and Contributors (https://github.com/skyline-emu/)
+
+#pragma once
+
+#include <unordered_set>
+#include <common.h>
+
+namespace skyline::loader {
+    /**
+     * @brief A persistent index of the metadata of ROM files, this allows refreshing the game list without parsing (and decrypting) every ROM again
+     * @details Entries are keyed by the path of the ROM alongside its size and modification time, a ROM which was modified or replaced misses the index and is parsed again
+     * @note All accesses are thread-safe so ROMs can be looked up and inserted from multiple threads in parallel
+     */
+    class MetadataIndex {
+      public:
+        struct Key {
+            std::string path;
+            u64 size;
+            i64 modificationTime; //!< The modification time of the ROM in nanoseconds
+            u32 language; //!< The system language the metadata was read in, the application name and publisher depend on it
+
+            bool operator==(const Key &) const = default;
+        };
+
+        struct Entry {
+            std::string applicationName;
+            std::string applicationVersion;
+            std::string applicationTitleId;
+            std::string applicationAuthor;
+            std::vector<u8> icon;
+        };
+
+      private:
+        static constexpr u32 Magic{util::MakeMagic<u32>("SKMI")};
+        static constexpr u32 Version{1}; //!< The version of the index format, this must be incremented after any changes to it
+
+        std::string indexPath;
+        std::mutex mutex;
+        std::unordered_map<std::string, std::pair<Key, Entry>> entries; //!< A map from the path of every indexed ROM to its key and metadata
+        std::unordered_set<std::string> accessedPaths; //!< The paths of all ROMs that were looked up or inserted since the index was loaded
+        bool dirty{}; //!< If the index was modified since it was loaded or last written out
+
+      public:
+        /**
+         * @brief Loads the index from the supplied path, a missing or invalid index is treated as an empty one
+         */
+        MetadataIndex(std::string indexPath);
+
+        /**
+         * @return The metadata of the ROM with the supplied key if it's in the index
+         */
+        std::optional<Entry> Lookup(const Key &key);
+
+        void Insert(const Key &key, Entry entry);
+
+        /**
+         * @brief Writes the index out to disk if it was modified, any entries for ROMs that weren't accessed since the index was loaded are dropped
+         * @note This should only be called after the entire library was scanned as ROMs that weren't accessed are assumed to have been removed
+         */
+        void Flush();
+
+        /**
+         * @return The index at the supplied path, it's loaded on the first call and shared between all further calls
+         */
+        static std::shared_ptr<MetadataIndex> Get(const std::string &indexPath);
+    };
+}
@@ -3,6 +3,7 @@
 
 #include <kernel/types/KProcess.h>
 #include <vfs/npdm.h>
+#include <vfs/cnmt.h>
 #include "nso.h"
 #include "nca.h"
 
@@ -12,6 +13,63 @@ namespace skyline::loader {
             throw exception("Only NCAs with an ExeFS can be loaded directly");
     }
 
+    void NcaLoader::OpenApplicationNcas(const std::shared_ptr<vfs::FileSystem> &container, const std::shared_ptr<crypto::KeyStore> &keyStore, bool useKeyArea, std::optional<vfs::NCA> &programNca, std::optional<vfs::NCA> &controlNca) {
+        auto openNca{[&](const std::string &name) {
+            auto nca{vfs::NCA(container->OpenFile(name), keyStore, useKeyArea)};
+
+            if (nca.contentType == vfs::NcaContentType::Program && nca.romFs != nullptr && nca.exeFs != nullptr)
+                programNca = std::move(nca);
+            else if (nca.contentType == vfs::NcaContentType::Control && nca.romFs != nullptr)
+                controlNca = std::move(nca);
+        }};
+
+        std::vector<std::string> ncaNames;
+        for (const auto &entry : container->OpenDirectory("", {false, true})->Read())
+            if (entry.name.ends_with(".nca"))
+                ncaNames.push_back(entry.name);
+
+        // Containers with updates or DLC hold several meta NCAs, only the application's one references the NCAs that are required for booting
+        for (const auto &name : ncaNames) {
+            if (!name.ends_with(".cnmt.nca"))
+                continue;
+
+            try {
+                vfs::NCA metaNca{container->OpenFile(name), keyStore, useKeyArea};
+                if (!metaNca.cnmt)
+                    continue;
+
+                vfs::CNMT cnmt{metaNca.cnmt};
+                if (cnmt.GetContentMetaType() != vfs::CNMT::ContentMetaType::Application)
+                    continue;
+
+                auto programName{cnmt.GetContentFileName(vfs::CNMT::ContentType::Program)}, controlName{cnmt.GetContentFileName(vfs::CNMT::ContentType::Control)};
+                if (programName && controlName && container->FileExists(*programName) && container->FileExists(*controlName)) {
+                    openNca(*programName);
+                    openNca(*controlName);
+                    if (programNca && controlNca)
+                        return;
+                }
+            } catch (const loader_exception &e) {
+                throw loader_exception(e.error);
+            } catch (const std::exception &e) {
+                Logger::Warn("Failed to use the CNMT in '{}': {}", name, e.what());
+            }
+            break;
+        }
+
+        programNca.reset();
+        controlNca.reset();
+        for (const auto &name : ncaNames) {
+            try {
+                openNca(name);
+            } catch (const loader_exception &e) {
+                throw loader_exception(e.error);
+            } catch (const std::exception &e) {
+                continue;
+            }
+        }
+    }
+
     void *NcaLoader::LoadExeFs(Loader *loader, const std::shared_ptr<vfs::FileSystem> &exeFs, const std::shared_ptr<kernel::type::KProcess> &process, const DeviceState &state) {
         if (exeFs == nullptr)
             throw exception("Cannot load a null ExeFS");
@@ -19,24 +77,28 @@ namespace skyline::loader {
         if (!exeFs->FileExists("rtld"))
             throw exception("Cannot load an ExeFS that doesn't contain rtld");
 
-        auto nsoFile{exeFs->OpenFile("rtld")};
+        // Every NSO is decompressed and scanned in parallel, only placing them in the address space needs to be done sequentially as each one's offset depends on the size of the prior ones
+        BS::thread_pool pool;
+        std::vector<std::pair<std::string, std::future<Executable>>> nsos;
+        nsos.emplace_back("rtld", NsoLoader::ReadNso(pool, exeFs->OpenFile("rtld"), state));
+        for (const auto &nso : {"main", "subsdk0", "subsdk1", "subsdk2", "subsdk3", "subsdk4", "subsdk5", "subsdk6", "subsdk7", "sdk"})
+            if (exeFs->FileExists(nso))
+                nsos.emplace_back(nso, NsoLoader::ReadNso(pool, exeFs->OpenFile(nso), state));
 
         state.process->memory.InitializeVmm(process->npdm.meta.flags.type);
 
-        auto loadInfo{NsoLoader::LoadNso(loader, nsoFile, process, state, 0, "rtld.nso")};
-        u64 offset{loadInfo.size};
-        u8 *base{loadInfo.base};
-        void *entry{loadInfo.entry};
-
-        Logger::Info("Loaded 'rtld.nso' at 0x{:X} (.text @ 0x{:X})", base, entry);
-
-        for (const auto &nso : {"main", "subsdk0", "subsdk1", "subsdk2", "subsdk3", "subsdk4", "subsdk5", "subsdk6", "subsdk7", "sdk"}) {
-            if (exeFs->FileExists(nso))
-                nsoFile = exeFs->OpenFile(nso);
-            else
-                continue;
+        u64 offset{};
+        u8 *base{};
+        void *entry{};
+        for (auto &[nso, future] : nsos) {
+            auto executable{future.get()};
+            bool isRtld{nso == "rtld"};
+            auto loadInfo{loader->LoadExecutable(process, state, executable, offset, nso + ".nso", !isRtld)};
+            if (isRtld) {
+                base = loadInfo.base;
+                entry = loadInfo.entry;
+            }
 
-            loadInfo = NsoLoader::LoadNso(loader, nsoFile, process, state, offset, nso + std::string(".nso"), true);
             Logger::Info("Loaded '{}.nso' at 0x{:X} (.text @ 0x{:X})", nso, base + offset, loadInfo.entry);
             offset += loadInfo.size;
         }
@@ -18,6 +18,13 @@ namespace skyline::loader {
       public:
         NcaLoader(std::shared_ptr<vfs::Backing> backing, std::shared_ptr<crypto::KeyStore> keyStore);
 
+        /**
+         * @brief Opens the program and control NCAs of an application in a container such as an NSP or an XCI partition
+         * @details The CNMT in the container's meta NCA is used to find them so no other NCAs are opened, every NCA is scanned if there's no usable CNMT
+         * @param useKeyArea If the key area should be used to decrypt the NCAs rather than a title key
+         */
+        static void OpenApplicationNcas(const std::shared_ptr<vfs::FileSystem> &container, const std::shared_ptr<crypto::KeyStore> &keyStore, bool useKeyArea, std::optional<vfs::NCA> &programNca, std::optional<vfs::NCA> &controlNca);
+
         /**
          * @brief Loads an ExeFS into memory and processes it accordingly for execution
          * @param exefs A filesystem object containing the ExeFS filesystem to load into memory
@@ -37,24 +37,28 @@ namespace skyline::loader {
         return buffer;
     }
 
-    std::vector<u8> NroLoader::GetSegment(const NroSegmentHeader &segment) {
-        std::vector<u8> buffer(segment.size);
-
-        backing->Read(buffer, segment.offset);
-        return buffer;
+    Executable::Segment NroLoader::GetSegment(const NroSegmentHeader &segment, size_t offset) {
+        Executable::Segment result{
+            .size = segment.size,
+            .offset = offset,
+        };
+
+        if (auto view{backing->GetView(segment.offset, segment.size)}; view.valid()) {
+            result.view = view;
+        } else {
+            result.storage.resize(segment.size);
+            backing->Read(result.storage, segment.offset);
+        }
+        return result;
     }
 
     void *NroLoader::LoadProcessData(const std::shared_ptr<kernel::type::KProcess> &process, const DeviceState &state) {
         Executable executable{};
 
-        executable.text.contents = GetSegment(header.text);
-        executable.text.offset = 0;
-
-        executable.ro.contents = GetSegment(header.ro);
-        executable.ro.offset = header.text.size;
-
-        executable.data.contents = GetSegment(header.data);
-        executable.data.offset = header.text.size + header.ro.size;
+        executable.text = GetSegment(header.text, 0);
+        executable.ro = GetSegment(header.ro, header.text.size);
+        executable.data = GetSegment(header.data, header.text.size + header.ro.size);
+        executable.backing = backing;
 
         executable.bssSize = header.bssSize;
 
@@ -63,11 +63,12 @@ namespace skyline::loader {
         std::shared_ptr<vfs::Backing> backing;
 
         /**
-         * @brief Reads the data of the specified segment
+         * @brief Reads the data of the specified segment, it's viewed directly in the backing rather than being read when possible
          * @param segment The header of the segment to read
-         * @return A buffer containing the data of the requested segment
+         * @param offset The offset from the base address to load the segment at
+         * @return The requested segment
          */
-        std::vector<u8> GetSegment(const NroSegmentHeader &segment);
+        Executable::Segment GetSegment(const NroSegmentHeader &segment, size_t offset);
 
       public:
         NroLoader(std::shared_ptr<vfs::Backing> backing);
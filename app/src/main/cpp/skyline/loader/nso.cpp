@@ -14,48 +14,93 @@ namespace skyline::loader {
             throw exception("Invalid NSO magic! 0x{0:X}", magic);
     }
 
-    std::vector<u8> NsoLoader::GetSegment(const std::shared_ptr<vfs::Backing> &backing, const NsoSegmentHeader &segment, u32 compressedSize) {
-        std::vector<u8> outputBuffer(segment.decompressedSize);
+    Executable::Segment NsoLoader::ReadSegment(const std::shared_ptr<vfs::Backing> &backing, const NsoSegmentHeader &header, u32 compressedSize, bool pageAlign) {
+        Executable::Segment segment{
+            .size = pageAlign ? util::AlignUp(header.decompressedSize, constant::PageSize) : header.decompressedSize,
+            .offset = header.memoryOffset,
+        };
+
+        size_t readSize{compressedSize ? compressedSize : header.decompressedSize};
+        backing->Advise(vfs::Backing::AccessPattern::Sequential, header.fileOffset, readSize);
+
+        // Compressed segments are decompressed straight from a view of the backing and uncompressed segments are copied straight from it into guest memory when possible
+        if (auto view{backing->GetView(header.fileOffset, readSize)}; view.valid()) {
+            segment.view = view;
+            return segment;
+        }
 
-        if (compressedSize) {
-            std::vector<u8> compressedBuffer(compressedSize);
-            backing->Read(compressedBuffer, segment.fileOffset);
+        segment.storage.resize(readSize);
+        backing->Read(segment.storage, header.fileOffset);
+        return segment;
+    }
 
-            LZ4_decompress_safe(reinterpret_cast<char *>(compressedBuffer.data()), reinterpret_cast<char *>(outputBuffer.data()), static_cast<int>(compressedSize), static_cast<int>(segment.decompressedSize));
-        } else {
-            backing->Read(outputBuffer, segment.fileOffset);
-        }
+    void NsoLoader::DecompressSegment(Executable::Segment &segment, const NsoSegmentHeader &header, u32 compressedSize) {
+        if (!compressedSize)
+            return;
 
-        return outputBuffer;
+        std::vector<u8> outputBuffer(segment.size);
+        LZ4_decompress_safe(reinterpret_cast<char *>(segment.Contents().data()), reinterpret_cast<char *>(outputBuffer.data()), static_cast<int>(compressedSize), static_cast<int>(header.decompressedSize));
+        segment.storage = std::move(outputBuffer);
+        segment.view = {};
     }
 
-    Loader::ExecutableLoadInfo NsoLoader::LoadNso(Loader *loader, const std::shared_ptr<vfs::Backing> &backing, const std::shared_ptr<kernel::type::KProcess> &process, const DeviceState &state, size_t offset, const std::string &name, bool dynamicallyLinked) {
+    std::future<Executable> NsoLoader::ReadNso(BS::thread_pool &pool, const std::shared_ptr<vfs::Backing> &backing, const DeviceState &state) {
         auto header{backing->Read<NsoHeader>()};
 
         if (header.magic != util::MakeMagic<u32>("NSO0"))
             throw exception("Invalid NSO magic! 0x{0:X}", header.magic);
 
-        Executable executable{};
-
-        executable.text.contents = GetSegment(backing, header.text, header.flags.textCompressed ? header.textCompressedSize : 0);
-        executable.text.contents.resize(util::AlignUp(executable.text.contents.size(), constant::PageSize));
-        executable.text.offset = header.text.memoryOffset;
-
-        executable.ro.contents = GetSegment(backing, header.ro, header.flags.roCompressed ? header.roCompressedSize : 0);
-        executable.ro.contents.resize(util::AlignUp(executable.ro.contents.size(), constant::PageSize));
-        executable.ro.offset = header.ro.memoryOffset;
-
-        executable.data.contents = GetSegment(backing, header.data, header.flags.dataCompressed ? header.dataCompressedSize : 0);
-        executable.data.offset = header.data.memoryOffset;
-
-        // Data and BSS are aligned together
-        executable.bssSize = util::AlignUp(executable.data.contents.size() + header.bssSize, constant::PageSize) - executable.data.contents.size();
-
-        if (header.dynsym.offset + header.dynsym.size <= header.ro.decompressedSize && header.dynstr.offset + header.dynstr.size <= header.ro.decompressedSize) {
-            executable.dynsym = {header.dynsym.offset, header.dynsym.size};
-            executable.dynstr = {header.dynstr.offset, header.dynstr.size};
-        }
+        u32 textCompressedSize{header.flags.textCompressed ? header.textCompressedSize : 0};
+        u32 roCompressedSize{header.flags.roCompressed ? header.roCompressedSize : 0};
+        u32 dataCompressedSize{header.flags.dataCompressed ? header.dataCompressedSize : 0};
+
+        // .text is scanned in the same task that decompresses it as the scan can't start any earlier and that avoids blocking a worker on another task
+        auto text{pool.submit([&state, backing, header, textCompressedSize, segment = ReadSegment(backing, header.text, textCompressedSize, true)]() mutable {
+            Executable executable{};
+            DecompressSegment(segment, header.text, textCompressedSize);
+            executable.text = std::move(segment);
+            executable.backing = backing;
+
+            executable.buildId = header.buildId;
+            struct {
+                NsoSegmentHeader text, ro, data;
+                u32 textCompressedSize, roCompressedSize, dataCompressedSize;
+            } segmentHeaders{header.text, header.ro, header.data, header.textCompressedSize, header.roCompressedSize, header.dataCompressedSize};
+            executable.headerHash = XXH64(&segmentHeaders, sizeof(segmentHeaders), 0);
+
+            ScanPatches(state, executable);
+            return executable;
+        })};
+        auto ro{pool.submit([backing, header, roCompressedSize, segment = ReadSegment(backing, header.ro, roCompressedSize, true)]() mutable {
+            DecompressSegment(segment, header.ro, roCompressedSize);
+            return std::move(segment);
+        })};
+        auto data{pool.submit([backing, header, dataCompressedSize, segment = ReadSegment(backing, header.data, dataCompressedSize, false)]() mutable {
+            DecompressSegment(segment, header.data, dataCompressedSize);
+            return std::move(segment);
+        })};
+
+        return std::async(std::launch::deferred, [header, text = std::move(text), ro = std::move(ro), data = std::move(data)]() mutable {
+            auto executable{text.get()};
+
+            executable.ro = ro.get();
+            executable.data = data.get();
+
+            // Data and BSS are aligned together
+            executable.bssSize = util::AlignUp(executable.data.size + header.bssSize, constant::PageSize) - executable.data.size;
+
+            if (header.dynsym.offset + header.dynsym.size <= header.ro.decompressedSize && header.dynstr.offset + header.dynstr.size <= header.ro.decompressedSize) {
+                executable.dynsym = {header.dynsym.offset, header.dynsym.size};
+                executable.dynstr = {header.dynstr.offset, header.dynstr.size};
+            }
+
+            return executable;
+        });
+    }
 
+    Loader::ExecutableLoadInfo NsoLoader::LoadNso(Loader *loader, const std::shared_ptr<vfs::Backing> &backing, const std::shared_ptr<kernel::type::KProcess> &process, const DeviceState &state, size_t offset, const std::string &name, bool dynamicallyLinked) {
+        BS::thread_pool pool{3}; // One thread for each segment
+        auto executable{ReadNso(pool, backing, state).get()};
         return loader->LoadExecutable(process, state, executable, offset, name, dynamicallyLinked);
     }
 
@@ -3,6 +3,8 @@
 
 #pragma once
 
+#include <future>
+#include <BS_thread_pool.hpp>
 #include "loader.h"
 
 namespace skyline::loader {
@@ -70,16 +72,29 @@ namespace skyline::loader {
         static_assert(sizeof(NsoHeader) == 0x100);
 
         /**
-         * @brief Reads the specified segment from the backing and decompresses it if needed
-         * @param segment The header of the segment to read
+         * @brief Reads the specified segment from the backing as it's stored, it's viewed directly in the backing rather than being read when possible
+         * @param header The header of the segment to read
          * @param compressedSize The compressed size of the segment, 0 if the segment is not compressed
-         * @return A buffer containing the data of the requested segment
+         * @param pageAlign If the segment should be padded to a page boundary
+         * @return The segment with its raw data as contents, this must be passed to DecompressSegment
          */
-        static std::vector<u8> GetSegment(const std::shared_ptr<vfs::Backing> &backing, const NsoSegmentHeader &segment, u32 compressedSize);
+        static Executable::Segment ReadSegment(const std::shared_ptr<vfs::Backing> &backing, const NsoSegmentHeader &header, u32 compressedSize, bool pageAlign);
+
+        /**
+         * @brief Decompresses the contents of a segment read by ReadSegment if it's compressed
+         */
+        static void DecompressSegment(Executable::Segment &segment, const NsoSegmentHeader &header, u32 compressedSize);
 
       public:
         NsoLoader(std::shared_ptr<vfs::Backing> backing);
 
+        /**
+         * @brief Reads an NSO from the backing, its segments are decompressed in parallel on the supplied pool alongside .text being scanned for NCE patches
+         * @note The backing is only read from on the calling thread as backings aren't guaranteed to be thread-safe
+         * @return A deferred future which waits on all segments when the executable is retrieved from it, it must not be waited on by a task on the same pool
+         */
+        static std::future<Executable> ReadNso(BS::thread_pool &pool, const std::shared_ptr<vfs::Backing> &backing, const DeviceState &state);
+
         /**
          * @brief Loads an NSO into memory, offset by the given amount
          * @param backing The backing that the NSO is contained within
@@ -1,6 +1,8 @@
 // SPDX-License-Identifier: MPL-2.0
 // Copyright © 2020 Skyline Team and Contributors (https://github.com/skyline-emu/)
 
+#include <os.h>
+#include <common/settings.h>
 #include <kernel/types/KProcess.h>
 #include <vfs/ticket.h>
 #include "nca.h"
@@ -25,24 +27,7 @@ namespace skyline::loader {
     NspLoader::NspLoader(const std::shared_ptr<vfs::Backing> &backing, const std::shared_ptr<crypto::KeyStore> &keyStore) : nsp(std::make_shared<vfs::PartitionFileSystem>(backing)) {
         ExtractTickets(nsp, keyStore);
 
-        auto root{nsp->OpenDirectory("", {false, true})};
-        for (const auto &entry : root->Read()) {
-            if (entry.name.substr(entry.name.find_last_of('.') + 1) != "nca")
-                continue;
-
-            try {
-                auto nca{vfs::NCA(nsp->OpenFile(entry.name), keyStore)};
-
-                if (nca.contentType == vfs::NcaContentType::Program && nca.romFs != nullptr && nca.exeFs != nullptr)
-                    programNca = std::move(nca);
-                else if (nca.contentType == vfs::NcaContentType::Control && nca.romFs != nullptr)
-                    controlNca = std::move(nca);
-            } catch (const loader_exception &e) {
-                throw loader_exception(e.error);
-            } catch (const std::exception &e) {
-                continue;
-            }
-        }
+        NcaLoader::OpenApplicationNcas(nsp, keyStore, false, programNca, controlNca);
 
         if (!programNca || !controlNca)
             throw exception("Incomplete NSP file");
@@ -53,6 +38,16 @@ namespace skyline::loader {
     }
 
     void *NspLoader::LoadProcessData(const std::shared_ptr<kernel::type::KProcess> &process, const DeviceState &state) {
+        if (*state.settings->verifyRomFsIntegrity) {
+            programNca->VerifyRomFsIntegrity();
+            romFs = programNca->romFs;
+        }
+
+        if (*state.settings->cacheDecryptedNca) {
+            programNca->UseDecryptedContainer(state.os->privateAppFilesPath + "cache/decrypted_nca/");
+            romFs = programNca->romFs;
+        }
+
         process->npdm = vfs::NPDM(programNca->exeFs->OpenFile("main.npdm"));
         return NcaLoader::LoadExeFs(this, programNca->exeFs, process, state);
     }
@@ -2,6 +2,8 @@
 // Copyright © 2021 Skyline Team and Contributors (https://github.com/skyline-emu/)
 
 #include <common.h>
+#include <os.h>
+#include <common/settings.h>
 #include <kernel/types/KProcess.h>
 #include <vfs/region_backing.h>
 #include "nca.h"
@@ -29,28 +31,10 @@ namespace skyline::loader {
                 logo = entryDir;
         }
 
-        if (secure) {
-            root = secure->OpenDirectory("", {false, true});
-            for (const auto &entry : root->Read()) {
-                if (entry.name.substr(entry.name.find_last_of('.') + 1) != "nca")
-                    continue;
-
-                try {
-                    auto nca{vfs::NCA(secure->OpenFile(entry.name), keyStore, true)};
-
-                    if (nca.contentType == vfs::NcaContentType::Program && nca.romFs != nullptr && nca.exeFs != nullptr)
-                        programNca = std::move(nca);
-                    else if (nca.contentType == vfs::NcaContentType::Control && nca.romFs != nullptr)
-                        controlNca = std::move(nca);
-                } catch (const loader_exception &e) {
-                    throw loader_exception(e.error);
-                } catch (const std::exception &e) {
-                    continue;
-                }
-            }
-        } else {
+        if (!secure)
             throw exception("Corrupted secure partition");
-        }
+
+        NcaLoader::OpenApplicationNcas(secure, keyStore, true, programNca, controlNca);
 
         if (!programNca || !controlNca)
             throw exception("Incomplete XCI file");
@@ -61,6 +45,16 @@ namespace skyline::loader {
     }
 
     void *XciLoader::LoadProcessData(const std::shared_ptr<kernel::type::KProcess> &process, const DeviceState &state) {
+        if (*state.settings->verifyRomFsIntegrity) {
+            programNca->VerifyRomFsIntegrity();
+            romFs = programNca->romFs;
+        }
+
+        if (*state.settings->cacheDecryptedNca) {
+            programNca->UseDecryptedContainer(state.os->privateAppFilesPath + "cache/decrypted_nca/");
+            romFs = programNca->romFs;
+        }
+
         process->npdm = vfs::NPDM(programNca->exeFs->OpenFile("main.npdm"));
         return NcaLoader::LoadExeFs(this, programNca->exeFs, process, state);
     }
@@ -3,6 +3,9 @@
 
 #include <cxxabi.h>
 #include <unistd.h>
+#include <arm_neon.h>
+#include <filesystem>
+#include <fstream>
 #include "common/signal.h"
 #include "common/trace.h"
 #include "os.h"
@@ -114,6 +117,12 @@ namespace skyline::nce {
                         TRACE_EVENT_END("hook");
                     }
                 },
+                [&](const hle::NativeOverrideHook &) {
+                    throw exception("Native override hooks don't call into the hook handler: {}", hookedSymbol.prettyName);
+                },
+                [&](const hle::DirectOverrideHook &) {
+                    throw exception("Direct override hooks don't call into the hook handler: {}", hookedSymbol.prettyName);
+                },
             }, hookedSymbol.hook);
 
             while (kernel::Scheduler::YieldPending) [[unlikely]] {
@@ -250,6 +259,9 @@ namespace skyline::nce {
     NCE::NCE(const DeviceState &state) : state(state) {
         signal::SetTlsRestorer(&NceTlsRestorer);
         staticNce = this;
+
+        if (writeTracker.IsSupported())
+            Logger::Debug("Tracking writes to trapped memory without faulting");
     }
 
     NCE::~NCE() {
@@ -260,8 +272,9 @@ namespace skyline::nce {
 
     /**
      * @brief Writes a trampoline to the given target address that saves the current context and calls the given function
+     * @param contextArgument If the Skyline TLS should be passed as the first argument rather than the second, this adds an instruction to the trampoline
      */
-    u32 *WriteTrampoline(u32 *code, u64 target) {
+    u32 *WriteTrampoline(u32 *code, u64 target, bool contextArgument = false) {
         /* Hook Trampoline */
         /* Store LR in 16B of pre-allocated stack */
         *code++ = 0xF90007FE; // STR LR, [SP, #8]
@@ -279,6 +292,9 @@ namespace skyline::nce {
         /* Store Skyline TLS + guest SP on stack */
         *code++ = 0xA9BF0BE1; // STP X1, X2, [SP, #-16]!
 
+        if (contextArgument)
+            *code++ = instructions::Mov(registers::X0, registers::X1).raw; // Pass the Skyline TLS as the sole argument
+
         /* Jump to SvcHandler */
         for (const auto &mov : instructions::MoveRegister(registers::X2, target)) {
             if (mov)
@@ -354,21 +370,46 @@ namespace skyline::nce {
     constexpr u32 CntvctEl0{0x5F02};        // ID of CNTVCT_EL0 in MRS
     constexpr u32 TegraX1Freq{19200000};    // The clock frequency of the Tegra X1 (19.2 MHz)
 
-    NCE::PatchData NCE::GetPatchData(const std::vector<u8> &text) {
+    constexpr size_t SvcTrampolineSize{7}; //!< The size of a per-SVC trampoline into the SVC handler in 32-bit ARMv8 instructions
+
+    /* SVCs which are implemented entirely in the patch section as they're frequently called and trivial */
+    constexpr u16 SvcGetCurrentProcessorNumber{0x10};
+    constexpr u16 SvcGetSystemTick{0x1E};
+    constexpr u16 SvcGetThreadId{0x25};
+    constexpr size_t GetCurrentProcessorNumberSize{4}; //!< The size of the GetCurrentProcessorNumber fast path in 32-bit ARMv8 instructions
+    constexpr size_t GetThreadIdFastSize{7}; //!< The size of the GetThreadId fast path in 32-bit ARMv8 instructions, it's followed by a trampoline for non-pseudo handles
+
+    /**
+     * @return The size of the patch for an SVC in 32-bit ARMv8 instructions
+     */
+    constexpr size_t GetSvcPatchSize(u16 svc, bool rescaleClock) {
+        switch (svc) {
+            case SvcGetCurrentProcessorNumber:
+                return GetCurrentProcessorNumberSize;
+            case SvcGetSystemTick:
+                return rescaleClock ? RescaleClockSize + 3 : 2;
+            case SvcGetThreadId:
+                return GetThreadIdFastSize + SvcTrampolineSize;
+            default:
+                return SvcTrampolineSize;
+        }
+    }
+
+    NCE::PatchData NCE::GetPatchData(span<u8> text) {
         size_t size{guest::SaveCtxSize + guest::LoadCtxSize + TrampolineSize};
         std::vector<size_t> offsets;
 
         bool rescaleClock{util::ClockFrequency != TegraX1Freq};
 
         auto start{reinterpret_cast<const u32 *>(text.data())}, end{reinterpret_cast<const u32 *>(text.data() + text.size())};
-        for (const u32 *instruction{start}; instruction < end; instruction++) {
+        auto scanInstruction{[&](const u32 *instruction) __attribute__((always_inline)) {
             auto svc{*reinterpret_cast<const instructions::Svc *>(instruction)};
             auto mrs{*reinterpret_cast<const instructions::Mrs *>(instruction)};
             auto msr{*reinterpret_cast<const instructions::Msr *>(instruction)};
             auto instructionOffset{static_cast<size_t>(instruction - start)};
 
             if (svc.Verify()) {
-                size += 7;
+                size += GetSvcPatchSize(static_cast<u16>(svc.value), rescaleClock);
                 offsets.push_back(instructionOffset);
             } else if (mrs.Verify()) {
                 if (mrs.srcReg == TpidrroEl0 || mrs.srcReg == TpidrEl0) {
@@ -391,11 +432,87 @@ namespace skyline::nce {
                 size += 6;
                 offsets.push_back(instructionOffset);
             }
+        }};
+
+        // The vast majority of instructions aren't SVC/MRS/MSR, so 8 instructions are filtered at a time using the fixed opcode bits and only blocks with a candidate are precisely decoded
+        // SVC: 0b11010100000 (imm16) 00001, MRS/MSR: 0b1101010100 (L) 1 (sysreg) (Rt) where the filter covers both directions by ignoring the L bit
+        constexpr u32 SvcMask{0xFFE0001F}, SvcValue{0xD4000001};
+        constexpr u32 SysRegMask{0xFFD00000}, SysRegValue{0xD5100000};
+        const uint32x4_t svcMask{vdupq_n_u32(SvcMask)}, svcValue{vdupq_n_u32(SvcValue)};
+        const uint32x4_t sysRegMask{vdupq_n_u32(SysRegMask)}, sysRegValue{vdupq_n_u32(SysRegValue)};
+
+        const u32 *instruction{start};
+        for (; instruction + 8 <= end; instruction += 8) {
+            uint32x4_t low{vld1q_u32(instruction)}, high{vld1q_u32(instruction + 4)};
+            uint32x4_t lowMatch{vorrq_u32(vceqq_u32(vandq_u32(low, svcMask), svcValue), vceqq_u32(vandq_u32(low, sysRegMask), sysRegValue))};
+            uint32x4_t highMatch{vorrq_u32(vceqq_u32(vandq_u32(high, svcMask), svcValue), vceqq_u32(vandq_u32(high, sysRegMask), sysRegValue))};
+            if (vmaxvq_u32(vorrq_u32(lowMatch, highMatch))) [[unlikely]]
+                for (const u32 *candidate{instruction}; candidate < instruction + 8; candidate++)
+                    scanInstruction(candidate);
         }
+
+        for (; instruction < end; instruction++)
+            scanInstruction(instruction);
+
         return {util::AlignUp(size * sizeof(u32), constant::PageSize), offsets};
     }
 
-    void NCE::PatchCode(std::vector<u8> &text, u32 *patch, size_t patchSize, const std::vector<size_t> &offsets, size_t textOffset) {
+    /**
+     * @brief The header of a patch cache file, it's followed by the patch offsets
+     */
+    struct PatchCacheHeader {
+        static constexpr u32 Magic{util::MakeMagic<u32>("NCEP")};
+        static constexpr u32 Version{3}; //!< The version of the patch cache format, this must be incremented whenever the patching logic in GetPatchData changes
+
+        u32 magic{Magic};
+        u32 version{Version};
+        u64 hash; //!< A hash of the executable contents alongside any state which affects the patch data
+        u64 patchSize;
+        u64 offsetCount;
+    };
+
+    NCE::PatchData NCE::GetPatchData(span<u8> text, const std::string &cachePath, u64 contentHash) {
+        // The offsets depend on if the clock needs to be rescaled which is host-specific, so it's part of the hash alongside the size of .text
+        struct {
+            u64 contentHash;
+            u64 textSize;
+            u64 rescaleClock;
+        } hashInput{contentHash, text.size(), util::ClockFrequency != TegraX1Freq};
+        u64 hash{XXH64(&hashInput, sizeof(hashInput), 0)};
+
+        std::ifstream inputStream{cachePath, std::ios::binary};
+        if (inputStream.good()) {
+            PatchCacheHeader header{};
+            inputStream.read(reinterpret_cast<char *>(&header), sizeof(PatchCacheHeader));
+            if (inputStream.good() && header.magic == PatchCacheHeader::Magic && header.version == PatchCacheHeader::Version && header.hash == hash && header.offsetCount <= text.size() / sizeof(u32)) {
+                PatchData patch{header.patchSize, std::vector<size_t>(header.offsetCount)};
+                inputStream.read(reinterpret_cast<char *>(patch.offsets.data()), static_cast<std::streamsize>(patch.offsets.size() * sizeof(size_t)));
+                // The offsets are used to directly index into .text, so they're bounds checked in case the cache file was corrupted
+                if (inputStream.good() && std::all_of(patch.offsets.begin(), patch.offsets.end(), [&](size_t offset) { return offset < text.size() / sizeof(u32); }))
+                    return patch;
+            }
+            Logger::Info("Discarding stale NCE patch cache: {}", cachePath);
+        }
+        inputStream.close();
+
+        auto patch{GetPatchData(text)};
+
+        std::filesystem::create_directories(std::filesystem::path{cachePath}.parent_path());
+        std::ofstream outputStream{cachePath, std::ios::binary | std::ios::trunc};
+        PatchCacheHeader header{
+            .hash = hash,
+            .patchSize = patch.size,
+            .offsetCount = patch.offsets.size(),
+        };
+        outputStream.write(reinterpret_cast<const char *>(&header), sizeof(PatchCacheHeader));
+        outputStream.write(reinterpret_cast<const char *>(patch.offsets.data()), static_cast<std::streamsize>(patch.offsets.size() * sizeof(size_t)));
+        if (!outputStream.good()) [[unlikely]]
+            Logger::Warn("Failed to write NCE patch cache: {}", cachePath);
+
+        return patch;
+    }
+
+    void NCE::PatchCode(span<u8> text, u32 *patch, size_t patchSize, const std::vector<size_t> &offsets, size_t textOffset) {
         u32 *start{patch};
         u32 *end{patch + (patchSize / sizeof(u32))};
 
@@ -418,13 +535,54 @@ namespace skyline::nce {
             auto startOffset{[&] { return static_cast<size_t>(start - patch); }};
 
             if (svc.Verify()) {
-                /* Per-SVC Trampoline */
                 /* Rewrite SVC with B to trampoline */
                 *instruction = instructions::B(static_cast<i32>(endOffset() + offset), true).raw;
 
-                /* Save Context */
+                if (svc.value == SvcGetCurrentProcessorNumber) {
+                    /* Fast GetCurrentProcessorNumber */
+                    /* Load the current core of the thread from ThreadContext */
+                    *patch++ = 0xD53BD040; // MRS X0, TPIDR_EL0
+                    *patch++ = 0xF9416C00; // LDR X0, [X0, #0x2D8] (ThreadContext::coreId)
+                    *patch++ = 0x39400000; // LDRB W0, [X0]
+
+                    /* Return */
+                    *patch = instructions::B(static_cast<i32>(endOffset() + offset + 1)).raw;
+                    patch++;
+                    continue;
+                } else if (svc.value == SvcGetSystemTick) {
+                    /* Fast GetSystemTick */
+                    if (rescaleClock) {
+                        /* Rescale host clock and load result from stack */
+                        patch = WriteRescaleClock(patch);
+                        *patch++ = 0xF94003E0; // LDR X0, [SP]
+                        *patch++ = 0x910083FF; // ADD SP, SP, #32
+                    } else {
+                        *patch++ = 0xD53BE040; // MRS X0, CNTVCT_EL0
+                    }
+
+                    /* Return */
+                    *patch = instructions::B(static_cast<i32>(endOffset() + offset + 1)).raw;
+                    patch++;
+                    continue;
+                } else if (svc.value == SvcGetThreadId) {
+                    /* Fast GetThreadId */
+                    /* Only the current thread pseudo-handle is handled here, any other handle needs to be looked up by the SVC handler */
+                    *patch++ = 0x128FFFE0; // MOVN W0, #0x7FFF (W0 = 0xFFFF8000)
+                    *patch++ = 0x6B00003F; // CMP W1, W0
+                    *patch++ = 0x540000A1; // B.NE #20 (Per-SVC Trampoline)
+
+                    /* Load the thread ID from ThreadContext and return success */
+                    *patch++ = 0xD53BD040; // MRS X0, TPIDR_EL0
+                    *patch++ = 0xF9417001; // LDR X1, [X0, #0x2E0] (ThreadContext::threadId)
+                    *patch++ = 0x2A1F03E0; // MOV W0, WZR
+                    *patch = instructions::B(static_cast<i32>(endOffset() + offset + 1)).raw;
+                    patch++;
+                }
+
+                /* Per-SVC Trampoline */
+                /* Save Context without FP registers, no SVC accesses them and callers of an SVC only rely on the callee-saved ones which the host preserves */
                 *patch++ = 0xF81F0FFE; // STR LR, [SP, #-16]!
-                *patch = instructions::BL(static_cast<i32>(startOffset())).raw;
+                *patch = instructions::BL(static_cast<i32>(startOffset() + guest::SaveGpCtxOffset)).raw;
                 patch++;
 
                 /* Jump to main SVC trampoline */
@@ -433,7 +591,7 @@ namespace skyline::nce {
                 patch++;
 
                 /* Restore Context and Return */
-                *patch = instructions::BL(static_cast<i32>(startOffset() + guest::SaveCtxSize + TrampolineSize)).raw;
+                *patch = instructions::BL(static_cast<i32>(startOffset() + guest::SaveCtxSize + TrampolineSize + guest::LoadGpCtxOffset)).raw;
                 patch++;
                 *patch++ = 0xF84107FE; // LDR LR, [SP], #16
                 *patch = instructions::B(static_cast<i32>(endOffset() + offset + 1)).raw;
@@ -531,6 +689,10 @@ namespace skyline::nce {
                 size += EmitTrampolineSize + 1;
             else if (std::holds_alternative<hle::EntryExitHook>(entry.hook))
                 size += 4 + EmitTrampolineSize + 1 + EmitTrampolineSize + 4 + 1;
+            else if (std::holds_alternative<hle::NativeOverrideHook>(entry.hook))
+                size += 4 + 1 + 1;
+            else if (std::holds_alternative<hle::DirectOverrideHook>(entry.hook))
+                size += 6 + TrampolineSize + 1 + 1;
         }
         return size * sizeof(u32);
     }
@@ -603,6 +765,27 @@ namespace skyline::nce {
                 *hook++ = 0xF841043E; // LDR LR, [X1], #16
                 *hook++ = 0xF9015401; // STR X1, [X0, #0x2A8] (ThreadContext::hostSp)
                 *hook++ = 0xA8C107E0; // LDP X0, X1, [SP], #16
+            } else if (auto nativeHook{std::get_if<hle::NativeOverrideHook>(&entry.hook)}) {
+                /* Native Override Hook */
+                // The function is tail-called with the guest's LR so it returns directly to the caller, X16 is an intra-procedure-call scratch register so it can be freely clobbered
+                for (const auto &mov : instructions::MoveRegister(registers::X16, reinterpret_cast<u64>(nativeHook->function)))
+                    if (mov)
+                        *hook++ = mov;
+                *hook++ = 0xD61F0200; // BR X16
+            } else if (auto directHook{std::get_if<hle::DirectOverrideHook>(&entry.hook)}) {
+                /* Direct Override Hook */
+                // The function is called through a dedicated trampoline rather than HookHandler, this avoids the symbol lookup and dispatch on every call
+                *hook++ = 0xF81F0FFE; // STR LR, [SP, #-16]!
+                *hook = instructions::BL(static_cast<i32>(startOffset())).raw; // BL SaveCtx
+                hook++;
+                *hook++ = instructions::BL(4).raw; // BL DirectTrampoline
+                *hook = instructions::BL(static_cast<i32>(startOffset() + guest::SaveCtxSize + TrampolineSize)).raw; // BL LoadCtx
+                hook++;
+                *hook++ = 0xF84107FE; // LDR LR, [SP], #16
+                *hook++ = 0xD65F03C0; // RET
+
+                /* Direct Trampoline */
+                hook = WriteTrampoline(hook, reinterpret_cast<u64>(directHook->function), true);
             }
 
             *hook++ = 0xD65F03C0; // RET
@@ -612,34 +795,110 @@ namespace skyline::nce {
         }
     }
 
-    NCE::CallbackEntry::CallbackEntry(TrapProtection protection, LockCallback lockCallback, TrapCallback readCallback, TrapCallback writeCallback) : protection{protection}, lockCallback{std::move(lockCallback)}, readCallback{std::move(readCallback)}, writeCallback{std::move(writeCallback)} {}
+    NCE::CallbackEntry::CallbackEntry(TrapProtection protection, LockCallback lockCallback, TrapCallback readCallback, TrapCallback writeCallback, PageTrapCallback pageWriteCallback) : protection{protection}, lockCallback{std::move(lockCallback)}, readCallback{std::move(readCallback)}, writeCallback{std::move(writeCallback)}, pageWriteCallback{std::move(pageWriteCallback)} {}
+
+    /**
+     * @brief A batch of changes to page protections which are coalesced into as few mprotect calls as possible when flushed
+     * @note Trapping can produce a large amount of small adjacent intervals, every mprotect call is a syscall and potentially a TLB shootdown so avoiding them is important
+     */
+    class ProtectionBatch {
+      private:
+        struct Change {
+            u8 *start;
+            u8 *end;
+            int protection;
+        };
+
+        std::vector<Change> changes;
+        bool uniformProtection{true}; //!< If all changes in the batch have the same protection, they can be freely reordered in that case
+
+      public:
+        ProtectionBatch(size_t capacity) {
+            changes.reserve(capacity);
+        }
+
+        void Add(u8 *start, u8 *end, int protection) {
+            changes.push_back(Change{start, end, protection});
+            uniformProtection = uniformProtection && changes.front().protection == protection;
+        }
+
+        /**
+         * @brief Applies all changes in the batch, any overlapping or adjacent changes with the same protection are merged prior to being applied
+         * @note Changes are only sorted when they all have the same protection, the protection of pages shared by changes with differing protections depends on the order they're applied in otherwise
+         */
+        void Flush() {
+            if (uniformProtection)
+                std::sort(changes.begin(), changes.end(), [](const Change &a, const Change &b) { return a.start < b.start; });
+
+            for (auto it{changes.begin()}; it != changes.end();) {
+                Change run{*it++};
+                while (it != changes.end() && it->protection == run.protection && it->start <= run.end && it->end >= run.start) {
+                    run.start = std::min(run.start, it->start);
+                    run.end = std::max(run.end, it->end);
+                    it++;
+                }
+
+                mprotect(run.start, static_cast<size_t>(run.end - run.start), run.protection);
+            }
+
+            changes.clear();
+            uniformProtection = true;
+        }
+    };
+
+    std::vector<NCE::TrapMap::Interval> NCE::GetPageRuns(const std::vector<TrapMap::Interval> &intervals) {
+        std::vector<TrapMap::Interval> runs;
+        runs.reserve(intervals.size());
+        for (const auto &interval : intervals)
+            runs.push_back(interval.Align(constant::PageSize));
+        std::sort(runs.begin(), runs.end(), [](const auto &a, const auto &b) { return a.start < b.start; });
+
+        for (auto it{runs.begin()}; it != runs.end();) {
+            auto next{std::next(it)};
+            if (next != runs.end() && it->end >= next->start) {
+                it->end = std::max(it->end, next->end);
+                it = std::prev(runs.erase(next));
+            } else {
+                it++;
+            }
+        }
+        return runs;
+    }
 
     void NCE::ReprotectIntervals(const std::vector<TrapMap::Interval> &intervals, TrapProtection protection) {
         TRACE_EVENT("host", "NCE::ReprotectIntervals");
 
+        // Determines the protection of a region from the trapped entries overlapping it, single pages are resolved from the directory without querying the trap map
+        auto getRegionProtection{[&](TrapMap::Interval region) {
+            if (region.Size() == constant::PageSize) {
+                const auto &page{trapDirectory[region.start]};
+                if (!page.Overflowed()) {
+                    TrapProtection highestProtection{TrapProtection::None};
+                    for (auto entry : page.Entries())
+                        highestProtection = std::max(highestProtection, entry->protection);
+                    return highestProtection;
+                }
+            }
+
+            TrapProtection highestProtection{TrapProtection::None};
+            for (const auto &entry : trapMap.GetRange(region))
+                highestProtection = std::max(highestProtection, entry.get().protection);
+            return highestProtection;
+        }};
+
         auto reprotectIntervalsWithFunction = [&intervals](auto getProtection) {
+            ProtectionBatch batch{intervals.size()};
             for (auto region : intervals) {
                 region = region.Align(constant::PageSize);
-                mprotect(region.start, region.Size(), getProtection(region));
+                batch.Add(region.start, region.end, getProtection(region));
             }
+            batch.Flush();
         };
 
         // We need to determine the lowest protection possible for the given interval
         if (protection == TrapProtection::None) {
             reprotectIntervalsWithFunction([&](auto region) {
-                auto entries{trapMap.GetRange(region)};
-
-                TrapProtection lowestProtection{TrapProtection::None};
-                for (const auto &entry : entries) {
-                    auto entryProtection{entry.get().protection};
-                    if (entryProtection > lowestProtection) {
-                        lowestProtection = entryProtection;
-                        if (entryProtection == TrapProtection::ReadWrite)
-                            return PROT_NONE;
-                    }
-                }
-
-                switch (lowestProtection) {
+                switch (getRegionProtection(region)) {
                     case TrapProtection::None:
                         return PROT_READ | PROT_WRITE | PROT_EXEC;
                     case TrapProtection::WriteOnly:
@@ -650,12 +909,7 @@ namespace skyline::nce {
             });
         } else if (protection == TrapProtection::WriteOnly) {
             reprotectIntervalsWithFunction([&](auto region) {
-                auto entries{trapMap.GetRange(region)};
-                for (const auto &entry : entries)
-                    if (entry.get().protection == TrapProtection::ReadWrite)
-                        return PROT_NONE;
-
-                return PROT_READ | PROT_EXEC;
+                return getRegionProtection(region) == TrapProtection::ReadWrite ? PROT_NONE : PROT_READ | PROT_EXEC;
             });
         } else if (protection == TrapProtection::ReadWrite) {
             reprotectIntervalsWithFunction([&](auto region) {
@@ -666,6 +920,7 @@ namespace skyline::nce {
 
     bool NCE::TrapHandler(u8 *address, bool write) {
         TRACE_EVENT("host", "NCE::TrapHandler");
+        trace::AddFrameCounter(trace::FrameCounter::NceTrapFaults);
 
         LockCallback lockCallback{};
         while (true) {
@@ -677,11 +932,48 @@ namespace skyline::nce {
 
             std::scoped_lock lock(trapMutex);
 
-            // Retrieve any callbacks for the page that was faulted
-            auto[entries, intervals]{trapMap.GetAlignedRecursiveRange<constant::PageSize>(address)};
-            if (entries.empty())
+            const auto &directoryPage{trapDirectory[address]};
+            if (directoryPage.count == 0)
                 return false; // There's no callbacks associated with this page
 
+            if (write) {
+                // If every trapped entry on the faulting page supports page-granular writes then only that page needs to be unprotected, this avoids a large entry being entirely untrapped by a small write
+                TrapMap::Interval page{TrapMap::Interval{address, address + 1}.Align(constant::PageSize)};
+
+                // The entries of the page are resolved from the directory unless there's too many of them, this avoids any allocations in the common case
+                span<CallbackEntry *const> pageEntries;
+                std::vector<CallbackEntry *> overflowedEntries;
+                if (!directoryPage.Overflowed()) [[likely]] {
+                    pageEntries = directoryPage.Entries();
+                } else {
+                    for (auto entryRef : trapMap.GetRange(page))
+                        overflowedEntries.push_back(&entryRef.get());
+                    pageEntries = overflowedEntries;
+                }
+
+                if (std::all_of(pageEntries.begin(), pageEntries.end(), [](CallbackEntry *entry) {
+                    return entry->protection == TrapProtection::None || (entry->protection == TrapProtection::WriteOnly && entry->pageWriteCallback);
+                })) {
+                    for (auto entry : pageEntries) {
+                        if (entry->protection == TrapProtection::None)
+                            continue;
+
+                        if (!entry->pageWriteCallback(span<u8>{page.start, page.Size()})) {
+                            lockCallback = entry->lockCallback;
+                            break;
+                        }
+                    }
+                    if (lockCallback)
+                        continue; // We need to retry the loop because a callback was blocking
+
+                    mprotect(page.start, page.Size(), PROT_READ | PROT_WRITE | PROT_EXEC);
+                    return true;
+                }
+            }
+
+            // Retrieve any callbacks for all intervals which are recursively covered by the entries on the faulting page, their protection is changed for the entire entry
+            auto[entries, intervals]{trapMap.GetAlignedRecursiveRange<constant::PageSize>(address)};
+
             // Do callbacks for every entry in the intervals
             if (write) {
                 for (auto entryRef : entries) {
@@ -719,10 +1011,12 @@ namespace skyline::nce {
                 write = allNone;
             }
 
+            // Reprotect the intervals to the lowest protection level that the callbacks performed allow
             int permission{PROT_READ | (write ? PROT_WRITE : 0) | PROT_EXEC};
+            ProtectionBatch batch{intervals.size()};
             for (const auto &interval : intervals)
-                // Reprotect the interval to the lowest protection level that the callbacks performed allow
-                mprotect(interval.start, interval.Size(), permission);
+                batch.Add(interval.start, interval.end, permission);
+            batch.Flush();
 
             return true;
         }
@@ -730,25 +1024,124 @@ namespace skyline::nce {
 
     constexpr NCE::TrapHandle::TrapHandle(const TrapMap::GroupHandle &handle) : TrapMap::GroupHandle(handle) {}
 
-    NCE::TrapHandle NCE::CreateTrap(span<span<u8>> regions, const LockCallback &lockCallback, const TrapCallback &readCallback, const TrapCallback &writeCallback) {
+    NCE::TrapHandle NCE::CreateTrap(span<span<u8>> regions, const LockCallback &lockCallback, const TrapCallback &readCallback, const TrapCallback &writeCallback, const PageTrapCallback &pageWriteCallback) {
         TRACE_EVENT("host", "NCE::CreateTrap");
         std::scoped_lock lock{trapMutex};
-        TrapHandle handle{trapMap.Insert(regions, CallbackEntry{TrapProtection::None, lockCallback, readCallback, writeCallback})};
+        TrapHandle handle{trapMap.Insert(regions, CallbackEntry{TrapProtection::None, lockCallback, readCallback, writeCallback, pageWriteCallback})};
+        for (const auto &run : GetPageRuns(handle->intervals))
+            trapDirectory.Insert(run.start, run.end, &handle->value);
         return handle;
     }
 
+    void NCE::CollectTrackedWrites(const std::vector<TrapMap::Interval> &intervals) {
+        TRACE_EVENT("host", "NCE::CollectTrackedWrites");
+
+        auto addTrackedWrite{[this](TrapMap::Interval pages) {
+            for (auto entryRef : trapMap.GetRange(pages)) {
+                auto &entry{entryRef.get()};
+                if (entry.writeTracked)
+                    entry.trackedWrites.emplace_back(pages.start, pages.Size());
+            }
+        }};
+
+        for (auto interval : intervals) {
+            interval = interval.Align(constant::PageSize);
+            if (!writeTracker.Collect(span<u8>{interval.start, interval.Size()}, [&](span<u8> pages) {
+                addTrackedWrite(TrapMap::Interval{pages.data(), pages.end().base()});
+            })) [[unlikely]]
+                addTrackedWrite(interval); // If the written pages couldn't be determined then all of them have to be assumed to be written
+        }
+    }
+
+    bool NCE::TrackWrites(CallbackEntry &entry, const std::vector<TrapMap::Interval> &intervals) {
+        if (!writeTracker.IsSupported() || !entry.pageWriteCallback)
+            return false;
+
+        if (entry.writeTracked) {
+            // Pages are tracked again as they're collected so they don't need to be retracked, any writes which weren't collected have been synchronized by the owner
+            entry.trackedWrites.clear();
+            return true;
+        }
+
+        CollectTrackedWrites(intervals); // Restarting tracking discards the kernel's written state which other tracked entries on the same pages may not have collected
+        for (auto interval : intervals) {
+            interval = interval.Align(constant::PageSize);
+            if (!writeTracker.Track(span<u8>{interval.start, interval.Size()}))
+                return false;
+        }
+
+        // Any existing protection is only removed after tracking has started so that no writes can be missed in between
+        entry.writeTracked = true;
+        entry.trackedWrites.clear();
+        entry.protection = TrapProtection::None;
+        ReprotectIntervals(intervals, TrapProtection::None);
+        return true;
+    }
+
     void NCE::TrapRegions(TrapHandle handle, bool writeOnly) {
         TRACE_EVENT("host", "NCE::TrapRegions");
         std::scoped_lock lock{trapMutex};
+        if (writeOnly && TrackWrites(handle->value, handle->intervals))
+            return;
+
         auto protection{writeOnly ? TrapProtection::WriteOnly : TrapProtection::ReadWrite};
         handle->value.protection = protection;
         ReprotectIntervals(handle->intervals, protection);
+
+        if (handle->value.writeTracked) {
+            // Writes prior to the entry being trapped need to be collected after it's protected so that none of them are missed
+            CollectTrackedWrites(handle->intervals);
+            handle->value.writeTracked = false;
+        }
+    }
+
+    void NCE::TrapRegions(TrapHandle handle, span<u8> region, bool writeOnly) {
+        TRACE_EVENT("host", "NCE::TrapRegions");
+        std::scoped_lock lock{trapMutex};
+        if (handle->value.writeTracked && writeOnly)
+            return; // Tracked pages are tracked again when they're collected so there's nothing to retrap
+
+        auto protection{writeOnly ? TrapProtection::WriteOnly : TrapProtection::ReadWrite};
+        handle->value.protection = protection;
+
+        if (handle->value.writeTracked) {
+            // The entire entry stops being tracked so all of it has to be trapped
+            ReprotectIntervals(handle->intervals, protection);
+            CollectTrackedWrites(handle->intervals);
+            handle->value.writeTracked = false;
+            return;
+        }
+
+        std::vector<TrapMap::Interval> intervals;
+        for (const auto &interval : handle->intervals) {
+            auto start{std::max(interval.start, region.data())}, end{std::min(interval.end, region.end().base())};
+            if (start < end)
+                intervals.emplace_back(start, end);
+        }
+        ReprotectIntervals(intervals, protection);
+    }
+
+    void NCE::CollectTrapWrites(TrapHandle handle, const std::function<void(span<u8>)> &callback) {
+        if (!writeTracker.IsSupported())
+            return;
+
+        TRACE_EVENT("host", "NCE::CollectTrapWrites");
+        std::scoped_lock lock{trapMutex};
+        auto &entry{handle->value};
+        if (entry.writeTracked)
+            CollectTrackedWrites(handle->intervals);
+
+        for (auto pages : entry.trackedWrites)
+            callback(pages);
+        entry.trackedWrites.clear();
     }
 
     void NCE::RemoveTrap(TrapHandle handle) {
         TRACE_EVENT("host", "NCE::RemoveTrap");
         std::scoped_lock lock{trapMutex};
         handle->value.protection = TrapProtection::None;
+        handle->value.writeTracked = false;
+        handle->value.trackedWrites.clear();
         ReprotectIntervals(handle->intervals, TrapProtection::None);
     }
 
@@ -756,7 +1149,16 @@ namespace skyline::nce {
         TRACE_EVENT("host", "NCE::DeleteTrap");
         std::scoped_lock lock{trapMutex};
         handle->value.protection = TrapProtection::None;
+        handle->value.writeTracked = false;
         ReprotectIntervals(handle->intervals, TrapProtection::None);
+
+        // The entry is removed from the directory after the trap map so that any overflowed pages are refilled with only the remaining entries
+        auto entry{&handle->value};
+        auto runs{GetPageRuns(handle->intervals)};
         trapMap.Remove(handle);
+        for (const auto &run : runs)
+            trapDirectory.Remove(run.start, run.end, entry, [this](u8 *page) {
+                return trapMap.GetRange(TrapMap::Interval{page, page + constant::PageSize});
+            });
     }
 }
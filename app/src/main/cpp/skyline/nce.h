@@ -8,6 +8,8 @@
 #include "common.h"
 #include "hle/symbol_hooks.h"
 #include "common/interval_map.h"
+#include "nce/write_tracker.h"
+#include "nce/trap_directory.h"
 
 namespace skyline::nce {
     /**
@@ -29,19 +31,41 @@ namespace skyline::nce {
         };
 
         using TrapCallback = std::function<bool()>;
+        using PageTrapCallback = std::function<bool(span<u8> pages)>;
         using LockCallback = std::function<void()>;
 
         struct CallbackEntry {
             TrapProtection protection; //!< The least restrictive protection that this callback needs to have
             LockCallback lockCallback;
             TrapCallback readCallback, writeCallback;
+            PageTrapCallback pageWriteCallback; //!< An optional callback for writes to a write-only trapped region, when supplied only the accessed pages are unprotected and the entry stays trapped
+            bool writeTracked{}; //!< If writes to the entry are recorded by the write tracker rather than trapped, the entry requires no protection while this is set
+            std::vector<span<u8>> trackedWrites; //!< The pages of the entry that were written while tracked and haven't been collected by CollectTrapWrites yet
 
-            CallbackEntry(TrapProtection protection, LockCallback lockCallback, TrapCallback readCallback, TrapCallback writeCallback);
+            CallbackEntry(TrapProtection protection, LockCallback lockCallback, TrapCallback readCallback, TrapCallback writeCallback, PageTrapCallback pageWriteCallback);
         };
 
         std::mutex trapMutex; //!< Synchronizes the accesses to the trap map
         using TrapMap = IntervalMap<u8*, CallbackEntry>;
         TrapMap trapMap; //!< A map of all intervals and corresponding callbacks that have been registered
+        TrapDirectory<CallbackEntry> trapDirectory; //!< A page table of the entries in trapMap overlapping each page, this is used to resolve faults without querying trapMap
+        WriteTracker writeTracker; //!< Records writes to write-only trapped entries with page-granular callbacks without faulting, this is used when supported by the kernel
+
+        /**
+         * @return The page-aligned regions covered by the supplied intervals with any overlapping or adjacent regions merged, every page is only contained in a single region
+         */
+        static std::vector<TrapMap::Interval> GetPageRuns(const std::vector<TrapMap::Interval> &intervals);
+
+        /**
+         * @brief Collects all tracked writes to the intervals into the entries they overlap with, this must be done before tracking is restarted for any pages as the kernel's written state is shared between all entries on a page
+         */
+        void CollectTrackedWrites(const std::vector<TrapMap::Interval> &intervals);
+
+        /**
+         * @brief Switches an entry that's being write-only trapped over to the write tracker if possible
+         * @return If writes to the entry are now tracked, it must be trapped using ReprotectIntervals otherwise
+         */
+        bool TrackWrites(CallbackEntry &entry, const std::vector<TrapMap::Interval> &intervals);
 
         /**
          * @brief Reprotects the intervals to the least restrictive protection given the supplied protection
@@ -105,14 +129,23 @@ namespace skyline::nce {
             std::vector<size_t> offsets; //!< Offsets in .text of instructions that need to be patched
         };
 
-        static PatchData GetPatchData(const std::vector<u8> &text);
+        static PatchData GetPatchData(span<u8> text);
+
+        /**
+         * @brief Retrieves the patch data for the supplied .text from a cache file if it's valid, otherwise it's scanned for and written to the cache file
+         * @param cachePath The path to the cache file, this should be unique to the executable such as by being derived from its build ID
+         * @param contentHash A hash identifying the contents of the executable, cache entries with a different hash are discarded
+         * @note Only the patch offsets and size are cached as the .patch section itself contains host addresses which differ between runs
+         */
+        static PatchData GetPatchData(span<u8> text, const std::string &cachePath, u64 contentHash);
 
         /**
          * @brief Writes the .patch section and mutates the code accordingly
+         * @param text The .text section, this is patched in place so it should be the copy in guest memory
          * @param patch A pointer to the .patch section which should be exactly patchSize in size and located before the .text section
          * @param textOffset The offset of the .text section, this must be page-aligned
          */
-        static void PatchCode(std::vector<u8> &text, u32 *patch, size_t patchSize, const std::vector<size_t> &offsets, size_t textOffset = 0);
+        static void PatchCode(span<u8> text, u32 *patch, size_t patchSize, const std::vector<size_t> &offsets, size_t textOffset = 0);
 
         struct HookedSymbolEntry : hle::HookedSymbol {
             Elf64_Addr* offset{}; //!< A pointer to the hooked function's offset (st_value) in the ELF's dynsym, this is set by the loader and is used to resolve/update the address of the function
@@ -138,11 +171,13 @@ namespace skyline::nce {
          * @param lockCallback A callback to lock the resource that is being trapped, it must block until the resource is locked but unlock it prior to returning
          * @param readCallback A callback for read accesses to the trapped region, it must not block and return a boolean if it would block
          * @param writeCallback A callback for write accesses to the trapped region, it must not block and return a boolean if it would block
+         * @param pageWriteCallback An optional callback for write accesses to individual pages of the region while it's write-only trapped, it has the same constraints as writeCallback and is supplied the accessed pages
          * @note The handle **must** be deleted using DeleteTrap before the NCE instance is destroyed
          * @note It is UB to supply a region of host memory rather than guest memory
          * @note This doesn't trap the region in itself, any trapping must be done via TrapRegions(...)
+         * @note writeCallback is still used for pages which are shared with any other trap that doesn't support page-granular writes, the entire region is unprotected in that case
          */
-        TrapHandle CreateTrap(span<span<u8>> regions, const LockCallback& lockCallback, const TrapCallback& readCallback, const TrapCallback& writeCallback);
+        TrapHandle CreateTrap(span<span<u8>> regions, const LockCallback& lockCallback, const TrapCallback& readCallback, const TrapCallback& writeCallback, const PageTrapCallback &pageWriteCallback = {});
 
         /**
          * @brief Re-traps a region of memory after protections were removed
@@ -150,6 +185,19 @@ namespace skyline::nce {
          */
         void TrapRegions(TrapHandle handle, bool writeOnly);
 
+        /**
+         * @brief Re-traps a subregion of a trap after protections were removed from it, this is used to re-trap pages that were unprotected through a page-granular write
+         * @param region The region to re-trap, this will be expanded to page boundaries
+         */
+        void TrapRegions(TrapHandle handle, span<u8> region, bool writeOnly);
+
+        /**
+         * @brief Supplies the pages of a trap that were written to while writes to it were tracked rather than trapped, this must be done at any point where the trap's owner depends on having observed all prior writes
+         * @param callback A function that's called with every run of written pages, it's called with trapMutex held and must not call into the NCE
+         * @note Tracked writes don't invoke any trap callbacks, they're only observable through this
+         */
+        void CollectTrapWrites(TrapHandle handle, const std::function<void(span<u8>)> &callback);
+
         /**
          * @brief Removes protections from a region of memory
          */
@@ -101,11 +101,16 @@ namespace skyline {
             u32 nzcv;
             const DeviceState *state;
             u64 magic{constant::SkyTlsMagic};
+            const u8 *coreId; //!< The ID of the core the thread is currently running on, this is read by SVC fast paths without entering the SVC handler
+            u64 threadId; //!< The ID of the thread, this is read by SVC fast paths without entering the SVC handler
         };
+        static_assert(offsetof(ThreadContext, coreId) == 0x2D8 && offsetof(ThreadContext, threadId) == 0x2E0, "SVC fast paths in nce.cpp depend on these offsets");
 
         namespace guest {
-            constexpr size_t SaveCtxSize{38}; //!< The size of the SaveCtx function in 32-bit ARMv8 instructions
-            constexpr size_t LoadCtxSize{36}; //!< The size of the LoadCtx function in 32-bit ARMv8 instructions
+            constexpr size_t SaveCtxSize{41}; //!< The size of the SaveCtx function in 32-bit ARMv8 instructions, this includes SaveGpCtx
+            constexpr size_t LoadCtxSize{39}; //!< The size of the LoadCtx function in 32-bit ARMv8 instructions, this includes LoadGpCtx
+            constexpr size_t SaveGpCtxOffset{19}; //!< The offset of SaveGpCtx from SaveCtx in 32-bit ARMv8 instructions
+            constexpr size_t LoadGpCtxOffset{19}; //!< The offset of LoadGpCtx from LoadCtx in 32-bit ARMv8 instructions
 
             /**
              * @brief Saves the context from CPU registers into TLS
@@ -118,6 +123,17 @@ namespace skyline {
              * @note Assumes that 8B is reserved at an offset of 8B from SP
              */
             extern "C" void LoadCtx(void);
+
+            /**
+             * @brief Saves the context from CPU registers into TLS without any FP/SIMD registers
+             * @note This is only valid at an SVC as callers of one don't rely on any FP/SIMD registers being preserved beyond the callee-saved ones, which host code preserves as well
+             */
+            extern "C" void SaveGpCtx(void);
+
+            /**
+             * @brief Loads the context saved by SaveGpCtx from TLS into CPU registers
+             */
+            extern "C" void LoadGpCtx(void);
         }
     }
 }
@@ -336,5 +336,438 @@ namespace skyline::nce {
             };
         };
         static_assert(sizeof(Ldr) == sizeof(u32));
+
+        /**
+         * @brief The condition codes used by conditional instructions
+         */
+        enum class Condition : u8 {
+            Eq = 0b0000, //!< Equal (Z == 1)
+            Ne = 0b0001, //!< Not equal (Z == 0)
+            Cs = 0b0010, //!< Carry set (C == 1)
+            Cc = 0b0011, //!< Carry clear (C == 0)
+        };
+
+        /**
+         * @return The inverse of the supplied condition
+         */
+        constexpr Condition Invert(Condition condition) {
+            return static_cast<Condition>(static_cast<u8>(condition) ^ 1);
+        }
+
+        /**
+         * @url https://developer.arm.com/documentation/ddi0596/2021-12/Base-Instructions/ADD--shifted-register---Add--shifted-register--
+         * @note This also covers ADDS, SUB and SUBS (shifted register), no shift is applied to the second source
+         */
+        struct AddSubRegister {
+            /**
+             * @param subtract If this is a subtraction rather than an addition
+             * @param setFlags If the NZCV flags should be set based on the result
+             */
+            constexpr AddSubRegister(registers::W destReg, registers::W srcRegA, registers::W srcRegB, bool subtract = false, bool setFlags = false) : destReg(destReg), srcRegA(srcRegA), imm6(0), srcRegB(srcRegB), sig0(0), shift(0), sig1(0xB), setFlags(setFlags), subtract(subtract), sf(0) {}
+
+            constexpr bool Verify() {
+                return (sig0 == 0) && (sig1 == 0xB);
+            }
+
+            union {
+                struct {
+                    u32 destReg : 5; //!< 5-bit destination register
+                    u32 srcRegA : 5; //!< 5-bit first source register
+                    u32 imm6 : 6; //!< 6-bit shift amount
+                    u32 srcRegB : 5; //!< 5-bit second source register
+                    u32 sig0 : 1; //!< 1-bit signature (0x0)
+                    u32 shift : 2; //!< 2-bit shift type
+                    u32 sig1 : 5; //!< 5-bit signature (0xB)
+                    u32 setFlags : 1; //!< 1-bit flag setting
+                    u32 subtract : 1; //!< 1-bit operation type
+                    u32 sf : 1; //!< 1-bit register type
+                };
+                u32 raw{};
+            };
+        };
+        static_assert(sizeof(AddSubRegister) == sizeof(u32));
+
+        /**
+         * @url https://developer.arm.com/documentation/ddi0596/2021-12/Base-Instructions/ADC--Add-with-Carry-
+         * @note This also covers ADCS, SBC and SBCS
+         */
+        struct AddSubWithCarry {
+            /**
+             * @param subtract If this is a subtraction with borrow rather than an addition with carry
+             * @param setFlags If the NZCV flags should be set based on the result
+             */
+            constexpr AddSubWithCarry(registers::W destReg, registers::W srcRegA, registers::W srcRegB, bool subtract = false, bool setFlags = false) : destReg(destReg), srcRegA(srcRegA), sig0(0), srcRegB(srcRegB), sig1(0xD0), setFlags(setFlags), subtract(subtract), sf(0) {}
+
+            constexpr bool Verify() {
+                return (sig0 == 0) && (sig1 == 0xD0);
+            }
+
+            union {
+                struct {
+                    u32 destReg : 5; //!< 5-bit destination register
+                    u32 srcRegA : 5; //!< 5-bit first source register
+                    u32 sig0 : 6; //!< 6-bit signature (0x0)
+                    u32 srcRegB : 5; //!< 5-bit second source register
+                    u32 sig1 : 8; //!< 8-bit signature (0xD0)
+                    u32 setFlags : 1; //!< 1-bit flag setting
+                    u32 subtract : 1; //!< 1-bit operation type
+                    u32 sf : 1; //!< 1-bit register type
+                };
+                u32 raw{};
+            };
+        };
+        static_assert(sizeof(AddSubWithCarry) == sizeof(u32));
+
+        /**
+         * @url https://developer.arm.com/documentation/ddi0596/2021-12/Base-Instructions/ORR--shifted-register---Bitwise-OR--shifted-register--
+         * @note This also covers AND, EOR and their inverted-operand forms (BIC, ORN, EON), no shift is applied to the second source
+         */
+        struct LogicalRegister {
+            enum class Operation : u8 {
+                And = 0b00,
+                Orr = 0b01,
+                Eor = 0b10,
+            };
+
+            /**
+             * @param invert If the second source should be inverted prior to the operation
+             */
+            constexpr LogicalRegister(Operation operation, registers::W destReg, registers::W srcRegA, registers::W srcRegB, bool invert = false) : destReg(destReg), srcRegA(srcRegA), imm6(0), srcRegB(srcRegB), invert(invert), shift(0), sig(0xA), opc(static_cast<u8>(operation)), sf(0) {}
+
+            constexpr bool Verify() {
+                return (sig == 0xA);
+            }
+
+            union {
+                struct {
+                    u32 destReg : 5; //!< 5-bit destination register
+                    u32 srcRegA : 5; //!< 5-bit first source register
+                    u32 imm6 : 6; //!< 6-bit shift amount
+                    u32 srcRegB : 5; //!< 5-bit second source register
+                    u32 invert : 1; //!< 1-bit second source inversion
+                    u32 shift : 2; //!< 2-bit shift type
+                    u32 sig : 5; //!< 5-bit signature (0xA)
+                    u32 opc : 2; //!< 2-bit operation
+                    u32 sf : 1; //!< 1-bit register type
+                };
+                u32 raw{};
+            };
+        };
+        static_assert(sizeof(LogicalRegister) == sizeof(u32));
+
+        /**
+         * @url https://developer.arm.com/documentation/ddi0596/2021-12/Base-Instructions/LSLV--Logical-Shift-Left-Variable-
+         * @note This also covers LSRV, the shift amount is taken modulo the register size
+         */
+        struct ShiftVariable {
+            /**
+             * @param right If this is a logical right shift rather than a left shift
+             */
+            constexpr ShiftVariable(registers::W destReg, registers::W srcReg, registers::W shiftReg, bool right = false) : destReg(destReg), srcReg(srcReg), right(right), sig0(0x2), shiftReg(shiftReg), sig1(0xD6), sf(0) {}
+
+            constexpr bool Verify() {
+                return (sig0 == 0x2) && (sig1 == 0xD6);
+            }
+
+            union {
+                struct {
+                    u32 destReg : 5; //!< 5-bit destination register
+                    u32 srcReg : 5; //!< 5-bit source register
+                    u32 right : 2; //!< 2-bit shift type
+                    u32 sig0 : 4; //!< 4-bit signature (0x2)
+                    u32 shiftReg : 5; //!< 5-bit shift amount register
+                    u32 sig1 : 10; //!< 10-bit signature (0xD6)
+                    u32 sf : 1; //!< 1-bit register type
+                };
+                u32 raw{};
+            };
+        };
+        static_assert(sizeof(ShiftVariable) == sizeof(u32));
+
+        /**
+         * @url https://developer.arm.com/documentation/ddi0596/2021-12/Base-Instructions/CSINC--Conditional-Select-Increment-
+         * @note This is used for CSET which is an alias of CSINC with the zero register as both sources and an inverted condition
+         */
+        struct Csinc {
+            constexpr Csinc(registers::W destReg, registers::W srcRegA, registers::W srcRegB, Condition condition) : destReg(destReg), srcRegA(srcRegA), sig0(0x1), condition(static_cast<u8>(condition)), srcRegB(srcRegB), sig1(0xD4), sf(0) {}
+
+            constexpr bool Verify() {
+                return (sig0 == 0x1) && (sig1 == 0xD4);
+            }
+
+            union {
+                struct {
+                    u32 destReg : 5; //!< 5-bit destination register
+                    u32 srcRegA : 5; //!< 5-bit first source register
+                    u32 sig0 : 2; //!< 2-bit signature (0x1)
+                    u32 condition : 4; //!< 4-bit condition
+                    u32 srcRegB : 5; //!< 5-bit second source register
+                    u32 sig1 : 10; //!< 10-bit signature (0xD4)
+                    u32 sf : 1; //!< 1-bit register type
+                };
+                u32 raw{};
+            };
+        };
+        static_assert(sizeof(Csinc) == sizeof(u32));
+
+        /**
+         * @return A CSET instruction which sets the destination register to 1 if the condition holds, otherwise 0
+         */
+        constexpr Csinc Cset(registers::W destReg, Condition condition) {
+            return Csinc{destReg, static_cast<registers::W>(31), static_cast<registers::W>(31), Invert(condition)};
+        }
+
+        /**
+         * @url https://developer.arm.com/documentation/ddi0596/2021-12/Base-Instructions/SUBS--immediate---Subtract--immediate---setting-flags-
+         * @note This is used for CMP (immediate) which is an alias of SUBS with the zero register as the destination
+         */
+        struct CmpImmediate {
+            constexpr CmpImmediate(registers::W srcReg, u16 imm12) : destReg(31), srcReg(srcReg), imm12(imm12), shift(0), sig(0xE2), sf(0) {}
+
+            constexpr bool Verify() {
+                return (sig == 0xE2);
+            }
+
+            union {
+                struct {
+                    u32 destReg : 5; //!< 5-bit destination register (0x1F)
+                    u32 srcReg : 5; //!< 5-bit source register
+                    u32 imm12 : 12; //!< 12-bit immediate value
+                    u32 shift : 1; //!< 1-bit immediate shift
+                    u32 sig : 8; //!< 8-bit signature (0xE2)
+                    u32 sf : 1; //!< 1-bit register type
+                };
+                u32 raw{};
+            };
+        };
+        static_assert(sizeof(CmpImmediate) == sizeof(u32));
+
+        /**
+         * @url https://developer.arm.com/documentation/ddi0596/2021-12/Base-Instructions/CBZ--Compare-and-Branch-on-Zero-
+         * @note This also covers CBNZ
+         */
+        struct Cbz {
+            /**
+             * @param offset The offset to branch to in instructions
+             * @param nonZero If the branch should be taken when the register is non-zero rather than zero
+             */
+            constexpr Cbz(registers::W srcReg, i32 offset, bool nonZero = false) : srcReg(srcReg), offset(offset), nonZero(nonZero), sig(0x1A), sf(0) {}
+
+            /**
+             * @return The offset encoded within the instruction in bytes
+             */
+            constexpr i32 Offset() {
+                return offset * static_cast<i32>(sizeof(u32));
+            }
+
+            constexpr bool Verify() {
+                return (sig == 0x1A);
+            }
+
+            union {
+                struct {
+                    u32 srcReg : 5; //!< 5-bit register to test
+                    i32 offset : 19; //!< 19-bit branch offset
+                    u32 nonZero : 1; //!< 1-bit branch condition
+                    u32 sig : 6; //!< 6-bit signature (0x1A)
+                    u32 sf : 1; //!< 1-bit register type
+                };
+                u32 raw{};
+            };
+        };
+        static_assert(sizeof(Cbz) == sizeof(u32));
+
+        /**
+         * @url https://developer.arm.com/documentation/ddi0596/2021-12/Base-Instructions/TBZ--Test-bit-and-Branch-if-Zero-
+         * @note This also covers TBNZ
+         */
+        struct Tbz {
+            /**
+             * @param bit The bit in the register to test (0-63)
+             * @param offset The offset to branch to in instructions
+             * @param nonZero If the branch should be taken when the bit is set rather than clear
+             */
+            constexpr Tbz(registers::X srcReg, u8 bit, i32 offset, bool nonZero = false) : srcReg(srcReg), offset(offset), bitLow(bit & 0x1F), nonZero(nonZero), sig(0x1B), bitHigh(bit >> 5) {}
+
+            /**
+             * @return The offset encoded within the instruction in bytes
+             */
+            constexpr i32 Offset() {
+                return offset * static_cast<i32>(sizeof(u32));
+            }
+
+            constexpr bool Verify() {
+                return (sig == 0x1B);
+            }
+
+            union {
+                struct {
+                    u32 srcReg : 5; //!< 5-bit register to test
+                    i32 offset : 14; //!< 14-bit branch offset
+                    u32 bitLow : 5; //!< Lower 5 bits of the bit to test
+                    u32 nonZero : 1; //!< 1-bit branch condition
+                    u32 sig : 6; //!< 6-bit signature (0x1B)
+                    u32 bitHigh : 1; //!< Upper bit of the bit to test
+                };
+                u32 raw{};
+            };
+        };
+        static_assert(sizeof(Tbz) == sizeof(u32));
+
+        /**
+         * @url https://developer.arm.com/documentation/ddi0596/2021-12/Base-Instructions/BLR--Branch-with-Link-to-Register-
+         */
+        struct Blr {
+            constexpr Blr(registers::X srcReg) : sig0(0x0), srcReg(srcReg), sig1(0x358FC0) {}
+
+            constexpr bool Verify() {
+                return (sig0 == 0x0) && (sig1 == 0x358FC0);
+            }
+
+            union {
+                struct {
+                    u32 sig0 : 5; //!< 5-bit signature (0x0)
+                    u32 srcReg : 5; //!< 5-bit branch target register
+                    u32 sig1 : 22; //!< 22-bit signature (0x358FC0)
+                };
+                u32 raw{};
+            };
+        };
+        static_assert(sizeof(Blr) == sizeof(u32));
+
+        /**
+         * @url https://developer.arm.com/documentation/ddi0596/2021-12/Base-Instructions/RET--Return-from-subroutine-
+         */
+        struct Ret {
+            constexpr Ret(registers::X srcReg = registers::X30) : sig0(0x0), srcReg(srcReg), sig1(0x3597C0) {}
+
+            constexpr bool Verify() {
+                return (sig0 == 0x0) && (sig1 == 0x3597C0);
+            }
+
+            union {
+                struct {
+                    u32 sig0 : 5; //!< 5-bit signature (0x0)
+                    u32 srcReg : 5; //!< 5-bit return address register
+                    u32 sig1 : 22; //!< 22-bit signature (0x3597C0)
+                };
+                u32 raw{};
+            };
+        };
+        static_assert(sizeof(Ret) == sizeof(u32));
+
+        /**
+         * @url https://developer.arm.com/documentation/ddi0596/2021-12/Base-Instructions/LDR--immediate---Load-Register--immediate--
+         * @note This is the post-indexed 32-bit variant which increments the base register after loading from it
+         */
+        struct LdrPostIndex {
+            /**
+             * @param increment The signed amount in bytes to add to the base register after the load
+             */
+            constexpr LdrPostIndex(registers::W destReg, registers::X baseReg, i16 increment) : destReg(destReg), baseReg(baseReg), sig0(0x1), imm9(increment), sig1(0x5C2) {}
+
+            constexpr bool Verify() {
+                return (sig0 == 0x1) && (sig1 == 0x5C2);
+            }
+
+            union {
+                struct {
+                    u32 destReg : 5; //!< 5-bit destination register
+                    u32 baseReg : 5; //!< 5-bit base address register
+                    u32 sig0 : 2; //!< 2-bit signature (0x1)
+                    i32 imm9 : 9; //!< 9-bit signed increment
+                    u32 sig1 : 11; //!< 11-bit signature (0x5C2)
+                };
+                u32 raw{};
+            };
+        };
+        static_assert(sizeof(LdrPostIndex) == sizeof(u32));
+
+        /**
+         * @url https://developer.arm.com/documentation/ddi0596/2021-12/Base-Instructions/STR--immediate---Store-Register--immediate--
+         * @note This also covers LDR, both are the unsigned offset 64-bit variants
+         */
+        struct StrLdrOffset {
+            /**
+             * @param offset The unsigned offset in bytes from the base register, this must be a multiple of 8
+             * @param load If this is a load rather than a store
+             */
+            constexpr StrLdrOffset(registers::X reg, registers::X baseReg, u16 offset, bool load = false) : reg(reg), baseReg(baseReg), imm12(offset / sizeof(u64)), load(load), sig(0xF9) {}
+
+            constexpr bool Verify() {
+                return (sig == 0xF9);
+            }
+
+            union {
+                struct {
+                    u32 reg : 5; //!< 5-bit source or destination register
+                    u32 baseReg : 5; //!< 5-bit base address register
+                    u32 imm12 : 12; //!< 12-bit scaled unsigned offset
+                    u32 load : 2; //!< 2-bit operation type
+                    u32 sig : 8; //!< 8-bit signature (0xF9)
+                };
+                u32 raw{};
+            };
+        };
+        static_assert(sizeof(StrLdrOffset) == sizeof(u32));
+
+        /**
+         * @url https://developer.arm.com/documentation/ddi0596/2021-12/Base-Instructions/STP--Store-Pair-of-Registers-
+         * @note This also covers LDP, both are the 64-bit variants
+         */
+        struct StpLdp {
+            enum class Addressing : u8 {
+                PostIndex = 0b01, //!< The base register is offset after the access
+                Offset = 0b10, //!< The base register is offset for the access but isn't modified
+                PreIndex = 0b11, //!< The base register is offset prior to the access
+            };
+
+            /**
+             * @param offset The signed offset in bytes from the base register, this must be a multiple of 8
+             * @param load If this is a load rather than a store
+             */
+            constexpr StpLdp(registers::X regA, registers::X regB, registers::X baseReg, i16 offset, Addressing addressing, bool load = false) : regA(regA), baseReg(baseReg), regB(regB), imm7(offset / static_cast<i16>(sizeof(u64))), load(load), addressing(static_cast<u8>(addressing)), sig(0x14), opc(0b10) {}
+
+            constexpr bool Verify() {
+                return (sig == 0x14) && (opc == 0b10);
+            }
+
+            union {
+                struct {
+                    u32 regA : 5; //!< 5-bit first register
+                    u32 baseReg : 5; //!< 5-bit base address register
+                    u32 regB : 5; //!< 5-bit second register
+                    i32 imm7 : 7; //!< 7-bit scaled signed offset
+                    u32 load : 1; //!< 1-bit operation type
+                    u32 addressing : 2; //!< 2-bit addressing mode
+                    u32 sig : 5; //!< 5-bit signature (0x14)
+                    u32 opc : 2; //!< 2-bit register size (0b10)
+                };
+                u32 raw{};
+            };
+        };
+        static_assert(sizeof(StpLdp) == sizeof(u32));
+
+        /**
+         * @url https://developer.arm.com/documentation/ddi0596/2021-12/Base-Instructions/MOV--to-from-SP---Move-between-register-and-stack-pointer--an-alias-of-ADD--immediate--
+         * @note Register 31 is the stack pointer rather than the zero register for this instruction
+         */
+        struct MovSp {
+            constexpr MovSp(registers::X destReg, registers::X srcReg) : destReg(destReg), srcReg(srcReg), sig(0x244000) {}
+
+            constexpr bool Verify() {
+                return (sig == 0x244000);
+            }
+
+            union {
+                struct {
+                    u32 destReg : 5; //!< 5-bit destination register
+                    u32 srcReg : 5; //!< 5-bit source register
+                    u32 sig : 22; //!< 22-bit signature (0x244000)
+                };
+                u32 raw{};
+            };
+        };
+        static_assert(sizeof(MovSp) == sizeof(u32));
     }
 }
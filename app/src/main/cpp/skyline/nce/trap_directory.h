@@ -0,0 +1,104 @@
+// SPDX-License-Identifier: MPL-2.0
+// Copyright © 2023 Skyline Team and Contributors (https://github.com/skyline-emu/)
+
+#pragma once
+
+#include <sys/mman.h>
+#include <common.h>
+
+namespace skyline::nce {
+    /**
+     * @brief A page table of the trap entries overlapping every page of the address space, this allows resolving the entries of a faulting page in O(1) without any allocations
+     * @details The table is backed by kernel demand paging so only the parts of it covering trapped pages are committed, pages with more entries than can be stored inline are marked as overflowed and must be resolved by the owner through other means
+     * @tparam EntryType The type of the trap entries, only pointers to them are stored in the directory
+     * @note This class is **NOT** thread-safe, any access to the directory must be protected by a mutex
+     */
+    template<typename EntryType>
+    class TrapDirectory {
+      public:
+        static constexpr size_t InlineEntryCount{3}; //!< The maximum amount of entries that can be stored for a single page
+
+        struct Page {
+            std::array<EntryType *, InlineEntryCount> entries;
+            u32 count; //!< The amount of entries overlapping the page, `entries` is only valid if this doesn't exceed InlineEntryCount
+
+            bool Overflowed() const {
+                return count > InlineEntryCount;
+            }
+
+            /**
+             * @note This must not be called on an overflowed page
+             */
+            span<EntryType *const> Entries() const {
+                return span<EntryType *const>{entries.data(), count};
+            }
+        };
+
+      private:
+        static constexpr size_t PageCount{constant::AddressSpaceSize >> constant::PageSizeBits};
+        span<Page, PageCount> pages;
+
+        Page &GetPage(u8 *address) {
+            return pages[reinterpret_cast<size_t>(address) >> constant::PageSizeBits];
+        }
+
+      public:
+        TrapDirectory() {
+            void *ptr{mmap(nullptr, PageCount * sizeof(Page), PROT_READ | PROT_WRITE, MAP_ANONYMOUS | MAP_PRIVATE | MAP_NORESERVE, -1, 0)};
+            if (ptr == MAP_FAILED)
+                throw exception("Failed to allocate 0x{:X} bytes of memory for the trap directory: {}", PageCount * sizeof(Page), strerror(errno));
+            pages = span<Page, PageCount>(static_cast<Page *>(ptr), PageCount);
+        }
+
+        TrapDirectory(const TrapDirectory &) = delete;
+
+        TrapDirectory &operator=(const TrapDirectory &) = delete;
+
+        ~TrapDirectory() {
+            munmap(pages.data(), pages.size_bytes());
+        }
+
+        /**
+         * @return The entries of the page containing the supplied address
+         */
+        const Page &operator[](u8 *address) const {
+            return pages[reinterpret_cast<size_t>(address) >> constant::PageSizeBits];
+        }
+
+        /**
+         * @brief Adds an entry to all pages in the supplied page-aligned region
+         * @note The same entry must not be added to a page more than once
+         */
+        void Insert(u8 *start, u8 *end, EntryType *entry) {
+            for (u8 *address{start}; address < end; address += constant::PageSize) {
+                auto &page{GetPage(address)};
+                if (page.count < InlineEntryCount)
+                    page.entries[page.count] = entry;
+                page.count++;
+            }
+        }
+
+        /**
+         * @brief Removes an entry from all pages in the supplied page-aligned region
+         * @param refill A function that's called with the address of any page which stops being overflowed, it must return all entries remaining on the page
+         */
+        template<typename RefillFunction>
+        void Remove(u8 *start, u8 *end, EntryType *entry, RefillFunction refill) {
+            for (u8 *address{start}; address < end; address += constant::PageSize) {
+                auto &page{GetPage(address)};
+                if (page.Overflowed()) {
+                    if (--page.count == InlineEntryCount) {
+                        size_t index{};
+                        for (EntryType &remaining : refill(address))
+                            page.entries[index++] = &remaining;
+                    }
+                    continue;
+                }
+
+                auto it{std::find(page.entries.begin(), page.entries.begin() + page.count, entry)};
+                std::move(std::next(it), page.entries.begin() + page.count, it);
+                page.count--;
+            }
+        }
+    };
+}
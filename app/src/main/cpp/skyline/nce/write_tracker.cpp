@@ -0,0 +1,130 @@
+// SPDX-License-Identifier: MPL-2.0
+// Copyright © 2022 Skyline Team and Contributors (https://github.com/skyline-emu/)
+
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <linux/fs.h>
+#include <linux/userfaultfd.h>
+#include "write_tracker.h"
+
+// The NDK's kernel headers may predate the features that are used here, they are defined manually in that case
+#ifndef UFFD_FEATURE_WP_UNPOPULATED
+#define UFFD_FEATURE_WP_UNPOPULATED (1 << 13)
+#endif
+
+#ifndef UFFD_FEATURE_WP_ASYNC
+#define UFFD_FEATURE_WP_ASYNC (1 << 15)
+#endif
+
+#ifndef PAGEMAP_SCAN
+#define PAGEMAP_SCAN _IOWR('f', 16, struct pm_scan_arg)
+#define PM_SCAN_WP_MATCHING (1 << 0)
+#define PM_SCAN_CHECK_WPASYNC (1 << 1)
+#define PAGE_IS_WRITTEN (1 << 1)
+
+struct page_region {
+    __u64 start;
+    __u64 end;
+    __u64 categories;
+};
+
+struct pm_scan_arg {
+    __u64 size;
+    __u64 flags;
+    __u64 start;
+    __u64 end;
+    __u64 walk_end;
+    __u64 vec;
+    __u64 vec_len;
+    __u64 max_pages;
+    __u64 category_inverted;
+    __u64 category_mask;
+    __u64 category_anyof_mask;
+    __u64 return_mask;
+};
+#endif
+
+namespace skyline::nce {
+    WriteTracker::WriteTracker() {
+        int fd{static_cast<int>(syscall(SYS_userfaultfd, O_CLOEXEC | O_NONBLOCK | UFFD_USER_MODE_ONLY))};
+        if (fd == -1)
+            return; // The kernel doesn't support userfaultfd or it's been restricted for this process
+
+        constexpr u64 RequiredFeatures{UFFD_FEATURE_WP_ASYNC | UFFD_FEATURE_WP_UNPOPULATED | UFFD_FEATURE_WP_HUGETLBFS_SHMEM};
+        uffdio_api api{
+            .api = UFFD_API,
+            .features = RequiredFeatures,
+        };
+        if (ioctl(fd, UFFDIO_API, &api) == -1 || (api.features & RequiredFeatures) != RequiredFeatures) {
+            close(fd);
+            return;
+        }
+
+        pagemapFd = open("/proc/self/pagemap", O_RDONLY | O_CLOEXEC);
+        if (pagemapFd == -1) {
+            close(fd);
+            return;
+        }
+
+        uffd = fd;
+    }
+
+    WriteTracker::~WriteTracker() {
+        if (uffd != -1)
+            close(uffd);
+        if (pagemapFd != -1)
+            close(pagemapFd);
+    }
+
+    bool WriteTracker::Track(span<u8> region) {
+        uffdio_writeprotect writeProtect{
+            .range = {
+                .start = reinterpret_cast<u64>(region.data()),
+                .len = region.size(),
+            },
+            .mode = UFFDIO_WRITEPROTECT_MODE_WP,
+        };
+        if (ioctl(uffd, UFFDIO_WRITEPROTECT, &writeProtect) == 0) [[likely]]
+            return true;
+
+        // The region needs to be registered with the userfaultfd prior to being write-protected, this is only done lazily as it's far more expensive and persists till the mapping is replaced
+        uffdio_register registration{
+            .range = writeProtect.range,
+            .mode = UFFDIO_REGISTER_MODE_WP,
+        };
+        if (ioctl(uffd, UFFDIO_REGISTER, &registration) == -1)
+            return false;
+
+        return ioctl(uffd, UFFDIO_WRITEPROTECT, &writeProtect) == 0;
+    }
+
+    bool WriteTracker::Collect(span<u8> region, const std::function<void(span<u8>)> &callback) {
+        std::array<page_region, 32> regions;
+        pm_scan_arg scan{
+            .size = sizeof(pm_scan_arg),
+            .flags = PM_SCAN_WP_MATCHING | PM_SCAN_CHECK_WPASYNC,
+            .start = reinterpret_cast<u64>(region.data()),
+            .end = reinterpret_cast<u64>(region.end().base()),
+            .vec = reinterpret_cast<u64>(regions.data()),
+            .vec_len = regions.size(),
+            .category_mask = PAGE_IS_WRITTEN,
+            .return_mask = PAGE_IS_WRITTEN,
+        };
+
+        while (scan.start < scan.end) {
+            auto count{ioctl(pagemapFd, PAGEMAP_SCAN, &scan)};
+            if (count < 0)
+                return false;
+
+            for (int i{}; i < count; i++)
+                callback(span<u8>{reinterpret_cast<u8 *>(regions[i].start), reinterpret_cast<u8 *>(regions[i].end)});
+
+            // The scan stops early if the output vector was filled, it needs to be resumed from where it stopped in that case
+            scan.start = scan.walk_end;
+        }
+
+        return true;
+    }
+}
@@ -0,0 +1,44 @@
+// SPDX-License-Identifier: MPL-2.0
+// Copyright © 2022 Skyline Team and Contributors (https://github.com/skyline-emu/)
+
+#pragma once
+
+#include <common.h>
+
+namespace skyline::nce {
+    /**
+     * @brief A tracker of writes to guest memory which are recorded by the kernel rather than faulting into a signal handler, writes are collected in batches when they're required
+     * @note This uses asynchronous userfaultfd write-protection alongside PAGEMAP_SCAN which requires Linux 6.7 or newer, the tracker is unsupported on any older kernels
+     * @url https://docs.kernel.org/admin-guide/mm/pagemap.html#pagemap-scan-ioctl
+     */
+    class WriteTracker {
+      private:
+        int uffd{-1}; //!< The userfaultfd with asynchronous write-protection enabled, this is -1 if the tracker isn't supported
+        int pagemapFd{-1}; //!< A file descriptor for /proc/self/pagemap which is used to scan for written pages
+
+      public:
+        WriteTracker();
+
+        ~WriteTracker();
+
+        /**
+         * @return If the host kernel supports tracking writes without faulting
+         */
+        bool IsSupported() const {
+            return uffd != -1;
+        }
+
+        /**
+         * @brief Starts tracking writes to the supplied page-aligned region, any writes made to it prior to this are discarded
+         * @return If the region could be tracked, this can fail for memory which the kernel can't write-protect
+         */
+        bool Track(span<u8> region);
+
+        /**
+         * @brief Collects every run of pages in the page-aligned region that has been written to since it was last tracked, they are atomically tracked again
+         * @param callback A function that's called with each run of written pages
+         * @return If the collection succeeded, the entire region must be assumed to be written to otherwise
+         */
+        bool Collect(span<u8> region, const std::function<void(span<u8>)> &callback);
+    };
+}
@@ -1,6 +1,7 @@
 // SPDX-License-Identifier: MPL-2.0
 // Copyright © 2020 Skyline Team and Contributors (https://github.com/skyline-emu/)
 
+#include <common/boot_profiler.h>
 #include "gpu.h"
 #include "nce.h"
 #include "nce/guest.h"
@@ -14,6 +15,33 @@
 #include "os.h"
 
 namespace skyline::kernel {
+    /**
+     * @brief Parses the ROM with the appropriate loader, this only depends on the keys and can run concurrently with the rest of the boot
+     */
+    static std::shared_ptr<loader::Loader> ParseRom(int romFd, loader::RomFormat romType, const std::string &privateAppFilesPath) {
+        auto romFile{std::make_shared<vfs::OsBacking>(romFd, false, vfs::Backing::Mode{true, false, false}, true)};
+        auto keyStore{[&] {
+            BootProfiler::ScopedStage bootStage{BootProfiler::Stage::KeyLoading};
+            return std::make_shared<crypto::KeyStore>(privateAppFilesPath + "keys/");
+        }()};
+
+        BootProfiler::ScopedStage bootStage{BootProfiler::Stage::RomParsing};
+        switch (romType) {
+            case loader::RomFormat::NRO:
+                return std::make_shared<loader::NroLoader>(std::move(romFile));
+            case loader::RomFormat::NSO:
+                return std::make_shared<loader::NsoLoader>(std::move(romFile));
+            case loader::RomFormat::NCA:
+                return std::make_shared<loader::NcaLoader>(std::move(romFile), std::move(keyStore));
+            case loader::RomFormat::NSP:
+                return std::make_shared<loader::NspLoader>(romFile, keyStore);
+            case loader::RomFormat::XCI:
+                return std::make_shared<loader::XciLoader>(romFile, keyStore);
+            default:
+                throw exception("Unsupported ROM extension.");
+        }
+    }
+
     OS::OS(
         std::shared_ptr<JvmManager> &jvmManager,
         std::shared_ptr<Settings> &settings,
@@ -21,42 +49,36 @@ namespace skyline::kernel {
         std::string privateAppFilesPath,
         std::string nativeLibraryPath,
         std::string deviceTimeZone,
-        std::shared_ptr<vfs::FileSystem> assetFileSystem)
+        std::shared_ptr<vfs::FileSystem> assetFileSystem,
+        int romFd,
+        loader::RomFormat romType)
         : nativeLibraryPath(std::move(nativeLibraryPath)),
           publicAppFilesPath(std::move(publicAppFilesPath)),
           privateAppFilesPath(std::move(privateAppFilesPath)),
           deviceTimeZone(std::move(deviceTimeZone)),
           assetFileSystem(std::move(assetFileSystem)),
+          romLoader(std::async(std::launch::async, ParseRom, romFd, romType, this->privateAppFilesPath)),
           state(this, jvmManager, settings),
           serviceManager(state) {}
 
-    void OS::Execute(int romFd, loader::RomFormat romType) {
-        auto romFile{std::make_shared<vfs::OsBacking>(romFd)};
-        auto keyStore{std::make_shared<crypto::KeyStore>(privateAppFilesPath + "keys/")};
-
-        state.loader = [&]() -> std::shared_ptr<loader::Loader> {
-            switch (romType) {
-                case loader::RomFormat::NRO:
-                    return std::make_shared<loader::NroLoader>(std::move(romFile));
-                case loader::RomFormat::NSO:
-                    return std::make_shared<loader::NsoLoader>(std::move(romFile));
-                case loader::RomFormat::NCA:
-                    return std::make_shared<loader::NcaLoader>(std::move(romFile), std::move(keyStore));
-                case loader::RomFormat::NSP:
-                    return std::make_shared<loader::NspLoader>(romFile, keyStore);
-                case loader::RomFormat::XCI:
-                    return std::make_shared<loader::XciLoader>(romFile, keyStore);
-                default:
-                    throw exception("Unsupported ROM extension.");
-            }
-        }();
-
-        state.gpu->Initialise();
+    void OS::Execute() {
+        state.loader = romLoader.get();
 
         auto &process{state.process};
         process = std::make_shared<kernel::type::KProcess>(state);
 
-        auto entry{state.loader->LoadProcessData(process, state)};
+        // Executables are loaded on another thread while the pipeline cache is warmed up on this one as the latter needs the JVM environment of this thread to show its progress
+        auto entryFuture{std::async(std::launch::async, [&] {
+            BootProfiler::ScopedStage bootStage{BootProfiler::Stage::ExecutableLoading};
+            return state.loader->LoadProcessData(process, state);
+        })};
+
+        {
+            BootProfiler::ScopedStage bootStage{BootProfiler::Stage::GpuInitialisation};
+            state.gpu->Initialise();
+        }
+
+        auto entry{entryFuture.get()};
         auto &nacp{state.loader->nacp};
         if (nacp) {
             std::string name{nacp->GetApplicationName(language::ApplicationLanguage::AmericanEnglish)}, publisher{nacp->GetApplicationPublisher(language::ApplicationLanguage::AmericanEnglish)};
@@ -72,6 +94,7 @@ namespace skyline::kernel {
         if (thread) {
             Logger::Info("Starting main HOS thread");
             Logger::EmulationContext.Flush();
+            BootProfile.MarkGuestStart();
             thread->Start(true);
             process->Kill(true, true, true);
         }
@@ -3,6 +3,7 @@
 
 #pragma once
 
+#include <future>
 #include <common/language.h>
 #include "vfs/filesystem.h"
 #include "loader/loader.h"
@@ -19,12 +20,14 @@ namespace skyline::kernel {
         std::string privateAppFilesPath; //!< The full path to the app's private files directory
         std::string deviceTimeZone; //!< The timezone name (e.g. Europe/London)
         std::shared_ptr<vfs::FileSystem> assetFileSystem; //!< A filesystem to be used for accessing emulator assets (like tzdata)
+        std::future<std::shared_ptr<loader::Loader>> romLoader; //!< The loader for the ROM, it's parsed on another thread while the device state (and Vulkan device) is being created
         DeviceState state;
         service::ServiceManager serviceManager;
 
         /**
          * @param settings An instance of the Settings class
-         * @param window The ANativeWindow object to draw the screen to
+         * @param romFd A FD to the ROM file to execute
+         * @param romType The type of the ROM file
          */
         OS(
             std::shared_ptr<JvmManager> &jvmManager,
@@ -33,14 +36,14 @@ namespace skyline::kernel {
             std::string privateAppFilesPath,
             std::string deviceTimeZone,
             std::string nativeLibraryPath,
-            std::shared_ptr<vfs::FileSystem> assetFileSystem
+            std::shared_ptr<vfs::FileSystem> assetFileSystem,
+            int romFd,
+            loader::RomFormat romType
         );
 
         /**
-         * @brief Execute a particular ROM file
-         * @param romFd A FD to the ROM file to execute
-         * @param romType The type of the ROM file
+         * @brief Execute the ROM file supplied during construction
          */
-        void Execute(int romFd, loader::RomFormat romType);
+        void Execute();
     };
 }
@@ -16,7 +16,13 @@ namespace skyline::service::am {
         T obj;
 
       public:
-        ObjIStorage(const DeviceState &state, ServiceManager &manager, T &&obj) :  IStorage(state, manager, true), obj(obj) {}
+        ObjIStorage(const DeviceState &state, ServiceManager &manager, T &&obj) : IStorage(state, manager, true), obj(std::move(obj)) {}
+
+        /**
+         * @brief Constructs the object directly inside the storage, this avoids copying large objects into the storage after they've been constructed
+         */
+        template<typename... Args>
+        ObjIStorage(const DeviceState &state, ServiceManager &manager, std::in_place_t, Args &&... args) : IStorage(state, manager, true), obj(std::forward<Args>(args)...) {}
 
         ~ObjIStorage() override = default;
 
@@ -3,6 +3,7 @@
 // Copyright © 2022 yuzu Emulator Project (https://github.com/yuzu-emu/)
 
 #include <audio.h>
+#include <common/host_affinity.h>
 #include <kernel/types/KProcess.h>
 #include "IAudioOut.h"
 
@@ -15,7 +16,8 @@ namespace skyline::service::audio {
            releaseEventWrapper{[releaseEvent = this->releaseEvent]() { releaseEvent->Signal(); },
                                [releaseEvent = this->releaseEvent]() { releaseEvent->ResetSignal(); }},
            impl{std::make_shared<AudioCore::AudioOut::Out>(state.audio->audioSystem, *state.audio->audioOutManager, &releaseEventWrapper, sessionId)} {
-
+        // The audio core creates its output stream threads on the calling guest thread, they'd inherit its placement on a performance core otherwise
+        HostAffinity::ScopedPlacement placement{HostThreadRole::Audio};
         if (impl->GetSystem().Initialize(std::string{deviceName}, parameters, handle, appletResourceUserId).IsError())
             Logger::Warn("Failed to initialise Audio Out");
     }
@@ -30,6 +32,7 @@ namespace skyline::service::audio {
     }
 
     Result IAudioOut::StartAudioOut(type::KSession &session, ipc::IpcRequest &request, ipc::IpcResponse &response) {
+        HostAffinity::ScopedPlacement placement{HostThreadRole::Audio};
         return Result{impl->StartSystem()};
     }
 
@@ -38,6 +41,7 @@ namespace skyline::service::audio {
     }
 
     Result IAudioOut::AppendAudioOutBuffer(type::KSession &session, ipc::IpcRequest &request, ipc::IpcResponse &response) {
+        // The buffer descriptor is passed by reference into the IPC buffer, the samples themselves are only read from guest memory by the audio core when the buffer is queued to the sink
         const auto &buffer{request.inputBuf.at(0).as<AudioCore::AudioOut::AudioOutBuffer>()};
         auto tag{request.Pop<u64>()};
 
@@ -52,12 +56,11 @@ namespace skyline::service::audio {
     }
 
     Result IAudioOut::GetReleasedAudioOutBuffer(type::KSession &session, ipc::IpcRequest &request, ipc::IpcResponse &response) {
-        auto maxCount{request.outputBuf.at(0).size() >> 3};
-
-        std::vector<u64> releasedBuffers(maxCount);
+        // The tags are written directly into the output buffer rather than an intermediate vector, any entries past the released buffers are zeroed as they would be otherwise
+        auto releasedBuffers{request.outputBuf.at(0).cast<u64, std::dynamic_extent, true>()};
         auto count{impl->GetReleasedBuffers(releasedBuffers)};
+        std::fill(releasedBuffers.begin() + count, releasedBuffers.end(), 0);
 
-        request.outputBuf.at(0).copy_from(releasedBuffers);
         response.Push<u32>(count);
         return {};
     }
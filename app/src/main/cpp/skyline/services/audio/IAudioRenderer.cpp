@@ -3,6 +3,7 @@
 // Copyright © 2022 yuzu Emulator Project (https://github.com/yuzu-emu/)
 
 #include <audio.h>
+#include <common/host_affinity.h>
 #include <kernel/types/KProcess.h>
 #include "IAudioRenderer.h"
 
@@ -17,6 +18,8 @@ namespace skyline::service::audio {
                               [renderedEvent = this->renderedEvent]() { renderedEvent->ResetSignal(); }},
           transferMemoryWrapper{transferMemorySize},
           impl{state.audio->audioSystem, rendererManager, &renderedEventWrapper} {
+        // The audio core creates its rendering and output threads on the calling guest thread, they'd inherit its placement on a performance core otherwise
+        HostAffinity::ScopedPlacement placement{HostThreadRole::Audio};
         impl.Initialize(params, &transferMemoryWrapper, transferMemorySize, processHandle, appletResourceUserId, sessionId);
     }
 
@@ -58,6 +61,7 @@ namespace skyline::service::audio {
     }
 
     Result IAudioRenderer::Start(type::KSession &session, ipc::IpcRequest &request, ipc::IpcResponse &response) {
+        HostAffinity::ScopedPlacement placement{HostThreadRole::Audio};
         impl.GetSystem().Start();
         return {};
     }
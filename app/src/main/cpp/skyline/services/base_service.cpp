@@ -3,6 +3,7 @@
 
 #include <cxxabi.h>
 #include <common/trace.h>
+#include "serviceman.h"
 #include "base_service.h"
 
 namespace skyline::service {
@@ -20,19 +21,20 @@ namespace skyline::service {
     }
 
     Result service::BaseService::HandleRequest(type::KSession &session, ipc::IpcRequest &request, ipc::IpcResponse &response) {
-        ServiceFunctionDescriptor function;
         u32 functionId{request.isTipc ? static_cast<u32>(request.header->type) : request.payload->value};
 
-        try {
-            function = GetServiceFunction(functionId, request.isTipc);
-            Logger::DebugNoPrefix("Service: {}", function.name);
-        } catch (const std::out_of_range &) {
+        auto function{GetServiceFunction(functionId, request.isTipc)};
+        if (!function.function) [[unlikely]] {
             Logger::Warn("Cannot find {0} function in service '{1}': 0x{2:X} ({2})", request.isTipc ? "TIPC" : "HIPC", GetName(), static_cast<u32>(functionId));
             return {};
         }
+        Logger::DebugNoPrefix("Service: {}", function.name);
         TRACE_EVENT("service", perfetto::StaticString{function.name});
         try {
-            return function(session, request, response);
+            auto start{util::GetTimeNs()};
+            auto result{function(session, request, response)};
+            manager.RecordServiceCall(function.name, functionId, request.isTipc, static_cast<u64>(util::GetTimeNs() - start));
+            return result;
         } catch (exception &e) {
             // We need to forward any skyline::exception objects without modification even though they inherit from std::exception
             std::rethrow_exception(std::current_exception());
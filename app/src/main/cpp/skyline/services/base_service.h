@@ -20,11 +20,13 @@ Result CallBaseFunction(type::KSession &session, ipc::IpcRequest &request, ipc::
 SERVICE_DECL_AUTO(functions, frozen::make_unordered_map({__VA_ARGS__}));                                       \
 protected:                                                                                                     \
 ServiceFunctionDescriptor GetServiceFunction(u32 id, bool isTipc) override {                                   \
-    auto& function{functions.at((isTipc ? TipcFunctionIdFlag : 0U) | id)};                                     \
+    auto it{functions.find((isTipc ? TipcFunctionIdFlag : 0U) | id)};                                          \
+    if (it == functions.end()) [[unlikely]]                                                                    \
+        return {};                                                                                             \
     return ServiceFunctionDescriptor{                                                                          \
         reinterpret_cast<DerivedService*>(this),                                                               \
-        reinterpret_cast<decltype(ServiceFunctionDescriptor::function)>(function.first),                       \
-        function.second                                                                                        \
+        reinterpret_cast<decltype(ServiceFunctionDescriptor::function)>(it->second.first),                     \
+        it->second.second                                                                                      \
     };                                                                                                         \
 }
 #define SRVREG(class, ...) std::make_shared<class>(state, manager, ##__VA_ARGS__)
@@ -73,8 +75,12 @@ namespace skyline::service {
          */
         virtual ~BaseService() = default;
 
+        /**
+         * @return The descriptor for the function with the supplied ID, its function pointer will be null if the service doesn't implement it
+         * @note This is looked up in a perfect hash table generated at compile-time by SERVICE_DECL, it must not throw as it's called for every request
+         */
         virtual ServiceFunctionDescriptor GetServiceFunction(u32 id, bool isTipc) {
-            throw std::out_of_range("GetServiceFunction not implemented");
+            return {};
         }
 
         /**
@@ -16,6 +16,7 @@ namespace skyline::service::codec {
           sampleRate(sampleRate),
           channelCount(channelCount),
           workBuffer(state.process->GetHandle<kernel::type::KTransferMemory>(workBufferHandle)),
+          maxFrameSize((isIsLargerSize ? MaxFrameSizeEx : MaxFrameSizeNormal) / (OpusFullbandSampleRate / sampleRate)),
           decoderOutputBufferSize(CalculateOutBufferSize(sampleRate, channelCount, isIsLargerSize ? MaxFrameSizeEx : MaxFrameSizeNormal)) {
         if (workBufferSize < decoderOutputBufferSize)
             throw exception("Work Buffer doesn't have adequate space for Opus Decoder: 0x{:X} (Required: 0x{:X})", workBufferSize, decoderOutputBufferSize);
@@ -23,7 +24,24 @@ namespace skyline::service::codec {
         // We utilize the guest-supplied work buffer for allocating the OpusDecoder object into
         decoderState = reinterpret_cast<OpusDecoder *>(workBuffer->host.data());
 
-        if (int result = opus_decoder_init(decoderState, sampleRate, channelCount) != OPUS_OK)
+        if (int result{opus_decoder_init(decoderState, sampleRate, channelCount)}; result != OPUS_OK)
+            throw OpusException(result);
+    }
+
+    IHardwareOpusDecoder::IHardwareOpusDecoder(const DeviceState &state, ServiceManager &manager, const MultiStreamParameters &parameters, u32 workBufferSize, KHandle workBufferHandle, bool isIsLargerSize)
+        : BaseService(state, manager),
+          sampleRate(parameters.sampleRate),
+          channelCount(parameters.channelCount),
+          workBuffer(state.process->GetHandle<kernel::type::KTransferMemory>(workBufferHandle)),
+          maxFrameSize((isIsLargerSize ? MaxFrameSizeEx : MaxFrameSizeNormal) / (OpusFullbandSampleRate / parameters.sampleRate)),
+          decoderOutputBufferSize(CalculateOutBufferSize(parameters.sampleRate, parameters.channelCount, isIsLargerSize ? MaxFrameSizeEx : MaxFrameSizeNormal)) {
+        if (workBufferSize < decoderOutputBufferSize)
+            throw exception("Work Buffer doesn't have adequate space for Opus Decoder: 0x{:X} (Required: 0x{:X})", workBufferSize, decoderOutputBufferSize);
+
+        // The multi-stream decoder is placed into the work buffer in the same way as the single-stream one, it contains the state of every stream
+        multiStreamDecoderState = reinterpret_cast<OpusMSDecoder *>(workBuffer->host.data());
+
+        if (int result{opus_multistream_decoder_init(multiStreamDecoderState, sampleRate, channelCount, parameters.streamCount, parameters.stereoStreamCount, parameters.mappings.data())}; result != OPUS_OK)
             throw OpusException(result);
     }
 
@@ -44,7 +62,10 @@ namespace skyline::service::codec {
     }
 
     void IHardwareOpusDecoder::ResetContext() {
-        opus_decoder_ctl(decoderState, OPUS_RESET_STATE);
+        if (multiStreamDecoderState)
+            opus_multistream_decoder_ctl(multiStreamDecoderState, OPUS_RESET_STATE);
+        else
+            opus_decoder_ctl(decoderState, OPUS_RESET_STATE);
     }
 
     Result IHardwareOpusDecoder::DecodeInterleavedImpl(ipc::IpcRequest &request, ipc::IpcResponse &response, bool writeDecodeTime) {
@@ -62,8 +83,13 @@ namespace skyline::service::codec {
         // Skip past the header in the input buffer to get the Opus packet
         auto sampleDataIn = dataIn.subspan(sizeof(OpusDataHeader));
 
+        // The frame size is bounded by the guest's output buffer so that all frames in the packet are decoded directly into it in a single call
+        i32 frameSize{std::min(maxFrameSize, static_cast<i32>(dataOut.size() / static_cast<size_t>(channelCount)))};
+
         auto perfTimer{timesrv::TimeSpanType::FromNanoseconds(util::GetTimeNs())};
-        i32 decodedCount{opus_decode(decoderState, sampleDataIn.data(), opusPacketSize, dataOut.data(), static_cast<int>(decoderOutputBufferSize), false)};
+        i32 decodedCount{multiStreamDecoderState ?
+                         opus_multistream_decode(multiStreamDecoderState, sampleDataIn.data(), opusPacketSize, dataOut.data(), frameSize, false) :
+                         opus_decode(decoderState, sampleDataIn.data(), opusPacketSize, dataOut.data(), frameSize, false)};
         perfTimer = timesrv::TimeSpanType::FromNanoseconds(util::GetTimeNs()) - perfTimer;
 
         if (decodedCount < 0)
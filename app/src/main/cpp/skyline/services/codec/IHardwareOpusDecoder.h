@@ -4,10 +4,12 @@
 #pragma once
 
 #include <opus.h>
+#include <opus_multistream.h>
 
 #include <common.h>
 #include <services/base_service.h>
 #include <kernel/types/KTransferMemory.h>
+#include "IHardwareOpusDecoderManager.h"
 
 namespace skyline::service::codec {
     /**
@@ -27,9 +29,11 @@ namespace skyline::service::codec {
     class IHardwareOpusDecoder : public BaseService {
       private:
         std::shared_ptr<kernel::type::KTransferMemory> workBuffer;
-        OpusDecoder *decoderState{};
+        OpusDecoder *decoderState{}; //!< The state of a single-stream decoder, this is null for multi-stream decoders
+        OpusMSDecoder *multiStreamDecoderState{}; //!< The state of a multi-stream decoder, this is null for single-stream decoders
         i32 sampleRate;
         i32 channelCount;
+        i32 maxFrameSize; //!< The maximum amount of samples per channel that can be decoded from a single packet
         u32 decoderOutputBufferSize;
 
         /**
@@ -54,12 +58,18 @@ namespace skyline::service::codec {
 
         /**
          * @brief Decodes Opus source data via libopus
+         * @note Packets are decoded directly into the guest's output buffer regardless of the stream count, no intermediate buffers are used
          */
         Result DecodeInterleavedImpl(ipc::IpcRequest &request, ipc::IpcResponse &response, bool writeDecodeTime = false);
 
       public:
         IHardwareOpusDecoder(const DeviceState &state, ServiceManager &manager, i32 sampleRate, i32 channelCount, u32 workBufferSize, KHandle workBufferHandle, bool isIsLargerSize = false);
 
+        /**
+         * @brief Creates a multi-stream decoder with the supplied stream layout
+         */
+        IHardwareOpusDecoder(const DeviceState &state, ServiceManager &manager, const MultiStreamParameters &parameters, u32 workBufferSize, KHandle workBufferHandle, bool isIsLargerSize = false);
+
         /**
          * @brief Decodes the Opus source data, returns decoded data size and decoded sample count
          * @url https://switchbrew.org/wiki/Audio_services#DecodeInterleavedOld
@@ -81,9 +91,13 @@ namespace skyline::service::codec {
 
         SERVICE_DECL(
             SFUNC(0x0, IHardwareOpusDecoder, DecodeInterleavedOld),
+            SFUNC(0x1, IHardwareOpusDecoder, DecodeInterleavedOld), // DecodeInterleavedForMultiStreamOld
             SFUNC(0x4, IHardwareOpusDecoder, DecodeInterleavedWithPerfOld),
+            SFUNC(0x5, IHardwareOpusDecoder, DecodeInterleavedWithPerfOld), // DecodeInterleavedForMultiStreamWithPerfOld
             SFUNC(0x6, IHardwareOpusDecoder, DecodeInterleaved), // DecodeInterleavedWithPerfAndResetOld is effectively the same as DecodeInterleaved
+            SFUNC(0x7, IHardwareOpusDecoder, DecodeInterleaved), // DecodeInterleavedForMultiStreamWithPerfAndResetOld
             SFUNC(0x8, IHardwareOpusDecoder, DecodeInterleaved),
+            SFUNC(0x9, IHardwareOpusDecoder, DecodeInterleaved), // DecodeInterleavedForMultiStream
         )
     };
 
@@ -13,6 +13,14 @@ namespace skyline::service::codec {
         return requiredSize;
     }
 
+    static u32 CalculateMultiStreamBufferSize(const MultiStreamParameters &parameters) {
+        i32 stateSize{opus_multistream_decoder_get_size(parameters.streamCount, parameters.stereoStreamCount)};
+        if (stateSize <= 0)
+            throw exception("Invalid Opus multi-stream layout: {} streams with {} stereo streams", parameters.streamCount, parameters.stereoStreamCount);
+
+        return static_cast<u32>(stateSize) + MaxInputBufferSize + CalculateOutBufferSize(parameters.sampleRate, parameters.channelCount, MaxFrameSizeNormal);
+    }
+
     Result IHardwareOpusDecoderManager::OpenHardwareOpusDecoder(type::KSession &session, ipc::IpcRequest &request, ipc::IpcResponse &response) {
         i32 sampleRate{request.Pop<i32>()};
         i32 channelCount{request.Pop<i32>()};
@@ -33,6 +41,22 @@ namespace skyline::service::codec {
         return {};
     }
 
+    Result IHardwareOpusDecoderManager::OpenHardwareOpusDecoderForMultiStream(type::KSession &session, ipc::IpcRequest &request, ipc::IpcResponse &response) {
+        u32 workBufferSize{request.Pop<u32>()};
+        KHandle workBuffer{request.copyHandles.at(0)};
+        auto parameters{request.inputBuf.at(0).as<MultiStreamParameters>()};
+
+        Logger::Debug("Creating Opus multi-stream decoder: Sample rate: {}, Channel count: {}, Stream count: {} (Stereo: {}), Work buffer handle: 0x{:X} (Size: 0x{:X})", parameters.sampleRate, parameters.channelCount, parameters.streamCount, parameters.stereoStreamCount, workBuffer, workBufferSize);
+
+        manager.RegisterService(std::make_shared<IHardwareOpusDecoder>(state, manager, parameters, workBufferSize, workBuffer), session, response);
+        return {};
+    }
+
+    Result IHardwareOpusDecoderManager::GetWorkBufferSizeForMultiStream(type::KSession &session, ipc::IpcRequest &request, ipc::IpcResponse &response) {
+        response.Push<u32>(CalculateMultiStreamBufferSize(request.inputBuf.at(0).as<MultiStreamParameters>()));
+        return {};
+    }
+
     Result IHardwareOpusDecoderManager::OpenHardwareOpusDecoderEx(type::KSession &session, ipc::IpcRequest &request, ipc::IpcResponse &response) {
         i32 sampleRate{request.Pop<i32>()};
         i32 channelCount{request.Pop<i32>()};
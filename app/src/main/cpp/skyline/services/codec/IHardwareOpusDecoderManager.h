@@ -39,6 +39,18 @@ namespace skyline::service::codec {
          */
         Result GetWorkBufferSize(type::KSession &session, ipc::IpcRequest &request, ipc::IpcResponse &response);
 
+        /**
+         * @brief Returns an IHardwareOpusDecoder object which decodes multi-stream packets
+         * @url https://switchbrew.org/wiki/Audio_services#OpenHardwareOpusDecoderForMultiStream
+         */
+        Result OpenHardwareOpusDecoderForMultiStream(type::KSession &session, ipc::IpcRequest &request, ipc::IpcResponse &response);
+
+        /**
+         * @brief Returns the required size for a multi-stream decoder's work buffer
+         * @url https://switchbrew.org/wiki/Audio_services#GetWorkBufferSizeForMultiStream
+         */
+        Result GetWorkBufferSizeForMultiStream(type::KSession &session, ipc::IpcRequest &request, ipc::IpcResponse &response);
+
         /**
          * @brief Returns an IHardwareOpusDecoder object [12.0.0+]
          * @url https://switchbrew.org/wiki/Audio_services#OpenHardwareOpusDecoder
@@ -54,6 +66,8 @@ namespace skyline::service::codec {
         SERVICE_DECL(
             SFUNC(0x0, IHardwareOpusDecoderManager, OpenHardwareOpusDecoder),
             SFUNC(0x1, IHardwareOpusDecoderManager, GetWorkBufferSize),
+            SFUNC(0x2, IHardwareOpusDecoderManager, OpenHardwareOpusDecoderForMultiStream),
+            SFUNC(0x3, IHardwareOpusDecoderManager, GetWorkBufferSizeForMultiStream),
             SFUNC(0x4, IHardwareOpusDecoderManager, OpenHardwareOpusDecoderEx),
             SFUNC(0x5, IHardwareOpusDecoderManager, GetWorkBufferSizeEx),
         )
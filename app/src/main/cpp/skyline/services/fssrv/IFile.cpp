@@ -1,10 +1,23 @@
 // SPDX-License-Identifier: MPL-2.0
 // Copyright © 2020 Skyline Team and Contributors (https://github.com/skyline-emu/)
 
+#include <BS_thread_pool.hpp>
 #include "results.h"
 #include "IFile.h"
 
 namespace skyline::service::fssrv {
+    constexpr u32 StreamThreshold{2}; //!< The amount of consecutive sequential reads after which a file is considered to be streamed
+    constexpr size_t PrefetchChunkSize{0x40000}; //!< The size of a single prefetched chunk
+    constexpr size_t PrefetchDepth{4}; //!< The maximum amount of chunks that are read ahead of the guest
+
+    /**
+     * @return The pool that all files are prefetched on, a single worker is used as prefetching is IO-bound and chunks must complete in order
+     */
+    static BS::thread_pool &GetPrefetchPool() {
+        static BS::thread_pool pool{1};
+        return pool;
+    }
+
     IFile::IFile(std::shared_ptr<vfs::Backing> backing, const DeviceState &state, ServiceManager &manager)
         : BaseService(state, manager),
           backing(std::move(backing)) {}
@@ -25,10 +38,66 @@ namespace skyline::service::fssrv {
             return result::InvalidSize;
         }
 
-        response.Push<u64>(backing->ReadUnchecked(request.outputBuf.at(0), static_cast<size_t>(offset)));
+        auto output{request.outputBuf.at(0)};
+        if (backing->mode.write || backing->mode.append)
+            response.Push<u64>(backing->ReadUnchecked(output, static_cast<size_t>(offset)));
+        else
+            response.Push<u64>(ReadPrefetched(output, static_cast<size_t>(offset)));
         return {};
     }
 
+    size_t IFile::ReadPrefetched(span<u8> output, size_t offset) {
+        std::scoped_lock lock{prefetchMutex};
+
+        if (offset == lastReadEnd) {
+            sequentialReads++;
+        } else {
+            // Any queued chunks are abandoned on a seek, they'll still complete in the background but are discarded
+            sequentialReads = 0;
+            prefetchQueue.clear();
+        }
+
+        size_t position{offset};
+        while (!prefetchQueue.empty() && position < offset + output.size()) {
+            auto &chunk{prefetchQueue.front()};
+            const auto &data{chunk.data.get()};
+            if (position >= chunk.offset + data.size()) {
+                prefetchQueue.pop_front();
+                continue;
+            } else if (position < chunk.offset) {
+                break;
+            }
+
+            size_t copySize{std::min(offset + output.size(), chunk.offset + data.size()) - position};
+            std::memcpy(output.data() + (position - offset), data.data() + (position - chunk.offset), copySize);
+            position += copySize;
+
+            if (position == chunk.offset + data.size())
+                prefetchQueue.pop_front();
+        }
+
+        if (position < offset + output.size())
+            position += backing->ReadUnchecked(output.subspan(position - offset), position);
+        lastReadEnd = position;
+
+        if (sequentialReads >= StreamThreshold) {
+            size_t nextOffset{prefetchQueue.empty() ? position : prefetchQueue.back().offset + PrefetchChunkSize};
+            while (prefetchQueue.size() < PrefetchDepth && nextOffset < backing->size) {
+                prefetchQueue.push_back(PrefetchChunk{
+                    .offset = nextOffset,
+                    .data = GetPrefetchPool().submit([backing = backing, nextOffset]() {
+                        std::vector<u8> data(std::min(PrefetchChunkSize, backing->size - nextOffset));
+                        data.resize(backing->ReadUnchecked(data, nextOffset));
+                        return data;
+                    }).share(),
+                });
+                nextOffset += PrefetchChunkSize;
+            }
+        }
+
+        return position - offset;
+    }
+
     Result IFile::Write(type::KSession &session, ipc::IpcRequest &request, ipc::IpcResponse &response) {
         auto writeOption{request.Pop<u32>()};
         request.Skip<u32>();
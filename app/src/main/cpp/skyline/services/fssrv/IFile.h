@@ -3,6 +3,7 @@
 
 #pragma once
 
+#include <deque>
 #include <services/serviceman.h>
 #include <vfs/backing.h>
 
@@ -13,7 +14,25 @@ namespace skyline::service::fssrv {
      */
     class IFile : public BaseService {
       private:
+        /**
+         * @brief A chunk of the file which is being read ahead of the guest asynchronously
+         */
+        struct PrefetchChunk {
+            size_t offset;
+            std::shared_future<std::vector<u8>> data; //!< The contents of the chunk, this may be shorter than the chunk size at the end of the file
+        };
+
         std::shared_ptr<vfs::Backing> backing;
+        std::mutex prefetchMutex; //!< Synchronizes access to the sequential read state and the prefetch queue
+        size_t lastReadEnd{}; //!< The offset at which the previous read ended
+        u32 sequentialReads{}; //!< The amount of consecutive reads that started where the prior one ended
+        std::deque<PrefetchChunk> prefetchQueue; //!< Chunks following the last read in ascending order of offset
+
+        /**
+         * @brief Reads data from the backing, serving it from the prefetched chunks where possible and queuing further chunks when the file is being streamed
+         * @note This must only be used with read-only backings as writes aren't reflected in prefetched chunks
+         */
+        size_t ReadPrefetched(span<u8> output, size_t offset);
 
       public:
         IFile(std::shared_ptr<vfs::Backing> backing, const DeviceState &state, ServiceManager &manager);
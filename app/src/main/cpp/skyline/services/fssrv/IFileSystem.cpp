@@ -83,7 +83,7 @@ namespace skyline::service::fssrv {
     }
 
     Result IFileSystem::Commit(type::KSession &session, ipc::IpcRequest &request, ipc::IpcResponse &response) {
-        return {};
+        return backing->Commit() ? Result{} : result::UnexpectedFailure;
     }
 
     Result IFileSystem::GetFreeSpaceSize(type::KSession &session, ipc::IpcRequest &request, ipc::IpcResponse &response) {
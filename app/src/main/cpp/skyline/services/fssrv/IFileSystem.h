@@ -18,6 +18,13 @@ namespace skyline::service::fssrv {
       public:
         IFileSystem(std::shared_ptr<vfs::FileSystem> backing, const DeviceState &state, ServiceManager &manager);
 
+        /**
+         * @return The filesystem this service provides access to
+         */
+        const std::shared_ptr<vfs::FileSystem> &GetBacking() {
+            return backing;
+        }
+
         /**
          * @brief Creates a file at the specified path in the filesystem
          */
@@ -3,6 +3,7 @@
 
 #include <os.h>
 #include <vfs/os_filesystem.h>
+#include <vfs/write_back_filesystem.h>
 #include <loader/loader.h>
 #include "results.h"
 #include "IStorage.h"
@@ -64,7 +65,15 @@ namespace skyline::service::fssrv {
             }
         }()};
 
-        manager.RegisterService(std::make_shared<IFileSystem>(std::make_shared<vfs::OsFileSystem>(state.os->publicAppFilesPath + "/switch" + saveDataPath), state, manager), session, response);
+        // Savedata is written back on commit as titles commonly perform many small writes to it which would otherwise each go to the host filesystem
+        auto &weakFileSystem{saveDataFileSystems[saveDataPath]};
+        auto fileSystem{weakFileSystem.lock()};
+        if (!fileSystem) {
+            fileSystem = std::make_shared<vfs::WriteBackFileSystem>(state.os->publicAppFilesPath + "/switch" + saveDataPath);
+            weakFileSystem = fileSystem;
+        }
+
+        manager.RegisterService(std::make_shared<IFileSystem>(std::move(fileSystem), state, manager), session, response);
         return {};
     }
 
@@ -56,6 +56,9 @@ namespace skyline::service::fssrv {
      * @url https://switchbrew.org/wiki/Filesystem_services#fsp-srv
      */
     class IFileSystemProxy : public BaseService {
+      private:
+        std::unordered_map<std::string, std::weak_ptr<vfs::FileSystem>> saveDataFileSystems; //!< The savedata filesystems that are open, these are shared between all sessions so they use the same write-back cache
+
       public:
         u64 process{}; //!< The PID as set by SetCurrentProcess
 
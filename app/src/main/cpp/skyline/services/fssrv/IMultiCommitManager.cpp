@@ -1,16 +1,26 @@
 // SPDX-License-Identifier: MPL-2.0
 // Copyright © 2023 Skyline Team and Contributors (https://github.com/skyline-emu/)
 
+#include "results.h"
 #include "IMultiCommitManager.h"
 
 namespace skyline::service::fssrv {
     IMultiCommitManager::IMultiCommitManager(const DeviceState &state, ServiceManager &manager) : BaseService(state, manager) {}
 
     Result IMultiCommitManager::Add(type::KSession &session, ipc::IpcRequest &request, ipc::IpcResponse &response) {
+        if (fileSystems.size() >= FileSystemCountMax)
+            return result::InvalidArgument;
+
+        fileSystems.push_back(request.PopService<IFileSystem>(0, session)->GetBacking());
         return {};
     }
 
     Result IMultiCommitManager::Commit(type::KSession &session, ipc::IpcRequest &request, ipc::IpcResponse &response) {
-        return {};
+        bool success{true};
+        for (const auto &fileSystem : fileSystems)
+            success &= fileSystem->Commit();
+
+        fileSystems.clear();
+        return success ? Result{} : result::UnexpectedFailure;
     }
 }
@@ -4,12 +4,18 @@
 #pragma once
 
 #include <services/serviceman.h>
+#include "IFileSystem.h"
 
 namespace skyline::service::fssrv {
     /**
      * @url https://switchbrew.org/wiki/Filesystem_services#IMultiCommitManager
      */
     class IMultiCommitManager : public BaseService {
+      private:
+        static constexpr size_t FileSystemCountMax{10}; //!< The maximum amount of filesystems that can be added to a single commit
+
+        std::vector<std::shared_ptr<vfs::FileSystem>> fileSystems; //!< The filesystems that will be committed together
+
       public:
         IMultiCommitManager(const DeviceState &state, ServiceManager &manager);
 
@@ -14,7 +14,7 @@ namespace skyline::service::hid {
 
         if (NpadManager::IsNpadIdValid(handle.id))
             if (!handle.isRight)
-                state.input->npad.at(handle.id).vibrationRight = NpadVibrationValue{};
+                state.input->npad.at(handle.id).ResetVibrationRight();
 
         return {};
     }
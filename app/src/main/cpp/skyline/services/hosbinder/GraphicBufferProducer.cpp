@@ -94,7 +94,7 @@ namespace skyline::service::hosbinder {
 
         std::unique_lock lock{mutex};
         auto buffer{queue.end()};
-        freeCondition.wait(lock, [&]() {
+        auto findSlot{[&]() {
             size_t dequeuedSlotCount{};
             for (auto it{queue.begin()}; it != std::min(queue.begin() + activeSlotCount, queue.end()); it++) {
                 // We want to select the oldest slot that's free to use as we'd want all slots to be used
@@ -118,7 +118,18 @@ namespace skyline::service::hosbinder {
 
             buffer = queue.end();
             return false;
-        });
+        }};
+
+        while (true) {
+            // The sequence must be read prior to searching for a slot so that a slot freed after the search ends the wait immediately
+            auto sequence{freeSequence.load(std::memory_order_acquire)};
+            if (findSlot())
+                break;
+
+            lock.unlock();
+            freeSequence.wait(sequence, std::memory_order_acquire);
+            lock.lock();
+        }
 
         if (slot == InvalidGraphicBufferSlot) [[unlikely]]
             return AndroidStatus::InvalidOperation;
@@ -400,10 +411,13 @@ namespace skyline::service::hosbinder {
         std::weak_ptr<GraphicBufferProducer> weakThis{shared_from_this()};
         state.gpu->presentation.Present(buffer.texture, isAutoTimestamp ? 0 : timestamp, swapInterval, crop, scalingMode, transform, fence, [weakThis, &buffer] {
             if (auto gbp{weakThis.lock()}) {
-                std::scoped_lock lock{gbp->mutex};
-                buffer.state = BufferState::Free;
+                // The queue isn't locked here as this is called by the presentation thread for every frame and would contend with the guest, the slot is only freed if it's still queued as it may have been reset in the meantime
+                auto expected{BufferState::Queued};
+                if (buffer.state.compare_exchange_strong(expected, BufferState::Free, std::memory_order_release, std::memory_order_relaxed)) {
+                    gbp->freeSequence.fetch_add(1, std::memory_order_release);
+                    gbp->freeSequence.notify_all();
+                }
                 gbp->bufferEvent->Signal();
-                gbp->freeCondition.notify_all();
             }
         });
 
@@ -40,7 +40,7 @@ namespace skyline::service::hosbinder {
      * @url https://cs.android.com/android/platform/superproject/+/android-5.1.1_r38:frameworks/native/include/gui/BufferSlot.h;l=32-138
      */
     struct BufferSlot {
-        BufferState state{BufferState::Free};
+        std::atomic<BufferState> state{BufferState::Free}; //!< The state of the slot, this is atomic as queued slots are freed by the presentation thread without locking the queue
         u64 frameNumber{}; //!< The amount of frames that have been queued using this slot
         bool wasBufferRequested{}; //!< If GraphicBufferProducer::RequestBuffer has been called with this buffer
         bool isPreallocated{}; //!< If this slot's graphic buffer has been preallocated or attached
@@ -62,7 +62,7 @@ namespace skyline::service::hosbinder {
       private:
         const DeviceState &state;
         std::mutex mutex; //!< Synchronizes access to the buffer queue
-        std::condition_variable freeCondition; //!< Used to wait for a free buffer slot
+        std::atomic<u32> freeSequence{}; //!< Incremented every time a queued slot is freed after presentation, it's waited on for a free buffer slot
         constexpr static u8 MaxSlotCount{16}; //!< The maximum amount of buffer slots that a buffer queue can hold, Android supports 64 but they go unused for applications like games so we've lowered this to 16 (https://cs.android.com/android/platform/superproject/+/android-5.1.1_r38:frameworks/native/include/gui/BufferQueueDefs.h;l=29)
         std::array<BufferSlot, MaxSlotCount> queue;
         u8 activeSlotCount{}; //!< The amount of slots in the queue that can be dequeued
@@ -20,8 +20,10 @@ namespace skyline::service::hosbinder {
 
         auto code{request.Pop<GraphicBufferProducer::TransactionCode>()};
 
-        Parcel in(request.inputBuf.at(0), state, true);
-        Parcel out(state);
+        // The parcels are reused by all transactions on a thread as several are done every frame and would otherwise allocate their storage each time
+        thread_local Parcel in(state), out(state);
+        in.Read(request.inputBuf.at(0), true);
+        out.Clear();
 
         if (!layer)
             throw exception("Transacting parcel with non-existant layer");
@@ -5,6 +5,12 @@
 
 namespace skyline::service::hosbinder {
     Parcel::Parcel(span<u8> buffer, const DeviceState &state, bool hasToken) : state(state) {
+        Read(buffer, hasToken);
+    }
+
+    Parcel::Parcel(const DeviceState &state) : state(state) {}
+
+    void Parcel::Read(span<u8> buffer, bool hasToken) {
         header = buffer.as<ParcelHeader>();
 
         if (buffer.size() < (sizeof(ParcelHeader) + header.dataSize + header.objectsSize))
@@ -12,14 +18,20 @@ namespace skyline::service::hosbinder {
 
         constexpr u8 tokenLength{0x50}; // The length of the token on BufferQueue parcels
 
-        data.resize(header.dataSize - (hasToken ? tokenLength : 0));
-        std::memcpy(data.data(), buffer.data() + header.dataOffset + (hasToken ? tokenLength : 0), header.dataSize - (hasToken ? tokenLength : 0));
+        auto dataStart{buffer.data() + header.dataOffset + (hasToken ? tokenLength : 0)};
+        data.assign(dataStart, dataStart + (header.dataSize - (hasToken ? tokenLength : 0)));
 
-        objects.resize(header.objectsSize);
-        std::memcpy(objects.data(), buffer.data() + header.objectsOffset, header.objectsSize);
+        auto objectsStart{buffer.data() + header.objectsOffset};
+        objects.assign(objectsStart, objectsStart + header.objectsSize);
+
+        dataOffset = 0;
     }
 
-    Parcel::Parcel(const DeviceState &state) : state(state) {}
+    void Parcel::Clear() {
+        data.clear();
+        objects.clear();
+        dataOffset = 0;
+    }
 
     u64 Parcel::WriteParcel(span<u8> buffer) {
         header.dataSize = static_cast<u32>(data.size());
@@ -39,6 +39,18 @@ namespace skyline::service::hosbinder {
          */
         Parcel(const DeviceState &state);
 
+        /**
+         * @brief Replaces the contents of the parcel with data from a IPC buffer, the existing storage is reused so this doesn't allocate after the first few transactions
+         * @param buffer The buffer that contains the parcel
+         * @param hasToken If the parcel starts with a token, it's skipped if this flag is true
+         */
+        void Read(span<u8> buffer, bool hasToken = false);
+
+        /**
+         * @brief Clears the contents of the parcel while retaining its storage so it can be reused for another transaction
+         */
+        void Clear();
+
         /**
          * @return A reference to an item from the top of data
          */
@@ -1,16 +1,32 @@
 // SPDX-License-Identifier: MPL-2.0
 // Copyright © 2022 Skyline Team and Contributors (https://github.com/skyline-emu/)
 
+#include <arpa/inet.h>
 #include "IUserLocalCommunicationService.h"
 #include <common/settings.h>
+#include <jvm.h>
 
 namespace skyline::service::ldn {
     IUserLocalCommunicationService::IUserLocalCommunicationService(const DeviceState &state, ServiceManager &manager)
         : BaseService(state, manager),
-          event{std::make_shared<type::KEvent>(state, false)} {}
+          event{std::make_shared<type::KEvent>(state, false)},
+          network{[this] { event->Signal(); }} {}
+
+    Result IUserLocalCommunicationService::InitializeNetwork() {
+        if (!*state.settings->isInternetEnabled)
+            return result::AirplaneModeEnabled;
+
+        auto dhcpInfo{state.jvm->GetDhcpInfo()};
+        if (!dhcpInfo.ipAddress)
+            return result::DeviceNotAvailable;
+
+        // Android no longer reports the netmask on all networks, a /24 is assumed in that case as it's what the vast majority of home networks use
+        auto netmask{dhcpInfo.subnet ? static_cast<in_addr_t>(dhcpInfo.subnet) : htonl(0xFFFFFF00)};
+        return network.Initialize(static_cast<in_addr_t>(dhcpInfo.ipAddress), netmask);
+    }
 
     Result IUserLocalCommunicationService::GetState(type::KSession &session, ipc::IpcRequest &request, ipc::IpcResponse &response) {
-        response.Push(State::Error);
+        response.Push(network.GetState());
         return {};
     }
 
@@ -20,28 +36,37 @@ namespace skyline::service::ldn {
             return result::InvalidInput;
         }
 
-        NetworkInfo networkInfo{};
-        request.outputBuf.at(0).as<NetworkInfo>() = networkInfo;
-        return {};
+        return network.GetNetworkInfo(request.outputBuf.at(0).as<NetworkInfo>());
     }
 
     Result IUserLocalCommunicationService::GetIpv4Address(type::KSession &session, ipc::IpcRequest &request, ipc::IpcResponse &response) {
+        auto [address, netmask]{network.GetIpv4Address()};
+        response.Push(address);
+        response.Push(netmask);
         return {};
     }
 
     Result IUserLocalCommunicationService::GetDisconnectReason(type::KSession &session, ipc::IpcRequest &request, ipc::IpcResponse &response) {
-        response.Push(DisconnectReason::None);
+        response.Push(network.GetDisconnectReason());
         return {};
     }
 
     Result IUserLocalCommunicationService::GetSecurityParameter(type::KSession &session, ipc::IpcRequest &request, ipc::IpcResponse &response) {
         SecurityParameter securityParameter{};
+        auto result{network.GetSecurityParameter(securityParameter)};
+        if (result)
+            return result;
+
         response.Push(securityParameter);
         return {};
     }
 
     Result IUserLocalCommunicationService::GetNetworkConfig(type::KSession &session, ipc::IpcRequest &request, ipc::IpcResponse &response) {
         NetworkConfig networkConfig{};
+        auto result{network.GetNetworkConfig(networkConfig)};
+        if (result)
+            return result;
+
         response.Push(networkConfig);
         return {};
     }
@@ -60,12 +85,7 @@ namespace skyline::service::ldn {
         if (nodeBufferCount == 0 || networkBuffferSize != sizeof(NetworkInfo))
             return result::InvalidInput;
 
-        NetworkInfo networkInfo{};
-        std::vector<NodeLatestUpdate> latestUpdate(nodeBufferCount);
-
-        request.outputBuf.at(0).as<NetworkInfo>() = networkInfo;
-        request.outputBuf.at(1).copy_from(latestUpdate);
-        return {};
+        return network.GetNetworkInfoLatestUpdate(request.outputBuf.at(0).as<NetworkInfo>(), request.outputBuf.at(1).cast<NodeLatestUpdate>());
     }
 
     Result IUserLocalCommunicationService::Scan(type::KSession &session, ipc::IpcRequest &request, ipc::IpcResponse &response) {
@@ -74,50 +94,83 @@ namespace skyline::service::ldn {
         if (networkInfoSize == 0)
             return result::InvalidInput;
 
-        std::vector<NetworkInfo> networkInfos(networkInfoSize);
-        request.outputBuf.at(0).copy_from(networkInfos);
-        response.Push<u32>(0);
+        request.Pop<WifiChannel>();
+        request.Skip<std::array<u8, 0x6>>();
+        auto &filter{request.Pop<ScanFilter>()};
+
+        size_t count{};
+        auto result{network.Scan(request.outputBuf.at(0).cast<NetworkInfo, std::dynamic_extent, true>(), filter, count)};
+        if (result)
+            return result;
+
+        response.Push<u32>(static_cast<u32>(count));
         return {};
     }
 
     Result IUserLocalCommunicationService::OpenAccessPoint(type::KSession &session, ipc::IpcRequest &request, ipc::IpcResponse &response) {
-        return {};
+        return network.OpenAccessPoint();
+    }
+
+    Result IUserLocalCommunicationService::CloseAccessPoint(type::KSession &session, ipc::IpcRequest &request, ipc::IpcResponse &response) {
+        return network.CloseAccessPoint();
     }
 
     Result IUserLocalCommunicationService::CreateNetwork(type::KSession &session, ipc::IpcRequest &request, ipc::IpcResponse &response) {
-        return {};
+        auto &securityConfig{request.Pop<SecurityConfig>()};
+        auto &userConfig{request.Pop<UserConfig>()};
+        request.Skip<u32>();
+        auto &networkConfig{request.Pop<NetworkConfig>()};
+        return network.CreateNetwork(securityConfig, userConfig, networkConfig);
     }
 
     Result IUserLocalCommunicationService::CreateNetworkPrivate(type::KSession &session, ipc::IpcRequest &request, ipc::IpcResponse &response) {
         return {};
     }
 
+    Result IUserLocalCommunicationService::DestroyNetwork(type::KSession &session, ipc::IpcRequest &request, ipc::IpcResponse &response) {
+        return network.DestroyNetwork();
+    }
+
     Result IUserLocalCommunicationService::SetAdvertiseData(type::KSession &session, ipc::IpcRequest &request, ipc::IpcResponse &response) {
-        return {};
+        return network.SetAdvertiseData(request.inputBuf.at(0));
+    }
+
+    Result IUserLocalCommunicationService::SetStationAcceptPolicy(type::KSession &session, ipc::IpcRequest &request, ipc::IpcResponse &response) {
+        return network.SetStationAcceptPolicy(request.Pop<AcceptPolicy>());
     }
 
     Result IUserLocalCommunicationService::OpenStation(type::KSession &session, ipc::IpcRequest &request, ipc::IpcResponse &response) {
-        return {};
+        return network.OpenStation();
     }
 
-    Result IUserLocalCommunicationService::InitializeSystem(type::KSession &session, ipc::IpcRequest &request, ipc::IpcResponse &response) {
-        if (!*state.settings->isInternetEnabled)
-            return result::AirplaneModeEnabled;
+    Result IUserLocalCommunicationService::CloseStation(type::KSession &session, ipc::IpcRequest &request, ipc::IpcResponse &response) {
+        return network.CloseStation();
+    }
+
+    Result IUserLocalCommunicationService::Connect(type::KSession &session, ipc::IpcRequest &request, ipc::IpcResponse &response) {
+        if (request.inputBuf.at(0).size() != sizeof(NetworkInfo))
+            return result::InvalidInput;
+
+        request.Skip<SecurityConfig>();
+        auto &userConfig{request.Pop<UserConfig>()};
+        auto localCommunicationVersion{request.Pop<u32>()};
+        return network.Connect(request.inputBuf.at(0).as<NetworkInfo>(), userConfig, static_cast<u16>(localCommunicationVersion));
+    }
 
-        isInitialized = true;
-        return result::AirplaneModeEnabled;
+    Result IUserLocalCommunicationService::Disconnect(type::KSession &session, ipc::IpcRequest &request, ipc::IpcResponse &response) {
+        return network.Disconnect();
+    }
+
+    Result IUserLocalCommunicationService::InitializeSystem(type::KSession &session, ipc::IpcRequest &request, ipc::IpcResponse &response) {
+        return InitializeNetwork();
     }
 
     Result IUserLocalCommunicationService::FinalizeSystem(type::KSession &session, ipc::IpcRequest &request, ipc::IpcResponse &response) {
-        isInitialized = false;
+        network.Finalize();
         return {};
     }
 
     Result IUserLocalCommunicationService::InitializeSystem2(type::KSession &session, ipc::IpcRequest &request, ipc::IpcResponse &response) {
-        if (!*state.settings->isInternetEnabled)
-            return result::AirplaneModeEnabled;
-
-        isInitialized = true;
-        return result::AirplaneModeEnabled;
+        return InitializeNetwork();
     }
 }
@@ -0,0 +1,555 @@
+// SPDX-License-Identifier: MPL-2.0
+// Copyright © 2023 Skyline Team and Contributors (https://github.com/skyline-emu/)
+
+#include <arpa/inet.h>
+#include <sys/eventfd.h>
+#include <poll.h>
+#include <unistd.h>
+#include "lan_network.h"
+
+namespace skyline::service::ldn {
+    LanNetwork::LanNetwork(std::function<void()> stateChangeCallback) : stateChangeCallback{std::move(stateChangeCallback)} {}
+
+    LanNetwork::~LanNetwork() {
+        Finalize();
+    }
+
+    void LanNetwork::Send(in_addr_t destination, PacketType type, span<const u8> payload) {
+        std::array<u8, PacketSizeMax> buffer;
+        PacketHeader header{
+            .magic = PacketMagic,
+            .type = type,
+            .size = static_cast<u16>(payload.size()),
+        };
+        std::memcpy(buffer.data(), &header, sizeof(PacketHeader));
+        std::memcpy(buffer.data() + sizeof(PacketHeader), payload.data(), payload.size());
+
+        sockaddr_in destinationAddress{
+            .sin_family = AF_INET,
+            .sin_port = htons(Port),
+            .sin_addr = {destination},
+        };
+        if (sendto(fd, buffer.data(), sizeof(PacketHeader) + payload.size(), 0, reinterpret_cast<sockaddr *>(&destinationAddress), sizeof(destinationAddress)) < 0)
+            Logger::Warn("Failed to send LDN packet: {}", strerror(errno));
+    }
+
+    void LanNetwork::SyncStations() {
+        for (u8 i{1}; i < networkInfo.ldn.nodeCountMax; i++)
+            if (networkInfo.ldn.nodes[i].isConnected)
+                Send(htonl(networkInfo.ldn.nodes[i].ipv4Address), PacketType::SyncNetwork, span(networkInfo).cast<const u8>());
+    }
+
+    void LanNetwork::ApplySync(const NetworkInfo &info) {
+        for (size_t i{}; i < NodeCountMax; i++) {
+            const auto &previous{networkInfo.ldn.nodes[i]}, &current{info.ldn.nodes[i]};
+            auto &update{nodeUpdates[i].stateChange};
+            if (previous.isConnected && !current.isConnected)
+                update = NodeStateChange::Disconnect;
+            else if (!previous.isConnected && current.isConnected)
+                update = update == NodeStateChange::Disconnect ? NodeStateChange::DisconnectAndConnect : NodeStateChange::Connect;
+            else if (previous.isConnected && current.isConnected && previous.ipv4Address != current.ipv4Address)
+                update = NodeStateChange::DisconnectAndConnect;
+        }
+        networkInfo = info;
+    }
+
+    void LanNetwork::HandlePacket(in_addr_t source, PacketType type, span<u8> payload) {
+        std::unique_lock lock{mutex};
+        auto sourceAddress{ntohl(source)};
+        switch (type) {
+            case PacketType::Scan:
+                if (state == State::AccessPointCreated)
+                    Send(source, PacketType::ScanResponse, span(networkInfo).cast<const u8>());
+                break;
+
+            case PacketType::ScanResponse: {
+                if (!scanning || payload.size() != sizeof(NetworkInfo) || scanResultCount == scanResults.size())
+                    break;
+
+                auto &info{payload.as<NetworkInfo>()};
+                auto end{scanResults.begin() + static_cast<ssize_t>(scanResultCount)};
+                if (std::find_if(scanResults.begin(), end, [&](const NetworkInfo &result) { return result.common.bssid.raw == info.common.bssid.raw; }) == end)
+                    scanResults[scanResultCount++] = info;
+                break;
+            }
+
+            case PacketType::Connect: {
+                if (state != State::AccessPointCreated || payload.size() != sizeof(NodeInfo))
+                    break;
+
+                auto &nodes{networkInfo.ldn.nodes};
+                auto nodesEnd{nodes.begin() + networkInfo.ldn.nodeCountMax};
+                auto node{std::find_if(nodes.begin() + 1, nodesEnd, [&](const NodeInfo &other) { return other.isConnected && other.ipv4Address == sourceAddress; })};
+                if (node == nodesEnd) {
+                    if (networkInfo.ldn.stationAcceptPolicy == AcceptPolicy::RejectAll)
+                        node = nodesEnd;
+                    else
+                        node = std::find_if(nodes.begin() + 1, nodesEnd, [](const NodeInfo &other) { return !other.isConnected; });
+
+                    if (node == nodesEnd) {
+                        Send(source, PacketType::Reject);
+                        break;
+                    }
+                    networkInfo.ldn.nodeCount++;
+                }
+
+                auto nodeId{static_cast<i8>(std::distance(nodes.begin(), node))};
+                *node = payload.as<NodeInfo>();
+                node->ipv4Address = sourceAddress;
+                node->nodeId = nodeId;
+                node->isConnected = true;
+                nodeUpdates[static_cast<size_t>(nodeId)].stateChange = NodeStateChange::Connect;
+
+                SyncStations();
+                lock.unlock();
+                stateChangeCallback();
+                break;
+            }
+
+            case PacketType::SyncNetwork: {
+                if (payload.size() != sizeof(NetworkInfo) || !(connecting || (state == State::StationConnected && networkInfo.ldn.nodes[0].ipv4Address == sourceAddress)))
+                    break;
+
+                ApplySync(payload.as<NetworkInfo>());
+                if (connecting) {
+                    const auto &nodes{networkInfo.ldn.nodes};
+                    if (std::any_of(nodes.begin(), nodes.end(), [&](const NodeInfo &node) { return node.isConnected && node.ipv4Address == ntohl(address); })) {
+                        connecting = false;
+                        state = State::StationConnected;
+                        connectCondition.notify_all();
+                    }
+                }
+
+                lock.unlock();
+                stateChangeCallback();
+                break;
+            }
+
+            case PacketType::Reject:
+                if (connecting) {
+                    connecting = false;
+                    connectRejected = true;
+                    connectCondition.notify_all();
+                }
+                break;
+
+            case PacketType::Disconnect: {
+                if (state != State::AccessPointCreated)
+                    break;
+
+                auto &nodes{networkInfo.ldn.nodes};
+                for (size_t i{1}; i < NodeCountMax; i++) {
+                    if (nodes[i].isConnected && nodes[i].ipv4Address == sourceAddress) {
+                        nodes[i] = NodeInfo{.nodeId = static_cast<i8>(i)};
+                        networkInfo.ldn.nodeCount--;
+                        nodeUpdates[i].stateChange = NodeStateChange::Disconnect;
+
+                        SyncStations();
+                        lock.unlock();
+                        stateChangeCallback();
+                        break;
+                    }
+                }
+                break;
+            }
+
+            case PacketType::Destroy:
+                if (state == State::StationConnected && networkInfo.ldn.nodes[0].ipv4Address == sourceAddress) {
+                    state = State::StationOpened;
+                    disconnectReason = DisconnectReason::DestroyedByUser;
+                    networkInfo = {};
+                    lock.unlock();
+                    stateChangeCallback();
+                }
+                break;
+
+            default:
+                Logger::Debug("Ignoring unknown LDN packet type: {}", static_cast<u8>(type));
+                break;
+        }
+    }
+
+    void LanNetwork::ReceiveThread() {
+        if (int result{pthread_setname_np(pthread_self(), "Sky-LDN")})
+            Logger::Warn("Failed to set the thread name: {}", strerror(result));
+
+        std::array<pollfd, 2> pollFds{
+            pollfd{.fd = fd, .events = POLLIN},
+            pollfd{.fd = wakeFd, .events = POLLIN},
+        };
+
+        while (true) {
+            if (poll(pollFds.data(), pollFds.size(), -1) < 0) {
+                if (errno == EINTR)
+                    continue;
+                Logger::Error("Failed to poll the LDN socket: {}", strerror(errno));
+                return;
+            }
+
+            if (pollFds[1].revents)
+                return;
+
+            sockaddr_in source{};
+            socklen_t sourceSize{sizeof(source)};
+            auto size{recvfrom(fd, receiveBuffer.data(), receiveBuffer.size(), 0, reinterpret_cast<sockaddr *>(&source), &sourceSize)};
+            if (size < static_cast<ssize_t>(sizeof(PacketHeader)) || source.sin_addr.s_addr == address)
+                continue; // Our own broadcasts are looped back to us and are ignored alongside any truncated packets
+
+            PacketHeader header;
+            std::memcpy(&header, receiveBuffer.data(), sizeof(PacketHeader));
+            if (header.magic != PacketMagic || sizeof(PacketHeader) + header.size != static_cast<size_t>(size))
+                continue;
+
+            HandlePacket(source.sin_addr.s_addr, header.type, span(receiveBuffer).subspan(sizeof(PacketHeader), header.size));
+        }
+    }
+
+    NodeInfo LanNetwork::MakeLocalNode(const UserConfig &userConfig, u16 localCommunicationVersion) {
+        NodeInfo node{
+            .ipv4Address = ntohl(address),
+            .isConnected = true,
+            .username = userConfig.username,
+            .localCommunicationVersion = static_cast<i16>(localCommunicationVersion),
+        };
+
+        // A locally administered MAC address is derived from the LAN address so it's unique and stable across sessions
+        node.macAddress.raw = {0x02, 0x00};
+        std::memcpy(node.macAddress.raw.data() + 2, &address, sizeof(address));
+        return node;
+    }
+
+    void LanNetwork::LeaveNetwork() {
+        if (state == State::AccessPointCreated) {
+            for (u8 i{1}; i < networkInfo.ldn.nodeCountMax; i++)
+                if (networkInfo.ldn.nodes[i].isConnected)
+                    Send(htonl(networkInfo.ldn.nodes[i].ipv4Address), PacketType::Destroy);
+            state = State::AccessPointOpened;
+        } else if (state == State::StationConnected) {
+            Send(htonl(networkInfo.ldn.nodes[0].ipv4Address), PacketType::Disconnect);
+            state = State::StationOpened;
+        } else {
+            return;
+        }
+
+        networkInfo = {};
+        nodeUpdates = {};
+        disconnectReason = DisconnectReason::User;
+    }
+
+    Result LanNetwork::Initialize(in_addr_t pAddress, in_addr_t pNetmask) {
+        std::scoped_lock lock{mutex};
+        if (state != State::None)
+            return {};
+
+        fd = socket(AF_INET, SOCK_DGRAM | SOCK_CLOEXEC, 0);
+        if (fd < 0) {
+            Logger::Warn("Failed to create the LDN socket: {}", strerror(errno));
+            return result::DeviceNotAvailable;
+        }
+
+        int enable{1};
+        setsockopt(fd, SOL_SOCKET, SO_BROADCAST, &enable, sizeof(enable));
+        setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &enable, sizeof(enable));
+
+        sockaddr_in bindAddress{
+            .sin_family = AF_INET,
+            .sin_port = htons(Port),
+            .sin_addr = {INADDR_ANY},
+        };
+        if (bind(fd, reinterpret_cast<sockaddr *>(&bindAddress), sizeof(bindAddress)) < 0) {
+            Logger::Warn("Failed to bind the LDN socket: {}", strerror(errno));
+            close(fd);
+            fd = -1;
+            return result::DeviceNotAvailable;
+        }
+
+        wakeFd = eventfd(0, EFD_CLOEXEC);
+        address = pAddress;
+        netmask = pNetmask;
+        broadcastAddress = address | ~netmask;
+        state = State::Initialized;
+        thread = std::thread(&LanNetwork::ReceiveThread, this);
+        return {};
+    }
+
+    void LanNetwork::Finalize() {
+        {
+            std::scoped_lock lock{mutex};
+            if (state == State::None)
+                return;
+
+            LeaveNetwork();
+            state = State::None;
+        }
+
+        u64 value{1};
+        write(wakeFd, &value, sizeof(value));
+        if (thread.joinable())
+            thread.join();
+
+        close(wakeFd);
+        close(fd);
+        wakeFd = fd = -1;
+    }
+
+    State LanNetwork::GetState() {
+        std::scoped_lock lock{mutex};
+        return state;
+    }
+
+    Result LanNetwork::GetNetworkInfo(NetworkInfo &info) {
+        std::scoped_lock lock{mutex};
+        if (state != State::AccessPointCreated && state != State::StationConnected)
+            return result::InvalidState;
+
+        info = networkInfo;
+        return {};
+    }
+
+    Result LanNetwork::GetNetworkInfoLatestUpdate(NetworkInfo &info, span<NodeLatestUpdate> updates) {
+        std::scoped_lock lock{mutex};
+        if (state != State::AccessPointCreated && state != State::StationConnected)
+            return result::InvalidState;
+
+        info = networkInfo;
+        std::copy_n(nodeUpdates.begin(), std::min(updates.size(), nodeUpdates.size()), updates.begin());
+        nodeUpdates = {};
+        return {};
+    }
+
+    std::pair<u32, u32> LanNetwork::GetIpv4Address() {
+        std::scoped_lock lock{mutex};
+        return {ntohl(address), ntohl(netmask)};
+    }
+
+    DisconnectReason LanNetwork::GetDisconnectReason() {
+        std::scoped_lock lock{mutex};
+        return disconnectReason;
+    }
+
+    Result LanNetwork::GetSecurityParameter(SecurityParameter &parameter) {
+        std::scoped_lock lock{mutex};
+        if (state != State::AccessPointCreated && state != State::StationConnected)
+            return result::InvalidState;
+
+        parameter.data = networkInfo.ldn.securityParameter;
+        parameter.sessionId = networkInfo.networkId.sessionId;
+        return {};
+    }
+
+    Result LanNetwork::GetNetworkConfig(NetworkConfig &config) {
+        std::scoped_lock lock{mutex};
+        if (state != State::AccessPointCreated && state != State::StationConnected)
+            return result::InvalidState;
+
+        config = NetworkConfig{
+            .intentId = networkInfo.networkId.intentId,
+            .channel = networkInfo.common.channel,
+            .nodeCountMax = networkInfo.ldn.nodeCountMax,
+            .localCommunicationVersion = static_cast<u16>(networkInfo.ldn.nodes[0].localCommunicationVersion),
+        };
+        return {};
+    }
+
+    Result LanNetwork::Scan(span<NetworkInfo> output, const ScanFilter &filter, size_t &count) {
+        {
+            std::scoped_lock lock{mutex};
+            if (state == State::None || state == State::Initialized)
+                return result::InvalidState;
+
+            scanResultCount = 0;
+            scanning = true;
+            Send(broadcastAddress, PacketType::Scan);
+        }
+
+        std::this_thread::sleep_for(ScanPeriod);
+
+        std::scoped_lock lock{mutex};
+        scanning = false;
+        count = 0;
+        for (size_t i{}; i < scanResultCount && count < output.size(); i++) {
+            const auto &network{scanResults[i]};
+            if (filter.flag.localCommunicationId && network.networkId.intentId.localCommunicationId != filter.networkId.intentId.localCommunicationId)
+                continue;
+            if (filter.flag.sceneId && network.networkId.intentId.sceneId != filter.networkId.intentId.sceneId)
+                continue;
+            if (filter.flag.sessionId && (network.networkId.sessionId.high != filter.networkId.sessionId.high || network.networkId.sessionId.low != filter.networkId.sessionId.low))
+                continue;
+            if (filter.flag.networkType && static_cast<u32>(network.common.networkType) != filter.networkType)
+                continue;
+            if (filter.flag.bssid && network.common.bssid.raw != filter.bssid.raw)
+                continue;
+            if (filter.flag.ssid && (network.common.ssid.length != filter.ssid.length || !std::equal(filter.ssid.raw.begin(), filter.ssid.raw.begin() + filter.ssid.length, network.common.ssid.raw.begin())))
+                continue;
+
+            output[count++] = network;
+        }
+        return {};
+    }
+
+    Result LanNetwork::OpenAccessPoint() {
+        std::scoped_lock lock{mutex};
+        if (state == State::None)
+            return result::InvalidState;
+
+        LeaveNetwork();
+        state = State::AccessPointOpened;
+        return {};
+    }
+
+    Result LanNetwork::CloseAccessPoint() {
+        std::scoped_lock lock{mutex};
+        if (state != State::AccessPointOpened && state != State::AccessPointCreated)
+            return result::InvalidState;
+
+        LeaveNetwork();
+        state = State::Initialized;
+        return {};
+    }
+
+    Result LanNetwork::CreateNetwork(const SecurityConfig &securityConfig, const UserConfig &userConfig, const NetworkConfig &networkConfig) {
+        {
+            std::scoped_lock lock{mutex};
+            if (state != State::AccessPointOpened)
+                return result::InvalidState;
+
+            networkInfo = NetworkInfo{
+                .networkId{.intentId = networkConfig.intentId},
+                .common{
+                    .channel = networkConfig.channel == WifiChannel::Default ? WifiChannel::Wifi24_6 : networkConfig.channel,
+                    .linkLevel = LinkLevel::Excellent,
+                    .networkType = PackedNetworkType::Ldn,
+                },
+                .ldn{
+                    .securityMode = securityConfig.securityMode,
+                    .stationAcceptPolicy = AcceptPolicy::AcceptAll,
+                    .nodeCountMax = static_cast<u8>(std::clamp<i32>(networkConfig.nodeCountMax, 1, NodeCountMax)),
+                    .nodeCount = 1,
+                    .advertiseDataSize = advertiseDataSize,
+                    .advertiseData = advertiseData,
+                },
+            };
+            util::FillRandomBytes(networkInfo.networkId.sessionId);
+            util::FillRandomBytes(networkInfo.ldn.securityParameter);
+
+            auto &hostNode{networkInfo.ldn.nodes[0]};
+            hostNode = MakeLocalNode(userConfig, networkConfig.localCommunicationVersion);
+            for (size_t i{}; i < NodeCountMax; i++)
+                networkInfo.ldn.nodes[i].nodeId = static_cast<i8>(i);
+
+            networkInfo.common.bssid = hostNode.macAddress;
+            auto ssid{fmt::format("{:016X}", networkInfo.networkId.sessionId.low)};
+            networkInfo.common.ssid.length = static_cast<u8>(ssid.size());
+            std::copy(ssid.begin(), ssid.end(), networkInfo.common.ssid.raw.begin());
+
+            nodeUpdates = {};
+            nodeUpdates[0].stateChange = NodeStateChange::Connect;
+            disconnectReason = DisconnectReason::None;
+            state = State::AccessPointCreated;
+        }
+
+        stateChangeCallback();
+        return {};
+    }
+
+    Result LanNetwork::DestroyNetwork() {
+        {
+            std::scoped_lock lock{mutex};
+            if (state != State::AccessPointCreated)
+                return result::InvalidState;
+
+            LeaveNetwork();
+        }
+
+        stateChangeCallback();
+        return {};
+    }
+
+    Result LanNetwork::SetAdvertiseData(span<u8> data) {
+        std::scoped_lock lock{mutex};
+        if (data.size() > AdvertiseDataSizeMax)
+            return result::InvalidInput;
+
+        advertiseDataSize = static_cast<u16>(data.size());
+        advertiseData = {};
+        std::copy(data.begin(), data.end(), advertiseData.begin());
+
+        if (state == State::AccessPointCreated) {
+            networkInfo.ldn.advertiseDataSize = advertiseDataSize;
+            networkInfo.ldn.advertiseData = advertiseData;
+            SyncStations();
+        }
+        return {};
+    }
+
+    Result LanNetwork::SetStationAcceptPolicy(AcceptPolicy policy) {
+        std::scoped_lock lock{mutex};
+        if (state != State::AccessPointOpened && state != State::AccessPointCreated)
+            return result::InvalidState;
+
+        networkInfo.ldn.stationAcceptPolicy = policy;
+        return {};
+    }
+
+    Result LanNetwork::OpenStation() {
+        std::scoped_lock lock{mutex};
+        if (state == State::None)
+            return result::InvalidState;
+
+        LeaveNetwork();
+        state = State::StationOpened;
+        return {};
+    }
+
+    Result LanNetwork::CloseStation() {
+        std::scoped_lock lock{mutex};
+        if (state != State::StationOpened && state != State::StationConnected)
+            return result::InvalidState;
+
+        LeaveNetwork();
+        state = State::Initialized;
+        return {};
+    }
+
+    Result LanNetwork::Connect(const NetworkInfo &network, const UserConfig &userConfig, u16 localCommunicationVersion) {
+        {
+            std::unique_lock lock{mutex};
+            if (state != State::StationOpened)
+                return result::InvalidState;
+
+            networkInfo = {};
+            nodeUpdates = {};
+            connecting = true;
+            connectRejected = false;
+
+            auto node{MakeLocalNode(userConfig, localCommunicationVersion)};
+            Send(htonl(network.ldn.nodes[0].ipv4Address), PacketType::Connect, span(node).cast<const u8>());
+
+            if (!connectCondition.wait_for(lock, ConnectTimeout, [this] { return !connecting; })) {
+                connecting = false;
+                return result::ConnectTimeout;
+            }
+
+            if (connectRejected)
+                return result::ConnectRejected;
+
+            disconnectReason = DisconnectReason::None;
+        }
+
+        stateChangeCallback();
+        return {};
+    }
+
+    Result LanNetwork::Disconnect() {
+        {
+            std::scoped_lock lock{mutex};
+            if (state != State::StationConnected)
+                return result::InvalidState;
+
+            LeaveNetwork();
+        }
+
+        stateChangeCallback();
+        return {};
+    }
+}
@@ -0,0 +1,164 @@
+// SPDX-License-Identifier: MPL-2.0
+// Copyright © 2023 Skyline Team and Contributors (https://github.com/skyline-emu/)
+
+#pragma once
+
+#include <netinet/in.h>
+#include "types.h"
+
+namespace skyline::service::ldn {
+    /**
+     * @brief An emulated LDN network carried over the LAN, access points answer broadcast scans with their network and stations join it by exchanging unicast control packets with the access point
+     * @note Only the control plane of LDN is handled here, nodes are advertised with their LAN addresses so the application's own traffic is sent directly between nodes over BSD sockets
+     */
+    class LanNetwork {
+      private:
+        static constexpr u16 Port{11452}; //!< The UDP port used for all LDN control traffic
+        static constexpr u32 PacketMagic{util::MakeMagic<u32>("SLDN")};
+        static constexpr size_t ScanResultCountMax{24}; //!< The maximum amount of networks that are retained from a single scan
+        static constexpr std::chrono::milliseconds ScanPeriod{150}; //!< The duration to collect scan responses for, LAN round trips are far shorter than this
+        static constexpr std::chrono::seconds ConnectTimeout{3}; //!< The duration to wait for the access point to accept a connection
+
+        enum class PacketType : u8 {
+            Scan, //!< A broadcast by a station to discover networks, this has no payload
+            ScanResponse, //!< A unicast by an access point in response to a scan with its NetworkInfo
+            Connect, //!< A unicast by a station to the access point requesting to join with its NodeInfo
+            SyncNetwork, //!< A unicast by an access point to all stations with the current NetworkInfo
+            Reject, //!< A unicast by an access point to a station which could not join, this has no payload
+            Disconnect, //!< A unicast by a station to the access point when leaving, this has no payload
+            Destroy, //!< A unicast by an access point to all stations when the network is destroyed, this has no payload
+        };
+
+        struct PacketHeader {
+            u32 magic;
+            PacketType type;
+            u8 _pad0_;
+            u16 size; //!< The size of the payload following the header
+        };
+        static_assert(sizeof(PacketHeader) == 0x8);
+
+        static constexpr size_t PacketSizeMax{sizeof(PacketHeader) + sizeof(NetworkInfo)};
+
+        std::function<void()> stateChangeCallback; //!< A callback invoked on any state change visible to the guest
+
+        int fd{-1}; //!< The UDP socket used for all control traffic
+        int wakeFd{-1}; //!< An eventfd used to wake the receive thread when it should exit
+        std::thread thread; //!< The thread which receives and handles all incoming control packets
+        alignas(u64) std::array<u8, PacketSizeMax> receiveBuffer; //!< A buffer for incoming packets, this is only used by the receive thread
+
+        std::mutex mutex; //!< Synchronizes all state below between the receive thread and guest calls
+        std::condition_variable connectCondition; //!< Signalled when a pending connection attempt is resolved
+        State state{State::None};
+        in_addr_t address{}; //!< The LAN address of this node in network byte order
+        in_addr_t broadcastAddress{}; //!< The broadcast address of the LAN in network byte order
+        in_addr_t netmask{}; //!< The netmask of the LAN in network byte order
+        NetworkInfo networkInfo{}; //!< The network that has been created or joined
+        std::array<NodeLatestUpdate, NodeCountMax> nodeUpdates{}; //!< The node changes since they were last retrieved by the guest
+        DisconnectReason disconnectReason{DisconnectReason::None};
+        std::array<u8, AdvertiseDataSizeMax> advertiseData{};
+        u16 advertiseDataSize{};
+        std::array<NetworkInfo, ScanResultCountMax> scanResults{};
+        size_t scanResultCount{};
+        bool scanning{}; //!< If responses to a scan are currently being collected
+        bool connecting{}; //!< If a connection to an access point is pending
+        bool connectRejected{}; //!< If the pending connection was rejected by the access point
+
+        /**
+         * @brief Sends a packet with the supplied payload to a host, failures are logged as UDP delivery isn't guaranteed regardless
+         */
+        void Send(in_addr_t destination, PacketType type, span<const u8> payload = {});
+
+        /**
+         * @brief Sends the current NetworkInfo to all connected stations
+         * @note The mutex must be locked when calling this
+         */
+        void SyncStations();
+
+        /**
+         * @brief Updates the network from a SyncNetwork packet and records all node changes relative to the prior network
+         * @note The mutex must be locked when calling this
+         */
+        void ApplySync(const NetworkInfo &info);
+
+        /**
+         * @brief Handles a single packet received from the supplied address
+         */
+        void HandlePacket(in_addr_t source, PacketType type, span<u8> payload);
+
+        void ReceiveThread();
+
+        /**
+         * @return A node for this device with the supplied user and version
+         */
+        NodeInfo MakeLocalNode(const UserConfig &userConfig, u16 localCommunicationVersion);
+
+        /**
+         * @brief Destroys the network if one was created or leaves the network if one was joined
+         * @note The mutex must be locked when calling this
+         */
+        void LeaveNetwork();
+
+      public:
+        LanNetwork(std::function<void()> stateChangeCallback);
+
+        ~LanNetwork();
+
+        /**
+         * @brief Opens the control socket on the LAN with the supplied address and starts receiving packets
+         * @param address The address of this device in network byte order
+         * @param netmask The netmask of the LAN in network byte order
+         */
+        Result Initialize(in_addr_t address, in_addr_t netmask);
+
+        void Finalize();
+
+        State GetState();
+
+        Result GetNetworkInfo(NetworkInfo &info);
+
+        /**
+         * @brief Retrieves the network alongside the node changes since the last call, the changes are reset after this
+         */
+        Result GetNetworkInfoLatestUpdate(NetworkInfo &info, span<NodeLatestUpdate> updates);
+
+        /**
+         * @return The address and netmask of this device in host byte order
+         */
+        std::pair<u32, u32> GetIpv4Address();
+
+        DisconnectReason GetDisconnectReason();
+
+        Result GetSecurityParameter(SecurityParameter &parameter);
+
+        Result GetNetworkConfig(NetworkConfig &config);
+
+        /**
+         * @brief Broadcasts a scan on the LAN and collects the networks that respond and match the filter
+         * @param count The amount of networks written into the output
+         */
+        Result Scan(span<NetworkInfo> output, const ScanFilter &filter, size_t &count);
+
+        Result OpenAccessPoint();
+
+        Result CloseAccessPoint();
+
+        Result CreateNetwork(const SecurityConfig &securityConfig, const UserConfig &userConfig, const NetworkConfig &networkConfig);
+
+        Result DestroyNetwork();
+
+        Result SetAdvertiseData(span<u8> data);
+
+        Result SetStationAcceptPolicy(AcceptPolicy policy);
+
+        Result OpenStation();
+
+        Result CloseStation();
+
+        /**
+         * @brief Requests to join the supplied network from its access point and waits for it to be accepted
+         */
+        Result Connect(const NetworkInfo &network, const UserConfig &userConfig, u16 localCommunicationVersion);
+
+        Result Disconnect();
+    };
+}
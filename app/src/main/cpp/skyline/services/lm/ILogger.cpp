@@ -1,23 +1,12 @@
 // SPDX-License-Identifier: MPL-2.0
 // Copyright © 2020 Skyline Team and Contributors (https://github.com/skyline-emu/)
 
-#include <sstream>
 #include "ILogger.h"
 
 namespace skyline::service::lm {
     ILogger::ILogger(const DeviceState &state, ServiceManager &manager) : BaseService(state, manager) {}
 
-    Result ILogger::Log(type::KSession &session, ipc::IpcRequest &request, ipc::IpcResponse &response) {
-        auto inputBuffer{request.inputBuf.at(0)};
-        struct Data {
-            u64 pid;
-            u64 threadContext;
-            u16 flags;
-            LogLevel level;
-            u8 verbosity;
-            u32 payloadLength;
-        } &data = inputBuffer.as<Data>();
-
+    std::string ILogger::FormatPacket(span<u8> packet) {
         struct LogMessage {
             std::string_view message;
             u32 line;
@@ -30,11 +19,11 @@ namespace skyline::service::lm {
             std::string_view program;
         } logMessage{};
 
-        u64 offset{sizeof(Data)};
-        while ((offset + sizeof(LogFieldType) + sizeof(u8)) < inputBuffer.size()) { // The length of the last field sometimes doesn't add up to the buffer size, so we need to terminate the loop when we can't pop the type and length off the buffer
-            auto fieldType{inputBuffer.subspan(offset++).as<LogFieldType>()};
-            auto length{inputBuffer.subspan(offset++).as<u8>()};
-            auto object{inputBuffer.subspan(offset, length)};
+        u64 offset{sizeof(PacketHeader)};
+        while ((offset + sizeof(LogFieldType) + sizeof(u8)) < packet.size()) { // The length of the last field sometimes doesn't add up to the buffer size, so we need to terminate the loop when we can't pop the type and length off the buffer
+            auto fieldType{packet.subspan(offset++).as<LogFieldType>()};
+            auto length{packet.subspan(offset++).as<u8>()};
+            auto object{packet.subspan(offset, std::min<size_t>(length, packet.size() - offset))};
 
             switch (fieldType) {
                 case LogFieldType::Start:
@@ -85,45 +74,57 @@ namespace skyline::service::lm {
             break;
         }
 
-        Logger::LogLevel hostLevel{[&data]() {
-            switch (data.level) {
-                case LogLevel::Trace:
-                    return Logger::LogLevel::Debug;
-                case LogLevel::Info:
-                    return Logger::LogLevel::Info;
-                case LogLevel::Warning:
-                    return Logger::LogLevel::Warn;
-                case LogLevel::Error:
-                case LogLevel::Critical:
-                    return Logger::LogLevel::Error;
-            }
-        }()};
-
-        std::ostringstream message;
+        std::string message;
+        auto out{std::back_inserter(message)};
         if (!logMessage.filename.empty())
-            message << logMessage.filename << ':';
+            fmt::format_to(out, "{}:", logMessage.filename);
         if (logMessage.line)
-            message << 'L' << std::dec << logMessage.line << ':';
+            fmt::format_to(out, "L{}:", logMessage.line);
         if (!logMessage.program.empty())
-            message << logMessage.program << ':';
+            fmt::format_to(out, "{}:", logMessage.program);
         if (!logMessage.module.empty())
-            message << logMessage.module << ':';
+            fmt::format_to(out, "{}:", logMessage.module);
         if (!logMessage.function.empty())
-            message << logMessage.function << "():";
+            fmt::format_to(out, "{}():", logMessage.function);
         if (!logMessage.thread.empty())
-            message << logMessage.thread << ':';
+            fmt::format_to(out, "{}:", logMessage.thread);
         if (logMessage.time)
-            message << logMessage.time << "s:";
+            fmt::format_to(out, "{}s:", logMessage.time);
         if (!logMessage.message.empty()) {
             if (logMessage.message.ends_with('\n'))
                 logMessage.message.remove_suffix(1);
-            message << ' ' << logMessage.message;
+            fmt::format_to(out, " {}", logMessage.message);
         }
         if (logMessage.dropCount)
-            message << " (Dropped Messages: " << logMessage.time << ')';
+            fmt::format_to(out, " (Dropped Messages: {})", logMessage.dropCount);
+
+        return message;
+    }
+
+    Result ILogger::Log(type::KSession &session, ipc::IpcRequest &request, ipc::IpcResponse &response) {
+        auto inputBuffer{request.inputBuf.at(0)};
+        auto &header{inputBuffer.as<PacketHeader>()};
+
+        Logger::LogLevel hostLevel{[&header]() {
+            switch (header.level) {
+                case LogLevel::Trace:
+                    return Logger::LogLevel::Debug;
+                case LogLevel::Info:
+                    return Logger::LogLevel::Info;
+                case LogLevel::Warning:
+                    return Logger::LogLevel::Warn;
+                case LogLevel::Error:
+                case LogLevel::Critical:
+                default:
+                    return Logger::LogLevel::Error;
+            }
+        }()};
 
-        Logger::Write(hostLevel, message.str());
+        // Packets are dropped before any parsing if they wouldn't be written out, chatty titles can log thousands of packets per second
+        if (hostLevel > Logger::configLevel)
+            return {};
 
+        Logger::WriteRaw(hostLevel, inputBuffer, &FormatPacket);
         return {};
     }
 
@@ -34,6 +34,23 @@ namespace skyline::service::lm {
             Critical,
         };
 
+        /**
+         * @brief The header preceding the fields of a log packet
+         */
+        struct PacketHeader {
+            u64 pid;
+            u64 threadContext;
+            u16 flags;
+            LogLevel level;
+            u8 verbosity;
+            u32 payloadLength;
+        };
+
+        /**
+         * @brief Parses a log packet into a message, this is done on the logger thread
+         */
+        static std::string FormatPacket(span<u8> packet);
+
       public:
         ILogger(const DeviceState &state, ServiceManager &manager);
 
@@ -56,12 +56,17 @@ namespace skyline::service::nvdrv::core {
         return PosixResult::Success;
     }
 
-    NvMap::NvMap(const DeviceState &state) : state(state), smmuAllocator(soc::SmmuPageSize) {}
+    NvMap::NvMap(const DeviceState &state) : state(state), smmuAllocator(soc::SmmuPageSize), handleSlots(HandleSlotCount) {}
 
     void NvMap::AddHandle(std::shared_ptr<Handle> handleDesc) {
-        std::scoped_lock lock(handlesLock);
+        // Handle IDs are sequential so the slot will almost always have been freed by the time it's reused
+        std::shared_ptr<Handle> expected;
+        if (std::atomic_compare_exchange_strong(&handleSlots[GetHandleSlot(handleDesc->id)], &expected, handleDesc)) [[likely]]
+            return;
 
-        handles.emplace(handleDesc->id, std::move(handleDesc));
+        std::scoped_lock lock(overflowLock);
+        overflowHandles.emplace(handleDesc->id, std::move(handleDesc));
+        overflowHandleCount.fetch_add(1, std::memory_order_release);
     }
 
     void NvMap::UnmapHandle(Handle &handleDesc) {
@@ -81,11 +86,15 @@ namespace skyline::service::nvdrv::core {
     bool NvMap::TryRemoveHandle(const Handle &handleDesc) {
         // No dupes left, we can remove from handle map
         if (handleDesc.dupes == 0 && handleDesc.internalDupes == 0) {
-            std::scoped_lock lock(handlesLock);
-
-            auto it{handles.find(handleDesc.id)};
-            if (it != handles.end())
-                handles.erase(it);
+            auto &slot{handleSlots[GetHandleSlot(handleDesc.id)]};
+            auto slotHandle{std::atomic_load(&slot)};
+            if (slotHandle.get() == &handleDesc) {
+                std::atomic_compare_exchange_strong(&slot, &slotHandle, std::shared_ptr<Handle>{});
+            } else {
+                std::scoped_lock lock(overflowLock);
+                if (overflowHandles.erase(handleDesc.id))
+                    overflowHandleCount.fetch_sub(1, std::memory_order_release);
+            }
 
             return true;
         } else {
@@ -105,13 +114,17 @@ namespace skyline::service::nvdrv::core {
     }
 
     std::shared_ptr<NvMap::Handle> NvMap::GetHandle(Handle::Id handle) {
-        std::scoped_lock lock(handlesLock);
+        // The atomic accessors for shared_ptr lock a mutex keyed by the address of the slot, so lookups of different handles don't contend with each other
+        auto handleDesc{std::atomic_load(&handleSlots[GetHandleSlot(handle)])};
+        if (handleDesc && handleDesc->id == handle) [[likely]]
+            return handleDesc;
 
-        try {
-            return handles.at(handle);
-        } catch (std::out_of_range &e) {
+        if (!overflowHandleCount.load(std::memory_order_acquire))
             return nullptr;
-        }
+
+        std::scoped_lock lock(overflowLock);
+        auto it{overflowHandles.find(handle)};
+        return it != overflowHandles.end() ? it->second : nullptr;
     }
 
     u32 NvMap::PinHandle(NvMap::Handle::Id handle) {
@@ -82,12 +82,19 @@ namespace skyline::service::nvdrv::core {
         std::list<std::shared_ptr<Handle>> unmapQueue;
         std::mutex unmapQueueLock; //!< Protects access to `unmapQueue`
 
-        std::unordered_map<Handle::Id, std::shared_ptr<Handle>> handles; //!< Main owning map of handles
-        std::mutex handlesLock; //!< Protects access to `handles`
-
         static constexpr u32 HandleIdIncrement{4}; //!< Each new handle ID is an increment of 4 from the previous
         std::atomic<u32> nextHandleId{HandleIdIncrement};
 
+        static constexpr size_t HandleSlotCount{0x10000}; //!< The amount of slots in the handle table, this is far larger than the amount of handles that are alive at once
+        std::vector<std::shared_ptr<Handle>> handleSlots; //!< Main owning table of handles indexed by their ID modulo the slot count, slots are only accessed atomically so lookups don't need to take a global lock
+        std::unordered_map<Handle::Id, std::shared_ptr<Handle>> overflowHandles; //!< Handles whose slot was occupied by an older handle at creation, this only happens when a handle outlives `HandleSlotCount` newer handles
+        std::atomic<size_t> overflowHandleCount{}; //!< The amount of handles in `overflowHandles`, this lets lookups skip `overflowLock` when there aren't any
+        std::mutex overflowLock; //!< Protects access to `overflowHandles`
+
+        static constexpr size_t GetHandleSlot(Handle::Id id) {
+            return (id / HandleIdIncrement) % HandleSlotCount;
+        }
+
         void AddHandle(std::shared_ptr<Handle> handle);
 
         /**
@@ -322,36 +322,45 @@ namespace skyline::service::nvdrv::device::nvhost {
         if (!vm.initialised)
             return PosixResult::InvalidArgument;
 
-        for (const auto &entry : entries) {
-            u64 virtAddr{static_cast<u64>(entry.asOffsetBigPages) << vm.bigPageSizeBits};
-            u64 size{static_cast<u64>(entry.bigPages) << vm.bigPageSizeBits};
+        // Games may remap hundreds of entries at once, so they are applied to the GMMU as a single batch with any entries prior to an invalid one still being applied
+        std::vector<GMMU::MapOperation> operations;
+        operations.reserve(entries.size());
 
-            auto alloc{allocationMap.upper_bound(virtAddr)};
+        auto result{[&]() {
+            for (const auto &entry : entries) {
+                u64 virtAddr{static_cast<u64>(entry.asOffsetBigPages) << vm.bigPageSizeBits};
+                u64 size{static_cast<u64>(entry.bigPages) << vm.bigPageSizeBits};
 
-            if (alloc-- == allocationMap.begin() || (virtAddr - alloc->first) + size > alloc->second.size) {
-                Logger::Warn("Cannot remap into an unallocated region!");
-                return PosixResult::InvalidArgument;
-            }
+                auto alloc{allocationMap.upper_bound(virtAddr)};
 
-            if (!alloc->second.sparse) {
-                Logger::Warn("Cannot remap a non-sparse mapping!");
-                return PosixResult::InvalidArgument;
-            }
+                if (alloc-- == allocationMap.begin() || (virtAddr - alloc->first) + size > alloc->second.size) {
+                    Logger::Warn("Cannot remap into an unallocated region!");
+                    return PosixResult::InvalidArgument;
+                }
 
-            if (!entry.handle) {
-                asCtx->gmmu.Map(virtAddr, GMMU::SparsePlaceholderAddress(), size, {true});
-            } else {
-                auto h{core.nvMap.GetHandle(entry.handle)};
-                if (!h)
+                if (!alloc->second.sparse) {
+                    Logger::Warn("Cannot remap a non-sparse mapping!");
                     return PosixResult::InvalidArgument;
+                }
+
+                if (!entry.handle) {
+                    operations.push_back({virtAddr, GMMU::SparsePlaceholderAddress(), size, {true}});
+                } else {
+                    auto h{core.nvMap.GetHandle(entry.handle)};
+                    if (!h)
+                        return PosixResult::InvalidArgument;
 
-                u8 *cpuPtr{reinterpret_cast<u8 *>(h->address + (static_cast<u64>(entry.handleOffsetBigPages) << vm.bigPageSizeBits))};
+                    u8 *cpuPtr{reinterpret_cast<u8 *>(h->address + (static_cast<u64>(entry.handleOffsetBigPages) << vm.bigPageSizeBits))};
 
-                asCtx->gmmu.Map(virtAddr, cpuPtr, size);
+                    operations.push_back({virtAddr, cpuPtr, size});
+                }
             }
-        }
 
-        return PosixResult::Success;
+            return PosixResult::Success;
+        }()};
+
+        asCtx->gmmu.MapBatch(operations);
+        return result;
     }
 
 #include <services/nvdrv/devices/deserialisation/macro_def.inc>
@@ -2,6 +2,7 @@
 // Copyright © 2021 Skyline Team and Contributors (https://github.com/skyline-emu/)
 
 #include <soc.h>
+#include <common/settings.h>
 #include <services/nvdrv/devices/deserialisation/deserialisation.h>
 #include "host1x_channel.h"
 
@@ -35,14 +36,16 @@ namespace skyline::service::nvdrv::device::nvhost {
 
         std::scoped_lock lock(channelMutex);
 
+        // Without hardware video decoding the command buffers are never executed, syncpoints are incremented on the CPU instead to avoid the guest waiting on them forever
+        bool executeCmdBufs{*state.settings->hardwareVideoDecoding};
         for (size_t i{}; i < syncpointIncrs.size(); i++) {
             const auto &incr{syncpointIncrs[i]};
 
             u32 max{core.syncpointManager.IncrementSyncpointMaxExt(incr.syncpointId, incr.numIncrs)};
 
-            // Increment syncpoints on the CPU to avoid needing to pass through the emulated nvdec code which currently does nothing
-            for (size_t j{}; j < incr.numIncrs; j++)
-                state.soc->host1x.syncpoints[incr.syncpointId].Increment();
+            if (!executeCmdBufs)
+                for (size_t j{}; j < incr.numIncrs; j++)
+                    state.soc->host1x.syncpoints[incr.syncpointId].Increment();
 
             if (i < fenceThresholds.size())
                 fenceThresholds[i] = max;
@@ -56,9 +59,10 @@ namespace skyline::service::nvdrv::device::nvhost {
             u64 gatherAddress{handleDesc->address + cmdBuf.offset};
             Logger::Debug("Submit gather, CPU address: 0x{:X}, words: 0x{:X}", gatherAddress, cmdBuf.words);
 
-            span gather(reinterpret_cast<u32 *>(gatherAddress), cmdBuf.words);
-            // Skip submitting the cmdbufs as no functionality is implemented
-            // state.soc->host1x.channels[static_cast<size_t>(channelType)].Push(gather);
+            if (executeCmdBufs) {
+                span gather(reinterpret_cast<u32 *>(gatherAddress), cmdBuf.words);
+                state.soc->host1x.channels[static_cast<size_t>(channelType)].Push(gather);
+            }
         }
 
         return PosixResult::Success;
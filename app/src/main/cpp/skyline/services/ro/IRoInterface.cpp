@@ -38,17 +38,10 @@ namespace skyline::service::ro {
 
         loader::Executable executable{};
 
-        executable.text.offset = 0;
-        executable.text.contents.resize(header.text.size);
-        span(executable.text.contents).copy_from(data.subspan(header.text.offset, header.text.size));
-
-        executable.ro.offset = header.text.size;
-        executable.ro.contents.resize(header.ro.size);
-        span(executable.ro.contents).copy_from(data.subspan(header.ro.offset, header.ro.size));
-
-        executable.data.offset = header.text.size + header.ro.size;
-        executable.data.contents.resize(header.data.size);
-        span(executable.data.contents).copy_from(data.subspan(header.data.offset, header.data.size));
+        // The segments are viewed directly in the guest's copy of the NRO as it stays mapped while the module is loaded
+        executable.text = {.view = data.subspan(header.text.offset, header.text.size), .size = header.text.size, .offset = 0};
+        executable.ro = {.view = data.subspan(header.ro.offset, header.ro.size), .size = header.ro.size, .offset = header.text.size};
+        executable.data = {.view = data.subspan(header.data.offset, header.data.size), .size = header.data.size, .offset = header.text.size + header.ro.size};
 
         executable.bssSize = header.bssSize;
 
@@ -57,11 +50,11 @@ namespace skyline::service::ro {
             executable.dynstr = {header.dynstr.offset, header.dynstr.size};
         }
 
-        u64 textSize{executable.text.contents.size()};
-        u64 roSize{executable.ro.contents.size()};
-        u64 dataSize{executable.data.contents.size() + executable.bssSize};
+        u64 textSize{executable.text.size};
+        u64 roSize{executable.ro.size};
+        u64 dataSize{executable.data.size + executable.bssSize};
 
-        auto patch{state.nce->GetPatchData(executable.text.contents)};
+        auto patch{state.nce->GetPatchData(executable.text.Contents())};
         auto size{patch.size + textSize + roSize + dataSize};
 
         u8 *ptr{};
@@ -1,8 +1,10 @@
 // SPDX-License-Identifier: MPL-2.0
 // Copyright © 2020 Skyline Team and Contributors (https://github.com/skyline-emu/)
 
+#include <fmt/ranges.h>
 #include <kernel/types/KProcess.h>
 #include <common/trace.h>
+#include <common/boot_profiler.h>
 #include "sm/IUserInterface.h"
 #include "settings/ISettingsServer.h"
 #include "settings/ISystemSettingsServer.h"
@@ -77,7 +79,10 @@ namespace skyline::service {
         explicit GlobalServiceState(const DeviceState &state) : timesrv(state), sharedFontCore(state), sharedIirCore(state), nvdrv(state) {}
     };
 
-    ServiceManager::ServiceManager(const DeviceState &state) : state(state), smUserInterface(std::make_shared<sm::IUserInterface>(state, *this)), globalServiceState(std::make_shared<GlobalServiceState>(state)) {}
+    ServiceManager::ServiceManager(const DeviceState &state) : state(state), smUserInterface(std::make_shared<sm::IUserInterface>(state, *this)), globalServiceState([&] {
+        BootProfiler::ScopedStage bootStage{BootProfiler::Stage::ServiceManager};
+        return std::make_shared<GlobalServiceState>(state);
+    }()) {}
 
     std::shared_ptr<BaseService> ServiceManager::CreateOrGetService(ServiceName name) {
         auto serviceIter{serviceMap.find(name)};
@@ -154,13 +159,16 @@ namespace skyline::service {
     }
 
     std::shared_ptr<BaseService> ServiceManager::NewService(ServiceName name, type::KSession &session, ipc::IpcResponse &response) {
-        std::scoped_lock serviceGuard{mutex};
-        auto serviceObject{CreateOrGetService(name)};
+        std::shared_ptr<BaseService> serviceObject;
+        {
+            std::scoped_lock serviceGuard{mutex};
+            serviceObject = CreateOrGetService(name);
+        }
+
         KHandle handle{};
         if (session.isDomain) {
-            session.domains.push_back(serviceObject);
-            response.domainObjects.push_back(session.handleIndex);
-            handle = session.handleIndex++;
+            handle = session.InsertDomainObject(serviceObject);
+            response.domainObjects.push_back(handle);
         } else {
             handle = state.process->NewHandle<type::KSession>(serviceObject).handle;
             response.moveHandles.push_back(handle);
@@ -170,13 +178,11 @@ namespace skyline::service {
     }
 
     void ServiceManager::RegisterService(std::shared_ptr<BaseService> serviceObject, type::KSession &session, ipc::IpcResponse &response) { // NOLINT(performance-unnecessary-value-param)
-        std::scoped_lock serviceGuard{mutex};
+        // The service isn't inserted into the service map so this doesn't require the service mutex, the domain table of the session has its own synchronization
         KHandle handle{};
-
         if (session.isDomain) {
-            session.domains.push_back(serviceObject);
-            response.domainObjects.push_back(session.handleIndex);
-            handle = session.handleIndex++;
+            handle = session.InsertDomainObject(serviceObject);
+            response.domainObjects.push_back(handle);
         } else {
             handle = state.process->NewHandle<type::KSession>(serviceObject).handle;
             response.moveHandles.push_back(handle);
@@ -186,12 +192,12 @@ namespace skyline::service {
     }
 
     void ServiceManager::CloseSession(KHandle handle) {
-        std::scoped_lock serviceGuard{mutex};
         auto session{state.process->GetHandle<type::KSession>(handle)};
-        if (session->isOpen) {
+        if (session->isOpen.exchange(false)) {
+            std::scoped_lock serviceGuard{mutex};
             if (session->isDomain) {
-                for (const auto &domainService : session->domains)
-                    std::erase_if(serviceMap, [domainService](const auto &entry) {
+                for (const auto &domainService : session->GetDomainObjects())
+                    std::erase_if(serviceMap, [&domainService](const auto &entry) {
                         return entry.second == domainService;
                     });
             } else {
@@ -199,10 +205,42 @@ namespace skyline::service {
                     return entry.second == session->serviceObject;
                 });
             }
-            session->isOpen = false;
         }
     }
 
+    void ServiceManager::RecordServiceCall(const char *name, u32 id, bool isTipc, u64 latencyNs) {
+        std::scoped_lock lock{statisticsMutex};
+        auto &statistics{functionStatistics[name]};
+        if (statistics.callTrackName.empty()) [[unlikely]] {
+            statistics.callTrackName = fmt::format("{} ({}: 0x{:X}) Calls", name, isTipc ? "TIPC" : "HIPC", id);
+            statistics.latencyTrackName = fmt::format("{} ({}: 0x{:X}) Latency (us)", name, isTipc ? "TIPC" : "HIPC", id);
+        }
+
+        statistics.callCount++;
+        statistics.totalLatencyNs += latencyNs;
+        statistics.maxLatencyNs = std::max(statistics.maxLatencyNs, latencyNs);
+
+        u64 latencyUs{latencyNs / 1000};
+        statistics.latencyHistogram[std::min<size_t>(std::bit_width(latencyUs), FunctionStatistics::LatencyBucketCount - 1)]++;
+
+        TRACE_COUNTER("service", perfetto::CounterTrack{statistics.callTrackName.c_str()}, statistics.callCount);
+        TRACE_COUNTER("service", perfetto::CounterTrack{statistics.latencyTrackName.c_str()}, latencyUs);
+    }
+
+    std::string ServiceManager::DumpServiceStatistics() {
+        std::scoped_lock lock{statisticsMutex};
+        std::vector<std::pair<const char *, const FunctionStatistics *>> sorted;
+        sorted.reserve(functionStatistics.size());
+        for (const auto &[name, statistics] : functionStatistics)
+            sorted.emplace_back(name, &statistics);
+        std::sort(sorted.begin(), sorted.end(), [](const auto &a, const auto &b) { return a.second->totalLatencyNs > b.second->totalLatencyNs; });
+
+        std::string dump{"Function, Calls, Total (ms), Average (us), Max (us), Histogram (<1us, <2us, <4us ... >=16ms)\n"};
+        for (const auto &[name, statistics] : sorted)
+            fmt::format_to(std::back_inserter(dump), "{}, {}, {:.3f}, {:.2f}, {}, [{}]\n", name, statistics->callCount, static_cast<double>(statistics->totalLatencyNs) / 1'000'000, static_cast<double>(statistics->totalLatencyNs) / static_cast<double>(statistics->callCount * 1000), statistics->maxLatencyNs / 1000, fmt::join(statistics->latencyHistogram, ", "));
+        return dump;
+    }
+
     void ServiceManager::SyncRequestHandler(KHandle handle) {
         TRACE_EVENT("kernel", "ServiceManager::SyncRequestHandler");
         auto session{state.process->GetHandle<type::KSession>(handle)};
@@ -218,7 +256,7 @@ namespace skyline::service {
                 case ipc::CommandType::RequestWithContext:
                     if (session->isDomain) {
                         try {
-                            auto service{session->domains.at(request.domain->objectId)};
+                            auto service{session->GetDomainObject(request.domain->objectId)};
                             if (service == nullptr)
                                 throw exception("Domain request used an expired handle");
                             switch (request.domain->command) {
@@ -226,12 +264,14 @@ namespace skyline::service {
                                     response.errorCode = service->HandleRequest(*session, request, response);
                                     break;
 
-                                case ipc::DomainCommand::CloseVHandle:
-                                    std::erase_if(serviceMap, [service](const auto &entry) {
+                                case ipc::DomainCommand::CloseVHandle: {
+                                    session->RemoveDomainObject(request.domain->objectId);
+                                    std::scoped_lock serviceGuard{mutex};
+                                    std::erase_if(serviceMap, [&service](const auto &entry) {
                                         return entry.second == service;
                                     });
-                                    session->domains.at(request.domain->objectId).reset();
                                     break;
+                                }
                             }
                         } catch (std::out_of_range &) {
                             throw exception("Invalid object ID was used with domain request");
@@ -19,7 +19,24 @@ namespace skyline::service {
       private:
         const DeviceState &state;
         std::unordered_map<ServiceName, std::shared_ptr<BaseService>> serviceMap; //!< A mapping from a Service to the underlying object
-        std::mutex mutex; //!< Synchronizes concurrent access to services to prevent crashes
+        std::mutex mutex; //!< Synchronizes access to the service map, this is only held for service creation and removal while request dispatch is lock-free
+
+        /**
+         * @brief Call statistics for a single HLE service function, these are exported as perfetto counters and can be dumped on demand to find the functions that would benefit the most from optimization
+         */
+        struct FunctionStatistics {
+            static constexpr size_t LatencyBucketCount{16}; //!< The amount of power-of-two microsecond latency buckets, the last bucket holds all calls that took 16ms or longer
+
+            std::string callTrackName; //!< The name of the perfetto counter track for the amount of calls
+            std::string latencyTrackName; //!< The name of the perfetto counter track for the latency of the most recent call
+            u64 callCount{};
+            u64 totalLatencyNs{};
+            u64 maxLatencyNs{};
+            std::array<u64, LatencyBucketCount> latencyHistogram{}; //!< A histogram of call latencies with bucket N holding calls that took between 2^(N-1) and 2^N microseconds
+        };
+
+        std::mutex statisticsMutex; //!< Synchronizes access to the function statistics, this is separate from the service mutex as it's locked on every request
+        std::unordered_map<const char *, FunctionStatistics> functionStatistics; //!< A map from the static "Class::Function" name of a service function to its statistics
 
       public:
         std::shared_ptr<BaseService> smUserInterface; //!< Used by applications to open connections to services
@@ -69,5 +86,16 @@ namespace skyline::service {
          * @param handle The handle of the object
          */
         void SyncRequestHandler(KHandle handle);
+
+        /**
+         * @brief Records a call to a service function in its statistics
+         * @param name The static "Class::Function" string of the function, it's used as the key for the statistics
+         */
+        void RecordServiceCall(const char *name, u32 id, bool isTipc, u64 latencyNs);
+
+        /**
+         * @return A human-readable table of the statistics for all service functions that have been called, ordered by their total latency
+         */
+        std::string DumpServiceStatistics();
     };
 }
@@ -7,6 +7,52 @@
 namespace skyline::service::socket {
     IClient::IClient(const DeviceState &state, ServiceManager &manager) : BaseService(state, manager) {}
 
+    void IClient::TrackSocket(i32 fd) {
+        fcntl(fd, F_SETFL, fcntl(fd, F_GETFL) | O_NONBLOCK);
+
+        std::scoped_lock lock{socketMutex};
+        sockets.insert(fd);
+        nonBlockingSockets.erase(fd);
+    }
+
+    bool IClient::IsNonBlocking(i32 fd, i32 flags) {
+        if (flags & GuestMsgDontWait)
+            return true;
+
+        std::scoped_lock lock{socketMutex};
+        return nonBlockingSockets.contains(fd) || !sockets.contains(fd);
+    }
+
+    template<typename Operation>
+    ssize_t IClient::PerformBlocking(i32 fd, i32 flags, short events, i32 timeoutOption, Operation operation) {
+        ssize_t result{operation()};
+        if (result != -1 || (errno != EAGAIN && errno != EWOULDBLOCK) || IsNonBlocking(fd, flags))
+            return result;
+
+        timeval timeout{};
+        socklen_t timeoutLength{sizeof(timeout)};
+        i32 timeoutMs{-1};
+        if (getsockopt(fd, SOL_SOCKET, timeoutOption, &timeout, &timeoutLength) == 0 && (timeout.tv_sec || timeout.tv_usec))
+            timeoutMs = static_cast<i32>(timeout.tv_sec * 1000 + timeout.tv_usec / 1000);
+
+        while (true) {
+            pollfd pollFd{.fd = fd, .events = events};
+            i32 pollResult{poll(&pollFd, 1, timeoutMs)};
+            if (pollResult == -1 && errno == EINTR) {
+                continue;
+            } else if (pollResult == -1) {
+                return -1;
+            } else if (pollResult == 0) {
+                errno = EAGAIN; // The socket timeout expired, this matches the behavior of a timed out blocking socket
+                return -1;
+            }
+
+            result = operation();
+            if (result != -1 || (errno != EAGAIN && errno != EWOULDBLOCK))
+                return result;
+        }
+    }
+
     Result IClient::RegisterClient(type::KSession &session, ipc::IpcRequest &request, ipc::IpcResponse &response) {
         response.Push<i32>(0);
         return {};
@@ -22,8 +68,12 @@ namespace skyline::service::socket {
         i32 protocol{request.Pop<i32>()};
         i32 fd{::socket(domain, type, protocol)};
         Logger::Info("File Descriptor {} with Domain {}, Type {}, Protocol {}", fd, domain, type, protocol);
-        if (fd == -1)
+        if (fd == -1) {
             Logger::Error("Error creating socket: {}", strerror(errno));
+            return PushBsdResult(response, -1, errno);
+        }
+
+        TrackSocket(fd);
         return PushBsdResult(response, fd, 0);
     }
 
@@ -36,53 +86,46 @@ namespace skyline::service::socket {
 
         span outputBuf{request.outputBuf.at(0)};
         auto fds{span<pollfd>(reinterpret_cast<pollfd*>(outputBuf.data()), static_cast<u32>(fdsCount))};
-        i32 result{poll(fds.data(), static_cast<u32>(fdsCount), static_cast<i32>(timeout))};
-        return PushBsdResult(response, result, errno);
+        i32 result;
+        do {
+            result = poll(fds.data(), static_cast<u32>(fdsCount), static_cast<i32>(timeout));
+        } while (result == -1 && errno == EINTR); // Host signals used by the emulator itself shouldn't be visible to the guest
+        return PushBsdResult(response, result, result == -1 ? errno : 0);
     }
 
     Result IClient::Recv(type::KSession &session, ipc::IpcRequest &request, ipc::IpcResponse &response) {
         i32 fd{request.Pop<i32>()};
         i32 flags{request.Pop<i32>()};
-        if (fcntl(fd, F_GETFL) == -1)
-            return PushBsdResult(response, -1, EBADF);
-
-        bool shouldBlockAfterOperation{false};
-        if (!(fcntl(fd, F_GETFL) & O_NONBLOCK) && (flags & MSG_EOR)) {
-            fcntl(fd, F_SETFL, O_NONBLOCK);
-            shouldBlockAfterOperation = true;
-        }
-
-        ssize_t result{recv(fd, request.outputBuf.at(0).data(), request.outputBuf.at(0).size(), flags)};
 
-        if (shouldBlockAfterOperation)
-            fcntl(fd, F_SETFL, MSG_EOR);
+        span buffer{request.outputBuf.at(0)};
+        ssize_t result{PerformBlocking(fd, flags, POLLIN, SO_RCVTIMEO, [&] {
+            return recv(fd, buffer.data(), buffer.size(), flags & ~GuestMsgDontWait);
+        })};
         return PushBsdResultErrno(response, result);
     }
 
     Result IClient::RecvFrom(type::KSession &session, ipc::IpcRequest &request, ipc::IpcResponse &response) {
         i32 fd{request.Pop<i32>()};
         i32 flags{request.Pop<i32>()};
-        if (fcntl(fd, F_GETFL) == -1)
-            return PushBsdResult(response, -1, EBADF);
 
-        bool shouldBlockAfterOperation{false};
-        if (!(fcntl(fd, F_GETFL) & O_NONBLOCK) && (flags & MSG_EOR)) {
-            fcntl(fd, F_SETFL, O_NONBLOCK);
-            shouldBlockAfterOperation = true;
-        }
+        // The source address is received directly into the guest buffer when it's large enough to hold it, this avoids a copy for every datagram
+        span addressBuffer{request.outputBuf.at(1)};
+        sockaddr fallbackAddress{};
+        auto &address{addressBuffer.size() >= sizeof(sockaddr) ? addressBuffer.as<sockaddr>() : fallbackAddress};
+        socklen_t addressLength{};
 
-        sockaddr addrIn{};
-        socklen_t addrLen{sizeof(addrIn)};
         span message{request.outputBuf.at(0)};
-        ssize_t result{recvfrom(fd, message.data(), message.size(), 0, &addrIn, &addrLen)};
+        ssize_t result{PerformBlocking(fd, flags, POLLIN, SO_RCVTIMEO, [&] {
+            addressLength = sizeof(sockaddr);
+            return recvfrom(fd, message.data(), message.size(), flags & ~GuestMsgDontWait, &address, &addressLength);
+        })};
+        i32 error{errno};
 
-        if (shouldBlockAfterOperation)
-            fcntl(fd, F_SETFL, MSG_EOR);
+        if (&address == &fallbackAddress && !addressBuffer.empty())
+            addressBuffer.copy_from(span{fallbackAddress});
+        response.Push(addressBuffer.size());
 
-        request.outputBuf.at(0).copy_from(message);
-        if (!request.outputBuf.at(1).empty())
-            request.outputBuf.at(1).copy_from(span{addrIn});
-        response.Push(request.outputBuf.at(1).size());
+        errno = error;
         return PushBsdResultErrno(response, result);
     }
 
@@ -90,7 +133,10 @@ namespace skyline::service::socket {
         i32 fd{request.Pop<i32>()};
         i32 flags{request.Pop<i32>()};
 
-        ssize_t result{send(fd, request.inputBuf.at(0).data(), request.inputBuf.at(0).size(), flags)};
+        span buffer{request.inputBuf.at(0)};
+        ssize_t result{PerformBlocking(fd, flags, POLLOUT, SO_SNDTIMEO, [&] {
+            return send(fd, buffer.data(), buffer.size(), flags & ~GuestMsgDontWait);
+        })};
         return PushBsdResultErrno(response, result);
     }
 
@@ -100,8 +146,10 @@ namespace skyline::service::socket {
 
         sockaddr addrIn{request.inputBuf.at(1).as<sockaddr>()};
         addrIn.sa_family = AF_INET;
-        ssize_t result{sendto(fd, request.inputBuf.at(0).data(), request.inputBuf.at(0).size(), flags,
-                          &addrIn, sizeof(addrIn))};
+        span buffer{request.inputBuf.at(0)};
+        ssize_t result{PerformBlocking(fd, flags, POLLOUT, SO_SNDTIMEO, [&] {
+            return sendto(fd, buffer.data(), buffer.size(), flags & ~GuestMsgDontWait, &addrIn, sizeof(addrIn));
+        })};
         return PushBsdResultErrno(response, result);
     }
 
@@ -109,13 +157,17 @@ namespace skyline::service::socket {
         i32 fd{request.Pop<i32>()};
         sockaddr addr{};
         socklen_t addrLen{sizeof(addr)};
-        i32 result{accept(fd, &addr, &addrLen)};
-        if (errno != 0)
+        auto result{static_cast<i32>(PerformBlocking(fd, 0, POLLIN, SO_RCVTIMEO, [&] {
+            addrLen = sizeof(addr);
+            return accept(fd, &addr, &addrLen);
+        }))};
+        if (result == -1)
             return PushBsdResult(response, -1, errno);
 
+        TrackSocket(result);
         request.outputBuf.at(0).copy_from(span{addr});
         response.Push(request.outputBuf.at(0).size());
-        return PushBsdResult(response, result, errno);
+        return PushBsdResult(response, result, 0);
     }
 
     Result IClient::Bind(type::KSession &session, ipc::IpcRequest &request, ipc::IpcResponse &response) {
@@ -133,7 +185,17 @@ namespace skyline::service::socket {
         addr.sa_family = AF_INET;
 
         i32 result{connect(fd, &addr, sizeof(addr))};
-        return PushBsdResult(response, 0, errno);
+        if (result == -1 && errno == EINPROGRESS && !IsNonBlocking(fd)) {
+            // A connection on a non-blocking host socket completes asynchronously, it's waited on for guest blocking sockets
+            pollfd pollFd{.fd = fd, .events = POLLOUT};
+            while (poll(&pollFd, 1, -1) == -1 && errno == EINTR);
+
+            i32 error{};
+            socklen_t errorLength{sizeof(error)};
+            getsockopt(fd, SOL_SOCKET, SO_ERROR, &error, &errorLength);
+            return PushBsdResult(response, error ? -1 : 0, error);
+        }
+        return PushBsdResult(response, result, result == -1 ? errno : 0);
     }
 
     Result IClient::GetPeerName(type::KSession &session, ipc::IpcRequest &request, ipc::IpcResponse &response) {
@@ -176,8 +238,28 @@ namespace skyline::service::socket {
         i32 fd{request.Pop<i32>()};
         i32 cmd{request.Pop<i32>()};
         i32 arg{request.Pop<i32>()};
+
+        // Host sockets are always non-blocking, the guest's view of O_NONBLOCK is emulated
+        if (cmd == F_GETFL) {
+            i32 result{fcntl(fd, F_GETFL)};
+            if (result == -1)
+                return PushBsdResult(response, -1, errno);
+            return PushBsdResult(response, IsNonBlocking(fd) ? result : (result & ~O_NONBLOCK), 0);
+        } else if (cmd == F_SETFL) {
+            i32 result{fcntl(fd, F_SETFL, arg | O_NONBLOCK)};
+            if (result == -1)
+                return PushBsdResult(response, -1, errno);
+
+            std::scoped_lock lock{socketMutex};
+            if (arg & O_NONBLOCK)
+                nonBlockingSockets.insert(fd);
+            else
+                nonBlockingSockets.erase(fd);
+            return PushBsdResult(response, result, 0);
+        }
+
         i32 result{fcntl(fd, cmd, arg)};
-        return PushBsdResult(response, 0, errno);
+        return PushBsdResult(response, result, result == -1 ? errno : 0);
     }
 
     Result IClient::SetSockOpt(type::KSession &session, ipc::IpcRequest &request, ipc::IpcResponse &response) {
@@ -198,26 +280,46 @@ namespace skyline::service::socket {
     }
 
     Result IClient::ShutdownAllSockets(type::KSession &session, ipc::IpcRequest &request, ipc::IpcResponse &response) {
-        return {};
+        i32 how{request.Pop<i32>()};
+
+        // This also wakes any guest threads which are waiting on the sockets as their polls will be signalled
+        std::scoped_lock lock{socketMutex};
+        for (i32 fd : sockets)
+            shutdown(fd, how);
+        return PushBsdResult(response, 0, 0);
     }
 
     Result IClient::Write(type::KSession &session, ipc::IpcRequest &request, ipc::IpcResponse &response) {
         i32 fd{request.Pop<i32>()};
         i32 flags{request.Pop<i32>()};
-        ssize_t result{send(fd, request.inputBuf.at(0).data(), request.inputBuf.at(0).size(), flags)};
+
+        span buffer{request.inputBuf.at(0)};
+        ssize_t result{PerformBlocking(fd, flags, POLLOUT, SO_SNDTIMEO, [&] {
+            return send(fd, buffer.data(), buffer.size(), flags & ~GuestMsgDontWait);
+        })};
         return PushBsdResultErrno(response, result);
     }
 
     Result IClient::Read(type::KSession &session, ipc::IpcRequest &request, ipc::IpcResponse &response) {
         i32 fd{request.Pop<i32>()};
-        ssize_t result{recv(fd, request.outputBuf.at(0).data(), request.outputBuf.at(0).size(), 0)};
+
+        span buffer{request.outputBuf.at(0)};
+        ssize_t result{PerformBlocking(fd, 0, POLLIN, SO_RCVTIMEO, [&] {
+            return recv(fd, buffer.data(), buffer.size(), 0);
+        })};
         return PushBsdResultErrno(response, result);
     }
 
     Result IClient::Close(type::KSession &session, ipc::IpcRequest &request, ipc::IpcResponse &response) {
         i32 fd{request.Pop<i32>()};
+        {
+            std::scoped_lock lock{socketMutex};
+            sockets.erase(fd);
+            nonBlockingSockets.erase(fd);
+        }
+
         i32 result{close(fd)};
-        return PushBsdResult(response, 0, errno);
+        return PushBsdResult(response, result, result == -1 ? errno : 0);
     }
 
     Result IClient::EventFd(type::KSession &session, ipc::IpcRequest &request, ipc::IpcResponse &response) {
@@ -3,6 +3,7 @@
 
 #pragma once
 
+#include <unordered_set>
 #include <services/serviceman.h>
 #include <netinet/in.h>
 
@@ -21,6 +22,33 @@ namespace skyline::service::socket {
      * @url https://switchbrew.org/wiki/Sockets_services#bsd:u.2C_bsd:s
      */
     class IClient : public BaseService {
+      private:
+        static constexpr i32 GuestMsgDontWait{0x80}; //!< The guest value of MSG_DONTWAIT, this corresponds to MSG_EOR on the host
+
+        std::mutex socketMutex; //!< Synchronizes access to the socket tracking state
+        std::unordered_set<i32> sockets; //!< All sockets created by the guest through this client, host sockets are always in non-blocking mode
+        std::unordered_set<i32> nonBlockingSockets; //!< The sockets which the guest has put into non-blocking mode
+
+        /**
+         * @brief Starts tracking a socket created by the guest and puts the host socket into non-blocking mode
+         */
+        void TrackSocket(i32 fd);
+
+        /**
+         * @return If an operation on the socket should fail with EAGAIN rather than wait for the socket to be ready
+         */
+        bool IsNonBlocking(i32 fd, i32 flags = 0);
+
+        /**
+         * @brief Performs an operation on a non-blocking host socket with the blocking semantics that the guest expects
+         * @param events The poll events which signal that the operation can make progress
+         * @param timeoutOption The socket option (SO_RCVTIMEO/SO_SNDTIMEO) which determines the maximum time to wait for, if any
+         * @return The result of the operation, errno is set accordingly if it failed
+         * @note The calling thread has already released its emulated core in SendSyncRequest, waiting here only occupies the host thread
+         */
+        template<typename Operation>
+        ssize_t PerformBlocking(i32 fd, i32 flags, short events, i32 timeoutOption, Operation operation);
+
       public:
         IClient(const DeviceState &state, ServiceManager &manager);
 
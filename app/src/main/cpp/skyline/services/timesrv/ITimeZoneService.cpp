@@ -80,11 +80,11 @@ namespace skyline::service::timesrv {
     }
 
     Result ITimeZoneService::ParseTimeZoneBinaryIpc(type::KSession &session, ipc::IpcRequest &request, ipc::IpcResponse &response) {
-        return core::TimeZoneManager::ParseTimeZoneBinary(request.inputBuf.at(0), request.outputBuf.at(0));
+        return core.timeZoneManager.ParseTimeZoneBinary(request.inputBuf.at(0), request.outputBuf.at(0));
     }
 
     Result ITimeZoneService::ParseTimeZoneBinary(span<u8> binary, span<u8> rule) {
-        return core::TimeZoneManager::ParseTimeZoneBinary(binary, rule);
+        return core.timeZoneManager.ParseTimeZoneBinary(binary, rule);
     }
 
     Result ITimeZoneService::GetDeviceLocationNameOperationEventReadableHandle(type::KSession &session, ipc::IpcRequest &request, ipc::IpcResponse &response) {
@@ -78,13 +78,44 @@ namespace skyline::service::timesrv::core {
         binaryVersion = pBinaryVersion;
     }
 
+    void TimeZoneManager::CopyRule(tz_timezone_t rule, span<u8> ruleOut) {
+        memcpy(ruleOut.data(), rule, ruleOut.size_bytes());
+    }
+
     Result TimeZoneManager::ParseTimeZoneBinary(span<u8> binary, span<u8> ruleOut) {
-        auto ruleObj{tz_tzalloc(binary.data(), static_cast<long>(binary.size()))};
-        if (!ruleObj)
-            return result::RuleConversionFailed;
+        auto hash{XXH64(binary.data(), binary.size(), 0)};
+
+        std::scoped_lock lock{ruleCacheMutex};
+        auto it{binaryRuleCache.find(hash)};
+        if (it == binaryRuleCache.end()) {
+            RuleHandle ruleObj{tz_tzalloc(binary.data(), static_cast<long>(binary.size())), &tz_tzfree};
+            if (!ruleObj)
+                return result::RuleConversionFailed;
+
+            if (binaryRuleCache.size() >= RuleCacheSizeMax)
+                binaryRuleCache.clear();
+            it = binaryRuleCache.emplace(hash, std::move(ruleObj)).first;
+        }
+
+        CopyRule(it->second.get(), ruleOut);
+        return {};
+    }
 
-        memcpy(ruleOut.data(), ruleObj, ruleOut.size_bytes());
-        tz_tzfree(ruleObj);
+    Result TimeZoneManager::LoadLocationRule(std::string_view pLocationName, const std::function<std::vector<u8>()> &readBinary, span<u8> ruleOut) {
+        std::scoped_lock lock{ruleCacheMutex};
+        auto it{locationRuleCache.find(std::string{pLocationName})};
+        if (it == locationRuleCache.end()) {
+            auto binary{readBinary()};
+            RuleHandle ruleObj{tz_tzalloc(binary.data(), static_cast<long>(binary.size())), &tz_tzfree};
+            if (!ruleObj)
+                return result::RuleConversionFailed;
+
+            if (locationRuleCache.size() >= RuleCacheSizeMax)
+                locationRuleCache.clear();
+            it = locationRuleCache.emplace(pLocationName, std::move(ruleObj)).first;
+        }
+
+        CopyRule(it->second.get(), ruleOut);
         return {};
     }
 
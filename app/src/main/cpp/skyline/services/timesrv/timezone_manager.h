@@ -21,6 +21,18 @@ namespace skyline::service::timesrv::core {
         std::array<u8, 0x10> binaryVersion{}; //!< The version of the tzdata package
         LocationName locationName{}; //!< Name of the currently selected location
 
+        using RuleHandle = std::unique_ptr<std::remove_pointer_t<tz_timezone_t>, decltype(&tz_tzfree)>;
+        static constexpr size_t RuleCacheSizeMax{32}; //!< The maximum amount of parsed rules retained by each cache, they're cleared entirely once this is exceeded
+
+        std::mutex ruleCacheMutex; //!< Synchronizes the rule caches, this is separate from `mutex` as they don't interact with the current location
+        std::unordered_map<u64, RuleHandle> binaryRuleCache; //!< A map from the hash of a TZif binary to the rule parsed from it
+        std::unordered_map<std::string, RuleHandle> locationRuleCache; //!< A map from a location name to the rule parsed from its binary, this avoids reading the binary again as well
+
+        /**
+         * @brief Copies a parsed rule into a guest rule buffer
+         */
+        static void CopyRule(tz_timezone_t rule, span<u8> ruleOut);
+
         void MarkInitialized() {
             initialized = true;
         }
@@ -56,8 +68,15 @@ namespace skyline::service::timesrv::core {
 
         /**
          * @brief Parses a raw TZIF2 file into a timezone rule that can be passed to other functions
+         * @note Parsed rules are cached by the hash of the binary, parsing a binary that was parsed prior is a copy
+         */
+        Result ParseTimeZoneBinary(span<u8> binary, span<u8> ruleOut);
+
+        /**
+         * @brief Writes the timezone rule for a location into the supplied buffer
+         * @param readBinary A function which reads the raw TZIF2 file for the location, this is only called the first time a location is loaded
          */
-        static Result ParseTimeZoneBinary(span<u8> binary, span<u8> ruleOut);
+        Result LoadLocationRule(std::string_view pLocationName, const std::function<std::vector<u8>()> &readBinary, span<u8> ruleOut);
 
         /**
          * @brief Converts a POSIX time to a calendar time using the given rule
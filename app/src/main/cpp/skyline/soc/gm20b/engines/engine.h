@@ -114,6 +114,10 @@ namespace skyline::soc::gm20b::engine {
             throw exception("DrawIndexedInstanced is not implemented for this engine");
         }
 
+        virtual void DrawIndirect(u32 drawTopology, span<u8> indirectBuffer, u32 count, u32 stride) {
+            throw exception("DrawIndirect is not implemented for this engine");
+        }
+
         virtual void DrawIndexedIndirect(u32 drawTopology, span<u8> indirectBuffer, u32 count, u32 stride) {
             throw exception("DrawIndexedIndirect is not implemented for this engine");
         }
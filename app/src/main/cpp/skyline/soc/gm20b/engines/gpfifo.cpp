@@ -22,7 +22,8 @@ namespace skyline::soc::gm20b::engine {
                     channelCtx.executor.AddDeferredAction([=, syncpoints = &this->syncpoints, index = action.index]() {
                         syncpoints->at(index).host.Increment();
                     });
-                    syncpoints.at(action.index).guest.Increment();
+                    auto &syncpoint{syncpoints.at(action.index)};
+                    channelCtx.executor.AddSyncpointFence(syncpoint.host, syncpoint.guest.Increment());
                 } else if (action.operation == Registers::Syncpoint::Operation::Wait) {
                     Logger::Debug("Wait syncpoint: {}, thresh: {}", +action.index, registers.syncpoint->payload);
 
@@ -25,8 +25,13 @@ namespace skyline::soc::gm20b::engine {
             channelCtx.channelSequenceNumber++;
 
             auto srcBuffer{span{buffer}.cast<u8>()};
-            for (u32 line{}, pitchOffset{}; line < state.lineCount; ++line, pitchOffset += state.pitchOut)
-                interconnect.Upload(u64{state.offsetOut + pitchOffset}, srcBuffer.subspan(state.lineLengthIn * line, state.lineLengthIn));
+            if (state.lineCount == 1 || state.pitchOut == state.lineLengthIn) [[likely]] {
+                // Tightly packed lines can be uploaded as a single write, this is the case for practically all constant data uploads
+                interconnect.Upload(u64{state.offsetOut}, srcBuffer.first(state.lineLengthIn * state.lineCount));
+            } else {
+                for (u32 line{}, pitchOffset{}; line < state.lineCount; ++line, pitchOffset += state.pitchOut)
+                    interconnect.Upload(u64{state.offsetOut + pitchOffset}, srcBuffer.subspan(state.lineLengthIn * line, state.lineLengthIn));
+            }
 
         } else {
             channelCtx.executor.Submit();
@@ -6,6 +6,7 @@
 #include <gpu/interconnect/command_executor.h>
 #include <soc/gm20b/channel.h>
 #include <soc.h>
+#include <common/settings.h>
 #include "maxwell/types.h"
 #include "maxwell_3d.h"
 
@@ -42,6 +43,8 @@ namespace skyline::soc::gm20b::engine::maxwell3d {
             .blendConstantsRegisters = {*registers.blendConsts},
             .depthBoundsRegisters = {*registers.depthBoundsMin, *registers.depthBoundsMax},
             .stencilValuesRegisters = {*registers.stencilValues, *registers.backStencilValues, *registers.twoSidedStencilTestEnable},
+            .extendedDynamicStateRegisters = {*registers.oglCullEnable, *registers.oglCullFace, *registers.oglFrontFace, *registers.windowOrigin, *registers.depthTestEnable, *registers.depthWriteEnable, *registers.depthFunc, *registers.depthBoundsTestEnable, *registers.stencilTestEnable, *registers.twoSidedStencilTestEnable, *registers.stencilOps, *registers.stencilBack},
+            .vertexInputLayoutRegisters = {*registers.vertexStreams, *registers.vertexStreamInstance, *registers.vertexAttributes},
         };
     }
 
@@ -63,26 +66,28 @@ namespace skyline::soc::gm20b::engine::maxwell3d {
     }
 
     bool Maxwell3D::CheckRenderEnable() {
+        interconnect.SetRenderCondition(std::nullopt);
+
         if (registers.renderEnableOverride->mode == Registers::RenderEnableOverride::Mode::AlwaysRender)
             return true;
         else if (registers.renderEnableOverride->mode == Registers::RenderEnableOverride::Mode::NeverRender)
             return false;
 
-
-
         switch (registers.renderEnable->mode) {
             case Registers::RenderEnable::Mode::True:
                 return true;
             case Registers::RenderEnable::Mode::False:
                 return false;
             case Registers::RenderEnable::Mode::Conditional:
-                // TODO: Use indirect draws to emulate conditional rendering with queries, for now just ignore such cases as they would decrease performance anyway by forcing a CPU sync
-                if (interconnect.QueryPresentAtAddress(u64{registers.renderEnable->offset}))
+                // Query results are predicated on the GPU with conditional rendering where possible, otherwise they're ignored as reading them would force a CPU sync
+                if (interconnect.QueryPresentAtAddress(u64{registers.renderEnable->offset})) {
+                    interconnect.SetRenderCondition(u64{registers.renderEnable->offset});
                     return true;
+                }
 
                 return channelCtx.asCtx->gmmu.Read<u32>(registers.renderEnable->offset) != 0;
             case Registers::RenderEnable::Mode::RenderIfEqual:
-                // TODO: See above
+                // TODO: Comparisons between two query results can't be expressed with conditional rendering, they're ignored for the same reason as above
                 if (interconnect.QueryPresentAtAddress(u64{registers.renderEnable->offset}) ||
                     interconnect.QueryPresentAtAddress(u64{registers.renderEnable->offset + 16}))
                     return true;
@@ -108,7 +113,7 @@ namespace skyline::soc::gm20b::engine::maxwell3d {
           syncpoints{state.soc->host1x.syncpoints},
           i2m{state, channelCtx},
           dirtyManager{registers},
-          interconnect{*state.gpu, channelCtx, *state.nce, state.process->memory, dirtyManager, MakeEngineRegisters(registers)},
+          interconnect{*state.gpu, channelCtx, *state.nce, state.process->memory, dirtyManager, MakeEngineRegisters(registers), *state.settings->asyncPipelineCompilation},
           channelCtx{channelCtx} {
         channelCtx.executor.AddFlushCallback([this]() { FlushEngineState(); });
         InitializeRegisters();
@@ -123,6 +128,35 @@ namespace skyline::soc::gm20b::engine::maxwell3d {
         }
     }
 
+    /**
+     * @brief A table of all methods that have side effects beyond updating their register and dirty state, these always need to go through HandleMethod
+     * @note This *MUST* be kept in sync with the method cases in HandleMethod
+     */
+    static constexpr std::array<bool, EngineMethodsEnd> SideEffectMethods{[] {
+        using Registers = Maxwell3D::Registers;
+        std::array<bool, EngineMethodsEnd> methods{};
+
+        for (u32 method : {
+            ENGINE_STRUCT_OFFSET(mme, shadowRamControl), ENGINE_STRUCT_OFFSET(mme, instructionRamLoad), ENGINE_STRUCT_OFFSET(mme, startAddressRamLoad),
+            ENGINE_STRUCT_OFFSET(i2m, launchDma), ENGINE_STRUCT_OFFSET(i2m, loadInlineData),
+            ENGINE_OFFSET(clearReportValue), ENGINE_OFFSET(syncpointAction), ENGINE_OFFSET(clearSurface), ENGINE_OFFSET(begin), ENGINE_OFFSET(end),
+            ENGINE_STRUCT_OFFSET(drawVertexArray, count), ENGINE_OFFSET(drawVertexArrayBeginEndInstanceFirst), ENGINE_OFFSET(drawVertexArrayBeginEndInstanceSubsequent),
+            ENGINE_STRUCT_OFFSET(drawInlineIndex4X8, index0), ENGINE_STRUCT_OFFSET(drawInlineIndex2X16, even), ENGINE_STRUCT_OFFSET(drawZeroIndex, count), ENGINE_STRUCT_OFFSET(drawAuto, byteCount), ENGINE_OFFSET(drawInlineIndex),
+            ENGINE_STRUCT_OFFSET(drawIndexBuffer, count), ENGINE_OFFSET(drawIndexBuffer32BeginEndInstanceFirst), ENGINE_OFFSET(drawIndexBuffer16BeginEndInstanceFirst), ENGINE_OFFSET(drawIndexBuffer8BeginEndInstanceFirst),
+            ENGINE_OFFSET(drawIndexBuffer32BeginEndInstanceSubsequent), ENGINE_OFFSET(drawIndexBuffer16BeginEndInstanceSubsequent), ENGINE_OFFSET(drawIndexBuffer8BeginEndInstanceSubsequent),
+            ENGINE_STRUCT_OFFSET(semaphore, info), ENGINE_ARRAY_OFFSET(firmwareCall, 4), ENGINE_OFFSET(invalidateSamplerCacheAll), ENGINE_OFFSET(invalidateTextureHeaderCacheAll),
+        })
+            methods[method] = true;
+
+        for (u32 index{}; index < 16; index++)
+            methods[ENGINE_STRUCT_ARRAY_OFFSET(loadConstantBuffer, data, index)] = true;
+
+        for (u32 index{}; index < type::ShaderStageCount; index++)
+            methods[ENGINE_ARRAY_STRUCT_OFFSET(bindGroups, index, constantBuffer)] = true;
+
+        return methods;
+    }()};
+
     __attribute__((always_inline)) void Maxwell3D::HandleMethod(u32 method, u32 argument) {
         if (method == ENGINE_STRUCT_OFFSET(mme, shadowRamControl)) [[unlikely]] {
             shadowRegisters.raw[method] = registers.raw[method] = argument;
@@ -267,7 +301,8 @@ namespace skyline::soc::gm20b::engine::maxwell3d {
                 channelCtx.executor.AddDeferredAction([=, syncpoints = &this->syncpoints, index = syncpointAction.id]() {
                     syncpoints->at(index).host.Increment();
                 });
-                syncpoints.at(syncpointAction.id).guest.Increment();
+                auto &syncpoint{syncpoints.at(syncpointAction.id)};
+                channelCtx.executor.AddSyncpointFence(syncpoint.host, syncpoint.guest.Increment());
             })
 
             ENGINE_CASE(clearSurface, {
@@ -510,6 +545,15 @@ namespace skyline::soc::gm20b::engine::maxwell3d {
             case ENGINE_STRUCT_OFFSET(i2m, loadInlineData):
                 i2m.LoadInlineData(*registers.i2m, arguments);
                 return;
+
+            #define LOAD_CONSTANT_BUFFER_CASES(z, index, data_) \
+            case ENGINE_STRUCT_ARRAY_OFFSET(loadConstantBuffer, data, index):
+
+            BOOST_PP_REPEAT(16, LOAD_CONSTANT_BUFFER_CASES, 0)
+            #undef LOAD_CONSTANT_BUFFER_CASES
+                LoadConstantBufferRun(method, arguments, false);
+                return;
+
             default:
                 break;
         }
@@ -518,6 +562,92 @@ namespace skyline::soc::gm20b::engine::maxwell3d {
             HandleMethod(method, argument);
     }
 
+    void Maxwell3D::WriteRegisters(u32 method, span<u32> arguments) {
+        auto target{span(registers.raw).subspan(method, arguments.size())};
+        auto shadowTarget{span(shadowRegisters.raw).subspan(method, arguments.size())};
+
+        span<u32> source{arguments};
+        if (shadowRegisters.mme->shadowRamControl == type::MmeShadowRamControl::MethodTrack || shadowRegisters.mme->shadowRamControl == type::MmeShadowRamControl::MethodTrackWithFilter) [[unlikely]]
+            shadowTarget.copy_from(arguments);
+        else if (shadowRegisters.mme->shadowRamControl == type::MmeShadowRamControl::MethodReplay) [[unlikely]]
+            source = shadowTarget;
+
+        // Only the range between the first and last modified registers is marked dirty, any redundant writes within it are conservatively treated as modifications
+        auto firstModified{std::mismatch(target.begin(), target.end(), source.begin()).first};
+        if (firstModified == target.end())
+            return;
+
+        auto lastModified{std::mismatch(target.rbegin(), target.rend(), source.rbegin()).first.base()};
+        target.copy_from(source);
+        dirtyManager.MarkDirty(method + static_cast<u32>(std::distance(target.begin(), firstModified)), static_cast<size_t>(std::distance(firstModified, lastModified)));
+    }
+
+    void Maxwell3D::LoadConstantBufferRun(u32 method, span<u32> data, bool increment) {
+        // The first write goes through the regular path, this begins the batch and flushes any other batch that might be active
+        HandleMethod(method, data.front());
+
+        auto remaining{data.subspan(1)};
+        if (remaining.empty())
+            return;
+
+        if (!batchEnableState.constantBufferActive || shadowRegisters.mme->shadowRamControl == type::MmeShadowRamControl::MethodReplay) [[unlikely]] {
+            for (u32 i{}; i < remaining.size(); i++)
+                HandleMethod(increment ? method + 1 + i : method, remaining[i]);
+            return;
+        }
+
+        auto &buffer{batchLoadConstantBuffer.buffer};
+        buffer.insert(buffer.end(), remaining.begin(), remaining.end());
+        registers.loadConstantBuffer->offset += static_cast<u32>(remaining.size_bytes());
+
+        bool trackShadow{shadowRegisters.mme->shadowRamControl == type::MmeShadowRamControl::MethodTrack || shadowRegisters.mme->shadowRamControl == type::MmeShadowRamControl::MethodTrackWithFilter};
+        if (increment) {
+            span(registers.raw).subspan(method + 1, remaining.size()).copy_from(remaining);
+            if (trackShadow)
+                span(shadowRegisters.raw).subspan(method + 1, remaining.size()).copy_from(remaining);
+        } else {
+            registers.raw[method] = remaining.back();
+            if (trackShadow)
+                shadowRegisters.raw[method] = remaining.back();
+        }
+    }
+
+    void Maxwell3D::CallMethodBatchInc(u32 method, span<u32> arguments) {
+        Logger::Verbose("Called batch of methods in Maxwell 3D: 0x{:X} count: 0x{:X}", method, arguments.size());
+
+        if (method + arguments.size() > EngineMethodsEnd) [[unlikely]]
+            throw exception("Batch of methods 0x{:X}-0x{:X} is out of bounds", method, method + arguments.size());
+
+        size_t index{};
+        while (index < arguments.size()) {
+            // Any active batch needs to inspect every method so they're handled individually until it ends
+            if (!batchEnableState.raw) [[likely]] {
+                size_t runEnd{index};
+                while (runEnd < arguments.size() && !SideEffectMethods[method + runEnd])
+                    runEnd++;
+
+                if (runEnd != index) {
+                    WriteRegisters(method + static_cast<u32>(index), arguments.subspan(index, runEnd - index));
+                    index = runEnd;
+                    continue;
+                }
+            }
+
+            constexpr u32 LoadConstantBufferDataBegin{ENGINE_STRUCT_OFFSET(loadConstantBuffer, data)};
+            constexpr u32 LoadConstantBufferDataEnd{LoadConstantBufferDataBegin + 16};
+            u32 currentMethod{method + static_cast<u32>(index)};
+            if (currentMethod >= LoadConstantBufferDataBegin && currentMethod < LoadConstantBufferDataEnd) {
+                size_t dataCount{std::min<size_t>(LoadConstantBufferDataEnd - currentMethod, arguments.size() - index)};
+                LoadConstantBufferRun(currentMethod, arguments.subspan(index, dataCount), true);
+                index += dataCount;
+                continue;
+            }
+
+            HandleMethod(currentMethod, arguments[index]);
+            index++;
+        }
+    }
+
     void Maxwell3D::CallMethodFromMacro(u32 method, u32 argument) {
         HandleMethod(method, argument);
     }
@@ -544,6 +674,13 @@ namespace skyline::soc::gm20b::engine::maxwell3d {
             interconnect.Draw(topology, *registers.streamOutputEnable, true, indexBufferCount, indexBufferFirst, instanceCount, globalBaseVertexIndex, globalBaseInstanceIndex);
     }
 
+    void Maxwell3D::DrawIndirect(u32 drawTopology, span<u8> indirectBuffer, u32 count, u32 stride) {
+        FlushEngineState();
+        auto topology{static_cast<type::DrawTopology>(drawTopology)};
+        if (CheckRenderEnable())
+            interconnect.DrawIndirect(topology, *registers.streamOutputEnable, false, indirectBuffer, count, stride);
+    }
+
     void Maxwell3D::DrawIndexedIndirect(u32 drawTopology, span<u8> indirectBuffer, u32 count, u32 stride) {
         FlushEngineState();
         auto topology{static_cast<type::DrawTopology>(drawTopology)};
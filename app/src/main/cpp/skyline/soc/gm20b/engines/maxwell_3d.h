@@ -80,6 +80,18 @@ namespace skyline::soc::gm20b::engine::maxwell3d {
          */
         void HandleMethod(u32 method, u32 argument);
 
+        /**
+         * @brief Writes a run of consecutive registers without any side effects, this handles shadow RAM and dirty tracking for the entire run at once
+         * @note None of the methods in the run may have any side effects beyond updating their register and there must be no active batch
+         */
+        void WriteRegisters(u32 method, span<u32> arguments);
+
+        /**
+         * @brief Handles a run of writes to the constant buffer load data methods, appending all of them to the batched constant buffer update at once
+         * @param increment If the method address is incremented after each write, the run must not go past the final data method if so
+         */
+        void LoadConstantBufferRun(u32 method, span<u32> data, bool increment);
+
       public:
         /**
          * @url https://github.com/devkitPro/deko3d/blob/master/source/maxwell/engine_3d.def
@@ -480,6 +492,11 @@ namespace skyline::soc::gm20b::engine::maxwell3d {
 
         void CallMethodBatchNonInc(u32 method, span<u32> arguments);
 
+        /**
+         * @brief Calls a run of incrementing methods starting at the supplied method, runs of methods without side effects are written in bulk
+         */
+        void CallMethodBatchInc(u32 method, span<u32> arguments);
+
         void CallMethodFromMacro(u32 method, u32 argument) override;
 
         u32 ReadMethodFromMacro(u32 method) override;
@@ -488,6 +505,8 @@ namespace skyline::soc::gm20b::engine::maxwell3d {
 
         void DrawIndexedInstanced(u32 drawTopology, u32 indexBufferCount, u32 instanceCount, u32 globalBaseVertexIndex, u32 indexBufferFirst, u32 globalBaseInstanceIndex) override;
 
+        void DrawIndirect(u32 drawTopology, span<u8> indirectBuffer, u32 count, u32 stride) override;
+
         void DrawIndexedIndirect(u32 drawTopology, span<u8> indirectBuffer, u32 count, u32 stride) override;
     };
 }
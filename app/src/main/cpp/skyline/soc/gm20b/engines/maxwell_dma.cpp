@@ -43,8 +43,6 @@ namespace skyline::soc::gm20b::engine {
                 return;
             }
 
-            channelCtx.executor.Submit();
-
             if (registers.launchDma->srcMemoryLayout == registers.launchDma->dstMemoryLayout) [[unlikely]] {
                 // Pitch to Pitch copy
                 if (registers.launchDma->srcMemoryLayout == Registers::LaunchDma::MemoryLayout::Pitch) [[likely]] {
@@ -123,10 +121,19 @@ namespace skyline::soc::gm20b::engine {
         auto srcMappings{channelCtx.asCtx->gmmu.TranslateRange(*registers.offsetIn, *registers.pitchIn * *registers.lineCount)};
         auto dstMappings{channelCtx.asCtx->gmmu.TranslateRange(*registers.offsetOut, *registers.pitchOut * *registers.lineCount)};
 
+        bool contiguous{(*registers.pitchIn == *registers.pitchOut) && (*registers.pitchIn == *registers.lineLengthIn)};
+        if (contiguous && srcMappings.size() == 1 && dstMappings.size() == 1) [[likely]] {
+            // Both Linear and tightly packed, this is equivalent to a 1D copy which can be done on the GPU without any synchronization
+            interconnect.Copy(dstMappings.front(), srcMappings.front());
+            return;
+        }
+
+        channelCtx.executor.Submit();
+
         if (srcMappings.size() != 1 || dstMappings.size() != 1) [[unlikely]] {
             HandleSplitCopy(srcMappings, dstMappings, *registers.lineLengthIn, *registers.lineLengthIn, [&](u8 *src, u8 *dst) {
                 // Both Linear, copy as is.
-                if ((*registers.pitchIn == *registers.pitchOut) && (*registers.pitchIn == *registers.lineLengthIn))
+                if (contiguous)
                     std::memcpy(dst, src, *registers.lineLengthIn * *registers.lineCount);
                 else
                     for (size_t linesToCopy{*registers.lineCount}, srcCopyOffset{}, dstCopyOffset{}; linesToCopy; --linesToCopy, srcCopyOffset += *registers.pitchIn, dstCopyOffset += *registers.pitchOut)
@@ -134,7 +141,7 @@ namespace skyline::soc::gm20b::engine {
             });
         } else [[likely]] {
             // Both Linear, copy as is.
-            if ((*registers.pitchIn == *registers.pitchOut) && (*registers.pitchIn == *registers.lineLengthIn)) {
+            if (contiguous) {
                 std::memcpy(dstMappings.front().data(), srcMappings.front().data(), *registers.lineLengthIn * *registers.lineCount);
             } else {
                 for (size_t linesToCopy{*registers.lineCount}, srcCopyOffset{}, dstCopyOffset{}; linesToCopy; --linesToCopy, srcCopyOffset += *registers.pitchIn, dstCopyOffset += *registers.pitchOut)
@@ -184,6 +191,15 @@ namespace skyline::soc::gm20b::engine {
 
         Logger::Debug("{}x{}x{}@0x{:X} -> {}x{}x{}@0x{:X}", srcDimensions.width, srcDimensions.height, srcDimensions.depth, srcLayerAddress, dstDimensions.width, dstDimensions.height, dstDimensions.depth, u64{*registers.offsetOut});
 
+        // Copies of an entire surface that's backed by a texture are done on the GPU, this avoids synchronizing the texture back to the guest
+        if (srcMappings.size() == 1 && dstMappings.size() == 1 && !registers.srcSurface->layer && srcDimensions.depth == 1 &&
+            srcDimensions.width == dstDimensions.width && srcDimensions.height == dstDimensions.height && !registers.srcSurface->origin.x && !registers.srcSurface->origin.y)
+            if (interconnect.CopyBlockLinearToPitch(dstMappings.front(), srcMappings.front(), *registers.pitchOut, dstDimensions.width, dstDimensions.height,
+                                                    registers.srcSurface->blockSize.Height(), registers.srcSurface->blockSize.Depth()))
+                return;
+
+        channelCtx.executor.Submit();
+
         if (srcMappings.size() != 1 || dstMappings.size() != 1) [[unlikely]]
             HandleSplitCopy(srcMappings, dstMappings, srcLayerStride, dstSize, copyFunc);
         else [[likely]]
@@ -231,6 +247,15 @@ namespace skyline::soc::gm20b::engine {
             }
         }};
 
+        // Copies of an entire surface that's backed by a texture are done on the GPU, this avoids synchronizing the texture with the guest
+        if (srcMappings.size() == 1 && dstMappings.size() == 1 && !registers.dstSurface->layer && dstDimensions.depth == 1 &&
+            srcDimensions.width == dstDimensions.width && srcDimensions.height == dstDimensions.height && !registers.dstSurface->origin.x && !registers.dstSurface->origin.y)
+            if (interconnect.CopyPitchToBlockLinear(dstMappings.front(), srcMappings.front(), *registers.pitchIn, srcDimensions.width, srcDimensions.height,
+                                                    registers.dstSurface->blockSize.Height(), registers.dstSurface->blockSize.Depth()))
+                return;
+
+        channelCtx.executor.Submit();
+
         if (srcMappings.size() != 1 || dstMappings.size() != 1) [[unlikely]]
             HandleSplitCopy(srcMappings, dstMappings, srcSize, dstLayerStride, copyFunc);
         else [[likely]]
@@ -3,7 +3,10 @@
 
 #include <gpu.h>
 #include <common/signal.h>
+#include <common/host_affinity.h>
+#include <common/performance_hint.h>
 #include <common/settings.h>
+#include <common/trace.h>
 #include <loader/loader.h>
 #include <kernel/types/KProcess.h>
 #include <soc.h>
@@ -87,6 +90,7 @@ namespace skyline::soc::gm20b {
         gpfifoEngine(state.soc->host1x.syncpoints, channelCtx),
         channelCtx(channelCtx),
         gpEntries(numEntries),
+        decodeThread(std::thread(&ChannelGpfifo::DecodeRun, this)),
         thread(std::thread(&ChannelGpfifo::Run, this)) {}
 
     void ChannelGpfifo::SendFull(u32 method, GpfifoArgument argument, SubchannelId subChannel, bool lastCall) {
@@ -162,239 +166,272 @@ namespace skyline::soc::gm20b {
         }
     }
 
-    void ChannelGpfifo::Process(GpEntry gpEntry) {
-        if (!gpEntry.size) {
-            // This is a GPFIFO control entry, all control entries have a zero length and contain no pushbuffers
-            switch (gpEntry.opcode) {
-                case GpEntry::Opcode::Nop:
-                    return;
-                default:
-                    Logger::Warn("Unsupported GpEntry control opcode used: {}", static_cast<u8>(gpEntry.opcode));
-                    return;
-            }
+    void ChannelGpfifo::SendPureBatchInc(u32 method, span<u32> arguments, SubchannelId subChannel) {
+        if (subChannel == SubchannelId::ThreeD) [[likely]] {
+            channelCtx.maxwell3D.CallMethodBatchInc(method, arguments);
+            return;
         }
 
-        auto pushBufferMappedRanges{channelCtx.asCtx->gmmu.TranslateRange(gpEntry.Address(), gpEntry.size * sizeof(u32))};
-
-        bool pushBufferCopied{}; //!< Set by the below lambda in order to track if the pushbuffer is a copy of guest memory or not
-        auto pushBuffer{[&]() -> span<u32> {
-            if (pushBufferMappedRanges.size() == 1) {
-                return pushBufferMappedRanges.front().cast<u32>();
-            } else {
-                // Create an intermediate copy of pushbuffer data if it's split across multiple mappings
-                pushBufferData.resize(gpEntry.size);
-                channelCtx.asCtx->gmmu.Read<u32>(pushBufferData, gpEntry.Address());
-                pushBufferCopied = true;
-                return span(pushBufferData);
-            }
-        }()};
+        for (u32 i{}; i < arguments.size(); i++)
+            SendPure(method + i, arguments[i], subChannel);
+    }
 
-        bool pushbufferDirty{false};
+    void ChannelGpfifo::Decode(GpEntry gpEntry, DecodedGpEntry &decoded, MethodResumeState &resume) {
+        decoded.gpEntry = gpEntry;
+        decoded.runs.clear();
+        decoded.decodeException = nullptr;
+        decoded.startResumeState = resume;
+        decoded.mappedRanges = channelCtx.asCtx->gmmu.TranslateRange(gpEntry.Address(), gpEntry.size * sizeof(u32));
 
-        for (auto range : pushBufferMappedRanges) {
-            if (channelCtx.executor.usageTracker.dirtyIntervals.Intersect(range)) {
-                if (skipDirtyFlushes)
-                    pushbufferDirty = true;
+        decoded.pushBufferCopied = false;
+        auto pushBuffer{[&]() -> span<u32> {
+            // Parse the pushbuffer in-place if it's entirely contained within a single host mapping
+            if (decoded.mappedRanges.size() == 1 && decoded.mappedRanges.front().valid()) [[likely]]
+                return decoded.mappedRanges.front().cast<u32>();
+
+            // Otherwise create an intermediate copy of pushbuffer data from the already translated ranges, sparse ranges read as zero
+            decoded.pushBufferData.resize(gpEntry.size);
+            auto destination{span(decoded.pushBufferData).cast<u8>()};
+            for (auto range : decoded.mappedRanges) {
+                if (range.valid())
+                    destination.copy_from(range);
                 else
-                    channelCtx.executor.Submit({}, true);
+                    std::memset(destination.data(), 0, range.size());
+
+                destination = destination.subspan(range.size());
             }
-        }
 
-        // There will be at least one entry here
-        auto entry{pushBuffer.begin()};
+            decoded.pushBufferCopied = true;
+            return span(decoded.pushBufferData);
+        }()};
+
+        size_t index{}; //!< The index of the next entry to decode in the pushbuffer
 
-        auto getArgument{[&](){
-            return GpfifoArgument{pushBufferCopied ? *entry : 0, pushBufferCopied ? nullptr : entry.base(), pushbufferDirty};
+        /**
+         * @brief Appends a run of method calls taking their arguments from the next entries in the pushbuffer
+         */
+        auto appendRun{[&](u32 address, u32 count, bool increment, bool pure, bool lastCall, SubchannelId subChannel, bool flushEngineState) {
+            if (count || flushEngineState)
+                decoded.runs.push_back(MethodRun{
+                    .arguments = pushBuffer.subspan(index, count),
+                    .address = address,
+                    .subChannel = subChannel,
+                    .increment = increment,
+                    .pure = pure,
+                    .lastCall = lastCall,
+                    .flushEngineState = flushEngineState,
+                });
+
+            index += count;
         }};
 
-        // Executes the current split method, returning once execution is finished or the current GpEntry has reached its end
-        auto resumeSplitMethod{[&](){
-            switch (resumeState.state) {
-                case MethodResumeState::State::Inc:
-                    while (entry != pushBuffer.end() && resumeState.remaining) {
-                        SendFull(resumeState.address++, getArgument(), resumeState.subChannel, --resumeState.remaining == 0);
-                        entry++;
-                    }
+        // Decodes as much of the current split method as is contained within the pushbuffer, split methods always take the slow path
+        auto resumeSplitMethod{[&]() {
+            auto availableCount{[&]() -> u32 {
+                return static_cast<u32>(std::min<size_t>(resume.remaining, pushBuffer.size() - index));
+            }};
 
+            switch (resume.state) {
+                case MethodResumeState::State::Inc: {
+                    u32 count{availableCount()};
+                    resume.remaining -= count;
+                    appendRun(resume.address, count, true, false, resume.remaining == 0, resume.subChannel, false);
+                    resume.address += count;
                     break;
+                }
+
                 case MethodResumeState::State::OneInc:
-                    SendFull(resumeState.address++, getArgument(), resumeState.subChannel, --resumeState.remaining == 0);
-                    entry++;
+                    if (index == pushBuffer.size())
+                        break;
+
+                    resume.remaining--;
+                    appendRun(resume.address++, 1, true, false, resume.remaining == 0, resume.subChannel, false);
 
                     // After the first increment OneInc methods work the same as a NonInc method, this is needed so they can resume correctly if they are broken up by multiple GpEntries
-                    resumeState.state = MethodResumeState::State::NonInc;
+                    resume.state = MethodResumeState::State::NonInc;
                     [[fallthrough]];
-                case MethodResumeState::State::NonInc:
-                    while (entry != pushBuffer.end() && resumeState.remaining) {
-                        SendFull(resumeState.address, getArgument(), resumeState.subChannel, --resumeState.remaining == 0);
-                        entry++;
-                    }
-
+                case MethodResumeState::State::NonInc: {
+                    u32 count{availableCount()};
+                    resume.remaining -= count;
+                    appendRun(resume.address, count, false, false, resume.remaining == 0, resume.subChannel, false);
                     break;
+                }
             }
         }};
 
         // We've a method from a previous GpEntry that needs resuming
-        if (resumeState.remaining)
+        if (resume.remaining)
             resumeSplitMethod();
 
-        // Process more methods if the entries are still not all used up after handling resuming
-        for (; entry != pushBuffer.end(); entry++) {
-            if (entry >= pushBuffer.end()) [[unlikely]]
-                throw exception("GPFIFO buffer overflow!"); // This should never happen
-
+        // Decode more methods if the entries are still not all used up after handling resuming
+        while (index < pushBuffer.size()) {
             // Entries containing all zeroes is a NOP, skip over them
-            for (; *entry == 0; entry++)
-                if (entry == std::prev(pushBuffer.end()))
-                    return;
+            if (pushBuffer[index] == 0) {
+                index++;
+                continue;
+            }
 
-            PushBufferMethodHeader methodHeader{.raw = *entry};
+            PushBufferMethodHeader methodHeader{.raw = pushBuffer[index++]};
 
             // Needed in order to check for methods split across multiple GpEntries
-            ssize_t remainingEntries{std::distance(entry, pushBuffer.end()) - 1};
+            size_t remainingEntries{pushBuffer.size() - index};
+
+            bool flushEngineState{methodHeader.methodSubChannel != SubchannelId::ThreeD}; //!< The 3D engine state is flushed when doing any calls to other engines
 
-            // Handles storing state and initial execution for methods that are split across multiple GpEntries
-            auto startSplitMethod{[&](auto methodState) {
-                resumeState = {
+            /**
+             * @brief Decodes a method of the type specified by the method state
+             * @return If the method was split across GpEntries, ending the current GpEntry
+             */
+            auto decodeMethod{[&](MethodResumeState::State methodState) -> bool {
+                if (remainingEntries >= methodHeader.methodCount) [[likely]] {
+                    bool pure{methodHeader.Pure()};
+                    if (methodState == MethodResumeState::State::OneInc && methodHeader.methodCount) {
+                        appendRun(methodHeader.methodAddress, 1, true, pure, methodHeader.methodCount == 1, methodHeader.methodSubChannel, flushEngineState);
+                        appendRun(methodHeader.methodAddress + 1, methodHeader.methodCount - 1, false, pure, true, methodHeader.methodSubChannel, false);
+                    } else {
+                        appendRun(methodHeader.methodAddress, methodHeader.methodCount, methodState == MethodResumeState::State::Inc, pure, true, methodHeader.methodSubChannel, flushEngineState);
+                    }
+
+                    return false;
+                }
+
+                // Store the state required for resuming the method in the next GpEntry
+                resume = {
                     .remaining = methodHeader.methodCount,
                     .address = methodHeader.methodAddress,
                     .subChannel = methodHeader.methodSubChannel,
                     .state = methodState
                 };
 
-                // Skip over method header as `resumeSplitMethod` doesn't expect it to be there
-                entry++;
-
+                appendRun(methodHeader.methodAddress, 0, false, false, false, methodHeader.methodSubChannel, flushEngineState);
                 resumeSplitMethod();
+                return true;
             }};
 
-            /**
-             * @brief Handles execution of a specific method type as specified by the State template parameter
-             */
-            auto dispatchCalls{[&]<MethodResumeState::State State> () {
-                /**
-                 * @brief Gets the offset to apply to the method address for a given dispatch loop index
-                 */
-                auto methodOffset{[] (u32 i) -> u32 {
-                    if constexpr(State == MethodResumeState::State::Inc)
-                        return i;
-                    else if constexpr (State == MethodResumeState::State::OneInc)
-                        return i ? 1 : 0;
-                    else
-                        return 0;
-                }};
-
-                constexpr u32 BatchCutoff{4}; //!< Cutoff needed to send method calls in a batch which is espcially important for UBO updates. This helps to avoid the extra overhead batching for small packets.
-                // TODO: Only batch for specific target methods like UBO updates, since normal dispatch is generally cheaper
-
-                if (remainingEntries >= methodHeader.methodCount) { [[likely]]
-                    if (methodHeader.Pure()) [[likely]] {
-                        if constexpr (State == MethodResumeState::State::NonInc) {
-                            // For pure noninc methods we can send all method calls as a span in one go
-                            if (methodHeader.methodCount > BatchCutoff) [[unlikely]] {
-                                SendPureBatchNonInc(methodHeader.methodAddress, span(&(*++entry), methodHeader.methodCount), methodHeader.methodSubChannel);
-
-                                entry += methodHeader.methodCount - 1;
-                                return false;
-                            }
-                        } else if constexpr (State == MethodResumeState::State::OneInc) {
-                            // For pure oneinc methods we can send the initial method then send the rest as a span in one go
-                            if (methodHeader.methodCount > (BatchCutoff + 1)) [[unlikely]] {
-                                SendPure(methodHeader.methodAddress, *++entry, methodHeader.methodSubChannel);
-                                SendPureBatchNonInc(methodHeader.methodAddress + 1, span((++entry).base(), methodHeader.methodCount - 1), methodHeader.methodSubChannel);
-
-                                entry += methodHeader.methodCount - 2;
-                                return false;
-                            }
-                        }
+            bool hitEnd{[&]() {
+                switch (methodHeader.secOp) {
+                    case PushBufferMethodHeader::SecOp::IncMethod:
+                        return decodeMethod(MethodResumeState::State::Inc);
+
+                    case PushBufferMethodHeader::SecOp::OneInc:
+                        return decodeMethod(MethodResumeState::State::OneInc);
+
+                    case PushBufferMethodHeader::SecOp::NonIncMethod:
+                        return decodeMethod(MethodResumeState::State::NonInc);
+
+                    case PushBufferMethodHeader::SecOp::ImmdDataMethod:
+                        decoded.runs.push_back(MethodRun{
+                            .address = methodHeader.methodAddress,
+                            .immediate = methodHeader.immdData,
+                            .subChannel = methodHeader.methodSubChannel,
+                            .isImmediate = true,
+                            .pure = methodHeader.Pure(),
+                            .lastCall = true,
+                            .flushEngineState = flushEngineState,
+                        });
+                        return false;
 
-                        #pragma unroll(2)
-                        for (u32 i{}; i < methodHeader.methodCount; i++)
-                            SendPure(methodHeader.methodAddress + methodOffset(i), *++entry, methodHeader.methodSubChannel);
-                    } else {
-                        // Slow path for methods that touch GPFIFO or macros
-                        for (u32 i{}; i < methodHeader.methodCount; i++) {
-                            entry++;
-                            SendFull(methodHeader.methodAddress + methodOffset(i), getArgument(), methodHeader.methodSubChannel, i == methodHeader.methodCount - 1);
+                    case PushBufferMethodHeader::SecOp::EndPbSegment:
+                        appendRun(methodHeader.methodAddress, 0, false, false, false, methodHeader.methodSubChannel, flushEngineState);
+                        return true;
+
+                    case PushBufferMethodHeader::SecOp::Grp0UseTert:
+                        if (methodHeader.tertOp == PushBufferMethodHeader::TertOp::Grp0SetSubDevMask) {
+                            appendRun(methodHeader.methodAddress, 0, false, false, false, methodHeader.methodSubChannel, flushEngineState);
+                            return false;
                         }
-                    }
-                } else {
-                    startSplitMethod(State);
-                    return true;
+
+                        throw exception("Unsupported pushbuffer method TertOp: {}", static_cast<u8>(methodHeader.tertOp));
+
+                    default:
+                        throw exception("Unsupported pushbuffer method SecOp: {}", static_cast<u8>(methodHeader.secOp));
                 }
+            }()};
 
-                return false;
-            }};
+            if (hitEnd)
+                break;
+        }
 
-            /**
-             * @brief Handles execution of a single method
-             * @return If the this was the final method in the current GpEntry
-             */
-            auto processMethod{[&] () -> bool {
-                if (methodHeader.secOp == PushBufferMethodHeader::SecOp::IncMethod)  [[likely]] {
-                    return dispatchCalls.operator()<MethodResumeState::State::Inc>();
-                } else if (methodHeader.secOp == PushBufferMethodHeader::SecOp::OneInc) [[likely]] {
-                    return dispatchCalls.operator()<MethodResumeState::State::OneInc>();
-                } else if (methodHeader.secOp == PushBufferMethodHeader::SecOp::ImmdDataMethod) {
-                    if (methodHeader.Pure())
-                        SendPure(methodHeader.methodAddress, methodHeader.immdData, methodHeader.methodSubChannel);
-                    else
-                        SendFull(methodHeader.methodAddress, GpfifoArgument{methodHeader.immdData}, methodHeader.methodSubChannel, true);
+        decoded.endResumeState = resume;
+    }
 
-                    return false;
-                } else if (methodHeader.secOp == PushBufferMethodHeader::SecOp::NonIncMethod) [[unlikely]] {
-                    return dispatchCalls.operator()<MethodResumeState::State::NonInc>();
-                } else if (methodHeader.secOp == PushBufferMethodHeader::SecOp::EndPbSegment) [[unlikely]] {
-                    return true;
-                } else if (methodHeader.secOp == PushBufferMethodHeader::SecOp::Grp0UseTert) {
-                    if (methodHeader.tertOp == PushBufferMethodHeader::TertOp::Grp0SetSubDevMask)
-                        return false;
+    void ChannelGpfifo::Execute(DecodedGpEntry &decoded) {
+        bool pushbufferDirty{false};
+        bool pushbufferFlushed{false};
 
-                    throw exception("Unsupported pushbuffer method TertOp: {}", static_cast<u8>(methodHeader.tertOp));
+        for (auto range : decoded.mappedRanges) {
+            if (channelCtx.executor.usageTracker.dirtyIntervals.Intersect(range)) {
+                if (skipDirtyFlushes) {
+                    pushbufferDirty = true;
                 } else {
-                    throw exception("Unsupported pushbuffer method SecOp: {}", static_cast<u8>(methodHeader.secOp));
+                    channelCtx.executor.Submit({}, true);
+                    pushbufferFlushed = true;
                 }
-            }};
+            }
+        }
 
-            bool hitEnd{[&]() {
-                if (methodHeader.methodSubChannel != SubchannelId::ThreeD) [[unlikely]]
-                    channelCtx.maxwell3D.FlushEngineState(); // Flush the 3D engine state when doing any calls to other engines
-                return processMethod();
-            }()};
+        // The entry needs to be redecoded if the GPU may have written to the pushbuffer since it was decoded or if it was decoded with the resume state of a stale decode
+        if (pushbufferFlushed || decoded.startResumeState != resumeState) [[unlikely]] {
+            auto resume{resumeState};
+            Decode(decoded.gpEntry, decoded, resume);
+        } else if (decoded.decodeException) [[unlikely]] {
+            std::rethrow_exception(decoded.decodeException);
+        }
 
-            if (hitEnd)
-                break;
+        resumeState = decoded.endResumeState;
+
+        if (state.soc->gpfifoCapture.IsActive()) [[unlikely]]
+            state.soc->gpfifoCapture.RecordGpEntry(channelCtx, decoded.gpEntry, decoded.mappedRanges);
+
+        auto getArgument{[&](u32 &argument) {
+            return GpfifoArgument{decoded.pushBufferCopied ? argument : 0, decoded.pushBufferCopied ? nullptr : &argument, pushbufferDirty};
+        }};
+
+        constexpr u32 BatchCutoff{4}; //!< Cutoff needed to send method calls in a batch which is espcially important for UBO updates. This helps to avoid the extra overhead batching for small packets.
+        // TODO: Only batch for specific target methods like UBO updates, since normal dispatch is generally cheaper
+
+        for (auto &run : decoded.runs) {
+            if (run.flushEngineState) [[unlikely]]
+                channelCtx.maxwell3D.FlushEngineState();
+
+            if (run.isImmediate) {
+                if (run.pure)
+                    SendPure(run.address, run.immediate, run.subChannel);
+                else
+                    SendFull(run.address, GpfifoArgument{run.immediate}, run.subChannel, true);
+            } else if (run.pure) [[likely]] {
+                // For pure methods we can send all method calls as a span in one go
+                if (run.arguments.size() > BatchCutoff) [[unlikely]] {
+                    if (run.increment)
+                        SendPureBatchInc(run.address, run.arguments, run.subChannel);
+                    else
+                        SendPureBatchNonInc(run.address, run.arguments, run.subChannel);
+                    continue;
+                }
+
+                #pragma unroll(2)
+                for (u32 i{}; i < run.arguments.size(); i++)
+                    SendPure(run.increment ? run.address + i : run.address, run.arguments[i], run.subChannel);
+            } else {
+                // Slow path for methods that touch GPFIFO or macros
+                for (u32 i{}; i < run.arguments.size(); i++)
+                    SendFull(run.increment ? run.address + i : run.address, getArgument(run.arguments[i]), run.subChannel, run.lastCall && i == run.arguments.size() - 1);
+            }
         }
     }
 
-    void ChannelGpfifo::Run() {
-        if (int result{pthread_setname_np(pthread_self(), "GPFIFO")})
+    void ChannelGpfifo::RunThread(const char *name, const std::function<void()> &function) {
+        if (int result{pthread_setname_np(pthread_self(), name)})
             Logger::Warn("Failed to set the thread name: {}", strerror(result));
 
+        HostAffinity::PlaceCurrentThread(HostThreadRole::GpuChannel);
+        PerformanceHint::ScopedThread hintThread;
+
         try {
             signal::SetSignalHandler({SIGINT, SIGILL, SIGTRAP, SIGBUS, SIGFPE}, signal::ExceptionalSignalHandler);
             signal::SetSignalHandler({SIGSEGV}, nce::NCE::HostSignalHandler); // We may access NCE trapped memory
 
-            bool channelLocked{};
-
-            gpEntries.Process([this, &channelLocked](GpEntry gpEntry) {
-                Logger::Debug("Processing pushbuffer: 0x{:X}, Size: 0x{:X}", gpEntry.Address(), +gpEntry.size);
-
-                if (!channelLocked) {
-                    channelCtx.Lock();
-                    channelLocked = true;
-                }
-
-                Process(gpEntry);
-            }, [this, &channelLocked]() {
-                // If we run out of GpEntries to process ensure we submit any remaining GPU work before waiting for more to arrive
-                Logger::Debug("Finished processing pushbuffer batch");
-                if (channelLocked) {
-                    channelCtx.executor.Submit();
-                    channelCtx.Unlock();
-                    channelLocked = false;
-                }
-            });
+            function();
         } catch (const signal::SignalException &e) {
             if (e.signal != SIGINT) {
                 Logger::Error("{}\nStack Trace:{}", e.what(), state.loader->GetStackTrace(e.frames));
@@ -415,6 +452,63 @@ namespace skyline::soc::gm20b {
         }
     }
 
+    void ChannelGpfifo::DecodeRun() {
+        RunThread("GPFIFO-Decode", [this]() {
+            gpEntries.Process([this](GpEntry gpEntry) {
+                auto &decoded{decodedEntries.BeginPush()};
+                decoded.endOfBatch = false;
+
+                // Decoding errors are deferred to execution as the pushbuffer may not have been written by the GPU yet
+                try {
+                    Decode(gpEntry, decoded, decodeResumeState);
+                } catch (const exception &) {
+                    decoded.decodeException = std::current_exception();
+                }
+
+                decodedEntries.EndPush();
+            }, [this]() {
+                // Signal the end of this batch of GpEntries so that any remaining GPU work is submitted once they have been executed
+                decodedEntries.BeginPush().endOfBatch = true;
+                decodedEntries.EndPush();
+            });
+        });
+    }
+
+    void ChannelGpfifo::Run() {
+        RunThread("GPFIFO", [this]() {
+            bool channelLocked{};
+
+            while (true) {
+                auto &decoded{decodedEntries.Front()};
+                auto startTime{util::GetTimeNs()};
+                if (decoded.endOfBatch) {
+                    // If we run out of GpEntries to process ensure we submit any remaining GPU work before waiting for more to arrive
+                    Logger::Debug("Finished processing pushbuffer batch");
+                    if (state.soc->gpfifoCapture.IsActive()) [[unlikely]]
+                        state.soc->gpfifoCapture.RecordEndOfBatch(channelCtx);
+
+                    if (channelLocked) {
+                        channelCtx.executor.Submit();
+                        channelCtx.Unlock();
+                        channelLocked = false;
+                    }
+                } else {
+                    Logger::Debug("Processing pushbuffer: 0x{:X}, Size: 0x{:X}", decoded.gpEntry.Address(), +decoded.gpEntry.size);
+
+                    if (!channelLocked) {
+                        channelCtx.Lock();
+                        channelLocked = true;
+                    }
+
+                    Execute(decoded);
+                }
+                trace::AddFrameCounter(trace::FrameCounter::GpfifoBusyTime, static_cast<u64>(util::GetTimeNs() - startTime));
+
+                decodedEntries.Pop();
+            }
+        });
+    }
+
     void ChannelGpfifo::Push(span<GpEntry> entries) {
         gpEntries.Append(entries);
     }
@@ -423,10 +517,31 @@ namespace skyline::soc::gm20b {
         gpEntries.Push(entry);
     }
 
+    void ChannelGpfifo::Process(span<GpEntry> entries, bool wait) {
+        DecodedGpEntry decoded;
+
+        channelCtx.Lock();
+        try {
+            for (auto gpEntry : entries) {
+                auto resume{resumeState};
+                Decode(gpEntry, decoded, resume);
+                Execute(decoded);
+            }
+
+            channelCtx.executor.Submit({}, wait);
+        } catch (...) {
+            channelCtx.Unlock();
+            throw;
+        }
+        channelCtx.Unlock();
+    }
+
     ChannelGpfifo::~ChannelGpfifo() {
-        if (thread.joinable()) {
-            pthread_kill(thread.native_handle(), SIGINT);
-            thread.join();
+        for (auto *gpfifoThread : {&decodeThread, &thread}) {
+            if (gpfifoThread->joinable()) {
+                pthread_kill(gpfifoThread->native_handle(), SIGINT);
+                gpfifoThread->join();
+            }
         }
     }
 }
@@ -3,7 +3,9 @@
 
 #pragma once
 
-#include <common/circular_queue.h>
+#include <common/mpsc_queue.h>
+#include <common/spsc_ring.h>
+#include <common/address_space.h>
 #include <soc/gm20b/macro/macro_state.h>
 #include "engines/gpfifo.h"
 
@@ -97,7 +99,7 @@ namespace skyline::soc::gm20b {
 
     /**
      * @brief The ChannelGpfifo class handles creating pushbuffers from GP entries and then processing them for a single channel
-     * @note A single ChannelGpfifo thread exists per channel, allowing them to run asynchronously
+     * @note Two ChannelGpfifo threads exist per channel, allowing them to run asynchronously: one decodes pushbuffers into runs of method calls ahead of time while the other executes them
      * @note This class doesn't perfectly map to any particular hardware component on the X1, it does a mix of the GPU Host PBDMA and handling the GPFIFO entries
      * @url https://github.com/NVIDIA/open-gpu-doc/blob/ab27fc22db5de0d02a4cabe08e555663b62db4d4/manuals/volta/gv100/dev_pbdma.ref.txt#L62
      */
@@ -106,12 +108,11 @@ namespace skyline::soc::gm20b {
         const DeviceState &state;
         ChannelContext &channelCtx;
         engine::GPFIFO gpfifoEngine; //!< The engine for processing GPFIFO method calls
-        CircularQueue<GpEntry> gpEntries;
-        std::vector<u32> pushBufferData; //!< Persistent vector storing pushbuffer data to avoid constant reallocations
+        MpscQueue<GpEntry> gpEntries; //!< GpEntries pushed by guest submission threads, these never block on the GPFIFO threads unless the queue is full
         bool skipDirtyFlushes{}; //!< If GPU flushing should be skipped when fetching pushbuffer contents
 
         /**
-         * @brief Holds the required state in order to resume a method started from one call to `Process` in another
+         * @brief Holds the required state in order to resume a method started from one call to `Decode` in another
          * @note This is needed as games (especially OpenGL ones) can split method entries over multiple GpEntries
          */
         struct MethodResumeState {
@@ -127,9 +128,52 @@ namespace skyline::soc::gm20b {
                 Inc,
                 OneInc //!< Will be switched to NonInc after the first call
             } state; //!< The type of method to resume
-        } resumeState{};
 
-        std::thread thread; //!< The thread that manages processing of pushbuffers
+            /**
+             * @note The contents of resume states with no remaining entries are irrelevant, they're considered equal regardless
+             */
+            bool operator==(const MethodResumeState &other) const {
+                return remaining == other.remaining && (!remaining || (address == other.address && subChannel == other.subChannel && state == other.state));
+            }
+        };
+
+        /**
+         * @brief A run of method calls decoded from a pushbuffer that can be executed without any further parsing
+         */
+        struct MethodRun {
+            span<u32> arguments; //!< The arguments of each call in the run, these point directly into guest memory unless the pushbuffer was copied
+            u32 address; //!< The method address of the first call in the run
+            u32 immediate; //!< The argument of an immediate data method, `arguments` is empty for these
+            SubchannelId subChannel;
+            bool increment; //!< If the method address should be incremented after each call
+            bool isImmediate; //!< If this is an immediate data method
+            bool pure; //!< If the calls don't touch macro or GPFIFO methods, allowing them to be dispatched directly
+            bool lastCall; //!< If the final call in the run is the final call of its method
+            bool flushEngineState; //!< If the 3D engine state needs to be flushed prior to the run as it targets another engine
+        };
+
+        /**
+         * @brief A GpEntry which has been decoded into runs of method calls by the decode thread
+         */
+        struct DecodedGpEntry {
+            GpEntry gpEntry{0, 0};
+            bool endOfBatch{}; //!< If this isn't a GpEntry but signals that there are no further entries to process for now
+            TranslatedAddressRange mappedRanges; //!< The host ranges the pushbuffer is mapped to
+            std::vector<u32> pushBufferData; //!< Storage for the pushbuffer if it's split across multiple mappings, persistent to avoid constant reallocations
+            bool pushBufferCopied{}; //!< If the pushbuffer is a copy of guest memory in `pushBufferData` rather than being read directly
+            std::vector<MethodRun> runs;
+            MethodResumeState startResumeState{}; //!< The resume state the entry was decoded with
+            MethodResumeState endResumeState{}; //!< The resume state after decoding the entry
+            std::exception_ptr decodeException; //!< An exception thrown during decoding, this is only rethrown if the entry is executed as decoded as the pushbuffer contents may have been stale
+        };
+
+        static constexpr size_t DecodeRingSize{32}; //!< The maximum amount of GpEntries that can be decoded ahead of execution
+        SpscRing<DecodedGpEntry, DecodeRingSize> decodedEntries;
+        MethodResumeState decodeResumeState{}; //!< The resume state of the decode thread
+        MethodResumeState resumeState{}; //!< The resume state at the point of execution, this is authoritative over the state any entry was decoded with
+
+        std::thread decodeThread; //!< The thread that manages decoding of pushbuffers
+        std::thread thread; //!< The thread that manages execution of decoded pushbuffers
 
         /**
          * @brief Sends a method call to the appropriate subchannel and handles macro and GPFIFO methods
@@ -147,12 +191,33 @@ namespace skyline::soc::gm20b {
         void SendPureBatchNonInc(u32 method, span<u32> arguments, SubchannelId subChannel);
 
         /**
-         * @brief Processes the pushbuffer contained within the given GpEntry, calling methods as needed
+         * @brief Sends a batch of method calls to consecutive methods to the appropriate subchannel, macro and GPFIFO methods are not handled
          */
-        void Process(GpEntry gpEntry);
+        void SendPureBatchInc(u32 method, span<u32> arguments, SubchannelId subChannel);
 
         /**
-         * @brief Executes all pending entries in the FIFO and polls for more
+         * @brief Fetches and decodes the pushbuffer contained within the given GpEntry into runs of method calls
+         * @param resume The resume state to start decoding with, this is updated to the state after the entry
+         */
+        void Decode(GpEntry gpEntry, DecodedGpEntry &decoded, MethodResumeState &resume);
+
+        /**
+         * @brief Executes all method calls of a decoded GpEntry, redecoding it if it has been invalidated since it was decoded
+         */
+        void Execute(DecodedGpEntry &decoded);
+
+        /**
+         * @brief Runs the supplied function as the body of a GPFIFO thread, any exceptions are considered fatal and will kill the process
+         */
+        void RunThread(const char *name, const std::function<void()> &function);
+
+        /**
+         * @brief Decodes all pending entries in the FIFO and polls for more
+         */
+        void DecodeRun();
+
+        /**
+         * @brief Executes all decoded entries and polls for more
          */
         void Run();
 
@@ -165,13 +230,20 @@ namespace skyline::soc::gm20b {
         ~ChannelGpfifo();
 
         /**
-         * @brief Pushes a list of entries to the FIFO, these commands will be executed on calls to 'Process'
+         * @brief Pushes a list of entries to the FIFO, these commands will be decoded and executed asynchronously by the GPFIFO threads
          */
         void Push(span<GpEntry> entries);
 
         /**
-         * @brief Pushes a single entry to the FIFO, these commands will be executed on calls to 'Process'
+         * @brief Pushes a single entry to the FIFO, these commands will be decoded and executed asynchronously by the GPFIFO threads
          */
         void Push(GpEntry entries);
+
+        /**
+         * @brief Decodes and executes the supplied entries synchronously on the calling thread then submits the resulting GPU work, this bypasses the GPFIFO threads entirely
+         * @param wait If the GPU work should be waited on before returning
+         * @note This is used for replaying captures and MUST NOT be mixed with entries pushed to the FIFO
+         */
+        void Process(span<GpEntry> entries, bool wait);
     };
 }
@@ -0,0 +1,265 @@
+// SPDX-License-Identifier: MPL-2.0
+// Copyright © 2023 Skyline Team and Contributors (https://github.com/skyline-emu/)
+
+#include <sys/mman.h>
+#include <common/trace.h>
+#include "channel.h"
+#include "gpfifo_capture.h"
+
+namespace skyline::soc::gm20b {
+    struct GpfifoCaptureHeader {
+        static constexpr u32 Magic{util::MakeMagic<u32>("GPFC")}; //!< The magic value used to identify a GPFIFO capture file
+        static constexpr u32 Version{1}; //!< The version of the GPFIFO capture file format, MUST be incremented for any format changes
+
+        u32 magic{Magic};
+        u32 version{Version};
+
+        /**
+         * @brief Checks if the header is valid
+         */
+        bool IsValid() {
+            return magic == Magic && version == Version;
+        }
+    };
+
+    void GpfifoCapture::WriteRecord(const GpfifoCaptureRecord &record, span<u8> payload) {
+        stream.write(reinterpret_cast<const char *>(&record), sizeof(GpfifoCaptureRecord));
+        if (!payload.empty())
+            stream.write(reinterpret_cast<const char *>(payload.data()), static_cast<std::streamsize>(payload.size()));
+    }
+
+    u32 GpfifoCapture::GetChannelIndexLocked(ChannelContext &channelCtx) {
+        if (auto it{channels.find(&channelCtx)}; it != channels.end())
+            return it->second;
+
+        auto [asIt, asInserted]{addressSpaces.try_emplace(channelCtx.asCtx.get(), static_cast<u32>(addressSpaces.size()))};
+        u32 asIndex{asIt->second};
+        if (asInserted) {
+            // Snapshot the entire address space as we can't know which regions will be accessed by the GPU ahead of time
+            channelCtx.asCtx->gmmu.ForEachMapping([&](u64 virt, span<u8> backing, bool sparse) {
+                WriteRecord(GpfifoCaptureRecord{
+                    .type = GpfifoCaptureRecord::Type::Mapping,
+                    .asIndex = asIndex,
+                    .sparse = sparse,
+                    .value = virt,
+                    .size = backing.size(),
+                }, sparse ? span<u8>{} : backing);
+            });
+        }
+
+        u32 channelIndex{static_cast<u32>(channels.size())};
+        channels.emplace(&channelCtx, channelIndex);
+        WriteRecord(GpfifoCaptureRecord{
+            .type = GpfifoCaptureRecord::Type::Channel,
+            .asIndex = asIndex,
+            .channelIndex = channelIndex,
+        });
+
+        return channelIndex;
+    }
+
+    bool GpfifoCapture::Start(const std::string &path) {
+        std::scoped_lock lock{mutex};
+        if (active)
+            return false;
+
+        stream = std::ofstream{path, std::ios::binary | std::ios::trunc};
+        if (stream.fail()) {
+            Logger::Warn("Failed to open GPFIFO capture file '{}'", path);
+            return false;
+        }
+
+        GpfifoCaptureHeader header{};
+        stream.write(reinterpret_cast<const char *>(&header), sizeof(GpfifoCaptureHeader));
+
+        addressSpaces.clear();
+        channels.clear();
+        active = true;
+
+        Logger::Info("Started GPFIFO capture to '{}'", path);
+        return true;
+    }
+
+    bool GpfifoCapture::Stop() {
+        std::scoped_lock lock{mutex};
+        if (!active)
+            return false;
+
+        active = false;
+        stream.close();
+
+        Logger::Info("Stopped GPFIFO capture with {} channel(s) across {} address space(s)", channels.size(), addressSpaces.size());
+        return true;
+    }
+
+    void GpfifoCapture::RecordGpEntry(ChannelContext &channelCtx, GpEntry gpEntry, const TranslatedAddressRange &mappedRanges) {
+        std::scoped_lock lock{mutex};
+        if (!active)
+            return;
+
+        auto channelIndex{GetChannelIndexLocked(channelCtx)};
+        WriteRecord(GpfifoCaptureRecord{
+            .type = GpfifoCaptureRecord::Type::GpEntry,
+            .channelIndex = channelIndex,
+            .value = util::BitCast<u64>(gpEntry),
+            .size = gpEntry.size * sizeof(u32),
+        });
+
+        // The pushbuffer is written out as it would be read by Decode with sparse ranges reading as zero
+        for (auto range : mappedRanges) {
+            if (range.valid()) {
+                stream.write(reinterpret_cast<const char *>(range.data()), static_cast<std::streamsize>(range.size()));
+            } else {
+                for (size_t remaining{range.size()}; remaining; remaining--)
+                    stream.put(0);
+            }
+        }
+    }
+
+    void GpfifoCapture::RecordEndOfBatch(ChannelContext &channelCtx) {
+        std::scoped_lock lock{mutex};
+        if (!active)
+            return;
+
+        WriteRecord(GpfifoCaptureRecord{
+            .type = GpfifoCaptureRecord::Type::EndOfBatch,
+            .channelIndex = GetChannelIndexLocked(channelCtx),
+        });
+    }
+
+    span<u8> GpfifoReplayer::AllocateHostMemory(AddressSpace &addressSpace, size_t size) {
+        size = util::AlignUp(size, PAGE_SIZE);
+        auto pointer{mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0)};
+        if (pointer == MAP_FAILED)
+            throw exception("Failed to allocate 0x{:X} bytes for GPFIFO replay: {}", size, strerror(errno));
+
+        return addressSpace.allocations.emplace_back(reinterpret_cast<u8 *>(pointer), size);
+    }
+
+    GpfifoReplayer::GpfifoReplayer(const DeviceState &state, const std::string &path) : state{state} {
+        std::ifstream stream{path, std::ios::binary};
+        GpfifoCaptureHeader header{};
+        stream.read(reinterpret_cast<char *>(&header), sizeof(GpfifoCaptureHeader));
+        if (stream.fail() || !header.IsValid())
+            throw exception("Invalid GPFIFO capture file '{}'", path);
+
+        std::vector<u32> channelAddressSpaces; //!< The index of the address space each channel is bound to
+        std::vector<Batch> pendingBatches; //!< The batch that is currently being recorded for each channel
+
+        // Address spaces are introduced by their first mapping or by a channel that is bound to them if they have no mappings
+        auto getAddressSpace{[&](u32 asIndex) -> AddressSpace & {
+            if (asIndex == addressSpaces.size())
+                addressSpaces.emplace_back().asCtx = std::make_shared<AddressSpaceContext>();
+            else if (asIndex > addressSpaces.size())
+                throw exception("GPFIFO capture references unknown address space {}", asIndex);
+
+            return addressSpaces[asIndex];
+        }};
+
+        GpfifoCaptureRecord record{};
+        while (stream.read(reinterpret_cast<char *>(&record), sizeof(GpfifoCaptureRecord))) {
+            switch (record.type) {
+                case GpfifoCaptureRecord::Type::Mapping: {
+                    auto &addressSpace{getAddressSpace(record.asIndex)};
+                    if (record.sparse) {
+                        addressSpace.asCtx->gmmu.Map(record.value, GMMU::SparsePlaceholderAddress(), record.size, {true});
+                    } else {
+                        auto backing{AllocateHostMemory(addressSpace, record.size)};
+                        stream.read(reinterpret_cast<char *>(backing.data()), static_cast<std::streamsize>(record.size));
+                        addressSpace.asCtx->gmmu.Map(record.value, backing.data(), record.size);
+                    }
+
+                    addressSpace.end = std::max(addressSpace.end, record.value + record.size);
+                    break;
+                }
+
+                case GpfifoCaptureRecord::Type::Channel:
+                    if (record.channelIndex != channelAddressSpaces.size())
+                        throw exception("GPFIFO capture channel {} is out of order", record.channelIndex);
+
+                    getAddressSpace(record.asIndex);
+                    channelAddressSpaces.push_back(record.asIndex);
+                    pendingBatches.push_back(Batch{.channelIndex = record.channelIndex});
+                    break;
+
+                case GpfifoCaptureRecord::Type::GpEntry: {
+                    if (record.channelIndex >= channelAddressSpaces.size())
+                        throw exception("GPFIFO capture entry references unknown channel {}", record.channelIndex);
+
+                    auto &pushBufferData{addressSpaces[channelAddressSpaces[record.channelIndex]].pushBufferData};
+                    size_t offset{pushBufferData.size()};
+                    pushBufferData.resize(offset + (record.size / sizeof(u32)));
+                    stream.read(reinterpret_cast<char *>(pushBufferData.data() + offset), static_cast<std::streamsize>(record.size));
+
+                    pendingBatches[record.channelIndex].gpEntries.emplace_back(offset * sizeof(u32), static_cast<u32>(record.size / sizeof(u32)));
+                    break;
+                }
+
+                case GpfifoCaptureRecord::Type::EndOfBatch:
+                    if (record.channelIndex >= channelAddressSpaces.size())
+                        throw exception("GPFIFO capture batch references unknown channel {}", record.channelIndex);
+
+                    batches.push_back(std::exchange(pendingBatches[record.channelIndex], Batch{.channelIndex = record.channelIndex}));
+                    break;
+
+                default:
+                    throw exception("Unknown GPFIFO capture record type: {}", static_cast<u32>(record.type));
+            }
+        }
+
+        // Any batches that were still in flight when the capture was stopped are replayed after all complete batches
+        for (auto &batch : pendingBatches)
+            if (!batch.gpEntries.empty())
+                batches.push_back(std::move(batch));
+
+        // Map the pushbuffer region of every address space directly after its highest mapping
+        std::vector<u64> pushBufferAddresses(addressSpaces.size());
+        for (size_t index{}; index < addressSpaces.size(); index++) {
+            auto &addressSpace{addressSpaces[index]};
+            if (addressSpace.pushBufferData.empty())
+                continue;
+
+            auto pushBufferBytes{span(addressSpace.pushBufferData).cast<u8>()};
+            u64 address{util::AlignUp(addressSpace.end, GmmuMinBigPageSize)};
+            if (address + pushBufferBytes.size() > (1ULL << GmmuAddressSpaceBits))
+                throw exception("No space in address space {} for 0x{:X} bytes of GPFIFO replay pushbuffers", index, pushBufferBytes.size());
+
+            auto backing{AllocateHostMemory(addressSpace, pushBufferBytes.size())};
+            backing.copy_from(pushBufferBytes);
+            addressSpace.asCtx->gmmu.Map(address, backing.data(), backing.size());
+            pushBufferAddresses[index] = address;
+
+            addressSpace.pushBufferData = {};
+        }
+
+        for (auto &batch : batches)
+            for (auto &gpEntry : batch.gpEntries)
+                gpEntry = GpEntry{pushBufferAddresses[channelAddressSpaces[batch.channelIndex]] + gpEntry.Address(), gpEntry.size};
+
+        for (auto asIndex : channelAddressSpaces)
+            channels.push_back(std::make_unique<ChannelContext>(state, addressSpaces[asIndex].asCtx, 1));
+
+        Logger::Info("Loaded GPFIFO capture '{}' with {} batch(es) on {} channel(s)", path, batches.size(), channels.size());
+    }
+
+    GpfifoReplayer::~GpfifoReplayer() {
+        channels.clear();
+
+        // GPU resources created during the replay are tracked by the host memory they were created from, the memory is decommitted while keeping its reservation so it can never alias memory from a later allocation
+        for (auto &addressSpace : addressSpaces)
+            for (auto allocation : addressSpace.allocations)
+                mmap(allocation.data(), allocation.size(), PROT_READ | PROT_WRITE, MAP_FIXED | MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+    }
+
+    i64 GpfifoReplayer::Replay() {
+        TRACE_EVENT("gpu", "GpfifoReplayer::Replay");
+
+        auto startTime{util::GetTimeNs()};
+        for (size_t index{}; index < batches.size(); index++) {
+            auto &batch{batches[index]};
+            channels[batch.channelIndex]->gpfifo.Process(batch.gpEntries, index == batches.size() - 1);
+        }
+
+        return util::GetTimeNs() - startTime;
+    }
+}
@@ -0,0 +1,121 @@
+// SPDX-License-Identifier: MPL-2.0
+// Copyright © 2023 Skyline Team and Contributors (https://github.com/skyline-emu/)
+
+#pragma once
+
+#include <fstream>
+#include <common.h>
+#include <common/address_space.h>
+#include "gmmu.h"
+#include "gpfifo.h"
+
+namespace skyline::soc::gm20b {
+    /**
+     * @brief A single record in a GPFIFO capture file, records are written in the order they occurred and may be followed by a payload of `size` bytes
+     */
+    struct GpfifoCaptureRecord {
+        enum class Type : u32 {
+            Mapping, //!< A GMMU mapping in address space `asIndex` at `value`, followed by its contents unless it is sparse
+            Channel, //!< A channel `channelIndex` which is bound to address space `asIndex`
+            GpEntry, //!< A GpEntry executed on `channelIndex` with the raw entry in `value`, followed by its pushbuffer contents
+            EndOfBatch, //!< The end of a batch of GpEntries on `channelIndex`, any outstanding GPU work is submitted at this point
+        } type;
+        u32 asIndex;
+        u32 channelIndex;
+        u32 sparse; //!< If a mapping is sparse, these have no payload and read as zero
+        u64 value;
+        u64 size; //!< The size of the mapping or the payload
+    };
+    static_assert(sizeof(GpfifoCaptureRecord) == 0x20);
+
+    /**
+     * @brief Records the GpEntries executed by all channels alongside their pushbuffer contents and a snapshot of the GMMU mappings they use, this allows the GPU work to be replayed repeatably without running any guest code
+     * @note Address spaces are snapshotted when first used by a channel during the capture, guest writes to memory other than pushbuffers and mappings created after that point aren't captured
+     */
+    class GpfifoCapture {
+      private:
+        std::mutex mutex;
+        std::atomic<bool> active{};
+        std::ofstream stream;
+        std::unordered_map<const AddressSpaceContext *, u32> addressSpaces; //!< A map from captured address spaces to their index in the capture
+        std::unordered_map<const ChannelContext *, u32> channels; //!< A map from captured channels to their index in the capture
+
+        void WriteRecord(const GpfifoCaptureRecord &record, span<u8> payload = {});
+
+        /**
+         * @return The index of the channel in the capture, the channel and its address space are written to the capture if they haven't been yet
+         */
+        u32 GetChannelIndexLocked(ChannelContext &channelCtx);
+
+      public:
+        /**
+         * @brief Starts capturing all GPFIFO activity into a file at the supplied path, it is truncated if it already exists
+         * @return If the capture was started, this fails if a capture is already active
+         */
+        bool Start(const std::string &path);
+
+        /**
+         * @brief Stops the active capture and closes its file
+         * @return If there was an active capture that was stopped
+         */
+        bool Stop();
+
+        bool IsActive() {
+            return active.load(std::memory_order_relaxed);
+        }
+
+        /**
+         * @brief Records a GpEntry that's about to be executed on the supplied channel
+         * @param mappedRanges The host ranges of the entry's pushbuffer
+         */
+        void RecordGpEntry(ChannelContext &channelCtx, GpEntry gpEntry, const TranslatedAddressRange &mappedRanges);
+
+        /**
+         * @brief Records the end of a batch of GpEntries on the supplied channel
+         */
+        void RecordEndOfBatch(ChannelContext &channelCtx);
+    };
+
+    /**
+     * @brief Replays a GPFIFO capture on a fresh set of channels bound to address spaces which are reconstructed from the capture
+     * @note Pushbuffers are relocated to a dedicated region in every address space so that entries which reused the same pushbuffer memory during the capture replay correctly
+     */
+    class GpfifoReplayer {
+      private:
+        const DeviceState &state;
+
+        struct AddressSpace {
+            std::shared_ptr<AddressSpaceContext> asCtx;
+            std::vector<span<u8>> allocations; //!< Host memory backing the mappings of the address space
+            u64 end{}; //!< The end of the highest mapping in the address space
+            std::vector<u32> pushBufferData; //!< The pushbuffer contents of all entries on this address space, these are relocated once all mappings are known
+        };
+        std::vector<AddressSpace> addressSpaces;
+
+        std::vector<std::unique_ptr<ChannelContext>> channels;
+
+        struct Batch {
+            u32 channelIndex;
+            std::vector<GpEntry> gpEntries; //!< The entries in the batch, these are relative to the address space's pushbuffer region until it has been mapped
+        };
+        std::vector<Batch> batches;
+
+        span<u8> AllocateHostMemory(AddressSpace &addressSpace, size_t size);
+
+      public:
+        /**
+         * @brief Loads a capture from the supplied path and reconstructs its address spaces and channels
+         * @note An exception is thrown if the capture is invalid
+         */
+        GpfifoReplayer(const DeviceState &state, const std::string &path);
+
+        ~GpfifoReplayer();
+
+        /**
+         * @brief Executes all batches in the capture in their original order and waits for the GPU to finish
+         * @return The host time taken in nanoseconds
+         * @note Replays after the first will run with warm caches and with guest memory that has been written by the previous replay
+         */
+        i64 Replay();
+    };
+}
@@ -12,7 +12,7 @@ namespace skyline::soc::gm20b::engine {
      * @brief The MacroInterpreter class handles interpreting macros. Macros are small programs that run on the GPU and are used for things like instanced rendering
      */
     class MacroInterpreter {
-      private:
+      public:
         #pragma pack(push, 1)
         union Opcode {
             u32 raw;
@@ -104,6 +104,7 @@ namespace skyline::soc::gm20b::engine {
         static_assert(sizeof(MethodAddress) == sizeof(u32));
         #pragma pack(pop)
 
+      private:
         span<u32> macroCode; //!< Span pointing to the global macro code memory
 
         MacroEngineBase *engine; //!< Pointer to the target engine
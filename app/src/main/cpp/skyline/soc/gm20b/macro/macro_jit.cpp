@@ -0,0 +1,483 @@
+// SPDX-License-Identifier: MPL-2.0
+// Copyright © 2022 Skyline Team and Contributors (https://github.com/skyline-emu/)
+
+#include <sys/mman.h>
+#include <nce/instructions.h>
+#include "soc/gm20b/engines/engine.h"
+#include "macro_interpreter.h"
+#include "macro_jit.h"
+
+namespace skyline::soc::gm20b::engine {
+    namespace {
+        namespace instructions = nce::instructions;
+        using namespace nce::registers;
+        using Opcode = MacroInterpreter::Opcode;
+
+        /*
+         * Register allocation for translated code:
+         * - W19-W25: Macro registers 1-7, macro register 0 is always zero and maps to WZR
+         * - W26: The method address register
+         * - W27: The carry flag
+         * - X28: The pointer to the next argument
+         * - W9-W12: Scratch registers which are never live across calls
+         * The context pointer is spilled to the stack frame and reloaded before each call
+         */
+        constexpr W ZeroRegister{static_cast<W>(31)};
+        constexpr X StackPointer{static_cast<X>(31)};
+        constexpr W ResultRegister{W9}, ScratchRegisterA{W10}, ScratchRegisterB{W11}, ScratchRegisterC{W12};
+        constexpr W MethodAddressRegister{W26}, CarryRegister{W27};
+        constexpr X ArgumentRegister{X28}, CallTargetRegister{X16};
+        constexpr i16 FrameSize{0x70}, ContextOffset{0x60}; //!< The size of the stack frame and the offset of the spilled context pointer within it
+        constexpr u8 AbortBit{32}; //!< The bit set in the return value of host calls when an exception was thrown
+        constexpr size_t EpilogueLabel{std::numeric_limits<size_t>::max()};
+
+        constexpr W MacroRegister(u8 index) {
+            return index == 0 ? ZeroRegister : static_cast<W>(W18 + index);
+        }
+
+        /**
+         * @brief A simple code buffer with support for forward and backward branches to macro instructions
+         */
+        class Emitter {
+          private:
+            struct Fixup {
+                size_t offset; //!< The offset of the branch instruction in the code buffer
+                size_t target; //!< The index of the target macro instruction or EpilogueLabel
+                bool conditional; //!< If the branch is a CBZ/CBNZ rather than a B
+            };
+
+            std::vector<Fixup> fixups;
+
+          public:
+            std::vector<u32> code;
+            std::vector<size_t> labels; //!< The offset of the host code for each macro instruction
+            size_t epilogue{};
+
+            template<typename Instruction>
+            void Emit(Instruction instruction) {
+                code.push_back(instruction.raw);
+            }
+
+            void MoveImmediate(W reg, u32 value) {
+                Emit(instructions::Movz(reg, static_cast<u16>(value)));
+                if (value >> 16)
+                    Emit(instructions::Movk(reg, static_cast<u16>(value >> 16), 1));
+            }
+
+            void Move(W destReg, W srcReg) {
+                if (destReg != srcReg)
+                    Emit(instructions::Mov(destReg, srcReg));
+            }
+
+            void Branch(size_t target) {
+                fixups.push_back({code.size(), target, false});
+                Emit(instructions::B(0));
+            }
+
+            void BranchConditional(W reg, bool nonZero, size_t target) {
+                fixups.push_back({code.size(), target, true});
+                Emit(instructions::Cbz(reg, 0, nonZero));
+            }
+
+            /**
+             * @brief Calls a host function with the context as the first argument, returning from the translated macro if the host function signals an exception
+             */
+            void Call(void *function) {
+                for (u32 instruction : instructions::MoveRegister(CallTargetRegister, reinterpret_cast<u64>(function)))
+                    if (instruction)
+                        code.push_back(instruction);
+
+                Emit(instructions::StrLdrOffset(X0, StackPointer, ContextOffset, true));
+                Emit(instructions::Blr(CallTargetRegister));
+                Emit(instructions::Tbz(X0, AbortBit, 2));
+                Branch(EpilogueLabel);
+            }
+
+            /**
+             * @brief Resolves all branches to their targets
+             * @return If all branch targets were within range
+             */
+            bool ResolveFixups() {
+                for (const auto &fixup : fixups) {
+                    auto target{static_cast<i64>(fixup.target == EpilogueLabel ? epilogue : labels[fixup.target])};
+                    auto offset{target - static_cast<i64>(fixup.offset)};
+
+                    if (fixup.conditional) {
+                        if (offset < -(1 << 18) || offset >= (1 << 18))
+                            return false;
+
+                        code[fixup.offset] |= (static_cast<u32>(offset) & 0x7FFFF) << 5;
+                    } else {
+                        if (offset < -(1 << 25) || offset >= (1 << 25))
+                            return false;
+
+                        code[fixup.offset] = instructions::B(static_cast<i32>(offset)).raw;
+                    }
+                }
+
+                return true;
+            }
+        };
+
+        bool EmitAlu(Emitter &emitter, Opcode::AluOperation operation, W srcRegA, W srcRegB) {
+            using LogicalOperation = instructions::LogicalRegister::Operation;
+
+            switch (operation) {
+                case Opcode::AluOperation::Add:
+                    emitter.Emit(instructions::AddSubRegister(ResultRegister, srcRegA, srcRegB, false, true));
+                    emitter.Emit(instructions::Cset(CarryRegister, instructions::Condition::Cs));
+                    return true;
+                case Opcode::AluOperation::AddWithCarry:
+                    emitter.Emit(instructions::CmpImmediate(CarryRegister, 1)); // Transfers our carry flag into the host carry flag
+                    emitter.Emit(instructions::AddSubWithCarry(ResultRegister, srcRegA, srcRegB, false, true));
+                    emitter.Emit(instructions::Cset(CarryRegister, instructions::Condition::Cs));
+                    return true;
+                case Opcode::AluOperation::Subtract:
+                    // The interpreter sets the carry flag for subtraction when the 32-bit result is non-zero
+                    emitter.Emit(instructions::AddSubRegister(ResultRegister, srcRegA, srcRegB, true, true));
+                    emitter.Emit(instructions::Cset(CarryRegister, instructions::Condition::Ne));
+                    return true;
+                case Opcode::AluOperation::SubtractWithBorrow:
+                    emitter.Emit(instructions::CmpImmediate(CarryRegister, 1));
+                    emitter.Emit(instructions::AddSubWithCarry(ResultRegister, srcRegA, srcRegB, true, true));
+                    emitter.Emit(instructions::Cset(CarryRegister, instructions::Condition::Ne));
+                    return true;
+                case Opcode::AluOperation::BitwiseXor:
+                    emitter.Emit(instructions::LogicalRegister(LogicalOperation::Eor, ResultRegister, srcRegA, srcRegB));
+                    return true;
+                case Opcode::AluOperation::BitwiseOr:
+                    emitter.Emit(instructions::LogicalRegister(LogicalOperation::Orr, ResultRegister, srcRegA, srcRegB));
+                    return true;
+                case Opcode::AluOperation::BitwiseAnd:
+                    emitter.Emit(instructions::LogicalRegister(LogicalOperation::And, ResultRegister, srcRegA, srcRegB));
+                    return true;
+                case Opcode::AluOperation::BitwiseAndNot:
+                    emitter.Emit(instructions::LogicalRegister(LogicalOperation::And, ResultRegister, srcRegA, srcRegB, true));
+                    return true;
+                case Opcode::AluOperation::BitwiseNand:
+                    emitter.Emit(instructions::LogicalRegister(LogicalOperation::And, ResultRegister, srcRegA, srcRegB));
+                    emitter.Emit(instructions::LogicalRegister(LogicalOperation::Orr, ResultRegister, ZeroRegister, ResultRegister, true));
+                    return true;
+                default:
+                    return false; // The interpreter's behaviour is undefined for any other operation
+            }
+        }
+
+        void EmitSend(Emitter &emitter, W argumentReg) {
+            emitter.Move(W2, argumentReg);
+            emitter.Move(W1, MethodAddressRegister);
+            emitter.Call(reinterpret_cast<void *>(&MacroJit::Send));
+            emitter.Move(MethodAddressRegister, W0);
+        }
+
+        void EmitFetch(Emitter &emitter, u8 reg) {
+            emitter.Emit(instructions::LdrPostIndex(reg ? MacroRegister(reg) : ScratchRegisterA, ArgumentRegister, sizeof(u32)));
+        }
+
+        void EmitWrite(Emitter &emitter, u8 reg, W srcReg) {
+            // Register 0 should always be zero so writes to it are dropped
+            if (reg)
+                emitter.Move(MacroRegister(reg), srcReg);
+        }
+
+        void EmitAssignment(Emitter &emitter, Opcode::AssignmentOperation operation, u8 reg) {
+            switch (operation) {
+                case Opcode::AssignmentOperation::IgnoreAndFetch:
+                    EmitFetch(emitter, reg);
+                    break;
+                case Opcode::AssignmentOperation::Move:
+                    EmitWrite(emitter, reg, ResultRegister);
+                    break;
+                case Opcode::AssignmentOperation::MoveAndSetMethod:
+                    EmitWrite(emitter, reg, ResultRegister);
+                    emitter.Move(MethodAddressRegister, ResultRegister);
+                    break;
+                case Opcode::AssignmentOperation::FetchAndSend:
+                    EmitFetch(emitter, reg);
+                    EmitSend(emitter, ResultRegister);
+                    break;
+                case Opcode::AssignmentOperation::MoveAndSend:
+                    EmitWrite(emitter, reg, ResultRegister);
+                    EmitSend(emitter, ResultRegister);
+                    break;
+                case Opcode::AssignmentOperation::FetchAndSetMethod:
+                    EmitFetch(emitter, reg);
+                    emitter.Move(MethodAddressRegister, ResultRegister);
+                    break;
+                case Opcode::AssignmentOperation::MoveAndSetMethodThenFetchAndSend:
+                    EmitWrite(emitter, reg, ResultRegister);
+                    emitter.Move(MethodAddressRegister, ResultRegister);
+                    EmitFetch(emitter, 0);
+                    EmitSend(emitter, ScratchRegisterA);
+                    break;
+                case Opcode::AssignmentOperation::MoveAndSetMethodThenSendHigh:
+                    EmitWrite(emitter, reg, ResultRegister);
+                    emitter.Move(MethodAddressRegister, ResultRegister);
+
+                    // Extract the increment field of the method address
+                    emitter.MoveImmediate(ScratchRegisterB, 12);
+                    emitter.Emit(instructions::ShiftVariable(ScratchRegisterA, ResultRegister, ScratchRegisterB, true));
+                    emitter.MoveImmediate(ScratchRegisterB, 0x3F);
+                    emitter.Emit(instructions::LogicalRegister(instructions::LogicalRegister::Operation::And, ScratchRegisterA, ScratchRegisterA, ScratchRegisterB));
+                    EmitSend(emitter, ScratchRegisterA);
+                    break;
+            }
+        }
+
+        /**
+         * @brief Emits the operation and assignment of a single non-branch macro instruction, the exit flag is ignored
+         * @return If the instruction could be translated
+         */
+        bool EmitOperation(Emitter &emitter, Opcode opcode) {
+            using LogicalOperation = instructions::LogicalRegister::Operation;
+
+            auto srcRegA{MacroRegister(opcode.srcA)}, srcRegB{MacroRegister(opcode.srcB)};
+            switch (opcode.operation) {
+                case Opcode::Operation::AluRegister:
+                    if (!EmitAlu(emitter, opcode.aluOperation, srcRegA, srcRegB))
+                        return false;
+                    break;
+
+                case Opcode::Operation::AddImmediate:
+                    emitter.MoveImmediate(ScratchRegisterA, static_cast<u32>(opcode.immediate));
+                    emitter.Emit(instructions::AddSubRegister(ResultRegister, srcRegA, ScratchRegisterA));
+                    break;
+
+                case Opcode::Operation::BitfieldReplace: {
+                    u32 mask{opcode.bitfield.GetMask()};
+
+                    // Extract the source region
+                    emitter.MoveImmediate(ScratchRegisterB, opcode.bitfield.srcBit);
+                    emitter.Emit(instructions::ShiftVariable(ResultRegister, srcRegB, ScratchRegisterB, true));
+                    emitter.MoveImmediate(ScratchRegisterA, mask);
+                    emitter.Emit(instructions::LogicalRegister(LogicalOperation::And, ResultRegister, ResultRegister, ScratchRegisterA));
+
+                    // Replace the bitfield region in the destination with the region from the source
+                    emitter.MoveImmediate(ScratchRegisterB, opcode.bitfield.destBit);
+                    emitter.Emit(instructions::ShiftVariable(ResultRegister, ResultRegister, ScratchRegisterB));
+                    emitter.MoveImmediate(ScratchRegisterA, mask << opcode.bitfield.destBit);
+                    emitter.Emit(instructions::LogicalRegister(LogicalOperation::And, ScratchRegisterC, srcRegA, ScratchRegisterA, true));
+                    emitter.Emit(instructions::LogicalRegister(LogicalOperation::Orr, ResultRegister, ScratchRegisterC, ResultRegister));
+                    break;
+                }
+
+                case Opcode::Operation::BitfieldExtractShiftLeftImmediate:
+                    emitter.Emit(instructions::ShiftVariable(ResultRegister, srcRegB, srcRegA, true));
+                    emitter.MoveImmediate(ScratchRegisterA, opcode.bitfield.GetMask());
+                    emitter.Emit(instructions::LogicalRegister(LogicalOperation::And, ResultRegister, ResultRegister, ScratchRegisterA));
+                    emitter.MoveImmediate(ScratchRegisterB, opcode.bitfield.destBit);
+                    emitter.Emit(instructions::ShiftVariable(ResultRegister, ResultRegister, ScratchRegisterB));
+                    break;
+
+                case Opcode::Operation::BitfieldExtractShiftLeftRegister:
+                    emitter.MoveImmediate(ScratchRegisterB, opcode.bitfield.srcBit);
+                    emitter.Emit(instructions::ShiftVariable(ResultRegister, srcRegB, ScratchRegisterB, true));
+                    emitter.MoveImmediate(ScratchRegisterA, opcode.bitfield.GetMask());
+                    emitter.Emit(instructions::LogicalRegister(LogicalOperation::And, ResultRegister, ResultRegister, ScratchRegisterA));
+                    emitter.Emit(instructions::ShiftVariable(ResultRegister, ResultRegister, srcRegA));
+                    break;
+
+                case Opcode::Operation::ReadImmediate:
+                    emitter.MoveImmediate(ScratchRegisterA, static_cast<u32>(opcode.immediate));
+                    emitter.Emit(instructions::AddSubRegister(W1, srcRegA, ScratchRegisterA));
+                    emitter.Call(reinterpret_cast<void *>(&MacroJit::Read));
+                    emitter.Move(ResultRegister, W0);
+                    break;
+
+                default:
+                    return false;
+            }
+
+            EmitAssignment(emitter, opcode.assignmentOperation, opcode.dest);
+            return true;
+        }
+    }
+
+    MacroJit::MacroJit(span<u32> macroCode) : macroCode{macroCode} {}
+
+    MacroJit::~MacroJit() {
+        if (codeArena.valid())
+            munmap(codeArena.data(), codeArena.size_bytes());
+    }
+
+    size_t MacroJit::GetMacroLength(size_t offset) {
+        if (offset >= macroCode.size())
+            return 0;
+
+        auto code{macroCode.subspan(offset)};
+        size_t limit{std::min(code.size(), MaxMacroLength)};
+
+        auto isBranch{[&](size_t index) {
+            return reinterpret_cast<Opcode &>(code[index]).operation == Opcode::Operation::Branch;
+        }};
+
+        // The macro ends at the first exit that can't be skipped over by an earlier branch, with the exit's delay slot included
+        size_t furthestTarget{};
+        for (size_t i{}; i < limit; i++) {
+            auto &opcode{reinterpret_cast<Opcode &>(code[i])};
+
+            if (opcode.operation == Opcode::Operation::Branch) {
+                auto target{static_cast<i64>(i) + opcode.immediate};
+                if (target < 0)
+                    return 0;
+                furthestTarget = std::max(furthestTarget, static_cast<size_t>(target));
+
+                // Branching inside a delay slot is an error in the interpreter, we leave these to it
+                if (!opcode.noDelay && (i + 1 >= limit || isBranch(i + 1)))
+                    return 0;
+            }
+
+            if (opcode.exit) {
+                if (i + 1 >= limit || isBranch(i + 1))
+                    return 0;
+
+                if (i >= furthestTarget)
+                    return i + 2;
+            }
+        }
+
+        return 0;
+    }
+
+    MacroJit::Function MacroJit::Translate(span<u32> macro) {
+        if (codeArenaExhausted)
+            return nullptr;
+
+        Emitter emitter;
+        emitter.labels.resize(macro.size());
+
+        auto opcodeAt{[&](size_t index) {
+            return reinterpret_cast<Opcode &>(macro[index]);
+        }};
+
+        // Prologue: Save all callee-saved registers we use and initialise the macro state
+        emitter.Emit(instructions::StpLdp(X29, X30, StackPointer, -FrameSize, instructions::StpLdp::Addressing::PreIndex));
+        emitter.Emit(instructions::MovSp(X29, StackPointer));
+        for (u8 i{}; i < 5; i++)
+            emitter.Emit(instructions::StpLdp(static_cast<X>(X19 + i * 2), static_cast<X>(X20 + i * 2), StackPointer, static_cast<i16>(0x10 + i * 0x10), instructions::StpLdp::Addressing::Offset));
+        emitter.Emit(instructions::StrLdrOffset(X0, StackPointer, ContextOffset));
+        emitter.Emit(instructions::Mov(ArgumentRegister, X1));
+
+        // The first argument is stored in register 1
+        emitter.Emit(instructions::LdrPostIndex(MacroRegister(1), ArgumentRegister, sizeof(u32)));
+        for (u8 reg{2}; reg < 8; reg++)
+            emitter.Move(MacroRegister(reg), ZeroRegister);
+        emitter.Move(MethodAddressRegister, ZeroRegister);
+        emitter.Move(CarryRegister, ZeroRegister);
+
+        // The final instruction is only ever executed as the delay slot of the exit before it
+        for (size_t i{}; i < macro.size() - 1; i++) {
+            emitter.labels[i] = emitter.code.size();
+            auto opcode{opcodeAt(i)};
+
+            if (opcode.operation == Opcode::Operation::Branch) {
+                auto conditionReg{MacroRegister(opcode.srcA)};
+                bool branchOnZero{opcode.branchCondition == Opcode::BranchCondition::Zero};
+                size_t target{i + static_cast<size_t>(static_cast<i64>(opcode.immediate))};
+
+                if (opcode.noDelay) {
+                    emitter.BranchConditional(conditionReg, !branchOnZero, target);
+                } else {
+                    // Skip over the delay slot and branch if the condition doesn't hold
+                    size_t skipOffset{emitter.code.size()};
+                    emitter.Emit(instructions::Cbz(conditionReg, 0, branchOnZero));
+                    if (!EmitOperation(emitter, opcodeAt(i + 1)))
+                        return nullptr;
+                    emitter.Branch(target);
+                    emitter.code[skipOffset] = instructions::Cbz(conditionReg, static_cast<i32>(emitter.code.size() - skipOffset), branchOnZero).raw;
+                }
+            } else if (!EmitOperation(emitter, opcode)) {
+                return nullptr;
+            }
+
+            if (opcode.exit) {
+                // Exit has a delay slot
+                if (!EmitOperation(emitter, opcodeAt(i + 1)))
+                    return nullptr;
+                emitter.Branch(EpilogueLabel);
+            }
+        }
+
+        // Epilogue: Restore all callee-saved registers and return
+        emitter.epilogue = emitter.code.size();
+        for (u8 i{}; i < 5; i++)
+            emitter.Emit(instructions::StpLdp(static_cast<X>(X19 + i * 2), static_cast<X>(X20 + i * 2), StackPointer, static_cast<i16>(0x10 + i * 0x10), instructions::StpLdp::Addressing::Offset, true));
+        emitter.Emit(instructions::StpLdp(X29, X30, StackPointer, FrameSize, instructions::StpLdp::Addressing::PostIndex, true));
+        emitter.Emit(instructions::Ret());
+
+        if (!emitter.ResolveFixups())
+            return nullptr;
+
+        if (!codeArena.valid()) {
+            void *arena{mmap(nullptr, CodeArenaSize, PROT_READ | PROT_WRITE | PROT_EXEC, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0)};
+            if (arena == MAP_FAILED) [[unlikely]] {
+                Logger::Warn("Failed to allocate macro JIT code arena, falling back to the interpreter: {}", strerror(errno));
+                codeArenaExhausted = true;
+                return nullptr;
+            }
+
+            codeArena = span<u8>{static_cast<u8 *>(arena), CodeArenaSize}.cast<u32>();
+        }
+
+        if (emitter.code.size() > codeArena.size() - codeArenaOffset) [[unlikely]] {
+            Logger::Warn("Macro JIT code arena exhausted, falling back to the interpreter for any new macros");
+            codeArenaExhausted = true;
+            return nullptr;
+        }
+
+        auto function{codeArena.subspan(codeArenaOffset, emitter.code.size())};
+        std::copy(emitter.code.begin(), emitter.code.end(), function.begin());
+        __builtin___clear_cache(reinterpret_cast<char *>(function.data()), reinterpret_cast<char *>(function.data() + function.size()));
+        codeArenaOffset += function.size();
+
+        return reinterpret_cast<Function>(function.data());
+    }
+
+    u64 MacroJit::Send(Context *context, u32 methodAddress, u32 argument) {
+        MacroInterpreter::MethodAddress address{.raw = methodAddress};
+        try {
+            context->engine->CallMethodFromMacro(address.address, argument);
+        } catch (...) {
+            context->exception = std::current_exception();
+            return 1ULL << AbortBit;
+        }
+
+        address.address += address.increment;
+        return address.raw;
+    }
+
+    u64 MacroJit::Read(Context *context, u32 method) {
+        try {
+            return context->engine->ReadMethodFromMacro(method);
+        } catch (...) {
+            context->exception = std::current_exception();
+            return 1ULL << AbortBit;
+        }
+    }
+
+    MacroJit::Function MacroJit::Compile(size_t offset) {
+        size_t length{GetMacroLength(offset)};
+        if (!length)
+            return nullptr;
+
+        auto macro{macroCode.subspan(offset, length)};
+        u64 hash{XXH64(macro.data(), macro.size_bytes(), 0)};
+
+        auto it{functions.find(hash)};
+        if (it != functions.end())
+            return it->second;
+
+        // Macros which fail translation are cached as nullptr so we don't repeatedly attempt to translate them
+        auto function{Translate(macro)};
+        functions.emplace(hash, function);
+        return function;
+    }
+
+    void MacroJit::Execute(Function function, span<u32> args, MacroEngineBase *targetEngine) {
+        Context context{targetEngine};
+        function(&context, args.data());
+
+        if (context.exception) [[unlikely]]
+            std::rethrow_exception(context.exception);
+    }
+}
@@ -0,0 +1,78 @@
+// SPDX-License-Identifier: MPL-2.0
+// Copyright © 2022 Skyline Team and Contributors (https://github.com/skyline-emu/)
+
+#pragma once
+
+#include <unordered_map>
+#include <common.h>
+
+namespace skyline::soc::gm20b::engine {
+    struct MacroEngineBase;
+
+    /**
+     * @brief The MacroJit class translates macros into host AArch64 code once so that they can be executed without the decoding overhead of the interpreter
+     * @note Any macro which can't be statically proven to match the interpreter's behaviour isn't compiled, such macros are left to be executed by the interpreter
+     */
+    class MacroJit {
+      public:
+        /**
+         * @brief The state that is passed to translated code and used by the host functions it calls into
+         */
+        struct Context {
+            MacroEngineBase *engine;
+            std::exception_ptr exception; //!< An exception thrown by the engine during execution, it's rethrown once translated code has returned
+        };
+
+        using Function = void (*)(Context *context, const u32 *arguments);
+
+      private:
+        static constexpr size_t CodeArenaSize{4 * 1024 * 1024}; //!< The size of the executable memory region that translated code is placed into
+        static constexpr size_t MaxMacroLength{0x800}; //!< The maximum length of a macro we'll attempt to translate in instructions
+
+        span<u32> macroCode; //!< Span pointing to the global macro code memory
+        span<u32> codeArena; //!< The executable memory region containing all translated code, this is lazily allocated
+        size_t codeArenaOffset{}; //!< The offset of the first unused instruction in the code arena
+        bool codeArenaExhausted{}; //!< If the code arena couldn't be allocated or has been filled up, no further macros will be translated
+        std::unordered_map<u64, Function> functions; //!< A map from the hash of a macro's code to its translated code, this persists across macro uploads
+
+        /**
+         * @brief Translates the supplied macro into host code and places it into the code arena
+         * @return The translated macro or nullptr if it couldn't be translated
+         */
+        Function Translate(span<u32> macro);
+
+      public:
+        MacroJit(span<u32> macroCode);
+
+        ~MacroJit();
+
+        /**
+         * @return The length of the macro starting at the supplied offset in instructions or 0 if it can't be statically determined or is malformed
+         * @note The length includes the delay slot of the final exit and is independent of whether the macro can be translated
+         */
+        size_t GetMacroLength(size_t offset);
+
+        /**
+         * @return The translated code for the macro at the supplied offset in macro code memory or nullptr if it can't be translated
+         * @note Translation is only performed once per unique macro, subsequent calls for the same code return the same translation
+         */
+        Function Compile(size_t offset);
+
+        /**
+         * @brief Executes a translated macro with the given arguments targeting the specified engine
+         */
+        void Execute(Function function, span<u32> args, MacroEngineBase *targetEngine);
+
+        /**
+         * @brief Calls a method on the engine, this is called from translated code
+         * @return The value of the method address register after the method was called with the upper 32-bits set if an exception was thrown
+         */
+        static u64 Send(Context *context, u32 methodAddress, u32 argument);
+
+        /**
+         * @brief Reads a method from the engine, this is called from translated code
+         * @return The value of the method with the upper 32-bits set if an exception was thrown
+         */
+        static u64 Read(Context *context, u32 method);
+    };
+}
@@ -3,6 +3,7 @@
 // Copyright © 2022 Skyline Team and Contributors (https://github.com/skyline-emu/)
 
 #include <range/v3/algorithm/any_of.hpp>
+#include <common/trace.h>
 #include <soc/gm20b/engines/maxwell/types.h>
 #include <soc/gm20b/engines/engine.h>
 #include "macro_state.h"
@@ -25,12 +26,21 @@ namespace skyline::soc::gm20b {
 
     namespace macro_hle {
         bool DrawInstanced(size_t offset, span<GpfifoArgument> args, engine::MacroEngineBase *targetEngine, const std::function<void(void)> &flushCallback) {
+            u32 topology{*args[0]};
+            bool topologyConversion{TopologyRequiresConversion(static_cast<engine::maxwell3d::type::DrawTopology>(topology))};
+
+            // Draw parameters that were written by the GPU are laid out identically to VkDrawIndirectCommand so they can be consumed by an indirect draw without a flush
+            if (!topologyConversion && args[1].dirty && args[1].argumentPtr) {
+                targetEngine->DrawIndirect(topology, span(args[1].argumentPtr, 4).cast<u8>(), 1, 0);
+                return true;
+            }
+
             if (AnyArgsDirty(args))
                 flushCallback();
 
             u32 instanceCount{targetEngine->ReadMethodFromMacro(0xD1B) & *args[2]};
 
-            targetEngine->DrawInstanced(*args[0], *args[1], instanceCount, *args[3], *args[4]);
+            targetEngine->DrawInstanced(topology, *args[1], instanceCount, *args[3], *args[4]);
             return true;
         }
 
@@ -64,18 +74,72 @@ namespace skyline::soc::gm20b {
             {DrawInstancedIndexedIndirect, 0x1F, 0xDA07F4E5} // This macro is the same as above but it writes draw params to a cbuf, which are unnecessary due to hades HLE
         }};
 
-        static Function LookupFunction(span<u32> code) {
-            for (const auto &function : functions) {
-                if (function.size > code.size())
-                    continue;
+        /**
+         * @return A key uniquely identifying a macro by its size and the XXH32 hash of its code
+         */
+        static u64 GetMacroKey(u64 size, u32 hash) {
+            return (size << 32) | hash;
+        }
+
+        /**
+         * @brief A registry of all HLE functions indexed by the size and hash of the macro they replace
+         * @note Macros are hashed once per distinct HLE function size rather than once per HLE function
+         */
+        class HleRegistry {
+          private:
+            std::vector<u64> sizes; //!< All distinct sizes of HLE functions in ascending order
+            std::unordered_map<u64, Function> registry;
+
+          public:
+            HleRegistry() {
+                for (const auto &function : functions) {
+                    if (!function.function)
+                        continue;
+
+                    registry.emplace(GetMacroKey(function.size, function.hash), function.function);
+                    if (std::find(sizes.begin(), sizes.end(), function.size) == sizes.end())
+                        sizes.push_back(function.size);
+                }
+
+                std::sort(sizes.begin(), sizes.end());
+            }
 
-                auto macro{code.subspan(0, function.size)};
-                if (XXH32(macro.data(), macro.size_bytes(), 0) == function.hash)
-                    return function.function;
+            Function Lookup(span<u32> code) const {
+                for (u64 size : sizes) {
+                    if (size > code.size())
+                        break;
+
+                    auto macro{code.subspan(0, size)};
+                    auto it{registry.find(GetMacroKey(size, XXH32(macro.data(), macro.size_bytes(), 0)))};
+                    if (it != registry.end())
+                        return it->second;
+                }
+
+                return {};
             }
+        };
 
-            return {};
+        static Function LookupFunction(span<u32> code) {
+            static const HleRegistry registry;
+            return registry.Lookup(code);
+        }
+    }
+
+    void MacroState::RecordExecution(u32 position, size_t offset, const char *path) {
+        auto &statistics{positionStatistics[position]};
+        if (!statistics) [[unlikely]] {
+            // Statistics are keyed with the same size and hash used by HLE function entries so hot macros can directly be added as HLE functions
+            size_t size{macroJit.GetMacroLength(offset)};
+            auto macro{span(macroCode).subspan(offset, size)};
+            u32 hash{XXH32(macro.data(), macro.size_bytes(), 0)};
+
+            auto it{macroStatistics.try_emplace(macro_hle::GetMacroKey(size, hash)).first};
+            if (it->second.trackName.empty())
+                it->second.trackName = fmt::format("Macro 0x{:X} (Size: 0x{:X}, {})", hash, size, path);
+            statistics = &it->second;
         }
+
+        TRACE_COUNTER("gpu", perfetto::CounterTrack{statistics->trackName.c_str()}, ++statistics->executionCount);
     }
 
     void MacroState::Invalidate() {
@@ -87,6 +151,8 @@ namespace skyline::soc::gm20b {
 
         if (invalidatePending) {
             macroHleFunctions.fill({});
+            macroJitFunctions.fill({});
+            positionStatistics.fill(nullptr);
             invalidatePending = false;
         }
 
@@ -97,14 +163,32 @@ namespace skyline::soc::gm20b {
             hleEntry.valid = true;
         }
 
-        if (macroHleFunctions[position].function && macroHleFunctions[position].function(offset, args, targetEngine, flushCallback))
+        if (hleEntry.function && hleEntry.function(offset, args, targetEngine, flushCallback)) {
+            RecordExecution(position, offset, "HLE");
             return;
+        }
 
         if (AnyArgsDirty(args))
             flushCallback();
 
         argumentStorage.resize(args.size());
         std::transform(args.begin(), args.end(), argumentStorage.begin(), [](GpfifoArgument arg) { return *arg; });
+
+        if (enableMacroJit) {
+            auto &jitEntry{macroJitFunctions[position]};
+            if (!jitEntry.valid) {
+                jitEntry.function = macroJit.Compile(offset);
+                jitEntry.valid = true;
+            }
+
+            if (jitEntry.function) {
+                RecordExecution(position, offset, "JIT");
+                macroJit.Execute(jitEntry.function, argumentStorage, targetEngine);
+                return;
+            }
+        }
+
+        RecordExecution(position, offset, "Interpreter");
         macroInterpreter.Execute(offset, argumentStorage, targetEngine);
     }
 }
@@ -5,6 +5,7 @@
 
 #include <common.h>
 #include "macro_interpreter.h"
+#include "macro_jit.h"
 
 namespace skyline::soc::gm20b {
     /**
@@ -37,23 +38,47 @@ namespace skyline::soc::gm20b {
             bool valid;
         };
 
+        struct MacroJitEntry {
+            engine::MacroJit::Function function;
+            bool valid;
+        };
+
+        /**
+         * @brief Execution statistics for a unique macro, these are exported as perfetto counters to identify hot macros that would benefit from HLE
+         */
+        struct MacroStatistics {
+            std::string trackName; //!< The name of the perfetto counter track, this contains the size and hash of the macro in the same form used by HLE function entries
+            u64 executionCount{};
+        };
+
         engine::MacroInterpreter macroInterpreter; //!< The macro interpreter for handling 3D/2D macros
+        engine::MacroJit macroJit; //!< The macro JIT for translating 3D/2D macros into host code, the interpreter is used for any macros it can't translate
         std::array<u32, 0x2000> macroCode{}; //!< Stores GPU macros, writes to it will wraparound on overflow
         std::array<size_t, 0x80> macroPositions{}; //!< The positions of each individual macro in macro code memory, there can be a maximum of 0x80 macros at any one time
         std::array<MacroHleEntry, 0x80> macroHleFunctions{}; //!< The HLE functions for each macro position, used to optionally override the interpreter
+        std::array<MacroJitEntry, 0x80> macroJitFunctions{}; //!< The translated code for each macro position, used in place of the interpreter when available
+        std::unordered_map<u64, MacroStatistics> macroStatistics; //!< A map from the size and hash of a macro to its statistics, this persists across macro uploads
+        std::array<MacroStatistics *, 0x80> positionStatistics{}; //!< The statistics for the macro at each macro position, nullptr if they haven't been looked up since the last invalidation
         std::vector<u32> argumentStorage; //!< Storage for the macro arguments during execution using the interpreter
 
         bool invalidatePending{};
+        bool enableMacroJit; //!< If macros should be translated into host code rather than interpreted
+
+        MacroState(bool enableMacroJit) : macroInterpreter{macroCode}, macroJit{macroCode}, enableMacroJit{enableMacroJit} {}
 
-        MacroState() : macroInterpreter{macroCode} {}
+        /**
+         * @brief Increments the execution counter of the macro at the supplied position
+         * @param path The name of the path the macro is being executed with
+         */
+        void RecordExecution(u32 position, size_t offset, const char *path);
 
         /**
-         * @brief Invalidates the HLE function cache
+         * @brief Invalidates the HLE function and JIT caches
          */
         void Invalidate();
 
         /**
-         * @brief Executes a macro at a given position, this can either be a HLE function or the interpreter
+         * @brief Executes a macro at a given position, this can either be a HLE function, translated code or the interpreter
          */
         void Execute(u32 position, span<GpfifoArgument> args, engine::MacroEngineBase *targetEngine, const std::function<void(void)> &flushCallback);
     };
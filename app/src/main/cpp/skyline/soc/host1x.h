@@ -5,6 +5,7 @@
 
 #include "host1x/syncpoint.h"
 #include "host1x/command_fifo.h"
+#include "host1x/frame_queue.h"
 
 namespace skyline::soc::host1x {
     constexpr static size_t ChannelCount{14}; //!< The number of channels within host1x
@@ -17,6 +18,7 @@ namespace skyline::soc::host1x {
       public:
         SyncpointSet syncpoints;
         std::array<ChannelCommandFifo, ChannelCount> channels;
+        FrameQueue frames; //!< Frames decoded by NVDEC which are yet to be consumed by VIC
 
         Host1x(const DeviceState &state) : channels{util::MakeFilledArray<ChannelCommandFifo, ChannelCount>(state, syncpoints)} {}
     };
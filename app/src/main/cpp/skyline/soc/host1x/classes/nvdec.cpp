@@ -1,13 +1,64 @@
 // SPDX-License-Identifier: MPL-2.0
 // Copyright © 2021 Skyline Team and Contributors (https://github.com/skyline-emu/)
 
+#include <soc.h>
+#include <soc/host1x/codecs/h264.h>
 #include "nvdec.h"
 
 namespace skyline::soc::host1x {
-    NvDecClass::NvDecClass(std::function<void()> opDoneCallback)
-        : opDoneCallback(std::move(opDoneCallback)) {}
+    NvDecClass::NvDecClass(std::function<void()> opDoneCallback, const DeviceState &state)
+        : opDoneCallback(std::move(opDoneCallback)),
+          state(state) {}
 
     void NvDecClass::CallMethod(u32 method, u32 argument) {
-        Logger::Warn("Unknown NVDEC class method called: 0x{:X} argument: 0x{:X}", method, argument);
+        if (method >= registers.raw.size()) {
+            Logger::Warn("Unknown NVDEC class method called: 0x{:X} argument: 0x{:X}", method, argument);
+            return;
+        }
+
+        registers.raw[method] = argument;
+        if (method == ExecuteMethodId)
+            Execute();
+    }
+
+    void NvDecClass::Execute() {
+        TRACE_EVENT("gpu", "NvDecClass::Execute", "codec", static_cast<u32>(registers.codecId));
+
+        try {
+            switch (registers.codecId) {
+                case VideoCodec::H264:
+                    DecodeH264();
+                    break;
+                default:
+                    Logger::Warn("Unsupported NVDEC codec: 0x{:X}", static_cast<u32>(registers.codecId));
+                    break;
+            }
+        } catch (const std::exception &e) {
+            // Decoding errors are non-fatal, the frame is dropped and the guest carries on with stale surfaces
+            Logger::Warn("Failed to decode frame: {}", e.what());
+        }
+
+        opDoneCallback();
+    }
+
+    void NvDecClass::DecodeH264() {
+        auto &smmu{state.soc->smmu};
+        auto info{smmu.Read<codecs::H264PictureInfo>(registers.pictureInfoOffset << 8)};
+
+        std::vector<u8> sliceData(info.streamLength);
+        smmu.Read<u8>(sliceData, registers.frameBitstreamOffset << 8);
+        auto frame{codecs::ComposeH264Frame(info, sliceData)};
+
+        if (!h264Decoder)
+            h264Decoder.emplace("video/avc");
+
+        u32 width{info.picWidthInMbs * 16}, height{info.frameHeightInMbs * 16};
+        if (info.currentPicIndex >= registers.surfaceLumaOffsets.size())
+            throw exception("Invalid H.264 output surface index: {}", static_cast<u32>(info.currentPicIndex));
+
+        // Frames are keyed by the surface that they would have been written to, the decoder may output them in display order rather than decode order
+        u32 lumaAddress{registers.surfaceLumaOffsets[info.currentPicIndex] << 8};
+        for (auto &[address, decodedFrame] : h264Decoder->Decode(frame, width, height, lumaAddress))
+            state.soc->host1x.frames.Push(address, std::move(decodedFrame));
     }
 }
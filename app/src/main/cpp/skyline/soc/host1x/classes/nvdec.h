@@ -4,17 +4,70 @@
 #pragma once
 
 #include <common.h>
+#include <soc/host1x/codecs/media_codec_decoder.h>
 
 namespace skyline::soc::host1x {
     /**
      * @brief The NVDEC Host1x class implements hardware accelerated video decoding for the VP9/VP8/H264/VC1 codecs
+     * @note Decoding is done by the host's hardware decoders through MediaCodec, only H.264 is supported as other codecs require their frame headers to be reconstructed from the picture setup as well
      */
     class NvDecClass {
       private:
+        /**
+         * @note These match the codec IDs used by the NVDEC driver
+         */
+        enum class VideoCodec : u32 {
+            None = 0x0,
+            H264 = 0x3,
+            Vp8 = 0x5,
+            H265 = 0x7,
+            Vp9 = 0x9,
+        };
+
+        /**
+         * @brief The NVDEC register file, all offsets to buffers are SMMU addresses shifted right by 8 bits
+         * @note Methods index 64-bit registers rather than 32-bit ones unlike other classes
+         */
+        union Registers {
+            std::array<u32, 0x200> raw;
+
+            struct {
+                u32 _pad0_[0x80];
+                VideoCodec codecId; //!< 0x80
+                u32 _pad1_[0x3F];
+                u32 execute; //!< 0xC0
+                u32 _pad2_[0x3F];
+                u32 controlParams; //!< 0x100
+                u32 pictureInfoOffset; //!< 0x101
+                u32 frameBitstreamOffset; //!< 0x102
+                u32 frameNumber; //!< 0x103
+                u32 h264SliceDataOffsets; //!< 0x104
+                u32 h264MvDumpOffset; //!< 0x105
+                u32 _pad3_[0x3];
+                u32 frameStatsOffset; //!< 0x109
+                u32 h264LastSurfaceLumaOffset; //!< 0x10A
+                u32 h264LastSurfaceChromaOffset; //!< 0x10B
+                std::array<u32, 17> surfaceLumaOffsets; //!< 0x10C
+                std::array<u32, 17> surfaceChromaOffsets; //!< 0x11D
+            };
+        } registers{};
+        static_assert(offsetof(Registers, surfaceChromaOffsets) == 0x11D * sizeof(u32));
+
+        static constexpr u32 ExecuteMethodId{offsetof(Registers, execute) / sizeof(u32)};
+
+        const DeviceState &state;
         std::function<void()> opDoneCallback;
+        std::optional<codecs::MediaCodecDecoder> h264Decoder;
+
+        /**
+         * @brief Decodes a frame with the current register state
+         */
+        void Execute();
+
+        void DecodeH264();
 
       public:
-        NvDecClass(std::function<void()> opDoneCallback);
+        NvDecClass(std::function<void()> opDoneCallback, const DeviceState &state);
 
         void CallMethod(u32 method, u32 argument);
     };
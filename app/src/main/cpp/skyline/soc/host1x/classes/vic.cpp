@@ -1,13 +1,126 @@
 // SPDX-License-Identifier: MPL-2.0
 // Copyright © 2021 Skyline Team and Contributors (https://github.com/skyline-emu/)
 
+#include <soc.h>
+#include <gpu.h>
+#include <gpu/texture/format.h>
+#include <gpu/texture_manager.h>
 #include "vic.h"
 
 namespace skyline::soc::host1x {
-    VicClass::VicClass(std::function<void()> opDoneCallback)
-        : opDoneCallback(std::move(opDoneCallback)) {}
+    VicClass::VicClass(std::function<void()> opDoneCallback, const DeviceState &state)
+        : opDoneCallback(std::move(opDoneCallback)),
+          state(state) {}
 
     void VicClass::CallMethod(u32 method, u32 argument) {
-        Logger::Warn("Unknown VIC class method called: 0x{:X} argument: 0x{:X}", method, argument);
+        if (method >= registers.raw.size()) {
+            Logger::Warn("Unknown VIC class method called: 0x{:X} argument: 0x{:X}", method, argument);
+            return;
+        }
+
+        registers.raw[method] = argument;
+        if (method == ExecuteMethodId)
+            Execute();
+    }
+
+    void VicClass::Execute() {
+        TRACE_EVENT("gpu", "VicClass::Execute");
+
+        if (!executor)
+            executor.emplace(state);
+
+        try {
+            Compose();
+        } catch (const std::exception &e) {
+            // Composition errors are non-fatal, the output surface retains its prior contents
+            Logger::Warn("Failed to compose frame: {}", e.what());
+        }
+
+        // The operation is complete once the composition has been submitted to the host GPU, any guest access to the output surface will wait on it
+        executor->Submit(std::function<void()>{opDoneCallback});
+    }
+
+    void VicClass::Compose() {
+        auto frame{state.soc->host1x.frames.GetLatest()};
+        if (!frame) {
+            Logger::Debug("No decoded frame is available for composition");
+            return;
+        }
+
+        auto &smmu{state.soc->smmu};
+        OutputConfig config{.raw = smmu.Read<u64>((registers.configStructOffset << 8) + OutputConfigOffset)};
+
+        gpu::texture::Format format;
+        bool swapRedBlue{};
+        switch (config.pixelFormat) {
+            case PixelFormat::R8G8B8A8:
+            case PixelFormat::R8G8B8X8:
+                format = gpu::format::R8G8B8A8Unorm;
+                break;
+            case PixelFormat::B8G8R8A8:
+                format = gpu::format::B8G8R8A8Unorm;
+                swapRedBlue = true;
+                break;
+            default:
+                throw exception("Unsupported output pixel format: 0x{:X}", static_cast<u32>(config.pixelFormat));
+        }
+
+        u32 surfaceWidth{static_cast<u32>(config.surfaceWidthMinus1 + 1)}, surfaceHeight{static_cast<u32>(config.surfaceHeightMinus1 + 1)};
+        gpu::GuestTexture guest{};
+        guest.format = format;
+        guest.aspect = format->vkAspect;
+        guest.viewType = vk::ImageViewType::e2D;
+        guest.dimensions = gpu::texture::Dimensions{surfaceWidth, surfaceHeight, 1};
+        if (config.blockLinearKind)
+            guest.tileConfig = gpu::texture::TileConfig{
+                .mode = gpu::texture::TileMode::Block,
+                .blockHeight = static_cast<u8>(1U << config.blockLinearHeightLog2),
+                .blockDepth = 1,
+            };
+        else
+            guest.tileConfig = gpu::texture::TileConfig{
+                .mode = gpu::texture::TileMode::Pitch,
+                .pitch = surfaceWidth * format->bpb,
+            };
+
+        auto mappings{smmu.TranslateRange(registers.outputSurfaceLumaOffset << 8, guest.GetSize())};
+        guest.mappings.assign(mappings.begin(), mappings.end());
+
+        auto dstView{state.gpu->texture.FindOrCreate(guest, executor->tag)};
+        executor->AttachDependency(dstView);
+        executor->AttachTexture(dstView.get());
+        dstView->texture->MarkGpuDirty(executor->usageTracker);
+
+        // The frame is uploaded as-is and converted on the GPU, the output is written into a linear buffer with the pitch of the surface and copied into the texture
+        u32 width{std::min(frame->width, surfaceWidth)}, height{std::min(frame->height, surfaceHeight)};
+        vk::DeviceSize srcSize{frame->luma.size() + frame->chroma.size()}, dstSize{static_cast<vk::DeviceSize>(surfaceWidth) * height * format->bpb};
+        auto srcAllocation{executor->megaBufferAllocator->Allocate(executor->cycle, srcSize, true)};
+        std::memcpy(srcAllocation.region.data(), frame->luma.data(), frame->luma.size());
+        std::memcpy(srcAllocation.region.data() + frame->luma.size(), frame->chroma.data(), frame->chroma.size());
+        auto dstAllocation{executor->megaBufferAllocator->Allocate(executor->cycle, dstSize, true)};
+
+        executor->AddOutsideRpCommand([=, srcStride = frame->width, chromaOffset = static_cast<u32>(frame->luma.size())](vk::raii::CommandBuffer &commandBuffer, const std::shared_ptr<FenceCycle> &cycle, gpu::GPU &gpu) {
+            gpu.helperShaders.vicCompositionHelperShader.Compose(gpu, commandBuffer, cycle,
+                                                                 vk::DescriptorBufferInfo{srcAllocation.buffer, srcAllocation.offset, srcSize},
+                                                                 vk::DescriptorBufferInfo{dstAllocation.buffer, dstAllocation.offset, dstSize},
+                                                                 width, height, srcStride, chromaOffset, surfaceWidth, swapRedBlue);
+
+            commandBuffer.copyBufferToImage(dstAllocation.buffer, dstView->texture->GetBacking(), vk::ImageLayout::eGeneral, vk::BufferImageCopy{
+                .bufferOffset = dstAllocation.offset,
+                .bufferRowLength = surfaceWidth,
+                .imageSubresource = {
+                    .aspectMask = dstView->range.aspectMask,
+                    .mipLevel = dstView->range.baseMipLevel,
+                    .baseArrayLayer = dstView->range.baseArrayLayer,
+                    .layerCount = 1,
+                },
+                .imageExtent = {width, height, 1},
+            });
+
+            commandBuffer.pipelineBarrier(vk::PipelineStageFlagBits::eTransfer, vk::PipelineStageFlagBits::eAllCommands, {}, vk::MemoryBarrier{
+                .srcAccessMask = vk::AccessFlagBits::eTransferWrite,
+                .dstAccessMask = vk::AccessFlagBits::eMemoryRead | vk::AccessFlagBits::eMemoryWrite,
+            }, {}, {});
+        });
     }
 }
@@ -4,17 +4,86 @@
 #pragma once
 
 #include <common.h>
+#include <gpu/interconnect/command_executor.h>
 
 namespace skyline::soc::host1x {
     /**
      * @brief The VIC Host1x class implements hardware accelerated image operations
+     * @note Only composition of the most recently decoded NVDEC frame into a single RGB output surface is supported, this is done with a compute shader that writes directly into the output texture on the host GPU
      */
     class VicClass {
       private:
+        /**
+         * @brief The VIC register file, all offsets to buffers are SMMU addresses shifted right by 8 bits
+         */
+        union Registers {
+            std::array<u32, 0x200> raw;
+
+            struct {
+                u32 _pad0_[0xC0];
+                u32 execute; //!< 0xC0
+                u32 _pad1_[0x100];
+                u32 controlParams; //!< 0x1C1
+                u32 configStructOffset; //!< 0x1C2
+                u32 filterStructOffset; //!< 0x1C3
+                u32 _pad2_[0x4];
+                u32 outputSurfaceLumaOffset; //!< 0x1C8
+                u32 outputSurfaceChromaOffset; //!< 0x1C9
+                u32 outputSurfaceChromaUnusedOffset; //!< 0x1CA
+            };
+        } registers{};
+        static_assert(offsetof(Registers, outputSurfaceChromaUnusedOffset) == 0x1CA * sizeof(u32));
+
+        static constexpr u32 ExecuteMethodId{offsetof(Registers, execute) / sizeof(u32)};
+
+        /**
+         * @note These match the pixel formats used by the VIC driver
+         */
+        enum class PixelFormat : u64 {
+            R8G8B8A8 = 0x1F,
+            B8G8R8A8 = 0x20,
+            R8G8B8X8 = 0x23,
+            Yuv420 = 0x44,
+        };
+
+        /**
+         * @brief The output configuration in the config struct
+         */
+        union OutputConfig {
+            u64 raw;
+
+            struct {
+                PixelFormat pixelFormat : 7;
+                u64 chromaLocationHorizontal : 2;
+                u64 chromaLocationVertical : 2;
+                u64 blockLinearKind : 4; //!< 0 for pitch linear surfaces and non-zero for block linear ones
+                u64 blockLinearHeightLog2 : 4;
+                u64 _pad0_ : 13;
+                u64 surfaceWidthMinus1 : 14;
+                u64 surfaceHeightMinus1 : 14;
+                u64 _pad1_ : 4;
+            };
+        };
+        static_assert(sizeof(OutputConfig) == sizeof(u64));
+
+        static constexpr u32 OutputConfigOffset{0x20}; //!< The offset of the output configuration in the config struct
+
+        const DeviceState &state;
         std::function<void()> opDoneCallback;
+        std::optional<gpu::interconnect::CommandExecutor> executor; //!< A dedicated executor for composition as VIC runs independently of any GPU channel, it's created on the first composition as every Host1x channel has a VIC class
+
+        /**
+         * @brief Runs a composition with the current register state and signals its completion
+         */
+        void Execute();
+
+        /**
+         * @brief Records the composition of the latest decoded frame into the output surface
+         */
+        void Compose();
 
       public:
-        VicClass(std::function<void()> opDoneCallback);
+        VicClass(std::function<void()> opDoneCallback, const DeviceState &state);
 
         void CallMethod(u32 method, u32 argument);
     };
@@ -0,0 +1,180 @@
+// SPDX-License-Identifier: MPL-2.0
+// Copyright © 2022 Skyline Team and Contributors (https://github.com/skyline-emu/)
+
+#include "h264.h"
+
+namespace skyline::soc::host1x::codecs {
+    /**
+     * @brief A writer of H.264 NAL units, bits are written MSB-first into the RBSP and emulation prevention bytes are inserted when the unit is finished
+     */
+    class NalWriter {
+      private:
+        std::vector<u8> &output;
+        std::vector<u8> rbsp;
+        u64 buffer{}; //!< Bits that haven't been flushed into the RBSP yet
+        u8 bufferedBits{};
+
+      public:
+        NalWriter(std::vector<u8> &output, u8 nalRefIdc, u8 nalUnitType) : output(output) {
+            output.insert(output.end(), {0x00, 0x00, 0x00, 0x01, static_cast<u8>((nalRefIdc << 5) | nalUnitType)});
+        }
+
+        void WriteBits(u32 value, u8 count) {
+            buffer = (buffer << count) | (value & ((1ULL << count) - 1));
+            bufferedBits += count;
+            while (bufferedBits >= 8) {
+                bufferedBits -= 8;
+                rbsp.push_back(static_cast<u8>(buffer >> bufferedBits));
+            }
+        }
+
+        void WriteBit(bool value) {
+            WriteBits(value, 1);
+        }
+
+        /**
+         * @brief Writes an unsigned Exp-Golomb code
+         */
+        void WriteUe(u32 value) {
+            u64 codeNum{static_cast<u64>(value) + 1};
+            u8 length{static_cast<u8>(std::bit_width(codeNum))};
+            WriteBits(0, length - 1);
+            if (length > 32) {
+                WriteBits(static_cast<u32>(codeNum >> 32), length - 32);
+                WriteBits(static_cast<u32>(codeNum), 32);
+            } else {
+                WriteBits(static_cast<u32>(codeNum), length);
+            }
+        }
+
+        /**
+         * @brief Writes a signed Exp-Golomb code
+         */
+        void WriteSe(i32 value) {
+            WriteUe(value > 0 ? static_cast<u32>(value) * 2 - 1 : static_cast<u32>(-static_cast<i64>(value)) * 2);
+        }
+
+        /**
+         * @brief Writes the RBSP trailing bits and copies the unit into the output with emulation prevention applied
+         */
+        void Finish() {
+            WriteBit(true);
+            if (bufferedBits)
+                WriteBits(0, 8 - bufferedBits);
+
+            u8 zeroCount{};
+            for (u8 byte : rbsp) {
+                if (zeroCount == 2 && byte <= 0x03) {
+                    output.push_back(0x03);
+                    zeroCount = 0;
+                }
+                output.push_back(byte);
+                zeroCount = byte ? 0 : zeroCount + 1;
+            }
+        }
+    };
+
+    /**
+     * @brief Writes a scaling list in zig-zag order as deltas from the previous coefficient
+     */
+    template<size_t Size>
+    static void WriteScalingList(NalWriter &writer, const std::array<u8, Size> &list) {
+        static constexpr std::array<u8, 16> ZigZag4x4{0, 1, 4, 8, 5, 2, 3, 6, 9, 12, 13, 10, 7, 11, 14, 15};
+        static constexpr std::array<u8, 64> ZigZag8x8{
+            0, 1, 8, 16, 9, 2, 3, 10, 17, 24, 32, 25, 18, 11, 4, 5,
+            12, 19, 26, 33, 40, 48, 41, 34, 27, 20, 13, 6, 7, 14, 21, 28,
+            35, 42, 49, 56, 57, 50, 43, 36, 29, 22, 15, 23, 30, 37, 44, 51,
+            58, 59, 52, 45, 38, 31, 39, 46, 53, 60, 61, 54, 47, 55, 62, 63,
+        };
+        const u8 *scan{Size == ZigZag4x4.size() ? ZigZag4x4.data() : ZigZag8x8.data()};
+
+        u8 lastScale{8};
+        for (size_t i{}; i < Size; i++) {
+            u8 scale{list[scan[i]]};
+            writer.WriteSe(static_cast<i8>(static_cast<u8>(scale - lastScale))); // Deltas wrap around modulo 256
+            lastScale = scale;
+        }
+    }
+
+    std::vector<u8> ComposeH264Frame(const H264PictureInfo &info, span<u8> sliceData) {
+        std::vector<u8> frame;
+        frame.reserve(sliceData.size() + 0x200);
+
+        {
+            constexpr u8 SpsNalType{7};
+            NalWriter sps{frame, 3, SpsNalType};
+            sps.WriteBits(100, 8); // profile_idc: High, this is the superset of all profiles that NVDEC supports
+            sps.WriteBits(0, 8); // constraint_set_flags
+            sps.WriteBits(51, 8); // level_idc: 5.1, the level is only used for allocating buffers so the maximum is used
+            sps.WriteUe(0); // seq_parameter_set_id
+            sps.WriteUe(static_cast<u32>(info.chromaFormatIdc));
+            if (info.chromaFormatIdc == 3)
+                sps.WriteBit(false); // separate_colour_plane_flag
+            sps.WriteUe(0); // bit_depth_luma_minus8
+            sps.WriteUe(0); // bit_depth_chroma_minus8
+            sps.WriteBit(false); // qpprime_y_zero_transform_bypass_flag
+            sps.WriteBit(false); // seq_scaling_matrix_present_flag, the scaling lists are supplied in the PPS instead
+            sps.WriteUe(static_cast<u32>(info.log2MaxFrameNumMinus4));
+            sps.WriteUe(static_cast<u32>(info.picOrderCntType));
+            if (info.picOrderCntType == 0) {
+                sps.WriteUe(info.log2MaxPicOrderCntLsbMinus4);
+            } else if (info.picOrderCntType == 1) {
+                sps.WriteBit(info.deltaPicOrderAlwaysZeroFlag != 0);
+                sps.WriteSe(0); // offset_for_non_ref_pic
+                sps.WriteSe(0); // offset_for_top_to_bottom_field
+                sps.WriteUe(0); // num_ref_frames_in_pic_order_cnt_cycle
+            }
+            sps.WriteUe(16); // max_num_ref_frames
+            sps.WriteBit(false); // gaps_in_frame_num_value_allowed_flag
+            sps.WriteUe(info.picWidthInMbs - 1);
+            sps.WriteUe((info.frameHeightInMbs / (info.frameMbsOnlyFlag ? 1 : 2)) - 1); // pic_height_in_map_units_minus1
+            sps.WriteBit(info.frameMbsOnlyFlag != 0);
+            if (!info.frameMbsOnlyFlag)
+                sps.WriteBit(info.mbaffFrame);
+            sps.WriteBit(info.direct8x8Inference);
+            sps.WriteBit(false); // frame_cropping_flag
+            sps.WriteBit(false); // vui_parameters_present_flag
+            sps.Finish();
+        }
+
+        {
+            constexpr u8 PpsNalType{8};
+            NalWriter pps{frame, 3, PpsNalType};
+            pps.WriteUe(0); // pic_parameter_set_id
+            pps.WriteUe(0); // seq_parameter_set_id
+            pps.WriteBit(info.entropyCodingModeFlag != 0);
+            pps.WriteBit(info.picOrderPresentFlag != 0);
+            pps.WriteUe(0); // num_slice_groups_minus1
+            pps.WriteUe(static_cast<u32>(std::max(info.numRefIdxL0DefaultActive, 1) - 1));
+            pps.WriteUe(static_cast<u32>(std::max(info.numRefIdxL1DefaultActive, 1) - 1));
+            pps.WriteBit(info.weightedPred);
+            pps.WriteBits(static_cast<u32>(info.weightedBipredIdc), 2);
+            pps.WriteSe(static_cast<i32>(info.picInitQpMinus26));
+            pps.WriteSe(0); // pic_init_qs_minus26
+            pps.WriteSe(static_cast<i32>(info.chromaQpIndexOffset));
+            pps.WriteBit(info.deblockingFilterControlPresentFlag != 0);
+            pps.WriteBit(info.constrainedIntraPred);
+            pps.WriteBit(info.redundantPicCntPresentFlag != 0);
+
+            // The extended PPS fields are always written as the scaling lists are only supplied through them
+            pps.WriteBit(info.transform8x8ModeFlag != 0);
+            pps.WriteBit(true); // pic_scaling_matrix_present_flag
+            for (const auto &list : info.weightScale4x4) {
+                pps.WriteBit(true); // pic_scaling_list_present_flag
+                WriteScalingList(pps, list);
+            }
+            if (info.transform8x8ModeFlag) {
+                for (const auto &list : info.weightScale8x8) {
+                    pps.WriteBit(true);
+                    WriteScalingList(pps, list);
+                }
+            }
+            pps.WriteSe(static_cast<i32>(info.secondChromaQpIndexOffset));
+            pps.Finish();
+        }
+
+        // The slice data is already a sequence of Annex B NAL units with start codes
+        frame.insert(frame.end(), sliceData.begin(), sliceData.end());
+        return frame;
+    }
+}
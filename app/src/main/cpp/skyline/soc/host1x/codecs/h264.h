@@ -0,0 +1,81 @@
+// SPDX-License-Identifier: MPL-2.0
+// Copyright © 2022 Skyline Team and Contributors (https://github.com/skyline-emu/)
+
+#pragma once
+
+#include <common.h>
+
+namespace skyline::soc::host1x::codecs {
+    /**
+     * @brief A reference picture in the decoded picture buffer as supplied to NVDEC
+     */
+    struct H264DpbEntry {
+        u32 flags;
+        u32 fieldOrderCount[2];
+        u32 frameIndex;
+    };
+    static_assert(sizeof(H264DpbEntry) == 0x10);
+
+    /**
+     * @brief The picture setup structure which the NVDEC driver supplies in place of the SPS and PPS that were parsed out of the bitstream
+     */
+    struct H264PictureInfo {
+        u32 _pad0_[18];
+        u32 streamLength; //!< The size of the slice data in the bitstream buffer
+        u32 _pad1_[3];
+        u32 log2MaxPicOrderCntLsbMinus4;
+        u32 deltaPicOrderAlwaysZeroFlag;
+        u32 frameMbsOnlyFlag;
+        u32 picWidthInMbs;
+        u32 frameHeightInMbs;
+        u32 surfaceFormat; //!< The tiling of the output surfaces
+        u32 entropyCodingModeFlag;
+        i32 picOrderPresentFlag;
+        i32 numRefIdxL0DefaultActive;
+        i32 numRefIdxL1DefaultActive;
+        i32 deblockingFilterControlPresentFlag;
+        i32 redundantPicCntPresentFlag;
+        u32 transform8x8ModeFlag;
+        u32 pitchLuma;
+        u32 pitchChroma;
+        u32 lumaTopOffset;
+        u32 lumaBottomOffset;
+        u32 lumaFrameOffset;
+        u32 chromaTopOffset;
+        u32 chromaBottomOffset;
+        u32 chromaFrameOffset;
+        u32 historyBufferSize;
+        struct {
+            u64 mbaffFrame : 1;
+            u64 direct8x8Inference : 1;
+            u64 weightedPred : 1;
+            u64 constrainedIntraPred : 1;
+            u64 refPic : 1;
+            u64 fieldPic : 1;
+            u64 bottomField : 1;
+            u64 secondField : 1;
+            u64 log2MaxFrameNumMinus4 : 4;
+            u64 chromaFormatIdc : 2;
+            u64 picOrderCntType : 2;
+            i64 picInitQpMinus26 : 6;
+            i64 chromaQpIndexOffset : 5;
+            i64 secondChromaQpIndexOffset : 5;
+            u64 weightedBipredIdc : 2;
+            u64 currentPicIndex : 7; //!< The index of the surface that the picture is decoded into
+            u64 currentColocatedIndex : 5;
+            u64 frameNumber : 16;
+            u64 frameSurfaces : 1;
+            u64 outputMemoryLayout : 1;
+        };
+        i32 currentFieldOrderCount[2];
+        std::array<H264DpbEntry, 16> dpb;
+        std::array<std::array<u8, 16>, 6> weightScale4x4; //!< The 4x4 scaling lists in raster order
+        std::array<std::array<u8, 64>, 2> weightScale8x8; //!< The 8x8 scaling lists in raster order
+    };
+    static_assert(sizeof(H264PictureInfo) == 0x2A0);
+
+    /**
+     * @brief Composes an Annex B frame that can be fed to a regular H.264 decoder by prepending an SPS and PPS synthesized from the picture setup to the slice data
+     */
+    std::vector<u8> ComposeH264Frame(const H264PictureInfo &info, span<u8> sliceData);
+}
@@ -0,0 +1,150 @@
+// SPDX-License-Identifier: MPL-2.0
+// Copyright © 2022 Skyline Team and Contributors (https://github.com/skyline-emu/)
+
+#include "media_codec_decoder.h"
+
+namespace skyline::soc::host1x::codecs {
+    constexpr i64 InputTimeoutUs{10000}; //!< The maximum duration to wait for an input buffer to be available
+    constexpr i64 OutputTimeoutUs{5000}; //!< The maximum duration to wait for a frame after queuing an access unit, the decoder is polled again on the next access unit
+
+    /**
+     * @note These are taken from android.media.MediaCodecInfo.CodecCapabilities as the NDK doesn't define them
+     */
+    namespace color_format {
+        constexpr i32 Yuv420Planar{19};
+        constexpr i32 Yuv420SemiPlanar{21};
+        constexpr i32 QcomYuv420SemiPlanar{0x7FA30C00};
+    }
+
+    MediaCodecDecoder::MediaCodecDecoder(const char *mimeType) : mimeType(mimeType) {}
+
+    MediaCodecDecoder::~MediaCodecDecoder() {
+        Release();
+    }
+
+    void MediaCodecDecoder::Release() {
+        if (codec) {
+            AMediaCodec_stop(codec);
+            AMediaCodec_delete(codec);
+            codec = nullptr;
+        }
+    }
+
+    void MediaCodecDecoder::Configure(u32 pWidth, u32 pHeight) {
+        Release();
+        width = pWidth;
+        height = pHeight;
+        outputStride = static_cast<i32>(width);
+        outputSliceHeight = static_cast<i32>(height);
+        outputColorFormat = color_format::Yuv420SemiPlanar;
+
+        codec = AMediaCodec_createDecoderByType(mimeType);
+        if (!codec)
+            throw exception("No decoder is available for '{}'", mimeType);
+
+        AMediaFormat *format{AMediaFormat_new()};
+        AMediaFormat_setString(format, AMEDIAFORMAT_KEY_MIME, mimeType);
+        AMediaFormat_setInt32(format, AMEDIAFORMAT_KEY_WIDTH, static_cast<i32>(width));
+        AMediaFormat_setInt32(format, AMEDIAFORMAT_KEY_HEIGHT, static_cast<i32>(height));
+        AMediaFormat_setInt32(format, AMEDIAFORMAT_KEY_COLOR_FORMAT, color_format::Yuv420SemiPlanar);
+        media_status_t status{AMediaCodec_configure(codec, format, nullptr, nullptr, 0)};
+        AMediaFormat_delete(format);
+        if (status != AMEDIA_OK || AMediaCodec_start(codec) != AMEDIA_OK) {
+            AMediaCodec_delete(codec);
+            codec = nullptr;
+            throw exception("Failed to start the decoder for '{}' at {}x{}: {}", mimeType, width, height, static_cast<i32>(status));
+        }
+
+        Logger::Info("Started {} decoder at {}x{}", mimeType, width, height);
+    }
+
+    std::shared_ptr<DecodedFrame> MediaCodecDecoder::ConvertOutput(const u8 *buffer, size_t size) {
+        auto frame{std::make_shared<DecodedFrame>(DecodedFrame{
+            .width = width,
+            .height = height,
+            .luma = std::vector<u8>(static_cast<size_t>(width) * height),
+            .chroma = std::vector<u8>(static_cast<size_t>(width) * (height / 2)),
+        })};
+
+        size_t stride{static_cast<size_t>(outputStride)}, sliceHeight{static_cast<size_t>(outputSliceHeight)};
+        size_t lumaSize{stride * sliceHeight};
+        bool planar{outputColorFormat == color_format::Yuv420Planar};
+        if (size < lumaSize + (planar ? 2 * (stride / 2) * (sliceHeight / 2) : stride * (sliceHeight / 2))) {
+            Logger::Warn("Decoder output buffer is too small: 0x{:X}", size);
+            return nullptr;
+        }
+
+        for (size_t y{}; y < height; y++)
+            std::memcpy(frame->luma.data() + y * width, buffer + y * stride, width);
+
+        const u8 *chroma{buffer + lumaSize};
+        if (planar) {
+            // Planar output has separate U and V planes that are interleaved into a single plane here
+            const u8 *chromaV{chroma + (stride / 2) * (sliceHeight / 2)};
+            for (size_t y{}; y < height / 2; y++) {
+                u8 *row{frame->chroma.data() + y * width};
+                for (size_t x{}; x < width / 2; x++) {
+                    row[x * 2] = chroma[y * (stride / 2) + x];
+                    row[x * 2 + 1] = chromaV[y * (stride / 2) + x];
+                }
+            }
+        } else {
+            for (size_t y{}; y < height / 2; y++)
+                std::memcpy(frame->chroma.data() + y * width, chroma + y * stride, width);
+        }
+
+        return frame;
+    }
+
+    std::vector<std::pair<u32, std::shared_ptr<DecodedFrame>>> MediaCodecDecoder::Decode(span<u8> accessUnit, u32 pWidth, u32 pHeight, u32 tag) {
+        if (!codec || pWidth != width || pHeight != height)
+            Configure(pWidth, pHeight);
+
+        ssize_t inputIndex{AMediaCodec_dequeueInputBuffer(codec, InputTimeoutUs)};
+        if (inputIndex < 0) {
+            Logger::Warn("Timed out waiting for a decoder input buffer, dropping access unit");
+        } else {
+            size_t capacity{};
+            u8 *input{AMediaCodec_getInputBuffer(codec, static_cast<size_t>(inputIndex), &capacity)};
+            size_t size{std::min(accessUnit.size(), capacity)};
+            if (size != accessUnit.size())
+                Logger::Warn("Access unit is larger than the decoder input buffer: 0x{:X} > 0x{:X}", accessUnit.size(), capacity);
+            std::memcpy(input, accessUnit.data(), size);
+
+            // The tag is stored in the lower half of the timestamp so it's returned alongside the frame decoded from this access unit
+            u64 timestamp{(static_cast<u64>(frameCounter++) << 32) | tag};
+            AMediaCodec_queueInputBuffer(codec, static_cast<size_t>(inputIndex), 0, size, timestamp, 0);
+        }
+
+        std::vector<std::pair<u32, std::shared_ptr<DecodedFrame>>> frames;
+        while (true) {
+            AMediaCodecBufferInfo info{};
+            ssize_t outputIndex{AMediaCodec_dequeueOutputBuffer(codec, &info, frames.empty() ? OutputTimeoutUs : 0)};
+            if (outputIndex == AMEDIACODEC_INFO_OUTPUT_FORMAT_CHANGED) {
+                AMediaFormat *format{AMediaCodec_getOutputFormat(codec)};
+                AMediaFormat_getInt32(format, AMEDIAFORMAT_KEY_STRIDE, &outputStride);
+                AMediaFormat_getInt32(format, AMEDIAFORMAT_KEY_SLICE_HEIGHT, &outputSliceHeight);
+                AMediaFormat_getInt32(format, AMEDIAFORMAT_KEY_COLOR_FORMAT, &outputColorFormat);
+                AMediaFormat_delete(format);
+
+                outputStride = std::max(outputStride, static_cast<i32>(width));
+                outputSliceHeight = std::max(outputSliceHeight, static_cast<i32>(height));
+                if (outputColorFormat != color_format::Yuv420Planar && outputColorFormat != color_format::Yuv420SemiPlanar && outputColorFormat != color_format::QcomYuv420SemiPlanar)
+                    Logger::Warn("Unsupported decoder output format: 0x{:X}, treating it as semi-planar", outputColorFormat);
+                continue;
+            } else if (outputIndex == AMEDIACODEC_INFO_OUTPUT_BUFFERS_CHANGED) {
+                continue;
+            } else if (outputIndex < 0) {
+                break; // AMEDIACODEC_INFO_TRY_AGAIN_LATER, no more frames are available yet
+            }
+
+            size_t size{};
+            u8 *output{AMediaCodec_getOutputBuffer(codec, static_cast<size_t>(outputIndex), &size)};
+            if (output && info.size > 0)
+                if (auto frame{ConvertOutput(output + info.offset, static_cast<size_t>(info.size))})
+                    frames.emplace_back(static_cast<u32>(info.presentationTimeUs), std::move(frame));
+            AMediaCodec_releaseOutputBuffer(codec, static_cast<size_t>(outputIndex), false);
+        }
+        return frames;
+    }
+}
@@ -0,0 +1,47 @@
+// SPDX-License-Identifier: MPL-2.0
+// Copyright © 2022 Skyline Team and Contributors (https://github.com/skyline-emu/)
+
+#pragma once
+
+#include <media/NdkMediaCodec.h>
+#include <soc/host1x/frame_queue.h>
+
+namespace skyline::soc::host1x::codecs {
+    /**
+     * @brief A wrapper around a hardware decoder exposed through the NDK MediaCodec API, frames are decoded synchronously into host buffers
+     * @note The codec is recreated whenever the dimensions of the stream change as not all decoders handle resolution changes without a new SPS being signalled
+     */
+    class MediaCodecDecoder {
+      private:
+        const char *mimeType;
+        AMediaCodec *codec{};
+        u32 width{}, height{};
+        i32 outputStride{}, outputSliceHeight{}; //!< The layout of the decoder's output buffers, this is updated when the output format changes
+        i32 outputColorFormat{};
+        u32 frameCounter{}; //!< A counter of queued frames that forms the upper half of their timestamps, decoders require these to be unique
+
+        void Configure(u32 width, u32 height);
+
+        void Release();
+
+        /**
+         * @brief Converts an output buffer of the decoder into an NV12 frame
+         */
+        std::shared_ptr<DecodedFrame> ConvertOutput(const u8 *buffer, size_t size);
+
+      public:
+        /**
+         * @param mimeType The MIME type of the stream such as "video/avc"
+         */
+        MediaCodecDecoder(const char *mimeType);
+
+        ~MediaCodecDecoder();
+
+        /**
+         * @brief Decodes a single access unit of the bitstream
+         * @param tag A value that's returned alongside the frame decoded from this access unit, decoders may output frames in a different order to their input
+         * @return All frames which the decoder has output alongside the tags of their access units, this may be empty as decoders buffer several frames before outputting any
+         */
+        std::vector<std::pair<u32, std::shared_ptr<DecodedFrame>>> Decode(span<u8> accessUnit, u32 width, u32 height, u32 tag);
+    };
+}
@@ -0,0 +1,58 @@
+// SPDX-License-Identifier: MPL-2.0
+// Copyright © 2022 Skyline Team and Contributors (https://github.com/skyline-emu/)
+
+#pragma once
+
+#include <deque>
+#include <common.h>
+
+namespace skyline::soc::host1x {
+    /**
+     * @brief A video frame decoded by NVDEC in a semi-planar 4:2:0 layout (NV12), this is kept on the host rather than being written back into guest surfaces as VIC is the only consumer
+     */
+    struct DecodedFrame {
+        u32 width;
+        u32 height;
+        std::vector<u8> luma; //!< The Y plane with a stride equal to the width
+        std::vector<u8> chroma; //!< The interleaved UV plane with a stride equal to the width and half the height of the luma plane
+    };
+
+    /**
+     * @brief A bounded map of frames decoded by NVDEC keyed by the SMMU address of the luma surface they would have been written to, VIC looks up its input surfaces in it
+     */
+    class FrameQueue {
+      private:
+        static constexpr size_t MaxFrames{32}; //!< The maximum amount of frames that are retained, this is larger than the amount of surfaces NVDEC can reference
+        std::mutex mutex;
+        std::deque<std::pair<u32, std::shared_ptr<DecodedFrame>>> frames; //!< Frames from the oldest to the newest
+
+      public:
+        /**
+         * @brief Inserts a frame for the supplied luma surface address, replacing any prior frame for it
+         */
+        void Push(u32 lumaAddress, std::shared_ptr<DecodedFrame> frame) {
+            std::scoped_lock lock{mutex};
+            std::erase_if(frames, [lumaAddress](const auto &entry) { return entry.first == lumaAddress; });
+            if (frames.size() == MaxFrames)
+                frames.pop_front();
+            frames.emplace_back(lumaAddress, std::move(frame));
+        }
+
+        /**
+         * @return The frame decoded into the supplied luma surface address or nullptr if there isn't one
+         */
+        std::shared_ptr<DecodedFrame> Get(u32 lumaAddress) {
+            std::scoped_lock lock{mutex};
+            auto it{std::find_if(frames.begin(), frames.end(), [lumaAddress](const auto &entry) { return entry.first == lumaAddress; })};
+            return it != frames.end() ? it->second : nullptr;
+        }
+
+        /**
+         * @return The most recently decoded frame or nullptr if no frames have been decoded
+         */
+        std::shared_ptr<DecodedFrame> GetLatest() {
+            std::scoped_lock lock{mutex};
+            return frames.empty() ? nullptr : frames.back().second;
+        }
+    };
+}
@@ -2,9 +2,31 @@
 // Copyright © 2020 Skyline Team and Contributors (https://github.com/skyline-emu/)
 // Copyright © 2020 Ryujinx Team and Contributors (https://github.com/Ryujinx/)
 
+#include <gpu/fence_cycle.h>
 #include "syncpoint.h"
 
 namespace skyline::soc::host1x {
+    u64 Syncpoint::PushWaiter(u32 threshold, std::function<void()> callback, std::condition_variable *condition) {
+        u64 id{nextWaiterId++};
+        waiters.push_back(Waiter{threshold, id, std::move(callback), condition});
+        std::push_heap(waiters.begin(), waiters.end(), std::greater<>{});
+        UpdateNextThreshold();
+        return id;
+    }
+
+    bool Syncpoint::RemoveWaiter(u64 id) {
+        auto it{std::find_if(waiters.begin(), waiters.end(), [id](const Waiter &waiter) { return waiter.id == id; })};
+        if (it == waiters.end())
+            return false;
+
+        // Removal of arbitrary waiters is rare and the heap is small, so it's simply rebuilt rather than sifting the replacement
+        *it = std::move(waiters.back());
+        waiters.pop_back();
+        std::make_heap(waiters.begin(), waiters.end(), std::greater<>{});
+        UpdateNextThreshold();
+        return true;
+    }
+
     Syncpoint::WaiterHandle Syncpoint::RegisterWaiter(u32 threshold, const std::function<void()> &callback) {
         if (value.load(std::memory_order_acquire) >= threshold) {
             // (Fast path) We don't need to wait on the mutex and can just get away with atomics
@@ -13,70 +35,104 @@ namespace skyline::soc::host1x {
         }
 
         std::scoped_lock lock(mutex);
-        if (value.load(std::memory_order_acquire) >= threshold) {
+        auto id{PushWaiter(threshold, callback, nullptr)};
+
+        // An increment which raced with the insertion may have skipped the mutex as it observed the prior threshold, so the value is checked after publishing it
+        if (value.load(std::memory_order_seq_cst) >= threshold) {
+            RemoveWaiter(id);
             callback();
             return {};
         }
 
-        auto it{waiters.begin()};
-        while (it != waiters.end() && threshold >= it->threshold)
-            it++;
-        return waiters.emplace(it, threshold, callback);
+        return id;
     }
 
     void Syncpoint::DeregisterWaiter(WaiterHandle waiter) {
+        if (!waiter)
+            return;
+
         std::scoped_lock lock(mutex);
-        // We want to ensure the iterator still exists prior to erasing it
-        // Otherwise, if an invalid iterator was passed in then it could lead to UB
-        // It is important to avoid UB in that case since the deregister isn't called from a locked context
-        for (auto it{waiters.begin()}; it != waiters.end(); it++) {
-            if (it == waiter) {
-                waiters.erase(it);
-                return;
-            }
-        }
+        RemoveWaiter(waiter);
     }
 
     u32 Syncpoint::Increment() {
-        auto readValue{value.fetch_add(1, std::memory_order_acq_rel) + 1}; // We don't want to constantly do redundant atomic loads
+        auto readValue{value.fetch_add(1, std::memory_order_seq_cst) + 1}; // We don't want to constantly do redundant atomic loads
+        if (readValue < nextThreshold.load(std::memory_order_seq_cst)) [[likely]]
+            return readValue; // (Fast path) No waiter is due so we can avoid the mutex entirely
 
         std::scoped_lock lock(mutex);
-        bool signalCondition{};
-        auto it{waiters.begin()};
-        while (it != waiters.end() && readValue >= it->threshold) {
-            auto &waiter{*it};
+        u32 currentValue{value.load(std::memory_order_acquire)};
+        while (!waiters.empty() && currentValue >= waiters.front().threshold) {
+            std::pop_heap(waiters.begin(), waiters.end(), std::greater<>{});
+            auto waiter{std::move(waiters.back())};
+            waiters.pop_back();
+
             if (waiter.callback)
                 waiter.callback();
             else
-                signalCondition = true;
-            it++;
+                waiter.condition->notify_one();
         }
 
-        waiters.erase(waiters.begin(), it);
-
-        if (signalCondition)
-            incrementCondition.notify_all();
-
+        UpdateNextThreshold();
         return readValue;
     }
 
+    void Syncpoint::AttachFence(u32 threshold, std::shared_ptr<gpu::FenceCycle> cycle) {
+        std::scoped_lock lock(mutex);
+        u32 currentValue{value.load(std::memory_order_acquire)};
+        std::erase_if(pendingFences, [currentValue](const auto &fence) { return fence.first <= currentValue; });
+        if (threshold > currentValue)
+            pendingFences.emplace_back(threshold, std::move(cycle));
+    }
+
     bool Syncpoint::Wait(u32 threshold, std::chrono::steady_clock::duration timeout) {
         if (value.load(std::memory_order_acquire) >= threshold)
             // (Fast Path) We don't need to wait on the mutex and can just get away with atomics
-            return {};
+            return true;
+
+        if (timeout == std::chrono::steady_clock::duration::max()) {
+            // If the threshold will be reached by host GPU submissions then we can wait on them directly, this avoids waiting for the CPU to observe their completion and make the increment
+            std::vector<std::shared_ptr<gpu::FenceCycle>> cycles;
+            {
+                std::scoped_lock lock(mutex);
+                u32 currentValue{value.load(std::memory_order_acquire)};
+                std::erase_if(pendingFences, [currentValue](const auto &fence) { return fence.first <= currentValue; });
+
+                std::optional<u32> target;
+                for (const auto &fence : pendingFences)
+                    if (fence.first >= threshold && (!target || fence.first < *target))
+                        target = fence.first;
+
+                // Submissions from other channels may complete out of order, so all submissions up to the target need to complete for it to be reached
+                if (target)
+                    for (const auto &fence : pendingFences)
+                        if (fence.first <= *target)
+                            cycles.push_back(fence.second);
+            }
+
+            if (!cycles.empty()) {
+                for (const auto &cycle : cycles)
+                    cycle->Wait();
+                return true;
+            }
+        }
 
+        // Every blocked thread has its own condition variable so an increment only wakes the threads that are due
+        std::condition_variable condition;
         std::unique_lock lock(mutex);
-        auto it{waiters.begin()};
-        while (it != waiters.end() && threshold >= it->threshold)
-            it++;
-        waiters.emplace(it, threshold, nullptr);
+        auto id{PushWaiter(threshold, nullptr, &condition)};
 
+        auto reached{[&] { return value.load(std::memory_order_seq_cst) >= threshold; }};
+        bool result;
         if (timeout == std::chrono::steady_clock::duration::max()) {
-            incrementCondition.wait(lock, [&] { return value.load(std::memory_order_relaxed) >= threshold; });
-            return true;
+            condition.wait(lock, reached);
+            result = true;
         } else {
-            return incrementCondition.wait_for(lock, timeout, [&] { return value.load(std::memory_order_relaxed) >= threshold; });
+            result = condition.wait_for(lock, timeout, reached);
         }
+
+        // The waiter is still in the heap if the threshold was reached without the increment taking the mutex or the wait timed out, it must not outlive the condition variable
+        RemoveWaiter(id);
+        return result;
     }
 }
-
@@ -6,6 +6,10 @@
 
 #include <common.h>
 
+namespace skyline::gpu {
+    struct FenceCycle;
+}
+
 namespace skyline::soc::host1x {
     constexpr size_t SyncpointCount{192}; //!< The number of host1x syncpoints on T210
 
@@ -15,17 +19,48 @@ namespace skyline::soc::host1x {
     class Syncpoint {
       private:
         std::atomic<u32> value{}; //!< An atomically-incrementing counter at the core of a syncpoint
+        static constexpr u64 NoThreshold{std::numeric_limits<u64>::max()}; //!< A sentinel for when there are no waiters, it can never be reached by a 32-bit value
+        std::atomic<u64> nextThreshold{NoThreshold}; //!< The lowest threshold of any waiter, increments which don't reach it skip the mutex entirely
 
-        std::mutex mutex; //!< Synchronizes insertions and deletions of waiters alongside locking the increment condition
-        std::condition_variable incrementCondition; //!< Signalled on thresholds for waiters which are tied to Wait(...)
+        std::mutex mutex; //!< Synchronizes insertions and deletions of waiters
 
         struct Waiter {
             u32 threshold; //!< The syncpoint value to wait on to be reached
-            std::function<void()> callback; //!< The callback to do after the wait has ended, refers to cvar signal when nullptr
-
-            Waiter(u32 threshold, std::function<void()> callback) : threshold(threshold), callback(std::move(callback)) {}
+            u64 id; //!< A unique ID for the waiter, waiters with the same threshold are signalled in the order of their IDs
+            std::function<void()> callback; //!< The callback to do after the wait has ended, `condition` is signalled when this is nullptr
+            std::condition_variable *condition; //!< The condition variable of a thread blocked in Wait(...)
+
+            /**
+             * @brief Orders waiters so the heap is a min-heap on the threshold
+             */
+            bool operator>(const Waiter &other) const {
+                return threshold != other.threshold ? threshold > other.threshold : id > other.id;
+            }
         };
-        std::list<Waiter> waiters; //!< A linked list of all waiters, it's sorted in ascending order by threshold
+        std::vector<Waiter> waiters; //!< A min-heap of all waiters, the front is always the waiter with the lowest threshold
+        u64 nextWaiterId{1}; //!< The ID of the next waiter, 0 is reserved for invalid handles
+
+        std::vector<std::pair<u32, std::shared_ptr<gpu::FenceCycle>>> pendingFences; //!< Host GPU submissions which will lead to the syncpoint reaching the paired value once they complete, these are pruned lazily once the value is reached
+
+        /**
+         * @brief Inserts a waiter into the heap and publishes the new lowest threshold
+         * @note The mutex **must** be locked prior to calling this
+         */
+        u64 PushWaiter(u32 threshold, std::function<void()> callback, std::condition_variable *condition);
+
+        /**
+         * @brief Removes the waiter with the supplied ID from the heap if it's still in it
+         * @return If the waiter was found and removed
+         * @note The mutex **must** be locked prior to calling this
+         */
+        bool RemoveWaiter(u64 id);
+
+        /**
+         * @brief Publishes the threshold of the front of the heap for the lock-free increment check
+         */
+        void UpdateNextThreshold() {
+            nextThreshold.store(waiters.empty() ? NoThreshold : waiters.front().threshold, std::memory_order_seq_cst);
+        }
 
       public:
         /**
@@ -35,17 +70,17 @@ namespace skyline::soc::host1x {
             return value.load(std::memory_order_acquire);
         }
 
-        using WaiterHandle = decltype(waiters)::iterator; //!< Aliasing an iterator to a Waiter as an opaque handle
+        using WaiterHandle = u64; //!< The ID of a waiter as an opaque handle, 0 denotes an invalid handle
 
         /**
          * @brief Registers a new waiter with a callback that will be called when the syncpoint reaches the target threshold
          * @note The callback will be called immediately if the syncpoint has already reached the given threshold
-         * @return A handle that can be used to deregister the waiter, its boolean operator will evaluate to false if the threshold has already been reached
+         * @return A handle that can be used to deregister the waiter, it will be 0 if the threshold has already been reached
          */
         WaiterHandle RegisterWaiter(u32 threshold, const std::function<void()> &callback);
 
         /**
-         * @note If the supplied handle is invalid then the function will do nothing
+         * @note If the supplied handle is invalid or the waiter has already been signalled then the function will do nothing
          */
         void DeregisterWaiter(WaiterHandle waiter);
 
@@ -54,6 +89,12 @@ namespace skyline::soc::host1x {
          */
         u32 Increment();
 
+        /**
+         * @brief Attaches a host GPU submission that'll lead to the syncpoint reaching the supplied threshold once it completes
+         * @note Unbounded waits for any threshold up to this will wait on the submission directly rather than for the increment to be made by the CPU
+         */
+        void AttachFence(u32 threshold, std::shared_ptr<gpu::FenceCycle> cycle);
+
         /**
          * @brief Waits for the syncpoint to reach given threshold
          * @return If the wait was successful (true) or timed out (false)
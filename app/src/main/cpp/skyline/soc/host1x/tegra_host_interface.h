@@ -41,8 +41,12 @@ namespace skyline::soc::host1x {
         }
 
       public:
-        TegraHostInterface(SyncpointSet &syncpoints)
-            : deviceClass([&] { SubmitPendingIncrs(); }),
+        /**
+         * @param args Any additional arguments to construct the device class with after its OpDone callback
+         */
+        template<typename... Args>
+        TegraHostInterface(SyncpointSet &syncpoints, Args &&... args)
+            : deviceClass([&] { SubmitPendingIncrs(); }, std::forward<Args>(args)...),
               syncpoints(syncpoints) {}
 
         void CallMethod(u32 method, u32 argument)  {
@@ -61,7 +65,7 @@ namespace skyline::soc::host1x {
                         case IncrementSyncpointMethod::Condition::OpDone:
                             Logger::Debug("Queue syncpoint for OpDone: {}", incrSyncpoint.index);
                             AddIncr(incrSyncpoint.index);
-                            SubmitPendingIncrs(); // FIXME: immediately submit the incrs as classes are not yet implemented
+                            SubmitPendingIncrs(); // Class operations are executed synchronously so any operation prior to this has already completed
                             break;
                         default:
                             Logger::Warn("Unimplemented syncpoint condition: {}", static_cast<u8>(incrSyncpoint.condition));
@@ -35,6 +35,14 @@ namespace skyline::vfs {
 
         size_t size; //!< The size of the backing in bytes
 
+        /**
+         * @brief The expected pattern of accesses to a region of a backing, this is used as a hint for readahead
+         */
+        enum class AccessPattern {
+            Sequential, //!< The region will be read once from start to end
+            Random, //!< The region will be read in small chunks at arbitrary offsets
+        };
+
         /**
          * @param mode The mode to use for the backing
          * @param size The initial size of the backing
@@ -100,6 +108,20 @@ namespace skyline::vfs {
             return object;
         }
 
+        /**
+         * @brief Retrieves a view directly into the contents of the backing, this allows for reading without an intermediate copy
+         * @return A span over the requested region or an empty span if the backing isn't directly addressable or the region is out of bounds
+         * @note The view is only valid for as long as the backing is alive and must never be written to
+         */
+        virtual span<u8> GetView(size_t offset, size_t viewSize) {
+            return {};
+        }
+
+        /**
+         * @brief Hints the expected pattern of accesses to a region of the backing, this is a no-op for backings which don't benefit from it
+         */
+        virtual void Advise(AccessPattern pattern, size_t offset, size_t adviseSize) {}
+
         /**
          * @brief Writes from a buffer to a particular offset in the backing
          * @param input The data to write to the backing
@@ -0,0 +1,31 @@
+// SPDX-License-Identifier: MPL-2.0
+// Copyright © 2023 Skyline Team and Contributors (https://github.com/skyline-emu/)
+
+#include <fmt/ranges.h>
+#include "cnmt.h"
+
+namespace skyline::vfs {
+    CNMT::CNMT(const std::shared_ptr<FileSystem> &cnmt) {
+        auto root{cnmt->OpenDirectory("", {false, true})};
+        for (const auto &entry : root->Read()) {
+            if (!entry.name.ends_with(".cnmt"))
+                continue;
+
+            auto backing{cnmt->OpenFile(entry.name)};
+            header = backing->Read<PackagedContentMetaHeader>();
+
+            contents.resize(header.contentCount);
+            backing->Read(span(contents), sizeof(PackagedContentMetaHeader) + header.extendedHeaderSize);
+            return;
+        }
+
+        throw exception("Meta NCA doesn't contain a CNMT");
+    }
+
+    std::optional<std::string> CNMT::GetContentFileName(ContentType type) {
+        for (const auto &content : contents)
+            if (content.contentType == type)
+                return fmt::format("{:02x}.nca", fmt::join(content.contentId, ""));
+        return std::nullopt;
+    }
+}
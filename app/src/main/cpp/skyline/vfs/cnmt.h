@@ -0,0 +1,84 @@
+// SPDX-License-Identifier: MPL-2.0
+// Copyright © 2023 Skyline Team and Contributors (https://github.com/skyline-emu/)
+
+#pragma once
+
+#include "filesystem.h"
+
+namespace skyline::vfs {
+    /**
+     * @brief The CNMT class parses the content meta of a title, this lists every NCA the title consists of alongside its type
+     * @url https://switchbrew.org/wiki/CNMT
+     */
+    class CNMT {
+      public:
+        enum class ContentMetaType : u8 {
+            SystemProgram = 0x01,
+            SystemData = 0x02,
+            SystemUpdate = 0x03,
+            BootImagePackage = 0x04,
+            BootImagePackageSafe = 0x05,
+            Application = 0x80,
+            Patch = 0x81,
+            AddOnContent = 0x82,
+            Delta = 0x83,
+        };
+
+        enum class ContentType : u8 {
+            Meta = 0x0,
+            Program = 0x1,
+            Data = 0x2,
+            Control = 0x3,
+            HtmlDocument = 0x4,
+            LegalInformation = 0x5,
+            DeltaFragment = 0x6,
+        };
+
+      private:
+        struct PackagedContentMetaHeader {
+            u64 titleId;
+            u32 version;
+            ContentMetaType type;
+            u8 _pad0_;
+            u16 extendedHeaderSize; //!< The size of the type-specific header which follows this one
+            u16 contentCount;
+            u16 contentMetaCount;
+            u8 contentMetaAttributes;
+            u8 _pad1_[0x3];
+            u32 requiredDownloadSystemVersion;
+            u8 _pad2_[0x4];
+        };
+        static_assert(sizeof(PackagedContentMetaHeader) == 0x20);
+
+        struct PackagedContentInfo {
+            std::array<u8, 0x20> hash; //!< A SHA-256 hash over the NCA
+            std::array<u8, 0x10> contentId; //!< The content ID of the NCA, this is the first half of the hash and is used as its filename
+            std::array<u8, 0x6> size;
+            ContentType contentType;
+            u8 idOffset;
+        };
+        static_assert(sizeof(PackagedContentInfo) == 0x38);
+
+        PackagedContentMetaHeader header{};
+        std::vector<PackagedContentInfo> contents;
+
+      public:
+        /**
+         * @param cnmt The PFS0 filesystem of a meta NCA, it should contain a single .cnmt file
+         */
+        CNMT(const std::shared_ptr<FileSystem> &cnmt);
+
+        ContentMetaType GetContentMetaType() {
+            return header.type;
+        }
+
+        u64 GetTitleId() {
+            return header.titleId;
+        }
+
+        /**
+         * @return The filename of the first NCA of the supplied type in the title, if there is one
+         */
+        std::optional<std::string> GetContentFileName(ContentType type);
+    };
+}
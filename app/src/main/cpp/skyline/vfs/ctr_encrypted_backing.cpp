@@ -1,24 +1,75 @@
 // SPDX-License-Identifier: MPL-2.0
 // Copyright © 2020 Skyline Team and Contributors (https://github.com/skyline-emu/)
 
+#include "decrypted_block_cache.h"
 #include "ctr_encrypted_backing.h"
 
 namespace skyline::vfs {
     constexpr size_t SectorSize{0x10};
+    constexpr size_t StreamThreshold{4 * DecryptedBlockCache::BlockSize}; //!< The amount of data that must be read sequentially before reads are considered to be a stream which bypasses the cache
 
     CtrEncryptedBacking::CtrEncryptedBacking(crypto::KeyStore::Key128 ctr, crypto::KeyStore::Key128 key, std::shared_ptr<Backing> backing, size_t baseOffset) : Backing({true, false, false}, backing->size), ctr(ctr), cipher(key, MBEDTLS_CIPHER_AES_128_CTR), backing(std::move(backing)), baseOffset(baseOffset) {
         if (mode.write || mode.append)
             throw exception("Cannot open a CtrEncryptedBacking as writable");
+
+        if (crypto::AesCtrCipher::IsSupported())
+            hardwareCipher.emplace(key);
+    }
+
+    CtrEncryptedBacking::~CtrEncryptedBacking() {
+        DecryptedBlockCache::Get().Evict(this);
     }
 
-    void CtrEncryptedBacking::UpdateCtr(u64 offset) {
-        offset >>= 4;
-        size_t le{util::SwapEndianness(offset)};
-        std::memcpy(ctr.data() + 8, &le, 8);
-        cipher.SetIV(ctr);
+    crypto::KeyStore::Key128 CtrEncryptedBacking::GetCtr(u64 offset) const {
+        auto blockCtr{ctr};
+        u64 be{util::SwapEndianness(offset >> 4)};
+        std::memcpy(blockCtr.data() + 8, &be, 8);
+        return blockCtr;
+    }
+
+    void CtrEncryptedBacking::Decrypt(span<u8> data, size_t offset) {
+        if (hardwareCipher) [[likely]] {
+            hardwareCipher->Process(data, GetCtr(baseOffset + offset));
+        } else {
+            std::scoped_lock guard{mutex};
+            cipher.SetIV(GetCtr(baseOffset + offset));
+            cipher.Decrypt(data);
+        }
     }
 
     size_t CtrEncryptedBacking::ReadImpl(span<u8> output, size_t offset) {
+        // Only small reads are admitted into the cache, large reads and streams of sequential reads are unlikely to be reused and would only evict useful blocks
+        size_t run{lastReadEnd.exchange(offset + output.size(), std::memory_order_relaxed) == offset ? sequentialRun.load(std::memory_order_relaxed) + output.size() : output.size()};
+        sequentialRun.store(run, std::memory_order_relaxed);
+
+        if (output.size() < DecryptedBlockCache::BlockSize && run < StreamThreshold)
+            return ReadCached(output, offset);
+        return ReadUncached(output, offset);
+    }
+
+    size_t CtrEncryptedBacking::ReadCached(span<u8> output, size_t offset) {
+        auto &cache{DecryptedBlockCache::Get()};
+        size_t end{std::min(offset + output.size(), size)};
+        size_t position{offset};
+        while (position < end) {
+            size_t blockOffset{util::AlignDown(position, DecryptedBlockCache::BlockSize)};
+            auto block{cache.Lookup(this, blockOffset)};
+            if (!block) {
+                auto decrypted{std::make_shared<std::vector<u8>>(std::min(DecryptedBlockCache::BlockSize, size - blockOffset))};
+                if (ReadUncached(*decrypted, blockOffset) != decrypted->size())
+                    return position - offset;
+                cache.Insert(this, blockOffset, decrypted);
+                block = std::move(decrypted);
+            }
+
+            size_t copySize{std::min(end, blockOffset + block->size()) - position};
+            std::memcpy(output.data() + (position - offset), block->data() + (position - blockOffset), copySize);
+            position += copySize;
+        }
+        return position - offset;
+    }
+
+    size_t CtrEncryptedBacking::ReadUncached(span<u8> output, size_t offset) {
         size_t size{output.size()};
         if (size == 0)
             return 0;
@@ -28,24 +79,16 @@ namespace skyline::vfs {
             size_t read{backing->ReadUnchecked(output, offset)};
             if (read != size)
                 return 0;
-            {
-                std::scoped_lock guard{mutex};
-                UpdateCtr(baseOffset + offset);
-                cipher.Decrypt(output);
-            }
+            Decrypt(output, offset);
             return size;
         }
 
         size_t sectorStart{offset - sectorOffset};
-        std::vector<u8> blockBuf(SectorSize);
+        std::array<u8, SectorSize> blockBuf;
         size_t read{backing->ReadUnchecked(blockBuf, sectorStart)};
         if (read != SectorSize)
             return 0;
-        {
-            std::scoped_lock guard{mutex};
-            UpdateCtr(baseOffset + sectorStart);
-            cipher.Decrypt(blockBuf);
-        }
+        Decrypt(blockBuf, sectorStart);
         if (size + sectorOffset < SectorSize) {
             std::memcpy(output.data(), blockBuf.data() + sectorOffset, size);
             return size;
@@ -53,6 +96,6 @@ namespace skyline::vfs {
 
         size_t readInBlock{SectorSize - sectorOffset};
         std::memcpy(output.data(), blockBuf.data() + sectorOffset, readInBlock);
-        return readInBlock + ReadUnchecked(output.subspan(readInBlock), offset + readInBlock);
+        return readInBlock + ReadUncached(output.subspan(readInBlock), offset + readInBlock);
     }
 }
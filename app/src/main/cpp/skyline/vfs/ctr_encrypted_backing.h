@@ -4,6 +4,7 @@
 #pragma once
 
 #include <crypto/aes_cipher.h>
+#include <crypto/aes_ctr.h>
 #include <crypto/key_store.h>
 #include "backing.h"
 
@@ -14,20 +15,40 @@ namespace skyline::vfs {
     class CtrEncryptedBacking : public Backing {
       private:
         crypto::KeyStore::Key128 ctr;
-        crypto::AesCipher cipher;
+        crypto::AesCipher cipher; //!< The mbedtls cipher used as a fallback when the AES instructions aren't supported
+        std::optional<crypto::AesCtrCipher> hardwareCipher; //!< A stateless cipher using the ARMv8 AES instructions, this is used over the mbedtls cipher when available
         std::shared_ptr<Backing> backing;
         std::mutex mutex; //!< Synchronize all AES-CTR cipher state modifications
         size_t baseOffset; //!< The offset of the backing into the file is used to calculate the IV
+        std::atomic<size_t> lastReadEnd{}; //!< The offset at which the previous read ended, this is used to detect sequential streams
+        std::atomic<size_t> sequentialRun{}; //!< The amount of bytes that have been read sequentially up to the previous read
 
         /**
-         * @brief Calculates IV based on the offset
+         * @return The counter of the block at the supplied offset
          */
-        void UpdateCtr(u64 offset);
+        crypto::KeyStore::Key128 GetCtr(u64 offset) const;
+
+        /**
+         * @brief Decrypts data in-place which starts at the supplied block-aligned offset
+         */
+        void Decrypt(span<u8> data, size_t offset);
+
+        /**
+         * @brief Reads and decrypts data directly from the underlying backing
+         */
+        size_t ReadUncached(span<u8> output, size_t offset);
+
+        /**
+         * @brief Reads data through the decrypted block cache, decrypting and caching any blocks that aren't cached yet
+         */
+        size_t ReadCached(span<u8> output, size_t offset);
 
       protected:
         size_t ReadImpl(span<u8> output, size_t offset) override;
 
       public:
         CtrEncryptedBacking(crypto::KeyStore::Key128 ctr, crypto::KeyStore::Key128 key, std::shared_ptr<Backing> backing, size_t baseOffset);
+
+        ~CtrEncryptedBacking();
     };
 }
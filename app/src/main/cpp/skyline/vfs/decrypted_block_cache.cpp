@@ -0,0 +1,54 @@
+// SPDX-License-Identifier: MPL-2.0
+// Copyright © 2022 Skyline Team and Contributors (https://github.com/skyline-emu/)
+
+#include "decrypted_block_cache.h"
+
+namespace skyline::vfs {
+    DecryptedBlockCache::Block DecryptedBlockCache::Lookup(const void *owner, size_t offset) {
+        Key key{owner, offset};
+        auto &shard{GetShard(key)};
+        std::scoped_lock lock{shard.mutex};
+
+        auto it{shard.map.find(key)};
+        if (it == shard.map.end())
+            return nullptr;
+
+        shard.blocks.splice(shard.blocks.begin(), shard.blocks, it->second);
+        return it->second->second;
+    }
+
+    void DecryptedBlockCache::Insert(const void *owner, size_t offset, Block block) {
+        Key key{owner, offset};
+        auto &shard{GetShard(key)};
+        std::scoped_lock lock{shard.mutex};
+
+        auto it{shard.map.find(key)};
+        if (it != shard.map.end()) {
+            // Another thread might've inserted the same block while this one was decrypting it
+            shard.blocks.splice(shard.blocks.begin(), shard.blocks, it->second);
+            return;
+        }
+
+        if (shard.blocks.size() >= ShardCapacity) {
+            shard.map.erase(shard.blocks.back().first);
+            shard.blocks.pop_back();
+        }
+
+        shard.blocks.emplace_front(key, std::move(block));
+        shard.map.emplace(key, shard.blocks.begin());
+    }
+
+    void DecryptedBlockCache::Evict(const void *owner) {
+        for (auto &shard : shards) {
+            std::scoped_lock lock{shard.mutex};
+            for (auto it{shard.blocks.begin()}; it != shard.blocks.end();) {
+                if (it->first.owner == owner) {
+                    shard.map.erase(it->first);
+                    it = shard.blocks.erase(it);
+                } else {
+                    ++it;
+                }
+            }
+        }
+    }
+}
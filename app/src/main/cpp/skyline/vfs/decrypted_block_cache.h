@@ -0,0 +1,73 @@
+// SPDX-License-Identifier: MPL-2.0
+// Copyright © 2022 Skyline Team and Contributors (https://github.com/skyline-emu/)
+
+#pragma once
+
+#include <list>
+#include <common.h>
+
+namespace skyline::vfs {
+    /**
+     * @brief A bounded LRU cache of decrypted blocks shared between all encrypted backings, this avoids repeatedly reading and decrypting regions such as archive headers that games read over and over
+     * @note The cache is split into independently locked shards so concurrent readers rarely contend on the same lock
+     */
+    class DecryptedBlockCache {
+      public:
+        static constexpr size_t BlockSize{0x8000}; //!< The size of a single cached block, all blocks are aligned to this
+        using Block = std::shared_ptr<const std::vector<u8>>;
+
+      private:
+        static constexpr size_t ShardCount{8};
+        static constexpr size_t CacheSize{32 * 1024 * 1024}; //!< The maximum amount of decrypted data that's cached across all shards
+        static constexpr size_t ShardCapacity{CacheSize / BlockSize / ShardCount}; //!< The maximum amount of blocks in a single shard
+
+        struct Key {
+            const void *owner; //!< The backing which the block belongs to
+            size_t offset; //!< The block-aligned offset of the block in the backing
+
+            bool operator==(const Key &) const = default;
+        };
+
+        struct KeyHash {
+            size_t operator()(const Key &key) const {
+                return std::hash<const void *>{}(key.owner) ^ (std::hash<size_t>{}(key.offset / BlockSize) * 0x9E3779B97F4A7C15);
+            }
+        };
+
+        struct Shard {
+            std::mutex mutex;
+            std::list<std::pair<Key, Block>> blocks; //!< All blocks in the shard ordered from the most to the least recently used
+            std::unordered_map<Key, std::list<std::pair<Key, Block>>::iterator, KeyHash> map;
+        };
+
+        std::array<Shard, ShardCount> shards;
+
+        Shard &GetShard(const Key &key) {
+            return shards[KeyHash{}(key) % ShardCount];
+        }
+
+      public:
+        /**
+         * @return The cache shared by all backings
+         */
+        static DecryptedBlockCache &Get() {
+            static DecryptedBlockCache cache;
+            return cache;
+        }
+
+        /**
+         * @return The cached block at the supplied block-aligned offset of the owner or nullptr if it isn't cached
+         */
+        Block Lookup(const void *owner, size_t offset);
+
+        /**
+         * @brief Inserts a block into the cache, evicting the least recently used block in its shard if it's full
+         */
+        void Insert(const void *owner, size_t offset, Block block);
+
+        /**
+         * @brief Removes all blocks belonging to the supplied owner, this must be called prior to the owner being destroyed as its address may be reused
+         */
+        void Evict(const void *owner);
+    };
+}
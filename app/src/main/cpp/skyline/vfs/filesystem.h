@@ -36,6 +36,10 @@ namespace skyline::vfs {
             throw exception("This filesystem does not support opening directories");
         };
 
+        virtual bool CommitImpl() {
+            return true;
+        }
+
       public:
         FileSystem() = default;
 
@@ -152,5 +156,13 @@ namespace skyline::vfs {
         std::shared_ptr<Directory> OpenDirectory(const std::string &path, Directory::ListMode listMode = {true, true}) {
             return OpenDirectoryUnchecked(path, listMode);
         };
+
+        /**
+         * @brief Commits any writes that are pending in the filesystem to the underlying storage, this does nothing for filesystems that write through
+         * @return Whether committing succeeded
+         */
+        bool Commit() {
+            return CommitImpl();
+        }
     };
 }
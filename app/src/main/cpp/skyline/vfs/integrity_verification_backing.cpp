@@ -0,0 +1,76 @@
+// SPDX-License-Identifier: MPL-2.0
+// Copyright © 2023 Skyline Team and Contributors (https://github.com/skyline-emu/)
+
+#include "integrity_verification_backing.h"
+
+namespace skyline::vfs {
+    IntegrityVerificationBacking::IntegrityVerificationBacking(std::shared_ptr<Backing> pBacking, span<const LevelInfo> pLevels, const crypto::Sha256Hash &masterHash) : Backing{{true, false, false}, pLevels.empty() ? 0 : pLevels.back().size}, backing{std::move(pBacking)}, masterHash{masterHash} {
+        if (pLevels.empty())
+            throw exception("Cannot verify a hash tree without any levels");
+
+        for (const auto &levelInfo : pLevels) {
+            if (!levelInfo.blockSize || levelInfo.offset + levelInfo.size > backing->size)
+                throw exception("Invalid hash tree level: 0x{:X} bytes at 0x{:X} with 0x{:X} byte blocks", levelInfo.size, levelInfo.offset, levelInfo.blockSize);
+
+            Level level{levelInfo};
+            level.verifiedBlocks.resize(util::DivideCeil<size_t>(util::DivideCeil<size_t>(levelInfo.size, levelInfo.blockSize), 64));
+            levels.push_back(std::move(level));
+        }
+    }
+
+    bool IntegrityVerificationBacking::IsVerified(const Level &level, size_t block) {
+        std::scoped_lock lock{mutex};
+        return level.verifiedBlocks[block / 64] & (1ULL << (block % 64));
+    }
+
+    crypto::Sha256Hash IntegrityVerificationBacking::GetExpectedHash(size_t levelIndex, size_t block) {
+        if (levelIndex == 0) {
+            if (block != 0)
+                throw exception("The first level of the hash tree must only contain a single block: 0x{:X}", block);
+            return masterHash;
+        }
+
+        crypto::Sha256Hash hash;
+        ReadLevel(levelIndex - 1, hash, block * sizeof(crypto::Sha256Hash));
+        return hash;
+    }
+
+    void IntegrityVerificationBacking::ReadLevel(size_t levelIndex, span<u8> output, size_t offset) {
+        auto &level{levels[levelIndex]};
+        size_t end{offset + output.size()};
+        std::vector<u8> blockBuffer;
+        for (size_t block{offset / level.blockSize}, blockOffset{block * level.blockSize}; blockOffset < end; block++, blockOffset += level.blockSize) {
+            size_t copyStart{std::max(offset, blockOffset)}, copyEnd{std::min(end, blockOffset + level.blockSize)};
+            auto copyOutput{output.subspan(copyStart - offset, copyEnd - copyStart)};
+
+            if (IsVerified(level, block)) {
+                backing->Read(copyOutput, level.offset + copyStart);
+                continue;
+            }
+
+            // The hash of the final block of a level covers the block padded with zeroes to the full block size
+            blockBuffer.assign(level.blockSize, 0);
+            size_t blockDataSize{std::min(level.blockSize, level.size - blockOffset)};
+            backing->Read(span(blockBuffer).first(blockDataSize), level.offset + blockOffset);
+
+            if (crypto::Sha256(blockBuffer) != GetExpectedHash(levelIndex, block))
+                throw exception("Integrity verification failed for block 0x{:X} of level {} (0x{:X} bytes at 0x{:X}), the dump is likely corrupted", block, levelIndex, blockDataSize, level.offset + blockOffset);
+
+            {
+                std::scoped_lock lock{mutex};
+                level.verifiedBlocks[block / 64] |= 1ULL << (block % 64);
+            }
+
+            std::memcpy(copyOutput.data(), blockBuffer.data() + (copyStart - blockOffset), copyOutput.size());
+        }
+    }
+
+    size_t IntegrityVerificationBacking::ReadImpl(span<u8> output, size_t offset) {
+        if (offset >= size)
+            return 0;
+
+        output = output.first(std::min(output.size(), size - offset));
+        ReadLevel(levels.size() - 1, output, offset);
+        return output.size();
+    }
+}
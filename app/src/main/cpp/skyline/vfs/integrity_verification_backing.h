@@ -0,0 +1,57 @@
+// SPDX-License-Identifier: MPL-2.0
+// Copyright © 2023 Skyline Team and Contributors (https://github.com/skyline-emu/)
+
+#pragma once
+
+#include <crypto/sha256.h>
+#include "backing.h"
+
+namespace skyline::vfs {
+    /**
+     * @brief A backing which verifies the data level of a hierarchical integrity (IVFC) hash tree against the master hash as it's read
+     * @details Every block is only verified on the first read of it, including the blocks of the hash levels that the expected hashes are read from, a bitmap of verified blocks is kept for each level so subsequent reads go directly to the underlying backing
+     * @note A block which fails verification results in an exception being thrown from the read
+     */
+    class IntegrityVerificationBacking : public Backing {
+      public:
+        /**
+         * @brief The location of a single level of the hash tree in the underlying backing
+         */
+        struct LevelInfo {
+            size_t offset;
+            size_t size;
+            size_t blockSize;
+        };
+
+      private:
+        struct Level : LevelInfo {
+            std::vector<u64> verifiedBlocks; //!< A bitmap of all blocks in the level that have been verified, this is protected by `mutex`
+        };
+
+        std::shared_ptr<Backing> backing; //!< The backing of the entire section that contains the hash tree, this must already be decrypted
+        std::vector<Level> levels; //!< All levels of the hash tree in order, the last level is the data level that's exposed by this backing
+        crypto::Sha256Hash masterHash; //!< The hash of the sole block of the first level
+        std::mutex mutex;
+
+        bool IsVerified(const Level &level, size_t block);
+
+        /**
+         * @return The hash that a block of the supplied level is expected to have, this is read from the prior level which is verified in the process
+         */
+        crypto::Sha256Hash GetExpectedHash(size_t levelIndex, size_t block);
+
+        /**
+         * @brief Reads data from a level of the hash tree, any blocks that haven't been verified yet are read in their entirety and verified
+         */
+        void ReadLevel(size_t levelIndex, span<u8> output, size_t offset);
+
+      protected:
+        size_t ReadImpl(span<u8> output, size_t offset) override;
+
+      public:
+        /**
+         * @param levels The levels of the hash tree from the first hash level to the data level
+         */
+        IntegrityVerificationBacking(std::shared_ptr<Backing> backing, span<const LevelInfo> levels, const crypto::Sha256Hash &masterHash);
+    };
+}
@@ -1,10 +1,16 @@
 // SPDX-License-Identifier: MPL-2.0
 // Copyright © 2020 Skyline Team and Contributors (https://github.com/skyline-emu/)
 
+#include <fcntl.h>
+#include <filesystem>
+#include <fstream>
+#include <xxhash.h>
 #include <crypto/aes_cipher.h>
 #include <loader/loader.h>
 
 #include "ctr_encrypted_backing.h"
+#include "integrity_verification_backing.h"
+#include "os_backing.h"
 #include "region_backing.h"
 #include "partition_filesystem.h"
 #include "nca.h"
@@ -41,7 +47,7 @@ namespace skyline::vfs {
             if (sectionHeader.fsType == NcaSectionFsType::PFS0 && sectionHeader.hashType == NcaSectionHashType::HierarchicalSha256)
                 ReadPfs0(sectionHeader, sectionEntry);
             else if (sectionHeader.fsType == NcaSectionFsType::RomFs && sectionHeader.hashType == NcaSectionHashType::HierarchicalIntegrity)
-                ReadRomFs(sectionHeader, sectionEntry);
+                ReadRomFs(sectionHeader, sectionEntry, i);
         }
     }
 
@@ -49,12 +55,15 @@ namespace skyline::vfs {
         size_t offset{static_cast<size_t>(entry.startOffset) * constant::MediaUnitSize + sectionHeader.sha256HashInfo.pfs0Offset};
         size_t size{constant::MediaUnitSize * static_cast<size_t>(entry.endOffset - entry.startOffset)};
 
-        auto pfs{std::make_shared<PartitionFileSystem>(CreateBacking(sectionHeader, std::make_shared<RegionBacking>(backing, offset, size), offset))};
+        auto sectionBacking{CreateBacking(sectionHeader, std::make_shared<RegionBacking>(backing, offset, size), offset)};
+        auto pfs{std::make_shared<PartitionFileSystem>(sectionBacking)};
 
         if (contentType == NcaContentType::Program) {
             // An ExeFS must always contain an NPDM and a main NSO, whereas the logo section will always contain a logo and a startup movie
-            if (pfs->FileExists("main") && pfs->FileExists("main.npdm"))
+            if (pfs->FileExists("main") && pfs->FileExists("main.npdm")) {
                 exeFs = std::move(pfs);
+                exeFsBacking = std::move(sectionBacking);
+            }
             else if (pfs->FileExists("NintendoLogo.png") && pfs->FileExists("StartupMovie.gif"))
                 logo = std::move(pfs);
         } else if (contentType == NcaContentType::Meta) {
@@ -62,11 +71,45 @@ namespace skyline::vfs {
         }
     }
 
-    void NCA::ReadRomFs(const NcaSectionHeader &sectionHeader, const NcaFsEntry &entry) {
+    void NCA::ReadRomFs(const NcaSectionHeader &sectionHeader, const NcaFsEntry &entry, size_t sectionIndex) {
         size_t offset{static_cast<size_t>(entry.startOffset) * constant::MediaUnitSize + sectionHeader.integrityHashInfo.levels.back().offset};
         size_t size{sectionHeader.integrityHashInfo.levels.back().size};
 
         romFs = CreateBacking(sectionHeader, std::make_shared<RegionBacking>(backing, offset, size), offset);
+        romFsSectionIndex = sectionIndex;
+    }
+
+    void NCA::VerifyRomFsIntegrity() {
+        if (!romFs)
+            return;
+
+        const auto &sectionHeader{header.sectionHeaders.at(romFsSectionIndex)};
+        const auto &entry{header.fsEntries.at(romFsSectionIndex)};
+        const auto &hashInfo{sectionHeader.integrityHashInfo};
+
+        // The level count includes the master hash which isn't stored as a level, the data level is always the last one
+        if (hashInfo.magic != util::MakeMagic<u32>("IVFC") || hashInfo.numLevels < 2 || hashInfo.numLevels - 1 > hashInfo.levels.size() || hashInfo.masterHashSize != sizeof(crypto::Sha256Hash)) {
+            Logger::Warn("Cannot verify the RomFS of {:016X} as its hash tree is unsupported", header.programId);
+            return;
+        }
+
+        std::vector<IntegrityVerificationBacking::LevelInfo> levels;
+        for (size_t i{hashInfo.levels.size() - (hashInfo.numLevels - 1)}; i < hashInfo.levels.size(); i++)
+            levels.push_back({
+                .offset = hashInfo.levels[i].offset,
+                .size = hashInfo.levels[i].size,
+                .blockSize = 1ULL << hashInfo.levels[i].blockSize, // The block size is stored as a power of two
+            });
+
+        // The hash levels precede the data level in the section, the entire section is decrypted together so the levels can be read from it
+        size_t offset{static_cast<size_t>(entry.startOffset) * constant::MediaUnitSize};
+        size_t size{constant::MediaUnitSize * static_cast<size_t>(entry.endOffset - entry.startOffset)};
+        try {
+            auto sectionBacking{CreateBacking(sectionHeader, std::make_shared<RegionBacking>(backing, offset, size), offset)};
+            romFs = std::make_shared<IntegrityVerificationBacking>(std::move(sectionBacking), levels, hashInfo.masterHash);
+        } catch (const std::exception &e) {
+            Logger::Warn("Cannot verify the RomFS of {:016X}: {}", header.programId, e.what());
+        }
     }
 
     std::shared_ptr<Backing> NCA::CreateBacking(const NcaSectionHeader &sectionHeader, std::shared_ptr<Backing> rawBacking, size_t offset) {
@@ -93,6 +136,81 @@ namespace skyline::vfs {
         }
     }
 
+    void NCA::UseDecryptedContainer(const std::string &directory) {
+        if (!encrypted || !romFs || !exeFsBacking)
+            return;
+
+        auto path{fmt::format("{}{:016X}.bin", directory, header.programId)};
+        u64 hash{XXH64(&header, sizeof(NcaHeader), backing->size)};
+
+        auto openContainer{[&]() -> bool {
+            int fd{open(path.c_str(), O_RDONLY | O_CLOEXEC)};
+            if (fd == -1)
+                return false;
+
+            auto container{std::make_shared<OsBacking>(fd, true, Backing::Mode{true, false, false}, true)};
+            if (container->size < sizeof(DecryptedContainerHeader))
+                return false;
+
+            auto containerHeader{container->Read<DecryptedContainerHeader>()};
+            if (containerHeader.magic != DecryptedContainerHeader{}.magic || containerHeader.version != DecryptedContainerHeader{}.version || containerHeader.hash != hash)
+                return false;
+            if (containerHeader.romFsOffset + containerHeader.romFsSize > container->size || containerHeader.exeFsOffset + containerHeader.exeFsSize > container->size)
+                return false;
+
+            romFs = std::make_shared<RegionBacking>(container, containerHeader.romFsOffset, containerHeader.romFsSize);
+            exeFsBacking = std::make_shared<RegionBacking>(container, containerHeader.exeFsOffset, containerHeader.exeFsSize);
+            exeFs = std::make_shared<PartitionFileSystem>(exeFsBacking);
+            return true;
+        }};
+
+        try {
+            if (openContainer())
+                return;
+
+            // The container is written to a temporary file first so an interrupted write never leaves behind a truncated container with a valid header
+            auto tempPath{path + ".tmp"};
+            std::filesystem::create_directories(std::filesystem::path{path}.parent_path());
+            {
+                std::ofstream stream{tempPath, std::ios::binary | std::ios::trunc};
+                if (!stream)
+                    throw exception("Failed to create '{}'", tempPath);
+
+                DecryptedContainerHeader containerHeader{
+                    .hash = hash,
+                    .romFsOffset = util::AlignUp(sizeof(DecryptedContainerHeader), constant::PageSize),
+                    .romFsSize = romFs->size,
+                };
+                containerHeader.exeFsOffset = util::AlignUp(containerHeader.romFsOffset + containerHeader.romFsSize, constant::PageSize);
+                containerHeader.exeFsSize = exeFsBacking->size;
+
+                std::vector<u8> buffer(0x400000);
+                auto writeSection{[&](const std::shared_ptr<Backing> &section, size_t sectionOffset) {
+                    stream.seekp(static_cast<std::streamoff>(sectionOffset));
+                    for (size_t offset{}; offset < section->size; offset += buffer.size()) {
+                        auto chunk{span(buffer).first(std::min(buffer.size(), section->size - offset))};
+                        section->Read(chunk, offset);
+                        stream.write(reinterpret_cast<const char *>(chunk.data()), static_cast<std::streamsize>(chunk.size()));
+                    }
+                }};
+
+                writeSection(romFs, containerHeader.romFsOffset);
+                writeSection(exeFsBacking, containerHeader.exeFsOffset);
+                stream.seekp(0);
+                stream.write(reinterpret_cast<const char *>(&containerHeader), sizeof(DecryptedContainerHeader));
+                if (!stream)
+                    throw exception("Failed to write '{}'", tempPath);
+            }
+            std::filesystem::rename(tempPath, path);
+
+            if (!openContainer())
+                throw exception("Failed to open the written container");
+            Logger::Info("Created decrypted container for {:016X}", header.programId);
+        } catch (const std::exception &e) {
+            Logger::Warn("Failed to use decrypted container for {:016X}: {}", header.programId, e.what());
+        }
+    }
+
     u8 NCA::GetKeyGeneration() {
         u8 legacyGen{static_cast<u8>(header.legacyKeyGenerationType)};
         u8 gen{static_cast<u8>(header.keyGenerationType)};
@@ -169,15 +169,30 @@ namespace skyline {
             } header{};
             static_assert(sizeof(NcaHeader) == 0xC00);
 
+            /**
+             * @brief The header of a container holding the decrypted RomFS and ExeFS sections of an NCA, the sections are stored uncompressed at page-aligned offsets so they can be mapped directly
+             */
+            struct DecryptedContainerHeader {
+                u32 magic{util::MakeMagic<u32>("DNCA")};
+                u32 version{1};
+                u64 hash; //!< A hash of the NCA header and size, a container with a mismatching hash is stale
+                u64 romFsOffset;
+                u64 romFsSize;
+                u64 exeFsOffset;
+                u64 exeFsSize;
+            };
+
             std::shared_ptr<Backing> backing;
+            std::shared_ptr<Backing> exeFsBacking; //!< The backing for the ExeFS section, this is retained for writing it into a decrypted container
             std::shared_ptr<crypto::KeyStore> keyStore;
             bool encrypted{false};
             bool rightsIdEmpty;
             bool useKeyArea;
+            size_t romFsSectionIndex{}; //!< The index of the section that holds the RomFS, this is only valid if `romFs` was read from the NCA
 
             void ReadPfs0(const NcaSectionHeader &sectionHeader, const NcaFsEntry &entry);
 
-            void ReadRomFs(const NcaSectionHeader &sectionHeader, const NcaFsEntry &entry);
+            void ReadRomFs(const NcaSectionHeader &sectionHeader, const NcaFsEntry &entry, size_t sectionIndex);
 
             std::shared_ptr<Backing> CreateBacking(const NcaSectionHeader &sectionHeader, std::shared_ptr<Backing> rawBacking, size_t offset);
 
@@ -195,6 +210,19 @@ namespace skyline {
             NcaContentType contentType; //!< The content type of the NCA
 
             NCA(std::shared_ptr<vfs::Backing> backing, std::shared_ptr<crypto::KeyStore> keyStore, bool useKeyArea = false);
+
+            /**
+             * @brief Replaces the RomFS and ExeFS with ones read from a container of their decrypted contents, the container is created from this NCA if it doesn't exist or is stale
+             * @param directory The directory that containers are stored in, they're named after the program ID of the NCA
+             * @note This does nothing for unencrypted NCAs or ones which lack either section, any errors fall back to the encrypted sections
+             */
+            void UseDecryptedContainer(const std::string &directory);
+
+            /**
+             * @brief Replaces the RomFS with a backing that verifies every block against the hierarchical integrity hash tree of its section when it's first read
+             * @note This must be called prior to UseDecryptedContainer as the container doesn't retain the hash tree, the container is then created from verified data
+             */
+            void VerifyRomFsIntegrity();
         };
     }
 }
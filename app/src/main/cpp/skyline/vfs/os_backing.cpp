@@ -4,23 +4,61 @@
 #include <sys/types.h>
 #include <sys/stat.h>
 #include <unistd.h>
+#include <sys/mman.h>
 #include "os_backing.h"
 
 namespace skyline::vfs {
-    OsBacking::OsBacking(int fd, bool closable, Mode mode) : Backing(mode), fd(fd), closable(closable) {
+    OsBacking::OsBacking(int fd, bool closable, Mode mode, bool map) : Backing(mode), fd(fd), closable(closable) {
         struct stat fileInfo;
         if (fstat(fd, &fileInfo))
             throw exception("Failed to stat fd: {}", strerror(errno));
 
         size = static_cast<size_t>(fileInfo.st_size);
+
+        // Writable backings are never mapped as their size can change underneath the mapping
+        if (map && !mode.write && !mode.append && size) {
+            void *address{mmap(nullptr, size, PROT_READ, MAP_SHARED, fd, 0)};
+            if (address != MAP_FAILED)
+                mapping = span<u8>{reinterpret_cast<u8 *>(address), size};
+            else
+                Logger::Warn("Failed to map fd, falling back to pread: {}", strerror(errno));
+        }
     }
 
     OsBacking::~OsBacking() {
+        if (mapping.valid())
+            munmap(mapping.data(), mapping.size());
         if (closable)
             close(fd);
     }
 
+    span<u8> OsBacking::GetView(size_t offset, size_t viewSize) {
+        if (!mapping.valid() || offset > mapping.size() || mapping.size() - offset < viewSize)
+            return {};
+        return mapping.subspan(offset, viewSize);
+    }
+
+    void OsBacking::Advise(AccessPattern pattern, size_t offset, size_t adviseSize) {
+        if (!mapping.valid() || offset >= mapping.size())
+            return;
+
+        // madvise requires a page-aligned address, the region is expanded to cover all pages it touches
+        auto start{util::AlignDown(reinterpret_cast<uintptr_t>(mapping.data() + offset), PAGE_SIZE)};
+        auto end{reinterpret_cast<uintptr_t>(mapping.data() + offset + std::min(adviseSize, mapping.size() - offset))};
+        if (madvise(reinterpret_cast<void *>(start), end - start, pattern == AccessPattern::Sequential ? MADV_SEQUENTIAL : MADV_RANDOM))
+            Logger::Debug("Failed to advise access pattern of fd: {}", strerror(errno));
+    }
+
     size_t OsBacking::ReadImpl(span<u8> output, size_t offset) {
+        if (mapping.valid()) {
+            // A memcpy from the mapping will trap into the signal handler normally for protected guest memory unlike pread, which fails with EFAULT instead
+            if (offset >= mapping.size())
+                return 0;
+            size_t readSize{std::min(output.size(), mapping.size() - offset)};
+            std::memcpy(output.data(), mapping.data() + offset, readSize);
+            return readSize;
+        }
+
         size_t bytesRead{};
         while (bytesRead < output.size()) {
             auto ret{pread64(fd, output.data() + bytesRead, output.size() - bytesRead, static_cast<off64_t>(offset + bytesRead))};
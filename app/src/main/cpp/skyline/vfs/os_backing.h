@@ -13,6 +13,7 @@ namespace skyline::vfs {
       private:
         int fd; //!< An FD to the backing
         bool closable; //!< Whether the FD can be closed when the backing is destroyed
+        span<u8> mapping; //!< A read-only mapping of the entire file which reads are served from, this is empty if the file isn't mapped
 
       protected:
         size_t ReadImpl(span<u8> output, size_t offset) override;
@@ -24,9 +25,15 @@ namespace skyline::vfs {
       public:
         /**
          * @param fd The file descriptor of the backing
+         * @param map If a read-only backing should be memory-mapped, this avoids a syscall per read and allows for zero-copy access via GetView
+         * @note The backing will silently fall back to pread if the file can't be mapped
          */
-        OsBacking(int fd, bool closable = false, Mode = {true, false, false});
+        OsBacking(int fd, bool closable = false, Mode = {true, false, false}, bool map = false);
 
         ~OsBacking();
+
+        span<u8> GetView(size_t offset, size_t viewSize) override;
+
+        void Advise(AccessPattern pattern, size_t offset, size_t adviseSize) override;
     };
 }
@@ -10,10 +10,9 @@ namespace skyline::vfs {
      * @brief The OsFileSystem class abstracts an OS folder with the vfs::FileSystem api
      */
     class OsFileSystem : public FileSystem {
-      private:
+      protected:
         std::string basePath; //!< The base path for filesystem operations
 
-      protected:
         bool CreateFileImpl(const std::string &path, size_t size) override;
 
         void DeleteFileImpl(const std::string &path) override;
@@ -29,5 +29,16 @@ namespace skyline::vfs {
             if (mode.write || mode.append)
                 throw exception("Cannot open a RegionBacking as writable");
         };
+
+        span<u8> GetView(size_t offset, size_t viewSize) override {
+            if (offset > size || size - offset < viewSize)
+                return {};
+            return backing->GetView(baseOffset + offset, viewSize);
+        }
+
+        void Advise(AccessPattern pattern, size_t offset, size_t adviseSize) override {
+            if (offset < size)
+                backing->Advise(pattern, baseOffset + offset, std::min(adviseSize, size - offset));
+        }
     };
 }
@@ -7,73 +7,90 @@
 namespace skyline::vfs {
     RomFileSystem::RomFileSystem(std::shared_ptr<Backing> pBacking) : FileSystem(), backing(std::move(pBacking)) {
         header = backing->Read<RomFsHeader>();
-        TraverseDirectory(0, "");
-    }
 
-    void RomFileSystem::TraverseFiles(u32 offset, const std::string &path) {
-        RomFsFileEntry entry;
-        do {
-            entry = backing->Read<RomFsFileEntry>(header.fileMetaTableOffset + offset);
+        // Files in a RomFS are typically accessed in small reads scattered throughout the image, readahead would only waste IO bandwidth
+        backing->Advise(Backing::AccessPattern::Random, 0, backing->size);
+    }
 
-            if (entry.nameSize) {
-                std::vector<char> name(entry.nameSize);
-                backing->Read(span(name), header.fileMetaTableOffset + offset + sizeof(RomFsFileEntry));
+    /**
+     * @return The hash of an entry's name combined with the offset of its parent directory, this is the same hash that the RomFS builder uses to place entries in hash table buckets
+     */
+    static u32 CalculatePathHash(u32 parentOffset, std::string_view name) {
+        u32 hash{parentOffset ^ 123456789};
+        for (char character : name) {
+            hash = std::rotr(hash, 5);
+            hash ^= static_cast<u8>(character);
+        }
+        return hash;
+    }
 
-                std::string fullPath{path + (path.empty() ? "" : "/") + std::string(name.data(), entry.nameSize)};
-                fileMap.emplace(fullPath, entry);
+    template<typename EntryType>
+    std::optional<std::pair<u32, EntryType>> RomFileSystem::FindEntry(u32 parentOffset, std::string_view name, u64 hashTableOffset, u64 hashTableSize, u64 metaTableOffset) {
+        u64 bucketCount{hashTableSize / sizeof(u32)};
+        if (!bucketCount)
+            return std::nullopt;
+
+        u32 offset{backing->Read<u32>(hashTableOffset + (CalculatePathHash(parentOffset, name) % bucketCount) * sizeof(u32))};
+        std::string entryName;
+        while (offset != constant::RomFsEmptyEntry) {
+            auto entry{backing->Read<EntryType>(metaTableOffset + offset)};
+            if (entry.parentOffset == parentOffset && entry.nameSize == name.size()) {
+                entryName.resize(entry.nameSize);
+                backing->Read(span(entryName.data(), entryName.size()), metaTableOffset + offset + sizeof(EntryType));
+                if (entryName == name)
+                    return std::pair{offset, entry};
             }
-
-            offset = entry.siblingOffset;
-        } while (offset != constant::RomFsEmptyEntry);
+            offset = entry.hashSiblingOffset;
+        }
+        return std::nullopt;
     }
 
-    void RomFileSystem::TraverseDirectory(u32 offset, const std::string &path) {
-        auto entry{backing->Read<RomFsDirectoryEntry>(header.dirMetaTableOffset + offset)};
+    std::optional<std::pair<u32, RomFileSystem::RomFsDirectoryEntry>> RomFileSystem::FindDirectory(std::string_view path) {
+        std::optional<std::pair<u32, RomFsDirectoryEntry>> directory{std::in_place, 0, backing->Read<RomFsDirectoryEntry>(header.dirMetaTableOffset)};
+        while (directory && !path.empty()) {
+            auto separator{path.find('/')};
+            auto component{path.substr(0, separator)};
+            path = separator == std::string_view::npos ? std::string_view{} : path.substr(separator + 1);
 
-        std::string childPath(path);
-        if (entry.nameSize) {
-            std::vector<char> name(entry.nameSize);
-            backing->Read(span(name), header.dirMetaTableOffset + offset + sizeof(RomFsDirectoryEntry));
-            childPath = path + (path.empty() ? "" : "/") + std::string(name.data(), entry.nameSize);
+            if (!component.empty()) // Empty components from leading or repeated separators are skipped
+                directory = FindEntry<RomFsDirectoryEntry>(directory->first, component, header.dirHashTableOffset, header.dirHashTableSize, header.dirMetaTableOffset);
         }
+        return directory;
+    }
 
-        directoryMap.emplace(childPath, entry);
-
-        if (entry.fileOffset != constant::RomFsEmptyEntry)
-            TraverseFiles(entry.fileOffset, childPath);
-
-        if (entry.childOffset != constant::RomFsEmptyEntry)
-            TraverseDirectory(entry.childOffset, childPath);
+    std::optional<RomFileSystem::RomFsFileEntry> RomFileSystem::FindFile(std::string_view path) {
+        auto separator{path.rfind('/')};
+        auto parent{FindDirectory(separator == std::string_view::npos ? std::string_view{} : path.substr(0, separator))};
+        if (!parent)
+            return std::nullopt;
 
-        if (entry.siblingOffset != constant::RomFsEmptyEntry)
-            TraverseDirectory(entry.siblingOffset, path);
+        auto file{FindEntry<RomFsFileEntry>(parent->first, separator == std::string_view::npos ? path : path.substr(separator + 1), header.fileHashTableOffset, header.fileHashTableSize, header.fileMetaTableOffset)};
+        if (!file)
+            return std::nullopt;
+        return file->second;
     }
 
     std::shared_ptr<Backing> RomFileSystem::OpenFileImpl(const std::string &path, Backing::Mode mode) {
-        try {
-            const auto &entry{fileMap.at(path)};
-            return std::make_shared<RegionBacking>(backing, header.dataOffset + entry.offset, entry.size, mode);
-        } catch (std::out_of_range &e) {
+        auto entry{FindFile(path)};
+        if (!entry)
             return nullptr;
-        }
+        return std::make_shared<RegionBacking>(backing, header.dataOffset + entry->offset, entry->size, mode);
     }
 
     std::optional<Directory::EntryType> RomFileSystem::GetEntryTypeImpl(const std::string &path) {
-        if (fileMap.count(path))
+        if (FindFile(path))
             return Directory::EntryType::File;
-        else if (directoryMap.count(path))
+        else if (FindDirectory(path))
             return Directory::EntryType::Directory;
 
         return std::nullopt;
     }
 
     std::shared_ptr<Directory> RomFileSystem::OpenDirectoryImpl(const std::string &path, Directory::ListMode listMode) {
-        try {
-            auto &entry{directoryMap.at(path)};
-            return std::make_shared<RomFileSystemDirectory>(backing, header, entry, listMode);
-        } catch (std::out_of_range &e) {
+        auto directory{FindDirectory(path)};
+        if (!directory)
             return nullptr;
-        }
+        return std::make_shared<RomFileSystemDirectory>(backing, header, directory->second, listMode);
     }
 
     RomFileSystemDirectory::RomFileSystemDirectory(std::shared_ptr<Backing> backing, const RomFileSystem::RomFsHeader &header, const RomFileSystem::RomFsDirectoryEntry &ownEntry, ListMode listMode) : Directory(listMode), backing(std::move(backing)), header(header), ownEntry(ownEntry) {}
@@ -18,20 +18,6 @@ namespace skyline {
           private:
             std::shared_ptr<Backing> backing;
 
-            /**
-             * @brief Traverses the sibling files of the given file and adds them to the file map
-             * @param offset The offset of the file entry to traverses the siblings of
-             * @param path The path to the parent directory of the supplied file entry
-             */
-            void TraverseFiles(u32 offset, const std::string &path);
-
-            /**
-             * @brief Traverses the directories within the given directory, adds them to the directory map and calls TraverseFiles on them
-             * @param offset The offset of the directory entry to traverses the directories in
-             * @param path The path to the supplied directory entry
-             */
-            void TraverseDirectory(u32 offset, const std::string &path);
-
           protected:
             std::shared_ptr<Backing> OpenFileImpl(const std::string &path, Backing::Mode mode) override;
 
@@ -59,7 +45,7 @@ namespace skyline {
                 u32 siblingOffset; //!< The offset from the directory metadata base of a sibling directory
                 u32 childOffset; //!< The offset from the directory metadata base of a child directory
                 u32 fileOffset; //!< The offset from the file metadata base of a child file
-                u32 hash; //!< The hash of the directory
+                u32 hashSiblingOffset; //!< The offset from the directory metadata base of the next directory in the same hash table bucket
                 u32 nameSize; //!< The size of the directory's name in bytes
             };
 
@@ -68,13 +54,35 @@ namespace skyline {
                 u32 siblingOffset; //!< The offset from the file metadata base of a sibling file
                 u64 offset; //!< The offset from the file data base of the file contents
                 u64 size; //!< The size of the file in bytes
-                u32 hash; //!< The hash of the file
+                u32 hashSiblingOffset; //!< The offset from the file metadata base of the next file in the same hash table bucket
                 u32 nameSize; //!< The size of the file's name in bytes
             };
 
-            std::unordered_map<std::string, RomFsFileEntry> fileMap; //!< A map that maps file names to their corresponding entry
-            std::unordered_map<std::string, RomFsDirectoryEntry> directoryMap; //!< A map that maps directory names to their corresponding entry
+          private:
+            /**
+             * @brief Finds an entry with the supplied parent and name through one of the image's hash tables
+             * @param hashTableOffset The offset of the hash table to search, this determines the type of entry
+             * @param metaTableOffset The offset of the metadata table that the hash table refers to
+             * @return The offset of the entry from the metadata table base and the entry itself or std::nullopt if it doesn't exist
+             */
+            template<typename EntryType>
+            std::optional<std::pair<u32, EntryType>> FindEntry(u32 parentOffset, std::string_view name, u64 hashTableOffset, u64 hashTableSize, u64 metaTableOffset);
+
+            /**
+             * @brief Walks the directory hash table for every component of the supplied path starting at the root directory
+             * @return The offset and entry of the directory or std::nullopt if any component doesn't exist
+             */
+            std::optional<std::pair<u32, RomFsDirectoryEntry>> FindDirectory(std::string_view path);
 
+            /**
+             * @return The entry of the file at the supplied path or std::nullopt if it doesn't exist
+             */
+            std::optional<RomFsFileEntry> FindFile(std::string_view path);
+
+          public:
+            /**
+             * @note Construction only reads the header, all lookups are done through the image's hash tables so no per-file state is held
+             */
             RomFileSystem(std::shared_ptr<Backing> backing);
         };
 
@@ -0,0 +1,191 @@
+// SPDX-License-Identifier: MPL-2.0
+// Copyright © 2023 Skyline Team and Contributors (https://github.com/skyline-emu/)
+
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include "os_backing.h"
+#include "write_back_filesystem.h"
+
+namespace skyline::vfs {
+    WriteBackFileSystem::CachedBacking::CachedBacking(std::shared_ptr<CachedFile> file, Mode mode) : Backing(mode, file->data.size()), file(std::move(file)) {}
+
+    size_t WriteBackFileSystem::CachedBacking::ReadImpl(span<u8> output, size_t offset) {
+        std::scoped_lock lock{file->mutex};
+        if (offset >= file->data.size())
+            return 0;
+
+        size_t readSize{std::min(output.size(), file->data.size() - offset)};
+        std::memcpy(output.data(), file->data.data() + offset, readSize);
+        return readSize;
+    }
+
+    size_t WriteBackFileSystem::CachedBacking::WriteImpl(span<u8> input, size_t offset) {
+        std::scoped_lock lock{file->mutex};
+        if (offset + input.size() > file->data.size())
+            file->data.resize(offset + input.size());
+
+        std::memcpy(file->data.data() + offset, input.data(), input.size());
+        file->dirty = true;
+        size = file->data.size();
+        return input.size();
+    }
+
+    void WriteBackFileSystem::CachedBacking::ResizeImpl(size_t pSize) {
+        std::scoped_lock lock{file->mutex};
+        file->data.resize(pSize);
+        file->dirty = true;
+        size = pSize;
+    }
+
+    WriteBackFileSystem::CachedDirectory::CachedDirectory(std::shared_ptr<Directory> directory, WriteBackFileSystem &fileSystem, std::string path)
+        : Directory(directory->listMode),
+          directory(std::move(directory)),
+          fileSystem(fileSystem),
+          path(std::move(path)) {}
+
+    std::vector<Directory::Entry> WriteBackFileSystem::CachedDirectory::Read() {
+        auto entries{directory->Read()};
+        std::erase_if(entries, [](const Entry &entry) { return entry.name.ends_with(CommitSuffix); });
+
+        std::scoped_lock lock{fileSystem.mutex};
+        for (auto &entry : entries) {
+            if (entry.type != EntryType::File)
+                continue;
+
+            auto it{fileSystem.cache.find(path + entry.name)};
+            if (it != fileSystem.cache.end()) {
+                std::scoped_lock fileLock{it->second->mutex};
+                entry.size = it->second->data.size();
+            }
+        }
+        return entries;
+    }
+
+    WriteBackFileSystem::WriteBackFileSystem(const std::string &basePath) : OsFileSystem(basePath) {}
+
+    WriteBackFileSystem::~WriteBackFileSystem() {
+        Commit();
+    }
+
+    bool WriteBackFileSystem::CreateFileImpl(const std::string &path, size_t size) {
+        std::scoped_lock lock{mutex};
+        cache.erase(path); // Creating a file truncates it on disk, any cached contents are stale after this
+        return OsFileSystem::CreateFileImpl(path, size);
+    }
+
+    void WriteBackFileSystem::DeleteFileImpl(const std::string &path) {
+        std::scoped_lock lock{mutex};
+        cache.erase(path);
+        OsFileSystem::DeleteFileImpl(path);
+    }
+
+    void WriteBackFileSystem::DeleteDirectoryImpl(const std::string &path) {
+        std::scoped_lock lock{mutex};
+        auto prefix{path.ends_with('/') ? path : path + '/'};
+        std::erase_if(cache, [&](const auto &entry) { return entry.first.starts_with(prefix); });
+        OsFileSystem::DeleteDirectoryImpl(path);
+    }
+
+    std::shared_ptr<Backing> WriteBackFileSystem::OpenFileImpl(const std::string &path, Backing::Mode mode) {
+        std::scoped_lock lock{mutex};
+        auto &file{cache[path]};
+        if (!file) {
+            // The file is read in its entirety on the first open, all further accesses are served from memory
+            auto diskFile{OsFileSystem::OpenFileImpl(path, {true, false, false})};
+            file = std::make_shared<CachedFile>();
+            file->data.resize(diskFile->size);
+            if (diskFile->ReadUnchecked(file->data, 0) != file->data.size())
+                Logger::Warn("Failed to read the entirety of '{}' into the cache", path);
+        }
+
+        return std::make_shared<CachedBacking>(file, mode);
+    }
+
+    std::shared_ptr<Directory> WriteBackFileSystem::OpenDirectoryImpl(const std::string &path, Directory::ListMode listMode) {
+        auto directory{OsFileSystem::OpenDirectoryImpl(path, listMode)};
+        if (!directory)
+            return nullptr;
+
+        return std::make_shared<CachedDirectory>(std::move(directory), *this, path.ends_with('/') ? path : path + '/');
+    }
+
+    bool WriteBackFileSystem::CommitImpl() {
+        std::scoped_lock lock{mutex};
+
+        struct PendingFile {
+            std::shared_ptr<CachedFile> file;
+            std::string path;
+            std::string temporaryPath;
+        };
+        std::vector<PendingFile> pendingFiles;
+
+        // All modified files are written out to temporary files and synced before any are renamed so a crash can only leave the prior or new contents
+        bool success{true};
+        for (auto &[path, file] : cache) {
+            std::scoped_lock fileLock{file->mutex};
+            if (!file->dirty)
+                continue;
+
+            auto fullPath{basePath + path};
+            auto temporaryPath{fullPath + std::string{CommitSuffix}};
+            int fd{open(temporaryPath.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, S_IRUSR | S_IWUSR | S_IRGRP | S_IWGRP | S_IROTH | S_IWOTH)};
+            if (fd < 0) {
+                Logger::Warn("Failed to create commit file for '{}': {}", path, strerror(errno));
+                success = false;
+                continue;
+            }
+
+            size_t written{};
+            while (written < file->data.size()) {
+                auto ret{write(fd, file->data.data() + written, file->data.size() - written)};
+                if (ret < 0) {
+                    if (errno == EINTR)
+                        continue;
+                    break;
+                }
+                written += static_cast<size_t>(ret);
+            }
+
+            if (written != file->data.size() || fsync(fd)) {
+                Logger::Warn("Failed to write commit file for '{}': {}", path, strerror(errno));
+                close(fd);
+                unlink(temporaryPath.c_str());
+                success = false;
+                continue;
+            }
+
+            close(fd);
+            pendingFiles.push_back({file, std::move(fullPath), std::move(temporaryPath)});
+            file->dirty = false;
+        }
+
+        std::vector<std::string> directories;
+        for (const auto &pendingFile : pendingFiles) {
+            if (rename(pendingFile.temporaryPath.c_str(), pendingFile.path.c_str())) {
+                Logger::Warn("Failed to commit '{}': {}", pendingFile.path, strerror(errno));
+                unlink(pendingFile.temporaryPath.c_str());
+
+                std::scoped_lock fileLock{pendingFile.file->mutex};
+                pendingFile.file->dirty = true; // The contents will be written out again on the next commit
+                success = false;
+                continue;
+            }
+
+            auto directory{pendingFile.path.substr(0, pendingFile.path.find_last_of('/') + 1)};
+            if (std::find(directories.begin(), directories.end(), directory) == directories.end())
+                directories.push_back(std::move(directory));
+        }
+
+        // The renames themselves are only durable once the directories containing them are synced
+        for (const auto &directory : directories) {
+            int fd{open(directory.c_str(), O_RDONLY | O_DIRECTORY | O_CLOEXEC)};
+            if (fd >= 0) {
+                fsync(fd);
+                close(fd);
+            }
+        }
+
+        return success;
+    }
+}
@@ -0,0 +1,83 @@
+// SPDX-License-Identifier: MPL-2.0
+// Copyright © 2023 Skyline Team and Contributors (https://github.com/skyline-emu/)
+
+#pragma once
+
+#include "os_filesystem.h"
+
+namespace skyline::vfs {
+    /**
+     * @brief A filesystem over an OS folder which holds the contents of all opened files in memory and only writes them out on a commit, this turns the small repeated writes of savedata into memcpys
+     * @note Commits are crash-consistent as modified files are written out to temporary files in full and renamed over the originals once all of them have been synced
+     */
+    class WriteBackFileSystem : public OsFileSystem {
+      private:
+        static constexpr std::string_view CommitSuffix{".sky-commit"}; //!< The suffix of temporary files that are written during a commit, these are hidden from the guest
+
+        /**
+         * @brief The cached contents of a single file, this is shared between all backings of the file
+         */
+        struct CachedFile {
+            std::mutex mutex;
+            std::vector<u8> data;
+            bool dirty{}; //!< If the contents were modified since the last commit
+        };
+
+        /**
+         * @brief A backing which reads and writes the cached contents of a file
+         */
+        class CachedBacking : public Backing {
+          private:
+            std::shared_ptr<CachedFile> file;
+
+          protected:
+            size_t ReadImpl(span<u8> output, size_t offset) override;
+
+            size_t WriteImpl(span<u8> input, size_t offset) override;
+
+            void ResizeImpl(size_t pSize) override;
+
+          public:
+            CachedBacking(std::shared_ptr<CachedFile> file, Mode mode);
+        };
+
+        /**
+         * @brief A directory which reports the sizes of files from the cache as they may differ from those on disk prior to a commit
+         */
+        class CachedDirectory : public Directory {
+          private:
+            std::shared_ptr<Directory> directory;
+            WriteBackFileSystem &fileSystem;
+            std::string path;
+
+          public:
+            CachedDirectory(std::shared_ptr<Directory> directory, WriteBackFileSystem &fileSystem, std::string path);
+
+            std::vector<Entry> Read() override;
+        };
+
+        std::mutex mutex; //!< Synchronizes access to the cache
+        std::unordered_map<std::string, std::shared_ptr<CachedFile>> cache; //!< A map from the path of every opened file to its cached contents
+
+      protected:
+        bool CreateFileImpl(const std::string &path, size_t size) override;
+
+        void DeleteFileImpl(const std::string &path) override;
+
+        void DeleteDirectoryImpl(const std::string &path) override;
+
+        std::shared_ptr<Backing> OpenFileImpl(const std::string &path, Backing::Mode mode) override;
+
+        std::shared_ptr<Directory> OpenDirectoryImpl(const std::string &path, Directory::ListMode listMode) override;
+
+        bool CommitImpl() override;
+
+      public:
+        WriteBackFileSystem(const std::string &basePath);
+
+        /**
+         * @note Any pending writes are committed when the filesystem is closed
+         */
+        ~WriteBackFileSystem();
+    };
+}
@@ -161,6 +161,104 @@ class EmulationActivity : AppCompatActivity(), SurfaceHolder.Callback, View.OnTo
      */
     private external fun updatePerformanceStatistics()
 
+    /**
+     * The indices of values in the array filled by [getPerformanceOverlayStatistics], these must be kept in sync with libskyline
+     */
+    private object OverlayStatistic {
+        const val Fps = 0
+        const val AverageFrametimeUs = 1
+        const val FrameGpuTimeUs = 2
+        const val PipelineCompiles = 3
+        const val ShaderCacheHits = 4
+        const val ShaderCacheMisses = 5
+        const val TextureCount = 6
+        const val BufferCount = 7
+        const val MegaBufferBytes = 8
+        const val DeviceLocalMemoryBytes = 9
+        const val ContextSwitches = 10
+        const val FrameTimeCount = 11
+        const val Count = 12
+    }
+
+    /**
+     * Writes the statistics shown by the detailed performance overlay into the supplied arrays
+     *
+     * @param statistics An array of at least [OverlayStatistic.Count] values which are indexed by [OverlayStatistic]
+     * @param frameTimes An array which is filled with the most recent frame times in milliseconds from oldest to newest, the amount written is stored at [OverlayStatistic.FrameTimeCount]
+     * @return The CPU usage of the busiest emulator threads, one thread per line
+     */
+    private external fun getPerformanceOverlayStatistics(statistics : LongArray, frameTimes : FloatArray) : String
+
+    /**
+     * Writes the call counts and latency histograms of all HLE service functions that have been called to the log
+     *
+     * @return The statistics as a table in CSV format or null if emulation isn't running
+     */
+    external fun dumpServiceStatistics() : String?
+
+    /**
+     * Returns the wall-clock time spent in each stage of booting the current title, this is also written to the log once the first frame is presented
+     *
+     * @return The stages with their start time, duration and occurrence count as a table in CSV format or null if the first frame hasn't been presented yet
+     */
+    external fun getBootProfile() : String?
+
+    /**
+     * Dumps the slowest pipeline compilations since emulation started to the log, these are broken down by compilation stage and attributed to the guest shader that took the longest to compile
+     *
+     * @return The slowest compilations with the time spent on shader translation, SPIR-V emission and pipeline creation as a table in CSV format
+     */
+    external fun dumpShaderCompileStatistics() : String
+
+    /**
+     * Starts an in-process perfetto tracing session which is written into a `.perfetto-trace` file, this doesn't require the system tracing service
+     *
+     * @param path The full path of the trace file, it is truncated if it already exists
+     * @param categories The track event categories to enable or null to enable all categories
+     * @param bufferSizeKb The size of the trace ring buffer in KiB or 0 for the default size
+     * @return If the session was started, this fails if a session is already active
+     */
+    external fun startTracing(path : String, categories : Array<String>?, bufferSizeKb : Int) : Boolean
+
+    /**
+     * Stops the active tracing session and finalizes its trace file, this is done automatically when emulation ends
+     *
+     * @return If there was an active session that was stopped
+     */
+    external fun stopTracing() : Boolean
+
+    /**
+     * Starts capturing the GPFIFO entries executed by all channels alongside their pushbuffers and a snapshot of GPU-mapped guest memory, the capture can be replayed with [replayGpuCapture]
+     *
+     * @param path The full path of the capture file, it is truncated if it already exists
+     * @return If the capture was started, this fails if a capture is already active or emulation isn't running
+     */
+    external fun startGpuCapture(path : String) : Boolean
+
+    /**
+     * Stops the active GPFIFO capture and closes its file
+     *
+     * @return If there was an active capture that was stopped
+     */
+    external fun stopGpuCapture() : Boolean
+
+    /**
+     * Replays a GPFIFO capture on fresh channels without running any guest code, this blocks until all replays have completed on the GPU
+     *
+     * @param path The full path of the capture file
+     * @param iterations The amount of times to replay the capture, replays after the first run with warm caches
+     * @return The host time taken by each replay in nanoseconds or null if the capture couldn't be loaded or emulation isn't running
+     */
+    external fun replayGpuCapture(path : String, iterations : Int) : LongArray?
+
+    /**
+     * Takes a copy-on-write snapshot of all mapped guest memory and writes it out to a file in the background, the guest keeps running while the snapshot is being written
+     *
+     * @param path The full path of the snapshot file, it is truncated if it already exists
+     * @return If the snapshot was taken, this fails if the previous snapshot is still being written out or emulation isn't running
+     */
+    external fun saveMemorySnapshot(path : String) : Boolean
+
     /**
      * @see [InputHandler.initializeControllers]
      */
@@ -290,7 +388,7 @@ class EmulationActivity : AppCompatActivity(), SurfaceHolder.Callback, View.OnTo
         }
 
         if (emulationSettings.respectDisplayCutout) {
-            binding.perfStats.setOnApplyWindowInsetsListener(insetsOrMarginHandler)
+            binding.perfOverlay.setOnApplyWindowInsetsListener(insetsOrMarginHandler)
             binding.onScreenControllerToggle.setOnApplyWindowInsetsListener(insetsOrMarginHandler)
         }
 
@@ -311,11 +409,30 @@ class EmulationActivity : AppCompatActivity(), SurfaceHolder.Callback, View.OnTo
             if (emulationSettings.disableFrameThrottling)
                 binding.perfStats.setTextColor(getColor(R.color.colorPerfStatsSecondary))
 
+            val perfOverlay = emulationSettings.perfOverlay
+            val statistics = LongArray(OverlayStatistic.Count)
+            val frameTimes = FloatArray(120)
+            if (perfOverlay)
+                binding.perfGraph.isGone = false
+
             binding.perfStats.apply {
                 postDelayed(object : Runnable {
                     override fun run() {
                         updatePerformanceStatistics()
                         text = "$fps FPS\n${"%.1f".format(averageFrametime)}±${"%.2f".format(averageFrametimeDeviation)}ms"
+
+                        if (perfOverlay) {
+                            val threadUsage = getPerformanceOverlayStatistics(statistics, frameTimes)
+                            binding.perfGraph.setFrameTimes(frameTimes, statistics[OverlayStatistic.FrameTimeCount].toInt())
+                            append("\nGPU: ${"%.2f".format(statistics[OverlayStatistic.FrameGpuTimeUs] / 1000f)}ms")
+                            append("\nPipelines: ${statistics[OverlayStatistic.PipelineCompiles]} (Shaders: ${statistics[OverlayStatistic.ShaderCacheHits]} hit/${statistics[OverlayStatistic.ShaderCacheMisses]} miss)")
+                            append("\nTextures: ${statistics[OverlayStatistic.TextureCount]} Buffers: ${statistics[OverlayStatistic.BufferCount]}")
+                            append("\nMegabuffer: ${statistics[OverlayStatistic.MegaBufferBytes] / (1024 * 1024)}MiB VRAM: ${statistics[OverlayStatistic.DeviceLocalMemoryBytes] / (1024 * 1024)}MiB")
+                            append("\nContext Switches: ${statistics[OverlayStatistic.ContextSwitches]}")
+                            if (threadUsage.isNotEmpty())
+                                append("\n$threadUsage")
+                        }
+
                         postDelayed(this, 250)
                     }
                 }, 250)
@@ -599,11 +716,11 @@ class EmulationActivity : AppCompatActivity(), SurfaceHolder.Callback, View.OnTo
         return inputHandler.handleTouchEvent(view, event)
     }
 
-    private fun onButtonStateChanged(buttonId : ButtonId, state : ButtonState) = InputHandler.setButtonState(0, buttonId.value, state.state)
+    private fun onButtonStateChanged(buttonId : ButtonId, state : ButtonState) = InputHandler.queueButtonState(0, buttonId.value, state.state)
 
     private fun onStickStateChanged(stickId : StickId, position : PointF) {
-        InputHandler.setAxisValue(0, stickId.xAxis.ordinal, (position.x * Short.MAX_VALUE).toInt())
-        InputHandler.setAxisValue(0, stickId.yAxis.ordinal, (-position.y * Short.MAX_VALUE).toInt()) // Y is inverted, since drawing starts from top left
+        InputHandler.queueAxisValue(0, stickId.xAxis.ordinal, (position.x * Short.MAX_VALUE).toInt())
+        InputHandler.queueAxisValue(0, stickId.yAxis.ordinal, (-position.y * Short.MAX_VALUE).toInt()) // Y is inverted, since drawing starts from top left
     }
 
     @SuppressLint("WrongConstant")
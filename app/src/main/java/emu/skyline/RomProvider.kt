@@ -9,30 +9,37 @@ import emu.skyline.loader.AppEntry
 import emu.skyline.loader.RomFile
 import emu.skyline.loader.RomFormat
 import emu.skyline.loader.RomFormat.*
+import java.util.stream.Collectors
 import javax.inject.Inject
 import javax.inject.Singleton
 
 @Singleton
 class RomProvider @Inject constructor(@ApplicationContext private val context : Context) {
     /**
-     * This adds all files in [directory] with [extension] as an entry using [RomFile] to load metadata
+     * This adds all files in [directory] with an extension in [fileFormats] to [files] alongside their format
      */
     @SuppressLint("DefaultLocale")
-    private fun addEntries(fileFormats : Map<String, RomFormat>, directory : DocumentFile, entries : ArrayList<AppEntry>, systemLanguage : Int) {
+    private fun addFiles(fileFormats : Map<String, RomFormat>, directory : DocumentFile, files : ArrayList<Pair<Uri, RomFormat>>) {
         directory.listFiles().forEach { file ->
             if (file.isDirectory) {
-                addEntries(fileFormats, file, entries, systemLanguage)
+                addFiles(fileFormats, file, files)
             } else {
-                fileFormats[file.name?.substringAfterLast(".")?.lowercase()]?.let { romFormat->
-                    entries.add(RomFile(context, romFormat, file.uri, systemLanguage).appEntry)
+                fileFormats[file.name?.substringAfterLast(".")?.lowercase()]?.let { romFormat ->
+                    files.add(file.uri to romFormat)
                 }
             }
         }
     }
 
+    /**
+     * Loads the metadata of all ROMs in [searchLocation] using [RomFile], ROMs are populated in parallel and any that are unchanged since the last scan are served from the metadata index
+     */
     fun loadRoms(searchLocation : Uri, systemLanguage : Int) = DocumentFile.fromTreeUri(context, searchLocation)!!.let { documentFile ->
-        arrayListOf<AppEntry>().apply {
-            addEntries(mapOf("nro" to NRO, "nso" to NSO, "nca" to NCA, "nsp" to NSP, "xci" to XCI), documentFile, this, systemLanguage)
-        }
+        val files = arrayListOf<Pair<Uri, RomFormat>>()
+        addFiles(mapOf("nro" to NRO, "nso" to NSO, "nca" to NCA, "nsp" to NSP, "xci" to XCI), documentFile, files)
+
+        val entries = files.parallelStream().map { (uri, romFormat) -> RomFile(context, romFormat, uri, systemLanguage).appEntry }.collect(Collectors.toList())
+        RomFile.flushMetadataIndex(RomFile.metadataIndexPath(context))
+        ArrayList<AppEntry>(entries)
     }
 }
@@ -48,7 +48,7 @@ class InputHandler(private val inputManager : InputManager, private val emulatio
          * @param mask The mask of the button that are being set
          * @param pressed If the buttons are being pressed or released
          */
-        external fun setButtonState(index : Int, mask : Long, pressed : Boolean)
+        private external fun setButtonState(index : Int, mask : Long, pressed : Boolean)
 
         /**
          * This sets the value of a specific axis on a specific controller
@@ -57,7 +57,7 @@ class InputHandler(private val inputManager : InputManager, private val emulatio
          * @param axis The ID of the axis that is being modified
          * @param value The value to set the axis to
          */
-        external fun setAxisValue(index : Int, axis : Int, value : Int)
+        private external fun setAxisValue(index : Int, axis : Int, value : Int)
 
         /**
          * This sets the values of the motion sensor on a specific controller
@@ -74,6 +74,64 @@ class InputHandler(private val inputManager : InputManager, private val emulatio
          * @param points An array of skyline::input::TouchScreenPoint in C++ represented as integers
          */
         external fun setTouchState(points : IntArray)
+
+        /**
+         * @return A direct buffer of skyline::input::InputEventRing in C++, it's valid for the lifetime of the process
+         */
+        private external fun getInputEventRing() : ByteBuffer
+
+        /**
+         * The amount of slots in the event ring, this must be kept in sync with C++
+         */
+        private const val EventRingCapacity = 256
+
+        private const val EventTypeButtonPress = 1
+        private const val EventTypeButtonRelease = 2
+        private const val EventTypeAxis = 3
+
+        private val eventRing by lazy { getInputEventRing().order(ByteOrder.LITTLE_ENDIAN) }
+        private var eventRingIndex = 0
+
+        /**
+         * Writes an event into the event ring shared with libskyline, it's drained by the input thread at the next sampling tick
+         *
+         * @return If the event was queued, this fails if the ring is full
+         */
+        @Synchronized
+        private fun queueEvent(type : Int, index : Int, axis : Int, value : Int) : Boolean {
+            val offset = eventRingIndex * Long.SIZE_BYTES
+            if (eventRing.getLong(offset) != 0L)
+                return false
+
+            // The event is written as a single word (skyline::input::InputEvent) so it can never be observed partially written
+            eventRing.putLong(offset, type.toLong() or ((index.toLong() and 0xFF) shl 8) or ((axis.toLong() and 0xFF) shl 16) or (value.toLong() shl 32))
+            eventRingIndex = (eventRingIndex + 1) % EventRingCapacity
+            return true
+        }
+
+        /**
+         * This sets the state of the buttons specified in the mask on a specific controller, the state is applied at the next sampling tick
+         *
+         * @param index The index of the controller this is directed to
+         * @param mask The mask of the button that are being set
+         * @param pressed If the buttons are being pressed or released
+         */
+        fun queueButtonState(index : Int, mask : Long, pressed : Boolean) {
+            if (mask ushr Int.SIZE_BITS != 0L || !queueEvent(if (pressed) EventTypeButtonPress else EventTypeButtonRelease, index, 0, mask.toInt()))
+                setButtonState(index, mask, pressed)
+        }
+
+        /**
+         * This sets the value of a specific axis on a specific controller, the value is applied at the next sampling tick
+         *
+         * @param index The index of the controller this is directed to
+         * @param axis The ID of the axis that is being modified
+         * @param value The value to set the axis to
+         */
+        fun queueAxisValue(index : Int, axis : Int, value : Int) {
+            if (!queueEvent(EventTypeAxis, index, axis, value))
+                setAxisValue(index, axis, value)
+        }
     }
 
     @Suppress("ArrayInDataClass")
@@ -221,12 +279,12 @@ class InputHandler(private val inputManager : InputManager, private val emulatio
         return when (val guestEvent = inputManager.eventMap[KeyHostEvent(event.device.descriptor, event.keyCode)]) {
             is ButtonGuestEvent -> {
                 if (guestEvent.button != ButtonId.Menu)
-                    setButtonState(guestEvent.id, guestEvent.button.value, action.state)
+                    queueButtonState(guestEvent.id, guestEvent.button.value, action.state)
                 true
             }
 
             is AxisGuestEvent -> {
-                setAxisValue(guestEvent.id, guestEvent.axis.ordinal, (if (action == ButtonState.Pressed) if (guestEvent.polarity) Short.MAX_VALUE else Short.MIN_VALUE else 0).toInt())
+                queueAxisValue(guestEvent.id, guestEvent.axis.ordinal, (if (action == ButtonState.Pressed) if (guestEvent.polarity) Short.MAX_VALUE else Short.MIN_VALUE else 0).toInt())
                 true
             }
 
@@ -274,14 +332,14 @@ class InputHandler(private val inputManager : InputManager, private val emulatio
                         is ButtonGuestEvent -> {
                             val action = if (abs(value) >= guestEvent.threshold) ButtonState.Pressed.state else ButtonState.Released.state
                             if (guestEvent.button != ButtonId.Menu)
-                                setButtonState(guestEvent.id, guestEvent.button.value, action)
+                                queueButtonState(guestEvent.id, guestEvent.button.value, action)
                         }
 
                         is AxisGuestEvent -> {
                             value = guestEvent.value(value)
                             value = if (polarity) abs(value) else -abs(value)
                             value = if (guestEvent.axis == AxisId.LX || guestEvent.axis == AxisId.RX) value else -value
-                            setAxisValue(guestEvent.id, guestEvent.axis.ordinal, (value * Short.MAX_VALUE).toInt())
+                            queueAxisValue(guestEvent.id, guestEvent.axis.ordinal, (value * Short.MAX_VALUE).toInt())
                         }
                     }
                 }
@@ -164,7 +164,7 @@ internal class RomFile(context : Context, format : RomFormat, uri : Uri, systemL
 
     init {
         context.contentResolver.openFileDescriptor(uri, "r")!!.use {
-            result = LoaderResult.get(populate(format.ordinal, it.fd, "${context.filesDir.canonicalPath}/keys/", systemLanguage))
+            result = LoaderResult.get(populate(format.ordinal, it.fd, uri.toString(), "${context.filesDir.canonicalPath}/keys/", metadataIndexPath(context), systemLanguage))
         }
 
         appEntry = applicationName?.let { name ->
@@ -184,8 +184,21 @@ internal class RomFile(context : Context, format : RomFormat, uri : Uri, systemL
      * Parses ROM and writes its metadata to [applicationName], [applicationAuthor] and [rawIcon]
      * @param format The format of the ROM
      * @param romFd A file descriptor of the ROM
+     * @param romPath The path of the ROM, this is used to key it in the metadata index
      * @param appFilesPath Path to internal app data storage, needed to read imported keys
+     * @param indexPath Path to the metadata index, ROMs that haven't changed since they were indexed aren't parsed again
      * @return A pointer to the newly allocated object, or 0 if the ROM is invalid
      */
-    private external fun populate(format : Int, romFd : Int, appFilesPath : String, systemLanguage : Int) : Int
+    private external fun populate(format : Int, romFd : Int, romPath : String, appFilesPath : String, indexPath : String, systemLanguage : Int) : Int
+
+    companion object {
+        fun metadataIndexPath(context : Context) = "${context.filesDir.canonicalPath}/rom_index.bin"
+
+        /**
+         * Writes the metadata index out to disk, entries for ROMs that weren't populated since the index was loaded are dropped
+         * @note This should only be called after populating every ROM in the library
+         */
+        @JvmStatic
+        external fun flushMetadataIndex(indexPath : String)
+    }
 }
@@ -30,12 +30,18 @@ class EmulationSettings private constructor(context : Context, prefName : String
     var systemLanguage by sharedPreferences(context, 1, prefName = prefName)
     var systemRegion by sharedPreferences(context, -1, prefName = prefName)
     var isInternetEnabled by sharedPreferences(context, false, prefName = prefName)
+    var pinHostThreads by sharedPreferences(context, true, prefName = prefName)
+    var performanceHints by sharedPreferences(context, true, prefName = prefName)
+    var cacheDecryptedNca by sharedPreferences(context, false, prefName = prefName)
+    var verifyRomFsIntegrity by sharedPreferences(context, false, prefName = prefName)
+    var hardwareVideoDecoding by sharedPreferences(context, false, prefName = prefName)
 
     // Audio
     var isAudioOutputDisabled by sharedPreferences(context, false, prefName = prefName)
 
     // Display
     var perfStats by sharedPreferences(context, false, prefName = prefName)
+    var perfOverlay by sharedPreferences(context, false, prefName = prefName)
     var maxRefreshRate by sharedPreferences(context, false, prefName = prefName)
     var orientation by sharedPreferences(context, ActivityInfo.SCREEN_ORIENTATION_SENSOR_LANDSCAPE, prefName = prefName)
     var aspectRatio by sharedPreferences(context, 0, prefName = prefName)
@@ -45,12 +51,27 @@ class EmulationSettings private constructor(context : Context, prefName : String
     var gpuDriver by sharedPreferences(context, SYSTEM_GPU_DRIVER, prefName = prefName)
     var forceTripleBuffering by sharedPreferences(context, true, prefName = prefName)
     var disableFrameThrottling by sharedPreferences(context, false, prefName = prefName)
+    var framePacing by sharedPreferences(context, false, prefName = prefName)
     var executorSlotCountScale by sharedPreferences(context, 6, prefName = prefName)
     var executorFlushThreshold by sharedPreferences(context, 256, prefName = prefName)
+    var adaptiveExecutorFlush by sharedPreferences(context, false, prefName = prefName)
     var useDirectMemoryImport by sharedPreferences(context, false, prefName = prefName)
     var forceMaxGpuClocks by sharedPreferences(context, false, prefName = prefName)
+    var parallelCommandRecording by sharedPreferences(context, false, prefName = prefName)
     var freeGuestTextureMemory by sharedPreferences(context, true, prefName = prefName)
+    var textureMemoryBudget by sharedPreferences(context, 0, prefName = prefName)
+    var transientAttachments by sharedPreferences(context, false, prefName = prefName)
+    var resolutionScale by sharedPreferences(context, 100, prefName = prefName)
+    var dynamicResolution by sharedPreferences(context, false, prefName = prefName)
+    var upscalingMode by sharedPreferences(context, 0, prefName = prefName)
+    var gpuTextureDecoding by sharedPreferences(context, false, prefName = prefName)
+    var textureTranscoding by sharedPreferences(context, false, prefName = prefName)
+    var gpuQuadConversion by sharedPreferences(context, false, prefName = prefName)
+    var enableTextureCache by sharedPreferences(context, false, prefName = prefName)
+    var skipRedundantUploads by sharedPreferences(context, false, prefName = prefName)
     var disableShaderCache by sharedPreferences(context, false, prefName = prefName)
+    var asyncPipelineCompilation by sharedPreferences(context, false, prefName = prefName)
+    var enableMacroJit by sharedPreferences(context, true, prefName = prefName)
 
     // Hacks
     var enableFastGpuReadbackHack by sharedPreferences(context, false, prefName = prefName)
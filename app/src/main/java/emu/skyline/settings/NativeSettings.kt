@@ -23,6 +23,11 @@ data class NativeSettings(
     var systemLanguage : Int,
     var systemRegion : Int,
     var isInternetEnabled : Boolean,
+    var pinHostThreads : Boolean,
+    var performanceHints : Boolean,
+    var cacheDecryptedNca : Boolean,
+    var verifyRomFsIntegrity : Boolean,
+    var hardwareVideoDecoding : Boolean,
 
     // Audio
     var isAudioOutputDisabled : Boolean,
@@ -32,12 +37,27 @@ data class NativeSettings(
     var gpuDriverLibraryName : String,
     var forceTripleBuffering : Boolean,
     var disableFrameThrottling : Boolean,
+    var framePacing : Boolean,
     var executorSlotCountScale : Int,
     var executorFlushThreshold : Int,
+    var adaptiveExecutorFlush : Boolean,
     var useDirectMemoryImport : Boolean,
     var forceMaxGpuClocks : Boolean,
+    var parallelCommandRecording : Boolean,
     var freeGuestTextureMemory : Boolean,
+    var textureMemoryBudget : Int,
+    var transientAttachments : Boolean,
+    var resolutionScale : Int,
+    var dynamicResolution : Boolean,
+    var upscalingMode : Int,
+    var gpuTextureDecoding : Boolean,
+    var textureTranscoding : Boolean,
+    var gpuQuadConversion : Boolean,
+    var enableTextureCache : Boolean,
+    var skipRedundantUploads : Boolean,
     var disableShaderCache : Boolean,
+    var asyncPipelineCompilation : Boolean,
+    var enableMacroJit : Boolean,
 
     // Hacks
     var enableFastGpuReadbackHack : Boolean,
@@ -54,17 +74,37 @@ data class NativeSettings(
         pref.systemLanguage,
         pref.systemRegion,
         pref.isInternetEnabled,
+        pref.pinHostThreads,
+        pref.performanceHints,
+        pref.cacheDecryptedNca,
+        pref.verifyRomFsIntegrity,
+        pref.hardwareVideoDecoding,
         pref.isAudioOutputDisabled,
         if (pref.gpuDriver == EmulationSettings.SYSTEM_GPU_DRIVER) "" else pref.gpuDriver,
         if (pref.gpuDriver == EmulationSettings.SYSTEM_GPU_DRIVER) "" else GpuDriverHelper.getLibraryName(context, pref.gpuDriver),
         pref.forceTripleBuffering,
         pref.disableFrameThrottling,
+        pref.framePacing,
         pref.executorSlotCountScale,
         pref.executorFlushThreshold,
+        pref.adaptiveExecutorFlush,
         pref.useDirectMemoryImport,
         pref.forceMaxGpuClocks,
+        pref.parallelCommandRecording,
         pref.freeGuestTextureMemory,
+        pref.textureMemoryBudget,
+        pref.transientAttachments,
+        pref.resolutionScale,
+        pref.dynamicResolution,
+        pref.upscalingMode,
+        pref.gpuTextureDecoding,
+        pref.textureTranscoding,
+        pref.gpuQuadConversion,
+        pref.enableTextureCache,
+        pref.skipRedundantUploads,
         pref.disableShaderCache,
+        pref.asyncPipelineCompilation,
+        pref.enableMacroJit,
         pref.enableFastGpuReadbackHack,
         pref.enableFastReadbackWrites,
         pref.disableSubgroupShuffle,
@@ -0,0 +1,81 @@
+/*
+ * SPDX-License-Identifier: MPL-2.0
+ * Copyright © 2023 Skyline Team and Contributors (https://github.com/skyline-emu/)
+ */
+
+package emu.skyline.views
+
+import android.content.Context
+import android.graphics.Canvas
+import android.graphics.Color
+import android.graphics.Paint
+import android.util.AttributeSet
+import android.view.View
+
+/**
+ * A view that draws a bar graph of recent frame times, frames that exceed [targetFrameTime] are highlighted
+ */
+class FrameTimeGraphView @JvmOverloads constructor(context : Context, attrs : AttributeSet? = null, defStyleAttr : Int = 0) : View(context, attrs, defStyleAttr) {
+    /**
+     * The frame time in milliseconds that corresponds to the target line, the graph is scaled to twice this value
+     */
+    var targetFrameTime = 1000f / 30
+        set(value) {
+            field = value
+            invalidate()
+        }
+
+    private var frameTimes = FloatArray(0)
+    private var frameTimeCount = 0
+
+    private val backgroundPaint = Paint().apply {
+        color = Color.BLACK
+        alpha = 90
+    }
+    private val barPaint = Paint().apply {
+        color = Color.GREEN
+        alpha = 200
+    }
+    private val slowBarPaint = Paint().apply {
+        color = Color.RED
+        alpha = 200
+    }
+    private val targetPaint = Paint().apply {
+        color = Color.WHITE
+        alpha = 135
+        strokeWidth = 2f
+    }
+
+    /**
+     * Sets the frame times in milliseconds to draw, ordered from oldest to newest
+     */
+    fun setFrameTimes(frameTimes : FloatArray, count : Int) {
+        this.frameTimes = frameTimes
+        frameTimeCount = count.coerceIn(0, frameTimes.size)
+        invalidate()
+    }
+
+    override fun onDraw(canvas : Canvas) {
+        super.onDraw(canvas)
+
+        val width = width.toFloat()
+        val height = height.toFloat()
+        canvas.drawRect(0f, 0f, width, height, backgroundPaint)
+
+        val maxFrameTime = targetFrameTime * 2
+        if (frameTimes.isNotEmpty()) {
+            // Bars are right-aligned so the newest frame is always at the right edge
+            val barWidth = width / frameTimes.size
+            var left = width - frameTimeCount * barWidth
+            for (index in 0 until frameTimeCount) {
+                val frameTime = frameTimes[index]
+                val top = height - (frameTime / maxFrameTime).coerceAtMost(1f) * height
+                canvas.drawRect(left, top, left + barWidth, height, if (frameTime > targetFrameTime) slowBarPaint else barPaint)
+                left += barWidth
+            }
+        }
+
+        val targetY = height / 2
+        canvas.drawLine(0f, targetY, width, targetY, targetPaint)
+    }
+}